@@ -114,9 +114,13 @@ ybcinvacuumcleanup(IndexVacuumInfo *info, IndexBulkDeleteResult *stats)
 
 /* --------------------------------------------------------------------------------------------- */
 
+/*
+ * The YugaByte index table stores the values of all the index columns, so an
+ * index-only scan can return any of them without reading the base table.
+ */
 bool ybcincanreturn(Relation index, int attno)
 {
-	return false;
+	return true;
 }
 
 void
@@ -173,6 +177,15 @@ ybcingettuple(IndexScanDesc scan, ScanDirection dir)
 {
 	HeapTuple tuple = ybc_index_getnext(scan);
 	scan->xs_ctup.t_ybctid = (tuple != NULL) ? tuple->t_ybctid : 0;
+
+	/* For an index-only scan, return the index columns that were read. */
+	if (scan->xs_want_itup)
+	{
+		if (scan->xs_hitup != NULL)
+			heap_freetuple(scan->xs_hitup);
+		scan->xs_hitup     = tuple;
+		scan->xs_hitupdesc = RelationGetDescr(scan->indexRelation);
+	}
 	return scan->xs_ctup.t_ybctid != 0;
 }
 
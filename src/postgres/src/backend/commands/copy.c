@@ -2524,12 +2524,21 @@ CopyFrom(CopyState cstate)
 	 * inserting to, and act differently if the tuples that have already been
 	 * processed and prepared for insertion are not there.  We also can't do
 	 * it if the table is partitioned.
+	 *
+	 * With YugaByte, a batch is sent to DocDB in one go by
+	 * YBCExecuteBulkInsert(), which does not return the ybctids of the rows,
+	 * so it is only used when no indexes or AFTER ROW triggers need them.
 	 */
 	if ((resultRelInfo->ri_TrigDesc != NULL &&
 		 (resultRelInfo->ri_TrigDesc->trig_insert_before_row ||
 		  resultRelInfo->ri_TrigDesc->trig_insert_instead_row)) ||
 		cstate->partition_dispatch_info != NULL ||
-		cstate->volatile_defexprs || IsYugaByteEnabled())
+		cstate->volatile_defexprs ||
+		(IsYugaByteEnabled() &&
+		 (cstate->rel->rd_rel->relhasindex ||
+		  (resultRelInfo->ri_TrigDesc != NULL &&
+		   (resultRelInfo->ri_TrigDesc->trig_insert_after_row ||
+			resultRelInfo->ri_TrigDesc->trig_insert_new_table)))))
 	{
 		useHeapMultiInsert = false;
 	}
@@ -2929,12 +2938,22 @@ CopyFromInsertBatch(CopyState cstate, EState *estate, CommandId mycid,
 	 * before calling it.
 	 */
 	oldcontext = MemoryContextSwitchTo(GetPerTupleMemoryContext(estate));
-	heap_multi_insert(cstate->rel,
-					  bufferedTuples,
-					  nBufferedTuples,
-					  mycid,
-					  hi_options,
-					  bistate);
+	if (IsYugaByteEnabled())
+	{
+		YBCExecuteBulkInsert(cstate->rel,
+							 RelationGetDescr(cstate->rel),
+							 bufferedTuples,
+							 nBufferedTuples);
+	}
+	else
+	{
+		heap_multi_insert(cstate->rel,
+						  bufferedTuples,
+						  nBufferedTuples,
+						  mycid,
+						  hi_options,
+						  bistate);
+	}
 	MemoryContextSwitchTo(oldcontext);
 
 	/*
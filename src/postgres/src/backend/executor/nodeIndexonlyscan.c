@@ -40,6 +40,7 @@
 #include "storage/predicate.h"
 #include "utils/memutils.h"
 #include "utils/rel.h"
+#include "pg_yb_utils.h"
 
 
 static TupleTableSlot *IndexOnlyNext(IndexOnlyScanState *node);
@@ -154,8 +155,13 @@ IndexOnlyNext(IndexOnlyScanState *node)
 		 *
 		 * It's worth going through this complexity to avoid needing to lock
 		 * the VM buffer, which could cause significant contention.
+		 *
+		 * YugaByte index entries are read at the same read point as the rows
+		 * of the table, so they are as visible as the rows they refer to, and
+		 * the table is never visited.
 		 */
-		if (!VM_ALL_VISIBLE(scandesc->heapRelation,
+		if (!IsYBRelation(scandesc->heapRelation) &&
+			!VM_ALL_VISIBLE(scandesc->heapRelation,
 							ItemPointerGetBlockNumber(tid),
 							&node->ioss_VMBuffer))
 		{
@@ -243,7 +249,7 @@ IndexOnlyNext(IndexOnlyScanState *node)
 		 * anyway, then we already have the tuple-level lock and can skip the
 		 * page lock.
 		 */
-		if (tuple == NULL)
+		if (tuple == NULL && !IsYBRelation(scandesc->heapRelation))
 			PredicateLockPage(scandesc->heapRelation,
 							  ItemPointerGetBlockNumber(tid),
 							  estate->es_snapshot);
@@ -53,3 +53,10 @@ YBCPgExpr YBCNewConstant(YBCPgStatement ybc_stmt, Oid type_id, Datum datum, bool
 	HandleYBStatus(YBCPgNewConstant(ybc_stmt, type_entity, datum, is_null, &expr));
 	return expr;
 }
+
+YBCPgExpr YBCNewOperator(YBCPgStatement ybc_stmt, const char *opname) {
+	YBCPgExpr expr = NULL;
+	const YBCPgTypeEntity *type_entity = YBCDataTypeFromOidMod(InvalidAttrNumber, BOOLOID);
+	HandleYBStatus(YBCPgNewOperator(ybc_stmt, opname, type_entity, &expr));
+	return expr;
+}
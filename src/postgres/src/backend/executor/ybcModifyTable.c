@@ -240,6 +240,84 @@ Oid YBCExecuteInsert(Relation rel, TupleDesc tupleDesc, HeapTuple tuple)
 	return HeapTupleGetOid(tuple);
 }
 
+/*
+ * Insert a batch of tuples into a relation's backing YugaByte table, as COPY FROM does. Unlike
+ * YBCExecuteInsert(), the rows share one statement and are sent together, and their ybctids are
+ * not returned, so the relation must not have indexes.
+ */
+void YBCExecuteBulkInsert(Relation rel, TupleDesc tupleDesc, HeapTuple *tuples, int ntuples)
+{
+	Oid            dboid    = YBCGetDatabaseOid(rel);
+	Oid            relid    = RelationGetRelid(rel);
+	AttrNumber     minattr  = FirstLowInvalidHeapAttributeNumber + 1;
+	int            natts    = RelationGetNumberOfAttributes(rel);
+	Bitmapset      *pkey    = GetTablePrimaryKey(rel);
+	YBCPgStatement ybc_stmt = NULL;
+	int            ncols    = 0;
+	AttrNumber     *attnums = palloc(sizeof(AttrNumber) * (natts - minattr + 1));
+	uint64_t       *values;
+	bool           *isnulls;
+
+	Assert(!rel->rd_rel->relhasindex);
+
+	/* Describe the columns of each row. */
+	HandleYBStatus(YBCPgNewBulkInsert(ybc_pg_session, dboid, relid, &ybc_stmt));
+	for (AttrNumber attnum = minattr; attnum <= natts; attnum++)
+	{
+		/* Skip virtual (system) columns */
+		if (!IsRealYBColumn(rel, attnum))
+		{
+			continue;
+		}
+
+		Oid type_id = GetTypeId(attnum, tupleDesc);
+		const YBCPgTypeEntity *type_entity = YBCDataTypeFromOidMod(InvalidAttrNumber, type_id);
+		HandleYBStmtStatus(YBCPgBulkInsertAddColumn(ybc_stmt, attnum, type_entity), ybc_stmt);
+		attnums[ncols++] = attnum;
+	}
+
+	/* Lay out the values of the rows one after the other. */
+	values = palloc(sizeof(uint64_t) * ncols * ntuples);
+	isnulls = palloc(sizeof(bool) * ncols * ntuples);
+	for (int i = 0; i < ntuples; i++)
+	{
+		HeapTuple tuple = tuples[i];
+
+		/* Generate a new oid for this row if needed */
+		if (rel->rd_rel->relhasoids)
+		{
+			if (!OidIsValid(HeapTupleGetOid(tuple)))
+				HeapTupleSetOid(tuple, GetNewOid(rel));
+		}
+
+		for (int col = 0; col < ncols; col++)
+		{
+			int   idx   = i * ncols + col;
+			Datum datum = heap_getattr(tuple, attnums[col], tupleDesc, &isnulls[idx]);
+
+			/* Check not-null constraint on primary key early */
+			if (isnulls[idx] && bms_is_member(attnums[col] - minattr, pkey))
+			{
+				HandleYBStatus(YBCPgDeleteStatement(ybc_stmt));
+				ereport(ERROR,
+				        (errcode(ERRCODE_NOT_NULL_VIOLATION), errmsg(
+						        "Missing/null value for primary key column")));
+			}
+			values[idx] = (uint64_t) datum;
+		}
+	}
+
+	/* Execute the insert and clean up. */
+	HandleYBStmtStatus(YBCPgBulkInsertAppendRows(ybc_stmt, ntuples, values, isnulls), ybc_stmt);
+	HandleYBStmtStatus(YBCPgBulkInsertFlush(ybc_stmt), ybc_stmt);
+	HandleYBStatus(YBCPgDeleteStatement(ybc_stmt));
+	ybc_stmt = NULL;
+
+	pfree(values);
+	pfree(isnulls);
+	pfree(attnums);
+}
+
 /*
  * Insert a tuple into the an index's backing YugaByte index table.
  */
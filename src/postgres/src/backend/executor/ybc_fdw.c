@@ -55,7 +55,11 @@
 
 /*  YB includes. */
 #include "commands/dbcommands.h"
+#include "catalog/pg_namespace.h"
 #include "catalog/pg_operator.h"
+#include "catalog/pg_type.h"
+#include "nodes/nodeFuncs.h"
+#include "utils/array.h"
 #include "utils/lsyscache.h"
 #include "utils/syscache.h"
 
@@ -299,6 +303,304 @@ static void ybcAddWhereCond(EState *estate, Expr* expr, YBCPgStatement yb_stmt)
 	HandleYBStatus(YBCPgDmlBindColumn(yb_stmt, col_desc->varattno, ybc_expr));
 }
 
+/*
+ * Returns the name of a built-in operator, or NULL for an operator defined by
+ * users, whose semantics YugaByte does not know.
+ */
+static char *ybcGetBuiltinOperatorName(Oid opno)
+{
+	HeapTuple        tuple;
+	Form_pg_operator form;
+	char             *opname = NULL;
+
+	tuple = SearchSysCache1(OPEROID, ObjectIdGetDatum(opno));
+	if (!HeapTupleIsValid(tuple))
+		ereport(ERROR,
+		        (errcode(ERRCODE_INTERNAL_ERROR), errmsg(
+				        "cache lookup failed for operator %u", opno)));
+	form = (Form_pg_operator) GETSTRUCT(tuple);
+	if (form->oprnamespace == PG_CATALOG_NAMESPACE)
+		opname = pstrdup(NameStr(form->oprname));
+	ReleaseSysCache(tuple);
+	return opname;
+}
+
+static bool ybcIsOrderingOperator(const char *opname)
+{
+	return strcmp(opname, ">") == 0 ||
+	       strcmp(opname, ">=") == 0 ||
+	       strcmp(opname, "<") == 0 ||
+	       strcmp(opname, "<=") == 0;
+}
+
+/* Returns the operator to use when the arguments of 'opname' are swapped. */
+static const char *ybcCommuteOperator(const char *opname)
+{
+	if (strcmp(opname, ">") == 0)
+		return "<";
+	if (strcmp(opname, ">=") == 0)
+		return "<=";
+	if (strcmp(opname, "<") == 0)
+		return ">";
+	if (strcmp(opname, "<=") == 0)
+		return ">=";
+	return opname;
+}
+
+/*
+ * Returns whether YugaByte compares values of the given type the same way
+ * Postgres does. Text is only compared for equality, because its ordering
+ * depends on the collation, and oid is stored as a signed integer. Floating
+ * point types are left out because Postgres considers NaN equal to itself,
+ * numeric and bpchar because their values are not compared byte by byte.
+ */
+static bool ybcIsFilterType(Oid type_id, bool is_ordering)
+{
+	switch (type_id)
+	{
+		case BOOLOID:
+		case INT2OID:
+		case INT4OID:
+		case INT8OID:
+			return true;
+		case OIDOID:
+		case TEXTOID:
+		case VARCHAROID:
+			return !is_ordering;
+		default:
+			return false;
+	}
+}
+
+static bool ybcIsTextType(Oid type_id)
+{
+	return type_id == TEXTOID || type_id == VARCHAROID;
+}
+
+/*
+ * Returns the column of the scanned relation that an expression refers to, or
+ * NULL if it is not a column reference.
+ */
+static Var *ybcGetFilterColumn(Index relid, Expr *expr)
+{
+	while (IsA(expr, RelabelType))
+		expr = ((RelabelType *) expr)->arg;
+	if (!IsA(expr, Var))
+		return NULL;
+
+	Var *var = (Var *) expr;
+	if (var->varno != relid || var->varlevelsup != 0 || var->varattno <= 0)
+		return NULL;
+	return var;
+}
+
+/* Returns whether 'value' could be sent to YugaByte as a value of column 'var'. */
+static bool ybcIsFilterValue(Var *var, Expr *value)
+{
+	Oid value_type = exprType((Node *) value);
+	return IsSupportedPredicateExpr(value) &&
+	       (value_type == var->vartype ||
+	        (ybcIsTextType(value_type) && ybcIsTextType(var->vartype)));
+}
+
+/*
+ * Returns whether a condition that Postgres checks could also be evaluated by
+ * YugaByte, to skip the rows that do not match before they are sent to
+ * Postgres. Supported are boolean columns, comparisons of a column with a
+ * value, IN lists of values, IS [NOT] NULL and their combinations with AND, OR
+ * and NOT.
+ */
+static bool ybcIsPushableFilter(Index relid, Expr *expr)
+{
+	switch (nodeTag(expr))
+	{
+		case T_Var:
+		{
+			Var *var = ybcGetFilterColumn(relid, expr);
+			return var != NULL && var->vartype == BOOLOID;
+		}
+		case T_OpExpr:
+		{
+			OpExpr *op_expr = (OpExpr *) expr;
+			if (list_length(op_expr->args) != 2)
+				return false;
+
+			char *opname = ybcGetBuiltinOperatorName(op_expr->opno);
+			if (opname == NULL)
+				return false;
+			/* Note: the != operator is converted to <> in the parser stage */
+			bool is_eq       = strcmp(opname, "=") == 0 || strcmp(opname, "<>") == 0;
+			bool is_ordering = ybcIsOrderingOperator(opname);
+			pfree(opname);
+			if (!is_eq && !is_ordering)
+				return false;
+
+			Expr *value = lsecond(op_expr->args);
+			Var  *var   = ybcGetFilterColumn(relid, linitial(op_expr->args));
+			if (var == NULL)
+			{
+				value = linitial(op_expr->args);
+				var   = ybcGetFilterColumn(relid, lsecond(op_expr->args));
+			}
+			return var != NULL &&
+			       ybcIsFilterType(var->vartype, is_ordering) &&
+			       ybcIsFilterValue(var, value);
+		}
+		case T_ScalarArrayOpExpr:
+		{
+			/* Only <col> IN (<values>), i.e. <col> = ANY(<array constant>). */
+			ScalarArrayOpExpr *saop = (ScalarArrayOpExpr *) expr;
+			if (!saop->useOr || list_length(saop->args) != 2)
+				return false;
+
+			char *opname = ybcGetBuiltinOperatorName(saop->opno);
+			bool is_eq   = opname != NULL && strcmp(opname, "=") == 0;
+			if (opname != NULL)
+				pfree(opname);
+
+			Var  *var   = ybcGetFilterColumn(relid, linitial(saop->args));
+			Expr *array = lsecond(saop->args);
+			if (!is_eq || var == NULL || !ybcIsFilterType(var->vartype, false) ||
+			    !IsA(array, Const) || ((Const *) array)->constisnull)
+				return false;
+
+			Oid       element_type = get_element_type(((Const *) array)->consttype);
+			ArrayType *values      = DatumGetArrayTypeP(((Const *) array)->constvalue);
+			return (element_type == var->vartype ||
+			        (ybcIsTextType(element_type) && ybcIsTextType(var->vartype))) &&
+			       ArrayGetNItems(ARR_NDIM(values), ARR_DIMS(values)) > 0;
+		}
+		case T_BoolExpr:
+		{
+			ListCell *lc;
+			foreach(lc, ((BoolExpr *) expr)->args)
+			{
+				if (!ybcIsPushableFilter(relid, (Expr *) lfirst(lc)))
+					return false;
+			}
+			return true;
+		}
+		case T_NullTest:
+		{
+			/* For a row, IS NULL checks each of its fields. */
+			NullTest *null_test = (NullTest *) expr;
+			return !null_test->argisrow && ybcGetFilterColumn(relid, null_test->arg) != NULL;
+		}
+		default:
+			break;
+	}
+
+	return false;
+}
+
+static YBCPgExpr ybcNewFilterColumnRef(YBCPgStatement yb_stmt, Var *var)
+{
+	YBCPgTypeAttrs type_attrs = { var->vartypmod };
+	return YBCNewColumnRef(yb_stmt, var->varattno, var->vartype, &type_attrs);
+}
+
+/*
+ * Builds the YugaByte expression for a condition that ybcIsPushableFilter
+ * accepted.
+ */
+static YBCPgExpr ybcNewFilter(EState *estate, Index relid, Expr *expr, YBCPgStatement yb_stmt)
+{
+	YBCPgExpr filter = NULL;
+	ListCell  *lc;
+
+	switch (nodeTag(expr))
+	{
+		case T_Var:
+			return ybcNewFilterColumnRef(yb_stmt, ybcGetFilterColumn(relid, expr));
+		case T_OpExpr:
+		{
+			OpExpr     *op_expr = (OpExpr *) expr;
+			const char *opname  = ybcGetBuiltinOperatorName(op_expr->opno);
+			Expr       *value   = lsecond(op_expr->args);
+			Var        *var     = ybcGetFilterColumn(relid, linitial(op_expr->args));
+			if (var == NULL)
+			{
+				/* '<value> <op> <col>' is sent as '<col> <commuted op> <value>'. */
+				value  = linitial(op_expr->args);
+				var    = ybcGetFilterColumn(relid, lsecond(op_expr->args));
+				opname = ybcCommuteOperator(opname);
+			}
+
+			Datum datum;
+			bool  is_null;
+			GetValFromPredicateExpr(value, estate->es_param_list_info, &datum, &is_null);
+			filter = YBCNewOperator(yb_stmt, opname);
+			HandleYBStatus(YBCPgOperatorAppendArg(filter, ybcNewFilterColumnRef(yb_stmt, var)));
+			HandleYBStatus(YBCPgOperatorAppendArg(
+					filter, YBCNewConstant(yb_stmt, var->vartype, datum, is_null)));
+			return filter;
+		}
+		case T_ScalarArrayOpExpr:
+		{
+			ScalarArrayOpExpr *saop   = (ScalarArrayOpExpr *) expr;
+			Var               *var    = ybcGetFilterColumn(relid, linitial(saop->args));
+			ArrayType         *values = DatumGetArrayTypeP(
+					((Const *) lsecond(saop->args))->constvalue);
+			int16 elmlen;
+			bool  elmbyval;
+			char  elmalign;
+			Datum *elems;
+			bool  *nulls;
+			int   nelems;
+			get_typlenbyvalalign(ARR_ELEMTYPE(values), &elmlen, &elmbyval, &elmalign);
+			deconstruct_array(values, ARR_ELEMTYPE(values), elmlen, elmbyval, elmalign,
+			                  &elems, &nulls, &nelems);
+
+			filter = YBCNewOperator(yb_stmt, "in");
+			HandleYBStatus(YBCPgOperatorAppendArg(filter, ybcNewFilterColumnRef(yb_stmt, var)));
+			for (int i = 0; i < nelems; i++)
+			{
+				HandleYBStatus(YBCPgOperatorAppendArg(
+						filter, YBCNewConstant(yb_stmt, var->vartype, elems[i], nulls[i])));
+			}
+			return filter;
+		}
+		case T_BoolExpr:
+		{
+			BoolExpr *bool_expr = (BoolExpr *) expr;
+			switch (bool_expr->boolop)
+			{
+				case AND_EXPR:
+					filter = YBCNewOperator(yb_stmt, "and");
+					break;
+				case OR_EXPR:
+					filter = YBCNewOperator(yb_stmt, "or");
+					break;
+				case NOT_EXPR:
+					filter = YBCNewOperator(yb_stmt, "not");
+					break;
+			}
+			foreach(lc, bool_expr->args)
+			{
+				HandleYBStatus(YBCPgOperatorAppendArg(
+						filter, ybcNewFilter(estate, relid, (Expr *) lfirst(lc), yb_stmt)));
+			}
+			return filter;
+		}
+		case T_NullTest:
+		{
+			NullTest *null_test = (NullTest *) expr;
+			filter = YBCNewOperator(yb_stmt,
+			                        null_test->nulltesttype == IS_NULL ? "is_null" : "is_not_null");
+			HandleYBStatus(YBCPgOperatorAppendArg(
+					filter,
+					ybcNewFilterColumnRef(yb_stmt, ybcGetFilterColumn(relid, null_test->arg))));
+			return filter;
+		}
+		default:
+			ereport(ERROR,
+			        (errcode(ERRCODE_INTERNAL_ERROR), errmsg(
+					        "Found unsupported YugaByte filter expression %s",
+					        nodeToString(expr))));
+	}
+	return filter;
+}
+
 /*
  * ybcGetForeignRelSize
  *		Obtain relation size estimates for a foreign table
@@ -538,8 +840,23 @@ ybcGetForeignPlan(PlannerInfo *root,
 
 	List *yb_conds = list_concat(yb_plan_state->yb_hconds, yb_plan_state->yb_rconds);
 
+	/*
+	 * The conditions left to Postgres that YugaByte could evaluate too, so that
+	 * it only sends the rows that match them. Postgres still checks all of them.
+	 */
+	List *yb_filters = NIL;
+	if (baserel->reloptkind == RELOPT_BASEREL)
+	{
+		foreach(lc, yb_plan_state->pg_conds)
+		{
+			Expr *expr = (Expr *) lfirst(lc);
+			if (ybcIsPushableFilter(scan_relid, expr))
+				yb_filters = lappend(yb_filters, expr);
+		}
+	}
+
 	/* Create the ForeignScan node */
-	fdw_private = list_make2(target_attrs, yb_conds);
+	fdw_private = list_make3(target_attrs, yb_conds, yb_filters);
 	return make_foreignscan(tlist,  /* target list */
 	                        yb_plan_state->pg_conds,  /* checked by Postgres */
 	                        scan_relid,
@@ -556,11 +873,30 @@ ybcGetForeignPlan(PlannerInfo *root,
 /*
  * FDW-specific information for ForeignScanState.fdw_state.
  */
+/*
+ * Number of rows fetched from YugaByte at once. Only the first row of a batch
+ * might wait for YugaByte, the others are the rows already received.
+ */
+#define YB_FDW_FETCH_BATCH_ROWS 128
+
 typedef struct YbFdwExecState
 {
 	/* The handle for the internal YB Select statement. */
 	YBCPgStatement handle;
 	ResourceOwner stmt_owner;
+
+	/*
+	 * The fetched rows, natts values per row, and the next row to return.
+	 * Their text values and ybctids live in batch_context until the next
+	 * batch is fetched.
+	 */
+	int				natts;
+	uint64_t	   *values;
+	bool		   *isnulls;
+	YBCPgSysColumns *syscols;
+	int32_t			nrows;
+	int32_t			next_row;
+	MemoryContext	batch_context;
 } YbFdwExecState;
 
 /*
@@ -576,9 +912,10 @@ ybcBeginForeignScan(ForeignScanState *node, int eflags)
 	TupleDesc   tupdesc      = RelationGetDescr(relation);
 
 	/* Planning function above should ensure both target and conds are set */
-	Assert(foreignScan->fdw_private->length == 2);
+	Assert(foreignScan->fdw_private->length == 3);
 	List *target_attrs = linitial(foreignScan->fdw_private);
 	List *yb_conds     = lsecond(foreignScan->fdw_private);
+	List *yb_filters   = lthird(foreignScan->fdw_private);
 
 	YbFdwExecState *ybc_state = NULL;
 	ListCell       *lc;
@@ -591,6 +928,13 @@ ybcBeginForeignScan(ForeignScanState *node, int eflags)
 	ybc_state = (YbFdwExecState *) palloc0(sizeof(YbFdwExecState));
 
 	node->fdw_state = (void *) ybc_state;
+	ybc_state->natts = tupdesc->natts;
+	ybc_state->values = palloc(sizeof(uint64_t) * tupdesc->natts * YB_FDW_FETCH_BATCH_ROWS);
+	ybc_state->isnulls = palloc(sizeof(bool) * tupdesc->natts * YB_FDW_FETCH_BATCH_ROWS);
+	ybc_state->syscols = palloc(sizeof(YBCPgSysColumns) * YB_FDW_FETCH_BATCH_ROWS);
+	ybc_state->batch_context = AllocSetContextCreate(estate->es_query_cxt,
+													 "YB FDW fetch batch",
+													 ALLOCSET_DEFAULT_SIZES);
 	HandleYBStatus(YBCPgNewSelect(ybc_pg_session,
 								  YBCGetDatabaseOid(relation),
 								  RelationGetRelid(relation),
@@ -608,6 +952,17 @@ ybcBeginForeignScan(ForeignScanState *node, int eflags)
 		ybcAddWhereCond(estate, expr, ybc_state->handle);
 	}
 
+	/* Set the filters that YugaByte evaluates before sending the rows. */
+	foreach(lc, yb_filters)
+	{
+		Expr *expr = (Expr *) lfirst(lc);
+		YBCPgExpr filter = ybcNewFilter(estate, foreignScan->scan.scanrelid, expr,
+		                                ybc_state->handle);
+		HandleYBStmtStatusWithOwner(YBCPgDmlAppendFilter(ybc_state->handle, filter),
+		                            ybc_state->handle,
+		                            ybc_state->stmt_owner);
+	}
+
 	/* Set scan targets. */
 	bool has_targets = false;
 	foreach(lc, target_attrs)
@@ -679,39 +1034,51 @@ ybcIterateForeignScan(ForeignScanState *node)
 {
 	TupleTableSlot *slot      = node->ss.ss_ScanTupleSlot;
 	YbFdwExecState *ybc_state = (YbFdwExecState *) node->fdw_state;
-	bool           has_data   = false;
 
 	/* Clear tuple slot before starting */
 	ExecClearTuple(slot);
 
-	TupleDesc       tupdesc = slot->tts_tupleDescriptor;
-	Datum           *values = slot->tts_values;
-	bool            *isnull = slot->tts_isnull;
-	YBCPgSysColumns syscols;
-
-	/* Fetch one row. */
-	HandleYBStmtStatusWithOwner(YBCPgDmlFetch(ybc_state->handle,
-	                                          tupdesc->natts,
-	                                          (uint64_t *) values,
-	                                          isnull,
-	                                          &syscols,
-	                                          &has_data),
-	                            ybc_state->handle,
-	                            ybc_state->stmt_owner);
+	TupleDesc tupdesc = slot->tts_tupleDescriptor;
+	Assert(tupdesc->natts == ybc_state->natts);
+
+	/* Fetch the next batch of rows once the previous one is used up. */
+	if (ybc_state->next_row >= ybc_state->nrows)
+	{
+		MemoryContext oldcontext;
+
+		MemoryContextReset(ybc_state->batch_context);
+		oldcontext = MemoryContextSwitchTo(ybc_state->batch_context);
+		HandleYBStmtStatusWithOwner(YBCPgDmlFetchBatch(ybc_state->handle,
+		                                               tupdesc->natts,
+		                                               YB_FDW_FETCH_BATCH_ROWS,
+		                                               ybc_state->values,
+		                                               ybc_state->isnulls,
+		                                               ybc_state->syscols,
+		                                               &ybc_state->nrows),
+		                            ybc_state->handle,
+		                            ybc_state->stmt_owner);
+		MemoryContextSwitchTo(oldcontext);
+		ybc_state->next_row = 0;
+	}
 
 	/* If we have result(s) update the tuple slot. */
-	if (has_data)
+	if (ybc_state->next_row < ybc_state->nrows)
 	{
+		int             row      = ybc_state->next_row++;
+		Datum           *values  = (Datum *) (ybc_state->values + row * tupdesc->natts);
+		bool            *isnull  = ybc_state->isnulls + row * tupdesc->natts;
+		YBCPgSysColumns *syscols = &ybc_state->syscols[row];
+
 		HeapTuple tuple = heap_form_tuple(tupdesc, values, isnull);
-		if (syscols.oid != InvalidOid)
+		if (syscols->oid != InvalidOid)
 		{
-			HeapTupleSetOid(tuple, syscols.oid);
+			HeapTupleSetOid(tuple, syscols->oid);
 		}
 
 		slot = ExecStoreTuple(tuple, slot, InvalidBuffer, false);
 
 		/* Setup special columns in the slot */
-		slot->tts_ybctid = PointerGetDatum(syscols.ybctid);
+		slot->tts_ybctid = PointerGetDatum(syscols->ybctid);
 	}
 
 	return slot;
@@ -728,6 +1095,8 @@ ybcFreeStatementObject(YbFdwExecState* yb_fdw_exec_state)
 										yb_fdw_exec_state->handle);
 		yb_fdw_exec_state->handle = NULL;
 		yb_fdw_exec_state->stmt_owner = NULL;
+		MemoryContextDelete(yb_fdw_exec_state->batch_context);
+		yb_fdw_exec_state->batch_context = NULL;
 	}
 }
 
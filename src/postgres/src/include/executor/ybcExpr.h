@@ -39,4 +39,8 @@ extern YBCPgExpr YBCNewColumnRef(YBCPgStatement ybc_stmt, int16_t attr_num, int
 // Construct constant expression using the given datatype "type_id" and value "datum".
 extern YBCPgExpr YBCNewConstant(YBCPgStatement ybc_stmt, Oid type_id, Datum datum, bool is_null);
 
+// Construct a boolean operator expression, such as "=", "and" or "is_null", whose arguments are
+// then appended with YBCPgOperatorAppendArg().
+extern YBCPgExpr YBCNewOperator(YBCPgStatement ybc_stmt, const char *opname);
+
 #endif							/* YBCEXPR_H */
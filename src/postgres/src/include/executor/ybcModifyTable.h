@@ -28,6 +28,9 @@
 
 extern Oid YBCExecuteInsert(Relation rel, TupleDesc tupleDesc, HeapTuple tuple);
 
+extern void YBCExecuteBulkInsert(Relation rel, TupleDesc tupleDesc, HeapTuple *tuples,
+								 int ntuples);
+
 extern void YBCExecuteInsertIndex(Relation rel, Datum *values, bool *isnull, Datum ybctid);
 
 extern void YBCExecuteDelete(Relation rel, ResultRelInfo *resultRelInfo, TupleTableSlot *slot);
@@ -0,0 +1,656 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+
+#include "yb/benchmarks/workload.h"
+
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <numeric>
+#include <thread>
+
+#include "yb/client/client.h"
+#include "yb/client/table_handle.h"
+#include "yb/client/transaction.h"
+#include "yb/client/yb_op.h"
+#include "yb/common/ql_protocol_util.h"
+#include "yb/gutil/stringprintf.h"
+#include "yb/gutil/strings/numbers.h"
+#include "yb/gutil/strings/split.h"
+#include "yb/util/countdown_latch.h"
+#include "yb/util/format.h"
+#include "yb/util/logging.h"
+
+using namespace std::literals;
+
+namespace yb {
+namespace benchmarks {
+
+namespace {
+
+// Highest latency kept by the histograms, larger ones are counted as this one.
+constexpr uint64_t kMaxLatencyUs = 60 * 1000 * 1000;
+constexpr int kLatencySignificantDigits = 3;
+
+// Scrambled Zipfian keys are taken from this many items, with zeta precomputed as YCSB does.
+constexpr int64_t kScrambledZipfianItems = 10000000000LL;
+constexpr double kScrambledZipfianZeta = 26.46902820178302;
+
+// Versions of the value of a key, see WorkloadRunner::ValueForIndex().
+constexpr int kNumValueVersions = 4;
+
+// Highest hash code of the partition key, which is 16 bits long.
+constexpr uint32_t kMaxHashCode = 0xffff;
+
+const char* const kKeyColumn = "k";
+const char* const kValueColumn = "v";
+
+double Zeta(int64_t begin, int64_t end, double theta, double initial_sum) {
+  double sum = initial_sum;
+  for (int64_t i = begin; i < end; ++i) {
+    sum += 1 / std::pow(i + 1, theta);
+  }
+  return sum;
+}
+
+// 64 bit FNV-1a hash of the bytes of 'value', as used by YCSB to scatter the Zipfian items.
+uint64_t FnvHash64(uint64_t value) {
+  constexpr uint64_t kOffsetBasis = 0xcbf29ce484222325ULL;
+  constexpr uint64_t kPrime = 1099511628211ULL;
+  uint64_t result = kOffsetBasis;
+  for (int i = 0; i != 8; ++i) {
+    result ^= value & 0xff;
+    result *= kPrime;
+    value >>= 8;
+  }
+  return result;
+}
+
+std::unique_ptr<HdrHistogram> NewLatencyHistogram() {
+  return std::make_unique<HdrHistogram>(kMaxLatencyUs, kLatencySignificantDigits);
+}
+
+Result<WorkloadOp> ParseWorkloadOp(const std::string& name) {
+  if (name == "read") {
+    return WorkloadOp::kRead;
+  }
+  if (name == "update") {
+    return WorkloadOp::kUpdate;
+  }
+  if (name == "insert") {
+    return WorkloadOp::kInsert;
+  }
+  if (name == "scan") {
+    return WorkloadOp::kScan;
+  }
+  if (name == "read_modify_write") {
+    return WorkloadOp::kReadModifyWrite;
+  }
+  if (name == "index_read") {
+    return WorkloadOp::kIndexRead;
+  }
+  return STATUS_FORMAT(InvalidArgument, "Unknown workload operation: $0", name);
+}
+
+Status CheckResponse(client::YBqlOp* op) {
+  if (!op->succeeded()) {
+    return STATUS_FORMAT(
+        RuntimeError, "$0 failed: $1", op->ToString(), op->response().error_message());
+  }
+  return Status::OK();
+}
+
+} // namespace
+
+Result<WorkloadSpec> WorkloadSpec::Parse(const std::string& text) {
+  WorkloadSpec result;
+  auto set_weight = [&result](WorkloadOp op, double weight) {
+    result.weights[to_underlying(op)] = weight;
+  };
+  if (text.size() == 1) {
+    // The YCSB core workloads.
+    result.distribution = KeyDistribution::kZipfian;
+    switch (text[0]) {
+      case 'a':
+        set_weight(WorkloadOp::kRead, 0.5);
+        set_weight(WorkloadOp::kUpdate, 0.5);
+        return result;
+      case 'b':
+        set_weight(WorkloadOp::kRead, 0.95);
+        set_weight(WorkloadOp::kUpdate, 0.05);
+        return result;
+      case 'c':
+        set_weight(WorkloadOp::kRead, 1);
+        return result;
+      case 'd':
+        set_weight(WorkloadOp::kRead, 0.95);
+        set_weight(WorkloadOp::kInsert, 0.05);
+        result.distribution = KeyDistribution::kLatest;
+        return result;
+      case 'e':
+        set_weight(WorkloadOp::kScan, 0.95);
+        set_weight(WorkloadOp::kInsert, 0.05);
+        return result;
+      case 'f':
+        set_weight(WorkloadOp::kRead, 0.5);
+        set_weight(WorkloadOp::kReadModifyWrite, 0.5);
+        return result;
+    }
+    return STATUS_FORMAT(InvalidArgument, "Unknown workload: $0", text);
+  }
+
+  std::vector<std::string> entries;
+  SplitStringUsing(text, ",", &entries);
+  for (const auto& entry : entries) {
+    const auto colon = entry.find(':');
+    double weight = 0;
+    if (colon == std::string::npos || !safe_strtod(entry.substr(colon + 1), &weight) ||
+        weight < 0) {
+      return STATUS_FORMAT(InvalidArgument, "Bad workload entry '$0', expected <op>:<weight>",
+                           entry);
+    }
+    set_weight(VERIFY_RESULT(ParseWorkloadOp(entry.substr(0, colon))), weight);
+  }
+  set_weight(WorkloadOp::kLoad, 0);
+  if (std::all_of(result.weights.begin(), result.weights.end(), [](double w) { return w == 0; })) {
+    return STATUS_FORMAT(InvalidArgument, "Workload without operations: $0", text);
+  }
+  return result;
+}
+
+std::string WorkloadSpec::ToString() const {
+  std::string result;
+  for (auto op : kWorkloadOpList) {
+    if (Uses(op)) {
+      result += Format("$0: $1, ", op, weights[to_underlying(op)]);
+    }
+  }
+  return result + Format("distribution: $0, max_scan_length: $1", distribution, max_scan_length);
+}
+
+Result<KeyDistribution> ParseKeyDistribution(const std::string& text) {
+  if (text == "uniform") {
+    return KeyDistribution::kUniform;
+  }
+  if (text == "zipfian") {
+    return KeyDistribution::kZipfian;
+  }
+  if (text == "latest") {
+    return KeyDistribution::kLatest;
+  }
+  return STATUS_FORMAT(InvalidArgument, "Unknown key distribution: $0", text);
+}
+
+ZipfianGenerator::ZipfianGenerator(int64_t num_items, double theta)
+    : ZipfianGenerator(num_items, theta, Zeta(0, num_items, theta, 0)) {
+}
+
+ZipfianGenerator::ZipfianGenerator(int64_t num_items, double theta, double zeta)
+    : theta_(theta), alpha_(1 / (1 - theta)), zeta2_(Zeta(0, 2, theta, 0)),
+      num_items_(num_items), zetan_(zeta) {
+  UpdateEta();
+}
+
+void ZipfianGenerator::UpdateEta() {
+  eta_ = (1 - std::pow(2.0 / num_items_, 1 - theta_)) / (1 - zeta2_ / zetan_);
+}
+
+int64_t ZipfianGenerator::Next(std::mt19937_64* rng) {
+  const double u = std::uniform_real_distribution<double>()(*rng);
+  const double uz = u * zetan_;
+  if (uz < 1) {
+    return 0;
+  }
+  if (uz < 1 + std::pow(0.5, theta_)) {
+    return 1;
+  }
+  const auto result = static_cast<int64_t>(num_items_ * std::pow(eta_ * u - eta_ + 1, alpha_));
+  return std::min(result, num_items_ - 1);
+}
+
+int64_t ZipfianGenerator::Next(int64_t num_items, std::mt19937_64* rng) {
+  if (num_items > num_items_) {
+    zetan_ = Zeta(num_items_, num_items, theta_, zetan_);
+    num_items_ = num_items;
+    UpdateEta();
+  }
+  return std::min(Next(rng), num_items - 1);
+}
+
+KeyChooser::KeyChooser(KeyDistribution distribution, int64_t num_keys)
+    : distribution_(distribution),
+      scrambled_(kScrambledZipfianItems, ZipfianGenerator::kDefaultTheta, kScrambledZipfianZeta),
+      // Computing zeta takes a while for many keys, so it is done only when needed.
+      latest_(distribution == KeyDistribution::kLatest ? std::max<int64_t>(num_keys, 1) : 1) {
+}
+
+int64_t KeyChooser::Next(int64_t num_keys, std::mt19937_64* rng) {
+  DCHECK_GT(num_keys, 0);
+  switch (distribution_) {
+    case KeyDistribution::kUniform:
+      return std::uniform_int_distribution<int64_t>(0, num_keys - 1)(*rng);
+    case KeyDistribution::kZipfian:
+      return FnvHash64(scrambled_.Next(rng)) % num_keys;
+    case KeyDistribution::kLatest:
+      return num_keys - 1 - latest_.Next(num_keys, rng);
+  }
+  FATAL_INVALID_ENUM_VALUE(KeyDistribution, distribution_);
+}
+
+WorkloadStats::WorkloadStats(int num_threads) {
+  threads_.reserve(num_threads);
+  for (int i = 0; i != num_threads; ++i) {
+    threads_.push_back(std::make_unique<ThreadStats>());
+  }
+}
+
+void WorkloadStats::Record(int thread_index, WorkloadOp op, MonoDelta latency, bool ok) {
+  auto& stats = *threads_[thread_index];
+  const auto op_index = to_underlying(op);
+  std::lock_guard<simple_spinlock> lock(stats.lock);
+  if (!ok) {
+    ++stats.errors[op_index];
+    num_errors_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  auto& histogram = stats.histograms[op_index];
+  if (PREDICT_FALSE(!histogram)) {
+    histogram = NewLatencyHistogram();
+  }
+  histogram->Increment(latency.ToMicroseconds());
+}
+
+void WorkloadStats::ReportInterval(MonoDelta interval) {
+  for (auto& thread : threads_) {
+    // The histograms of a thread are reset along with the merge, so no value goes to two
+    // intervals.
+    std::lock_guard<simple_spinlock> lock(thread->lock);
+    for (auto op : kWorkloadOpList) {
+      const auto op_index = to_underlying(op);
+      auto& totals = totals_[op_index];
+      totals.interval_errors += thread->errors[op_index];
+      thread->errors[op_index] = 0;
+      const auto& histogram = thread->histograms[op_index];
+      if (!histogram || histogram->TotalCount() == 0) {
+        continue;
+      }
+      if (!totals.interval) {
+        totals.interval = NewLatencyHistogram();
+        totals.total = NewLatencyHistogram();
+      }
+      totals.interval->MergeFrom(*histogram);
+      histogram->Reset();
+    }
+  }
+
+  for (auto op : kWorkloadOpList) {
+    auto& totals = totals_[to_underlying(op)];
+    if (!totals.interval) {
+      continue;
+    }
+    Report("interval", interval, op, *totals.interval, totals.interval_errors);
+    totals.total->MergeFrom(*totals.interval);
+    totals.interval->Reset();
+    totals.total_errors += totals.interval_errors;
+    totals.interval_errors = 0;
+  }
+}
+
+void WorkloadStats::ReportTotal(MonoDelta elapsed) {
+  for (auto op : kWorkloadOpList) {
+    const auto& totals = totals_[to_underlying(op)];
+    if (totals.total) {
+      Report("total", elapsed, op, *totals.total, totals.total_errors);
+    }
+  }
+}
+
+void WorkloadStats::Report(
+    const char* title, MonoDelta elapsed, WorkloadOp op, const HdrHistogram& histogram,
+    int64_t errors) {
+  const auto count = histogram.TotalCount();
+  LOG(INFO) << title << " " << op << ": " << count << " ops, "
+            << StringPrintf("%.1f", count / elapsed.ToSeconds()) << " ops/s, "
+            << errors << " errors, latency us: "
+            << StringPrintf("mean %.1f", histogram.MeanValue())
+            << " p50 " << histogram.ValueAtPercentile(50)
+            << " p95 " << histogram.ValueAtPercentile(95)
+            << " p99 " << histogram.ValueAtPercentile(99)
+            << " p99.9 " << histogram.ValueAtPercentile(99.9)
+            << " max " << histogram.MaxValue();
+}
+
+class WorkloadRunner::Worker {
+ public:
+  Worker(WorkloadRunner* runner, WorkloadStats* stats, int index, bool load)
+      : runner_(*runner), options_(runner->options_), stats_(*stats), index_(index), load_(load),
+        rng_(options_.seed + index),
+        chooser_(load ? KeyDistribution::kUniform : options_.spec.distribution, options_.num_keys) {
+    std::vector<double> weights(options_.spec.weights.begin(), options_.spec.weights.end());
+    if (!load) {
+      op_distribution_ = std::discrete_distribution<int>(weights.begin(), weights.end());
+    }
+  }
+
+  void Run() {
+    session_ = runner_.client_->NewSession();
+    session_->SetTimeout(options_.timeout);
+
+    MonoDelta interval;
+    if (!load_ && options_.target_ops_per_sec > 0) {
+      interval = MonoDelta::FromNanoseconds(
+          static_cast<int64_t>(1e9 * options_.num_threads / options_.target_ops_per_sec));
+    }
+    // The schedules of the threads are interleaved, so the operations are evenly spread.
+    auto scheduled = MonoTime::Now() + MonoDelta::FromNanoseconds(
+        interval.ToNanoseconds() * index_ / options_.num_threads);
+    while (!runner_.stop_.load(std::memory_order_acquire)) {
+      if (!load_ && options_.num_operations > 0 &&
+          runner_.remaining_operations_.fetch_sub(1, std::memory_order_relaxed) <= 0) {
+        break;
+      }
+      auto start = MonoTime::Now();
+      if (interval.Initialized()) {
+        scheduled += interval;
+        if (start < scheduled) {
+          SleepFor(scheduled - start);
+        }
+        start = scheduled;
+      }
+
+      const auto op = load_ ? WorkloadOp::kLoad
+                            : static_cast<WorkloadOp>(op_distribution_(rng_));
+      const auto status = Execute(op);
+      if (status.IsEndOfFile()) {
+        break;
+      }
+      if (!status.ok()) {
+        YB_LOG_EVERY_N_SECS(WARNING, 1) << op << " failed: " << status;
+      }
+      stats_.Record(index_, op, MonoTime::Now() - start, status.ok());
+    }
+  }
+
+ private:
+  Status Execute(WorkloadOp op) {
+    switch (op) {
+      case WorkloadOp::kRead:
+        return Read(NextKey());
+      case WorkloadOp::kUpdate:
+        return Write(QLWriteRequestPB::QL_STMT_UPDATE, NextKeys());
+      case WorkloadOp::kInsert:
+        return Write(QLWriteRequestPB::QL_STMT_INSERT, NewKeys());
+      case WorkloadOp::kScan:
+        return Scan(NextKey());
+      case WorkloadOp::kReadModifyWrite:
+        return ReadModifyWrite(NextKeys());
+      case WorkloadOp::kIndexRead:
+        return IndexRead(NextKey());
+      case WorkloadOp::kLoad:
+        return Write(QLWriteRequestPB::QL_STMT_INSERT, LoadKeys());
+    }
+    FATAL_INVALID_ENUM_VALUE(WorkloadOp, op);
+  }
+
+  int64_t NextKey() {
+    return chooser_.Next(
+        std::max<int64_t>(runner_.next_key_.load(std::memory_order_relaxed), 1), &rng_);
+  }
+
+  std::vector<int64_t> NextKeys() {
+    std::vector<int64_t> result(options_.batch_size);
+    for (auto& key : result) {
+      key = NextKey();
+    }
+    return result;
+  }
+
+  std::vector<int64_t> NewKeys() {
+    const auto first = runner_.next_key_.fetch_add(options_.batch_size);
+    std::vector<int64_t> result(options_.batch_size);
+    std::iota(result.begin(), result.end(), first);
+    return result;
+  }
+
+  // Returns the next batch of the initial keys, an empty one when all of them were taken.
+  std::vector<int64_t> LoadKeys() {
+    const auto first = runner_.next_key_.fetch_add(options_.batch_size);
+    std::vector<int64_t> result;
+    for (auto key = first; key < std::min(first + options_.batch_size, options_.num_keys); ++key) {
+      result.push_back(key);
+    }
+    return result;
+  }
+
+  // Starts a transaction for the following operations of the session if the workload is
+  // transactional.
+  client::YBTransactionPtr StartTransaction(bool writes_only) {
+    if (!runner_.transaction_manager_) {
+      return nullptr;
+    }
+    auto transaction = std::make_shared<client::YBTransaction>(runner_.transaction_manager_);
+    CHECK_OK(transaction->Init(IsolationLevel::SNAPSHOT_ISOLATION));
+    // Index updates are written by the tablets in the transaction, so they need its status.
+    if (writes_only && !runner_.index_) {
+      transaction->ExpectSingleFlush();
+    }
+    session_->SetTransaction(transaction);
+    return transaction;
+  }
+
+  Status FinishTransaction(const client::YBTransactionPtr& transaction, const Status& status) {
+    if (!transaction) {
+      return status;
+    }
+    session_->SetTransaction(nullptr);
+    if (!status.ok()) {
+      transaction->Abort();
+      return status;
+    }
+    return transaction->CommitFuture().get();
+  }
+
+  Status Read(int64_t key) {
+    auto op = runner_.table_->NewReadOp();
+    auto* req = op->mutable_request();
+    QLAddStringHashValue(req, KeyForIndex(key));
+    runner_.table_->AddColumns({kKeyColumn, kValueColumn}, req);
+    RETURN_NOT_OK(session_->ApplyAndFlush(op));
+    // Reads may pick keys that are being inserted, so missing rows are not errors.
+    return CheckResponse(op.get());
+  }
+
+  // Writes the keys, or returns EndOfFile when there are none.
+  Status Write(QLWriteRequestPB::QLStmtType type, const std::vector<int64_t>& keys) {
+    if (keys.empty()) {
+      return STATUS(EndOfFile, "No keys left to write");
+    }
+    auto transaction = StartTransaction(/* writes_only */ true);
+    auto status = DoWrite(type, keys);
+    return FinishTransaction(transaction, status);
+  }
+
+  Status DoWrite(QLWriteRequestPB::QLStmtType type, const std::vector<int64_t>& keys) {
+    std::vector<std::shared_ptr<client::YBqlWriteOp>> ops;
+    ops.reserve(keys.size());
+    for (auto key : keys) {
+      auto op = runner_.table_->NewWriteOp(type);
+      auto* req = op->mutable_request();
+      QLAddStringHashValue(req, KeyForIndex(key));
+      const int version = type == QLWriteRequestPB::QL_STMT_INSERT
+          ? 0 : std::uniform_int_distribution<int>(0, kNumValueVersions - 1)(rng_);
+      runner_.table_->AddStringColumnValue(
+          req, kValueColumn, ValueForIndex(key, version, options_.value_size));
+      RETURN_NOT_OK(session_->Apply(op));
+      ops.push_back(std::move(op));
+    }
+    RETURN_NOT_OK(session_->Flush());
+    for (const auto& op : ops) {
+      RETURN_NOT_OK(CheckResponse(op.get()));
+    }
+    return Status::OK();
+  }
+
+  // Scans the rows starting at the partition of the key. Like a single page of a token scan in
+  // CQL, the scan does not go past the tablet of the key, so it may return fewer rows.
+  Status Scan(int64_t key) {
+    auto op = runner_.table_->NewReadOp();
+    auto* req = op->mutable_request();
+    QLAddStringHashValue(req, KeyForIndex(key));
+    QLSetHashCode(req);
+    req->clear_hashed_column_values();
+    req->set_max_hash_code(kMaxHashCode);
+    req->set_limit(
+        std::uniform_int_distribution<int>(1, options_.spec.max_scan_length)(rng_));
+    runner_.table_->AddColumns({kKeyColumn, kValueColumn}, req);
+    RETURN_NOT_OK(session_->ApplyAndFlush(op));
+    return CheckResponse(op.get());
+  }
+
+  Status ReadModifyWrite(const std::vector<int64_t>& keys) {
+    auto transaction = StartTransaction(/* writes_only */ false);
+    Status status;
+    for (auto key : keys) {
+      status = Read(key);
+      if (!status.ok()) {
+        break;
+      }
+    }
+    if (status.ok()) {
+      status = DoWrite(QLWriteRequestPB::QL_STMT_UPDATE, keys);
+    }
+    return FinishTransaction(transaction, status);
+  }
+
+  // Looks up one of the values the key may have in the index, and reads the rows found, as a CQL
+  // query by an indexed column does.
+  Status IndexRead(int64_t key) {
+    if (!runner_.index_) {
+      return STATUS(IllegalState, "Index reads need a table with an index");
+    }
+    const int version = std::uniform_int_distribution<int>(0, kNumValueVersions - 1)(rng_);
+    auto op = runner_.index_->NewReadOp();
+    auto* req = op->mutable_request();
+    QLAddStringHashValue(req, ValueForIndex(key, version, options_.value_size));
+    runner_.index_->AddColumns({kKeyColumn}, req);
+    RETURN_NOT_OK(session_->ApplyAndFlush(op));
+    RETURN_NOT_OK(CheckResponse(op.get()));
+
+    auto rows = VERIFY_RESULT(op->MakeRowBlock());
+    std::vector<std::shared_ptr<client::YBqlReadOp>> reads;
+    for (const auto& row : rows.rows()) {
+      auto read = runner_.table_->NewReadOp();
+      QLAddStringHashValue(read->mutable_request(), row.column(0).string_value());
+      runner_.table_->AddColumns({kKeyColumn, kValueColumn}, read->mutable_request());
+      RETURN_NOT_OK(session_->Apply(read));
+      reads.push_back(std::move(read));
+    }
+    if (reads.empty()) {
+      return Status::OK();
+    }
+    RETURN_NOT_OK(session_->Flush());
+    for (const auto& read : reads) {
+      RETURN_NOT_OK(CheckResponse(read.get()));
+    }
+    return Status::OK();
+  }
+
+  WorkloadRunner& runner_;
+  const WorkloadOptions& options_;
+  WorkloadStats& stats_;
+  const int index_;
+  const bool load_;
+  std::mt19937_64 rng_;
+  KeyChooser chooser_;
+  std::discrete_distribution<int> op_distribution_;
+  client::YBSessionPtr session_;
+};
+
+WorkloadRunner::WorkloadRunner(
+    const WorkloadOptions& options, client::YBClient* client, client::TableHandle* table,
+    client::TableHandle* index, client::TransactionManager* transaction_manager)
+    : options_(options), client_(client), table_(table), index_(index),
+      transaction_manager_(transaction_manager) {
+}
+
+WorkloadRunner::~WorkloadRunner() {
+}
+
+std::string WorkloadRunner::KeyForIndex(int64_t key_index) {
+  return Format("user$0", key_index);
+}
+
+std::string WorkloadRunner::ValueForIndex(int64_t key_index, int version, int value_size) {
+  std::string result = Format("$0_$1_", key_index, version);
+  // Deterministic filler, so the values of a run can be checked and reproduced.
+  uint64_t x = key_index * kNumValueVersions + version;
+  while (result.size() < static_cast<size_t>(value_size)) {
+    result.push_back("0123456789abcdef"[x & 0xf]);
+    x = (x >> 4) * 31 + result.size();
+  }
+  return result;
+}
+
+Status WorkloadRunner::Load() {
+  LOG(INFO) << "Loading " << options_.num_keys << " keys";
+  next_key_ = 0;
+  return RunPhase(/* load */ true);
+}
+
+Status WorkloadRunner::Run() {
+  LOG(INFO) << "Running workload " << options_.spec.ToString();
+  next_key_ = std::max(next_key_.load(), options_.num_keys);
+  remaining_operations_ = options_.num_operations;
+  return RunPhase(/* load */ false);
+}
+
+Status WorkloadRunner::RunPhase(bool load) {
+  stop_ = false;
+  WorkloadStats stats(options_.num_threads);
+  CountDownLatch latch(options_.num_threads);
+  std::vector<std::thread> threads;
+  threads.reserve(options_.num_threads);
+  for (int i = 0; i != options_.num_threads; ++i) {
+    threads.emplace_back([this, &stats, &latch, i, load] {
+      Worker(this, &stats, i, load).Run();
+      latch.CountDown();
+    });
+  }
+
+  const auto start = MonoTime::Now();
+  auto last_report = start;
+  Status result;
+  while (!latch.WaitFor(options_.report_interval)) {
+    const auto now = MonoTime::Now();
+    stats.ReportInterval(now - last_report);
+    last_report = now;
+    if (options_.max_num_errors > 0 && stats.num_errors() > options_.max_num_errors) {
+      result = STATUS_FORMAT(Aborted, "Exceeded the maximum number of errors: $0",
+                             options_.max_num_errors);
+      stop_ = true;
+    } else if (!load && options_.duration.Initialized() && now - start >= options_.duration) {
+      stop_ = true;
+    }
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  const auto now = MonoTime::Now();
+  stats.ReportInterval(now - last_report);
+  stats.ReportTotal(now - start);
+  return result;
+}
+
+} // namespace benchmarks
+} // namespace yb
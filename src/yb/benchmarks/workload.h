@@ -0,0 +1,217 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+
+#ifndef YB_BENCHMARKS_WORKLOAD_H
+#define YB_BENCHMARKS_WORKLOAD_H
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "yb/client/client_fwd.h"
+#include "yb/util/enums.h"
+#include "yb/util/hdr_histogram.h"
+#include "yb/util/locks.h"
+#include "yb/util/monotime.h"
+#include "yb/util/result.h"
+
+namespace yb {
+
+namespace client {
+
+class TableHandle;
+class TransactionManager;
+
+} // namespace client
+
+namespace benchmarks {
+
+// Operations of a benchmark workload, as in YCSB, plus a lookup by the secondary index.
+// kLoad is the insert of the initial data set, reported separately from the run phase.
+YB_DEFINE_ENUM(WorkloadOp, (kRead)(kUpdate)(kInsert)(kScan)(kReadModifyWrite)(kIndexRead)(kLoad));
+
+// How the keys of the operations are picked from the keys inserted so far.
+// kZipfian makes a few keys, scattered over the key space, much hotter than the rest. kLatest makes
+// the most recently inserted keys the hottest.
+YB_DEFINE_ENUM(KeyDistribution, (kUniform)(kZipfian)(kLatest));
+
+struct WorkloadSpec {
+  // Relative weights of the operations, kLoad is ignored.
+  std::array<double, kWorkloadOpMapSize> weights = {};
+  KeyDistribution distribution = KeyDistribution::kUniform;
+  // Scans read a uniformly picked number of rows between 1 and max_scan_length.
+  int max_scan_length = 100;
+
+  // Parses a YCSB core workload name, "a" to "f", or a custom mix like "read:90,index_read:10".
+  // Custom mixes use the uniform distribution.
+  static Result<WorkloadSpec> Parse(const std::string& text);
+
+  bool Uses(WorkloadOp op) const { return weights[to_underlying(op)] > 0; }
+
+  std::string ToString() const;
+};
+
+Result<KeyDistribution> ParseKeyDistribution(const std::string& text);
+
+// Generates Zipfian distributed values in [0, num_items), 0 being the most popular, with the
+// algorithm from "Quickly Generating Billion-Record Synthetic Databases" by Jim Gray et al., which
+// is also the one of YCSB. The number of items may grow between calls, it is accounted for
+// incrementally. Not thread safe.
+class ZipfianGenerator {
+ public:
+  static constexpr double kDefaultTheta = 0.99;
+
+  explicit ZipfianGenerator(int64_t num_items, double theta = kDefaultTheta);
+
+  // Creates the generator from the precomputed zeta(num_items, theta).
+  ZipfianGenerator(int64_t num_items, double theta, double zeta);
+
+  int64_t Next(std::mt19937_64* rng);
+  int64_t Next(int64_t num_items, std::mt19937_64* rng);
+
+ private:
+  void UpdateEta();
+
+  const double theta_;
+  const double alpha_;
+  const double zeta2_;
+  int64_t num_items_;
+  double zetan_;
+  double eta_;
+};
+
+// Picks keys among the first num_keys ones according to a distribution. Not thread safe.
+class KeyChooser {
+ public:
+  KeyChooser(KeyDistribution distribution, int64_t num_keys);
+
+  int64_t Next(int64_t num_keys, std::mt19937_64* rng);
+
+ private:
+  const KeyDistribution distribution_;
+  // Zipfian values over a large fixed item count, scattered over the actual keys by hashing, as
+  // the scrambled Zipfian generator of YCSB does. So the hot keys do not change while keys are
+  // inserted.
+  ZipfianGenerator scrambled_;
+  ZipfianGenerator latest_;
+};
+
+// Latency percentiles per operation, collected by several threads and reported at intervals.
+class WorkloadStats {
+ public:
+  explicit WorkloadStats(int num_threads);
+
+  void Record(int thread_index, WorkloadOp op, MonoDelta latency, bool ok);
+
+  // Logs the percentiles of the operations recorded since the previous call and adds them to the
+  // totals.
+  void ReportInterval(MonoDelta interval);
+
+  // Logs the percentiles of all the operations recorded by ReportInterval() calls.
+  void ReportTotal(MonoDelta elapsed);
+
+  int64_t num_errors() const { return num_errors_.load(std::memory_order_relaxed); }
+
+ private:
+  struct ThreadStats {
+    simple_spinlock lock;
+    std::array<std::unique_ptr<HdrHistogram>, kWorkloadOpMapSize> histograms;
+    std::array<int64_t, kWorkloadOpMapSize> errors = {};
+  };
+
+  struct OpTotals {
+    std::unique_ptr<HdrHistogram> interval;
+    std::unique_ptr<HdrHistogram> total;
+    int64_t interval_errors = 0;
+    int64_t total_errors = 0;
+  };
+
+  void Report(const char* title, MonoDelta elapsed, WorkloadOp op, const HdrHistogram& histogram,
+              int64_t errors);
+
+  std::vector<std::unique_ptr<ThreadStats>> threads_;
+  std::array<OpTotals, kWorkloadOpMapSize> totals_;
+  std::atomic<int64_t> num_errors_{0};
+};
+
+struct WorkloadOptions {
+  WorkloadSpec spec;
+  // Keys inserted by the load phase, the run phase inserts new keys after them.
+  int64_t num_keys = 0;
+  int num_threads = 1;
+  // Total rate of the operations of all threads, 0 for running them back to back.
+  double target_ops_per_sec = 0;
+  // The run phase stops after this time or this many operations, whichever comes first.
+  MonoDelta duration;
+  int64_t num_operations = 0;
+  // Rows written by each insert, update and read-modify-write, and by each write of the load.
+  int batch_size = 1;
+  int value_size = 100;
+  MonoDelta report_interval;
+  MonoDelta timeout;
+  uint64_t seed = 0;
+  int64_t max_num_errors = 0;
+};
+
+// Runs a workload against a table with a string hash key "k" and a string value "v", optionally
+// with a secondary index on "v". Writes are done in distributed transactions when a transaction
+// manager is given, which is required to keep an index consistent.
+//
+// With a target rate each thread schedules its operations at fixed intervals and measures their
+// latency from the scheduled time rather than from the actual start. So the time an operation
+// waits for the previous ones of the thread is included, which is what the driver of an open
+// system would observe. This is what corrects the percentiles for coordinated omission.
+class WorkloadRunner {
+ public:
+  WorkloadRunner(const WorkloadOptions& options, client::YBClient* client,
+                 client::TableHandle* table, client::TableHandle* index,
+                 client::TransactionManager* transaction_manager);
+  ~WorkloadRunner();
+
+  // Inserts the first num_keys keys.
+  CHECKED_STATUS Load();
+
+  // Runs the operations of the workload spec.
+  CHECKED_STATUS Run();
+
+  static std::string KeyForIndex(int64_t key_index);
+
+  // Values of a key are picked among a few versions, so lookups by value can find rows that were
+  // updated.
+  static std::string ValueForIndex(int64_t key_index, int version, int value_size);
+
+ private:
+  class Worker;
+
+  CHECKED_STATUS RunPhase(bool load);
+
+  const WorkloadOptions options_;
+  client::YBClient* const client_;
+  client::TableHandle* const table_;
+  client::TableHandle* const index_;
+  client::TransactionManager* const transaction_manager_;
+
+  // Next key to insert, keys below it are picked by the operations.
+  std::atomic<int64_t> next_key_{0};
+  std::atomic<int64_t> remaining_operations_{0};
+  std::atomic<bool> stop_{false};
+};
+
+} // namespace benchmarks
+} // namespace yb
+
+#endif // YB_BENCHMARKS_WORKLOAD_H
@@ -17,11 +17,14 @@
 
 #include <glog/logging.h>
 #include <boost/bind.hpp>
+#include <boost/optional.hpp>
 #include <boost/thread/mutex.hpp>
 
 #include "yb/client/client.h"
 #include "yb/client/meta_cache.h"
 #include "yb/client/table_handle.h"
+#include "yb/client/transaction_manager.h"
+#include "yb/benchmarks/workload.h"
 #include "yb/common/partition.h"
 #include "yb/yql/redis/redisserver/redis_constants.h"
 #include "yb/yql/redis/redisserver/redis_parser.h"
@@ -31,6 +34,7 @@
 #include "yb/gutil/strings/substitute.h"
 #include "yb/master/master.h"
 #include "yb/master/master.pb.h"
+#include "yb/server/hybrid_clock.h"
 #include "yb/util/atomic.h"
 #include "yb/util/env.h"
 #include "yb/util/flags.h"
@@ -100,6 +104,53 @@ DEFINE_bool(
     stop_on_empty_read, true,
     "Stop reading if we get an empty set of rows on a read operation");
 
+DEFINE_string(workload, "",
+              "Runs a benchmark workload instead of the load test: one of the YCSB core workloads "
+              "'a' to 'f', or a mix of operations with weights like 'read:80,update:20'. The "
+              "operations are read, update, insert, scan, read_modify_write and index_read.");
+
+DEFINE_string(workload_key_distribution, "",
+              "Distribution of the keys of the workload operations: uniform, zipfian or latest. "
+              "Defaults to the one of the YCSB workload, or to uniform for mixes.");
+
+DEFINE_bool(workload_load, true, "Insert num_rows keys before running the workload.");
+
+DEFINE_int32(workload_num_threads, 16, "Number of threads running the workload.");
+
+DEFINE_double(workload_target_ops_per_sec, 0,
+              "Total rate of workload operations. Latencies are measured from the time an "
+              "operation was scheduled, so they are corrected for coordinated omission. 0 runs "
+              "the operations back to back.");
+
+DEFINE_int32(workload_duration_sec, 60,
+             "Stop the workload after this many seconds, 0 for no limit.");
+
+DEFINE_int64(workload_num_operations, 0,
+             "Stop the workload after this many operations, 0 for no limit.");
+
+DEFINE_int32(workload_batch_size, 1,
+             "Number of rows written by each insert, update and read-modify-write operation.");
+
+DEFINE_int32(workload_max_scan_length, 100, "Maximum number of rows read by a scan.");
+
+DEFINE_int32(workload_report_interval_sec, 10,
+             "Interval between the latency percentiles reports of the workload.");
+
+DEFINE_int64(workload_seed, 1,
+             "Seed of the random choices of the workload, for reproducible runs.");
+
+DEFINE_int64(workload_max_num_errors, 1000,
+             "Maximum number of workload errors. The workload is aborted after this number of "
+             "errors.");
+
+DEFINE_bool(workload_transactional, false,
+            "Create a transactional table and do the workload writes in distributed "
+            "transactions.");
+
+DEFINE_bool(workload_secondary_index, false,
+            "Create a secondary index on the values of the workload table, which is kept up to "
+            "date in distributed transactions. Needed for index_read operations.");
+
 using strings::Substitute;
 using std::atomic_long;
 using std::atomic_bool;
@@ -147,6 +198,8 @@ void CreateYBTable(const YBTableName &table_name, const shared_ptr<YBClient> &cl
 
 void LaunchYBLoadTest(SessionFactory *session_factory);
 
+void RunWorkload(const shared_ptr<YBClient> &client);
+
 shared_ptr<YBClient> CreateYBClient();
 
 void SetupYBTable(const shared_ptr<YBClient> &client);
@@ -178,8 +231,14 @@ int main(int argc, char *argv[]) {
   if (!FLAGS_reads_only)
     LOG(INFO) << "num_keys = " << FLAGS_num_rows;
 
+  if (!FLAGS_workload.empty() && use_redis_table) {
+    LOG(FATAL) << "Workloads run against YQL tables only";
+  }
+
   for (int i = 0; i < FLAGS_num_iter; ++i) {
-    if (!use_redis_table) {
+    if (!FLAGS_workload.empty()) {
+      RunWorkload(CreateYBClient());
+    } else if (!use_redis_table) {
       const YBTableName table_name("my_keyspace", FLAGS_table_name);
       shared_ptr<YBClient> client = CreateYBClient();
       SetupYBTable(client);
@@ -379,3 +438,102 @@ void LaunchYBLoadTest(SessionFactory *session_factory) {
     reader.WaitForCompletion();
   }
 }
+
+YBTableName WorkloadIndexName(const YBTableName &table_name) {
+  return YBTableName(table_name.namespace_name(), table_name.table_name() + "_by_value");
+}
+
+void CreateWorkloadTables(
+    const YBTableName &table_name, bool transactional, const shared_ptr<YBClient> &client) {
+  yb::TableProperties table_properties;
+  table_properties.SetTransactional(transactional);
+
+  LOG(INFO) << "Creating workload table";
+  YBSchemaBuilder schema_builder;
+  schema_builder.AddColumn("k")->Type(yb::STRING)->HashPrimaryKey()->NotNull();
+  schema_builder.AddColumn("v")->Type(yb::STRING);
+  schema_builder.SetTableProperties(table_properties);
+  yb::client::TableHandle table;
+  CHECK_OK(table.Create(table_name, FLAGS_num_tablets, client.get(), &schema_builder));
+
+  if (FLAGS_workload_secondary_index) {
+    // Laid out as a CQL index on v: the indexed column is the hash key, followed by the primary
+    // key of the table.
+    LOG(INFO) << "Creating workload index";
+    YBSchemaBuilder index_builder;
+    index_builder.AddColumn("v")->Type(yb::STRING)->HashPrimaryKey()->NotNull();
+    index_builder.AddColumn("k")->Type(yb::STRING)->PrimaryKey()->NotNull();
+    index_builder.SetTableProperties(table_properties);
+    YBSchema index_schema;
+    CHECK_OK(index_builder.Build(&index_schema));
+    gscoped_ptr<YBTableCreator> index_creator(client->NewTableCreator());
+    CHECK_OK(index_creator->table_name(WorkloadIndexName(table_name))
+                 .schema(&index_schema)
+                 .num_tablets(FLAGS_num_tablets)
+                 .indexed_table_id(table->id())
+                 .Create());
+  }
+
+  LOG(INFO) << "Sleeping 10 seconds for leader balancing operations to settle.";
+  sleep(10);
+}
+
+void RunWorkload(const shared_ptr<YBClient> &client) {
+  using yb::benchmarks::WorkloadOptions;
+
+  WorkloadOptions options;
+  options.spec = CHECK_RESULT(yb::benchmarks::WorkloadSpec::Parse(FLAGS_workload));
+  if (!FLAGS_workload_key_distribution.empty()) {
+    options.spec.distribution =
+        CHECK_RESULT(yb::benchmarks::ParseKeyDistribution(FLAGS_workload_key_distribution));
+  }
+  options.spec.max_scan_length = FLAGS_workload_max_scan_length;
+  options.num_keys = FLAGS_num_rows;
+  options.num_threads = FLAGS_workload_num_threads;
+  options.target_ops_per_sec = FLAGS_workload_target_ops_per_sec;
+  if (FLAGS_workload_duration_sec > 0) {
+    options.duration = MonoDelta::FromSeconds(FLAGS_workload_duration_sec);
+  }
+  options.num_operations = FLAGS_workload_num_operations;
+  options.batch_size = FLAGS_workload_batch_size;
+  options.value_size = FLAGS_value_size_bytes;
+  options.report_interval = MonoDelta::FromSeconds(FLAGS_workload_report_interval_sec);
+  options.timeout = MonoDelta::FromSeconds(FLAGS_rpc_timeout_sec);
+  options.seed = FLAGS_workload_seed;
+  options.max_num_errors = FLAGS_workload_max_num_errors;
+
+  if (options.spec.Uses(yb::benchmarks::WorkloadOp::kIndexRead) &&
+      !FLAGS_workload_secondary_index) {
+    LOG(FATAL) << "index_read operations need --workload_secondary_index";
+  }
+  // Indexes are updated in the transactions of the writes, as for CQL tables.
+  const bool transactional = FLAGS_workload_transactional || FLAGS_workload_secondary_index;
+
+  const YBTableName table_name("my_keyspace", FLAGS_table_name);
+  CHECK_OK(client->CreateNamespaceIfNotExists(table_name.namespace_name()));
+  if (!YBTableExistsAlready(client, table_name) || DropTableIfNecessary(client, table_name)) {
+    CreateWorkloadTables(table_name, transactional, client);
+  }
+
+  yb::client::TableHandle table;
+  CHECK_OK(table.Open(table_name, client.get()));
+  boost::optional<yb::client::TableHandle> index;
+  if (FLAGS_workload_secondary_index) {
+    index.emplace();
+    CHECK_OK(index->Open(WorkloadIndexName(table_name), client.get()));
+  }
+
+  boost::optional<yb::client::TransactionManager> transaction_manager;
+  if (transactional) {
+    yb::server::ClockPtr clock(new yb::server::HybridClock());
+    CHECK_OK(clock->Init());
+    transaction_manager.emplace(client, clock, yb::client::LocalTabletFilter());
+  }
+
+  yb::benchmarks::WorkloadRunner runner(
+      options, client.get(), &table, index.get_ptr(), transaction_manager.get_ptr());
+  if (FLAGS_workload_load) {
+    CHECK_OK(runner.Load());
+  }
+  CHECK_OK(runner.Run());
+}
@@ -12,6 +12,9 @@
 //
 
 #include "yb/client/async_rpc.h"
+
+#include <gflags/gflags.h>
+
 #include "yb/client/batcher.h"
 #include "yb/client/client.h"
 #include "yb/client/client-internal.h"
@@ -22,6 +25,8 @@
 #include "yb/common/wire_protocol.h"
 #include "yb/common/transaction.h"
 
+#include "yb/rpc/messenger.h"
+
 #include "yb/util/cast.h"
 #include "yb/util/debug-util.h"
 #include "yb/util/logging.h"
@@ -44,6 +49,15 @@ METRIC_DEFINE_histogram(
     server, handler_latency_yb_client_time_to_send,
     "Time taken for a Write/Read rpc to be sent to the server", yb::MetricUnit::kMicroseconds,
     "Microseconds spent before sending the request to the server", 60000000LU, 2);
+METRIC_DEFINE_counter(
+    server, yb_client_hedged_reads, "Hedged reads", yb::MetricUnit::kRequests,
+    "Number of reads also sent to another replica because the first one was slow to respond");
+METRIC_DEFINE_counter(
+    server, yb_client_hedged_read_wins, "Hedged read wins", yb::MetricUnit::kRequests,
+    "Number of hedged reads that were served by the replica the read was sent to second");
+METRIC_DEFINE_counter(
+    server, yb_client_coalesced_reads, "Coalesced reads", yb::MetricUnit::kRequests,
+    "Number of reads that were not sent because they shared the response of an identical read");
 DECLARE_bool(rpc_dump_all_traces);
 DECLARE_bool(collect_end_to_end_traces);
 
@@ -53,6 +67,18 @@ DEFINE_bool(forward_redis_requests, true, "If false, the redis op will not be se
             "part of the reply and ignores the rest. For now, if this flag is true, we will only "
             "attempt to read from leaders, so redis_allow_reads_from_followers will be ignored.");
 
+DEFINE_bool(hedge_follower_reads, false,
+            "Whether a read that may be served by a follower is also sent to another replica when "
+            "the first one does not respond within the recent 95th percentile latency of the "
+            "tablet. The first successful response is used.");
+
+DEFINE_int32(hedged_read_min_delay_ms, 1,
+             "Minimum time to wait for the first replica before hedging a read.");
+
+DEFINE_bool(coalesce_reads, false,
+            "Whether a read that may be served by a follower waits for an identical read that is "
+            "in flight in the same client and shares its response, instead of being sent.");
+
 DEFINE_bool(detect_duplicates_for_retryable_requests, true,
             "Enable tracking of write requests that prevents the same write from being applied "
                 "twice.");
@@ -94,7 +120,32 @@ AsyncRpcMetrics::AsyncRpcMetrics(const scoped_refptr<yb::MetricEntity>& entity)
       remote_read_rpc_time(METRIC_handler_latency_yb_client_read_remote.Instantiate(entity)),
       local_write_rpc_time(METRIC_handler_latency_yb_client_write_local.Instantiate(entity)),
       local_read_rpc_time(METRIC_handler_latency_yb_client_read_local.Instantiate(entity)),
-      time_to_send(METRIC_handler_latency_yb_client_time_to_send.Instantiate(entity)) {
+      time_to_send(METRIC_handler_latency_yb_client_time_to_send.Instantiate(entity)),
+      hedged_reads(METRIC_yb_client_hedged_reads.Instantiate(entity)),
+      hedged_read_wins(METRIC_yb_client_hedged_read_wins.Instantiate(entity)),
+      coalesced_reads(METRIC_yb_client_coalesced_reads.Instantiate(entity)) {
+}
+
+bool ReadCoalescer::Join(const std::string& key, ReadRpc* rpc) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = waiters_.find(key);
+  if (it == waiters_.end()) {
+    waiters_.emplace(key, std::vector<ReadRpc*>());
+    return true;
+  }
+  it->second.push_back(rpc);
+  return false;
+}
+
+std::vector<ReadRpc*> ReadCoalescer::Finish(const std::string& key) {
+  std::vector<ReadRpc*> result;
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = waiters_.find(key);
+  if (it != waiters_.end()) {
+    result.swap(it->second);
+    waiters_.erase(it);
+  }
+  return result;
 }
 
 AsyncRpc::AsyncRpc(AsyncRpcData* data, YBConsistencyLevel yb_consistency_level)
@@ -135,9 +186,10 @@ void AsyncRpc::SendRpc() {
   // For now, if this is a retry, execute this rpc on the leader even if
   // the consistency level is YBConsistencyLevel::CONSISTENT_PREFIX or
   // FLAGS_redis_allow_reads_from_followers is set to true.
-  // TODO(hector): Temporarily blacklist the follower that couldn't serve the read so we can retry
-  // on another follower.
-  tablet_invoker_.Execute(std::string(), num_attempts() > 1);
+  // Reads with bounded staleness are retried on the closest replica that was not found stale
+  // instead, the invoker falls back to the leader when there is none.
+  tablet_invoker_.Execute(
+      std::string(), num_attempts() > 1 && !batcher_->max_staleness().Initialized());
 }
 
 std::string AsyncRpc::ToString() const {
@@ -219,6 +271,10 @@ bool AsyncRpc::IsLocalCall() const {
   return tablet_invoker_.IsLocalCall();
 }
 
+ReadCoalescer* AsyncRpc::read_coalescer() const {
+  return batcher_->client_->data_->read_coalescer_.get();
+}
+
 namespace {
 
 void SetTransactionMetadata(const TransactionMetadata& metadata, bool may_have_metadata,
@@ -552,11 +608,44 @@ void WriteRpc::ProcessResponseFromTserver(const Status& status) {
   SwapRequestsAndResponses(false);
 }
 
+// The two attempts of a hedged read. Each has its own response and controller, so the attempt that
+// lost could still write into them after the winner has been processed.
+struct ReadRpc::Hedging {
+  struct Attempt {
+    RemoteTabletServer* ts = nullptr;
+    MonoTime start;
+    tserver::ReadResponsePB resp;
+    RpcController controller;
+    bool sent = false;
+    bool finished = false;
+  };
+
+  std::mutex mutex;
+  std::array<Attempt, 2> attempts;
+  MonoTime deadline;
+  // Set when the response of one of the attempts is accepted.
+  bool done = false;
+  rpc::ScheduledTaskId hedge_task_id = rpc::kUninitializedScheduledTaskId;
+  // The copy of the request sent by the second attempt.
+  tserver::ReadRequestPB hedged_req;
+};
+
+struct ReadRpc::CoalescedResponse {
+  tserver::ReadResponsePB resp;
+  // The rows data of the response, by sidecar index.
+  std::vector<std::string> sidecars;
+};
+
 ReadRpc::ReadRpc(AsyncRpcData* data, YBConsistencyLevel yb_consistency_level)
     : AsyncRpcBase(data, yb_consistency_level) {
   TRACE_TO(trace_, "ReadRpc initiated to $0", data->tablet->tablet_id());
   req_.set_consistency_level(yb_consistency_level);
   req_.set_proxy_uuid(data->batcher->proxy_uuid());
+  const auto max_staleness = data->batcher->max_staleness();
+  if (yb_consistency_level == YBConsistencyLevel::CONSISTENT_PREFIX &&
+      max_staleness.Initialized()) {
+    req_.set_max_staleness_ms(std::max<int64_t>(max_staleness.ToMilliseconds(), 1));
+  }
 
   int ctr = 0;
   for (auto& op : ops_) {
@@ -609,7 +698,8 @@ ReadRpc::ReadRpc(AsyncRpcData* data, YBConsistencyLevel yb_consistency_level)
 }
 
 ReadRpc::~ReadRpc() {
-  MonoTime end_time = MonoTime::Now();
+  // A hedged read lives until the attempt that lost finishes, which should not be accounted.
+  MonoTime end_time = hedged_response_time_ ? hedged_response_time_ : MonoTime::Now();
 
   // Get locality metrics if enabled, but skip for system tables as those go to the master.
   if (async_rpc_metrics_ && !table()->name().is_system()) {
@@ -626,12 +716,226 @@ void ReadRpc::CallRemoteMethod() {
                        // Detailed explanation in WriteRpc::SendRpcToTserver.
   TRACE_TO(trace, "SendRpcToTserver");
   ADOPT_TRACE(trace.get());
-  tablet_invoker_.proxy()->ReadAsync(
-      req_, &resp_, PrepareController(),
-      std::bind(&ReadRpc::Finished, this, Status::OK()));
+  // Retries of a sent read keep it registered, identical reads wait for its final response.
+  if (num_attempts() == 1 && CouldCoalesce()) {
+    tserver::ReadRequestPB key_req(req_);
+    key_req.clear_propagated_hybrid_time();
+    key_req.clear_include_trace();
+    key_req.clear_proxy_uuid();
+    auto key = key_req.SerializeAsString();
+    if (!read_coalescer()->Join(key, this)) {
+      TRACE_TO(trace, "Waiting for identical read");
+      if (async_rpc_metrics_) {
+        async_rpc_metrics_->coalesced_reads->Increment();
+      }
+      return;
+    }
+    coalescing_key_ = std::move(key);
+  }
+  SendRead();
   TRACE_TO(trace, "RpcDispatched Asynchronously");
 }
 
+void ReadRpc::SendRead() {
+  if (CouldHedge()) {
+    SendHedgeableRead();
+  } else {
+    tablet_invoker_.proxy()->ReadAsync(
+        req_, &resp_, PrepareController(),
+        std::bind(&ReadRpc::Finished, this, Status::OK()));
+  }
+}
+
+bool ReadRpc::CouldCoalesce() const {
+  // Reads that must see all the writes that completed before they started cannot use the response
+  // of a read that started earlier.
+  return FLAGS_coalesce_reads &&
+         req_.consistency_level() == YBConsistencyLevel::CONSISTENT_PREFIX &&
+         !req_.has_transaction() && req_.redis_batch_size() == 0 && req_.pgsql_batch_size() == 0;
+}
+
+void ReadRpc::FinishCoalescedReads(const Status& status) {
+  auto waiters = read_coalescer()->Finish(coalescing_key_);
+  coalescing_key_.clear();
+  if (waiters.empty()) {
+    return;
+  }
+  // Waiters of a failed read send it themselves, so each of them gets its own error or retries.
+  std::shared_ptr<CoalescedResponse> response;
+  if (status.ok() && !resp_.has_error()) {
+    response = std::make_shared<CoalescedResponse>();
+    response->resp = resp_;
+    for (const auto& ql_response : resp_.ql_batch()) {
+      if (ql_response.has_rows_data_sidecar()) {
+        const size_t sidecar = ql_response.rows_data_sidecar();
+        if (response->sidecars.size() <= sidecar) {
+          response->sidecars.resize(sidecar + 1);
+        }
+        response->sidecars[sidecar] = RowsData(sidecar).ToBuffer();
+      }
+    }
+  }
+  VLOG(3) << ToString() << ": passing response to " << waiters.size() << " identical reads";
+  for (auto* waiter : waiters) {
+    waiter->CoalescedReadFinished(response);
+  }
+}
+
+void ReadRpc::CoalescedReadFinished(const std::shared_ptr<const CoalescedResponse>& response) {
+  if (!response) {
+    TRACE_TO(trace_, "Identical read failed");
+    SendRead();
+    return;
+  }
+  TRACE_TO(trace_, "Using response of identical read");
+  coalesced_response_ = response;
+  resp_.CopyFrom(response->resp);
+  Finished(Status::OK());
+}
+
+Slice ReadRpc::RowsData(int sidecar) const {
+  if (coalesced_response_) {
+    CHECK_LT(sidecar, coalesced_response_->sidecars.size());
+    return coalesced_response_->sidecars[sidecar];
+  }
+  Slice rows_data;
+  CHECK_OK(retrier().controller().GetSidecar(sidecar, &rows_data));
+  return rows_data;
+}
+
+bool ReadRpc::CouldHedge() const {
+  // Only the first attempt is hedged, retries go to the leader.
+  return FLAGS_hedge_follower_reads && num_attempts() == 1 &&
+         req_.consistency_level() == YBConsistencyLevel::CONSISTENT_PREFIX &&
+         !req_.has_transaction() && !IsLocalCall();
+}
+
+void ReadRpc::SendHedgeableRead() {
+  hedging_ = std::make_unique<Hedging>();
+  const auto* prepared = PrepareController();
+  auto& attempt = hedging_->attempts[0];
+  attempt.ts = tablet_invoker_.mutable_current_ts();
+  attempt.start = MonoTime::Now();
+  attempt.sent = true;
+  attempt.controller.set_timeout(prepared->timeout());
+  attempt.controller.set_allow_local_calls_in_curr_thread(
+      prepared->allow_local_calls_in_curr_thread());
+  attempt.controller.set_priority(prepared->priority());
+  hedging_->deadline = attempt.start + prepared->timeout();
+
+  auto self = shared_from_this();
+  tablet_invoker_.proxy()->ReadAsync(
+      req_, &attempt.resp, &attempt.controller, [this, self] { HedgedAttemptFinished(0); });
+
+  // The latencies of the tablet are not known yet, so the read is not hedged.
+  auto delay = tablet_invoker_.tablet()->ReadLatencyP95();
+  if (!delay) {
+    return;
+  }
+  delay = std::max(delay, MonoDelta::FromMilliseconds(FLAGS_hedged_read_min_delay_ms));
+  auto task_id = retrier().messenger()->scheduler().Schedule(
+      [this, self](const Status& status) {
+        if (status.ok()) {
+          SendHedgedCopy();
+        }
+      },
+      delay.ToSteadyDuration());
+  std::lock_guard<std::mutex> lock(hedging_->mutex);
+  hedging_->hedge_task_id = task_id;
+}
+
+void ReadRpc::SendHedgedCopy() {
+  auto& hedging = *hedging_;
+  auto& attempt = hedging.attempts[1];
+  std::shared_ptr<tserver::TabletServerServiceProxy> proxy;
+  {
+    std::lock_guard<std::mutex> lock(hedging.mutex);
+    hedging.hedge_task_id = rpc::kUninitializedScheduledTaskId;
+    if (hedging.done) {
+      return;
+    }
+    // Prefer the leader, it is never behind.
+    auto* first_ts = hedging.attempts[0].ts;
+    auto& tablet = *tablet_invoker_.tablet();
+    RemoteTabletServer* ts = tablet.LeaderTServer();
+    if (!ts || ts == first_ts) {
+      ts = nullptr;
+      std::vector<RemoteTabletServer*> replicas;
+      tablet.GetRemoteTabletServers(&replicas);
+      for (auto* replica : replicas) {
+        if (replica != first_ts) {
+          ts = replica;
+          break;
+        }
+      }
+    }
+    if (!ts || !ts->InitProxy(&tablet_invoker_.client()).ok()) {
+      return;
+    }
+    proxy = ts->proxy();
+    attempt.ts = ts;
+    attempt.start = MonoTime::Now();
+    attempt.sent = true;
+    attempt.controller.set_deadline(hedging.deadline);
+    attempt.controller.set_priority(retrier().controller().priority());
+    // The first attempt could finish and restore the request into the operations right after the
+    // lock is released, so the copy is sent.
+    hedging.hedged_req = req_;
+  }
+  VLOG(2) << ToString() << ": hedging read to " << attempt.ts->ToString();
+  TRACE_TO(trace_, "Hedging read to $0", attempt.ts->ToString());
+  if (async_rpc_metrics_) {
+    async_rpc_metrics_->hedged_reads->Increment();
+  }
+  // The first attempt is accounted by the tablet invoker, the second one here.
+  attempt.ts->RpcStarted();
+  auto self = shared_from_this();
+  proxy->ReadAsync(
+      hedging.hedged_req, &attempt.resp, &attempt.controller,
+      [this, self] { HedgedAttemptFinished(1); });
+}
+
+void ReadRpc::HedgedAttemptFinished(size_t index) {
+  auto& hedging = *hedging_;
+  auto& attempt = hedging.attempts[index];
+  const bool succeeded = attempt.controller.status().ok() && !attempt.resp.has_error();
+  const auto latency = MonoTime::Now().GetDeltaSince(attempt.start);
+  if (succeeded) {
+    tablet_invoker_.tablet()->RecordReadLatency(latency);
+  }
+  if (index == 1) {
+    attempt.ts->RpcFinished(latency, succeeded);
+  }
+  rpc::ScheduledTaskId hedge_task_id;
+  {
+    std::lock_guard<std::mutex> lock(hedging.mutex);
+    attempt.finished = true;
+    if (hedging.done) {
+      return;
+    }
+    const auto& other = hedging.attempts[1 - index];
+    if (!succeeded && other.sent && !other.finished) {
+      return;
+    }
+    hedging.done = true;
+    hedge_task_id = hedging.hedge_task_id;
+  }
+  if (hedge_task_id != rpc::kUninitializedScheduledTaskId) {
+    retrier().messenger()->scheduler().Abort(hedge_task_id);
+  }
+  if (index != 0) {
+    TRACE_TO(trace_, "Hedged read won");
+    if (succeeded && async_rpc_metrics_) {
+      async_rpc_metrics_->hedged_read_wins->Increment();
+    }
+  }
+  hedged_response_time_ = MonoTime::Now();
+  resp_.Swap(&attempt.resp);
+  mutable_retrier()->mutable_controller()->Swap(&attempt.controller);
+  tablet_invoker_.set_current_ts(attempt.ts);
+  Finished(Status::OK());
+}
+
 void ReadRpc::Finished(const Status& status) {
   // It is possible that call succeeded, but failed to send response.
   // So in case of retry to should tell server that it could have metadata.
@@ -707,9 +1011,7 @@ void ReadRpc::SwapRequestsAndResponses(bool skip_responses) {
         ql_op->mutable_response()->Swap(resp_.mutable_ql_batch(ql_idx));
         const auto& ql_response = ql_op->response();
         if (ql_response.has_rows_data_sidecar()) {
-          Slice rows_data;
-          CHECK_OK(retrier().controller().GetSidecar(
-              ql_response.rows_data_sidecar(), &rows_data));
+          Slice rows_data = RowsData(ql_response.rows_data_sidecar());
           ql_op->mutable_rows_data()->assign(util::to_char_ptr(rows_data.data()), rows_data.size());
         }
         ql_idx++;
@@ -763,6 +1065,9 @@ void ReadRpc::ProcessResponseFromTserver(const Status& status) {
   if (resp_.has_trace_buffer()) {
     TRACE_TO(trace_, "Received from server: $0", resp_.trace_buffer());
   }
+  if (!coalescing_key_.empty()) {
+    FinishCoalescedReads(status);
+  }
   batcher_->ProcessReadResponse(*this, status);
   if (!CommonResponseCheck(status)) {
     SwapRequestsAndResponses(true);
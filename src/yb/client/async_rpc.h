@@ -14,6 +14,9 @@
 #ifndef YB_CLIENT_ASYNC_RPC_H_
 #define YB_CLIENT_ASYNC_RPC_H_
 
+#include <mutex>
+#include <unordered_map>
+
 #include "yb/rpc/rpc_fwd.h"
 
 #include "yb/tserver/tserver_service.proxy.h"
@@ -30,6 +33,7 @@ namespace internal {
 
 class Batcher;
 struct InFlightOp;
+class ReadRpc;
 class RemoteTablet;
 class RemoteTabletServer;
 
@@ -42,10 +46,29 @@ struct AsyncRpcMetrics {
   scoped_refptr<Histogram> local_write_rpc_time;
   scoped_refptr<Histogram> local_read_rpc_time;
   scoped_refptr<Histogram> time_to_send;
+  scoped_refptr<Counter> hedged_reads;
+  scoped_refptr<Counter> hedged_read_wins;
+  scoped_refptr<Counter> coalesced_reads;
 };
 
 typedef std::shared_ptr<AsyncRpcMetrics> AsyncRpcMetricsPtr;
 
+// Reads of a client that are identical and in flight at the same time, see --coalesce_reads.
+// Only the first of them is sent, the others wait for it and share its response.
+class ReadCoalescer {
+ public:
+  // Registers the read with the given key. Returns true if there is no identical read in flight,
+  // so 'rpc' should send it. Otherwise 'rpc' waits for the identical read and returns false.
+  bool Join(const std::string& key, ReadRpc* rpc);
+
+  // Unregisters the sent read with the given key, returning the reads that wait for its response.
+  std::vector<ReadRpc*> Finish(const std::string& key);
+
+ private:
+  std::mutex mutex_;
+  std::unordered_map<std::string, std::vector<ReadRpc*>> waiters_;
+};
+
 struct AsyncRpcData {
   scoped_refptr<Batcher> batcher;
   RemoteTablet* tablet = nullptr;
@@ -93,6 +116,8 @@ class AsyncRpc : public rpc::Rpc, public TabletRpc {
   // Is this a local call?
   bool IsLocalCall() const;
 
+  ReadCoalescer* read_coalescer() const;
+
   // Pointer back to the batcher. Processes the write response when it
   // completes, regardless of success or failure.
   scoped_refptr<Batcher> batcher_;
@@ -157,10 +182,55 @@ class ReadRpc : public AsyncRpcBase<tserver::ReadRequestPB, tserver::ReadRespons
   virtual ~ReadRpc();
 
  private:
+  struct Hedging;
+  struct CoalescedResponse;
+
   void Finished(const Status& status) override;
   void SwapRequestsAndResponses(bool skip_responses);
   void CallRemoteMethod() override;
   void ProcessResponseFromTserver(const Status& status) override;
+
+  // Sends the read to the current tablet server.
+  void SendRead();
+
+  // Whether this read could share the response of an identical one, see --coalesce_reads.
+  bool CouldCoalesce() const;
+
+  // Passes the response of the sent read to the identical reads that wait for it.
+  void FinishCoalescedReads(const Status& status);
+
+  // Completes a read that waited for an identical one with its response, or sends the read if the
+  // identical one failed and 'response' is null.
+  void CoalescedReadFinished(const std::shared_ptr<const CoalescedResponse>& response);
+
+  // Returns the rows data of the sidecar with the given index.
+  Slice RowsData(int sidecar) const;
+
+  // Whether a copy of this read could be sent to another replica, see --hedge_follower_reads.
+  bool CouldHedge() const;
+
+  // Sends the read with its own response and controller, so a copy could be sent later if the
+  // replica is slow.
+  void SendHedgeableRead();
+
+  // Sends the copy of the read, unless the first response has already been accepted.
+  void SendHedgedCopy();
+
+  // Accepts the response of the given attempt, unless the response of the other one has already
+  // been accepted. A failed attempt waits for the other one, if it is still in flight.
+  void HedgedAttemptFinished(size_t index);
+
+  // Set when the first attempt of a read is sent with hedging.
+  std::unique_ptr<Hedging> hedging_;
+
+  // When the response of the hedged read was accepted.
+  MonoTime hedged_response_time_;
+
+  // The key of the read in the read coalescer, set when it was sent for identical reads.
+  std::string coalescing_key_;
+
+  // The response shared by an identical read, set when this read waited for it.
+  std::shared_ptr<const CoalescedResponse> coalesced_response_;
 };
 
 }  // namespace internal
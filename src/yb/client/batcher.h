@@ -120,6 +120,16 @@ class Batcher : public RefCountedThreadSafe<Batcher> {
   // "corked" (i.e not yet flushed). Once Flush has been called, this returns 0.
   int CountBufferedOperations() const;
 
+  // Bytes of the requests of the operations added to this batcher, as counted by the session in
+  // the background flush mode.
+  int64_t buffer_bytes_used() const {
+    return buffer_bytes_used_.Load();
+  }
+
+  void AddBufferBytes(int64_t bytes) {
+    buffer_bytes_used_.IncrementBy(bytes);
+  }
+
   // Flush any buffered operations. The callback will be called once there are no
   // more pending operations from this Batcher. If all of the operations succeeded,
   // then the callback will receive Status::OK. Otherwise, it will receive IOError,
@@ -147,6 +157,14 @@ class Batcher : public RefCountedThreadSafe<Batcher> {
     force_consistent_read_ = value;
   }
 
+  void SetMaxStaleness(MonoDelta max_staleness) {
+    max_staleness_ = max_staleness;
+  }
+
+  MonoDelta max_staleness() const {
+    return max_staleness_;
+  }
+
   YBTransactionPtr transaction() const;
 
   const TransactionMetadata& transaction_metadata() const {
@@ -303,6 +321,10 @@ class Batcher : public RefCountedThreadSafe<Batcher> {
   // Force consistent read on transactional table, even we have only single shard commands.
   bool force_consistent_read_;
 
+  // Bound on the staleness of the replicas that serve follower reads, see
+  // YBSession::SetMaxStaleness.
+  MonoDelta max_staleness_;
+
   DISALLOW_COPY_AND_ASSIGN(Batcher);
 };
 
@@ -44,6 +44,7 @@
 
 #include <boost/preprocessor/seq/for_each.hpp>
 
+#include "yb/client/async_rpc.h"
 #include "yb/client/meta_cache.h"
 #include "yb/client/table-internal.h"
 #include "yb/common/index.h"
@@ -80,6 +81,11 @@ DEFINE_test_flag(bool, assert_local_tablet_server_selected, false, "Verify that
 DEFINE_test_flag(string, assert_tablet_server_select_is_in_zone, "", "Verify that SelectTServer "
                  "selected a talet server in the AZ specified by this flag.");
 
+DEFINE_bool(select_replicas_by_latency, true,
+            "Whether, among the replicas closest to the client by placement, reads that may be "
+            "served by any replica choose the one with the lowest recent latency and load.");
+TAG_FLAG(select_replicas_by_latency, advanced);
+
 DECLARE_string(flagfile);
 
 namespace yb {
@@ -288,7 +294,8 @@ YB_CLIENT_SPECIALIZE_SIMPLE(IsTruncateTableDone);
 YB_CLIENT_SPECIALIZE_SIMPLE(IsDeleteTableDone);
 
 YBClient::Data::Data()
-    : leader_master_rpc_(rpcs_.InvalidHandle()),
+    : read_coalescer_(new internal::ReadCoalescer()),
+      leader_master_rpc_(rpcs_.InvalidHandle()),
       latest_observed_hybrid_time_(YBClient::kNoHybridTime),
       id_(ClientId::GenerateRandom()) {}
 
@@ -304,6 +311,60 @@ YBClient::Data::~Data() {
   rpcs_.Shutdown();
 }
 
+int YBClient::Data::PlacementDistance(const RemoteTabletServer& ts) const {
+  if (IsTabletServerLocal(ts)) {
+    return 0;
+  }
+  const auto& ts_cloud_info = ts.cloud_info();
+  if (!cloud_info_pb_.has_placement_region() || !ts_cloud_info.has_placement_region() ||
+      cloud_info_pb_.placement_region() != ts_cloud_info.placement_region()) {
+    return 3;
+  }
+  if (cloud_info_pb_.has_placement_zone() && ts_cloud_info.has_placement_zone() &&
+      cloud_info_pb_.placement_zone() == ts_cloud_info.placement_zone()) {
+    return 1;
+  }
+  return 2;
+}
+
+RemoteTabletServer* YBClient::Data::SelectClosestTServer(
+    const vector<RemoteTabletServer*>& candidates) const {
+  if (candidates.empty()) {
+    return nullptr;
+  }
+  // Replicas are ordered by placement first: the local tserver, then the same zone, the same
+  // region and the rest. Among replicas with the same placement the one expected to respond first
+  // is chosen, and a replica without a recent latency counts as the fastest, so it gets measured.
+  // Ties are broken at random, to spread the load.
+  RemoteTabletServer* ret = nullptr;
+  int best_distance = std::numeric_limits<int>::max();
+  int64_t best_latency_us = std::numeric_limits<int64_t>::max();
+  const size_t offset = rand() % candidates.size();
+  for (size_t i = 0; i != candidates.size(); ++i) {
+    RemoteTabletServer* rts = candidates[(offset + i) % candidates.size()];
+    const int distance = PlacementDistance(*rts);
+    if (distance == 0) {
+      return rts;
+    }
+    if (distance > best_distance) {
+      continue;
+    }
+    int64_t latency_us = 0;
+    if (FLAGS_select_replicas_by_latency) {
+      auto expected = rts->ExpectedLatency();
+      if (expected) {
+        latency_us = expected.ToMicroseconds();
+      }
+    }
+    if (distance < best_distance || latency_us < best_latency_us) {
+      ret = rts;
+      best_distance = distance;
+      best_latency_us = latency_us;
+    }
+  }
+  return ret;
+}
+
 RemoteTabletServer* YBClient::Data::SelectTServer(RemoteTablet* rt,
                                                   const ReplicaSelection selection,
                                                   const set<string>& blacklist,
@@ -344,35 +405,7 @@ RemoteTabletServer* YBClient::Data::SelectTServer(RemoteTablet* rt,
           ret = filtered[0];
         }
       } else if (selection == CLOSEST_REPLICA) {
-        // Choose the closest replica.
-        bool local_zone_ts = false;
-        for (RemoteTabletServer* rts : filtered) {
-          if (IsTabletServerLocal(*rts)) {
-            ret = rts;
-            // If the tserver is local, we are done here.
-            break;
-          } else if (cloud_info_pb_.has_placement_region() &&
-                     rts->cloud_info().has_placement_region() &&
-                     cloud_info_pb_.placement_region() == rts->cloud_info().placement_region()) {
-            if (cloud_info_pb_.has_placement_zone() && rts->cloud_info().has_placement_zone() &&
-                cloud_info_pb_.placement_zone() == rts->cloud_info().placement_zone()) {
-              // Note down that we have found a zone local tserver and continue looking for node
-              // local tserver.
-              ret = rts;
-              local_zone_ts = true;
-            } else if (!local_zone_ts) {
-              // Look for a region local tserver only if we haven't found a zone local tserver yet.
-              ret = rts;
-            }
-          }
-        }
-
-        // If ret is not null here, it should point to the closest replica from the client.
-
-        // Fallback to a random replica if none are local.
-        if (ret == nullptr && !filtered.empty()) {
-          ret = filtered[rand() % filtered.size()];
-        }
+        ret = SelectClosestTServer(filtered);
       }
       break;
     }
@@ -65,6 +65,10 @@ class MasterServiceProxy;
 
 namespace client {
 
+namespace internal {
+class ReadCoalescer;
+} // namespace internal
+
 class YBClient::Data {
  public:
   Data();
@@ -161,6 +165,15 @@ class YBClient::Data {
 
   bool IsTabletServerLocal(const internal::RemoteTabletServer& rts) const;
 
+  // How far the tablet server is from the client: 0 if it is local, 1 if it is in the same zone,
+  // 2 if it is in the same region and 3 otherwise.
+  int PlacementDistance(const internal::RemoteTabletServer& rts) const;
+
+  // Returns the candidate closest to the client by placement and, among equally close ones, the
+  // one with the lowest expected latency. Returns NULL if there are no candidates.
+  internal::RemoteTabletServer* SelectClosestTServer(
+      const std::vector<internal::RemoteTabletServer*>& candidates) const;
+
   // Returns a non-failed replica of the specified tablet based on the provided selection criteria
   // and tablet server blacklist.
   //
@@ -255,6 +268,7 @@ class YBClient::Data {
   std::unique_ptr<rpc::ProxyCache> proxy_cache_;
   gscoped_ptr<DnsResolver> dns_resolver_;
   scoped_refptr<internal::MetaCache> meta_cache_;
+  const std::unique_ptr<internal::ReadCoalescer> read_coalescer_;
   scoped_refptr<MetricEntity> metric_entity_;
 
   // Set of hostnames and IPs on the local host.
@@ -934,6 +934,24 @@ TEST_F(ClientTest, TestAsyncFlushResponseAfterSessionDropped) {
   ASSERT_OK(s.Wait());
 }
 
+// The isolated flush should send only its own operation, and should not leave it in the session
+// when it is done.
+TEST_F(ClientTest, TestApplyAndFlushIsolatedAsync) {
+  auto session = CreateSession();
+  ASSERT_OK(ApplyInsertToSession(session.get(), client_table_, 1, 1, "row"));
+
+  Synchronizer s;
+  ASSERT_OK(session->ApplyAndFlushIsolatedAsync(
+      BuildTestRow(client_table_, 2), s.AsStatusFunctor()));
+  ASSERT_OK(s.Wait());
+  ASSERT_EQ(1, session->CountBufferedOperations());
+  ASSERT_EQ(0, session->CountPendingErrors());
+  ASSERT_EQ(1, CountRowsFromClient(client_table_));
+
+  ASSERT_OK(session->Flush());
+  ASSERT_EQ(2, CountRowsFromClient(client_table_));
+}
+
 TEST_F(ClientTest, TestSessionClose) {
   auto session = CreateSession();
   ASSERT_OK(ApplyInsertToSession(session.get(), client_table_, 1, 1, "row"));
@@ -1645,6 +1663,31 @@ TEST_F(ClientTest, TestSeveralRowMutatesPerBatch) {
 
 // Tests that master permits are properly released after a whole bunch of
 // rows are inserted.
+// Checks that the background flush mode sends the operations without Flush, once the batch reaches
+// the thresholds and after the linger time, also when Apply has to wait for memory.
+TEST_F(ClientTest, BackgroundFlush) {
+  constexpr int kNumRows = 105;
+  int first_row = 0;
+  for (size_t max_pending_bytes : {64 * 1024 * 1024, 1024}) {
+    SCOPED_TRACE(Format("max_pending_bytes: $0", max_pending_bytes));
+    auto session = CreateSession();
+    BackgroundFlushOptions options;
+    options.max_buffered_ops = 10;
+    options.max_linger = MonoDelta::FromMilliseconds(100);
+    options.max_pending_bytes = max_pending_bytes;
+    session->SetBackgroundFlush(options);
+    for (int i = first_row; i != first_row + kNumRows; ++i) {
+      ASSERT_OK(session->Apply(BuildTestRow(client_table_, i)));
+    }
+    first_row += kNumRows;
+    // The last rows do not reach the threshold, so they are sent after the linger time.
+    ASSERT_OK(WaitFor([&session] { return !session->HasPendingOperations(); },
+                      10s, "Background flush"));
+    ASSERT_EQ(0, session->CountPendingErrors());
+    ASSERT_EQ(first_row, CountRowsFromClient(client_table_));
+  }
+}
+
 TEST_F(ClientTest, TestMasterLookupPermits) {
   int initial_value = client_->data_->meta_cache_->master_lookup_sem_.GetValue();
   ASSERT_NO_FATALS(InsertTestRows(client_table_, FLAGS_test_scan_num_rows));
@@ -1652,6 +1695,61 @@ TEST_F(ClientTest, TestMasterLookupPermits) {
             client_->data_->meta_cache_->master_lookup_sem_.GetValue());
 }
 
+// Checks that a single lookup in a small table caches the locations of all its tablets.
+TEST_F(ClientTest, TestMetaCachePrefetch) {
+  constexpr int kPrefetchTablets = 8;
+  const YBTableName kPrefetchTableName(kKeyspaceName, "prefetch-table");
+  TableHandle table;
+  ASSERT_NO_FATALS(CreateTable(kPrefetchTableName, kPrefetchTablets, &table));
+
+  shared_ptr<YBClient> client;
+  ASSERT_OK(YBClientBuilder()
+      .add_master_server_addr(ToString(cluster_->mini_master()->bound_rpc_addr()))
+      .Build(&client));
+  shared_ptr<YBTable> client_table;
+  ASSERT_OK(client->OpenTable(kPrefetchTableName, &client_table));
+  const auto& partitions = client_table->GetPartitions();
+  ASSERT_EQ(kPrefetchTablets, static_cast<int>(partitions.size()));
+
+  auto& meta_cache = client->data_->meta_cache_;
+  ASSERT_OK(meta_cache->LookupTabletByKeyFuture(
+      client_table.get(), partitions.back(), MonoTime::Now() + 10s).get());
+
+  boost::shared_lock<decltype(meta_cache->mutex_)> lock(meta_cache->mutex_);
+  for (const auto& partition : partitions) {
+    ASSERT_NE(nullptr, meta_cache->LookupTabletByKeyFastPathUnlocked(
+        client_table.get(), partition)) << "Not cached: " << Slice(partition).ToDebugHexString();
+  }
+}
+
+// Checks the latency that replica selection expects from a tablet server.
+TEST_F(ClientTest, TestTabletServerExpectedLatency) {
+  TSInfoPB ts_info;
+  ts_info.set_permanent_uuid("ts");
+  internal::RemoteTabletServer ts(ts_info);
+  ASSERT_FALSE(ts.ExpectedLatency());
+
+  ts.RpcStarted();
+  ts.RpcFinished(MonoDelta::FromMicroseconds(1000), /* succeeded = */ false);
+  ASSERT_FALSE(ts.ExpectedLatency());
+
+  ts.RpcStarted();
+  ts.RpcFinished(MonoDelta::FromMicroseconds(1000), /* succeeded = */ true);
+  ASSERT_EQ(1000, ts.ExpectedLatency().ToMicroseconds());
+
+  // A new sample moves the average a fifth of the way.
+  ts.RpcStarted();
+  ts.RpcFinished(MonoDelta::FromMicroseconds(6000), /* succeeded = */ true);
+  ASSERT_EQ(2000, ts.ExpectedLatency().ToMicroseconds());
+
+  // Each RPC in flight adds the average latency.
+  ts.RpcStarted();
+  ts.RpcStarted();
+  ASSERT_EQ(6000, ts.ExpectedLatency().ToMicroseconds());
+  ts.RpcFinished(MonoDelta::FromMicroseconds(2000), /* succeeded = */ true);
+  ASSERT_EQ(4000, ts.ExpectedLatency().ToMicroseconds());
+}
+
 // Define callback for deadlock simulation, as well as various helper methods.
 namespace {
 
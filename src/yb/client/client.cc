@@ -538,7 +538,8 @@ Status YBClient::CreateNamespace(const std::string& namespace_name,
                                  const std::string& creator_role_name,
                                  const std::string& namespace_id,
                                  const std::string& source_namespace_id,
-                                 const boost::optional<uint32_t>& next_pg_oid) {
+                                 const boost::optional<uint32_t>& next_pg_oid,
+                                 bool colocated) {
   CreateNamespaceRequestPB req;
   CreateNamespaceResponsePB resp;
   req.set_name(namespace_name);
@@ -557,6 +558,9 @@ Status YBClient::CreateNamespace(const std::string& namespace_name,
   if (next_pg_oid) {
     req.set_next_pg_oid(*next_pg_oid);
   }
+  if (colocated) {
+    req.set_colocated(true);
+  }
   CALL_SYNC_LEADER_MASTER_RPC(req, resp, CreateNamespace);
   return Status::OK();
 }
@@ -980,6 +984,10 @@ const std::string& YBClient::proxy_uuid() const {
   return data_->uuid_;
 }
 
+const CloudInfoPB& YBClient::cloud_info() const {
+  return data_->cloud_info_pb_;
+}
+
 const ClientId& YBClient::id() const {
   return data_->id_;
 }
@@ -1813,10 +1821,31 @@ void YBSession::FlushAsync(StatusFunctor callback) {
   data_->FlushAsync(std::move(callback));
 }
 
+Status YBSession::ApplyAndFlushIsolatedAsync(YBOperationPtr yb_op, StatusFunctor callback) {
+  return data_->ApplyAndFlushIsolatedAsync(std::move(yb_op), std::move(callback));
+}
+
 std::future<Status> YBSession::FlushFuture() {
   return MakeFuture<Status>([this](auto callback) { this->FlushAsync(std::move(callback)); });
 }
 
+ChainableFuture<Status> YBSession::FlushChainableFuture() {
+  return MakeChainableFuture<Status>([this](auto callback) {
+    this->FlushAsync(std::move(callback));
+  });
+}
+
+ChainableFuture<Status> YBSession::ApplyAndFlushChainableFuture(
+    const std::vector<YBOperationPtr>& ops) {
+  Status s = Apply(ops);
+  if (!s.ok()) {
+    ChainablePromise<Status> promise;
+    promise.Set(std::move(s));
+    return promise.GetFuture();
+  }
+  return FlushChainableFuture();
+}
+
 bool YBSession::HasPendingOperations() const {
   return data_->HasPendingOperations();
 }
@@ -1833,6 +1862,12 @@ void YBSession::ReadAsync(std::shared_ptr<YBOperation> yb_op, StatusFunctor call
   FlushAsync(std::move(callback));
 }
 
+ChainableFuture<Status> YBSession::ReadChainableFuture(std::shared_ptr<YBOperation> yb_op) {
+  return MakeChainableFuture<Status>([this, &yb_op](auto callback) {
+    this->ReadAsync(std::move(yb_op), std::move(callback));
+  });
+}
+
 Status YBSession::Apply(std::shared_ptr<YBOperation> yb_op) {
   return data_->Apply(std::move(yb_op));
 }
@@ -1882,6 +1917,14 @@ void YBSession::SetForceConsistentRead(bool value) {
   data_->SetForceConsistentRead(value);
 }
 
+void YBSession::SetMaxStaleness(MonoDelta max_staleness) {
+  data_->SetMaxStaleness(max_staleness);
+}
+
+void YBSession::SetBackgroundFlush(const BackgroundFlushOptions& options) {
+  data_->SetBackgroundFlush(options);
+}
+
 ////////////////////////////////////////////////////////////
 // YBTableAlterer
 ////////////////////////////////////////////////////////////
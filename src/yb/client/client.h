@@ -68,6 +68,7 @@
 
 #include "yb/rpc/rpc_fwd.h"
 
+#include "yb/util/chainable_future.h"
 #include "yb/util/enums.h"
 #include "yb/util/monotime.h"
 #include "yb/util/net/net_fwd.h"
@@ -309,7 +310,8 @@ class YBClient : public std::enable_shared_from_this<YBClient> {
 
   // Namespace related methods.
 
-  // Create a new namespace with the given name.
+  // Create a new namespace with the given name. The tables of a colocated namespace share one
+  // tablet.
   // TODO(neil) When database_type is undefined, backend will not check error on database type.
   // Except for testing we should use proper database_types for all creations.
   CHECKED_STATUS CreateNamespace(const std::string& namespace_name,
@@ -317,7 +319,8 @@ class YBClient : public std::enable_shared_from_this<YBClient> {
                                  const std::string& creator_role_name = "",
                                  const std::string& namespace_id = "",
                                  const std::string& source_namespace_id = "",
-                                 const boost::optional<uint32_t>& next_pg_oid = boost::none);
+                                 const boost::optional<uint32_t>& next_pg_oid = boost::none,
+                                 bool colocated = false);
 
   // It calls CreateNamespace(), but before it checks that the namespace has NOT been yet
   // created. So, it prevents error 'namespace already exists'.
@@ -536,6 +539,9 @@ class YBClient : public std::enable_shared_from_this<YBClient> {
 
   const std::string& proxy_uuid() const;
 
+  // Placement of this client, as set by YBClientBuilder::set_cloud_info_pb.
+  const CloudInfoPB& cloud_info() const;
+
   // Id of this client instance.
   const ClientId& id() const;
 
@@ -564,6 +570,7 @@ class YBClient : public std::enable_shared_from_this<YBClient> {
   FRIEND_TEST(ClientTest, TestGetTabletServerBlacklist);
   FRIEND_TEST(ClientTest, TestMasterDown);
   FRIEND_TEST(ClientTest, TestMasterLookupPermits);
+  FRIEND_TEST(ClientTest, TestMetaCachePrefetch);
   FRIEND_TEST(ClientTest, TestReplicatedMultiTabletTableFailover);
   FRIEND_TEST(ClientTest, TestReplicatedTabletWritesWithLeaderElection);
   FRIEND_TEST(ClientTest, TestScanFaultTolerance);
@@ -958,6 +965,22 @@ typedef std::vector<std::unique_ptr<YBError>> CollectedErrors;
 
 class YBSessionData;
 
+// Thresholds of the background flush mode of YBSession, see YBSession::SetBackgroundFlush.
+struct BackgroundFlushOptions {
+  // The buffered operations are flushed once there are this many of them,
+  size_t max_buffered_ops = 1000;
+
+  // or once their requests take this many bytes,
+  size_t max_buffered_bytes = 1024 * 1024;
+
+  // or once the first of them has been buffered for this long.
+  MonoDelta max_linger = MonoDelta::FromMilliseconds(5);
+
+  // Apply blocks while the requests of the buffered and in-flight operations take more than this
+  // many bytes, for at most the session timeout.
+  size_t max_pending_bytes = 64 * 1024 * 1024;
+};
+
 YB_STRONGLY_TYPED_BOOL(VerifyResponse);
 YB_STRONGLY_TYPED_BOOL(Restart);
 
@@ -1030,6 +1053,9 @@ class YBSession : public std::enable_shared_from_this<YBSession> {
 
   void ReadAsync(std::shared_ptr<YBOperation> yb_op, StatusFunctor callback);
 
+  // ReadAsync that returns a future which can be continued without blocking a thread.
+  ChainableFuture<Status> ReadChainableFuture(std::shared_ptr<YBOperation> yb_op);
+
   // TODO: add "doAs" ability here for proxy servers to be able to act on behalf of
   // other users, assuming access rights.
 
@@ -1090,8 +1116,25 @@ class YBSession : public std::enable_shared_from_this<YBSession> {
   // For FlushAsync, 'cb' must remain valid until it is invoked.
   CHECKED_STATUS Flush() WARN_UNUSED_RESULT;
   void FlushAsync(StatusFunctor callback);
+
+  // Sends the operation in a batch of its own, leaving the operations buffered in the session
+  // untouched, and calls 'callback' with the status of the operation when it is done. Unlike
+  // Apply and FlushAsync, the error of the operation is passed to the callback and is not kept in
+  // the session. If the operation could not be added to the batch, returns the error without
+  // calling 'callback'. Could be called from any thread, including the callback of another
+  // flush, and concurrently with other calls on the session.
+  CHECKED_STATUS ApplyAndFlushIsolatedAsync(YBOperationPtr yb_op, StatusFunctor callback);
   std::future<Status> FlushFuture();
 
+  // FlushAsync that returns a future which can be continued without blocking a thread, e.g.
+  // to commit the transaction once the flush is done. The futures of several sessions could be
+  // combined with WhenAllOk, so one thread can keep many flushes in flight.
+  ChainableFuture<Status> FlushChainableFuture();
+
+  // Applies the operations and flushes them, see FlushChainableFuture. A failure to apply an
+  // operation is returned through the future.
+  ChainableFuture<Status> ApplyAndFlushChainableFuture(const std::vector<YBOperationPtr>& ops);
+
   // Abort the unflushed or in-flight operations in the session.
   void Abort();
 
@@ -1141,6 +1184,22 @@ class YBSession : public std::enable_shared_from_this<YBSession> {
   // It is useful when whole statement is executed using multiple flushes.
   void SetForceConsistentRead(bool value);
 
+  // Sets how far behind the leader a follower may be to serve the reads of this session that are
+  // allowed to go to followers, i.e. CONSISTENT_PREFIX reads. Such reads go to the closest replica
+  // whose safe time is at most max_staleness behind its clock, and to the leader if there is
+  // none. An uninitialized value means no bound.
+  void SetMaxStaleness(MonoDelta max_staleness);
+
+  // Turns on the background flush mode: instead of waiting for Flush, the session sends the
+  // buffered operations in the background once they reach the thresholds in 'options'. The
+  // operations are then grouped by tablet as in a regular flush. Errors of the background flushes
+  // are only reported through GetPendingErrors. Flush still sends the operations buffered so far
+  // and waits for them, but not for the operations already sent in the background. Operations of
+  // different flushes could be applied in any order.
+  //
+  // In this mode Apply is thread safe and could block, see BackgroundFlushOptions.
+  void SetBackgroundFlush(const BackgroundFlushOptions& options);
+
  private:
   friend class YBClient;
   friend class internal::Batcher;
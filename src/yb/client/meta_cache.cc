@@ -30,6 +30,7 @@
 // under the License.
 //
 
+#include <algorithm>
 #include <mutex>
 
 #include <boost/bind.hpp>
@@ -66,9 +67,19 @@ DEFINE_test_flag(bool, verify_all_replicas_alive, false,
                  "If set, when a RemoteTablet object is destroyed, we will verify that all its "
                  "replicas are not marked as failed");
 
+DEFINE_int32(meta_cache_prefetch_max_tablets, 256,
+             "Locations of all tablets of tables with at most this number of tablets are fetched "
+             "from master with a single lookup, on the first use of the table.");
+TAG_FLAG(meta_cache_prefetch_max_tablets, advanced);
+
 DEFINE_int32(retry_failed_replica_ms, 60 * 1000,
              "Time in milliseconds to wait for before retrying a failed replica");
 
+DEFINE_int32(replica_latency_expiration_ms, 10 * 1000,
+             "Time in milliseconds after which the latency measured for a tablet server is "
+             "forgotten, so the server is tried again by replica selection.");
+TAG_FLAG(replica_latency_expiration_ms, advanced);
+
 METRIC_DEFINE_histogram(
   server, dns_resolve_latency_during_init_proxy,
   "yb.client.MetaCache.InitProxy DNS Resolve",
@@ -106,6 +117,16 @@ const size_t kPartitionGroupSize = 64;
 const size_t kPartitionGroupSize = 4;
 #endif
 
+// Returns the number of partitions whose locations are requested with a single lookup. Small
+// tables are requested whole, so all concurrent lookups in such table share one master RPC.
+size_t PartitionGroupSize(const YBTable* table) {
+  const size_t num_partitions = table->GetPartitions().size();
+  if (num_partitions <= static_cast<size_t>(FLAGS_meta_cache_prefetch_max_tablets)) {
+    return std::max<size_t>(num_partitions, 1);
+  }
+  return kPartitionGroupSize;
+}
+
 } // namespace
 
 ////////////////////////////////////////////////////////////
@@ -208,6 +229,46 @@ bool RemoteTabletServer::HasHostFrom(const std::unordered_set<std::string>& host
   return false;
 }
 
+void RemoteTabletServer::RpcStarted() {
+  rpcs_in_flight_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void RemoteTabletServer::RpcFinished(MonoDelta latency, bool succeeded) {
+  // Weight of a new sample in the moving average.
+  constexpr int64_t kEwmaWeightPercent = 20;
+
+  rpcs_in_flight_.fetch_sub(1, std::memory_order_relaxed);
+  if (!succeeded) {
+    return;
+  }
+  const auto now = MonoTime::Now();
+  const auto latency_us = latency.ToMicroseconds();
+  std::lock_guard<simple_spinlock> l(lock_);
+  if (!latency_update_time_ ||
+      now.GetDeltaSince(latency_update_time_).ToMilliseconds() >
+          FLAGS_replica_latency_expiration_ms) {
+    latency_ewma_us_ = latency_us;
+  } else {
+    latency_ewma_us_ += (latency_us - latency_ewma_us_) * kEwmaWeightPercent / 100;
+  }
+  latency_update_time_ = now;
+}
+
+MonoDelta RemoteTabletServer::ExpectedLatency() const {
+  int64_t latency_us;
+  {
+    std::lock_guard<simple_spinlock> l(lock_);
+    if (!latency_update_time_ ||
+        MonoTime::Now().GetDeltaSince(latency_update_time_).ToMilliseconds() >
+            FLAGS_replica_latency_expiration_ms) {
+      return MonoDelta();
+    }
+    latency_us = latency_ewma_us_;
+  }
+  const auto in_flight = std::max(rpcs_in_flight_.load(std::memory_order_relaxed), 0);
+  return MonoDelta::FromMicroseconds(latency_us * (in_flight + 1));
+}
+
 ////////////////////////////////////////////////////////////
 
 RemoteTablet::~RemoteTablet() {
@@ -340,6 +401,35 @@ void RemoteTablet::GetRemoteTabletServers(vector<RemoteTabletServer*>* servers)
   }
 }
 
+void RemoteTablet::RecordReadLatency(MonoDelta latency) {
+  // The percentile is recalculated once there are this many samples, and then after each
+  // kReadLatencyRecalculateInterval samples.
+  constexpr size_t kReadLatencyMinSamples = 16;
+  constexpr size_t kReadLatencyRecalculateInterval = 8;
+
+  std::array<int64_t, kReadLatencySamples> samples;
+  size_t num_samples;
+  {
+    std::lock_guard<simple_spinlock> l(lock_);
+    read_latencies_us_[num_read_latencies_ % kReadLatencySamples] = latency.ToMicroseconds();
+    ++num_read_latencies_;
+    if (num_read_latencies_ < kReadLatencyMinSamples ||
+        num_read_latencies_ % kReadLatencyRecalculateInterval != 0) {
+      return;
+    }
+    num_samples = std::min(num_read_latencies_, kReadLatencySamples);
+    std::copy_n(read_latencies_us_.begin(), num_samples, samples.begin());
+  }
+  auto p95 = samples.begin() + num_samples * 95 / 100;
+  std::nth_element(samples.begin(), p95, samples.begin() + num_samples);
+  read_latency_p95_us_.store(std::max<int64_t>(*p95, 1), std::memory_order_release);
+}
+
+MonoDelta RemoteTablet::ReadLatencyP95() const {
+  const auto p95 = read_latency_p95_us_.load(std::memory_order_acquire);
+  return p95 ? MonoDelta::FromMicroseconds(p95) : MonoDelta();
+}
+
 void RemoteTablet::MarkTServerAsLeader(const RemoteTabletServer* server) {
   bool found = false;
   std::lock_guard<simple_spinlock> l(lock_);
@@ -637,6 +727,9 @@ RemoteTabletPtr MetaCache::ProcessTabletLocations(
                     remote->partition().partition_key_end());
 
           VLOG(3) << "Refreshing tablet " << tablet_id << ": " << loc.ShortDebugString();
+          // A tablet shared by several tables, like the tablet of a colocated namespace, is
+          // cached once but has to be found through each of its tables.
+          tablets_by_key.emplace(remote->partition().partition_key_start(), remote);
         } else {
           VLOG(3) << "Caching tablet " << tablet_id << ": " << loc.ShortDebugString();
 
@@ -833,7 +926,7 @@ class LookupByKeyRpc : public LookupRpc {
     // Fill out the request.
     req_.mutable_table()->set_table_id(table_->id());
     req_.set_partition_key_start(partition_group_start_);
-    req_.set_max_returned_locations(kPartitionGroupSize);
+    req_.set_max_returned_locations(PartitionGroupSize(table_.get()));
 
     // The end partition key is left unset intentionally so that we'll prefetch
     // some additional tablets.
@@ -931,7 +1024,7 @@ void MetaCache::LookupTabletByKey(const YBTable* table,
   }
 
   const std::string& partition_group_start =
-      table->FindPartitionStart(partition_start, kPartitionGroupSize);
+      table->FindPartitionStart(partition_start, PartitionGroupSize(table));
   {
     std::unique_lock<boost::shared_mutex> lock(mutex_);
     if (FastLookupTabletByKeyUnlocked(table, partition_start, callback, &lock)) {
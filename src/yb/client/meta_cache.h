@@ -33,6 +33,7 @@
 #ifndef YB_CLIENT_META_CACHE_H
 #define YB_CLIENT_META_CACHE_H
 
+#include <array>
 #include <map>
 #include <string>
 #include <memory>
@@ -96,6 +97,7 @@ class TSInfoPB;
 namespace client {
 
 class ClientTest_TestMasterLookupPermits_Test;
+class ClientTest_TestMetaCachePrefetch_Test;
 class YBClient;
 class YBTable;
 
@@ -146,10 +148,25 @@ class RemoteTabletServer {
 
   const CloudInfoPB& cloud_info() const;
 
+  // Account an RPC sent to this server and, when it succeeded, the latency of its response.
+  void RpcStarted();
+  void RpcFinished(MonoDelta latency, bool succeeded);
+
+  // Expected latency of the next RPC to this server: the moving average of the latencies of its
+  // recent RPCs, scaled by the number of RPCs in flight. Uninitialized if no recent latency is
+  // known.
+  MonoDelta ExpectedLatency() const;
+
  private:
   mutable simple_spinlock lock_;
   const std::string uuid_;
 
+  std::atomic<int> rpcs_in_flight_{0};
+  // Exponentially weighted moving average of RPC latencies, and the time it was last updated.
+  // Protected by lock_.
+  int64_t latency_ewma_us_ = 0;
+  MonoTime latency_update_time_;
+
   google::protobuf::RepeatedPtrField<HostPortPB> public_rpc_hostports_;
   google::protobuf::RepeatedPtrField<HostPortPB> private_rpc_hostports_;
   yb::CloudInfoPB cloud_info_pb_;
@@ -269,10 +286,19 @@ class RemoteTablet : public RefCountedThreadSafe<RemoteTablet> {
 
   MonoTime refresh_time() { return refresh_time_.load(std::memory_order_acquire); }
 
+  // Records the latency of a read served by a replica of this tablet.
+  void RecordReadLatency(MonoDelta latency);
+
+  // Returns the 95th percentile of the recent read latencies, used as the delay before hedging a
+  // read. Uninitialized until enough reads were recorded.
+  MonoDelta ReadLatencyP95() const;
+
  private:
   // Same as ReplicasAsString(), except that the caller must hold lock_.
   std::string ReplicasAsStringUnlocked() const;
 
+  static constexpr size_t kReadLatencySamples = 64;
+
   const std::string tablet_id_;
   const Partition partition_;
 
@@ -285,6 +311,13 @@ class RemoteTablet : public RefCountedThreadSafe<RemoteTablet> {
   // checking whether it has been initialized everytime we use this value.
   std::atomic<MonoTime> refresh_time_{MonoTime::Min()};
 
+  // Ring of the latencies of the recent reads, in microseconds, protected by lock_.
+  std::array<int64_t, kReadLatencySamples> read_latencies_us_;
+  size_t num_read_latencies_ = 0;
+
+  // The 95th percentile of read_latencies_us_, recalculated every few reads. Zero when unknown.
+  std::atomic<int64_t> read_latency_p95_us_{0};
+
   DISALLOW_COPY_AND_ASSIGN(RemoteTablet);
 };
 
@@ -362,6 +395,7 @@ class MetaCache : public RefCountedThreadSafe<MetaCache> {
   friend class LookupByIdRpc;
 
   FRIEND_TEST(client::ClientTest, TestMasterLookupPermits);
+  FRIEND_TEST(client::ClientTest, TestMetaCachePrefetch);
 
   // Lookup the given tablet by key, only consulting local information.
   // Returns true and sets *remote_tablet if successful.
@@ -32,6 +32,7 @@
 
 #include "yb/yql/cql/ql/util/statement_result.h"
 
+DECLARE_bool(coalesce_reads);
 DECLARE_bool(mini_cluster_reuse_data);
 DECLARE_bool(rocksdb_disable_compactions);
 DECLARE_int32(yb_num_shards_per_tserver);
@@ -1260,6 +1261,39 @@ TEST_F(QLDmlTest, ReadFollower) {
   ASSERT_TRUE(missing_rows.empty()) << "Missing rows: " << yb::ToString(missing_rows);
 }
 
+// Checks that follower reads of the same keys from concurrent sessions get the right rows when
+// identical reads share responses.
+TEST_F(QLDmlTest, CoalesceReads) {
+  constexpr size_t kNumRows = 10;
+  constexpr int kNumThreads = 8;
+  constexpr size_t kReadsPerThread = 200;
+  FLAGS_coalesce_reads = true;
+
+  ASSERT_NO_FATALS(InsertRows(kNumRows));
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i != kNumThreads; ++i) {
+    threads.emplace_back([this] {
+      auto session = NewSession();
+      for (size_t j = 0; j != kReadsPerThread; ++j) {
+        const size_t index = j % kNumRows;
+        auto row = ReadRow(session, KeyForIndex(index), YBConsistencyLevel::CONSISTENT_PREFIX);
+        // The follower could have not applied the row yet.
+        if (!row.ok() && row.status().IsNotFound()) {
+          continue;
+        }
+        EXPECT_OK(row);
+        if (row.ok()) {
+          EXPECT_EQ(ValueForIndex(index), *row);
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
 TEST_F(QLDmlTest, DeletePartialRangeKey) {
   auto session = NewSession();
   RowKey row_key{1, "a", 2, "b"};
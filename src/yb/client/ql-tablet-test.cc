@@ -22,6 +22,8 @@
 #include "yb/client/ql-dml-test-base.h"
 #include "yb/client/table_handle.h"
 
+#include "yb/common/wire_protocol.h"
+
 #include "yb/consensus/consensus.h"
 #include "yb/consensus/consensus.pb.h"
 
@@ -306,6 +308,55 @@ class QLTabletTest : public QLDmlTestBase {
     return Status::OK();
   }
 
+  Result<tserver::MiniTabletServer*> FindLeaderServer(const TabletId& tablet_id) {
+    for (int i = 0; i != cluster_->num_tablet_servers(); ++i) {
+      auto* server = cluster_->mini_tablet_server(i);
+      tablet::TabletPeerPtr peer;
+      if (server->server()->tablet_manager()->LookupTablet(tablet_id, &peer) &&
+          peer->LeaderStatus() == consensus::LeaderStatus::LEADER_AND_READY) {
+        return server;
+      }
+    }
+    return STATUS_FORMAT(NotFound, "No leader found for $0", tablet_id);
+  }
+
+  // Ingests the data of table 1 into table 2 through Raft, using the source leader's RocksDB
+  // directory for all replicas, since the mini cluster servers share the file system.
+  CHECKED_STATUS IngestReplicated() {
+    std::this_thread::sleep_for(1s); // Wait until all tablets a synced and flushed.
+    RETURN_NOT_OK(cluster_->FlushTablets());
+
+    auto source_infos = GetTabletInfos(kTable1Name);
+    auto dest_infos = GetTabletInfos(kTable2Name);
+    EXPECT_EQ(source_infos.size(), dest_infos.size());
+    for (size_t i = 0; i != source_infos.size(); ++i) {
+      auto* source_server = VERIFY_RESULT(FindLeaderServer(source_infos[i]->id()));
+      tablet::TabletPeerPtr source_peer;
+      source_server->server()->tablet_manager()->LookupTablet(source_infos[i]->id(), &source_peer);
+
+      auto* dest_server = VERIFY_RESULT(FindLeaderServer(dest_infos[i]->id()));
+      auto endpoint = dest_server->server()->rpc_server()->GetBoundAddresses().front();
+      tserver::TabletServerServiceProxy proxy(
+          &dest_server->server()->proxy_cache(), HostPort::FromBoundEndpoint(endpoint));
+
+      tserver::IngestExternalFilesRequestPB req;
+      req.set_tablet_id(dest_infos[i]->id());
+      req.set_source_dir(source_peer->tablet()->metadata()->rocksdb_dir());
+      tserver::IngestExternalFilesResponsePB resp;
+      rpc::RpcController controller;
+      controller.set_timeout(30s);
+      RETURN_NOT_OK(proxy.IngestExternalFiles(req, &resp, &controller));
+      if (resp.has_error()) {
+        auto status = StatusFromPB(resp.error().status());
+        // Tablets of table 1 that did not get any keys have nothing to ingest.
+        if (!status.IsNotFound()) {
+          return status;
+        }
+      }
+    }
+    return Status::OK();
+  }
+
   scoped_refptr<master::TableInfo> GetTableInfo(const YBTableName& table_name) {
     auto* catalog_manager = cluster_->leader_mini_master()->master()->catalog_manager();
     std::vector<scoped_refptr<master::TableInfo>> all_tables;
@@ -377,6 +428,22 @@ TEST_F(QLTabletTest, ImportToNonEmptyAndRestart) {
   VerifyTable(0, 2 * kTotalKeys, &table2_);
 }
 
+TEST_F(QLTabletTest, ReplicatedIngestAndRestart) {
+  CreateTables(0, kBigSeqNo);
+
+  FillTable(0, kTotalKeys, &table1_);
+  FillTable(kTotalKeys, 2 * kTotalKeys, &table2_);
+  ASSERT_OK(IngestReplicated());
+  VerifyTable(0, 2 * kTotalKeys, &table2_);
+  // Followers apply the ingest operation themselves.
+  ASSERT_OK(WaitSync(0, kTotalKeys, &table2_));
+
+  // The operation must not be replayed on top of the already ingested files.
+  ASSERT_OK(cluster_->RestartSync());
+  VerifyTable(0, kTotalKeys, &table1_);
+  VerifyTable(0, 2 * kTotalKeys, &table2_);
+}
+
 TEST_F(QLTabletTest, LateImport) {
   CreateTables(kBigSeqNo, 0);
 
@@ -660,6 +727,30 @@ TEST_F(QLTabletTest, SkewedClocks) {
   cluster_.reset();
 }
 
+TEST_F(QLTabletTest, BoundedStalenessReads) {
+  constexpr int kNumKeys = 100;
+
+  TableHandle table;
+  CreateTable(kTable1Name, &table, 1);
+  FillTable(0, kNumKeys, &table);
+
+  // Followers are rarely within 1ms of their clock, so most of the reads with that bound are
+  // rejected by them and retried on the leader.
+  for (auto max_staleness : {MonoDelta::FromSeconds(10), MonoDelta::FromMilliseconds(1)}) {
+    auto session = CreateSession();
+    session->SetMaxStaleness(max_staleness);
+    for (int i = 0; i != kNumKeys; ++i) {
+      auto op = CreateReadOp(i, &table);
+      op->set_yb_consistency_level(YBConsistencyLevel::CONSISTENT_PREFIX);
+      ASSERT_OK(session->ApplyAndFlush(op));
+      ASSERT_EQ(QLResponsePB::YQL_STATUS_OK, op->response().status());
+      auto rowblock = RowsResult(op.get()).GetRowBlock();
+      ASSERT_EQ(1, rowblock->row_count());
+      ASSERT_EQ(ValueForKey(i), rowblock->row(0).column(0).int32_value());
+    }
+  }
+}
+
 TEST_F(QLTabletTest, LeaderChange) {
   const int32_t kKey = 1;
   const int32_t kValue1 = 2;
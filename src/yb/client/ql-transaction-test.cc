@@ -43,6 +43,7 @@ using yb::tablet::GetTransactionTimeout;
 using yb::tablet::TabletPeer;
 
 DECLARE_uint64(transaction_heartbeat_usec);
+DECLARE_uint64(transaction_heartbeat_batch_window_usec);
 DECLARE_uint64(log_segment_size_bytes);
 DECLARE_int32(log_min_seconds_to_retain);
 DECLARE_uint64(max_clock_skew_usec);
@@ -84,6 +85,26 @@ TEST_F(QLTransactionTest, Simple) {
   CheckNoRunningTransactions();
 }
 
+TEST_F(QLTransactionTest, SingleShard) {
+  auto txn = CreateTransaction();
+  txn->ExpectSingleFlush();
+  ASSERT_OK(WriteRow(CreateSession(txn), 0 /* key */, 1 /* value */));
+  ASSERT_EQ(0, CountIntents());
+  ASSERT_OK(txn->CommitFuture().get());
+  VERIFY_ROW(CreateSession(), 0 /* key */, 1 /* value */);
+  CheckNoRunningTransactions();
+}
+
+TEST_F(QLTransactionTest, ReadOnly) {
+  WriteData();
+  auto txn = CreateTransaction();
+  VerifyRows(CreateSession(txn));
+  // The reads did not involve the coordinator.
+  ASSERT_EQ(0, CountTransactions());
+  ASSERT_OK(txn->CommitFuture().get());
+  CheckNoRunningTransactions();
+}
+
 TEST_F(QLTransactionTest, LookupTabletFailure) {
   FLAGS_master_inject_latency_on_transactional_tablet_lookups_ms =
       TransactionRpcTimeout().ToMilliseconds() + 500;
@@ -399,6 +420,29 @@ TEST_F(QLTransactionTest, Heartbeat) {
   CheckNoRunningTransactions();
 }
 
+TEST_F(QLTransactionTest, BatchedHeartbeat) {
+  constexpr size_t kTransactions = 5;
+  FLAGS_transaction_heartbeat_batch_window_usec = 10000;
+
+  std::vector<YBTransactionPtr> transactions;
+  for (size_t i = 0; i != kTransactions; ++i) {
+    transactions.push_back(CreateTransaction());
+    auto session = CreateSession(transactions.back());
+    WriteRows(session, i);
+  }
+  std::this_thread::sleep_for(GetTransactionTimeout() * 2);
+  CountDownLatch latch(kTransactions);
+  for (const auto& txn : transactions) {
+    txn->Commit([&latch](const Status& status) {
+      EXPECT_OK(status);
+      latch.CountDown();
+    });
+  }
+  latch.Wait();
+  VerifyData(kTransactions);
+  CheckNoRunningTransactions();
+}
+
 TEST_F(QLTransactionTest, Expire) {
   SetDisableHeartbeatInTests(true);
   auto txn = CreateTransaction();
@@ -696,7 +740,9 @@ TEST_F(QLTransactionTest, ResolveIntentsWriteReadWithinTransactionAndRollback) {
     VERIFY_ROW(session, 2, 2);
   }
 
-  ASSERT_EQ(CountIntents(), 0);
+  // Intents of aborted transactions are removed in the background.
+  ASSERT_OK(WaitFor([this] { return CountIntents() == 0; }, 10s * kTimeMultiplier,
+                    "Intents of aborted transaction are removed"));
 
   ASSERT_OK(cluster_->RestartSync());
 }
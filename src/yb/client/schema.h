@@ -259,6 +259,7 @@ class YBColumnSpec {
   // Add JSON operation.
   YBColumnSpec* JsonOp(JsonOperatorPB op, const std::string& str_value);
   YBColumnSpec* JsonOp(JsonOperatorPB op, int32_t int_value);
+  YBColumnSpec* JsonOp(JsonOperatorPB op, const QLValuePB& value);
 
   // Operations only relevant for Alter Table
   // ------------------------------------------------------------
@@ -279,8 +280,6 @@ class YBColumnSpec {
 
   CHECKED_STATUS ToColumnSchema(YBColumnSchema* col) const;
 
-  YBColumnSpec* JsonOp(JsonOperatorPB op, const QLValuePB& value);
-
   // Owned.
   Data* data_;
 };
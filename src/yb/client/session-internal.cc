@@ -67,23 +67,42 @@ YBSessionData::~YBSessionData() {
 }
 
 void YBSessionData::SetTransaction(YBTransactionPtr transaction) {
+  std::lock_guard<std::mutex> lock(batcher_mutex_);
   transaction_ = std::move(transaction);
   internal::BatcherPtr old_batcher;
   old_batcher.swap(batcher_);
   if (old_batcher) {
     LOG_IF(DFATAL, old_batcher->HasPendingOperations()) << "SetTransaction with non empty batcher";
     old_batcher->Abort(STATUS(Aborted, "Transaction changed"));
+    ReleasePendingBytesUnlocked(*old_batcher);
   }
 }
 
 void YBSessionData::FlushFinished(internal::BatcherPtr batcher) {
-  std::lock_guard<simple_spinlock> l(lock_);
-  CHECK_EQ(flushed_batchers_.erase(batcher), 1);
+  {
+    std::lock_guard<simple_spinlock> l(lock_);
+    CHECK_EQ(flushed_batchers_.erase(batcher), 1);
+  }
+  if (batcher->buffer_bytes_used() != 0) {
+    std::lock_guard<std::mutex> lock(batcher_mutex_);
+    ReleasePendingBytesUnlocked(*batcher);
+  }
+}
+
+void YBSessionData::ReleasePendingBytesUnlocked(const internal::Batcher& batcher) {
+  const size_t bytes = batcher.buffer_bytes_used();
+  if (bytes != 0) {
+    DCHECK_GE(pending_bytes_, bytes);
+    pending_bytes_ -= bytes;
+    pending_bytes_cond_.notify_all();
+  }
 }
 
 void YBSessionData::Abort() {
+  std::lock_guard<std::mutex> lock(batcher_mutex_);
   if (batcher_ && batcher_->HasPendingOperations()) {
     batcher_->Abort(STATUS(Aborted, "Batch aborted"));
+    ReleasePendingBytesUnlocked(*batcher_);
     batcher_.reset();
   }
 }
@@ -98,11 +117,13 @@ void YBSessionData::SetReadPoint(const Restart restart) {
 }
 
 Status YBSessionData::Close(bool force) {
+  std::lock_guard<std::mutex> lock(batcher_mutex_);
   if (batcher_) {
     if (batcher_->HasPendingOperations() && !force) {
       return STATUS(IllegalState, "Could not close. There are pending operations.");
     }
     batcher_->Abort(STATUS(Aborted, "Batch aborted"));
+    ReleasePendingBytesUnlocked(*batcher_);
     batcher_.reset();
   }
   return Status::OK();
@@ -117,19 +138,95 @@ void YBSessionData::FlushAsync(StatusFunctor callback) {
   // the batch fails "inline" on the same thread.
 
   internal::BatcherPtr old_batcher;
-  old_batcher.swap(batcher_);
+  {
+    std::lock_guard<std::mutex> lock(batcher_mutex_);
+    old_batcher.swap(batcher_);
+  }
   if (old_batcher) {
-    {
-      std::lock_guard<simple_spinlock> l(lock_);
-      flushed_batchers_.insert(old_batcher);
-    }
-    old_batcher->set_allow_local_calls_in_curr_thread(allow_local_calls_in_curr_thread_);
-    old_batcher->FlushAsync(std::move(callback));
+    FlushBatcher(
+        std::move(old_batcher), std::move(callback), allow_local_calls_in_curr_thread_);
   } else {
     callback(Status::OK());
   }
 }
 
+Status YBSessionData::ApplyAndFlushIsolatedAsync(YBOperationPtr yb_op, StatusFunctor callback) {
+  // The batch has a collector of its own, so errors of other batches of the session do not mix
+  // with the error of this operation.
+  scoped_refptr<ErrorCollector> error_collector(new ErrorCollector());
+  internal::BatcherPtr batcher;
+  {
+    std::lock_guard<std::mutex> lock(batcher_mutex_);
+    batcher.reset(new internal::Batcher(
+        client_.get(), error_collector.get(), shared_from_this(), transaction_, read_point(),
+        force_consistent_read_));
+    if (timeout_.Initialized()) {
+      batcher->SetTimeout(timeout_);
+    }
+    batcher->SetMaxStaleness(max_staleness_);
+  }
+  Status s = batcher->Add(yb_op);
+  if (!s.ok()) {
+    batcher->Abort(s);
+    return s;
+  }
+  FlushBatcher(
+      std::move(batcher),
+      [error_collector, callback = std::move(callback)](const Status& status) {
+        auto errors = error_collector->GetErrors();
+        callback(errors.empty() ? status : errors.front()->status());
+      },
+      false /* allow_local_calls_in_curr_thread */);
+  return Status::OK();
+}
+
+void YBSessionData::FlushBatcher(internal::BatcherPtr batcher, StatusFunctor callback,
+                                 bool allow_local_calls_in_curr_thread) {
+  {
+    std::lock_guard<simple_spinlock> l(lock_);
+    flushed_batchers_.insert(batcher);
+  }
+  batcher->set_allow_local_calls_in_curr_thread(allow_local_calls_in_curr_thread);
+  batcher->FlushAsync(std::move(callback));
+}
+
+void YBSessionData::SetBackgroundFlush(const BackgroundFlushOptions& options) {
+  CHECK(options.max_linger.Initialized());
+  std::lock_guard<std::mutex> lock(batcher_mutex_);
+  background_flush_ = options;
+  if (batcher_) {
+    ScheduleLingerFlush();
+  }
+}
+
+void YBSessionData::ScheduleLingerFlush() {
+  std::weak_ptr<YBSessionData> weak_self = shared_from_this();
+  const auto generation = batcher_generation_;
+  client_->messenger()->scheduler().Schedule(
+      [weak_self, generation](const Status& status) {
+        auto self = weak_self.lock();
+        if (status.ok() && self) {
+          self->LingerFlush(generation);
+        }
+      },
+      background_flush_->max_linger.ToSteadyDuration());
+}
+
+void YBSessionData::LingerFlush(uint64_t batcher_generation) {
+  internal::BatcherPtr batcher;
+  {
+    std::lock_guard<std::mutex> lock(batcher_mutex_);
+    if (batcher_generation != batcher_generation_) {
+      return;
+    }
+    batcher.swap(batcher_);
+  }
+  if (batcher) {
+    // The scheduler runs this on a reactor thread, which should not execute local calls.
+    FlushBatcher(std::move(batcher), [](const Status&) {}, false);
+  }
+}
+
 bool YBSessionData::allow_local_calls_in_curr_thread() const {
   return allow_local_calls_in_curr_thread_;
 }
@@ -157,12 +254,63 @@ internal::Batcher& YBSessionData::Batcher() {
     if (timeout_.Initialized()) {
       batcher_->SetTimeout(timeout_);
     }
+    batcher_->SetMaxStaleness(max_staleness_);
+    ++batcher_generation_;
+    if (background_flush_) {
+      ScheduleLingerFlush();
+    }
   }
   return *batcher_;
 }
 
+Status YBSessionData::WaitForPendingBytes(size_t bytes, std::unique_lock<std::mutex>* lock) {
+  const auto limit = background_flush_->max_pending_bytes;
+  // An operation larger than the limit is let through when nothing else is pending.
+  auto fits = [this, bytes, limit] {
+    return pending_bytes_ == 0 || pending_bytes_ + bytes <= limit;
+  };
+  if (fits()) {
+    return Status::OK();
+  }
+  const auto deadline = std::chrono::steady_clock::now() + timeout_.ToSteadyDuration();
+  if (!pending_bytes_cond_.wait_until(*lock, deadline, fits)) {
+    return STATUS_FORMAT(
+        TimedOut, "Timed out waiting for $0 bytes of pending operations to drop below $1",
+        pending_bytes_, limit);
+  }
+  return Status::OK();
+}
+
+Status YBSessionData::Add(const YBOperationPtr& yb_op) {
+  internal::BatcherPtr to_flush;
+  {
+    std::unique_lock<std::mutex> lock(batcher_mutex_);
+    size_t bytes = 0;
+    if (background_flush_) {
+      bytes = yb_op->space_used_by_request();
+      RETURN_NOT_OK(WaitForPendingBytes(bytes, &lock));
+    }
+    auto& batcher = Batcher();
+    RETURN_NOT_OK(batcher.Add(yb_op));
+    if (background_flush_) {
+      batcher.AddBufferBytes(bytes);
+      pending_bytes_ += bytes;
+      if (static_cast<size_t>(batcher.CountBufferedOperations()) >=
+              background_flush_->max_buffered_ops ||
+          static_cast<size_t>(batcher.buffer_bytes_used()) >=
+              background_flush_->max_buffered_bytes) {
+        to_flush.swap(batcher_);
+      }
+    }
+  }
+  if (to_flush) {
+    FlushBatcher(std::move(to_flush), [](const Status&) {}, allow_local_calls_in_curr_thread_);
+  }
+  return Status::OK();
+}
+
 Status YBSessionData::Apply(YBOperationPtr yb_op) {
-  Status s = Batcher().Add(yb_op);
+  Status s = Add(yb_op);
   if (!PREDICT_FALSE(s.ok())) {
     error_collector_->AddError(yb_op, s);
     return s;
@@ -178,9 +326,8 @@ Status YBSessionData::ApplyAndFlush(YBOperationPtr yb_op) {
 }
 
 Status YBSessionData::Apply(const std::vector<YBOperationPtr>& ops) {
-  auto& batcher = Batcher();
   for (const auto& op : ops) {
-    Status s = batcher.Add(op);
+    Status s = Add(op);
     if (!PREDICT_FALSE(s.ok())) {
       error_collector_->AddError(op, s);
       return s;
@@ -213,6 +360,7 @@ Status YBSessionData::Flush() {
 
 void YBSessionData::SetTimeout(MonoDelta timeout) {
   CHECK_GE(timeout, MonoDelta::kZero);
+  std::lock_guard<std::mutex> lock(batcher_mutex_);
   timeout_ = timeout;
   if (batcher_) {
     batcher_->SetTimeout(timeout);
@@ -220,12 +368,16 @@ void YBSessionData::SetTimeout(MonoDelta timeout) {
 }
 
 int YBSessionData::CountBufferedOperations() const {
+  std::lock_guard<std::mutex> lock(batcher_mutex_);
   return batcher_ ? batcher_->CountBufferedOperations() : 0;
 }
 
 bool YBSessionData::HasPendingOperations() const {
-  if (batcher_ && batcher_->HasPendingOperations()) {
-    return true;
+  {
+    std::lock_guard<std::mutex> lock(batcher_mutex_);
+    if (batcher_ && batcher_->HasPendingOperations()) {
+      return true;
+    }
   }
   std::lock_guard<simple_spinlock> l(lock_);
   for (const auto& b : flushed_batchers_) {
@@ -245,11 +397,20 @@ CollectedErrors YBSessionData::GetPendingErrors() {
 }
 
 void YBSessionData::SetForceConsistentRead(bool value) {
+  std::lock_guard<std::mutex> lock(batcher_mutex_);
   force_consistent_read_ = value;
   if (batcher_) {
     batcher_->SetForceConsistentRead(value);
   }
 }
 
+void YBSessionData::SetMaxStaleness(MonoDelta max_staleness) {
+  std::lock_guard<std::mutex> lock(batcher_mutex_);
+  max_staleness_ = max_staleness;
+  if (batcher_) {
+    batcher_->SetMaxStaleness(max_staleness);
+  }
+}
+
 }  // namespace client
 }  // namespace yb
@@ -32,9 +32,14 @@
 #ifndef YB_CLIENT_SESSION_INTERNAL_H_
 #define YB_CLIENT_SESSION_INTERNAL_H_
 
+#include <condition_variable>
+#include <mutex>
 #include <unordered_set>
 
+#include <boost/optional.hpp>
+
 #include "yb/client/async_rpc.h"
+#include "yb/client/client.h"
 #include "yb/common/consistent_read_point.h"
 #include "yb/util/locks.h"
 
@@ -68,6 +73,9 @@ class YBSessionData : public std::enable_shared_from_this<YBSessionData> {
 
   void FlushAsync(StatusFunctor callback);
 
+  // See YBSession::ApplyAndFlushIsolatedAsync.
+  CHECKED_STATUS ApplyAndFlushIsolatedAsync(YBOperationPtr yb_op, StatusFunctor callback);
+
   CHECKED_STATUS Flush();
 
   // Called by Batcher when a flush has finished.
@@ -106,13 +114,41 @@ class YBSessionData : public std::enable_shared_from_this<YBSessionData> {
 
   void SetForceConsistentRead(bool value);
 
+  void SetMaxStaleness(MonoDelta max_staleness);
+
   void SetInTxnLimit(HybridTime value);
 
+  void SetBackgroundFlush(const BackgroundFlushOptions& options);
+
  private:
   ConsistentReadPoint* read_point();
 
+  // Returns the batcher being prepared, starting a new one if needed. Should be called with
+  // batcher_mutex_ held.
   internal::Batcher& Batcher();
 
+  // Adds the operation to the batcher being prepared. In the background flush mode, first waits
+  // for the pending operations to fit into the memory limit, and then flushes the batcher if it
+  // reached the thresholds.
+  CHECKED_STATUS Add(const YBOperationPtr& yb_op);
+
+  // Waits, with batcher_mutex_ held by 'lock', until 'bytes' more fit into the memory limit of
+  // the background flush mode.
+  CHECKED_STATUS WaitForPendingBytes(size_t bytes, std::unique_lock<std::mutex>* lock);
+
+  void FlushBatcher(internal::BatcherPtr batcher, StatusFunctor callback,
+                    bool allow_local_calls_in_curr_thread);
+
+  // Schedules the flush of the current batcher after the linger time of the background flush
+  // mode. Should be called with batcher_mutex_ held.
+  void ScheduleLingerFlush();
+
+  // Flushes the current batcher, if it has not been replaced since the linger flush was scheduled.
+  void LingerFlush(uint64_t batcher_generation);
+
+  // Releases memory accounted for the operations of the finished or aborted batcher.
+  void ReleasePendingBytesUnlocked(const internal::Batcher& batcher);
+
   // The client that this session is associated with.
   const std::shared_ptr<YBClient> client_;
 
@@ -120,6 +156,7 @@ class YBSessionData : public std::enable_shared_from_this<YBSessionData> {
   YBTransactionPtr transaction_;
   bool allow_local_calls_in_curr_thread_ = true;
   bool force_consistent_read_ = false;
+  MonoDelta max_staleness_;
 
   // Lock protecting flushed_batchers_.
   mutable simple_spinlock lock_;
@@ -127,9 +164,26 @@ class YBSessionData : public std::enable_shared_from_this<YBSessionData> {
   // Buffer for errors.
   scoped_refptr<internal::ErrorCollector> error_collector_;
 
+  // Protects batcher_ and the state of the background flush mode, because the background flush
+  // could take the batcher from another thread.
+  mutable std::mutex batcher_mutex_;
+
   // The current batcher being prepared.
   scoped_refptr<internal::Batcher> batcher_;
 
+  // Incremented for each new batcher, so the linger flush does not flush a later batcher.
+  uint64_t batcher_generation_ = 0;
+
+  // Set in the background flush mode.
+  boost::optional<BackgroundFlushOptions> background_flush_;
+
+  // Bytes of the requests of the buffered and in-flight operations, counted in the background
+  // flush mode.
+  size_t pending_bytes_ = 0;
+
+  // Notified when pending_bytes_ decreases.
+  std::condition_variable pending_bytes_cond_;
+
   // Any batchers which have been flushed but not yet finished.
   //
   // Upon a batch finishing, it will call FlushFinished(), which removes the batcher from
@@ -98,16 +98,19 @@ Status YBTableAlterer::Data::ToRequest(AlterTableRequestPB* req) {
         break;
       }
       case AlterTableRequestPB::ALTER_COLUMN:
-        // TODO(KUDU-861): support altering a column in the wire protocol.
-        // For now, we just give an error if the caller tries to do
-        // any operation other than rename.
-        if (s.spec->data_->has_type ||
-            s.spec->data_->has_nullable ||
-            s.spec->data_->primary_key) {
+        // A single step either renames a column or changes its type; the master validates that
+        // the type change does not require rewriting data.
+        if (s.spec->data_->has_nullable ||
+            s.spec->data_->primary_key ||
+            (s.spec->data_->has_type && s.spec->data_->has_rename_to)) {
           return STATUS(NotSupported, "cannot support AlterColumn of this type",
                                       s.spec->data_->name);
         }
-        // We only support rename column
+        if (s.spec->data_->has_type) {
+          pb_step->mutable_alter_column()->set_name(s.spec->data_->name);
+          s.spec->data_->type->ToQLTypePB(pb_step->mutable_alter_column()->mutable_type());
+          break;
+        }
         if (!s.spec->data_->has_rename_to) {
           return STATUS(InvalidArgument, "no alter operation specified",
                                          s.spec->data_->name);
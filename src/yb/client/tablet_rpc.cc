@@ -58,8 +58,15 @@ TabletInvoker::~TabletInvoker() {}
 void TabletInvoker::SelectTabletServerWithConsistentPrefix() {
   std::vector<RemoteTabletServer*> candidates;
   current_ts_ = client_->data_->SelectTServer(tablet_.get(),
-                                              YBClient::ReplicaSelection::CLOSEST_REPLICA, {},
+                                              YBClient::ReplicaSelection::CLOSEST_REPLICA,
+                                              stale_replicas_,
                                               &candidates);
+  if (!current_ts_ && !stale_replicas_.empty()) {
+    // All replicas are too far behind for a follower read, so go to the leader.
+    VLOG(1) << "Tablet " << tablet_id_ << ": All replicas are stale, using leader";
+    SelectTabletServer();
+    return;
+  }
   VLOG(1) << "Using tserver: " << yb::ToString(current_ts_);
 }
 
@@ -193,6 +200,9 @@ void TabletInvoker::Execute(const std::string& tablet_id, bool leader_only) {
   VLOG(2) << "Tablet " << tablet_id_ << ": Writing batch to replica "
           << current_ts_->ToString();
 
+  in_flight_ts_ = current_ts_;
+  rpc_start_time_ = MonoTime::Now();
+  current_ts_->RpcStarted();
   rpc_->SendRpcToTserver();
 }
 
@@ -200,8 +210,13 @@ void TabletInvoker::FailToNewReplica(const Status& reason,
                                      const tserver::TabletServerErrorPB* error_code) {
   VLOG(1) << "Failing " << command_->ToString() << " to a new replica: " << reason.ToString();
 
-  bool found = ErrorCode(error_code) != tserver::TabletServerErrorPB::STALE_FOLLOWER &&
-               (!tablet_ || tablet_->MarkReplicaFailed(current_ts_, reason));
+  const bool stale_follower =
+      ErrorCode(error_code) == tserver::TabletServerErrorPB::STALE_FOLLOWER;
+  if (stale_follower && current_ts_) {
+    // Do not send follower reads there again, but keep it as a candidate leader.
+    stale_replicas_.insert(current_ts_->permanent_uuid());
+  }
+  bool found = !stale_follower && (!tablet_ || tablet_->MarkReplicaFailed(current_ts_, reason));
   if (!found) {
     // Its possible that current_ts_ is not part of replicas if RemoteTablet.Refresh() is invoked
     // which updates the set of replicas.
@@ -214,10 +229,34 @@ void TabletInvoker::FailToNewReplica(const Status& reason,
   LOG_IF(DFATAL, !status.ok()) << "Retry failed: " << status;
 }
 
+void TabletInvoker::UseLeaderHint(const tserver::TabletServerErrorPB* error) {
+  if (!tablet_ || !error || !error->has_leader_uuid() ||
+      error->code() != tserver::TabletServerErrorPB::NOT_THE_LEADER) {
+    return;
+  }
+  vector<RemoteTabletServer*> replicas;
+  tablet_->GetRemoteTabletServers(&replicas);
+  for (RemoteTabletServer* ts : replicas) {
+    if (ts->permanent_uuid() == error->leader_uuid()) {
+      if (!ContainsKey(followers_, ts)) {
+        VLOG(2) << "Tablet " << tablet_id_ << ": Using leader hint " << ts->ToString();
+        tablet_->MarkTServerAsLeader(ts);
+      }
+      return;
+    }
+  }
+}
+
 bool TabletInvoker::Done(Status* status) {
   TRACE_TO(trace_, "Done($0)", status->ToString(false));
   ADOPT_TRACE(trace_);
 
+  if (in_flight_ts_) {
+    in_flight_ts_->RpcFinished(MonoTime::Now().GetDeltaSince(rpc_start_time_),
+                               status->ok() && !rpc_->response_error());
+    in_flight_ts_ = nullptr;
+  }
+
   if (status->IsAborted() || retrier_->finished()) {
     return true;
   }
@@ -264,6 +303,7 @@ bool TabletInvoker::Done(Status* status) {
     // Else the leader became a follower and must be reset on retry.
     if (!leader_is_not_ready) {
       followers_.insert(current_ts_);
+      UseLeaderHint(rpc_->response_error());
     }
 
     if (PREDICT_FALSE(FLAGS_assert_local_op) && current_ts_->IsLocal() &&
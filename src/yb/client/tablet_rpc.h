@@ -16,6 +16,8 @@
 #ifndef YB_CLIENT_TABLET_RPC_H
 #define YB_CLIENT_TABLET_RPC_H
 
+#include <set>
+#include <string>
 #include <unordered_set>
 
 #include "yb/client/client-internal.h"
@@ -73,6 +75,11 @@ class TabletInvoker {
   std::shared_ptr<tserver::TabletServerServiceProxy> proxy() const;
   YBClient& client() const { return *client_; }
   const RemoteTabletServer& current_ts() { return *current_ts_; }
+  RemoteTabletServer* mutable_current_ts() { return current_ts_; }
+
+  // Makes the invoker handle the response as one from 'ts', for an rpc that also sent the call to
+  // a replica of its own choice, e.g. a hedged read.
+  void set_current_ts(RemoteTabletServer* ts) { current_ts_ = ts; }
   bool local_tserver_only() const { return local_tserver_only_; }
 
  private:
@@ -91,6 +98,10 @@ class TabletInvoker {
   void FailToNewReplica(const Status& reason,
                         const tserver::TabletServerErrorPB* error_code = nullptr);
 
+  // Marks the replica that the tablet server named in the error as the leader, so the retry goes
+  // straight to it instead of guessing or asking the master.
+  void UseLeaderHint(const tserver::TabletServerErrorPB* error);
+
   // Called when we finish a lookup (to find the new consensus leader). Retries
   // the rpc after a short delay.
   void LookupTabletCb(const Result<RemoteTabletPtr>& result);
@@ -128,6 +139,10 @@ class TabletInvoker {
   // Cleared when new consensus configuration information arrives from the master.
   std::unordered_set<RemoteTabletServer*> followers_;
 
+  // Uuids of tablet servers that rejected a consistent prefix read because their safe time was too
+  // far behind. Skipped when choosing a replica for a follower read.
+  std::set<std::string> stale_replicas_;
+
   const bool local_tserver_only_;
 
   const bool consistent_prefix_;
@@ -136,6 +151,10 @@ class TabletInvoker {
   // RemoteTabletServer is taken from YBClient cache, so it is guaranteed that those objects are
   // alive while YBClient is alive. Because we don't delete them, but only add and update.
   RemoteTabletServer* current_ts_ = nullptr;
+
+  // The TS the last RPC was sent to and when, to account its latency when the RPC is done.
+  RemoteTabletServer* in_flight_ts_ = nullptr;
+  MonoTime rpc_start_time_;
 };
 
 CHECKED_STATUS ErrorStatus(const tserver::TabletServerErrorPB* error);
@@ -29,9 +29,11 @@
 #include "yb/common/transaction.h"
 
 #include "yb/rpc/messenger.h"
+#include "yb/rpc/outbound_call.h"
 #include "yb/rpc/rpc.h"
 #include "yb/rpc/scheduler.h"
 
+#include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
 #include "yb/util/random_util.h"
 #include "yb/util/result.h"
@@ -44,7 +46,20 @@ DEFINE_uint64(transaction_heartbeat_usec, 500000, "Interval of transaction heart
 DEFINE_bool(transaction_disable_heartbeat_in_tests, false, "Disable heartbeat during test.");
 DEFINE_bool(transaction_disable_proactive_cleanup_in_tests, false,
             "Disable cleanup of intents in abort path.");
+DEFINE_bool(transaction_single_shard_fast_path, true,
+            "Apply transactions whose only flush writes to a single tablet as one "
+            "non-transactional write batch on that tablet, without a status tablet and intents.");
+DEFINE_bool(transaction_read_only_fast_path, true,
+            "Send the reads of a snapshot isolation transaction that did not write yet without "
+            "transaction metadata, at its read point. So a transaction that only reads does not "
+            "need a status tablet, heartbeats or a commit.");
+DEFINE_bool(transaction_prefer_region_local_status_tablet, false,
+            "Pick a status tablet led in the region of the client for a transaction whose first "
+            "flush only touches tablets led in that region, so its status updates do not cross "
+            "regions.");
+TAG_FLAG(transaction_prefer_region_local_status_tablet, advanced);
 DECLARE_uint64(max_clock_skew_usec);
+DECLARE_uint64(transaction_heartbeat_batch_window_usec);
 
 namespace yb {
 namespace client {
@@ -54,6 +69,66 @@ namespace {
 YB_STRONGLY_TYPED_BOOL(Child);
 YB_DEFINE_ENUM(TransactionState, (kRunning)(kAborted)(kCommitted));
 
+// kNone - transaction is not known to consist of a single flush.
+// kExpected - the next flush is the last one before commit.
+// kFlushing - the last flush is sent as a single shard write batch.
+// kFlushed - the single shard write batch was applied.
+YB_DEFINE_ENUM(SingleShardState, (kNone)(kExpected)(kFlushing)(kFlushed));
+
+// Whether ops could be applied as one non-transactional write batch, i.e. whether they are all
+// writes with the same tablet, that the batcher sends in one RPC, and have no secondary indexes
+// that would have to be updated in the same transaction.
+bool IsSingleShardBatch(const std::unordered_set<internal::InFlightOpPtr>& ops) {
+  if (ops.empty()) {
+    return false;
+  }
+  const internal::RemoteTablet* tablet = nullptr;
+  size_t num_sidecars = 0;
+  for (const auto& op : ops) {
+    if (op->yb_op->type() != YBOperation::Type::QL_WRITE ||
+        !op->yb_op->table()->index_map().empty()) {
+      return false;
+    }
+    if (tablet == nullptr) {
+      tablet = op->tablet.get();
+    } else if (tablet != op->tablet.get()) {
+      return false;
+    }
+    if (op->yb_op->returns_sidecar() && ++num_sidecars >= rpc::CallResponse::kMaxSidecarSlices) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool IsReadOnlyBatch(const std::unordered_set<internal::InFlightOpPtr>& ops) {
+  if (ops.empty()) {
+    return false;
+  }
+  for (const auto& op : ops) {
+    if (!op->yb_op->read_only()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Locality of the transaction as far as the first flush tells it: local if all of its tablets have
+// their leaders in the region of the client.
+TransactionLocality BatchLocality(const std::unordered_set<internal::InFlightOpPtr>& ops,
+                                  const TransactionManager& manager) {
+  if (!FLAGS_transaction_prefer_region_local_status_tablet || ops.empty()) {
+    return TransactionLocality::kGlobal;
+  }
+  for (const auto& op : ops) {
+    auto* leader = op->tablet ? op->tablet->LeaderTServer() : nullptr;
+    if (leader == nullptr || !manager.InLocalRegion(leader->cloud_info())) {
+      return TransactionLocality::kGlobal;
+    }
+  }
+  return TransactionLocality::kLocal;
+}
+
 } // namespace
 
 Result<ChildTransactionData> ChildTransactionData::FromPB(const ChildTransactionDataPB& data) {
@@ -146,6 +221,10 @@ class YBTransaction::Impl final {
       other->metadata_.isolation = metadata_.isolation;
       other->metadata_.start_time = other->read_point_.Now();
       state_.store(TransactionState::kAborted, std::memory_order_release);
+      if (single_shard_state_ != SingleShardState::kNone ||
+          (!ready_ && CanReadWithoutMetadata())) {
+        return;
+      }
     }
     DoAbort(Status::OK(), transaction);
   }
@@ -161,10 +240,40 @@ class YBTransaction::Impl final {
     bool has_tablets_without_metadata = false;
     {
       std::unique_lock<std::mutex> lock(mutex_);
+      if (single_shard_state_ != SingleShardState::kNone) {
+        if (single_shard_state_ == SingleShardState::kExpected && !ready_ &&
+            !requested_status_tablet_.load(std::memory_order_acquire) && tablets_.empty() &&
+            !read_without_metadata_ && IsSingleShardBatch(ops)) {
+          // Leave metadata empty, so the ops are sent without transaction.
+          single_shard_state_ = SingleShardState::kFlushing;
+          VLOG_WITH_PREFIX(2) << "Prepare, single shard";
+          return true;
+        }
+        if (single_shard_state_ != SingleShardState::kExpected) {
+          // Our lock is held by the batcher, so the waiter should not be invoked from here.
+          lock.unlock();
+          LOG_WITH_PREFIX(DFATAL) << "Flush after the last one";
+          manager_->client()->messenger()->scheduler().Schedule(
+              [waiter](const Status&) {
+                waiter(STATUS(IllegalState, "Flush of transaction after the last one"));
+              },
+              std::chrono::steady_clock::duration(0));
+          return false;
+        }
+        // The flush does not qualify, so the transaction proceeds as a regular one.
+        single_shard_state_ = SingleShardState::kNone;
+      }
+      if (!ready_ && CanReadWithoutMetadata() && IsReadOnlyBatch(ops)) {
+        // There are no intents of this transaction yet, so reading at the read point without
+        // metadata gives the same result. Restarts are handled by the read point as well.
+        read_without_metadata_ = true;
+        VLOG_WITH_PREFIX(2) << "Prepare, read only";
+        return true;
+      }
       if (!ready_) {
         waiters_.push_back(std::move(waiter));
         lock.unlock();
-        RequestStatusTablet();
+        RequestStatusTablet(BatchLocality(ops, *manager_));
         VLOG_WITH_PREFIX(2) << "Prepare, rejected (not ready, requesting status tablet)";
         return false;
       }
@@ -212,6 +321,18 @@ class YBTransaction::Impl final {
   }
 
   void Flushed(const internal::InFlightOps& ops, const Status& status) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (single_shard_state_ == SingleShardState::kFlushing) {
+        if (status.ok()) {
+          single_shard_state_ = SingleShardState::kFlushed;
+        } else {
+          // The write batch is applied as a whole or not at all, so the transaction fails.
+          SetError(status, &lock);
+        }
+        return;
+      }
+    }
     if (status.ok()) {
       std::lock_guard<std::mutex> lock(mutex_);
       TabletStates::iterator it = tablets_.end();
@@ -251,7 +372,25 @@ class YBTransaction::Impl final {
             IllegalState, "Commit of transaction that requires restart is not allowed"));
         return;
       }
+      if (single_shard_state_ == SingleShardState::kFlushed) {
+        VLOG_WITH_PREFIX(1) << "Commit, applied as single shard";
+        state_.store(TransactionState::kCommitted, std::memory_order_release);
+        lock.unlock();
+        callback(Status::OK());
+        return;
+      }
+      if (single_shard_state_ == SingleShardState::kFlushing) {
+        lock.unlock();
+        callback(STATUS(IllegalState, "Commit of transaction with the last flush in progress"));
+        return;
+      }
       state_.store(TransactionState::kCommitted, std::memory_order_release);
+      if (!ready_ && CanReadWithoutMetadata()) {
+        VLOG_WITH_PREFIX(1) << "Commit, read only";
+        lock.unlock();
+        callback(Status::OK());
+        return;
+      }
       commit_callback_ = std::move(callback);
       if (!ready_) {
         waiters_.emplace_back(std::bind(&Impl::DoCommit, this, _1, transaction));
@@ -277,6 +416,16 @@ class YBTransaction::Impl final {
         return;
       }
       state_.store(TransactionState::kAborted, std::memory_order_release);
+      if (single_shard_state_ != SingleShardState::kNone) {
+        // Nothing was written through the status tablet, so there is nothing to abort.
+        LOG_IF_WITH_PREFIX(DFATAL, single_shard_state_ == SingleShardState::kFlushed)
+            << "Abort of transaction applied as single shard";
+        return;
+      }
+      if (!ready_ && CanReadWithoutMetadata()) {
+        // Nothing was written, and the coordinator does not know about this transaction.
+        return;
+      }
       if (!ready_) {
         waiters_.emplace_back(std::bind(&Impl::DoAbort, this, _1, transaction));
         lock.unlock();
@@ -287,6 +436,17 @@ class YBTransaction::Impl final {
     DoAbort(Status::OK(), transaction);
   }
 
+  void ExpectSingleFlush() {
+    if (!FLAGS_transaction_single_shard_fast_path || child_) {
+      return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (single_shard_state_ == SingleShardState::kNone && !ready_ && tablets_.empty() &&
+        !read_without_metadata_) {
+      single_shard_state_ = SingleShardState::kExpected;
+    }
+  }
+
   bool IsRestartRequired() const {
     return read_point_.IsRestartRequired();
   }
@@ -394,6 +554,14 @@ class YBTransaction::Impl final {
     abort_handle_ = manager_->rpcs().InvalidHandle();
   }
 
+  // Whether this transaction did not involve the coordinator so far, and may keep sending its reads
+  // without metadata.
+  bool CanReadWithoutMetadata() const {
+    return FLAGS_transaction_read_only_fast_path && !child_ &&
+           metadata_.isolation == IsolationLevel::SNAPSHOT_ISOLATION &&
+           !requested_status_tablet_.load(std::memory_order_acquire) && tablets_.empty();
+  }
+
   CHECKED_STATUS CheckRunning(std::unique_lock<std::mutex>* lock) {
     if (state_.load(std::memory_order_acquire) != TransactionState::kRunning) {
       auto status = error_;
@@ -560,14 +728,16 @@ class YBTransaction::Impl final {
     manager_->rpcs().Unregister(&abort_handle_);
   }
 
-  void RequestStatusTablet() {
+  void RequestStatusTablet(TransactionLocality locality = TransactionLocality::kGlobal) {
     bool expected = false;
     if (!requested_status_tablet_.compare_exchange_strong(
         expected, true, std::memory_order_acq_rel)) {
       return;
     }
+    VLOG_WITH_PREFIX(2) << "Requesting status tablet, locality: " << yb::client::ToString(locality);
     manager_->PickStatusTablet(
-        std::bind(&Impl::StatusTabletPicked, this, _1, transaction_->shared_from_this()));
+        std::bind(&Impl::StatusTabletPicked, this, _1, transaction_->shared_from_this()),
+        locality);
   }
 
   void StatusTabletPicked(const Result<std::string>& tablet,
@@ -631,6 +801,14 @@ class YBTransaction::Impl final {
       return;
     }
 
+    if (status == TransactionStatus::PENDING &&
+        FLAGS_transaction_heartbeat_batch_window_usec != 0) {
+      manager_->SendHeartbeat(
+          status_tablet_, metadata_.transaction_id,
+          std::bind(&Impl::HeartbeatDone, this, _1, _2, status, transaction));
+      return;
+    }
+
     tserver::UpdateTransactionRequestPB req;
     req.set_tablet_id(status_tablet_->tablet_id());
     req.set_propagated_hybrid_time(manager_->Now().ToUint64());
@@ -738,6 +916,10 @@ class YBTransaction::Impl final {
   // Transaction is successfully initialized and ready to process intents.
   const bool child_;
   bool ready_ = false;
+  SingleShardState single_shard_state_ = SingleShardState::kNone;
+  // Some reads were sent without metadata, so the transaction can't be applied as single shard
+  // anymore: its writes have to be checked for conflicts since its read point.
+  bool read_without_metadata_ = false;
   CommitCallback commit_callback_;
   Status error_;
   rpc::Rpcs::Handle heartbeat_handle_;
@@ -835,10 +1017,20 @@ std::future<Status> YBTransaction::CommitFuture() {
   return MakeFuture<Status>([this](auto callback) { impl_->Commit(std::move(callback)); });
 }
 
+ChainableFuture<Status> YBTransaction::CommitChainableFuture() {
+  return MakeChainableFuture<Status>([this](auto callback) {
+    impl_->Commit(std::move(callback));
+  });
+}
+
 void YBTransaction::Abort() {
   impl_->Abort();
 }
 
+void YBTransaction::ExpectSingleFlush() {
+  impl_->ExpectSingleFlush();
+}
+
 bool YBTransaction::IsRestartRequired() const {
   return impl_->IsRestartRequired();
 }
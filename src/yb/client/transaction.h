@@ -29,6 +29,7 @@
 #include "yb/client/client_fwd.h"
 
 #include "yb/util/async_util.h"
+#include "yb/util/chainable_future.h"
 #include "yb/util/status.h"
 
 namespace yb {
@@ -89,9 +90,19 @@ class YBTransaction : public std::enable_shared_from_this<YBTransaction> {
   // Utility function for Commit.
   std::future<Status> CommitFuture();
 
+  // Commit that returns a future which can be continued without blocking a thread.
+  ChainableFuture<Status> CommitChainableFuture();
+
   // Aborts this transaction.
   void Abort();
 
+  // Notifies transaction that the next flush contains all of its operations and is followed by
+  // commit. If those operations are writes to a single tablet, they are applied there as one
+  // non-transactional write batch, which is still checked for conflicts with other transactions.
+  // So the transaction does not need a status tablet and does not write intents.
+  // Otherwise the transaction proceeds as usual.
+  void ExpectSingleFlush();
+
   // Returns transaction ID.
   const TransactionId& id() const;
 
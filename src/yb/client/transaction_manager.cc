@@ -15,7 +15,11 @@
 
 #include "yb/client/transaction_manager.h"
 
+#include <unordered_map>
+
+#include "yb/rpc/messenger.h"
 #include "yb/rpc/rpc.h"
+#include "yb/rpc/scheduler.h"
 #include "yb/rpc/thread_pool.h"
 #include "yb/rpc/tasks_pool.h"
 
@@ -23,11 +27,20 @@
 #include "yb/util/thread_restrictions.h"
 
 #include "yb/client/client.h"
+#include "yb/client/meta_cache.h"
 
 #include "yb/common/transaction.h"
+#include "yb/common/wire_protocol.h"
 
 #include "yb/master/master_defaults.h"
 
+#include "yb/tserver/tserver_service.pb.h"
+
+DEFINE_uint64(transaction_heartbeat_batch_window_usec, 0,
+              "Time in usec during which PENDING heartbeats of transactions with the same status "
+              "tablet are collected to be sent in a single RPC. 0 to send each heartbeat on its "
+              "own.");
+
 namespace yb {
 namespace client {
 
@@ -40,8 +53,23 @@ const YBTableName kTransactionTableName(master::kSystemNamespaceName, kTransacti
 // Resolved - final state, when all tablets are resolved and written to cache.
 YB_DEFINE_ENUM(TransactionTableStatus, (kExists)(kUpdating)(kResolved));
 
-void InvokeCallback(const LocalTabletFilter& filter, const std::vector<TabletId>& tablets,
+bool SameRegion(const CloudInfoPB& lhs, const CloudInfoPB& rhs) {
+  return lhs.placement_cloud() == rhs.placement_cloud() &&
+         lhs.placement_region() == rhs.placement_region();
+}
+
+struct TransactionTableState {
+  LocalTabletFilter local_tablet_filter;
+  std::atomic<TransactionTableStatus> status{TransactionTableStatus::kExists};
+  std::vector<TabletId> tablets;
+  // Tablets whose leader was in the region of the client when the table was resolved.
+  std::vector<TabletId> local_region_tablets;
+};
+
+void InvokeCallback(const TransactionTableState& table_state, TransactionLocality locality,
                     const PickStatusTabletCallback& callback) {
+  const auto& filter = table_state.local_tablet_filter;
+  const auto& tablets = table_state.tablets;
   if (filter) {
     std::vector<const TabletId*> ids;
     ids.reserve(tablets.size());
@@ -55,29 +83,30 @@ void InvokeCallback(const LocalTabletFilter& filter, const std::vector<TabletId>
     }
     LOG(WARNING) << "No local transaction status tablet";
   }
+  if (locality == TransactionLocality::kLocal && !table_state.local_region_tablets.empty()) {
+    callback(RandomElement(table_state.local_region_tablets));
+    return;
+  }
   callback(RandomElement(tablets));
 }
 
-struct TransactionTableState {
-  LocalTabletFilter local_tablet_filter;
-  std::atomic<TransactionTableStatus> status{TransactionTableStatus::kExists};
-  std::vector<TabletId> tablets;
-};
-
 // Picks status tablet for transaction.
 class PickStatusTabletTask {
  public:
   PickStatusTabletTask(const YBClientPtr& client,
                        TransactionTableState* table_state,
-                       PickStatusTabletCallback callback)
+                       PickStatusTabletCallback callback,
+                       TransactionLocality locality)
       : client_(client), table_state_(table_state),
-        callback_(std::move(callback)) {
+        callback_(std::move(callback)), locality_(locality) {
   }
 
   void Run() {
     // TODO(dtxn) async
     std::vector<TabletId> tablets;
-    auto status = client_->GetTablets(kTransactionTableName, 0, &tablets, /* ranges */ nullptr);
+    std::vector<master::TabletLocationsPB> locations;
+    auto status = client_->GetTablets(
+        kTransactionTableName, 0, &tablets, /* ranges */ nullptr, &locations);
     if (!status.ok()) {
       callback_(status);
       return;
@@ -89,11 +118,20 @@ class PickStatusTabletTask {
     auto expected = TransactionTableStatus::kExists;
     if (table_state_->status.compare_exchange_strong(
         expected, TransactionTableStatus::kUpdating, std::memory_order_acq_rel)) {
-      table_state_->tablets = tablets;
+      table_state_->tablets = std::move(tablets);
+      table_state_->local_region_tablets = LocalRegionTablets(locations);
       table_state_->status.store(TransactionTableStatus::kResolved, std::memory_order_release);
+    } else {
+      // Another task is resolving the table, so use what it would have been resolved to.
+      TransactionTableState resolved;
+      resolved.local_tablet_filter = table_state_->local_tablet_filter;
+      resolved.tablets = std::move(tablets);
+      resolved.local_region_tablets = LocalRegionTablets(locations);
+      InvokeCallback(resolved, locality_, callback_);
+      return;
     }
 
-    InvokeCallback(table_state_->local_tablet_filter, tablets, callback_);
+    InvokeCallback(*table_state_, locality_, callback_);
   }
 
   void Done(const Status& status) {
@@ -105,21 +143,37 @@ class PickStatusTabletTask {
   }
 
  private:
+  std::vector<TabletId> LocalRegionTablets(
+      const std::vector<master::TabletLocationsPB>& locations) {
+    std::vector<TabletId> result;
+    for (const auto& tablet : locations) {
+      for (const auto& replica : tablet.replicas()) {
+        if (replica.role() == consensus::RaftPeerPB::LEADER &&
+            SameRegion(replica.ts_info().cloud_info(), client_->cloud_info())) {
+          result.push_back(tablet.tablet_id());
+          break;
+        }
+      }
+    }
+    return result;
+  }
 
   YBClientPtr client_;
   TransactionTableState* table_state_;
   PickStatusTabletCallback callback_;
+  TransactionLocality locality_;
 };
 
 class InvokeCallbackTask {
  public:
   InvokeCallbackTask(TransactionTableState* table_state,
-                     PickStatusTabletCallback callback)
-      : table_state_(table_state), callback_(std::move(callback)) {
+                     PickStatusTabletCallback callback,
+                     TransactionLocality locality)
+      : table_state_(table_state), callback_(std::move(callback)), locality_(locality) {
   }
 
   void Run() {
-    InvokeCallback(table_state_->local_tablet_filter, table_state_->tablets, callback_);
+    InvokeCallback(*table_state_, locality_, callback_);
   }
 
   void Done(const Status& status) {
@@ -132,6 +186,138 @@ class InvokeCallbackTask {
  private:
   TransactionTableState* table_state_;
   PickStatusTabletCallback callback_;
+  TransactionLocality locality_;
+};
+
+// Collects heartbeats of transactions per status tablet, and sends each collected group in one
+// UpdateTransaction RPC after the batch window.
+class HeartbeatBatcher : public std::enable_shared_from_this<HeartbeatBatcher> {
+ public:
+  HeartbeatBatcher(YBClient* client, rpc::Rpcs* rpcs) : client_(client), rpcs_(rpcs) {}
+
+  void Add(const internal::RemoteTabletPtr& status_tablet,
+           const TransactionId& id,
+           UpdateTransactionCallback callback,
+           HybridTime now) {
+    bool schedule;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (closed_) {
+        return;
+      }
+      auto& batch = pending_[status_tablet->tablet_id()];
+      schedule = batch.heartbeats.empty();
+      batch.tablet = status_tablet;
+      batch.heartbeats.push_back({id, std::move(callback)});
+      batch.propagated_hybrid_time = now;
+    }
+    if (schedule) {
+      std::weak_ptr<HeartbeatBatcher> weak_self(shared_from_this());
+      auto tablet_id = status_tablet->tablet_id();
+      client_->messenger()->scheduler().Schedule(
+          [weak_self, tablet_id](const Status& status) {
+            auto self = weak_self.lock();
+            if (self) {
+              self->Flush(tablet_id);
+            }
+          },
+          std::chrono::microseconds(FLAGS_transaction_heartbeat_batch_window_usec));
+    }
+  }
+
+  void Shutdown() {
+    std::unordered_map<TabletId, Batch> pending;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      closed_ = true;
+      pending.swap(pending_);
+    }
+  }
+
+ private:
+  struct Heartbeat {
+    TransactionId id;
+    UpdateTransactionCallback callback;
+  };
+
+  struct Batch {
+    internal::RemoteTabletPtr tablet;
+    std::vector<Heartbeat> heartbeats;
+    HybridTime propagated_hybrid_time;
+  };
+
+  struct InFlight {
+    tserver::UpdateTransactionRequestPB request;
+    std::vector<Heartbeat> heartbeats;
+    rpc::Rpcs::Handle handle;
+  };
+
+  void Flush(const TabletId& tablet_id) {
+    auto in_flight = std::make_shared<InFlight>();
+    internal::RemoteTabletPtr tablet;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = pending_.find(tablet_id);
+      if (it == pending_.end()) {
+        return;
+      }
+      tablet = std::move(it->second.tablet);
+      in_flight->heartbeats.swap(it->second.heartbeats);
+      in_flight->request.set_propagated_hybrid_time(
+          it->second.propagated_hybrid_time.ToUint64());
+      pending_.erase(it);
+      in_flight->handle = rpcs_->Prepare();
+    }
+    if (in_flight->handle == rpcs_->InvalidHandle()) {
+      return;
+    }
+
+    auto& request = in_flight->request;
+    request.set_tablet_id(tablet_id);
+    for (const auto& heartbeat : in_flight->heartbeats) {
+      auto& state = *request.add_batched_heartbeats();
+      state.set_transaction_id(heartbeat.id.begin(), heartbeat.id.size());
+      state.set_status(TransactionStatus::PENDING);
+    }
+    *in_flight->handle = UpdateTransactions(
+        TransactionRpcDeadline(),
+        tablet.get(),
+        client_,
+        &request,
+        [this, in_flight](const Status& status, const tserver::UpdateTransactionResponsePB& resp) {
+          rpcs_->Unregister(&in_flight->handle);
+          Done(status, resp, &in_flight->heartbeats);
+        });
+    (**in_flight->handle).SendRpc();
+  }
+
+  void Done(const Status& status,
+            const tserver::UpdateTransactionResponsePB& response,
+            std::vector<Heartbeat>* heartbeats) {
+    HybridTime propagated_hybrid_time = response.has_propagated_hybrid_time()
+        ? HybridTime(response.propagated_hybrid_time()) : HybridTime::kInvalid;
+    for (size_t i = 0; i != heartbeats->size(); ++i) {
+      auto& callback = (*heartbeats)[i].callback;
+      if (!status.ok()) {
+        callback(status, propagated_hybrid_time);
+      } else if (i >= static_cast<size_t>(response.batched_results_size())) {
+        callback(STATUS(IllegalState, "Missing result of batched heartbeat"),
+                 propagated_hybrid_time);
+      } else if (response.batched_results(i).has_error()) {
+        callback(StatusFromPB(response.batched_results(i).error().status()),
+                 propagated_hybrid_time);
+      } else {
+        callback(Status::OK(), propagated_hybrid_time);
+      }
+    }
+  }
+
+  YBClient* const client_;
+  rpc::Rpcs* const rpcs_;
+
+  std::mutex mutex_;
+  bool closed_ = false;
+  std::unordered_map<TabletId, Batch> pending_;
 };
 
 constexpr size_t kQueueLimit = 150;
@@ -148,26 +334,35 @@ class TransactionManager::Impl {
         table_state_{std::move(local_tablet_filter)},
         thread_pool_("TransactionManager", kQueueLimit, kMaxWorkers),
         tasks_pool_(kQueueLimit),
-        invoke_callback_tasks_(kQueueLimit) {
+        invoke_callback_tasks_(kQueueLimit),
+        heartbeat_batcher_(std::make_shared<HeartbeatBatcher>(client_.get(), &rpcs_)) {
     CHECK(clock);
   }
 
-  void PickStatusTablet(PickStatusTabletCallback callback) {
+  void PickStatusTablet(PickStatusTabletCallback callback, TransactionLocality locality) {
     if (table_state_.status.load(std::memory_order_acquire) == TransactionTableStatus::kResolved) {
       if (ThreadRestrictions::IsWaitAllowed()) {
-        InvokeCallback(table_state_.local_tablet_filter, table_state_.tablets, callback);
-      } else if (!invoke_callback_tasks_.Enqueue(&thread_pool_, &table_state_, callback)) {
+        InvokeCallback(table_state_, locality, callback);
+      } else if (!invoke_callback_tasks_.Enqueue(
+                     &thread_pool_, &table_state_, callback, locality)) {
         callback(STATUS_FORMAT(ServiceUnavailable,
                               "Invoke callback queue overflow, number of tasks: $0",
                               invoke_callback_tasks_.size()));
       }
       return;
     }
-    if (!tasks_pool_.Enqueue(&thread_pool_, client_, &table_state_, std::move(callback))) {
+    if (!tasks_pool_.Enqueue(
+            &thread_pool_, client_, &table_state_, std::move(callback), locality)) {
       callback(STATUS_FORMAT(ServiceUnavailable, "Tasks overflow, exists: $0", tasks_pool_.size()));
     }
   }
 
+  void SendHeartbeat(const internal::RemoteTabletPtr& status_tablet,
+                     const TransactionId& id,
+                     UpdateTransactionCallback callback) {
+    heartbeat_batcher_->Add(status_tablet, id, std::move(callback), Now());
+  }
+
   const scoped_refptr<ClockBase>& clock() const {
     return clock_;
   }
@@ -193,6 +388,7 @@ class TransactionManager::Impl {
   }
 
   void Shutdown() {
+    heartbeat_batcher_->Shutdown();
     rpcs_.Shutdown();
     thread_pool_.Shutdown();
   }
@@ -206,6 +402,7 @@ class TransactionManager::Impl {
   yb::rpc::TasksPool<PickStatusTabletTask> tasks_pool_;
   yb::rpc::TasksPool<InvokeCallbackTask> invoke_callback_tasks_;
   yb::rpc::Rpcs rpcs_;
+  std::shared_ptr<HeartbeatBatcher> heartbeat_batcher_;
 };
 
 TransactionManager::TransactionManager(
@@ -217,8 +414,19 @@ TransactionManager::~TransactionManager() {
   impl_->Shutdown();
 }
 
-void TransactionManager::PickStatusTablet(PickStatusTabletCallback callback) {
-  impl_->PickStatusTablet(std::move(callback));
+void TransactionManager::PickStatusTablet(PickStatusTabletCallback callback,
+                                          TransactionLocality locality) {
+  impl_->PickStatusTablet(std::move(callback), locality);
+}
+
+bool TransactionManager::InLocalRegion(const CloudInfoPB& cloud_info) const {
+  return SameRegion(cloud_info, impl_->client()->cloud_info());
+}
+
+void TransactionManager::SendHeartbeat(const internal::RemoteTabletPtr& status_tablet,
+                                       const TransactionId& id,
+                                       UpdateTransactionCallback callback) {
+  impl_->SendHeartbeat(status_tablet, id, std::move(callback));
 }
 
 const YBClientPtr& TransactionManager::client() const {
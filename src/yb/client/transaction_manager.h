@@ -20,19 +20,30 @@
 #include <memory>
 
 #include "yb/client/client_fwd.h"
+#include "yb/client/transaction_rpc.h"
 
 #include "yb/common/clock.h"
 #include "yb/common/hybrid_time.h"
+#include "yb/common/transaction.h"
 
 #include "yb/rpc/rpc_fwd.h"
 
+#include "yb/util/enums.h"
 #include "yb/util/result.h"
 
 namespace yb {
+
+class CloudInfoPB;
+
 namespace client {
 
 typedef std::function<void(const Result<std::string>&)> PickStatusTabletCallback;
 
+// kLocal - the transaction is expected to touch only tablets led in the region of the client, so
+// a status tablet led in the same region is preferred.
+// kGlobal - any status tablet.
+YB_DEFINE_ENUM(TransactionLocality, (kGlobal)(kLocal));
+
 // TransactionManager manages multiple transactions. It lives at the YQL engine layer.
 class TransactionManager {
  public:
@@ -40,7 +51,18 @@ class TransactionManager {
                      LocalTabletFilter local_tablet_filter);
   ~TransactionManager();
 
-  void PickStatusTablet(PickStatusTabletCallback callback);
+  void PickStatusTablet(PickStatusTabletCallback callback,
+                        TransactionLocality locality = TransactionLocality::kGlobal);
+
+  // Whether cloud_info is in the same cloud and region as the client.
+  bool InLocalRegion(const CloudInfoPB& cloud_info) const;
+
+  // Sends a PENDING heartbeat of the transaction to its status tablet. Heartbeats of transactions
+  // with the same status tablet that arrive within transaction_heartbeat_batch_window_usec are
+  // sent in a single RPC.
+  void SendHeartbeat(const internal::RemoteTabletPtr& status_tablet,
+                     const TransactionId& id,
+                     UpdateTransactionCallback callback);
 
   rpc::Rpcs& rpcs();
   const YBClientPtr& client() const;
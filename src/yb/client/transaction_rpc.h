@@ -36,6 +36,7 @@ class AbortTransactionResponsePB;
 class GetTransactionStatusRequestPB;
 class GetTransactionStatusResponsePB;
 class UpdateTransactionRequestPB;
+class UpdateTransactionResponsePB;
 
 }
 
@@ -58,6 +59,18 @@ MUST_USE_RESULT rpc::RpcCommandPtr UpdateTransaction(
     tserver::UpdateTransactionRequestPB* req,
     UpdateTransactionCallback callback);
 
+typedef std::function<void(const Status&, const tserver::UpdateTransactionResponsePB&)>
+    UpdateTransactionsCallback;
+
+// Sends heartbeats of several transactions managed by the same status tablet, listed in
+// batched_heartbeats of the request.
+MUST_USE_RESULT rpc::RpcCommandPtr UpdateTransactions(
+    const MonoTime& deadline,
+    internal::RemoteTablet* tablet,
+    YBClient* client,
+    tserver::UpdateTransactionRequestPB* req,
+    UpdateTransactionsCallback callback);
+
 typedef std::function<void(const Status&, const tserver::GetTransactionStatusResponsePB&)>
     GetTransactionStatusCallback;
 
@@ -185,6 +185,10 @@ YBqlWriteOp::YBqlWriteOp(const shared_ptr<YBTable>& table)
 
 YBqlWriteOp::~YBqlWriteOp() {}
 
+size_t YBqlWriteOp::space_used_by_request() const {
+  return ql_write_request_->ByteSizeLong();
+}
+
 static YBqlWriteOp *NewYBqlWriteOp(const shared_ptr<YBTable>& table,
                                    QLWriteRequestPB::QLStmtType stmt_type) {
   YBqlWriteOp *op = new YBqlWriteOp(table);
@@ -335,6 +339,10 @@ YBqlReadOp::YBqlReadOp(const shared_ptr<YBTable>& table)
 
 YBqlReadOp::~YBqlReadOp() {}
 
+size_t YBqlReadOp::space_used_by_request() const {
+  return ql_read_request_->ByteSizeLong();
+}
+
 YBqlReadOp *YBqlReadOp::NewSelect(const shared_ptr<YBTable>& table) {
   YBqlReadOp *op = new YBqlReadOp(table);
   QLReadRequestPB *req = op->mutable_request();
@@ -457,6 +465,10 @@ YBPgsqlWriteOp::YBPgsqlWriteOp(const shared_ptr<YBTable>& table)
 
 YBPgsqlWriteOp::~YBPgsqlWriteOp() {}
 
+size_t YBPgsqlWriteOp::space_used_by_request() const {
+  return write_request_->ByteSizeLong();
+}
+
 static YBPgsqlWriteOp *NewYBPgsqlWriteOp(const shared_ptr<YBTable>& table,
                                          PgsqlWriteRequestPB::PgsqlStmtType stmt_type) {
   YBPgsqlWriteOp *op = new YBPgsqlWriteOp(table);
@@ -511,6 +523,10 @@ YBPgsqlReadOp::YBPgsqlReadOp(const shared_ptr<YBTable>& table)
 
 YBPgsqlReadOp::~YBPgsqlReadOp() {}
 
+size_t YBPgsqlReadOp::space_used_by_request() const {
+  return read_request_->ByteSizeLong();
+}
+
 YBPgsqlReadOp *YBPgsqlReadOp::NewSelect(const shared_ptr<YBTable>& table) {
   YBPgsqlReadOp *op = new YBPgsqlReadOp(table);
   PgsqlReadRequestPB *req = op->mutable_request();
@@ -521,6 +537,14 @@ YBPgsqlReadOp *YBPgsqlReadOp::NewSelect(const shared_ptr<YBTable>& table) {
   return op;
 }
 
+std::unique_ptr<YBPgsqlReadOp> YBPgsqlReadOp::DeepCopy() const {
+  std::unique_ptr<YBPgsqlReadOp> result(new YBPgsqlReadOp(table_));
+  *result->read_request_ = *read_request_;
+  result->yb_consistency_level_ = yb_consistency_level_;
+  result->read_time_ = read_time_;
+  return result;
+}
+
 std::string YBPgsqlReadOp::ToString() const {
   return "PGSQL_READ " + read_request_->DebugString();
 }
@@ -102,6 +102,9 @@ class YBOperation {
 
   virtual bool wrote_data() { return succeeded() && !read_only(); }
 
+  // Returns the size of the request of this operation, in bytes.
+  virtual size_t space_used_by_request() const = 0;
+
   virtual void SetHashCode(uint16_t hash_code) = 0;
 
   const scoped_refptr<internal::RemoteTablet>& tablet() const {
@@ -140,7 +143,6 @@ class YBRedisOp : public YBOperation {
   virtual ~YBRedisOp();
 
   bool has_response() { return redis_response_ ? true : false; }
-  virtual size_t space_used_by_request() const = 0;
 
   const RedisResponsePB& response() const;
 
@@ -267,6 +269,8 @@ class YBqlWriteOp : public YBqlOp {
 
   QLWriteRequestPB* mutable_request() { return ql_write_request_.get(); }
 
+  size_t space_used_by_request() const override;
+
   std::string ToString() const override;
 
   bool read_only() override { return false; };
@@ -333,6 +337,8 @@ class YBqlReadOp : public YBqlOp {
 
   QLReadRequestPB* mutable_request() { return ql_read_request_.get(); }
 
+  size_t space_used_by_request() const override;
+
   virtual std::string ToString() const override;
 
   virtual bool read_only() override { return true; };
@@ -412,6 +418,8 @@ class YBPgsqlWriteOp : public YBPgsqlOp {
 
   PgsqlWriteRequestPB* mutable_request() { return write_request_.get(); }
 
+  size_t space_used_by_request() const override;
+
   std::string ToString() const override;
 
   bool read_only() override { return false; };
@@ -444,6 +452,10 @@ class YBPgsqlReadOp : public YBPgsqlOp {
 
   static YBPgsqlReadOp *NewSelect(const std::shared_ptr<YBTable>& table);
 
+  // Returns a new operation on the same table, with copies of the request, consistency level and
+  // read time of this one.
+  std::unique_ptr<YBPgsqlReadOp> DeepCopy() const;
+
   // Note: to avoid memory copy, this PgsqlReadRequestPB is moved into tserver ReadRequestPB
   // when the request is sent to tserver. It is restored after response is received from tserver
   // (see ReadRpc's constructor).
@@ -451,6 +463,8 @@ class YBPgsqlReadOp : public YBPgsqlOp {
 
   PgsqlReadRequestPB* mutable_request() { return read_request_.get(); }
 
+  size_t space_used_by_request() const override;
+
   virtual std::string ToString() const override;
 
   virtual bool read_only() override { return true; };
@@ -27,12 +27,16 @@ namespace yb {
 
 IndexInfo::IndexColumn::IndexColumn(const IndexInfoPB::IndexColumnPB& pb)
     : column_id(ColumnId(pb.column_id())),
-      indexed_column_id(ColumnId(pb.indexed_column_id())) {
+      indexed_column_id(ColumnId(pb.indexed_column_id())),
+      json_ops(pb.json_ops()) {
 }
 
 void IndexInfo::IndexColumn::ToPB(IndexInfoPB::IndexColumnPB* pb) const {
   pb->set_column_id(column_id);
   pb->set_indexed_column_id(indexed_column_id);
+  if (is_json_path()) {
+    *pb->mutable_json_ops() = json_ops;
+  }
 }
 
 namespace {
@@ -70,7 +74,9 @@ IndexInfo::IndexInfo(const IndexInfoPB& pb)
       indexed_hash_column_ids_(ColumnIdsFromPB(pb.indexed_hash_column_ids())),
       indexed_range_column_ids_(ColumnIdsFromPB(pb.indexed_range_column_ids())) {
   for (const IndexInfo::IndexColumn &index_col : columns_) {
-    covered_column_ids_.insert(index_col.indexed_column_id);
+    if (!index_col.is_json_path()) {
+      covered_column_ids_.insert(index_col.indexed_column_id);
+    }
   }
 }
 
@@ -33,6 +33,10 @@ class IndexInfo {
   struct IndexColumn {
     ColumnId column_id;         // Column id in the index table.
     ColumnId indexed_column_id; // Corresponding column id in indexed table.
+    // Path applied to the jsonb indexed column, empty if the column itself is indexed.
+    QLJsonColumnOperationsPB json_ops;
+
+    bool is_json_path() const { return json_ops.json_operations_size() != 0; }
 
     explicit IndexColumn(const IndexInfoPB::IndexColumnPB& pb);
     IndexColumn() {}
@@ -70,7 +74,8 @@ class IndexInfo {
   // Index primary key columns of the indexed table only?
   bool PrimaryKeyColumnsOnly(const Schema& indexed_schema) const;
 
-  // Is column covered by this index? (Note: indexed columns are always covered)
+  // Is column covered by this index? (Note: indexed columns are always covered, but not the jsonb
+  // columns of which only a path is indexed)
   bool IsColumnCovered(ColumnId column_id) const;
 
  private:
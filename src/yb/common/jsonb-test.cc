@@ -15,6 +15,7 @@
 #include <rapidjson/prettywriter.h>
 
 #include "yb/common/jsonb.h"
+#include "yb/util/format.h"
 #include "yb/util/test_macros.h"
 #include "yb/util/test_util.h"
 
@@ -151,5 +152,49 @@ TEST(JsonbTest, TestArrays) {
   VerifyArray(document);
 }
 
+namespace {
+
+void AddJsonOperation(JsonOperatorPB json_operator, const std::string& key,
+                      QLJsonColumnOperationsPB* json_ops) {
+  auto* json_op = json_ops->add_json_operations();
+  json_op->set_json_operator(json_operator);
+  json_op->mutable_operand()->mutable_value()->set_string_value(key);
+}
+
+} // namespace
+
+TEST(JsonbTest, TestOperatorsOnLargeObject) {
+  // Keys are inserted in an order that differs from the sorted one, and one key is duplicated.
+  constexpr int kNumKeys = 500;
+  std::string json = "{";
+  for (int i = kNumKeys; i-- > 0;) {
+    json += Format(R"#("k$0" : { "n" : $0, "s" : "v$0" }, )#", i);
+  }
+  json += R"#("k7" : 0})#";
+  Jsonb jsonb;
+  ASSERT_OK(jsonb.FromString(json));
+
+  for (int i = 0; i != kNumKeys; ++i) {
+    QLJsonColumnOperationsPB json_ops;
+    AddJsonOperation(JsonOperatorPB::JSON_OBJECT, Format("k$0", i), &json_ops);
+    AddJsonOperation(JsonOperatorPB::JSON_TEXT, "s", &json_ops);
+    QLValue result;
+    ASSERT_OK(jsonb.ApplyJsonbOperators(json_ops, &result));
+    ASSERT_EQ(Format("v$0", i), result.string_value());
+
+    json_ops.mutable_json_operations(1)->mutable_operand()->mutable_value()->set_string_value("n");
+    ASSERT_OK(Jsonb::ApplyJsonbOperators(jsonb.SerializedJsonb(), json_ops, &result));
+    ASSERT_EQ(to_string(i), result.string_value());
+  }
+
+  for (const auto& missing : {"k", "k500", "k07", "zzz", ""}) {
+    QLJsonColumnOperationsPB json_ops;
+    AddJsonOperation(JsonOperatorPB::JSON_OBJECT, missing, &json_ops);
+    QLValue result;
+    ASSERT_OK(jsonb.ApplyJsonbOperators(json_ops, &result));
+    ASSERT_TRUE(result.IsNull()) << missing;
+  }
+}
+
 }  // namespace common
 }  // namespace yb
@@ -11,6 +11,9 @@
 // under the License.
 //
 
+#include <algorithm>
+#include <vector>
+
 #include <rapidjson/document.h>
 #include <rapidjson/error/en.h>
 #include <rapidjson/stringbuffer.h>
@@ -94,11 +97,22 @@ CHECKED_STATUS Jsonb::ToJsonbProcessObject(const rapidjson::Value& document,
                                            std::string* jsonb) {
   DCHECK(document.IsObject());
 
-  // Use a map since we need to store the keys in sorted order.
-  std::map<string, const rapidjson::Value&> kv_pairs;
+  // Keys are stored in sorted order, so they can be looked up with a binary search. Like with a
+  // map, only the first of duplicate keys is kept.
+  std::vector<std::pair<Slice, const rapidjson::Value*>> kv_pairs;
+  kv_pairs.reserve(document.MemberCount());
   for (const auto& member : document.GetObject()) {
-    kv_pairs.emplace(member.name.GetString(), member.value);
+    kv_pairs.emplace_back(Slice(member.name.GetString(), member.name.GetStringLength()),
+                          &member.value);
   }
+  std::stable_sort(kv_pairs.begin(), kv_pairs.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.first.compare(rhs.first) < 0;
+  });
+  auto unique_end = std::unique(
+      kv_pairs.begin(), kv_pairs.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.first == rhs.first;
+      });
+  kv_pairs.erase(unique_end, kv_pairs.end());
 
   size_t metadata_offset, jsonb_metadata_size;
   std::tie(metadata_offset, jsonb_metadata_size) = ComputeOffsetsAndJsonbHeader(kv_pairs.size(),
@@ -107,7 +121,7 @@ CHECKED_STATUS Jsonb::ToJsonbProcessObject(const rapidjson::Value& document,
   // Now append the keys and store the key offsets in the jentry.
   size_t data_begin_offset = jsonb->size();
   for (const auto& entry : kv_pairs) {
-    jsonb->append(entry.first);
+    jsonb->append(entry.first.cdata(), entry.first.size());
     auto key_offset = jsonb->size() - data_begin_offset;
     JEntry jentry = GetOffset(key_offset) | kJEIsString; // keys are always strings.
     BigEndian::Store32(&((*jsonb)[metadata_offset]), jentry);
@@ -116,7 +130,7 @@ CHECKED_STATUS Jsonb::ToJsonbProcessObject(const rapidjson::Value& document,
 
   // Append the values to the buffer.
   for (const auto& entry : kv_pairs) {
-    const rapidjson::Value& value = entry.second;
+    const rapidjson::Value& value = *entry.second;
     RETURN_NOT_OK(ProcessJsonValueAndMetadata(value, data_begin_offset, jsonb, &metadata_offset));
   }
 
@@ -175,7 +189,7 @@ CHECKED_STATUS Jsonb::ProcessJsonValueAndMetadata(const rapidjson::Value& value,
       break;
     case rapidjson::Type::kStringType:
       jentry |= kJEIsString;
-      jsonb->append(value.GetString());
+      jsonb->append(value.GetString(), value.GetStringLength());
       break;
   }
 
@@ -683,12 +697,12 @@ Status Jsonb::ApplyJsonbOperatorToObject(const Slice& jsonb, const QLJsonOperati
     Slice mid_key;
     RETURN_NOT_OK(GetObjectKey(mid, jsonb, metadata_begin_offset, data_begin_offset, &mid_key));
 
-    if (mid_key == search_key_slice) {
-      RETURN_NOT_OK(GetObjectValue(mid, jsonb, sizeof(jsonb_header),
-                                   ComputeDataOffset(num_kv_pairs, kJBObject), num_kv_pairs,
-                                   result, element_metadata));
+    const int cmp = mid_key.compare(search_key_slice);
+    if (cmp == 0) {
+      RETURN_NOT_OK(GetObjectValue(mid, jsonb, metadata_begin_offset, data_begin_offset,
+                                   num_kv_pairs, result, element_metadata));
       return Status::OK();
-    } else if (mid_key.ToBuffer() > search_key) {
+    } else if (cmp > 0) {
       high = mid - 1;
     } else {
       low = mid + 1;
@@ -698,10 +712,15 @@ Status Jsonb::ApplyJsonbOperatorToObject(const Slice& jsonb, const QLJsonOperati
 }
 
 Status Jsonb::ApplyJsonbOperators(const QLJsonColumnOperationsPB& json_ops, QLValue* result) const {
+  return ApplyJsonbOperators(serialized_jsonb_, json_ops, result);
+}
+
+Status Jsonb::ApplyJsonbOperators(const Slice& jsonb, const QLJsonColumnOperationsPB& json_ops,
+                                  QLValue* result) {
   const int num_ops = json_ops.json_operations().size();
 
   Slice jsonop_result;
-  Slice operand(serialized_jsonb_);
+  Slice operand(jsonb);
   JEntry element_metadata;
   for (int i = 0; i < num_ops; i++) {
     const QLJsonOperationPB &op = json_ops.json_operations().Get(i);
@@ -737,7 +756,10 @@ Status Jsonb::ApplyJsonbOperators(const QLJsonColumnOperationsPB& json_ops, QLVa
     return Status::OK();
   }
 
-  string jsonb_result = jsonop_result.ToBuffer();
+  string jsonb_result;
+  if (!IsScalar(element_metadata)) {
+    jsonb_result = jsonop_result.ToBuffer();
+  }
   if (IsScalar(element_metadata)) {
     // In case of a scalar that is received from an operation, convert it to a jsonb scalar.
     RETURN_NOT_OK(CreateScalar(jsonop_result,
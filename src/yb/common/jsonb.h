@@ -79,6 +79,13 @@ class Jsonb {
   CHECKED_STATUS ApplyJsonbOperators(const QLJsonColumnOperationsPB& json_ops,
                                      QLValue* result) const;
 
+  // Applies the operators to the serialized jsonb in place, only copying the extracted element
+  // into the result, so the document does not have to be copied or deserialized. Object keys are
+  // looked up with a binary search, since they are stored in sorted order.
+  static CHECKED_STATUS ApplyJsonbOperators(const Slice& jsonb,
+                                            const QLJsonColumnOperationsPB& json_ops,
+                                            QLValue* result);
+
   const std::string& SerializedJsonb() const;
 
   // Use with extreme care since this destroys the internal state of the object. The only purpose
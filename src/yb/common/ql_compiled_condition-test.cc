@@ -0,0 +1,102 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/common/ql_compiled_condition.h"
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+namespace yb {
+
+namespace {
+
+QLConditionPB* AddColumnTerm(QLConditionPB* parent, QLOperator op, int column_id) {
+  QLConditionPB* term = parent->add_operands()->mutable_condition();
+  term->set_op(op);
+  term->add_operands()->set_column_id(column_id);
+  return term;
+}
+
+void AddInt32Term(QLConditionPB* parent, QLOperator op, int column_id, int32_t value) {
+  AddColumnTerm(parent, op, column_id)->add_operands()->mutable_value()->set_int32_value(value);
+}
+
+} // namespace
+
+class CompiledQLConditionTest : public YBTest {
+ protected:
+  // Checks that the compiled condition gives the same result as the expression executor.
+  void CheckRow(const QLConditionPB& condition, const QLTableRow& row, bool expected) {
+    auto compiled = CompiledQLCondition::Compile(condition);
+    ASSERT_TRUE(compiled != nullptr);
+    bool compiled_match = !expected;
+    ASSERT_OK(compiled->Match(row, &compiled_match));
+    bool executor_match = !expected;
+    ASSERT_OK(executor_.EvalCondition(condition, row, &executor_match));
+    ASSERT_EQ(expected, compiled_match) << row.ToString();
+    ASSERT_EQ(expected, executor_match) << row.ToString();
+  }
+
+  QLExprExecutor executor_;
+};
+
+TEST_F(CompiledQLConditionTest, Conjunction) {
+  // c10 >= 5 AND c10 < 10 AND c11 IN (1, 3) AND c12 IS NULL
+  QLConditionPB condition;
+  condition.set_op(QL_OP_AND);
+  AddInt32Term(&condition, QL_OP_GREATER_THAN_EQUAL, 10, 5);
+  AddInt32Term(&condition, QL_OP_LESS_THAN, 10, 10);
+  auto* in_list = AddColumnTerm(&condition, QL_OP_IN, 11)->add_operands()->mutable_value()
+      ->mutable_list_value();
+  in_list->add_elems()->set_int32_value(1);
+  in_list->add_elems()->set_int32_value(3);
+  AddColumnTerm(&condition, QL_OP_IS_NULL, 12);
+  ASSERT_EQ(4, CompiledQLCondition::Compile(condition)->num_terms());
+
+  QLTableRow row;
+  row.AllocColumn(10).value.set_int32_value(7);
+  row.AllocColumn(11).value.set_int32_value(3);
+  CheckRow(condition, row, true);
+
+  row.AllocColumn(11).value.set_int32_value(2);
+  CheckRow(condition, row, false);
+
+  row.AllocColumn(11).value.set_int32_value(1);
+  row.AllocColumn(10).value.set_int32_value(10);
+  CheckRow(condition, row, false);
+
+  row.AllocColumn(10).value.set_int32_value(5);
+  row.AllocColumn(12).value.set_int32_value(0);
+  CheckRow(condition, row, false);
+
+  // A missing column compares as null.
+  QLTableRow empty_row;
+  CheckRow(condition, empty_row, false);
+}
+
+TEST_F(CompiledQLConditionTest, NotCompiled) {
+  // OR is not supported.
+  QLConditionPB condition;
+  condition.set_op(QL_OP_OR);
+  AddInt32Term(&condition, QL_OP_EQUAL, 10, 1);
+  AddInt32Term(&condition, QL_OP_EQUAL, 10, 2);
+  ASSERT_TRUE(CompiledQLCondition::Compile(condition) == nullptr);
+
+  // Neither is a constant on the left hand side of a comparison.
+  QLConditionPB reversed;
+  reversed.set_op(QL_OP_EQUAL);
+  reversed.add_operands()->mutable_value()->set_int32_value(1);
+  reversed.add_operands()->set_column_id(10);
+  ASSERT_TRUE(CompiledQLCondition::Compile(reversed) == nullptr);
+}
+
+} // namespace yb
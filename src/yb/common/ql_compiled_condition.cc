@@ -0,0 +1,144 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/common/ql_compiled_condition.h"
+
+#include "yb/common/ql_value.h"
+
+namespace yb {
+
+std::unique_ptr<CompiledQLCondition> CompiledQLCondition::Compile(const QLConditionPB& condition) {
+  std::unique_ptr<CompiledQLCondition> result(new CompiledQLCondition());
+  if (!result->AddTerms(condition) || result->terms_.empty()) {
+    return nullptr;
+  }
+  return result;
+}
+
+bool CompiledQLCondition::AddTerms(const QLConditionPB& condition) {
+  const auto& operands = condition.operands();
+  switch (condition.op()) {
+    case QL_OP_AND:
+      for (const auto& operand : operands) {
+        if (operand.expr_case() != QLExpressionPB::ExprCase::kCondition ||
+            !AddTerms(operand.condition())) {
+          return false;
+        }
+      }
+      return true;
+
+    case QL_OP_IS_NULL: FALLTHROUGH_INTENDED;
+    case QL_OP_IS_NOT_NULL:
+      if (operands.size() != 1 ||
+          operands.Get(0).expr_case() != QLExpressionPB::ExprCase::kColumnId) {
+        return false;
+      }
+      terms_.push_back({operands.Get(0).column_id(), condition.op(), nullptr});
+      return true;
+
+    case QL_OP_IN: FALLTHROUGH_INTENDED;
+    case QL_OP_NOT_IN:
+      if (operands.size() != 2 ||
+          operands.Get(1).expr_case() != QLExpressionPB::ExprCase::kValue ||
+          operands.Get(1).value().value_case() != QLValuePB::kListValue) {
+        return false;
+      }
+      FALLTHROUGH_INTENDED;
+    case QL_OP_EQUAL: FALLTHROUGH_INTENDED;
+    case QL_OP_NOT_EQUAL: FALLTHROUGH_INTENDED;
+    case QL_OP_LESS_THAN: FALLTHROUGH_INTENDED;
+    case QL_OP_LESS_THAN_EQUAL: FALLTHROUGH_INTENDED;
+    case QL_OP_GREATER_THAN: FALLTHROUGH_INTENDED;
+    case QL_OP_GREATER_THAN_EQUAL:
+      if (operands.size() != 2 ||
+          operands.Get(0).expr_case() != QLExpressionPB::ExprCase::kColumnId ||
+          operands.Get(1).expr_case() != QLExpressionPB::ExprCase::kValue) {
+        return false;
+      }
+      terms_.push_back({operands.Get(0).column_id(), condition.op(), &operands.Get(1).value()});
+      return true;
+
+    default:
+      return false;
+  }
+}
+
+CHECKED_STATUS CompiledQLCondition::Match(const QLTableRow& table_row, bool* match) const {
+#define QL_COMPILED_RELATIONAL_OP(op) \
+  do { \
+    if (!Comparable(left, *term.value)) { \
+      return STATUS(RuntimeError, "values not comparable"); \
+    } \
+    term_match = left op *term.value; \
+  } while (false)
+
+  for (const Term& term : terms_) {
+    auto column_value = table_row.GetValue(term.column_id);
+    const QLValuePB& left = column_value ? *column_value : QLValuePB::default_instance();
+    bool term_match = false;
+    switch (term.op) {
+      case QL_OP_IS_NULL:
+        term_match = IsNull(left);
+        break;
+      case QL_OP_IS_NOT_NULL:
+        term_match = !IsNull(left);
+        break;
+      case QL_OP_EQUAL:
+        QL_COMPILED_RELATIONAL_OP(==);
+        break;
+      case QL_OP_NOT_EQUAL:
+        QL_COMPILED_RELATIONAL_OP(!=);
+        break;
+      case QL_OP_LESS_THAN:
+        QL_COMPILED_RELATIONAL_OP(<);                                                      // NOLINT
+        break;
+      case QL_OP_LESS_THAN_EQUAL:
+        QL_COMPILED_RELATIONAL_OP(<=);
+        break;
+      case QL_OP_GREATER_THAN:
+        QL_COMPILED_RELATIONAL_OP(>);                                                      // NOLINT
+        break;
+      case QL_OP_GREATER_THAN_EQUAL:
+        QL_COMPILED_RELATIONAL_OP(>=);
+        break;
+      case QL_OP_IN: FALLTHROUGH_INTENDED;
+      case QL_OP_NOT_IN: {
+        bool found = false;
+        for (const QLValuePB& elem : term.value->list_value().elems()) {
+          if (!Comparable(elem, left)) {
+            return STATUS(RuntimeError, "values not comparable");
+          }
+          if (elem == left) {
+            found = true;
+            break;
+          }
+        }
+        term_match = (term.op == QL_OP_IN) == found;
+        break;
+      }
+      default:
+        return STATUS_FORMAT(InternalError, "Unexpected operator in compiled condition: $0",
+                             QLOperator_Name(term.op));
+    }
+    if (!term_match) {
+      *match = false;
+      return Status::OK();
+    }
+  }
+  *match = true;
+  return Status::OK();
+
+#undef QL_COMPILED_RELATIONAL_OP
+}
+
+} // namespace yb
@@ -0,0 +1,61 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+//
+// This file contains CompiledQLCondition, a flattened form of simple WHERE conditions used to
+// filter scanned rows.
+
+#ifndef YB_COMMON_QL_COMPILED_CONDITION_H
+#define YB_COMMON_QL_COMPILED_CONDITION_H
+
+#include <memory>
+#include <vector>
+
+#include "yb/common/ql_expr.h"
+#include "yb/common/ql_protocol.pb.h"
+
+namespace yb {
+
+// A WHERE condition that is a conjunction of "column <op> constant" terms (=, !=, <, <=, >, >=,
+// IN, NOT IN, IS NULL and IS NOT NULL), compiled into a flat list of terms. Evaluating it reads
+// column values in place from the QLTableRow, without copying them into QLValue temporaries or
+// recursing through QLExprExecutor, which dominates the CPU cost of filtering large scans.
+//
+// The compiled condition refers to the constants of the condition it was compiled from, so that
+// condition should outlive it. Evaluation results are identical to QLExprExecutor::EvalCondition.
+class CompiledQLCondition {
+ public:
+  // Returns nullptr when the condition does not have the supported shape.
+  static std::unique_ptr<CompiledQLCondition> Compile(const QLConditionPB& condition);
+
+  // Evaluate the condition for the given row.
+  CHECKED_STATUS Match(const QLTableRow& table_row, bool* match) const;
+
+  size_t num_terms() const { return terms_.size(); }
+
+ private:
+  struct Term {
+    ColumnIdRep column_id;
+    QLOperator op;
+    const QLValuePB* value;
+  };
+
+  CompiledQLCondition() {}
+
+  bool AddTerms(const QLConditionPB& condition);
+
+  std::vector<Term> terms_;
+};
+
+} // namespace yb
+
+#endif // YB_COMMON_QL_COMPILED_CONDITION_H
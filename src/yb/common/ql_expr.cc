@@ -31,11 +31,11 @@ CHECKED_STATUS QLExprExecutor::EvalExpr(const QLExpressionPB& ql_expr,
       break;
 
     case QLExpressionPB::ExprCase::kJsonColumn: {
-      QLValue ql_value;
+      // Only the extracted element is copied out of the row, not the whole document.
       const QLJsonColumnOperationsPB& json_ops = ql_expr.json_column();
-      RETURN_NOT_OK(table_row.ReadColumn(json_ops.column_id(), &ql_value));
-      common::Jsonb jsonb(std::move(ql_value.jsonb_value()));
-      RETURN_NOT_OK(jsonb.ApplyJsonbOperators(json_ops, result));
+      const auto value = table_row.GetValue(json_ops.column_id());
+      RETURN_NOT_OK(common::Jsonb::ApplyJsonbOperators(
+          value ? Slice(value->jsonb_value()) : Slice(), json_ops, result));
       break;
     }
 
@@ -358,7 +358,9 @@ CHECKED_STATUS QLExprExecutor::EvalExpr(const PgsqlExpressionPB& ql_expr,
     case PgsqlExpressionPB::ExprCase::kTscall:
       return EvalTSCall(ql_expr.tscall(), table_row, result);
 
-    case PgsqlExpressionPB::ExprCase::kBocall: FALLTHROUGH_INTENDED;
+    case PgsqlExpressionPB::ExprCase::kBocall:
+      return EvalBOCall(ql_expr.bocall(), table_row, result);
+
     case PgsqlExpressionPB::ExprCase::kBindId: FALLTHROUGH_INTENDED;
     case PgsqlExpressionPB::ExprCase::kAliasId: FALLTHROUGH_INTENDED;
     case PgsqlExpressionPB::ExprCase::EXPR_NOT_SET:
@@ -417,6 +419,129 @@ CHECKED_STATUS QLExprExecutor::EvalBFCall(const PgsqlBCallPB& bfcall,
 
 //--------------------------------------------------------------------------------------------------
 
+CHECKED_STATUS QLExprExecutor::EvalBOCall(const PgsqlBCallPB& bocall,
+                                          const QLTableRow::SharedPtrConst& table_row,
+                                          QLValue *result) {
+#define PG_EVALUATE_RELATIONAL_OP(op)                                                              \
+  do {                                                                                             \
+    if (operands.size() != 2) {                                                                    \
+      return STATUS_FORMAT(InvalidArgument, "Operator $0 needs 2 operands", bocall.opcode());     \
+    }                                                                                              \
+    QLValue left, right;                                                                           \
+    RETURN_NOT_OK(EvalExpr(operands.Get(0), table_row, &left));                                    \
+    RETURN_NOT_OK(EvalExpr(operands.Get(1), table_row, &right));                                   \
+    if (left.EitherIsNull(right)) {                                                                \
+      result->SetNull();                                                                           \
+    } else if (!left.Comparable(right)) {                                                          \
+      return STATUS(RuntimeError, "values not comparable");                                        \
+    } else {                                                                                       \
+      result->set_bool_value(left.CompareTo(right) op 0);                                          \
+    }                                                                                              \
+    return Status::OK();                                                                           \
+  } while (false)
+
+  QLValue temp;
+  const auto& operands = bocall.operands();
+  switch (static_cast<QLOperator>(bocall.opcode())) {
+    case QL_OP_NOT:
+      if (operands.size() != 1) {
+        return STATUS(InvalidArgument, "Operator NOT needs 1 operand");
+      }
+      RETURN_NOT_OK(EvalExpr(operands.Get(0), table_row, &temp));
+      if (temp.IsNull()) {
+        result->SetNull();
+      } else {
+        result->set_bool_value(!temp.bool_value());
+      }
+      return Status::OK();
+
+    case QL_OP_IS_NULL: FALLTHROUGH_INTENDED;
+    case QL_OP_IS_NOT_NULL:
+      if (operands.size() != 1) {
+        return STATUS(InvalidArgument, "Operator IS [NOT] NULL needs 1 operand");
+      }
+      RETURN_NOT_OK(EvalExpr(operands.Get(0), table_row, &temp));
+      result->set_bool_value(temp.IsNull() == (bocall.opcode() == QL_OP_IS_NULL));
+      return Status::OK();
+
+    case QL_OP_EQUAL:
+      PG_EVALUATE_RELATIONAL_OP(==);
+
+    case QL_OP_LESS_THAN:
+      PG_EVALUATE_RELATIONAL_OP(<);                                                      // NOLINT
+
+    case QL_OP_LESS_THAN_EQUAL:
+      PG_EVALUATE_RELATIONAL_OP(<=);
+
+    case QL_OP_GREATER_THAN:
+      PG_EVALUATE_RELATIONAL_OP(>);                                                      // NOLINT
+
+    case QL_OP_GREATER_THAN_EQUAL:
+      PG_EVALUATE_RELATIONAL_OP(>=);
+
+    case QL_OP_NOT_EQUAL:
+      PG_EVALUATE_RELATIONAL_OP(!=);
+
+    case QL_OP_AND: FALLTHROUGH_INTENDED;
+    case QL_OP_OR: {
+      // AND is false if any operand is false, OR is true if any operand is true. Otherwise the
+      // result is null if any operand is null.
+      const bool is_and = bocall.opcode() == QL_OP_AND;
+      bool has_null = false;
+      for (const auto& operand : operands) {
+        RETURN_NOT_OK(EvalExpr(operand, table_row, &temp));
+        if (temp.IsNull()) {
+          has_null = true;
+        } else if (temp.bool_value() != is_and) {
+          result->set_bool_value(!is_and);
+          return Status::OK();
+        }
+      }
+      if (has_null) {
+        result->SetNull();
+      } else {
+        result->set_bool_value(is_and);
+      }
+      return Status::OK();
+    }
+
+    case QL_OP_IN: {
+      // The first operand is compared with each of the others.
+      if (operands.size() < 2) {
+        return STATUS(InvalidArgument, "Operator IN needs at least 2 operands");
+      }
+      QLValue left;
+      RETURN_NOT_OK(EvalExpr(operands.Get(0), table_row, &left));
+      bool has_null = left.IsNull();
+      for (int i = 1; !left.IsNull() && i < operands.size(); ++i) {
+        RETURN_NOT_OK(EvalExpr(operands.Get(i), table_row, &temp));
+        if (temp.IsNull()) {
+          has_null = true;
+        } else if (!left.Comparable(temp)) {
+          return STATUS(RuntimeError, "values not comparable");
+        } else if (left.CompareTo(temp) == 0) {
+          result->set_bool_value(true);
+          return Status::OK();
+        }
+      }
+      if (has_null) {
+        result->SetNull();
+      } else {
+        result->set_bool_value(false);
+      }
+      return Status::OK();
+    }
+
+    default:
+      break;
+  }
+
+  result->SetNull();
+  return STATUS_FORMAT(RuntimeError, "Unsupported builtin operator: $0", bocall.opcode());
+
+#undef PG_EVALUATE_RELATIONAL_OP
+}
+
 CHECKED_STATUS QLExprExecutor::EvalTSCall(const PgsqlBCallPB& ql_expr,
                                           const QLTableRow::SharedPtrConst& table_row,
                                           QLValue *result) {
@@ -433,14 +558,23 @@ CHECKED_STATUS QLExprExecutor::ReadTSCallValue(const PgsqlBCallPB& ql_expr,
 
 //--------------------------------------------------------------------------------------------------
 
+const QLTableColumn* QLTableRow::FindColumn(ColumnIdRep col_id) const {
+  for (size_t i = 0; i < num_columns_; ++i) {
+    if (columns_[i].first == col_id) {
+      return &columns_[i].second;
+    }
+  }
+  return nullptr;
+}
+
 CHECKED_STATUS QLTableRow::ReadColumn(ColumnIdRep col_id, QLValue *col_value) const {
-  const auto& col_iter = col_map_.find(col_id);
-  if (col_iter == col_map_.end()) {
+  const QLTableColumn* column = FindColumn(col_id);
+  if (column == nullptr) {
     col_value->SetNull();
     return Status::OK();
   }
 
-  *col_value = col_iter->second.value;
+  *col_value = column->value;
   return Status::OK();
 }
 
@@ -449,21 +583,21 @@ CHECKED_STATUS QLTableRow::ReadSubscriptedColumn(const QLSubscriptedColPB& subco
                                                  QLValue *col_value) const {
   col_value->SetNull();
 
-  const auto& col_iter = col_map_.find(subcol.column_id());
-  if (col_iter == col_map_.end()) {
+  const QLTableColumn* column = FindColumn(subcol.column_id());
+  if (column == nullptr) {
     // Not exists.
     return Status::OK();
-  } else if (col_iter->second.value.has_map_value()) {
+  } else if (column->value.has_map_value()) {
     // map['key']
-    auto& map = col_iter->second.value.map_value();
+    auto& map = column->value.map_value();
     for (int i = 0; i < map.keys_size(); i++) {
       if (map.keys(i) == index_arg.value()) {
           *col_value = map.values(i);
       }
     }
-  } else if (col_iter->second.value.has_list_value()) {
+  } else if (column->value.has_list_value()) {
     // list[index]
-    auto& list = col_iter->second.value.list_value();
+    auto& list = column->value.list_value();
     if (index_arg.value().has_int32_value()) {
       int list_index = index_arg.int32_value();
       if (list_index >= 0 && list_index < list.elems_size()) {
@@ -475,91 +609,118 @@ CHECKED_STATUS QLTableRow::ReadSubscriptedColumn(const QLSubscriptedColPB& subco
 }
 
 CHECKED_STATUS QLTableRow::GetTTL(ColumnIdRep col_id, int64_t *ttl_seconds) const {
-  const auto& col_iter = col_map_.find(col_id);
-  if (col_iter == col_map_.end()) {
+  const QLTableColumn* column = FindColumn(col_id);
+  if (column == nullptr) {
     // Not exists.
     return STATUS(InternalError, "Column unexpectedly not found in cache");
   }
-  *ttl_seconds = col_iter->second.ttl_seconds;
+  *ttl_seconds = column->ttl_seconds;
   return Status::OK();
 }
 
 CHECKED_STATUS QLTableRow::GetWriteTime(ColumnIdRep col_id, int64_t *write_time) const {
-  const auto& col_iter = col_map_.find(col_id);
-  if (col_iter == col_map_.end()) {
+  const QLTableColumn* column = FindColumn(col_id);
+  if (column == nullptr) {
     // Not exists.
     return STATUS(InternalError, "Column unexpectedly not found in cache");
   }
-  DCHECK_NE(QLTableColumn::kUninitializedWriteTime, col_iter->second.write_time);
-  *write_time = col_iter->second.write_time;
+  DCHECK_NE(QLTableColumn::kUninitializedWriteTime, column->write_time);
+  *write_time = column->write_time;
   return Status::OK();
 }
 
 CHECKED_STATUS QLTableRow::GetValue(ColumnIdRep col_id, QLValue *column) const {
-  const auto& col_iter = col_map_.find(col_id);
-  if (col_iter == col_map_.end()) {
+  const QLTableColumn* table_column = FindColumn(col_id);
+  if (table_column == nullptr) {
     // Not exists.
     return STATUS(InternalError, "Column unexpectedly not found in cache");
   }
-  *column = std::move(col_iter->second.value);
+  *column = table_column->value;
   return Status::OK();
 }
 
 boost::optional<const QLValuePB&> QLTableRow::GetValue(ColumnIdRep col_id) const {
-  const auto& col_iter = col_map_.find(col_id);
-  if (col_iter == col_map_.end()) {
+  const QLTableColumn* column = FindColumn(col_id);
+  if (column == nullptr) {
     return boost::none;
   }
-  return col_iter->second.value;
+  return column->value;
 }
 
 void QLTableRow::ClearValue(ColumnIdRep col_id) {
-  col_map_[col_id].value.Clear();
+  AllocColumn(col_id).value.Clear();
 }
 
 bool QLTableRow::MatchColumn(ColumnIdRep col_id, const QLTableRow& source) const {
-  auto this_iter = col_map_.find(col_id);
-  auto source_iter = source.col_map_.find(col_id);
-  if (this_iter != col_map_.end() && source_iter != source.col_map_.end()) {
-    return this_iter->second.value == source_iter->second.value;
+  const QLTableColumn* this_column = FindColumn(col_id);
+  const QLTableColumn* source_column = source.FindColumn(col_id);
+  if (this_column != nullptr && source_column != nullptr) {
+    return this_column->value == source_column->value;
   }
-  if (this_iter != col_map_.end() || source_iter != source.col_map_.end()) {
+  if (this_column != nullptr || source_column != nullptr) {
     return false;
   }
   return true;
 }
 
 QLTableColumn& QLTableRow::AllocColumn(ColumnIdRep col_id) {
-  return col_map_[col_id];
+  QLTableColumn* column = FindColumn(col_id);
+  if (column != nullptr) {
+    return *column;
+  }
+  if (num_columns_ == columns_.size()) {
+    columns_.emplace_back(col_id, QLTableColumn());
+    return columns_[num_columns_++].second;
+  }
+  // Reuse a slot left over from a previous row. Clearing the value keeps the memory allocated by
+  // the protobuf for reuse.
+  auto& slot = columns_[num_columns_++];
+  slot.first = col_id;
+  slot.second.value.Clear();
+  slot.second.ttl_seconds = 0;
+  slot.second.write_time = QLTableColumn::kUninitializedWriteTime;
+  return slot.second;
 }
 
 QLTableColumn& QLTableRow::AllocColumn(ColumnIdRep col_id, const QLValue& ql_value) {
-  col_map_[col_id].value = ql_value.value();
-  return col_map_[col_id];
+  QLTableColumn& column = AllocColumn(col_id);
+  column.value = ql_value.value();
+  return column;
 }
 
 QLTableColumn& QLTableRow::AllocColumn(ColumnIdRep col_id, const QLValuePB& ql_value) {
-  col_map_[col_id].value = ql_value;
-  return col_map_[col_id];
+  QLTableColumn& column = AllocColumn(col_id);
+  column.value = ql_value;
+  return column;
 }
 
 CHECKED_STATUS QLTableRow::CopyColumn(ColumnIdRep col_id,
                                       const QLTableRow& source) {
-  auto col_iter = source.col_map_.find(col_id);
-  if (col_iter != source.col_map_.end()) {
-    col_map_[col_id] = col_iter->second;
+  const QLTableColumn* source_column = source.FindColumn(col_id);
+  if (source_column != nullptr) {
+    AllocColumn(col_id) = *source_column;
   }
   return Status::OK();
 }
 
+std::string QLTableRow::ToString() const {
+  std::string ret = "{";
+  for (size_t i = 0; i < num_columns_; ++i) {
+    ret += i == 0 ? " " : ", ";
+    ret += Format("$0: $1", columns_[i].first, columns_[i].second.ToString());
+  }
+  ret += " }";
+  return ret;
+}
+
 std::string QLTableRow::ToString(const Schema& schema) const {
   std::string ret;
   ret.append("{ ");
 
   for (size_t col_idx = 0; col_idx < schema.num_columns(); col_idx++) {
-    auto it = col_map_.find(schema.column_id(col_idx));
-    if (it != col_map_.end() && it->second.value.value_case() != QLValuePB::VALUE_NOT_SET) {
-      ret += it->second.value.ShortDebugString();
+    const QLTableColumn* column = FindColumn(schema.column_id(col_idx));
+    if (column != nullptr && column->value.value_case() != QLValuePB::VALUE_NOT_SET) {
+      ret += column->value.ShortDebugString();
     } else {
       ret += "null";
     }
@@ -7,6 +7,8 @@
 #ifndef YB_COMMON_QL_EXPR_H_
 #define YB_COMMON_QL_EXPR_H_
 
+#include <deque>
+
 #include "yb/common/ql_value.h"
 #include "yb/common/schema.h"
 #include "yb/common/ql_bfunc.h"
@@ -73,16 +75,17 @@ class QLTableRow {
 
   // Check if row is empty (no column).
   bool IsEmpty() const {
-    return col_map_.empty();
+    return num_columns_ == 0;
   }
 
   // Get column count.
   size_t ColumnCount() const {
-    return col_map_.size();
+    return num_columns_;
   }
 
-  // Clear the row.
-  void Clear() { col_map_.clear(); }
+  // Clear the row. The column slots stay allocated, so that the next row read into this object
+  // reuses them instead of allocating its columns again.
+  void Clear() { num_columns_ = 0; }
 
   // Compare column value between two rows.
   bool MatchColumn(ColumnIdRep col_id, const QLTableRow& source) const;
@@ -139,20 +142,30 @@ class QLTableRow {
 
   // For testing only (no status check).
   const QLTableColumn& TestValue(ColumnIdRep col_id) const {
-    return col_map_.at(col_id);
+    const QLTableColumn* column = FindColumn(col_id);
+    CHECK(column != nullptr) << "Column not found: " << col_id;
+    return *column;
   }
   const QLTableColumn& TestValue(const ColumnId& col) const {
-    return col_map_.at(col.rep());
+    return TestValue(col.rep());
   }
 
-  std::string ToString() const {
-    return yb::ToString(col_map_);
-  }
+  std::string ToString() const;
 
   std::string ToString(const Schema& schema) const;
 
  private:
-  std::unordered_map<ColumnIdRep, QLTableColumn> col_map_;
+  const QLTableColumn* FindColumn(ColumnIdRep col_id) const;
+  QLTableColumn* FindColumn(ColumnIdRep col_id) {
+    return const_cast<QLTableColumn*>(const_cast<const QLTableRow*>(this)->FindColumn(col_id));
+  }
+
+  // Rows have few columns, so they are kept in a flat array and looked up by a linear scan, which
+  // is cheaper than hashing and does not allocate a node per column. Only the first num_columns_
+  // slots are in use; the rest are left over from previous rows and are reused by AllocColumn.
+  // A deque keeps references returned by AllocColumn valid while more columns are added.
+  std::deque<std::pair<ColumnIdRep, QLTableColumn>> columns_;
+  size_t num_columns_ = 0;
 };
 
 class QLExprExecutor {
@@ -235,6 +248,12 @@ class QLExprExecutor {
                                     const QLTableRow::SharedPtrConst& table_row,
                                     QLValue *result);
 
+  // Evaluate call to builtin operator, whose opcode is a QLOperator. Follows the SQL rules for
+  // null, so a comparison with a null operand is null, and null is not a match.
+  virtual CHECKED_STATUS EvalBOCall(const PgsqlBCallPB& ql_expr,
+                                    const QLTableRow::SharedPtrConst& table_row,
+                                    QLValue *result);
+
   // Evaluate call to tablet-server builtin operator.
   virtual CHECKED_STATUS EvalTSCall(const PgsqlBCallPB& ql_expr,
                                     const QLTableRow::SharedPtrConst& table_row,
@@ -122,4 +122,16 @@ bool RequireRead(const QLWriteRequestPB& request, const Schema& schema) {
   return RequireReadForExpressions(request) || has_user_timestamp || is_range_operation;
 }
 
+void AddExecutionStats(const DocDBExecutionStatsPB& stats, DocDBExecutionStatsPB* total) {
+  total->set_seeks(total->seeks() + stats.seeks());
+  total->set_nexts(total->nexts() + stats.nexts());
+  total->set_block_cache_hits(total->block_cache_hits() + stats.block_cache_hits());
+  total->set_blocks_read(total->blocks_read() + stats.blocks_read());
+  total->set_intents(total->intents() + stats.intents());
+  total->set_rows_scanned(total->rows_scanned() + stats.rows_scanned());
+  total->set_rows_returned(total->rows_returned() + stats.rows_returned());
+  total->set_conflict_resolution_time_us(
+      total->conflict_resolution_time_us() + stats.conflict_resolution_time_us());
+}
+
 } // namespace yb
@@ -92,6 +92,9 @@ bool RequireRead(const QLWriteRequestPB& request, const Schema& schema);
 // Does this write request perform a range operation (e.g. range delete)?
 bool IsRangeOperation(const QLWriteRequestPB& request, const Schema& schema);
 
+// Adds the DocDB execution statistics 'stats' to 'total'.
+void AddExecutionStats(const DocDBExecutionStatsPB& stats, DocDBExecutionStatsPB* total);
+
 } // namespace yb
 
 #endif // YB_COMMON_QL_PROTOCOL_UTIL_H
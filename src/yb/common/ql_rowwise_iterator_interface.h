@@ -84,6 +84,13 @@ class YQLRowwiseIteratorIf {
     return STATUS(NotSupported, "This iterator cannot seek by row key");
   }
 
+  // Skips the rest of the rows with the same hashed columns as the row read last, so that the next
+  // row belongs to the next partition key. Iterators that cannot skip stay where they are, so the
+  // caller must still be prepared to see more rows of the same partition key.
+  virtual CHECKED_STATUS SkipToNextPartitionKey() {
+    return Status::OK();
+  }
+
   //------------------------------------------------------------------------------------------------
   // Common API methods.
   //------------------------------------------------------------------------------------------------
@@ -15,6 +15,13 @@
 
 #include "yb/common/ql_scanspec.h"
 
+#include "yb/util/flag_tags.h"
+
+DEFINE_bool(ql_compile_simple_conditions, true,
+            "Evaluate WHERE conditions that are conjunctions of simple column comparisons "
+            "without going through the generic expression executor.");
+TAG_FLAG(ql_compile_simple_conditions, advanced);
+
 namespace yb {
 namespace common {
 
@@ -309,10 +316,16 @@ QLScanSpec::QLScanSpec(const QLConditionPB* condition,
   if (executor_ == nullptr) {
     executor_ = std::make_shared<QLExprExecutor>();
   }
+  if (condition_ != nullptr && FLAGS_ql_compile_simple_conditions) {
+    compiled_condition_ = CompiledQLCondition::Compile(*condition_);
+  }
 }
 
 // Evaluate the WHERE condition for the given row.
 CHECKED_STATUS QLScanSpec::Match(const QLTableRow& table_row, bool* match) const {
+  if (compiled_condition_ != nullptr) {
+    return compiled_condition_->Match(table_row, match);
+  }
   if (condition_ != nullptr) {
     return executor_->EvalCondition(*condition_, table_row, match);
   }
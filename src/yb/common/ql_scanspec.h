@@ -21,6 +21,7 @@
 #include "yb/common/schema.h"
 #include "yb/common/ql_protocol.pb.h"
 #include "yb/common/ql_rowblock.h"
+#include "yb/common/ql_compiled_condition.h"
 #include "yb/common/ql_expr.h"
 
 namespace yb {
@@ -115,6 +116,9 @@ class QLScanSpec : public YQLScanSpec {
   const QLConditionPB* condition_;
   const bool is_forward_scan_;
   QLExprExecutor::SharedPtr executor_;
+
+  // Flat form of condition_ when it is a conjunction of simple column terms, nullptr otherwise.
+  std::unique_ptr<CompiledQLCondition> compiled_condition_;
 };
 
 //--------------------------------------------------------------------------------------------------
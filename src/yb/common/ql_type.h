@@ -512,6 +512,16 @@ class QLType {
     return false;
   }
 
+  // Whether a column of type 'from' can be altered to type 'to' without rewriting existing data.
+  // INT8, INT16 and INT32 share one storage encoding, and INT32 and FLOAT values already on disk
+  // are widened to INT64 and DOUBLE when they are read back.
+  static bool IsStorageWidening(DataType from, DataType to) {
+    if (from >= INT8 && from <= INT64 && to >= INT8 && to <= INT64) {
+      return from <= to;
+    }
+    return from == to || (from == FLOAT && to == DOUBLE);
+  }
+
   static bool IsComparable(DataType left, DataType right) {
     DCHECK(IsValid(left) && IsValid(right)) << left << ", " << right;
 
@@ -1092,4 +1092,11 @@ bool operator !=(const QLValuePB& lhs, const QLValue& rhs) {
   return BothNotNull(lhs, rhs) && Compare(lhs, rhs) != 0;
 }
 
+int CompareForOrderBy(const QLValue& lhs, const QLValue& rhs) {
+  if (lhs.IsNull() || rhs.IsNull()) {
+    return Compare(lhs.IsNull(), rhs.IsNull());
+  }
+  return lhs.CompareTo(rhs);
+}
+
 } // namespace yb
@@ -464,6 +464,9 @@ int Compare(const QLValuePB& lhs, const QLValue& rhs);
 int Compare(const QLSeqValuePB& lhs, const QLSeqValuePB& rhs);
 int Compare(const bool lhs, const bool rhs);
 
+// Compares the values of a column for ORDER BY, where null comes after all the other values.
+int CompareForOrderBy(const QLValue& lhs, const QLValue& rhs);
+
 #define YB_SET_INT_VALUE(ql_valuepb, input, bits) \
   case DataType::BOOST_PP_CAT(INT, bits): { \
     auto value = util::CheckedStoInt<BOOST_PP_CAT(BOOST_PP_CAT(int, bits), _t)>(input); \
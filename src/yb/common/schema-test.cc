@@ -241,6 +241,33 @@ TEST(TestSchema, TestProjectRename) {
   ASSERT_EQ(row_projector.base_cols_mapping()[1].second, 1); // val schema1
 }
 
+// Only widening type changes of non-key columns are allowed, and they keep the column id.
+TEST(TestSchema, TestAlterColumnType) {
+  SchemaBuilder builder;
+  ASSERT_OK(builder.AddKeyColumn("key", INT32));
+  ASSERT_OK(builder.AddColumn("i", INT32));
+  ASSERT_OK(builder.AddColumn("f", FLOAT));
+  ASSERT_OK(builder.AddColumn("s", STRING));
+  Schema schema1 = builder.Build();
+
+  builder.Reset(schema1);
+  ASSERT_OK(builder.AlterColumnType("i", QLType::Create(INT64)));
+  ASSERT_OK(builder.AlterColumnType("f", QLType::Create(DOUBLE)));
+  ASSERT_NOK(builder.AlterColumnType("key", QLType::Create(INT64)));
+  ASSERT_NOK(builder.AlterColumnType("s", QLType::Create(INT64)));
+  ASSERT_TRUE(builder.AlterColumnType("missing", QLType::Create(INT64)).IsNotFound());
+  Schema schema2 = builder.Build();
+
+  ASSERT_EQ(INT64, schema2.column(1).type()->main());
+  ASSERT_EQ(DOUBLE, schema2.column(2).type()->main());
+  ASSERT_EQ(schema1.column_id(1), schema2.column_id(1));
+  ASSERT_EQ(schema1.column_id(2), schema2.column_id(2));
+
+  builder.Reset(schema2);
+  ASSERT_NOK(builder.AlterColumnType("i", QLType::Create(INT32)));
+  ASSERT_NOK(builder.AlterColumnType("f", QLType::Create(FLOAT)));
+}
+
 
 // Test that the schema can be used to compare and stringify rows.
 TEST(TestSchema, TestRowOperations) {
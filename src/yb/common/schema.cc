@@ -83,6 +83,21 @@ void TableProperties::ToTablePropertiesPB(TablePropertiesPB *pb) const {
   if (HasCopartitionTableId()) {
     pb->set_copartition_table_id(copartition_table_id_);
   }
+  if (num_range_components_in_bloom_filter_ != 0) {
+    pb->set_num_range_components_in_bloom_filter(num_range_components_in_bloom_filter_);
+  }
+  if (block_cache_priority_class_ != 0) {
+    pb->set_block_cache_priority_class(block_cache_priority_class_);
+  }
+  if (fast_local_bloom_filter_) {
+    pb->set_fast_local_bloom_filter(fast_local_bloom_filter_);
+  }
+  if (HasHistoryRetentionInterval()) {
+    pb->set_history_retention_interval_sec(history_retention_interval_sec_);
+  }
+  if (hash_prefix_memtable_) {
+    pb->set_hash_prefix_memtable(hash_prefix_memtable_);
+  }
 }
 
 TableProperties TableProperties::FromTablePropertiesPB(const TablePropertiesPB& pb) {
@@ -102,6 +117,22 @@ TableProperties TableProperties::FromTablePropertiesPB(const TablePropertiesPB&
   if (pb.has_copartition_table_id()) {
     table_properties.SetCopartitionTableId(pb.copartition_table_id());
   }
+  if (pb.has_num_range_components_in_bloom_filter()) {
+    table_properties.SetNumRangeComponentsInBloomFilter(
+        pb.num_range_components_in_bloom_filter());
+  }
+  if (pb.has_block_cache_priority_class()) {
+    table_properties.SetBlockCachePriorityClass(pb.block_cache_priority_class());
+  }
+  if (pb.has_fast_local_bloom_filter()) {
+    table_properties.SetFastLocalBloomFilter(pb.fast_local_bloom_filter());
+  }
+  if (pb.has_history_retention_interval_sec()) {
+    table_properties.SetHistoryRetentionInterval(pb.history_retention_interval_sec());
+  }
+  if (pb.has_hash_prefix_memtable()) {
+    table_properties.SetHashPrefixMemTable(pb.hash_prefix_memtable());
+  }
   return table_properties;
 }
 
@@ -118,6 +149,9 @@ void TableProperties::AlterFromTablePropertiesPB(const TablePropertiesPB& pb) {
   if (pb.has_copartition_table_id()) {
     SetCopartitionTableId(pb.copartition_table_id());
   }
+  if (pb.has_history_retention_interval_sec()) {
+    SetHistoryRetentionInterval(pb.history_retention_interval_sec());
+  }
 }
 
 void TableProperties::Reset() {
@@ -126,6 +160,11 @@ void TableProperties::Reset() {
   is_transactional_ = false;
   consistency_level_ = YBConsistencyLevel::STRONG;
   copartition_table_id_ = kNoCopartitionTableId;
+  num_range_components_in_bloom_filter_ = 0;
+  block_cache_priority_class_ = 0;
+  fast_local_bloom_filter_ = false;
+  history_retention_interval_sec_ = kNoHistoryRetentionInterval;
+  hash_prefix_memtable_ = false;
 }
 
 Schema::Schema(const Schema& other)
@@ -579,6 +618,28 @@ Status SchemaBuilder::RenameColumn(const string& old_name, const string& new_nam
   return STATUS(IllegalState, "Unable to rename existing column");
 }
 
+Status SchemaBuilder::AlterColumnType(const string& name, const std::shared_ptr<QLType>& type) {
+  for (int i = 0; i < cols_.size(); ++i) {
+    ColumnSchema& col_schema = cols_[i];
+    if (name != col_schema.name()) {
+      continue;
+    }
+    if (i < num_key_columns_) {
+      return STATUS(InvalidArgument, "Cannot alter the type of a key column", name);
+    }
+    const auto& old_type = col_schema.type();
+    if (old_type->IsElementary() && type->IsElementary() &&
+        QLType::IsStorageWidening(old_type->main(), type->main())) {
+      col_schema.set_type(type);
+      return Status::OK();
+    }
+    return STATUS_FORMAT(InvalidArgument, "Cannot alter type of column $0 from $1 to $2",
+                         name, old_type->ToString(), type->ToString());
+  }
+
+  return STATUS(NotFound, "The specified column does not exist", name);
+}
+
 Status SchemaBuilder::AddColumn(const ColumnSchema& column, bool is_key) {
   if (ContainsKey(col_names_, column.name())) {
     return STATUS(AlreadyPresent, "The column already exists", column.name());
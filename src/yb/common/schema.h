@@ -431,6 +431,50 @@ class TableProperties {
     copartition_table_id_ = copartition_table_id;
   }
 
+  size_t num_range_components_in_bloom_filter() const {
+    return num_range_components_in_bloom_filter_;
+  }
+
+  void SetNumRangeComponentsInBloomFilter(size_t num_range_components_in_bloom_filter) {
+    num_range_components_in_bloom_filter_ = num_range_components_in_bloom_filter;
+  }
+
+  uint32_t block_cache_priority_class() const {
+    return block_cache_priority_class_;
+  }
+
+  void SetBlockCachePriorityClass(uint32_t block_cache_priority_class) {
+    block_cache_priority_class_ = block_cache_priority_class;
+  }
+
+  bool fast_local_bloom_filter() const {
+    return fast_local_bloom_filter_;
+  }
+
+  void SetFastLocalBloomFilter(bool fast_local_bloom_filter) {
+    fast_local_bloom_filter_ = fast_local_bloom_filter;
+  }
+
+  bool HasHistoryRetentionInterval() const {
+    return history_retention_interval_sec_ != kNoHistoryRetentionInterval;
+  }
+
+  int32_t history_retention_interval_sec() const {
+    return history_retention_interval_sec_;
+  }
+
+  void SetHistoryRetentionInterval(int32_t history_retention_interval_sec) {
+    history_retention_interval_sec_ = history_retention_interval_sec;
+  }
+
+  bool hash_prefix_memtable() const {
+    return hash_prefix_memtable_;
+  }
+
+  void SetHashPrefixMemTable(bool hash_prefix_memtable) {
+    hash_prefix_memtable_ = hash_prefix_memtable;
+  }
+
   void ToTablePropertiesPB(TablePropertiesPB *pb) const;
 
   static TableProperties FromTablePropertiesPB(const TablePropertiesPB& pb);
@@ -441,11 +485,17 @@ class TableProperties {
 
  private:
   static const int kNoDefaultTtl = -1;
+  static const int32_t kNoHistoryRetentionInterval = -1;
   int64_t default_time_to_live_ = kNoDefaultTtl;
   bool contain_counters_ = false;
   bool is_transactional_ = false;
   YBConsistencyLevel consistency_level_ = YBConsistencyLevel::STRONG;
   TableId copartition_table_id_ = kNoCopartitionTableId;
+  size_t num_range_components_in_bloom_filter_ = 0;
+  uint32_t block_cache_priority_class_ = 0;
+  bool fast_local_bloom_filter_ = false;
+  int32_t history_retention_interval_sec_ = kNoHistoryRetentionInterval;
+  bool hash_prefix_memtable_ = false;
 };
 
 // The schema for a set of rows.
@@ -1143,6 +1193,11 @@ class SchemaBuilder {
 
   CHECKED_STATUS RemoveColumn(const string& name);
   CHECKED_STATUS RenameColumn(const string& old_name, const string& new_name);
+
+  // Changes the type of a non-key column. Only changes for which the stored values of the old
+  // type can be read as the new type (see QLType::IsStorageWidening) are allowed, so existing data
+  // is never rewritten.
+  CHECKED_STATUS AlterColumnType(const string& name, const std::shared_ptr<QLType>& type);
   CHECKED_STATUS AlterProperties(const TablePropertiesPB& pb);
 
  private:
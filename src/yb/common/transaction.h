@@ -16,6 +16,8 @@
 #ifndef YB_COMMON_TRANSACTION_H
 #define YB_COMMON_TRANSACTION_H
 
+#include <vector>
+
 #include <boost/functional/hash.hpp>
 #include <boost/optional.hpp>
 #include <boost/uuid/uuid.hpp>
@@ -114,12 +116,25 @@ class TransactionStatusManager {
   // 4. Any kind of network/timeout errors would be reflected in error passed to callback.
   virtual void RequestStatusAt(const StatusRequest& request) = 0;
 
+  // Same as RequestStatusAt for each of the requests. Implementations could fetch statuses of
+  // transactions that share a transaction coordinator with a single RPC.
+  virtual void RequestStatusesAt(const std::vector<StatusRequest>& requests) {
+    for (const auto& request : requests) {
+      RequestStatusAt(request);
+    }
+  }
+
   virtual boost::optional<TransactionMetadata> Metadata(const TransactionId& id) = 0;
 
   virtual void Abort(const TransactionId& id, TransactionStatusCallback callback) = 0;
 
   virtual void Cleanup(TransactionIdSet&& set) = 0;
 
+  // Returns false when it is known that the tablet has no intents that could be visible to a
+  // reader, i.e. no transaction has intents that were neither aborted nor applied. Readers use it
+  // to avoid merging the intents DB when it cannot contribute anything.
+  virtual bool MayHaveLiveIntents() { return true; }
+
  private:
   friend class RequestScope;
 
@@ -33,6 +33,7 @@
 #ifndef YB_CONSENSUS_CONSENSUS_TEST_UTIL_H_
 #define YB_CONSENSUS_CONSENSUS_TEST_UTIL_H_
 
+#include <deque>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -149,10 +150,11 @@ class TestPeerProxy : public PeerProxy {
 
  protected:
   // Register the RPC callback in order to call later.
-  // We currently only support one request of each method being in flight at a time.
+  // Requests of the same method that are in flight at the same time are answered in the order
+  // they were registered.
   virtual void RegisterCallback(Method method, const rpc::ResponseCallback& callback) {
     std::lock_guard<simple_spinlock> lock(lock_);
-    InsertOrDie(&callbacks_, method, callback);
+    callbacks_[method].push_back(callback);
   }
 
   // Answer the peer.
@@ -160,8 +162,10 @@ class TestPeerProxy : public PeerProxy {
     rpc::ResponseCallback callback;
     {
       std::lock_guard<simple_spinlock> lock(lock_);
-      callback = FindOrDie(callbacks_, method);
-      CHECK_EQ(1, callbacks_.erase(method));
+      auto& callbacks = FindOrDie(callbacks_, method);
+      CHECK(!callbacks.empty());
+      callback = std::move(callbacks.front());
+      callbacks.pop_front();
       // Drop the lock before submitting to the pool, since the callback itself may
       // destroy this instance.
     }
@@ -175,7 +179,7 @@ class TestPeerProxy : public PeerProxy {
 
   mutable simple_spinlock lock_;
   ThreadPool* pool_;
-  std::map<Method, rpc::ResponseCallback> callbacks_; // Protected by lock_.
+  std::map<Method, std::deque<rpc::ResponseCallback>> callbacks_; // Protected by lock_.
 };
 
 template <typename ProxyType>
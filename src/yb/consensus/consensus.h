@@ -178,6 +178,10 @@ class Consensus {
   // election_lost_by_uuid - uuid of protege that lost election.
   virtual CHECKED_STATUS ElectionLostByProtege(const std::string& election_lost_by_uuid) = 0;
 
+  // The old leader stepped down in favor of this peer and handed its lease over, so this peer
+  // doesn't have to wait out that lease once it wins the election that follows.
+  virtual CHECKED_STATUS AcceptLeaseTransfer(const LeaseTransferPB& lease_transfer) = 0;
+
   // Implement a LeaderStepDown() request.
   virtual CHECKED_STATUS StepDown(const LeaderStepDownRequestPB* req,
                                   LeaderStepDownResponsePB* resp) {
@@ -57,6 +57,9 @@ using namespace std::chrono_literals;
 
 METRIC_DECLARE_entity(tablet);
 
+DECLARE_int32(consensus_max_batch_size_bytes);
+DECLARE_int32(consensus_max_inflight_requests_per_peer);
+
 namespace yb {
 namespace consensus {
 
@@ -98,6 +101,7 @@ class ConsensusPeersTest : public YBTest {
                        0, // schema_version
                        NULL,
                        append_pool_.get(),
+                       nullptr /* allocation_thread_pool */,
                        &log_));
     clock_.reset(new server::HybridClock());
     ASSERT_OK(clock_->Init());
@@ -208,6 +212,31 @@ TEST_F(ConsensusPeersTest, TestRemotePeer) {
   CheckLastRemoteEntry(proxy, 2, 20);
 }
 
+// Same as above, but with small batches and several requests in flight to the remote peer.
+TEST_F(ConsensusPeersTest, TestPipelinedRemotePeer) {
+  google::FlagSaver flag_saver;
+  FLAGS_consensus_max_inflight_requests_per_peer = 4;
+  FLAGS_consensus_max_batch_size_bytes = 1024;
+
+  std::shared_ptr<Peer> remote_peer;
+  BOOST_SCOPE_EXIT(&remote_peer) {
+    // This guarantees that the Peer object doesn't get destroyed if there is a pending request.
+    remote_peer->Close();
+  } BOOST_SCOPE_EXIT_END
+
+  DelayablePeerProxy<NoOpTestPeerProxy>* proxy = NewRemotePeer(kFollowerUuid, &remote_peer);
+
+  // Each operation is big enough for a batch to carry only a few of them.
+  AppendReplicateMessagesToQueue(message_queue_.get(), clock_, 1, 100, 100 /* payload_size */);
+  remote_peer->SetTermForTest(14);
+
+  ASSERT_OK(remote_peer->SignalRequest(RequestTriggerMode::kNonEmptyOnly));
+
+  WaitForMajorityReplicatedIndex(100);
+  CheckLastRemoteEntry(proxy, 14, 100);
+  ASSERT_EQ(0U, remote_peer->failed_attempts());
+}
+
 TEST_F(ConsensusPeersTest, TestLocalAppendAndRemotePeerDelay) {
   // Create a set of remote peers.
   std::shared_ptr<Peer> remote_peer1;
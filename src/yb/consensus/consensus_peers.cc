@@ -49,6 +49,7 @@
 #include "yb/consensus/consensus_meta.h"
 #include "yb/consensus/consensus_queue.h"
 #include "yb/consensus/log.h"
+#include "yb/consensus/multi_raft_batcher.h"
 #include "yb/gutil/map-util.h"
 #include "yb/gutil/stl_util.h"
 #include "yb/gutil/strings/substitute.h"
@@ -57,6 +58,7 @@
 #include "yb/tserver/tserver.pb.h"
 
 #include "yb/util/backoff_waiter.h"
+#include "yb/util/distributed_trace.h"
 #include "yb/util/fault_injection.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
@@ -72,6 +74,12 @@ DEFINE_int32(consensus_rpc_timeout_ms, 3000,
              "Timeout used for all consensus internal RPC communications.");
 TAG_FLAG(consensus_rpc_timeout_ms, advanced);
 
+DEFINE_int32(consensus_max_inflight_requests_per_peer, 1,
+             "Maximum number of UpdateConsensus requests in flight to a single follower. More than "
+             "one request is only sent to a follower that is in sync with the leader, which helps "
+             "replication throughput over links with high round trip time.");
+TAG_FLAG(consensus_max_inflight_requests_per_peer, advanced);
+
 DECLARE_int32(raft_heartbeat_interval_ms);
 
 DEFINE_test_flag(double, fault_crash_on_leader_request_fraction, 0.0,
@@ -127,7 +135,8 @@ Peer::Peer(
       messenger_(std::move(messenger)) {}
 
 void Peer::SetTermForTest(int term) {
-  response_.set_responder_term(term);
+  std::lock_guard<simple_spinlock> lock(peer_lock_);
+  term_for_tests_ = term;
 }
 
 Status Peer::Init() {
@@ -150,8 +159,8 @@ Status Peer::Init() {
 }
 
 Status Peer::SignalRequest(RequestTriggerMode trigger_mode) {
-  // If the peer is currently sending, return Status::OK().
-  // If there are new requests in the queue we'll get them on ProcessResponse().
+  // If the peer is currently sending or handling responses, return Status::OK().
+  // If there are new requests in the queue we'll get them on DoProcessResponses().
   auto performing_lock = LockPerforming(std::try_to_lock);
   if (!performing_lock.owns_lock()) {
     return Status::OK();
@@ -171,6 +180,14 @@ Status Peer::SignalRequest(RequestTriggerMode trigger_mode) {
     }
     DCHECK_EQ(state_, kPeerRunning);
 
+    // Responses that arrived while the lock was held are handled first, the next request is sent
+    // after them.
+    if (HasCompletedResponseUnlocked()) {
+      processing_lock.unlock();
+      SubmitProcessResponses(&performing_lock);
+      return Status::OK();
+    }
+
     // If our last request generated an error, and this is not a normal heartbeat request (i.e.
     // we're not forcing a request even if the queue is empty, unlike we do during heartbeats),
     // then don't send the "per-RPC" request. Instead, we'll wait for the heartbeat.
@@ -179,7 +196,10 @@ Status Peer::SignalRequest(RequestTriggerMode trigger_mode) {
     // ignoring the signal, ask the heartbeater to "expedite" the next heartbeat in order to achieve
     // something like exponential backoff after an error. As it is implemented today, any transient
     // error will result in a latency blip as long as the heartbeat period.
-    if (failed_attempts_ > 0 && trigger_mode == RequestTriggerMode::kNonEmptyOnly) {
+    if ((failed_attempts_ > 0 && trigger_mode == RequestTriggerMode::kNonEmptyOnly) ||
+        !CanSendRequestUnlocked()) {
+      processing_lock.unlock();
+      ReleasePerforming(&performing_lock);
       return Status::OK();
     }
   }
@@ -192,32 +212,66 @@ Status Peer::SignalRequest(RequestTriggerMode trigger_mode) {
   return status;
 }
 
+bool Peer::CanSendRequestUnlocked() const {
+  if (in_flight_.empty()) {
+    return true;
+  }
+  const size_t max_in_flight = std::max(FLAGS_consensus_max_inflight_requests_per_peer, 1);
+  return last_response_in_sync_ && failed_attempts_ == 0 && in_flight_.size() < max_in_flight;
+}
+
+bool Peer::HasCompletedResponseUnlocked() const {
+  return !in_flight_.empty() && in_flight_.front()->completed;
+}
+
 void Peer::SendNextRequest(RequestTriggerMode trigger_mode) {
-  auto retain_self = shared_from_this();
   DCHECK(performing_mutex_.is_locked()) << "Cannot send request";
-
   auto performing_lock = LockPerforming(std::adopt_lock);
+
+  while (DoSendNextRequest(trigger_mode, &performing_lock)) {
+    // Send the rest of the pending operations without waiting for the responses.
+    trigger_mode = RequestTriggerMode::kNonEmptyOnly;
+  }
+
+  ReleasePerforming(&performing_lock);
+}
+
+bool Peer::DoSendNextRequest(RequestTriggerMode trigger_mode,
+                             std::unique_lock<AtomicTryMutex>* performing_lock) {
+  auto retain_self = shared_from_this();
   auto processing_lock = StartProcessingUnlocked();
   if (!processing_lock.owns_lock()) {
-    return;
+    return false;
+  }
+
+  if (!CanSendRequestUnlocked()) {
+    return false;
   }
 
+  auto in_flight = std::make_shared<InFlightRequest>();
+  if (term_for_tests_ != 0) {
+    in_flight->response.set_responder_term(term_for_tests_);
+  }
+  ConsensusRequestPB& request = in_flight->request;
+
   // The peer has no pending request nor is sending: send the request.
   bool needs_remote_bootstrap = false;
   bool last_exchange_successful = false;
   RaftPeerPB::MemberType member_type = RaftPeerPB::UNKNOWN_MEMBER_TYPE;
-  int64_t commit_index_before = request_.has_committed_index() ?
-      request_.committed_index().index() : kMinimumOpIdIndex;
-  Status s = queue_->RequestForPeer(peer_pb_.permanent_uuid(), &request_,
-      &replicate_msg_refs_, &needs_remote_bootstrap, &member_type, &last_exchange_successful);
-  int64_t commit_index_after = request_.has_committed_index() ?
-      request_.committed_index().index() : kMinimumOpIdIndex;
+  int64_t commit_index_before = last_committed_index_;
+  Status s = queue_->RequestForPeer(peer_pb_.permanent_uuid(), &request,
+      &in_flight->msg_refs, &needs_remote_bootstrap, &member_type, &last_exchange_successful,
+      &in_flight->info);
 
   if (PREDICT_FALSE(!s.ok())) {
     LOG_WITH_PREFIX(INFO) << "Could not obtain request from queue for peer: " << s;
-    return;
+    return false;
   }
 
+  int64_t commit_index_after = request.has_committed_index() ?
+      request.committed_index().index() : kMinimumOpIdIndex;
+  last_committed_index_ = commit_index_after;
+
   if (PREDICT_FALSE(needs_remote_bootstrap)) {
     Status status;
     if (!FLAGS_enable_remote_bootstrap) {
@@ -228,16 +282,16 @@ void Peer::SendNextRequest(RequestTriggerMode trigger_mode) {
     }
     if (!status.ok()) {
       LOG_WITH_PREFIX(WARNING) << "Unable to generate remote bootstrap request for peer: " << s;
-      return;
+      return false;
     }
 
     s = SendRemoteBootstrapRequest();
     if (s.ok()) {
       // If we successfully sent the request, release ownership of performing_lock so the semaphore
       // won't be unlocked when we exits this method.
-      performing_lock.release();
+      performing_lock->release();
     }
-    return;
+    return false;
   }
 
   // If the peer doesn't need remote bootstrap, but it is a PRE_VOTER or PRE_OBSERVER in the config,
@@ -246,8 +300,10 @@ void Peer::SendNextRequest(RequestTriggerMode trigger_mode) {
       (member_type == RaftPeerPB::PRE_VOTER || member_type == RaftPeerPB::PRE_OBSERVER)) {
     if (PREDICT_TRUE(consensus_)) {
       auto uuid = peer_pb_.permanent_uuid();
+      // The request is dropped, so its operations have to be sent again.
+      queue_->RequestToPeerFailed(uuid);
       processing_lock.unlock();
-      performing_lock.unlock();
+      performing_lock->unlock();
       consensus::ChangeConfigRequestPB req;
       consensus::ChangeConfigResponsePB resp;
 
@@ -272,20 +328,20 @@ void Peer::SendNextRequest(RequestTriggerMode trigger_mode) {
                        << status;
         }
       }
-      return;
+      return false;
     }
   }
 
-  request_.set_tablet_id(tablet_id_);
-  request_.set_caller_uuid(leader_uuid_);
-  request_.set_dest_uuid(peer_pb_.permanent_uuid());
+  request.set_tablet_id(tablet_id_);
+  request.set_caller_uuid(leader_uuid_);
+  request.set_dest_uuid(peer_pb_.permanent_uuid());
 
-  const bool req_has_ops = (request_.ops_size() > 0) || (commit_index_after > commit_index_before);
+  const bool req_has_ops = (request.ops_size() > 0) || (commit_index_after > commit_index_before);
 
   // If the queue is empty, check if we were told to send a status-only message (which is what
   // happens during heartbeats). If not, just return.
   if (PREDICT_FALSE(!req_has_ops && trigger_mode == RequestTriggerMode::kNonEmptyOnly)) {
-    return;
+    return false;
   }
 
   // If we're actually sending ops there's no need to heartbeat for a while, reset the heartbeater.
@@ -294,12 +350,25 @@ void Peer::SendNextRequest(RequestTriggerMode trigger_mode) {
   }
 
   MAYBE_FAULT(FLAGS_fault_crash_on_leader_request_fraction);
-  controller_.Reset();
+
+  in_flight_.push_back(in_flight);
+  const bool send_more =
+      request.ops_size() > 0 && in_flight->info.has_more && CanSendRequestUnlocked();
 
   processing_lock.unlock();
-  performing_lock.release();
-  proxy_->UpdateAsync(&request_, trigger_mode, &response_, &controller_,
-                      std::bind(&Peer::ProcessResponse, retain_self));
+  // A request with the operation of a traced request continues its trace on the follower.
+  TraceContext trace_context;
+  for (const auto& op : request.ops()) {
+    if (PREDICT_FALSE(op.has_trace_context())) {
+      trace_context.trace_id = op.trace_context().trace_id();
+      trace_context.span_id = op.trace_context().parent_span_id();
+      break;
+    }
+  }
+  ScopedTraceContext scoped_trace_context(trace_context);
+  proxy_->UpdateAsync(&request, trigger_mode, &in_flight->response, &in_flight->controller,
+                      std::bind(&Peer::ProcessResponse, retain_self, in_flight));
+  return send_more;
 }
 
 std::unique_lock<simple_spinlock> Peer::StartProcessingUnlocked() {
@@ -313,19 +382,76 @@ std::unique_lock<simple_spinlock> Peer::StartProcessingUnlocked() {
   return lock;
 }
 
-void Peer::ProcessResponse() {
+void Peer::ProcessResponse(const InFlightRequestPtr& in_flight) {
   // Note: This method runs on the reactor thread.
+  {
+    std::lock_guard<simple_spinlock> lock(peer_lock_);
+    if (state_ == kPeerClosed) {
+      return;
+    }
+    in_flight->completed = true;
+    if (in_flight_.empty() || in_flight_.front() != in_flight) {
+      // The response to an earlier request did not arrive yet, this one is handled after it.
+      return;
+    }
+  }
 
-  DCHECK(performing_mutex_.is_locked()) << "Got a response when nothing was pending";
+  auto performing_lock = LockPerforming(std::try_to_lock);
+  if (!performing_lock.owns_lock()) {
+    // The current owner of the lock handles the response in ReleasePerforming().
+    return;
+  }
+
+  // The queue's handling of the peer response may generate IO (reads against the WAL) and
+  // SendNextRequest() may do the same thing. So we run the rest of the response handling logic on
+  // our thread pool and not on the reactor thread.
+  SubmitProcessResponses(&performing_lock);
+}
+
+void Peer::SubmitProcessResponses(std::unique_lock<AtomicTryMutex>* performing_lock) {
+  Status s = raft_pool_token_->SubmitFunc(
+      std::bind(&Peer::DoProcessResponses, shared_from_this()));
+  if (PREDICT_FALSE(!s.ok())) {
+    LOG_WITH_PREFIX(WARNING) << "Unable to process peer response: " << s;
+  } else {
+    performing_lock->release();
+  }
+}
 
+void Peer::DoProcessResponses() {
+  auto retain_self = shared_from_this();
+  DCHECK(performing_mutex_.is_locked());
   auto performing_lock = LockPerforming(std::adopt_lock);
-  auto processing_lock = StartProcessingUnlocked();
-  if (!processing_lock.owns_lock()) {
+
+  bool more_pending = false;
+  {
+    auto processing_lock = StartProcessingUnlocked();
+    if (!processing_lock.owns_lock()) {
+      return;
+    }
+
+    while (HasCompletedResponseUnlocked()) {
+      auto in_flight = std::move(in_flight_.front());
+      in_flight_.pop_front();
+      HandleResponseUnlocked(*in_flight, &more_pending);
+    }
+  }
+
+  if (more_pending) {
+    performing_lock.release();
+    SendNextRequest(RequestTriggerMode::kAlwaysSend);
     return;
   }
+  ReleasePerforming(&performing_lock);
+}
+
+void Peer::HandleResponseUnlocked(const InFlightRequest& in_flight, bool* more_pending) {
+  const auto& controller = in_flight.controller;
+  const auto& response = in_flight.response;
+  *more_pending = false;
 
-  if (!controller_.status().ok()) {
-    if (controller_.status().IsRemoteError()) {
+  if (!controller.status().ok()) {
+    if (controller.status().IsRemoteError()) {
       // Most controller errors are caused by network issues or corner cases like shutdown and
       // failure to serialize a protobuf. Therefore, we generally consider these errors to indicate
       // an unreachable peer.  However, a RemoteError wraps some other error propagated from the
@@ -333,65 +459,56 @@ void Peer::ProcessResponse() {
       // remote is responsive.
       queue_->NotifyPeerIsResponsiveDespiteError(peer_pb_.permanent_uuid());
     }
-    ProcessResponseError(controller_.status());
+    ProcessResponseError(controller.status());
     return;
   }
 
   // We should try to evict a follower which returns a WRONG UUID error.
-  if (response_.has_error() &&
-      response_.error().code() == tserver::TabletServerErrorPB::WRONG_SERVER_UUID) {
+  if (response.has_error() &&
+      response.error().code() == tserver::TabletServerErrorPB::WRONG_SERVER_UUID) {
     queue_->NotifyObserversOfFailedFollower(
         peer_pb_.permanent_uuid(),
         Substitute("Leader communication with peer $0 received error $1, will try to "
                    "evict peer", peer_pb_.permanent_uuid(),
-                   response_.error().ShortDebugString()));
-    ProcessResponseError(StatusFromPB(response_.error().status()));
+                   response.error().ShortDebugString()));
+    ProcessResponseError(StatusFromPB(response.error().status()));
     return;
   }
 
   // Pass through errors we can respond to, like not found, since in that case
   // we will need to remotely bootstrap. TODO: Handle DELETED response once implemented.
-  if ((response_.has_error() &&
-      response_.error().code() != tserver::TabletServerErrorPB::TABLET_NOT_FOUND) ||
-      (response_.status().has_error() &&
-          response_.status().error().code() == consensus::ConsensusErrorPB::CANNOT_PREPARE)) {
+  if ((response.has_error() &&
+      response.error().code() != tserver::TabletServerErrorPB::TABLET_NOT_FOUND) ||
+      (response.status().has_error() &&
+          response.status().error().code() == consensus::ConsensusErrorPB::CANNOT_PREPARE)) {
     // Again, let the queue know that the remote is still responsive, since we will not be sending
     // this error response through to the queue.
     queue_->NotifyPeerIsResponsiveDespiteError(peer_pb_.permanent_uuid());
-    ProcessResponseError(StatusFromPB(response_.error().status()));
+    ProcessResponseError(StatusFromPB(response.error().status()));
     return;
   }
 
-  processing_lock.unlock();
-  // The queue's handling of the peer response may generate IO (reads against the WAL) and
-  // SendNextRequest() may do the same thing. So we run the rest of the response handling logic on
-  // our thread pool and not on the reactor thread.
-  Status s = raft_pool_token_->SubmitFunc(std::bind(&Peer::DoProcessResponse, shared_from_this()));
-  if (PREDICT_FALSE(!s.ok())) {
-    LOG_WITH_PREFIX(WARNING) << "Unable to process peer response: " << s
-                             << ": " << response_.ShortDebugString();
-  } else {
-    performing_lock.release();
-  }
+  failed_attempts_ = 0;
+  last_response_in_sync_ =
+      !response.has_error() && response.has_status() && !response.status().has_error();
+  queue_->ResponseFromPeer(peer_pb_.permanent_uuid(), response, more_pending, &in_flight.info);
 }
 
-void Peer::DoProcessResponse() {
-  auto retain_self = shared_from_this();
-  DCHECK(performing_mutex_.is_locked());
-  auto performing_lock = LockPerforming(std::adopt_lock);
-  auto processing_lock = StartProcessingUnlocked();
-  if (!processing_lock.owns_lock()) {
-    return;
+void Peer::ReleasePerforming(std::unique_lock<AtomicTryMutex>* performing_lock) {
+  if (performing_lock->owns_lock()) {
+    performing_lock->unlock();
   }
 
-  failed_attempts_ = 0;
-  bool more_pending = false;
-  queue_->ResponseFromPeer(peer_pb_.permanent_uuid(), response_, &more_pending);
-
-  if (more_pending) {
-    processing_lock.unlock();
-    performing_lock.release();
-    SendNextRequest(RequestTriggerMode::kAlwaysSend);
+  // A response that arrived while the lock was held could not be handled by ProcessResponse().
+  {
+    std::lock_guard<simple_spinlock> lock(peer_lock_);
+    if (state_ == kPeerClosed || !HasCompletedResponseUnlocked()) {
+      return;
+    }
+  }
+  auto new_performing_lock = LockPerforming(std::try_to_lock);
+  if (new_performing_lock.owns_lock()) {
+    SubmitProcessResponses(&new_performing_lock);
   }
 }
 
@@ -407,26 +524,32 @@ Status Peer::SendRemoteBootstrapRequest() {
 
 void Peer::ProcessRemoteBootstrapResponse() {
   auto performing_lock = LockPerforming(std::adopt_lock);
-  auto processing_lock = StartProcessingUnlocked();
-  if (!processing_lock.owns_lock()) {
-    return;
-  }
+  {
+    auto processing_lock = StartProcessingUnlocked();
+    if (!processing_lock.owns_lock()) {
+      return;
+    }
 
-  if (rb_response_.has_error()) {
-    if (rb_response_.error().code() == tserver::TabletServerErrorPB::ALREADY_IN_PROGRESS) {
-      queue_->NotifyPeerIsResponsiveDespiteError(peer_pb_.permanent_uuid());
-      YB_LOG_WITH_PREFIX_EVERY_N_SECS(WARNING, 30)
-        << ":::Unable to begin remote bootstrap on peer: " << rb_response_.ShortDebugString();
-    } else {
-      LOG_WITH_PREFIX(WARNING) << "Unable to begin remote bootstrap on peer: "
-                               << rb_response_.ShortDebugString();
+    if (rb_response_.has_error()) {
+      if (rb_response_.error().code() == tserver::TabletServerErrorPB::ALREADY_IN_PROGRESS) {
+        queue_->NotifyPeerIsResponsiveDespiteError(peer_pb_.permanent_uuid());
+        YB_LOG_WITH_PREFIX_EVERY_N_SECS(WARNING, 30)
+          << ":::Unable to begin remote bootstrap on peer: " << rb_response_.ShortDebugString();
+      } else {
+        LOG_WITH_PREFIX(WARNING) << "Unable to begin remote bootstrap on peer: "
+                                 << rb_response_.ShortDebugString();
+      }
     }
   }
+  ReleasePerforming(&performing_lock);
 }
 
 void Peer::ProcessResponseError(const Status& status) {
   DCHECK(performing_mutex_.is_locked());
   failed_attempts_++;
+  last_response_in_sync_ = false;
+  // Requests sent after the failed one have to be sent again.
+  queue_->RequestToPeerFailed(peer_pb_.permanent_uuid());
   YB_LOG_WITH_PREFIX_EVERY_N_SECS(WARNING, 5) << "Couldn't send request. "
       << " Status: " << status.ToString() << ". Retrying in the next heartbeat period."
       << " Already tried " << failed_attempts_ << " times. State: " << state_;
@@ -470,18 +593,26 @@ Peer::~Peer() {
     std::lock_guard<simple_spinlock> processing_lock(peer_lock_);
     CHECK_EQ(state_, kPeerClosed) << "Peer cannot be implicitly closed";
   }
+}
 
-  // We don't own the ops (the queue does).
-  request_.mutable_ops()->ExtractSubrange(0, request_.ops_size(), /* elements */ nullptr);
+Peer::InFlightRequest::~InFlightRequest() {
+  // We don't own the ops (msg_refs does).
+  request.mutable_ops()->ExtractSubrange(0, request.ops_size(), /* elements */ nullptr);
 }
 
 void Peer::ReleaseResourcesUnlocked() {
-  replicate_msg_refs_.clear();
+  {
+    // Requests still in flight are kept alive by their RPC callbacks.
+    std::lock_guard<simple_spinlock> lock(peer_lock_);
+    in_flight_.clear();
+  }
   LOG_WITH_PREFIX(INFO) << "Closed peer";
 }
 
-RpcPeerProxy::RpcPeerProxy(HostPort hostport, ConsensusServiceProxyPtr consensus_proxy)
-    : hostport_(std::move(hostport)), consensus_proxy_(std::move(consensus_proxy)) {
+RpcPeerProxy::RpcPeerProxy(HostPort hostport, ConsensusServiceProxyPtr consensus_proxy,
+                           MultiRaftHeartbeatBatcherPtr batcher)
+    : hostport_(std::move(hostport)), consensus_proxy_(std::move(consensus_proxy)),
+      batcher_(std::move(batcher)) {
 }
 
 void RpcPeerProxy::UpdateAsync(const ConsensusRequestPB* request,
@@ -490,6 +621,12 @@ void RpcPeerProxy::UpdateAsync(const ConsensusRequestPB* request,
                                rpc::RpcController* controller,
                                const rpc::ResponseCallback& callback) {
   controller->set_timeout(MonoDelta::FromMilliseconds(FLAGS_consensus_rpc_timeout_ms));
+  // Raft traffic should not wait behind client requests in the queue of the follower.
+  controller->set_priority(rpc::RPC_PRIORITY_HIGH);
+  if (batcher_ && request->ops_size() == 0 &&
+      batcher_->Add(request, response, controller, callback)) {
+    return;
+  }
   consensus_proxy_->UpdateConsensusAsync(*request, response, controller, callback);
 }
 
@@ -497,6 +634,7 @@ void RpcPeerProxy::RequestConsensusVoteAsync(const VoteRequestPB* request,
                                              VoteResponsePB* response,
                                              rpc::RpcController* controller,
                                              const rpc::ResponseCallback& callback) {
+  controller->set_priority(rpc::RPC_PRIORITY_HIGH);
   consensus_proxy_->RequestConsensusVoteAsync(*request, response, controller, callback);
 }
 
@@ -525,13 +663,17 @@ void RpcPeerProxy::StartRemoteBootstrap(const StartRemoteBootstrapRequestPB* req
 RpcPeerProxy::~RpcPeerProxy() {}
 
 RpcPeerProxyFactory::RpcPeerProxyFactory(
-    shared_ptr<Messenger> messenger, rpc::ProxyCache* proxy_cache, CloudInfoPB from)
-    : messenger_(std::move(messenger)), proxy_cache_(proxy_cache), from_(std::move(from)) {}
+    shared_ptr<Messenger> messenger, rpc::ProxyCache* proxy_cache, CloudInfoPB from,
+    MultiRaftManager* multi_raft_manager)
+    : messenger_(std::move(messenger)), proxy_cache_(proxy_cache), from_(std::move(from)),
+      multi_raft_manager_(multi_raft_manager) {}
 
 PeerProxyPtr RpcPeerProxyFactory::NewProxy(const RaftPeerPB& peer_pb) {
   auto hostport = HostPortFromPB(DesiredHostPort(peer_pb, from_));
   auto proxy = std::make_unique<ConsensusServiceProxy>(proxy_cache_, hostport);
-  return std::make_unique<RpcPeerProxy>(std::move(hostport), std::move(proxy));
+  auto batcher = multi_raft_manager_ ? multi_raft_manager_->GetBatcher(hostport) : nullptr;
+  return std::make_unique<RpcPeerProxy>(
+      std::move(hostport), std::move(proxy), std::move(batcher));
 }
 
 RpcPeerProxyFactory::~RpcPeerProxyFactory() {}
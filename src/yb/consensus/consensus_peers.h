@@ -33,6 +33,7 @@
 #ifndef YB_CONSENSUS_CONSENSUS_PEERS_H_
 #define YB_CONSENSUS_CONSENSUS_PEERS_H_
 
+#include <deque>
 #include <memory>
 #include <string>
 #include <vector>
@@ -40,6 +41,7 @@
 
 #include "yb/consensus/consensus_fwd.h"
 #include "yb/consensus/consensus.pb.h"
+#include "yb/consensus/consensus_queue.h"
 #include "yb/consensus/metadata.pb.h"
 #include "yb/consensus/consensus_util.h"
 
@@ -177,15 +179,62 @@ class Peer : public std::enable_shared_from_this<Peer> {
   }
 
  private:
+  // An UpdateConsensus request sent to the peer and its response. The RPC callback holds a
+  // reference to it, so it is safe to close the peer while the request is in flight.
+  struct InFlightRequest {
+    ~InFlightRequest();
+
+    ConsensusRequestPB request;
+    ConsensusResponsePB response;
+    rpc::RpcController controller;
+
+    // Reference-counted pointers to the ReplicateMsgs in the request. We may have loaded these
+    // messages from the LogCache, in which case we are potentially sharing the same object as
+    // other peers. Since the PB request itself can't hold reference counts, this holds them.
+    ReplicateMsgs msg_refs;
+
+    // What the queue put into the request, to match the response with.
+    PeerRequestInfo info;
+
+    // Set on the reactor thread once the response arrived. Protected by peer_lock_.
+    bool completed = false;
+  };
+
+  typedef std::shared_ptr<InFlightRequest> InFlightRequestPtr;
+
+  // Sends requests to the peer, as long as the window of in-flight requests allows it and there
+  // are operations to send. Runs on raft_pool_token_ with performing_mutex_ held.
   void SendNextRequest(RequestTriggerMode trigger_mode);
 
+  // Sends a single request. Returns true if another request could be sent right after it.
+  bool DoSendNextRequest(RequestTriggerMode trigger_mode,
+                         std::unique_lock<AtomicTryMutex>* performing_lock);
+
+  // Whether another request could be sent now. Only a single request is sent to a peer that is
+  // not known to be in sync, since requests after it would most likely be rejected.
+  bool CanSendRequestUnlocked() const;
+
+  // Whether the oldest in-flight request got its response, which has not been handled yet.
+  bool HasCompletedResponseUnlocked() const;
+
   // Signals that a response was received from the peer.  This method is called from the reactor
-  // thread and calls DoProcessResponse() on raft_pool_token_ to do any work that requires IO or
+  // thread and calls DoProcessResponses() on raft_pool_token_ to do any work that requires IO or
   // lock-taking.
-  void ProcessResponse();
+  void ProcessResponse(const InFlightRequestPtr& in_flight);
+
+  // Run on 'raft_pool_token'. Handles, in the order the requests were sent, the responses that
+  // arrived so far. Does response handling that requires IO or may block.
+  void DoProcessResponses();
+
+  // Handles the response to a single request. Sets 'more_pending' if there is more to send.
+  void HandleResponseUnlocked(const InFlightRequest& in_flight, bool* more_pending);
+
+  // Submits DoProcessResponses(), handing it the ownership of performing_lock on success.
+  void SubmitProcessResponses(std::unique_lock<AtomicTryMutex>* performing_lock);
 
-  // Run on 'raft_pool_token'. Does response handling that requires IO or may block.
-  void DoProcessResponse();
+  // Unlocks performing_mutex_, if still owned by performing_lock. Then, because the responses
+  // that arrived in the meantime could not be handled, these are handled by taking the lock again.
+  void ReleasePerforming(std::unique_lock<AtomicTryMutex>* performing_lock);
 
   // Fetch the desired remote bootstrap request from the queue and send it to the peer. The callback
   // goes to ProcessRemoteBootstrapResponse().
@@ -224,24 +273,31 @@ class Peer : public std::enable_shared_from_this<Peer> {
   PeerMessageQueue* queue_;
   uint64_t failed_attempts_ = 0;
 
-  // The latest consensus update request and response.
-  ConsensusRequestPB request_;
-  ConsensusResponsePB response_;
+  // UpdateConsensus requests sent to the peer, in the order they were sent, that were not handled
+  // yet. Protected by peer_lock_.
+  std::deque<InFlightRequestPtr> in_flight_;
+
+  // Whether the last handled response showed that the peer is in sync with the leader's log, so
+  // more than one request may be in flight. Protected by peer_lock_.
+  bool last_response_in_sync_ = false;
+
+  // Committed index in the latest request built for the peer.
+  int64_t last_committed_index_ = kMinimumOpIdIndex;
+
+  // Responder term preset in responses, for tests.
+  int64_t term_for_tests_ = 0;
 
   // The latest remote bootstrap request and response.
   StartRemoteBootstrapRequestPB rb_request_;
   StartRemoteBootstrapResponsePB rb_response_;
 
-  // Reference-counted pointers to any ReplicateMsgs which are in-flight to the peer. We may have
-  // loaded these messages from the LogCache, in which case we are potentially sharing the same
-  // object as other peers. Since the PB request_ itself can't hold reference counts, this holds
-  // them.
-  ReplicateMsgs replicate_msg_refs_;
-
+  // Controller of the remote bootstrap request.
   rpc::RpcController controller_;
 
-  // Held if there is an outstanding request.  This is used in order to ensure that we only have a
-  // single request outstanding at a time, and to wait for the outstanding requests at Close().
+  // Held while a request is being built, responses are being handled, or a remote bootstrap request
+  // is outstanding. This is used in order to ensure that the queue is accessed for this peer by one
+  // thread at a time, and to wait for the outstanding work at Close(). UpdateConsensus requests in
+  // flight don't hold it.
   AtomicTryMutex performing_mutex_;
 
   // Heartbeater for remote peer implementations.  This will send status only requests to the remote
@@ -328,7 +384,9 @@ class PeerProxyFactory {
 // PeerProxy implementation that does RPC calls
 class RpcPeerProxy : public PeerProxy {
  public:
-  RpcPeerProxy(HostPort hostport, ConsensusServiceProxyPtr consensus_proxy);
+  // Heartbeats are sent through 'batcher' when it is set.
+  RpcPeerProxy(HostPort hostport, ConsensusServiceProxyPtr consensus_proxy,
+               MultiRaftHeartbeatBatcherPtr batcher = nullptr);
 
   virtual void UpdateAsync(const ConsensusRequestPB* request,
                            RequestTriggerMode trigger_mode,
@@ -361,13 +419,15 @@ class RpcPeerProxy : public PeerProxy {
  private:
   HostPort hostport_;
   ConsensusServiceProxyPtr consensus_proxy_;
+  MultiRaftHeartbeatBatcherPtr batcher_;
 };
 
 // PeerProxyFactory implementation that generates RPCPeerProxies
 class RpcPeerProxyFactory : public PeerProxyFactory {
  public:
+  // 'multi_raft_manager' is optional, heartbeats are not batched without it.
   RpcPeerProxyFactory(std::shared_ptr<rpc::Messenger> messenger, rpc::ProxyCache* proxy_cache,
-                      CloudInfoPB from);
+                      CloudInfoPB from, MultiRaftManager* multi_raft_manager = nullptr);
 
   PeerProxyPtr NewProxy(const RaftPeerPB& peer_pb) override;
 
@@ -379,6 +439,7 @@ class RpcPeerProxyFactory : public PeerProxyFactory {
   std::shared_ptr<rpc::Messenger> messenger_;
   rpc::ProxyCache* const proxy_cache_;
   const CloudInfoPB from_;
+  MultiRaftManager* const multi_raft_manager_;
 };
 
 // Query the consensus service at last known host/port that is specified in 'remote_peer' and set
@@ -88,6 +88,7 @@ class ConsensusQueueTest : public YBTest {
                             0, // schema_version
                             NULL,
                             append_pool_.get(),
+                            nullptr /* allocation_thread_pool */,
                             &log_));
     clock_.reset(new server::HybridClock());
     ASSERT_OK(clock_->Init());
@@ -355,6 +356,72 @@ TEST_F(ConsensusQueueTest, TestGetPagedMessages) {
   ASSERT_FALSE(more_pending);
 }
 
+// Tests that pipelined requests continue after the last operation sent, and that the queue goes
+// back to the last acknowledged operation when one of them is refused.
+TEST_F(ConsensusQueueTest, TestPipelinedRequests) {
+  queue_->Init(MinimumOpId());
+  queue_->SetLeaderMode(MinimumOpId(), MinimumOpId().term(), BuildRaftConfigPBForTests(2));
+  AppendReplicateMessagesToQueue(queue_.get(), clock_, 1, 100, 100 /* payload_size */);
+
+  // Limit each request to a few operations.
+  google::FlagSaver saver;
+  FLAGS_consensus_max_batch_size_bytes = 1024;
+
+  ConsensusRequestPB request;
+  ConsensusResponsePB response;
+  response.set_responder_uuid(kPeerUuid);
+  bool more_pending = false;
+
+  UpdatePeerWatermarkToOp(&request, &response, MakeOpId(7, 50), MinimumOpId(), &more_pending);
+  ASSERT_TRUE(more_pending);
+
+  ConsensusRequestPB first, second, third;
+  BOOST_SCOPE_EXIT(&first, &second, &third) {
+    // Extract the ops from the requests to avoid double free.
+    for (auto* req : {&first, &second, &third}) {
+      req->mutable_ops()->ExtractSubrange(0, req->ops_size(), /* elements */ nullptr);
+    }
+  } BOOST_SCOPE_EXIT_END;
+  ReplicateMsgs first_refs, second_refs, third_refs;
+  PeerRequestInfo first_info, second_info, third_info;
+  bool needs_remote_bootstrap;
+
+  ASSERT_OK(queue_->RequestForPeer(kPeerUuid, &first, &first_refs, &needs_remote_bootstrap,
+                                   nullptr, nullptr,
+                                   &first_info));
+  ASSERT_FALSE(needs_remote_bootstrap);
+  ASSERT_GT(first.ops_size(), 0);
+  ASSERT_LT(first.ops_size(), 50);
+  ASSERT_EQ(51, first.ops(0).id().index());
+  const OpId first_last = first.ops(first.ops_size() - 1).id();
+  ASSERT_EQ(first_last.index(), first_info.last_index);
+  ASSERT_TRUE(first_info.has_more);
+
+  // The next request does not wait for the response to the first one.
+  ASSERT_OK(queue_->RequestForPeer(kPeerUuid, &second, &second_refs, &needs_remote_bootstrap,
+                                   nullptr, nullptr,
+                                   &second_info));
+  ASSERT_GT(second.ops_size(), 0);
+  ASSERT_EQ(first_last.index() + 1, second.ops(0).id().index());
+  ASSERT_OPID_EQ(first_last, second.preceding_id());
+
+  // Acknowledging the first request keeps the second one in flight.
+  SetLastReceivedAndLastCommitted(&response, first_last);
+  queue_->ResponseFromPeer(kPeerUuid, response, &more_pending, &first_info);
+  ASSERT_TRUE(more_pending);
+
+  // The second one is refused, so the next request starts right after the first one again.
+  RefuseWithLogPropertyMismatch(&response, first_last, first_last);
+  queue_->ResponseFromPeer(kPeerUuid, response, &more_pending, &second_info);
+  ASSERT_TRUE(more_pending);
+
+  ASSERT_OK(queue_->RequestForPeer(kPeerUuid, &third, &third_refs, &needs_remote_bootstrap,
+                                   nullptr, nullptr,
+                                   &third_info));
+  ASSERT_GT(third.ops_size(), 0);
+  ASSERT_EQ(second.ops(0).id().index(), third.ops(0).id().index());
+}
+
 TEST_F(ConsensusQueueTest, TestPeersDontAckBeyondWatermarks) {
   queue_->Init(MinimumOpId());
   queue_->SetLeaderMode(MinimumOpId(), MinimumOpId().term(), BuildRaftConfigPBForTests(3));
@@ -864,5 +931,42 @@ TEST_F(ConsensusQueueTest, TestTriggerRemoteBootstrapIfTabletNotFound) {
             rb_req.source_private_addr()[0].ShortDebugString());
 }
 
+// Test that an up to date follower is picked as the source of a remote bootstrap.
+TEST_F(ConsensusQueueTest, TestRemoteBootstrapFromFollower) {
+  queue_->Init(MinimumOpId());
+  queue_->SetLeaderMode(MinimumOpId(), MinimumOpId().term(), BuildRaftConfigPBForTests(3));
+  AppendReplicateMessagesToQueue(queue_.get(), clock_, 1, 100);
+
+  // The follower is tracked starting from the last operation, and acknowledges it.
+  const std::string kFollowerUuid = "peer-2";
+  queue_->TrackPeer(kFollowerUuid);
+  ConsensusRequestPB request;
+  ReplicateMsgs refs;
+  bool needs_remote_bootstrap;
+  ASSERT_OK(queue_->RequestForPeer(kFollowerUuid, &request, &refs, &needs_remote_bootstrap));
+  ASSERT_FALSE(needs_remote_bootstrap);
+  ConsensusResponsePB response;
+  response.set_responder_uuid(kFollowerUuid);
+  SetLastReceivedAndLastCommitted(&response, request.preceding_id());
+  bool more_pending = false;
+  queue_->ResponseFromPeer(kFollowerUuid, response, &more_pending);
+
+  // The other peer does not have the tablet.
+  queue_->TrackPeer(kPeerUuid);
+  ASSERT_OK(queue_->RequestForPeer(kPeerUuid, &request, &refs, &needs_remote_bootstrap));
+  response.Clear();
+  response.set_responder_uuid(kPeerUuid);
+  response.mutable_error()->set_code(tserver::TabletServerErrorPB::TABLET_NOT_FOUND);
+  StatusToPB(STATUS(NotFound, "No such tablet"), response.mutable_error()->mutable_status());
+  queue_->ResponseFromPeer(kPeerUuid, response, &more_pending);
+  ASSERT_OK(queue_->RequestForPeer(kPeerUuid, &request, &refs, &needs_remote_bootstrap));
+  ASSERT_TRUE(needs_remote_bootstrap);
+
+  StartRemoteBootstrapRequestPB rb_req;
+  ASSERT_OK(queue_->GetRemoteBootstrapRequestForPeer(kPeerUuid, &rb_req));
+  ASSERT_EQ(kFollowerUuid, rb_req.bootstrap_peer_uuid());
+  ASSERT_EQ("peer-2.fake-domain-for-tests", rb_req.source_private_addr(0).host());
+}
+
 }  // namespace consensus
 }  // namespace yb
@@ -62,6 +62,7 @@
 #include "yb/util/logging.h"
 #include "yb/util/mem_tracker.h"
 #include "yb/util/metrics.h"
+#include "yb/util/random_util.h"
 #include "yb/util/size_literals.h"
 #include "yb/util/threadpool.h"
 #include "yb/util/url-coding.h"
@@ -97,6 +98,13 @@ DECLARE_int32(rpc_max_message_size);
 
 DEFINE_bool(propagate_safe_time, true, "Propagate safe time to read from leader to followers");
 
+DEFINE_bool(remote_bootstrap_from_followers, true,
+            "Whether the leader could pick an up to date follower as the source of a remote "
+            "bootstrap, preferring replicas in the zone of the bootstrapped peer, to spare the "
+            "leader the load of serving it.");
+TAG_FLAG(remote_bootstrap_from_followers, advanced);
+TAG_FLAG(remote_bootstrap_from_followers, runtime);
+
 namespace yb {
 namespace consensus {
 
@@ -115,14 +123,24 @@ METRIC_DEFINE_gauge_int64(tablet, in_progress_ops, "Leader Operations in Progres
                           "Number of operations in the leader queue ack'd by a minority of "
                           "peers.");
 
+namespace {
+
+bool IsSameZone(const CloudInfoPB& lhs, const CloudInfoPB& rhs) {
+  return lhs.placement_cloud() == rhs.placement_cloud() &&
+         lhs.placement_region() == rhs.placement_region() &&
+         lhs.placement_zone() == rhs.placement_zone();
+}
+
+} // namespace
+
 std::string PeerMessageQueue::TrackedPeer::ToString() const {
   return Substitute("Peer: $0, Is new: $1, Last received: $2, Next index: $3, "
                     "Last known committed idx: $4, Last exchange result: $5, "
-                    "Needs remote bootstrap: $6",
+                    "Needs remote bootstrap: $6, Last sent index: $7",
                     uuid, is_new, OpIdToString(last_received), next_index,
                     last_known_committed_idx,
                     is_last_exchange_successful ? "SUCCESS" : "ERROR",
-                    needs_remote_bootstrap);
+                    needs_remote_bootstrap, last_sent_index);
 }
 
 #define INSTANTIATE_METRIC(x) \
@@ -327,7 +345,8 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
                                         ReplicateMsgs* msg_refs,
                                         bool* needs_remote_bootstrap,
                                         RaftPeerPB::MemberType* member_type,
-                                        bool* last_exchange_successful) {
+                                        bool* last_exchange_successful,
+                                        PeerRequestInfo* request_info) {
   OpId preceding_id;
   MonoDelta unreachable_time = MonoDelta::kMin;
   bool is_voter = false;
@@ -395,6 +414,11 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
     if (last_exchange_successful) *last_exchange_successful = peer->is_last_exchange_successful;
     *needs_remote_bootstrap = peer->needs_remote_bootstrap;
     next_index = peer->next_index;
+    if (request_info) {
+      next_index = std::max(next_index, peer->last_sent_index + 1);
+      request_info->leader_lease_expiration = peer->last_leader_lease_expiration_sent_to_follower;
+      request_info->ht_lease_expiration = peer->last_ht_lease_expiration_sent_to_follower;
+    }
     if (peer->member_type == RaftPeerPB::VOTER) {
       is_voter = true;
     }
@@ -477,11 +501,26 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
     }
     msg_refs->swap(messages);
     DCHECK_LE(request->ByteSize(), FLAGS_consensus_max_batch_size_bytes);
+    if (request_info) {
+      request_info->has_more = have_more_messages;
+    }
   }
 
   DCHECK(preceding_id.IsInitialized());
   request->mutable_preceding_id()->CopyFrom(preceding_id);
 
+  if (request_info) {
+    request_info->last_index = request->ops_size() > 0
+        ? request->ops(request->ops_size() - 1).id().index() : preceding_id.index();
+    if (request->ops_size() > 0) {
+      LockGuard lock(queue_lock_);
+      auto peer = FindPtrOrNull(peers_map_, uuid);
+      if (peer != nullptr) {
+        peer->last_sent_index = std::max(peer->last_sent_index, request_info->last_index);
+      }
+    }
+  }
+
   if (PREDICT_FALSE(VLOG_IS_ON(2))) {
     if (request->ops_size() > 0) {
       VLOG_WITH_PREFIX_UNLOCKED(2) << "Sending request with operations to Peer: " << uuid
@@ -502,6 +541,8 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
 Status PeerMessageQueue::GetRemoteBootstrapRequestForPeer(const string& uuid,
                                                           StartRemoteBootstrapRequestPB* req) {
   TrackedPeer* peer = nullptr;
+  const RaftPeerPB* source = &local_peer_pb_;
+  RaftPeerPB follower_source;
   {
     LockGuard lock(queue_lock_);
     DCHECK_EQ(queue_state_.state, State::kQueueOpen);
@@ -510,6 +551,10 @@ Status PeerMessageQueue::GetRemoteBootstrapRequestForPeer(const string& uuid,
     if (PREDICT_FALSE(peer == nullptr || queue_state_.mode == Mode::NON_LEADER)) {
       return STATUS(NotFound, "Peer not tracked or queue not in leader mode.");
     }
+    if (FLAGS_remote_bootstrap_from_followers &&
+        SelectRemoteBootstrapSourceUnlocked(uuid, &follower_source)) {
+      source = &follower_source;
+    }
   }
 
   if (PREDICT_FALSE(!peer->needs_remote_bootstrap)) {
@@ -524,15 +569,72 @@ Status PeerMessageQueue::GetRemoteBootstrapRequestForPeer(const string& uuid,
   req->Clear();
   req->set_dest_uuid(uuid);
   req->set_tablet_id(tablet_id_);
-  req->set_bootstrap_peer_uuid(local_peer_uuid_);
-  *req->mutable_source_private_addr() = local_peer_pb_.last_known_private_addr();
-  *req->mutable_source_broadcast_addr() = local_peer_pb_.last_known_broadcast_addr();
-  *req->mutable_source_cloud_info() = local_peer_pb_.cloud_info();
+  req->set_bootstrap_peer_uuid(source->permanent_uuid());
+  *req->mutable_source_private_addr() = source->last_known_private_addr();
+  *req->mutable_source_broadcast_addr() = source->last_known_broadcast_addr();
+  *req->mutable_source_cloud_info() = source->cloud_info();
   req->set_caller_term(queue_state_.current_term);
   peer->needs_remote_bootstrap = false; // Now reset the flag.
   return Status::OK();
 }
 
+bool PeerMessageQueue::SelectRemoteBootstrapSourceUnlocked(const std::string& uuid,
+                                                           RaftPeerPB* source) {
+  DCHECK(queue_lock_.is_locked());
+  if (!queue_state_.active_config) {
+    return false;
+  }
+  const RaftPeerPB* dest = nullptr;
+  for (const RaftPeerPB& peer_pb : queue_state_.active_config->peers()) {
+    if (peer_pb.permanent_uuid() == uuid) {
+      dest = &peer_pb;
+      break;
+    }
+  }
+  if (dest == nullptr) {
+    return false;
+  }
+
+  // A follower qualifies if everything committed, as well as the config that added the peer, is
+  // in its log, so the bootstrapped peer could be caught up from it by the leader. The leader is
+  // preferred over followers in other zones, to keep the copy within the zone.
+  const bool leader_in_zone = IsSameZone(local_peer_pb_.cloud_info(), dest->cloud_info());
+  const int64_t min_index = std::max(queue_state_.committed_index.index(),
+                                     queue_state_.active_config->opid_index());
+  std::vector<const RaftPeerPB*> candidates;
+  bool candidates_in_zone = false;
+  for (const RaftPeerPB& peer_pb : queue_state_.active_config->peers()) {
+    if (peer_pb.permanent_uuid() == uuid || peer_pb.permanent_uuid() == local_peer_uuid_ ||
+        (peer_pb.member_type() != RaftPeerPB::VOTER &&
+         peer_pb.member_type() != RaftPeerPB::OBSERVER)) {
+      continue;
+    }
+    const TrackedPeer* tracked = FindPtrOrNull(peers_map_, peer_pb.permanent_uuid());
+    if (tracked == nullptr || !tracked->is_last_exchange_successful ||
+        tracked->needs_remote_bootstrap || tracked->last_received.index() < min_index) {
+      continue;
+    }
+    const bool in_zone = IsSameZone(peer_pb.cloud_info(), dest->cloud_info());
+    if (!in_zone && (leader_in_zone || candidates_in_zone)) {
+      continue;
+    }
+    if (in_zone && !candidates_in_zone) {
+      candidates.clear();
+      candidates_in_zone = true;
+    }
+    candidates.push_back(&peer_pb);
+  }
+  if (candidates.empty()) {
+    return false;
+  }
+
+  // Spread concurrent bootstraps over the qualifying followers.
+  *source = *candidates[RandomUniformInt<size_t>(0, candidates.size() - 1)];
+  LOG_WITH_PREFIX_UNLOCKED(INFO) << "Remote bootstrapping peer " << uuid << " from follower "
+                                 << source->permanent_uuid();
+  return true;
+}
+
 void PeerMessageQueue::UpdateAllReplicatedOpId(OpId* result) {
   OpId new_op_id = MaximumOpId();
 
@@ -738,9 +840,17 @@ void PeerMessageQueue::NotifyPeerIsResponsiveDespiteError(const std::string& pee
   peer->last_successful_communication_time = MonoTime::Now();
 }
 
+void PeerMessageQueue::RequestToPeerFailed(const std::string& peer_uuid) {
+  LockGuard l(queue_lock_);
+  TrackedPeer* peer = FindPtrOrNull(peers_map_, peer_uuid);
+  if (!peer) return;
+  peer->last_sent_index = peer->next_index - 1;
+}
+
 void PeerMessageQueue::ResponseFromPeer(const std::string& peer_uuid,
                                         const ConsensusResponsePB& response,
-                                        bool* more_pending) {
+                                        bool* more_pending,
+                                        const PeerRequestInfo* request_info) {
   DCHECK(response.IsInitialized()) << "Error: Uninitialized: "
       << response.InitializationErrorString() << ". Response: " << response.ShortDebugString();
 
@@ -765,6 +875,7 @@ void PeerMessageQueue::ResponseFromPeer(const std::string& peer_uuid,
           << response.ShortDebugString();
 
       peer->needs_remote_bootstrap = true;
+      peer->last_sent_index = peer->next_index - 1;
       // Since we received a response from the peer, we know it is alive. So we need to update
       // peer->last_successful_communication_time, otherwise, we will remove this peer from the
       // configuration if the remote bootstrap is not completed within
@@ -840,6 +951,15 @@ void PeerMessageQueue::ResponseFromPeer(const std::string& peer_uuid,
       peer->next_index = peer->last_known_committed_idx + 1;
     }
 
+    // Operations sent after the acknowledged ones are resent, unless this is a pipelined request
+    // that the peer fully accepted, in which case the requests sent after it are still in flight.
+    if (request_info && !status.has_error() &&
+        peer->last_received.index() >= request_info->last_index) {
+      peer->last_sent_index = std::max(peer->last_sent_index, peer->next_index - 1);
+    } else {
+      peer->last_sent_index = peer->next_index - 1;
+    }
+
     if (PREDICT_FALSE(status.has_error())) {
       peer->is_last_exchange_successful = false;
       switch (status.error().code()) {
@@ -890,7 +1010,7 @@ void PeerMessageQueue::ResponseFromPeer(const std::string& peer_uuid,
 
     // If our log has the next request for the peer or if the peer's committed index is lower than
     // our own, set 'more_pending' to true.
-    *more_pending = log_cache_.HasOpBeenWritten(peer->next_index) ||
+    *more_pending = log_cache_.HasOpBeenWritten(peer->last_sent_index + 1) ||
         (peer->last_known_committed_idx < queue_state_.committed_index.index());
 
     mode_copy = queue_state_.mode;
@@ -905,11 +1025,17 @@ void PeerMessageQueue::ResponseFromPeer(const std::string& peer_uuid,
       }
       majority_replicated.op_id = queue_state_.majority_replicated_opid;
 
-      peer->last_leader_lease_expiration_received_by_follower =
-          peer->last_leader_lease_expiration_sent_to_follower;
+      if (request_info) {
+        peer->last_leader_lease_expiration_received_by_follower =
+            request_info->leader_lease_expiration;
+        peer->last_ht_lease_expiration_received_by_follower = request_info->ht_lease_expiration;
+      } else {
+        peer->last_leader_lease_expiration_received_by_follower =
+            peer->last_leader_lease_expiration_sent_to_follower;
 
-      peer->last_ht_lease_expiration_received_by_follower =
-          peer->last_ht_lease_expiration_sent_to_follower;
+        peer->last_ht_lease_expiration_received_by_follower =
+            peer->last_ht_lease_expiration_sent_to_follower;
+      }
 
       majority_replicated.leader_lease_expiration = LeaderLeaseExpirationWatermark();
 
@@ -75,6 +75,21 @@ struct MajorityReplicatedData;
 // The id for the server-wide consensus queue MemTracker.
 extern const char kConsensusQueueParentTrackerId[];
 
+// What was sent to a peer in a single request. When several requests to the same peer are in
+// flight, the response to each of them has to be matched with what that request carried, rather
+// than with the latest request.
+struct PeerRequestInfo {
+  // Index of the last operation in the request, or of the preceding operation if it has none.
+  int64_t last_index = kInvalidOpIdIndex;
+
+  // Leader lease expirations sent in the request, see TrackedPeer for details.
+  CoarseTimePoint leader_lease_expiration;
+  MicrosTime ht_lease_expiration = HybridTime::kMin.GetPhysicalValueMicros();
+
+  // Whether there are more operations to send after this request.
+  bool has_more = false;
+};
+
 // Tracks the state of the peers and which transactions they have replicated.  Owns the LogCache
 // which actually holds the replicate messages which are en route to the various peers.
 //
@@ -83,8 +98,9 @@ extern const char kConsensusQueueParentTrackerId[];
 //
 // This class is used only on the LEADER side.
 //
-// TODO Currently this class is able to track one outstanding operation per peer. If we want to have
-// more than one outstanding RPC we need to modify it.
+// Requests that pass PeerRequestInfo to RequestForPeer() and ResponseFromPeer() may be pipelined:
+// the next request starts after the last operation sent instead of the last one acknowledged, and
+// the queue rewinds to the last acknowledged operation when a request fails.
 class PeerMessageQueue {
  public:
   struct TrackedPeer {
@@ -111,6 +127,10 @@ class PeerMessageQueue {
     // Next index to send to the peer.  This corresponds to "nextIndex" as specified in Raft.
     int64_t next_index = kInvalidOpIdIndex;
 
+    // Index of the last operation sent to the peer in a pipelined request, which may not have been
+    // acknowledged yet. Never lower than next_index - 1.
+    int64_t last_sent_index = kInvalidOpIdIndex;
+
     // The last operation that we've sent to this peer and that it acked. Used for watermark
     // movement.
     OpId last_received;
@@ -240,7 +260,8 @@ class PeerMessageQueue {
       ReplicateMsgs* msg_refs,
       bool* needs_remote_bootstrap,
       RaftPeerPB::MemberType* member_type = nullptr,
-      bool* last_exchange_successful = nullptr);
+      bool* last_exchange_successful = nullptr,
+      PeerRequestInfo* request_info = nullptr);
 
   // Fill in a StartRemoteBootstrapRequest for the specified peer.  If that peer should not remotely
   // bootstrap, returns a non-OK status.  On success, also internally resets
@@ -254,11 +275,17 @@ class PeerMessageQueue {
   // is alive, even if it may not be fully up and running or able to accept updates.
   void NotifyPeerIsResponsiveDespiteError(const std::string& peer_uuid);
 
+  // Makes the next request to the given peer start after the last acknowledged operation, because
+  // a pipelined request to it failed or was not sent.
+  void RequestToPeerFailed(const std::string& peer_uuid);
+
   // Updates the request queue with the latest response of a peer, returns whether this peer has
-  // more requests pending.
+  // more requests pending. 'request_info' is what RequestForPeer() returned for the request this
+  // is the response to.
   virtual void ResponseFromPeer(const std::string& peer_uuid,
                                 const ConsensusResponsePB& response,
-                                bool* more_pending);
+                                bool* more_pending,
+                                const PeerRequestInfo* request_info = nullptr);
 
   // Closes the queue, peers are still allowed to call UntrackPeer() and ResponseFromPeer() but no
   // additional peers can be tracked or messages queued.
@@ -408,6 +435,10 @@ class PeerMessageQueue {
 
   TrackedPeer* TrackPeerUnlocked(const std::string& uuid);
 
+  // Picks an up to date follower to serve the remote bootstrap of peer 'uuid'. Returns false if
+  // the leader should serve it.
+  bool SelectRemoteBootstrapSourceUnlocked(const std::string& uuid, RaftPeerPB* source);
+
   // Checks that if the queue is in LEADER mode then all registered peers are in the active config.
   // Crashes with a FATAL log message if this invariant does not hold. If the queue is in NON_LEADER
   // mode, does nothing.
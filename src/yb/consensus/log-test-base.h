@@ -174,7 +174,7 @@ class LogTestBase : public YBTest {
                  .Build(&append_pool_));
   }
 
-  void BuildLog() {
+  void BuildLog(ThreadPool* allocation_pool = nullptr) {
     Schema schema_with_ids = SchemaBuilder(schema_).Build();
     ASSERT_OK(Log::Open(options_,
                        fs_manager_.get(),
@@ -184,6 +184,7 @@ class LogTestBase : public YBTest {
                        0, // schema_version
                        metric_entity_.get(),
                        append_pool_.get(),
+                       allocation_pool,
                        &log_));
   }
 
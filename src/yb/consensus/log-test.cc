@@ -34,6 +34,7 @@
 #include <unistd.h>
 
 #include <algorithm>
+#include <thread>
 #include <vector>
 
 #include <boost/bind.hpp>
@@ -44,6 +45,7 @@
 #include "yb/consensus/log-test-base.h"
 #include "yb/consensus/log_index.h"
 #include "yb/consensus/opid_util.h"
+#include "yb/consensus/shared_log_syncer.h"
 #include "yb/gutil/stl_util.h"
 #include "yb/gutil/strings/substitute.h"
 #include "yb/util/random.h"
@@ -56,6 +58,9 @@ DECLARE_bool(never_fsync);
 DECLARE_bool(writable_file_use_fsync);
 DECLARE_int32(o_direct_block_alignment_bytes);
 DECLARE_int32(o_direct_block_size_bytes);
+DECLARE_string(log_compression_codec);
+DECLARE_bool(log_shared_sync);
+DECLARE_bool(log_mmap_closed_segments);
 
 namespace yb {
 namespace log {
@@ -207,6 +212,73 @@ TEST_F(LogTest, TestMultipleEntriesInABatch) {
   ASSERT_OK(log_->Close());
 }
 
+// Entries of a compressed segment should be read back both when scanning the segment and through
+// the log index.
+TEST_F(LogTest, TestCompressedEntries) {
+  google::FlagSaver saver;
+  FLAGS_log_compression_codec = "lz4";
+  BuildLog();
+
+  OpId opid;
+  opid.set_term(1);
+  opid.set_index(1);
+
+  ASSERT_OK(AppendNoOpsToLogSync(clock_, log_.get(), &opid, 10));
+  ASSERT_OK(log_->AllocateSegmentAndRollOver());
+
+  SegmentSequence segments;
+  ASSERT_OK(log_->GetLogReader()->GetSegmentsSnapshot(&segments));
+  ASSERT_EQ(LZ4_COMPRESSION, segments[0]->header().compression());
+
+  auto read_entries = segments[0]->ReadEntries();
+  ASSERT_OK(read_entries.status);
+  ASSERT_EQ(10, read_entries.entries.size());
+  for (int i = 0; i != 10; ++i) {
+    ASSERT_EQ(i + 1, read_entries.entries[i]->replicate().id().index());
+  }
+
+  consensus::ReplicateMsgs repls;
+  ASSERT_OK(log_->GetLogReader()->ReadReplicatesInRange(3, 7, LogReader::kNoSizeLimit, &repls));
+  ASSERT_EQ(5, repls.size());
+  ASSERT_EQ(3, repls.front()->id().index());
+  ASSERT_EQ(7, repls.back()->id().index());
+
+  ASSERT_OK(log_->Close());
+}
+
+// Entries of closed segments are read through a mapping of the segment, and the active segment is
+// read from the file.
+TEST_F(LogTest, TestReadFromMappedSegment) {
+  BuildLog();
+  OpId op_id = MakeOpId(1, 1);
+  ASSERT_OK(AppendNoOps(&op_id, 10));
+  ASSERT_OK(log_->AllocateSegmentAndRollOver());
+  ASSERT_OK(AppendNoOps(&op_id, 10));
+
+  auto read_all = [this](consensus::ReplicateMsgs* repls) {
+    return log_->GetLogReader()->ReadReplicatesInRange(1, 20, LogReader::kNoSizeLimit, repls);
+  };
+  consensus::ReplicateMsgs mapped_repls;
+  ASSERT_OK(read_all(&mapped_repls));
+  SegmentSequence segments;
+  ASSERT_OK(log_->GetLogReader()->GetSegmentsSnapshot(&segments));
+  ASSERT_EQ(2, segments.size());
+  ASSERT_FALSE(segments[0]->MappedData().empty());
+  ASSERT_TRUE(segments[1]->MappedData().empty());
+
+  google::FlagSaver flag_saver;
+  FLAGS_log_mmap_closed_segments = false;
+  consensus::ReplicateMsgs file_repls;
+  ASSERT_OK(read_all(&file_repls));
+  ASSERT_EQ(20, mapped_repls.size());
+  ASSERT_EQ(file_repls.size(), mapped_repls.size());
+  for (size_t i = 0; i != mapped_repls.size(); ++i) {
+    ASSERT_EQ(file_repls[i]->ShortDebugString(), mapped_repls[i]->ShortDebugString());
+  }
+
+  ASSERT_OK(log_->Close());
+}
+
 // Tests that everything works properly with fsync enabled:
 // This also tests SyncDir() (see KUDU-261), which is called whenever
 // a new log segment is initialized.
@@ -223,6 +295,48 @@ TEST_F(LogTest, TestFsync) {
 }
 
 // Tests interval for durable wal write
+// Tests durable writes of several logs on the same filesystem that are synced together.
+TEST_F(LogTest, TestSharedSync) {
+  google::FlagSaver saver;
+  FLAGS_log_shared_sync = true;
+  options_.durable_wal_write = true;
+  BuildLog();
+
+  // All directories on the same filesystem share the syncer.
+  auto syncer = ASSERT_RESULT(SharedLogSyncer::ForDirectory(tablet_wal_path_));
+  auto test_dir_syncer = ASSERT_RESULT(SharedLogSyncer::ForDirectory(GetTestDataDirectory()));
+  ASSERT_EQ(syncer, test_dir_syncer);
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i != 4; ++i) {
+    threads.emplace_back([syncer] {
+      for (int j = 0; j != 10; ++j) {
+        ASSERT_OK(syncer->Sync());
+      }
+    });
+  }
+
+  OpId opid;
+  opid.set_term(0);
+  opid.set_index(1);
+  ASSERT_OK(AppendNoOps(&opid, 10));
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  ASSERT_OK(log_->Close());
+
+  std::unique_ptr<LogReader> reader;
+  ASSERT_OK(LogReader::Open(fs_manager_.get(), nullptr, kTestTablet, tablet_wal_path_, nullptr,
+                            &reader));
+  SegmentSequence segments;
+  ASSERT_OK(reader->GetSegmentsSnapshot(&segments));
+  auto read_entries = segments[0]->ReadEntries();
+  ASSERT_OK(read_entries.status);
+  ASSERT_EQ(10, read_entries.entries.size());
+}
+
 TEST_F(LogTest, TestFsyncInterval) {
   options_.interval_durable_wal_write = MonoDelta::FromMilliseconds(1);
   BuildLog();
@@ -475,6 +589,38 @@ TEST_F(LogTest, TestSegmentRollover) {
   ASSERT_EQ(num_entries, total_read);
 }
 
+// Logs sharing a single allocation thread roll over independently.
+TEST_F(LogTest, TestSharedAllocationPool) {
+  std::unique_ptr<ThreadPool> allocation_pool;
+  ASSERT_OK(ThreadPoolBuilder("log-alloc").set_max_threads(1).Build(&allocation_pool));
+  BuildLog(allocation_pool.get());
+  log_->SetMaxSegmentSizeForTests(990);
+
+  const std::string other_wal_path = fs_manager_->GetFirstTabletWalDirOrDie(
+      kTestTable, "other-tablet");
+  scoped_refptr<Log> other_log;
+  ASSERT_OK(Log::Open(options_, fs_manager_.get(), "other-tablet", other_wal_path,
+                      SchemaBuilder(schema_).Build(), 0 /* schema_version */, metric_entity_.get(),
+                      append_pool_.get(), allocation_pool.get(), &other_log));
+  other_log->SetMaxSegmentSizeForTests(990);
+
+  OpId op_id = MakeOpId(1, 1);
+  OpId other_op_id = MakeOpId(1, 1);
+  SegmentSequence segments;
+  SegmentSequence other_segments;
+  while (segments.size() < 3 || other_segments.size() < 3) {
+    ASSERT_OK(AppendNoOps(&op_id, 100));
+    ASSERT_OK(AppendNoOpsToLogSync(clock_, other_log.get(), &other_op_id, 100));
+    ASSERT_OK(log_->GetLogReader()->GetSegmentsSnapshot(&segments));
+    ASSERT_OK(other_log->GetLogReader()->GetSegmentsSnapshot(&other_segments));
+  }
+
+  ASSERT_OK(other_log->Close());
+  ASSERT_OK(log_->Close());
+  other_log.reset();
+  log_.reset();
+}
+
 TEST_F(LogTest, TestWriteAndReadToAndFromInProgressSegment) {
   const int kNumEntries = 4;
   BuildLog();
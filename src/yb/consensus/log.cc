@@ -43,6 +43,7 @@
 #include "yb/consensus/log_metrics.h"
 #include "yb/consensus/log_reader.h"
 #include "yb/consensus/log_util.h"
+#include "yb/consensus/shared_log_syncer.h"
 #include "yb/fs/fs_manager.h"
 #include "yb/gutil/map-util.h"
 #include "yb/gutil/ref_counted.h"
@@ -124,6 +125,17 @@ TAG_FLAG(log_inject_latency_ms_stddev, unsafe);
 DEFINE_int32(log_inject_append_latency_ms_max, 0,
              "The maximum latency to inject before the log append operation.");
 
+DEFINE_bool(log_shared_sync, false,
+            "Whether durable WAL writes of all tablets on the same filesystem are synced together "
+            "by a single sync call, instead of one sync per tablet. Only takes effect if "
+            "--durable_wal_write is true, in which case WAL files are written without O_DIRECT.");
+TAG_FLAG(log_shared_sync, advanced);
+
+DEFINE_string(log_compression_codec, "none",
+              "Compression of the entry batches written to new WAL segments: none or lz4. "
+              "Compressed segments cannot be read by versions without WAL compression support.");
+TAG_FLAG(log_compression_codec, advanced);
+
 // Validate that log_min_segments_to_retain >= 1
 static bool ValidateLogsToRetain(const char* flagname, int value) {
   if (value >= 1) {
@@ -136,6 +148,17 @@ static bool ValidateLogsToRetain(const char* flagname, int value) {
 static bool dummy = google::RegisterFlagValidator(
     &FLAGS_log_min_segments_to_retain, &ValidateLogsToRetain);
 
+static bool ValidateLogCompressionCodec(const char* flagname, const std::string& value) {
+  if (value == "none" || value == "lz4") {
+    return true;
+  }
+  LOG(ERROR) << strings::Substitute("$0 must be none or lz4, value $1 is invalid",
+                                    flagname, value);
+  return false;
+}
+static bool log_compression_codec_dummy = google::RegisterFlagValidator(
+    &FLAGS_log_compression_codec, &ValidateLogCompressionCodec);
+
 static const char kSegmentPlaceholderFileTemplate[] = ".tmp.newsegmentXXXXXX";
 
 namespace yb {
@@ -313,6 +336,7 @@ Status Log::Open(const LogOptions &options,
                  uint32_t schema_version,
                  const scoped_refptr<MetricEntity>& metric_entity,
                  ThreadPool* append_thread_pool,
+                 ThreadPool* allocation_thread_pool,
                  scoped_refptr<Log>* log) {
 
   RETURN_NOT_OK_PREPEND(fs_manager->CreateDirIfMissing(DirName(tablet_wal_path)),
@@ -329,7 +353,8 @@ Status Log::Open(const LogOptions &options,
                                      schema,
                                      schema_version,
                                      metric_entity,
-                                     append_thread_pool));
+                                     append_thread_pool,
+                                     allocation_thread_pool));
   RETURN_NOT_OK(new_log->Init());
   log->swap(new_log);
   return Status::OK();
@@ -338,7 +363,8 @@ Status Log::Open(const LogOptions &options,
 Log::Log(LogOptions options, FsManager* fs_manager, string log_path,
          string tablet_id, string tablet_wal_path, const Schema& schema, uint32_t schema_version,
          const scoped_refptr<MetricEntity>& metric_entity,
-         ThreadPool* append_thread_pool)
+         ThreadPool* append_thread_pool,
+         ThreadPool* allocation_thread_pool)
     : options_(std::move(options)),
       fs_manager_(fs_manager),
       log_dir_(std::move(log_path)),
@@ -357,7 +383,11 @@ Log::Log(LogOptions options, FsManager* fs_manager, string log_path,
       allocation_state_(kAllocationNotStarted),
       metric_entity_(metric_entity),
       on_disk_size_(0) {
-  CHECK_OK(ThreadPoolBuilder("log-alloc").set_max_threads(1).Build(&allocation_pool_));
+  if (!allocation_thread_pool) {
+    CHECK_OK(ThreadPoolBuilder("log-alloc").set_max_threads(1).Build(&allocation_pool_));
+    allocation_thread_pool = allocation_pool_.get();
+  }
+  allocation_token_ = allocation_thread_pool->NewToken(ThreadPool::ExecutionMode::SERIAL);
   if (metric_entity_) {
     metrics_.reset(new LogMetrics(metric_entity_));
   }
@@ -389,6 +419,9 @@ Status Log::Init() {
 
   if (durable_wal_write_) {
     YB_LOG_FIRST_N(INFO, 1) << "durable_wal_write is turned on.";
+    if (FLAGS_log_shared_sync) {
+      shared_syncer_ = VERIFY_RESULT(SharedLogSyncer::ForDirectory(log_dir_));
+    }
   } else if (interval_durable_wal_write_) {
     YB_LOG_FIRST_N(INFO, 1) << "interval_durable_wal_write_ms is turned on to sync every "
                             << interval_durable_wal_write_.ToMilliseconds() << " ms.";
@@ -414,7 +447,7 @@ Status Log::AsyncAllocateSegment() {
   CHECK_EQ(allocation_state_, kAllocationNotStarted);
   allocation_status_.Reset();
   allocation_state_ = kAllocationInProgress;
-  return allocation_pool_->SubmitClosure(Bind(&Log::SegmentAllocationTask, Unretained(this)));
+  return allocation_token_->SubmitClosure(Bind(&Log::SegmentAllocationTask, Unretained(this)));
 }
 
 Status Log::CloseCurrentSegment() {
@@ -672,7 +705,11 @@ Status Log::Sync() {
       periodic_sync_needed_.store(false);
       periodic_sync_unsynced_bytes_ = 0;
       LOG_SLOW_EXECUTION(WARNING, 50, "Fsync log took a long time") {
-        RETURN_NOT_OK(active_segment_->Sync());
+        if (shared_syncer_) {
+          RETURN_NOT_OK(shared_syncer_->Sync());
+        } else {
+          RETURN_NOT_OK(active_segment_->Sync());
+        }
       }
     }
   }
@@ -911,9 +948,9 @@ void Log::SetSchemaForNextLogSegment(const Schema& schema,
 }
 
 Status Log::Close() {
-  // Allocation pool is used from appender pool, so we should shutdown appender first.
+  // Allocation token is used from appender pool, so we should shutdown appender first.
   appender_->Shutdown();
-  allocation_pool_->Shutdown();
+  allocation_token_->Shutdown();
 
   std::lock_guard<percpu_rwlock> l(state_lock_);
   switch (log_state_) {
@@ -962,7 +999,8 @@ Status Log::PreAllocateNewSegment() {
 
   WritableFileOptions opts;
   opts.sync_on_close = durable_wal_write_;
-  opts.o_direct = durable_wal_write_;
+  // The shared sync only covers what is in the page cache.
+  opts.o_direct = durable_wal_write_ && !shared_syncer_;
   RETURN_NOT_OK(CreatePlaceholderSegment(opts, &next_segment_path_, &next_segment_file_));
 
   if (options_.preallocate_segments) {
@@ -1004,6 +1042,9 @@ Status Log::SwitchToAllocatedSegment() {
   header.set_minor_version(kLogMinorVersion);
   header.set_sequence_number(active_segment_sequence_number_);
   header.set_tablet_id(tablet_id_);
+  if (FLAGS_log_compression_codec == "lz4") {
+    header.set_compression(LZ4_COMPRESSION);
+  }
 
   // Set up the new footer. This will be maintained as the segment is written.
   footer_builder_.Clear();
@@ -91,12 +91,18 @@ class LogReader;
 //
 // Note: The Log needs to be Close()d before any log-writing class is destroyed, otherwise the Log
 // might hold references to these classes to execute the callbacks after each write.
+class SharedLogSyncer;
+
 class Log : public RefCountedThreadSafe<Log> {
  public:
   static const Status kLogShutdownStatus;
 
   // Opens or continues a log and sets 'log' to the newly built Log.
   // After a successful Open() the Log is ready to receive entries.
+  //
+  // New segments are allocated by the tasks of a serial token of allocation_thread_pool, so the
+  // logs hosted by a server share the allocation threads while each log allocates at most one
+  // segment at a time. If allocation_thread_pool is null, the log uses its own pool.
   static CHECKED_STATUS Open(const LogOptions &options,
                              FsManager *fs_manager,
                              const std::string& tablet_id,
@@ -105,6 +111,7 @@ class Log : public RefCountedThreadSafe<Log> {
                              uint32_t schema_version,
                              const scoped_refptr<MetricEntity>& metric_entity,
                              ThreadPool *append_thread_pool,
+                             ThreadPool *allocation_thread_pool,
                              scoped_refptr<Log> *log);
 
   ~Log();
@@ -273,7 +280,7 @@ class Log : public RefCountedThreadSafe<Log> {
   Log(LogOptions options, FsManager* fs_manager, std::string log_path,
       std::string tablet_id, std::string tablet_wal_path, const Schema& schema,
       uint32_t schema_version, const scoped_refptr<MetricEntity>& metric_entity,
-      ThreadPool* append_thread_pool);
+      ThreadPool* append_thread_pool, ThreadPool* allocation_thread_pool);
 
   // Initializes a new one or continues an existing log.
   CHECKED_STATUS Init();
@@ -399,12 +406,20 @@ class Log : public RefCountedThreadSafe<Log> {
   // Appender manages a TaskStream writing to the log. We will use one taskstream per tablet.
   std::unique_ptr<Appender> appender_;
 
-  // A thread pool for asynchronously pre-allocating new log segments.
+  // A thread pool for asynchronously pre-allocating new log segments, only used when no shared
+  // pool was provided.
   gscoped_ptr<ThreadPool> allocation_pool_;
 
+  // Serializes the segment allocation tasks of this log.
+  std::unique_ptr<ThreadPoolToken> allocation_token_;
+
   // If true, sync on all appends.
   bool durable_wal_write_;
 
+  // If set, durable writes are synced together with those of the other tablets on the same
+  // filesystem, see --log_shared_sync.
+  std::shared_ptr<SharedLogSyncer> shared_syncer_;
+
   // If non-zero, sync every interval of time.
   MonoDelta interval_durable_wal_write_;
 
@@ -95,6 +95,7 @@ class LogCacheTest : public YBTest {
                             0, // schema_version
                             NULL,
                             append_pool_.get(),
+                            nullptr /* allocation_thread_pool */,
                             &log_));
 
     CloseAndReopenCache(MinimumOpId());
@@ -319,6 +320,56 @@ TEST_F(LogCacheTest, TestGlobalMemoryLimit) {
   ASSERT_LE(cache_->BytesUsed(), 1024 * 1024);
 }
 
+// When the server-wide limit is exceeded, the cache that lags the most is evicted from first.
+TEST_F(LogCacheTest, TestEvictAcrossTablets) {
+  FLAGS_global_log_cache_size_limit_mb = 4;
+  CloseAndReopenCache(MinimumOpId());
+
+  const int kPayloadSize = 768 * 1024;
+  ASSERT_OK(AppendReplicateMessagesToCache(1, 4, kPayloadSize));
+  ASSERT_OK(log_->WaitUntilAllFlushed());
+  ASSERT_EQ(4, cache_->num_cached_ops());
+
+  const std::string kOtherTablet = "other-tablet";
+  scoped_refptr<log::Log> other_log;
+  ASSERT_OK(log::Log::Open(log::LogOptions(),
+                           fs_manager_.get(),
+                           kOtherTablet,
+                           fs_manager_->GetFirstTabletWalDirOrDie(kTestTable, kOtherTablet),
+                           schema_,
+                           0, // schema_version
+                           NULL,
+                           append_pool_.get(),
+                           nullptr /* allocation_thread_pool */,
+                           &other_log));
+  auto other_metric_entity = METRIC_ENTITY_tablet.Instantiate(&metric_registry_, kOtherTablet);
+  LogCache other_cache(
+      other_metric_entity, other_log, nullptr /* mem_tracker */, kPeerUuid, kOtherTablet);
+  other_cache.Init(MinimumOpId());
+
+  // The other tablet only has fresh operations, so making room for them evicts the oldest
+  // operation of the lagging tablet rather than its own.
+  for (int index = 1; index <= 2; ++index) {
+    ReplicateMsgs msgs = { CreateDummyReplicate(0, index, clock_->Now(), kPayloadSize) };
+    ASSERT_OK(other_cache.AppendOperations(
+        msgs, yb::OpId() /* committed_op_id */, RestartSafeCoarseMonoClock().Now(),
+        Bind(&FatalOnError)));
+  }
+  ASSERT_OK(other_log->WaitUntilAllFlushed());
+  ASSERT_EQ(2, other_cache.num_cached_ops());
+  ASSERT_EQ(3, cache_->num_cached_ops());
+
+  // Reading the evicted operation is a miss caused by memory pressure.
+  ReplicateMsgs messages;
+  OpId preceding;
+  ASSERT_OK(cache_->ReadOps(0, 8 * 1024 * 1024, &messages, &preceding));
+  ASSERT_EQ(4, messages.size());
+  ASSERT_EQ(1, cache_->metrics_.log_cache_misses_memory_pressure->value());
+  ASSERT_EQ(0, cache_->metrics_.log_cache_misses_replicated->value());
+  ASSERT_EQ(0, cache_->metrics_.log_cache_misses_not_cached->value());
+  ASSERT_EQ(3, cache_->metrics_.log_cache_hits->value());
+}
+
 // Test that the log cache properly replaces messages when an index
 // is reused. This is a regression test for a bug where the memtracker's
 // consumption wasn't properly managed when messages were replaced.
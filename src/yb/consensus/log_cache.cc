@@ -81,6 +81,22 @@ METRIC_DEFINE_gauge_int64(tablet, log_cache_num_ops, "Log Cache Operation Count"
 METRIC_DEFINE_gauge_int64(tablet, log_cache_size, "Log Cache Memory Usage",
                           MetricUnit::kBytes,
                           "Amount of memory in use for caching the local log.");
+METRIC_DEFINE_counter(tablet, log_cache_hits, "Log Cache Hits",
+                      MetricUnit::kOperations,
+                      "Number of operations sent to peers that were read from the log cache.");
+METRIC_DEFINE_counter(tablet, log_cache_misses_not_cached, "Log Cache Misses: Not Cached",
+                      MetricUnit::kOperations,
+                      "Number of operations sent to peers that were read from the disk because "
+                      "they were written before the log cache was initialized.");
+METRIC_DEFINE_counter(tablet, log_cache_misses_replicated, "Log Cache Misses: Replicated",
+                      MetricUnit::kOperations,
+                      "Number of operations sent to peers that were read from the disk because "
+                      "they were evicted after being replicated to all the peers.");
+METRIC_DEFINE_counter(tablet, log_cache_misses_memory_pressure,
+                      "Log Cache Misses: Memory Pressure",
+                      MetricUnit::kOperations,
+                      "Number of operations sent to peers that were read from the disk because "
+                      "they were evicted to stay under the log cache memory limits.");
 
 namespace {
 
@@ -88,6 +104,56 @@ const std::string kParentMemTrackerId = "log_cache"s;
 
 }
 
+// Keeps track of all the log caches of the process, so that the caches of all the tablets of a
+// server can be evicted from when the server-wide limit is exceeded.
+class LogCacheRegistry {
+ public:
+  static LogCacheRegistry& Instance() {
+    static LogCacheRegistry* instance = new LogCacheRegistry;
+    return *instance;
+  }
+
+  void Register(LogCache* cache) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    caches_.push_back(cache);
+  }
+
+  void Unregister(LogCache* cache) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    caches_.erase(std::find(caches_.begin(), caches_.end(), cache));
+  }
+
+  // Evicts at least 'bytes_to_evict' bytes from the caches tracked by 'parent_tracker' if possible,
+  // from the cache that lags the most first.
+  void Evict(MemTracker* parent_tracker, int64_t bytes_to_evict) {
+    // Holding the mutex keeps the caches from being destroyed while we evict from them.
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<std::pair<int64_t, LogCache*>> candidates;
+    for (auto* cache : caches_) {
+      if (cache->parent_tracker_.get() != parent_tracker) {
+        continue;
+      }
+      auto lag = cache->EvictionLag();
+      if (lag > 0) {
+        candidates.emplace_back(lag, cache);
+      }
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const auto& lhs, const auto& rhs) {
+      return lhs.first > rhs.first;
+    });
+    for (const auto& candidate : candidates) {
+      bytes_to_evict -= candidate.second->EvictForMemoryPressure(bytes_to_evict);
+      if (bytes_to_evict <= 0) {
+        break;
+      }
+    }
+  }
+
+ private:
+  std::mutex mutex_;
+  std::vector<LogCache*> caches_;
+};
+
 typedef vector<const ReplicateMsg*>::const_iterator MsgIter;
 
 LogCache::LogCache(const scoped_refptr<MetricEntity>& metric_entity,
@@ -121,9 +187,13 @@ LogCache::LogCache(const scoped_refptr<MetricEntity>& metric_entity,
   auto zero_op = std::make_shared<ReplicateMsg>();
   *zero_op->mutable_id() = MinimumOpId();
   InsertOrDie(&cache_, 0, { zero_op, zero_op->SpaceUsed() });
+
+  LogCacheRegistry::Instance().Register(this);
 }
 
 LogCache::~LogCache() {
+  LogCacheRegistry::Instance().Unregister(this);
+
   tracker_->Release(tracker_->consumption());
   cache_.clear();
 
@@ -135,6 +205,14 @@ void LogCache::Init(const OpId& preceding_op) {
   CHECK_EQ(cache_.size(), 1) << "Cache should have only our special '0' op";
   next_sequential_op_index_ = preceding_op.index() + 1;
   min_pinned_op_index_ = next_sequential_op_index_;
+  first_cached_op_index_ = next_sequential_op_index_;
+}
+
+void LogCache::EnsureGlobalSpareCapacity(int64_t bytes_needed) {
+  const int64_t spare = parent_tracker_->SpareCapacity();
+  if (spare < bytes_needed) {
+    LogCacheRegistry::Instance().Evict(parent_tracker_.get(), bytes_needed - spare);
+  }
 }
 
 Result<LogCache::PrepareAppendResult> LogCache::PrepareAppendOperations(const ReplicateMsgs& msgs) {
@@ -151,6 +229,10 @@ Result<LogCache::PrepareAppendResult> LogCache::PrepareAppendOperations(const Re
   int64_t first_idx_in_batch = msgs.front()->id().index();
   result.last_idx_in_batch = msgs.back()->id().index();
 
+  // Make room in the caches of the other tablets first, rather than evicting recent operations of
+  // this one.
+  EnsureGlobalSpareCapacity(result.mem_required);
+
   std::unique_lock<simple_spinlock> lock(lock_);
   // If we're not appending a consecutive op we're likely overwriting and need to replace operations
   // in the cache.
@@ -179,13 +261,11 @@ Result<LogCache::PrepareAppendResult> LogCache::PrepareAppendOperations(const Re
                         << HumanReadableNumBytes::ToString(spare)
                         << "): attempting to evict some operations...";
 
-    // TODO: we should also try to evict from other tablets - probably better to evict really old
-    // ops from another tablet than evict recent ops from this one.
     EvictSomeUnlocked(min_pinned_op_index_, need_to_free);
 
     // Force consuming, so that we don't refuse appending data. We might blow past our limit a
     // little bit (as much as the number of tablets times the amount of in-flight data in the log),
-    // but until implementing the above TODO, it's difficult to solve this issue.
+    // when the operations of the other tablets that could be evicted are pinned or in use.
     tracker_->Consume(result.mem_required);
 
     result.borrowed_memory = parent_tracker_->LimitExceeded();
@@ -229,19 +309,18 @@ void LogCache::LogCallback(int64_t last_idx_in_batch,
                            const StatusCallback& user_callback,
                            const Status& log_status) {
   if (log_status.ok()) {
-    std::lock_guard<simple_spinlock> l(lock_);
-    if (min_pinned_op_index_ <= last_idx_in_batch) {
-      VLOG_WITH_PREFIX_UNLOCKED(1) << "Updating pinned index to " << (last_idx_in_batch + 1);
-      min_pinned_op_index_ = last_idx_in_batch + 1;
+    {
+      std::lock_guard<simple_spinlock> l(lock_);
+      if (min_pinned_op_index_ <= last_idx_in_batch) {
+        VLOG_WITH_PREFIX_UNLOCKED(1) << "Updating pinned index to " << (last_idx_in_batch + 1);
+        min_pinned_op_index_ = last_idx_in_batch + 1;
+      }
     }
 
     // If we went over the global limit in order to log this batch, evict some to get back down
-    // under the limit.
+    // under the limit. Now that this batch is unpinned, it is an eviction candidate as well.
     if (borrowed_memory) {
-      int64_t spare_capacity = parent_tracker_->SpareCapacity();
-      if (spare_capacity < 0) {
-        EvictSomeUnlocked(min_pinned_op_index_, -spare_capacity);
-      }
+      EnsureGlobalSpareCapacity(0);
     }
   }
   user_callback.Run(log_status);
@@ -331,6 +410,7 @@ Status LogCache::ReadOps(int64_t after_op_index,
       l.lock();
       LOG_WITH_PREFIX_UNLOCKED(INFO) << "Successfully read " << raw_replicate_ptrs.size() << " ops "
                             << "from disk.";
+      CountCacheMissesUnlocked(next_index, raw_replicate_ptrs.size());
 
       for (auto& msg : raw_replicate_ptrs) {
         CHECK_EQ(next_index, msg->id().index());
@@ -362,6 +442,7 @@ Status LogCache::ReadOps(int64_t after_op_index,
         }
 
         messages->push_back(msg);
+        metrics_.log_cache_hits->Increment();
         next_index++;
       }
     }
@@ -369,14 +450,43 @@ Status LogCache::ReadOps(int64_t after_op_index,
   return Status::OK();
 }
 
+void LogCache::CountCacheMissesUnlocked(int64_t first_index, int64_t num_ops) {
+  const int64_t end_index = first_index + num_ops;
+  auto count = [first_index, end_index](int64_t begin, int64_t end) {
+    return std::max<int64_t>(0, std::min(end, end_index) - std::max(begin, first_index));
+  };
+  const int64_t replicated_end = std::max(
+      first_cached_op_index_, replicated_evicted_through_index_ + 1);
+  metrics_.log_cache_misses_not_cached->IncrementBy(count(0, first_cached_op_index_));
+  metrics_.log_cache_misses_replicated->IncrementBy(count(first_cached_op_index_, replicated_end));
+  metrics_.log_cache_misses_memory_pressure->IncrementBy(count(replicated_end, end_index));
+}
+
 
 void LogCache::EvictThroughOp(int64_t index) {
   std::lock_guard<simple_spinlock> lock(lock_);
 
   EvictSomeUnlocked(index, MathLimits<int64_t>::kMax);
+  replicated_evicted_through_index_ = std::max(replicated_evicted_through_index_, index);
+}
+
+int64_t LogCache::EvictionLag() const {
+  std::lock_guard<simple_spinlock> lock(lock_);
+  // Skip our special '0' op.
+  auto it = cache_.upper_bound(0);
+  if (it == cache_.end()) {
+    return 0;
+  }
+  const int64_t oldest_index = it->first;
+  return oldest_index < min_pinned_op_index_ ? next_sequential_op_index_ - oldest_index : 0;
+}
+
+int64_t LogCache::EvictForMemoryPressure(int64_t bytes_to_evict) {
+  std::lock_guard<simple_spinlock> lock(lock_);
+  return EvictSomeUnlocked(min_pinned_op_index_, bytes_to_evict);
 }
 
-void LogCache::EvictSomeUnlocked(int64_t stop_after_index, int64_t bytes_to_evict) {
+int64_t LogCache::EvictSomeUnlocked(int64_t stop_after_index, int64_t bytes_to_evict) {
   DCHECK(lock_.is_locked());
   VLOG_WITH_PREFIX_UNLOCKED(2) << "Evicting log cache index <= "
                       << stop_after_index
@@ -416,6 +526,7 @@ void LogCache::EvictSomeUnlocked(int64_t stop_after_index, int64_t bytes_to_evic
     }
   }
   VLOG_WITH_PREFIX_UNLOCKED(1) << "Evicting log cache: after state: " << ToStringUnlocked();
+  return bytes_evicted;
 }
 
 void LogCache::AccountForMessageRemovalUnlocked(const CacheEntry& entry) {
@@ -503,7 +614,12 @@ void LogCache::DumpToHtml(std::ostream& out) const {
   x.Instantiate(metric_entity, 0)
 LogCache::Metrics::Metrics(const scoped_refptr<MetricEntity>& metric_entity)
   : log_cache_num_ops(INSTANTIATE_METRIC(METRIC_log_cache_num_ops)),
-    log_cache_size(INSTANTIATE_METRIC(METRIC_log_cache_size)) {
+    log_cache_size(INSTANTIATE_METRIC(METRIC_log_cache_size)),
+    log_cache_hits(METRIC_log_cache_hits.Instantiate(metric_entity)),
+    log_cache_misses_not_cached(METRIC_log_cache_misses_not_cached.Instantiate(metric_entity)),
+    log_cache_misses_replicated(METRIC_log_cache_misses_replicated.Instantiate(metric_entity)),
+    log_cache_misses_memory_pressure(
+        METRIC_log_cache_misses_memory_pressure.Instantiate(metric_entity)) {
 }
 #undef INSTANTIATE_METRIC
 
@@ -62,6 +62,7 @@ class LogReader;
 
 namespace consensus {
 
+class LogCacheRegistry;
 class ReplicateMsg;
 
 // Write-through cache for the log.
@@ -69,6 +70,12 @@ class ReplicateMsg;
 // This stores a set of log messages by their index. New operations can be appended to the end as
 // they are written to the log. Readers fetch entries that were explicitly appended, or they can
 // fetch older entries which are asynchronously fetched from the disk.
+//
+// The operations replicated to all peers are evicted right away, so the cache holds the operations
+// that some peer still needs. When the server-wide limit is exceeded, operations are evicted from
+// the caches of all tablets, starting with the cache whose oldest operation lags the most behind
+// the head of its log: those are only needed by the peers that lag the most, which are the least
+// likely to be served from the cache anyway.
 class LogCache {
  public:
   LogCache(const scoped_refptr<MetricEntity>& metric_entity,
@@ -153,7 +160,9 @@ class LogCache {
   FRIEND_TEST(LogCacheTest, TestAppendAndGetMessages);
   FRIEND_TEST(LogCacheTest, TestGlobalMemoryLimit);
   FRIEND_TEST(LogCacheTest, TestReplaceMessages);
+  FRIEND_TEST(LogCacheTest, TestEvictAcrossTablets);
   friend class LogCacheTest;
+  friend class LogCacheRegistry;
 
   // An entry in the cache.
   struct CacheEntry {
@@ -165,8 +174,26 @@ class LogCache {
 
   // Try to evict the oldest operations from the queue, stopping either when
   // 'bytes_to_evict' bytes have been evicted, or the op with index
-  // 'stop_after_index' has been evicted, whichever comes first.
-  void EvictSomeUnlocked(int64_t stop_after_index, int64_t bytes_to_evict);
+  // 'stop_after_index' has been evicted, whichever comes first. Returns the number of bytes
+  // evicted.
+  int64_t EvictSomeUnlocked(int64_t stop_after_index, int64_t bytes_to_evict);
+
+  // Number of operations between the oldest cached operation that could be evicted and the head of
+  // the log, 0 if there is no such operation. Used for choosing the caches to evict from when the
+  // server-wide limit is exceeded.
+  int64_t EvictionLag() const;
+
+  // Evict up to 'bytes_to_evict' bytes of the oldest unpinned operations to make room for the
+  // appends of any tablet. Returns the number of bytes evicted.
+  int64_t EvictForMemoryPressure(int64_t bytes_to_evict);
+
+  // Frees up 'bytes_needed' bytes of the server-wide limit if it would be exceeded, evicting from
+  // the caches of all the tablets sharing parent_tracker_. Must be called without lock_ held.
+  void EnsureGlobalSpareCapacity(int64_t bytes_needed);
+
+  // Accounts for the operations starting at 'first_index' that ReadOps read from the disk,
+  // attributed to why they were not in the cache.
+  void CountCacheMissesUnlocked(int64_t first_index, int64_t num_ops);
 
   // Update metrics and MemTracker to account for the removal of the
   // given message.
@@ -221,6 +248,14 @@ class LogCache {
   // log.  Protected by lock_.
   int64_t min_pinned_op_index_;
 
+  // The index of the first operation appended after Init: the operations before it were never in
+  // this cache.
+  int64_t first_cached_op_index_ = 0;
+
+  // The operations with an index up to this one were evicted once they were replicated to all the
+  // peers. Protected by lock_.
+  int64_t replicated_evicted_through_index_ = 0;
+
   // Pointer to a parent memtracker for all log caches. This exists to compute server-wide cache
   // size and enforce a server-wide memory limit.  When the first instance of a log cache is
   // created, a new entry is added to MemTracker's static map; subsequent entries merely increment
@@ -239,6 +274,13 @@ class LogCache {
 
     // Keeps track of the memory consumed by the cache, in bytes.
     scoped_refptr<AtomicGauge<int64_t> > log_cache_size;
+
+    // Operations read by ReadOps from the cache, and the ones it had to read from the disk, broken
+    // down by why they were not in the cache.
+    scoped_refptr<Counter> log_cache_hits;
+    scoped_refptr<Counter> log_cache_misses_not_cached;
+    scoped_refptr<Counter> log_cache_misses_replicated;
+    scoped_refptr<Counter> log_cache_misses_memory_pressure;
   };
   Metrics metrics_;
 
@@ -32,6 +32,9 @@
 
 #include "yb/consensus/log_index.h"
 
+#include <fcntl.h>
+#include <unistd.h>
+
 #include "yb/consensus/opid_util.h"
 #include "yb/fs/fs_manager.h"
 #include "yb/util/test_util.h"
@@ -126,7 +129,54 @@ TEST_F(LogIndexTest, TestMultiSegmentWithGC) {
   VerifyNotFound(1500000);
   VerifyNotFound(2500000);
 }
+
+TEST_F(LogIndexTest, TestLegacyChunkConversion) {
+  // Entry layout of the unversioned chunk files.
+  struct LegacyEntry {
+    int64_t term;
+    uint64_t segment_sequence_number;
+    uint64_t offset_in_segment;
+  } PACKED;
+  const std::string legacy_path = GetTestDataDirectory() + "/index.000000000";
+  {
+    int fd = open(legacy_path.c_str(), O_CREAT | O_RDWR, 0666);
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(0, ftruncate(fd, 1000000 * sizeof(LegacyEntry)));
+    LegacyEntry entry = {3, 2, 777};
+    ASSERT_EQ(static_cast<ssize_t>(sizeof(entry)),
+              pwrite(fd, &entry, sizeof(entry), 5 * sizeof(entry)));
+    close(fd);
+  }
+
+  // Opening the chunk for a new entry converts the legacy one.
+  ASSERT_OK(AddEntry(MakeOpId(3, 6), 2, 888));
+  VerifyEntry(MakeOpId(3, 5), 2, 777);
+  VerifyEntry(MakeOpId(3, 6), 2, 888);
+  VerifyNotFound(7);
+  ASSERT_FALSE(env_->FileExists(legacy_path));
+}
 #endif
 
+TEST_F(LogIndexTest, TestReader) {
+  ASSERT_OK(AddEntry(MakeOpId(1, 1), 1, 100));
+  ASSERT_OK(AddEntry(MakeOpId(1, 2), 1, 100));
+  ASSERT_OK(AddEntry(MakeOpId(2, 3), 2, 200));
+
+  LogIndex::Reader reader(index_.get());
+  for (int64_t index = 1; index <= 3; ++index) {
+    LogIndexEntry entry;
+    ASSERT_OK(reader.GetEntry(index, &entry));
+    ASSERT_EQ(index, entry.op_id.index());
+    ASSERT_EQ(index == 3 ? 2 : 1, entry.segment_sequence_number);
+  }
+  LogIndexEntry entry;
+  ASSERT_TRUE(reader.GetEntry(4, &entry).IsNotFound());
+}
+
+TEST_F(LogIndexTest, TestEntryOutOfRange) {
+  ASSERT_NOK(AddEntry(MakeOpId(1, 1), 1, 1LL << 32));
+  ASSERT_NOK(AddEntry(MakeOpId(1, 1), 1LL << 32, 100));
+}
+
 } // namespace log
 } // namespace yb
@@ -38,6 +38,13 @@
 // simple division operation. Because the entries are fixed size, we can compute the
 // index offset by a modulo.
 //
+// The chunks that are in use stay mapped, and the map from chunk number to chunk is the only
+// in-memory structure, so a lookup is a memory access into the mapping. LogIndex::Reader also
+// skips the map for consecutive lookups in the same chunk.
+//
+// The version of the entry layout is part of the chunk file name. Chunks in the previous layout
+// are converted when the chunk with the same number is opened.
+//
 // When the log is GCed, we remove any index chunks which are no longer needed, and
 // unmap them.
 
@@ -49,6 +56,7 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <limits>
 #include <mutex>
 #include <string>
 #include <vector>
@@ -73,12 +81,27 @@ namespace log {
 // This mirrors LogIndexEntry but uses simple primitives only so we can
 // read/write it via mmap.
 // See LogIndexEntry for docs.
+//
+// Segments are numbered sequentially and are much smaller than 4GB, so 32 bits are enough for the
+// segment sequence number and the offset. That keeps 256 entries in a page.
 struct PhysicalEntry {
+  int64_t term;
+  uint32_t segment_sequence_number;
+  uint32_t offset_in_segment;
+};
+
+static_assert(sizeof(PhysicalEntry) == 16, "Unexpected size of the log index entry");
+
+// The entry of the previous version of the chunk files, which had no version in their names.
+struct LegacyPhysicalEntry {
   int64_t term;
   uint64_t segment_sequence_number;
   uint64_t offset_in_segment;
 } PACKED;
 
+// Version of the entry layout, used in chunk file names.
+static const int kIndexFormatVersion = 2;
+
 // The number of index entries per index chunk.
 //
 // **** Note: This number cannot be changed after production!!!!! ***
@@ -101,6 +124,7 @@ static const int64_t kEntriesPerIndexChunk = 1000000;
 #endif
 
 static const int64_t kChunkFileSize = kEntriesPerIndexChunk * sizeof(PhysicalEntry);
+static const int64_t kLegacyChunkFileSize = kEntriesPerIndexChunk * sizeof(LegacyPhysicalEntry);
 
 ////////////////////////////////////////////////////////////
 // LogIndex::IndexChunk implementation
@@ -118,6 +142,9 @@ class LogIndex::IndexChunk : public RefCountedThreadSafe<LogIndex::IndexChunk> {
   void GetEntry(int entry_index, PhysicalEntry* ret);
   void SetEntry(int entry_index, const PhysicalEntry& entry);
 
+  // Copies the entries of the chunk file in the previous layout at the given path into this chunk.
+  Status ConvertLegacyChunk(const string& legacy_path);
+
  private:
   const string path_;
   int fd_;
@@ -179,6 +206,51 @@ void LogIndex::IndexChunk::SetEntry(int entry_index, const PhysicalEntry& phys)
   memcpy(mapping_ + sizeof(PhysicalEntry) * entry_index, &phys, sizeof(PhysicalEntry));
 }
 
+Status LogIndex::IndexChunk::ConvertLegacyChunk(const string& legacy_path) {
+  int fd;
+  RETRY_ON_EINTR(fd, open(legacy_path.c_str(), O_CLOEXEC | O_RDONLY));
+  RETURN_NOT_OK(CheckError(fd, "open"));
+
+  struct stat st;
+  int rc = fstat(fd, &st);
+  if (rc < 0 || st.st_size < kLegacyChunkFileSize) {
+    close(fd);
+    RETURN_NOT_OK(CheckError(rc, "fstat"));
+    return STATUS(Corruption, "Unexpected size of legacy index chunk", legacy_path);
+  }
+
+  void* legacy_mapping = mmap(nullptr, kLegacyChunkFileSize, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (legacy_mapping == MAP_FAILED) {
+    int err = errno;
+    return STATUS(IOError, "Unable to mmap()", ErrnoToString(err), err);
+  }
+
+  int converted = 0;
+  const auto* legacy_entries = static_cast<const LegacyPhysicalEntry*>(legacy_mapping);
+  for (int i = 0; i != kEntriesPerIndexChunk; ++i) {
+    LegacyPhysicalEntry legacy;
+    memcpy(&legacy, legacy_entries + i, sizeof(legacy));
+    // Entries that do not fit the new layout are dropped, so they are reported as not found.
+    if (legacy.offset_in_segment == 0 ||
+        legacy.segment_sequence_number > std::numeric_limits<uint32_t>::max() ||
+        legacy.offset_in_segment > std::numeric_limits<uint32_t>::max()) {
+      continue;
+    }
+    PhysicalEntry phys;
+    phys.term = legacy.term;
+    phys.segment_sequence_number = static_cast<uint32_t>(legacy.segment_sequence_number);
+    phys.offset_in_segment = static_cast<uint32_t>(legacy.offset_in_segment);
+    SetEntry(i, phys);
+    ++converted;
+  }
+  munmap(legacy_mapping, kLegacyChunkFileSize);
+
+  LOG(INFO) << "Converted " << converted << " entries of legacy log index chunk " << legacy_path
+            << " to " << path_;
+  return Status::OK();
+}
+
 ////////////////////////////////////////////////////////////
 // LogIndex
 ////////////////////////////////////////////////////////////
@@ -189,6 +261,11 @@ LogIndex::~LogIndex() {
 }
 
 string LogIndex::GetChunkPath(int64_t chunk_idx) {
+  return StringPrintf("%s/index.v%d.%09" PRId64, base_dir_.c_str(), kIndexFormatVersion,
+                      chunk_idx);
+}
+
+string LogIndex::GetLegacyChunkPath(int64_t chunk_idx) {
   return StringPrintf("%s/index.%09" PRId64, base_dir_.c_str(), chunk_idx);
 }
 
@@ -197,6 +274,19 @@ Status LogIndex::OpenChunk(int64_t chunk_idx, scoped_refptr<IndexChunk>* chunk)
 
   scoped_refptr<IndexChunk> new_chunk(new IndexChunk(path));
   RETURN_NOT_OK(new_chunk->Open());
+
+  // The legacy chunk is removed right after the conversion, so it is converted before anything
+  // else is written to the new chunk. The index is not durable anyway, so entries that could not
+  // be converted are just lost.
+  string legacy_path = GetLegacyChunkPath(chunk_idx);
+  if (access(legacy_path.c_str(), F_OK) == 0) {
+    Status s = new_chunk->ConvertLegacyChunk(legacy_path);
+    WARN_NOT_OK(s, Substitute("Unable to convert legacy index chunk $0", legacy_path));
+    if (unlink(legacy_path.c_str()) != 0) {
+      PLOG(WARNING) << "Unable to delete legacy index chunk " << legacy_path;
+    }
+  }
+
   chunk->swap(new_chunk);
   return Status::OK();
 }
@@ -241,10 +331,17 @@ Status LogIndex::AddEntry(const LogIndexEntry& entry) {
                                  &chunk));
   int index_in_chunk = entry.op_id.index() % kEntriesPerIndexChunk;
 
+  if (PREDICT_FALSE(entry.segment_sequence_number < 0 ||
+                    entry.segment_sequence_number > std::numeric_limits<uint32_t>::max() ||
+                    entry.offset_in_segment < 0 ||
+                    entry.offset_in_segment > std::numeric_limits<uint32_t>::max())) {
+    return STATUS(InvalidArgument, "Log index entry out of range", entry.ToString());
+  }
+
   PhysicalEntry phys;
   phys.term = entry.op_id.term();
-  phys.segment_sequence_number = entry.segment_sequence_number;
-  phys.offset_in_segment = entry.offset_in_segment;
+  phys.segment_sequence_number = static_cast<uint32_t>(entry.segment_sequence_number);
+  phys.offset_in_segment = static_cast<uint32_t>(entry.offset_in_segment);
 
   chunk->SetEntry(index_in_chunk, phys);
   VLOG(3) << "Added log index entry " << entry.ToString();
@@ -255,6 +352,10 @@ Status LogIndex::AddEntry(const LogIndexEntry& entry) {
 Status LogIndex::GetEntry(int64_t index, LogIndexEntry* entry) {
   scoped_refptr<IndexChunk> chunk;
   RETURN_NOT_OK(GetChunkForIndex(index, false /* do not create */, &chunk));
+  return GetEntryFromChunk(chunk.get(), index, entry);
+}
+
+Status LogIndex::GetEntryFromChunk(IndexChunk* chunk, int64_t index, LogIndexEntry* entry) {
   int index_in_chunk = index % kEntriesPerIndexChunk;
   PhysicalEntry phys;
   chunk->GetEntry(index_in_chunk, &phys);
@@ -272,6 +373,21 @@ Status LogIndex::GetEntry(int64_t index, LogIndexEntry* entry) {
   return Status::OK();
 }
 
+LogIndex::Reader::Reader(LogIndex* index) : index_(index) {}
+
+LogIndex::Reader::~Reader() {}
+
+Status LogIndex::Reader::GetEntry(int64_t index, LogIndexEntry* entry) {
+  CHECK_GT(index, 0);
+  int64_t chunk_idx = index / kEntriesPerIndexChunk;
+  if (!chunk_ || chunk_idx != chunk_idx_) {
+    chunk_.reset();
+    RETURN_NOT_OK(index_->GetChunkForIndex(index, false /* do not create */, &chunk_));
+    chunk_idx_ = chunk_idx;
+  }
+  return index_->GetEntryFromChunk(chunk_.get(), index, entry);
+}
+
 void LogIndex::GC(int64_t min_index_to_retain) {
   int min_chunk_to_retain = min_index_to_retain / kEntriesPerIndexChunk;
 
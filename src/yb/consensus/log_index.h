@@ -89,12 +89,33 @@ class LogIndex : public RefCountedThreadSafe<LogIndex> {
   // earlier entries.
   void GC(int64_t min_index_to_retain);
 
+ private:
+  class IndexChunk;
+
+ public:
+  // Looks up entries for a range of operations, e.g. to serve a lagging follower. Keeps a
+  // reference to the index chunk of the previous lookup, so consecutive lookups in the same chunk
+  // don't go through the chunk map and its lock. Not thread-safe, the index has to outlive it.
+  class Reader {
+   public:
+    explicit Reader(LogIndex* index);
+    ~Reader();
+
+    // Same as LogIndex::GetEntry.
+    CHECKED_STATUS GetEntry(int64_t index, LogIndexEntry* entry);
+
+   private:
+    LogIndex* const index_;
+    int64_t chunk_idx_ = -1;
+    scoped_refptr<IndexChunk> chunk_;
+
+    DISALLOW_COPY_AND_ASSIGN(Reader);
+  };
+
  private:
   friend class RefCountedThreadSafe<LogIndex>;
   ~LogIndex();
 
-  class IndexChunk;
-
   // Open the on-disk chunk with the given index.
   // Note: 'chunk_idx' is the index of the index chunk, not the index of a log _entry_.
   CHECKED_STATUS OpenChunk(int64_t chunk_idx, scoped_refptr<IndexChunk>* chunk);
@@ -105,9 +126,15 @@ class LogIndex : public RefCountedThreadSafe<LogIndex> {
   CHECKED_STATUS GetChunkForIndex(int64_t log_index, bool create,
                           scoped_refptr<IndexChunk>* chunk);
 
+  // Read the entry for the given log index from the chunk that contains it.
+  static CHECKED_STATUS GetEntryFromChunk(IndexChunk* chunk, int64_t index, LogIndexEntry* entry);
+
   // Return the path of the given index chunk.
   std::string GetChunkPath(int64_t chunk_idx);
 
+  // Return the path of the given index chunk in the previous, unversioned, format.
+  std::string GetLegacyChunkPath(int64_t chunk_idx);
+
   // The base directory where index files are located.
   const std::string base_dir_;
 
@@ -314,7 +314,8 @@ Status LogReader::ReadBatchUsingIndexEntry(const LogIndexEntry& index_entry,
                                    index_entry.offset_in_segment));
 
   if (bytes_read_) {
-    bytes_read_->IncrementBy(kEntryHeaderSize + tmp_buf->length());
+    // The entry is not copied into tmp_buf when the segment is mapped.
+    bytes_read_->IncrementBy(offset - index_entry.offset_in_segment);
     entries_read_->IncrementBy(batch->entry_size());
   }
 
@@ -337,9 +338,10 @@ Status LogReader::ReadReplicatesInRange(
   bool limit_exceeded = false;
   faststring tmp_buf;
   LogEntryBatchPB batch;
+  LogIndex::Reader index_reader(log_index_.get());
   for (int index = starting_at; index <= up_to && !limit_exceeded; index++) {
     LogIndexEntry index_entry;
-    RETURN_NOT_OK_PREPEND(log_index_->GetEntry(index, &index_entry),
+    RETURN_NOT_OK_PREPEND(index_reader.GetEntry(index, &index_entry),
                           Substitute("Failed to read log index for op $0", index));
 
     // Since a given LogEntryBatch may contain multiple REPLICATE messages,
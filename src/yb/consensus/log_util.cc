@@ -32,6 +32,10 @@
 
 #include "yb/consensus/log_util.h"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
 #include <algorithm>
 #include <iostream>
 #include <limits>
@@ -39,6 +43,7 @@
 
 #include <gflags/gflags.h>
 #include <glog/logging.h>
+#include <lz4.h>
 
 #include "yb/consensus/opid_util.h"
 #include "yb/fs/fs_manager.h"
@@ -53,6 +58,7 @@
 #include "yb/util/crc.h"
 #include "yb/util/debug/trace_event.h"
 #include "yb/util/env_util.h"
+#include "yb/util/errno.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/pb_util.h"
 #include "yb/util/size_literals.h"
@@ -95,6 +101,12 @@ DEFINE_bool(require_durable_wal_write, false, "Whether durable WAL write is requ
     "the system will soft downgrade the durable_wal_write flag.");
 TAG_FLAG(require_durable_wal_write, stable);
 
+DEFINE_bool(log_mmap_closed_segments, true,
+            "Map closed log segments into memory when reading their entries, instead of copying "
+            "each entry from the file into a buffer. Speeds up catching up lagging followers "
+            "from the disk.");
+TAG_FLAG(log_mmap_closed_segments, advanced);
+
 namespace yb {
 namespace log {
 
@@ -106,6 +118,46 @@ using strings::SubstituteAndAppend;
 
 const char kTmpSuffix[] = ".tmp";
 
+namespace {
+
+// A compressed entry batch is the varint32 encoded size of the uncompressed batch, followed by
+// the LZ4 block.
+Status CompressEntryBatch(const Slice& data, faststring* out) {
+  const int bound = LZ4_compressBound(data.size());
+  if (bound <= 0) {
+    return STATUS_FORMAT(InvalidArgument, "Entry batch too large to compress: $0", data.size());
+  }
+  out->clear();
+  PutVarint32(out, data.size());
+  const size_t prefix_size = out->size();
+  out->resize(prefix_size + bound);
+  const int size = LZ4_compress_default(
+      data.cdata(), reinterpret_cast<char*>(out->data() + prefix_size), data.size(), bound);
+  if (size <= 0) {
+    return STATUS_FORMAT(RuntimeError, "Failed to compress $0-byte entry batch", data.size());
+  }
+  out->resize(prefix_size + size);
+  return Status::OK();
+}
+
+Status UncompressEntryBatch(const Slice& data, faststring* out) {
+  Slice input = data;
+  uint32_t size = 0;
+  if (!GetVarint32(&input, &size)) {
+    return STATUS(Corruption, "Could not read uncompressed size of entry batch");
+  }
+  out->resize(size);
+  const int result = LZ4_decompress_safe(
+      input.cdata(), reinterpret_cast<char*>(out->data()), input.size(), size);
+  if (result < 0 || static_cast<uint32_t>(result) != size) {
+    return STATUS_FORMAT(Corruption, "Could not uncompress entry batch of $0 bytes into $1 bytes",
+                         input.size(), size);
+  }
+  return Status::OK();
+}
+
+} // namespace
+
 const char kLogSegmentHeaderMagicString[] = "yugalogf";
 
 // A magic that is written as the very last thing when a segment is closed.
@@ -161,6 +213,46 @@ ReadableLogSegment::ReadableLogSegment(
       is_initialized_(false),
       footer_was_rebuilt_(false) {}
 
+ReadableLogSegment::~ReadableLogSegment() {
+  auto* mapping = mapping_.load(std::memory_order_acquire);
+  if (mapping) {
+    munmap(const_cast<uint8_t*>(mapping), mapping_size_);
+  }
+}
+
+Slice ReadableLogSegment::MappedData() {
+  auto* mapping = mapping_.load(std::memory_order_acquire);
+  if (mapping) {
+    return Slice(mapping, mapping_size_);
+  }
+  if (!FLAGS_log_mmap_closed_segments || !IsInitialized() || !HasFooter()) {
+    return Slice();
+  }
+
+  std::lock_guard<std::mutex> lock(mapping_mutex_);
+  mapping = mapping_.load(std::memory_order_acquire);
+  if (mapping || mapping_failed_) {
+    return mapping ? Slice(mapping, mapping_size_) : Slice();
+  }
+  const size_t size = file_size();
+  int fd = open(path_.c_str(), O_CLOEXEC | O_RDONLY);
+  void* data = fd >= 0 && size > 0 ? mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0)
+                                   : MAP_FAILED;
+  int err = errno;
+  if (fd >= 0) {
+    close(fd);
+  }
+  if (data == MAP_FAILED) {
+    // Reads fall back to the file.
+    LOG(WARNING) << "Unable to mmap() " << path_ << ": " << ErrnoToString(err);
+    mapping_failed_ = true;
+    return Slice();
+  }
+  mapping_size_ = size;
+  mapping_.store(static_cast<const uint8_t*>(data), std::memory_order_release);
+  return Slice(static_cast<const uint8_t*>(data), size);
+}
+
 Status ReadableLogSegment::Init(const LogSegmentHeaderPB& header,
                                 const LogSegmentFooterPB& footer,
                                 int64_t first_entry_offset) {
@@ -650,9 +742,18 @@ Status ReadableLogSegment::ReadEntryHeaderAndBatch(int64_t* offset, faststring*
 Status ReadableLogSegment::ReadEntryHeader(int64_t *offset, EntryHeader* header) {
   uint8_t scratch[kEntryHeaderSize];
   Slice slice;
-  RETURN_NOT_OK_PREPEND(ReadFully(readable_file().get(), *offset, kEntryHeaderSize,
-                                  &slice, scratch),
-                        "Could not read log entry header");
+  Slice mapped = MappedData();
+  if (!mapped.empty()) {
+    if (PREDICT_FALSE(*offset + kEntryHeaderSize > mapped.size())) {
+      return STATUS_FORMAT(Corruption, "Could not read log entry header at offset $0 of $1-byte "
+                                       "segment $2", *offset, mapped.size(), path_);
+    }
+    slice = Slice(mapped.data() + *offset, kEntryHeaderSize);
+  } else {
+    RETURN_NOT_OK_PREPEND(ReadFully(readable_file().get(), *offset, kEntryHeaderSize,
+                                    &slice, scratch),
+                          "Could not read log entry header");
+  }
 
   RETURN_NOT_OK(DecodeEntryHeader(slice, header));
   *offset += slice.size();
@@ -697,17 +798,23 @@ Status ReadableLogSegment::ReadEntryBatch(int64_t *offset,
                    header.msg_length, *offset, path_, limit));
   }
 
-  tmp_buf->clear();
-  tmp_buf->resize(header.msg_length);
   Slice entry_batch_slice;
-
-  Status s =  readable_file()->Read(*offset,
-                                    header.msg_length,
-                                    &entry_batch_slice,
-                                    tmp_buf->data());
-
-  if (!s.ok()) return STATUS(IOError, Substitute("Could not read entry. Cause: $0",
-                                                 s.ToString()));
+  Status s;
+  Slice mapped = MappedData();
+  if (!mapped.empty() && header.msg_length + *offset <= mapped.size()) {
+    // Decoded right from the mapping, without copying the entry.
+    entry_batch_slice = Slice(mapped.data() + *offset, header.msg_length);
+  } else {
+    tmp_buf->clear();
+    tmp_buf->resize(header.msg_length);
+    s = readable_file()->Read(*offset,
+                              header.msg_length,
+                              &entry_batch_slice,
+                              tmp_buf->data());
+
+    if (!s.ok()) return STATUS(IOError, Substitute("Could not read entry. Cause: $0",
+                                                   s.ToString()));
+  }
 
   // Verify the CRC.
   uint32_t read_crc = crc::Crc32c(entry_batch_slice.data(), entry_batch_slice.size());
@@ -719,10 +826,18 @@ Status ReadableLogSegment::ReadEntryBatch(int64_t *offset,
   }
 
 
+  Slice batch_data = entry_batch_slice;
+  faststring uncompressed;
+  if (header_.compression() == LZ4_COMPRESSION) {
+    RETURN_NOT_OK_PREPEND(UncompressEntryBatch(entry_batch_slice, &uncompressed),
+                          Format("Could not read entry at offset $0 in $1", *offset, path_));
+    batch_data = Slice(uncompressed);
+  }
+
   LogEntryBatchPB read_entry_batch;
   s = pb_util::ParseFromArray(&read_entry_batch,
-                              entry_batch_slice.data(),
-                              header.msg_length);
+                              batch_data.data(),
+                              batch_data.size());
 
   if (!s.ok()) return STATUS(Corruption, Substitute("Could parse PB. Cause: $0",
                                                     s.ToString()));
@@ -793,11 +908,19 @@ Status WritableLogSegment::WriteFooterAndClose(const LogSegmentFooterPB& footer)
 }
 
 
-Status WritableLogSegment::WriteEntryBatch(const Slice& data) {
+Status WritableLogSegment::WriteEntryBatch(const Slice& entry_batch_data) {
   DCHECK(is_header_written_);
   DCHECK(!is_footer_written_);
   uint8_t header_buf[kEntryHeaderSize];
 
+  // The length and CRC in the entry header are those of the data actually written, so that
+  // scanning for valid entries does not depend on the compression.
+  Slice data = entry_batch_data;
+  if (header_.compression() == LZ4_COMPRESSION) {
+    RETURN_NOT_OK(CompressEntryBatch(entry_batch_data, &compression_buffer_));
+    data = Slice(compression_buffer_);
+  }
+
   // First encode the length of the message.
   uint32_t len = data.size();
   InlineEncodeFixed32(&header_buf[0], len);
@@ -33,9 +33,11 @@
 #ifndef YB_CONSENSUS_LOG_UTIL_H_
 #define YB_CONSENSUS_LOG_UTIL_H_
 
+#include <atomic>
 #include <iosfwd>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <utility>
 #include <vector>
@@ -48,6 +50,7 @@
 #include "yb/gutil/ref_counted.h"
 #include "yb/util/atomic.h"
 #include "yb/util/env.h"
+#include "yb/util/faststring.h"
 #include "yb/util/monotime.h"
 #include "yb/util/opid.h"
 #include "yb/util/restart_safe_clock.h"
@@ -231,6 +234,7 @@ class ReadableLogSegment : public RefCountedThreadSafe<ReadableLogSegment> {
   friend class RefCountedThreadSafe<ReadableLogSegment>;
   friend class LogReader;
   FRIEND_TEST(LogTest, TestWriteAndReadToAndFromInProgressSegment);
+  FRIEND_TEST(LogTest, TestReadFromMappedSegment);
 
   struct EntryHeader {
     // The length of the batch data.
@@ -243,7 +247,12 @@ class ReadableLogSegment : public RefCountedThreadSafe<ReadableLogSegment> {
     uint32_t header_crc;
   };
 
-  ~ReadableLogSegment() {}
+  ~ReadableLogSegment();
+
+  // Returns the contents of the segment mapped into memory, mapping them on the first call, or an
+  // empty slice if the segment is not mapped. Only closed segments are mapped, since they no
+  // longer change, see --log_mmap_closed_segments.
+  Slice MappedData();
 
   // Helper functions called by Init().
 
@@ -329,6 +338,12 @@ class ReadableLogSegment : public RefCountedThreadSafe<ReadableLogSegment> {
   // the offset of the first entry in the log
   int64_t first_entry_offset_;
 
+  // The mapping returned by MappedData(), set once. mapping_mutex_ serializes creating it.
+  std::mutex mapping_mutex_;
+  std::atomic<const uint8_t*> mapping_{nullptr};
+  size_t mapping_size_ = 0;
+  bool mapping_failed_ = false;
+
   DISALLOW_COPY_AND_ASSIGN(ReadableLogSegment);
 };
 
@@ -354,7 +369,7 @@ class WritableLogSegment {
   }
 
   // Appends the provided batch of data, including a header
-  // and checksum.
+  // and checksum. The data is compressed first if the segment header asks for it.
   // Makes sure that the log segment has not been closed.
   CHECKED_STATUS WriteEntryBatch(const Slice& entry_batch_data);
 
@@ -421,6 +436,9 @@ class WritableLogSegment {
   // The offset where the last written entry ends.
   int64_t written_offset_;
 
+  // Holds the compressed form of the entry batch being written.
+  faststring compression_buffer_;
+
   DISALLOW_COPY_AND_ASSIGN(WritableLogSegment);
 };
 
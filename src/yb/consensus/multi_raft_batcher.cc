@@ -0,0 +1,188 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/consensus/multi_raft_batcher.h"
+
+#include <algorithm>
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include "yb/rpc/messenger.h"
+#include "yb/rpc/rpc_header.pb.h"
+
+#include "yb/util/flag_tags.h"
+#include "yb/util/monotime.h"
+
+DEFINE_bool(enable_multi_raft_heartbeat_batching, false,
+            "Send the heartbeats of all tablets led by this server to the same follower server "
+            "in a single RPC.");
+TAG_FLAG(enable_multi_raft_heartbeat_batching, advanced);
+TAG_FLAG(enable_multi_raft_heartbeat_batching, runtime);
+
+DEFINE_int32(multi_raft_heartbeat_batch_window_ms, 5,
+             "How long to wait for heartbeats of other tablets before sending a batch.");
+TAG_FLAG(multi_raft_heartbeat_batch_window_ms, advanced);
+
+DEFINE_int32(multi_raft_heartbeat_batch_max_requests, 256,
+             "Number of heartbeats after which a batch is sent without waiting for the window "
+             "to end.");
+TAG_FLAG(multi_raft_heartbeat_batch_max_requests, advanced);
+
+DECLARE_int32(consensus_rpc_timeout_ms);
+
+using namespace std::placeholders;
+
+namespace yb {
+namespace consensus {
+
+MultiRaftHeartbeatBatcher::MultiRaftHeartbeatBatcher(const HostPort& hostport,
+                                                     rpc::ProxyCache* proxy_cache,
+                                                     std::shared_ptr<rpc::Messenger> messenger)
+    : hostport_(hostport), proxy_(proxy_cache, hostport), messenger_(std::move(messenger)) {
+}
+
+MultiRaftHeartbeatBatcher::~MultiRaftHeartbeatBatcher() {
+}
+
+bool MultiRaftHeartbeatBatcher::Add(const ConsensusRequestPB* request,
+                                    ConsensusResponsePB* response,
+                                    rpc::RpcController* controller,
+                                    const rpc::ResponseCallback& callback) {
+  if (!FLAGS_enable_multi_raft_heartbeat_batching ||
+      unsupported_.load(std::memory_order_acquire)) {
+    return false;
+  }
+
+  BatchPtr full_batch;
+  bool schedule_flush = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!pending_) {
+      pending_ = std::make_shared<Batch>();
+      schedule_flush = true;
+    }
+    pending_->entries.push_back(Entry{request, response, controller, callback});
+    pending_->request.add_requests()->CopyFrom(*request);
+    if (pending_->entries.size() >=
+            static_cast<size_t>(std::max(FLAGS_multi_raft_heartbeat_batch_max_requests, 1))) {
+      full_batch = std::move(pending_);
+      pending_ = nullptr;
+    }
+  }
+
+  if (full_batch) {
+    Send(full_batch);
+    return true;
+  }
+
+  if (schedule_flush) {
+    auto task_id = messenger_->ScheduleOnReactor(
+        std::bind(&MultiRaftHeartbeatBatcher::FlushScheduled, shared_from_this(), _1),
+        MonoDelta::FromMilliseconds(FLAGS_multi_raft_heartbeat_batch_window_ms),
+        SOURCE_LOCATION(), messenger_);
+    if (task_id == rpc::kInvalidTaskId) {
+      FlushScheduled(STATUS(Aborted, "Failed to schedule heartbeat batch flush"));
+    }
+  }
+  return true;
+}
+
+void MultiRaftHeartbeatBatcher::FlushScheduled(const Status& status) {
+  BatchPtr batch;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    batch = std::move(pending_);
+    pending_ = nullptr;
+  }
+  if (!batch) {
+    // Already sent because it got full.
+    return;
+  }
+
+  if (!status.ok()) {
+    // The messenger is shutting down, so let each request fail on its own.
+    SendSeparately(batch);
+    return;
+  }
+  Send(batch);
+}
+
+void MultiRaftHeartbeatBatcher::Send(const BatchPtr& batch) {
+  VLOG(4) << "Sending " << batch->entries.size() << " heartbeats to " << hostport_;
+  batch->controller.set_timeout(MonoDelta::FromMilliseconds(FLAGS_consensus_rpc_timeout_ms));
+  batch->controller.set_priority(rpc::RPC_PRIORITY_HIGH);
+  proxy_.MultiUpdateConsensusAsync(
+      batch->request, &batch->response, &batch->controller,
+      std::bind(&MultiRaftHeartbeatBatcher::ProcessResponse, shared_from_this(), batch));
+}
+
+void MultiRaftHeartbeatBatcher::ProcessResponse(const BatchPtr& batch) {
+  const Status& status = batch->controller.status();
+  if (!status.ok()) {
+    const auto* error = batch->controller.error_response();
+    if (status.IsRemoteError() && error &&
+        (error->code() == rpc::ErrorStatusPB::ERROR_NO_SUCH_METHOD ||
+         error->code() == rpc::ErrorStatusPB::ERROR_NO_SUCH_SERVICE)) {
+      LOG(INFO) << hostport_ << " does not support batched heartbeats: " << status;
+      unsupported_.store(true, std::memory_order_release);
+    } else {
+      VLOG(1) << "Failed to send " << batch->entries.size() << " heartbeats to " << hostport_
+              << ": " << status;
+    }
+    SendSeparately(batch);
+    return;
+  }
+
+  if (static_cast<size_t>(batch->response.responses_size()) != batch->entries.size()) {
+    LOG(DFATAL) << "Got " << batch->response.responses_size() << " responses to "
+                << batch->entries.size() << " heartbeats from " << hostport_;
+    SendSeparately(batch);
+    return;
+  }
+
+  for (size_t i = 0; i != batch->entries.size(); ++i) {
+    auto& entry = batch->entries[i];
+    entry.response->Swap(batch->response.mutable_responses(i));
+    entry.callback();
+  }
+}
+
+void MultiRaftHeartbeatBatcher::SendSeparately(const BatchPtr& batch) {
+  for (auto& entry : batch->entries) {
+    entry.controller->set_timeout(MonoDelta::FromMilliseconds(FLAGS_consensus_rpc_timeout_ms));
+    proxy_.UpdateConsensusAsync(*entry.request, entry.response, entry.controller, entry.callback);
+  }
+}
+
+MultiRaftManager::MultiRaftManager(std::shared_ptr<rpc::Messenger> messenger,
+                                   rpc::ProxyCache* proxy_cache)
+    : messenger_(std::move(messenger)), proxy_cache_(proxy_cache) {
+}
+
+MultiRaftManager::~MultiRaftManager() {
+}
+
+MultiRaftHeartbeatBatcherPtr MultiRaftManager::GetBatcher(const HostPort& hostport) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = batchers_.find(hostport);
+  if (it == batchers_.end()) {
+    it = batchers_.emplace(
+        hostport,
+        std::make_shared<MultiRaftHeartbeatBatcher>(hostport, proxy_cache_, messenger_)).first;
+  }
+  return it->second;
+}
+
+} // namespace consensus
+} // namespace yb
@@ -0,0 +1,116 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_CONSENSUS_MULTI_RAFT_BATCHER_H
+#define YB_CONSENSUS_MULTI_RAFT_BATCHER_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "yb/consensus/consensus_fwd.h"
+#include "yb/consensus/consensus.pb.h"
+#include "yb/consensus/consensus.proxy.h"
+
+#include "yb/rpc/rpc_controller.h"
+
+#include "yb/util/net/net_util.h"
+
+namespace yb {
+
+namespace rpc {
+class Messenger;
+class ProxyCache;
+} // namespace rpc
+
+namespace consensus {
+
+// Coalesces the heartbeats that the leaders on this tablet server send to the followers on one
+// other tablet server into a single MultiUpdateConsensus RPC. With many tablets per server, most
+// of them idle, the per tablet heartbeats otherwise dominate the RPC traffic between servers.
+//
+// Only requests without operations are batched, so a slow append on one tablet never delays the
+// heartbeats of the others. If the batch RPC fails, each request is resent on its own, using the
+// controller of its caller, so that the caller sees the same errors as without batching.
+class MultiRaftHeartbeatBatcher : public std::enable_shared_from_this<MultiRaftHeartbeatBatcher> {
+ public:
+  MultiRaftHeartbeatBatcher(const HostPort& hostport,
+                            rpc::ProxyCache* proxy_cache,
+                            std::shared_ptr<rpc::Messenger> messenger);
+
+  ~MultiRaftHeartbeatBatcher();
+
+  // Adds the request to the current batch. The callback is invoked once the response is filled,
+  // as with ConsensusServiceProxy::UpdateConsensusAsync. Returns false, without taking ownership
+  // of anything, if the request is not batched, in which case the caller should send it itself.
+  bool Add(const ConsensusRequestPB* request,
+           ConsensusResponsePB* response,
+           rpc::RpcController* controller,
+           const rpc::ResponseCallback& callback);
+
+ private:
+  struct Entry {
+    const ConsensusRequestPB* request;
+    ConsensusResponsePB* response;
+    rpc::RpcController* controller;
+    rpc::ResponseCallback callback;
+  };
+
+  struct Batch {
+    std::vector<Entry> entries;
+    MultiConsensusRequestPB request;
+    MultiConsensusResponsePB response;
+    rpc::RpcController controller;
+  };
+
+  typedef std::shared_ptr<Batch> BatchPtr;
+
+  void FlushScheduled(const Status& status);
+  void Send(const BatchPtr& batch);
+  void ProcessResponse(const BatchPtr& batch);
+  void SendSeparately(const BatchPtr& batch);
+
+  const HostPort hostport_;
+  ConsensusServiceProxy proxy_;
+  const std::shared_ptr<rpc::Messenger> messenger_;
+
+  // Set once the destination is found to not support MultiUpdateConsensus.
+  std::atomic<bool> unsupported_{false};
+
+  std::mutex mutex_;
+  BatchPtr pending_;
+};
+
+// Owns the heartbeat batchers of a tablet server, one per destination server.
+class MultiRaftManager {
+ public:
+  MultiRaftManager(std::shared_ptr<rpc::Messenger> messenger, rpc::ProxyCache* proxy_cache);
+
+  ~MultiRaftManager();
+
+  MultiRaftHeartbeatBatcherPtr GetBatcher(const HostPort& hostport);
+
+ private:
+  const std::shared_ptr<rpc::Messenger> messenger_;
+  rpc::ProxyCache* const proxy_cache_;
+
+  std::mutex mutex_;
+  std::unordered_map<HostPort, MultiRaftHeartbeatBatcherPtr, HostPortHash> batchers_;
+};
+
+} // namespace consensus
+} // namespace yb
+
+#endif // YB_CONSENSUS_MULTI_RAFT_BATCHER_H
@@ -228,6 +228,7 @@ class RaftConsensusTest : public YBTest {
                        0, // schema_version
                        nullptr, // metric_entity
                        append_pool_.get(),
+                       nullptr /* allocation_thread_pool */,
                        &log_));
 
     log_->TEST_SetAllOpIdsSafe(true);
@@ -69,6 +69,7 @@
 #include "yb/util/tostring.h"
 #include "yb/util/trace.h"
 #include "yb/util/url-coding.h"
+#include "yb/util/wait_state.h"
 #include "yb/util/format.h"
 #include "yb/util/tsan_util.h"
 
@@ -125,6 +126,19 @@ DEFINE_int32(after_stepdown_delay_election_multiplier, 5,
 TAG_FLAG(after_stepdown_delay_election_multiplier, advanced);
 TAG_FLAG(after_stepdown_delay_election_multiplier, hidden);
 
+DEFINE_bool(use_preelection, true,
+            "Whether a peer that detected a leader failure first checks that it would win the "
+            "election, without incrementing its term, before actually starting it. This keeps a "
+            "partitioned peer from forcing a healthy leader to step down when it rejoins.");
+TAG_FLAG(use_preelection, advanced);
+TAG_FLAG(use_preelection, runtime);
+
+DEFINE_bool(transfer_leader_lease_on_stepdown, true,
+            "Whether a leader that steps down in favor of another peer hands its lease over to "
+            "it, so the new leader doesn't have to wait until the lease of the old one expires.");
+TAG_FLAG(transfer_leader_lease_on_stepdown, advanced);
+TAG_FLAG(transfer_leader_lease_on_stepdown, runtime);
+
 DECLARE_int32(memory_limit_warn_threshold_percentage);
 
 DEFINE_test_flag(int32, inject_delay_leader_change_role_append_secs, 0,
@@ -205,9 +219,10 @@ shared_ptr<RaftConsensus> RaftConsensus::Create(
     const Callback<void(std::shared_ptr<StateChangeContext> context)> mark_dirty_clbk,
     TableType table_type,
     ThreadPool* raft_pool,
-    RetryableRequests* retryable_requests) {
+    RetryableRequests* retryable_requests,
+    MultiRaftManager* multi_raft_manager) {
   gscoped_ptr<PeerProxyFactory> rpc_factory(new RpcPeerProxyFactory(
-      messenger, proxy_cache, local_peer_pb.cloud_info()));
+      messenger, proxy_cache, local_peer_pb.cloud_info(), multi_raft_manager));
 
   // The message queue that keeps track of which operations need to be replicated
   // where.
@@ -409,6 +424,18 @@ Status RaftConsensus::DoStartElection(
     const OpId& must_be_committed_opid,
     const std::string& originator_uuid,
     TEST_SuppressVoteRequest suppress_vote_request) {
+  return StartElectionImpl(
+      mode, PreElected::kFalse, pending_commit, must_be_committed_opid, originator_uuid,
+      suppress_vote_request);
+}
+
+Status RaftConsensus::StartElectionImpl(
+    ElectionMode mode,
+    PreElected pre_elected,
+    const bool pending_commit,
+    const OpId& must_be_committed_opid,
+    const std::string& originator_uuid,
+    TEST_SuppressVoteRequest suppress_vote_request) {
   TRACE_EVENT2("consensus", "RaftConsensus::StartElection",
                "peer", peer_uuid(),
                "tablet", tablet_id());
@@ -461,7 +488,44 @@ Status RaftConsensus::DoStartElection(
       start_now = state_->HasOpIdCommittedUnlocked(required_id);
     }
 
-    if (start_now) {
+    // Only a peer that thinks the leader has failed has to check that it could win the election.
+    // The other elections are started on behalf of a live leader, or after a pre-election.
+    const bool preelection = start_now && mode == NORMAL_ELECTION && !pre_elected &&
+                             FLAGS_use_preelection;
+    if (preelection) {
+      LOG_WITH_PREFIX(INFO) << "Triggering pre-election for term "
+                            << state_->GetCurrentTermUnlocked() + 1;
+
+      // Don't trigger another election while the pre-election runs.
+      MonoDelta timeout = LeaderElectionExpBackoffDeltaUnlocked();
+      SnoozeFailureDetector(ALLOW_LOGGING, timeout);
+
+      const RaftConfigPB& active_config = state_->GetActiveConfigUnlocked();
+      int num_voters = CountVoters(active_config);
+      auto counter = std::make_unique<VoteCounter>(num_voters, MajoritySize(num_voters));
+
+      // Our own vote is not persisted, we don't promise anything by a pre-election.
+      bool duplicate;
+      RETURN_NOT_OK(counter->RegisterVote(state_->GetPeerUuid(), VOTE_GRANTED, &duplicate));
+
+      VoteRequestPB request;
+      request.set_preelection(true);
+      request.set_candidate_uuid(state_->GetPeerUuid());
+      request.set_candidate_term(state_->GetCurrentTermUnlocked() + 1);
+      request.set_tablet_id(state_->GetOptions().tablet_id);
+      *request.mutable_candidate_status()->mutable_last_received() =
+        state_->GetLastReceivedOpIdUnlocked();
+
+      election.reset(new LeaderElection(
+          active_config,
+          peer_proxy_factory_.get(),
+          request,
+          std::move(counter),
+          timeout,
+          suppress_vote_request,
+          std::bind(&RaftConsensus::PreElectionCallback, shared_from_this(), originator_uuid,
+                    suppress_vote_request, std::placeholders::_1)));
+    } else if (start_now) {
       if (state_->HasLeaderUnlocked()) {
         LOG_WITH_PREFIX(INFO)
             << "Fail of leader " << state_->GetLeaderUuidUnlocked()
@@ -504,6 +568,12 @@ Status RaftConsensus::DoStartElection(
       request.set_tablet_id(state_->GetOptions().tablet_id);
       *request.mutable_candidate_status()->mutable_last_received() =
         state_->GetLastReceivedOpIdUnlocked();
+      if (lease_transfer_.has_term()) {
+        auto* lease_transfer = request.mutable_lease_transfer();
+        lease_transfer->set_old_leader_uuid(lease_transfer_.old_leader_uuid());
+        lease_transfer->set_term(lease_transfer_.term());
+        lease_transfer_.Clear();
+      }
 
       election.reset(new LeaderElection(
           active_config,
@@ -601,6 +671,7 @@ Status RaftConsensus::StepDown(const LeaderStepDownRequestPB* req, LeaderStepDow
   }
 
   std::string new_leader_uuid;
+  std::shared_ptr<RunLeaderElectionState> election_state;
   // If a new leader is nominated, find it among peers to send RunLeaderElection request.
   // See https://ramcloud.stanford.edu/~ongaro/thesis.pdf, section 3.10 for this mechanism
   // to transfer the leadership.
@@ -637,12 +708,11 @@ Status RaftConsensus::StepDown(const LeaderStepDownRequestPB* req, LeaderStepDow
       }
       election_lost_by_protege_at_ = MonoTime();
     }
-    bool new_leader_found = false;
     const RaftConfigPB& active_config = state_->GetActiveConfigUnlocked();
     for (const RaftPeerPB& peer : active_config.peers()) {
       if (peer.member_type() == RaftPeerPB::VOTER &&
           peer.permanent_uuid() == new_leader_uuid) {
-        auto election_state = std::make_shared<RunLeaderElectionState>();
+        election_state = std::make_shared<RunLeaderElectionState>();
         // TODO(sergei) Currently we preserved synchronous DNS resolution in this case.
         // It is possible that it should be changed to async in future.
         // But it looks like it is not a problem to leave synchronous variant here.
@@ -652,16 +722,11 @@ Status RaftConsensus::StepDown(const LeaderStepDownRequestPB* req, LeaderStepDow
         election_state->req.set_tablet_id(tablet_id);
         election_state->req.mutable_committed_index()->CopyFrom(
             state_->GetCommittedOpIdUnlocked());
-        election_state->proxy->RunLeaderElectionAsync(
-            &election_state->req, &election_state->resp, &election_state->rpc,
-            std::bind(&RaftConsensus::RunLeaderElectionResponseRpcCallback, this,
-                election_state));
-        new_leader_found = true;
         LOG(INFO) << "Transferring leadership of " << leadership_transfer_description;
         break;
       }
     }
-    if (!new_leader_found) {
+    if (!election_state) {
       LOG(WARNING) << "New leader " << new_leader_uuid << " not found among " << tablet_id
                    << " tablet peers.";
       resp->mutable_error()->set_code(TabletServerErrorPB::LEADER_NOT_READY_TO_STEP_DOWN);
@@ -674,6 +739,66 @@ Status RaftConsensus::StepDown(const LeaderStepDownRequestPB* req, LeaderStepDow
 
   RETURN_NOT_OK(BecomeReplicaUnlocked(new_leader_uuid));
 
+  if (election_state) {
+    // The protege is asked to run the election only once we stopped acting as a leader, so that
+    // we can hand our lease over to it.
+    if (FLAGS_transfer_leader_lease_on_stepdown) {
+      // Reads that passed the lease check before we stepped down could still pick a safe time, so
+      // it is limited to the hybrid time we hand over. The protege assigns later hybrid times
+      // only.
+      const auto handover_time = HybridTime::FromMicros(clock_->Now().GetPhysicalValueMicros() + 1);
+      state_->LimitMajorityReplicatedHtLeaseExpirationUnlocked(
+          handover_time.GetPhysicalValueMicros());
+      auto* lease_transfer = election_state->req.mutable_lease_transfer();
+      lease_transfer->set_old_leader_uuid(state_->GetPeerUuid());
+      lease_transfer->set_term(state_->GetCurrentTermUnlocked());
+      lease_transfer->set_hybrid_time(handover_time.ToUint64());
+      auto remaining_old_leader_lease = state_->RemainingOldLeaderLeaseDuration();
+      if (remaining_old_leader_lease.Initialized()) {
+        lease_transfer->set_remaining_old_leader_lease_duration_ms(
+            remaining_old_leader_lease.ToMilliseconds() + 1);
+      }
+      lease_transfer->set_old_leader_ht_lease_expiration(
+          state_->old_leader_ht_lease_expiration());
+    }
+    election_state->proxy->RunLeaderElectionAsync(
+        &election_state->req, &election_state->resp, &election_state->rpc,
+        std::bind(&RaftConsensus::RunLeaderElectionResponseRpcCallback, this,
+            election_state));
+  }
+
+  return Status::OK();
+}
+
+Status RaftConsensus::AcceptLeaseTransfer(const LeaseTransferPB& lease_transfer) {
+  // Everything we assign from now on is after what the old leader could have read or written.
+  clock_->Update(HybridTime(lease_transfer.hybrid_time()));
+
+  ReplicaState::UniqueLock lock;
+  RETURN_NOT_OK(state_->LockForConfigChange(&lock));
+
+  // The old leader can't act as a leader again in the term it stepped down in. A transfer that
+  // arrives after the term moved on could be about a lease it has got since.
+  if (lease_transfer.term() != state_->GetCurrentTermUnlocked() ||
+      lease_transfer.old_leader_uuid() != state_->GetLeaderUuidUnlocked()) {
+    LOG_WITH_PREFIX(INFO) << "Ignoring lease transfer " << lease_transfer.ShortDebugString()
+                          << ", term: " << state_->GetCurrentTermUnlocked()
+                          << ", leader: " << state_->GetLeaderUuidUnlocked();
+    return Status::OK();
+  }
+
+  LOG_WITH_PREFIX(INFO) << "Accepting lease transfer " << lease_transfer.ShortDebugString();
+  // The lease of the leader before the old one is known to the old leader, it had to wait it out
+  // itself.
+  state_->ResetOldLeaderLeaseExpirationUnlocked(
+      lease_transfer.has_remaining_old_leader_lease_duration_ms()
+          ? CoarseMonoClock::Now() +
+                std::chrono::milliseconds(lease_transfer.remaining_old_leader_lease_duration_ms())
+          : CoarseTimePoint(),
+      lease_transfer.has_old_leader_ht_lease_expiration()
+          ? lease_transfer.old_leader_ht_lease_expiration()
+          : HybridTime::kMin.GetPhysicalValueMicros());
+  lease_transfer_ = lease_transfer;
   return Status::OK();
 }
 
@@ -1725,6 +1850,7 @@ Status RaftConsensus::WaitWritesUnlocked(const LeaderRequest& deduped_req,
     // request at a time and this way we can allow commits to proceed while we wait.
     TRACE("Waiting on the replicates to finish logging");
     TRACE_EVENT0("consensus", "Wait for log");
+    ScopedWaitState wait_state(WaitState::kRaft);
     for (;;) {
       Status s = log_synchronizer->WaitFor(
         MonoDelta::FromMilliseconds(FLAGS_raft_heartbeat_interval_ms));
@@ -1887,6 +2013,30 @@ Status RaftConsensus::RequestVote(const VoteRequestPB* request, VoteResponsePB*
     return RequestVoteRespondAlreadyVotedForOther(request, response);
   }
 
+  // A pre-election only asks whether we would vote, so it doesn't change our state, and we don't
+  // wait for a candidate we haven't voted for to become the leader.
+  if (request->preelection()) {
+    consensus::OpId local_last_logged_opid;
+    GetLatestOpIdFromLog().ToPB(&local_last_logged_opid);
+    if (OpIdLessThan(request->candidate_status().last_received(), local_last_logged_opid)) {
+      return RequestVoteRespondLastOpIdTooOld(local_last_logged_opid, request, response);
+    }
+    FillVoteResponseVoteGranted(response);
+    LOG(INFO) << Substitute("$0: Granting yes pre-election vote for candidate $1 in term $2.",
+                            GetRequestVoteLogPrefix(),
+                            request->candidate_uuid(),
+                            request->candidate_term());
+    return Status::OK();
+  }
+
+  // The old leader handed its lease over to the candidate, so the candidate doesn't have to wait
+  // out the lease we know about. This is only the case while we are still in the term the old
+  // leader stepped down in, it can't be leader in that term again.
+  const bool lease_transferred =
+      request->has_lease_transfer() &&
+      request->lease_transfer().term() == state_->GetCurrentTermUnlocked() &&
+      request->lease_transfer().old_leader_uuid() == state_->GetLeaderUuidUnlocked();
+
   // The term advanced.
   if (request->candidate_term() > state_->GetCurrentTermUnlocked()) {
     RETURN_NOT_OK_PREPEND(HandleTermAdvanceUnlocked(request->candidate_term()),
@@ -1906,15 +2056,17 @@ Status RaftConsensus::RequestVote(const VoteRequestPB* request, VoteResponsePB*
   // election.
   state_->ClearPendingElectionOpIdUnlocked();
 
-  auto remaining_old_leader_lease = state_->RemainingOldLeaderLeaseDuration();
-  if (remaining_old_leader_lease.Initialized()) {
-    response->set_remaining_leader_lease_duration_ms(
-        remaining_old_leader_lease.ToMilliseconds());
-  }
+  if (!lease_transferred) {
+    auto remaining_old_leader_lease = state_->RemainingOldLeaderLeaseDuration();
+    if (remaining_old_leader_lease.Initialized()) {
+      response->set_remaining_leader_lease_duration_ms(
+          remaining_old_leader_lease.ToMilliseconds());
+    }
 
-  auto old_leader_ht_lease_expiration = state_->old_leader_ht_lease_expiration();
-  if (old_leader_ht_lease_expiration != HybridTime::kMin.GetPhysicalValueMicros()) {
-    response->set_leader_ht_lease_expiration(old_leader_ht_lease_expiration);
+    auto old_leader_ht_lease_expiration = state_->old_leader_ht_lease_expiration();
+    if (old_leader_ht_lease_expiration != HybridTime::kMin.GetPhysicalValueMicros()) {
+      response->set_leader_ht_lease_expiration(old_leader_ht_lease_expiration);
+    }
   }
 
   // Passed all our checks. Vote granted.
@@ -2567,6 +2719,43 @@ void RaftConsensus::ElectionCallback(const std::string& originator_uuid,
               state_->LogPrefix() + "Unable to run election callback");
 }
 
+void RaftConsensus::PreElectionCallback(
+    const std::string& originator_uuid, TEST_SuppressVoteRequest suppress_vote_request,
+    const ElectionResult& result) {
+  // Runs on a reactor thread as well.
+  WARN_NOT_OK(raft_pool_token_->SubmitFunc(
+              std::bind(&RaftConsensus::DoPreElectionCallback, shared_from_this(),
+                        originator_uuid, suppress_vote_request, result)),
+              state_->LogPrefix() + "Unable to run pre-election callback");
+}
+
+void RaftConsensus::DoPreElectionCallback(
+    const std::string& originator_uuid, TEST_SuppressVoteRequest suppress_vote_request,
+    const ElectionResult& result) {
+  if (result.decision == VOTE_DENIED) {
+    // The failure detector was snoozed when the pre-election started, so we will just try again
+    // later.
+    LOG_WITH_PREFIX(INFO) << "Pre-election lost for term " << result.election_term
+                          << ". Reason: "
+                          << (!result.message.empty() ? result.message : "None given");
+    return;
+  }
+
+  {
+    auto lock = state_->LockForRead();
+    if (result.election_term != state_->GetCurrentTermUnlocked() + 1) {
+      LOG_WITH_PREFIX(INFO) << "Pre-election decision for defunct term " << result.election_term;
+      return;
+    }
+  }
+
+  LOG_WITH_PREFIX(INFO) << "Pre-election won for term " << result.election_term;
+  WARN_NOT_OK(StartElectionImpl(
+                  NORMAL_ELECTION, PreElected::kTrue, /* pending_commit */ false,
+                  OpId::default_instance(), originator_uuid, suppress_vote_request),
+              state_->LogPrefix() + "Unable to start election after pre-election");
+}
+
 void RaftConsensus::NotifyOriginatorAboutLostElection(const std::string& originator_uuid) {
   if (originator_uuid.empty()) {
     return;
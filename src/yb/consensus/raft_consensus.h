@@ -83,6 +83,7 @@ struct ElectionResult;
 constexpr int32_t kDefaultLeaderLeaseDurationMs = 2000;
 
 YB_STRONGLY_TYPED_BOOL(WriteEmpty);
+YB_STRONGLY_TYPED_BOOL(PreElected);
 
 YB_DEFINE_ENUM(RejectMode, (kNone)(kAll)(kNonEmpty));
 
@@ -107,7 +108,8 @@ class RaftConsensus : public std::enable_shared_from_this<RaftConsensus>,
     const Callback<void(std::shared_ptr<StateChangeContext> context)> mark_dirty_clbk,
     TableType table_type,
     ThreadPool* raft_pool,
-    RetryableRequests* retryable_requests);
+    RetryableRequests* retryable_requests,
+    MultiRaftManager* multi_raft_manager);
 
   RaftConsensus(
     const ConsensusOptions& options,
@@ -140,6 +142,8 @@ class RaftConsensus : public std::enable_shared_from_this<RaftConsensus>,
 
   CHECKED_STATUS ElectionLostByProtege(const std::string& election_lost_by_uuid) override;
 
+  CHECKED_STATUS AcceptLeaseTransfer(const LeaseTransferPB& lease_transfer) override;
+
   CHECKED_STATUS WaitUntilLeaderForTests(const MonoDelta& timeout) override;
 
   CHECKED_STATUS StepDown(const LeaderStepDownRequestPB* req,
@@ -276,6 +280,16 @@ class RaftConsensus : public std::enable_shared_from_this<RaftConsensus>,
       const std::string& originator_uuid,
       TEST_SuppressVoteRequest suppress_vote_request) override;
 
+  // Starts a pre-election first if this is a normal election that was not pre-elected yet and
+  // --use_preelection is set.
+  CHECKED_STATUS StartElectionImpl(
+      ElectionMode mode,
+      PreElected pre_elected,
+      const bool pending_commit,
+      const OpId& must_be_committed_opid,
+      const std::string& originator_uuid,
+      TEST_SuppressVoteRequest suppress_vote_request);
+
   friend class ReplicaState;
   friend class RaftConsensusQuorumTest;
 
@@ -441,6 +455,15 @@ class RaftConsensus : public std::enable_shared_from_this<RaftConsensus>,
   void DoElectionCallback(const std::string& originator_uuid, const ElectionResult& result);
   void NotifyOriginatorAboutLostElection(const std::string& originator_uuid);
 
+  // Same for the pre-election, DoPreElectionCallback starts the real election if the pre-election
+  // was won.
+  void PreElectionCallback(
+      const std::string& originator_uuid, TEST_SuppressVoteRequest suppress_vote_request,
+      const ElectionResult& result);
+  void DoPreElectionCallback(
+      const std::string& originator_uuid, TEST_SuppressVoteRequest suppress_vote_request,
+      const ElectionResult& result);
+
   // Helper struct that tracks the RunLeaderElection as part of leadership transferral.
   struct RunLeaderElectionState {
     PeerProxyPtr proxy;
@@ -607,6 +630,10 @@ class RaftConsensus : public std::enable_shared_from_this<RaftConsensus>,
   // server, we'll reply with the amount of time that has passed to avoid leader stepdown loops.s
   MonoTime election_lost_by_protege_at_;
 
+  // The lease handed over by the leader that stepped down in favor of this peer, to be sent with
+  // the vote requests of the next election. Protected by the ReplicaState lock.
+  LeaseTransferPB lease_transfer_;
+
   const Callback<void(std::shared_ptr<StateChangeContext> context)> mark_dirty_clbk_;
 
   // TODO hack to serialize updates due to repeated/out-of-order messages
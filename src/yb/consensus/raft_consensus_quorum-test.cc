@@ -134,6 +134,7 @@ class RaftConsensusQuorumTest : public YBTest {
                               0, // schema_version
                               nullptr, // metric_entity
                               append_pool_.get(),
+                              nullptr /* allocation_thread_pool */,
                               &log));
       logs_.push_back(log.get());
       fs_managers_.push_back(fs_manager.release());
@@ -1008,5 +1009,69 @@ TEST_F(RaftConsensusQuorumTest, TestRequestVote) {
   LOG(INFO) << "Follower rejected old heartbeat, as expected: " << res.ShortDebugString();
 }
 
+TEST_F(RaftConsensusQuorumTest, TestRequestPreElectionVote) {
+  ASSERT_OK(BuildAndStartConfig(3));
+
+  OpId last_op_id;
+  vector<scoped_refptr<ConsensusRound> > rounds;
+  REPLICATE_SEQUENCE_OF_MESSAGES(10,
+                                 2, // The index of the initial leader.
+                                 WAIT_FOR_ALL_REPLICAS,
+                                 COMMIT_ONE_BY_ONE,
+                                 &last_op_id,
+                                 &rounds);
+  WaitForCommitIfNotAlreadyPresent(last_op_id, 1, 2);
+
+  const int kPeerIndex = 1;
+  shared_ptr<RaftConsensus> peer;
+  ASSERT_OK(peers_->GetPeerByIdx(kPeerIndex, &peer));
+  const auto term = ReadConsensusMetadataFromDisk(kPeerIndex)->current_term();
+
+  VoteRequestPB request;
+  request.set_tablet_id(kTestTablet);
+  request.mutable_candidate_status()->mutable_last_received()->CopyFrom(last_op_id);
+  request.set_candidate_uuid("peer-0");
+  request.set_candidate_term(term + 1);
+  request.set_preelection(true);
+
+  // The replica recently heard from the leader, so it won't pre-vote either.
+  VoteResponsePB response;
+  ASSERT_OK(peer->RequestVote(&request, &response));
+  ASSERT_FALSE(response.vote_granted());
+  ASSERT_EQ(ConsensusErrorPB::LEADER_IS_ALIVE, response.consensus_error().code());
+
+  // The pre-vote is granted, but the replica keeps its term and doesn't record the vote.
+  request.set_ignore_live_leader(true);
+  response.Clear();
+  ASSERT_OK(peer->RequestVote(&request, &response));
+  ASSERT_TRUE(response.vote_granted());
+  ASSERT_EQ(term, response.responder_term());
+  ASSERT_NO_FATALS(AssertDurableTermWithoutVote(kPeerIndex, term));
+
+  // A pre-vote is denied for an old op index.
+  request.mutable_candidate_status()->mutable_last_received()->CopyFrom(MinimumOpId());
+  response.Clear();
+  ASSERT_OK(peer->RequestVote(&request, &response));
+  ASSERT_FALSE(response.vote_granted());
+  ASSERT_EQ(ConsensusErrorPB::LAST_OPID_TOO_OLD, response.consensus_error().code());
+  ASSERT_NO_FATALS(AssertDurableTermWithoutVote(kPeerIndex, term));
+
+  // Once the replica voted for another candidate in the term, it doesn't pre-vote for this one.
+  request.mutable_candidate_status()->mutable_last_received()->CopyFrom(last_op_id);
+  request.set_preelection(false);
+  request.set_candidate_uuid("peer-2");
+  response.Clear();
+  ASSERT_OK(peer->RequestVote(&request, &response));
+  ASSERT_TRUE(response.vote_granted());
+  ASSERT_NO_FATALS(AssertDurableTermAndVote(kPeerIndex, term + 1, "peer-2"));
+
+  request.set_preelection(true);
+  request.set_candidate_uuid("peer-0");
+  response.Clear();
+  ASSERT_OK(peer->RequestVote(&request, &response));
+  ASSERT_FALSE(response.vote_granted());
+  ASSERT_EQ(ConsensusErrorPB::ALREADY_VOTED, response.consensus_error().code());
+}
+
 }  // namespace consensus
 }  // namespace yb
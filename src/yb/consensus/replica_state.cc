@@ -1080,6 +1080,22 @@ void ReplicaState::UpdateOldLeaderLeaseExpirationUnlocked(
   old_leader_ht_lease_expiration_ = std::max(ht_lease_expiration, old_leader_ht_lease_expiration_);
 }
 
+void ReplicaState::ResetOldLeaderLeaseExpirationUnlocked(
+    CoarseTimePoint lease_expiration,
+    MicrosTime ht_lease_expiration) {
+  old_leader_lease_expiration_ = lease_expiration;
+  old_leader_ht_lease_expiration_ = ht_lease_expiration;
+}
+
+void ReplicaState::LimitMajorityReplicatedHtLeaseExpirationUnlocked(
+    MicrosTime ht_lease_expiration) {
+  DCHECK_NE(GetActiveRoleUnlocked(), RaftPeerPB::LEADER);
+  if (majority_replicated_ht_lease_expiration_.load(std::memory_order_acquire) >
+          ht_lease_expiration) {
+    majority_replicated_ht_lease_expiration_.store(ht_lease_expiration, std::memory_order_release);
+  }
+}
+
 template <class Policy>
 LeaderLeaseStatus ReplicaState::GetLeaseStatusUnlocked(Policy policy) const {
   DCHECK_EQ(GetActiveRoleUnlocked(), RaftPeerPB_Role_LEADER);
@@ -362,6 +362,14 @@ class ReplicaState {
   void UpdateOldLeaderLeaseExpirationUnlocked(
       CoarseTimePoint lease_expiration, MicrosTime ht_lease_expiration);
 
+  // Replaces the old leader leases we know about, when the old leader handed its lease over to us.
+  void ResetOldLeaderLeaseExpirationUnlocked(
+      CoarseTimePoint lease_expiration, MicrosTime ht_lease_expiration);
+
+  // Limits the hybrid time lease of a leader that just stepped down, so that it doesn't pick safe
+  // times after ht_lease_expiration for the reads that are still in flight.
+  void LimitMajorityReplicatedHtLeaseExpirationUnlocked(MicrosTime ht_lease_expiration);
+
   void SetMajorityReplicatedLeaseExpirationUnlocked(
       const MajorityReplicatedData& majority_replicated_data);
 
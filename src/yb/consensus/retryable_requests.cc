@@ -22,6 +22,8 @@
 #include "yb/consensus/consensus.h"
 
 #include "yb/util/atomic.h"
+#include "yb/util/flag_tags.h"
+#include "yb/util/mem_tracker.h"
 #include "yb/util/metrics.h"
 #include "yb/util/opid.h"
 
@@ -34,6 +36,20 @@ DEFINE_int32(retryable_request_timeout_secs, 300,
 DEFINE_int32(retryable_request_range_time_limit_secs, 30,
              "Max delta in time for single op id range.");
 
+// Replicated ranges are split by gaps in request ids, so a client that leaves lots of gaps could
+// make its ranges grow without limit.
+DEFINE_int32(retryable_requests_max_ranges_per_client, 10000,
+             "Max number of replicated request ranges kept for a single client. When it is "
+             "exceeded, the ranges with the lowest request ids are dropped, and retries of the "
+             "requests in them are rejected as expired instead of being detected as duplicates.");
+TAG_FLAG(retryable_requests_max_ranges_per_client, advanced);
+
+DEFINE_int32(retryable_requests_max_cleaned_ranges, 10000,
+             "Max number of expired replicated request ranges removed by a single cleanup, so "
+             "cleanup does not hold the replica state lock for long. The remaining ones are "
+             "removed by the following cleanups.");
+TAG_FLAG(retryable_requests_max_cleaned_ranges, advanced);
+
 METRIC_DEFINE_gauge_int64(tablet, running_retryable_requests,
                           "Number of running retryable requests.",
                           yb::MetricUnit::kRequests,
@@ -145,6 +161,13 @@ struct ClientRetryableRequests {
   RestartSafeCoarseTimePoint empty_since;
 };
 
+// Approximate memory used by entries, including the nodes of their multi index containers.
+constexpr int64_t kRunningRequestBytes = sizeof(RunningRetryableRequest) + 6 * sizeof(void*);
+constexpr int64_t kReplicatedRangeBytes =
+    sizeof(ReplicatedRetryableRequestRange) + 8 * sizeof(void*);
+constexpr int64_t kClientBytes = sizeof(ClientRetryableRequests) + sizeof(ClientId) +
+                                 4 * sizeof(void*);
+
 std::chrono::seconds RangeTimeLimit() {
   return std::chrono::seconds(FLAGS_retryable_request_range_time_limit_secs);
 }
@@ -218,7 +241,7 @@ class RetryableRequests::Impl {
       entry_time = clock_.Now();
     }
 
-    ClientRetryableRequests& client_retryable_requests = clients_[data.client_id()];
+    ClientRetryableRequests& client_retryable_requests = Client(data.client_id());
 
     CleanupReplicatedRequests(
         data.write_request().min_running_request_id(), &client_retryable_requests);
@@ -246,9 +269,7 @@ class RetryableRequests::Impl {
     }
 
     VLOG_WITH_PREFIX(4) << "Running added " << data;
-    if (running_requests_gauge_) {
-      running_requests_gauge_->Increment();
-    }
+    RunningChanged(1);
 
     return true;
   }
@@ -258,23 +279,22 @@ class RetryableRequests::Impl {
     auto now = clock_.Now();
     auto clean_start =
         now - std::chrono::seconds(GetAtomicFlag(&FLAGS_retryable_request_timeout_secs));
+    int64_t budget = GetAtomicFlag(&FLAGS_retryable_requests_max_cleaned_ranges);
     for (auto ci = clients_.begin(); ci != clients_.end();) {
       ClientRetryableRequests& client_retryable_requests = ci->second;
       auto& op_id_index = client_retryable_requests.replicated.get<OpIdIndex>();
       auto it = op_id_index.begin();
       int64_t count = 0;
-      while (it != op_id_index.end() && it->max_time < clean_start) {
+      while (count < budget && it != op_id_index.end() && it->max_time < clean_start) {
         ++it;
         ++count;
       }
-      if (replicated_request_ranges_gauge_) {
-        replicated_request_ranges_gauge_->DecrementBy(count);
-      }
-      if (it != op_id_index.end()) {
-        result = std::min(result, it->min_op_id);
-        op_id_index.erase(op_id_index.begin(), it);
-      } else {
-        op_id_index.clear();
+      budget -= count;
+      op_id_index.erase(op_id_index.begin(), it);
+      ReplicatedChanged(-count);
+      // Ranges left because the budget is exhausted still keep their log entries.
+      if (!op_id_index.empty()) {
+        result = std::min(result, op_id_index.begin()->min_op_id);
       }
       if (op_id_index.empty() && client_retryable_requests.running.empty()) {
         // We delay deleting client with empty requests, to be able to filter requests with too
@@ -283,6 +303,7 @@ class RetryableRequests::Impl {
           client_retryable_requests.empty_since = now;
         } else if (client_retryable_requests.empty_since < clean_start) {
           ci = clients_.erase(ci);
+          UpdateConsumption(-kClientBytes);
           continue;
         }
       }
@@ -299,7 +320,7 @@ class RetryableRequests::Impl {
       return;
     }
 
-    auto& client_retryable_requests = clients_[data.client_id()];
+    auto& client_retryable_requests = Client(data.client_id());
     auto& running_indexed_by_request_id = client_retryable_requests.running.get<RequestIdIndex>();
     auto running_it = running_indexed_by_request_id.find(data.request_id());
     if (running_it == running_indexed_by_request_id.end()) {
@@ -319,9 +340,7 @@ class RetryableRequests::Impl {
     }
     auto entry_time = running_it->time;
     running_indexed_by_request_id.erase(running_it);
-    if (running_requests_gauge_) {
-      running_requests_gauge_->Decrement();
-    }
+    RunningChanged(-1);
 
     if (status.ok()) {
       AddReplicated(
@@ -336,7 +355,7 @@ class RetryableRequests::Impl {
       return;
     }
 
-    auto& client_retryable_requests = clients_[data.client_id()];
+    auto& client_retryable_requests = Client(data.client_id());
     auto& running_indexed_by_request_id = client_retryable_requests.running.get<RequestIdIndex>();
     if (running_indexed_by_request_id.count(data.request_id()) != 0) {
 #ifndef NDEBUG
@@ -363,6 +382,14 @@ class RetryableRequests::Impl {
     running_requests_gauge_ = METRIC_running_retryable_requests.Instantiate(metric_entity, 0);
     replicated_request_ranges_gauge_ = METRIC_replicated_retryable_request_ranges.Instantiate(
         metric_entity, 0);
+    running_requests_gauge_->IncrementBy(num_running_);
+    replicated_request_ranges_gauge_->IncrementBy(num_replicated_);
+  }
+
+  void SetMemTracker(const MemTrackerPtr& parent) {
+    consumption_ = ScopedTrackedConsumption(
+        MemTracker::FindOrCreateTracker("RetryableRequests", parent), 0);
+    UpdateConsumption(0);
   }
 
   RetryableRequestsCounts TEST_Counts() {
@@ -376,6 +403,37 @@ class RetryableRequests::Impl {
   }
 
  private:
+  ClientRetryableRequests& Client(const ClientId& client_id) {
+    auto emplace_result = clients_.emplace(client_id, ClientRetryableRequests());
+    if (emplace_result.second) {
+      UpdateConsumption(kClientBytes);
+    }
+    return emplace_result.first->second;
+  }
+
+  void RunningChanged(int64_t delta) {
+    num_running_ += delta;
+    if (running_requests_gauge_) {
+      running_requests_gauge_->IncrementBy(delta);
+    }
+    UpdateConsumption(delta * kRunningRequestBytes);
+  }
+
+  void ReplicatedChanged(int64_t delta) {
+    num_replicated_ += delta;
+    if (replicated_request_ranges_gauge_) {
+      replicated_request_ranges_gauge_->IncrementBy(delta);
+    }
+    UpdateConsumption(delta * kReplicatedRangeBytes);
+  }
+
+  void UpdateConsumption(int64_t delta) {
+    consumed_bytes_ += delta;
+    if (consumption_) {
+      consumption_.Reset(consumed_bytes_);
+    }
+  }
+
   void CleanupReplicatedRequests(
       RetryableRequestId new_min_running_request_id,
       ClientRetryableRequests* client_retryable_requests) {
@@ -391,10 +449,7 @@ class RetryableRequests::Impl {
           it->first_id < new_min_running_request_id) {
         it->first_id = new_min_running_request_id;
       }
-      if (replicated_request_ranges_gauge_) {
-        replicated_request_ranges_gauge_->DecrementBy(
-            std::distance(replicated_indexed_by_last_id.begin(), it));
-      }
+      ReplicatedChanged(-std::distance(replicated_indexed_by_last_id.begin(), it));
       // Remove all intervals that has ids below write_request.min_running_request_id().
       replicated_indexed_by_last_id.erase(replicated_indexed_by_last_id.begin(), it);
       client_retryable_requests->min_running_request_id = new_min_running_request_id;
@@ -436,8 +491,16 @@ class RetryableRequests::Impl {
     }
 
     client->replicated.emplace(request_id, op_id, time);
-    if (replicated_request_ranges_gauge_) {
-      replicated_request_ranges_gauge_->Increment();
+    ReplicatedChanged(1);
+
+    auto max_ranges = GetAtomicFlag(&FLAGS_retryable_requests_max_ranges_per_client);
+    if (max_ranges > 0 && client->replicated.size() > static_cast<size_t>(max_ranges)) {
+      // Forgetting a range is only safe together with rejecting retries of its requests, so
+      // min running request id is moved past it.
+      auto last_id = replicated_indexed_by_last_id.begin()->last_id;
+      VLOG_WITH_PREFIX(1) << "Too many replicated ranges for " << data.client_id()
+                          << ", dropping requests through " << last_id;
+      CleanupReplicatedRequests(last_id + 1, client);
     }
   }
 
@@ -477,9 +540,7 @@ class RetryableRequests::Impl {
     min_op_id = std::min(min_op_id, request_prev_it->min_op_id);
     request_it->PrepareJoinWithPrev(*request_prev_it);
     replicated_indexed_by_last_id->erase(request_prev_it);
-    if (replicated_request_ranges_gauge_) {
-      replicated_request_ranges_gauge_->Decrement();
-    }
+    ReplicatedChanged(-1);
     UpdateMinOpId(request_it, min_op_id, replicated_indexed_by_last_id);
 
     return true;
@@ -526,6 +587,10 @@ class RetryableRequests::Impl {
   RestartSafeCoarseMonoClock clock_;
   scoped_refptr<AtomicGauge<int64_t>> running_requests_gauge_;
   scoped_refptr<AtomicGauge<int64_t>> replicated_request_ranges_gauge_;
+  int64_t num_running_ = 0;
+  int64_t num_replicated_ = 0;
+  int64_t consumed_bytes_ = 0;
+  ScopedTrackedConsumption consumption_;
 };
 
 RetryableRequests::RetryableRequests(std::string log_prefix)
@@ -572,5 +637,9 @@ void RetryableRequests::SetMetricEntity(const scoped_refptr<MetricEntity>& metri
   impl_->SetMetricEntity(metric_entity);
 }
 
+void RetryableRequests::SetMemTracker(const std::shared_ptr<MemTracker>& parent) {
+  impl_->SetMemTracker(parent);
+}
+
 } // namespace consensus
 } // namespace yb
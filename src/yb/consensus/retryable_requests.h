@@ -20,6 +20,7 @@
 
 namespace yb {
 
+class MemTracker;
 class MetricEntity;
 struct OpId;
 
@@ -45,6 +46,8 @@ class RetryableRequests {
                 RestartSafeCoarseTimePoint entry_time = RestartSafeCoarseTimePoint());
 
   // Cleans expires replicated requests and returns min op id of running request.
+  // At most --retryable_requests_max_cleaned_ranges ranges are removed by one call, the rest are
+  // removed by the following calls.
   yb::OpId CleanExpiredReplicatedAndGetMinOpId();
 
   // Mark appropriate request as replicated, i.e. move it from set of running requests to
@@ -62,6 +65,9 @@ class RetryableRequests {
 
   void SetMetricEntity(const scoped_refptr<MetricEntity>& metric_entity);
 
+  // Starts accounting the memory used by tracked requests in a child of 'parent'.
+  void SetMemTracker(const std::shared_ptr<MemTracker>& parent);
+
  private:
   class Impl;
   std::unique_ptr<Impl> impl_;
@@ -0,0 +1,110 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/consensus/shared_log_syncer.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <unordered_map>
+
+#include <glog/logging.h>
+
+#include "yb/util/debug/trace_event.h"
+#include "yb/util/errno.h"
+#include "yb/util/stopwatch.h"
+#include "yb/util/thread_restrictions.h"
+
+namespace yb {
+namespace log {
+
+namespace {
+
+std::mutex syncers_mutex;
+std::unordered_map<dev_t, std::weak_ptr<SharedLogSyncer>> syncers;
+
+} // namespace
+
+Result<std::shared_ptr<SharedLogSyncer>> SharedLogSyncer::ForDirectory(const std::string& dir) {
+  struct stat st;
+  if (stat(dir.c_str(), &st) != 0) {
+    return STATUS(IOError, "Failed to stat " + dir, ErrnoToString(errno), errno);
+  }
+
+  std::lock_guard<std::mutex> lock(syncers_mutex);
+  auto& weak_syncer = syncers[st.st_dev];
+  auto syncer = weak_syncer.lock();
+  if (syncer) {
+    return syncer;
+  }
+
+  int fd = open(dir.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return STATUS(IOError, "Failed to open " + dir, ErrnoToString(errno), errno);
+  }
+  syncer = std::make_shared<SharedLogSyncer>(fd, dir);
+  weak_syncer = syncer;
+  return syncer;
+}
+
+SharedLogSyncer::SharedLogSyncer(int fd, std::string dir) : fd_(fd), dir_(std::move(dir)) {
+}
+
+SharedLogSyncer::~SharedLogSyncer() {
+  if (close(fd_) != 0) {
+    LOG(WARNING) << "Failed to close " << dir_ << ": " << ErrnoToString(errno);
+  }
+}
+
+Status SharedLogSyncer::Sync() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  // A sync that is already in progress might have started before our writes, so we need the one
+  // after it.
+  const uint64_t needed_sync = started_syncs_ + 1;
+  while (finished_syncs_ < needed_sync) {
+    if (sync_in_progress_) {
+      cond_.wait(lock);
+      continue;
+    }
+    sync_in_progress_ = true;
+    const uint64_t sync = ++started_syncs_;
+    lock.unlock();
+    Status status = DoSync();
+    lock.lock();
+    sync_in_progress_ = false;
+    finished_syncs_ = sync;
+    last_status_ = std::move(status);
+    cond_.notify_all();
+  }
+  return last_status_;
+}
+
+Status SharedLogSyncer::DoSync() {
+  TRACE_EVENT1("log", "SharedLogSyncer::DoSync", "path", dir_);
+  ThreadRestrictions::AssertIOAllowed();
+  LOG_SLOW_EXECUTION(WARNING, 50, "Shared sync of " + dir_ + " took a long time") {
+#if defined(__linux__)
+    if (syncfs(fd_) != 0) {
+      return STATUS(IOError, "Failed to sync filesystem of " + dir_, ErrnoToString(errno), errno);
+    }
+#else
+    // There is no way to sync a single filesystem, so sync all of them.
+    sync();
+#endif
+  }
+  return Status::OK();
+}
+
+} // namespace log
+} // namespace yb
@@ -0,0 +1,72 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_CONSENSUS_SHARED_LOG_SYNCER_H
+#define YB_CONSENSUS_SHARED_LOG_SYNCER_H
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "yb/util/result.h"
+#include "yb/util/status.h"
+
+namespace yb {
+namespace log {
+
+// Makes the WAL writes of all tablets on one filesystem durable with shared sync calls, instead of
+// one sync per tablet. Tablets that ask for durability while a sync is in progress are covered by
+// the next one, which the first of them issues on behalf of all of them. So with many tablets
+// appending at the same time, the filesystem sees one sync at a time instead of one per tablet.
+//
+// On Linux a sync is a single syncfs() call on the filesystem. It also flushes whatever else is
+// dirty on that filesystem, so it works best when the WALs have a device of their own.
+class SharedLogSyncer {
+ public:
+  // Returns the syncer of the filesystem that 'dir' is on, shared by all callers with directories
+  // on that filesystem.
+  static Result<std::shared_ptr<SharedLogSyncer>> ForDirectory(const std::string& dir);
+
+  SharedLogSyncer(int fd, std::string dir);
+
+  ~SharedLogSyncer();
+
+  // Returns once everything written to files on this filesystem before the call is durable.
+  CHECKED_STATUS Sync();
+
+ private:
+  CHECKED_STATUS DoSync();
+
+  // Descriptor of a directory on the filesystem, and its path.
+  const int fd_;
+  const std::string dir_;
+
+  std::mutex mutex_;
+  std::condition_variable cond_;
+
+  // Whether some caller is currently syncing for all waiting ones.
+  bool sync_in_progress_ = false;
+
+  // Number of syncs started and finished so far.
+  uint64_t started_syncs_ = 0;
+  uint64_t finished_syncs_ = 0;
+
+  // Result of the last finished sync.
+  Status last_status_;
+};
+
+} // namespace log
+} // namespace yb
+
+#endif // YB_CONSENSUS_SHARED_LOG_SYNCER_H
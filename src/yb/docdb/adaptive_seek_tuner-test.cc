@@ -0,0 +1,108 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/adaptive_seek_tuner.h"
+
+#include "yb/util/metrics.h"
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+DECLARE_int32(adaptive_seek_probe_interval);
+DECLARE_int32(adaptive_seek_probes_per_update);
+DECLARE_int32(max_nexts_to_avoid_seek);
+
+METRIC_DEFINE_entity(test_entity);
+METRIC_DEFINE_counter(test_entity, test_nexts_instead_of_seek, "Test Nexts Instead Of Seek",
+                      yb::MetricUnit::kOperations, "Number of test seeks replaced by nexts.");
+METRIC_DEFINE_counter(test_entity, test_seeks_after_nexts, "Test Seeks After Nexts",
+                      yb::MetricUnit::kOperations, "Number of test seeks done after nexts.");
+METRIC_DEFINE_gauge_uint32(test_entity, test_max_nexts_to_avoid_seek, "Test Max Nexts",
+                           yb::MetricUnit::kOperations, "Test number of nexts to try.");
+
+namespace yb {
+namespace docdb {
+
+class AdaptiveSeekTunerTest : public YBTest {
+ protected:
+  void SetUp() override {
+    YBTest::SetUp();
+    // Only recompute when the test asks for it.
+    FLAGS_adaptive_seek_probes_per_update = 1000000;
+    entity_ = METRIC_ENTITY_test_entity.Instantiate(&registry_, "test");
+    metrics_.nexts_instead_of_seek = METRIC_test_nexts_instead_of_seek.Instantiate(entity_);
+    metrics_.seeks_after_nexts = METRIC_test_seeks_after_nexts.Instantiate(entity_);
+    metrics_.max_nexts_to_avoid_seek = METRIC_test_max_nexts_to_avoid_seek.Instantiate(entity_, 0);
+  }
+
+  static void AddProbes(AdaptiveSeekTuner* tuner, int count, int nexts, bool seeked) {
+    for (int i = 0; i != count; ++i) {
+      tuner->RecordProbe(nexts, seeked, MonoDelta::FromNanoseconds(100 * nexts),
+                         MonoDelta::FromNanoseconds(seeked ? 1000 : 0));
+    }
+  }
+
+  MetricRegistry registry_;
+  scoped_refptr<MetricEntity> entity_;
+  AdaptiveSeekTuner::Metrics metrics_;
+};
+
+TEST_F(AdaptiveSeekTunerTest, ProbesEveryInterval) {
+  FLAGS_adaptive_seek_probe_interval = 4;
+  FLAGS_max_nexts_to_avoid_seek = 2;
+  AdaptiveSeekTuner tuner(metrics_);
+  ASSERT_EQ(2, tuner.max_nexts());
+  ASSERT_EQ(2U, metrics_.max_nexts_to_avoid_seek->value());
+
+  int probes = 0;
+  for (int i = 0; i != 16; ++i) {
+    bool probe = false;
+    const int nexts = tuner.NextsToTry(&probe);
+    ASSERT_EQ(probe ? AdaptiveSeekTuner::kMaxNexts : 2, nexts);
+    probes += probe;
+  }
+  ASSERT_EQ(4, probes);
+
+  tuner.Record(false);
+  tuner.Record(true);
+  tuner.Record(true);
+  ASSERT_EQ(1, metrics_.nexts_instead_of_seek->value());
+  ASSERT_EQ(2, metrics_.seeks_after_nexts->value());
+}
+
+TEST_F(AdaptiveSeekTunerTest, SingleVersionPerKey) {
+  AdaptiveSeekTuner tuner(metrics_);
+  // Seeks cost several nexts, and the target is usually the next key.
+  AddProbes(&tuner, 90, 1, false);
+  AddProbes(&tuner, 10, 2, false);
+  tuner.TEST_Recompute();
+  ASSERT_EQ(2, tuner.max_nexts());
+  ASSERT_EQ(2U, metrics_.max_nexts_to_avoid_seek->value());
+}
+
+TEST_F(AdaptiveSeekTunerTest, DeepHistory) {
+  AdaptiveSeekTuner tuner(metrics_);
+  // The target is always further than the probes go, so nexts are wasted.
+  AddProbes(&tuner, 100, AdaptiveSeekTuner::kMaxNexts, true);
+  tuner.TEST_Recompute();
+  ASSERT_EQ(0, tuner.max_nexts());
+
+  // The workload changes, old probes decay.
+  for (int i = 0; i != 4; ++i) {
+    AddProbes(&tuner, 100, 3, false);
+    tuner.TEST_Recompute();
+  }
+  ASSERT_EQ(3, tuner.max_nexts());
+}
+
+}  // namespace docdb
+}  // namespace yb
@@ -0,0 +1,151 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/adaptive_seek_tuner.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "yb/util/flag_tags.h"
+#include "yb/util/metrics.h"
+
+DEFINE_int32(adaptive_seek_probe_interval, 64,
+             "One in this many forward seeks of a RocksDB instance with an adaptive seek tuner "
+             "tries up to the maximum number of nexts, to learn how many of them are needed.");
+TAG_FLAG(adaptive_seek_probe_interval, advanced);
+
+DEFINE_int32(adaptive_seek_probes_per_update, 64,
+             "Number of probes after which the adaptive seek tuner picks a new number of nexts to "
+             "try before seeking.");
+TAG_FLAG(adaptive_seek_probes_per_update, advanced);
+
+DEFINE_int32(adaptive_seek_default_seek_to_next_cost_ratio, 8,
+             "Cost of a RocksDB seek relative to a next, assumed by the adaptive seek tuner until "
+             "it has measured both.");
+TAG_FLAG(adaptive_seek_default_seek_to_next_cost_ratio, advanced);
+
+DECLARE_int32(max_nexts_to_avoid_seek);
+
+namespace yb {
+namespace docdb {
+
+namespace {
+
+// Weight of a new sample in the cost averages is 1 / kAverageWeight.
+constexpr uint64_t kAverageWeight = 16;
+
+thread_local uint32_t seek_call_counter = 0;
+
+} // namespace
+
+constexpr int AdaptiveSeekTuner::kMaxNexts;
+
+AdaptiveSeekTuner::AdaptiveSeekTuner(const Metrics& metrics)
+    : metrics_(metrics),
+      max_nexts_(std::min(std::max(FLAGS_max_nexts_to_avoid_seek, 0), kMaxNexts)) {
+  for (auto& distance : probe_distances_) {
+    distance.store(0, std::memory_order_relaxed);
+  }
+  if (metrics_.max_nexts_to_avoid_seek) {
+    metrics_.max_nexts_to_avoid_seek->set_value(max_nexts());
+  }
+}
+
+int AdaptiveSeekTuner::NextsToTry(bool* probe) {
+  const auto interval = std::max(FLAGS_adaptive_seek_probe_interval, 1);
+  *probe = ++seek_call_counter % interval == 0;
+  return *probe ? kMaxNexts : max_nexts();
+}
+
+void AdaptiveSeekTuner::Record(bool seeked) {
+  IncrementCounter(seeked ? metrics_.seeks_after_nexts : metrics_.nexts_instead_of_seek);
+}
+
+void AdaptiveSeekTuner::RecordProbe(
+    int nexts, bool seeked, MonoDelta nexts_time, MonoDelta seek_time) {
+  Record(seeked);
+  probe_distances_[seeked ? kMaxNexts + 1 : nexts].fetch_add(1, std::memory_order_relaxed);
+  if (nexts > 0) {
+    UpdateAverage(&next_cost_ns_, nexts_time.ToNanoseconds() / nexts);
+  }
+  if (seeked) {
+    UpdateAverage(&seek_cost_ns_, seek_time.ToNanoseconds());
+  }
+
+  const auto probes_per_update = std::max(FLAGS_adaptive_seek_probes_per_update, 1);
+  if (num_probes_.fetch_add(1, std::memory_order_relaxed) % probes_per_update ==
+          static_cast<uint64_t>(probes_per_update - 1)) {
+    Recompute();
+  }
+}
+
+void AdaptiveSeekTuner::UpdateAverage(std::atomic<uint64_t>* average, uint64_t sample) {
+  // Concurrent updates could lose a sample, that is fine for an estimate.
+  const auto old_value = average->load(std::memory_order_relaxed);
+  const auto new_value = old_value == 0
+      ? std::max<uint64_t>(sample, 1)
+      : std::max<uint64_t>((old_value * (kAverageWeight - 1) + sample) / kAverageWeight, 1);
+  average->store(new_value, std::memory_order_relaxed);
+}
+
+void AdaptiveSeekTuner::Recompute() {
+  std::unique_lock<std::mutex> lock(recompute_mutex_, std::try_to_lock);
+  if (!lock.owns_lock()) {
+    return;
+  }
+
+  std::array<uint64_t, kMaxNexts + 2> distances;
+  uint64_t remaining = 0;
+  for (size_t i = 0; i != distances.size(); ++i) {
+    distances[i] = probe_distances_[i].load(std::memory_order_relaxed);
+    remaining += distances[i];
+    // Halve the history, so that the recent probes dominate the next decision.
+    probe_distances_[i].fetch_sub(distances[i] / 2, std::memory_order_relaxed);
+  }
+  if (remaining == 0) {
+    return;
+  }
+
+  const auto ratio = std::max(FLAGS_adaptive_seek_default_seek_to_next_cost_ratio, 1);
+  double next_cost = next_cost_ns_.load(std::memory_order_relaxed);
+  double seek_cost = seek_cost_ns_.load(std::memory_order_relaxed);
+  if (next_cost == 0) {
+    next_cost = seek_cost == 0 ? 1 : seek_cost / ratio;
+  }
+  if (seek_cost == 0) {
+    seek_cost = next_cost * ratio;
+  }
+
+  // Expected cost of trying up to n nexts, multiplied by the number of probes: probes that
+  // reached the target within n nexts paid for their nexts, the others paid for n nexts and a seek.
+  double reached_cost = 0;
+  int best_nexts = 0;
+  double best_cost = std::numeric_limits<double>::max();
+  for (int n = 0; n <= kMaxNexts; ++n) {
+    reached_cost += distances[n] * n * next_cost;
+    remaining -= distances[n];
+    const double cost = reached_cost + remaining * (n * next_cost + seek_cost);
+    if (cost < best_cost) {
+      best_cost = cost;
+      best_nexts = n;
+    }
+  }
+
+  max_nexts_.store(best_nexts, std::memory_order_relaxed);
+  if (metrics_.max_nexts_to_avoid_seek) {
+    metrics_.max_nexts_to_avoid_seek->set_value(best_nexts);
+  }
+}
+
+}  // namespace docdb
+}  // namespace yb
@@ -0,0 +1,101 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_DOCDB_ADAPTIVE_SEEK_TUNER_H_
+#define YB_DOCDB_ADAPTIVE_SEEK_TUNER_H_
+
+#include <array>
+#include <atomic>
+#include <mutex>
+
+#include "yb/gutil/ref_counted.h"
+
+#include "yb/util/monotime.h"
+
+namespace yb {
+
+class Counter;
+template<class T>
+class AtomicGauge;
+
+namespace docdb {
+
+// Learns how many Next() calls PerformRocksDBSeek should try before falling back to a Seek() on one
+// RocksDB instance. Tables with a deep version history need many nexts to reach the target key,
+// so an actual seek pays off early, while tables with a single version per key usually reach the
+// target in one or two nexts.
+//
+// Every sample_interval-th forward seek is a probe: it tries up to max_nexts nexts, records how
+// many of them were needed to reach the target (or that it had to seek anyway), and times the
+// nexts and the seek. Periodically the tuner picks the number of nexts that minimizes the expected
+// cost given the observed distribution and costs. Older observations decay, so the tuner follows
+// workload changes.
+//
+// This class is thread-safe.
+class AdaptiveSeekTuner {
+ public:
+  struct Metrics {
+    // Seeks that were replaced by Next() calls.
+    scoped_refptr<Counter> nexts_instead_of_seek;
+    // Seeks that were performed after trying Next() calls.
+    scoped_refptr<Counter> seeks_after_nexts;
+    // Currently chosen number of Next() calls to try.
+    scoped_refptr<AtomicGauge<uint32_t>> max_nexts_to_avoid_seek;
+  };
+
+  static constexpr int kMaxNexts = 32;
+
+  explicit AdaptiveSeekTuner(const Metrics& metrics = Metrics());
+
+  // Returns the number of Next() calls to try before seeking. Sets *probe if the caller should
+  // time the call and pass the result to RecordProbe instead of Record.
+  int NextsToTry(bool* probe);
+
+  // Records the outcome of a non-probe forward seek.
+  void Record(bool seeked);
+
+  // Records the outcome of a probe. nexts_time is the time taken by the nexts and seek_time the
+  // time taken by the seek, if it was performed.
+  void RecordProbe(int nexts, bool seeked, MonoDelta nexts_time, MonoDelta seek_time);
+
+  int max_nexts() const { return max_nexts_.load(std::memory_order_relaxed); }
+
+  // Makes the tuner choose a new number of nexts now instead of after the next batch of probes.
+  void TEST_Recompute() { Recompute(); }
+
+ private:
+  void Recompute();
+
+  static void UpdateAverage(std::atomic<uint64_t>* average, uint64_t sample);
+
+  const Metrics metrics_;
+
+  std::atomic<int> max_nexts_;
+  std::atomic<uint64_t> num_calls_{0};
+  std::atomic<uint64_t> num_probes_{0};
+
+  // probe_distances_[i] for i <= kMaxNexts is the number of probes that reached the target after
+  // i nexts; probe_distances_[kMaxNexts + 1] counts probes that had to seek.
+  std::array<std::atomic<uint64_t>, kMaxNexts + 2> probe_distances_;
+
+  // Exponential moving averages, in nanoseconds. Zero until the first sample.
+  std::atomic<uint64_t> next_cost_ns_{0};
+  std::atomic<uint64_t> seek_cost_ns_{0};
+
+  std::mutex recompute_mutex_;
+};
+
+}  // namespace docdb
+}  // namespace yb
+
+#endif  // YB_DOCDB_ADAPTIVE_SEEK_TUNER_H_
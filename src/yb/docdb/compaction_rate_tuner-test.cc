@@ -0,0 +1,100 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/compaction_rate_tuner.h"
+
+#include "yb/rocksdb/rate_limiter.h"
+
+#include "yb/util/size_literals.h"
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+using namespace yb::size_literals;
+
+DECLARE_int64(rocksdb_compaction_rate_min_bytes_per_sec);
+DECLARE_int64(rocksdb_compaction_rate_max_bytes_per_sec);
+DECLARE_int64(rocksdb_compaction_rate_target_read_latency_us);
+DECLARE_uint64(rocksdb_compaction_rate_pending_bytes_threshold);
+
+namespace yb {
+namespace docdb {
+
+constexpr int64_t kMB = 1_MB;
+
+class CompactionRateTunerTest : public YBTest {
+ protected:
+  void SetUp() override {
+    YBTest::SetUp();
+    FLAGS_rocksdb_compaction_rate_min_bytes_per_sec = 10_MB;
+    FLAGS_rocksdb_compaction_rate_max_bytes_per_sec = 200_MB;
+    FLAGS_rocksdb_compaction_rate_target_read_latency_us = 1000;
+    FLAGS_rocksdb_compaction_rate_pending_bytes_threshold = 1_GB;
+    rate_limiter_.reset(rocksdb::NewGenericRateLimiter(100_MB));
+  }
+
+  std::shared_ptr<rocksdb::RateLimiter> rate_limiter_;
+};
+
+TEST_F(CompactionRateTunerTest, RaisesWhileCompactionsFallBehind) {
+  CompactionRateTuner tuner(rate_limiter_, kMB * 100);
+  CompactionRateTuner::Signals signals;
+  ASSERT_EQ(kMB * 100, tuner.Update(signals));
+
+  signals.pending_compaction_bytes = 2_GB;
+  ASSERT_EQ(kMB * 125, tuner.Update(signals));
+  for (int i = 0; i != 10; ++i) {
+    tuner.Update(signals);
+  }
+  ASSERT_EQ(kMB * 200, tuner.bytes_per_second());
+}
+
+TEST_F(CompactionRateTunerTest, LowersWhileReadsAreSlow) {
+  CompactionRateTuner tuner(rate_limiter_, kMB * 100);
+  CompactionRateTuner::Signals signals;
+  signals.pending_compaction_bytes = 2_GB;
+  for (int i = 0; i != 2; ++i) {
+    signals.num_reads += 100;
+    signals.total_read_latency_us += 100 * 5000;
+    tuner.Update(signals);
+  }
+  ASSERT_EQ(kMB * 56 + kMB / 4, tuner.bytes_per_second());
+
+  for (int i = 0; i != 20; ++i) {
+    signals.num_reads += 100;
+    signals.total_read_latency_us += 100 * 5000;
+    tuner.Update(signals);
+  }
+  ASSERT_EQ(kMB * 10, tuner.bytes_per_second());
+
+  // Fast reads let the backlog raise the rate again.
+  signals.num_reads += 100;
+  signals.total_read_latency_us += 100 * 100;
+  ASSERT_EQ(kMB * 12 + kMB / 2, tuner.Update(signals));
+
+  // Totals that went down, because some tablets went away, are ignored.
+  signals.num_reads -= 50;
+  signals.total_read_latency_us -= 50 * 5000;
+  ASSERT_EQ(kMB * 15 + kMB / 2 + kMB / 8, tuner.Update(signals));
+}
+
+TEST_F(CompactionRateTunerTest, L0FilesOverrideSlowReads) {
+  CompactionRateTuner tuner(rate_limiter_, kMB * 100);
+  CompactionRateTuner::Signals signals;
+  signals.num_reads = 100;
+  signals.total_read_latency_us = 100 * 5000;
+  signals.max_l0_slowdown_ratio = 0.75;
+  ASSERT_EQ(kMB * 150, tuner.Update(signals));
+}
+
+}  // namespace docdb
+}  // namespace yb
@@ -0,0 +1,112 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/compaction_rate_tuner.h"
+
+#include <algorithm>
+
+#include <glog/logging.h>
+
+#include "yb/rocksdb/rate_limiter.h"
+
+#include "yb/util/flag_tags.h"
+#include "yb/util/size_literals.h"
+
+using namespace yb::size_literals;
+
+DEFINE_bool(rocksdb_compaction_rate_auto_tune, false,
+            "Periodically adjust the compaction and flush rate limit shared by all tablets of a "
+            "tablet server, based on the compaction backlog and foreground read latency.");
+TAG_FLAG(rocksdb_compaction_rate_auto_tune, advanced);
+
+DEFINE_int64(rocksdb_compaction_rate_min_bytes_per_sec, 16_MB,
+             "Lowest compaction and flush rate limit the auto tuner goes down to.");
+TAG_FLAG(rocksdb_compaction_rate_min_bytes_per_sec, advanced);
+
+DEFINE_int64(rocksdb_compaction_rate_max_bytes_per_sec, 1_GB,
+             "Highest compaction and flush rate limit the auto tuner goes up to.");
+TAG_FLAG(rocksdb_compaction_rate_max_bytes_per_sec, advanced);
+
+DEFINE_int64(rocksdb_compaction_rate_target_read_latency_us, 10000,
+             "Mean foreground read latency above which the auto tuner lowers the compaction and "
+             "flush rate limit.");
+TAG_FLAG(rocksdb_compaction_rate_target_read_latency_us, advanced);
+
+DEFINE_uint64(rocksdb_compaction_rate_pending_bytes_threshold, 1_GB,
+              "Estimated number of bytes pending compaction over all tablets above which the auto "
+              "tuner raises the compaction and flush rate limit.");
+TAG_FLAG(rocksdb_compaction_rate_pending_bytes_threshold, advanced);
+
+namespace yb {
+namespace docdb {
+
+namespace {
+
+// Ratio of level 0 files to level0_slowdown_writes_trigger at which compactions are raised even if
+// reads are slow, since throttled writes hurt more.
+constexpr double kUrgentL0SlowdownRatio = 0.5;
+
+constexpr double kUrgentIncreaseFactor = 1.5;
+constexpr double kIncreaseFactor = 1.25;
+constexpr double kDecreaseFactor = 0.75;
+
+} // namespace
+
+CompactionRateTuner::CompactionRateTuner(std::shared_ptr<rocksdb::RateLimiter> rate_limiter,
+                                         int64_t initial_bytes_per_second)
+    : rate_limiter_(std::move(rate_limiter)), bytes_per_second_(initial_bytes_per_second) {
+}
+
+int64_t CompactionRateTuner::Update(const Signals& signals) {
+  // The totals drop when tablets go away, in which case there is nothing to compare with.
+  bool reads_slow = false;
+  if (signals.num_reads > last_num_reads_ &&
+      signals.total_read_latency_us >= last_total_read_latency_us_) {
+    const uint64_t num_reads = signals.num_reads - last_num_reads_;
+    const uint64_t read_latency_us = signals.total_read_latency_us - last_total_read_latency_us_;
+    reads_slow = read_latency_us >
+        num_reads * std::max<int64_t>(FLAGS_rocksdb_compaction_rate_target_read_latency_us, 0);
+  }
+  last_num_reads_ = signals.num_reads;
+  last_total_read_latency_us_ = signals.total_read_latency_us;
+
+  double factor = 1.0;
+  if (signals.max_l0_slowdown_ratio >= kUrgentL0SlowdownRatio) {
+    factor = kUrgentIncreaseFactor;
+  } else if (reads_slow) {
+    factor = kDecreaseFactor;
+  } else if (signals.pending_compaction_bytes >=
+                 FLAGS_rocksdb_compaction_rate_pending_bytes_threshold) {
+    factor = kIncreaseFactor;
+  }
+
+  const int64_t min_bytes_per_second =
+      std::max<int64_t>(FLAGS_rocksdb_compaction_rate_min_bytes_per_sec, 1);
+  const int64_t max_bytes_per_second =
+      std::max(FLAGS_rocksdb_compaction_rate_max_bytes_per_sec, min_bytes_per_second);
+  const int64_t bytes_per_second = std::min(
+      std::max(static_cast<int64_t>(bytes_per_second_ * factor), min_bytes_per_second),
+      max_bytes_per_second);
+  if (bytes_per_second != bytes_per_second_) {
+    VLOG(1) << "Compaction rate limit " << bytes_per_second_ << " -> " << bytes_per_second
+            << " bytes/s, pending compaction bytes: " << signals.pending_compaction_bytes
+            << ", max L0 slowdown ratio: " << signals.max_l0_slowdown_ratio
+            << ", reads slow: " << reads_slow;
+    bytes_per_second_ = bytes_per_second;
+    rate_limiter_->SetBytesPerSecond(bytes_per_second);
+  }
+  return bytes_per_second_;
+}
+
+}  // namespace docdb
+}  // namespace yb
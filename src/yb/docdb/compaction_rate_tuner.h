@@ -0,0 +1,70 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_DOCDB_COMPACTION_RATE_TUNER_H_
+#define YB_DOCDB_COMPACTION_RATE_TUNER_H_
+
+#include <memory>
+
+namespace rocksdb {
+class RateLimiter;
+}
+
+namespace yb {
+namespace docdb {
+
+// Adjusts the compaction and flush rate limiter shared by all RocksDB instances of a tablet server.
+// A fixed rate either starves compactions while the server is idle or hurts foreground reads
+// under peak load, so the rate is raised while compactions fall behind and lowered while reads
+// are slow.
+//
+// The caller gathers Signals from all tablets and calls Update periodically, always from the same
+// thread.
+class CompactionRateTuner {
+ public:
+  struct Signals {
+    // Estimated number of bytes that compactions still have to rewrite, summed over all RocksDB
+    // instances.
+    uint64_t pending_compaction_bytes = 0;
+
+    // Highest ratio, over all RocksDB instances, of the number of level 0 files to
+    // level0_slowdown_writes_trigger. Writes get throttled once it reaches 1.
+    double max_l0_slowdown_ratio = 0;
+
+    // Totals of the foreground read latency histograms of all tablets, in microseconds. Since the
+    // histograms are cumulative, the tuner uses the difference from the previous Update.
+    uint64_t num_reads = 0;
+    uint64_t total_read_latency_us = 0;
+  };
+
+  CompactionRateTuner(std::shared_ptr<rocksdb::RateLimiter> rate_limiter,
+                      int64_t initial_bytes_per_second);
+
+  // Picks a new rate from the given signals and applies it to the rate limiter. Returns the new
+  // rate in bytes per second.
+  int64_t Update(const Signals& signals);
+
+  int64_t bytes_per_second() const { return bytes_per_second_; }
+
+ private:
+  const std::shared_ptr<rocksdb::RateLimiter> rate_limiter_;
+  int64_t bytes_per_second_;
+
+  uint64_t last_num_reads_ = 0;
+  uint64_t last_total_read_latency_us_ = 0;
+};
+
+}  // namespace docdb
+}  // namespace yb
+
+#endif  // YB_DOCDB_COMPACTION_RATE_TUNER_H_
@@ -88,6 +88,9 @@ class ConflictResolverContext {
 
   virtual bool IgnoreConflictsWith(const TransactionId& other) = 0;
 
+  // Whether CheckPriority found transactions that we should wait for, instead of aborting them.
+  virtual bool HasBlockers() = 0;
+
  protected:
   ~ConflictResolverContext() {}
 };
@@ -220,6 +223,9 @@ class ConflictResolver {
       }
 
       RETURN_NOT_OK(context_.CheckPriority(this, &transactions_));
+      if (context_.HasBlockers()) {
+        return Status::OK();
+      }
 
       RETURN_NOT_OK(AbortTransactions());
 
@@ -279,9 +285,11 @@ class ConflictResolver {
   void FetchTransactionStatuses() {
     static const std::string kRequestReason = "conflict resolution"s;
     CountDownLatch latch(transactions_.size());
+    std::vector<StatusRequest> requests;
+    requests.reserve(transactions_.size());
     for (auto& i : transactions_) {
       auto& transaction = i;
-      StatusRequest request = {
+      requests.push_back({
         &transaction.id,
         context_.GetHybridTime(),
         context_.GetHybridTime(),
@@ -302,9 +310,10 @@ class ConflictResolver {
           }
           latch.CountDown();
         }
-      };
-      status_manager().RequestStatusAt(request);
+      });
     }
+    // Statuses of transactions with the same status tablet are fetched by a single RPC.
+    status_manager().RequestStatusesAt(requests);
     latch.Wait();
   }
 
@@ -355,13 +364,15 @@ class TransactionConflictResolverContext : public ConflictResolverContext {
   TransactionConflictResolverContext(const DocOperations& doc_ops,
                                      const KeyValueWriteBatchPB& write_batch,
                                      HybridTime hybrid_time,
-                                     Counter* conflicts_metric)
+                                     Counter* conflicts_metric,
+                                     std::vector<TransactionId>* blockers)
       : doc_ops_(doc_ops),
         write_batch_(write_batch),
         hybrid_time_(hybrid_time),
         transaction_id_(FullyDecodeTransactionId(
             write_batch.transaction().transaction_id())),
-        conflicts_metric_(conflicts_metric)
+        conflicts_metric_(conflicts_metric),
+        blockers_(blockers)
   {}
 
   virtual ~TransactionConflictResolverContext() {}
@@ -472,7 +483,10 @@ class TransactionConflictResolverContext : public ConflictResolverContext {
       }
       auto their_priority = transaction.metadata.priority;
       if (our_priority < their_priority) {
-        return MakeConflictStatus(transaction.id, "higher priority", conflicts_metric_);
+        if (!blockers_) {
+          return MakeConflictStatus(transaction.id, "higher priority", conflicts_metric_);
+        }
+        blockers_->push_back(transaction.id);
       }
     }
     fetched_metadata_for_transactions_ = true;
@@ -480,6 +494,10 @@ class TransactionConflictResolverContext : public ConflictResolverContext {
     return Status::OK();
   }
 
+  bool HasBlockers() override {
+    return blockers_ && !blockers_->empty();
+  }
+
   CHECKED_STATUS CheckConflictWithCommitted(
       const TransactionId& id, HybridTime commit_time) override {
     DSCHECK(commit_time.is_valid(), Corruption, "Invalid transaction commit time");
@@ -519,6 +537,7 @@ class TransactionConflictResolverContext : public ConflictResolverContext {
   Status result_ = Status::OK();
   bool fetched_metadata_for_transactions_ = false;
   Counter* conflicts_metric_ = nullptr;
+  std::vector<TransactionId>* blockers_;
 };
 
 class OperationConflictResolverContext : public ConflictResolverContext {
@@ -566,6 +585,10 @@ class OperationConflictResolverContext : public ConflictResolverContext {
     return Status::OK();
   }
 
+  bool HasBlockers() override {
+    return false;
+  }
+
   HybridTime GetHybridTime() override {
     return hybrid_time_;
   }
@@ -592,10 +615,11 @@ Status ResolveTransactionConflicts(const DocOperations& doc_ops,
                                    HybridTime hybrid_time,
                                    const DocDB& doc_db,
                                    TransactionStatusManager* status_manager,
-                                   Counter* conflicts_metric) {
+                                   Counter* conflicts_metric,
+                                   std::vector<TransactionId>* blockers) {
   DCHECK(hybrid_time.is_valid());
   TransactionConflictResolverContext context(
-      doc_ops, write_batch, hybrid_time, conflicts_metric);
+      doc_ops, write_batch, hybrid_time, conflicts_metric, blockers);
   ConflictResolver resolver(doc_db, status_manager, &context);
   return resolver.Resolve();
 }
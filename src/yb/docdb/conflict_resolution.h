@@ -14,6 +14,8 @@
 #ifndef YB_DOCDB_CONFLICT_RESOLUTION_H
 #define YB_DOCDB_CONFLICT_RESOLUTION_H
 
+#include "yb/common/transaction.h"
+
 #include "yb/docdb/doc_operation.h"
 #include "yb/docdb/value_type.h"
 
@@ -46,12 +48,19 @@ class KeyValueWriteBatchPB;
 // db - db that contains tablet data.
 // status_manager - status manager that should be used during this conflict resolution.
 // conflicts_metric - transaction_conflicts metric to update.
+// Resolves conflicts of the transactional write batch with the intents of other transactions.
+// Transactions of lower priority are aborted. If the write conflicts with a transaction of higher
+// priority, it fails with TryAgain. Unless 'blockers' is specified: then the pending transactions
+// of higher priority are stored there, and the caller should retry once they finished. Since only
+// transactions of lower priority wait for transactions of higher priority, waits never form a
+// cycle.
 CHECKED_STATUS ResolveTransactionConflicts(const DocOperations& doc_ops,
                                            const KeyValueWriteBatchPB& write_batch,
                                            HybridTime hybrid_time,
                                            const DocDB& doc_db,
                                            TransactionStatusManager* status_manager,
-                                           Counter* conflicts_metric);
+                                           Counter* conflicts_metric,
+                                           std::vector<TransactionId>* blockers = nullptr);
 
 // Resolves conflicts for doc operations.
 // Read all intents that could conflict with provided doc_ops.
@@ -17,12 +17,17 @@
 
 #include "yb/docdb/consensus_frontier.h"
 #include "yb/docdb/doc_key.h"
+#include "yb/docdb/doc_kv_util.h"
+#include "yb/docdb/value.h"
+#include "yb/gutil/endian.h"
 
 namespace yb {
 namespace docdb {
 
 Status GetDocHybridTime(const rocksdb::UserBoundaryValues& values, DocHybridTime* out);
 
+Status GetMaxValueTtl(const rocksdb::UserBoundaryValues& values, MonoDelta* out);
+
 Status GetPrimitiveValue(const rocksdb::UserBoundaryValues& values,
                          size_t index,
                          PrimitiveValue* out);
@@ -30,6 +35,8 @@ Status GetPrimitiveValue(const rocksdb::UserBoundaryValues& values,
 namespace {
 
 constexpr rocksdb::UserBoundaryTag kDocHybridTimeTag = 1;
+constexpr rocksdb::UserBoundaryTag kValueTtlTag = 2;
+constexpr uint64_t kTtlNeverExpires = std::numeric_limits<uint64_t>::max();
 // Here we reserve some tags for future use.
 // Because Tag is persistent.
 constexpr rocksdb::UserBoundaryTag kRangeComponentsStart = 10;
@@ -80,6 +87,71 @@ class DocHybridTimeValue : public rocksdb::UserBoundaryValue {
   Slice encoded_;
 };
 
+// Wrapper for UserBoundaryValue that stores the TTL of a value in milliseconds, so that the largest
+// boundary of a file bounds the TTLs of all its values. Values that use the default TTL of the
+// table are stored as 0, and values that never expire as kTtlNeverExpires.
+class ValueTtlBoundaryValue : public rocksdb::UserBoundaryValue {
+ public:
+  explicit ValueTtlBoundaryValue(uint64_t ttl_ms) {
+    BigEndian::Store64(buffer_, ttl_ms);
+  }
+
+  static CHECKED_STATUS Create(Slice data, rocksdb::UserBoundaryValuePtr* value) {
+    CHECK_NOTNULL(value);
+    if (data.size() != sizeof(uint64_t)) {
+      return STATUS_SUBSTITUTE(Corruption, "Wrong size of encoded value TTL: $0", data.size());
+    }
+
+    *value = std::make_shared<ValueTtlBoundaryValue>(BigEndian::Load64(data.data()));
+    return Status::OK();
+  }
+
+  static rocksdb::UserBoundaryValuePtr FromValue(Slice value) {
+    uint64_t merge_flags = 0;
+    MonoDelta ttl;
+    if (!Value::DecodeMergeFlags(&value, &merge_flags).ok() || merge_flags != 0 ||
+        !Value::DecodeTTL(&value, &ttl).ok()) {
+      // Merge records change the expiration of other values, and nothing is known about the
+      // expiration of values that could not be decoded, so both are treated as never expiring.
+      return std::make_shared<ValueTtlBoundaryValue>(kTtlNeverExpires);
+    }
+    if (ttl.Equals(Value::kMaxTtl)) {
+      return std::make_shared<ValueTtlBoundaryValue>(0);
+    }
+    const auto ttl_ms = ttl.ToMilliseconds();
+    return std::make_shared<ValueTtlBoundaryValue>(
+        ttl_ms <= static_cast<int64_t>(kResetTTL) ? kTtlNeverExpires : ttl_ms);
+  }
+
+  virtual ~ValueTtlBoundaryValue() {}
+
+  rocksdb::UserBoundaryTag Tag() override {
+    return kValueTtlTag;
+  }
+
+  Slice Encode() override {
+    return Slice(buffer_, sizeof(buffer_));
+  }
+
+  int CompareTo(const UserBoundaryValue& pre_rhs) override {
+    const auto* rhs = down_cast<const ValueTtlBoundaryValue*>(&pre_rhs);
+    return Slice(buffer_, sizeof(buffer_)).compare(Slice(rhs->buffer_, sizeof(rhs->buffer_)));
+  }
+
+  // Returns Value::kMaxTtl for values that use the default TTL of the table, and
+  // Value::kResetTtl for values that never expire.
+  MonoDelta value() const {
+    const uint64_t ttl_ms = BigEndian::Load64(buffer_);
+    if (ttl_ms == 0) {
+      return Value::kMaxTtl;
+    }
+    return ttl_ms == kTtlNeverExpires ? Value::kResetTtl : MonoDelta::FromMilliseconds(ttl_ms);
+  }
+
+ private:
+  char buffer_[sizeof(uint64_t)];
+};
+
 // Wrapper for UserBoundaryValue that stores PrimitiveValue with index.
 class PrimitiveBoundaryValue : public rocksdb::UserBoundaryValue {
  public:
@@ -147,6 +219,9 @@ class DocBoundaryValuesExtractor : public rocksdb::BoundaryValuesExtractor {
     if (tag == kDocHybridTimeTag) {
       return DocHybridTimeValue::Create(data, value);
     }
+    if (tag == kValueTtlTag) {
+      return ValueTtlBoundaryValue::Create(data, value);
+    }
     if (tag >= kRangeComponentsStart) {
       return PrimitiveBoundaryValue::Create(tag - kRangeComponentsStart, data, value);
     }
@@ -176,6 +251,7 @@ class DocBoundaryValuesExtractor : public rocksdb::BoundaryValuesExtractor {
     rocksdb::UserBoundaryValuePtr temp;
     RETURN_NOT_OK(DocHybridTimeValue::Create(slices.back(), &temp));
     values->push_back(std::move(temp));
+    values->push_back(ValueTtlBoundaryValue::FromValue(value));
 
     for (size_t i = 0; i != size; ++i) {
       RETURN_NOT_OK(PrimitiveBoundaryValue::Create(i, slices[i], &temp));
@@ -252,6 +328,19 @@ Status GetDocHybridTime(const rocksdb::UserBoundaryValues& values, DocHybridTime
   return time_value->value(out);
 }
 
+Status GetMaxValueTtl(const rocksdb::UserBoundaryValues& values, MonoDelta* out) {
+  auto value = rocksdb::UserValueWithTag(values, kValueTtlTag);
+  if (!value) {
+    return STATUS(NotFound, "Not found value for value TTL");
+  }
+  *out = down_cast<ValueTtlBoundaryValue*>(value.get())->value();
+  return Status::OK();
+}
+
+rocksdb::UserBoundaryTag TagForDocHybridTime() {
+  return kDocHybridTimeTag;
+}
+
 rocksdb::UserBoundaryTag TagForRangeComponent(size_t index) {
   return PrimitiveBoundaryValue::TagForIndex(index);
 }
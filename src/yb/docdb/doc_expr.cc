@@ -156,6 +156,58 @@ CHECKED_STATUS DocExprExecutor::EvalTSCall(const QLBCallPB& tscall,
 
 //--------------------------------------------------------------------------------------------------
 
+CHECKED_STATUS DocExprExecutor::EvalTSCall(const PgsqlBCallPB& tscall,
+                                           const QLTableRow::SharedPtrConst& table_row,
+                                           QLValue *result) {
+  bfpg::TSOpcode tsopcode = static_cast<bfpg::TSOpcode>(tscall.opcode());
+  switch (tsopcode) {
+    case bfpg::TSOpcode::kCount: {
+      // COUNT(*) has no operand or a constant one. COUNT(expr) does not count NULL values.
+      if (tscall.operands().size() > 0 && !tscall.operands(0).has_value()) {
+        QLValue arg_result;
+        RETURN_NOT_OK(EvalExpr(tscall.operands(0), table_row, &arg_result));
+        if (arg_result.IsNull()) {
+          return Status::OK();
+        }
+      }
+      return EvalCount(result);
+    }
+
+    case bfpg::TSOpcode::kSum: {
+      QLValue arg_result;
+      RETURN_NOT_OK(EvalExpr(tscall.operands(0), table_row, &arg_result));
+      return EvalSum(arg_result, result);
+    }
+
+    case bfpg::TSOpcode::kMin: {
+      QLValue arg_result;
+      RETURN_NOT_OK(EvalExpr(tscall.operands(0), table_row, &arg_result));
+      return EvalMin(arg_result, result);
+    }
+
+    case bfpg::TSOpcode::kMax: {
+      QLValue arg_result;
+      RETURN_NOT_OK(EvalExpr(tscall.operands(0), table_row, &arg_result));
+      return EvalMax(arg_result, result);
+    }
+
+    case bfpg::TSOpcode::kAvg: {
+      QLValue arg_result;
+      RETURN_NOT_OK(EvalExpr(tscall.operands(0), table_row, &arg_result));
+      return EvalAvg(arg_result, result);
+    }
+
+    default:
+      break;
+  }
+
+  result->SetNull();
+  return STATUS_FORMAT(NotSupported, "Unsupported PGSQL tablet-server operator: $0",
+                       static_cast<int>(tsopcode));
+}
+
+//--------------------------------------------------------------------------------------------------
+
 CHECKED_STATUS DocExprExecutor::EvalCount(QLValue *aggr_count) {
   if (aggr_count->IsNull()) {
     aggr_count->set_int64_value(1);
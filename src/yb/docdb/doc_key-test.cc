@@ -14,6 +14,7 @@
 #include "yb/docdb/doc_key.h"
 
 #include <memory>
+#include <random>
 
 #include "yb/rocksdb/table.h"
 #include "yb/rocksdb/table/full_filter_block.h"
@@ -373,6 +374,90 @@ TEST(DocKeyTest, TestKeyMatching) {
   ASSERT_FALSE(may_match(EncodeSimpleSubDocKey(absent_key))) << "Key: " << absent_key;
 }
 
+TEST(DocKeyTest, TestRangeComponentsKeyMatching) {
+  DocDbAwareFilterPolicy policy(
+      rocksdb::FilterPolicy::kDefaultFixedSizeFilterBits, nullptr, 1 /* num_range_components */);
+  ASSERT_STRNE(
+      policy.Name(),
+      DocDbAwareFilterPolicy(rocksdb::FilterPolicy::kDefaultFixedSizeFilterBits, nullptr).Name());
+  const auto* transformer = policy.GetKeyTransformer();
+
+  auto row_key = [](const std::string& first, const std::string& second) {
+    return SubDocKey(DocKey({PrimitiveValue(first), PrimitiveValue(second)}),
+                     PrimitiveValue("column"), HybridTime::FromMicros(1000)).Encode();
+  };
+
+  std::unique_ptr<FilterBitsBuilder> builder(policy.GetFilterBitsBuilder());
+  for (const auto& first : { "foo", "bar", "test" }) {
+    builder->AddKey(transformer->Transform(row_key(first, "x").AsSlice()));
+  }
+  std::unique_ptr<const char[]> buf;
+  rocksdb::Slice filter = builder->Finish(&buf);
+  std::unique_ptr<FilterBitsReader> reader(policy.GetFilterBitsReader(filter));
+
+  auto may_match = [&](const KeyBytes& key) {
+    return reader->MayMatch(transformer->Transform(key.AsSlice()));
+  };
+
+  // Only the first range component takes part in filtering.
+  ASSERT_TRUE(may_match(row_key("foo", "y")));
+  ASSERT_TRUE(may_match(DocKey({PrimitiveValue("bar")}).Encode()));
+  ASSERT_FALSE(may_match(row_key("fake", "x")));
+
+  // A scan of the whole table could not use the filter, a scan by the first column could.
+  ASSERT_FALSE(transformer->IsFilterableLookupKey(DocKey().Encode().AsSlice()));
+  ASSERT_TRUE(transformer->IsFilterableLookupKey(
+      DocKey({PrimitiveValue("foo")}).Encode().AsSlice()));
+  ASSERT_TRUE(transformer->IsFilterableLookupKey(row_key("foo", "x").AsSlice()));
+}
+
+// Measures decoding of keys that look like the keys of a table with a hashed string column, a
+// descending string column and an integer column, followed by a column id and a hybrid time.
+TEST(DocKeyTest, DecodePerformance) {
+  constexpr int kNumKeys = 100000;
+  constexpr int kIterations = 20;
+  std::mt19937_64 rng(12345);
+  auto random_string = [&rng](size_t min_length, size_t max_length) {
+    std::string result;
+    const size_t length = std::uniform_int_distribution<size_t>(min_length, max_length)(rng);
+    for (size_t i = 0; i != length; ++i) {
+      // Zero bytes are escaped, so some of them show up.
+      result.push_back(rng() % 32 == 0 ? '\0' : 'a' + rng() % 26);
+    }
+    return result;
+  };
+
+  std::vector<SubDocKey> keys;
+  std::vector<KeyBytes> encoded_keys;
+  for (int i = 0; i != kNumKeys; ++i) {
+    keys.emplace_back(
+        DocKey(static_cast<DocKeyHash>(rng() & 0xffff),
+               {PrimitiveValue(random_string(8, 16))},
+               {PrimitiveValue(random_string(4, 48), SortOrder::kDescending),
+                PrimitiveValue(static_cast<int64_t>(rng()))}),
+        PrimitiveValue(ColumnId(rng() % 20 + 10)),
+        HybridTime::FromMicros(1500000000000000 + rng() % 1000000000));
+    encoded_keys.push_back(keys.back().Encode());
+  }
+
+  SubDocKey decoded_key;
+  auto start_time = MonoTime::Now();
+  for (int iteration = 0; iteration != kIterations; ++iteration) {
+    for (const auto& encoded_key : encoded_keys) {
+      ASSERT_OK_FAST(decoded_key.FullyDecodeFrom(encoded_key.AsSlice()));
+    }
+  }
+  auto passed = MonoTime::Now() - start_time;
+  LOG(INFO) << "Decoded " << kNumKeys * kIterations << " keys in " << passed << ", "
+            << passed.ToNanoseconds() / (kNumKeys * kIterations) << " ns per key";
+
+  for (int i = 0; i != kNumKeys; ++i) {
+    ASSERT_OK(decoded_key.FullyDecodeFrom(encoded_keys[i].AsSlice()));
+    ASSERT_EQ(keys[i], decoded_key);
+    ASSERT_EQ(encoded_keys[i].ToString(), decoded_key.Encode().ToString());
+  }
+}
+
 TEST(DocKeyTest, TestWriteId) {
   SubDocKey subdoc_key(DocKey({PrimitiveValue("a"), PrimitiveValue(135)}),
                        DocHybridTime(1000000, 4091, 135));
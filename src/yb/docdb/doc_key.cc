@@ -25,6 +25,7 @@
 #include "yb/gutil/strings/substitute.h"
 #include "yb/rocksutil/yb_rocksdb.h"
 #include "yb/util/enums.h"
+#include "yb/util/format.h"
 #include "yb/util/compare_util.h"
 
 using std::ostringstream;
@@ -804,19 +805,71 @@ class HashedComponentsExtractor : public rocksdb::FilterPolicy::KeyTransformer {
   HashedComponentsExtractor(const HashedComponentsExtractor&) = delete;
   HashedComponentsExtractor& operator=(const HashedComponentsExtractor&) = delete;
 
-  static HashedComponentsExtractor& GetInstance() {
-    static HashedComponentsExtractor instance;
-    return instance;
-  }
-
   Slice Transform(Slice key) const override {
     auto size = CHECK_RESULT(DocKey::EncodedSize(key, DocKeyPart::HASHED_PART_ONLY));
     return Slice(key.data(), size);
   }
 };
 
+// Extracts the hashed components and the first num_range_components range components of a key.
+// Keys with fewer range components are left with all of them.
+class RangeComponentsExtractor : public rocksdb::FilterPolicy::KeyTransformer {
+ public:
+  explicit RangeComponentsExtractor(size_t num_range_components)
+      : num_range_components_(num_range_components) {}
+
+  RangeComponentsExtractor(const RangeComponentsExtractor&) = delete;
+  RangeComponentsExtractor& operator=(const RangeComponentsExtractor&) = delete;
+
+  Slice Transform(Slice key) const override {
+    return Slice(key.data(), CHECK_RESULT(Extract(key)).first);
+  }
+
+  bool IsFilterableLookupKey(Slice key) const override {
+    auto result = Extract(key);
+    return result.ok() && result->second == num_range_components_;
+  }
+
+ private:
+  // Returns the size of the extracted prefix and the number of range components in it.
+  Result<std::pair<size_t, size_t>> Extract(Slice key) const {
+    const auto hashed_size = VERIFY_RESULT(DocKey::EncodedSize(key, DocKeyPart::HASHED_PART_ONLY));
+    Slice range_part(key.data() + hashed_size, key.size() - hashed_size);
+    size_t num_components = 0;
+    while (num_components < num_range_components_ && !range_part.empty() &&
+           VERIFY_RESULT(ConsumePrimitiveValueFromKey(&range_part))) {
+      ++num_components;
+    }
+    return std::make_pair(static_cast<size_t>(range_part.data() - key.data()), num_components);
+  }
+
+  const size_t num_range_components_;
+};
+
+std::string FilterPolicyName(size_t num_range_components) {
+  return num_range_components == 0
+      ? "DocKeyHashedComponentsFilter"
+      : Format("DocKeyHashedAndRangeComponentsFilter$0", num_range_components);
+}
+
 } // namespace
 
+DocDbAwareFilterPolicy::DocDbAwareFilterPolicy(
+    size_t filter_block_size_bits, rocksdb::Logger* logger, size_t num_range_components,
+    rocksdb::FixedSizeFilterFormat format)
+    : num_range_components_(num_range_components),
+      name_(FilterPolicyName(num_range_components)) {
+  builtin_policy_.reset(rocksdb::NewFixedSizeFilterPolicy(
+      filter_block_size_bits, rocksdb::FilterPolicy::kDefaultFixedSizeFilterErrorRate, logger,
+      format));
+  if (num_range_components == 0) {
+    key_transformer_ = std::make_unique<HashedComponentsExtractor>();
+  } else {
+    key_transformer_ = std::make_unique<RangeComponentsExtractor>(num_range_components);
+  }
+}
+
+DocDbAwareFilterPolicy::~DocDbAwareFilterPolicy() = default;
 
 void DocDbAwareFilterPolicy::CreateFilter(
     const rocksdb::Slice* keys, int n, std::string* dst) const {
@@ -843,7 +896,14 @@ rocksdb::FilterPolicy::FilterType DocDbAwareFilterPolicy::GetFilterType() const
 }
 
 const rocksdb::FilterPolicy::KeyTransformer* DocDbAwareFilterPolicy::GetKeyTransformer() const {
-  return &HashedComponentsExtractor::GetInstance();
+  return key_transformer_.get();
+}
+
+size_t DocKeyGroupExtractor::GroupPrefixSize(const Slice& user_key) const {
+  // Keys that are not prefixed by a DocKey, e.g. transaction metadata in the intents DB, are
+  // left ungrouped.
+  auto size = DocKey::EncodedSize(user_key, DocKeyPart::WHOLE_DOC_KEY);
+  return size.ok() ? *size : 0;
 }
 
 }  // namespace docdb
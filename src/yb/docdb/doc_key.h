@@ -21,6 +21,7 @@
 
 #include "yb/rocksdb/env.h"
 #include "yb/rocksdb/filter_policy.h"
+#include "yb/rocksdb/table.h"
 
 #include "yb/common/schema.h"
 #include "yb/docdb/primitive_value.h"
@@ -35,6 +36,8 @@ namespace docdb {
 using DocKeyHash = uint16_t;
 
 class DocPath;
+class AdaptiveSeekTuner;
+class DocRowCache;
 
 // ------------------------------------------------------------------------------------------------
 // DocKey
@@ -547,15 +550,24 @@ inline std::ostream& operator <<(std::ostream& out, const SubDocKey& subdoc_key)
 std::string BestEffortDocDBKeyToStr(const KeyBytes &key_bytes);
 std::string BestEffortDocDBKeyToStr(const rocksdb::Slice &slice);
 
-// This filter policy only takes into account hashed components of keys for filtering.
+// This filter policy only takes into account hashed components of keys and the first
+// num_range_components range components for filtering. Lookups by keys that have fewer range
+// components, i.e. prefix scans on fewer range columns, are not checked against the filter.
+//
+// The number of range components is part of the policy name, so SST files built with a different
+// number are not filtered instead of being filtered incorrectly. The format of the filter blocks is
+// not, since filter blocks of all formats are read.
 class DocDbAwareFilterPolicy : public rocksdb::FilterPolicy {
  public:
-  explicit DocDbAwareFilterPolicy(size_t filter_block_size_bits, rocksdb::Logger* logger) {
-    builtin_policy_.reset(rocksdb::NewFixedSizeFilterPolicy(
-        filter_block_size_bits, rocksdb::FilterPolicy::kDefaultFixedSizeFilterErrorRate, logger));
-  }
+  DocDbAwareFilterPolicy(
+      size_t filter_block_size_bits, rocksdb::Logger* logger, size_t num_range_components = 0,
+      rocksdb::FixedSizeFilterFormat format = rocksdb::FixedSizeFilterFormat::kDefault);
+
+  ~DocDbAwareFilterPolicy();
+
+  const char* Name() const override { return name_.c_str(); }
 
-  const char* Name() const override { return "DocKeyHashedComponentsFilter"; }
+  size_t num_range_components() const { return num_range_components_; }
 
   void CreateFilter(const rocksdb::Slice* keys, int n, std::string* dst) const override;
 
@@ -570,13 +582,30 @@ class DocDbAwareFilterPolicy : public rocksdb::FilterPolicy {
   const KeyTransformer* GetKeyTransformer() const override;
 
  private:
+  const size_t num_range_components_;
+  const std::string name_;
   std::unique_ptr<const rocksdb::FilterPolicy> builtin_policy_;
+  std::unique_ptr<const KeyTransformer> key_transformer_;
+};
+
+// Groups keys by their encoded DocKey, so that data blocks place restart points at row boundaries
+// and the keys of the row share the DocKey through delta encoding.
+class DocKeyGroupExtractor : public rocksdb::KeyGroupExtractor {
+ public:
+  const char* Name() const override { return "DocKeyGroupExtractor"; }
+
+  size_t GroupPrefixSize(const Slice& user_key) const override;
 };
 
 // Combined DB to store regular records and intents.
 struct DocDB {
   rocksdb::DB* regular;
   rocksdb::DB* intents;
+  // Optional cache of decoded rows of the regular DB, used by point reads.
+  DocRowCache* row_cache = nullptr;
+  // Optional tuners of the number of nexts to try before seeking in each of the DBs.
+  AdaptiveSeekTuner* regular_seek_tuner = nullptr;
+  AdaptiveSeekTuner* intents_seek_tuner = nullptr;
 
   static DocDB FromRegular(rocksdb::DB* regular) {
     return {regular, nullptr /* intents */};
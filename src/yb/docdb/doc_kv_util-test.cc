@@ -114,6 +114,28 @@ TEST(DocKVUtilTest, ZeroEncodingAndDecoding) {
   }
 }
 
+TEST(DocKVUtilTest, ComplementZeroEncodingAndDecoding) {
+  rocksdb::Random rng(12345); // initialize with a fixed seed
+  for (int i = 0; i < 1000; ++i) {
+    int len = rng.Next() % 200;
+    string s;
+    s.reserve(len);
+    for (int j = 0; j < len; ++j) {
+      // Make 0x00 and 0xff frequent, so both escaped and terminating sequences show up.
+      const auto r = rng.Next() % 4;
+      s.push_back(r == 0 ? '\0' : (r == 1 ? '\xff' : static_cast<char>(rng.Next())));
+    }
+    string encoded_str;
+    ComplementZeroEncodeAndAppendStrToKey(s, &encoded_str);
+    encoded_str.push_back('x');
+    rocksdb::Slice slice(encoded_str);
+    string decoded_str;
+    ASSERT_OK(DecodeComplementZeroEncodedStr(&slice, &decoded_str));
+    ASSERT_EQ(s, decoded_str);
+    ASSERT_EQ("x", slice.ToBuffer());
+  }
+}
+
 TEST(DocKVUtilTest, TableTTL) {
   Schema schema;
   EXPECT_TRUE(TableTTL(schema).Equals(Value::kMaxTtl));
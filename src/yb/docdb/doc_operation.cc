@@ -13,6 +13,9 @@
 
 #include "yb/docdb/doc_operation.h"
 
+#include <algorithm>
+#include <functional>
+
 #include <boost/optional/optional_io.hpp>
 
 #include "yb/common/jsonb.h"
@@ -31,6 +34,7 @@
 #include "yb/docdb/doc_pgsql_scanspec.h"
 #include "yb/docdb/doc_rowwise_iterator.h"
 #include "yb/docdb/intent_aware_iterator.h"
+#include "yb/docdb/packed_row.h"
 #include "yb/docdb/subdocument.h"
 
 #include "yb/server/hybrid_clock.h"
@@ -38,6 +42,7 @@
 #include "yb/util/flag_tags.h"
 #include "yb/util/stol_utils.h"
 #include "yb/util/trace.h"
+#include "yb/util/random_util.h"
 #include "yb/util/redis_util.h"
 
 DECLARE_bool(trace_docdb_calls);
@@ -51,6 +56,11 @@ DEFINE_bool(emulate_redis_responses,
     "and HDEL. If emulate_redis_responses is true, we read the required records to compute the "
     "response as specified by the official Redis API documentation. https://redis.io/commands");
 
+DEFINE_bool(ysql_enable_packed_row, false,
+            "Whether YSQL inserts should write all columns of a row as one packed DocDB entry. "
+            "Rows written in the packed format can be read regardless of this flag.");
+TAG_FLAG(ysql_enable_packed_row, advanced);
+
 DEFINE_test_flag(bool, pause_write_apply_after_if, false,
                  "Pause application of QLWriteOperation after evaluating if condition.");
 
@@ -416,6 +426,87 @@ CHECKED_STATUS AddResponseValuesSortedSets(const PrimitiveValue& first,
   return Status::OK();
 }
 
+// Groups the samples of a time series, passed in the order of the response, by intervals of the
+// given step, and adds one sample per interval to the response: the start of the interval and the
+// aggregate of the values in it.
+class TsAggregator {
+ public:
+  TsAggregator(RedisCollectionGetRangeRequestPB::TsAggregation aggregation, int64_t step)
+      : aggregation_(aggregation), step_(step) {}
+
+  CHECKED_STATUS operator()(const PrimitiveValue& timestamp,
+                            const PrimitiveValue& value,
+                            RedisResponsePB* response,
+                            bool add_keys,
+                            bool add_values,
+                            bool reverse) {
+    const int64_t ts = timestamp.GetInt64();
+    int64_t interval = ts / step_ * step_;
+    if (interval > ts) {
+      interval -= step_;
+    }
+    if (count_ != 0 && interval != interval_) {
+      Flush(response->mutable_array_response());
+    }
+    interval_ = interval;
+    if (aggregation_ != RedisCollectionGetRangeRequestPB::TS_COUNT) {
+      const auto& str = value.GetString();
+      auto number = util::CheckedStold(str);
+      if (!number.ok()) {
+        return STATUS_FORMAT(InvalidArgument, "Time series value is not a number: $0", str);
+      }
+      sum_ += *number;
+      if (count_ == 0 || *number < min_) {
+        min_ = *number;
+        min_value_ = str;
+      }
+      if (count_ == 0 || *number > max_) {
+        max_ = *number;
+        max_value_ = str;
+      }
+    }
+    ++count_;
+    return Status::OK();
+  }
+
+  void Finish(RedisArrayPB* array) {
+    if (count_ != 0) {
+      Flush(array);
+    }
+  }
+
+ private:
+  void Flush(RedisArrayPB* array) {
+    array->add_elements(std::to_string(interval_));
+    switch (aggregation_) {
+      case RedisCollectionGetRangeRequestPB::TS_AVG:
+        array->add_elements(std::to_string(static_cast<double>(sum_ / count_)));
+        break;
+      case RedisCollectionGetRangeRequestPB::TS_MIN:
+        array->add_elements(min_value_);
+        break;
+      case RedisCollectionGetRangeRequestPB::TS_MAX:
+        array->add_elements(max_value_);
+        break;
+      case RedisCollectionGetRangeRequestPB::TS_COUNT:
+        array->add_elements(std::to_string(count_));
+        break;
+    }
+    count_ = 0;
+    sum_ = 0;
+  }
+
+  const RedisCollectionGetRangeRequestPB::TsAggregation aggregation_;
+  const int64_t step_;
+  int64_t interval_ = 0;
+  int64_t count_ = 0;
+  long double sum_ = 0;
+  long double min_ = 0;
+  long double max_ = 0;
+  std::string min_value_;
+  std::string max_value_;
+};
+
 template <typename T, typename AddResponseRow>
 CHECKED_STATUS PopulateRedisResponseFromInternal(T iter,
                                                  AddResponseRow add_response_row,
@@ -1560,6 +1651,18 @@ Status RedisReadOperation::ExecuteCollectionGetRangeByBounds(
       // If reverse is false, newest element is the first element returned.
       is_reverse = false;
     }
+    const auto& range_request = request_.get_collection_range_request();
+    if (range_request.has_ts_aggregation()) {
+      TsAggregator aggregator(range_request.ts_aggregation(),
+                              range_request.ts_aggregation_step());
+      RETURN_NOT_OK(GetAndPopulateResponseValues(
+          iterator_.get(), std::ref(aggregator), data, ValueType::kRedisTS, request_, &response_,
+          /* add_keys */ true, /* add_values */ true, is_reverse));
+      if (response_.code() == RedisResponsePB::OK) {
+        aggregator.Finish(response_.mutable_array_response());
+      }
+      return Status::OK();
+    }
     RETURN_NOT_OK(GetAndPopulateResponseValues(
         iterator_.get(), AddResponseValuesGeneric, data, ValueType::kRedisTS, request_, &response_,
         /* add_keys */ true, /* add_values */ true, is_reverse));
@@ -2881,6 +2984,30 @@ QLExpressionPB* NewKeyColumn(QLWriteRequestPB* request, const IndexInfo& index,
           : request->add_range_column_values());
 }
 
+// Sets the value of an index column for the value of its indexed column. For an index on a jsonb
+// path, it is the element at the path, as text because the index column is text.
+Status SetIndexColumnValue(const IndexInfo::IndexColumn& index_column, const QLValuePB& value,
+                           QLValuePB* index_value) {
+  if (!index_column.is_json_path()) {
+    index_value->CopyFrom(value);
+    return Status::OK();
+  }
+  index_value->Clear();
+  if (value.value_case() != QLValuePB::kJsonbValue) {
+    return Status::OK();
+  }
+  QLValue element;
+  RETURN_NOT_OK(common::Jsonb::ApplyJsonbOperators(
+      value.jsonb_value(), index_column.json_ops, &element));
+  if (element.value().value_case() == QLValuePB::kJsonbValue) {
+    RETURN_NOT_OK(common::Jsonb(element.jsonb_value()).ToJsonString(
+        index_value->mutable_string_value()));
+  } else {
+    index_value->Swap(element.mutable_value());
+  }
+  return Status::OK();
+}
+
 } // namespace
 
 QLWriteRequestPB* QLWriteOperation::NewIndexRequest(const IndexInfo* index,
@@ -2910,20 +3037,29 @@ Status QLWriteOperation::UpdateIndexes(const QLTableRow& existing_row, const QLT
         const IndexInfo::IndexColumn& index_column = index->column(idx);
         QLExpressionPB *key_column = NewKeyColumn(index_request, *index, idx);
         auto result = new_row.GetValue(index_column.indexed_column_id);
+        bool column_changed = false;
         if (!existing_row.IsEmpty()) {
           // For each column in the index key, if there is a new value, see if the value is changed
           // from the current value. Else, use the current value.
           if (result) {
-            if (!new_row.MatchColumn(index_column.indexed_column_id, existing_row)) {
-              index_key_changed = true;
-            }
+            column_changed = !new_row.MatchColumn(index_column.indexed_column_id, existing_row);
           } else {
             result = existing_row.GetValue(index_column.indexed_column_id);
           }
         }
         if (result) {
-          key_column->mutable_value()->CopyFrom(*result);
+          RETURN_NOT_OK(SetIndexColumnValue(index_column, *result, key_column->mutable_value()));
         }
+        if (column_changed && index_column.is_json_path()) {
+          // Other changes of the jsonb document do not change the indexed element.
+          QLValuePB existing_value;
+          const auto existing = existing_row.GetValue(index_column.indexed_column_id);
+          if (existing) {
+            RETURN_NOT_OK(SetIndexColumnValue(index_column, *existing, &existing_value));
+          }
+          column_changed = !(existing_value == key_column->value());
+        }
+        index_key_changed = index_key_changed || column_changed;
       }
       // Prepare the covering columns.
       for (size_t idx = index->key_column_count(); idx < index->columns().size(); idx++) {
@@ -2937,7 +3073,8 @@ Status QLWriteOperation::UpdateIndexes(const QLTableRow& existing_row, const QLT
         if (result) {
           QLColumnValuePB* covering_column = index_request->add_column_values();
           covering_column->set_column_id(index_column.column_id);
-          covering_column->mutable_expr()->mutable_value()->CopyFrom(*result);
+          RETURN_NOT_OK(SetIndexColumnValue(
+              index_column, *result, covering_column->mutable_expr()->mutable_value()));
         }
       }
     }
@@ -2950,7 +3087,7 @@ Status QLWriteOperation::UpdateIndexes(const QLTableRow& existing_row, const QLT
         QLExpressionPB *key_column = NewKeyColumn(index_request, *index, idx);
         auto result = existing_row.GetValue(index_column.indexed_column_id);
         if (result) {
-          key_column->mutable_value()->CopyFrom(*result);
+          RETURN_NOT_OK(SetIndexColumnValue(index_column, *result, key_column->mutable_value()));
         }
       }
     }
@@ -3035,8 +3172,6 @@ Status QLReadOperation::Execute(const common::YQLStorageIf& ql_storage,
     } else { // Reading a regular row that contains non-static columns.
 
       // Read this regular row.
-      // TODO(omer): this is quite inefficient if read_distinct_column. A better way to do this
-      // would be to only read the first non-static column for each hash key, and skip the rest
       non_static_row.Clear();
       RETURN_NOT_OK(iter->NextRow(non_static_projection, &non_static_row));
     }
@@ -3059,6 +3194,10 @@ Status QLReadOperation::Execute(const common::YQLStorageIf& ql_storage,
         RETURN_NOT_OK(AddRowToResult(
             spec, static_row, row_count_limit, offset, resultset, &match_count, &num_rows_skipped));
       }
+
+      // The other rows of this hash key would only join with the row just dealt with, so they are
+      // skipped without being read.
+      RETURN_NOT_OK(iter->SkipToNextPartitionKey());
     } else {
       if (last_read_static) {
 
@@ -3102,14 +3241,18 @@ Status QLReadOperation::Execute(const common::YQLStorageIf& ql_storage,
   if (request_.is_aggregate() && match_count > 0) {
     RETURN_NOT_OK(PopulateAggregate(selected_row, resultset));
   }
+  if (request_.has_order_by()) {
+    PopulateTopN(resultset);
+  }
 
   if (FLAGS_trace_docdb_calls) {
     TRACE("Fetched $0 rows.", resultset->rsrow_count());
   }
   *restart_read_ht = iter->RestartReadHt();
 
+  // An aggregate or an ORDER BY reads all the rows of the tablet.
   if ((resultset->rsrow_count() >= row_count_limit || request_.has_offset()) &&
-      !request_.is_aggregate()) {
+      !request_.is_aggregate() && !request_.has_order_by()) {
     RETURN_NOT_OK(iter->SetPagingStateIfNecessary(request_, num_rows_skipped, &response_));
   }
 
@@ -3186,6 +3329,8 @@ Status QLReadOperation::AddRowToResult(const std::unique_ptr<common::QLScanSpec>
         (*match_count)++;
         if (request_.is_aggregate()) {
           RETURN_NOT_OK(EvalAggregate(row));
+        } else if (request_.has_order_by()) {
+          RETURN_NOT_OK(AddRowToTopN(row, row_count_limit));
         } else {
           RETURN_NOT_OK(PopulateResultSet(row, resultset));
         }
@@ -3197,6 +3342,54 @@ Status QLReadOperation::AddRowToResult(const std::unique_ptr<common::QLScanSpec>
   return Status::OK();
 }
 
+bool QLReadOperation::TopNRowLess(const std::vector<QLValue>& lhs,
+                                  const std::vector<QLValue>& rhs) const {
+  const auto& order_by = request_.order_by();
+  const int result = CompareForOrderBy(lhs[order_by.rscol_index()], rhs[order_by.rscol_index()]);
+  return order_by.is_descending() ? result > 0 : result < 0;
+}
+
+Status QLReadOperation::AddRowToTopN(const QLTableRow& table_row, size_t limit) {
+  const auto less = [this](const std::vector<QLValue>& lhs, const std::vector<QLValue>& rhs) {
+    return TopNRowLess(lhs, rhs);
+  };
+  std::vector<QLValue> row(request_.selected_exprs().size());
+  int rscol_index = 0;
+  for (const QLExpressionPB& expr : request_.selected_exprs()) {
+    RETURN_NOT_OK(EvalExpr(expr, table_row, &row[rscol_index]));
+    rscol_index++;
+  }
+  if (request_.order_by().rscol_index() >= rscol_index) {
+    return STATUS_FORMAT(InvalidArgument, "Invalid ORDER BY column index $0",
+                         request_.order_by().rscol_index());
+  }
+
+  // Only 'limit' rows are kept, so the memory used does not depend on the size of the tablet.
+  if (top_n_rows_.size() < limit) {
+    top_n_rows_.push_back(std::move(row));
+    std::push_heap(top_n_rows_.begin(), top_n_rows_.end(), less);
+  } else if (!top_n_rows_.empty() && less(row, top_n_rows_.front())) {
+    std::pop_heap(top_n_rows_.begin(), top_n_rows_.end(), less);
+    top_n_rows_.back() = std::move(row);
+    std::push_heap(top_n_rows_.begin(), top_n_rows_.end(), less);
+  }
+  return Status::OK();
+}
+
+void QLReadOperation::PopulateTopN(QLResultSet* resultset) {
+  std::sort_heap(top_n_rows_.begin(), top_n_rows_.end(),
+                 [this](const std::vector<QLValue>& lhs, const std::vector<QLValue>& rhs) {
+    return TopNRowLess(lhs, rhs);
+  });
+  for (const auto& row : top_n_rows_) {
+    resultset->AllocateRow();
+    for (size_t rscol_index = 0; rscol_index != row.size(); ++rscol_index) {
+      resultset->AppendColumn(rscol_index, row[rscol_index]);
+    }
+  }
+  top_n_rows_.clear();
+}
+
 //--------------------------------------------------------------------------------------------------
 // Pgsql support.
 //--------------------------------------------------------------------------------------------------
@@ -3300,6 +3493,10 @@ Status PgsqlWriteOperation::ApplyInsert(const DocOperationApplyData& data) {
   const MonoDelta ttl = Value::kMaxTtl;
   const UserTimeMicros user_timestamp = Value::kInvalidUserTimestamp;
 
+  if (FLAGS_ysql_enable_packed_row && encoded_range_doc_key_) {
+    return ApplyPackedInsert(data, table_row);
+  }
+
   // Add the appropriate liveness column.
   if (encoded_range_doc_key_) {
     const DocPath sub_path(encoded_range_doc_key_.as_slice(),
@@ -3341,6 +3538,53 @@ Status PgsqlWriteOperation::ApplyInsert(const DocOperationApplyData& data) {
   return Status::OK();
 }
 
+Status PgsqlWriteOperation::ApplyPackedInsert(const DocOperationApplyData& data,
+                                              const QLTableRow::SharedPtr& table_row) {
+  // Evaluate all the columns first: the packed row has to be added to the write batch before any
+  // column that could not be packed, otherwise it would hide such columns.
+  PackedRowEncoder packed_row(request_.schema_version());
+  packed_row.AddColumn(PrimitiveValue::SystemColumnId(SystemColumnIds::kLivenessColumn),
+                       Value(PrimitiveValue()));
+  std::vector<std::pair<ColumnId, SubDocument>> unpacked_columns;
+
+  for (const auto& column_value : request_.column_values()) {
+    if (!column_value.has_column_id()) {
+      return STATUS_FORMAT(InvalidArgument, "column id missing: $0",
+                           column_value.DebugString());
+    }
+    const ColumnId column_id(column_value.column_id());
+    auto column = schema_.column_by_id(column_id);
+    RETURN_NOT_OK(column);
+
+    CHECK(GetTSWriteInstruction(column_value.expr()) == bfpg::TSOpcode::kScalarInsert)
+      << "Illegal write instruction";
+
+    QLValue expr_result;
+    RETURN_NOT_OK(EvalExpr(column_value.expr(), table_row, &expr_result));
+    SubDocument sub_doc =
+        SubDocument::FromQLValuePB(expr_result.value(), column->sorting_type());
+    if (sub_doc.IsTombstoneOrPrimitive()) {
+      packed_row.AddColumn(PrimitiveValue(column_id), Value(sub_doc));
+    } else {
+      unpacked_columns.emplace_back(column_id, std::move(sub_doc));
+    }
+  }
+
+  RETURN_NOT_OK(data.doc_write_batch->SetPackedRow(
+      encoded_range_doc_key_.as_slice(), packed_row.Finish()));
+
+  for (const auto& column : unpacked_columns) {
+    DocPath sub_path(encoded_range_doc_key_.as_slice(), PrimitiveValue(column.first));
+    RETURN_NOT_OK(data.doc_write_batch->InsertSubDocument(
+        sub_path, column.second, data.read_time, data.deadline, request_.stmt_id()));
+  }
+
+  RETURN_NOT_OK(PopulateResultSet());
+
+  response_->set_status(PgsqlResponsePB::PGSQL_STATUS_OK);
+  return Status::OK();
+}
+
 Status PgsqlWriteOperation::ApplyUpdate(const DocOperationApplyData& data) {
   QLTableRow::SharedPtr table_row = make_shared<QLTableRow>();
   RETURN_NOT_OK(ReadColumns(data, table_row));
@@ -3580,12 +3824,15 @@ Status PgsqlReadOperation::Execute(const common::YQLStorageIf& ql_storage,
     if (request_.has_where_expr()) {
       QLValue match;
       RETURN_NOT_OK(EvalExpr(request_.where_expr(), row, &match));
-      is_match = match.bool_value();
+      // A null condition, e.g. a comparison with a null column, does not match.
+      is_match = !match.IsNull() && match.bool_value();
     }
     if (is_match) {
       match_count++;
       if (request_.is_aggregate()) {
         RETURN_NOT_OK(EvalAggregate(row));
+      } else if (request_.has_sample_size()) {
+        RETURN_NOT_OK(SampleRow(row));
       } else {
         RETURN_NOT_OK(PopulateResultSet(row, resultset));
       }
@@ -3595,19 +3842,80 @@ Status PgsqlReadOperation::Execute(const common::YQLStorageIf& ql_storage,
   if (request_.is_aggregate() && match_count > 0) {
     RETURN_NOT_OK(PopulateAggregate(row, resultset));
   }
+  if (request_.has_sample_size()) {
+    PopulateSample(resultset);
+  }
 
   if (FLAGS_trace_docdb_calls) {
     TRACE("Fetched $0 rows.", resultset->rsrow_count());
   }
   *restart_read_ht = iter->RestartReadHt();
 
-  if (resultset->rsrow_count() >= row_count_limit && !request_.is_aggregate()) {
+  // An aggregate or a sampling scan reads all the rows of the tablet.
+  if (resultset->rsrow_count() >= row_count_limit && !request_.is_aggregate() &&
+      !request_.has_sample_size()) {
     RETURN_NOT_OK(iter->SetPagingStateIfNecessary(request_, &response_));
   }
 
   return Status::OK();
 }
 
+Status PgsqlReadOperation::SampleRow(const QLTableRow::SharedPtr& table_row) {
+  const size_t num_targets = request_.targets().size();
+  std::vector<QLValue> values(num_targets);
+  for (size_t i = 0; i != num_targets; ++i) {
+    RETURN_NOT_OK(EvalExpr(request_.targets(i), table_row, &values[i]));
+  }
+
+  if (distinct_sketches_.empty()) {
+    null_counts_.resize(num_targets);
+    distinct_sketches_.resize(num_targets);
+  }
+  std::string buffer;
+  for (size_t i = 0; i != num_targets; ++i) {
+    if (values[i].IsNull()) {
+      ++null_counts_[i];
+    } else {
+      buffer.clear();
+      values[i].value().AppendToString(&buffer);
+      distinct_sketches_[i].Add(buffer);
+    }
+  }
+
+  // Reservoir sampling: the n-th row replaces a random row of the sample with probability
+  // sample_size / n, so each row read ends up in the sample with the same probability.
+  ++num_sampled_rows_;
+  if (sample_.size() < request_.sample_size()) {
+    sample_.push_back(std::move(values));
+  } else {
+    const uint64_t index = RandomUniformInt<uint64_t>(0, num_sampled_rows_ - 1);
+    if (index < sample_.size()) {
+      sample_[index] = std::move(values);
+    }
+  }
+  return Status::OK();
+}
+
+void PgsqlReadOperation::PopulateSample(PgsqlResultSet *resultset) {
+  // The client takes a prefix of the rows when it samples the rows of several tablets again.
+  std::shuffle(sample_.begin(), sample_.end(), ThreadLocalRandom());
+  for (auto& values : sample_) {
+    PgsqlRSRow *rsrow = resultset->AllocateRSRow(values.size());
+    for (size_t i = 0; i != values.size(); ++i) {
+      *rsrow->rscol(i) = std::move(values[i]);
+    }
+  }
+  sample_.clear();
+
+  PgsqlSampleResultPB* sample_result = response_.mutable_sample_result();
+  sample_result->set_num_rows(num_sampled_rows_);
+  for (size_t i = 0; i != distinct_sketches_.size(); ++i) {
+    PgsqlColumnStatsPB* column_stats = sample_result->add_column_stats();
+    column_stats->set_null_count(null_counts_[i]);
+    column_stats->set_distinct_sketch(distinct_sketches_[i].registers());
+  }
+}
+
 Status PgsqlReadOperation::PopulateResultSet(const QLTableRow::SharedPtr& table_row,
                                              PgsqlResultSet *resultset) {
   PgsqlRSRow *rsrow = resultset->AllocateRSRow(request_.targets().size());
@@ -41,6 +41,7 @@
 
 #include "yb/server/hybrid_clock.h"
 
+#include "yb/util/hyperloglog.h"
 #include "yb/util/ref_cnt_buffer.h"
 
 namespace yb {
@@ -440,14 +441,27 @@ class QLReadOperation : public DocExprExecutor {
                                 int* match_count,
                                 size_t* num_rows_skipped);
 
+  // Keeps the selected row of 'table_row' if it is among the first 'limit' rows in the order of
+  // the ORDER BY of the request.
+  CHECKED_STATUS AddRowToTopN(const QLTableRow& table_row, size_t limit);
+
+  // Appends the rows kept by AddRowToTopN() to the result set, in order.
+  void PopulateTopN(QLResultSet* resultset);
+
   CHECKED_STATUS GetIntents(const Schema& schema, KeyValueWriteBatchPB* out);
 
   QLResponsePB& response() { return response_; }
 
  private:
+  // Whether the selected row 'lhs' comes before 'rhs' in the order of the ORDER BY.
+  bool TopNRowLess(const std::vector<QLValue>& lhs, const std::vector<QLValue>& rhs) const;
+
   const QLReadRequestPB& request_;
   const TransactionOperationContextOpt txn_op_context_;
   QLResponsePB response_;
+
+  // The selected rows kept for the ORDER BY, as a heap whose top is the last row in order.
+  std::vector<std::vector<QLValue>> top_n_rows_;
 };
 
 //--------------------------------------------------------------------------------------------------
@@ -484,6 +498,9 @@ class PgsqlWriteOperation :
 
   // Insert, update, and delete operations.
   CHECKED_STATUS ApplyInsert(const DocOperationApplyData& data);
+  // Insert that writes the row as one packed entry, used when ysql_enable_packed_row is set.
+  CHECKED_STATUS ApplyPackedInsert(const DocOperationApplyData& data,
+                                   const QLTableRow::SharedPtr& table_row);
   CHECKED_STATUS ApplyUpdate(const DocOperationApplyData& data);
   CHECKED_STATUS ApplyDelete(const DocOperationApplyData& data);
 
@@ -559,12 +576,26 @@ class PgsqlReadOperation : public DocExprExecutor {
   CHECKED_STATUS PopulateAggregate(const QLTableRow::SharedPtr& table_row,
                                    PgsqlResultSet *resultset);
 
+  // Adds the row to the statistics of a sampling scan, and to the sample with the probability of
+  // reservoir sampling.
+  CHECKED_STATUS SampleRow(const QLTableRow::SharedPtr& table_row);
+
+  // Writes the sample to the result set and the statistics to the response.
+  void PopulateSample(PgsqlResultSet *resultset);
+
   //------------------------------------------------------------------------------------------------
   const PgsqlReadRequestPB& request_;
   const TransactionOperationContextOpt txn_op_context_;
   PgsqlResponsePB response_;
   common::YQLRowwiseIteratorIf::UniPtr table_iter_;
   common::YQLRowwiseIteratorIf::UniPtr index_iter_;
+
+  // State of a sampling scan: the rows read so far, the sampled targets of some of them, and the
+  // null counts and distinct sketches of the targets.
+  uint64_t num_sampled_rows_ = 0;
+  std::vector<std::vector<QLValue>> sample_;
+  std::vector<uint64_t> null_counts_;
+  std::vector<HyperLogLog> distinct_sketches_;
 };
 
 }  // namespace docdb
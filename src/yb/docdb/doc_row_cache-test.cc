@@ -0,0 +1,137 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/doc_row_cache.h"
+
+#include "yb/util/format.h"
+#include "yb/util/mem_tracker.h"
+#include "yb/util/metrics.h"
+#include "yb/util/size_literals.h"
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+METRIC_DEFINE_entity(test_entity);
+METRIC_DEFINE_counter(test_entity, test_row_cache_hits, "Test Row Cache Hits",
+                      yb::MetricUnit::kRequests, "Number of test row cache hits.");
+METRIC_DEFINE_counter(test_entity, test_row_cache_misses, "Test Row Cache Misses",
+                      yb::MetricUnit::kRequests, "Number of test row cache misses.");
+
+namespace yb {
+namespace docdb {
+
+namespace {
+
+const std::string kProjection = "projection";
+
+SubDocument MakeRow(const std::string& value) {
+  SubDocument row;
+  row.SetChildPrimitive(PrimitiveValue(ColumnId(10)), PrimitiveValue(value));
+  return row;
+}
+
+ReadHybridTime ReadTime(uint64_t value) {
+  return ReadHybridTime::SingleTime(HybridTime(value));
+}
+
+} // namespace
+
+class DocRowCacheTest : public YBTest {
+ protected:
+  void SetUp() override {
+    YBTest::SetUp();
+    entity_ = METRIC_ENTITY_test_entity.Instantiate(&registry_, "test");
+    hits_ = METRIC_test_row_cache_hits.Instantiate(entity_);
+    misses_ = METRIC_test_row_cache_misses.Instantiate(entity_);
+    mem_tracker_ = MemTracker::CreateTracker("DocRowCacheTest");
+  }
+
+  std::unique_ptr<DocRowCache> CreateCache(size_t capacity_bytes) {
+    return std::make_unique<DocRowCache>(capacity_bytes, mem_tracker_, hits_, misses_);
+  }
+
+  MetricRegistry registry_;
+  scoped_refptr<MetricEntity> entity_;
+  scoped_refptr<Counter> hits_;
+  scoped_refptr<Counter> misses_;
+  std::shared_ptr<MemTracker> mem_tracker_;
+};
+
+TEST_F(DocRowCacheTest, LookupAndInvalidate) {
+  auto cache = CreateCache(1_MB);
+  SubDocument row;
+  ASSERT_FALSE(cache->Lookup("key1", kProjection, ReadTime(100), &row));
+
+  auto generation = cache->generation();
+  cache->Insert("key1", kProjection, HybridTime(100), MakeRow("a"), generation);
+  ASSERT_EQ(1, cache->size());
+  ASSERT_EQ(static_cast<int64_t>(cache->charged_bytes()), mem_tracker_->consumption());
+
+  ASSERT_TRUE(cache->Lookup("key1", kProjection, ReadTime(150), &row));
+  ASSERT_EQ(MakeRow("a"), row);
+  // Older reads and other projections bypass the cached row.
+  ASSERT_FALSE(cache->Lookup("key1", kProjection, ReadTime(50), &row));
+  ASSERT_FALSE(cache->Lookup("key1", "other", ReadTime(150), &row));
+  ASSERT_EQ(1, hits_->value());
+  ASSERT_EQ(3, misses_->value());
+
+  cache->Invalidate("key1", HybridTime(200));
+  ASSERT_FALSE(cache->Lookup("key1", kProjection, ReadTime(250), &row));
+  ASSERT_EQ(0, cache->size());
+  ASSERT_EQ(0, mem_tracker_->consumption());
+}
+
+TEST_F(DocRowCacheTest, StaleInserts) {
+  auto cache = CreateCache(1_MB);
+  SubDocument row;
+
+  // The row was read before a write got applied.
+  auto generation = cache->generation();
+  cache->Invalidate("key1", HybridTime(200));
+  cache->Insert("key1", kProjection, HybridTime(300), MakeRow("a"), generation);
+  ASSERT_FALSE(cache->Lookup("key1", kProjection, ReadTime(300), &row));
+
+  // The row was read at a time before an applied write.
+  generation = cache->generation();
+  cache->Insert("key2", kProjection, HybridTime(150), MakeRow("b"), generation);
+  ASSERT_FALSE(cache->Lookup("key2", kProjection, ReadTime(300), &row));
+
+  // Values with TTL expire over time, so they are not cached.
+  SubDocument ttl_row = MakeRow("c");
+  ttl_row.GetChild(PrimitiveValue(ColumnId(10)))->SetTtl(100);
+  cache->Insert("key3", kProjection, HybridTime(300), ttl_row, generation);
+  ASSERT_FALSE(cache->Lookup("key3", kProjection, ReadTime(300), &row));
+  ASSERT_EQ(0, cache->size());
+}
+
+TEST_F(DocRowCacheTest, Eviction) {
+  auto cache = CreateCache(1_KB);
+  const std::string value(300, 'x');
+  for (int i = 0; i != 10; ++i) {
+    cache->Insert(Format("key$0", i), kProjection, HybridTime(100), MakeRow(value),
+                  cache->generation());
+    ASSERT_LE(cache->charged_bytes(), 1_KB);
+  }
+  ASSERT_LT(cache->size(), 10U);
+
+  // The most recently inserted row is kept.
+  SubDocument row;
+  ASSERT_TRUE(cache->Lookup("key9", kProjection, ReadTime(100), &row));
+  ASSERT_FALSE(cache->Lookup("key0", kProjection, ReadTime(100), &row));
+
+  cache->Clear();
+  ASSERT_EQ(0, cache->size());
+  ASSERT_EQ(0, mem_tracker_->consumption());
+}
+
+} // namespace docdb
+} // namespace yb
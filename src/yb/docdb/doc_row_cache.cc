@@ -0,0 +1,176 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/doc_row_cache.h"
+
+#include "yb/util/mem_tracker.h"
+#include "yb/util/metrics.h"
+
+namespace yb {
+namespace docdb {
+
+namespace {
+
+// Rough per-node overhead of std::map and std::list.
+constexpr size_t kContainerNodeOverhead = 4 * sizeof(void*);
+
+// Estimates the memory taken by a decoded row. Clears *cacheable if the row holds a value that
+// depends on the read time (i.e. has a TTL), or a container we do not account for.
+size_t EstimateCharge(const SubDocument& doc, bool* cacheable) {
+  size_t result = sizeof(SubDocument);
+  if (doc.GetTtl() != -1) {
+    *cacheable = false;
+  }
+  if (IsObjectType(doc.value_type())) {
+    if (doc.object_num_keys() > 0) {
+      for (const auto& child : doc.object_container()) {
+        result += kContainerNodeOverhead + sizeof(PrimitiveValue);
+        if (child.first.IsString()) {
+          result += child.first.GetString().size();
+        }
+        result += EstimateCharge(child.second, cacheable);
+      }
+    }
+  } else if (doc.value_type() == ValueType::kArray) {
+    *cacheable = false;
+  } else if (doc.IsString()) {
+    result += doc.GetString().size();
+  }
+  return result;
+}
+
+} // namespace
+
+DocRowCache::DocRowCache(size_t capacity_bytes,
+                         const std::shared_ptr<MemTracker>& mem_tracker,
+                         const scoped_refptr<Counter>& hits,
+                         const scoped_refptr<Counter>& misses)
+    : capacity_bytes_(capacity_bytes),
+      mem_tracker_(mem_tracker),
+      hits_(hits),
+      misses_(misses) {
+}
+
+DocRowCache::~DocRowCache() {
+  if (mem_tracker_) {
+    mem_tracker_->Release(charged_bytes_);
+  }
+}
+
+uint64_t DocRowCache::generation() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return generation_;
+}
+
+bool DocRowCache::Lookup(const Slice& encoded_doc_key,
+                         const Slice& projection,
+                         const ReadHybridTime& read_time,
+                         SubDocument* row) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(encoded_doc_key);
+    if (it != index_.end()) {
+      Entry& entry = *it->second;
+      if (entry.projection == projection && entry.read_ht <= read_time.read) {
+        lru_.splice(lru_.begin(), lru_, it->second);
+        *row = entry.row;
+        if (hits_) {
+          hits_->Increment();
+        }
+        return true;
+      }
+    }
+  }
+  if (misses_) {
+    misses_->Increment();
+  }
+  return false;
+}
+
+void DocRowCache::Insert(const Slice& encoded_doc_key,
+                         const Slice& projection,
+                         HybridTime read_ht,
+                         const SubDocument& row,
+                         uint64_t generation) {
+  bool cacheable = true;
+  const size_t charge = EstimateCharge(row, &cacheable) + sizeof(Entry) + kContainerNodeOverhead +
+                        2 * encoded_doc_key.size() + projection.size();
+  if (!cacheable || charge > capacity_bytes_) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (generation != generation_ || max_write_ht_ > read_ht) {
+    return;
+  }
+  auto it = index_.find(encoded_doc_key);
+  if (it != index_.end()) {
+    if (it->second->read_ht >= read_ht) {
+      return;
+    }
+    EraseUnlocked(it->second);
+  }
+  while (!lru_.empty() && charged_bytes_ + charge > capacity_bytes_) {
+    EraseUnlocked(std::prev(lru_.end()));
+  }
+
+  lru_.push_front(Entry{encoded_doc_key.ToBuffer(), projection.ToBuffer(), read_ht, row, charge});
+  index_.emplace(Slice(lru_.front().key), lru_.begin());
+  charged_bytes_ += charge;
+  if (mem_tracker_) {
+    mem_tracker_->Consume(charge);
+  }
+}
+
+void DocRowCache::Invalidate(const Slice& encoded_doc_key, HybridTime write_ht) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ++generation_;
+  max_write_ht_.MakeAtLeast(write_ht);
+  auto it = index_.find(encoded_doc_key);
+  if (it != index_.end()) {
+    EraseUnlocked(it->second);
+  }
+}
+
+void DocRowCache::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ++generation_;
+  index_.clear();
+  lru_.clear();
+  if (mem_tracker_) {
+    mem_tracker_->Release(charged_bytes_);
+  }
+  charged_bytes_ = 0;
+}
+
+size_t DocRowCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return lru_.size();
+}
+
+size_t DocRowCache::charged_bytes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return charged_bytes_;
+}
+
+void DocRowCache::EraseUnlocked(LruList::iterator it) {
+  charged_bytes_ -= it->charge;
+  if (mem_tracker_) {
+    mem_tracker_->Release(it->charge);
+  }
+  index_.erase(Slice(it->key));
+  lru_.erase(it);
+}
+
+}  // namespace docdb
+}  // namespace yb
@@ -0,0 +1,124 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_DOCDB_DOC_ROW_CACHE_H_
+#define YB_DOCDB_DOC_ROW_CACHE_H_
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "yb/common/hybrid_time.h"
+#include "yb/common/read_hybrid_time.h"
+
+#include "yb/docdb/subdocument.h"
+
+#include "yb/gutil/ref_counted.h"
+
+#include "yb/util/slice.h"
+
+namespace yb {
+
+class Counter;
+class MemTracker;
+
+namespace docdb {
+
+// A per-tablet LRU cache of decoded rows, keyed by the encoded DocKey. It lets point reads of hot
+// rows skip seeking and decoding RocksDB blocks. Each entry remembers the projection it was built
+// for and the read time it was read at, and is only served to reads of the same projection at the
+// same or a later read time.
+//
+// Every write applied to the regular DB must invalidate the rows it touches. An invalidation also
+// bumps a generation counter: a read that started before the invalidation will not populate the
+// cache, because it could have read the row as of before the write.
+//
+// Rows are only valid as long as the regular DB is their only source, so the cache must not be used
+// for tablets that apply transaction intents.
+//
+// This class is thread-safe.
+class DocRowCache {
+ public:
+  DocRowCache(size_t capacity_bytes,
+              const std::shared_ptr<MemTracker>& mem_tracker,
+              const scoped_refptr<Counter>& hits,
+              const scoped_refptr<Counter>& misses);
+
+  ~DocRowCache();
+
+  // Returns the current invalidation generation. A reader should take it before reading a row
+  // from RocksDB and pass it to Insert.
+  uint64_t generation() const;
+
+  // Looks up the row of the given encoded DocKey as read with the given projection, at read_time.
+  // Returns false if there is no usable entry.
+  bool Lookup(const Slice& encoded_doc_key,
+              const Slice& projection,
+              const ReadHybridTime& read_time,
+              SubDocument* row);
+
+  // Adds a row read at read_ht. The row is not added if the cache was invalidated since
+  // generation was taken, if a write later than read_ht has been applied, or if the row contains
+  // values that expire over time.
+  void Insert(const Slice& encoded_doc_key,
+              const Slice& projection,
+              HybridTime read_ht,
+              const SubDocument& row,
+              uint64_t generation);
+
+  // Drops the row of the given encoded DocKey. It should be called after a write with the given
+  // hybrid time has been applied for that row.
+  void Invalidate(const Slice& encoded_doc_key, HybridTime write_ht);
+
+  // Drops all rows, i.e. after the whole DB got replaced or its schema changed.
+  void Clear();
+
+  size_t size() const;
+  size_t charged_bytes() const;
+
+ private:
+  struct Entry {
+    std::string key;
+    std::string projection;
+    HybridTime read_ht;
+    SubDocument row;
+    size_t charge;
+  };
+
+  typedef std::list<Entry> LruList;
+
+  void EraseUnlocked(LruList::iterator it);
+
+  const size_t capacity_bytes_;
+  std::shared_ptr<MemTracker> mem_tracker_;
+  scoped_refptr<Counter> hits_;
+  scoped_refptr<Counter> misses_;
+
+  mutable std::mutex mutex_;
+
+  // Most recently used entries are at the front.
+  LruList lru_;
+  std::unordered_map<Slice, LruList::iterator, Slice::Hash> index_;
+  size_t charged_bytes_ = 0;
+  uint64_t generation_ = 0;
+
+  // The highest hybrid time of a write invalidated so far.
+  HybridTime max_write_ht_ = HybridTime::kMin;
+};
+
+}  // namespace docdb
+}  // namespace yb
+
+#endif  // YB_DOCDB_DOC_ROW_CACHE_H_
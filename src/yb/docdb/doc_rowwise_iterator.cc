@@ -18,9 +18,11 @@
 #include "yb/common/ql_scanspec.h"
 #include "yb/docdb/docdb.h"
 #include "yb/docdb/docdb-internal.h"
+#include "yb/docdb/docdb_execution_stats.h"
 #include "yb/docdb/docdb_rocksdb_util.h"
 #include "yb/docdb/doc_key.h"
 #include "yb/docdb/doc_ql_scanspec.h"
+#include "yb/docdb/doc_row_cache.h"
 #include "yb/docdb/intent_aware_iterator.h"
 #include "yb/docdb/subdocument.h"
 #include "yb/gutil/strings/substitute.h"
@@ -36,6 +38,29 @@ using yb::FormatRocksDBSliceAsStr;
 namespace yb {
 namespace docdb {
 
+namespace {
+
+// Returns the key the bloom filter is checked against for a scan between the given bounds. The
+// scanned rows share only the range components that are common to both bounds, and the bloom
+// filter could take leading range components into account, so the others are dropped.
+KeyBytes BloomFilterKey(const DocKey& lower_doc_key, const DocKey& upper_doc_key) {
+  const auto& lower_range = lower_doc_key.range_group();
+  const auto& upper_range = upper_doc_key.range_group();
+  size_t common_size = 0;
+  while (common_size < lower_range.size() && common_size < upper_range.size() &&
+         lower_range[common_size] == upper_range[common_size]) {
+    ++common_size;
+  }
+  if (common_size == lower_range.size()) {
+    return lower_doc_key.Encode();
+  }
+  DocKey filter_key = lower_doc_key;
+  filter_key.ResizeRangeComponents(static_cast<int>(common_size));
+  return filter_key.Encode();
+}
+
+} // namespace
+
 DocRowwiseIterator::DocRowwiseIterator(
     const Schema &projection,
     const Schema &schema,
@@ -99,10 +124,11 @@ Status DocRowwiseIterator::Init(const common::QLScanSpec& spec) {
       BloomFilterMode::DONT_USE_BLOOM_FILTER;
 
   const KeyBytes row_key_encoded = lower_doc_key.Encode();
-  const Slice row_key_encoded_as_slice = row_key_encoded.AsSlice();
+  const KeyBytes filter_key = is_fixed_point_get
+      ? BloomFilterKey(lower_doc_key, upper_doc_key) : KeyBytes();
 
   db_iter_ = CreateIntentAwareIterator(
-      doc_db_, mode, row_key_encoded_as_slice, doc_spec.QueryId(), txn_op_context_,
+      doc_db_, mode, filter_key.AsSlice(), doc_spec.QueryId(), txn_op_context_,
       deadline_, read_time_, doc_spec.CreateFileFilter());
 
   row_ready_ = false;
@@ -119,6 +145,22 @@ Status DocRowwiseIterator::Init(const common::QLScanSpec& spec) {
     }
   }
 
+  if (IsRowCachePointRead(doc_spec, lower_doc_key, upper_doc_key)) {
+    row_cache_key_ = row_key_encoded.AsSlice().ToBuffer();
+    KeyBytes projection;
+    for (const auto& subkey : projection_subkeys_) {
+      subkey.AppendToKey(&projection);
+    }
+    row_cache_projection_ = projection.AsSlice().ToBuffer();
+    row_cache_generation_ = doc_db_.row_cache->generation();
+    if (doc_db_.row_cache->Lookup(row_cache_key_, row_cache_projection_, read_time_, &row_)) {
+      row_key_ = lower_doc_key;
+      row_ready_ = true;
+      row_cache_hit_ = true;
+      return Status::OK();
+    }
+  }
+
   if (doc_spec.range_options()) {
     range_cols_scan_options_ = doc_spec.range_options();
     current_scan_target_idxs_.resize(range_cols_scan_options_->size());
@@ -157,6 +199,33 @@ Status DocRowwiseIterator::Init(const common::QLScanSpec& spec) {
   return Status::OK();
 }
 
+bool DocRowwiseIterator::IsRowCachePointRead(const DocQLScanSpec& doc_spec,
+                                             const DocKey& lower_doc_key,
+                                             const DocKey& upper_doc_key) const {
+  if (doc_db_.row_cache == nullptr || txn_op_context_ || doc_spec.include_static_columns() ||
+      lower_doc_key.hashed_group().size() != schema_.num_hash_key_columns() ||
+      lower_doc_key.range_group().size() != schema_.num_range_key_columns()) {
+    return false;
+  }
+  // A scan of exactly one row has the upper bound of the row key followed by +inf.
+  DocKey point_upper_doc_key = lower_doc_key;
+  point_upper_doc_key.AddRangeComponent(PrimitiveValue(ValueType::kHighest));
+  return upper_doc_key == point_upper_doc_key;
+}
+
+void DocRowwiseIterator::MaybeAddToRowCache(const Slice& sub_doc_key) const {
+  if (row_cache_key_.empty() || sub_doc_key != Slice(row_cache_key_)) {
+    return;
+  }
+  // A read that found a value in its uncertainty window is going to be restarted.
+  const auto max_seen_ht = db_iter_->max_seen_ht();
+  if (max_seen_ht.is_valid() && max_seen_ht > read_time_.read) {
+    return;
+  }
+  doc_db_.row_cache->Insert(
+      row_cache_key_, row_cache_projection_, read_time_.read, row_, row_cache_generation_);
+}
+
 Status DocRowwiseIterator::Init(const common::PgsqlScanSpec& spec) {
   const DocPgsqlScanSpec& doc_spec = dynamic_cast<const DocPgsqlScanSpec&>(spec);
   is_forward_scan_ = doc_spec.is_forward_scan();
@@ -175,11 +244,11 @@ Status DocRowwiseIterator::Init(const common::PgsqlScanSpec& spec) {
   const auto mode = is_fixed_point_get ? BloomFilterMode::USE_BLOOM_FILTER :
       BloomFilterMode::DONT_USE_BLOOM_FILTER;
 
-  const KeyBytes row_key_encoded = lower_doc_key.Encode();
-  const Slice row_key_encoded_as_slice = row_key_encoded.AsSlice();
+  const KeyBytes filter_key = is_fixed_point_get
+      ? BloomFilterKey(lower_doc_key, upper_doc_key) : KeyBytes();
 
   db_iter_ = CreateIntentAwareIterator(
-      doc_db_, mode, row_key_encoded_as_slice, doc_spec.QueryId(), txn_op_context_,
+      doc_db_, mode, filter_key.AsSlice(), doc_spec.QueryId(), txn_op_context_,
       deadline_, read_time_, doc_spec.CreateFileFilter());
 
   row_ready_ = false;
@@ -215,7 +284,10 @@ Status DocRowwiseIterator::EnsureIteratorPositionCorrect() const {
     // Seek to the current target doc key if needed.
     if (current_scan_target_ != row_key_ && !FinishedScanTargetsList()) {
       if (is_forward_scan_) {
-        db_iter_->Seek(current_scan_target_);
+        // Targets are visited in increasing key order, so the iterator only has to move forward.
+        // SeekForward steps to a nearby target with Next() instead of descending the index again.
+        KeyBytes target_key = current_scan_target_.Encode();
+        db_iter_->SeekForward(&target_key);
       } else {
         DocKey tmp = current_scan_target_;
         tmp.AddRangeComponent(PrimitiveValue(ValueType::kHighest));
@@ -238,6 +310,12 @@ bool DocRowwiseIterator::HasNext() const {
 
   if (done_) return false;
 
+  if (row_cache_hit_) {
+    // The only row of this point read has been served from the row cache.
+    done_ = true;
+    return false;
+  }
+
   if (IsMultiKeyScan() && FinishedScanTargetsList()) {
     // If there are no more options left to scan then we are done.
     done_ = true;
@@ -317,7 +395,9 @@ bool DocRowwiseIterator::HasNext() const {
       return true;
     }
 
-    if (!doc_found) {
+    if (doc_found) {
+      MaybeAddToRowCache(sub_doc_key);
+    } else {
       SubDocument full_row;
       // If doc is not found, decide if some non-projection column exists.
       // Currently we read the whole doc here,
@@ -433,6 +513,7 @@ Status DocRowwiseIterator::DoNextRow(const Schema& projection, QLTableRow* table
   }
 
   row_ready_ = false;
+  RecordRowScanned();
   return Status::OK();
 }
 
@@ -601,6 +682,20 @@ Result<string> DocRowwiseIterator::GetRowKey() const {
   return std::move(*row_key_.Encode().mutable_data());
 }
 
+Status DocRowwiseIterator::SkipToNextPartitionKey() {
+  if (!is_forward_scan_ || IsMultiKeyScan() || row_ready_ || iter_key_.data().empty() ||
+      schema_.num_hash_key_columns() == 0) {
+    return Status::OK();
+  }
+  // All keys of the partition key start with the hashed part, which ends with kGroupEnd, so seeking
+  // out of it skips the static row and all regular rows of the partition key.
+  const auto hashed_part_size = VERIFY_RESULT(DocKey::EncodedSize(
+      iter_key_.AsSlice(), DocKeyPart::HASHED_PART_ONLY));
+  KeyBytes hashed_part(Slice(iter_key_.data().data(), hashed_part_size));
+  db_iter_->SeekOutOfSubDoc(&hashed_part);
+  return Status::OK();
+}
+
 Status DocRowwiseIterator::Seek(const std::string& row_key) {
   DocKey doc_key;
   RETURN_NOT_OK(doc_key.DecodeFrom(Slice(row_key)));
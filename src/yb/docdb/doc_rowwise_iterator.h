@@ -110,6 +110,10 @@ class DocRowwiseIterator : public common::YQLRowwiseIteratorIf {
   // Seek to the given key.
   virtual CHECKED_STATUS Seek(const std::string& row_key) override;
 
+  // Seeks past the hashed part of the key of the row read last. Only done by forward scans that are
+  // not multi-key scans.
+  CHECKED_STATUS SkipToNextPartitionKey() override;
+
  private:
 
   // Retrieves the next key to read after the iterator finishes for the given page.
@@ -148,6 +152,14 @@ class DocRowwiseIterator : public common::YQLRowwiseIteratorIf {
   // ensures that the iterator will be positioned on the first kv-pair of the next row.
   CHECKED_STATUS EnsureIteratorPositionCorrect() const;
 
+  // Returns true if the scan reads exactly one non-static row and can be served by the row cache.
+  bool IsRowCachePointRead(const DocQLScanSpec& doc_spec,
+                           const DocKey& lower_doc_key,
+                           const DocKey& upper_doc_key) const;
+
+  // Adds the row just read to the row cache if this is a row cache point read.
+  void MaybeAddToRowCache(const Slice& sub_doc_key) const;
+
   // Read next row into a value map using the specified projection.
   CHECKED_STATUS DoNextRow(const Schema& projection, QLTableRow* table_row) override;
 
@@ -255,6 +267,17 @@ class DocRowwiseIterator : public common::YQLRowwiseIteratorIf {
   mutable Status status_;
 
   mutable boost::optional<DeadlineInfo> deadline_info_;
+
+  // Encoded row key and projection of a point read that uses doc_db_.row_cache. The key is empty
+  // if the read does not use the row cache.
+  std::string row_cache_key_;
+  std::string row_cache_projection_;
+
+  // Row cache generation taken before reading the row from RocksDB.
+  uint64_t row_cache_generation_ = 0;
+
+  // Whether the row has been served from the row cache.
+  bool row_cache_hit_ = false;
 };
 
 }  // namespace docdb
@@ -13,22 +13,32 @@
 
 #include "yb/docdb/doc_write_batch.h"
 
+#include <algorithm>
+
 #include "yb/docdb/docdb-internal.h"
 #include "yb/docdb/docdb.pb.h"
 #include "yb/docdb/value_type.h"
 #include "yb/docdb/docdb_rocksdb_util.h"
+#include "yb/docdb/packed_row.h"
 #include "yb/rocksdb/db.h"
 #include "yb/server/hybrid_clock.h"
+#include "yb/util/flag_tags.h"
 
 using yb::server::HybridClock;
 
+DEFINE_int32(docdb_write_batch_cache_max_read_entries, 16384,
+             "Maximum number of key prefixes read from RocksDB that a DocWriteBatch remembers, "
+             "so that operations of the same write batch do not seek for them again.");
+TAG_FLAG(docdb_write_batch_cache_max_read_entries, advanced);
+
 namespace yb {
 namespace docdb {
 
 DocWriteBatch::DocWriteBatch(const DocDB& doc_db,
                              InitMarkerBehavior init_marker_behavior,
                              std::atomic<int64_t>* monotonic_counter)
-    : doc_db_(doc_db),
+    : cache_(std::max(FLAGS_docdb_write_batch_cache_max_read_entries, 0)),
+      doc_db_(doc_db),
       init_marker_behavior_(init_marker_behavior),
       monotonic_counter_(monotonic_counter) {}
 
@@ -52,6 +62,7 @@ Status DocWriteBatch::SeekToKeyPrefix(IntentAwareIterator* doc_iter, bool has_an
   const auto prev_key_prefix_exact = current_entry_.found_exact_key_prefix;
 
   // Seek the value.
+  ++num_rocksdb_seeks_;
   doc_iter->Seek(key_prefix_.AsSlice());
   if (!doc_iter->valid()) {
     return Status::OK();
@@ -78,7 +89,7 @@ Status DocWriteBatch::SeekToKeyPrefix(IntentAwareIterator* doc_iter, bool has_an
   if (has_expired) {
     current_entry_.value_type = ValueType::kTombstone;
     current_entry_.doc_hybrid_time = write_ht;
-    cache_.Put(key_prefix_, current_entry_);
+    cache_.PutRead(key_prefix_, current_entry_);
     return Status::OK();
   }
 
@@ -131,7 +142,7 @@ Status DocWriteBatch::SeekToKeyPrefix(IntentAwareIterator* doc_iter, bool has_an
       // therefore we can't create "a.y.x", which would be incorrect.
       subdoc_exists_ = false;
     } else {
-      cache_.Put(key_prefix_, current_entry_);
+      cache_.PutRead(key_prefix_, current_entry_);
       subdoc_exists_ = current_entry_.value_type != ValueType::kTombstone;
     }
   }
@@ -360,6 +371,21 @@ Status DocWriteBatch::SetPrimitive(const DocPath& doc_path,
   return SetPrimitive(doc_path, value, &iter);
 }
 
+Status DocWriteBatch::SetPackedRow(const Slice& encoded_doc_key, std::string packed_row) {
+  DCHECK(IsPackedRow(packed_row));
+  if (put_batch_.size() > numeric_limits<IntraTxnWriteId>::max()) {
+    return STATUS_SUBSTITUTE(
+        NotSupported,
+        "Trying to add more than $0 key/value pairs in the same single-shard txn.",
+        numeric_limits<IntraTxnWriteId>::max());
+  }
+  const auto write_id = static_cast<IntraTxnWriteId>(put_batch_.size());
+  key_prefix_.Reset(encoded_doc_key);
+  put_batch_.emplace_back(key_prefix_.AsStringRef(), std::move(packed_row));
+  cache_.Put(key_prefix_, DocHybridTime(HybridTime::kMax, write_id), ValueType::kPackedRow);
+  return Status::OK();
+}
+
 Status DocWriteBatch::ExtendSubDocument(
     const DocPath& doc_path,
     const SubDocument& value,
@@ -582,6 +608,12 @@ void DocWriteBatch::Clear() {
   cache_.Clear();
 }
 
+int DocWriteBatch::GetAndResetNumRocksDBSeeks() {
+  const int result = num_rocksdb_seeks_;
+  num_rocksdb_seeks_ = 0;
+  return result;
+}
+
 void DocWriteBatch::MoveToWriteBatchPB(KeyValueWriteBatchPB *kv_pb) {
   kv_pb->mutable_write_pairs()->Reserve(put_batch_.size());
   for (auto& entry : put_batch_) {
@@ -184,6 +184,10 @@ class DocWriteBatch {
                         read_ht, deadline, query_id, user_timestamp);
   }
 
+  // Writes a packed row (see packed_row.h) at the given encoded DocKey. The packed row replaces
+  // the whole row, so no read is needed regardless of the init marker behavior.
+  CHECKED_STATUS SetPackedRow(const Slice& encoded_doc_key, std::string packed_row);
+
   void Clear();
   bool IsEmpty() const { return put_batch_.empty(); }
 
@@ -199,8 +203,8 @@ class DocWriteBatch {
   // testing. Consider using MoveToWriteBatchPB in production code.
   void TEST_CopyToWriteBatchPB(KeyValueWriteBatchPB *kv_pb) const;
 
-  // This is used in tests when measuring the number of seeks that a given update to this batch
-  // performs. The internal seek count is reset.
+  // Returns the number of RocksDB seeks performed by this batch since the last call, i.e. those
+  // that were not served by the cache. The internal seek count is reset.
   int GetAndResetNumRocksDBSeeks();
 
   const DocDB& doc_db() { return doc_db_; }
@@ -245,6 +249,8 @@ class DocWriteBatch {
   KeyBytes key_prefix_;
   bool subdoc_exists_ = true;
   DocWriteBatchCache::Entry current_entry_;
+
+  int num_rocksdb_seeks_ = 0;
 };
 
 }  // namespace docdb
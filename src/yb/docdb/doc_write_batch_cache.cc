@@ -21,9 +21,8 @@
 #include "yb/docdb/docdb-internal.h"
 #include "yb/docdb/primitive_value.h"
 #include "yb/util/bytes_formatter.h"
+#include "yb/util/memory/request_arena.h"
 
-using std::back_inserter;
-using std::copy;
 using std::endl;
 using std::ostringstream;
 using std::pair;
@@ -37,6 +36,24 @@ using yb::util::FormatBytesAsStr;
 namespace yb {
 namespace docdb {
 
+DocWriteBatchCache::DocWriteBatchCache(size_t max_read_entries)
+    : max_read_entries_(max_read_entries),
+      owned_arena_(CurrentRequestArena() ? nullptr : new Arena()),
+      arena_(owned_arena_ ? owned_arena_.get() : CurrentRequestArena()),
+      prefix_to_gen_ht_(0, KeyHash(), std::equal_to<Slice>(), PrefixMap::allocator_type(arena_)) {
+}
+
+std::pair<DocWriteBatchCache::PrefixMap::iterator, bool> DocWriteBatchCache::Emplace(
+    const KeyBytes& key_bytes, const Entry& entry) {
+  auto iter = prefix_to_gen_ht_.find(key_bytes.AsSlice());
+  if (iter != prefix_to_gen_ht_.end()) {
+    return std::make_pair(iter, false);
+  }
+  Slice key;
+  CHECK(arena_->RelocateSlice(key_bytes.AsSlice(), &key));
+  return prefix_to_gen_ht_.emplace(key, entry);
+}
+
 void DocWriteBatchCache::Put(const KeyBytes& key_bytes, const DocWriteBatchCache::Entry& entry) {
     DOCDB_DEBUG_LOG(
       "Writing to DocWriteBatchCache: encoded_key_prefix=$0, gen_ht=$1, value_type=$2",
@@ -44,12 +61,24 @@ void DocWriteBatchCache::Put(const KeyBytes& key_bytes, const DocWriteBatchCache
       entry.doc_hybrid_time.ToString(),
       ToString(entry.value_type));
 
-  prefix_to_gen_ht_[key_bytes.AsStringRef()] = entry;
+  auto result = Emplace(key_bytes, entry);
+  if (!result.second) {
+    result.first->second = entry;
+  }
+}
+
+void DocWriteBatchCache::PutRead(const KeyBytes& key_bytes, const Entry& entry) {
+  if (num_read_entries_ >= max_read_entries_) {
+    return;
+  }
+  if (Emplace(key_bytes, entry).second) {
+    ++num_read_entries_;
+  }
 }
 
 boost::optional<DocWriteBatchCache::Entry> DocWriteBatchCache::Get(
     const KeyBytes& encoded_key_prefix) {
-  auto iter = prefix_to_gen_ht_.find(encoded_key_prefix.AsStringRef());
+  auto iter = prefix_to_gen_ht_.find(encoded_key_prefix.AsSlice());
 #ifdef DOCDB_DEBUG
   if (iter == prefix_to_gen_ht_.end()) {
     DOCDB_DEBUG_LOG("DocWriteBatchCache contained no entry for $0",
@@ -64,7 +93,9 @@ boost::optional<DocWriteBatchCache::Entry> DocWriteBatchCache::Get(
 
 string DocWriteBatchCache::ToDebugString() {
   vector<pair<string, Entry>> sorted_contents;
-  copy(prefix_to_gen_ht_.begin(), prefix_to_gen_ht_.end(), back_inserter(sorted_contents));
+  for (const auto& entry : prefix_to_gen_ht_) {
+    sorted_contents.emplace_back(entry.first.ToBuffer(), entry.second);
+  }
   sort(sorted_contents.begin(), sorted_contents.end());
   ostringstream ss;
   ss << "DocWriteBatchCache[" << endl;
@@ -90,7 +121,13 @@ string DocWriteBatchCache::EntryToStr(const Entry& entry) {
 }
 
 void DocWriteBatchCache::Clear() {
-  prefix_to_gen_ht_.clear();
+  // The map should release its buckets before the memory of its own arena is reused.
+  PrefixMap(0, KeyHash(), std::equal_to<Slice>(), PrefixMap::allocator_type(arena_)).swap(
+      prefix_to_gen_ht_);
+  if (owned_arena_) {
+    owned_arena_->Reset();
+  }
+  num_read_entries_ = 0;
 }
 
 }  // namespace docdb
@@ -14,6 +14,7 @@
 #ifndef YB_DOCDB_DOC_WRITE_BATCH_CACHE_H_
 #define YB_DOCDB_DOC_WRITE_BATCH_CACHE_H_
 
+#include <memory>
 #include <unordered_map>
 #include <string>
 
@@ -21,15 +22,23 @@
 
 #include "yb/common/hybrid_time.h"
 #include "yb/docdb/key_bytes.h"
+#include "yb/gutil/hash/city.h"
 #include "yb/docdb/value_type.h"
 #include "yb/docdb/value.h"
+#include "yb/util/memory/arena.h"
+#include "yb/util/slice.h"
 
 namespace yb {
 namespace docdb {
 
 // A utility used by DocWriteBatch. Caches generation hybrid_times (hybrid_times of full overwrite
 // or deletion) for key prefixes that were read from RocksDB or created by previous operations
-// performed on the DocWriteBatch.
+// performed on the DocWriteBatch. A DocWriteBatch is shared by all the operations of a write
+// operation, so the ancestors of rows written by a multi-row batch are only read once.
+//
+// The key prefixes and the map nodes are allocated from the request arena of the thread that
+// creates the cache (see request_arena.h), or from an arena of its own outside of a request scope.
+// So the cache should not outlive the request scope it was created in.
 //
 // This class is not thread-safe.
 class DocWriteBatchCache {
@@ -49,10 +58,17 @@ class DocWriteBatchCache {
     }
   };
 
+  explicit DocWriteBatchCache(size_t max_read_entries);
+
   // Records the generation hybrid_time corresponding to the given encoded key prefix, which is
   // assumed not to include the hybrid_time at the end.
   void Put(const KeyBytes& key_bytes, const Entry& entry);
 
+  // Records the state of a key prefix as read from RocksDB. Unlike the entries written by the
+  // DocWriteBatch itself, such entries could be re-read at any time, so they are not added once the
+  // cache holds max_read_entries of them.
+  void PutRead(const KeyBytes& key_bytes, const Entry& entry);
+
   // Same thing, but doesn't use an already created entry.
   void Put(const KeyBytes& key_bytes,
            DocHybridTime gen_ht,
@@ -64,7 +80,6 @@ class DocWriteBatchCache {
 
   // Returns the latest generation hybrid_time for the document/subdocument identified by the given
   // encoded key prefix.
-  // TODO: switch to taking a slice as an input to avoid making a copy on lookup.
   boost::optional<Entry> Get(const KeyBytes& encoded_key_prefix);
 
   std::string ToDebugString();
@@ -74,7 +89,24 @@ class DocWriteBatchCache {
   void Clear();
 
  private:
-  std::unordered_map<std::string, Entry> prefix_to_gen_ht_;
+  struct KeyHash {
+    size_t operator()(const Slice& key) const {
+      return util_hash::CityHash64(key.cdata(), key.size());
+    }
+  };
+
+  typedef std::unordered_map<Slice, Entry, KeyHash, std::equal_to<Slice>,
+                             ArenaAllocator<std::pair<const Slice, Entry>>> PrefixMap;
+
+  // Returns the entry for 'key_bytes', copying the key to the arena when the entry is added.
+  std::pair<PrefixMap::iterator, bool> Emplace(const KeyBytes& key_bytes, const Entry& entry);
+
+  const size_t max_read_entries_;
+  size_t num_read_entries_ = 0;
+  // Set when the cache is created outside of a request scope.
+  std::unique_ptr<Arena> owned_arena_;
+  Arena* arena_;
+  PrefixMap prefix_to_gen_ht_;
 };
 
 
@@ -0,0 +1,331 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+
+// Microbenchmarks of the DocDB hot paths, run against an in-process DocDB:
+// - building DocWriteBatches,
+// - encoding and decoding DocKeys,
+// - IntentAwareIterator seeks, with and without intents of committed transactions,
+// - DocRowwiseIterator full-row scans,
+// - compactions that drop overwritten versions.
+
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+#include "yb/common/transaction-test-util.h"
+
+#include "yb/docdb/doc_rowwise_iterator.h"
+#include "yb/docdb/docdb.pb.h"
+#include "yb/docdb/docdb_rocksdb_util.h"
+#include "yb/docdb/docdb_test_base.h"
+#include "yb/docdb/docdb_test_util.h"
+#include "yb/docdb/intent_aware_iterator.h"
+
+#include "yb/util/benchmark_counters.h"
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+#include "yb/util/tsan_util.h"
+
+DEFINE_int32(docdb_bench_num_rows, yb::NonTsanVsTsan(100000, 10000),
+             "Number of rows loaded into DocDB by the benchmarks.");
+DEFINE_int64(docdb_bench_num_ops, yb::NonTsanVsTsan(1000000, 100000),
+             "Number of operations done by the benchmarks that are not scans or compactions.");
+DEFINE_int32(docdb_bench_hash_columns, 1,
+             "Number of int64 hash key columns of the benchmark schema.");
+DEFINE_int32(docdb_bench_range_columns, 1,
+             "Number of string range key columns of the benchmark schema.");
+DEFINE_int32(docdb_bench_value_columns, 4,
+             "Number of string value columns of the benchmark schema.");
+DEFINE_int32(docdb_bench_value_size, 32, "Size of the values of the benchmark rows.");
+DEFINE_int32(docdb_bench_versions, 1, "Number of versions written for each column.");
+DEFINE_int32(docdb_bench_intent_rows_percent, 10,
+             "Percentage of the rows that also get intents of committed transactions, for the "
+             "benchmarks with intents.");
+DEFINE_int32(docdb_bench_transactions, 16,
+             "Number of transactions the intents of the benchmarks with intents are spread over.");
+DEFINE_string(docdb_bench_key_order, "random",
+              "Order in which the benchmarks access the keys: sequential or random.");
+
+DECLARE_int32(test_random_seed);
+
+namespace yb {
+namespace docdb {
+
+namespace {
+
+// Keeps the compiler from dropping the results of the benchmarked code.
+std::atomic<size_t> sink{0};
+
+constexpr int kFirstVersionMicros = 1000;
+constexpr int kFirstIntentMicros = 500000;
+constexpr int kCommitMicros = 600000;
+constexpr int kWriteBatchRows = 1000;
+
+} // namespace
+
+class DocDBBench : public DocDBTestBase {
+ protected:
+  void SetUp() override {
+    DocDBTestBase::SetUp();
+    SeedRandom();
+
+    std::vector<ColumnSchema> columns;
+    std::vector<ColumnId> ids;
+    for (int i = 0; i != FLAGS_docdb_bench_hash_columns; ++i) {
+      columns.emplace_back(Format("h$0", i), DataType::INT64, /* is_nullable */ false,
+                           /* is_hash_key */ true);
+    }
+    for (int i = 0; i != FLAGS_docdb_bench_range_columns; ++i) {
+      columns.emplace_back(Format("r$0", i), DataType::STRING, /* is_nullable */ false);
+    }
+    for (int i = 0; i != FLAGS_docdb_bench_value_columns; ++i) {
+      columns.emplace_back(Format("c$0", i), DataType::STRING, /* is_nullable */ true);
+    }
+    for (size_t i = 0; i != columns.size(); ++i) {
+      ids.emplace_back(10 + i);
+    }
+    bench_schema_ = Schema(
+        columns, ids, FLAGS_docdb_bench_hash_columns + FLAGS_docdb_bench_range_columns);
+    LOG(INFO) << "Schema: " << bench_schema_.ToString();
+
+    // The order of the keys of the operations, picked once so that all benchmarks use the same.
+    key_order_.resize(FLAGS_docdb_bench_num_rows);
+    std::iota(key_order_.begin(), key_order_.end(), 0);
+    if (FLAGS_docdb_bench_key_order == "random") {
+      std::shuffle(key_order_.begin(), key_order_.end(), std::mt19937_64(FLAGS_test_random_seed));
+    } else {
+      ASSERT_EQ("sequential", FLAGS_docdb_bench_key_order);
+    }
+  }
+
+  DocKey MakeDocKey(int64_t row) const {
+    std::vector<PrimitiveValue> hashed;
+    for (int i = 0; i != FLAGS_docdb_bench_hash_columns; ++i) {
+      hashed.emplace_back(static_cast<int64_t>(row + i));
+    }
+    std::vector<PrimitiveValue> range;
+    for (int i = 0; i != FLAGS_docdb_bench_range_columns; ++i) {
+      range.push_back(PrimitiveValue(Format("range_$0_$1", i, row)));
+    }
+    // The hash does not have to match the hash columns, as long as the rows are spread.
+    return DocKey(static_cast<DocKeyHash>(row * 0x9e3779b1), std::move(hashed), std::move(range));
+  }
+
+  std::string MakeValue(int64_t row, int column, int version) const {
+    std::string result = Format("$0_$1_$2_", row, column, version);
+    result.resize(std::max<size_t>(FLAGS_docdb_bench_value_size, result.size()), 'x');
+    return result;
+  }
+
+  ColumnId ValueColumnId(int column) const {
+    return bench_schema_.column_id(bench_schema_.num_key_columns() + column);
+  }
+
+  void AddRow(int64_t row, int version, DocWriteBatch* dwb) {
+    const KeyBytes encoded_key = MakeDocKey(row).Encode();
+    for (int column = 0; column != FLAGS_docdb_bench_value_columns; ++column) {
+      ASSERT_OK(dwb->SetPrimitive(
+          DocPath(encoded_key, PrimitiveValue(ValueColumnId(column))),
+          Value(PrimitiveValue(MakeValue(row, column, version)))));
+    }
+  }
+
+  // Writes all versions of all rows, and flushes them to an SST file.
+  void LoadRows() {
+    auto dwb = MakeDocWriteBatch();
+    for (int version = 0; version != FLAGS_docdb_bench_versions; ++version) {
+      const auto hybrid_time = HybridTime::FromMicros(kFirstVersionMicros + version);
+      for (int64_t row = 0; row != FLAGS_docdb_bench_num_rows; ++row) {
+        ASSERT_NO_FATALS(AddRow(row, version, &dwb));
+        if ((row + 1) % kWriteBatchRows == 0) {
+          ASSERT_OK(WriteToRocksDBAndClear(&dwb, hybrid_time));
+        }
+      }
+      ASSERT_OK(WriteToRocksDBAndClear(&dwb, hybrid_time));
+    }
+    ASSERT_OK(FlushRocksDbAndWait());
+  }
+
+  // Writes new values of some rows in transactions that are committed, but whose intents are not
+  // applied yet, so reads have to resolve them.
+  void WriteIntents() {
+    SetTransactionIsolationLevel(IsolationLevel::SNAPSHOT_ISOLATION);
+    std::vector<TransactionId> transactions;
+    for (int i = 0; i != FLAGS_docdb_bench_transactions; ++i) {
+      transactions.push_back(GenerateTransactionId());
+    }
+    const int64_t num_intent_rows =
+        FLAGS_docdb_bench_num_rows * FLAGS_docdb_bench_intent_rows_percent / 100;
+    auto dwb = MakeDocWriteBatch();
+    for (size_t i = 0; i != transactions.size(); ++i) {
+      SetCurrentTransactionId(transactions[i]);
+      for (int64_t row = i; row < num_intent_rows; row += transactions.size()) {
+        ASSERT_NO_FATALS(AddRow(key_order_[row], FLAGS_docdb_bench_versions, &dwb));
+      }
+      ASSERT_OK(WriteToRocksDBAndClear(&dwb, HybridTime::FromMicros(kFirstIntentMicros + i)));
+      txn_status_manager_.Commit(transactions[i], HybridTime::FromMicros(kCommitMicros + i));
+    }
+    ResetCurrentTransactionId();
+    LOG(INFO) << "Wrote intents for " << num_intent_rows << " rows in " << transactions.size()
+              << " transactions";
+  }
+
+  // The context of a reading transaction, which resolves the intents of the others through the
+  // transaction status manager.
+  TransactionOperationContextOpt ReadContext() {
+    return TransactionOperationContext(GenerateTransactionId(), &txn_status_manager_);
+  }
+
+  // Runs 'ops', which does num_ops operations, and reports the time, instructions and allocations
+  // per op. Those of all threads are counted, so that the ones of background compactions are too.
+  template <class Ops>
+  void Measure(const std::string& name, int64_t num_ops, const Ops& ops) {
+    const auto counters_before = counters_.Read();
+    const auto start = MonoTime::Now();
+    ops();
+    const auto elapsed = MonoTime::Now() - start;
+    const auto counts = counters_.Read() - counters_before;
+    LOG(INFO) << name << ": " << num_ops << " ops in " << elapsed;
+    LOG(INFO) << name << " ops/sec: " << num_ops / elapsed.ToSeconds();
+    LOG(INFO) << name << " ns/op: " << 1.0 * elapsed.ToNanoseconds() / num_ops;
+    if (counts.instructions >= 0) {
+      LOG(INFO) << name << " instructions/op: " << 1.0 * counts.instructions / num_ops;
+    }
+    if (counts.allocations >= 0) {
+      LOG(INFO) << name << " allocations/op: " << 1.0 * counts.allocations / num_ops;
+    }
+  }
+
+  // Runs 'op' for op indexes from 0 to num_ops - 1.
+  template <class Op>
+  void RunBenchmark(const std::string& name, int64_t num_ops, const Op& op) {
+    Measure(name, num_ops, [num_ops, &op] {
+      for (int64_t i = 0; i != num_ops; ++i) {
+        op(i);
+      }
+    });
+  }
+
+  void BenchmarkSeeks(const std::string& name, const TransactionOperationContextOpt& context) {
+    std::vector<KeyBytes> keys;
+    keys.reserve(key_order_.size());
+    for (auto row : key_order_) {
+      keys.push_back(MakeDocKey(row).Encode());
+    }
+    auto iter = CreateIntentAwareIterator(
+        doc_db(), BloomFilterMode::DONT_USE_BLOOM_FILTER, boost::none, rocksdb::kDefaultQueryId,
+        context, CoarseTimePoint::max(), ReadHybridTime::Max());
+    RunBenchmark(name, FLAGS_docdb_bench_num_ops, [&keys, &iter](int64_t i) {
+      iter->Seek(keys[i % keys.size()]);
+      ASSERT_TRUE(iter->valid());
+      auto key = iter->FetchKey();
+      ASSERT_OK(key);
+      sink += key->size();
+    });
+  }
+
+  void BenchmarkScan(const std::string& name, const TransactionOperationContextOpt& context) {
+    DocRowwiseIterator iter(
+        bench_schema_, bench_schema_, context, doc_db(), CoarseTimePoint::max(),
+        ReadHybridTime::Max());
+    ASSERT_OK(iter.Init());
+    QLTableRow row;
+    RunBenchmark(name, FLAGS_docdb_bench_num_rows, [&iter, &row](int64_t i) {
+      ASSERT_TRUE(iter.HasNext());
+      ASSERT_OK(iter.NextRow(&row));
+      sink += row.ColumnCount();
+    });
+    ASSERT_FALSE(iter.HasNext());
+  }
+
+  // Created with the fixture, so that it counts the threads started by SetUp().
+  BenchmarkCounters counters_;
+  Schema bench_schema_;
+  std::vector<int64_t> key_order_;
+  TransactionStatusManagerMock txn_status_manager_;
+};
+
+TEST_F(DocDBBench, BenchmarkDocKeyEncode) {
+  std::vector<DocKey> doc_keys;
+  for (auto row : key_order_) {
+    doc_keys.push_back(MakeDocKey(row));
+  }
+  RunBenchmark("DocKey::Encode", FLAGS_docdb_bench_num_ops, [&doc_keys](int64_t i) {
+    sink += doc_keys[i % doc_keys.size()].Encode().size();
+  });
+}
+
+TEST_F(DocDBBench, BenchmarkDocKeyDecode) {
+  std::vector<KeyBytes> encoded_keys;
+  for (auto row : key_order_) {
+    encoded_keys.push_back(MakeDocKey(row).Encode());
+  }
+  DocKey doc_key;
+  RunBenchmark("DocKey::FullyDecodeFrom", FLAGS_docdb_bench_num_ops,
+               [&encoded_keys, &doc_key](int64_t i) {
+    ASSERT_OK(doc_key.FullyDecodeFrom(encoded_keys[i % encoded_keys.size()].AsSlice()));
+    sink += doc_key.range_group().size();
+  });
+}
+
+TEST_F(DocDBBench, BenchmarkDocWriteBatch) {
+  // Each op builds the write batch of a row, and moves it to the protobuf replicated by Raft, as
+  // the write of a tablet does.
+  KeyValueWriteBatchPB write_batch_pb;
+  RunBenchmark("DocWriteBatch", FLAGS_docdb_bench_num_ops, [this, &write_batch_pb](int64_t i) {
+    auto dwb = MakeDocWriteBatch();
+    AddRow(key_order_[i % key_order_.size()], 0, &dwb);
+    dwb.MoveToWriteBatchPB(&write_batch_pb);
+    sink += write_batch_pb.write_pairs_size();
+    write_batch_pb.Clear();
+  });
+}
+
+TEST_F(DocDBBench, BenchmarkIntentAwareIteratorSeek) {
+  ASSERT_NO_FATALS(LoadRows());
+  ASSERT_NO_FATALS(BenchmarkSeeks("IntentAwareIterator::Seek", boost::none));
+  ASSERT_NO_FATALS(BenchmarkSeeks("IntentAwareIterator::Seek no intents in txn", ReadContext()));
+  ASSERT_NO_FATALS(WriteIntents());
+  ASSERT_NO_FATALS(BenchmarkSeeks("IntentAwareIterator::Seek with intents", ReadContext()));
+}
+
+TEST_F(DocDBBench, BenchmarkRowwiseIterator) {
+  ASSERT_NO_FATALS(LoadRows());
+  ASSERT_NO_FATALS(BenchmarkScan("DocRowwiseIterator", boost::none));
+  ASSERT_NO_FATALS(WriteIntents());
+  ASSERT_NO_FATALS(BenchmarkScan("DocRowwiseIterator with intents", ReadContext()));
+}
+
+TEST_F(DocDBBench, BenchmarkCompaction) {
+  ASSERT_NO_FATALS(LoadRows());
+  // All but the latest version of each column are dropped by the compaction filter.
+  SetHistoryCutoffHybridTime(
+      HybridTime::FromMicros(kFirstVersionMicros + FLAGS_docdb_bench_versions));
+  const int64_t num_entries = static_cast<int64_t>(FLAGS_docdb_bench_num_rows) *
+                              FLAGS_docdb_bench_value_columns * FLAGS_docdb_bench_versions;
+  // The whole DB is compacted at once, each entry that goes through the compaction filter is an
+  // op.
+  Measure("Compaction", num_entries, [this] {
+    ASSERT_OK(FullyCompactDB(rocksdb()));
+  });
+}
+
+}  // namespace docdb
+}  // namespace yb
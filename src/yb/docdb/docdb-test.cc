@@ -27,6 +27,7 @@
 #include "yb/docdb/docdb_test_util.h"
 #include "yb/docdb/in_mem_docdb.h"
 #include "yb/docdb/intent.h"
+#include "yb/docdb/packed_row.h"
 #include "yb/gutil/stringprintf.h"
 #include "yb/rocksutil/yb_rocksdb.h"
 #include "yb/server/hybrid_clock.h"
@@ -58,6 +59,11 @@ using namespace std::chrono_literals;
 
 DECLARE_bool(use_docdb_aware_bloom_filter);
 DECLARE_int32(max_nexts_to_avoid_seek);
+DECLARE_bool(use_docdb_hybrid_time_file_filter);
+DECLARE_bool(use_docdb_overwrite_file_filter);
+DECLARE_int32(tablet_obsolete_versions_compaction_trigger_percent);
+DECLARE_uint64(tablet_obsolete_versions_compaction_min_entries);
+DECLARE_int32(docdb_hash_prefix_memtable_bucket_bits);
 
 #define ASSERT_DOC_DB_DEBUG_DUMP_STR_EQ(str) ASSERT_NO_FATALS(AssertDocDbDebugDumpStrEq(str))
 
@@ -2353,6 +2359,28 @@ TEST_F(DocDBTest, MultiOperationDocWriteBatch) {
       )#", dwb_str);
 }
 
+TEST_F(DocDBTest, DocWriteBatchCacheSavesSeeks) {
+  const auto encoded_doc_key = DocKey(PrimitiveValues("a")).Encode();
+  {
+    auto dwb = MakeDocWriteBatch(InitMarkerBehavior::kRequired);
+    ASSERT_OK(dwb.SetPrimitive(DocPath(encoded_doc_key, "b"), PrimitiveValue("v1")));
+    ASSERT_OK(WriteToRocksDB(dwb, 1000_usec_ht));
+  }
+
+  auto dwb = MakeDocWriteBatch(InitMarkerBehavior::kRequired);
+  ASSERT_OK(dwb.SetPrimitive(DocPath(encoded_doc_key, "c"), PrimitiveValue("v2")));
+  const int first_seeks = dwb.GetAndResetNumRocksDBSeeks();
+  ASSERT_GT(first_seeks, 0);
+
+  // The document itself was already read by the previous operation of the same batch.
+  ASSERT_OK(dwb.SetPrimitive(DocPath(encoded_doc_key, "d"), PrimitiveValue("v3")));
+  ASSERT_LT(dwb.GetAndResetNumRocksDBSeeks(), first_seeks);
+
+  // Everything on the path was written by this batch.
+  ASSERT_OK(dwb.SetPrimitive(DocPath(encoded_doc_key, "c"), PrimitiveValue("v4")));
+  ASSERT_EQ(0, dwb.GetAndResetNumRocksDBSeeks());
+}
+
 class DocDBTestBoundaryValues: public DocDBTest {
  protected:
   void TestBoundaryValues(size_t flush_rate) {
@@ -2443,6 +2471,133 @@ TEST_F_EX(DocDBTest, BoundaryValuesMultiFiles, DocDBTestBoundaryValues) {
   TestBoundaryValues(350);
 }
 
+TEST_F(DocDBTest, ExpiredFilesDeletion) {
+  SetTableTTL(1000);
+  // file1: k1 at 1ms, file2: k2 at 2s, with a value that never expires.
+  ASSERT_OK(SetPrimitive(DocPath(DocKey(PrimitiveValues("k1")).Encode()),
+                         Value(PrimitiveValue("v1")), HybridTime::FromMicros(1000)));
+  ASSERT_OK(FlushRocksDbAndWait());
+  ASSERT_OK(SetPrimitive(DocPath(DocKey(PrimitiveValues("k2")).Encode()),
+                         Value(PrimitiveValue("v2")), HybridTime::FromMicros(2000000)));
+  ASSERT_OK(SetPrimitive(DocPath(DocKey(PrimitiveValues("k3")).Encode()),
+                         Value(PrimitiveValue("v3"), 0ms), HybridTime::FromMicros(2000000)));
+  ASSERT_OK(FlushRocksDbAndWait());
+  ASSERT_EQ(2, NumSSTableFiles());
+
+  // Only the values of file1 expired before the history cutoff. The next flush lets compactions
+  // delete it.
+  SetHistoryCutoffHybridTime(HybridTime::FromMicros(1500000));
+  ASSERT_OK(SetPrimitive(DocPath(DocKey(PrimitiveValues("k4")).Encode()),
+                         Value(PrimitiveValue("v4")), HybridTime::FromMicros(3000000)));
+  ASSERT_OK(FlushRocksDbAndWait());
+  ASSERT_OK(WaitFor([this] { return NumSSTableFiles() == 2; }, 10s, "Expired file deleted"));
+  ASSERT_DOC_DB_DEBUG_DUMP_STR_EQ(R"#(
+      SubDocKey(DocKey([], ["k2"]), [HT{ physical: 2000000 }]) -> "v2"
+      SubDocKey(DocKey([], ["k3"]), [HT{ physical: 2000000 }]) -> "v3"; ttl: 0.000s
+      SubDocKey(DocKey([], ["k4"]), [HT{ physical: 3000000 }]) -> "v4"
+      )#");
+
+  // file2 holds a value that never expires, so it is kept however old it is.
+  SetHistoryCutoffHybridTime(HybridTime::FromMicros(10000000));
+  ASSERT_OK(SetPrimitive(DocPath(DocKey(PrimitiveValues("k5")).Encode()),
+                         Value(PrimitiveValue("v5")), HybridTime::FromMicros(4000000)));
+  ASSERT_OK(FlushRocksDbAndWait());
+  ASSERT_EQ(3, NumSSTableFiles());
+}
+
+TEST_F(DocDBTest, ObsoleteVersionsCompaction) {
+  FLAGS_tablet_obsolete_versions_compaction_trigger_percent = 30;
+  FLAGS_tablet_obsolete_versions_compaction_min_entries = 1;
+
+  auto num_obsolete_versions = [this]() -> Result<std::vector<std::string>> {
+    rocksdb::TablePropertiesCollection props;
+    RETURN_NOT_OK(rocksdb()->GetPropertiesOfAllTables(&props));
+    std::vector<std::string> result;
+    for (const auto& file_and_props : props) {
+      const auto& user_props = file_and_props.second->user_collected_properties;
+      auto it = user_props.find(kObsoleteVersionsPropertyName);
+      result.push_back(it != user_props.end() ? it->second : "");
+    }
+    return result;
+  };
+
+  // Versions of k1 at 2ms and 1ms are overwritten at the history cutoff, the one at 4ms is not
+  // visible at the cutoff yet.
+  SetHistoryCutoffHybridTime(HybridTime::FromMicros(3000));
+  for (int i = 1; i <= 4; ++i) {
+    ASSERT_OK(SetPrimitive(DocPath(DocKey(PrimitiveValues("k1")).Encode()),
+                           Value(PrimitiveValue(Format("v$0", i))),
+                           HybridTime::FromMicros(i * 1000)));
+  }
+  ASSERT_OK(SetPrimitive(DocPath(DocKey(PrimitiveValues("k2")).Encode()),
+                         Value(PrimitiveValue("v")), HybridTime::FromMicros(1000)));
+  ASSERT_OK(FlushRocksDbAndWait());
+
+  // The flushed file has 2 obsolete versions of its 5 entries, so it is compacted on its own.
+  ASSERT_OK(WaitFor([&num_obsolete_versions]() -> Result<bool> {
+    return VERIFY_RESULT(num_obsolete_versions()) == std::vector<std::string>{"0"};
+  }, 10s, "Obsolete versions compacted"));
+  ASSERT_DOC_DB_DEBUG_DUMP_STR_EQ(R"#(
+      SubDocKey(DocKey([], ["k1"]), [HT{ physical: 4000 }]) -> "v4"
+      SubDocKey(DocKey([], ["k1"]), [HT{ physical: 3000 }]) -> "v3"
+      SubDocKey(DocKey([], ["k2"]), [HT{ physical: 1000 }]) -> "v"
+      )#");
+}
+
+TEST_F(DocDBTest, HashPrefixMemTable) {
+  // 4 hash buckets, so some of them are empty and some are shared by several hashes.
+  FLAGS_docdb_hash_prefix_memtable_bucket_bits = 2;
+  ASSERT_OK(UseHashPrefixMemTable());
+
+  const std::vector<DocKeyHash> hashes = {0xffff, 0x0000, 0x8001, 0x8000, 0x0123, 0xc000};
+  for (size_t i = 0; i != hashes.size(); ++i) {
+    for (const auto& range_key : {"b", "a"}) {
+      const DocKey doc_key(hashes[i], PrimitiveValues("h"), PrimitiveValues(range_key));
+      ASSERT_OK(SetPrimitive(DocPath(doc_key.Encode()), PrimitiveValue(Format("v$0", i)),
+                             HybridTime::FromMicros(1000 + i)));
+    }
+  }
+  // Keys of the range partitioned layout are ordered after all hashed keys.
+  ASSERT_OK(SetPrimitive(DocPath(DocKey(PrimitiveValues("r")).Encode()), PrimitiveValue("v"),
+                         HybridTime::FromMicros(2000)));
+
+  auto read_keys = [this](bool reverse) {
+    std::vector<std::string> result;
+    std::unique_ptr<rocksdb::Iterator> iter(rocksdb()->NewIterator(rocksdb::ReadOptions()));
+    for (reverse ? iter->SeekToLast() : iter->SeekToFirst(); iter->Valid();
+         reverse ? iter->Prev() : iter->Next()) {
+      result.push_back(iter->key().ToBuffer());
+    }
+    return result;
+  };
+
+  // The memtable is iterated in key order in both directions.
+  const auto memtable_keys = read_keys(/* reverse */ false);
+  ASSERT_EQ(hashes.size() * 2 + 1, memtable_keys.size());
+  ASSERT_TRUE(std::is_sorted(memtable_keys.begin(), memtable_keys.end()));
+  auto reverse_keys = read_keys(/* reverse */ true);
+  std::reverse(reverse_keys.begin(), reverse_keys.end());
+  ASSERT_EQ(memtable_keys, reverse_keys);
+
+  // Seeks land in the bucket of the target, or in the next non-empty one.
+  std::unique_ptr<rocksdb::Iterator> iter(rocksdb()->NewIterator(rocksdb::ReadOptions()));
+  for (const DocKeyHash hash : {0x0000, 0x4000, 0x8001, 0xcfff}) {
+    const auto target = DocKey(hash, PrimitiveValues("h"), PrimitiveValues()).Encode();
+    iter->Seek(target.AsSlice());
+    auto expected = std::lower_bound(
+        memtable_keys.begin(), memtable_keys.end(), target.AsSlice().ToBuffer());
+    ASSERT_NE(expected, memtable_keys.end());
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ(*expected, iter->key().ToBuffer());
+  }
+
+  // The flushed file holds the same records in the same order.
+  const auto memtable_dump = DocDBDebugDumpToStr();
+  ASSERT_OK(FlushRocksDbAndWait());
+  ASSERT_EQ(memtable_keys, read_keys(/* reverse */ false));
+  ASSERT_EQ(memtable_dump, DocDBDebugDumpToStr());
+}
+
 TEST_F(DocDBTest, BloomFilterTest) {
   // Turn off "next instead of seek" optimization, because this test rely on DocDB to do seeks.
   FLAGS_max_nexts_to_avoid_seek = 0;
@@ -2542,6 +2697,91 @@ TEST_F(DocDBTest, BloomFilterTest) {
   ASSERT_NO_FATALS(CheckBloom(2, &total_bloom_useful, 2, &total_table_iterators));
 }
 
+TEST_F(DocDBTest, HybridTimeFileFilter) {
+  // Each file holds a version of the same document, written at its own hybrid time:
+  // file1: 1000, file2: 2000, file3: 3000.
+  DocKey key(0, PrimitiveValues("key"), PrimitiveValues());
+  auto dwb = MakeDocWriteBatch();
+  for (int i = 1; i <= 3; ++i) {
+    dwb.Clear();
+    ASSERT_OK(dwb.SetPrimitive(DocPath(key.Encode()), PrimitiveValue(Format("value$0", i))));
+    ASSERT_OK(WriteToRocksDB(dwb, HybridTime::FromMicros(1000 * i)));
+    ASSERT_OK(FlushRocksDbAndWait());
+  }
+
+  auto read_and_count_files = [this, &key](const ReadHybridTime& read_time) -> std::string {
+    const auto iterators_before =
+        options().statistics->getTickerCount(rocksdb::NO_TABLE_CACHE_ITERATORS);
+    SubDocument doc_from_rocksdb;
+    bool subdoc_found_in_rocksdb = false;
+    auto encoded_subdoc_key = SubDocKey(key).EncodeWithoutHt();
+    GetSubDocumentData data = { encoded_subdoc_key, &doc_from_rocksdb, &subdoc_found_in_rocksdb };
+    EXPECT_OK(GetSubDocument(
+        doc_db(), data, rocksdb::kDefaultQueryId, kNonTransactionalOperationContext,
+        CoarseTimePoint::max() /* deadline */, read_time));
+    EXPECT_TRUE(subdoc_found_in_rocksdb);
+    const auto iterators_after =
+        options().statistics->getTickerCount(rocksdb::NO_TABLE_CACHE_ITERATORS);
+    return Format("$0 $1", doc_from_rocksdb.ToString(), iterators_after - iterators_before);
+  };
+
+  // Files whose records are all newer than the read time are not read.
+  ASSERT_EQ("\"value1\" 1", read_and_count_files(ReadHybridTime::FromMicros(1500)));
+  ASSERT_EQ("\"value2\" 2", read_and_count_files(ReadHybridTime::FromMicros(2500)));
+  ASSERT_EQ("\"value3\" 3", read_and_count_files(ReadHybridTime::Max()));
+
+  // Files with records below the global limit are still read, to detect read restarts.
+  ASSERT_EQ("\"value1\" 2", read_and_count_files(ReadHybridTime::FromHybridTimeRange(
+      {HybridTime::FromMicros(1500), HybridTime::FromMicros(2500)})));
+
+  FLAGS_use_docdb_hybrid_time_file_filter = false;
+  ASSERT_EQ("\"value1\" 3", read_and_count_files(ReadHybridTime::FromMicros(1500)));
+}
+
+TEST_F(DocDBTest, OverwriteFileFilter) {
+  // file1: 1000, children of the document. file2: 2000, the document is deleted.
+  // file3: 3000, a new child of the document.
+  const DocKey doc_key(PrimitiveValues("k1"));
+  KeyBytes encoded_doc_key(doc_key.Encode());
+  for (int i = 0; i != 10; ++i) {
+    ASSERT_OK(SetPrimitive(DocPath(encoded_doc_key, PrimitiveValue(Format("s$0", i))),
+                           Value(PrimitiveValue(Format("v$0", i))), 1000_usec_ht));
+  }
+  ASSERT_OK(FlushRocksDbAndWait());
+  ASSERT_OK(DeleteSubDoc(DocPath(encoded_doc_key), 2000_usec_ht));
+  ASSERT_OK(FlushRocksDbAndWait());
+  ASSERT_OK(SetPrimitive(DocPath(encoded_doc_key, PrimitiveValue("s10")),
+                         Value(PrimitiveValue("v10")), 3000_usec_ht));
+  ASSERT_OK(FlushRocksDbAndWait());
+
+  auto read_and_count_files = [this, &doc_key](const ReadHybridTime& read_time) -> std::string {
+    const auto iterators_before =
+        options().statistics->getTickerCount(rocksdb::NO_TABLE_CACHE_ITERATORS);
+    SubDocument doc_from_rocksdb;
+    bool subdoc_found_in_rocksdb = false;
+    auto encoded_subdoc_key = SubDocKey(doc_key).EncodeWithoutHt();
+    GetSubDocumentData data = { encoded_subdoc_key, &doc_from_rocksdb, &subdoc_found_in_rocksdb };
+    EXPECT_OK(GetSubDocument(
+        doc_db(), data, rocksdb::kDefaultQueryId, kNonTransactionalOperationContext,
+        CoarseTimePoint::max() /* deadline */, read_time));
+    EXPECT_TRUE(subdoc_found_in_rocksdb);
+    const auto iterators_after =
+        options().statistics->getTickerCount(rocksdb::NO_TABLE_CACHE_ITERATORS);
+    // The number of children and the number of files read.
+    return Format("$0 $1", doc_from_rocksdb.object_num_keys(), iterators_after - iterators_before);
+  };
+
+  // The document is read with an iterator over all three files, that finds the deletion, and
+  // then with an iterator that skips file1.
+  ASSERT_EQ("1 5", read_and_count_files(ReadHybridTime::Max()));
+
+  // Nothing was overwritten before 1500, so all the files that could be visible are read once.
+  ASSERT_EQ("10 1", read_and_count_files(ReadHybridTime::FromMicros(1500)));
+
+  FLAGS_use_docdb_overwrite_file_filter = false;
+  ASSERT_EQ("1 3", read_and_count_files(ReadHybridTime::Max()));
+}
+
 TEST_F(DocDBTest, MergingIterator) {
   // Test for the case described in https://yugabyte.atlassian.net/browse/ENG-1677.
 
@@ -3232,5 +3472,81 @@ TEST_F(DocDBTest, ForceFlushedFrontier) {
   ASSERT_EQ(*new_user_frontier_ptr, *rocksdb_->GetFlushedFrontier());
 }
 
+namespace {
+
+std::string ColumnValueToString(const SubDocument& row, ColumnId column_id) {
+  const SubDocument* column = row.GetChild(PrimitiveValue(column_id));
+  return column == nullptr ? "<absent>" : column->ToString();
+}
+
+} // namespace
+
+TEST_F(DocDBTest, PackedRow) {
+  auto dwb = MakeDocWriteBatch();
+  // An older column value that the packed row fully overwrites.
+  ASSERT_OK(dwb.SetPrimitive(
+      DocPath(kEncodedDocKey1, PrimitiveValue(ColumnId(13))), PrimitiveValue("old")));
+  ASSERT_OK(WriteToRocksDBAndClear(&dwb, 500_usec_ht));
+
+  PackedRowEncoder encoder(/* schema_version */ 1);
+  encoder.AddColumn(PrimitiveValue(ColumnId(10)), Value(PrimitiveValue("a")));
+  encoder.AddColumn(PrimitiveValue(ColumnId(11)), Value(PrimitiveValue("b")));
+  encoder.AddColumn(PrimitiveValue(ColumnId(12)), Value(PrimitiveValue::kTombstone));
+  ASSERT_EQ(3, encoder.num_columns());
+  auto packed_row = encoder.Finish();
+
+  PackedRowDecoder decoder;
+  ASSERT_OK(decoder.Init(packed_row));
+  ASSERT_EQ(1, decoder.schema_version());
+  PrimitiveValue column_key;
+  Slice encoded_value;
+  ASSERT_TRUE(ASSERT_RESULT(decoder.Next(&column_key, &encoded_value)));
+  ASSERT_EQ(PrimitiveValue(ColumnId(10)), column_key);
+
+  ASSERT_OK(dwb.SetPackedRow(kEncodedDocKey1.AsSlice(), packed_row));
+  ASSERT_OK(WriteToRocksDBAndClear(&dwb, 1000_usec_ht));
+
+  // Per-column updates on top of the packed row.
+  ASSERT_OK(dwb.SetPrimitive(
+      DocPath(kEncodedDocKey1, PrimitiveValue(ColumnId(11))), PrimitiveValue("b2")));
+  ASSERT_OK(WriteToRocksDBAndClear(&dwb, 2000_usec_ht));
+  ASSERT_OK(dwb.SetPrimitive(
+      DocPath(kEncodedDocKey1, PrimitiveValue(ColumnId(10))), PrimitiveValue::kTombstone));
+  ASSERT_OK(WriteToRocksDBAndClear(&dwb, 3000_usec_ht));
+
+  auto encoded_subdoc_key = SubDocKey(kDocKey1).EncodeWithoutHt();
+  auto read_row = [this, &encoded_subdoc_key](HybridTime ht) -> Result<SubDocument> {
+    SubDocument row;
+    bool doc_found = false;
+    GetSubDocumentData data = { encoded_subdoc_key, &row, &doc_found };
+    RETURN_NOT_OK(GetSubDocument(
+        doc_db(), data, rocksdb::kDefaultQueryId, kNonTransactionalOperationContext,
+        CoarseTimePoint::max() /* deadline */, ReadHybridTime::SingleTime(ht)));
+    EXPECT_TRUE(doc_found);
+    return row;
+  };
+
+  auto row = ASSERT_RESULT(read_row(1500_usec_ht));
+  ASSERT_EQ("\"a\"", ColumnValueToString(row, ColumnId(10)));
+  ASSERT_EQ("\"b\"", ColumnValueToString(row, ColumnId(11)));
+  ASSERT_EQ("<absent>", ColumnValueToString(row, ColumnId(12)));
+  ASSERT_EQ("<absent>", ColumnValueToString(row, ColumnId(13)));
+
+  row = ASSERT_RESULT(read_row(2500_usec_ht));
+  ASSERT_EQ("\"a\"", ColumnValueToString(row, ColumnId(10)));
+  ASSERT_EQ("\"b2\"", ColumnValueToString(row, ColumnId(11)));
+
+  row = ASSERT_RESULT(read_row(3500_usec_ht));
+  ASSERT_EQ("<absent>", ColumnValueToString(row, ColumnId(10)));
+  ASSERT_EQ("\"b2\"", ColumnValueToString(row, ColumnId(11)));
+
+  // Compaction garbage-collects the column overwritten by the packed row, and keeps the rest.
+  FullyCompactHistoryBefore(3500_usec_ht);
+  row = ASSERT_RESULT(read_row(3500_usec_ht));
+  ASSERT_EQ("<absent>", ColumnValueToString(row, ColumnId(10)));
+  ASSERT_EQ("\"b2\"", ColumnValueToString(row, ColumnId(11)));
+  ASSERT_EQ("<absent>", ColumnValueToString(row, ColumnId(13)));
+}
+
 }  // namespace docdb
 }  // namespace yb
@@ -31,6 +31,7 @@
 #include "yb/docdb/docdb_util.h"
 #include "yb/docdb/intent.h"
 #include "yb/docdb/intent_aware_iterator.h"
+#include "yb/docdb/packed_row.h"
 #include "yb/docdb/shared_lock_manager.h"
 #include "yb/docdb/subdocument.h"
 #include "yb/docdb/value.h"
@@ -45,8 +46,10 @@
 #include "yb/util/date_time.h"
 #include "yb/util/enums.h"
 #include "yb/util/logging.h"
+#include "yb/util/memory/request_arena.h"
 #include "yb/util/status.h"
 #include "yb/util/metrics.h"
+#include "yb/util/flag_tags.h"
 
 using std::endl;
 using std::list;
@@ -63,6 +66,13 @@ using yb::util::FormatBytesAsStr;
 using yb::FormatRocksDBSliceAsStr;
 using strings::Substitute;
 
+DEFINE_bool(use_docdb_overwrite_file_filter, true,
+            "Whether reads of a subdocument should skip the SST files that only hold records "
+            "written before the subdocument or one of its ancestors was last overwritten, e.g. "
+            "by deleting it.");
+TAG_FLAG(use_docdb_overwrite_file_filter, advanced);
+TAG_FLAG(use_docdb_overwrite_file_filter, runtime);
+
 
 namespace yb {
 namespace docdb {
@@ -301,8 +311,12 @@ Status ExecuteDocWriteOperation(const vector<unique_ptr<DocOperation>>& doc_writ
                                 KeyValueWriteBatchPB* write_batch,
                                 InitMarkerBehavior init_marker_behavior,
                                 std::atomic<int64_t>* monotonic_counter,
-                                HybridTime* restart_read_ht) {
+                                HybridTime* restart_read_ht,
+                                int* num_rocksdb_seeks) {
   DCHECK_ONLY_NOTNULL(restart_read_ht);
+  // The batch only lives during this call, so its cache could use a request arena even when we
+  // are not called by an RPC handler.
+  ScopedRequestArena request_arena;
   DocWriteBatch doc_write_batch(doc_db, init_marker_behavior, monotonic_counter);
   DocOperationApplyData data = {&doc_write_batch, deadline, read_time, restart_read_ht};
   for (const unique_ptr<DocOperation>& doc_op : doc_write_ops) {
@@ -314,6 +328,9 @@ Status ExecuteDocWriteOperation(const vector<unique_ptr<DocOperation>>& doc_writ
     }
     RETURN_NOT_OK(s);
   }
+  if (num_rocksdb_seeks) {
+    *num_rocksdb_seeks = doc_write_batch.GetAndResetNumRocksDBSeeks();
+  }
   doc_write_batch.MoveToWriteBatchPB(write_batch);
   return Status::OK();
 }
@@ -550,6 +567,37 @@ void SeekToLowerBound(const SliceKeyBound& lower_bound, IntentAwareIterator* ite
   }
 }
 
+// Fills result with the columns of the given packed row, as they were written at write_time.
+// Columns stored as tombstones in the packed row are left out. If projection is specified, only
+// the values of columns in the projection are decoded, the projection should be sorted.
+CHECKED_STATUS UnpackRow(
+    const Slice& packed_row, const DocHybridTime& write_time, SubDocument* result,
+    const std::vector<PrimitiveValue>* projection = nullptr) {
+  PackedRowDecoder decoder;
+  RETURN_NOT_OK(decoder.Init(packed_row));
+  *result = SubDocument();
+  PrimitiveValue column_key;
+  Slice encoded_value;
+  while (VERIFY_RESULT(decoder.Next(&column_key, &encoded_value))) {
+    if (projection &&
+        !std::binary_search(projection->begin(), projection->end(), column_key)) {
+      continue;
+    }
+    Value column_value;
+    RETURN_NOT_OK(column_value.Decode(encoded_value));
+    if (column_value.value_type() == ValueType::kTombstone) {
+      continue;
+    }
+    // Packed rows are only written without TTL.
+    column_value.mutable_primitive_value()->SetTtl(-1);
+    column_value.mutable_primitive_value()->SetWriteTime(
+        write_time.hybrid_time().GetPhysicalValueMicros());
+    result->SetChild(std::move(column_key),
+                     SubDocument(std::move(*column_value.mutable_primitive_value())));
+  }
+  return Status::OK();
+}
+
 // This function does not assume that object init_markers are present. If no init marker is present,
 // or if a tombstone is found at some level, it still looks for subkeys inside it if they have
 // larger timestamps.
@@ -572,6 +620,9 @@ CHECKED_STATUS BuildSubDocument(
     int64* num_values_observed) {
   VLOG(3) << "BuildSubDocument data: " << data << " read_time: " << iter->read_time()
           << " low_ts: " << low_ts;
+  // Set when the visible version of subdocument_key is a packed row. Columns of the packed row are
+  // put into data.result right away, and are then replaced or removed by newer per-column entries.
+  bool packed_row_found = false;
   while (iter->valid()) {
     if (data.deadline_info && data.deadline_info->CheckAndSetDeadlinePassed()) {
       return STATUS(Expired, "Deadline for query passed.");
@@ -599,6 +650,21 @@ CHECKED_STATUS BuildSubDocument(
       iter->SeekPastSubKey(key);
       continue;
     }
+    if (IsPackedRow(value)) {
+      if (key != data.subdocument_key) {
+        return STATUS_FORMAT(Corruption, "Packed row found below the row level: $0",
+                             SubDocKey::DebugSliceToString(key));
+      }
+      RETURN_NOT_OK(UnpackRow(value, write_time, data.result));
+      packed_row_found = true;
+      // A packed row overwrites the whole row, so older per-column entries are not visible.
+      if (low_ts < write_time) {
+        low_ts = write_time;
+      }
+      VLOG(3) << "SeekPastSubKey: " << SubDocKey::DebugSliceToString(key);
+      iter->SeekPastSubKey(key);
+      continue;
+    }
     Value doc_value;
     RETURN_NOT_OK(doc_value.Decode(value));
     ValueType value_type = doc_value.value_type();
@@ -694,6 +760,29 @@ CHECKED_STATUS BuildSubDocument(
         return Status::OK();
       }
     }
+    if (!packed_row_found) {
+      // Check the bounds before building the descendant, so children outside of them, e.g. scores
+      // of a sorted set outside of the requested range, are neither read nor decoded. A newer
+      // entry of a packed row column has to be looked at even then, to hide the packed value.
+      if (!data.low_subkey->CanInclude(key)) {
+        VLOG(3) << "Filtered by low_subkey: " << data.low_subkey->ToString()
+                << ", key: " << SubDocKey::DebugSliceToString(key);
+        SeekToLowerBound(*data.low_subkey, iter);
+        continue;
+      }
+      if (!data.high_subkey->CanInclude(key)) {
+        VLOG(3) << "Filtered by high_subkey: " << data.high_subkey->ToString()
+                << ", key: " << SubDocKey::DebugSliceToString(key);
+        return Status::OK();
+      }
+      if (data.limit != 0 && IsObjectType(data.result->value_type())) {
+        size_t num_children;
+        RETURN_NOT_OK(data.result->NumChildren(&num_children));
+        if (num_children >= data.limit) {
+          return Status::OK();
+        }
+      }
+    }
     SubDocument descendant{PrimitiveValue(ValueType::kInvalid)};
     // TODO: what if the key we found is the same as before?
     //       We'll get into an infinite recursion then.
@@ -706,6 +795,15 @@ CHECKED_STATUS BuildSubDocument(
     }
     if (descendant.value_type() == ValueType::kInvalid) {
       // The document was not found in this level (maybe a tombstone was encountered).
+      if (packed_row_found) {
+        // The entry was not filtered out by low_ts, so it is newer than the packed row and hides
+        // the packed value of this column.
+        Slice temp = key;
+        temp.remove_prefix(data.subdocument_key.size());
+        PrimitiveValue child;
+        RETURN_NOT_OK(child.DecodeFromKey(&temp));
+        data.result->DeleteChild(child);
+      }
       continue;
     }
 
@@ -756,10 +854,10 @@ CHECKED_STATUS BuildSubDocument(
         PrimitiveValue child;
         RETURN_NOT_OK(child.DecodeFromKey(&temp));
         if (temp.empty()) {
-          current->SetChild(child, std::move(descendant));
+          current->SetChild(std::move(child), std::move(descendant));
           break;
         }
-        current = current->GetOrAddChild(child).first;
+        current = current->GetOrAddChild(std::move(child)).first;
       }
     }
   }
@@ -774,7 +872,8 @@ yb::Status FindLastWriteTime(
     const Slice& key_without_ht,
     DocHybridTime* max_overwrite_time,
     Expiration* exp,
-    Value* result_value) {
+    Value* result_value,
+    std::string* packed_row) {
 
   Slice value;
   DocHybridTime doc_ht = *max_overwrite_time;
@@ -838,12 +937,55 @@ yb::Status FindLastWriteTime(
             << *max_overwrite_time;
   }
 
+  if (value_type == ValueType::kPackedRow) {
+    if (packed_row) {
+      packed_row->assign(value.cdata(), value.size());
+    }
+    if (result_value) {
+      *result_value = Value(PrimitiveValue(ValueType::kPackedRow));
+    }
+    return Status::OK();
+  }
+
   if (result_value)
     RETURN_NOT_OK(result_value->Decode(value));
 
   return Status::OK();
 }
 
+namespace {
+
+// Checks the ancestors of subdocument_key and then subdocument_key itself for init markers,
+// tombstones, and expiration, tracking the expiration and corresponding most recent write time in
+// exp, and the general most recent overwrite time in max_overwrite_ht. The iterator is expected to
+// be positioned on or before the doc key, which is the first dockey_size bytes of subdocument_key.
+CHECKED_STATUS FindSubDocumentOverwrite(
+    IntentAwareIterator* iter,
+    const Slice& subdocument_key,
+    size_t dockey_size,
+    DocHybridTime* max_overwrite_ht,
+    Expiration* exp,
+    Value* doc_value,
+    std::string* packed_row) {
+  Slice key_slice(subdocument_key.data(), dockey_size);
+  auto temp_key = subdocument_key;
+  temp_key.remove_prefix(dockey_size);
+  for (;;) {
+    auto decode_result = VERIFY_RESULT(SubDocKey::DecodeSubkey(&temp_key));
+    if (!decode_result) {
+      break;
+    }
+    RETURN_NOT_OK(FindLastWriteTime(iter, key_slice, max_overwrite_ht, exp));
+    key_slice = Slice(key_slice.data(), temp_key.data() - key_slice.data());
+  }
+
+  // By this point key_slice is the encoded representation of the DocKey and all the subkeys of
+  // subdocument_key. Check for init-marker / tombstones at the top level, update max_overwrite_ht.
+  return FindLastWriteTime(iter, key_slice, max_overwrite_ht, exp, doc_value, packed_row);
+}
+
+} // namespace
+
 yb::Status GetSubDocument(
     const DocDB& doc_db,
     const GetSubDocumentData& data,
@@ -851,9 +993,35 @@ yb::Status GetSubDocument(
     const TransactionOperationContextOpt& txn_op_context,
     CoarseTimePoint deadline,
     const ReadHybridTime& read_time) {
+  auto file_tracker = FLAGS_use_docdb_overwrite_file_filter
+      ? std::make_shared<FileMaxHybridTimeTracker>() : nullptr;
   auto iter = CreateIntentAwareIterator(
       doc_db, BloomFilterMode::USE_BLOOM_FILTER, data.subdocument_key, query_id,
-      txn_op_context, deadline, read_time);
+      txn_op_context, deadline, read_time, file_tracker);
+  if (file_tracker) {
+    // All the entries of the subdocument that were written before it or one of its ancestors was
+    // last overwritten, e.g. by deleting it, are hidden. So the SST files that only hold older
+    // entries are not read, instead of skipping each of their entries of a large deleted container.
+    auto dockey_size =
+        VERIFY_RESULT(DocKey::EncodedSize(data.subdocument_key, DocKeyPart::WHOLE_DOC_KEY));
+    DocHybridTime max_overwrite_ht(DocHybridTime::kMin);
+    {
+      Expiration exp = data.exp;
+      Value doc_value(PrimitiveValue(ValueType::kInvalid));
+      IntentAwareIteratorPrefixScope prefix_scope(
+          Slice(data.subdocument_key.data(), dockey_size), iter.get());
+      iter->Seek(Slice(data.subdocument_key.data(), dockey_size));
+      RETURN_NOT_OK(FindSubDocumentOverwrite(
+          iter.get(), data.subdocument_key, dockey_size, &max_overwrite_ht, &exp, &doc_value,
+          nullptr /* packed_row */));
+    }
+    if (file_tracker->HasFilesOlderThan(max_overwrite_ht.hybrid_time())) {
+      iter = CreateIntentAwareIterator(
+          doc_db, BloomFilterMode::USE_BLOOM_FILTER, data.subdocument_key, query_id,
+          txn_op_context, deadline, read_time,
+          CreateMinHybridTimeFileFilter(max_overwrite_ht.hybrid_time()));
+    }
+  }
   return GetSubDocument(iter.get(), data, nullptr /* projection */, SeekFwdSuffices::kFalse);
 }
 
@@ -890,27 +1058,12 @@ yb::Status GetSubDocument(
   } else {
     db_iter->Seek(key_slice);
   }
-  Value doc_value;
-  // Check ancestors for init markers, tombstones, and expiration, tracking
-  // the expiration and corresponding most recent write time in exp, and the
-  // the general most recent overwrite time in max_overwrite_ht
-  {
-    auto temp_key = data.subdocument_key;
-    temp_key.remove_prefix(dockey_size);
-    for (;;) {
-      auto decode_result = VERIFY_RESULT(SubDocKey::DecodeSubkey(&temp_key));
-      if (!decode_result) {
-        break;
-      }
-      RETURN_NOT_OK(FindLastWriteTime(db_iter, key_slice, &max_overwrite_ht, &data.exp));
-      key_slice = Slice(key_slice.data(), temp_key.data() - key_slice.data());
-    }
-  }
-
-  // By this point key_bytes is the encoded representation of the DocKey and all the subkeys of
-  // subdocument_key. Check for init-marker / tombstones at the top level, update max_overwrite_ht.
-  doc_value = Value(PrimitiveValue(ValueType::kInvalid));
-  RETURN_NOT_OK(FindLastWriteTime(db_iter, key_slice, &max_overwrite_ht, &data.exp, &doc_value));
+  Value doc_value(PrimitiveValue(ValueType::kInvalid));
+  std::string packed_row;
+  RETURN_NOT_OK(FindSubDocumentOverwrite(
+      db_iter, data.subdocument_key, dockey_size, &max_overwrite_ht, &data.exp, &doc_value,
+      &packed_row));
+  key_slice = data.subdocument_key;
 
   const ValueType value_type = doc_value.value_type();
 
@@ -954,6 +1107,11 @@ yb::Status GetSubDocument(
   // Seed key_bytes with the subdocument key. For each subkey in the projection, build subdocument
   // and reuse key_bytes while appending the subkey.
   *data.result = SubDocument();
+  SubDocument packed_columns;
+  if (value_type == ValueType::kPackedRow) {
+    // max_overwrite_ht is the packed row write time at this point.
+    RETURN_NOT_OK(UnpackRow(packed_row, max_overwrite_ht, &packed_columns, projection));
+  }
   KeyBytes key_bytes(data.subdocument_key);
   const size_t subdocument_key_size = key_bytes.size();
   for (const PrimitiveValue& subkey : *projection) {
@@ -966,10 +1124,26 @@ yb::Status GetSubDocument(
     IntentAwareIteratorPrefixScope prefix_scope(key_bytes, db_iter);
     db_iter->SeekForward(&key_bytes);
     SubDocument descendant(ValueType::kInvalid);
-    int64 num_values_observed = 0;
-    RETURN_NOT_OK(BuildSubDocument(
-        db_iter, data.Adjusted(key_bytes, &descendant), max_overwrite_ht,
-        &num_values_observed));
+    const SubDocument* packed_column = nullptr;
+    if (value_type == ValueType::kPackedRow) {
+      packed_column = packed_columns.GetChild(subkey);
+    }
+    bool overwritten_after_packing = packed_column == nullptr;
+    if (packed_column != nullptr && db_iter->valid()) {
+      // The prefix scope limits the iterator to entries of this column, so a valid iterator here
+      // means that there is a per-column entry. Only entries newer than the packed row matter.
+      DocHybridTime column_write_time;
+      RETURN_NOT_OK(db_iter->FetchKey(&column_write_time));
+      overwritten_after_packing = column_write_time > max_overwrite_ht;
+    }
+    if (overwritten_after_packing) {
+      int64 num_values_observed = 0;
+      RETURN_NOT_OK(BuildSubDocument(
+          db_iter, data.Adjusted(key_bytes, &descendant), max_overwrite_ht,
+          &num_values_observed));
+    } else {
+      descendant = *packed_column;
+    }
     *data.doc_found = descendant.value_type() != ValueType::kInvalid;
     data.result->SetChild(subkey, std::move(descendant));
 
@@ -1092,6 +1266,10 @@ Result<std::string> DocDBValueToDebugStr(Slice value_slice, const KeyType& key_t
     }
   }
 
+  if (IsPackedRow(value_slice)) {
+    return prefix + PackedRowToString(value_slice);
+  }
+
   // Empty values are allowed for weak intents.
   if (!value_slice.empty() || key_type != KeyType::kIntentKey) {
     Value v;
@@ -121,7 +121,7 @@ Result<PrepareDocWriteOperationResult> PrepareDocWriteOperation(
 //
 // Input: doc_write_ops, read snapshot hybrid_time if requested in PrepareDocWriteOperation().
 // Context: rocksdb
-// Outputs: keys_locked, write_batch
+// Outputs: keys_locked, write_batch, number of RocksDB seeks performed if num_rocksdb_seeks is set
 // TODO: rename this to something other than "apply" to avoid confusing it with the "apply"
 // operation that happens after Raft replication.
 CHECKED_STATUS ExecuteDocWriteOperation(
@@ -132,7 +132,8 @@ CHECKED_STATUS ExecuteDocWriteOperation(
     KeyValueWriteBatchPB* write_batch,
     InitMarkerBehavior init_marker_behavior,
     std::atomic<int64_t>* monotonic_counter,
-    HybridTime* restart_read_ht);
+    HybridTime* restart_read_ht,
+    int* num_rocksdb_seeks = nullptr);
 
 void PrepareNonTransactionWriteBatch(
     const docdb::KeyValueWriteBatchPB& put_batch,
@@ -413,7 +414,8 @@ yb::Status FindLastWriteTime(
     const Slice& key_without_ht,
     DocHybridTime* max_overwrite_time,
     Expiration* exp,
-    Value* result_value = nullptr);
+    Value* result_value = nullptr,
+    std::string* packed_row = nullptr);
 
 // Indicates if we can get away by only seeking forward, or if we must do a regular seek.
 YB_STRONGLY_TYPED_BOOL(SeekFwdSuffices);
@@ -428,7 +430,8 @@ YB_STRONGLY_TYPED_BOOL(SeekFwdSuffices);
 // If tombstone and other values are inserted at the same timestamp, it results in undefined
 // behavior.
 // The projection, if set, restricts the scan to a subset of keys in the first level.
-// The projection is used for QL selects to get only a subset of columns.
+// The projection is used for QL selects to get only a subset of columns. It should be sorted, so
+// that the values of other columns in a packed row are skipped without being decoded.
 // If low and high subkey are specified, only first level keys in the subdocument within that
 // range(inclusive) are returned and the iterator is positioned after high_subkey and not
 // necessarily outside the SubDocument.
@@ -13,11 +13,14 @@
 
 #include "yb/docdb/docdb_compaction_filter.h"
 
+#include <algorithm>
 #include <memory>
 
 #include <glog/logging.h>
 
 #include "yb/rocksdb/compaction_filter.h"
+#include "yb/rocksdb/table_properties.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/string_util.h"
 
 #include "yb/docdb/doc_key.h"
@@ -32,9 +35,31 @@ using std::unordered_set;
 using rocksdb::CompactionFilter;
 using rocksdb::VectorToString;
 
+DEFINE_bool(tablet_enable_ttl_file_filter, true,
+            "Whether compactions delete the SST files whose values all expired by TTL before the "
+            "history cutoff without reading them, for tables with a default TTL.");
+TAG_FLAG(tablet_enable_ttl_file_filter, runtime);
+
+DEFINE_int32(tablet_obsolete_versions_compaction_trigger_percent, 0,
+             "Percentage of the entries of a newly written SST file of the regular RocksDB that "
+             "are versions no longer visible at the history cutoff, above which the file is "
+             "marked for compaction, so that reads of frequently updated keys stop skipping those "
+             "versions. 0 to disable.");
+TAG_FLAG(tablet_obsolete_versions_compaction_trigger_percent, runtime);
+TAG_FLAG(tablet_obsolete_versions_compaction_trigger_percent, advanced);
+
+DEFINE_uint64(tablet_obsolete_versions_compaction_min_entries, 10000,
+              "Minimal number of entries of an SST file for it to be marked for compaction by "
+              "tablet_obsolete_versions_compaction_trigger_percent.");
+TAG_FLAG(tablet_obsolete_versions_compaction_min_entries, runtime);
+TAG_FLAG(tablet_obsolete_versions_compaction_min_entries, advanced);
+
 namespace yb {
 namespace docdb {
 
+Status GetDocHybridTime(const rocksdb::UserBoundaryValues& values, DocHybridTime* out);
+Status GetMaxValueTtl(const rocksdb::UserBoundaryValues& values, MonoDelta* out);
+
 // ------------------------------------------------------------------------------------------------
 
 DocDBCompactionFilter::DocDBCompactionFilter(
@@ -313,6 +338,181 @@ const char* DocDBCompactionFilterFactory::Name() const {
 
 // ------------------------------------------------------------------------------------------------
 
+namespace {
+
+// Returns the hybrid time of the newest value of a file if all its values expired before the
+// history cutoff, or an invalid hybrid time otherwise.
+HybridTime ExpiredFileMaxHybridTime(
+    const rocksdb::SstFileBoundaries& file, const HistoryRetentionDirective& retention) {
+  DocHybridTime max_ht;
+  MonoDelta max_value_ttl;
+  if (!GetDocHybridTime(file.largest->user_values, &max_ht).ok() ||
+      !GetMaxValueTtl(file.largest->user_values, &max_value_ttl).ok()) {
+    // Files written before value TTLs were recorded are never deleted this way.
+    return HybridTime::kInvalid;
+  }
+  // Some values of the file could use the default TTL of the table, which could be longer than
+  // the TTLs of the other ones.
+  const MonoDelta ttl = std::max(ComputeTTL(max_value_ttl, retention.table_ttl),
+                                 retention.table_ttl);
+  bool has_expired = false;
+  if (!HasExpiredTTL(max_ht.hybrid_time(), ttl, retention.history_cutoff, &has_expired).ok() ||
+      !has_expired) {
+    return HybridTime::kInvalid;
+  }
+  return max_ht.hybrid_time();
+}
+
+HybridTime FileMinHybridTime(const rocksdb::SstFileBoundaries& file) {
+  DocHybridTime min_ht;
+  if (!GetDocHybridTime(file.smallest->user_values, &min_ht).ok()) {
+    return HybridTime::kMin;
+  }
+  return min_ht.hybrid_time();
+}
+
+size_t SelectTtlExpiredFiles(
+    HistoryRetentionPolicy* retention_policy,
+    const std::vector<rocksdb::SstFileBoundaries>& files) {
+  if (!FLAGS_tablet_enable_ttl_file_filter || files.empty()) {
+    return 0;
+  }
+  const auto retention = retention_policy->GetRetentionDirective();
+  if (retention.table_ttl.Equals(Value::kMaxTtl)) {
+    return 0;
+  }
+
+  // The expired values could overwrite older versions of their rows that are kept in newer files,
+  // e.g. values of transactions that were applied later, and those must not be uncovered. So the
+  // deleted files must be older than all the kept ones.
+  std::vector<HybridTime> newer_files_min_ht(files.size() + 1, HybridTime::kMax);
+  for (size_t i = files.size(); i-- > 0;) {
+    newer_files_min_ht[i] = std::min(newer_files_min_ht[i + 1], FileMinHybridTime(files[i]));
+  }
+
+  size_t result = 0;
+  HybridTime expired_max_ht = HybridTime::kMin;
+  for (size_t i = 0; i != files.size(); ++i) {
+    const HybridTime file_max_ht = ExpiredFileMaxHybridTime(files[i], retention);
+    if (!file_max_ht.is_valid()) {
+      break;
+    }
+    expired_max_ht = std::max(expired_max_ht, file_max_ht);
+    if (expired_max_ht < newer_files_min_ht[i + 1]) {
+      result = i + 1;
+    }
+  }
+  return result;
+}
+
+} // namespace
+
+rocksdb::ExpiredFilesSelector CreateTtlExpiredFilesSelector(
+    std::shared_ptr<HistoryRetentionPolicy> retention_policy) {
+  return [retention_policy](const std::vector<rocksdb::SstFileBoundaries>& files) {
+    return SelectTtlExpiredFiles(retention_policy.get(), files);
+  };
+}
+
+// ------------------------------------------------------------------------------------------------
+
+const char* const kObsoleteVersionsPropertyName = "yb.docdb.obsolete_versions";
+
+namespace {
+
+// Counts the entries of an SST file that are overwritten by a newer version of the same key at or
+// before the history cutoff, i.e. the ones that a compaction would garbage-collect.
+class ObsoleteVersionsCollector : public rocksdb::TablePropertiesCollector {
+ public:
+  ObsoleteVersionsCollector(HybridTime history_cutoff, uint64_t trigger_percent,
+                            uint64_t min_entries)
+      : history_cutoff_(history_cutoff), trigger_percent_(trigger_percent),
+        min_entries_(min_entries) {}
+
+  rocksdb::Status AddUserKey(const rocksdb::Slice& key, const rocksdb::Slice& value,
+                             rocksdb::EntryType type, rocksdb::SequenceNumber seq,
+                             uint64_t file_size) override {
+    ++num_entries_;
+    Slice key_without_ht = key;
+    auto doc_ht = DocHybridTime::DecodeFromEnd(&key_without_ht);
+    if (!doc_ht.ok()) {
+      prev_key_without_ht_.clear();
+      return rocksdb::Status::OK();
+    }
+    const bool visible_at_cutoff_ht = doc_ht->hybrid_time() <= history_cutoff_;
+    // Versions of the same key are ordered from the newest to the oldest.
+    if (visible_at_cutoff_ht && prev_visible_at_cutoff_ht_ &&
+        key_without_ht == Slice(prev_key_without_ht_)) {
+      ++num_obsolete_versions_;
+      return rocksdb::Status::OK();
+    }
+    prev_key_without_ht_.assign(key_without_ht.cdata(), key_without_ht.size());
+    prev_visible_at_cutoff_ht_ = visible_at_cutoff_ht;
+    return rocksdb::Status::OK();
+  }
+
+  rocksdb::Status Finish(rocksdb::UserCollectedProperties* properties) override {
+    *properties = GetReadableProperties();
+    return rocksdb::Status::OK();
+  }
+
+  rocksdb::UserCollectedProperties GetReadableProperties() const override {
+    return {{kObsoleteVersionsPropertyName, std::to_string(num_obsolete_versions_)}};
+  }
+
+  const char* Name() const override {
+    return "ObsoleteVersionsCollector";
+  }
+
+  bool NeedCompact() const override {
+    return trigger_percent_ != 0 && num_entries_ >= min_entries_ &&
+           num_obsolete_versions_ * 100 > num_entries_ * trigger_percent_;
+  }
+
+ private:
+  const HybridTime history_cutoff_;
+  const uint64_t trigger_percent_;
+  const uint64_t min_entries_;
+  uint64_t num_entries_ = 0;
+  uint64_t num_obsolete_versions_ = 0;
+  std::string prev_key_without_ht_;
+  bool prev_visible_at_cutoff_ht_ = false;
+};
+
+class ObsoleteVersionsCollectorFactory : public rocksdb::TablePropertiesCollectorFactory {
+ public:
+  explicit ObsoleteVersionsCollectorFactory(
+      std::shared_ptr<HistoryRetentionPolicy> retention_policy)
+      : retention_policy_(std::move(retention_policy)) {}
+
+  rocksdb::TablePropertiesCollector* CreateTablePropertiesCollector(
+      rocksdb::TablePropertiesCollectorFactory::Context context) override {
+    const auto trigger_percent = FLAGS_tablet_obsolete_versions_compaction_trigger_percent;
+    // Counting is skipped when disabled, as getting the cutoff is not free.
+    const HybridTime history_cutoff = trigger_percent > 0
+        ? retention_policy_->GetRetentionDirective().history_cutoff : HybridTime::kMin;
+    return new ObsoleteVersionsCollector(
+        history_cutoff, std::max(trigger_percent, 0),
+        FLAGS_tablet_obsolete_versions_compaction_min_entries);
+  }
+
+  const char* Name() const override {
+    return "ObsoleteVersionsCollectorFactory";
+  }
+
+ private:
+  std::shared_ptr<HistoryRetentionPolicy> retention_policy_;
+};
+
+} // namespace
+
+std::shared_ptr<rocksdb::TablePropertiesCollectorFactory> CreateObsoleteVersionsCollectorFactory(
+    std::shared_ptr<HistoryRetentionPolicy> retention_policy) {
+  return std::make_shared<ObsoleteVersionsCollectorFactory>(std::move(retention_policy));
+}
+
+// ------------------------------------------------------------------------------------------------
+
 HistoryRetentionDirective ManualHistoryRetentionPolicy::GetRetentionDirective() {
   std::lock_guard<std::mutex> lock(deleted_cols_mtx_);
   return {
@@ -23,6 +23,7 @@
 
 #include "yb/rocksdb/compaction_filter.h"
 #include "yb/rocksdb/metadata.h"
+#include "yb/rocksdb/options.h"
 
 #include "yb/common/schema.h"
 #include "yb/common/hybrid_time.h"
@@ -146,6 +147,22 @@ class DocDBCompactionFilterFactory : public rocksdb::CompactionFilterFactory {
   std::shared_ptr<HistoryRetentionPolicy> retention_policy_;
 };
 
+// Returns a selector of the oldest SST files of the regular RocksDB whose values all expired by TTL
+// before the history cutoff of 'retention_policy', so that compactions delete them without reading
+// them. Only tables with a default TTL are handled.
+rocksdb::ExpiredFilesSelector CreateTtlExpiredFilesSelector(
+    std::shared_ptr<HistoryRetentionPolicy> retention_policy);
+
+// Name of the SST file property with the number of versions that are overwritten at the history
+// cutoff of the time the file was written.
+extern const char* const kObsoleteVersionsPropertyName;
+
+// Returns a factory of collectors of kObsoleteVersionsPropertyName for the regular RocksDB. Files
+// with many obsolete versions, see tablet_obsolete_versions_compaction_trigger_percent, are marked
+// for compaction.
+std::shared_ptr<rocksdb::TablePropertiesCollectorFactory> CreateObsoleteVersionsCollectorFactory(
+    std::shared_ptr<HistoryRetentionPolicy> retention_policy);
+
 // A history retention policy that can be configured manually. Useful in tests. This class is
 // useful for testing and is thread-safe.
 class ManualHistoryRetentionPolicy : public HistoryRetentionPolicy {
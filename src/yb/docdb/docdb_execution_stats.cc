@@ -0,0 +1,78 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+
+#include "yb/docdb/docdb_execution_stats.h"
+
+#include "yb/common/ql_protocol.pb.h"
+#include "yb/rocksdb/perf_context.h"
+
+namespace yb {
+namespace docdb {
+
+namespace {
+
+thread_local DocDBExecutionStats* current_stats = nullptr;
+
+} // namespace
+
+void DocDBExecutionStats::ToPB(DocDBExecutionStatsPB* pb) const {
+  pb->set_seeks(seeks);
+  pb->set_nexts(nexts);
+  pb->set_block_cache_hits(block_cache_hits);
+  pb->set_blocks_read(blocks_read);
+  pb->set_intents(intents);
+  pb->set_rows_scanned(rows_scanned);
+  pb->set_rows_returned(rows_returned);
+  pb->set_conflict_resolution_time_us(conflict_resolution_time.ToMicroseconds());
+}
+
+ScopedDocDBExecutionStats::ScopedDocDBExecutionStats(DocDBExecutionStats* stats)
+    : stats_(stats), old_stats_(current_stats) {
+  if (!stats_) {
+    return;
+  }
+  const auto& perf_context = rocksdb::perf_context;
+  start_seeks_ = perf_context.iter_seek_count;
+  start_nexts_ = perf_context.iter_next_count + perf_context.iter_prev_count;
+  start_block_cache_hits_ = perf_context.block_cache_hit_count;
+  start_blocks_read_ = perf_context.block_read_count;
+  current_stats = stats_;
+}
+
+ScopedDocDBExecutionStats::~ScopedDocDBExecutionStats() {
+  if (!stats_) {
+    return;
+  }
+  const auto& perf_context = rocksdb::perf_context;
+  stats_->seeks += perf_context.iter_seek_count - start_seeks_;
+  stats_->nexts += perf_context.iter_next_count + perf_context.iter_prev_count - start_nexts_;
+  stats_->block_cache_hits += perf_context.block_cache_hit_count - start_block_cache_hits_;
+  stats_->blocks_read += perf_context.block_read_count - start_blocks_read_;
+  current_stats = old_stats_;
+}
+
+void RecordIntentEncountered() {
+  if (current_stats) {
+    ++current_stats->intents;
+  }
+}
+
+void RecordRowScanned() {
+  if (current_stats) {
+    ++current_stats->rows_scanned;
+  }
+}
+
+} // namespace docdb
+} // namespace yb
@@ -0,0 +1,74 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+
+#ifndef YB_DOCDB_DOCDB_EXECUTION_STATS_H
+#define YB_DOCDB_DOCDB_EXECUTION_STATS_H
+
+#include <stdint.h>
+
+#include "yb/gutil/macros.h"
+#include "yb/util/monotime.h"
+
+namespace yb {
+
+class DocDBExecutionStatsPB;
+
+namespace docdb {
+
+// Statistics of the execution of a request by DocDB, returned to the client in
+// DocDBExecutionStatsPB when the request asks for them.
+struct DocDBExecutionStats {
+  uint64_t seeks = 0;
+  // Nexts and prevs.
+  uint64_t nexts = 0;
+  uint64_t block_cache_hits = 0;
+  uint64_t blocks_read = 0;
+  uint64_t intents = 0;
+  uint64_t rows_scanned = 0;
+  uint64_t rows_returned = 0;
+  MonoDelta conflict_resolution_time = MonoDelta::kZero;
+
+  void ToPB(DocDBExecutionStatsPB* pb) const;
+};
+
+// Gathers the statistics of the DocDB work done by the current thread into 'stats' for the
+// duration of the scope. 'stats' may be null, then nothing is gathered.
+//
+// Iterator and block counters come from the RocksDB perf context of the thread, so they are not
+// gathered when the perf level of the thread is kDisable. Scopes should not be nested.
+class ScopedDocDBExecutionStats {
+ public:
+  explicit ScopedDocDBExecutionStats(DocDBExecutionStats* stats);
+  ~ScopedDocDBExecutionStats();
+
+ private:
+  DocDBExecutionStats* const stats_;
+  DocDBExecutionStats* const old_stats_;
+  uint64_t start_seeks_ = 0;
+  uint64_t start_nexts_ = 0;
+  uint64_t start_block_cache_hits_ = 0;
+  uint64_t start_blocks_read_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(ScopedDocDBExecutionStats);
+};
+
+// Counts an intent encountered or a row read from DocDB by the current thread, when its statistics
+// are gathered.
+void RecordIntentEncountered();
+void RecordRowScanned();
+
+} // namespace docdb
+} // namespace yb
+
+#endif // YB_DOCDB_DOCDB_EXECUTION_STATS_H
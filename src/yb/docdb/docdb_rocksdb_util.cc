@@ -13,18 +13,28 @@
 
 #include "yb/docdb/docdb_rocksdb_util.h"
 
+#include <algorithm>
+#include <limits>
 #include <thread>
 #include <memory>
+#include <unordered_map>
 
 #include "yb/common/transaction.h"
 
+#include "yb/gutil/casts.h"
+
+#include "yb/rocksdb/db/compaction.h"
+#include "yb/rocksdb/memtablerep.h"
 #include "yb/rocksdb/rate_limiter.h"
 #include "yb/rocksdb/table.h"
 
+#include "yb/docdb/adaptive_seek_tuner.h"
+#include "yb/docdb/consensus_frontier.h"
 #include "yb/docdb/intent_aware_iterator.h"
 #include "yb/rocksutil/yb_rocksdb.h"
 #include "yb/rocksutil/yb_rocksdb_logger.h"
 #include "yb/server/hybrid_clock.h"
+#include "yb/util/path_util.h"
 #include "yb/util/size_literals.h"
 #include "yb/util/trace.h"
 #include "yb/gutil/sysinfo.h"
@@ -50,12 +60,59 @@ DEFINE_int32(rocksdb_universal_compaction_size_ratio, 20,
              "The percentage upto which files that are larger are include in a compaction.");
 DEFINE_int32(rocksdb_universal_compaction_min_merge_width, 4,
              "The minimum number of files in a single compaction run.");
+DEFINE_int32(rocksdb_read_amp_compaction_trigger, 0,
+             "Compact the sorted runs of a tablet by their number alone, without regard to their "
+             "sizes, when its reads consult at least this many SST files on average. 0 - disabled.");
+DEFINE_uint64(rocksdb_read_amp_compaction_min_reads, 1000,
+              "Minimal number of reads since the previous compaction pick for the read "
+              "amplification of a tablet to be taken into account.");
 DEFINE_int64(rocksdb_compact_flush_rate_limit_bytes_per_sec, 100 * 1024 * 1024,
-             "Use to control write rate of flush and compaction.");
+             "Use to control write rate of flush and compaction. On a tablet server the limit is "
+             "shared by all tablets, and it is the initial rate when "
+             "rocksdb_compaction_rate_auto_tune is set.");
 DEFINE_uint64(rocksdb_compaction_size_threshold_bytes, 2ULL * 1024 * 1024 * 1024,
              "Threshold beyond which compaction is considered large.");
 DEFINE_uint64(rocksdb_max_file_size_for_compaction, 0,
              "Maximal allowed file size to participate in RocksDB compaction. 0 - unlimited.");
+DEFINE_bool(rocksdb_allow_concurrent_memtable_write, true,
+            "Whether the writers of a RocksDB write group insert their batches into the memtable "
+            "in parallel instead of the group leader inserting all of them.");
+DEFINE_int64(rocksdb_compaction_readahead_size_bytes, 2_MB,
+             "Size of the reads of SST files that are compaction inputs. 0 to read them block by "
+             "block.");
+DEFINE_uint64(rocksdb_large_compaction_threshold_bytes, 0,
+              "Files written by compactions whose input is at least this large are compressed with "
+              "rocksdb_large_compaction_compression_type instead of the default compression. "
+              "0 - disabled.");
+DEFINE_string(rocksdb_large_compaction_compression_type, "zlib",
+              "Compression type of the files written by large compactions: none, snappy, zlib, "
+              "lz4 or zstd.");
+DEFINE_int32(rocksdb_large_compaction_compression_level, -1,
+             "Compression level of the files written by large compactions. -1 - the default level "
+             "of the compression type.");
+DEFINE_int32(rocksdb_large_compaction_max_dict_bytes, 16_KB,
+             "Maximal size of the compression dictionary of the files written by large "
+             "compactions. 0 - do not use a dictionary.");
+DEFINE_int32(rocksdb_large_compaction_dict_train_bytes, 1_MB,
+             "Amount of data blocks the compression dictionary of the files written by large "
+             "compactions is built from.");
+DEFINE_int32(rocksdb_max_subcompactions, 1,
+             "Maximal number of threads a compaction is split into by key ranges. 1 - do not split "
+             "compactions.");
+DEFINE_uint64(rocksdb_min_subcompaction_size_bytes, 1_GB,
+              "Minimal amount of compaction input processed by one subcompaction.");
+DEFINE_bool(rocksdb_use_direct_io_for_flush_and_compaction, false,
+            "Write the SST files of flushes and compactions and read compaction inputs with "
+            "O_DIRECT, so that background I/O does not evict the data of foreground reads from the "
+            "OS page cache.");
+DEFINE_string(rocksdb_cold_data_dir, "",
+              "Directory on a secondary, usually larger and cheaper, device for SST files that "
+              "only contain old data. Every tablet gets its own subdirectory. Should not be unset "
+              "while tablets have files there.");
+DEFINE_int64(rocksdb_cold_data_age_sec, 0,
+             "Compactions whose input files only contain data written, by the hybrid time of "
+             "committed Raft log entries, at least this many seconds ago write their output to "
+             "rocksdb_cold_data_dir. 0 disables placing files there.");
 
 DEFINE_int64(db_block_size_bytes, 32_KB,
              "Size of RocksDB data block (in bytes).");
@@ -78,6 +135,38 @@ DEFINE_int32(max_nexts_to_avoid_seek, 1,
              "The number of next calls to try before doing resorting to do a rocksdb seek.");
 DEFINE_bool(trace_docdb_calls, false, "Whether we should trace calls into the docdb.");
 DEFINE_bool(use_multi_level_index, true, "Whether to use multi-level data index.");
+DEFINE_bool(pin_top_level_data_index, true,
+            "Whether to keep the top level of the multi-level data index of each SST file in memory "
+            "instead of the block cache.");
+DEFINE_bool(index_and_filter_blocks_in_multi_touch_cache, false,
+            "Whether to put data index and bloom filter blocks into the multi-touch part of the "
+            "block cache on first access, protecting them from eviction by scanned data blocks.");
+DEFINE_int32(rocksdb_scan_prefetch_data_blocks, 8,
+             "Number of upcoming data blocks that a forward scan reads from an SST file with a "
+             "single batched read, when they are not in the block cache. 0 disables prefetching.");
+DEFINE_int64(rocksdb_max_auto_readahead_size_bytes, 256_KB,
+             "Maximum readahead of a scan that reads data blocks of an SST file sequentially. The "
+             "readahead starts small and doubles while the scan stays sequential. 0 disables "
+             "readahead.");
+DEFINE_int32(rocksdb_num_sequential_reads_for_auto_readahead, 2,
+             "Number of sequential data block reads after which a scan starts reading ahead.");
+DEFINE_bool(use_docdb_aware_block_restarts, true,
+            "Whether to place restart points of data blocks at DocKey boundaries, so that the "
+            "keys of a row share its DocKey through delta encoding.");
+DEFINE_int32(db_block_max_restart_interval, 64,
+             "Maximum number of keys between restart points of a data block when restarts are "
+             "placed at DocKey boundaries.");
+DEFINE_bool(use_docdb_data_block_hash_index, false,
+            "Whether to append to data blocks a hash index that maps each DocKey to the restart "
+            "interval of its first key, so point reads do not binary search the block. Only used "
+            "when restarts are placed at DocKey boundaries. Older versions cannot read the SST "
+            "files written with this option.");
+DEFINE_bool(use_docdb_hybrid_time_file_filter, true,
+            "Whether reads skip the SST files of the regular RocksDB whose records were all "
+            "written after the read time, according to the hybrid time boundaries of the files.");
+DEFINE_int32(docdb_hash_prefix_memtable_bucket_bits, 10,
+             "Number of high bits of the 16-bit hash of DocKeys that select the memtable bucket of "
+             "the keys of tables with the hash_prefix memtable format.");
 
 DEFINE_uint64(initial_seqno, 1ULL << 50, "Initial seqno for new RocksDB instances.");
 
@@ -90,6 +179,7 @@ namespace yb {
 namespace docdb {
 
 std::shared_ptr<rocksdb::BoundaryValuesExtractor> DocBoundaryValuesExtractorInstance();
+rocksdb::UserBoundaryTag TagForDocHybridTime();
 
 Status SeekToValidKvAtTs(
     rocksdb::Iterator *iter,
@@ -179,15 +269,15 @@ Status SeekToValidKvAtTs(
   return Status::OK();
 }
 
-void SeekForward(const rocksdb::Slice& slice, rocksdb::Iterator *iter) {
+void SeekForward(const rocksdb::Slice& slice, rocksdb::Iterator *iter, AdaptiveSeekTuner* tuner) {
   if (!iter->Valid() || iter->key().compare(slice) >= 0) {
     return;
   }
-  ROCKSDB_SEEK(iter, slice);
+  ROCKSDB_TUNED_SEEK(iter, slice, tuner);
 }
 
-void SeekForward(const KeyBytes& key_bytes, rocksdb::Iterator *iter) {
-  SeekForward(key_bytes.AsSlice(), iter);
+void SeekForward(const KeyBytes& key_bytes, rocksdb::Iterator *iter, AdaptiveSeekTuner* tuner) {
+  SeekForward(key_bytes.AsSlice(), iter, tuner);
 }
 
 void SeekPastSubKey(const SubDocKey& sub_doc_key, rocksdb::Iterator* iter) {
@@ -203,8 +293,8 @@ KeyBytes AppendDocHt(const Slice& key, const DocHybridTime& doc_ht) {
   return KeyBytes(key, Slice(buf, end));
 }
 
-void SeekPastSubKey(const Slice& key, rocksdb::Iterator* iter) {
-  SeekForward(AppendDocHt(key, DocHybridTime::kMin), iter);
+void SeekPastSubKey(const Slice& key, rocksdb::Iterator* iter, AdaptiveSeekTuner* tuner) {
+  SeekForward(AppendDocHt(key, DocHybridTime::kMin), iter, tuner);
 }
 
 void SeekOutOfSubKey(const Slice& key, rocksdb::Iterator* iter) {
@@ -214,15 +304,16 @@ void SeekOutOfSubKey(const Slice& key, rocksdb::Iterator* iter) {
   SeekOutOfSubKey(&key_bytes, iter);
 }
 
-void SeekOutOfSubKey(KeyBytes* key_bytes, rocksdb::Iterator* iter) {
+void SeekOutOfSubKey(KeyBytes* key_bytes, rocksdb::Iterator* iter, AdaptiveSeekTuner* tuner) {
   key_bytes->AppendValueType(ValueType::kMaxByte);
-  SeekForward(*key_bytes, iter);
+  SeekForward(*key_bytes, iter, tuner);
   key_bytes->RemoveValueTypeSuffix(ValueType::kMaxByte);
 }
 
 void PerformRocksDBSeek(
     rocksdb::Iterator *iter,
     const rocksdb::Slice &seek_key,
+    AdaptiveSeekTuner* tuner,
     const char* file_name,
     int line) {
 #ifndef NDEBUG
@@ -267,24 +358,42 @@ void PerformRocksDBSeek(
   } else if (!iter->Valid() || iter->key().compare(seek_key) > 0) {
     iter->Seek(seek_key);
   } else {
-    for (int nexts = 0; nexts <= FLAGS_max_nexts_to_avoid_seek; nexts++) {
+    bool probe = false;
+    const int max_nexts = tuner ? tuner->NextsToTry(&probe) : FLAGS_max_nexts_to_avoid_seek;
+    const MonoTime start = probe ? MonoTime::Now() : MonoTime();
+    MonoTime nexts_done;
+    for (;;) {
       if (!iter->Valid() || iter->key().compare(seek_key) >= 0) {
         if (FLAGS_trace_docdb_calls) {
-          TRACE("Did $0 Next(s) instead of a Seek", nexts);
+          TRACE("Did $0 Next(s) instead of a Seek", next_count);
         }
         break;
       }
-      if (nexts < FLAGS_max_nexts_to_avoid_seek) {
+      if (next_count < max_nexts) {
         iter->Next();
         ++next_count;
       } else {
         if (FLAGS_trace_docdb_calls) {
-          TRACE("Forced to do an actual Seek after $0 Next(s)", FLAGS_max_nexts_to_avoid_seek);
+          TRACE("Forced to do an actual Seek after $0 Next(s)", max_nexts);
+        }
+        if (probe) {
+          nexts_done = MonoTime::Now();
         }
         iter->Seek(seek_key);
         ++seek_count;
+        break;
       }
     }
+    if (probe) {
+      const MonoTime end = MonoTime::Now();
+      if (seek_count) {
+        tuner->RecordProbe(next_count, true, nexts_done - start, end - nexts_done);
+      } else {
+        tuner->RecordProbe(next_count, false, end - start, MonoDelta());
+      }
+    } else if (tuner) {
+      tuner->Record(seek_count != 0);
+    }
   }
   VLOG(4) << Substitute(
       "PerformRocksDBSeek at $0:$1:\n"
@@ -310,7 +419,7 @@ void PerformRocksDBReverseSeek(
     const rocksdb::Slice &seek_key,
     const char *file_name,
     int line) {
-  PerformRocksDBSeek(iter, seek_key, file_name, line);
+  PerformRocksDBSeek(iter, seek_key, nullptr /* tuner */, file_name, line);
   if (!iter->Valid()) {
     iter->SeekToLast();
   } else if (iter->key().compare(seek_key) > 0) {
@@ -320,6 +429,56 @@ void PerformRocksDBReverseSeek(
 
 namespace {
 
+// Skips SST files whose oldest record was written after the global limit of the read time, so
+// none of their records is visible to the read or could cause a read restart. Files that pass the
+// filter are then checked by 'inner' if it is set.
+class HybridTimeFileFilter : public rocksdb::ReadFileFilter {
+ public:
+  HybridTimeFileFilter(HybridTime global_limit, std::shared_ptr<rocksdb::ReadFileFilter> inner)
+      : global_limit_(global_limit), inner_(std::move(inner)) {
+  }
+
+  bool Filter(const rocksdb::FdWithBoundaries& file) const override {
+    // The smallest boundary value of the hybrid time tag is the oldest hybrid time of the file.
+    const auto* encoded_min_ht = file.smallest.user_value_with_tag(TagForDocHybridTime());
+    if (encoded_min_ht) {
+      DocHybridTime min_ht;
+      if (min_ht.FullyDecodeFrom(*encoded_min_ht).ok() &&
+          min_ht.hybrid_time() > global_limit_) {
+        return false;
+      }
+    }
+    return !inner_ || inner_->Filter(file);
+  }
+
+ private:
+  const HybridTime global_limit_;
+  const std::shared_ptr<rocksdb::ReadFileFilter> inner_;
+};
+
+// Returns the latest hybrid time of the file, or HybridTime::kMax if it is unknown.
+HybridTime FileMaxHybridTime(const rocksdb::FdWithBoundaries& file) {
+  // The largest boundary value of the hybrid time tag is the latest hybrid time of the file.
+  const auto* encoded_max_ht = file.largest.user_value_with_tag(TagForDocHybridTime());
+  DocHybridTime max_ht;
+  if (!encoded_max_ht || !max_ht.FullyDecodeFrom(*encoded_max_ht).ok()) {
+    return HybridTime::kMax;
+  }
+  return max_ht.hybrid_time();
+}
+
+class MinHybridTimeFileFilter : public rocksdb::ReadFileFilter {
+ public:
+  explicit MinHybridTimeFileFilter(HybridTime min_ht) : min_ht_(min_ht) {}
+
+  bool Filter(const rocksdb::FdWithBoundaries& file) const override {
+    return FileMaxHybridTime(file) >= min_ht_;
+  }
+
+ private:
+  const HybridTime min_ht_;
+};
+
 rocksdb::ReadOptions PrepareReadOptions(
     rocksdb::DB* rocksdb,
     BloomFilterMode bloom_filter_mode,
@@ -364,6 +523,11 @@ unique_ptr<IntentAwareIterator> CreateIntentAwareIterator(
     const ReadHybridTime& read_time,
     std::shared_ptr<rocksdb::ReadFileFilter> file_filter,
     const Slice* iterate_upper_bound) {
+  if (FLAGS_use_docdb_hybrid_time_file_filter && read_time.global_limit.is_valid() &&
+      read_time.global_limit != HybridTime::kMax) {
+    file_filter = std::make_shared<HybridTimeFileFilter>(
+        read_time.global_limit, std::move(file_filter));
+  }
   // TODO(dtxn) do we need separate options for intents db?
   rocksdb::ReadOptions read_opts = PrepareReadOptions(doc_db.regular, bloom_filter_mode,
       user_key_for_filter, query_id, std::move(file_filter), iterate_upper_bound);
@@ -371,10 +535,59 @@ unique_ptr<IntentAwareIterator> CreateIntentAwareIterator(
       doc_db, read_opts, deadline, read_time, txn_op_context);
 }
 
+bool FileMaxHybridTimeTracker::Filter(const rocksdb::FdWithBoundaries& file) const {
+  min_max_ht_ = std::min(min_max_ht_, FileMaxHybridTime(file));
+  return true;
+}
+
+std::shared_ptr<rocksdb::ReadFileFilter> CreateMinHybridTimeFileFilter(HybridTime min_ht) {
+  return std::make_shared<MinHybridTimeFileFilter>(min_ht);
+}
+
 namespace {
 
 std::mutex rocksdb_flags_mutex;
 
+bool ParseCompressionType(const std::string& name, rocksdb::CompressionType* type) {
+  static const std::unordered_map<std::string, rocksdb::CompressionType> kCompressionTypes = {
+      {"none", rocksdb::kNoCompression},
+      {"snappy", rocksdb::kSnappyCompression},
+      {"zlib", rocksdb::kZlibCompression},
+      {"lz4", rocksdb::kLZ4Compression},
+      {"zstd", rocksdb::kZSTDNotFinalCompression},
+  };
+  auto it = kCompressionTypes.find(name);
+  if (it == kCompressionTypes.end()) {
+    return false;
+  }
+  *type = it->second;
+  return true;
+}
+
+void InitLargeCompactionCompression(rocksdb::Options* options) {
+  if (FLAGS_rocksdb_large_compaction_threshold_bytes == 0) {
+    return;
+  }
+  rocksdb::CompressionType type;
+  if (!ParseCompressionType(FLAGS_rocksdb_large_compaction_compression_type, &type)) {
+    LOG(DFATAL) << "Unknown compression type for large compactions: "
+                << FLAGS_rocksdb_large_compaction_compression_type;
+    return;
+  }
+  if (!rocksdb::CompressionTypeSupported(type)) {
+    LOG(WARNING) << "Compression type for large compactions is not supported: "
+                 << FLAGS_rocksdb_large_compaction_compression_type;
+    return;
+  }
+  options->large_compaction_threshold_bytes = FLAGS_rocksdb_large_compaction_threshold_bytes;
+  options->large_compaction_compression = type;
+  auto& compression_opts = options->large_compaction_compression_opts;
+  compression_opts.level = FLAGS_rocksdb_large_compaction_compression_level;
+  compression_opts.max_dict_bytes = std::max(FLAGS_rocksdb_large_compaction_max_dict_bytes, 0);
+  compression_opts.dict_train_bytes =
+      std::max(FLAGS_rocksdb_large_compaction_dict_train_bytes, 0);
+}
+
 // Auto initialize some of the RocksDB flags that are defaulted to -1.
 void AutoInitRocksDBFlags(rocksdb::Options* options) {
   const int kNumCpus = base::NumCPUs();
@@ -432,6 +645,7 @@ void InitRocksDBOptions(
   options->info_log_level = YBRocksDBLogger::ConvertToRocksDBLogLevel(FLAGS_minloglevel);
   options->initial_seqno = FLAGS_initial_seqno;
   options->boundary_extractor = DocBoundaryValuesExtractorInstance();
+  options->allow_concurrent_memtable_write = FLAGS_rocksdb_allow_concurrent_memtable_write;
   options->memory_monitor = tablet_options.memory_monitor;
   if (FLAGS_db_write_buffer_size != -1) {
     options->write_buffer_size = FLAGS_db_write_buffer_size;
@@ -446,11 +660,19 @@ void InitRocksDBOptions(
     table_options.block_cache = tablet_options.block_cache;
     // Cache the bloom filters in the block cache.
     table_options.cache_index_and_filter_blocks = true;
+    table_options.pin_top_level_index = FLAGS_pin_top_level_data_index;
+    table_options.index_and_filter_blocks_in_multi_touch_cache =
+        FLAGS_index_and_filter_blocks_in_multi_touch_cache;
+    table_options.scan_prefetch_data_blocks = std::max(FLAGS_rocksdb_scan_prefetch_data_blocks, 0);
   } else {
     table_options.no_block_cache = true;
     table_options.cache_index_and_filter_blocks = false;
   }
   table_options.block_size = FLAGS_db_block_size_bytes;
+  table_options.max_auto_readahead_size = std::max<int64_t>(
+      FLAGS_rocksdb_max_auto_readahead_size_bytes, 0);
+  table_options.num_sequential_reads_for_auto_readahead = std::max(
+      FLAGS_rocksdb_num_sequential_reads_for_auto_readahead, 0);
   table_options.filter_block_size = FLAGS_db_filter_block_size_bytes;
   table_options.index_block_size = FLAGS_db_index_block_size_bytes;
   table_options.min_keys_per_index_block = FLAGS_db_min_keys_per_index_block;
@@ -461,6 +683,12 @@ void InitRocksDBOptions(
         table_options.filter_block_size * 8, options->info_log.get()));
   }
 
+  if (FLAGS_use_docdb_aware_block_restarts) {
+    table_options.data_block_key_group_extractor = std::make_shared<DocKeyGroupExtractor>();
+    table_options.data_block_max_restart_interval = FLAGS_db_block_max_restart_interval;
+    table_options.data_block_hash_index = FLAGS_use_docdb_data_block_hash_index;
+  }
+
   if (FLAGS_use_multi_level_index) {
     table_options.index_type = rocksdb::IndexType::kMultiLevelBinarySearch;
   } else {
@@ -492,18 +720,137 @@ void InitRocksDBOptions(
         FLAGS_rocksdb_universal_compaction_size_ratio;
     options->compaction_options_universal.min_merge_width =
         FLAGS_rocksdb_universal_compaction_min_merge_width;
+    options->compaction_options_universal.read_amp_compaction_trigger =
+        std::max(FLAGS_rocksdb_read_amp_compaction_trigger, 0);
+    options->compaction_options_universal.read_amp_compaction_min_reads =
+        FLAGS_rocksdb_read_amp_compaction_min_reads;
     options->compaction_size_threshold_bytes = FLAGS_rocksdb_compaction_size_threshold_bytes;
-    if (FLAGS_rocksdb_compact_flush_rate_limit_bytes_per_sec > 0) {
-      options->rate_limiter.reset(
-          rocksdb::NewGenericRateLimiter(FLAGS_rocksdb_compact_flush_rate_limit_bytes_per_sec));
+    options->compaction_readahead_size = std::max<int64_t>(
+        FLAGS_rocksdb_compaction_readahead_size_bytes, 0);
+    InitLargeCompactionCompression(options);
+    options->max_subcompactions = std::max(FLAGS_rocksdb_max_subcompactions, 1);
+    options->min_subcompaction_size = FLAGS_rocksdb_min_subcompaction_size_bytes;
+    // Keep all the records of a row in one subcompaction, the compaction filter relies on seeing
+    // them together.
+    options->subcompaction_key_group_extractor = std::make_shared<DocKeyGroupExtractor>();
+    if (tablet_options.rate_limiter) {
+      options->rate_limiter = tablet_options.rate_limiter;
+    } else {
+      options->rate_limiter = CreateCompactionRateLimiter();
     }
   }
 
+  options->use_direct_io_for_flush_and_compaction =
+      FLAGS_rocksdb_use_direct_io_for_flush_and_compaction;
+
   uint64_t max_file_size_for_compaction = FLAGS_rocksdb_max_file_size_for_compaction;
   if (max_file_size_for_compaction != 0) {
     options->max_file_size_for_compaction = max_file_size_for_compaction;
   }
 }
 
+std::shared_ptr<rocksdb::RateLimiter> CreateCompactionRateLimiter() {
+  if (FLAGS_rocksdb_compact_flush_rate_limit_bytes_per_sec <= 0) {
+    return nullptr;
+  }
+  return std::shared_ptr<rocksdb::RateLimiter>(
+      rocksdb::NewGenericRateLimiter(FLAGS_rocksdb_compact_flush_rate_limit_bytes_per_sec));
+}
+
+void SetBloomFilterOptions(
+    rocksdb::Options* options, size_t num_range_components, rocksdb::FixedSizeFilterFormat format) {
+  if (!FLAGS_use_docdb_aware_bloom_filter || !options->table_factory) {
+    return;
+  }
+  auto* current_options =
+      static_cast<rocksdb::BlockBasedTableOptions*>(options->table_factory->GetOptions());
+  if (!current_options) {
+    return;
+  }
+  // The table factory could be shared with options of another RocksDB instance, so create a new
+  // one instead of updating the current one.
+  rocksdb::BlockBasedTableOptions table_options = *current_options;
+  table_options.filter_policy.reset(new DocDbAwareFilterPolicy(
+      table_options.filter_block_size * 8, options->info_log.get(), num_range_components, format));
+  options->table_factory.reset(rocksdb::NewBlockBasedTableFactory(table_options));
+}
+
+void SetColdDataPath(const std::string& db_dir, std::function<HybridTime()> now,
+                     rocksdb::Options* options) {
+  if (FLAGS_rocksdb_cold_data_dir.empty()) {
+    return;
+  }
+  // Keep the table-<id>/tablet-<id> layout of the data directories.
+  const std::string cold_dir = JoinPathSegments(
+      FLAGS_rocksdb_cold_data_dir, BaseName(DirName(db_dir)), BaseName(db_dir));
+  options->db_paths = {
+      rocksdb::DbPath(db_dir, std::numeric_limits<uint64_t>::max()),
+      rocksdb::DbPath(cold_dir, std::numeric_limits<uint64_t>::max()),
+  };
+  if (!now) {
+    return;
+  }
+  options->compaction_output_path_selector =
+      [now = std::move(now)](const rocksdb::UserFrontier& largest_frontier) -> uint32_t {
+    const int64_t age_sec = FLAGS_rocksdb_cold_data_age_sec;
+    const HybridTime hybrid_time =
+        down_cast<const ConsensusFrontier&>(largest_frontier).hybrid_time();
+    if (age_sec > 0 && hybrid_time.is_valid() &&
+        hybrid_time.AddMicroseconds(age_sec * MonoTime::kMicrosecondsPerSecond) < now()) {
+      return kColdDataPathId;
+    }
+    return 0;
+  };
+}
+
+void SetBlockCachePriorityClass(rocksdb::Options* options,
+                                rocksdb::CachePriorityClass priority_class) {
+  if (!options->table_factory) {
+    return;
+  }
+  auto* current_options =
+      static_cast<rocksdb::BlockBasedTableOptions*>(options->table_factory->GetOptions());
+  if (!current_options || !current_options->block_cache) {
+    return;
+  }
+  // The table factory could be shared with options of another RocksDB instance, so create a new
+  // one instead of updating the current one.
+  rocksdb::BlockBasedTableOptions table_options = *current_options;
+  table_options.block_cache = rocksdb::NewPriorityClassCache(
+      table_options.block_cache, priority_class);
+  options->table_factory.reset(rocksdb::NewBlockBasedTableFactory(table_options));
+}
+
+void SetHashPrefixMemTableOptions(rocksdb::Options* options) {
+  const int bucket_bits = std::max(0, std::min(FLAGS_docdb_hash_prefix_memtable_bucket_bits, 16));
+  const int shift = 16 - bucket_bits;
+  const size_t num_hash_buckets = 1ULL << bucket_bits;
+  // Bucket 0 holds the keys ordered before all hashed DocKeys, and the last bucket the keys ordered
+  // after them, so the bucket function is monotonic for any key. Missing bytes of a truncated hash
+  // are taken as zeros, which also keeps the order.
+  auto bucket_function = [shift, num_hash_buckets](const Slice& user_key) -> size_t {
+    if (user_key.empty()) {
+      return 0;
+    }
+    const auto value_type = static_cast<ValueType>(user_key[0]);
+    if (value_type < ValueType::kUInt16Hash) {
+      return 0;
+    }
+    if (value_type > ValueType::kUInt16Hash) {
+      return num_hash_buckets + 1;
+    }
+    uint16_t hash = 0;
+    if (user_key.size() > 1) {
+      hash = static_cast<uint8_t>(user_key[1]) << 8;
+    }
+    if (user_key.size() > 2) {
+      hash |= static_cast<uint8_t>(user_key[2]);
+    }
+    return 1 + (hash >> shift);
+  };
+  options->memtable_factory.reset(
+      rocksdb::NewOrderedBucketsRepFactory(num_hash_buckets + 2, std::move(bucket_function)));
+}
+
 }  // namespace docdb
 }  // namespace yb
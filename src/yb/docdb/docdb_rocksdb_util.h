@@ -14,6 +14,8 @@
 #ifndef YB_DOCDB_DOCDB_ROCKSDB_UTIL_H_
 #define YB_DOCDB_DOCDB_ROCKSDB_UTIL_H_
 
+#include <functional>
+
 #include <boost/optional.hpp>
 
 #include "yb/common/read_hybrid_time.h"
@@ -24,6 +26,7 @@
 
 #include "yb/rocksdb/cache.h"
 #include "yb/rocksdb/db.h"
+#include "yb/rocksdb/filter_policy.h"
 #include "yb/rocksdb/options.h"
 
 #include "yb/tablet/tablet_options.h"
@@ -33,6 +36,7 @@
 namespace yb {
 namespace docdb {
 
+class AdaptiveSeekTuner;
 class IntentAwareIterator;
 
 // Seek to a given prefix and hybrid_time. If an expired value is found, it is still considered
@@ -51,30 +55,36 @@ Status SeekToValidKvAtTs(
 
 // See to a rocksdb point that is at least sub_doc_key.
 // If the iterator is already positioned far enough, does not perform a seek.
-void SeekForward(const rocksdb::Slice& slice, rocksdb::Iterator *iter);
+// If tuner is specified, it decides how many nexts to try before seeking.
+void SeekForward(const rocksdb::Slice& slice, rocksdb::Iterator *iter,
+                 AdaptiveSeekTuner* tuner = nullptr);
 
-void SeekForward(const KeyBytes& key_bytes, rocksdb::Iterator *iter);
+void SeekForward(const KeyBytes& key_bytes, rocksdb::Iterator *iter,
+                 AdaptiveSeekTuner* tuner = nullptr);
 
 // When we replace HybridTime::kMin in the end of seek key, next seek will skip older versions of
 // this key, but will not skip any subkeys in its subtree. If the iterator is already positioned far
 // enough, does not perform a seek.
 void SeekPastSubKey(const SubDocKey& sub_doc_key, rocksdb::Iterator* iter);
-void SeekPastSubKey(const Slice& key, rocksdb::Iterator* iter);
+void SeekPastSubKey(const Slice& key, rocksdb::Iterator* iter, AdaptiveSeekTuner* tuner = nullptr);
 
 // Seek out of the given SubDocKey. For efficiency, the method that takes a non-const KeyBytes
 // pointer avoids memory allocation by using the KeyBytes buffer to prepare the key to seek to by
 // appending an extra byte. The appended byte is removed when the method returns.
 void SeekOutOfSubKey(const Slice& key, rocksdb::Iterator* iter);
-void SeekOutOfSubKey(KeyBytes* key_bytes, rocksdb::Iterator* iter);
+void SeekOutOfSubKey(KeyBytes* key_bytes, rocksdb::Iterator* iter,
+                     AdaptiveSeekTuner* tuner = nullptr);
 
 KeyBytes AppendDocHt(const Slice& key, const DocHybridTime& doc_ht);
 
 // A wrapper around the RocksDB seek operation that uses Next() up to the configured number of
-// times to avoid invalidating iterator state. In debug mode it also allows printing detailed
-// information about RocksDB seeks.
+// times to avoid invalidating iterator state. The number is chosen by tuner if specified, or
+// taken from FLAGS_max_nexts_to_avoid_seek otherwise. In debug mode it also allows printing
+// detailed information about RocksDB seeks.
 void PerformRocksDBSeek(
     rocksdb::Iterator *iter,
     const rocksdb::Slice &seek_key,
+    AdaptiveSeekTuner* tuner,
     const char* file_name,
     int line);
 
@@ -94,7 +104,12 @@ void PerformRocksDBReverseSeek(
 // TODO: is there too much overhead in passing file name and line here in release mode?
 #define ROCKSDB_SEEK(iter, key) \
   do { \
-    PerformRocksDBSeek((iter), (key), __FILE__, __LINE__); \
+    PerformRocksDBSeek((iter), (key), nullptr /* tuner */, __FILE__, __LINE__); \
+  } while (0)
+
+#define ROCKSDB_TUNED_SEEK(iter, key, tuner) \
+  do { \
+    PerformRocksDBSeek((iter), (key), (tuner), __FILE__, __LINE__); \
   } while (0)
 
 enum class BloomFilterMode {
@@ -129,6 +144,24 @@ std::unique_ptr<IntentAwareIterator> CreateIntentAwareIterator(
     std::shared_ptr<rocksdb::ReadFileFilter> file_filter = nullptr,
     const Slice* iterate_upper_bound = nullptr);
 
+// A file filter that does not skip any SST file, but tracks the oldest of the latest hybrid times
+// of the files it was asked about, i.e. of the files read by the iterator it was passed to.
+class FileMaxHybridTimeTracker : public rocksdb::ReadFileFilter {
+ public:
+  bool Filter(const rocksdb::FdWithBoundaries& file) const override;
+
+  // Returns true if some of the tracked files only hold records written before ht.
+  bool HasFilesOlderThan(HybridTime ht) const {
+    return min_max_ht_ < ht;
+  }
+
+ private:
+  mutable HybridTime min_max_ht_ = HybridTime::kMax;
+};
+
+// Creates a file filter that skips the SST files that only hold records written before min_ht.
+std::shared_ptr<rocksdb::ReadFileFilter> CreateMinHybridTimeFileFilter(HybridTime min_ht);
+
 // Initialize the RocksDB 'options' object for tablet identified by 'tablet_id'. The 'statistics'
 // object provided by the caller will be used by RocksDB to maintain the stats for the tablet
 // specified by 'tablet_id'.
@@ -137,6 +170,37 @@ void InitRocksDBOptions(
     const std::shared_ptr<rocksdb::Statistics>& statistics,
     const tablet::TabletOptions& tablet_options);
 
+// Creates a compaction and flush rate limiter to be shared by all RocksDB instances of a tablet
+// server through TabletOptions. Returns nullptr if compactions and flushes are not rate limited.
+std::shared_ptr<rocksdb::RateLimiter> CreateCompactionRateLimiter();
+
+// Makes the DocDB-aware bloom filter of 'options', initialized by InitRocksDBOptions, also take
+// into account the first num_range_components range components of keys, and build its filter
+// blocks in the given format. Does nothing when the DocDB-aware bloom filter is disabled.
+void SetBloomFilterOptions(
+    rocksdb::Options* options, size_t num_range_components, rocksdb::FixedSizeFilterFormat format);
+
+// Index in db_paths of the directory for SST files that only contain old data.
+constexpr uint32_t kColdDataPathId = 1;
+
+// Adds the directory for SST files that only contain old data of the RocksDB instance at 'db_dir'
+// to 'options', when rocksdb_cold_data_dir is set. If 'now' is given, the output files of
+// compactions of data older than rocksdb_cold_data_age_sec go there.
+void SetColdDataPath(const std::string& db_dir, std::function<HybridTime()> now,
+                     rocksdb::Options* options);
+
+// Makes the blocks of the RocksDB instance opened with 'options', initialized by
+// InitRocksDBOptions, belong to the given priority class of the shared block cache. Does nothing
+// when there is no block cache.
+void SetBlockCachePriorityClass(rocksdb::Options* options,
+                                rocksdb::CachePriorityClass priority_class);
+
+// Makes the memtables of the RocksDB instance opened with 'options' split into buckets by the high
+// bits of the 16-bit hash of their DocKeys, as set by docdb_hash_prefix_memtable_bucket_bits. Keys
+// of a hash partitioned table stay in order across the buckets, so scans and flushes still see one
+// sorted memtable, while writes and point reads only traverse the skip list of their bucket.
+void SetHashPrefixMemTableOptions(rocksdb::Options* options);
+
 }  // namespace docdb
 }  // namespace yb
 
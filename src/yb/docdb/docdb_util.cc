@@ -251,6 +251,10 @@ Status DocDBRocksDBUtil::InitCommonRocksDBOptions() {
   InitRocksDBWriteOptions(&write_options_);
   rocksdb_options_.compaction_filter_factory =
       std::make_shared<docdb::DocDBCompactionFilterFactory>(retention_policy_);
+  rocksdb_options_.expired_files_selector =
+      docdb::CreateTtlExpiredFilesSelector(retention_policy_);
+  rocksdb_options_.table_properties_collector_factories.push_back(
+      docdb::CreateObsoleteVersionsCollectorFactory(retention_policy_));
   return Status::OK();
 }
 
@@ -371,6 +375,11 @@ Status DocDBRocksDBUtil::ReinitDBOptions() {
   return ReopenRocksDB();
 }
 
+Status DocDBRocksDBUtil::UseHashPrefixMemTable() {
+  SetHashPrefixMemTableOptions(&rocksdb_options_);
+  return ReopenRocksDB();
+}
+
 DocWriteBatch DocDBRocksDBUtil::MakeDocWriteBatch() {
   return DocWriteBatch(
       {rocksdb_.get(), nullptr /* intents_db */}, init_marker_behavior_, &monotonic_counter_);
@@ -177,6 +177,9 @@ class DocDBRocksDBUtil {
 
   CHECKED_STATUS ReinitDBOptions();
 
+  // Reopens RocksDB with memtables split into buckets by the hash of the DocKeys.
+  CHECKED_STATUS UseHashPrefixMemTable();
+
   std::atomic<int64_t>& monotonic_counter() {
     return monotonic_counter_;
   }
@@ -18,6 +18,7 @@
 
 #include "yb/docdb/doc_rowwise_iterator.h"
 #include "yb/docdb/docdb.h"
+#include "yb/docdb/docdb_execution_stats.h"
 #include "yb/docdb/docdb_test_base.h"
 #include "yb/docdb/docdb_test_util.h"
 #include "yb/docdb/intent.h"
@@ -628,6 +629,46 @@ SubDocKey(DocKey([], ["row1", 11111]), [ColumnId(50); HT{ physical: 1000 w: 1 }]
   }
 }
 
+TEST_F(DocRowwiseIteratorTest, SkipToNextPartitionKey) {
+  const Schema schema({
+          ColumnSchema("h", DataType::STRING, /* is_nullable = */ false, /* is_hash_key = */ true),
+          ColumnSchema("r", DataType::INT64, false),
+          ColumnSchema("v", DataType::INT64, true)
+      }, {
+          10_ColId,
+          20_ColId,
+          30_ColId
+      }, 2);
+
+  auto dwb = MakeDocWriteBatch();
+  for (const auto& hash_and_key : {std::make_pair(0x1111, "h1"), std::make_pair(0x2222, "h2")}) {
+    for (int64_t r = 1; r <= 3; ++r) {
+      const KeyBytes doc_key = DocKey(
+          hash_and_key.first, PrimitiveValues(hash_and_key.second), PrimitiveValues(r)).Encode();
+      ASSERT_OK(dwb.SetPrimitive(DocPath(doc_key, PrimitiveValue(30_ColId)), PrimitiveValue(r)));
+    }
+  }
+  ASSERT_OK(WriteToRocksDB(dwb, HybridTime::FromMicros(1000)));
+
+  DocRowwiseIterator iter(
+      schema, schema, kNonTransactionalOperationContext, doc_db(),
+      CoarseTimePoint::max() /* deadline */, ReadHybridTime::FromMicros(2000));
+  ASSERT_OK(iter.Init());
+
+  QLTableRow row;
+  QLValue value;
+  for (const auto* hashed_value : {"h1", "h2"}) {
+    ASSERT_TRUE(iter.HasNext());
+    ASSERT_OK(iter.NextRow(&row));
+    ASSERT_OK(row.GetValue(10_ColId, &value));
+    ASSERT_EQ(hashed_value, value.string_value());
+    ASSERT_OK(row.GetValue(20_ColId, &value));
+    ASSERT_EQ(1, value.int64_value());
+    ASSERT_OK(iter.SkipToNextPartitionKey());
+  }
+  ASSERT_FALSE(iter.HasNext());
+}
+
 TEST_F(DocRowwiseIteratorTest, DocRowwiseIteratorResolveWriteIntents) {
   SetTransactionIsolationLevel(IsolationLevel::SNAPSHOT_ISOLATION);
 
@@ -1037,5 +1078,43 @@ TEST_F(DocRowwiseIteratorTest, ScanWithinTheSameTxn) {
   ASSERT_FALSE(iter.HasNext());
 }
 
+TEST_F(DocRowwiseIteratorTest, ExecutionStats) {
+  ASSERT_OK(SetPrimitive(
+      DocPath(kEncodedDocKey1, PrimitiveValue(30_ColId)),
+      PrimitiveValue("row1_c"), HybridTime::FromMicros(1000)));
+  ASSERT_OK(SetPrimitive(
+      DocPath(kEncodedDocKey2, PrimitiveValue(30_ColId)),
+      PrimitiveValue("row2_c"), HybridTime::FromMicros(1000)));
+
+  const Schema &schema = kSchemaForIteratorTests;
+  const Schema &projection = kProjectionForIteratorTests;
+  QLTableRow row;
+  DocDBExecutionStats stats;
+  {
+    ScopedDocDBExecutionStats stats_scope(&stats);
+    DocRowwiseIterator iter(
+        projection, schema, kNonTransactionalOperationContext, doc_db(),
+        CoarseTimePoint::max() /* deadline */, ReadHybridTime::FromMicros(2000));
+    ASSERT_OK(iter.Init());
+    while (iter.HasNext()) {
+      ASSERT_OK(iter.NextRow(&row));
+    }
+  }
+  ASSERT_EQ(2U, stats.rows_scanned);
+  ASSERT_EQ(0U, stats.intents);
+  ASSERT_GT(stats.seeks, 0U);
+
+  // Nothing is gathered outside of the scope.
+  const auto seeks = stats.seeks;
+  DocRowwiseIterator iter(
+      projection, schema, kNonTransactionalOperationContext, doc_db(),
+      CoarseTimePoint::max() /* deadline */, ReadHybridTime::FromMicros(2000));
+  ASSERT_OK(iter.Init());
+  ASSERT_TRUE(iter.HasNext());
+  ASSERT_OK(iter.NextRow(&row));
+  ASSERT_EQ(2U, stats.rows_scanned);
+  ASSERT_EQ(seeks, stats.seeks);
+}
+
 }  // namespace docdb
 }  // namespace yb
@@ -22,6 +22,7 @@
 #include "yb/common/transaction.h"
 
 #include "yb/docdb/conflict_resolution.h"
+#include "yb/docdb/docdb_execution_stats.h"
 #include "yb/docdb/docdb_rocksdb_util.h"
 #include "yb/docdb/docdb-internal.h"
 #include "yb/docdb/intent.h"
@@ -34,6 +35,8 @@ using namespace std::literals;
 
 DEFINE_bool(transaction_allow_rerequest_status_in_tests, true,
             "Allow rerequest transaction status when try again is received.");
+DEFINE_bool(skip_intents_db_without_live_intents, true,
+            "Do not merge the intents DB into reads of a tablet that has no live intents.");
 
 namespace yb {
 namespace docdb {
@@ -238,11 +241,15 @@ IntentAwareIterator::IntentAwareIterator(
       encoded_read_time_global_limit_(
           DocHybridTime(read_time_.global_limit, kMaxWriteId).EncodedInDocDbFormat()),
       txn_op_context_(txn_op_context),
+      regular_seek_tuner_(doc_db.regular_seek_tuner),
+      intents_seek_tuner_(doc_db.intents_seek_tuner),
       transaction_status_cache_(
           txn_op_context ? &txn_op_context->txn_status_manager : nullptr, read_time, deadline) {
   VLOG(4) << "IntentAwareIterator, read_time: " << read_time
           << ", txp_op_context: " << txn_op_context_;
-  if (txn_op_context.is_initialized()) {
+  if (txn_op_context.is_initialized() &&
+      (!FLAGS_skip_intents_db_without_live_intents ||
+       txn_op_context->txn_status_manager.MayHaveLiveIntents())) {
     intent_iter_ = docdb::CreateRocksDBIterator(doc_db.intents,
                                                 docdb::BloomFilterMode::DONT_USE_BLOOM_FILTER,
                                                 boost::none,
@@ -266,7 +273,7 @@ void IntentAwareIterator::Seek(const Slice& key) {
     return;
   }
 
-  ROCKSDB_SEEK(iter_.get(), key);
+  ROCKSDB_TUNED_SEEK(iter_.get(), key, regular_seek_tuner_);
   skip_future_records_needed_ = true;
 
   if (intent_iter_) {
@@ -312,7 +319,7 @@ void IntentAwareIterator::SeekPastSubKey(const Slice& key) {
     return;
   }
 
-  docdb::SeekPastSubKey(key, iter_.get());
+  docdb::SeekPastSubKey(key, iter_.get(), regular_seek_tuner_);
   skip_future_records_needed_ = true;
   if (intent_iter_ && status_.ok()) {
     seek_intent_iter_needed_ = SeekIntentIterNeeded::kSeekForward;
@@ -328,7 +335,7 @@ void IntentAwareIterator::SeekOutOfSubDoc(KeyBytes* key_bytes) {
     return;
   }
 
-  docdb::SeekOutOfSubKey(key_bytes, iter_.get());
+  docdb::SeekOutOfSubKey(key_bytes, iter_.get(), regular_seek_tuner_);
   skip_future_records_needed_ = true;
   if (intent_iter_ && status_.ok()) {
     seek_intent_iter_needed_ = SeekIntentIterNeeded::kSeekForward;
@@ -426,7 +433,7 @@ Status IntentAwareIterator::NextFullValue(
 }
 
 void IntentAwareIterator::PrevSubDocKey(const KeyBytes& key_bytes) {
-  ROCKSDB_SEEK(iter_.get(), key_bytes);
+  ROCKSDB_TUNED_SEEK(iter_.get(), key_bytes, regular_seek_tuner_);
 
   if (iter_->Valid()) {
     iter_->Prev();
@@ -437,7 +444,8 @@ void IntentAwareIterator::PrevSubDocKey(const KeyBytes& key_bytes) {
 
   if (intent_iter_) {
     ResetIntentUpperbound();
-    ROCKSDB_SEEK(intent_iter_.get(), GetIntentPrefixForKeyWithoutHt(key_bytes));
+    ROCKSDB_TUNED_SEEK(
+        intent_iter_.get(), GetIntentPrefixForKeyWithoutHt(key_bytes), intents_seek_tuner_);
     if (intent_iter_->Valid()) {
       intent_iter_->Prev();
     } else {
@@ -457,7 +465,7 @@ void IntentAwareIterator::PrevSubDocKey(const KeyBytes& key_bytes) {
 void IntentAwareIterator::PrevDocKey(const DocKey& doc_key) {
   auto key_bytes = doc_key.Encode();
 
-  ROCKSDB_SEEK(iter_.get(), key_bytes);
+  ROCKSDB_TUNED_SEEK(iter_.get(), key_bytes, regular_seek_tuner_);
   if (iter_->Valid()) {
     iter_->Prev();
   } else {
@@ -467,7 +475,8 @@ void IntentAwareIterator::PrevDocKey(const DocKey& doc_key) {
 
   if (intent_iter_) {
     ResetIntentUpperbound();
-    ROCKSDB_SEEK(intent_iter_.get(), GetIntentPrefixForKeyWithoutHt(key_bytes));
+    ROCKSDB_TUNED_SEEK(
+        intent_iter_.get(), GetIntentPrefixForKeyWithoutHt(key_bytes), intents_seek_tuner_);
     if (intent_iter_->Valid()) {
       intent_iter_->Prev();
     } else {
@@ -536,7 +545,7 @@ void IntentAwareIterator::SeekIntentIterIfNeeded() {
     case SeekIntentIterNeeded::kNoNeed:
       break;
     case SeekIntentIterNeeded::kSeek:
-      ROCKSDB_SEEK(intent_iter_.get(), seek_key_buffer_);
+      ROCKSDB_TUNED_SEEK(intent_iter_.get(), seek_key_buffer_, intents_seek_tuner_);
       SeekToSuitableIntent<Direction::kForward>();
       seek_intent_iter_needed_ = SeekIntentIterNeeded::kNoNeed;
       return;
@@ -608,7 +617,7 @@ Slice IntentAwareIterator::value() {
 
 void IntentAwareIterator::SeekForwardRegular(const Slice& slice) {
   VLOG(4) << "SeekForwardRegular(" << SubDocKey::DebugSliceToString(slice) << ")";
-  docdb::SeekForward(slice, iter_.get());
+  docdb::SeekForward(slice, iter_.get(), regular_seek_tuner_);
   skip_future_records_needed_ = true;
 }
 
@@ -619,6 +628,7 @@ void IntentAwareIterator::ProcessIntent() {
     status_ = decode_result.status();
     return;
   }
+  RecordIntentEncountered();
   VLOG(4) << "Intent decode: " << DebugIntentKeyToString(intent_iter_->key())
           << " => " << intent_iter_->value().ToDebugHexString() << ", result: " << *decode_result;
   DOCDB_DEBUG_LOG(
@@ -677,9 +687,9 @@ void IntentAwareIterator::SeekForwardToSuitableIntent(const KeyBytes &intent_key
       resolved_intent_key_prefix_.CompareTo(intent_key_prefix) >= 0) {
     return;
   }
-  // Use ROCKSDB_SEEK() to force re-seek of "intent_iter_" in case the iterator was invalid by the
-  // previous intent upperbound, but the upperbound has changed therefore requiring re-seek.
-  ROCKSDB_SEEK(intent_iter_.get(), intent_key_prefix.AsSlice());
+  // Use ROCKSDB_TUNED_SEEK() to force re-seek of "intent_iter_" in case the iterator was invalid by
+  // the previous intent upperbound, but the upperbound has changed therefore requiring re-seek.
+  ROCKSDB_TUNED_SEEK(intent_iter_.get(), intent_key_prefix.AsSlice(), intents_seek_tuner_);
   SeekToSuitableIntent<Direction::kForward>();
 }
 
@@ -248,6 +248,8 @@ class IntentAwareIterator {
   const string encoded_read_time_local_limit_;
   const string encoded_read_time_global_limit_;
   const TransactionOperationContextOpt txn_op_context_;
+  AdaptiveSeekTuner* const regular_seek_tuner_;
+  AdaptiveSeekTuner* const intents_seek_tuner_;
   std::unique_ptr<rocksdb::Iterator> intent_iter_;
   std::unique_ptr<rocksdb::Iterator> iter_;
   // iter_valid_ is true if and only if iter_ is positioned at key which matches top prefix from
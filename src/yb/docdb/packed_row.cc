@@ -0,0 +1,95 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/packed_row.h"
+
+#include "yb/util/fast_varint.h"
+#include "yb/util/format.h"
+
+namespace yb {
+namespace docdb {
+
+PackedRowEncoder::PackedRowEncoder(uint32_t schema_version) {
+  buffer_.push_back(ValueTypeAsChar::kPackedRow);
+  util::FastAppendUnsignedVarIntToStr(schema_version, &buffer_);
+}
+
+void PackedRowEncoder::AddColumn(const PrimitiveValue& column_key, const Value& value) {
+  column_key_buffer_.Clear();
+  column_key.AppendToKey(&column_key_buffer_);
+  buffer_.append(column_key_buffer_.data());
+
+  value_buffer_.clear();
+  value.EncodeAndAppend(&value_buffer_);
+  util::FastAppendUnsignedVarIntToStr(value_buffer_.size(), &buffer_);
+  buffer_.append(value_buffer_);
+  ++num_columns_;
+}
+
+Status PackedRowDecoder::Init(const Slice& packed_row) {
+  remaining_ = packed_row;
+  if (ConsumeValueType(&remaining_) != ValueType::kPackedRow) {
+    return STATUS_FORMAT(Corruption, "Expected packed row, got: $0",
+                         packed_row.ToDebugHexString());
+  }
+  const auto schema_version = VERIFY_RESULT(util::FastDecodeUnsignedVarInt(&remaining_));
+  schema_version_ = static_cast<uint32_t>(schema_version);
+  return Status::OK();
+}
+
+Result<bool> PackedRowDecoder::Next(PrimitiveValue* column_key, Slice* encoded_value) {
+  if (remaining_.empty()) {
+    return false;
+  }
+  RETURN_NOT_OK(column_key->DecodeFromKey(&remaining_));
+  const auto value_size = VERIFY_RESULT(util::FastDecodeUnsignedVarInt(&remaining_));
+  if (value_size > remaining_.size()) {
+    return STATUS_FORMAT(Corruption, "Packed column value size $0 exceeds remaining $1 bytes",
+                         value_size, remaining_.size());
+  }
+  *encoded_value = Slice(remaining_.data(), value_size);
+  remaining_.remove_prefix(value_size);
+  return true;
+}
+
+std::string PackedRowToString(const Slice& packed_row) {
+  PackedRowDecoder decoder;
+  auto status = decoder.Init(packed_row);
+  if (!status.ok()) {
+    return status.ToString();
+  }
+  std::string result = Format("PACKED_ROW(v$0) { ", decoder.schema_version());
+  bool first = true;
+  for (;;) {
+    PrimitiveValue column_key;
+    Slice encoded_value;
+    auto has_next = decoder.Next(&column_key, &encoded_value);
+    if (!has_next.ok()) {
+      return result + has_next.status().ToString();
+    }
+    if (!*has_next) {
+      break;
+    }
+    if (!first) {
+      result += ", ";
+    }
+    first = false;
+    Value value;
+    status = value.Decode(encoded_value);
+    result += column_key.ToString() + ": " + (status.ok() ? value.ToString() : status.ToString());
+  }
+  return result + " }";
+}
+
+}  // namespace docdb
+}  // namespace yb
@@ -0,0 +1,90 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_DOCDB_PACKED_ROW_H
+#define YB_DOCDB_PACKED_ROW_H
+
+#include <string>
+
+#include "yb/docdb/primitive_value.h"
+#include "yb/docdb/value.h"
+#include "yb/docdb/value_type.h"
+
+#include "yb/util/result.h"
+#include "yb/util/slice.h"
+
+namespace yb {
+namespace docdb {
+
+// A packed row keeps all the non-key columns of a row in one RocksDB value stored at the DocKey
+// level, instead of one SubDocKey -> Value entry per column. Per-column entries written later on
+// top of the packed row take precedence over the packed column value, the same way they would
+// over an older per-column entry.
+//
+// Encoding:
+//   kPackedRow
+//   schema_version (unsigned varint)
+//   for each column:
+//     column subkey (PrimitiveValue in key encoding, self-delimiting)
+//     size of the encoded value (unsigned varint)
+//     encoded Value
+//
+// A packed row is a full overwrite of the row as of its hybrid time: columns that are absent from
+// the packed row are treated as having been deleted at that time.
+class PackedRowEncoder {
+ public:
+  explicit PackedRowEncoder(uint32_t schema_version);
+
+  void AddColumn(const PrimitiveValue& column_key, const Value& value);
+
+  size_t num_columns() const { return num_columns_; }
+
+  // Returns the encoded packed row. The encoder should not be used after this call.
+  std::string Finish() { return std::move(buffer_); }
+
+ private:
+  std::string buffer_;
+  KeyBytes column_key_buffer_;
+  std::string value_buffer_;
+  size_t num_columns_ = 0;
+};
+
+// Iterates over the columns of an encoded packed row. The decoder does not copy the packed row,
+// so the slice passed to Init should outlive it.
+class PackedRowDecoder {
+ public:
+  PackedRowDecoder() {}
+
+  CHECKED_STATUS Init(const Slice& packed_row);
+
+  uint32_t schema_version() const { return schema_version_; }
+
+  // Decodes the next column into column_key and encoded_value. Returns false when there are no
+  // more columns.
+  Result<bool> Next(PrimitiveValue* column_key, Slice* encoded_value);
+
+ private:
+  Slice remaining_;
+  uint32_t schema_version_ = 0;
+};
+
+inline bool IsPackedRow(const Slice& value) {
+  return DecodeValueType(value) == ValueType::kPackedRow;
+}
+
+std::string PackedRowToString(const Slice& packed_row);
+
+}  // namespace docdb
+}  // namespace yb
+
+#endif // YB_DOCDB_PACKED_ROW_H
@@ -59,6 +59,7 @@ using yb::util::DecodeDoubleFromKey;
     case ValueType::kJsonb: FALLTHROUGH_INTENDED; \
     case ValueType::kObject: FALLTHROUGH_INTENDED; \
     case ValueType::kObsoleteIntentPrefix: FALLTHROUGH_INTENDED; \
+    case ValueType::kPackedRow: FALLTHROUGH_INTENDED; \
     case ValueType::kRedisList: FALLTHROUGH_INTENDED;            \
     case ValueType::kRedisSet: FALLTHROUGH_INTENDED; \
     case ValueType::kRedisSortedSet: FALLTHROUGH_INTENDED;  \
@@ -218,6 +219,7 @@ string PrimitiveValue::ToString() const {
     case ValueType::kGroupEndDescending: FALLTHROUGH_INTENDED;
     case ValueType::kTtl: FALLTHROUGH_INTENDED;
     case ValueType::kUserTimestamp: FALLTHROUGH_INTENDED;
+    case ValueType::kPackedRow: FALLTHROUGH_INTENDED;
     case ValueType::kObsoleteIntentPrefix:
       break;
     case ValueType::kLowest:
@@ -528,6 +530,7 @@ string PrimitiveValue::ToValue() const {
     case ValueType::kMergeFlags: FALLTHROUGH_INTENDED;
     case ValueType::kGroupEnd: FALLTHROUGH_INTENDED;
     case ValueType::kGroupEndDescending: FALLTHROUGH_INTENDED;
+    case ValueType::kPackedRow: FALLTHROUGH_INTENDED;
     case ValueType::kObsoleteIntentPrefix: FALLTHROUGH_INTENDED;
     case ValueType::kTtl: FALLTHROUGH_INTENDED;
     case ValueType::kUserTimestamp: FALLTHROUGH_INTENDED;
@@ -626,7 +629,7 @@ Status PrimitiveValue::DecodeKey(rocksdb::Slice* slice, PrimitiveValue* out) {
           } else {
             PrimitiveValue pv;
             RETURN_NOT_OK(DecodeKey(slice, &pv));
-            out->frozen_val_->push_back(pv);
+            out->frozen_val_->push_back(std::move(pv));
           }
         }
       } else {
@@ -1078,6 +1081,7 @@ Status PrimitiveValue::DecodeFromValue(const rocksdb::Slice& rocksdb_slice) {
     case ValueType::kObsoleteIntentType: FALLTHROUGH_INTENDED;
     case ValueType::kGroupEnd: FALLTHROUGH_INTENDED;
     case ValueType::kGroupEndDescending: FALLTHROUGH_INTENDED;
+    case ValueType::kPackedRow: FALLTHROUGH_INTENDED;
     case ValueType::kObsoleteIntentPrefix: FALLTHROUGH_INTENDED;
     case ValueType::kUInt16Hash: FALLTHROUGH_INTENDED;
     case ValueType::kInvalid: FALLTHROUGH_INTENDED;
@@ -1528,12 +1532,25 @@ void PrimitiveValue::ToQLValuePB(const PrimitiveValue& primitive_value,
       ql_value->set_int32_value(static_cast<int32_t>(primitive_value.GetInt32()));
       return;
     case INT64:
+      // Values written before the column was widened from a smaller integer type are still
+      // stored as kInt32.
+      if (primitive_value.value_type() == ValueType::kInt32 ||
+          primitive_value.value_type() == ValueType::kInt32Descending) {
+        ql_value->set_int64_value(primitive_value.GetInt32());
+        return;
+      }
       ql_value->set_int64_value(static_cast<int64_t>(primitive_value.GetInt64()));
       return;
     case FLOAT:
       ql_value->set_float_value(static_cast<float>(primitive_value.GetFloat()));
       return;
     case DOUBLE:
+      // Likewise for values written before the column was widened from FLOAT.
+      if (primitive_value.value_type() == ValueType::kFloat ||
+          primitive_value.value_type() == ValueType::kFloatDescending) {
+        ql_value->set_double_value(primitive_value.GetFloat());
+        return;
+      }
       ql_value->set_double_value(primitive_value.GetDouble());
       return;
     case DECIMAL:
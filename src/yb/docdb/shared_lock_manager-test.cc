@@ -22,6 +22,7 @@
 
 #include "yb/rpc/thread_pool.h"
 
+#include "yb/util/metrics.h"
 #include "yb/util/random_util.h"
 #include "yb/util/test_macros.h"
 #include "yb/util/test_util.h"
@@ -33,6 +34,10 @@ using std::vector;
 using std::stack;
 using std::thread;
 
+METRIC_DEFINE_entity(test_entity);
+METRIC_DEFINE_counter(test_entity, test_lock_waits, "Test Lock Waits",
+                      yb::MetricUnit::kOperations, "Number of test lock waits.");
+
 namespace yb {
 namespace docdb {
 
@@ -194,5 +199,26 @@ TEST_F(SharedLockManagerTest, LockConflicts) {
   tp.Shutdown();
 }
 
+TEST_F(SharedLockManagerTest, LockWaitsCounter) {
+  MetricRegistry registry;
+  auto entity = METRIC_ENTITY_test_entity.Instantiate(&registry, "test");
+  auto lock_waits = METRIC_test_lock_waits.Instantiate(entity);
+  lm_.SetLockWaitsCounter(lock_waits);
+
+  TestLockBatch();
+  ASSERT_EQ(0, lock_waits->value());
+
+  auto lb = TestLockBatch();
+  std::thread thread([this] {
+    TestLockBatch();
+  });
+  std::this_thread::sleep_for(200ms);
+  // The second batch waits for the first key only, because both keys are released before it
+  // gets the first one.
+  lb.Reset();
+  thread.join();
+  ASSERT_EQ(1, lock_waits->value());
+}
+
 } // namespace docdb
 } // namespace yb
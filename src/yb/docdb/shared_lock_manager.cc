@@ -13,14 +13,18 @@
 
 #include "yb/docdb/shared_lock_manager.h"
 
+#include <array>
 #include <vector>
 
 #include <boost/range/adaptor/reversed.hpp>
 #include <boost/scope_exit.hpp>
 #include <glog/logging.h>
 
+#include "yb/gutil/port.h"
+
 #include "yb/util/bytes_formatter.h"
 #include "yb/util/enums.h"
+#include "yb/util/lock_contention.h"
 #include "yb/util/logging.h"
 #include "yb/util/trace.h"
 #include "yb/util/tostring.h"
@@ -107,8 +111,8 @@ struct LockedBatchEntry {
 
   std::condition_variable cond_var;
 
-  // Refcounting for garbage collection. Can only be used while the global mutex is locked.
-  // Global mutex resides in lock manager and the same for all LockBatchEntries.
+  // Refcounting for garbage collection. Can only be used while the mutex of the partition owning
+  // this entry is locked.
   size_t ref_count = 0;
 
   // Number of holders for each type
@@ -116,7 +120,8 @@ struct LockedBatchEntry {
 
   std::atomic<size_t> num_waiters{0};
 
-  MUST_USE_RESULT bool Lock(IntentTypeSet lock, CoarseTimePoint deadline);
+  // Sets waited to true if the lock could not be acquired without waiting.
+  MUST_USE_RESULT bool Lock(IntentTypeSet lock, CoarseTimePoint deadline, bool* waited);
 
   void Unlock(IntentTypeSet lock);
 };
@@ -126,24 +131,42 @@ class SharedLockManager::Impl {
   MUST_USE_RESULT bool Lock(LockBatchEntries* key_to_intent_type, CoarseTimePoint deadline);
   void Unlock(const LockBatchEntries& key_to_intent_type);
 
+  void SetLockWaitsCounter(scoped_refptr<Counter> lock_waits) {
+    lock_waits_ = std::move(lock_waits);
+  }
+
  private:
   typedef std::unordered_map<RefCntPrefix, LockedBatchEntry*, RefCntPrefixHash> LockEntryMap;
 
-  // Make sure the entries exist in the locks_ map and return pointers so we can access
-  // them without holding the global lock. Returns a vector with pointers in the same order
+  // The lock table is split into partitions by key hash, so that concurrent batches locking
+  // different keys do not serialize on a single mutex while reserving and releasing entries.
+  struct Partition {
+    // Taken only for short duration, with no blocking wait.
+    std::mutex mutex;
+
+    LockEntryMap locks GUARDED_BY(mutex);
+    // Cache of lock entries, to avoid allocation/deallocation of heavy LockedBatchEntry.
+    std::vector<std::unique_ptr<LockedBatchEntry>> lock_entries GUARDED_BY(mutex);
+    std::vector<LockedBatchEntry*> free_lock_entries GUARDED_BY(mutex);
+  } CACHELINE_ALIGNED;
+
+  static constexpr size_t kNumPartitions = 16;
+
+  Partition& PartitionFor(const RefCntPrefix& key) {
+    return partitions_[RefCntPrefixHash()(key) % kNumPartitions];
+  }
+
+  // Make sure the entries exist in the lock maps and return pointers so we can access
+  // them without holding the partition locks. Returns a vector with pointers in the same order
   // as the keys in the batch.
   void Reserve(LockBatchEntries* batch);
 
   // Update refcounts and maybe collect garbage.
   void Cleanup(const LockBatchEntries& key_to_intent_type);
 
-  // The global mutex should be taken only for very short duration, with no blocking wait.
-  std::mutex global_mutex_;
+  std::array<Partition, kNumPartitions> partitions_;
 
-  LockEntryMap locks_ GUARDED_BY(global_mutex_);
-  // Cache of lock entries, to avoid allocation/deallocation of heavy LockedBatchEntry.
-  std::vector<std::unique_ptr<LockedBatchEntry>> lock_entries_ GUARDED_BY(global_mutex_);
-  std::vector<LockedBatchEntry*> free_lock_entries_ GUARDED_BY(global_mutex_);
+  scoped_refptr<Counter> lock_waits_;
 };
 
 const std::array<LockState, kIntentTypeSetMapSize> kIntentTypeSetMask = GenerateByMask(
@@ -168,19 +191,25 @@ std::string SharedLockManager::ToString(const LockState& state) {
   return result;
 }
 
-bool LockedBatchEntry::Lock(IntentTypeSet lock_type, CoarseTimePoint deadline) {
+bool LockedBatchEntry::Lock(IntentTypeSet lock_type, CoarseTimePoint deadline, bool* waited) {
   size_t type_idx = lock_type.ToUIntPtr();
   auto& num_holding = this->num_holding;
   auto old_value = num_holding.load(std::memory_order_acquire);
   auto add = kIntentTypeSetAdd[type_idx];
+  int64_t contention_start = 0;
   for (;;) {
     if ((old_value & kIntentTypeSetConflicts[type_idx]) == 0) {
       auto new_value = old_value + add;
       if (num_holding.compare_exchange_weak(old_value, new_value, std::memory_order_acq_rel)) {
+        RecordLockContention(LockContentionSite::kSharedLockManager, contention_start);
         return true;
       }
       continue;
     }
+    if (!*waited) {
+      contention_start = LockContentionStart();
+    }
+    *waited = true;
     num_waiters.fetch_add(1, std::memory_order_release);
     BOOST_SCOPE_EXIT(this_) {
       this_->num_waiters.fetch_sub(1, std::memory_order_release);
@@ -190,6 +219,7 @@ bool LockedBatchEntry::Lock(IntentTypeSet lock_type, CoarseTimePoint deadline) {
     if ((old_value & kIntentTypeSetConflicts[type_idx]) != 0) {
       if (deadline != CoarseTimePoint::max()) {
         if (cond_var.wait_until(lock, deadline) == std::cv_status::timeout) {
+          RecordLockContention(LockContentionSite::kSharedLockManager, contention_start);
           return false;
         }
       } else {
@@ -242,12 +272,21 @@ void LockedBatchEntry::Unlock(IntentTypeSet lock_types) {
 bool SharedLockManager::Impl::Lock(LockBatchEntries* key_to_intent_type, CoarseTimePoint deadline) {
   TRACE("Locking a batch of $0 keys", key_to_intent_type->size());
   Reserve(key_to_intent_type);
+  int64_t num_waits = 0;
+  BOOST_SCOPE_EXIT(&num_waits, this_) {
+    if (num_waits != 0 && this_->lock_waits_) {
+      this_->lock_waits_->IncrementBy(num_waits);
+    }
+  } BOOST_SCOPE_EXIT_END;
   for (auto it = key_to_intent_type->begin(); it != key_to_intent_type->end(); ++it) {
     const auto& key_and_intent_type = *it;
     const auto intent_types = key_and_intent_type.intent_types;
     VLOG(4) << "Locking " << yb::ToString(intent_types) << ": "
             << key_and_intent_type.key.as_slice().ToDebugHexString();
-    if (!key_and_intent_type.locked->Lock(intent_types, deadline)) {
+    bool waited = false;
+    const bool locked = key_and_intent_type.locked->Lock(intent_types, deadline, &waited);
+    num_waits += waited;
+    if (!locked) {
       while (it != key_to_intent_type->begin()) {
         --it;
         it->locked->Unlock(it->intent_types);
@@ -261,16 +300,24 @@ bool SharedLockManager::Impl::Lock(LockBatchEntries* key_to_intent_type, CoarseT
 }
 
 void SharedLockManager::Impl::Reserve(LockBatchEntries* key_to_intent_type) {
-  std::lock_guard<std::mutex> lock(global_mutex_);
+  // Each key takes the mutex of its partition. The mutex is kept while the following keys map to
+  // the same partition.
+  Partition* locked_partition = nullptr;
+  std::unique_lock<std::mutex> lock;
   for (auto& key_and_intent_type : *key_to_intent_type) {
-    auto& value = locks_[key_and_intent_type.key];
+    auto& partition = PartitionFor(key_and_intent_type.key);
+    if (&partition != locked_partition) {
+      lock = std::unique_lock<std::mutex>(partition.mutex);
+      locked_partition = &partition;
+    }
+    auto& value = partition.locks[key_and_intent_type.key];
     if (!value) {
-      if (!free_lock_entries_.empty()) {
-        value = free_lock_entries_.back();
-        free_lock_entries_.pop_back();
+      if (!partition.free_lock_entries.empty()) {
+        value = partition.free_lock_entries.back();
+        partition.free_lock_entries.pop_back();
       } else {
-        lock_entries_.emplace_back(std::make_unique<LockedBatchEntry>());
-        value = lock_entries_.back().get();
+        partition.lock_entries.emplace_back(std::make_unique<LockedBatchEntry>());
+        value = partition.lock_entries.back().get();
       }
     }
     value->ref_count++;
@@ -289,11 +336,17 @@ void SharedLockManager::Impl::Unlock(const LockBatchEntries& key_to_intent_type)
 }
 
 void SharedLockManager::Impl::Cleanup(const LockBatchEntries& key_to_intent_type) {
-  std::lock_guard<std::mutex> lock(global_mutex_);
+  Partition* locked_partition = nullptr;
+  std::unique_lock<std::mutex> lock;
   for (const auto& item : key_to_intent_type) {
+    auto& partition = PartitionFor(item.key);
+    if (&partition != locked_partition) {
+      lock = std::unique_lock<std::mutex>(partition.mutex);
+      locked_partition = &partition;
+    }
     if (--(item.locked->ref_count) == 0) {
-      locks_.erase(item.key);
-      free_lock_entries_.push_back(item.locked);
+      partition.locks.erase(item.key);
+      partition.free_lock_entries.push_back(item.locked);
     }
   }
 }
@@ -311,5 +364,9 @@ void SharedLockManager::Unlock(const LockBatchEntries& key_to_intent_type) {
   impl_->Unlock(key_to_intent_type);
 }
 
+void SharedLockManager::SetLockWaitsCounter(scoped_refptr<Counter> lock_waits) {
+  impl_->SetLockWaitsCounter(std::move(lock_waits));
+}
+
 }  // namespace docdb
 }  // namespace yb
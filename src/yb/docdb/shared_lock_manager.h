@@ -24,6 +24,7 @@
 #include "yb/docdb/lock_batch.h"
 #include "yb/gutil/spinlock.h"
 #include "yb/util/cross_thread_mutex.h"
+#include "yb/util/metrics.h"
 
 namespace yb {
 namespace docdb {
@@ -49,6 +50,10 @@ class SharedLockManager {
   // Release the batch of locks. Requires that the locks are held.
   void Unlock(const LockBatchEntries& key_to_intent_type);
 
+  // Sets the counter incremented for every key lock that could not be acquired immediately,
+  // because a conflicting lock was held. Should be called before the lock manager is used.
+  void SetLockWaitsCounter(scoped_refptr<Counter> lock_waits);
+
   // Whether or not the state is possible
   static std::string ToString(const LockState& state);
 
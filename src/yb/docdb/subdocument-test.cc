@@ -43,6 +43,26 @@ TEST(SubDocumentTest, TestGetOrAddChild) {
 )#", d.ToString());
 }
 
+TEST(SubDocumentTest, TestSetChild) {
+  SubDocument d;
+  // Keys in increasing order are appended, other keys are inserted in place or replace a child.
+  d.SetChild(PrimitiveValue("b"), SubDocument(PrimitiveValue(1)));
+  d.SetChild(PrimitiveValue("d"), SubDocument(PrimitiveValue(2)));
+  d.SetChild(PrimitiveValue("a"), SubDocument(PrimitiveValue(3)));
+  d.SetChild(PrimitiveValue("c"), SubDocument(PrimitiveValue(4)));
+  d.SetChild(PrimitiveValue("d"), SubDocument(PrimitiveValue(5)));
+  const PrimitiveValue key("b");
+  d.SetChild(key, SubDocument(PrimitiveValue(6)));
+  ASSERT_STR_EQ_VERBOSE_TRIMMED(R"#(
+{
+  "a": 3,
+  "b": 6,
+  "c": 4,
+  "d": 5
+}
+)#", d.ToString());
+}
+
 TEST(SubDocumentTest, TestToString) {
   SubDocument subdoc(ValueType::kObject);
   SubDocument mathematicians;
@@ -219,6 +219,27 @@ pair<SubDocument*, bool> SubDocument::GetOrAddChild(const PrimitiveValue& key) {
   }
 }
 
+pair<SubDocument*, bool> SubDocument::GetOrAddChild(PrimitiveValue&& key) {
+  DCHECK(IsObjectType(type_));
+  EnsureContainerAllocated();
+  auto position = FindChildOrPosition(key);
+  if (position.second) {
+    return make_pair(&position.first->second, false);  // No new subdocument created.
+  }
+  auto iter = object_container().emplace_hint(position.first, std::move(key), SubDocument());
+  return make_pair(&iter->second, true);  // New subdocument created.
+}
+
+std::pair<SubDocument::ObjectContainer::iterator, bool> SubDocument::FindChildOrPosition(
+    const PrimitiveValue& key) {
+  auto& obj_container = object_container();
+  if (obj_container.empty() || obj_container.rbegin()->first < key) {
+    return make_pair(obj_container.end(), false);
+  }
+  auto iter = obj_container.lower_bound(key);
+  return make_pair(iter, iter != obj_container.end() && !(key < iter->first));
+}
+
 void SubDocument::AddListElement(SubDocument&& value) {
   DCHECK_EQ(ValueType::kArray, type_);
   EnsureContainerAllocated();
@@ -238,6 +259,17 @@ void SubDocument::SetChild(const PrimitiveValue& key, SubDocument&& value) {
   }
 }
 
+void SubDocument::SetChild(PrimitiveValue&& key, SubDocument&& value) {
+  type_ = ValueType::kObject;
+  EnsureContainerAllocated();
+  auto position = FindChildOrPosition(key);
+  if (position.second) {
+    position.first->second = std::move(value);
+  } else {
+    object_container().emplace_hint(position.first, std::move(key), std::move(value));
+  }
+}
+
 bool SubDocument::DeleteChild(const PrimitiveValue& key) {
   CHECK_EQ(ValueType::kObject, type_);
   if (!has_valid_object_container())
@@ -140,14 +140,22 @@ class SubDocument : public PrimitiveValue {
   //         new child subdocument has been added.
   std::pair<SubDocument*, bool> GetOrAddChild(const PrimitiveValue& key);
 
+  // Same as above, but moves the key into the new child. Children that are added in increasing key
+  // order, the way they are read from DocDB, are appended without searching the object.
+  std::pair<SubDocument*, bool> GetOrAddChild(PrimitiveValue&& key);
+
   // Add a list element child of the given value.
   void AddListElement(SubDocument&& value);
 
   // Set the child subdocument of an object to the given value.
   void SetChild(const PrimitiveValue& key, SubDocument&& value);
 
+  // Same as above, but moves the key into the object. Like GetOrAddChild, it is cheapest when
+  // children are added in increasing key order.
+  void SetChild(PrimitiveValue&& key, SubDocument&& value);
+
   void SetChildPrimitive(const PrimitiveValue& key, PrimitiveValue&& value) {
-    SetChild(key, SubDocument(value));
+    SetChild(key, SubDocument(std::move(value)));
   }
 
   void SetChildPrimitive(const PrimitiveValue& key, const PrimitiveValue& value) {
@@ -190,6 +198,10 @@ class SubDocument : public PrimitiveValue {
 
   void EnsureContainerAllocated();
 
+  // Returns the child with the given key, or the position to insert it at if there is none.
+  // Checks the position after the last child first.
+  std::pair<ObjectContainer::iterator, bool> FindChildOrPosition(const PrimitiveValue& key);
+
   bool container_allocated() const {
     CHECK(IsCollectionType(type_));
     return complex_data_structure_ != nullptr;
@@ -92,6 +92,8 @@ namespace docdb {
     ((kDoubleDescending, 'L'))  /* ASCII code 76 */ \
     ((kFloatDescending, 'M')) /* ASCII code 77 */ \
     ((kUInt32, 'O'))  /* ASCII code 78 */ \
+    /* All non-key columns of a row packed into one value stored at the DocKey level. */ \
+    ((kPackedRow, 'P'))  /* ASCII code 80 */ \
     ((kString, 'S'))  /* ASCII code 83 */ \
     ((kTrue, 'T'))  /* ASCII code 84 */ \
     ((kTombstone, 'X'))  /* ASCII code 88 */ \
@@ -208,7 +210,8 @@ constexpr inline bool IsCollectionType(const ValueType value_type) {
 constexpr inline bool IsPrimitiveValueType(const ValueType value_type) {
   return kMinPrimitiveValueType <= value_type && value_type <= kMaxPrimitiveValueType &&
          !IsCollectionType(value_type) &&
-         value_type != ValueType::kTombstone;
+         value_type != ValueType::kTombstone &&
+         value_type != ValueType::kPackedRow;
 }
 
 // Decode the first byte of the given slice as a ValueType.
@@ -96,6 +96,7 @@ const char *FsManager::kDataDirName = "data";
 const char *FsManager::kCorruptedSuffix = ".corrupted";
 const char *FsManager::kInstanceMetadataFileName = "instance";
 const char *FsManager::kConsensusMetadataDirName = "consensus-meta";
+const char *FsManager::kTabletOpenHintsFileName = "tablet-open-hints";
 const char *FsManager::kLogsDirName = "logs";
 
 static const char* const kTmpInfix = ".tmp";
@@ -491,6 +492,13 @@ std::string FsManager::GetInstanceMetadataPath(const string& root) const {
   return JoinPathSegments(GetServerTypeDataPath(root, server_type_), kInstanceMetadataFileName);
 }
 
+std::string FsManager::GetTabletOpenHintsPath() const {
+  DCHECK(initted_);
+  return JoinPathSegments(
+      GetServerTypeDataPath(canonicalized_metadata_fs_root_, server_type_),
+      kTabletOpenHintsFileName);
+}
+
 std::string FsManager::GetConsensusMetadataDir() const {
   DCHECK(initted_);
   return JoinPathSegments(
@@ -172,6 +172,9 @@ class FsManager {
   // Return the path where InstanceMetadataPB is stored.
   std::string GetInstanceMetadataPath(const std::string& root) const;
 
+  // Return the path where the TabletOpenHintsPB of the tablet server is stored.
+  std::string GetTabletOpenHintsPath() const;
+
   // Return the directory where the consensus metadata is stored.
   std::string GetConsensusMetadataDir() const;
 
@@ -244,6 +247,7 @@ class FsManager {
   static const char *kInstanceMetadataMagicNumber;
   static const char *kTabletSuperBlockMagicNumber;
   static const char *kConsensusMetadataDirName;
+  static const char *kTabletOpenHintsFileName;
   static const char *kLogsDirName;
 
   Env *env_;
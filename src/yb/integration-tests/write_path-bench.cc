@@ -0,0 +1,298 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+
+// Micro-profiling of the write path: writes rows to a MiniCluster with YBClient, and reports the
+// time that each write spends in each layer, from the client queue to the apply of the Raft
+// replicated operation, with the CPU instructions and allocations of the whole process per write.
+//
+// The layer times are taken from the latency histograms of the client, the tablet servers and the
+// tablets. Layers run on several servers, e.g. the log append runs on each replica, so the time of
+// a layer per write is the sum for all of them.
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+#include "yb/client/ql-dml-test-base.h"
+
+#include "yb/gutil/casts.h"
+
+#include "yb/tablet/tablet.h"
+#include "yb/tablet/tablet_peer.h"
+
+#include "yb/tserver/mini_tablet_server.h"
+#include "yb/tserver/tablet_server.h"
+#include "yb/tserver/ts_tablet_manager.h"
+
+#include "yb/util/benchmark_counters.h"
+#include "yb/util/env.h"
+#include "yb/util/hdr_histogram.h"
+#include "yb/util/jsonwriter.h"
+#include "yb/util/metrics.h"
+#include "yb/util/test_macros.h"
+#include "yb/util/tsan_util.h"
+
+DEFINE_int32(write_path_bench_ops, yb::NonTsanVsTsan(20000, 2000),
+             "Number of rows written by the measured part of the benchmark.");
+DEFINE_int32(write_path_bench_warmup_ops, yb::NonTsanVsTsan(2000, 200),
+             "Number of rows written before the measurements start.");
+DEFINE_int32(write_path_bench_threads, 1, "Number of threads writing rows.");
+DEFINE_int32(write_path_bench_batch_size, 1, "Number of rows written by each flush of a session.");
+DEFINE_string(write_path_bench_report_file, "",
+              "File that the JSON report of the benchmark is written to. The report is logged when "
+              "empty.");
+
+METRIC_DECLARE_entity(server);
+
+namespace yb {
+namespace client {
+
+namespace {
+
+struct Layer {
+  const char* name;
+  const char* histogram;
+};
+
+// The layers of the write path, in the order that a write goes through them.
+const Layer kLayers[] = {
+  {"client_call_queue", "handler_latency_outbound_call_queue_time"},
+  {"client_call_send", "handler_latency_outbound_call_send_time"},
+  {"client_call_response", "handler_latency_outbound_call_time_to_response"},
+  {"rpc_service_queue", "rpc_incoming_queue_time"},
+  {"tserver_write", "handler_latency_yb_tserver_TabletServerService_Write"},
+  {"prepare_queue", "op_prepare_queue_time"},
+  {"prepare", "op_prepare_run_time"},
+  {"log_append", "log_append_latency"},
+  {"log_group_commit", "log_group_commit_latency"},
+  {"log_sync", "log_sync_latency"},
+  {"raft_update_consensus", "handler_latency_yb_consensus_ConsensusService_UpdateConsensus"},
+  {"apply_queue", "op_apply_queue_time"},
+  {"apply", "op_apply_run_time"},
+  {"rpc_response_transfer", "handler_latency_outbound_transfer"},
+};
+
+struct HistogramTotals {
+  uint64_t count = 0;
+  uint64_t sum = 0;
+};
+
+// Totals of the histograms with the same name in all metric entities.
+typedef std::map<std::string, HistogramTotals> HistogramsTotals;
+
+void AddHistograms(const MetricEntity& entity, HistogramsTotals* out) {
+  for (const auto& entry : entity.UnsafeMetricsMapForTests()) {
+    if (entry.first->type() != MetricType::kHistogram) {
+      continue;
+    }
+    const auto* histogram = down_cast<const Histogram*>(entry.second.get());
+    auto& totals = (*out)[entry.first->name()];
+    totals.count += histogram->TotalCount();
+    totals.sum += histogram->TotalSum();
+  }
+}
+
+// Returns 'numerator' / 'denominator', or 0 when there is nothing to divide.
+double Ratio(double numerator, double denominator) {
+  return denominator != 0 ? numerator / denominator : 0;
+}
+
+} // namespace
+
+class WritePathBench : public KeyValueTableTest {
+ protected:
+  void SetUp() override {
+    KeyValueTableTest::SetUp();
+    CreateTable(Transactional::kFalse);
+  }
+
+  void DoTearDown() override {
+    KeyValueTableTest::DoTearDown();
+    // Uses the metric entity of the fixture.
+    client_.reset();
+  }
+
+  // The client reports the latencies of its calls to a metric entity of the fixture.
+  CHECKED_STATUS CreateClient() override {
+    client_metric_entity_ = METRIC_ENTITY_server.Instantiate(&client_metric_registry_, "client");
+    YBClientBuilder builder;
+    builder.set_metric_entity(client_metric_entity_);
+    return cluster_->CreateClient(&builder, &client_);
+  }
+
+  HistogramsTotals CollectHistograms() {
+    HistogramsTotals result;
+    AddHistograms(*client_metric_entity_, &result);
+    for (int i = 0; i != cluster_->num_tablet_servers(); ++i) {
+      auto* server = cluster_->mini_tablet_server(i)->server();
+      AddHistograms(*server->metric_entity(), &result);
+      for (const auto& peer : server->tablet_manager()->GetTabletPeers()) {
+        auto tablet = peer->shared_tablet();
+        if (tablet) {
+          AddHistograms(*tablet->GetMetricEntity(), &result);
+        }
+      }
+    }
+    return result;
+  }
+
+  // Writes the rows from 'begin' to 'end' with --write_path_bench_threads threads, and records
+  // the latency of each flush in 'latency' when it is not null.
+  void WriteRows(int32_t begin, int32_t end, HdrHistogram* latency) {
+    const int num_threads = FLAGS_write_path_bench_threads;
+    const int32_t batch_size = FLAGS_write_path_bench_batch_size;
+    std::vector<std::thread> threads;
+    std::atomic<int32_t> next_key{begin};
+    for (int i = 0; i != num_threads; ++i) {
+      threads.emplace_back([this, end, batch_size, latency, &next_key] {
+        auto session = CreateSession();
+        for (;;) {
+          const int32_t batch_begin = next_key.fetch_add(batch_size);
+          if (batch_begin >= end) {
+            break;
+          }
+          const int32_t batch_end = std::min(batch_begin + batch_size, end);
+          const auto start = MonoTime::Now();
+          std::vector<YBqlWriteOpPtr> ops;
+          for (int32_t key = batch_begin; key != batch_end; ++key) {
+            ops.push_back(ASSERT_RESULT(WriteRow(
+                session, key, key, WriteOpType::INSERT, Flush::kFalse)));
+          }
+          ASSERT_OK(session->Flush());
+          if (latency) {
+            latency->Increment((MonoTime::Now() - start).ToMicroseconds());
+          }
+          for (const auto& op : ops) {
+            ASSERT_OK(CheckOp(op.get()));
+          }
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+
+  void WriteReport(int64_t num_ops, MonoDelta elapsed, const BenchmarkCounters::Values& counts,
+                   const HdrHistogram& latency, const HistogramsTotals& before,
+                   const HistogramsTotals& after, std::stringstream* out) {
+    JsonWriter writer(out, JsonWriter::COMPACT);
+    writer.StartObject();
+    writer.String("ops");
+    writer.Int64(num_ops);
+    writer.String("threads");
+    writer.Int(FLAGS_write_path_bench_threads);
+    writer.String("batch_size");
+    writer.Int(FLAGS_write_path_bench_batch_size);
+    writer.String("elapsed_us");
+    writer.Int64(elapsed.ToMicroseconds());
+    writer.String("ops_per_sec");
+    writer.Double(num_ops / elapsed.ToSeconds());
+
+    writer.String("flush_latency_us");
+    writer.StartObject();
+    writer.String("mean");
+    writer.Double(latency.MeanValue());
+    for (auto percentile : {50.0, 99.0, 99.9}) {
+      writer.String(Format("p$0", percentile));
+      writer.Uint64(latency.ValueAtPercentile(percentile));
+    }
+    writer.String("max");
+    writer.Uint64(latency.MaxValue());
+    writer.EndObject();
+
+    writer.String("per_op");
+    writer.StartObject();
+    writer.String("cpu_us");
+    writer.Double(Ratio(counts.cpu_time.ToMicroseconds(), num_ops));
+    if (counts.instructions >= 0) {
+      writer.String("instructions");
+      writer.Double(Ratio(counts.instructions, num_ops));
+    }
+    if (counts.allocations >= 0) {
+      writer.String("allocations");
+      writer.Double(Ratio(counts.allocations, num_ops));
+    }
+    writer.EndObject();
+
+    writer.String("layers");
+    writer.StartArray();
+    for (const auto& layer : kLayers) {
+      HistogramTotals delta;
+      auto it = after.find(layer.histogram);
+      if (it != after.end()) {
+        delta = it->second;
+      }
+      it = before.find(layer.histogram);
+      if (it != before.end()) {
+        delta.count -= it->second.count;
+        delta.sum -= it->second.sum;
+      }
+      writer.StartObject();
+      writer.String("name");
+      writer.String(layer.name);
+      writer.String("histogram");
+      writer.String(layer.histogram);
+      writer.String("count_per_op");
+      writer.Double(Ratio(delta.count, num_ops));
+      writer.String("us_per_op");
+      writer.Double(Ratio(delta.sum, num_ops));
+      writer.String("mean_us");
+      writer.Double(Ratio(delta.sum, delta.count));
+      writer.EndObject();
+    }
+    writer.EndArray();
+    writer.EndObject();
+  }
+
+  // Created with the fixture, so that it also counts the threads of the cluster started by SetUp().
+  BenchmarkCounters counters_;
+  MetricRegistry client_metric_registry_;
+  scoped_refptr<MetricEntity> client_metric_entity_;
+};
+
+TEST_F(WritePathBench, BenchmarkWrite) {
+  const int32_t num_warmup_ops = FLAGS_write_path_bench_warmup_ops;
+  const int32_t num_ops = FLAGS_write_path_bench_ops;
+
+  // Opens the connections and fills the caches of the client before measuring.
+  ASSERT_NO_FATALS(WriteRows(0, num_warmup_ops, nullptr /* latency */));
+
+  HdrHistogram latency(60000000LU, 2);
+  const auto histograms_before = CollectHistograms();
+  const auto counters_before = counters_.Read();
+  const auto start = MonoTime::Now();
+  ASSERT_NO_FATALS(WriteRows(num_warmup_ops, num_warmup_ops + num_ops, &latency));
+  const auto elapsed = MonoTime::Now() - start;
+  const auto counts = counters_.Read() - counters_before;
+  const auto histograms_after = CollectHistograms();
+
+  std::stringstream report;
+  WriteReport(num_ops, elapsed, counts, latency, histograms_before, histograms_after, &report);
+  LOG(INFO) << "Write path report: " << report.str();
+  if (!FLAGS_write_path_bench_report_file.empty()) {
+    ASSERT_OK(WriteStringToFile(
+        Env::Default(), report.str() + "\n", FLAGS_write_path_bench_report_file));
+  }
+}
+
+} // namespace client
+} // namespace yb
@@ -358,6 +358,30 @@ void RetryingTSRpcTask::TransitionToTerminalState(MonitoredTaskState expected,
 // ============================================================================
 //  Class AsyncCreateReplica.
 // ============================================================================
+namespace {
+
+// Fills 'req' from the dirty data of 'tablet', which the caller has locked for write, and
+// 'table_pb', the data of its table.
+void SetupCreateTabletRequest(const TabletInfo& tablet,
+                              const SysTablesEntryPB& table_pb,
+                              tserver::CreateTabletRequestPB* req) {
+  const SysTabletsEntryPB& tablet_pb = tablet.metadata().dirty().pb;
+
+  req->set_table_id(tablet.table()->id());
+  req->set_tablet_id(tablet.tablet_id());
+  req->set_table_type(table_pb.table_type());
+  req->mutable_partition()->CopyFrom(tablet_pb.partition());
+  req->set_table_name(table_pb.name());
+  req->mutable_schema()->CopyFrom(table_pb.schema());
+  req->mutable_partition_schema()->CopyFrom(table_pb.partition_schema());
+  req->mutable_config()->CopyFrom(tablet_pb.committed_consensus_state().config());
+  if (table_pb.has_index_info()) {
+    req->mutable_index_info()->CopyFrom(table_pb.index_info());
+  }
+}
+
+} // namespace
+
 AsyncCreateReplica::AsyncCreateReplica(Master *master,
                                        ThreadPool *callback_pool,
                                        const string& permanent_uuid,
@@ -368,20 +392,8 @@ AsyncCreateReplica::AsyncCreateReplica(Master *master,
   deadline_.AddDelta(MonoDelta::FromMilliseconds(FLAGS_tablet_creation_timeout_ms));
 
   auto table_lock = tablet->table()->LockForRead();
-  const SysTabletsEntryPB& tablet_pb = tablet->metadata().dirty().pb;
-
   req_.set_dest_uuid(permanent_uuid);
-  req_.set_table_id(tablet->table()->id());
-  req_.set_tablet_id(tablet->tablet_id());
-  req_.set_table_type(tablet->table()->metadata().state().pb.table_type());
-  req_.mutable_partition()->CopyFrom(tablet_pb.partition());
-  req_.set_table_name(table_lock->data().pb.name());
-  req_.mutable_schema()->CopyFrom(table_lock->data().pb.schema());
-  req_.mutable_partition_schema()->CopyFrom(table_lock->data().pb.partition_schema());
-  req_.mutable_config()->CopyFrom(tablet_pb.committed_consensus_state().config());
-  if (table_lock->data().pb.has_index_info()) {
-    req_.mutable_index_info()->CopyFrom(table_lock->data().pb.index_info());
-  }
+  SetupCreateTabletRequest(*tablet, table_lock->data().pb, &req_);
 }
 
 void AsyncCreateReplica::HandleResponse(int attempt) {
@@ -409,6 +421,84 @@ bool AsyncCreateReplica::SendRequest(int attempt) {
   return true;
 }
 
+// ============================================================================
+//  Class AsyncCreateReplicas.
+// ============================================================================
+AsyncCreateReplicas::AsyncCreateReplicas(Master *master,
+                                         ThreadPool *callback_pool,
+                                         const string& permanent_uuid,
+                                         const std::vector<scoped_refptr<TabletInfo>>& tablets)
+  : RetrySpecificTSRpcTask(master, callback_pool, permanent_uuid, tablets.front()->table().get()) {
+  deadline_ = start_ts_;
+  deadline_.AddDelta(MonoDelta::FromMilliseconds(FLAGS_tablet_creation_timeout_ms));
+
+  auto table_lock = table_->LockForRead();
+  req_.set_dest_uuid(permanent_uuid);
+  for (const auto& tablet : tablets) {
+    DCHECK_EQ(tablet->table(), table_);
+    SetupCreateTabletRequest(*tablet, table_lock->data().pb, req_.add_tablets());
+  }
+}
+
+std::string AsyncCreateReplicas::description() const {
+  return Format("CreateTablets RPC for $0 tablets starting from $1 on TS $2",
+                req_.tablets_size(), tablet_id(), permanent_uuid_);
+}
+
+TabletId AsyncCreateReplicas::tablet_id() const {
+  return req_.tablets_size() ? req_.tablets(0).tablet_id() : TabletId();
+}
+
+void AsyncCreateReplicas::HandleResponse(int attempt) {
+  if (resp_.has_error()) {
+    LOG(WARNING) << "CreateTablets RPC on TS " << permanent_uuid_ << " failed: "
+                 << StatusFromPB(resp_.error().status()).ToString();
+    return;
+  }
+  if (resp_.tablets_size() != req_.tablets_size()) {
+    LOG(DFATAL) << "CreateTablets RPC on TS " << permanent_uuid_ << " returned "
+                << resp_.tablets_size() << " responses for " << req_.tablets_size()
+                << " tablets";
+    return;
+  }
+
+  // Keep only the tablets that should be retried.
+  auto* tablets = req_.mutable_tablets();
+  int num_failed = 0;
+  for (int i = 0; i != resp_.tablets_size(); ++i) {
+    const auto& tablet_resp = resp_.tablets(i);
+    const auto& tablet_id = req_.tablets(i).tablet_id();
+    if (tablet_resp.has_error()) {
+      Status s = StatusFromPB(tablet_resp.error().status());
+      if (!s.IsAlreadyPresent()) {
+        LOG(WARNING) << "CreateTablets RPC for tablet " << tablet_id
+                     << " on TS " << permanent_uuid_ << " failed: " << s.ToString();
+        tablets->SwapElements(i, num_failed++);
+        continue;
+      }
+      LOG(INFO) << "CreateTablets RPC for tablet " << tablet_id
+                << " on TS " << permanent_uuid_ << " returned already present: "
+                << s.ToString();
+    }
+  }
+  while (tablets->size() > num_failed) {
+    tablets->RemoveLast();
+  }
+
+  if (num_failed == 0) {
+    TransitionToTerminalState(MonitoredTaskState::kRunning, MonitoredTaskState::kComplete);
+  }
+}
+
+bool AsyncCreateReplicas::SendRequest(int attempt) {
+  resp_.Clear();
+  ts_admin_proxy_->CreateTabletsAsync(req_, &resp_, &rpc_, BindRpcCallback());
+  VLOG(1) << "Send create tablets request to " << permanent_uuid_ << ":\n"
+          << " (attempt " << attempt << "):\n"
+          << req_.DebugString();
+  return true;
+}
+
 // ============================================================================
 //  Class AsyncDeleteReplica.
 // ============================================================================
@@ -590,25 +680,52 @@ TabletServerId AsyncCopartitionTable::permanent_uuid() const {
   return target_ts_desc_ != nullptr ? target_ts_desc_->permanent_uuid() : "";
 }
 
-// TODO(sagnik): modify this to fill all relevant fields for the AsyncCopartition request.
 bool AsyncCopartitionTable::SendRequest(int attempt) {
+  auto l = table_->LockForRead();
 
-  tserver::CopartitionTableRequestPB req;
+  // The table is added to the tablet with a change metadata operation, so that all the replicas
+  // of the tablet learn about it through Raft.
+  tserver::ChangeMetadataRequestPB req;
   req.set_dest_uuid(permanent_uuid());
   req.set_tablet_id(tablet_->tablet_id());
-  req.set_table_id(table_->id());
-  req.set_table_name(table_->name());
+  req.set_propagated_hybrid_time(master_->clock()->Now().ToUint64());
+  auto& add_table = *req.mutable_add_table();
+  add_table.set_table_id(table_->id());
+  add_table.set_table_name(l->data().name());
+  add_table.set_table_type(l->data().table_type());
+  add_table.mutable_schema()->CopyFrom(l->data().schema());
+  add_table.set_schema_version(l->data().pb.version());
+  add_table.mutable_partition_schema()->CopyFrom(l->data().pb.partition_schema());
 
-  ts_admin_proxy_->CopartitionTableAsync(req, &resp_, &rpc_, BindRpcCallback());
+  l->Unlock();
+
+  ts_admin_proxy_->AlterSchemaAsync(req, &resp_, &rpc_, BindRpcCallback());
   VLOG(1) << "Send copartition table request to " << permanent_uuid()
           << " (attempt " << attempt << "):\n"
           << req.DebugString();
   return true;
 }
 
-// TODO(sagnik): modify this to handle the AsyncCopartition Response and retry fail as necessary.
 void AsyncCopartitionTable::HandleResponse(int attempt) {
-  LOG(INFO) << "master can't handle server responses yet";
+  if (resp_.has_error()) {
+    Status status = StatusFromPB(resp_.error().status());
+
+    // Do not retry on a fatal error
+    if (resp_.error().code() == TabletServerErrorPB::TABLET_NOT_FOUND) {
+      LOG(WARNING) << "TS " << permanent_uuid() << ": copartition failed for tablet "
+                   << tablet_->ToString() << " no further retry: " << status.ToString();
+      TransitionToTerminalState(MonitoredTaskState::kRunning, MonitoredTaskState::kComplete);
+    } else {
+      LOG(WARNING) << "TS " << permanent_uuid() << ": copartition failed for tablet "
+                   << tablet_->ToString() << ": " << status.ToString();
+    }
+  } else {
+    TransitionToTerminalState(MonitoredTaskState::kRunning, MonitoredTaskState::kComplete);
+    VLOG(1) << "TS " << permanent_uuid() << ": copartition complete on tablet "
+            << tablet_->ToString();
+  }
+
+  server::UpdateClock(resp_, master_->clock());
 }
 
 // ============================================================================
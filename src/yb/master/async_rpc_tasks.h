@@ -265,6 +265,34 @@ class AsyncCreateReplica : public RetrySpecificTSRpcTask {
   tserver::CreateTabletResponsePB resp_;
 };
 
+// Fire off one async CreateTablets for several tablets of the same table, all hosted by the same
+// tablet server. Retries resend only the tablets that failed.
+// Has the same requirements as AsyncCreateReplica for every tablet.
+class AsyncCreateReplicas : public RetrySpecificTSRpcTask {
+ public:
+  AsyncCreateReplicas(Master *master,
+                      ThreadPool *callback_pool,
+                      const std::string& permanent_uuid,
+                      const std::vector<scoped_refptr<TabletInfo>>& tablets);
+
+  Type type() const override { return ASYNC_CREATE_REPLICA; }
+
+  std::string type_name() const override { return "Create Tablets"; }
+
+  std::string description() const override;
+
+ protected:
+  // The first tablet that is not created yet.
+  TabletId tablet_id() const override;
+
+  void HandleResponse(int attempt) override;
+  bool SendRequest(int attempt) override;
+
+ private:
+  tserver::CreateTabletsRequestPB req_;
+  tserver::CreateTabletsResponsePB resp_;
+};
+
 // Send a DeleteTablet() RPC request.
 class AsyncDeleteReplica : public RetrySpecificTSRpcTask {
  public:
@@ -334,6 +362,10 @@ class AsyncAlterTable : public RetryingTSRpcTask {
   tserver::ChangeMetadataResponsePB resp_;
 };
 
+// Send the "Alter Table" that adds a copartitioned or colocated table to the leader replica of an
+// existing tablet.
+// Keeps retrying until we get an "ok" response, which is also sent when the table was added by a
+// previous attempt.
 class AsyncCopartitionTable : public RetryingTSRpcTask {
  public:
   AsyncCopartitionTable(Master *master,
@@ -357,7 +389,7 @@ class AsyncCopartitionTable : public RetryingTSRpcTask {
 
   scoped_refptr<TabletInfo> tablet_;
   scoped_refptr<TableInfo> table_;
-  tserver::CopartitionTableResponsePB resp_;
+  tserver::ChangeMetadataResponsePB resp_;
 };
 
 // Send a Truncate() RPC request.
@@ -130,6 +130,22 @@ TEST(TestLoadBalancerCommunity, TestLoadBalancerAlgorithm) {
   lb->TestAlgorithm();
 }
 
+// Tablet servers with the same load should be ordered by the reads and writes they reported.
+TEST(TestCatalogManager, TestLoadOrderByThroughput) {
+  std::shared_ptr<TSDescriptor> ts0 = SetupTS("0000", "a");
+  std::shared_ptr<TSDescriptor> ts1 = SetupTS("1111", "a");
+  std::shared_ptr<TSDescriptor> ts2 = SetupTS("2222", "a");
+  ts0->set_read_ops_per_sec(100);
+  ts2->set_write_ops_per_sec(10);
+
+  ClusterLoadState state;
+  for (const auto& ts : {ts0, ts1, ts2}) {
+    state.UpdateTabletServer(ts);
+  }
+  state.SortLoad();
+  ASSERT_EQ((vector<TabletServerId>{"1111", "2222", "0000"}), state.sorted_load_);
+}
+
 TEST(TestCatalogManager, TestLoadCountMultiAZ) {
   std::shared_ptr<TSDescriptor> ts0 = SetupTS("0000", "a");
   std::shared_ptr<TSDescriptor> ts1 = SetupTS("1111", "b");
@@ -77,13 +77,16 @@ void SetupClusterConfig(vector<string> azs, ReplicationInfoPB* replication_info)
 
 void NewReplica(
     TSDescriptor* ts_desc, tablet::TabletStatePB state, consensus::RaftPeerPB::Role role,
-    TabletReplica* replica) {
+    TabletReplica* replica,
+    consensus::RaftPeerPB::MemberType member_type = consensus::RaftPeerPB::VOTER) {
   replica->ts_desc = ts_desc;
   replica->state = state;
   replica->role = role;
+  replica->member_type = member_type;
 }
 
-std::shared_ptr<TSDescriptor> SetupTS(const string& uuid, const string& az) {
+std::shared_ptr<TSDescriptor> SetupTS(const string& uuid, const string& az,
+                                      const string& placement_uuid = "") {
   NodeInstancePB node;
   node.set_permanent_uuid(uuid);
 
@@ -96,6 +99,9 @@ std::shared_ptr<TSDescriptor> SetupTS(const string& uuid, const string& az) {
   ci->set_placement_cloud(default_cloud);
   ci->set_placement_region(default_region);
   ci->set_placement_zone(az);
+  if (!placement_uuid.empty()) {
+    reg.mutable_common()->set_placement_uuid(placement_uuid);
+  }
 
   std::shared_ptr<TSDescriptor> ts(new YB_EDITION_NS_PREFIX TSDescriptor(node.permanent_uuid()));
   CHECK_OK(ts->Register(node, reg, CloudInfoPB(), nullptr));
@@ -179,6 +185,9 @@ class TestLoadBalancerBase {
 
     PrepareTestState(ts_descs_multi_az);
     TestLeaderOverReplication();
+
+    PrepareTestState(ts_descs_multi_az);
+    TestReadReplicas();
   }
 
  protected:
@@ -375,6 +384,51 @@ class TestLoadBalancerBase {
     TestRemoveLoad(tablets_[0]->tablet_id(), "");
   }
 
+  void TestReadReplicas() {
+    LOG(INFO) << "Testing observers placed in a read replica cluster";
+    const string kReadReplicaUuid = "read_replica";
+    replication_info_.mutable_live_replicas()->set_num_replicas(kNumReplicas);
+    auto* read_replica = replication_info_.add_read_replicas();
+    read_replica->set_placement_uuid(kReadReplicaUuid);
+    read_replica->set_num_replicas(1);
+
+    ts_descs_.push_back(SetupTS("3333", "a", kReadReplicaUuid));
+    const auto read_replica_ts = ts_descs_[3]->permanent_uuid();
+    Options* options = cb_->state_->options_;
+
+    // The read replica pass only sees its own tablet server, and adds an observer of each tablet
+    // there.
+    options->type = ReplicaType::kReadOnly;
+    options->placement_uuid = kReadReplicaUuid;
+    ResetState();
+    ASSERT_OK(AnalyzeTablets());
+    ASSERT_EQ(consensus::RaftPeerPB::PRE_OBSERVER, cb_->GetDefaultMemberType());
+    string placeholder;
+    for (const auto& tablet : tablets_) {
+      TestAddLoad(tablet->tablet_id(), placeholder, read_replica_ts);
+    }
+    ASSERT_FALSE(ASSERT_RESULT(HandleAddReplicas(&placeholder, &placeholder, &placeholder)));
+    ASSERT_FALSE(ASSERT_RESULT(cb_->HandleRemoveReplicas(&placeholder, &placeholder)));
+
+    // Once the observers run, neither pass has anything to do: the observers do not count as
+    // extra voters, and the live pass does not place voters on the read replica tablet server.
+    for (const auto& tablet : tablets_) {
+      AddRunningReplica(tablet.get(), ts_descs_[3], false /* is_live */);
+    }
+    ResetState();
+    ASSERT_OK(AnalyzeTablets());
+    ASSERT_FALSE(ASSERT_RESULT(HandleAddReplicas(&placeholder, &placeholder, &placeholder)));
+
+    options->type = ReplicaType::kLive;
+    options->placement_uuid = "";
+    ResetState();
+    ASSERT_OK(AnalyzeTablets());
+    ASSERT_EQ(consensus::RaftPeerPB::PRE_VOTER, cb_->GetDefaultMemberType());
+    ASSERT_EQ(0, cb_->state_->per_ts_meta_.count(read_replica_ts));
+    ASSERT_EQ(0, cb_->get_total_over_replication());
+    ASSERT_FALSE(ASSERT_RESULT(HandleAddReplicas(&placeholder, &placeholder, &placeholder)));
+  }
+
   void TestWithMissingPlacement() {
     LOG(INFO) << "Testing with tablet servers missing placement information";
     // Setup cluster level placement to multiple AZs.
@@ -859,7 +913,8 @@ class TestLoadBalancerBase {
 
     TabletReplica replica;
     NewReplica(ts_desc.get(), tablet::TabletStatePB::RUNNING,
-               consensus::RaftPeerPB::FOLLOWER, &replica);
+               consensus::RaftPeerPB::FOLLOWER, &replica,
+               is_live ? consensus::RaftPeerPB::VOTER : consensus::RaftPeerPB::OBSERVER);
     InsertOrDie(&replicas, ts_desc->permanent_uuid(), replica);
     tablet->SetReplicaLocations(replicas);
   }
@@ -56,6 +56,7 @@
 #include <algorithm>
 #include <bitset>
 #include <functional>
+#include <map>
 #include <mutex>
 #include <set>
 #include <unordered_map>
@@ -80,6 +81,7 @@
 #include "yb/gutil/strings/escaping.h"
 #include "yb/gutil/strings/join.h"
 #include "yb/gutil/strings/substitute.h"
+#include "yb/gutil/strings/util.h"
 #include "yb/gutil/sysinfo.h"
 #include "yb/gutil/walltime.h"
 #include "yb/master/catalog_manager_util.h"
@@ -118,6 +120,7 @@
 #include "yb/yql/redis/redisserver/redis_constants.h"
 #include "yb/tserver/tserver_admin.proxy.h"
 
+#include "yb/util/cache_metrics.h"
 #include "yb/util/crypt.h"
 #include "yb/util/debug/trace_event.h"
 #include "yb/util/flag_tags.h"
@@ -167,6 +170,13 @@ DEFINE_int32(max_create_tablets_per_ts, 50,
              "The number of tablets per TS that can be requested for a new table.");
 TAG_FLAG(max_create_tablets_per_ts, advanced);
 
+DEFINE_int32(max_tablets_per_create_tablets_rpc, 32,
+             "Maximal number of tablets of a table that are created on a TS with one CreateTablets "
+             "RPC. Values below 2 send a CreateTablet RPC per tablet, which is needed while tablet "
+             "servers without CreateTablets are still running.");
+TAG_FLAG(max_tablets_per_create_tablets_rpc, advanced);
+TAG_FLAG(max_tablets_per_create_tablets_rpc, runtime);
+
 DEFINE_int32(master_failover_catchup_timeout_ms, 30 * 1000,  // 30 sec
              "Amount of time to give a newly-elected leader master to load"
              " the previous master's metadata and become active. If this time"
@@ -191,6 +201,12 @@ METRIC_DEFINE_gauge_uint32(cluster, num_tablet_servers_live,
                            "in the time interval defined by the gflag "
                            "FLAGS_tserver_unresponsive_timeout_ms.");
 
+METRIC_DEFINE_histogram(cluster, tablet_report_processing_time,
+                        "Tablet Report Processing Time", yb::MetricUnit::kMicroseconds,
+                        "Microseconds spent by the master processing the tablet reports sent by "
+                        "tservers with their heartbeats.",
+                        60000000LU, 2);
+
 DEFINE_test_flag(uint64, inject_latency_during_remote_bootstrap_secs, 0,
                  "Number of seconds to sleep during a remote bootstrap.");
 
@@ -215,6 +231,12 @@ DEFINE_bool(
     "This cuts down test logs significantly.");
 TAG_FLAG(hide_pg_catalog_table_creation_logs, hidden);
 
+DEFINE_uint64(tablet_split_size_threshold_bytes, 0,
+    "Size of SST files of a tablet above which it becomes a split candidate. 0 to disable.");
+
+DEFINE_double(tablet_split_write_ops_per_sec_threshold, 0,
+    "Write ops per second of a tablet above which it becomes a split candidate. 0 to disable.");
+
 DEFINE_test_flag(int32, simulate_slow_table_create_secs, 0,
     "Simulates a slow table creation by sleeping after the table has been added to memory.");
 
@@ -392,6 +414,10 @@ class TabletLoader : public Visitor<PersistentTabletInfo> {
       }
     }
 
+    if (metadata.colocated() && first_table != nullptr && !l->mutable_data()->is_deleted()) {
+      catalog_manager_->colocated_tablets_map_[first_table->namespace_id()] = tablet;
+    }
+
     l->Commit();
 
     // TODO(KUDU-1070): if we see a running tablet under a deleted table,
@@ -748,6 +774,14 @@ std::string RequestorString(RpcContext* rpc) {
   }
 }
 
+// The parent table of a colocated namespace is named after the namespace, and is not listed.
+const char* const kColocatedParentTableIdSuffix = ".colocated.parent.uuid";
+const char* const kColocatedParentTableNameSuffix = ".colocated.parent.tablename";
+
+bool IsColocatedParentTableId(const TableId& table_id) {
+  return HasSuffixString(table_id, kColocatedParentTableIdSuffix);
+}
+
 }  // anonymous namespace
 
 CatalogManager::CatalogManager(Master* master)
@@ -784,6 +818,8 @@ Status CatalogManager::Init(bool is_first_run) {
   // Initialize the metrics emitted by the catalog manager.
   metric_num_tablet_servers_live_ =
     METRIC_num_tablet_servers_live.Instantiate(master_->metric_entity_cluster(), 0);
+  metric_tablet_report_processing_time_ =
+    METRIC_tablet_report_processing_time.Instantiate(master_->metric_entity_cluster());
 
   RETURN_NOT_OK_PREPEND(InitSysCatalogAsync(is_first_run),
                         "Failed to initialize sys tables async");
@@ -942,6 +978,7 @@ Status CatalogManager::RunLoaders() {
   // Clear the namespace mappings.
   namespace_ids_map_.clear();
   namespace_names_map_.clear();
+  colocated_tablets_map_.clear();
 
   // Clear the type mappings.
   udtype_ids_map_.clear();
@@ -1612,6 +1649,15 @@ Status CatalogManager::CreateIndexInfo(const TableId& indexed_table_id,
     auto* col = index_info->add_columns();
     col->set_column_id(index_schema.column_id(i));
     col->set_indexed_column_id(indexed_schema.column_id(indexed_col_idx));
+    const auto& json_ops = index_schema.column(i).json_ops();
+    if (!json_ops.empty()) {
+      col->mutable_json_ops()->set_column_id(col->indexed_column_id());
+      for (const auto& json_op : json_ops) {
+        auto* json_op_pb = col->mutable_json_ops()->add_json_operations();
+        json_op_pb->set_json_operator(json_op.first);
+        *json_op_pb->mutable_operand()->mutable_value() = json_op.second;
+      }
+    }
   }
   index_info->set_hash_column_count(index_schema.num_hash_key_columns());
   index_info->set_range_column_count(index_schema.num_range_key_columns());
@@ -1658,31 +1704,57 @@ Status CatalogManager::CreateCopartitionedTable(const CreateTableRequestPB req,
                                                 rpc::RpcContext* rpc,
                                                 Schema schema,
                                                 NamespaceId namespace_id) {
-  scoped_refptr<TableInfo> parent_table_info;
-  Status s;
-  const char* const object_type = "table";
-  PartitionSchema partition_schema;
-  std::vector<Partition> partitions;
-
   std::lock_guard<LockType> l(lock_);
   TRACE("Acquired catalog manager lock");
-  parent_table_info = FindPtrOrNull(table_ids_map_,
-                                    schema.table_properties().CopartitionTableId());
+  scoped_refptr<TableInfo> parent_table_info = FindPtrOrNull(
+      table_ids_map_, schema.table_properties().CopartitionTableId());
   if (parent_table_info == nullptr) {
-    s = STATUS(NotFound, "The table does not exist",
-               schema.table_properties().CopartitionTableId());
+    Status s = STATUS(NotFound, "The table does not exist",
+                      schema.table_properties().CopartitionTableId());
     return SetupError(resp->mutable_error(), MasterErrorPB::TABLE_NOT_FOUND, s);
   }
 
+  TabletInfos tablets;
+  parent_table_info->GetAllTablets(&tablets);
+  return AddTableToExistingTabletsUnlocked(req, resp, rpc, schema, PartitionSchema(),
+                                           namespace_id, tablets, false /* colocated */);
+}
+
+Status CatalogManager::CreateColocatedTable(const CreateTableRequestPB& req,
+                                            CreateTableResponsePB* resp,
+                                            rpc::RpcContext* rpc,
+                                            const Schema& schema,
+                                            const PartitionSchema& partition_schema,
+                                            const scoped_refptr<TabletInfo>& colocated_tablet) {
+  std::lock_guard<LockType> l(lock_);
+  TRACE("Acquired catalog manager lock");
+  return AddTableToExistingTabletsUnlocked(req, resp, rpc, schema, partition_schema,
+                                           colocated_tablet->table()->namespace_id(),
+                                           {colocated_tablet}, true /* colocated */);
+}
+
+Status CatalogManager::AddTableToExistingTabletsUnlocked(const CreateTableRequestPB& req,
+                                                         CreateTableResponsePB* resp,
+                                                         rpc::RpcContext* rpc,
+                                                         const Schema& schema,
+                                                         const PartitionSchema& partition_schema,
+                                                         const NamespaceId& namespace_id,
+                                                         const TabletInfos& scoped_ref_tablets,
+                                                         bool colocated) {
+  DCHECK(lock_.is_locked()) << "We don't have the catalog manager lock!";
+  Status s;
+  const char* const object_type = req.indexed_table_id().empty() ? "table" : "index";
+  std::vector<Partition> partitions;
+
   scoped_refptr<TableInfo> this_table_info;
   std::vector<TabletInfo *> tablets;
-  TabletInfos scoped_ref_tablets;
   // Verify that the table does not exist.
   this_table_info = FindPtrOrNull(table_names_map_, {namespace_id, req.name()});
 
   if (this_table_info != nullptr) {
     s = STATUS(AlreadyPresent, Substitute("Target $0 already exists", object_type),
                this_table_info->id());
+    resp->set_table_id(this_table_info->id());
     return SetupError(resp->mutable_error(), MasterErrorPB::TABLE_ALREADY_PRESENT, s);
   }
 
@@ -1698,7 +1770,6 @@ Status CatalogManager::CreateCopartitionedTable(const CreateTableRequestPB req,
   // It will get committed at the end of this function.
   // Sanity check: the table should be in "preparing" state.
   CHECK_EQ(SysTablesEntryPB::PREPARING, this_table_info->metadata().dirty().pb.state());
-  parent_table_info->GetAllTablets(&scoped_ref_tablets);
   for (auto tablet : scoped_ref_tablets) {
     tablets.push_back(tablet.get());
     tablet->mutable_metadata()->StartMutation();
@@ -1716,6 +1787,7 @@ Status CatalogManager::CreateCopartitionedTable(const CreateTableRequestPB req,
   // Update the on-disk table state to "running".
   this_table_info->AddTablets(tablets);
   this_table_info->mutable_metadata()->mutable_dirty()->pb.set_state(SysTablesEntryPB::RUNNING);
+  this_table_info->mutable_metadata()->mutable_dirty()->pb.set_colocated(colocated);
   s = sys_catalog_->AddItem(this_table_info.get(), leader_ready_term_);
   if (PREDICT_FALSE(!s.ok())) {
     return AbortTableCreation(this_table_info.get(), tablets, s.CloneAndPrepend(
@@ -1757,6 +1829,12 @@ CHECKED_STATUS ValidateCreateTableSchema(const Schema& schema, CreateTableRespon
                         STATUS(InvalidArgument, "Invalid datatype for primary key column"));
     }
   }
+  if (schema.table_properties().block_cache_priority_class() >= kNumCachePriorityClasses) {
+    return SetupError(resp->mutable_error(), MasterErrorPB::INVALID_SCHEMA,
+                      STATUS_FORMAT(InvalidArgument,
+                                    "Block cache priority class must be less than $0",
+                                    kNumCachePriorityClasses));
+  }
   return Status::OK();
 }
 
@@ -2045,7 +2123,8 @@ Status CatalogManager::CreateTable(const CreateTableRequestPB* orig_req,
     replication_info = l->data().pb.replication_info();
   }
   // Calculate number of tablets to be used.
-  int num_tablets = req.num_tablets();
+  const bool is_colocated_parent = IsColocatedParentTableId(req.table_id());
+  int num_tablets = is_colocated_parent ? 1 : req.num_tablets();
   if (num_tablets <= 0) {
     // Use default as client could have gotten the value before any tserver had heartbeated
     // to (a new) master leader.
@@ -2079,6 +2158,22 @@ Status CatalogManager::CreateTable(const CreateTableRequestPB* orig_req,
     }
   }
 
+  // The tables of a colocated namespace are put in the tablet of its parent table. The YCQL
+  // indexes are left out, since the index info of their indexed tables is not set up there.
+  if (ns->colocated() && !is_colocated_parent &&
+      (req.table_type() == PGSQL_TABLE_TYPE || !req.has_indexed_table_id())) {
+    scoped_refptr<TabletInfo> colocated_tablet;
+    {
+      boost::shared_lock<LockType> l(lock_);
+      colocated_tablet = FindPtrOrNull(colocated_tablets_map_, namespace_id);
+    }
+    if (colocated_tablet == nullptr) {
+      s = STATUS(IllegalState, "Colocated namespace has no shared tablet", ns->name());
+      return SetupError(resp->mutable_error(), MasterErrorPB::UNKNOWN_ERROR, s);
+    }
+    return CreateColocatedTable(req, resp, rpc, schema, partition_schema, colocated_tablet);
+  }
+
   // Validate the table placement rules are a subset of the cluster ones.
   s = ValidateTableReplicationInfo(req.replication_info());
   if (PREDICT_FALSE(!s.ok())) {
@@ -2138,6 +2233,11 @@ Status CatalogManager::CreateTable(const CreateTableRequestPB* orig_req,
                                       namespace_id, partitions,
                                       create_index_info ? &index_info : nullptr,
                                       &tablets, resp, &table));
+    if (is_colocated_parent) {
+      for (TabletInfo* tablet : tablets) {
+        tablet->mutable_metadata()->mutable_dirty()->pb.set_colocated(true);
+      }
+    }
   }
   if (PREDICT_FALSE(FLAGS_simulate_slow_table_create_secs > 0)) {
     LOG(INFO) << "Simulating slow table creation";
@@ -2154,20 +2254,14 @@ Status CatalogManager::CreateTable(const CreateTableRequestPB* orig_req,
     CHECK_EQ(SysTabletsEntryPB::PREPARING, tablet->metadata().dirty().pb.state());
   }
 
-  // Write Tablets to sys-tablets (in "preparing" state).
-  s = sys_catalog_->AddItems(tablets, leader_ready_term_);
-  if (PREDICT_FALSE(!s.ok())) {
-    return AbortTableCreation(table.get(), tablets,
-                              s.CloneAndPrepend(
-                                  Substitute("An error occurred while inserting to sys-tablets: $0",
-                                             s.ToString())),
-                              resp);
-  }
-  TRACE("Wrote tablets to system table");
+  // Place the tablets right away, so that they are persisted in "creating" state and their
+  // CreateTablet() requests are sent without waiting for the background task.
+  const bool tablets_placed = PlaceNewTablets(replication_info, tablets);
+  TRACE("Placed tablets");
 
-  // Update the on-disk table state to "running".
+  // Write the tablets and the table (in "running" state) to sys-tablets with one write.
   table->mutable_metadata()->mutable_dirty()->pb.set_state(SysTablesEntryPB::RUNNING);
-  s = sys_catalog_->AddItem(table.get(), leader_ready_term_);
+  s = sys_catalog_->AddItems(tablets, vector<TableInfo*>{table.get()}, leader_ready_term_);
   if (PREDICT_FALSE(!s.ok())) {
     return AbortTableCreation(table.get(), tablets,
                               s.CloneAndPrepend(
@@ -2175,7 +2269,7 @@ Status CatalogManager::CreateTable(const CreateTableRequestPB* orig_req,
                                              s.ToString())),
                               resp);
   }
-  TRACE("Wrote table to system table");
+  TRACE("Wrote table and tablets to system table");
 
   // For index table, insert index info in the indexed table.
   if (req.has_indexed_table_id() && create_index_info) {
@@ -2192,10 +2286,20 @@ Status CatalogManager::CreateTable(const CreateTableRequestPB* orig_req,
   // Commit the in-memory state.
   table->mutable_metadata()->CommitMutation();
 
+  if (tablets_placed) {
+    // The requests are built from the committed table and the dirty tablets.
+    SendCreateTabletRequests(tablets);
+  }
+
   for (TabletInfo *tablet : tablets) {
     tablet->mutable_metadata()->CommitMutation();
   }
 
+  if (is_colocated_parent) {
+    std::lock_guard<LockType> l(lock_);
+    colocated_tablets_map_[namespace_id] = tablets.front();
+  }
+
   if (req.has_creator_role_name()) {
     const NamespaceName& keyspace_name = req.namespace_().name();
     const TableName& table_name = req.name();
@@ -2388,6 +2492,26 @@ Status CatalogManager::CreateTransactionsStatusTableIfNeeded(rpc::RpcContext *rp
   return Status::OK();
 }
 
+Status CatalogManager::CreateColocatedParentTable(const scoped_refptr<NamespaceInfo>& ns,
+                                                  rpc::RpcContext* rpc) {
+  // Set up a CreateTable request internally.
+  CreateTableRequestPB req;
+  CreateTableResponsePB resp;
+  req.set_name(ns->id() + kColocatedParentTableNameSuffix);
+  req.set_table_id(ns->id() + kColocatedParentTableIdSuffix);
+  req.mutable_namespace_()->set_id(ns->id());
+  req.set_table_type(
+      ns->database_type() == YQL_DATABASE_PGSQL ? PGSQL_TABLE_TYPE : YQL_TABLE_TYPE);
+
+  // The parent table only owns the shared tablet and has no rows of its own. The tablet is
+  // transactional, so that transactional tables can be put in it.
+  ColumnSchema hash("parent_key", BINARY, /* is_nullable */ false, /* is_hash_key */ true);
+  ColumnSchemaToPB(hash, req.mutable_schema()->mutable_columns()->Add());
+  req.mutable_schema()->mutable_table_properties()->set_is_transactional(true);
+
+  return CreateTable(&req, &resp, rpc);
+}
+
 Status CatalogManager::IsCreateTableDone(const IsCreateTableDoneRequestPB* req,
                                          IsCreateTableDoneResponsePB* resp) {
   RETURN_NOT_OK(CheckOnline());
@@ -2941,6 +3065,17 @@ Status CatalogManager::DeleteTableInMemory(const TableIdentifierPB& table_identi
     }
   }
 
+  if (l->data().colocated()) {
+    // The shared tablet is left to the other tables of the namespace, so the table has no tablets
+    // to wait for.
+    s = RemoveTableFromColocatedTablet(table);
+    if (!s.ok()) {
+      s = s.CloneAndPrepend("An error occurred while removing table from colocated tablet");
+      LOG(WARNING) << s.ToString();
+      return CheckIfNoLongerLeaderAndSetupError(s, resp);
+    }
+  }
+
   table->AbortTasks();
   scoped_refptr<DeletedTableInfo> deleted_table(new DeletedTableInfo(table.get()));
 
@@ -2975,6 +3110,58 @@ Status CatalogManager::DeleteTableInMemory(const TableIdentifierPB& table_identi
   return Status::OK();
 }
 
+Status CatalogManager::RemoveTableFromColocatedTablet(const scoped_refptr<TableInfo>& table) {
+  TabletInfos tablets;
+  table->GetAllTablets(&tablets);
+  for (const auto& tablet : tablets) {
+    auto tablet_lock = tablet->LockForWrite();
+    auto* table_ids = tablet_lock->mutable_data()->pb.mutable_table_ids();
+    for (int i = 0; i < table_ids->size(); ++i) {
+      if (table_ids->Get(i) == table->id()) {
+        table_ids->DeleteSubrange(i, 1);
+        break;
+      }
+    }
+    const std::string partition_key_start =
+        tablet_lock->data().pb.partition().partition_key_start();
+    RETURN_NOT_OK(sys_catalog_->UpdateItem(tablet.get(), leader_ready_term_));
+    tablet_lock->Commit();
+    table->RemoveTablet(partition_key_start);
+  }
+  return Status::OK();
+}
+
+Status CatalogManager::DeleteColocatedParentTable(const NamespaceId& namespace_id,
+                                                  rpc::RpcContext* rpc) {
+  TableIdentifierPB parent_identifier;
+  parent_identifier.set_table_id(namespace_id + kColocatedParentTableIdSuffix);
+  {
+    boost::shared_lock<LockType> l(lock_);
+    if (FindPtrOrNull(table_ids_map_, parent_identifier.table_id()) == nullptr) {
+      return Status::OK();
+    }
+  }
+
+  vector<scoped_refptr<TableInfo>> tables;
+  vector<scoped_refptr<DeletedTableInfo>> deleted_tables;
+  vector<unique_ptr<TableInfo::lock_type>> table_locks;
+  DeleteTableResponsePB resp;
+  RETURN_NOT_OK(DeleteTableInMemory(parent_identifier, false /* is_index_table */,
+                                    false /* update_indexed_table */,
+                                    &tables, &deleted_tables, &table_locks, &resp, rpc));
+  for (auto& table_lock : table_locks) {
+    table_lock->Commit();
+  }
+  for (int i = 0; i < deleted_tables.size(); i++) {
+    MarkTableDeletedIfNoTablets(deleted_tables[i], tables[i].get());
+    DeleteTabletsAndSendRequests(tables[i]);
+  }
+
+  std::lock_guard<LockType> l(lock_);
+  colocated_tablets_map_.erase(namespace_id);
+  return Status::OK();
+}
+
 void CatalogManager::MarkTableDeletedIfNoTablets(scoped_refptr<DeletedTableInfo> deleted_table,
                                                  TableInfo* table_info) {
   DCHECK_NOTNULL(deleted_table.get());
@@ -3136,7 +3323,29 @@ CHECKED_STATUS ApplyAlterSteps(const SysTablesEntryPB& current_pb,
         break;
       }
 
-        // TODO: EDIT_COLUMN.
+      case AlterTableRequestPB::ALTER_COLUMN: {
+        if (!step.has_alter_column()) {
+          return STATUS(InvalidArgument, "ALTER_COLUMN missing column info");
+        }
+
+        // The index tables store their own copy of the column and would not see the new type.
+        const string& name = step.alter_column().name();
+        const int idx = cur_schema.find_column(name);
+        if (idx != Schema::kColumnNotFound) {
+          const ColumnId col_id = cur_schema.column_id(idx);
+          for (const IndexInfoPB& index : current_pb.indexes()) {
+            for (const auto& index_col : index.columns()) {
+              if (ColumnId(index_col.indexed_column_id()) == col_id) {
+                return STATUS(InvalidArgument, "cannot alter the type of an indexed column", name);
+              }
+            }
+          }
+        }
+
+        RETURN_NOT_OK(builder.AlterColumnType(
+            name, QLType::FromQLTypePB(step.alter_column().type())));
+        break;
+      }
 
       default: {
         return STATUS(InvalidArgument,
@@ -3422,6 +3631,10 @@ Status CatalogManager::ListTables(const ListTablesRequestPB* req,
       continue; // Skip tables from other namespaces.
     }
 
+    if (IsColocatedParentTableId(entry.first)) {
+      continue; // Skip the internal table that owns the tablet of a colocated namespace.
+    }
+
     if (req->has_name_filter()) {
       size_t found = ltm->data().name().find(req->name_filter());
       if (found == string::npos) {
@@ -3646,7 +3859,13 @@ Status CatalogManager::GetPermissions(const GetPermissionsRequestPB* req,
                                       GetPermissionsResponsePB* resp,
                                       rpc::RpcContext* rpc) {
   std::shared_ptr<GetPermissionsResponsePB> permissions_cache;
+  // Every CQL proxy polls permissions, so the common case of a built cache only takes the lock for
+  // reading. Create another reference so that the cache doesn't go away while we are using it.
   {
+    boost::shared_lock<LockType> l(lock_);
+    permissions_cache = permissions_cache_;
+  }
+  if (!permissions_cache) {
     std::lock_guard<LockType> l_big(lock_);
     if (!permissions_cache_) {
       BuildRecursiveRolesUnlocked();
@@ -3654,7 +3873,6 @@ Status CatalogManager::GetPermissions(const GetPermissionsRequestPB* req,
         DFATAL_OR_RETURN_NOT_OK(STATUS(IllegalState, "Unable to build permissions cache"));
       }
     }
-    // Create another reference so that the cache doesn't go away while we are using it.
     permissions_cache = permissions_cache_;
   }
 
@@ -3751,6 +3969,55 @@ void CatalogManager::NotifyTabletDeleteFinished(const TabletServerId& tserver_uu
   CleanUpDeletedTables();
 }
 
+void CatalogManager::ProcessTabletLeaderMetrics(
+    const TSDescriptor& ts_desc, const TServerMetricsPB& metrics) {
+  const auto size_threshold = FLAGS_tablet_split_size_threshold_bytes;
+  const auto write_ops_threshold = FLAGS_tablet_split_write_ops_per_sec_threshold;
+  if (size_threshold == 0 && write_ops_threshold <= 0) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(split_candidates_mutex_);
+  for (const auto& tablet_metrics : metrics.tablet_leader_metrics()) {
+    const bool over_size = size_threshold != 0 &&
+        static_cast<uint64_t>(tablet_metrics.sst_file_size()) > size_threshold;
+    const bool over_write_ops = write_ops_threshold > 0 &&
+        tablet_metrics.write_ops_per_sec() > write_ops_threshold;
+    if (!over_size && !over_write_ops) {
+      split_candidates_.erase(tablet_metrics.tablet_id());
+      continue;
+    }
+    auto emplace_result = split_candidates_.emplace(
+        tablet_metrics.tablet_id(), TabletSplitCandidate());
+    auto& candidate = emplace_result.first->second;
+    candidate.tablet_id = tablet_metrics.tablet_id();
+    candidate.sst_file_size = tablet_metrics.sst_file_size();
+    candidate.write_ops_per_sec = tablet_metrics.write_ops_per_sec();
+    LOG_IF(INFO, emplace_result.second)
+        << "Tablet " << candidate.tablet_id << " led by " << ts_desc.permanent_uuid()
+        << " is a split candidate, SST files size: " << candidate.sst_file_size
+        << ", write ops per sec: " << candidate.write_ops_per_sec;
+  }
+}
+
+std::vector<CatalogManager::TabletSplitCandidate>
+    CatalogManager::GetTabletSplitCandidates() const {
+  std::vector<TabletSplitCandidate> result;
+  {
+    std::lock_guard<std::mutex> lock(split_candidates_mutex_);
+    result.reserve(split_candidates_.size());
+    for (const auto& entry : split_candidates_) {
+      result.push_back(entry.second);
+    }
+  }
+  // Skip tablets that were deleted since they were reported.
+  boost::shared_lock<LockType> l(lock_);
+  result.erase(std::remove_if(result.begin(), result.end(), [this](const auto& candidate) {
+    return tablet_map_.count(candidate.tablet_id) == 0;
+  }), result.end());
+  return result;
+}
+
 Status CatalogManager::ProcessTabletReport(TSDescriptor* ts_desc,
                                            const TabletReportPB& report,
                                            TabletReportUpdatesPB *report_update,
@@ -3758,6 +4025,7 @@ Status CatalogManager::ProcessTabletReport(TSDescriptor* ts_desc,
   TRACE_EVENT2("master", "ProcessTabletReport",
                "requestor", rpc->requestor_string(),
                "num_tablets", report.updated_tablets_size());
+  ScopedLatencyMetric latency_metric(metric_tablet_report_processing_time_);
 
   if (VLOG_IS_ON(2)) {
     VLOG(2) << "Received tablet report from " << RequestorString(rpc) << "("
@@ -3775,10 +4043,22 @@ Status CatalogManager::ProcessTabletReport(TSDescriptor* ts_desc,
   // the server should have, compare vs the ones being reported, and somehow mark
   // any that have been "lost" (eg somehow the tablet metadata got corrupted or something).
 
-  for (const ReportedTabletPB& reported : report.updated_tablets()) {
+  // Look up all reported tablets at once, so that a full report of many tablets, e.g. from every
+  // tserver after a master failover, does not take the catalog lock once per tablet.
+  std::vector<scoped_refptr<TabletInfo>> tablets;
+  tablets.reserve(report.updated_tablets_size());
+  {
+    boost::shared_lock<LockType> l(lock_);
+    for (const ReportedTabletPB& reported : report.updated_tablets()) {
+      tablets.push_back(FindPtrOrNull(tablet_map_, reported.tablet_id()));
+    }
+  }
+
+  for (int i = 0; i != report.updated_tablets_size(); ++i) {
+    const ReportedTabletPB& reported = report.updated_tablets(i);
     ReportedTabletUpdatesPB *tablet_report = report_update->add_tablets();
     tablet_report->set_tablet_id(reported.tablet_id());
-    RETURN_NOT_OK_PREPEND(HandleReportedTablet(ts_desc, reported, tablet_report),
+    RETURN_NOT_OK_PREPEND(HandleReportedTablet(ts_desc, reported, tablets[i], tablet_report),
                           Substitute("Error handling $0", reported.ShortDebugString()));
   }
 
@@ -3822,14 +4102,10 @@ bool ShouldTransitionTabletToRunning(const ReportedTabletPB& report) {
 
 Status CatalogManager::HandleReportedTablet(TSDescriptor* ts_desc,
                                             const ReportedTabletPB& report,
+                                            const scoped_refptr<TabletInfo>& tablet,
                                             ReportedTabletUpdatesPB *report_updates) {
   TRACE_EVENT1("master", "HandleReportedTablet",
                "tablet_id", report.tablet_id());
-  scoped_refptr<TabletInfo> tablet;
-  {
-    boost::shared_lock<LockType> l(lock_);
-    tablet = FindPtrOrNull(tablet_map_, report.tablet_id());
-  }
   RETURN_NOT_OK_PREPEND(CheckIsLeaderAndReady(),
       Substitute("This master is no longer the leader, unable to handle report for tablet $0",
                  report.tablet_id()));
@@ -4034,15 +4310,20 @@ Status CatalogManager::HandleReportedTablet(TSDescriptor* ts_desc,
   }
 
   table_lock->Unlock();
-  // We update the tablets each time that someone reports it.
-  // This shouldn't be very frequent and should only happen when something in fact changed.
-  Status s = sys_catalog_->UpdateItem(tablet.get(), leader_ready_term_);
-  if (!s.ok()) {
-    LOG(WARNING) << "Error updating tablets: " << s.ToString() << ". Tablet report was: "
-                 << report.ShortDebugString();
-    return s;
+  // Most reports, e.g. the full reports that every tserver sends after a master failover, do not
+  // change the persistent state of the tablet. Only write to the sys catalog when they do.
+  if (tablet_lock->data().pb.SerializeAsString() !=
+          tablet->metadata().state().pb.SerializeAsString()) {
+    Status s = sys_catalog_->UpdateItem(tablet.get(), leader_ready_term_);
+    if (!s.ok()) {
+      LOG(WARNING) << "Error updating tablets: " << s.ToString() << ". Tablet report was: "
+                   << report.ShortDebugString();
+      return s;
+    }
+    tablet_lock->Commit();
+  } else {
+    tablet_lock->Unlock();
   }
-  tablet_lock->Commit();
 
   // Need to defer the AlterTable command to after we've committed the new tablet data,
   // since the tablet report may also be updating the raft config, and the Alter Table
@@ -4303,6 +4584,13 @@ Status CatalogManager::CreateNamespace(const CreateNamespaceRequestPB* req,
     if (req->has_database_type()) {
       metadata->set_database_type(req->database_type());
     }
+    if (req->colocated()) {
+      if (req->database_type() == YQL_DATABASE_REDIS) {
+        s = STATUS(InvalidArgument, "Redis namespace cannot be colocated", req->name());
+        return SetupError(resp->mutable_error(), MasterErrorPB::INVALID_REQUEST, s);
+      }
+      metadata->set_colocated(true);
+    }
 
     // For namespace created for a Postgres database, save the list of tables and indexes for
     // for the database that need to be copied.
@@ -4370,6 +4658,14 @@ Status CatalogManager::CreateNamespace(const CreateNamespaceRequestPB* req,
                                    resp));
   }
 
+  if (req->colocated()) {
+    s = CreateColocatedParentTable(ns, rpc);
+    if (!s.ok()) {
+      return SetupError(resp->mutable_error(), MasterErrorPB::UNKNOWN_ERROR, s.CloneAndPrepend(
+          "An error occurred while creating the tablet of colocated namespace"));
+    }
+  }
+
   if (req->database_type() == YQL_DATABASE_PGSQL && !pgsql_tables.empty()) {
     RETURN_NOT_OK(CopyPgsqlSysTables(ns->id(), pgsql_tables, resp, rpc));
   }
@@ -4408,6 +4704,9 @@ Status CatalogManager::DeleteNamespace(const DeleteNamespaceRequestPB* req,
     boost::shared_lock<LockType> catalog_lock(lock_);
 
     for (const TableInfoMap::value_type& entry : table_ids_map_) {
+      if (IsColocatedParentTableId(entry.first)) {
+        continue;
+      }
       auto ltm = entry.second->LockForRead();
 
       if (!ltm->data().started_deleting() && ltm->data().namespace_id() == ns->id()) {
@@ -4437,6 +4736,16 @@ Status CatalogManager::DeleteNamespace(const DeleteNamespaceRequestPB* req,
     }
   }
 
+  if (l->data().colocated()) {
+    TRACE("Deleting the parent table of the colocated namespace");
+    Status s = DeleteColocatedParentTable(ns->id(), rpc);
+    if (!s.ok()) {
+      s = s.CloneAndPrepend("An error occurred while deleting the tablet of colocated namespace");
+      LOG(WARNING) << s.ToString();
+      return CheckIfNoLongerLeaderAndSetupError(s, resp);
+    }
+  }
+
   TRACE("Updating metadata on disk");
   // Update sys-catalog.
   Status s = sys_catalog_->DeleteItem(ns.get(), leader_ready_term_);
@@ -4969,7 +5278,7 @@ Status CatalogManager::RedisConfigGet(
   DCHECK(req->has_keyword());
   resp->set_keyword(req->keyword());
   TRACE("Acquired catalog manager lock");
-  std::lock_guard<LockType> l_big(lock_);
+  boost::shared_lock<LockType> l(lock_);
   scoped_refptr<RedisConfigInfo> cfg = FindPtrOrNull(redis_config_map_, req->keyword());
   if (cfg == nullptr) {
     Status s = STATUS(NotFound, Substitute("Redis config for $0 does not exists", req->keyword()));
@@ -5962,6 +6271,12 @@ Status CatalogManager::SelectReplicasForTablet(const TSDescriptorVector& ts_desc
     replication_info = l->data().pb.replication_info();
   }
 
+  return SelectInitialReplicas(ts_descs, replication_info, tablet);
+}
+
+Status CatalogManager::SelectInitialReplicas(const TSDescriptorVector& ts_descs,
+                                             const ReplicationInfoPB& replication_info,
+                                             TabletInfo* tablet) {
   // Select the set of replicas for the tablet.
   ConsensusStatePB* cstate = tablet->mutable_metadata()->mutable_dirty()
           ->pb.mutable_committed_consensus_state();
@@ -5990,12 +6305,70 @@ Status CatalogManager::SelectReplicasForTablet(const TSDescriptorVector& ts_desc
   return Status::OK();
 }
 
+bool CatalogManager::PlaceNewTablets(const ReplicationInfoPB& replication_info,
+                                     const vector<TabletInfo*>& tablets) {
+  TSDescriptorVector ts_descs;
+  master_->ts_manager()->GetAllLiveDescriptors(&ts_descs, blacklistState.tservers_);
+  for (TabletInfo* tablet : tablets) {
+    Status s = SelectInitialReplicas(ts_descs, replication_info, tablet);
+    if (!s.ok()) {
+      LOG(INFO) << "Leaving the placement of " << tablets.size() << " new tablets to the "
+                << "background task: " << s.ToString();
+      for (TabletInfo* placed_tablet : tablets) {
+        placed_tablet->mutable_metadata()->mutable_dirty()->pb.clear_committed_consensus_state();
+      }
+      return false;
+    }
+  }
+  for (TabletInfo* tablet : tablets) {
+    tablet->mutable_metadata()->mutable_dirty()->set_state(
+        SysTabletsEntryPB::CREATING, "Sending initial creation of tablet");
+  }
+  return true;
+}
+
 Status CatalogManager::HandlePlacementUsingReplicationInfo(
     const ReplicationInfoPB& replication_info,
     const TSDescriptorVector& all_ts_descs,
     consensus::RaftConfigPB* config) {
-  return HandlePlacementUsingPlacementInfo(replication_info.live_replicas(),
-                                           all_ts_descs, RaftPeerPB::VOTER, config);
+  // Voters only go to the tablet servers of the live cluster, each read replica cluster gets
+  // observers on its own tablet servers.
+  std::unordered_map<std::string, TSDescriptorVector> read_replica_ts_descs;
+  for (const auto& read_replica : replication_info.read_replicas()) {
+    read_replica_ts_descs[read_replica.placement_uuid()];
+  }
+  const auto& live_placement_uuid = replication_info.live_replicas().placement_uuid();
+  TSDescriptorVector live_ts_descs;
+  for (const auto& ts_desc : all_ts_descs) {
+    const auto placement_uuid = ts_desc->placement_uuid();
+    auto it = read_replica_ts_descs.find(placement_uuid);
+    if (it != read_replica_ts_descs.end()) {
+      it->second.push_back(ts_desc);
+    } else if (live_placement_uuid.empty() || placement_uuid == live_placement_uuid) {
+      live_ts_descs.push_back(ts_desc);
+    }
+  }
+
+  RETURN_NOT_OK(HandlePlacementUsingPlacementInfo(replication_info.live_replicas(),
+                                                  live_ts_descs, RaftPeerPB::VOTER, config));
+
+  for (const auto& read_replica : replication_info.read_replicas()) {
+    // Observers that cannot be placed now are added later by the load balancer, so a read replica
+    // cluster that is short of tablet servers does not fail table creation.
+    consensus::RaftConfigPB observers;
+    Status s = HandlePlacementUsingPlacementInfo(
+        read_replica, read_replica_ts_descs[read_replica.placement_uuid()], RaftPeerPB::OBSERVER,
+        &observers);
+    if (!s.ok()) {
+      LOG(WARNING) << "Not placing observers in read replica cluster "
+                   << read_replica.placement_uuid() << ": " << s;
+      continue;
+    }
+    for (auto& peer : *observers.mutable_peers()) {
+      config->add_peers()->Swap(&peer);
+    }
+  }
+  return Status::OK();
 }
 
 Status CatalogManager::HandlePlacementUsingPlacementInfo(const PlacementInfoPB& placement_info,
@@ -6081,15 +6454,38 @@ Status CatalogManager::HandlePlacementUsingPlacementInfo(const PlacementInfoPB&
 }
 
 void CatalogManager::SendCreateTabletRequests(const vector<TabletInfo*>& tablets) {
+  const size_t batch_size = std::max(FLAGS_max_tablets_per_create_tablets_rpc, 1);
+  // Tablets of the same table to create on the same TS, in the order of 'tablets'.
+  std::map<std::pair<TableId, TabletServerId>, std::vector<scoped_refptr<TabletInfo>>> batches;
+  auto send_batch = [this](const TabletServerId& ts_uuid,
+                           std::vector<scoped_refptr<TabletInfo>>* batch) {
+    std::shared_ptr<RetryingTSRpcTask> task;
+    if (batch->size() == 1) {
+      task = std::make_shared<AsyncCreateReplica>(
+          master_, worker_pool_.get(), ts_uuid, batch->front());
+    } else {
+      task = std::make_shared<AsyncCreateReplicas>(master_, worker_pool_.get(), ts_uuid, *batch);
+    }
+    batch->front()->table()->AddTask(task);
+    WARN_NOT_OK(task->Run(), "Failed to send new tablet request");
+    batch->clear();
+  };
+
   for (TabletInfo *tablet : tablets) {
     const consensus::RaftConfigPB& config =
         tablet->metadata().dirty().pb.committed_consensus_state().config();
     tablet->set_last_update_time(MonoTime::Now());
     for (const RaftPeerPB& peer : config.peers()) {
-      auto task = std::make_shared<AsyncCreateReplica>(master_, worker_pool_.get(),
-          peer.permanent_uuid(), tablet);
-      tablet->table()->AddTask(task);
-      WARN_NOT_OK(task->Run(), "Failed to send new tablet request");
+      auto& batch = batches[std::make_pair(tablet->table()->id(), peer.permanent_uuid())];
+      batch.push_back(tablet);
+      if (batch.size() >= batch_size) {
+        send_batch(peer.permanent_uuid(), &batch);
+      }
+    }
+  }
+  for (auto& entry : batches) {
+    if (!entry.second.empty()) {
+      send_batch(entry.first.second, &entry.second);
     }
   }
 }
@@ -6636,6 +7032,11 @@ Status CatalogManager::SetClusterConfig(
                         "All read-only clusters must have a placement uuid specified");
       return SetupError(resp->mutable_error(), MasterErrorPB::INVALID_CLUSTER_CONFIG, s);
     }
+    if (replication_info.read_replicas(i).num_replicas() <= 0) {
+      Status s = STATUS(IllegalState,
+                        "All read-only clusters must have a positive number of replicas");
+      return SetupError(resp->mutable_error(), MasterErrorPB::INVALID_CLUSTER_CONFIG, s);
+    }
   }
 
   l->mutable_data()->pb.CopyFrom(config);
@@ -6757,7 +7158,7 @@ std::string BlacklistState::ToString() {
 
 int64_t CatalogManager::GetNumBlacklistReplicas() {
   int64_t blacklist_replicas = 0;
-  std::lock_guard <LockType> tablet_map_lock(lock_);
+  boost::shared_lock<LockType> tablet_map_lock(lock_);
   for (const TabletInfoMap::value_type& entry : tablet_map_) {
     scoped_refptr<TabletInfo> tablet = entry.second;
     auto l = tablet->LockForRead();
@@ -7271,6 +7672,11 @@ YQLDatabase NamespaceInfo::database_type() const {
                                           : YQL_DATABASE_UNDEFINED;
 }
 
+bool NamespaceInfo::colocated() const {
+  auto l = LockForRead();
+  return l->data().colocated();
+}
+
 std::string NamespaceInfo::ToString() const {
   return Substitute("$0 [id=$1]", name(), namespace_id_);
 }
@@ -327,6 +327,11 @@ struct PersistentTableInfo : public Persistent<SysTablesEntryPB, SysRowEntry::TA
     return pb.schema();
   }
 
+  // Whether the table lives in the tablet shared by the tables of a colocated namespace.
+  bool colocated() const {
+    return pb.colocated();
+  }
+
   // Helper to set the state of the tablet with a custom message.
   void set_state(SysTablesEntryPB::State state, const std::string& msg);
 };
@@ -477,6 +482,10 @@ struct PersistentNamespaceInfo : public Persistent<SysNamespaceEntryPB, SysRowEn
   YQLDatabase database_type() const {
     return pb.has_database_type() ? pb.database_type() : YQL_DATABASE_UNDEFINED;
   }
+
+  bool colocated() const {
+    return pb.colocated();
+  }
 };
 
 // The information about a namespace.
@@ -494,6 +503,9 @@ class NamespaceInfo : public RefCountedThreadSafe<NamespaceInfo>,
 
   YQLDatabase database_type() const;
 
+  // Whether the tables of the namespace share one tablet.
+  bool colocated() const;
+
   std::string ToString() const override;
 
  private:
@@ -885,6 +897,21 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
                                      TabletReportUpdatesPB *report_update,
                                      rpc::RpcContext* rpc);
 
+  // Tablet that is over a size or write ops split threshold, as reported by its leader.
+  struct TabletSplitCandidate {
+    TabletId tablet_id;
+    uint64_t sst_file_size = 0;
+    double write_ops_per_sec = 0;
+  };
+
+  // Handle the loads of tablets led by the given tablet server, reported with its metrics.
+  // Tablets over a split threshold become split candidates, and stop being ones once reported
+  // below all thresholds.
+  void ProcessTabletLeaderMetrics(const TSDescriptor& ts_desc, const TServerMetricsPB& metrics);
+
+  // Returns the current split candidates of existing tablets.
+  std::vector<TabletSplitCandidate> GetTabletSplitCandidates() const;
+
   // Create a new Namespace with the specified attributes.
   //
   // The RPC context is provided for logging/tracing purposes,
@@ -1274,6 +1301,40 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
                                           Schema schema,
                                           NamespaceId namespace_id);
 
+  // Helper for creating a table in the tablet shared by the tables of a colocated namespace.
+  CHECKED_STATUS CreateColocatedTable(const CreateTableRequestPB& req,
+                                      CreateTableResponsePB* resp,
+                                      rpc::RpcContext* rpc,
+                                      const Schema& schema,
+                                      const PartitionSchema& partition_schema,
+                                      const scoped_refptr<TabletInfo>& colocated_tablet);
+
+  // Creates the table of a new colocated namespace that owns the shared tablet. The tables of
+  // the namespace are then added to that tablet.
+  CHECKED_STATUS CreateColocatedParentTable(const scoped_refptr<NamespaceInfo>& ns,
+                                            rpc::RpcContext* rpc);
+
+  // Creates the in-memory and on-disk state of a table on the existing tablets of another table,
+  // and adds the new table to these tablets on the tablet servers. The new table takes the table
+  // id prefix of DocKeys on the tablets. Requires lock_ to be held.
+  CHECKED_STATUS AddTableToExistingTabletsUnlocked(const CreateTableRequestPB& req,
+                                                   CreateTableResponsePB* resp,
+                                                   rpc::RpcContext* rpc,
+                                                   const Schema& schema,
+                                                   const PartitionSchema& partition_schema,
+                                                   const NamespaceId& namespace_id,
+                                                   const TabletInfos& tablets,
+                                                   bool colocated);
+
+  // Detaches a colocated table that is being deleted from the shared tablet, which stays with the
+  // other tables of the namespace.
+  CHECKED_STATUS RemoveTableFromColocatedTablet(const scoped_refptr<TableInfo>& table);
+
+  // Deletes the parent table of a colocated namespace that is being deleted, together with the
+  // shared tablet.
+  CHECKED_STATUS DeleteColocatedParentTable(const NamespaceId& namespace_id,
+                                            rpc::RpcContext* rpc);
+
   // Check that local host is present in master addresses for normal master process start.
   // On error, it could imply that master_addresses is incorrectly set for shell master startup
   // or that this master host info was missed in the master addresses and it should be
@@ -1326,10 +1387,11 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
   CHECKED_STATUS BuildLocationsForTablet(const scoped_refptr<TabletInfo>& tablet,
                                          TabletLocationsPB* locs_pb);
 
-  // Handle one of the tablets in a tablet reported.
-  // Requires that the lock is already held.
+  // Handle one of the tablets in a tablet reported. 'tablet' is the reported tablet as found in
+  // tablet_map_, null if it is unknown.
   CHECKED_STATUS HandleReportedTablet(TSDescriptor* ts_desc,
                                       const ReportedTabletPB& report,
+                                      const scoped_refptr<TabletInfo>& tablet,
                                       ReportedTabletUpdatesPB *report_updates);
 
   CHECKED_STATUS ResetTabletReplicasFromReportedConfig(const ReportedTabletPB& report,
@@ -1376,6 +1438,20 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
   // This method is called by "ProcessPendingAssignments()".
   CHECKED_STATUS SelectReplicasForTablet(const TSDescriptorVector& ts_descs, TabletInfo* tablet);
 
+  // Populates the initial consensus configuration of 'tablet' with replicas selected from
+  // 'ts_descs' according to 'replication_info'.
+  CHECKED_STATUS SelectInitialReplicas(const TSDescriptorVector& ts_descs,
+                                       const ReplicationInfoPB& replication_info,
+                                       TabletInfo* tablet);
+
+  // Selects the replicas of the preparing 'tablets' of a new table and marks them as creating,
+  // so that the table and its placed tablets could be persisted with one write. Returns false,
+  // leaving the tablets preparing for the background task, if some tablet could not be placed.
+  //
+  // This method is called by "CreateTable()".
+  bool PlaceNewTablets(const ReplicationInfoPB& replication_info,
+                       const std::vector<TabletInfo*>& tablets);
+
   // Select N Replicas from the online tablet servers that have been chosen to respect the
   // placement information provided. Populate the consensus configuration object with choices and
   // also update the set of selected tablet servers, to not place several replicas on the same TS.
@@ -1591,6 +1667,9 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
   NamespaceInfoMap namespace_ids_map_;
   NamespaceInfoMap namespace_names_map_;
 
+  // Colocated tablet map: namespace-id -> the tablet shared by the tables of the namespace.
+  std::unordered_map<NamespaceId, scoped_refptr<TabletInfo>> colocated_tablets_map_;
+
   // User-Defined type maps: udtype-id -> UDTypeInfo and udtype-name -> UDTypeInfo
   UDTypeInfoMap udtype_ids_map_;
   UDTypeInfoByNameMap udtype_names_map_;
@@ -1696,6 +1775,8 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
   // Number of live tservers metric.
   scoped_refptr<AtomicGauge<uint32_t>> metric_num_tablet_servers_live_;
 
+  scoped_refptr<Histogram> metric_tablet_report_processing_time_;
+
   friend class ClusterLoadBalancer;
 
   // Policy for load balancing tablets on tablet servers.
@@ -1711,6 +1792,9 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
   // Tablets of system tables on the master indexed by the tablet id.
   std::unordered_map<std::string, std::shared_ptr<tablet::AbstractTablet>> system_tablets_;
 
+  mutable std::mutex split_candidates_mutex_;
+  std::unordered_map<TabletId, TabletSplitCandidate> split_candidates_;
+
   std::vector<PermissionType> all_permissions_ = {
       PermissionType::ALTER_PERMISSION, PermissionType::AUTHORIZE_PERMISSION,
       PermissionType::CREATE_PERMISSION, PermissionType::DESCRIBE_PERMISSION,
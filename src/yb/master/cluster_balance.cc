@@ -60,6 +60,12 @@ DEFINE_int32(load_balancer_max_concurrent_moves,
              "Maximum number of tablet leaders on tablet servers to move in any one run of the "
              "load balancer.");
 
+DEFINE_bool(load_balancer_prefer_idle_tservers,
+            true,
+            "When tablet servers have the same number of replicas or leaders of a table, treat the "
+            "ones serving more reads and writes, as reported in their heartbeats, as more loaded. "
+            "So replicas and leaders move off busier tablet servers and onto idler ones first.");
+
 DECLARE_int32(min_leader_stepdown_retry_interval_ms);
 
 namespace yb {
@@ -77,7 +83,10 @@ Status ClusterLoadBalancer::UpdateTabletInfo(TabletInfo* tablet) {
   // Set the placement information on a per-table basis, only once.
   if (!state_->placement_by_table_.count(table_id)) {
     PlacementInfoPB pb;
-    {
+    if (state_->options_->type == ReplicaType::kReadOnly) {
+      // Read replicas are only configured for the whole cluster.
+      pb.CopyFrom(GetClusterPlacementInfo());
+    } else {
       auto l = tablet->table()->LockForRead();
       // If we have a custom per-table placement policy, use that.
       if (l->data().pb.replication_info().has_live_replicas()) {
@@ -180,6 +189,9 @@ void ClusterLoadBalancer::RunLoadBalancer(Options* options) {
   set_remaining(pending_remove_replica_tasks, &remaining_removals);
   set_remaining(pending_stepdown_leader_tasks, &remaining_leader_moves);
 
+  // Live replicas are balanced first, then the observers of each read replica cluster.
+  const auto replication_info = GetClusterReplicationInfo();
+
   // Loop over all tables.
   for (const auto& table : GetTableMap()) {
 
@@ -187,62 +199,82 @@ void ClusterLoadBalancer::RunLoadBalancer(Options* options) {
       continue;
     }
 
-    ResetState();
-    state_->options_ = options;
-
-    // Prepare the in-memory structures.
-    YB_WARN_NOT_OK(AnalyzeTablets(table.first), "Skipping load balancing " + table.first);
-
-    // Output parameters are unused in the load balancer, but useful in testing.
-    TabletId out_tablet_id;
-    TabletServerId out_from_ts;
-    TabletServerId out_to_ts;
+    options->type = ReplicaType::kLive;
+    options->placement_uuid = replication_info.live_replicas().placement_uuid();
+    BalanceTable(table.first, options, &remaining_adds, &remaining_removals,
+                 &remaining_leader_moves);
+    for (const auto& read_replica : replication_info.read_replicas()) {
+      options->type = ReplicaType::kReadOnly;
+      options->placement_uuid = read_replica.placement_uuid();
+      BalanceTable(table.first, options, &remaining_adds, &remaining_removals,
+                   &remaining_leader_moves);
+    }
 
-    // Handle adding and moving replicas.
-    for (int i = 0; i < remaining_adds; ++i) {
-      auto handle_add = HandleAddReplicas(&out_tablet_id, &out_from_ts, &out_to_ts);
-      if (!handle_add.ok()) {
-        LOG(WARNING) << "Skipping add replicas for " << table.first << ": "
-                     << StatusToString(handle_add);
-        break;
-      }
-      if (!*handle_add) {
-        break;
-      }
-      --remaining_adds;
+    if (remaining_adds == 0 && remaining_removals == 0 && remaining_leader_moves == 0) {
+      break;
     }
+  }
+}
 
-    // Handle cleanup after over-replication.
-    for (int i = 0; i < remaining_removals; ++i) {
-      auto handle_remove = HandleRemoveReplicas(&out_tablet_id, &out_from_ts);
-      if (!handle_remove.ok()) {
-        LOG(WARNING) << "Skipping remove replicas for " << table.first << ": "
-                     << StatusToString(handle_remove);
-        break;
-      }
-      if (!*handle_remove) {
-        break;
-      }
-      --remaining_removals;
+void ClusterLoadBalancer::BalanceTable(
+    const TableId& table_id, Options* options, int* remaining_adds, int* remaining_removals,
+    int* remaining_leader_moves) {
+  ResetState();
+  state_->options_ = options;
+
+  // Prepare the in-memory structures.
+  YB_WARN_NOT_OK(AnalyzeTablets(table_id), "Skipping load balancing " + table_id);
+
+  // Output parameters are unused in the load balancer, but useful in testing.
+  TabletId out_tablet_id;
+  TabletServerId out_from_ts;
+  TabletServerId out_to_ts;
+
+  // Handle adding and moving replicas.
+  for (int i = 0; i < *remaining_adds; ++i) {
+    auto handle_add = HandleAddReplicas(&out_tablet_id, &out_from_ts, &out_to_ts);
+    if (!handle_add.ok()) {
+      LOG(WARNING) << "Skipping add replicas for " << table_id << ": "
+                   << StatusToString(handle_add);
+      break;
+    }
+    if (!*handle_add) {
+      break;
     }
+    --*remaining_adds;
+  }
 
-    // Handle tablet servers with too many leaders.
-    for (int i = 0; i < remaining_leader_moves; ++i) {
-      auto handle_leader = HandleLeaderMoves(&out_tablet_id, &out_from_ts, &out_to_ts);
-      if (!handle_leader.ok()) {
-        LOG(WARNING) << "Skipping leader moves for " << table.first << ": "
-                     << StatusToString(handle_leader);
-        break;
-      }
-      if (!*handle_leader) {
-        break;
-      }
-      --remaining_leader_moves;
+  // Handle cleanup after over-replication.
+  for (int i = 0; i < *remaining_removals; ++i) {
+    auto handle_remove = HandleRemoveReplicas(&out_tablet_id, &out_from_ts);
+    if (!handle_remove.ok()) {
+      LOG(WARNING) << "Skipping remove replicas for " << table_id << ": "
+                   << StatusToString(handle_remove);
+      break;
+    }
+    if (!*handle_remove) {
+      break;
     }
+    --*remaining_removals;
+  }
 
-    if (remaining_adds == 0 && remaining_removals == 0 && remaining_leader_moves == 0) {
+  // Observers never lead, so only live passes move leaders.
+  if (options->type != ReplicaType::kLive) {
+    return;
+  }
+
+  // Handle tablet servers with too many leaders.
+  for (int i = 0; i < *remaining_leader_moves; ++i) {
+    auto handle_leader = HandleLeaderMoves(&out_tablet_id, &out_from_ts, &out_to_ts);
+    if (!handle_leader.ok()) {
+      LOG(WARNING) << "Skipping leader moves for " << table_id << ": "
+                   << StatusToString(handle_leader);
+      break;
+    }
+    if (!*handle_leader) {
       break;
     }
+    --*remaining_leader_moves;
   }
 }
 
@@ -253,14 +285,17 @@ void ClusterLoadBalancer::ResetState() {
 Status ClusterLoadBalancer::AnalyzeTablets(const TableId& table_uuid) {
   // Set the blacklist so we can also mark the tablet servers as we add them up.
   state_->SetBlacklist(GetServerBlacklist());
+  state_->SetReplicationInfo(GetClusterReplicationInfo());
 
   // Loop over live tablet servers to set empty defaults, so we can also have info on those
   // servers that have yet to receive load (have heartbeated to the master, but have not been
-  // assigned any tablets yet).
+  // assigned any tablets yet). Only the servers of the cluster balanced by this pass are used.
   TSDescriptorVector ts_descs;
   GetAllReportedDescriptors(&ts_descs);
   for (const auto ts_desc : ts_descs) {
-    state_->UpdateTabletServer(ts_desc);
+    if (state_->IsTsInPlacement(*ts_desc)) {
+      state_->UpdateTabletServer(ts_desc);
+    }
   }
 
   vector<scoped_refptr<TabletInfo>> tablets;
@@ -825,9 +860,21 @@ const TableInfoMap& ClusterLoadBalancer::GetTableMap() const {
   return catalog_manager_->table_ids_map_;
 }
 
-const PlacementInfoPB& ClusterLoadBalancer::GetClusterPlacementInfo() const {
+const ReplicationInfoPB& ClusterLoadBalancer::GetClusterReplicationInfo() const {
   auto l = catalog_manager_->cluster_config_->LockForRead();
-  return l->data().pb.replication_info().live_replicas();
+  return l->data().pb.replication_info();
+}
+
+const PlacementInfoPB& ClusterLoadBalancer::GetClusterPlacementInfo() const {
+  const auto& replication_info = GetClusterReplicationInfo();
+  if (state_->options_->type == ReplicaType::kReadOnly) {
+    for (const auto& read_replica : replication_info.read_replicas()) {
+      if (read_replica.placement_uuid() == state_->options_->placement_uuid) {
+        return read_replica;
+      }
+    }
+  }
+  return replication_info.live_replicas();
 }
 
 const BlacklistPB& ClusterLoadBalancer::GetServerBlacklist() const {
@@ -896,6 +943,9 @@ void ClusterLoadBalancer::SendReplicaChanges(
 }
 
 consensus::RaftPeerPB::MemberType ClusterLoadBalancer::GetDefaultMemberType() {
+  if (state_->options_->type == ReplicaType::kReadOnly) {
+    return consensus::RaftPeerPB::PRE_OBSERVER;
+  }
   return consensus::RaftPeerPB::PRE_VOTER;
 }
 
@@ -903,6 +953,9 @@ Result<bool> ClusterLoadBalancer::IsConfigMemberInTransitionMode(const TabletId
   auto tablet = GetTabletMap().at(tablet_id);
   auto l = tablet->LockForRead();
   auto config = l->data().pb.committed_consensus_state().config();
+  if (state_->options_->type == ReplicaType::kReadOnly) {
+    return CountMemberType(config, consensus::RaftPeerPB::PRE_OBSERVER) != 0;
+  }
   return CountVotersInTransition(config) != 0;
 }
 
@@ -70,6 +70,10 @@ namespace master {
 //  leaders and moving some leaders to the servers with less to achieve an even distribution. If
 //  a threshold is set in the configuration, the balancer will just keep the numbers of leaders
 //  on each server below it instead of maintaining an even distribution.
+//
+//  Each table is balanced by one pass for the voters of the live cluster, followed by one pass
+//  for the observers of each read replica cluster, placed according to its own placement info.
+//  Read replica passes only see the tablet servers of their cluster, and do not move leaders.
 class ClusterLoadBalancer {
  public:
   explicit ClusterLoadBalancer(CatalogManager* cm);
@@ -103,8 +107,8 @@ class ClusterLoadBalancer {
   // Get the table info object for given table uuid.
   virtual const scoped_refptr<TableInfo> GetTableInfo(const TableId& table_uuid) const;
 
-  // Get the placement information from the cluster configuration.
-  virtual const PlacementInfoPB& GetClusterPlacementInfo() const;
+  // Get the replication information from the cluster configuration.
+  virtual const ReplicationInfoPB& GetClusterReplicationInfo() const;
 
   // Get the blacklist information.
   virtual const BlacklistPB& GetServerBlacklist() const;
@@ -134,7 +138,8 @@ class ClusterLoadBalancer {
       scoped_refptr<TabletInfo> tablet, const TabletServerId& ts_uuid, const bool is_add,
       const bool should_remove_leader, const TabletServerId& new_leader_ts_uuid = "");
 
-  // Returns default member type for newly created replicas (PRE_VOTER).
+  // Returns default member type for newly created replicas (PRE_VOTER, or PRE_OBSERVER for read
+  // replica passes).
   virtual consensus::RaftPeerPB::MemberType GetDefaultMemberType();
 
   //
@@ -240,6 +245,9 @@ class ClusterLoadBalancer {
 
   const PlacementInfoPB& GetPlacementByTablet(const TabletId& tablet_id) const;
 
+  // Get the placement information of the cluster balanced by the current pass.
+  const PlacementInfoPB& GetClusterPlacementInfo() const;
+
   // Get access to all the tablets for the given table.
   const CHECKED_STATUS GetTabletsForTable(const TableId& table_uuid,
                                   vector<scoped_refptr<TabletInfo>>* tablets) const;
@@ -274,8 +282,13 @@ class ClusterLoadBalancer {
   template <class ClusterLoadBalancerClass> friend class TestLoadBalancerBase;
 
  private:
+  // Runs the add, remove and leader move steps for the given table and the replicas selected by
+  // 'options', consuming the remaining task budgets.
+  void BalanceTable(const TableId& table_id, Options* options, int* remaining_adds,
+                    int* remaining_removals, int* remaining_leader_moves);
+
   // Returns true if at least one member in the tablet's configuration is transitioning into a
-  // VOTER, but it's not a VOTER yet.
+  // VOTER (or an OBSERVER for read replica passes), but it's not there yet.
   Result<bool> IsConfigMemberInTransitionMode(const TabletId& tablet_id) const;
 
   // Dump the sorted load on tservers (it is usually per table).
@@ -32,8 +32,8 @@ class ClusterLoadBalancerMocked : public ClusterLoadBalancer {
     return FindPtrOrNull(table_map_, table_uuid);
   }
 
-  const PlacementInfoPB& GetClusterPlacementInfo() const override {
-    return replication_info_.live_replicas();
+  const ReplicationInfoPB& GetClusterReplicationInfo() const override {
+    return replication_info_;
   }
 
   const BlacklistPB& GetServerBlacklist() const override { return blacklist_; }
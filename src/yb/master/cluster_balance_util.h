@@ -48,6 +48,8 @@ DECLARE_int32(load_balancer_max_concurrent_removals);
 
 DECLARE_int32(load_balancer_max_concurrent_moves);
 
+DECLARE_bool(load_balancer_prefer_idle_tservers);
+
 namespace yb {
 namespace master {
 
@@ -141,6 +143,19 @@ struct CBTabletServerMetadata {
 
   // The set of tablet leader ids that this tablet server is currently running.
   std::set<TabletId> leaders;
+
+  // Reads and writes per second last reported by this tablet server, or 0 if they are not taken
+  // into account. Copied once, so that sorting sees the same value throughout.
+  double ops_per_sec = 0;
+};
+
+// Kinds of replicas that are balanced by separate passes of the load balancer.
+enum class ReplicaType {
+  // Voters of the live cluster, placed according to the live placement.
+  kLive,
+  // Observers of a read replica cluster, that receive the Raft log asynchronously and serve
+  // follower reads, but do not count toward majority.
+  kReadOnly,
 };
 
 struct Options {
@@ -176,6 +191,13 @@ struct Options {
   int kMaxConcurrentLeaderMoves = FLAGS_load_balancer_max_concurrent_moves;
 
   // TODO(bogdan): add state for leaders starting remote bootstraps, to limit on that end too.
+
+  // Kind of replicas balanced by the current pass.
+  ReplicaType type = ReplicaType::kLive;
+
+  // Placement uuid of the tablet servers balanced by the current pass. Empty for a live cluster
+  // without placement uuid, whose tablet servers are all those not in read replica clusters.
+  std::string placement_uuid;
 };
 
 class ClusterLoadState {
@@ -190,6 +212,11 @@ class ClusterLoadState {
     int load_a = GetLoad(a);
     int load_b = GetLoad(b);
     if (load_a == load_b) {
+      const double ops_a = GetOpsPerSec(a);
+      const double ops_b = GetOpsPerSec(b);
+      if (ops_a != ops_b) {
+        return ops_a < ops_b;
+      }
       return a < b;
     } else {
       return load_a < load_b;
@@ -219,7 +246,12 @@ class ClusterLoadState {
   struct LeaderLoadComparator {
     explicit LeaderLoadComparator(ClusterLoadState* state) : state_(state) {}
     bool operator()(const TabletServerId& a, const TabletServerId& b) {
-      return state_->GetLeaderLoad(a) < state_->GetLeaderLoad(b);
+      const int load_a = state_->GetLeaderLoad(a);
+      const int load_b = state_->GetLeaderLoad(b);
+      if (load_a == load_b) {
+        return state_->GetOpsPerSec(a) < state_->GetOpsPerSec(b);
+      }
+      return load_a < load_b;
     }
     ClusterLoadState* state_;
   };
@@ -235,8 +267,41 @@ class ClusterLoadState {
     return per_ts_meta_.at(ts_uuid).leaders.size();
   }
 
+  // Reported throughput of a TS, used to tell apart tablet servers with the same load, so that
+  // replicas and leaders move off the busier ones and onto the idler ones first.
+  double GetOpsPerSec(const TabletServerId& ts_uuid) const {
+    return per_ts_meta_.at(ts_uuid).ops_per_sec;
+  }
+
   void SetBlacklist(const BlacklistPB& blacklist) { blacklist_ = blacklist; }
 
+  void SetReplicationInfo(const ReplicationInfoPB& replication_info) {
+    read_replica_placement_uuids_.clear();
+    for (const auto& read_replica : replication_info.read_replicas()) {
+      read_replica_placement_uuids_.insert(read_replica.placement_uuid());
+    }
+  }
+
+  // Whether the tablet server belongs to the cluster balanced by the current pass.
+  bool IsTsInPlacement(const TSDescriptor& ts_desc) const {
+    const auto ts_placement_uuid = ts_desc.placement_uuid();
+    if (options_->type == ReplicaType::kReadOnly || !options_->placement_uuid.empty()) {
+      return ts_placement_uuid == options_->placement_uuid;
+    }
+    return read_replica_placement_uuids_.count(ts_placement_uuid) == 0;
+  }
+
+  // Whether the replica is of the kind balanced by the current pass. Observers are only balanced
+  // within their read replica cluster, voters are left alone by read replica passes.
+  bool IsReplicaInPlacement(const TabletReplica& replica) const {
+    const bool is_observer = replica.member_type == consensus::RaftPeerPB::OBSERVER ||
+                             replica.member_type == consensus::RaftPeerPB::PRE_OBSERVER;
+    if (options_->type == ReplicaType::kLive) {
+      return !is_observer;
+    }
+    return is_observer && replica.ts_desc->placement_uuid() == options_->placement_uuid;
+  }
+
   // Update the per-tablet information for this tablet.
   Status UpdateTablet(TabletInfo* tablet) {
     const auto& tablet_id = tablet->id();
@@ -249,6 +314,14 @@ class ClusterLoadState {
     // Get replicas for this tablet.
     TabletInfo::ReplicaMap replica_map;
     GetReplicaLocations(tablet, &replica_map);
+    // Replicas of the other kinds are counted by their own passes.
+    for (auto it = replica_map.begin(); it != replica_map.end();) {
+      if (IsReplicaInPlacement(it->second)) {
+        ++it;
+      } else {
+        it = replica_map.erase(it);
+      }
+    }
     // Set state information for both the tablet and the tablet server replicas.
     for (const auto& replica : replica_map) {
       const auto& ts_uuid = replica.first;
@@ -376,6 +449,8 @@ class ClusterLoadState {
     // tablet servers that happen to not be serving any tablets, so were not in the map yet.
     auto& ts_meta = per_ts_meta_[ts_uuid];
     ts_meta.descriptor = ts_desc;
+    ts_meta.ops_per_sec = FLAGS_load_balancer_prefer_idle_tservers
+        ? ts_desc->read_ops_per_sec() + ts_desc->write_ops_per_sec() : 0;
 
     sorted_load_.push_back(ts_uuid);
 
@@ -644,6 +719,10 @@ class ClusterLoadState {
   // The list of tablet server ids that match the cached blacklist.
   std::set<TabletServerId> blacklisted_servers_;
 
+  // Placement uuids of the read replica clusters, whose tablet servers are not part of the live
+  // cluster.
+  std::set<std::string> read_replica_placement_uuids_;
+
   // List of tablet server ids that have pending deletes.
   std::set<TabletServerId> servers_with_pending_deletes_;
 
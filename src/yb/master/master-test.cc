@@ -1450,5 +1450,59 @@ TEST_F(MasterTest, TestGetTableSchema) {
   }
 }
 
+TEST_F(MasterTest, TestColocatedNamespace) {
+  const NamespaceName kNamespaceName = "colocated_ns";
+  {
+    CreateNamespaceRequestPB req;
+    CreateNamespaceResponsePB resp;
+    req.set_name(kNamespaceName);
+    req.set_colocated(true);
+    ASSERT_OK(proxy_->CreateNamespace(req, &resp, ResetAndGetController()));
+    ASSERT_FALSE(resp.has_error()) << resp.DebugString();
+  }
+
+  const Schema kTableSchema({ ColumnSchema("key", INT32) }, 1);
+  ASSERT_OK(CreateTable(kNamespaceName, "table1", kTableSchema));
+  ASSERT_OK(CreateTable(kNamespaceName, "table2", kTableSchema));
+
+  // The parent table that owns the shared tablet is not listed.
+  ListTablesResponsePB tables;
+  ASSERT_NO_FATALS(DoListAllTables(&tables, kNamespaceName));
+  ASSERT_EQ(2, tables.tables_size());
+
+  auto* catalog_manager = mini_master_->master()->catalog_manager();
+  auto get_tablets = [catalog_manager](const TableId& table_id) {
+    TabletInfos tablets;
+    catalog_manager->GetTableInfo(table_id)->GetAllTablets(&tablets);
+    return tablets;
+  };
+  const auto tablets1 = get_tablets(tables.tables(0).id());
+  const auto tablets2 = get_tablets(tables.tables(1).id());
+  ASSERT_EQ(1, tablets1.size());
+  ASSERT_EQ(1, tablets2.size());
+  ASSERT_EQ(tablets1[0]->tablet_id(), tablets2[0]->tablet_id());
+  // The parent table and the two tables.
+  ASSERT_EQ(3, tablets1[0]->LockForRead()->data().pb.table_ids_size());
+
+  // The shared tablet stays with the table that is left.
+  ASSERT_OK(DeleteTable(kNamespaceName, tables.tables(0).name()));
+  {
+    auto l = tablets1[0]->LockForRead();
+    ASSERT_FALSE(l->data().is_deleted());
+    ASSERT_EQ(2, l->data().pb.table_ids_size());
+  }
+  ASSERT_OK(DeleteTable(kNamespaceName, tables.tables(1).name()));
+
+  // The namespace is empty once its tables are deleted, and takes the shared tablet with it.
+  {
+    DeleteNamespaceRequestPB req;
+    DeleteNamespaceResponsePB resp;
+    req.mutable_namespace_()->set_name(kNamespaceName);
+    ASSERT_OK(proxy_->DeleteNamespace(req, &resp, ResetAndGetController()));
+    ASSERT_FALSE(resp.has_error()) << resp.DebugString();
+  }
+  ASSERT_TRUE(tablets1[0]->LockForRead()->data().is_deleted());
+}
+
 } // namespace master
 } // namespace yb
@@ -170,6 +170,7 @@ void MasterServiceImpl::TSHeartbeat(const TSHeartbeatRequestPB* req,
   // Set the TServer metrics in TS Descriptor.
   if (req->has_metrics()) {
     ts_desc->UpdateMetrics(req->metrics());
+    server_->catalog_manager()->ProcessTabletLeaderMetrics(*ts_desc, req->metrics());
   }
 
   if (req->has_tablet_report()) {
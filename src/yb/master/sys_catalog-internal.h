@@ -184,6 +184,19 @@ CHECKED_STATUS SysCatalogTable::AddItems(const vector<Item*>& items, int64_t lea
   return MutateItems(items, QLWriteRequestPB::QL_STMT_INSERT, leader_term);
 }
 
+template <class Item, class OtherItem>
+CHECKED_STATUS SysCatalogTable::AddItems(
+    const vector<Item*>& items, const vector<OtherItem*>& other_items, int64_t leader_term) {
+  auto w = NewWriter(leader_term);
+  for (const auto& item : items) {
+    RETURN_NOT_OK(w->MutateItem(item, QLWriteRequestPB::QL_STMT_INSERT));
+  }
+  for (const auto& item : other_items) {
+    RETURN_NOT_OK(w->MutateItem(item, QLWriteRequestPB::QL_STMT_INSERT));
+  }
+  return SyncWrite(w.get());
+}
+
 template <class Item>
 CHECKED_STATUS SysCatalogTable::AddAndUpdateItems(
     const vector<Item*>& added_items,
@@ -408,6 +408,40 @@ TEST_F(SysCatalogTest, TestSysCatalogTabletsOperations) {
   }
 }
 
+// Test adding a table together with its tablets.
+TEST_F(SysCatalogTest, TestSysCatalogTableWithTabletsOperations) {
+  scoped_refptr<TableInfo> table(new TableInfo("abc"));
+  scoped_refptr<TabletInfo> tablet1(CreateTablet(table.get(), "123", "a", "b"));
+  scoped_refptr<TabletInfo> tablet2(CreateTablet(table.get(), "456", "b", "c"));
+
+  SysCatalogTable* sys_catalog = master_->catalog_manager()->sys_catalog();
+  {
+    auto table_lock = table->LockForWrite();
+    table_lock->mutable_data()->pb.set_name("testtb");
+    table_lock->mutable_data()->pb.set_version(0);
+    table_lock->mutable_data()->pb.set_state(SysTablesEntryPB::RUNNING);
+    SchemaToPB(Schema(), table_lock->mutable_data()->pb.mutable_schema());
+    auto l1 = tablet1->LockForWrite();
+    auto l2 = tablet2->LockForWrite();
+    ASSERT_OK(sys_catalog->AddItems(std::vector<TabletInfo*>{tablet1.get(), tablet2.get()},
+                                    std::vector<TableInfo*>{table.get()}, kLeaderTerm));
+    table_lock->Commit();
+    l1->Commit();
+    l2->Commit();
+  }
+
+  unique_ptr<TestTableLoader> table_loader(new TestTableLoader());
+  ASSERT_OK(sys_catalog->Visit(table_loader.get()));
+  ASSERT_EQ(1 + kNumSystemTables, table_loader->tables.size());
+  ASSERT_TRUE(MetadatasEqual(table.get(), table_loader->tables[table->id()]));
+
+  unique_ptr<TestTabletLoader> tablet_loader(new TestTabletLoader());
+  ASSERT_OK(sys_catalog->Visit(tablet_loader.get()));
+  ASSERT_EQ(2 + kNumSystemTables, tablet_loader->tablets.size());
+  ASSERT_TRUE(MetadatasEqual(tablet1.get(), tablet_loader->tablets[tablet1->id()]));
+  ASSERT_TRUE(MetadatasEqual(tablet2.get(), tablet_loader->tablets[tablet2->id()]));
+}
+
 // Verify that data mutations are not available from metadata() until commit.
 TEST_F(SysCatalogTest, TestTabletInfoCommit) {
   scoped_refptr<TabletInfo> tablet(new TabletInfo(nullptr, "123"));
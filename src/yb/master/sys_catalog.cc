@@ -512,7 +512,8 @@ Status SysCatalogTable::OpenTablet(const scoped_refptr<tablet::TabletMetadata>&
                                                      tablet->GetMetricEntity(),
                                                      raft_pool(),
                                                      tablet_prepare_pool(),
-                                                     nullptr /* retryable_requests */),
+                                                     nullptr /* retryable_requests */,
+                                                     nullptr /* multi_raft_manager */),
                         "Failed to Init() TabletPeer");
 
   RETURN_NOT_OK_PREPEND(tablet_peer()->Start(consensus_info),
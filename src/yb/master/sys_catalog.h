@@ -105,6 +105,10 @@ class SysCatalogTable {
   CHECKED_STATUS AddItem(Item* item, int64_t leader_term);
   template <class Item>
   CHECKED_STATUS AddItems(const vector<Item*>& items, int64_t leader_term);
+  // Adds items of two types with one write, e.g. the tablets of a new table with the table.
+  template <class Item, class OtherItem>
+  CHECKED_STATUS AddItems(const vector<Item*>& items, const vector<OtherItem*>& other_items,
+                          int64_t leader_term);
 
   template <class Item>
   CHECKED_STATUS UpdateItem(Item* item, int64_t leader_term);
@@ -13,9 +13,19 @@
 
 #include "yb/master/yql_partitions_vtable.h"
 
+#include <gflags/gflags.h>
+
 #include "yb/common/ql_value.h"
 #include "yb/master/catalog_manager.h"
 #include "yb/master/master_util.h"
+#include "yb/util/flag_tags.h"
+
+DEFINE_int32(partitions_vtable_cache_refresh_secs, 1,
+             "Rows of the system.partitions table are rebuilt at most once in this many seconds, "
+             "and reads in between are served from the last built rows. 0 rebuilds them on every "
+             "read.");
+TAG_FLAG(partitions_vtable_cache_refresh_secs, advanced);
+TAG_FLAG(partitions_vtable_cache_refresh_secs, runtime);
 
 namespace yb {
 namespace master {
@@ -26,6 +36,25 @@ YQLPartitionsVTable::YQLPartitionsVTable(const Master* const master)
 
 Status YQLPartitionsVTable::RetrieveData(const QLReadRequestPB& request,
                                          std::unique_ptr<QLRowBlock>* vtable) const {
+  std::shared_ptr<const QLRowBlock> cache;
+  {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    const auto now = CoarseMonoClock::now();
+    if (!cache_ ||
+        now - cache_time_ >= std::chrono::seconds(FLAGS_partitions_vtable_cache_refresh_secs)) {
+      std::unique_ptr<QLRowBlock> data;
+      RETURN_NOT_OK(BuildData(&data));
+      cache_ = std::move(data);
+      cache_time_ = now;
+    }
+    cache = cache_;
+  }
+  // The caller filters the rows it gets, so it gets its own copy.
+  vtable->reset(new QLRowBlock(*cache));
+  return Status::OK();
+}
+
+Status YQLPartitionsVTable::BuildData(std::unique_ptr<QLRowBlock>* vtable) const {
   vtable->reset(new QLRowBlock(schema_));
   std::vector<scoped_refptr<TableInfo> > tables;
   CatalogManager* catalog_manager = master_->catalog_manager();
@@ -14,13 +14,21 @@
 #ifndef YB_MASTER_YQL_PARTITIONS_VTABLE_H
 #define YB_MASTER_YQL_PARTITIONS_VTABLE_H
 
+#include <mutex>
+
 #include "yb/master/master.h"
 #include "yb/master/yql_virtual_table.h"
 
+#include "yb/util/monotime.h"
+
 namespace yb {
 namespace master {
 
 // VTable implementation of system.partitions.
+//
+// Drivers poll this table for token aware routing, and building it looks up the locations of
+// every tablet. So the rows are built at most once per --partitions_vtable_cache_refresh_secs and
+// served from a copy shared by all reads in between.
 class YQLPartitionsVTable : public YQLVirtualTable {
  public:
   explicit YQLPartitionsVTable(const Master* const master);
@@ -29,6 +37,14 @@ class YQLPartitionsVTable : public YQLVirtualTable {
  protected:
   Schema CreateSchema() const;
  private:
+  CHECKED_STATUS BuildData(std::unique_ptr<QLRowBlock>* vtable) const;
+
+  // Last built rows and when they were built. Reads that find them too old rebuild them while
+  // holding the mutex, so concurrent reads wait for that instead of building their own.
+  mutable std::mutex cache_mutex_;
+  mutable std::shared_ptr<const QLRowBlock> cache_;
+  mutable CoarseTimePoint cache_time_;
+
   static constexpr const char* const kKeyspaceName = "keyspace_name";
   static constexpr const char* const kTableName = "table_name";
   static constexpr const char* const kStartKey = "start_key";
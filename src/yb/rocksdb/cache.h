@@ -66,6 +66,15 @@ extern shared_ptr<Cache> NewLRUCache(size_t capacity, int num_shard_bits);
 extern shared_ptr<Cache> NewLRUCache(size_t capacity, int num_shard_bits,
                                      bool strict_capacity_limit);
 
+// Create a new cache with CLOCK replacement, that does not take a mutex on Lookup and Release.
+// Each shard keeps its entries in a fixed size table, sized to hold the capacity worth of entries
+// of estimated_entry_charge. Smaller entries fill the table before the capacity is reached, in
+// that case entries are evicted to free table slots.
+extern shared_ptr<Cache> NewClockCache(size_t capacity);
+extern shared_ptr<Cache> NewClockCache(size_t capacity, int num_shard_bits,
+                                       bool strict_capacity_limit = false,
+                                       size_t estimated_entry_charge = 32 * 1024);
+
 using QueryId = int64_t;
 // Query ids to represent values for the default query id.
 constexpr QueryId kDefaultQueryId = 0;
@@ -74,6 +83,14 @@ constexpr QueryId kInMultiTouchId = -1;
 // Query ids to represent values that should not be in any cache.
 constexpr QueryId kNoCacheQueryId = -2;
 
+// Priority classes partition a cache shared by many tables, so that scans over a low priority table
+// do not evict the working set of a latency-critical one. Every entry belongs to the priority class
+// it was inserted with. While a class uses no more than its reserved capacity, its entries are only
+// evicted to make room for entries of the same class.
+using CachePriorityClass = uint32_t;
+constexpr CachePriorityClass kDefaultCachePriorityClass = 0;
+using yb::kNumCachePriorityClasses;
+
 class Cache {
  public:
   Cache() { }
@@ -105,19 +122,23 @@ class Cache {
   // The query ids will allow the cache values to be included in the
   // single touch or multi touch cache, which gives scan resistance to the
   // cache.
+  //
+  // The entry is accounted to the given priority class.
   virtual Status Insert(const Slice& key, const QueryId query_id,
                         void* value, size_t charge,
                         void (*deleter)(const Slice& key, void* value),
                         Handle** handle = nullptr,
-                        Statistics* statistics = nullptr) = 0;
+                        Statistics* statistics = nullptr,
+                        CachePriorityClass priority_class = kDefaultCachePriorityClass) = 0;
 
   // If the cache has no mapping for "key", returns nullptr.
   //
   // Else return a handle that corresponds to the mapping.  The caller
   // must call this->Release(handle) when the returned mapping is no
-  // longer needed.
+  // longer needed. The hit or miss is accounted to the given priority class.
   virtual Handle* Lookup(const Slice& key, const QueryId query_id,
-                         Statistics* statistics = nullptr) = 0;
+                         Statistics* statistics = nullptr,
+                         CachePriorityClass priority_class = kDefaultCachePriorityClass) = 0;
 
   // Release a mapping returned by a previous Lookup().
   // REQUIRES: handle must not have been released yet.
@@ -158,6 +179,12 @@ class Cache {
   // returns the maximum configured capacity of the cache
   virtual size_t GetCapacity() const = 0;
 
+  // Reserves capacity for the entries of the given priority class: they are not evicted on behalf
+  // of other classes while the class uses less than that. Caches that do not support priority
+  // classes ignore this.
+  virtual void SetPriorityClassReservedCapacity(CachePriorityClass priority_class,
+                                                size_t capacity) {}
+
   // returns the memory size for the entries residing in the cache.
   virtual size_t GetUsage() const = 0;
 
@@ -200,6 +227,11 @@ class Cache {
   void operator=(const Cache&);
 };
 
+// Returns a cache that shares the entries and capacity of 'cache', but inserts entries into the
+// given priority class and accounts lookups to it. Can be used as the block cache of a table.
+extern shared_ptr<Cache> NewPriorityClassCache(shared_ptr<Cache> cache,
+                                               CachePriorityClass priority_class);
+
 }  // namespace rocksdb
 
 #endif  // STORAGE_ROCKSDB_UTIL_CACHE_H_
@@ -809,6 +809,11 @@ class DB {
 
   virtual bool HasSomethingToFlush() { return true; }
 
+  // Drops the readers of the live SST files from the table cache, releasing their file descriptors
+  // and the memory they hold once they are not used by iterators. The files are reopened by the
+  // next reads.
+  virtual void ReleaseTableReaders() {}
+
   // Obtains the meta data of the specified column family of the DB.
   // STATUS(NotFound, "") will be returned if the current DB does not have
   // any column family match the specified name.
@@ -875,7 +880,10 @@ class DB {
   // Needed for StackableDB
   virtual DB* GetRootDB() { return this; }
 
-  virtual CHECKED_STATUS Import(const std::string& source_dir) {
+  // When flushed_frontier is specified, it is applied in the same version edit that adds the
+  // imported files, so the import and the flushed frontier update are persisted atomically.
+  virtual CHECKED_STATUS Import(
+      const std::string& source_dir, UserFrontierPtr flushed_frontier = nullptr) {
     return STATUS(NotSupported, "");
   }
 
@@ -138,6 +138,13 @@ Status CheckCompressionSupported(const ColumnFamilyOptions& cf_options) {
           " is not linked with the binary.");
     }
   }
+  if (cf_options.large_compaction_threshold_bytes > 0 &&
+      !CompressionTypeSupported(cf_options.large_compaction_compression)) {
+    return STATUS(InvalidArgument,
+        "Compression type " +
+        CompressionTypeToString(cf_options.large_compaction_compression) +
+        " is not linked with the binary.");
+  }
   return Status::OK();
 }
 
@@ -726,6 +733,9 @@ Compaction* ColumnFamilyData::PickCompaction(
     const MutableCFOptions& mutable_options, LogBuffer* log_buffer) {
   // TODO: do we need to check if current() is not nullptr here?
   Version* const current_version = current();
+  uint64_t num_reads = 0;
+  const double sst_files_per_read = internal_stats_->TakeSstFilesPerRead(&num_reads);
+  current_version->storage_info()->SetObservedReads(num_reads, sst_files_per_read);
   auto* result = compaction_picker_->PickCompaction(
       GetName(), mutable_options, current_version->storage_info(), log_buffer);
   if (result != nullptr) {
@@ -70,6 +70,7 @@
 #include "yb/rocksdb/util/mutexlock.h"
 #include "yb/rocksdb/util/perf_context_imp.h"
 #include "yb/rocksdb/util/stop_watch.h"
+#include "yb/util/io_accounting.h"
 #include "yb/util/string_util.h"
 #include "yb/rocksdb/util/sync_point.h"
 #include "yb/rocksdb/util/thread_status_util.h"
@@ -120,6 +121,8 @@ struct CompactionJob::SubcompactionState {
   uint64_t num_output_records;
   CompactionJobStats compaction_job_stats;
   uint64_t approx_size;
+  // Largest user frontier reported by the compaction filter of this subcompaction.
+  UserFrontierPtr largest_user_frontier;
 
   SubcompactionState(Compaction* c, Slice* _start, Slice* _end,
                      uint64_t size = 0)
@@ -152,6 +155,7 @@ struct CompactionJob::SubcompactionState {
     num_output_records = std::move(o.num_output_records);
     compaction_job_stats = std::move(o.compaction_job_stats);
     approx_size = std::move(o.approx_size);
+    largest_user_frontier = std::move(o.largest_user_frontier);
     return *this;
   }
 
@@ -304,6 +308,8 @@ void CompactionJob::ReportStartedCompaction(
 
   IOSTATS_RESET(bytes_written);
   IOSTATS_RESET(bytes_read);
+  IOSTATS_RESET(direct_bytes_written);
+  IOSTATS_RESET(direct_bytes_read);
   ThreadStatusUtil::SetThreadOperationProperty(
       ThreadStatus::COMPACTION_BYTES_WRITTEN, 0);
   ThreadStatusUtil::SetThreadOperationProperty(
@@ -361,6 +367,10 @@ struct RangeWithSize {
       : range(a, b), size(s) {}
 };
 
+// Maximum number of keys sampled from the index of a level 0 file to split it between
+// subcompactions.
+constexpr size_t kMaxSampleKeysPerFile = 64;
+
 // Generates a histogram representing potential divisions of key ranges from
 // the input. It adds the starting and/or ending keys of certain input files
 // to the working set and then finds the approximate size of data in between
@@ -393,6 +403,21 @@ void CompactionJob::GenSubcompactionBoundaries() {
           bounds.emplace_back(flevel->files[i].smallest.key);
           bounds.emplace_back(flevel->files[i].largest.key);
         }
+        if (out_lvl == 0) {
+          // In a single level DB the level 0 files usually cover the whole key range, so also add
+          // keys sampled from their indexes.
+          for (size_t i = 0; i < num_files; i++) {
+            Status s = cfd->table_cache()->GetSampleKeys(
+                env_options_, cfd->internal_comparator(), flevel->files[i].fd,
+                kMaxSampleKeysPerFile, &sample_keys_);
+            if (!s.ok()) {
+              RLOG(InfoLogLevel::WARN_LEVEL, db_options_.info_log,
+                  "[%s] [JOB %d] Failed to sample keys of file %" PRIu64 ": %s",
+                  cfd->GetName().c_str(), job_id_, flevel->files[i].fd.GetNumber(),
+                  s.ToString().c_str());
+            }
+          }
+        }
       } else {
         // For all other levels add the smallest/largest key in the level to
         // encompass the range covered by that level
@@ -411,6 +436,10 @@ void CompactionJob::GenSubcompactionBoundaries() {
     }
   }
 
+  for (const auto& key : sample_keys_) {
+    bounds.emplace_back(key);
+  }
+
   std::sort(bounds.begin(), bounds.end(),
     [cfd_comparator] (const Slice& a, const Slice& b) -> bool {
       return cfd_comparator->Compare(ExtractUserKey(a), ExtractUserKey(b)) < 0;
@@ -442,9 +471,16 @@ void CompactionJob::GenSubcompactionBoundaries() {
 
   // Group the ranges into subcompactions
   const double min_file_fill_percent = 4.0 / 5;
-  uint64_t max_output_files = static_cast<uint64_t>(std::ceil(
-      sum / min_file_fill_percent /
-      cfd->GetCurrentMutableCFOptions()->MaxFileSizeForLevel(out_lvl)));
+  const uint64_t max_file_size = cfd->GetCurrentMutableCFOptions()->MaxFileSizeForLevel(out_lvl);
+  uint64_t max_output_files;
+  if (max_file_size == std::numeric_limits<uint64_t>::max()) {
+    // The output is not split into files by size, so limit the number of subcompactions by the
+    // amount of data each of them gets instead.
+    max_output_files = sum / std::max<uint64_t>(db_options_.min_subcompaction_size, 1);
+  } else {
+    max_output_files = static_cast<uint64_t>(std::ceil(
+        sum / min_file_fill_percent / max_file_size));
+  }
   uint64_t subcompactions =
       std::min({static_cast<uint64_t>(ranges.size()),
                 static_cast<uint64_t>(db_options_.max_subcompactions),
@@ -476,6 +512,40 @@ void CompactionJob::GenSubcompactionBoundaries() {
     // Only one range so its size is the total sum of sizes computed above
     sizes_.emplace_back(sum);
   }
+
+  AlignSubcompactionBoundariesToKeyGroups();
+}
+
+// Moves each subcompaction boundary to the start of its key group, merging subcompactions whose
+// boundaries end up in the same group, so that no key group is split between subcompactions.
+void CompactionJob::AlignSubcompactionBoundariesToKeyGroups() {
+  const KeyGroupExtractor* key_group_extractor =
+      db_options_.subcompaction_key_group_extractor.get();
+  if (key_group_extractor == nullptr || boundaries_.empty()) {
+    return;
+  }
+  const Comparator* user_comparator =
+      compact_->compaction->column_family_data()->user_comparator();
+  std::vector<Slice> boundaries;
+  std::vector<uint64_t> sizes;
+  uint64_t size = 0;
+  for (size_t i = 0; i < boundaries_.size(); i++) {
+    Slice boundary = boundaries_[i];
+    const size_t group_prefix_size = key_group_extractor->GroupPrefixSize(boundary);
+    if (group_prefix_size != 0 && group_prefix_size < boundary.size()) {
+      boundary = Slice(boundary.data(), group_prefix_size);
+    }
+    size += sizes_[i];
+    if (!boundaries.empty() && user_comparator->Compare(boundary, boundaries.back()) <= 0) {
+      continue;
+    }
+    boundaries.push_back(boundary);
+    sizes.push_back(size);
+    size = 0;
+  }
+  sizes.push_back(size + sizes_.back());
+  boundaries_ = std::move(boundaries);
+  sizes_ = std::move(sizes);
 }
 
 Result<FileNumbersHolder> CompactionJob::Run() {
@@ -524,6 +594,12 @@ Result<FileNumbersHolder> CompactionJob::Run() {
     }
   }
 
+  // Each subcompaction has its own compaction filter, so persist the largest of their frontiers.
+  for (const auto& state : compact_->sub_compact_states) {
+    UserFrontier::Update(
+        state.largest_user_frontier.get(), UpdateUserValueType::kLargest, &largest_user_frontier_);
+  }
+
   TablePropertiesCollection tp;
   for (const auto& state : compact_->sub_compact_states) {
     for (const auto& output : state.outputs) {
@@ -622,6 +698,8 @@ Status CompactionJob::Install(const MutableCFOptions& mutable_cf_options) {
 void CompactionJob::ProcessKeyValueCompaction(
     FileNumbersHolder* holder, SubcompactionState* sub_compact) {
   assert(sub_compact != nullptr);
+  // Subcompactions run on their own threads, so each one accounts its I/O.
+  yb::ScopedIOAccounting io_accounting(db_options_.compaction_io_metrics.get());
   std::unique_ptr<InternalIterator> input(
       versions_->MakeInputIterator(sub_compact->compaction));
 
@@ -656,7 +734,7 @@ void CompactionJob::ProcessKeyValueCompaction(
   if (compaction_filter) {
     // This is used to persist the history cutoff hybrid time chosen for the DocDB compaction
     // filter.
-    largest_user_frontier_ = compaction_filter->GetLargestUserFrontier();
+    sub_compact->largest_user_frontier = compaction_filter->GetLargestUserFrontier();
   }
 
   MergeHelper merge(
@@ -990,6 +1068,10 @@ void CompactionJob::RecordCompactionIOStats() {
   ThreadStatusUtil::IncreaseThreadOperationProperty(
       ThreadStatus::COMPACTION_BYTES_WRITTEN, IOSTATS(bytes_written));
   IOSTATS_RESET(bytes_written);
+  RecordTick(stats_, DIRECT_IO_READ_BYTES, IOSTATS(direct_bytes_read));
+  IOSTATS_RESET(direct_bytes_read);
+  RecordTick(stats_, DIRECT_IO_WRITE_BYTES, IOSTATS(direct_bytes_written));
+  IOSTATS_RESET(direct_bytes_written);
 }
 
 Status CompactionJob::OpenFile(const std::string table_name, uint64_t file_number,
@@ -1065,12 +1147,21 @@ Status CompactionJob::OpenCompactionOutputFile(
   // data is going to be found
   bool skip_filters =
       cfd->ioptions()->optimize_filters_for_hits && bottommost_level_;
+  // Large compactions produce long-lived files, which may use a stronger compression.
+  const auto* ioptions = cfd->ioptions();
+  auto compression = sub_compact->compaction->output_compression();
+  const auto* compression_opts = &ioptions->compression_opts;
+  if (ioptions->large_compaction_threshold_bytes > 0 &&
+      sub_compact->compaction->CalculateTotalInputSize() >=
+          ioptions->large_compaction_threshold_bytes) {
+    compression = ioptions->large_compaction_compression;
+    compression_opts = &ioptions->large_compaction_compression_opts;
+  }
   sub_compact->builder.reset(NewTableBuilder(
-      *cfd->ioptions(), cfd->internal_comparator(),
+      *ioptions, cfd->internal_comparator(),
       cfd->int_tbl_prop_collector_factories(), cfd->GetID(),
       sub_compact->base_outfile.get(), sub_compact->data_outfile.get(),
-      sub_compact->compaction->output_compression(), cfd->ioptions()->compression_opts,
-      skip_filters));
+      compression, *compression_opts, skip_filters));
   LogFlush(db_options_.info_log);
   return Status::OK();
 }
@@ -1148,20 +1148,76 @@ bool LevelCompactionPicker::PickCompactionBySize(VersionStorageInfo* vstorage,
 bool UniversalCompactionPicker::NeedsCompaction(
     const VersionStorageInfo* vstorage) const {
   const int kLevel0 = 0;
-  return vstorage->CompactionScore(kLevel0) >= 1;
+  return vstorage->CompactionScore(kLevel0) >= 1 || NumExpiredFiles(*vstorage) != 0 ||
+         !vstorage->FilesMarkedForCompaction().empty();
+}
+
+size_t UniversalCompactionPicker::NumExpiredFiles(const VersionStorageInfo& vstorage) const {
+  if (!ioptions_.expired_files_selector) {
+    return 0;
+  }
+  // Files of upper levels are older than the ones of level 0, so deleting files of level 0 could
+  // uncover the data that they overwrite.
+  for (int level = 1; level < vstorage.num_levels(); ++level) {
+    if (vstorage.NumLevelFiles(level) != 0) {
+      return 0;
+    }
+  }
+  const std::vector<FileMetaData*>& level_files = vstorage.LevelFiles(0);
+  std::vector<SstFileBoundaries> files;
+  files.reserve(level_files.size());
+  // Level 0 files are ordered from the newest to the oldest.
+  for (auto it = level_files.rbegin(); it != level_files.rend(); ++it) {
+    files.push_back({&(*it)->smallest, &(*it)->largest});
+  }
+  size_t result = std::min(ioptions_.expired_files_selector(files), files.size());
+  for (size_t i = 0; i != result; ++i) {
+    if (level_files[level_files.size() - 1 - i]->being_compacted) {
+      return i;
+    }
+  }
+  return result;
+}
+
+Compaction* UniversalCompactionPicker::PickCompactionUniversalExpiredFiles(
+    const std::string& cf_name, const MutableCFOptions& mutable_cf_options,
+    VersionStorageInfo* vstorage, LogBuffer* log_buffer) {
+  const size_t num_files = NumExpiredFiles(*vstorage);
+  if (num_files == 0) {
+    return nullptr;
+  }
+  const std::vector<FileMetaData*>& level_files = vstorage->LevelFiles(0);
+  std::vector<CompactionInputFiles> inputs(1);
+  inputs[0].level = 0;
+  uint64_t total_size = 0;
+  for (size_t i = 0; i != num_files; ++i) {
+    FileMetaData* f = level_files[level_files.size() - 1 - i];
+    inputs[0].files.push_back(f);
+    total_size += f->fd.GetTotalFileSize();
+  }
+  char tmp_fsize[16];
+  AppendHumanBytes(total_size, tmp_fsize, sizeof(tmp_fsize));
+  LOG_TO_BUFFER(log_buffer, "[%s] Universal: deleting %" ROCKSDB_PRIszt " expired files of %s",
+                cf_name.c_str(), num_files, tmp_fsize);
+  Compaction* c = new Compaction(
+      vstorage, mutable_cf_options, std::move(inputs), 0, 0, 0, 0,
+      kNoCompression, {}, /* is manual */ false, vstorage->CompactionScore(0),
+      /* is deletion compaction */ true, CompactionReason::kUniversalExpiredFiles);
+  level0_compactions_in_progress_.insert(c);
+  return c;
 }
 
 struct UniversalCompactionPicker::SortedRun {
-  SortedRun(int _level, FileMetaData* _file, uint64_t _size,
+  SortedRun(int _level, std::vector<FileMetaData*> _files, uint64_t _size,
             uint64_t _compensated_file_size, bool _being_compacted)
       : level(_level),
-        file(_file),
+        files(std::move(_files)),
         size(_size),
         compensated_file_size(_compensated_file_size),
         being_compacted(_being_compacted) {
     assert(compensated_file_size > 0);
-    // Allowed either one of level and file.
-    assert((level != 0) != (file != nullptr));
+    // Allowed either one of level and files.
+    assert((level != 0) != !files.empty());
   }
 
   void Dump(char* out_buf, size_t out_buf_size,
@@ -1171,30 +1227,46 @@ struct UniversalCompactionPicker::SortedRun {
   void DumpSizeInfo(char* out_buf, size_t out_buf_size,
                     size_t sorted_run_count) const;
 
+  // Returns the numbers of the files of a level 0 sorted run.
+  std::string FileNumbers() const;
+
   int level;
-  // `file` Will be null for level > 0. For level = 0, the sorted run is
-  // for this file.
-  FileMetaData* file;
-  // For level > 0, `size` and `compensated_file_size` are sum of sizes all
-  // files in the level. `being_compacted` should be the same for all files
-  // in a non-zero level. Use the value here.
+  // `files` will be empty for level > 0. For level = 0, the sorted run is
+  // for these files. It is usually a single file, but the outputs of a compaction
+  // split into subcompactions form one sorted run, see InSameLevel0SortedRun.
+  std::vector<FileMetaData*> files;
+  // `size` and `compensated_file_size` are sum of sizes all files in the
+  // sorted run. `being_compacted` should be the same for all files
+  // in the sorted run. Use the value here.
   uint64_t size;
   uint64_t compensated_file_size;
   bool being_compacted;
 };
 
+std::string UniversalCompactionPicker::SortedRun::FileNumbers() const {
+  std::string result;
+  for (const auto* file : files) {
+    if (!result.empty()) {
+      result += ',';
+    }
+    result += ToString(file->fd.GetNumber());
+  }
+  return result;
+}
+
 void UniversalCompactionPicker::SortedRun::Dump(char* out_buf,
                                                 size_t out_buf_size,
                                                 bool print_path) const {
   if (level == 0) {
-    assert(file != nullptr);
+    assert(!files.empty());
+    const FileMetaData* file = files.front();
     if (file->fd.GetPathId() == 0 || !print_path) {
-      snprintf(out_buf, out_buf_size, "file %" PRIu64, file->fd.GetNumber());
+      snprintf(out_buf, out_buf_size, "file %s", FileNumbers().c_str());
     } else {
-      snprintf(out_buf, out_buf_size, "file %" PRIu64
+      snprintf(out_buf, out_buf_size, "file %s"
                                       "(path "
                                       "%" PRIu32 ")",
-               file->fd.GetNumber(), file->fd.GetPathId());
+               FileNumbers().c_str(), file->fd.GetPathId());
     }
   } else {
     snprintf(out_buf, out_buf_size, "level %d", level);
@@ -1204,13 +1276,12 @@ void UniversalCompactionPicker::SortedRun::Dump(char* out_buf,
 void UniversalCompactionPicker::SortedRun::DumpSizeInfo(
     char* out_buf, size_t out_buf_size, size_t sorted_run_count) const {
   if (level == 0) {
-    assert(file != nullptr);
+    assert(!files.empty());
     snprintf(out_buf, out_buf_size,
-             "file %" PRIu64 "[%" ROCKSDB_PRIszt
+             "file %s[%" ROCKSDB_PRIszt
              "] "
              "with size %" PRIu64 " (compensated size %" PRIu64 ")",
-             file->fd.GetNumber(), sorted_run_count, file->fd.GetTotalFileSize(),
-             file->compensated_file_size);
+             FileNumbers().c_str(), sorted_run_count, size, compensated_file_size);
   } else {
     snprintf(out_buf, out_buf_size,
              "level %d[%" ROCKSDB_PRIszt
@@ -1225,10 +1296,24 @@ std::vector<std::vector<UniversalCompactionPicker::SortedRun>>
                                                    const ImmutableCFOptions& ioptions,
                                                    uint64_t max_file_size) {
   std::vector<std::vector<SortedRun>> ret(1);
-  for (FileMetaData* f : vstorage.LevelFiles(0)) {
-    if (f->fd.GetTotalFileSize() <= max_file_size) {
-      ret.back().emplace_back(0, f, f->fd.GetTotalFileSize(), f->compensated_file_size,
-          f->being_compacted);
+  const auto& level0_files = vstorage.LevelFiles(0);
+  for (size_t i = 0; i < level0_files.size();) {
+    std::vector<FileMetaData*> files;
+    uint64_t total_size = 0;
+    uint64_t total_compensated_size = 0;
+    bool being_compacted = false;
+    do {
+      FileMetaData* f = level0_files[i];
+      files.push_back(f);
+      total_size += f->fd.GetTotalFileSize();
+      total_compensated_size += f->compensated_file_size;
+      being_compacted = being_compacted || f->being_compacted;
+      ++i;
+    } while (i < level0_files.size() && InSameLevel0SortedRun(*files.back(), *level0_files[i]));
+
+    if (total_size <= max_file_size) {
+      ret.back().emplace_back(
+          0, std::move(files), total_size, total_compensated_size, being_compacted);
     // If last sequence is empty it means that there are multiple too-large-to-compact files in
     // a row. So we just don't start new sequence in this case.
     } else if (!ret.back().empty()) {
@@ -1262,7 +1347,8 @@ std::vector<std::vector<UniversalCompactionPicker::SortedRun>>
       }
     }
     if (total_compensated_size > 0) {
-      ret.back().emplace_back(level, nullptr, total_size, total_compensated_size, being_compacted);
+      ret.back().emplace_back(level, std::vector<FileMetaData*>(), total_size,
+                              total_compensated_size, being_compacted);
     }
   }
 
@@ -1353,6 +1439,13 @@ Compaction* UniversalCompactionPicker::PickCompaction(
     const MutableCFOptions& mutable_cf_options,
     VersionStorageInfo* vstorage,
     LogBuffer* log_buffer) {
+  // Deleting expired files is free, and it could make the compactions below unnecessary.
+  Compaction* expired_files_compaction = PickCompactionUniversalExpiredFiles(
+      cf_name, mutable_cf_options, vstorage, log_buffer);
+  if (expired_files_compaction != nullptr) {
+    return expired_files_compaction;
+  }
+
   std::vector<std::vector<SortedRun>> sorted_runs = CalculateSortedRuns(
       *vstorage,
       ioptions_,
@@ -1364,9 +1457,57 @@ Compaction* UniversalCompactionPicker::PickCompaction(
       return result;
     }
   }
+  return PickCompactionUniversalMarkedFiles(
+      cf_name, mutable_cf_options, vstorage, sorted_runs, log_buffer);
+}
+
+Compaction* UniversalCompactionPicker::PickCompactionUniversalMarkedFiles(
+    const std::string& cf_name, const MutableCFOptions& mutable_cf_options,
+    VersionStorageInfo* vstorage, const std::vector<std::vector<SortedRun>>& sorted_runs,
+    LogBuffer* log_buffer) {
+  if (vstorage->FilesMarkedForCompaction().empty()) {
+    return nullptr;
+  }
+  // Rewriting the sorted run on its own drops what the compaction filter garbage-collects, without
+  // merging it with the neighbouring runs.
+  for (const auto& block : sorted_runs) {
+    for (const auto& sorted_run : block) {
+      if (sorted_run.level != 0 || sorted_run.being_compacted) {
+        continue;
+      }
+      bool marked = false;
+      for (const auto* f : sorted_run.files) {
+        marked = marked || f->marked_for_compaction;
+      }
+      if (!marked) {
+        continue;
+      }
+      LOG_TO_BUFFER(log_buffer, "[%s] Universal: compacting marked files %s\n",
+                    cf_name.c_str(), sorted_run.FileNumbers().c_str());
+      std::vector<CompactionInputFiles> inputs(1);
+      inputs[0].level = 0;
+      inputs[0].files = sorted_run.files;
+      const uint32_t path_id = SelectOutputPathId(inputs, GetPathId(ioptions_, sorted_run.size));
+      Compaction* c = new Compaction(
+          vstorage, mutable_cf_options, std::move(inputs), 0,
+          mutable_cf_options.MaxFileSizeForLevel(0), LLONG_MAX, path_id,
+          GetCompressionType(ioptions_, 0, 1), /* grandparents */ {}, /* is manual */ false,
+          vstorage->CompactionScore(0), /* is deletion compaction */ false,
+          CompactionReason::kFilesMarkedForCompaction);
+      level0_compactions_in_progress_.insert(c);
+      return c;
+    }
+  }
   return nullptr;
 }
 
+bool UniversalCompactionPicker::IsReadHot(const VersionStorageInfo& vstorage) const {
+  const auto& options = ioptions_.compaction_options_universal;
+  return options.read_amp_compaction_trigger != 0 &&
+         vstorage.observed_num_reads() >= options.read_amp_compaction_min_reads &&
+         vstorage.observed_sst_files_per_read() >= options.read_amp_compaction_trigger;
+}
+
 Compaction* UniversalCompactionPicker::DoPickCompaction(
     const std::string& cf_name,
     const MutableCFOptions& mutable_cf_options,
@@ -1415,8 +1556,16 @@ Compaction* UniversalCompactionPicker::DoPickCompaction(
       // This was causing a lot of read/write amplification.
       //
       // Ideally, we should just remove this block below. For now, putting this
-      // under a gflag.
-      if (FLAGS_aggressive_compaction_for_read_amp) {
+      // under a gflag. Column families whose reads consult many files are compacted this way
+      // regardless of the flag, their read latency matters more than the write amplification.
+      const bool read_hot = IsReadHot(*vstorage);
+      if (read_hot) {
+        LOG_TO_BUFFER(log_buffer,
+                      "[%s] Universal: read-hot, %.2f files per read in %" PRIu64 " reads\n",
+                      cf_name.c_str(), vstorage->observed_sst_files_per_read(),
+                      vstorage->observed_num_reads());
+      }
+      if (FLAGS_aggressive_compaction_for_read_amp || read_hot) {
         // Size amplification and file size ratios are within configured limits.
         // If max read amplification is exceeding configured limits, then force
         // compaction without looking at filesize ratios and try to reduce
@@ -1428,6 +1577,10 @@ Compaction* UniversalCompactionPicker::DoPickCompaction(
         unsigned int num_files =
         static_cast<unsigned int>(sorted_runs.size()) -
           mutable_cf_options.level0_file_num_compaction_trigger;
+        if (read_hot) {
+          // Merging that many more sorted runs brings their number below the trigger.
+          num_files += 2;
+        }
         if ((c = PickCompactionUniversalReadAmp(
                      cf_name, mutable_cf_options, vstorage, score, UINT_MAX,
                      num_files, sorted_runs, log_buffer)) != nullptr) {
@@ -1453,14 +1606,16 @@ Compaction* UniversalCompactionPicker::DoPickCompaction(
 
   size_t level_index = 0U;
   if (c->start_level() == 0) {
+    const FileMetaData* prev_file = nullptr;
     for (auto f : *c->inputs(0)) {
       DCHECK_LE(f->smallest.seqno, f->largest.seqno);
       if (is_first) {
         is_first = false;
-      } else {
+      } else if (!InSameLevel0SortedRun(*prev_file, *f)) {
         DCHECK_GT(prev_smallest_seqno, f->largest.seqno);
       }
       prev_smallest_seqno = f->smallest.seqno;
+      prev_file = f;
     }
     level_index = 1U;
   }
@@ -1526,6 +1681,29 @@ uint32_t UniversalCompactionPicker::GetPathId(
   return p;
 }
 
+uint32_t UniversalCompactionPicker::SelectOutputPathId(
+    const std::vector<CompactionInputFiles>& inputs, uint32_t path_id) const {
+  if (!ioptions_.compaction_output_path_selector) {
+    return path_id;
+  }
+  UserFrontierPtr largest_frontier;
+  for (const auto& level_inputs : inputs) {
+    for (const auto* f : level_inputs.files) {
+      if (!f->largest.user_frontier) {
+        // Nothing is known about the data of this file.
+        return path_id;
+      }
+      UserFrontier::Update(
+          f->largest.user_frontier.get(), UpdateUserValueType::kLargest, &largest_frontier);
+    }
+  }
+  if (!largest_frontier) {
+    return path_id;
+  }
+  return std::min(ioptions_.compaction_output_path_selector(*largest_frontier),
+                  static_cast<uint32_t>(ioptions_.db_paths.size() - 1));
+}
+
 //
 // Consider compaction files based on their size differences with
 // the next file in time order.
@@ -1688,8 +1866,8 @@ Compaction* UniversalCompactionPicker::PickCompactionUniversalReadAmp(
   for (size_t i = start_index; i < first_index_after; i++) {
     auto& picking_sr = sorted_runs[i];
     if (picking_sr.level == 0) {
-      FileMetaData* picking_file = picking_sr.file;
-      inputs[0].files.push_back(picking_file);
+      inputs[0].files.insert(
+          inputs[0].files.end(), picking_sr.files.begin(), picking_sr.files.end());
     } else {
       auto& files = inputs[picking_sr.level - start_level].files;
       for (auto* f : vstorage->LevelFiles(picking_sr.level)) {
@@ -1708,6 +1886,7 @@ Compaction* UniversalCompactionPicker::PickCompactionUniversalReadAmp(
   } else {
     compaction_reason = CompactionReason::kUniversalSizeRatio;
   }
+  path_id = SelectOutputPathId(inputs, path_id);
   return new Compaction(
       vstorage, mutable_cf_options, std::move(inputs), output_level,
       mutable_cf_options.MaxFileSizeForLevel(output_level), LLONG_MAX, path_id,
@@ -1814,8 +1993,8 @@ Compaction* UniversalCompactionPicker::PickCompactionUniversalSizeAmp(
   for (size_t loop = start_index; loop < sorted_runs.size(); loop++) {
     auto& picking_sr = sorted_runs[loop];
     if (picking_sr.level == 0) {
-      FileMetaData* f = picking_sr.file;
-      inputs[0].files.push_back(f);
+      inputs[0].files.insert(
+          inputs[0].files.end(), picking_sr.files.begin(), picking_sr.files.end());
     } else {
       auto& files = inputs[picking_sr.level - start_level].files;
       for (auto* f : vstorage->LevelFiles(picking_sr.level)) {
@@ -1828,6 +2007,7 @@ Compaction* UniversalCompactionPicker::PickCompactionUniversalSizeAmp(
                 cf_name.c_str(), file_num_buf);
   }
 
+  path_id = SelectOutputPathId(inputs, path_id);
   return new Compaction(
       vstorage, mutable_cf_options, std::move(inputs),
       vstorage->num_levels() - 1,
@@ -259,6 +259,22 @@ class UniversalCompactionPicker : public CompactionPicker {
  private:
   struct SortedRun;
 
+  // Returns the number of the oldest files of level 0 that expired_files_selector picks for
+  // deletion, none of which is being compacted.
+  size_t NumExpiredFiles(const VersionStorageInfo& vstorage) const;
+
+  // Picks a deletion compaction of the files counted by NumExpiredFiles().
+  Compaction* PickCompactionUniversalExpiredFiles(
+      const std::string& cf_name, const MutableCFOptions& mutable_cf_options,
+      VersionStorageInfo* vstorage, LogBuffer* log_buffer);
+
+  // Picks a compaction of the first level 0 sorted run that has a file marked for compaction by
+  // a table properties collector, see TablePropertiesCollector::NeedCompact().
+  Compaction* PickCompactionUniversalMarkedFiles(
+      const std::string& cf_name, const MutableCFOptions& mutable_cf_options,
+      VersionStorageInfo* vstorage, const std::vector<std::vector<SortedRun>>& sorted_runs,
+      LogBuffer* log_buffer);
+
   Compaction* DoPickCompaction(
       const std::string& cf_name,
       const MutableCFOptions& mutable_cf_options,
@@ -266,6 +282,10 @@ class UniversalCompactionPicker : public CompactionPicker {
       LogBuffer* log_buffer,
       const std::vector<SortedRun>& sorted_runs);
 
+  // Whether the reads observed since the previous pick exceed
+  // CompactionOptionsUniversal::read_amp_compaction_trigger.
+  bool IsReadHot(const VersionStorageInfo& vstorage) const;
+
   // Pick Universal compaction to limit read amplification
   Compaction* PickCompactionUniversalReadAmp(
       const std::string& cf_name, const MutableCFOptions& mutable_cf_options,
@@ -294,6 +314,11 @@ class UniversalCompactionPicker : public CompactionPicker {
   // size.
   static uint32_t GetPathId(const ImmutableCFOptions& ioptions,
                             uint64_t file_size);
+
+  // Picks the output path ID of a compaction of the given inputs by compaction_output_path_selector
+  // if it is set. Returns path_id otherwise, or when some input has no user frontier.
+  uint32_t SelectOutputPathId(const std::vector<CompactionInputFiles>& inputs,
+                              uint32_t path_id) const;
 };
 
 class FIFOCompactionPicker : public CompactionPicker {
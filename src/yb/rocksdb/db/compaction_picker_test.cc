@@ -474,6 +474,79 @@ TEST_F(CompactionPickerTest, AllowsTrivialMoveUniversal) {
   ASSERT_TRUE(compaction->is_trivial_move());
 }
 
+// Tests that a read-hot column family is compacted by the number of sorted runs, even if their
+// sizes are not comparable.
+TEST_F(CompactionPickerTest, ReadHotUniversal) {
+  ioptions_.compaction_options_universal.read_amp_compaction_trigger = 4;
+  ioptions_.compaction_options_universal.read_amp_compaction_min_reads = 100;
+  UniversalCompactionPicker universal_compaction_picker(ioptions_, icmp_.get());
+
+  NewVersionStorage(1, kCompactionStyleUniversal);
+  const int num_files = mutable_cf_options_.level0_file_num_compaction_trigger + 1;
+  uint64_t file_size = 100;
+  for (int i = num_files; i > 0; --i) {
+    // Every file is 10 times larger than the next newer one.
+    Add(0, i, ToString(i * 100).c_str(), ToString(i * 100 + 99).c_str(), file_size, 0,
+        i * 100, i * 100 + 99);
+    file_size *= 10;
+  }
+  UpdateVersionStorageInfo();
+
+  std::unique_ptr<Compaction> compaction(universal_compaction_picker.PickCompaction(
+      cf_name_, mutable_cf_options_, vstorage_.get(), &log_buffer_));
+  ASSERT_TRUE(compaction == nullptr);
+
+  // Too few reads.
+  vstorage_->SetObservedReads(10, 5);
+  compaction.reset(universal_compaction_picker.PickCompaction(
+      cf_name_, mutable_cf_options_, vstorage_.get(), &log_buffer_));
+  ASSERT_TRUE(compaction == nullptr);
+
+  // Reads consult too few files.
+  vstorage_->SetObservedReads(1000, 3);
+  compaction.reset(universal_compaction_picker.PickCompaction(
+      cf_name_, mutable_cf_options_, vstorage_.get(), &log_buffer_));
+  ASSERT_TRUE(compaction == nullptr);
+
+  vstorage_->SetObservedReads(1000, 5);
+  compaction.reset(universal_compaction_picker.PickCompaction(
+      cf_name_, mutable_cf_options_, vstorage_.get(), &log_buffer_));
+  ASSERT_TRUE(compaction != nullptr);
+  // The newest sorted runs are merged, so that fewer than the trigger remain.
+  ASSERT_EQ(3U, compaction->num_input_files(0));
+  ASSERT_EQ(static_cast<uint64_t>(num_files), compaction->input(0, 0)->fd.GetNumber());
+}
+
+TEST_F(CompactionPickerTest, MarkedFilesUniversal) {
+  const uint64_t kFileSize = 100000;
+  mutable_cf_options_.level0_file_num_compaction_trigger = 4;
+  UniversalCompactionPicker universal_compaction_picker(ioptions_, icmp_.get());
+
+  NewVersionStorage(1, kCompactionStyleUniversal);
+  // Fewer sorted runs than the trigger, so nothing is compacted unless files are marked.
+  Add(0, 3U, "150", "200", kFileSize, 0, 300, 399);
+  Add(0, 2U, "150", "200", kFileSize, 0, 200, 299);
+  Add(0, 1U, "150", "200", kFileSize, 0, 100, 199);
+  UpdateVersionStorageInfo();
+  ASSERT_FALSE(universal_compaction_picker.NeedsCompaction(vstorage_.get()));
+
+  NewVersionStorage(1, kCompactionStyleUniversal);
+  Add(0, 3U, "150", "200", kFileSize, 0, 300, 399);
+  Add(0, 2U, "150", "200", kFileSize, 0, 200, 299);
+  Add(0, 1U, "150", "200", kFileSize, 0, 100, 199);
+  file_map_[2U].first->marked_for_compaction = true;
+  UpdateVersionStorageInfo();
+  ASSERT_TRUE(universal_compaction_picker.NeedsCompaction(vstorage_.get()));
+
+  std::unique_ptr<Compaction> compaction(universal_compaction_picker.PickCompaction(
+      cf_name_, mutable_cf_options_, vstorage_.get(), &log_buffer_));
+  ASSERT_TRUE(compaction != nullptr);
+  // Only the sorted run of the marked file is rewritten.
+  ASSERT_EQ(1U, compaction->num_input_files(0));
+  ASSERT_EQ(2U, compaction->input(0, 0)->fd.GetNumber());
+  ASSERT_EQ(CompactionReason::kFilesMarkedForCompaction, compaction->compaction_reason());
+}
+
 TEST_F(CompactionPickerTest, NeedsCompactionFIFO) {
   NewVersionStorage(1, kCompactionStyleFIFO);
   const int kFileCount =
@@ -829,6 +902,25 @@ TEST_F(CompactionPickerTest, EstimateCompactionBytesNeeded2) {
             vstorage_->estimated_compaction_needed_bytes());
 }
 
+TEST_F(CompactionPickerTest, EstimateCompactionBytesNeededUniversal) {
+  mutable_cf_options_.level0_file_num_compaction_trigger = 3;
+  NewVersionStorage(1, kCompactionStyleUniversal);
+  // Newest file first.
+  Add(0, 3U, "150", "200", 100, 0, 300, 399);
+  Add(0, 2U, "150", "200", 200, 0, 200, 299);
+  UpdateVersionStorageInfo();
+  // Fewer sorted runs than the trigger.
+  ASSERT_EQ(0u, vstorage_->estimated_compaction_needed_bytes());
+
+  NewVersionStorage(1, kCompactionStyleUniversal);
+  Add(0, 3U, "150", "200", 100, 0, 300, 399);
+  Add(0, 2U, "150", "200", 200, 0, 200, 299);
+  Add(0, 1U, "150", "200", 5000, 0, 100, 199);
+  UpdateVersionStorageInfo();
+  // The oldest sorted run is not counted.
+  ASSERT_EQ(300u, vstorage_->estimated_compaction_needed_bytes());
+}
+
 TEST_F(CompactionPickerTest, EstimateCompactionBytesNeededDynamicLevel) {
   int num_levels = ioptions_.num_levels;
   ioptions_.level_compaction_dynamic_level_bytes = true;
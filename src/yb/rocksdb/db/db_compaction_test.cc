@@ -26,6 +26,7 @@
 #include "yb/rocksdb/db/db_test_util.h"
 #include "yb/rocksdb/port/stack_trace.h"
 #include "yb/rocksdb/experimental.h"
+#include "yb/rocksdb/utilities/checkpoint.h"
 #include "yb/rocksdb/utilities/convenience.h"
 #include "yb/rocksdb/util/sync_point.h"
 #include "yb/rocksdb/util/testutil.h"
@@ -268,6 +269,69 @@ TEST_F(DBCompactionTest, LastFlushedOpIdWithCompaction) {
   TestFlushedOpId(true /* compact */, this);
 }
 
+TEST_F(DBCompactionTest, CompactionOutputPathSelector) {
+  constexpr int kColdFrontier = 10;
+  Options options = CurrentOptions(Options());
+  options.compaction_style = kCompactionStyleUniversal;
+  options.num_levels = 1;
+  options.level0_file_num_compaction_trigger = 2;
+  options.boundary_extractor = test::MakeBoundaryValuesExtractor();
+  options.db_paths.emplace_back(dbname_, std::numeric_limits<uint64_t>::max());
+  options.db_paths.emplace_back(dbname_ + "_cold", std::numeric_limits<uint64_t>::max());
+  options.compaction_output_path_selector = [](const UserFrontier& largest_frontier) {
+    return down_cast<const test::TestUserFrontier&>(largest_frontier).Value() <
+           static_cast<uint64_t>(kColdFrontier) ? 1 : 0;
+  };
+  DestroyAndReopen(options);
+
+  auto write = [this](int frontier) {
+    WriteBatch batch;
+    test::TestUserFrontiers frontiers(frontier, frontier);
+    batch.SetFrontiers(&frontiers);
+    batch.Put(Key(frontier), std::to_string(frontier));
+    ASSERT_OK(dbfull()->Write(WriteOptions(), &batch));
+    ASSERT_OK(dbfull()->TEST_FlushMemTable(true));
+  };
+
+  // Flushes always go to the first path.
+  write(1);
+  ASSERT_EQ(1, GetSstFileCount(dbname_));
+  write(2);
+  ASSERT_OK(dbfull()->TEST_WaitForCompact());
+  ASSERT_EQ(0, GetSstFileCount(dbname_));
+  ASSERT_EQ(1, GetSstFileCount(options.db_paths[1].path));
+
+  // Table files of all paths go into a checkpoint, and are moved back to their paths when the
+  // checkpoint is opened with its own paths.
+  const std::string checkpoint_dir = dbname_ + "_checkpoint";
+  Options checkpoint_options = options;
+  checkpoint_options.db_paths[0].path = checkpoint_dir;
+  checkpoint_options.db_paths[1].path = checkpoint_dir + "_cold";
+  ASSERT_OK(DestroyDB(checkpoint_dir, checkpoint_options));
+  ASSERT_OK(checkpoint::CreateCheckpoint(db_, checkpoint_dir));
+  ASSERT_EQ(1, GetSstFileCount(checkpoint_dir));
+
+  DB* checkpoint_db = nullptr;
+  ASSERT_OK(DB::Open(checkpoint_options, checkpoint_dir, &checkpoint_db));
+  ASSERT_EQ(0, GetSstFileCount(checkpoint_dir));
+  ASSERT_EQ(1, GetSstFileCount(checkpoint_options.db_paths[1].path));
+  for (int i : {1, 2}) {
+    std::string value;
+    ASSERT_OK(checkpoint_db->Get(ReadOptions(), Key(i), &value));
+    ASSERT_EQ(std::to_string(i), value);
+  }
+  delete checkpoint_db;
+  ASSERT_OK(DestroyDB(checkpoint_dir, checkpoint_options));
+
+  // A compaction that also has newer input stays in the first path.
+  write(kColdFrontier + 1);
+  ASSERT_OK(dbfull()->TEST_WaitForCompact());
+  ASSERT_EQ(1, GetSstFileCount(dbname_));
+  ASSERT_EQ(0, GetSstFileCount(options.db_paths[1].path));
+  ASSERT_EQ("1", Get(Key(1)));
+  ASSERT_EQ(std::to_string(kColdFrontier + 1), Get(Key(kColdFrontier + 1)));
+}
+
 TEST_F(DBCompactionTest, SkipStatsUpdateTest) {
   // This test verify UpdateAccumulatedStats is not on by observing
   // the compaction behavior when there are many of deletion entries.
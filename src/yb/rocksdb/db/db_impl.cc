@@ -209,6 +209,11 @@ DBOptions SanitizeOptions(const std::string& dbname, const DBOptions& src) {
     result.db_paths.emplace_back(dbname, std::numeric_limits<uint64_t>::max());
   }
 
+  if (result.use_direct_io_for_flush_and_compaction && result.compaction_readahead_size == 0) {
+    // Reads of compaction inputs bypass the OS page cache, so the kernel readahead does not help.
+    result.compaction_readahead_size = 2 * 1024 * 1024;
+  }
+
   if (result.compaction_readahead_size > 0) {
     result.new_table_reader_for_compaction_inputs = true;
   }
@@ -308,6 +313,8 @@ DBImpl::DBImpl(const DBOptions& options, const std::string& dbname)
       next_job_id_(1),
       has_unpersisted_data_(false),
       env_options_(db_options_),
+      env_options_for_compaction_(
+          env_->OptimizeForCompactionTableWrite(env_options_, db_options_)),
 #ifndef ROCKSDB_LITE
       wal_manager_(db_options_, env_options_),
 #endif  // ROCKSDB_LITE
@@ -1042,6 +1049,9 @@ Status DBImpl::Recover(
   }
 
   Status s = versions_->Recover(column_families, read_only);
+  if (s.ok() && !read_only && db_options_.db_paths.size() > 1) {
+    s = MoveTableFilesToTheirPaths();
+  }
   if (db_options_.paranoid_checks && s.ok()) {
     s = CheckConsistency();
   }
@@ -1483,7 +1493,7 @@ Status DBImpl::WriteLevel0TableForRecovery(int job_id, ColumnFamilyData* cfd,
         s = BuildTable(dbname_,
                        env_,
                        *cfd->ioptions(),
-                       env_options_,
+                       env_options_for_compaction_,
                        cfd->table_cache(),
                        iter.get(),
                        &meta,
@@ -1558,7 +1568,7 @@ Result<FileNumbersHolder> DBImpl::FlushMemTableToOutputFile(
   }
 
   FlushJob flush_job(
-      dbname_, cfd, db_options_, mutable_cf_options, env_options_,
+      dbname_, cfd, db_options_, mutable_cf_options, env_options_for_compaction_,
       versions_.get(), &mutex_, &shutting_down_, snapshot_seqs,
       earliest_write_conflict_snapshot, mem_table_flush_filter, pending_outputs_.get(),
       job_context, log_buffer, directories_.GetDbDir(), directories_.GetDataDir(0U),
@@ -1951,7 +1961,7 @@ Status DBImpl::CompactFilesImpl(
 
   assert(is_snapshot_supported_ || snapshots_.empty());
   CompactionJob compaction_job(
-      job_context->job_id, c.get(), db_options_, env_options_, versions_.get(),
+      job_context->job_id, c.get(), db_options_, env_options_for_compaction_, versions_.get(),
       &shutting_down_, log_buffer, directories_.GetDbDir(),
       directories_.GetDataDir(c->output_path_id()), stats_, &mutex_, &bg_error_,
       snapshot_seqs, earliest_write_conflict_snapshot, pending_outputs_.get(), table_cache_,
@@ -2542,6 +2552,26 @@ bool DBImpl::HasSomethingToFlush() {
   return cfd->imm()->NumNotFlushed() != 0 || !cfd->mem()->IsEmpty();
 }
 
+void DBImpl::ReleaseTableReaders() {
+  // With an unlimited table cache, the versions hold the readers of their files.
+  if (db_options_.max_open_files == -1) {
+    return;
+  }
+  std::vector<uint64_t> file_numbers;
+  {
+    InstrumentedMutexLock guard_lock(&mutex_);
+    const auto* vstorage = default_cf_handle_->cfd()->current()->storage_info();
+    for (int level = 0; level < vstorage->num_levels(); ++level) {
+      for (const auto* file : vstorage->LevelFiles(level)) {
+        file_numbers.push_back(file->fd.GetNumber());
+      }
+    }
+  }
+  for (auto number : file_numbers) {
+    TableCache::Evict(table_cache_.get(), number);
+  }
+}
+
 Status DBImpl::FlushMemTable(ColumnFamilyData* cfd,
                              const FlushOptions& flush_options) {
   Status s;
@@ -2686,7 +2716,9 @@ bool DBImpl::AddToCompactionQueue(ColumnFamilyData* cfd) {
     c = cfd->PickCompaction(*cfd->GetLatestMutableCFOptions(), &log_buffer);
     if (c) {
       cfd->Ref();
-      if (c->CalculateTotalInputSize() < db_options_.compaction_size_threshold_bytes) {
+      // Deletion compactions do not read their input files, so they are always small.
+      if (c->deletion_compaction() ||
+          c->CalculateTotalInputSize() < db_options_.compaction_size_threshold_bytes) {
         small_compaction_queue_.push_back(c);
       } else {
         large_compaction_queue_.push_back(c);
@@ -2756,6 +2788,8 @@ void DBImpl::SchedulePendingCompaction(ColumnFamilyData* cfd) {
 void DBImpl::RecordFlushIOStats() {
   RecordTick(stats_, FLUSH_WRITE_BYTES, IOSTATS(bytes_written));
   IOSTATS_RESET(bytes_written);
+  RecordTick(stats_, DIRECT_IO_WRITE_BYTES, IOSTATS(direct_bytes_written));
+  IOSTATS_RESET(direct_bytes_written);
 }
 
 void DBImpl::BGWorkFlush(void* db) {
@@ -3101,8 +3135,8 @@ Result<FileNumbersHolder> DBImpl::BackgroundCompaction(
     // file if there is alive snapshot pointing to it
     assert(c->num_input_files(1) == 0);
     assert(c->level() == 0);
-    assert(c->column_family_data()->ioptions()->compaction_style ==
-           kCompactionStyleFIFO);
+    assert(c->column_family_data()->ioptions()->compaction_style == kCompactionStyleFIFO ||
+           c->column_family_data()->ioptions()->compaction_style == kCompactionStyleUniversal);
 
     compaction_job_stats.num_input_files = c->num_input_files(0);
 
@@ -3188,7 +3222,7 @@ Result<FileNumbersHolder> DBImpl::BackgroundCompaction(
 
     assert(is_snapshot_supported_ || snapshots_.empty());
     CompactionJob compaction_job(
-        job_context->job_id, c.get(), db_options_, env_options_,
+        job_context->job_id, c.get(), db_options_, env_options_for_compaction_,
         versions_.get(), &shutting_down_, log_buffer, directories_.GetDbDir(),
         directories_.GetDataDir(c->output_path_id()), stats_, &mutex_,
         &bg_error_, snapshot_seqs, earliest_write_conflict_snapshot,
@@ -4578,8 +4612,9 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
     // 3. Deletes or SingleDeletes are not okay if filtering deletes
     //    (controlled by both batch and memtable setting)
     // 4. Merges are not okay
-    // 5. YugaByte-specific user-specified sequence numbers are currently not compatible with
-    //    parallel memtable writes.
+    //
+    // User frontiers of the batches are merged into the memtable under a mutex, so they do not
+    // prevent parallel writes.
     //
     // Rules 1..3 are enforced by checking the options
     // during startup (CheckConcurrentWritesSupported), so if
@@ -5202,7 +5237,7 @@ ColumnFamilyHandle* DBImpl::GetColumnFamilyHandleUnlocked(
   return cf_memtables->GetColumnFamilyHandle();
 }
 
-Status DBImpl::Import(const std::string& source_dir) {
+Status DBImpl::Import(const std::string& source_dir, UserFrontierPtr flushed_frontier) {
   const auto seqno = versions_->LastSequence();
   FlushOptions options;
   Flush(options);
@@ -5211,6 +5246,9 @@ Status DBImpl::Import(const std::string& source_dir) {
   if (!status.ok()) {
     return status;
   }
+  if (flushed_frontier) {
+    edit.ModifyFlushedFrontier(std::move(flushed_frontier), FrontierModificationMode::kUpdate);
+  }
   return ApplyVersionEdit(&edit);
 }
 
@@ -5531,6 +5569,50 @@ Status DBImpl::CheckConsistency() {
   }
 }
 
+Status DBImpl::MoveTableFilesToTheirPaths() {
+  mutex_.AssertHeld();
+  std::vector<LiveFileMetaData> metadata;
+  versions_->GetLiveFilesMetaData(&metadata);
+
+  const std::string& first_path = db_options_.db_paths[0].path;
+  for (const auto& md : metadata) {
+    if (md.db_path == first_path) {
+      continue;
+    }
+    // md.name has a leading "/".
+    std::vector<std::string> names = { md.name };
+    if (md.total_size > md.base_size) {
+      names.push_back(TableBaseToDataFileName(md.name));
+    }
+    for (const auto& name : names) {
+      const std::string source = first_path + name;
+      if (!env_->FileExists(source).ok()) {
+        continue;
+      }
+      const std::string target = md.db_path + name;
+      // The target exists if we were interrupted after the file was put in place.
+      if (!env_->FileExists(target).ok()) {
+        // Copy to a temporary file first, since the paths are usually on different devices.
+        const std::string temp_target = target + ".tmp";
+        Status s = CopyFile(env_, source, temp_target, 0 /* size */);
+        if (s.ok()) {
+          s = env_->RenameFile(temp_target, target);
+        }
+        if (!s.ok()) {
+          return s;
+        }
+        RLOG(InfoLogLevel::INFO_LEVEL, db_options_.info_log,
+            "Moved %s to %s", source.c_str(), target.c_str());
+      }
+      Status s = env_->DeleteFile(source);
+      if (!s.ok()) {
+        return s;
+      }
+    }
+  }
+  return Status::OK();
+}
+
 Status DBImpl::GetDbIdentity(std::string* identity) const {
   std::string idfilename = IdentityFileName(dbname_);
   const EnvOptions soptions;
@@ -5908,6 +5990,9 @@ Status DestroyDB(const std::string& dbname, const Options& options) {
           }
         }
       }
+      if (db_path.path != dbname) {
+        env->DeleteDir(db_path.path);  // Ignore error in case dir contains other files
+      }
     }
 
     std::vector<std::string> walDirFiles;
@@ -222,6 +222,8 @@ class DBImpl : public DB {
 
   bool HasSomethingToFlush() override;
 
+  void ReleaseTableReaders() override;
+
   // Obtains the meta data of the specified column family of the DB.
   // STATUS(NotFound, "") will be returned if the current DB does not have
   // any column family match the specified name.
@@ -466,7 +468,8 @@ class DBImpl : public DB {
   // Checks that source database has appropriate seqno.
   // I.e. seqno ranges of imported database does not overlap with seqno ranges of destination db.
   // And max seqno of imported database is less that active seqno of destination db.
-  CHECKED_STATUS Import(const std::string& source_dir) override;
+  CHECKED_STATUS Import(
+      const std::string& source_dir, UserFrontierPtr flushed_frontier = nullptr) override;
 
   // Used in testing to make the old memtable immutable and start writing to a new one.
   void TEST_SwitchMemtable() override;
@@ -535,6 +538,11 @@ class DBImpl : public DB {
   Status Recover(const std::vector<ColumnFamilyDescriptor>& column_families,
                  bool read_only = false, bool error_if_log_file_exist = false);
 
+  // Moves live table files that are found in the first DB path, but belong to another one, to the
+  // path they belong to. Such files appear when a copy of the DB, e.g. a checkpoint, is put into
+  // the first path only.
+  Status MoveTableFilesToTheirPaths();
+
   void MaybeIgnoreError(Status* s) const;
 
   const Status CreateArchivalDirectory();
@@ -907,6 +915,9 @@ class DBImpl : public DB {
   // The options to access storage files
   const EnvOptions env_options_;
 
+  // The options to write table files produced by flushes and compactions
+  const EnvOptions env_options_for_compaction_;
+
 #ifndef ROCKSDB_LITE
   WalManager wal_manager_;
 #endif  // ROCKSDB_LITE
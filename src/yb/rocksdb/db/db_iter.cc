@@ -247,6 +247,7 @@ inline bool DBIter::ParseKey(ParsedInternalKey* ikey) {
 
 void DBIter::Next() {
   assert(valid_);
+  PERF_COUNTER_ADD(iter_next_count, 1);
 
   if (direction_ == kReverse) {
     FindNextUserKey();
@@ -445,6 +446,7 @@ void DBIter::MergeValuesNewToOld() {
 
 void DBIter::Prev() {
   assert(valid_);
+  PERF_COUNTER_ADD(iter_prev_count, 1);
   if (direction_ == kForward) {
     ReverseToBackward();
   }
@@ -751,6 +753,7 @@ void DBIter::Seek(const Slice& target) {
   }
 
   RecordTick(statistics_, NUMBER_DB_SEEK);
+  PERF_COUNTER_ADD(iter_seek_count, 1);
   if (iter_->Valid()) {
     direction_ = kForward;
     ClearSavedValue();
@@ -784,6 +787,7 @@ void DBIter::SeekToFirst() {
   }
 
   RecordTick(statistics_, NUMBER_DB_SEEK);
+  PERF_COUNTER_ADD(iter_seek_count, 1);
   if (iter_->Valid()) {
     FindNextUserEntry(false /* not skipping */);
     if (statistics_ != nullptr) {
@@ -801,6 +805,7 @@ void DBIter::SeekToFirst() {
 }
 
 void DBIter::SeekToLast() {
+  PERF_COUNTER_ADD(iter_seek_count, 1);
   // Don't use iter_::Seek() if we set a prefix extractor
   // because prefix seek will be used.
   if (prefix_extractor_ != nullptr) {
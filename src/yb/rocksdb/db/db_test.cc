@@ -5323,6 +5323,43 @@ TEST_F(DBTest, ConcurrentMemtableNotSupported) {
 
 #endif  // ROCKSDB_LITE
 
+TEST_F(DBTest, ConcurrentMemtableWritesWithFrontiers) {
+  Options options = CurrentOptions();
+  options.allow_concurrent_memtable_write = true;
+  options.enable_write_thread_adaptive_yield = true;
+  DestroyAndReopen(options);
+
+  constexpr int kNumThreads = 8;
+  constexpr int kBatchesPerThread = 200;
+  std::vector<std::thread> threads;
+  for (int t = 0; t != kNumThreads; ++t) {
+    threads.emplace_back([this, t] {
+      WriteOptions write_options;
+      write_options.disableWAL = true;
+      for (int i = 0; i != kBatchesPerThread; ++i) {
+        const int index = t * kBatchesPerThread + i;
+        WriteBatch batch;
+        test::TestUserFrontiers frontiers(1 + index, 1 + index);
+        batch.SetFrontiers(&frontiers);
+        batch.Put(Key(index), std::to_string(index));
+        batch.Put(Key(index) + "_2", std::to_string(index));
+        ASSERT_OK(dbfull()->Write(write_options, &batch));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (int index = 0; index != kNumThreads * kBatchesPerThread; ++index) {
+    ASSERT_EQ(std::to_string(index), Get(Key(index)));
+    ASSERT_EQ(std::to_string(index), Get(Key(index) + "_2"));
+  }
+  ASSERT_OK(dbfull()->TEST_FlushMemTable(true));
+  ASSERT_EQ(static_cast<uint64_t>(kNumThreads * kBatchesPerThread),
+            down_cast<test::TestUserFrontier&>(*dbfull()->GetFlushedFrontier()).Value());
+}
+
 TEST_F(DBTest, SanitizeNumThreads) {
   for (int attempt = 0; attempt < 2; attempt++) {
     const size_t kTotalTasks = 8;
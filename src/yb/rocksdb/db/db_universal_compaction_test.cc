@@ -660,6 +660,66 @@ INSTANTIATE_TEST_CASE_P(DBTestUniversalCompactionParallel,
                         ::testing::Combine(::testing::Values(1, 10),
                                            ::testing::Bool()));
 
+class DBTestUniversalSubcompaction : public DBTestBase {
+ public:
+  DBTestUniversalSubcompaction() : DBTestBase("/db_universal_subcompaction_test") {}
+};
+
+// A compaction of a single level DB split into subcompactions writes several level 0 files with
+// disjoint key ranges. They should be handled as one sorted run by reads and later compactions.
+TEST_F(DBTestUniversalSubcompaction, SingleLevel) {
+  Options options = CurrentOptions();
+  options.compaction_style = kCompactionStyleUniversal;
+  options.num_levels = 1;
+  options.write_buffer_size = 4 << 20;  // 4MB
+  options.level0_file_num_compaction_trigger = 4;
+  options.max_subcompactions = 4;
+  options.min_subcompaction_size = 1;
+  DestroyAndReopen(options);
+
+  Random rnd(301);
+  constexpr int kNumKeys = 2000;
+  std::vector<std::string> values(kNumKeys);
+  // Every file covers the whole key range.
+  auto write_file = [&]() {
+    for (int i = 0; i < kNumKeys; i++) {
+      values[i] = RandomString(&rnd, 100);
+      ASSERT_OK(Put(Key(i), values[i]));
+    }
+    ASSERT_OK(Flush());
+  };
+  auto verify = [&]() {
+    for (int i = 0; i < kNumKeys; i++) {
+      ASSERT_EQ(values[i], Get(Key(i)));
+    }
+  };
+
+  write_file();
+  write_file();
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_OK(dbfull()->TEST_WaitForCompact());
+  const int num_outputs = NumTableFilesAtLevel(0);
+  ASSERT_GT(num_outputs, 1);
+  ASSERT_LE(num_outputs, 4);
+  verify();
+
+  // The outputs are counted as one sorted run, so two more files do not trigger a compaction.
+  write_file();
+  write_file();
+  ASSERT_OK(dbfull()->TEST_WaitForCompact());
+  ASSERT_EQ(num_outputs + 2, NumTableFilesAtLevel(0));
+  verify();
+
+  // The fourth sorted run triggers a compaction of all of them.
+  write_file();
+  ASSERT_OK(dbfull()->TEST_WaitForCompact());
+  ASSERT_LE(NumTableFilesAtLevel(0), 4);
+  verify();
+
+  Reopen(options);
+  verify();
+}
+
 TEST_P(DBTestUniversalCompaction, UniversalCompactionOptions) {
   Options options;
   options.compaction_style = kCompactionStyleUniversal;
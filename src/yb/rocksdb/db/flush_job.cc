@@ -69,6 +69,7 @@
 #include "yb/rocksdb/util/sync_point.h"
 #include "yb/rocksdb/util/thread_status_util.h"
 
+#include "yb/util/io_accounting.h"
 #include "yb/util/logging.h"
 
 DEFINE_int32(rocksdb_nothing_in_memtable_to_flush_sleep_ms, 10,
@@ -127,6 +128,7 @@ void FlushJob::ReportStartedFlush() {
       ThreadStatus::COMPACTION_JOB_ID,
       job_context_->job_id);
   IOSTATS_RESET(bytes_written);
+  IOSTATS_RESET(direct_bytes_written);
 }
 
 void FlushJob::ReportFlushInputSize(const autovector<MemTable*>& mems) {
@@ -147,6 +149,7 @@ void FlushJob::RecordFlushIOStats() {
 Result<FileNumbersHolder> FlushJob::Run(FileMetaData* file_meta) {
   AutoThreadOperationStageUpdater stage_run(
       ThreadStatus::STAGE_FLUSH_RUN);
+  yb::ScopedIOAccounting io_accounting(db_options_.flush_io_metrics.get());
   // Save the contents of the earliest memtable as a new Table
   FileMetaData meta;
   autovector<MemTable*> mems;
@@ -231,6 +231,20 @@ class InternalStats {
     return &file_read_latency_[level];
   }
 
+  // Records a point lookup or an iterator that consulted num_files SST files.
+  void AddSstRead(size_t num_files) {
+    num_sst_reads_.fetch_add(1, std::memory_order_relaxed);
+    num_sst_read_files_.fetch_add(num_files, std::memory_order_relaxed);
+  }
+
+  // Returns the average number of SST files consulted per read since the previous call, and
+  // the number of those reads in *num_reads. Returns 0 if there were no reads.
+  double TakeSstFilesPerRead(uint64_t* num_reads) {
+    *num_reads = num_sst_reads_.exchange(0, std::memory_order_relaxed);
+    const uint64_t num_files = num_sst_read_files_.exchange(0, std::memory_order_relaxed);
+    return *num_reads == 0 ? 0 : static_cast<double>(num_files) / *num_reads;
+  }
+
   uint64_t GetBackgroundErrorCount() const { return bg_error_count_; }
 
   uint64_t BumpAndGetBackgroundErrorCount() { return ++bg_error_count_; }
@@ -260,6 +274,9 @@ class InternalStats {
   // Per-ColumnFamily/level compaction stats
   std::vector<CompactionStats> comp_stats_;
   std::vector<HistogramImpl> file_read_latency_;
+  // Number of reads and SST files consulted by them since the last TakeSstFilesPerRead.
+  std::atomic<uint64_t> num_sst_reads_{0};
+  std::atomic<uint64_t> num_sst_read_files_{0};
 
   // Used to compute per-interval statistics
   struct CFStatsSnapshot {
@@ -439,6 +456,13 @@ class InternalStats {
 
   HistogramImpl* GetFileReadHist(int level) { return nullptr; }
 
+  void AddSstRead(size_t num_files) {}
+
+  double TakeSstFilesPerRead(uint64_t* num_reads) {
+    *num_reads = 0;
+    return 0;
+  }
+
   uint64_t GetBackgroundErrorCount() const { return 0; }
 
   uint64_t BumpAndGetBackgroundErrorCount() { return 0; }
@@ -30,6 +30,7 @@
 #include <deque>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -340,7 +341,9 @@ class MemTable {
 
   const MemTableOptions* GetMemTableOptions() const { return &moptions_; }
 
+  // Could be called concurrently by the writers of a parallel write group.
   void UpdateFrontiers(const UserFrontiers& value) {
+    std::lock_guard<std::mutex> lock(frontiers_mutex_);
     if (frontiers_) {
       frontiers_->MergeFrontiers(value);
     } else {
@@ -401,6 +404,7 @@ class MemTable {
 
   Env* env_;
 
+  std::mutex frontiers_mutex_;
   std::unique_ptr<UserFrontiers> frontiers_;
 
   // Returns a heuristic flush decision
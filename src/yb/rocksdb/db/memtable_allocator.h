@@ -23,6 +23,8 @@
 //
 // This is used by the MemTable to allocate write buffer memory. It connects
 // to WriteBuffer so we can track and enforce overall write buffer limits.
+// It is thread-safe when the wrapped allocator is, MemTable wraps its ConcurrentArena so that
+// parallel write group members could insert concurrently.
 
 #pragma once
 
@@ -437,6 +437,28 @@ Status TableCache::GetTableProperties(
   return s;
 }
 
+Status TableCache::GetSampleKeys(
+    const EnvOptions& env_options,
+    const InternalKeyComparatorPtr& internal_comparator, const FileDescriptor& fd,
+    size_t max_keys, std::vector<std::string>* keys) {
+  auto table_reader = fd.table_reader;
+  // table already been pre-loaded?
+  if (table_reader) {
+    return table_reader->GetSampleKeys(max_keys, keys);
+  }
+
+  Cache::Handle* table_handle = nullptr;
+  Status s = FindTable(env_options, internal_comparator, fd, &table_handle, kDefaultQueryId);
+  if (!s.ok()) {
+    return s;
+  }
+  assert(table_handle);
+  auto table = GetTableReaderFromHandle(table_handle);
+  s = table->GetSampleKeys(max_keys, keys);
+  ReleaseHandle(table_handle);
+  return s;
+}
+
 size_t TableCache::GetMemoryUsageByTableReader(
     const EnvOptions& env_options,
     const InternalKeyComparatorPtr& internal_comparator,
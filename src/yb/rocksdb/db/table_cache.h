@@ -132,6 +132,13 @@ class TableCache {
                             std::shared_ptr<const TableProperties>* properties,
                             bool no_io = false);
 
+  // Append up to max_keys keys sampled from the table of the given file, see
+  // TableReader::GetSampleKeys.
+  Status GetSampleKeys(const EnvOptions& toptions,
+                       const InternalKeyComparatorPtr& internal_comparator,
+                       const FileDescriptor& fd, size_t max_keys,
+                       std::vector<std::string>* keys);
+
   // Return total memory usage of the table reader of the file.
   // 0 if table reader of the file is not loaded.
   size_t GetMemoryUsageByTableReader(
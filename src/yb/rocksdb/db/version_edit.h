@@ -139,6 +139,14 @@ struct FileMetaData {
   std::string ToString() const;
 };
 
+// Returns true if the level 0 file `older`, that follows `newer` in the newest first order of
+// level 0, belongs to the same sorted run. Level 0 files normally have disjoint seqno ranges, but
+// the outputs of a compaction split into subcompactions share the seqno range of the compaction
+// input, and have disjoint key ranges instead.
+inline bool InSameLevel0SortedRun(const FileMetaData& newer, const FileMetaData& older) {
+  return older.largest.seqno >= newer.smallest.seqno;
+}
+
 class VersionEdit {
  public:
   VersionEdit() { Clear(); }
@@ -563,6 +563,21 @@ class BaseReferencedVersionBuilder {
   VersionBuilder* version_builder_;
   Version* version_;
 };
+
+// Counts the SST files consulted by a point lookup and records them in the column family stats
+// when the lookup completes.
+class SstReadRecorder {
+ public:
+  explicit SstReadRecorder(InternalStats* internal_stats) : internal_stats_(internal_stats) {}
+
+  ~SstReadRecorder() { internal_stats_->AddSstRead(num_files_); }
+
+  void AddFile() { ++num_files_; }
+
+ private:
+  InternalStats* internal_stats_;
+  size_t num_files_ = 0;
+};
 }  // anonymous namespace
 
 Status Version::GetTableProperties(std::shared_ptr<const TableProperties>* tp,
@@ -800,6 +815,8 @@ void Version::AddIterators(const ReadOptions& read_options,
   }
 
   auto* arena = merge_iter_builder->GetArena();
+  // Every seek of the iterator consults one file per level zero iterator and per other level.
+  size_t num_files = 0;
 
   // Merge all level zero files together since they may overlap
   for (size_t i = 0; i < storage_info_.LevelFilesBrief(0).num_files; i++) {
@@ -822,6 +839,7 @@ void Version::AddIterators(const ReadOptions& read_options,
       }
       if (file_iter) {
         merge_iter_builder->AddIterator(file_iter);
+        ++num_files;
       }
     }
   }
@@ -831,6 +849,7 @@ void Version::AddIterators(const ReadOptions& read_options,
   // lazily.
   for (int level = 1; level < storage_info_.num_non_empty_levels(); level++) {
     if (storage_info_.LevelFilesBrief(level).num_files != 0) {
+      ++num_files;
       auto* mem = arena->AllocateAligned(sizeof(LevelFileIteratorState));
       auto* state = new (mem)
           LevelFileIteratorState(cfd_->table_cache(), read_options, soptions,
@@ -845,6 +864,7 @@ void Version::AddIterators(const ReadOptions& read_options,
       merge_iter_builder->AddIterator(NewTwoLevelIterator(state, first_level_iter, arena, false));
     }
   }
+  cfd_->internal_stats()->AddSstRead(num_files);
 }
 
 VersionStorageInfo::VersionStorageInfo(
@@ -931,6 +951,7 @@ void Version::Get(const ReadOptions& read_options, const LookupKey& k,
       user_comparator(), merge_operator_, info_log_, db_statistics_,
       status->ok() ? GetContext::kNotFound : GetContext::kMerge, user_key,
       value, value_found, merge_context, this->env_, seq);
+  SstReadRecorder read_recorder(cfd_->internal_stats());
 
   FilePicker fp(
       storage_info_.files_, user_key, ikey, &storage_info_.level_files_brief_,
@@ -938,6 +959,7 @@ void Version::Get(const ReadOptions& read_options, const LookupKey& k,
       user_comparator(), internal_comparator().get());
   FdWithBoundaries* f = fp.GetNextFile();
   while (f != nullptr) {
+    read_recorder.AddFile();
     *status = table_cache_->Get(
         read_options, internal_comparator(), f->fd, ikey, &get_context,
         cfd_->internal_stats()->GetFileReadHist(fp.GetHitFileLevel()),
@@ -1160,7 +1182,36 @@ int VersionStorageInfo::MaxInputLevel() const {
 
 void VersionStorageInfo::EstimateCompactionBytesNeeded(
     const MutableCFOptions& mutable_cf_options) {
-  // Only implemented for level-based compaction
+  if (compaction_style_ == kCompactionStyleUniversal) {
+    // Every level 0 file and every non-empty level above it is a sorted run. Once there are
+    // level0_file_num_compaction_trigger sorted runs they get merged, and the oldest run is usually
+    // large enough to be left alone, so estimate that all the other runs are rewritten.
+    int num_sorted_runs = 0;
+    uint64_t total_size = 0;
+    uint64_t oldest_run_size = 0;
+    for (auto* f : files_[0]) {
+      ++num_sorted_runs;
+      oldest_run_size = f->fd.GetTotalFileSize();
+      total_size += oldest_run_size;
+    }
+    for (int level = 1; level < num_levels(); level++) {
+      if (files_[level].empty()) {
+        continue;
+      }
+      ++num_sorted_runs;
+      oldest_run_size = 0;
+      for (auto* f : files_[level]) {
+        oldest_run_size += f->fd.GetTotalFileSize();
+      }
+      total_size += oldest_run_size;
+    }
+    estimated_compaction_needed_bytes_ =
+        num_sorted_runs >= mutable_cf_options.level0_file_num_compaction_trigger
+            ? total_size - oldest_run_size : 0;
+    return;
+  }
+
+  // Only implemented for level-based and universal compaction
   if (compaction_style_ != kCompactionStyleLevel) {
     estimated_compaction_needed_bytes_ = 0;
     return;
@@ -1234,11 +1285,16 @@ void VersionStorageInfo::ComputeCompactionScore(
       // overwrites/deletions).
       int num_sorted_runs = 0;
       uint64_t total_size = 0;
+      const FileMetaData* prev_file = nullptr;
       for (auto* f : files_[level]) {
         if (!f->being_compacted) {
           total_size += f->compensated_file_size;
-          num_sorted_runs++;
+          // Level 0 files that form one sorted run are counted once.
+          if (prev_file == nullptr || !InSameLevel0SortedRun(*prev_file, *f)) {
+            num_sorted_runs++;
+          }
         }
+        prev_file = f;
       }
       if (compaction_style_ == kCompactionStyleUniversal) {
         // For universal compaction, we use level0 score to indicate
@@ -1870,14 +1926,16 @@ void VersionStorageInfo::CalculateBaseBytes(const ImmutableCFOptions& ioptions,
                                             const MutableCFOptions& options) {
   // Special logic to set number of sorted runs.
   // It is to match the previous behavior when all files are in L0.
+  // Level 0 files that form one sorted run are counted once, see InSameLevel0SortedRun.
   int num_l0_count = 0;
-  if (options.max_file_size_for_compaction == std::numeric_limits<uint64_t>::max()) {
-    num_l0_count = static_cast<int>(files_[0].size());
-  } else {
-    for (const auto& file : files_[0]) {
-      if (file->fd.GetTotalFileSize() <= options.max_file_size_for_compaction) {
-        ++num_l0_count;
-      }
+  for (size_t i = 0; i < files_[0].size();) {
+    uint64_t sorted_run_size = 0;
+    do {
+      sorted_run_size += files_[0][i]->fd.GetTotalFileSize();
+      ++i;
+    } while (i < files_[0].size() && InSameLevel0SortedRun(*files_[0][i - 1], *files_[0][i]));
+    if (sorted_run_size <= options.max_file_size_for_compaction) {
+      ++num_l0_count;
     }
   }
   if (compaction_style_ == kCompactionStyleUniversal) {
@@ -2080,7 +2138,8 @@ VersionSet::VersionSet(const std::string& dbname, const DBOptions* db_options,
       dbname_(dbname),
       db_options_(db_options),
       env_options_(storage_options),
-      env_options_compactions_(env_options_) {}
+      env_options_compactions_(
+          env_->OptimizeForCompactionTableRead(env_options_, *db_options_)) {}
 
 VersionSet::~VersionSet() {
   // we need to delete column_family_set_ because its destructor depends on
@@ -2824,7 +2883,12 @@ Status VersionSet::Import(const std::string& source_dir,
     return status;
   }
   std::vector<FileMetaData> files;
-  std::vector<std::pair<SequenceNumber, SequenceNumber>> segments;
+  struct SeqNoSegment {
+    SequenceNumber smallest;
+    SequenceNumber largest;
+    bool imported;
+  };
+  std::vector<SeqNoSegment> segments;
   for (;;) {
     status = manifest_reader.Next();
     if (!status.ok()) {
@@ -2846,7 +2910,7 @@ Status VersionSet::Import(const std::string& source_dir,
                              seqno);
       }
       files.push_back(filemeta);
-      segments.emplace_back(filemeta.smallest.seqno, filemeta.largest.seqno);
+      segments.push_back({filemeta.smallest.seqno, filemeta.largest.seqno, true});
     }
   }
   if (!status.IsEndOfFile()) {
@@ -2860,22 +2924,28 @@ Status VersionSet::Import(const std::string& source_dir,
   std::vector<LiveFileMetaData> live_files;
   GetLiveFilesMetaData(&live_files);
   for (const auto& file : live_files) {
-    segments.emplace_back(file.smallest.seqno, file.largest.seqno);
+    segments.push_back({file.smallest.seqno, file.largest.seqno, false});
   }
 
   std::sort(segments.begin(), segments.end(), [](const auto& lhs, const auto& rhs) {
-    return lhs.first < rhs.first;
+    return lhs.smallest < rhs.smallest;
   });
+  // Files of the same DB could have overlapping seqno ranges when they are the outputs of one
+  // compaction split into subcompactions, so only check imported files against live ones.
   auto prev = segments.front();
   for (size_t i = 1; i != segments.size(); ++i) {
     const auto& segment = segments[i];
-    if (segment.first <= prev.second) {
-      return STATUS_FORMAT(Corruption,
-                           "Overlapping seqno ranges: [$0, $1] and [$2, $3]",
-                           prev.first,
-                           prev.second,
-                           segment.first,
-                           segment.second);
+    if (segment.smallest <= prev.largest) {
+      if (segment.imported != prev.imported) {
+        return STATUS_FORMAT(Corruption,
+                             "Overlapping seqno ranges: [$0, $1] and [$2, $3]",
+                             prev.smallest,
+                             prev.largest,
+                             segment.smallest,
+                             segment.largest);
+      }
+      prev.largest = std::max(prev.largest, segment.largest);
+      continue;
     }
     prev = segment;
   }
@@ -3542,7 +3612,7 @@ InternalIterator* VersionSet::MakeInputIterator(Compaction* c) {
         // Create concatenating iterator for the files from this level
         list[num++] = NewTwoLevelIterator(
             new LevelFileIteratorState(
-                cfd->table_cache(), read_options, env_options_,
+                cfd->table_cache(), read_options, env_options_compactions_,
                 cfd->internal_comparator(),
                 nullptr /* no per level latency histogram */,
                 true /* for_compaction */, false /* prefix enabled */,
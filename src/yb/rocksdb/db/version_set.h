@@ -227,6 +227,17 @@ class VersionStorageInfo {
 
   void set_l0_delay_trigger_count(int v) { l0_delay_trigger_count_ = v; }
 
+  // Reads of the column family observed since the previous compaction pick, set right before
+  // picking a compaction of this version.
+  void SetObservedReads(uint64_t num_reads, double sst_files_per_read) {
+    observed_num_reads_ = num_reads;
+    observed_sst_files_per_read_ = sst_files_per_read;
+  }
+
+  uint64_t observed_num_reads() const { return observed_num_reads_; }
+
+  double observed_sst_files_per_read() const { return observed_sst_files_per_read_; }
+
   // REQUIRES: This version has been saved (see VersionSet::SaveTo)
   int NumLevelFiles(int level) const {
     assert(finalized_);
@@ -405,6 +416,9 @@ class VersionStorageInfo {
   int l0_delay_trigger_count_ = 0;  // Count used to trigger slow down and stop
                                     // for number of L0 files.
 
+  uint64_t observed_num_reads_ = 0;
+  double observed_sst_files_per_read_ = 0;
+
   // the following are the sampled temporary stats.
   // the current accumulated size of sampled files.
   uint64_t accumulated_file_size_;
@@ -812,7 +826,7 @@ class VersionSet {
   const EnvOptions& env_options_;
 
   // env options used for compactions. This is a copy of
-  // env_options_ but with readaheads set to readahead_compactions_.
+  // env_options_ optimized for reading table files that are compaction inputs.
   const EnvOptions env_options_compactions_;
 
   // No copying allowed
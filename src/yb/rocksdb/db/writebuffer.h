@@ -50,7 +50,8 @@ class WriteBuffer {
     return buffer_size() > 0 && memory_usage() >= buffer_size();
   }
 
-  // Should only be called from write thread
+  // Called by the memtable allocators, concurrently if memtable writes of a write group are
+  // performed in parallel.
   void ReserveMem(size_t mem) {
     memory_used_.fetch_add(mem, std::memory_order_relaxed);
     if (memory_monitor_) {
@@ -105,6 +105,12 @@ struct EnvOptions {
   // If true, then use mmap to write data
   bool use_mmap_writes = true;
 
+  // If true, then open random access files with O_DIRECT, so reads bypass the OS page cache
+  bool use_direct_reads = false;
+
+  // If true, then open writable files with O_DIRECT, so writes bypass the OS page cache
+  bool use_direct_writes = false;
+
   // If false, fallocate() calls are bypassed
   bool allow_fallocate = true;
 
@@ -387,6 +393,16 @@ class Env {
   // files. Default implementation returns the copy of the same object.
   virtual EnvOptions OptimizeForManifestWrite(const EnvOptions& env_options)
       const;
+  // OptimizeForCompactionTableWrite will create a new EnvOptions object that is
+  // a copy of the EnvOptions in the parameters, but is optimized for writing
+  // table files produced by flushes and compactions.
+  virtual EnvOptions OptimizeForCompactionTableWrite(const EnvOptions& env_options,
+                                                     const DBOptions& db_options) const;
+  // OptimizeForCompactionTableRead will create a new EnvOptions object that is
+  // a copy of the EnvOptions in the parameters, but is optimized for reading
+  // table files that are compaction inputs.
+  virtual EnvOptions OptimizeForCompactionTableRead(const EnvOptions& env_options,
+                                                    const DBOptions& db_options) const;
 
   // Returns the status of all threads that belong to the current Env.
   virtual Status GetThreadList(std::vector<ThreadStatus>* thread_list) {
@@ -452,6 +468,18 @@ class SequentialFile {
   }
 };
 
+// A single read of a RandomAccessFile::MultiRead batch.
+struct ReadRequest {
+  uint64_t offset = 0;
+  size_t n = 0;
+  // Buffer of at least n bytes, that the result may point into.
+  char* scratch = nullptr;
+
+  // Filled by MultiRead, same as the result and the returned status of Read.
+  Slice result;
+  Status status;
+};
+
 // A file abstraction for randomly reading the contents of a file.
 class RandomAccessFile : public File {
  public:
@@ -470,6 +498,20 @@ class RandomAccessFile : public File {
   virtual Status Read(uint64_t offset, size_t n, Slice* result,
                       char* scratch) const = 0;
 
+  // Performs all reads of the batch, filling result and status of each request as Read does.
+  // Implementations could submit the whole batch at once, so independent reads are served by the
+  // device in parallel. Returns a non-OK status only if the batch could not be processed at all.
+  // The default implementation performs the reads one by one.
+  //
+  // Safe for concurrent use by multiple threads.
+  virtual Status MultiRead(ReadRequest* requests, size_t num_requests) const;
+
+  // Asks the OS to read the given range of the file into its cache in the background, so that
+  // following reads of it do not wait for the device.
+  virtual Status Prefetch(uint64_t offset, size_t n) const {
+    return STATUS(NotSupported, "Prefetch not supported.");
+  }
+
   // Used by the file_reader_writer to decide if the ReadAhead wrapper
   // should simply forward the call and do not enact buffering or locking.
   virtual bool ShouldForwardRawRequest() const {
@@ -1006,6 +1048,11 @@ class WritableFileWrapper : public WritableFile {
  public:
   explicit WritableFileWrapper(WritableFile* t) : target_(t) { }
 
+  bool UseOSBuffer() const override { return target_->UseOSBuffer(); }
+  bool UseDirectIO() const override { return target_->UseDirectIO(); }
+  size_t GetRequiredBufferAlignment() const override {
+    return target_->GetRequiredBufferAlignment();
+  }
   Status Append(const Slice& data) override { return target_->Append(data); }
   Status PositionedAppend(const Slice& data, uint64_t offset) override {
     return target_->PositionedAppend(data, offset);
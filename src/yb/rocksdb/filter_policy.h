@@ -148,6 +148,11 @@ class FilterPolicy {
 
     // Transform a key.
     virtual Slice Transform(Slice key) const = 0;
+
+    // Returns whether a lookup by the given key could be checked against the filter. A lookup key
+    // could identify the keys it is interested in less precisely than their transformed keys do,
+    // i.e. a lookup by a key prefix, so that its own transformed key would not match theirs.
+    virtual bool IsFilterableLookupKey(Slice key) const { return true; }
   };
 
   // Filter policy can optionally return key transformer to be used before writing key to filter or
@@ -191,6 +196,15 @@ class FilterPolicy {
 extern const FilterPolicy* NewBloomFilterPolicy(int bits_per_key,
     bool use_block_based_builder = true);
 
+// Encodings of the bits of fixed-size filter blocks.
+enum class FixedSizeFilterFormat {
+  // The probes of a key are spread over a cache line by double hashing, with a division per probe.
+  kDefault,
+  // The probes of a key are computed by multiplication and tested at once with a mask of the cache
+  // line. Not readable by versions that predate it, which let all keys through such filters.
+  kFastLocal,
+};
+
 // Return a new filter policy that uses a bloom filter divided into fixed-size blocks with
 // specified parameters:
 //
@@ -198,12 +212,13 @@ extern const FilterPolicy* NewBloomFilterPolicy(int bits_per_key,
 // some metadata added.
 // error_rate: expected false positive error rate to calculate maximum number of keys to store in
 // each filter block. This is used to determine whether a filter block is full.
+// format: encoding of the filter blocks built by the policy. Filter blocks of all formats are read.
 //
 // Callers must delete the result after any database that is using the filter policy has been
 // closed.
-extern const FilterPolicy* NewFixedSizeFilterPolicy(uint32_t total_bits,
-                                                    double error_rate,
-                                                    Logger* logger);
+extern const FilterPolicy* NewFixedSizeFilterPolicy(
+    uint32_t total_bits, double error_rate, Logger* logger,
+    FixedSizeFilterFormat format = FixedSizeFilterFormat::kDefault);
 }  // namespace rocksdb
 
 #endif  // YB_ROCKSDB_FILTER_POLICY_H
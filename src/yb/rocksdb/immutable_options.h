@@ -84,6 +84,10 @@ struct ImmutableCFOptions {
 
   std::vector<DbPath> db_paths;
 
+  CompactionOutputPathSelector compaction_output_path_selector;
+
+  ExpiredFilesSelector expired_files_selector;
+
   MemTableRepFactory* memtable_factory;
 
   TableFactory* table_factory;
@@ -111,6 +115,12 @@ struct ImmutableCFOptions {
 
   CompressionOptions compression_opts;
 
+  uint64_t large_compaction_threshold_bytes;
+
+  CompressionType large_compaction_compression;
+
+  CompressionOptions large_compaction_compression_opts;
+
   bool level_compaction_dynamic_level_bytes;
 
   Options::AccessHint access_hint_on_compaction_start;
@@ -42,6 +42,10 @@ struct IOStatsContext {
   uint64_t bytes_written;
   // number of bytes that has been read.
   uint64_t bytes_read;
+  // number of bytes that has been written with direct I/O, bypassing the OS page cache.
+  uint64_t direct_bytes_written;
+  // number of bytes that has been read with direct I/O, bypassing the OS page cache.
+  uint64_t direct_bytes_read;
 
   // time spent in open() and fopen().
   uint64_t open_nanos;
@@ -74,6 +74,8 @@ enum class CompactionReason {
   kManualCompaction,
   // DB::SuggestCompactRange() marked files for compaction
   kFilesMarkedForCompaction,
+  // [Universal] Deleting the files picked by expired_files_selector
+  kUniversalExpiredFiles,
 };
 
 #ifndef ROCKSDB_LITE
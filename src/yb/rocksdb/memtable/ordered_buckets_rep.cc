@@ -0,0 +1,258 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <algorithm>
+#include <atomic>
+
+#include "yb/rocksdb/db/inlineskiplist.h"
+#include "yb/rocksdb/db/memtable.h"
+#include "yb/rocksdb/memtablerep.h"
+#include "yb/rocksdb/util/arena.h"
+
+namespace rocksdb {
+namespace {
+
+// Keys are split into buckets by a monotonic function of their user key, and each bucket is a skip
+// list. All the keys of a bucket are ordered before the keys of the following buckets, so iteration
+// goes over the buckets in order, while inserts and seeks only traverse the list of one bucket.
+class OrderedBucketsRep : public MemTableRep {
+ public:
+  typedef InlineSkipList<const MemTableRep::KeyComparator&> Bucket;
+
+  OrderedBucketsRep(const MemTableRep::KeyComparator& compare, MemTableAllocator* allocator,
+                    size_t num_buckets, const OrderedBucketFunction& bucket_function)
+      : MemTableRep(allocator), compare_(compare), num_buckets_(num_buckets),
+        bucket_function_(bucket_function) {
+    auto mem = allocator->AllocateAligned(sizeof(std::atomic<Bucket*>) * num_buckets_);
+    buckets_ = new (mem) std::atomic<Bucket*>[num_buckets_];
+    for (size_t i = 0; i != num_buckets_; ++i) {
+      buckets_[i].store(nullptr, std::memory_order_relaxed);
+    }
+    // Nodes are allocated before their keys are filled in, so before their bucket is known. All the
+    // lists have the same height, branching factor and allocator, so a node allocated by one of
+    // them could be linked into any other one.
+    allocating_bucket_ = NewBucket();
+    buckets_[0].store(allocating_bucket_, std::memory_order_release);
+  }
+
+  KeyHandle Allocate(const size_t len, char** buf) override {
+    *buf = allocating_bucket_->AllocateKey(len);
+    return static_cast<KeyHandle>(*buf);
+  }
+
+  void Insert(KeyHandle handle) override {
+    auto* key = static_cast<char*>(handle);
+    GetOrCreateBucket(BucketIndex(key))->Insert(key);
+  }
+
+  void InsertConcurrently(KeyHandle handle) override {
+    auto* key = static_cast<char*>(handle);
+    GetOrCreateBucket(BucketIndex(key))->InsertConcurrently(key);
+  }
+
+  bool Contains(const char* key) const override {
+    auto* bucket = GetBucket(BucketIndex(key));
+    return bucket != nullptr && bucket->Contains(key);
+  }
+
+  size_t ApproximateMemoryUsage() override {
+    // All memory is allocated through allocator; nothing to report here
+    return 0;
+  }
+
+  void Get(const LookupKey& k, void* callback_args,
+           bool (*callback_func)(void* arg, const char* entry)) override {
+    auto* bucket = GetBucket(Clamp(bucket_function_(k.user_key())));
+    if (bucket == nullptr) {
+      return;
+    }
+    // Versions of a user key are always in the same bucket.
+    Bucket::Iterator iter(bucket);
+    for (iter.Seek(k.memtable_key().cdata());
+         iter.Valid() && callback_func(callback_args, iter.key());
+         iter.Next()) {
+    }
+  }
+
+  MemTableRep::Iterator* GetIterator(Arena* arena = nullptr) override {
+    void* mem = arena ? arena->AllocateAligned(sizeof(Iterator))
+                      : operator new(sizeof(Iterator));
+    return new (mem) Iterator(this);
+  }
+
+ private:
+  class Iterator : public MemTableRep::Iterator {
+   public:
+    explicit Iterator(const OrderedBucketsRep* rep)
+        : rep_(rep), iter_(rep->GetBucket(0)) {}
+
+    bool Valid() const override {
+      return bucket_index_ < rep_->num_buckets_ && iter_.Valid();
+    }
+
+    const char* key() const override {
+      return iter_.key();
+    }
+
+    void Next() override {
+      iter_.Next();
+      if (!iter_.Valid()) {
+        SeekToFirstOfBucketsFrom(bucket_index_ + 1);
+      }
+    }
+
+    void Prev() override {
+      iter_.Prev();
+      if (!iter_.Valid()) {
+        SeekToLastOfBucketsBefore(bucket_index_);
+      }
+    }
+
+    void Seek(const Slice& internal_key, const char* memtable_key) override {
+      const char* encoded_key =
+          memtable_key != nullptr ? memtable_key : EncodeKey(&tmp_, internal_key);
+      const size_t index = rep_->BucketIndex(encoded_key);
+      auto* bucket = rep_->GetBucket(index);
+      if (bucket != nullptr) {
+        bucket_index_ = index;
+        iter_.SetList(bucket);
+        iter_.Seek(encoded_key);
+        if (iter_.Valid()) {
+          return;
+        }
+      }
+      SeekToFirstOfBucketsFrom(index + 1);
+    }
+
+    void SeekToFirst() override {
+      SeekToFirstOfBucketsFrom(0);
+    }
+
+    void SeekToLast() override {
+      SeekToLastOfBucketsBefore(rep_->num_buckets_);
+    }
+
+   private:
+    // Positions at the first entry of the first non-empty bucket with index of at least 'index'.
+    void SeekToFirstOfBucketsFrom(size_t index) {
+      for (; index < rep_->num_buckets_; ++index) {
+        auto* bucket = rep_->GetBucket(index);
+        if (bucket == nullptr) {
+          continue;
+        }
+        iter_.SetList(bucket);
+        iter_.SeekToFirst();
+        if (iter_.Valid()) {
+          bucket_index_ = index;
+          return;
+        }
+      }
+      bucket_index_ = rep_->num_buckets_;
+    }
+
+    // Positions at the last entry of the last non-empty bucket with index less than 'index'.
+    void SeekToLastOfBucketsBefore(size_t index) {
+      while (index-- > 0) {
+        auto* bucket = rep_->GetBucket(index);
+        if (bucket == nullptr) {
+          continue;
+        }
+        iter_.SetList(bucket);
+        iter_.SeekToLast();
+        if (iter_.Valid()) {
+          bucket_index_ = index;
+          return;
+        }
+      }
+      bucket_index_ = rep_->num_buckets_;
+    }
+
+    const OrderedBucketsRep* const rep_;
+    size_t bucket_index_ = 0;
+    Bucket::Iterator iter_;
+    std::string tmp_; // For passing to EncodeKey
+  };
+
+  Bucket* NewBucket() {
+    auto mem = allocator_->AllocateAligned(sizeof(Bucket));
+    return new (mem) Bucket(compare_, allocator_);
+  }
+
+  size_t Clamp(size_t index) const {
+    return std::min(index, num_buckets_ - 1);
+  }
+
+  size_t BucketIndex(const char* key) const {
+    return Clamp(bucket_function_(UserKey(key)));
+  }
+
+  Bucket* GetBucket(size_t index) const {
+    return buckets_[index].load(std::memory_order_acquire);
+  }
+
+  Bucket* GetOrCreateBucket(size_t index) {
+    auto* bucket = GetBucket(index);
+    if (bucket != nullptr) {
+      return bucket;
+    }
+    // Concurrent inserts could race to create the bucket, the arena memory of the lists of the
+    // losers is just left unused.
+    auto* new_bucket = NewBucket();
+    if (buckets_[index].compare_exchange_strong(
+            bucket, new_bucket, std::memory_order_acq_rel, std::memory_order_acquire)) {
+      return new_bucket;
+    }
+    return bucket;
+  }
+
+  const MemTableRep::KeyComparator& compare_;
+  const size_t num_buckets_;
+  const OrderedBucketFunction bucket_function_;
+  std::atomic<Bucket*>* buckets_;
+  Bucket* allocating_bucket_;
+};
+
+class OrderedBucketsRepFactory : public MemTableRepFactory {
+ public:
+  OrderedBucketsRepFactory(size_t num_buckets, OrderedBucketFunction bucket_function)
+      : num_buckets_(std::max<size_t>(num_buckets, 1)),
+        bucket_function_(std::move(bucket_function)) {}
+
+  MemTableRep* CreateMemTableRep(const MemTableRep::KeyComparator& compare,
+                                 MemTableAllocator* allocator,
+                                 const SliceTransform* transform,
+                                 Logger* logger) override {
+    return new OrderedBucketsRep(compare, allocator, num_buckets_, bucket_function_);
+  }
+
+  const char* Name() const override {
+    return "OrderedBucketsRepFactory";
+  }
+
+  bool IsInsertConcurrentlySupported() const override {
+    return true;
+  }
+
+ private:
+  const size_t num_buckets_;
+  const OrderedBucketFunction bucket_function_;
+};
+
+} // namespace
+
+MemTableRepFactory* NewOrderedBucketsRepFactory(
+    size_t num_buckets, OrderedBucketFunction bucket_function) {
+  return new OrderedBucketsRepFactory(num_buckets, std::move(bucket_function));
+}
+
+} // namespace rocksdb
@@ -54,6 +54,7 @@
 #include <stdint.h>
 #include <stdlib.h>
 
+#include <functional>
 #include <memory>
 #include <stdexcept>
 
@@ -344,6 +345,18 @@ extern MemTableRepFactory* NewHashCuckooRepFactory(
     size_t write_buffer_size, size_t average_data_size = 64,
     unsigned int hash_function_count = 4);
 #endif  // ROCKSDB_LITE
+
+// Maps a user key to its bucket. Should be monotonic: when a is ordered before b by the comparator,
+// bucket_function(a) <= bucket_function(b). Results of num_buckets or more go to the last bucket.
+typedef std::function<size_t(const Slice& user_key)> OrderedBucketFunction;
+
+// This factory creates memtables split into a fixed array of buckets by the bucket function, each
+// bucket being a skip list. Unlike the hash based memtables above, the buckets follow the order of
+// the keys, so iteration over the whole memtable, e.g. by flush, does not copy or sort the keys.
+// Insert and point lookups only traverse the skip list of a single bucket. Concurrent inserts are
+// supported.
+extern MemTableRepFactory* NewOrderedBucketsRepFactory(
+    size_t num_buckets, OrderedBucketFunction bucket_function);
 }  // namespace rocksdb
 
 #endif // ROCKSDB_INCLUDE_ROCKSDB_MEMTABLEREP_H
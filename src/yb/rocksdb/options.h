@@ -45,6 +45,7 @@
 namespace yb {
 
 class MemTracker;
+struct IOMetrics;
 
 }
 
@@ -70,6 +71,9 @@ class RateLimiter;
 class SliceTransform;
 class Statistics;
 class InternalKeyComparator;
+class KeyGroupExtractor;
+class UserFrontier;
+struct FileBoundaryValuesBase;
 class WalFilter;
 class MemoryMonitor;
 
@@ -163,9 +167,22 @@ struct CompressionOptions {
   int window_bits;
   int level;
   int strategy;
-  CompressionOptions() : window_bits(-14), level(-1), strategy(0) {}
-  CompressionOptions(int wbits, int _lev, int _strategy)
-      : window_bits(wbits), level(_lev), strategy(_strategy) {}
+  // Maximum size of the dictionary used to prime the compressor of data blocks. The dictionary is
+  // built from the first data blocks of each SST file and stored in the file as a meta block.
+  // Supported for zlib, LZ4 and ZSTD, ignored for other compression types. 0 disables dictionary
+  // compression.
+  uint32_t max_dict_bytes;
+  // Amount of raw data blocks buffered by the table builder to build the dictionary from. When it
+  // is larger than max_dict_bytes and ZSTD is used, the dictionary is trained with the ZSTD
+  // dictionary builder, otherwise it is sampled from the buffered blocks. Files smaller than this
+  // are written without a dictionary. 0 means the same as max_dict_bytes.
+  uint32_t dict_train_bytes;
+  CompressionOptions()
+      : window_bits(-14), level(-1), strategy(0), max_dict_bytes(0), dict_train_bytes(0) {}
+  CompressionOptions(int wbits, int _lev, int _strategy, uint32_t _max_dict_bytes = 0,
+                     uint32_t _dict_train_bytes = 0)
+      : window_bits(wbits), level(_lev), strategy(_strategy), max_dict_bytes(_max_dict_bytes),
+        dict_train_bytes(_dict_train_bytes) {}
 };
 
 enum UpdateStatus {    // Return status For inplace update callback
@@ -376,6 +393,20 @@ struct ColumnFamilyOptions {
   // different options for compression algorithms
   CompressionOptions compression_opts;
 
+  // Files written by compactions whose total input size is at least
+  // large_compaction_threshold_bytes are compressed with large_compaction_compression and
+  // large_compaction_compression_opts instead of the per-level compression above. This allows
+  // flushes and small compactions to use a fast codec while large, long-lived files use a
+  // stronger one, e.g. with a dictionary.
+  // 0 disables the override.
+  // Default: 0
+  uint64_t large_compaction_threshold_bytes;
+
+  // Default: kZlibCompression
+  CompressionType large_compaction_compression;
+
+  CompressionOptions large_compaction_compression_opts;
+
   // If non-nullptr, use the specified function to determine the
   // prefixes for keys.  These prefixes will be placed in the filter.
   // Depending on the workload, this can reduce the number of read-IOP
@@ -823,6 +854,21 @@ struct ColumnFamilyOptions {
 
 typedef std::function<yb::Result<bool>(const MemTable&)> MemTableFilter;
 
+// Returns the index in db_paths of the path that the output files of a compaction go to, given the
+// largest user frontier over its input files.
+typedef std::function<uint32_t(const UserFrontier& largest_frontier)>
+    CompactionOutputPathSelector;
+
+// Boundary values of an SST file, as passed to ExpiredFilesSelector.
+struct SstFileBoundaries {
+  const FileBoundaryValuesBase* smallest;
+  const FileBoundaryValuesBase* largest;
+};
+
+// Given the SST files of level 0 ordered from the oldest to the newest, returns how many of the
+// oldest ones only hold data that no read could see any more.
+typedef std::function<size_t(const std::vector<SstFileBoundaries>& files)> ExpiredFilesSelector;
+
 struct DBOptions {
   // Some functions that make it easier to optimize RocksDB
 
@@ -948,6 +994,21 @@ struct DBOptions {
   // Default: empty
   std::vector<DbPath> db_paths;
 
+  // If set, picks the path of the output files of universal style compactions instead of the
+  // target sizes of db_paths, e.g. to place files that only contain old data on a cheaper device.
+  // Not used for compactions of files without user frontiers.
+  //
+  // Files that are found in the first path at open while the MANIFEST places them in another one,
+  // e.g. after a checkpoint was copied into the first path, are moved to their path.
+  // Default: not set
+  CompactionOutputPathSelector compaction_output_path_selector;
+
+  // If set, universal style compactions delete the oldest files that it selects before picking
+  // anything else, without reading them, e.g. files whose records all expired by TTL. Only used
+  // when all the files are in level 0.
+  // Default: not set
+  ExpiredFilesSelector expired_files_selector;
+
   // This specifies the info LOG dir.
   // If it is empty, the log files will be in the same dir as data.
   // If it is non empty, the log files will be in the specified dir,
@@ -1090,6 +1151,15 @@ struct DBOptions {
   // Default: false
   bool allow_mmap_writes;
 
+  // Use O_DIRECT for the SST files written by flushes and compactions and for the reads of
+  // compaction inputs, so that background I/O does not evict the working set of foreground reads
+  // from the OS page cache. Foreground reads stay buffered. If the file system does not support
+  // O_DIRECT, the files are accessed through the page cache and their pages are dropped from it
+  // with posix_fadvise instead.
+  // When set, compaction_readahead_size defaults to 2MB if it is not set explicitly.
+  // Default: false
+  bool use_direct_io_for_flush_and_compaction;
+
   // If false, fallocate() calls are bypassed
   bool allow_fallocate;
 
@@ -1319,9 +1389,23 @@ struct DBOptions {
   // Max file size for compaction. Supported only for level0 of universal style compactions.
   uint64_t max_file_size_for_compaction = std::numeric_limits<uint64_t>::max();
 
+  // Minimum amount of input data per subcompaction, for compactions whose output is not split into
+  // files of a bounded size, i.e. universal style compactions into level 0 of a single level DB.
+  // The outputs of such a compaction form one sorted run of level 0 files with disjoint key ranges.
+  uint64_t min_subcompaction_size = 256 * 1024 * 1024;
+
+  // If set, subcompaction boundaries are moved to the start of the key group they fall into, so
+  // that all keys of a group are processed by the same subcompaction and its compaction filter.
+  std::shared_ptr<const KeyGroupExtractor> subcompaction_key_group_extractor;
+
   // Invoked after memtable switched.
   std::shared_ptr<std::function<MemTableFilter()>> mem_table_flush_filter_factory;
 
+  // If set, the file I/O of flushes and of compactions is accounted to these metrics, see
+  // yb/util/io_accounting.h.
+  std::shared_ptr<const yb::IOMetrics> flush_io_metrics;
+  std::shared_ptr<const yb::IOMetrics> compaction_io_metrics;
+
   // A prefix for log messages, usually containing the tablet id.
   std::string log_prefix;
 
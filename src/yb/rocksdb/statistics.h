@@ -206,6 +206,10 @@ enum Tickers : uint32_t {
   BLOCK_CACHE_MULTI_TOUCH_BYTES_READ,
   BLOCK_CACHE_MULTI_TOUCH_BYTES_WRITE,
 
+  // Bytes of flushes and compactions that bypassed the OS page cache using direct I/O.
+  DIRECT_IO_READ_BYTES,
+  DIRECT_IO_WRITE_BYTES,
+
   // End of ticker enum.
   TICKER_ENUM_MAX,
 };
@@ -300,7 +304,9 @@ const std::vector<std::pair<Tickers, std::string>> TickersNameMap = {
     {BLOCK_CACHE_MULTI_TOUCH_HIT, "rocksdb_block_cache_multi_touch_hit"},
     {BLOCK_CACHE_MULTI_TOUCH_ADD, "rocksdb_block_cache_multi_touch_add"},
     {BLOCK_CACHE_MULTI_TOUCH_BYTES_READ, "rocksdb_block_cache_multi_touch_bytes_read"},
-    {BLOCK_CACHE_MULTI_TOUCH_BYTES_WRITE, "rocksdb_block_cache_multi_touch_bytes_write"}
+    {BLOCK_CACHE_MULTI_TOUCH_BYTES_WRITE, "rocksdb_block_cache_multi_touch_bytes_write"},
+    {DIRECT_IO_READ_BYTES, "rocksdb_direct_io_read_bytes"},
+    {DIRECT_IO_WRITE_BYTES, "rocksdb_direct_io_write_bytes"},
 };
 
 /**
@@ -79,6 +79,21 @@ YB_DEFINE_ENUM(IndexType,
   (kMultiLevelBinarySearch)
 );
 
+// Splits keys into groups of consecutive keys sharing a common prefix, e.g. all the keys that
+// belong to the same row. Used to choose restart points in data blocks, so that a group prefix is
+// stored in full only once per restart interval instead of being repeated at every restart point
+// that falls inside the group.
+class KeyGroupExtractor {
+ public:
+  virtual ~KeyGroupExtractor() {}
+
+  virtual const char* Name() const = 0;
+
+  // Returns the size of the group prefix of the given user key, or 0 if the key does not belong
+  // to any group.
+  virtual size_t GroupPrefixSize(const Slice& user_key) const = 0;
+};
+
 // For advanced user only
 struct BlockBasedTableOptions {
   // @flush_block_policy_factory creates the instances of flush block policy.
@@ -97,6 +112,29 @@ struct BlockBasedTableOptions {
   // Note: Fixed-size bloom filter data blocks are never pre-loaded.
   bool cache_index_and_filter_blocks = false;
 
+  // If cache_index_and_filter_blocks is set, keep the top level of a kMultiLevelBinarySearch data
+  // index in the table reader instead of the block cache, the same way the fixed-size filter index
+  // is kept. The top level is small, and every data index lookup starts from it, so it should not
+  // be evicted by data blocks.
+  bool pin_top_level_index = false;
+
+  // Insert the lower-level data index blocks and the fixed-size filter blocks into the multi-touch
+  // part of the block cache on first access, so that loading them does not evict single-touch data
+  // blocks and scans filling the single-touch part do not evict them.
+  bool index_and_filter_blocks_in_multi_touch_cache = false;
+
+  // When a forward scan moves to a data block, read up to this number of upcoming data blocks that
+  // are not in the block cache yet with a single batched read and add them to the block cache.
+  // Only used with the block cache and binary search indexes. Zero disables prefetching.
+  size_t scan_prefetch_data_blocks = 0;
+
+  // When a scan has read num_sequential_reads_for_auto_readahead data blocks that follow each
+  // other in the file, the table reader asks the file to read ahead, starting with 8KB and doubling
+  // the readahead size with each readahead up to max_auto_readahead_size. Any non-sequential block
+  // read starts over. Zero disables readahead.
+  size_t max_auto_readahead_size = 0;
+  size_t num_sequential_reads_for_auto_readahead = 2;
+
   IndexType index_type = IndexType::kMultiLevelBinarySearch;
 
   // Influence the behavior when kHashSearch is used.
@@ -150,6 +188,22 @@ struct BlockBasedTableOptions {
   // Same as block_restart_interval but used for the index block.
   int index_block_restart_interval = 1;
 
+  // If set, a restart point in a data block is postponed while the next key belongs to the same
+  // group as the previous one, so the keys of a group share the group prefix through delta
+  // encoding. The format of data blocks does not change, so blocks written with this option are
+  // readable by any reader.
+  std::shared_ptr<const KeyGroupExtractor> data_block_key_group_extractor = nullptr;
+
+  // Upper bound on the number of keys between restart points when restarts are postponed because
+  // of data_block_key_group_extractor. Bounds the linear scan done by a seek inside a long group.
+  int data_block_max_restart_interval = 64;
+
+  // If true and data_block_key_group_extractor is set, a hash index of the key groups is appended
+  // to each data block, which maps a group to the restart interval of its first key. Seeks then
+  // start from that restart interval instead of binary searching the restart array. Blocks written
+  // with this option are not readable by readers that do not support the hash index.
+  bool data_block_hash_index = false;
+
   // Index block size for sharded index. Applied to data index when kMultiLevelBinarySearch is used.
   size_t index_block_size = 4_KB;
 
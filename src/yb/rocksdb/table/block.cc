@@ -31,6 +31,8 @@
 #include <vector>
 
 #include "yb/rocksdb/comparator.h"
+#include "yb/rocksdb/table.h"
+#include "yb/rocksdb/db/dbformat.h"
 #include "yb/rocksdb/table/format.h"
 #include "yb/rocksdb/table/block_hash_index.h"
 #include "yb/rocksdb/table/block_prefix_index.h"
@@ -122,9 +124,13 @@ void BlockIter::Seek(const Slice& target) {
   bool ok = false;
   if (prefix_index_) {
     ok = PrefixSeek(target, &index);
+  } else if (hash_index_) {
+    ok = HashSeek(target, &index);
   } else {
-    ok = hash_index_ ? HashSeek(target, &index)
-      : BinarySeek(target, 0, num_restarts_ - 1, &index);
+    uint32_t left = 0;
+    uint32_t right = num_restarts_ - 1;
+    ok = (!data_block_hash_index_ || NarrowByDataBlockHash(target, &left, &right)) &&
+         BinarySeek(target, left, right, &index);
   }
 
   if (!ok) {
@@ -332,9 +338,51 @@ bool BlockIter::PrefixSeek(const Slice& target, uint32_t* index) {
   }
 }
 
+bool BlockIter::NarrowByDataBlockHash(const Slice& target, uint32_t* left, uint32_t* right) {
+  if (target.size() < 8) {
+    return true;
+  }
+  const size_t group_prefix_size = key_group_extractor_->GroupPrefixSize(ExtractUserKey(target));
+  if (group_prefix_size == 0) {
+    return true;
+  }
+  const Slice group_prefix(target.data(), group_prefix_size);
+  const uint32_t restart_index = data_block_hash_index_->Lookup(group_prefix);
+  if (restart_index >= num_restarts_) {
+    // No entry or a collision.
+    return true;
+  }
+
+  uint32_t shared, non_shared, value_length;
+  const char* key_ptr = DecodeEntry(data_ + GetRestartPoint(restart_index), data_ + restarts_,
+                                    &shared, &non_shared, &value_length);
+  if (key_ptr == nullptr || shared != 0) {
+    CorruptionError();
+    return false;
+  }
+  const Slice restart_key(key_ptr, non_shared);
+  // The keys before the restart interval are less than target if its first key is not greater
+  // than target, or if its first key is the first key of the group of target. The latter is the
+  // case when the first key belongs to the group, because the bucket of the group then points to
+  // the restart interval of its first key. Otherwise the bucket belongs to another group, and the
+  // group of target is not in the block.
+  if (Compare(restart_key, target) > 0 && !restart_key.starts_with(group_prefix)) {
+    return true;
+  }
+  *left = restart_index;
+  // Unless the group continues past the restart interval, the first key not less than target is
+  // in the restart interval, or is the first key of the next one.
+  if (restart_index + 1 < num_restarts_ && CompareBlockKey(restart_index + 1, target) < 0) {
+    *left = restart_index + 1;
+  } else {
+    *right = restart_index;
+  }
+  return status_.ok();
+}
+
 uint32_t Block::NumRestarts() const {
   assert(size_ >= 2*sizeof(uint32_t));
-  return DecodeFixed32(data_ + size_ - sizeof(uint32_t));
+  return DecodeFixed32(data_ + size_ - sizeof(uint32_t)) & ~kDataBlockHashIndexFlag;
 }
 
 Block::Block(BlockContents&& contents)
@@ -344,9 +392,17 @@ Block::Block(BlockContents&& contents)
   if (size_ < sizeof(uint32_t)) {
     size_ = 0;  // Error marker
   } else {
-    restart_offset_ =
-        static_cast<uint32_t>(size_) - (1 + NumRestarts()) * sizeof(uint32_t);
-    if (restart_offset_ > size_ - sizeof(uint32_t)) {
+    const char* restarts_end = data_ + size_ - sizeof(uint32_t);
+    if (DecodeFixed32(restarts_end) & kDataBlockHashIndexFlag) {
+      restarts_end = data_block_hash_index_.Initialize(data_, restarts_end);
+      if (restarts_end == nullptr) {
+        size_ = 0;
+        return;
+      }
+    }
+    const uint32_t restarts_end_offset = static_cast<uint32_t>(restarts_end - data_);
+    restart_offset_ = restarts_end_offset - NumRestarts() * sizeof(uint32_t);
+    if (restart_offset_ > restarts_end_offset) {
       // The size is too small for NumRestarts() and therefore
       // restart_offset_ wrapped around.
       size_ = 0;
@@ -355,7 +411,8 @@ Block::Block(BlockContents&& contents)
 }
 
 InternalIterator* Block::NewIterator(const Comparator* cmp, BlockIter* iter,
-                                     bool total_order_seek) {
+                                     bool total_order_seek,
+                                     const KeyGroupExtractor* key_group_extractor) {
   if (size_ < 2*sizeof(uint32_t)) {
     if (iter != nullptr) {
       iter->SetStatus(STATUS(Corruption, "bad block contents"));
@@ -385,6 +442,9 @@ InternalIterator* Block::NewIterator(const Comparator* cmp, BlockIter* iter,
       iter = new BlockIter(cmp, data_, restart_offset_, num_restarts,
                            hash_index_ptr, prefix_index_ptr);
     }
+    if (key_group_extractor != nullptr && data_block_hash_index_.initialized()) {
+      iter->SetDataBlockHashIndex(&data_block_hash_index_, key_group_extractor);
+    }
   }
 
   return iter;
@@ -35,6 +35,7 @@
 #include "yb/rocksdb/db/dbformat.h"
 #include "yb/rocksdb/table/block_prefix_index.h"
 #include "yb/rocksdb/table/block_hash_index.h"
+#include "yb/rocksdb/table/data_block_hash_index.h"
 #include "yb/rocksdb/table/format.h"
 #include "yb/rocksdb/table/internal_iterator.h"
 
@@ -45,6 +46,7 @@ class Comparator;
 class BlockIter;
 class BlockHashIndex;
 class BlockPrefixIndex;
+class KeyGroupExtractor;
 
 class Block {
  public:
@@ -82,9 +84,13 @@ class Block {
   // If total_order_seek is true, hash_index_ and prefix_index_ are ignored.
   // This option only applies for index block. For data block, hash_index_
   // and prefix_index_ are null, so this option does not matter.
+  //
+  // If the block has a DataBlockHashIndex, seeks use it when key_group_extractor is set. It should
+  // be the extractor the block was built with.
   InternalIterator* NewIterator(const Comparator* comparator,
                                 BlockIter* iter = nullptr,
-                                bool total_order_seek = true);
+                                bool total_order_seek = true,
+                                const KeyGroupExtractor* key_group_extractor = nullptr);
   void SetBlockHashIndex(BlockHashIndex* hash_index);
   void SetBlockPrefixIndex(BlockPrefixIndex* prefix_index);
 
@@ -98,6 +104,7 @@ class Block {
   uint32_t restart_offset_;     // Offset in data_ of restart array
   std::unique_ptr<BlockHashIndex> hash_index_;
   std::unique_ptr<BlockPrefixIndex> prefix_index_;
+  DataBlockHashIndex data_block_hash_index_;
 
   // No copying allowed
   Block(const Block&);
@@ -115,7 +122,9 @@ class BlockIter : public InternalIterator {
         restart_index_(0),
         status_(Status::OK()),
         hash_index_(nullptr),
-        prefix_index_(nullptr) {}
+        prefix_index_(nullptr),
+        data_block_hash_index_(nullptr),
+        key_group_extractor_(nullptr) {}
 
   BlockIter(const Comparator* comparator, const char* data, uint32_t restarts,
        uint32_t num_restarts, BlockHashIndex* hash_index,
@@ -133,6 +142,13 @@ class BlockIter : public InternalIterator {
     status_ = s;
   }
 
+  // Makes seeks use the hash index of a data block, where keys are grouped by key_group_extractor.
+  void SetDataBlockHashIndex(const DataBlockHashIndex* data_block_hash_index,
+                             const KeyGroupExtractor* key_group_extractor) {
+    data_block_hash_index_ = data_block_hash_index;
+    key_group_extractor_ = key_group_extractor;
+  }
+
   virtual bool Valid() const override { return current_ < restarts_; }
   virtual Status status() const override { return status_; }
   virtual Slice key() const override {
@@ -180,6 +196,8 @@ class BlockIter : public InternalIterator {
   Status status_;
   BlockHashIndex* hash_index_;
   BlockPrefixIndex* prefix_index_;
+  const DataBlockHashIndex* data_block_hash_index_;
+  const KeyGroupExtractor* key_group_extractor_;
 
   inline int Compare(const Slice& a, const Slice& b) const {
     return comparator_->Compare(a, b);
@@ -223,6 +241,10 @@ class BlockIter : public InternalIterator {
 
   bool PrefixSeek(const Slice& target, uint32_t* index);
 
+  // Narrows the range [*left, *right] of restart intervals to binary search for target, using the
+  // data block hash index. Returns false on corruption.
+  bool NarrowByDataBlockHash(const Slice& target, uint32_t* left, uint32_t* right);
+
 };
 
 }  // namespace rocksdb
@@ -27,11 +27,13 @@
 #include <inttypes.h>
 #include <stdio.h>
 
+#include <algorithm>
 #include <map>
 #include <memory>
 #include <string>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "yb/rocksdb/db/dbformat.h"
 
@@ -110,6 +112,7 @@ bool GoodCompressionRatio(size_t compressed_size, size_t raw_size) {
 Slice CompressBlock(const Slice& raw,
                     const CompressionOptions& compression_options,
                     CompressionType* type, uint32_t format_version,
+                    const Slice& compression_dict,
                     std::string* compressed_output) {
   if (*type == kNoCompression) {
     return raw;
@@ -129,7 +132,7 @@ Slice CompressBlock(const Slice& raw,
       if (Zlib_Compress(
               compression_options,
               GetCompressFormatForVersion(kZlibCompression, format_version),
-              raw.cdata(), raw.size(), compressed_output) &&
+              raw.cdata(), raw.size(), compressed_output, compression_dict) &&
           GoodCompressionRatio(compressed_output->size(), raw.size())) {
         return *compressed_output;
       }
@@ -147,7 +150,7 @@ Slice CompressBlock(const Slice& raw,
       if (LZ4_Compress(
               compression_options,
               GetCompressFormatForVersion(kLZ4Compression, format_version),
-              raw.cdata(), raw.size(), compressed_output) &&
+              raw.cdata(), raw.size(), compressed_output, compression_dict) &&
           GoodCompressionRatio(compressed_output->size(), raw.size())) {
         return *compressed_output;
       }
@@ -156,14 +159,14 @@ Slice CompressBlock(const Slice& raw,
       if (LZ4HC_Compress(
               compression_options,
               GetCompressFormatForVersion(kLZ4HCCompression, format_version),
-              raw.cdata(), raw.size(), compressed_output) &&
+              raw.cdata(), raw.size(), compressed_output, compression_dict) &&
           GoodCompressionRatio(compressed_output->size(), raw.size())) {
         return *compressed_output;
       }
       break;     // fall back to no compression.
     case kZSTDNotFinalCompression:
       if (ZSTD_Compress(compression_options, raw.cdata(), raw.size(),
-                        compressed_output) &&
+                        compressed_output, compression_dict) &&
           GoodCompressionRatio(compressed_output->size(), raw.size())) {
         return *compressed_output;
       }
@@ -177,6 +180,39 @@ Slice CompressBlock(const Slice& raw,
   return raw;
 }
 
+// Builds a dictionary of at most compression_options.max_dict_bytes from the given raw data
+// blocks. ZSTD dictionaries are trained when there is more sample data than fits into the
+// dictionary, otherwise the dictionary is made of blocks sampled evenly across the input.
+std::string BuildCompressionDict(const std::vector<Slice>& blocks, size_t total_size,
+                                 const CompressionOptions& compression_options,
+                                 CompressionType type) {
+  const size_t max_dict_bytes = compression_options.max_dict_bytes;
+  if (blocks.empty() || max_dict_bytes == 0) {
+    return std::string();
+  }
+  if (type == kZSTDNotFinalCompression && total_size > max_dict_bytes) {
+    std::string samples;
+    std::vector<size_t> sample_lens;
+    samples.reserve(total_size);
+    sample_lens.reserve(blocks.size());
+    for (const auto& block : blocks) {
+      samples.append(block.cdata(), block.size());
+      sample_lens.push_back(block.size());
+    }
+    std::string dict = ZSTD_TrainDictionary(samples, sample_lens, max_dict_bytes);
+    if (!dict.empty()) {
+      return dict;
+    }
+  }
+  std::string dict;
+  dict.reserve(std::min(total_size, max_dict_bytes));
+  const size_t step = std::max<size_t>(total_size / max_dict_bytes, 1);
+  for (size_t i = 0; i < blocks.size() && dict.size() < max_dict_bytes; i += step) {
+    dict.append(blocks[i].cdata(), std::min(blocks[i].size(), max_dict_bytes - dict.size()));
+  }
+  return dict;
+}
+
 }  // namespace
 
 // kBlockBasedTableMagicNumber was picked by running
@@ -303,6 +339,22 @@ struct BlockBasedTableBuilder::Rep {
 
   yb::MemTrackerPtr mem_tracker;
 
+  // Dictionary compression, see CompressionOptions::max_dict_bytes. While buffer_data_blocks is
+  // set, finished data blocks are kept in memory instead of being written out, until
+  // dict_train_bytes of them are collected. The dictionary is then built from the buffered blocks
+  // and the blocks are compressed with it and written out in order, followed by all the next data
+  // blocks.
+  struct BufferedDataBlock {
+    std::string contents;
+    std::string last_key;
+    std::string next_block_first_key;
+  };
+  bool buffer_data_blocks = false;
+  size_t dict_train_bytes = 0;
+  std::vector<BufferedDataBlock> buffered_data_blocks;
+  size_t buffered_data_size = 0;
+  std::string compression_dict;
+
   Rep(const ImmutableCFOptions& _ioptions,
       const BlockBasedTableOptions& table_opt,
       const InternalKeyComparatorPtr& icomparator,
@@ -352,7 +404,10 @@ BlockBasedTableBuilder::Rep::Rep(
       filter_block_builder(skip_filters ? nullptr : CreateFilterBlockBuilder(
           _ioptions, table_options, filter_type)),
       data_block_builder(table_options.block_restart_interval,
-                 table_options.use_delta_encoding),
+                 table_options.use_delta_encoding,
+                 table_options.data_block_key_group_extractor.get(),
+                 table_options.data_block_max_restart_interval,
+                 table_options.data_block_hash_index),
       internal_prefix_transform(_ioptions.prefix_extractor),
       filter_key_transformer(table_opt.filter_policy ?
           table_opt.filter_policy->GetKeyTransformer() : nullptr),
@@ -384,6 +439,16 @@ BlockBasedTableBuilder::Rep::Rep(
   } else {
     data_writer = metadata_writer;
   }
+  // Data blocks are buffered without their index entries, so the hash index, which collects key
+  // prefixes as keys are added, and the block-based filter, which is partitioned by data block
+  // offsets, are not compatible with buffering.
+  if (compression_opts.max_dict_bytes > 0 && CompressionDictSupported(compression_type) &&
+      table_options.index_type != IndexType::kHashSearch &&
+      filter_type != FilterType::kBlockBasedFilter) {
+    buffer_data_blocks = true;
+    dict_train_bytes = std::max<size_t>(
+        compression_opts.dict_train_bytes, compression_opts.max_dict_bytes);
+  }
   for (auto& collector_factories : int_tbl_prop_collector_factories) {
     table_properties_collectors.emplace_back(
         collector_factories->CreateIntTblPropCollector(column_family_id));
@@ -486,14 +551,36 @@ void BlockBasedTableBuilder::FlushDataBlock(const Slice& next_block_first_key) {
   Rep* const r = rep_;
   assert(!r->closed);
   if (!ok()) return;
+
+  if (r->buffer_data_blocks) {
+    if (!r->data_block_builder.empty()) {
+      const Slice contents = r->data_block_builder.Finish();
+      r->buffered_data_size += contents.size();
+      r->buffered_data_blocks.push_back(Rep::BufferedDataBlock{
+          contents.ToBuffer(), r->last_key, next_block_first_key.ToBuffer()});
+      r->data_block_builder.Reset();
+    }
+    if (r->buffered_data_size >= r->dict_train_bytes) {
+      EnterUnbuffered();
+    }
+    return;
+  }
+
   size_t data_block_size = 0;
 
   if (!r->data_block_builder.empty()) {
-    data_block_size = WriteBlock(&r->data_block_builder, &r->data_pending_handle,
-        r->data_writer.get());
+    data_block_size = WriteBlock(r->data_block_builder.Finish(), &r->data_pending_handle,
+        r->data_writer.get(), r->compression_dict);
+    r->data_block_builder.Reset();
   }
   if (!ok()) return;
 
+  DataBlockWritten(data_block_size, &r->last_key, next_block_first_key);
+}
+
+void BlockBasedTableBuilder::DataBlockWritten(
+    size_t data_block_size, std::string* last_key, const Slice& next_block_first_key) {
+  Rep* const r = rep_;
   if (!r->table_options.skip_table_builder_flush) {
     r->status = r->data_writer->writer->Flush();
   }
@@ -514,7 +601,7 @@ void BlockBasedTableBuilder::FlushDataBlock(const Slice& next_block_first_key) {
   // "the r" as the key for the index block entry since it is >= all
   // entries in the first block and < all entries in subsequent
   // blocks.
-  r->data_index_builder->AddIndexEntry(&r->last_key,
+  r->data_index_builder->AddIndexEntry(last_key,
       next_block_first_key.empty() ? nullptr : &next_block_first_key,
       r->data_pending_handle);
   while (r->data_index_builder->ShouldFlush()) {
@@ -533,6 +620,32 @@ void BlockBasedTableBuilder::FlushDataBlock(const Slice& next_block_first_key) {
   }
 }
 
+void BlockBasedTableBuilder::EnterUnbuffered() {
+  Rep* const r = rep_;
+  r->buffer_data_blocks = false;
+  // Files that end before enough data is collected are too small to benefit from a dictionary.
+  if (r->buffered_data_size >= r->dict_train_bytes) {
+    std::vector<Slice> samples;
+    samples.reserve(r->buffered_data_blocks.size());
+    for (const auto& block : r->buffered_data_blocks) {
+      samples.emplace_back(block.contents);
+    }
+    r->compression_dict = BuildCompressionDict(
+        samples, r->buffered_data_size, r->compression_opts, r->compression_type);
+  }
+
+  for (auto& block : r->buffered_data_blocks) {
+    const size_t data_block_size = WriteBlock(
+        block.contents, &r->data_pending_handle, r->data_writer.get(), r->compression_dict);
+    if (!ok()) break;
+    DataBlockWritten(data_block_size, &block.last_key, block.next_block_first_key);
+    if (!ok()) break;
+  }
+  r->buffered_data_blocks.clear();
+  r->buffered_data_blocks.shrink_to_fit();
+  r->buffered_data_size = 0;
+}
+
 void BlockBasedTableBuilder::FlushFilterBlock(const Slice& next_block_first_key) {
   Rep* const r = rep_;
   assert(!r->closed);
@@ -571,7 +684,8 @@ size_t BlockBasedTableBuilder::WriteBlock(BlockBuilder* block,
 
 size_t BlockBasedTableBuilder::WriteBlock(const Slice& raw_block_contents,
                                           BlockHandle* handle,
-                                          FileWriterWithOffsetAndCachePrefix* writer_info) {
+                                          FileWriterWithOffsetAndCachePrefix* writer_info,
+                                          const Slice& compression_dict) {
   // File format contains a sequence of blocks where each block has:
   //    block_data: uint8[n]
   //    type: uint8
@@ -584,7 +698,7 @@ size_t BlockBasedTableBuilder::WriteBlock(const Slice& raw_block_contents,
   if (raw_block_contents.size() < kCompressionSizeLimit) {
     block_contents =
         CompressBlock(raw_block_contents, r->compression_opts, &type,
-                      r->table_options.format_version, &r->compressed_output);
+                      r->table_options.format_version, compression_dict, &r->compressed_output);
   } else {
     RecordTick(r->ioptions.statistics, NUMBER_BLOCK_NOT_COMPRESSED);
     type = kNoCompression;
@@ -701,6 +815,9 @@ Status BlockBasedTableBuilder::Finish() {
   if (!r->data_block_builder.empty()) {
     FlushDataBlock(end_slice);  // no more data block
   }
+  if (r->buffer_data_blocks && ok()) {
+    EnterUnbuffered();
+  }
   if (r->filter_block_builder != nullptr) {
     FlushFilterBlock(end_slice);  // no more filter block
   }
@@ -716,7 +833,7 @@ Status BlockBasedTableBuilder::Finish() {
 
   // Write meta blocks and metaindex block with the following order.
   //    1. [meta block: filter]
-  //    2. [other meta blocks]
+  //    2. [other meta blocks, including the compression dictionary]
   //    3. [meta block: properties]
   //    4. [metaindex block]
   // write meta blocks
@@ -727,6 +844,13 @@ Status BlockBasedTableBuilder::Finish() {
     meta_index_builder.Add(item.first, block_handle);
   }
 
+  if (ok() && !r->compression_dict.empty()) {
+    BlockHandle compression_dict_block_handle;
+    WriteRawBlock(r->compression_dict, kNoCompression, &compression_dict_block_handle,
+        r->metadata_writer.get());
+    meta_index_builder.Add(kCompressionDictBlock, compression_dict_block_handle);
+  }
+
   if (ok()) {
     if (r->filter_block_builder != nullptr) {
       // Add mapping from "<filter_block_prefix>.Name" to location of either filter block or
@@ -849,8 +973,9 @@ uint64_t BlockBasedTableBuilder::NumEntries() const {
 }
 
 uint64_t BlockBasedTableBuilder::TotalFileSize() const {
-  return rep_->is_split_sst() ? rep_->metadata_writer->offset + rep_->data_writer->offset :
-      rep_->metadata_writer->offset;
+  // Buffered data blocks are accounted with their uncompressed size.
+  return (rep_->is_split_sst() ? rep_->metadata_writer->offset + rep_->data_writer->offset :
+      rep_->metadata_writer->offset) + rep_->buffered_data_size;
 }
 
 uint64_t BlockBasedTableBuilder::BaseFileSize() const {
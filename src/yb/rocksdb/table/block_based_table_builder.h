@@ -112,7 +112,7 @@ class BlockBasedTableBuilder : public TableBuilder {
       FileWriterWithOffsetAndCachePrefix* writer_info);
   // Directly write block content to the file. Returns number of bytes written to file.
   size_t WriteBlock(const Slice& block_contents, BlockHandle* handle,
-      FileWriterWithOffsetAndCachePrefix* writer_info);
+      FileWriterWithOffsetAndCachePrefix* writer_info, const Slice& compression_dict = Slice());
   size_t WriteRawBlock(const Slice& data, CompressionType, BlockHandle* handle,
       FileWriterWithOffsetAndCachePrefix* writer_info);
   Status InsertBlockInCache(const Slice& block_contents,
@@ -130,6 +130,13 @@ class BlockBasedTableBuilder : public TableBuilder {
   // REQUIRES: Finish(), Abandon() have not been called.
   void FlushDataBlock(const Slice& next_block_first_key);
 
+  // Accounts the data block that was just written to the data file and adds its index entry.
+  void DataBlockWritten(
+      size_t data_block_size, std::string* last_key, const Slice& next_block_first_key);
+
+  // Builds the compression dictionary from the buffered data blocks and writes them out.
+  void EnterUnbuffered();
+
   // Flush the current filter block into disk. next_block_first_key should be nullptr if this is the
   // last block written to disk.
   // REQUIRES: Finish(), Abandon() have not been called.
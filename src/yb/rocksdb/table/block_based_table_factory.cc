@@ -136,6 +136,21 @@ std::string BlockBasedTableFactory::GetPrintableTableOptions() const {
   snprintf(buffer, kBufferSize, "  cache_index_and_filter_blocks: %d\n",
            table_options_.cache_index_and_filter_blocks);
   ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  pin_top_level_index: %d\n",
+           table_options_.pin_top_level_index);
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  index_and_filter_blocks_in_multi_touch_cache: %d\n",
+           table_options_.index_and_filter_blocks_in_multi_touch_cache);
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  scan_prefetch_data_blocks: %" ROCKSDB_PRIszt "\n",
+           table_options_.scan_prefetch_data_blocks);
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  max_auto_readahead_size: %" ROCKSDB_PRIszt "\n",
+           table_options_.max_auto_readahead_size);
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  num_sequential_reads_for_auto_readahead: %" ROCKSDB_PRIszt "\n",
+           table_options_.num_sequential_reads_for_auto_readahead);
+  ret.append(buffer);
   snprintf(buffer, kBufferSize, "  index_type: %d\n",
            yb::to_underlying(table_options_.index_type));
   ret.append(buffer);
@@ -177,6 +192,16 @@ std::string BlockBasedTableFactory::GetPrintableTableOptions() const {
   snprintf(buffer, kBufferSize, "  index_block_restart_interval: %d\n",
            table_options_.index_block_restart_interval);
   ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  data_block_key_group_extractor: %s\n",
+           table_options_.data_block_key_group_extractor ?
+               table_options_.data_block_key_group_extractor->Name() : "nullptr");
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  data_block_max_restart_interval: %d\n",
+           table_options_.data_block_max_restart_interval);
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  data_block_hash_index: %d\n",
+           table_options_.data_block_hash_index);
+  ret.append(buffer);
   snprintf(buffer, kBufferSize, "  filter_policy: %s\n",
            table_options_.filter_policy == nullptr ?
              "nullptr" : table_options_.filter_policy->Name());
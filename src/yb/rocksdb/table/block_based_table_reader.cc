@@ -23,6 +23,8 @@
 
 #include "yb/rocksdb/table/block_based_table_reader.h"
 
+#include <algorithm>
+#include <limits>
 #include <string>
 #include <utility>
 #include <cinttypes>
@@ -235,6 +237,9 @@ struct BlockBasedTable::Rep {
   unique_ptr<SliceTransform> internal_prefix_transform;
   DataIndexLoadMode data_index_load_mode;
   yb::MemTrackerPtr mem_tracker;
+
+  // Dictionary the data blocks were compressed with, empty if the file was written without one.
+  BlockContents compression_dict_block;
 };
 
 // BlockEntryIteratorState doesn't actually store any iterator state and is only used as an adapter
@@ -249,12 +254,31 @@ class BlockBasedTable::BlockEntryIteratorState : public TwoLevelIteratorState {
         table_(table),
         read_options_(read_options),
         skip_filters_(skip_filters),
-        block_type_(block_type) {}
+        block_type_(block_type) {
+    const auto& table_options = table->rep_->table_options;
+    // Prefetching relies on seeking the index back to the current entry, which is only exact for
+    // binary search indexes.
+    if (block_type == BlockType::kData &&
+        (table_options.index_type == IndexType::kBinarySearch ||
+         table_options.index_type == IndexType::kMultiLevelBinarySearch)) {
+      num_secondary_to_prefetch = table_options.scan_prefetch_data_blocks;
+    }
+    if (block_type == BlockType::kData && read_options.read_tier != kBlockCacheTier) {
+      max_readahead_size_ = table_options.max_auto_readahead_size;
+    }
+  }
 
   InternalIterator* NewSecondaryIterator(const Slice& index_value) override {
+    if (max_readahead_size_ > 0) {
+      MaybeReadahead(index_value);
+    }
     return table_->NewDataBlockIterator(read_options_, index_value, block_type_);
   }
 
+  void PrefetchSecondary(const std::vector<std::string>& index_values) override {
+    table_->PrefetchDataBlocks(read_options_, index_values);
+  }
+
   bool PrefixMayMatch(const Slice& internal_key) override {
     if (read_options_.total_order_seek || skip_filters_) {
       return true;
@@ -263,6 +287,46 @@ class BlockBasedTable::BlockEntryIteratorState : public TwoLevelIteratorState {
   }
 
  private:
+  // Once the iterator has visited num_sequential_reads_for_auto_readahead data blocks that follow
+  // each other in the file, asks the file to read ahead. Each next readahead is started when the
+  // iterator leaves the previous readahead window and is twice as large, up to
+  // max_auto_readahead_size.
+  void MaybeReadahead(const Slice& index_value) {
+    BlockHandle handle;
+    Slice input = index_value;
+    if (!handle.DecodeFrom(&input).ok()) {
+      return;
+    }
+    const uint64_t offset = handle.offset();
+    const uint64_t end = offset + handle.size() + kBlockTrailerSize;
+    const bool sequential = offset == prev_block_end_;
+    prev_block_end_ = end;
+    if (end <= readahead_limit_ && sequential) {
+      return;
+    }
+    if (!sequential) {
+      num_sequential_reads_ = 1;
+      readahead_size_ = 0;
+      readahead_limit_ = 0;
+      return;
+    }
+    const auto& table_options = table_->rep_->table_options;
+    if (++num_sequential_reads_ <= table_options.num_sequential_reads_for_auto_readahead) {
+      return;
+    }
+    readahead_size_ = readahead_size_ == 0
+        ? std::min(kInitialAutoReadaheadSize, max_readahead_size_)
+        : std::min(readahead_size_ * 2, max_readahead_size_);
+    if (!table_->GetBlockReader(block_type_)->reader->Prefetch(offset, readahead_size_).ok()) {
+      // Readahead is only a hint, stop trying if the file does not support it.
+      max_readahead_size_ = 0;
+      return;
+    }
+    readahead_limit_ = offset + readahead_size_;
+  }
+
+  static constexpr size_t kInitialAutoReadaheadSize = 8 * 1024;
+
   // Don't own table_. BlockEntryIteratorState should only be stored in iterators or in
   // corresponding BlockBasedTable. TableReader (superclass of BlockBasedTable) is only destroyed
   // after iterator is deleted.
@@ -270,8 +334,17 @@ class BlockBasedTable::BlockEntryIteratorState : public TwoLevelIteratorState {
   const ReadOptions read_options_;
   const bool skip_filters_;
   const BlockType block_type_;
+
+  // Readahead state, see MaybeReadahead.
+  size_t max_readahead_size_ = 0;
+  size_t num_sequential_reads_ = 0;
+  size_t readahead_size_ = 0;
+  uint64_t prev_block_end_ = std::numeric_limits<uint64_t>::max();
+  uint64_t readahead_limit_ = 0;
 };
 
+constexpr size_t BlockBasedTable::BlockEntryIteratorState::kInitialAutoReadaheadSize;
+
 
 class BlockBasedTable::IndexIteratorHolder {
  public:
@@ -324,6 +397,9 @@ BloomFilterAwareFileFilter::BloomFilterAwareFileFilter(
 bool BloomFilterAwareFileFilter::Filter(TableReader* reader) const {
   auto table = down_cast<BlockBasedTable*>(reader);
   if (table->rep_->filter_type == FilterType::kFixedSizeFilter) {
+    if (!table->IsFilterableLookupKey(user_key_)) {
+      return true;
+    }
     const auto filter_key = table->GetFilterKeyFromUserKey(user_key_);
     auto filter_entry = table->GetFilter(read_options_.query_id,
         read_options_.read_tier == kBlockCacheTier /* no_io */, &filter_key);
@@ -465,6 +541,20 @@ Status BlockBasedTable::Open(const ImmutableCFOptions& ioptions,
         "Cannot find Properties block from file.");
   }
 
+  // Read the compression dictionary, the data blocks can't be uncompressed without it.
+  BlockHandle compression_dict_handle;
+  if (FindMetaBlock(meta_iter.get(), kCompressionDictBlock, &compression_dict_handle).ok()) {
+    s = ReadBlockContents(
+        rep->base_reader_with_cache_prefix->reader.get(), rep->footer, ReadOptions::kDefault,
+        compression_dict_handle, &rep->compression_dict_block, rep->ioptions.env,
+        rep->mem_tracker, false /* do_uncompress */);
+    if (!s.ok()) {
+      RLOG(InfoLogLevel::ERROR_LEVEL, rep->ioptions.info_log,
+          "Encountered error while reading compression dictionary: %s", s.ToString().c_str());
+      return s;
+    }
+  }
+
   // Determine whether whole key filtering is supported.
   if (rep->table_properties) {
     rep->whole_key_filtering &=
@@ -478,7 +568,7 @@ Status BlockBasedTable::Open(const ImmutableCFOptions& ioptions,
 
   if (data_index_load_mode == DataIndexLoadMode::PRELOAD_ON_OPEN) {
     // Will use block cache for data index access?
-    if (table_options.cache_index_and_filter_blocks) {
+    if (table_options.cache_index_and_filter_blocks && !new_table->PinTopLevelIndex()) {
       DCHECK_ONLY_NOTNULL(table_options.block_cache.get());
       // Hack: Call NewIndexIterator() to implicitly add index to the
       // block_cache
@@ -684,9 +774,9 @@ Tickers GetBlockCacheHitTicker(BlockType block_type) {
 Status BlockBasedTable::GetDataBlockFromCache(
     const Slice& block_cache_key, const Slice& compressed_block_cache_key,
     Cache* block_cache, Cache* block_cache_compressed, Statistics* statistics,
-    const ReadOptions& read_options, BlockBasedTable::CachableEntry<Block>* block,
-    uint32_t format_version, BlockType block_type,
-    const std::shared_ptr<yb::MemTracker>& mem_tracker) {
+    const ReadOptions& read_options, QueryId query_id,
+    BlockBasedTable::CachableEntry<Block>* block, uint32_t format_version, BlockType block_type,
+    const std::shared_ptr<yb::MemTracker>& mem_tracker, const Slice& compression_dict) {
   Status s;
   Block* compressed_block = nullptr;
   Cache::Handle* block_cache_compressed_handle = nullptr;
@@ -696,7 +786,7 @@ Status BlockBasedTable::GetDataBlockFromCache(
     block->cache_handle =
         GetEntryFromCache(
             block_cache, block_cache_key, GetBlockCacheMissTicker(block_type),
-            GetBlockCacheHitTicker(block_type), statistics, read_options.query_id);
+            GetBlockCacheHitTicker(block_type), statistics, query_id);
     if (block->cache_handle != nullptr) {
       block->value =
           static_cast<Block*>(block_cache->Value(block->cache_handle));
@@ -713,7 +803,7 @@ Status BlockBasedTable::GetDataBlockFromCache(
 
   assert(!compressed_block_cache_key.empty());
   block_cache_compressed_handle =
-      block_cache_compressed->Lookup(compressed_block_cache_key, read_options.query_id);
+      block_cache_compressed->Lookup(compressed_block_cache_key, query_id);
   // if we found in the compressed cache, then uncompress and insert into
   // uncompressed cache
   if (block_cache_compressed_handle == nullptr) {
@@ -730,7 +820,7 @@ Status BlockBasedTable::GetDataBlockFromCache(
   // Retrieve the uncompressed contents into a new buffer
   BlockContents contents;
   s = UncompressBlockContents(compressed_block->data(), compressed_block->size(), &contents,
-                              format_version, mem_tracker);
+                              format_version, mem_tracker, compression_dict);
 
   // Insert uncompressed block into block cache
   if (s.ok()) {
@@ -738,7 +828,7 @@ Status BlockBasedTable::GetDataBlockFromCache(
     assert(block->value->compression_type() == kNoCompression);
     if (block_cache != nullptr && block->value->cachable() &&
         read_options.fill_cache) {
-      s = block_cache->Insert(block_cache_key, read_options.query_id, block->value,
+      s = block_cache->Insert(block_cache_key, query_id, block->value,
                               block->value->usable_size(), &DeleteCachedEntry<Block>,
                               &block->cache_handle, statistics);
       if (!s.ok()) {
@@ -756,9 +846,9 @@ Status BlockBasedTable::GetDataBlockFromCache(
 Status BlockBasedTable::PutDataBlockToCache(
     const Slice& block_cache_key, const Slice& compressed_block_cache_key,
     Cache* block_cache, Cache* block_cache_compressed,
-    const ReadOptions& read_options, Statistics* statistics,
+    const ReadOptions& read_options, QueryId query_id, Statistics* statistics,
     CachableEntry<Block>* block, Block* raw_block, uint32_t format_version,
-    const std::shared_ptr<yb::MemTracker>& mem_tracker) {
+    const std::shared_ptr<yb::MemTracker>& mem_tracker, const Slice& compression_dict) {
   assert(raw_block->compression_type() == kNoCompression ||
          block_cache_compressed != nullptr);
 
@@ -767,7 +857,7 @@ Status BlockBasedTable::PutDataBlockToCache(
   BlockContents contents;
   if (raw_block->compression_type() != kNoCompression) {
     s = UncompressBlockContents(raw_block->data(), raw_block->size(), &contents,
-                                format_version, mem_tracker);
+                                format_version, mem_tracker, compression_dict);
   }
   if (!s.ok()) {
     delete raw_block;
@@ -785,7 +875,7 @@ Status BlockBasedTable::PutDataBlockToCache(
   // Release the hold on the compressed cache entry immediately.
   if (block_cache_compressed != nullptr && raw_block != nullptr &&
       raw_block->cachable()) {
-    s = block_cache_compressed->Insert(compressed_block_cache_key, read_options.query_id, raw_block,
+    s = block_cache_compressed->Insert(compressed_block_cache_key, query_id, raw_block,
                                        raw_block->usable_size(), &DeleteCachedEntry<Block>);
     if (s.ok()) {
       // Avoid the following code to delete this cached block.
@@ -800,7 +890,7 @@ Status BlockBasedTable::PutDataBlockToCache(
   // insert into uncompressed block cache
   assert((block->value->compression_type() == kNoCompression));
   if (block_cache != nullptr && block->value->cachable()) {
-    s = block_cache->Insert(block_cache_key, read_options.query_id, block->value,
+    s = block_cache->Insert(block_cache_key, query_id, block->value,
                             block->value->usable_size(),
                             &DeleteCachedEntry<Block>, &block->cache_handle, statistics);
     if (!s.ok()) {
@@ -898,6 +988,22 @@ Slice BlockBasedTable::GetFilterKeyFromUserKey(const Slice &user_key) const {
       rep_->filter_key_transformer->Transform(user_key) : user_key;
 }
 
+bool BlockBasedTable::PinTopLevelIndex() const {
+  return rep_->table_options.pin_top_level_index &&
+         rep_->table_options.index_type == IndexType::kMultiLevelBinarySearch &&
+         rep_->data_index_load_mode != DataIndexLoadMode::USE_CACHE;
+}
+
+QueryId BlockBasedTable::IndexAndFilterQueryId(QueryId query_id) const {
+  return (rep_->table_options.index_and_filter_blocks_in_multi_touch_cache &&
+          query_id != kNoCacheQueryId) ? kInMultiTouchId : query_id;
+}
+
+bool BlockBasedTable::IsFilterableLookupKey(const Slice& user_key) const {
+  return !rep_->filter_key_transformer ||
+         rep_->filter_key_transformer->IsFilterableLookupKey(user_key);
+}
+
 BlockBasedTable::CachableEntry<FilterBlockReader> BlockBasedTable::GetFilter(
     const QueryId query_id,
     bool no_io,
@@ -960,8 +1066,9 @@ BlockBasedTable::CachableEntry<FilterBlockReader> BlockBasedTable::GetFilter(
       *filter_block_handle, cache_key_buffer);
 
   Statistics* statistics = rep_->ioptions.statistics;
+  const QueryId filter_query_id = IndexAndFilterQueryId(query_id);
   auto cache_handle = GetEntryFromCache(block_cache, filter_block_cache_key,
-      BLOCK_CACHE_FILTER_MISS, BLOCK_CACHE_FILTER_HIT, statistics, query_id);
+      BLOCK_CACHE_FILTER_MISS, BLOCK_CACHE_FILTER_HIT, statistics, filter_query_id);
 
   FilterBlockReader* filter = nullptr;
   if (cache_handle != nullptr) {
@@ -976,7 +1083,7 @@ BlockBasedTable::CachableEntry<FilterBlockReader> BlockBasedTable::GetFilter(
     filter = ReadFilterBlock(*filter_block_handle, rep_, &filter_size);
     if (filter != nullptr) {
       assert(filter_size > 0);
-      Status s = block_cache->Insert(filter_block_cache_key, query_id,
+      Status s = block_cache->Insert(filter_block_cache_key, filter_query_id,
                                      filter, filter_size,
                                      &DeleteCachedEntry<FilterBlockReader>, &cache_handle,
                                      statistics);
@@ -1022,14 +1129,15 @@ InternalIterator* BlockBasedTable::NewIndexIterator(
   Cache* const block_cache = rep_->table_options.block_cache.get();
 
   if (block_cache && (rep_->data_index_load_mode == DataIndexLoadMode::USE_CACHE ||
-      rep_->table_options.cache_index_and_filter_blocks)) {
+      (rep_->table_options.cache_index_and_filter_blocks && !PinTopLevelIndex()))) {
     char cache_key[block_based_table::kMaxCacheKeyPrefixSize + kMaxVarint64Length];
     auto key = GetCacheKey(rep_->base_reader_with_cache_prefix->cache_key_prefix,
         rep_->footer.index_handle(), cache_key);
     Statistics* statistics = rep_->ioptions.statistics;
+    const QueryId query_id = IndexAndFilterQueryId(read_options.query_id);
     auto cache_handle =
         GetEntryFromCache(block_cache, key, BLOCK_CACHE_INDEX_MISS,
-            BLOCK_CACHE_INDEX_HIT, statistics, read_options.query_id);
+            BLOCK_CACHE_INDEX_HIT, statistics, query_id);
 
     if (cache_handle == nullptr && no_io) {
       return ReturnNoIOErrorIterator(input_iter);
@@ -1042,7 +1150,7 @@ InternalIterator* BlockBasedTable::NewIndexIterator(
     std::unique_ptr<IndexReader> index_reader_unique;
     Status s = CreateDataBlockIndexReader(&index_reader_unique);
     if (s.ok()) {
-      s = block_cache->Insert(key, read_options.query_id, index_reader_unique.get(),
+      s = block_cache->Insert(key, query_id, index_reader_unique.get(),
                               index_reader_unique->usable_size(),
                               &DeleteCachedEntry<IndexReader>, &cache_handle, statistics);
     }
@@ -1120,6 +1228,9 @@ InternalIterator* BlockBasedTable::NewDataBlockIterator(const ReadOptions& ro,
   }
 
   FileReaderWithCachePrefix* reader = GetBlockReader(block_type);
+  // Only data blocks are compressed with the dictionary.
+  const Slice compression_dict =
+      block_type == BlockType::kData ? rep_->compression_dict_block.data : Slice();
 
   // If either block cache is enabled, we'll try to read from it.
   if (block_cache != nullptr || block_cache_compressed != nullptr) {
@@ -1138,9 +1249,11 @@ InternalIterator* BlockBasedTable::NewDataBlockIterator(const ReadOptions& ro,
       ckey = GetCacheKey(reader->compressed_cache_key_prefix, handle, compressed_cache_key);
     }
 
+    const QueryId query_id =
+        block_type == BlockType::kIndex ? IndexAndFilterQueryId(ro.query_id) : ro.query_id;
     s = GetDataBlockFromCache(
-        key, ckey, block_cache, block_cache_compressed, statistics, ro, &block,
-        rep_->table_options.format_version, block_type, rep_->mem_tracker);
+        key, ckey, block_cache, block_cache_compressed, statistics, ro, query_id, &block,
+        rep_->table_options.format_version, block_type, rep_->mem_tracker, compression_dict);
 
     if (block.value == nullptr && !no_io && ro.fill_cache) {
       std::unique_ptr<Block> raw_block;
@@ -1148,13 +1261,14 @@ InternalIterator* BlockBasedTable::NewDataBlockIterator(const ReadOptions& ro,
         StopWatch sw(rep_->ioptions.env, statistics, READ_BLOCK_GET_MICROS);
         s = block_based_table::ReadBlockFromFile(
             reader->reader.get(), rep_->footer, ro, handle, &raw_block, rep_->ioptions.env,
-            rep_->mem_tracker, block_cache_compressed == nullptr);
+            rep_->mem_tracker, block_cache_compressed == nullptr, compression_dict);
       }
 
       if (s.ok()) {
         s = PutDataBlockToCache(key, ckey, block_cache, block_cache_compressed,
-                                ro, statistics, &block, raw_block.release(),
-                                rep_->table_options.format_version, rep_->mem_tracker);
+                                ro, query_id, statistics, &block, raw_block.release(),
+                                rep_->table_options.format_version, rep_->mem_tracker,
+                                compression_dict);
       }
     }
   }
@@ -1173,7 +1287,7 @@ InternalIterator* BlockBasedTable::NewDataBlockIterator(const ReadOptions& ro,
     std::unique_ptr<Block> block_value;
     s = block_based_table::ReadBlockFromFile(
         reader->reader.get(), rep_->footer, ro, handle, &block_value, rep_->ioptions.env,
-        rep_->mem_tracker);
+        rep_->mem_tracker, true /* do_uncompress */, compression_dict);
     if (s.ok()) {
       block.value = block_value.release();
     }
@@ -1181,7 +1295,9 @@ InternalIterator* BlockBasedTable::NewDataBlockIterator(const ReadOptions& ro,
 
   InternalIterator* iter;
   if (s.ok() && block.value != nullptr) {
-    iter = block.value->NewIterator(rep_->comparator.get(), input_iter);
+    iter = block.value->NewIterator(
+        rep_->comparator.get(), input_iter, true /* total_order_seek */,
+        rep_->table_options.data_block_key_group_extractor.get());
     if (block.cache_handle != nullptr) {
       iter->RegisterCleanup(&ReleaseCachedEntry, block_cache,
           block.cache_handle);
@@ -1199,6 +1315,73 @@ InternalIterator* BlockBasedTable::NewDataBlockIterator(const ReadOptions& ro,
   return iter;
 }
 
+void BlockBasedTable::PrefetchDataBlocks(
+    const ReadOptions& ro, const std::vector<std::string>& index_values) {
+  Cache* block_cache = rep_->table_options.block_cache.get();
+  // Blocks in the compressed block cache are not checked, so do not prefetch when it is used.
+  if (block_cache == nullptr || rep_->table_options.block_cache_compressed != nullptr ||
+      !ro.fill_cache || ro.read_tier == kBlockCacheTier || ro.query_id == kNoCacheQueryId) {
+    return;
+  }
+
+  FileReaderWithCachePrefix* reader = GetBlockReader(BlockType::kData);
+  std::vector<BlockHandle> handles;
+  std::vector<std::string> cache_keys;
+  handles.reserve(index_values.size());
+  cache_keys.reserve(index_values.size());
+  for (const auto& index_value : index_values) {
+    BlockHandle handle;
+    Slice input = index_value;
+    if (!handle.DecodeFrom(&input).ok()) {
+      // The error is reported when the iterator reaches this block.
+      break;
+    }
+    char cache_key[block_based_table::kMaxCacheKeyPrefixSize + kMaxVarint64Length];
+    Slice key = GetCacheKey(reader->cache_key_prefix, handle, cache_key);
+    Cache::Handle* cache_handle = block_cache->Lookup(key, ro.query_id);
+    if (cache_handle != nullptr) {
+      block_cache->Release(cache_handle);
+      continue;
+    }
+    handles.push_back(handle);
+    cache_keys.push_back(key.ToBuffer());
+  }
+  // A single missing block is read by NewDataBlockIterator as usual.
+  if (handles.size() < 2) {
+    return;
+  }
+
+  Statistics* statistics = rep_->ioptions.statistics;
+  std::vector<BlockContents> contents(handles.size());
+  std::vector<Status> statuses(handles.size());
+  {
+    StopWatch sw(rep_->ioptions.env, statistics, READ_BLOCK_GET_MICROS);
+    ReadBlocksContents(
+        reader->reader.get(), rep_->footer, ro, handles.data(), handles.size(), contents.data(),
+        statuses.data(), rep_->ioptions.env, rep_->mem_tracker, true /* do_uncompress */,
+        rep_->compression_dict_block.data);
+  }
+  for (size_t i = 0; i != handles.size(); ++i) {
+    // Failed blocks are read again and the error is reported when the iterator reaches them.
+    if (!statuses[i].ok()) {
+      continue;
+    }
+    CachableEntry<Block> block;
+    Status s = PutDataBlockToCache(
+        cache_keys[i], Slice(), block_cache, nullptr, ro, ro.query_id, statistics, &block,
+        new Block(std::move(contents[i])), rep_->table_options.format_version,
+        rep_->mem_tracker);
+    if (!s.ok()) {
+      continue;
+    }
+    if (block.cache_handle != nullptr) {
+      block.Release(block_cache);
+    } else {
+      delete block.value;
+    }
+  }
+}
+
 // This will be broken if the user specifies an unusual implementation
 // of Options.comparator, or if the user specifies an unusual
 // definition of prefixes in BlockBasedTableOptions.filter_policy.
@@ -1335,7 +1518,7 @@ Status BlockBasedTable::Get(const ReadOptions& read_options, const Slice& intern
   Status s;
   CachableEntry<FilterBlockReader> filter_entry;
   Slice filter_key;
-  if (!skip_filters) {
+  if (!skip_filters && IsFilterableLookupKey(ExtractUserKey(internal_key))) {
     filter_key = GetFilterKeyFromInternalKey(internal_key);
     filter_entry = GetFilter(read_options.query_id,
                              read_options.read_tier == kBlockCacheTier,
@@ -1479,8 +1662,9 @@ bool BlockBasedTable::TEST_KeyInCache(const ReadOptions& options,
       GetCacheKey(rep_->data_reader_with_cache_prefix->cache_key_prefix, handle, cache_key_storage);
   Slice ckey;
 
-  s = GetDataBlockFromCache(cache_key, ckey, block_cache, nullptr, nullptr, options, &block,
-      rep_->table_options.format_version, BlockType::kData, rep_->mem_tracker);
+  s = GetDataBlockFromCache(cache_key, ckey, block_cache, nullptr, nullptr, options,
+      options.query_id, &block, rep_->table_options.format_version, BlockType::kData,
+      rep_->mem_tracker);
   assert(s.ok());
   bool in_cache = block.value != nullptr;
   if (in_cache) {
@@ -1611,6 +1795,26 @@ uint64_t BlockBasedTable::ApproximateOffsetOf(const Slice& key) {
   return result;
 }
 
+Status BlockBasedTable::GetSampleKeys(size_t max_keys, std::vector<std::string>* keys) {
+  const uint64_t num_data_blocks =
+      rep_->table_properties ? rep_->table_properties->num_data_blocks : 0;
+  if (max_keys == 0 || num_data_blocks <= 1) {
+    return Status::OK();
+  }
+  const uint64_t step = std::max<uint64_t>(num_data_blocks / (max_keys + 1), 1);
+
+  unique_ptr<InternalIterator> index_iter(NewIndexIterator(ReadOptions::kDefault));
+  uint64_t block_index = 0;
+  size_t num_keys = 0;
+  for (index_iter->SeekToFirst(); index_iter->Valid() && num_keys < max_keys; index_iter->Next()) {
+    if (++block_index % step == 0) {
+      keys->push_back(index_iter->key().ToString());
+      ++num_keys;
+    }
+  }
+  return index_iter->status();
+}
+
 bool BlockBasedTable::TEST_filter_block_preloaded() const {
   return rep_->filter != nullptr;
 }
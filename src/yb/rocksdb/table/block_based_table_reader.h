@@ -28,6 +28,7 @@
 #include <memory>
 #include <utility>
 #include <string>
+#include <vector>
 
 #include "yb/rocksdb/options.h"
 #include "yb/rocksdb/statistics.h"
@@ -164,6 +165,9 @@ class BlockBasedTable : public TableReader {
   // be close to the file length.
   uint64_t ApproximateOffsetOf(const Slice& key) override;
 
+  // Samples the keys from the data index, at equal distances in data blocks.
+  Status GetSampleKeys(size_t max_keys, std::vector<std::string>* keys) override;
+
   // Returns true if the block for the specified key is in cache.
   // REQUIRES: key is in this table && block cache enabled
   bool TEST_KeyInCache(const ReadOptions& options, const Slice& key);
@@ -213,6 +217,16 @@ class BlockBasedTable : public TableReader {
   // Returns key to be added to filter or verified against filter based on user_key.
   Slice GetFilterKeyFromUserKey(const Slice& user_key) const;
 
+  // Returns whether a lookup by the given user key could be checked against the filter.
+  bool IsFilterableLookupKey(const Slice& user_key) const;
+
+  // Returns whether the top level of the data index is kept in the table reader rather than in the
+  // block cache. See BlockBasedTableOptions::pin_top_level_index.
+  bool PinTopLevelIndex() const;
+
+  // Returns the query id to access index and filter blocks in the block cache with.
+  QueryId IndexAndFilterQueryId(QueryId query_id) const;
+
   // If `no_io == true`, we will not try to read filter/index from sst file (except fixed-size
   // filter blocks) were they not present in cache yet.
   // filter_key is only required when using fixed-size bloom filter in order to use the filter index
@@ -246,9 +260,10 @@ class BlockBasedTable : public TableReader {
   static Status GetDataBlockFromCache(
       const Slice& block_cache_key, const Slice& compressed_block_cache_key,
       Cache* block_cache, Cache* block_cache_compressed, Statistics* statistics,
-      const ReadOptions& read_options, BlockBasedTable::CachableEntry<Block>* block,
-      uint32_t format_version, BlockType block_type,
-      const std::shared_ptr<yb::MemTracker>& mem_tracker);
+      const ReadOptions& read_options, QueryId query_id,
+      BlockBasedTable::CachableEntry<Block>* block, uint32_t format_version, BlockType block_type,
+      const std::shared_ptr<yb::MemTracker>& mem_tracker,
+      const Slice& compression_dict = Slice());
 
   // Put a raw block (maybe compressed) to the corresponding block caches.
   // This method will perform decompression against raw_block if needed and then
@@ -261,9 +276,10 @@ class BlockBasedTable : public TableReader {
   static Status PutDataBlockToCache(
       const Slice& block_cache_key, const Slice& compressed_block_cache_key,
       Cache* block_cache, Cache* block_cache_compressed,
-      const ReadOptions& read_options, Statistics* statistics,
+      const ReadOptions& read_options, QueryId query_id, Statistics* statistics,
       CachableEntry<Block>* block, Block* raw_block, uint32_t format_version,
-      const std::shared_ptr<yb::MemTracker>& mem_tracker);
+      const std::shared_ptr<yb::MemTracker>& mem_tracker,
+      const Slice& compression_dict = Slice());
 
   // Calls (*handle_result)(arg, ...) repeatedly, starting with the entry found
   // after a call to Seek(key), until handle_result returns false.
@@ -301,6 +317,10 @@ class BlockBasedTable : public TableReader {
 
   FileReaderWithCachePrefix* GetBlockReader(BlockType block_type);
 
+  // Reads the data blocks referenced by index_values that are not in the block cache yet with a
+  // single batched file read, and adds them to the block cache.
+  void PrefetchDataBlocks(const ReadOptions& ro, const std::vector<std::string>& index_values);
+
   explicit BlockBasedTable(Rep* rep) : rep_(rep) {}
 
   // Helper functions for DumpTable()
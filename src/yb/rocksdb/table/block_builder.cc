@@ -44,24 +44,43 @@
 //     restarts: uint32[num_restarts]
 //     num_restarts: uint32
 // restarts[i] contains the offset within the block of the ith restart point.
+//
+// A block with a DataBlockHashIndex has the trailer:
+//     restarts: uint32[num_restarts]
+//     hash index: uint8[num_buckets], num_buckets: uint32
+//     num_restarts | kDataBlockHashIndexFlag: uint32
 
 #include "yb/rocksdb/table/block_builder.h"
 
 #include <assert.h>
+#include <string.h>
 
 #include <algorithm>
 
 #include "yb/rocksdb/comparator.h"
+#include "yb/rocksdb/table.h"
 #include "yb/rocksdb/db/dbformat.h"
 #include "yb/rocksdb/util/coding.h"
 
 namespace rocksdb {
 
 BlockBuilder::BlockBuilder(int block_restart_interval, bool use_delta_encoding)
+    : BlockBuilder(block_restart_interval, use_delta_encoding, nullptr /* key_group_extractor */,
+                   block_restart_interval) {
+}
+
+BlockBuilder::BlockBuilder(int block_restart_interval, bool use_delta_encoding,
+                           const KeyGroupExtractor* key_group_extractor, int max_restart_interval,
+                           bool use_hash_index)
     : block_restart_interval_(block_restart_interval),
       use_delta_encoding_(use_delta_encoding),
+      key_group_extractor_(use_delta_encoding ? key_group_extractor : nullptr),
+      max_restart_interval_(std::max(block_restart_interval, max_restart_interval)),
+      hash_index_builder_(use_hash_index && key_group_extractor_ != nullptr ?
+          new DataBlockHashIndexBuilder() : nullptr),
       restarts_(),
       counter_(0),
+      num_keys_(0),
       finished_(false) {
   assert(block_restart_interval_ >= 1);
   restarts_.push_back(0);       // First restart point is at offset 0
@@ -72,8 +91,12 @@ void BlockBuilder::Reset() {
   restarts_.clear();
   restarts_.push_back(0);       // First restart point is at offset 0
   counter_ = 0;
+  num_keys_ = 0;
   finished_ = false;
   last_key_.clear();
+  if (hash_index_builder_) {
+    hash_index_builder_->Reset();
+  }
 }
 
 size_t BlockBuilder::CurrentSizeEstimate() const {
@@ -82,6 +105,9 @@ size_t BlockBuilder::CurrentSizeEstimate() const {
     // Restarts haven't been flushed to buffer yet.
     size += restarts_.size() * sizeof(uint32_t) +    // Restart array.
             sizeof(uint32_t);                        // Restart array length.
+    if (hash_index_builder_) {
+      size += hash_index_builder_->EstimateSize();
+    }
   }
   return size;
 }
@@ -102,7 +128,16 @@ size_t BlockBuilder::EstimateSizeAfterKV(const Slice& key, const Slice& value)
 }
 
 size_t BlockBuilder::NumKeys() const {
-  return restarts_.size() * block_restart_interval_ + counter_;
+  return num_keys_;
+}
+
+size_t BlockBuilder::GroupPrefixSize(const Slice& key) const {
+  return key.size() < 8 ? 0 : key_group_extractor_->GroupPrefixSize(ExtractUserKey(key));
+}
+
+bool BlockBuilder::SameKeyGroup(const Slice& key, size_t group_prefix_size) const {
+  return group_prefix_size != 0 && last_key_.size() >= group_prefix_size &&
+         memcmp(last_key_.data(), key.data(), group_prefix_size) == 0;
 }
 
 Slice BlockBuilder::Finish() {
@@ -110,7 +145,12 @@ Slice BlockBuilder::Finish() {
   for (size_t i = 0; i < restarts_.size(); i++) {
     PutFixed32(&buffer_, restarts_[i]);
   }
-  PutFixed32(&buffer_, static_cast<uint32_t>(restarts_.size()));
+  uint32_t num_restarts = static_cast<uint32_t>(restarts_.size());
+  if (hash_index_builder_ && hash_index_builder_->Valid()) {
+    hash_index_builder_->Finish(&buffer_);
+    num_restarts |= kDataBlockHashIndexFlag;
+  }
+  PutFixed32(&buffer_, num_restarts);
   finished_ = true;
   return Slice(buffer_);
 }
@@ -118,13 +158,27 @@ Slice BlockBuilder::Finish() {
 void BlockBuilder::Add(const Slice& key, const Slice& value) {
   Slice last_key_piece(last_key_);
   assert(!finished_);
-  assert(counter_ <= block_restart_interval_);
+  assert(counter_ <= max_restart_interval_);
   size_t shared = 0;  // number of bytes shared with prev key
-  if (counter_ >= block_restart_interval_) {
+  // The group of the key is only needed to decide whether to postpone a restart, and for the hash
+  // index.
+  const bool need_group = key_group_extractor_ != nullptr &&
+      (hash_index_builder_ != nullptr ||
+       (counter_ >= block_restart_interval_ && counter_ < max_restart_interval_));
+  const size_t group_prefix_size = need_group ? GroupPrefixSize(key) : 0;
+  const bool same_group = SameKeyGroup(key, group_prefix_size);
+  const bool restart = counter_ >= block_restart_interval_ &&
+      (key_group_extractor_ == nullptr || counter_ >= max_restart_interval_ || !same_group);
+  if (restart) {
     // Restart compression
     restarts_.push_back(static_cast<uint32_t>(buffer_.size()));
     counter_ = 0;
-  } else if (use_delta_encoding_) {
+  }
+  if (hash_index_builder_ && group_prefix_size != 0 && !same_group) {
+    hash_index_builder_->Add(Slice(key.data(), group_prefix_size),
+                             static_cast<uint32_t>(restarts_.size() - 1));
+  }
+  if (!restart && use_delta_encoding_) {
     // See how much sharing to do with previous string
     const size_t min_length = std::min(last_key_piece.size(), key.size());
     while ((shared < min_length) && (last_key_piece[shared] == key[shared])) {
@@ -147,6 +201,7 @@ void BlockBuilder::Add(const Slice& key, const Slice& value) {
   last_key_.append(key.cdata() + shared, non_shared);
   assert(Slice(last_key_) == key);
   counter_++;
+  num_keys_++;
 }
 
 }  // namespace rocksdb
@@ -25,11 +25,15 @@
 #define YB_ROCKSDB_TABLE_BLOCK_BUILDER_H
 
 #include <stdint.h>
+#include <memory>
 #include <vector>
 #include "yb/util/slice.h"
+#include "yb/rocksdb/table/data_block_hash_index.h"
 
 namespace rocksdb {
 
+class KeyGroupExtractor;
+
 class BlockBuilder {
  public:
   BlockBuilder(const BlockBuilder&) = delete;
@@ -38,6 +42,14 @@ class BlockBuilder {
   explicit BlockBuilder(int block_restart_interval,
                         bool use_delta_encoding = true);
 
+  // Builder that postpones restart points while keys belong to the same group according to
+  // key_group_extractor, up to max_restart_interval keys between restart points. Keys are
+  // expected to be internal keys. If use_hash_index is true, a DataBlockHashIndex of the groups
+  // is appended to the block.
+  BlockBuilder(int block_restart_interval, bool use_delta_encoding,
+               const KeyGroupExtractor* key_group_extractor, int max_restart_interval,
+               bool use_hash_index = false);
+
   // Reset the contents as if the BlockBuilder was just constructed.
   void Reset();
 
@@ -65,12 +77,23 @@ class BlockBuilder {
   }
 
  private:
+  // Returns the size of the group prefix of key, or 0 if it does not belong to any group.
+  size_t GroupPrefixSize(const Slice& key) const;
+
+  // Returns true if key belongs to the same key group as last_key_.
+  bool SameKeyGroup(const Slice& key, size_t group_prefix_size) const;
+
   const int          block_restart_interval_;
   const bool         use_delta_encoding_;
+  const KeyGroupExtractor* const key_group_extractor_;
+  const int          max_restart_interval_;
+  // Set when the block has a hash index.
+  std::unique_ptr<DataBlockHashIndexBuilder> hash_index_builder_;
 
   std::string           buffer_;    // Destination buffer
   std::vector<uint32_t> restarts_;  // Restart points
   int                   counter_;   // Number of entries emitted since restart
+  size_t                num_keys_;  // Number of entries emitted since Reset()
   bool                  finished_;  // Has Finish() been called?
   std::string           last_key_;
 };
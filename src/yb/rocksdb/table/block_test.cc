@@ -243,6 +243,144 @@ TEST_F(BlockTest, IndexHashWithSharedPrefix) {
   CheckBlockContents(std::move(contents), kMaxKey, keys, values);
 }
 
+namespace {
+
+// Groups keys generated by GenerateKey by their primary key.
+class PrimaryKeyGroupExtractor : public KeyGroupExtractor {
+ public:
+  const char* Name() const override { return "PrimaryKeyGroupExtractor"; }
+
+  size_t GroupPrefixSize(const Slice& user_key) const override {
+    return user_key.size() >= 6 ? 6 : 0;
+  }
+};
+
+} // namespace
+
+TEST_F(BlockTest, KeyGroupRestarts) {
+  const int kNumPrimaryKeys = 1000;
+  const int kKeysPerPrimaryKey = 40;
+  const int kRestartInterval = 16;
+  Options options;
+  std::vector<std::string> keys;
+  std::vector<std::string> values;
+  // Padding plays the role of the internal key suffix.
+  GenerateRandomKVs(&keys, &values, 0, kNumPrimaryKeys, 1, 8 /* padding size */,
+                    kKeysPerPrimaryKey);
+
+  BlockBuilder plain_builder(kRestartInterval);
+  PrimaryKeyGroupExtractor extractor;
+  BlockBuilder grouped_builder(kRestartInterval, true /* use_delta_encoding */, &extractor,
+                               64 /* max_restart_interval */);
+  for (size_t i = 0; i < keys.size(); ++i) {
+    plain_builder.Add(keys[i], values[i]);
+    grouped_builder.Add(keys[i], values[i]);
+  }
+  ASSERT_EQ(keys.size(), grouped_builder.NumKeys());
+
+  BlockContents plain_contents;
+  plain_contents.data = plain_builder.Finish();
+  plain_contents.cachable = false;
+  Block plain_block(std::move(plain_contents));
+
+  BlockContents grouped_contents;
+  grouped_contents.data = grouped_builder.Finish();
+  grouped_contents.cachable = false;
+  Block grouped_block(std::move(grouped_contents));
+
+  // Restarts are only placed at the start of a primary key.
+  ASSERT_EQ(kNumPrimaryKeys, grouped_block.NumRestarts());
+  ASSERT_LT(grouped_block.NumRestarts(), plain_block.NumRestarts());
+  ASSERT_LT(grouped_block.size(), plain_block.size());
+
+  std::unique_ptr<InternalIterator> iter(grouped_block.NewIterator(options.comparator));
+  size_t count = 0;
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next(), ++count) {
+    ASSERT_EQ(keys[count], iter->key().ToString());
+    ASSERT_EQ(values[count], iter->value().ToString());
+  }
+  ASSERT_EQ(keys.size(), count);
+
+  for (size_t i = 0; i < keys.size(); i += 7) {
+    iter->Seek(keys[i]);
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ(keys[i], iter->key().ToString());
+    ASSERT_EQ(values[i], iter->value().ToString());
+  }
+}
+
+TEST_F(BlockTest, DataBlockHashIndex) {
+  const int kNumPrimaryKeys = 200;
+  const int kRestartInterval = 16;
+  Options options;
+  Random rnd(301);
+  // Only even primary keys are present, with from 1 to 90 keys each, so some groups share a
+  // restart interval and others span several ones.
+  std::vector<std::string> keys;
+  for (int primary_key = 0; primary_key < kNumPrimaryKeys; primary_key += 2) {
+    const int num_keys = 1 + primary_key * 7 % 90;
+    for (int secondary_key = 0; secondary_key < num_keys; ++secondary_key) {
+      keys.push_back(GenerateKey(primary_key, secondary_key, 8 /* padding size */, &rnd));
+    }
+  }
+
+  PrimaryKeyGroupExtractor extractor;
+  BlockBuilder plain_builder(kRestartInterval, true /* use_delta_encoding */, &extractor,
+                             64 /* max_restart_interval */);
+  BlockBuilder hashed_builder(kRestartInterval, true /* use_delta_encoding */, &extractor,
+                              64 /* max_restart_interval */, true /* use_hash_index */);
+  for (size_t i = 0; i < keys.size(); ++i) {
+    const auto value = std::to_string(i);
+    plain_builder.Add(keys[i], value);
+    hashed_builder.Add(keys[i], value);
+  }
+
+  BlockContents plain_contents;
+  plain_contents.data = plain_builder.Finish();
+  plain_contents.cachable = false;
+  Block plain_block(std::move(plain_contents));
+
+  BlockContents hashed_contents;
+  hashed_contents.data = hashed_builder.Finish();
+  hashed_contents.cachable = false;
+  Block hashed_block(std::move(hashed_contents));
+
+  ASSERT_EQ(plain_block.NumRestarts(), hashed_block.NumRestarts());
+  ASSERT_GT(hashed_block.size(), plain_block.size());
+
+  std::unique_ptr<InternalIterator> plain_iter(plain_block.NewIterator(options.comparator));
+  std::unique_ptr<InternalIterator> hashed_iter(hashed_block.NewIterator(
+      options.comparator, nullptr /* iter */, true /* total_order_seek */, &extractor));
+
+  size_t count = 0;
+  for (hashed_iter->SeekToFirst(); hashed_iter->Valid(); hashed_iter->Next(), ++count) {
+    ASSERT_EQ(keys[count], hashed_iter->key().ToString());
+  }
+  ASSERT_EQ(keys.size(), count);
+
+  for (size_t i = 0; i < keys.size(); ++i) {
+    hashed_iter->Seek(keys[i]);
+    ASSERT_TRUE(hashed_iter->Valid());
+    ASSERT_EQ(keys[i], hashed_iter->key().ToString());
+    ASSERT_EQ(std::to_string(i), hashed_iter->value().ToString());
+  }
+
+  // Seeks to keys that are not in the block, including to groups that are not in the block,
+  // end up at the same key as with a binary search.
+  for (int primary_key = 0; primary_key <= kNumPrimaryKeys; ++primary_key) {
+    for (int secondary_key = 0; secondary_key < 100; secondary_key += 7) {
+      const auto target = GenerateKey(primary_key, secondary_key, 0 /* padding size */, nullptr) +
+                          std::string(8, '\0');
+      plain_iter->Seek(target);
+      hashed_iter->Seek(target);
+      ASSERT_EQ(plain_iter->Valid(), hashed_iter->Valid()) << target;
+      if (plain_iter->Valid()) {
+        ASSERT_EQ(plain_iter->key().ToString(), hashed_iter->key().ToString()) << target;
+      }
+    }
+  }
+}
+
 }  // namespace rocksdb
 
 int main(int argc, char **argv) {
@@ -0,0 +1,95 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/rocksdb/table/data_block_hash_index.h"
+
+#include <algorithm>
+
+#include "yb/rocksdb/util/coding.h"
+#include "yb/rocksdb/util/hash.h"
+
+namespace rocksdb {
+
+namespace {
+
+constexpr uint32_t kHashSeed = 0x5f3759df;
+
+// About 3 groups per 4 buckets, so that few groups collide.
+constexpr double kBucketsPerGroup = 1.33;
+
+uint32_t GroupHash(const Slice& group_prefix) {
+  return Hash(group_prefix.cdata(), group_prefix.size(), kHashSeed);
+}
+
+uint32_t NumBuckets(size_t num_groups) {
+  return static_cast<uint32_t>(num_groups * kBucketsPerGroup) + 1;
+}
+
+} // namespace
+
+void DataBlockHashIndexBuilder::Add(const Slice& group_prefix, uint32_t restart_index) {
+  if (restart_index > DataBlockHashIndex::kMaxRestartIndex) {
+    valid_ = false;
+    return;
+  }
+  if (valid_) {
+    entries_.emplace_back(GroupHash(group_prefix), static_cast<uint8_t>(restart_index));
+  }
+}
+
+size_t DataBlockHashIndexBuilder::EstimateSize() const {
+  return Valid() ? NumBuckets(entries_.size()) + sizeof(uint32_t) : 0;
+}
+
+void DataBlockHashIndexBuilder::Finish(std::string* buffer) const {
+  const uint32_t num_buckets = NumBuckets(entries_.size());
+  std::vector<uint8_t> buckets(num_buckets, DataBlockHashIndex::kNoEntry);
+  for (const auto& entry : entries_) {
+    auto& bucket = buckets[entry.first % num_buckets];
+    if (bucket == DataBlockHashIndex::kNoEntry) {
+      bucket = entry.second;
+    } else if (bucket != entry.second) {
+      bucket = DataBlockHashIndex::kCollision;
+    }
+  }
+  buffer->append(reinterpret_cast<const char*>(buckets.data()), buckets.size());
+  PutFixed32(buffer, num_buckets);
+}
+
+void DataBlockHashIndexBuilder::Reset() {
+  entries_.clear();
+  valid_ = true;
+}
+
+constexpr uint8_t DataBlockHashIndex::kNoEntry;
+constexpr uint8_t DataBlockHashIndex::kCollision;
+constexpr uint32_t DataBlockHashIndex::kMaxRestartIndex;
+
+const char* DataBlockHashIndex::Initialize(const char* start, const char* end) {
+  if (end - start < static_cast<ptrdiff_t>(sizeof(uint32_t))) {
+    return nullptr;
+  }
+  const uint32_t num_buckets = DecodeFixed32(end - sizeof(uint32_t));
+  if (num_buckets == 0 || end - start - sizeof(uint32_t) < num_buckets) {
+    return nullptr;
+  }
+  num_buckets_ = num_buckets;
+  buckets_ = reinterpret_cast<const uint8_t*>(end - sizeof(uint32_t) - num_buckets);
+  return reinterpret_cast<const char*>(buckets_);
+}
+
+uint8_t DataBlockHashIndex::Lookup(const Slice& group_prefix) const {
+  return buckets_[GroupHash(group_prefix) % num_buckets_];
+}
+
+}  // namespace rocksdb
@@ -0,0 +1,94 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_ROCKSDB_TABLE_DATA_BLOCK_HASH_INDEX_H
+#define YB_ROCKSDB_TABLE_DATA_BLOCK_HASH_INDEX_H
+
+#include <stdint.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "yb/util/slice.h"
+
+namespace rocksdb {
+
+// Set in the number of restarts stored at the end of a data block that has a hash index. The
+// number of restarts of a block without one never has it set.
+constexpr uint32_t kDataBlockHashIndexFlag = 1u << 31;
+
+// Hash index stored at the end of a data block, that maps the group prefix of the keys of the
+// block, e.g. the DocKey of a DocDB key, to the restart interval holding the first key of the
+// group. A seek then starts from that restart interval instead of binary searching the restart
+// array.
+//
+// The index is an array of one byte buckets followed by the number of buckets. A bucket holds
+// the restart index of the only group that was hashed to it, kNoEntry if no group was hashed to it
+// or kCollision if several were. So the index can only point to the first 254 restart intervals.
+//
+// A bucket may also point to the restart interval of another group, when the group looked up is
+// not in the block, so readers have to check the restart interval they get.
+class DataBlockHashIndexBuilder {
+ public:
+  // Adds a group whose first key is in the restart interval restart_index of the block.
+  void Add(const Slice& group_prefix, uint32_t restart_index);
+
+  // Returns true if the index should be appended to the block.
+  bool Valid() const {
+    return valid_ && !entries_.empty();
+  }
+
+  // Returns an estimate of the size of the encoded index.
+  size_t EstimateSize() const;
+
+  // Appends the encoded index to buffer.
+  void Finish(std::string* buffer) const;
+
+  void Reset();
+
+ private:
+  // Hash of the group prefix and restart index of the group, in the order they were added.
+  std::vector<std::pair<uint32_t, uint8_t>> entries_;
+  bool valid_ = true;
+};
+
+class DataBlockHashIndex {
+ public:
+  static constexpr uint8_t kNoEntry = 255;
+  static constexpr uint8_t kCollision = 254;
+  static constexpr uint32_t kMaxRestartIndex = 253;
+
+  // Initializes the index from the encoded index that ends at end. Returns the start of the
+  // encoded index, or nullptr if it is corrupted.
+  const char* Initialize(const char* start, const char* end);
+
+  // Returns the restart index of the bucket of group_prefix, kNoEntry or kCollision.
+  uint8_t Lookup(const Slice& group_prefix) const;
+
+  bool initialized() const {
+    return num_buckets_ != 0;
+  }
+
+  size_t size() const {
+    return num_buckets_ + sizeof(uint32_t);
+  }
+
+ private:
+  const uint8_t* buckets_ = nullptr;
+  uint32_t num_buckets_ = 0;
+};
+
+}  // namespace rocksdb
+
+#endif // YB_ROCKSDB_TABLE_DATA_BLOCK_HASH_INDEX_H
@@ -26,6 +26,7 @@
 #include <inttypes.h>
 
 #include <string>
+#include <vector>
 
 #include "yb/rocksdb/env.h"
 #include "yb/rocksdb/table/block.h"
@@ -270,32 +271,18 @@ Status ReadFooterFromFile(RandomAccessFileReader* file, uint64_t file_size,
 // Without anonymous namespace here, we fail the warning -Wmissing-prototypes
 namespace {
 
-// Read a block and check its CRC
-// contents is the result of reading.
-// According to the implementation of file->Read, contents may not point to buf
-Status ReadBlock(RandomAccessFileReader* file, const Footer& footer,
-                 const ReadOptions& options, const BlockHandle& handle,
-                 Slice* contents, /* result of reading */ char* buf) {
+// Check the size and the CRC of a block that was read from the file.
+Status VerifyBlock(const Footer& footer, const ReadOptions& options, const BlockHandle& handle,
+                   const Slice& contents) {
   size_t n = static_cast<size_t>(handle.size());
   Status s;
 
-  {
-    PERF_TIMER_GUARD(block_read_time);
-    s = file->Read(handle.offset(), n + kBlockTrailerSize, contents, buf);
-  }
-
-  PERF_COUNTER_ADD(block_read_count, 1);
-  PERF_COUNTER_ADD(block_read_byte, n + kBlockTrailerSize);
-
-  if (!s.ok()) {
-    return s;
-  }
-  if (contents->size() != n + kBlockTrailerSize) {
+  if (contents.size() != n + kBlockTrailerSize) {
     return STATUS(Corruption, "truncated block read");
   }
 
   // Check the crc of the type and the block contents
-  const char* data = contents->cdata();  // Pointer to where Read put the data
+  const char* data = contents.cdata();  // Pointer to where Read put the data
   if (options.verify_checksums) {
     PERF_TIMER_GUARD(block_checksum_time);
     uint32_t value = DecodeFixed32(data + n + 1);
@@ -321,6 +308,29 @@ Status ReadBlock(RandomAccessFileReader* file, const Footer& footer,
   return s;
 }
 
+// Read a block and check its CRC
+// contents is the result of reading.
+// According to the implementation of file->Read, contents may not point to buf
+Status ReadBlock(RandomAccessFileReader* file, const Footer& footer,
+                 const ReadOptions& options, const BlockHandle& handle,
+                 Slice* contents, /* result of reading */ char* buf) {
+  size_t n = static_cast<size_t>(handle.size());
+  Status s;
+
+  {
+    PERF_TIMER_GUARD(block_read_time);
+    s = file->Read(handle.offset(), n + kBlockTrailerSize, contents, buf);
+  }
+
+  PERF_COUNTER_ADD(block_read_count, 1);
+  PERF_COUNTER_ADD(block_read_byte, n + kBlockTrailerSize);
+
+  if (!s.ok()) {
+    return s;
+  }
+  return VerifyBlock(footer, options, handle, *contents);
+}
+
 }  // namespace
 
 TrackedAllocation::TrackedAllocation()
@@ -365,7 +375,8 @@ BlockContents::BlockContents(
 Status ReadBlockContents(RandomAccessFileReader* file, const Footer& footer,
                          const ReadOptions& options, const BlockHandle& handle,
                          BlockContents* contents, Env* env,
-                         const yb::MemTrackerPtr& mem_tracker, bool decompression_requested) {
+                         const yb::MemTrackerPtr& mem_tracker, bool decompression_requested,
+                         const Slice& compression_dict) {
   Status status;
   Slice slice;
   size_t n = static_cast<size_t>(handle.size());
@@ -395,7 +406,8 @@ Status ReadBlockContents(RandomAccessFileReader* file, const Footer& footer,
   compression_type = static_cast<rocksdb::CompressionType>(slice.data()[n]);
 
   if (decompression_requested && compression_type != kNoCompression) {
-    return UncompressBlockContents(slice.cdata(), n, contents, footer.version(), mem_tracker);
+    return UncompressBlockContents(
+        slice.cdata(), n, contents, footer.version(), mem_tracker, compression_dict);
   }
 
   if (slice.cdata() != used_buf) {
@@ -412,6 +424,62 @@ Status ReadBlockContents(RandomAccessFileReader* file, const Footer& footer,
   return status;
 }
 
+void ReadBlocksContents(RandomAccessFileReader* file, const Footer& footer,
+                        const ReadOptions& options, const BlockHandle* handles, size_t num_handles,
+                        BlockContents* contents, Status* statuses, Env* env,
+                        const yb::MemTrackerPtr& mem_tracker, bool decompression_requested,
+                        const Slice& compression_dict) {
+  std::vector<std::unique_ptr<char[]>> bufs(num_handles);
+  std::vector<ReadRequest> requests(num_handles);
+  size_t total_size = 0;
+  for (size_t i = 0; i != num_handles; ++i) {
+    auto& request = requests[i];
+    request.offset = handles[i].offset();
+    request.n = static_cast<size_t>(handles[i].size()) + kBlockTrailerSize;
+    bufs[i].reset(new char[request.n]);
+    request.scratch = bufs[i].get();
+    total_size += request.n;
+  }
+
+  Status status;
+  {
+    PERF_TIMER_GUARD(block_read_time);
+    status = file->MultiRead(requests.data(), num_handles);
+  }
+
+  PERF_COUNTER_ADD(block_read_count, num_handles);
+  PERF_COUNTER_ADD(block_read_byte, total_size);
+
+  for (size_t i = 0; i != num_handles; ++i) {
+    const auto& request = requests[i];
+    if (!status.ok()) {
+      statuses[i] = status;
+      continue;
+    }
+    statuses[i] = request.status;
+    if (statuses[i].ok()) {
+      statuses[i] = VerifyBlock(footer, options, handles[i], request.result);
+    }
+    if (!statuses[i].ok()) {
+      continue;
+    }
+
+    PERF_TIMER_GUARD(block_decompress_time);
+
+    const size_t n = static_cast<size_t>(handles[i].size());
+    const Slice& slice = request.result;
+    auto compression_type = static_cast<rocksdb::CompressionType>(slice.data()[n]);
+    if (decompression_requested && compression_type != kNoCompression) {
+      statuses[i] = UncompressBlockContents(
+          slice.cdata(), n, &contents[i], footer.version(), mem_tracker, compression_dict);
+    } else if (slice.cdata() != bufs[i].get()) {
+      contents[i] = BlockContents(Slice(slice.data(), n), false, compression_type);
+    } else {
+      contents[i] = BlockContents(std::move(bufs[i]), n, true, compression_type, mem_tracker);
+    }
+  }
+}
+
 //
 // The 'data' points to the raw block contents that was read in from file.
 // This method allocates a new heap buffer and the raw block
@@ -422,7 +490,8 @@ Status ReadBlockContents(RandomAccessFileReader* file, const Footer& footer,
 Status UncompressBlockContents(const char* data, size_t n,
                                BlockContents* contents,
                                uint32_t format_version,
-                               const std::shared_ptr<yb::MemTracker>& mem_tracker) {
+                               const std::shared_ptr<yb::MemTracker>& mem_tracker,
+                               const Slice& compression_dict) {
   std::unique_ptr<char[]> ubuf;
   int decompress_size = 0;
   assert(data[n] != kNoCompression);
@@ -444,7 +513,7 @@ Status UncompressBlockContents(const char* data, size_t n,
     case kZlibCompression:
       ubuf = std::unique_ptr<char[]>(Zlib_Uncompress(
           data, n, &decompress_size,
-          GetCompressFormatForVersion(kZlibCompression, format_version)));
+          GetCompressFormatForVersion(kZlibCompression, format_version), compression_dict));
       if (!ubuf) {
         static char zlib_corrupt_msg[] =
           "Zlib not supported or corrupted Zlib compressed block contents";
@@ -468,7 +537,7 @@ Status UncompressBlockContents(const char* data, size_t n,
     case kLZ4Compression:
       ubuf = std::unique_ptr<char[]>(LZ4_Uncompress(
           data, n, &decompress_size,
-          GetCompressFormatForVersion(kLZ4Compression, format_version)));
+          GetCompressFormatForVersion(kLZ4Compression, format_version), compression_dict));
       if (!ubuf) {
         static char lz4_corrupt_msg[] =
           "LZ4 not supported or corrupted LZ4 compressed block contents";
@@ -480,7 +549,7 @@ Status UncompressBlockContents(const char* data, size_t n,
     case kLZ4HCCompression:
       ubuf = std::unique_ptr<char[]>(LZ4_Uncompress(
           data, n, &decompress_size,
-          GetCompressFormatForVersion(kLZ4HCCompression, format_version)));
+          GetCompressFormatForVersion(kLZ4HCCompression, format_version), compression_dict));
       if (!ubuf) {
         static char lz4hc_corrupt_msg[] =
           "LZ4HC not supported or corrupted LZ4HC compressed block contents";
@@ -490,8 +559,8 @@ Status UncompressBlockContents(const char* data, size_t n,
           BlockContents(std::move(ubuf), decompress_size, true, kNoCompression, mem_tracker);
       break;
     case kZSTDNotFinalCompression:
-      ubuf =
-          std::unique_ptr<char[]>(ZSTD_Uncompress(data, n, &decompress_size));
+      ubuf = std::unique_ptr<char[]>(
+          ZSTD_Uncompress(data, n, &decompress_size, compression_dict));
       if (!ubuf) {
         static char zstd_corrupt_msg[] =
             "ZSTD not supported or corrupted ZSTD compressed block contents";
@@ -245,13 +245,26 @@ struct BlockContents {
 
 // Read the block identified by "handle" from "file".  On failure
 // return non-OK.  On success fill *result and return OK.
+// compression_dict is the dictionary the block was compressed with, if any.
 extern Status ReadBlockContents(RandomAccessFileReader* file,
                                 const Footer& footer,
                                 const ReadOptions& options,
                                 const BlockHandle& handle,
                                 BlockContents* contents, Env* env,
                                 const std::shared_ptr<yb::MemTracker>& mem_tracker,
-                                bool do_uncompress);
+                                bool do_uncompress,
+                                const Slice& compression_dict = Slice());
+
+// Read the blocks identified by "handles" from "file" with a single batched file read. Fills
+// contents[i] and statuses[i] the same way ReadBlockContents does for handles[i].
+extern void ReadBlocksContents(RandomAccessFileReader* file,
+                               const Footer& footer,
+                               const ReadOptions& options,
+                               const BlockHandle* handles, size_t num_handles,
+                               BlockContents* contents, Status* statuses, Env* env,
+                               const std::shared_ptr<yb::MemTracker>& mem_tracker,
+                               bool do_uncompress,
+                               const Slice& compression_dict = Slice());
 
 // The 'data' points to the raw block contents read in from file.
 // This method allocates a new heap buffer and the raw block
@@ -260,10 +273,12 @@ extern Status ReadBlockContents(RandomAccessFileReader* file,
 // free this buffer.
 // For description of compress_format_version and possible values, see
 // util/compression.h
+// compression_dict is the dictionary the block was compressed with, empty if none was used.
 extern Status UncompressBlockContents(const char* data, size_t n,
                                       BlockContents* contents,
                                       uint32_t compress_format_version,
-                                      const std::shared_ptr<yb::MemTracker>& mem_tracker);
+                                      const std::shared_ptr<yb::MemTracker>& mem_tracker,
+                                      const Slice& compression_dict = Slice());
 
 // Implementation details follow.  Clients should ignore,
 
@@ -25,6 +25,8 @@
 #define ROCKSDB_TABLE_TABLE_READER_H
 
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "yb/util/slice.h"
 
@@ -72,6 +74,12 @@ class TableReader {
   // be close to the file length.
   virtual uint64_t ApproximateOffsetOf(const Slice& key) = 0;
 
+  // Appends to keys up to max_keys internal keys that split the table into parts of roughly equal
+  // size, in increasing order. The default implementation appends nothing.
+  virtual Status GetSampleKeys(size_t max_keys, std::vector<std::string>* keys) {
+    return Status::OK();
+  }
+
   // Set up the table for Compaction. Might change some parameters with
   // posix_fadvise
   virtual void SetupForCompaction() = 0;
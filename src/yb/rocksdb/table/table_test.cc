@@ -298,7 +298,7 @@ class TableConstructor: public Constructor {
                             internal_comparator,
                             int_tbl_prop_collector_factories,
                             options.compression,
-                            CompressionOptions(),
+                            options.compression_opts,
                             /* skip_filters */ false),
         TablePropertiesCollectorFactory::Context::kUnknownColumnFamily,
         file_writer_.get()));
@@ -323,8 +323,8 @@ class TableConstructor: public Constructor {
 
     // Open the table
     uniq_id_ = cur_uniq_id_++;
-    file_reader_.reset(test::GetRandomAccessFileReader(new test::StringSource(
-        GetSink()->contents(), uniq_id_, ioptions.allow_mmap_reads)));
+    source_ = new test::StringSource(GetSink()->contents(), uniq_id_, ioptions.allow_mmap_reads);
+    file_reader_.reset(test::GetRandomAccessFileReader(source_));
     return ioptions.table_factory->NewTableReader(
         TableReaderOptions(ioptions, soptions, internal_comparator),
         std::move(file_reader_), GetSink()->contents().size(), &table_reader_);
@@ -345,8 +345,8 @@ class TableConstructor: public Constructor {
   }
 
   virtual Status Reopen(const ImmutableCFOptions& ioptions) {
-    file_reader_.reset(test::GetRandomAccessFileReader(new test::StringSource(
-        GetSink()->contents(), uniq_id_, ioptions.allow_mmap_reads)));
+    source_ = new test::StringSource(GetSink()->contents(), uniq_id_, ioptions.allow_mmap_reads);
+    file_reader_.reset(test::GetRandomAccessFileReader(source_));
     return ioptions.table_factory->NewTableReader(
         TableReaderOptions(ioptions, soptions, last_internal_key_),
         std::move(file_reader_), GetSink()->contents().size(), &table_reader_);
@@ -356,6 +356,11 @@ class TableConstructor: public Constructor {
     return table_reader_.get();
   }
 
+  // The file of the current table reader, owned by the table reader.
+  const test::StringSource* source() const {
+    return source_;
+  }
+
   bool AnywayDeleteIterator() const override {
     return convert_to_internal_key_;
   }
@@ -370,6 +375,7 @@ class TableConstructor: public Constructor {
     table_reader_.reset();
     file_writer_.reset();
     file_reader_.reset();
+    source_ = nullptr;
   }
 
   test::StringSink* GetSink() {
@@ -379,6 +385,7 @@ class TableConstructor: public Constructor {
   uint64_t uniq_id_;
   unique_ptr<WritableFileWriter> file_writer_;
   unique_ptr<RandomAccessFileReader> file_reader_;
+  test::StringSource* source_ = nullptr;
   unique_ptr<TableReader> table_reader_;
   bool convert_to_internal_key_;
 
@@ -1840,6 +1847,195 @@ TEST_F(BlockBasedTableTest, FilterBlockInBlockCache) {
   props.AssertFilterBlockStat(0, 0);
 }
 
+TEST_F(BlockBasedTableTest, PinnedTopLevelIndex) {
+  Options options;
+  options.create_if_missing = true;
+  options.statistics = CreateDBStatistics();
+
+  BlockBasedTableOptions table_options;
+  table_options.block_cache = NewLRUCache(1024 / FLAGS_cache_single_touch_ratio);
+  table_options.cache_index_and_filter_blocks = true;
+  table_options.pin_top_level_index = true;
+  table_options.index_type = IndexType::kMultiLevelBinarySearch;
+  options.table_factory.reset(new BlockBasedTableFactory(table_options));
+  std::vector<std::string> keys;
+  stl_wrappers::KVMap kvmap;
+
+  TableConstructor c(BytewiseComparator());
+  c.Add("key", "value");
+  const ImmutableCFOptions ioptions(options);
+  c.Finish(options, ioptions, table_options,
+           GetPlainInternalComparator(options.comparator), &keys, &kvmap);
+  auto* reader = dynamic_cast<BlockBasedTable*>(c.GetTableReader());
+  ASSERT_FALSE(reader->TEST_index_reader_loaded());
+
+  // The top level index is loaded into the table reader, only the data block goes through the
+  // block cache.
+  for (int i = 0; i != 2; ++i) {
+    unique_ptr<InternalIterator> iter(c.NewIterator());
+    iter->SeekToFirst();
+    ASSERT_TRUE(iter->Valid());
+  }
+  ASSERT_TRUE(reader->TEST_index_reader_loaded());
+  BlockCachePropertiesSnapshot props(options.statistics.get());
+  props.AssertEqual(0, 0, 1, 1);
+}
+
+TEST_F(BlockBasedTableTest, ScanPrefetchDataBlocks) {
+  Random rnd(test::RandomSeed());
+  Options options;
+  options.compression = kNoCompression;
+  options.statistics = CreateDBStatistics();
+
+  BlockBasedTableOptions table_options;
+  table_options.block_cache = NewLRUCache(1024 * 1024);
+  table_options.block_restart_interval = 1;
+  table_options.block_size = 1000;
+  table_options.scan_prefetch_data_blocks = 4;
+  options.table_factory.reset(new BlockBasedTableFactory(table_options));
+
+  TableConstructor c(BytewiseComparator());
+  for (int i = 0; i < 10; ++i) {
+    // Each block holds one key/value pair.
+    c.Add(RandomString(&rnd, 900), "val");
+  }
+  std::vector<std::string> keys;
+  stl_wrappers::KVMap kvmap;
+  const ImmutableCFOptions ioptions(options);
+  c.Finish(options, ioptions, table_options,
+           GetPlainInternalComparator(options.comparator), &keys, &kvmap);
+  ASSERT_EQ(10u, c.GetTableReader()->GetTableProperties()->num_data_blocks);
+
+  unique_ptr<InternalIterator> iter(c.NewIterator());
+  auto expected = kvmap.begin();
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next(), ++expected) {
+    ASSERT_NE(expected, kvmap.end());
+    ASSERT_EQ(expected->first, iter->key().ToBuffer());
+  }
+  ASSERT_OK(iter->status());
+  ASSERT_EQ(expected, kvmap.end());
+
+  // The first block is read by the seek. Moving to the second and the sixth block prefetches
+  // 4 blocks each, the last block is the only one left, so it is read as usual.
+  BlockCachePropertiesSnapshot props(options.statistics.get());
+  props.AssertEqual(0, 0, 2, 8);
+}
+
+TEST_F(BlockBasedTableTest, AutoReadahead) {
+  Random rnd(test::RandomSeed());
+  Options options;
+  options.compression = kNoCompression;
+
+  BlockBasedTableOptions table_options;
+  table_options.block_restart_interval = 1;
+  table_options.block_size = 1000;
+  table_options.max_auto_readahead_size = 32 * 1024;
+  table_options.num_sequential_reads_for_auto_readahead = 2;
+  options.table_factory.reset(new BlockBasedTableFactory(table_options));
+
+  TableConstructor c(BytewiseComparator());
+  for (int i = 0; i < 100; ++i) {
+    // Each block holds one key/value pair.
+    c.Add(RandomString(&rnd, 900), "val");
+  }
+  std::vector<std::string> keys;
+  stl_wrappers::KVMap kvmap;
+  const ImmutableCFOptions ioptions(options);
+  c.Finish(options, ioptions, table_options,
+           GetPlainInternalComparator(options.comparator), &keys, &kvmap);
+
+  unique_ptr<InternalIterator> iter(c.NewIterator());
+  size_t num_keys = 0;
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+    ++num_keys;
+  }
+  ASSERT_OK(iter->status());
+  ASSERT_EQ(kvmap.size(), num_keys);
+
+  // Readahead starts with the third block, doubles with each readahead and is capped.
+  const auto& prefetches = c.source()->prefetches();
+  ASSERT_GE(prefetches.size(), 4U);
+  ASSERT_EQ(8 * 1024U, prefetches[0].second);
+  ASSERT_EQ(16 * 1024U, prefetches[1].second);
+  for (size_t i = 2; i != prefetches.size(); ++i) {
+    ASSERT_EQ(32 * 1024U, prefetches[i].second);
+  }
+  for (size_t i = 1; i != prefetches.size(); ++i) {
+    // The next readahead starts when the scan leaves the previous window.
+    ASSERT_GT(prefetches[i].first, prefetches[i - 1].first);
+    ASSERT_GT(prefetches[i].first + 1000, prefetches[i - 1].first + prefetches[i - 1].second);
+  }
+}
+
+namespace {
+
+// Builds a table of num_entries entries, whose values share long common parts across data blocks,
+// and checks that all entries are read back. Returns the size of the table's data blocks.
+uint64_t BuildTableWithCompressionDict(
+    CompressionType compression, uint32_t max_dict_bytes, uint32_t dict_train_bytes,
+    int num_entries) {
+  Random rnd(301);
+  std::vector<std::string> templates;
+  for (int i = 0; i < 16; ++i) {
+    templates.push_back(RandomString(&rnd, 200));
+  }
+
+  Options options;
+  options.compression = compression;
+  options.compression_opts.max_dict_bytes = max_dict_bytes;
+  options.compression_opts.dict_train_bytes = dict_train_bytes;
+  BlockBasedTableOptions table_options;
+  table_options.block_size = 1024;
+  options.table_factory.reset(new BlockBasedTableFactory(table_options));
+
+  TableConstructor c(BytewiseComparator());
+  for (int i = 0; i < num_entries; ++i) {
+    char key[16];
+    snprintf(key, sizeof(key), "key%08d", i);
+    c.Add(key, templates[rnd.Uniform(static_cast<int>(templates.size()))] +
+               RandomString(&rnd, 8));
+  }
+  std::vector<std::string> keys;
+  stl_wrappers::KVMap kvmap;
+  const ImmutableCFOptions ioptions(options);
+  c.Finish(options, ioptions, table_options,
+           GetPlainInternalComparator(options.comparator), &keys, &kvmap);
+
+  unique_ptr<InternalIterator> iter(c.NewIterator());
+  auto expected = kvmap.begin();
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next(), ++expected) {
+    EXPECT_TRUE(expected != kvmap.end());
+    if (expected == kvmap.end()) {
+      break;
+    }
+    EXPECT_EQ(expected->first, iter->key().ToString());
+    EXPECT_EQ(expected->second, iter->value().ToString());
+  }
+  EXPECT_OK(iter->status());
+  EXPECT_TRUE(expected == kvmap.end());
+  return c.GetTableProperties().data_size;
+}
+
+} // namespace
+
+TEST_F(BlockBasedTableTest, CompressionDictionary) {
+  if (!Zlib_Supported()) {
+    fprintf(stderr, "skipping compression dictionary test\n");
+    return;
+  }
+  constexpr int kNumEntries = 2000;
+  const uint64_t size_without_dict = BuildTableWithCompressionDict(
+      kZlibCompression, 0 /* max_dict_bytes */, 0 /* dict_train_bytes */, kNumEntries);
+  const uint64_t size_with_dict = BuildTableWithCompressionDict(
+      kZlibCompression, 8 * 1024, 64 * 1024, kNumEntries);
+  ASSERT_LT(size_with_dict, size_without_dict);
+
+  // Files that are smaller than the dictionary training sample are written without dictionary.
+  ASSERT_EQ(
+      BuildTableWithCompressionDict(kZlibCompression, 0, 0, 100),
+      BuildTableWithCompressionDict(kZlibCompression, 8 * 1024, 64 * 1024, 100));
+}
+
 void ValidateBlockSizeDeviation(int value, int expected) {
   BlockBasedTableOptions table_options;
   table_options.block_size_deviation = value;
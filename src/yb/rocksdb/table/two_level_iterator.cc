@@ -93,6 +93,7 @@ class TwoLevelIterator : public InternalIterator {
   void SkipEmptyDataBlocksBackward();
   void SetSecondLevelIterator(InternalIterator* iter);
   void InitDataBlock();
+  void MaybePrefetch();
 
   TwoLevelIteratorState* state_;
   IteratorWrapper first_level_iter_;
@@ -102,6 +103,9 @@ class TwoLevelIterator : public InternalIterator {
   // If second_level_iter is non-nullptr, then "data_block_handle_" holds the
   // "index_value" passed to block_function_ to create the second_level_iter.
   std::string data_block_handle_;
+  // Number of upcoming first level entries, whose secondary blocks were already passed to
+  // PrefetchSecondary.
+  size_t num_prefetched_ahead_ = 0;
 };
 
 TwoLevelIterator::TwoLevelIterator(TwoLevelIteratorState* state,
@@ -117,6 +121,7 @@ void TwoLevelIterator::Seek(const Slice& target) {
     SetSecondLevelIterator(nullptr);
     return;
   }
+  num_prefetched_ahead_ = 0;
   first_level_iter_.Seek(target);
 
   InitDataBlock();
@@ -127,6 +132,7 @@ void TwoLevelIterator::Seek(const Slice& target) {
 }
 
 void TwoLevelIterator::SeekToFirst() {
+  num_prefetched_ahead_ = 0;
   first_level_iter_.SeekToFirst();
   InitDataBlock();
   if (second_level_iter_.iter() != nullptr) {
@@ -136,6 +142,7 @@ void TwoLevelIterator::SeekToFirst() {
 }
 
 void TwoLevelIterator::SeekToLast() {
+  num_prefetched_ahead_ = 0;
   first_level_iter_.SeekToLast();
   InitDataBlock();
   if (second_level_iter_.iter() != nullptr) {
@@ -152,6 +159,7 @@ void TwoLevelIterator::Next() {
 
 void TwoLevelIterator::Prev() {
   assert(Valid());
+  num_prefetched_ahead_ = 0;
   second_level_iter_.Prev();
   SkipEmptyDataBlocksBackward();
 }
@@ -167,6 +175,7 @@ void TwoLevelIterator::SkipEmptyDataBlocksForward() {
       return;
     }
     first_level_iter_.Next();
+    MaybePrefetch();
     InitDataBlock();
     if (second_level_iter_.iter() != nullptr) {
       second_level_iter_.SeekToFirst();
@@ -174,6 +183,37 @@ void TwoLevelIterator::SkipEmptyDataBlocksForward() {
   }
 }
 
+void TwoLevelIterator::MaybePrefetch() {
+  if (state_->num_secondary_to_prefetch < 2 || !first_level_iter_.Valid()) {
+    return;
+  }
+  if (num_prefetched_ahead_ > 0) {
+    --num_prefetched_ahead_;
+    return;
+  }
+
+  // Collect the handles of the upcoming secondary blocks, then return to the current entry.
+  std::string current_key = first_level_iter_.key().ToBuffer();
+  std::vector<std::string> handles;
+  handles.reserve(state_->num_secondary_to_prefetch);
+  while (first_level_iter_.Valid() && handles.size() < state_->num_secondary_to_prefetch) {
+    handles.push_back(first_level_iter_.value().ToBuffer());
+    first_level_iter_.Next();
+  }
+  if (!first_level_iter_.status().ok()) {
+    // Do not hide the error, it is reported when the scan gets to the failed entry.
+    first_level_iter_.Seek(current_key);
+    return;
+  }
+  first_level_iter_.Seek(current_key);
+  if (!first_level_iter_.Valid() || first_level_iter_.value() != handles.front()) {
+    // Seek did not return to the same entry, so do not rely on the handles.
+    return;
+  }
+  state_->PrefetchSecondary(handles);
+  num_prefetched_ahead_ = handles.size() - 1;
+}
+
 void TwoLevelIterator::SkipEmptyDataBlocksBackward() {
   while (second_level_iter_.iter() == nullptr ||
          (!second_level_iter_.Valid() &&
@@ -22,6 +22,10 @@
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 
 #pragma once
+
+#include <string>
+#include <vector>
+
 #include "yb/rocksdb/iterator.h"
 #include "yb/rocksdb/env.h"
 #include "yb/rocksdb/table/iterator_wrapper.h"
@@ -40,8 +44,17 @@ struct TwoLevelIteratorState {
   virtual InternalIterator* NewSecondaryIterator(const Slice& handle) = 0;
   virtual bool PrefixMayMatch(const Slice& internal_key) = 0;
 
+  // Called with the handles of the secondary blocks a forward scan is about to visit, so they
+  // could be read ahead of time with a single batched read.
+  virtual void PrefetchSecondary(const std::vector<std::string>& handles) {}
+
   // If call PrefixMayMatch()
   bool check_prefix_may_match;
+
+  // When a forward scan moves to a secondary block that was not passed to PrefetchSecondary yet,
+  // the iterator passes this number of handles, starting from that block, to PrefetchSecondary.
+  // Zero disables prefetching.
+  size_t num_secondary_to_prefetch = 0;
 };
 
 
@@ -89,6 +89,20 @@ class CompactionOptionsUniversal {
   // Default: false
   bool allow_trivial_move;
 
+  // If non-zero, the column family is considered read-hot when the reads served since the
+  // previous compaction pick consulted at least this many SST files on average. When there are
+  // at least level0_file_num_compaction_trigger sorted runs but none of them can be compacted
+  // according to the size ratio, a read-hot column family is compacted by the number of sorted
+  // runs alone, in order to reduce its read amplification.
+  // Default: 0 (disabled)
+  unsigned int read_amp_compaction_trigger;
+
+  // The minimal number of reads since the previous compaction pick for the observed read
+  // amplification to be taken into account. Keeps rarely read column families from being
+  // considered read-hot.
+  // Default: 1000
+  uint64_t read_amp_compaction_min_reads;
+
   // Default set of parameters
   CompactionOptionsUniversal()
       : size_ratio(1),
@@ -97,7 +111,9 @@ class CompactionOptionsUniversal {
         max_size_amplification_percent(200),
         compression_size_percent(-1),
         stop_style(kCompactionStopStyleTotalSize),
-        allow_trivial_move(false) {}
+        allow_trivial_move(false),
+        read_amp_compaction_trigger(0),
+        read_amp_compaction_min_reads(1000) {}
 };
 
 }  // namespace rocksdb
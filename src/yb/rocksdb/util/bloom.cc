@@ -23,6 +23,10 @@
 
 #include <cstdlib>
 
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
 #include "yb/rocksdb/filter_policy.h"
 
 #include "yb/rocksdb/table/block_based_filter_block.h"
@@ -30,6 +34,7 @@
 #include "yb/rocksdb/table/fixed_size_filter_block.h"
 #include "yb/rocksdb/util/hash.h"
 #include "yb/rocksdb/util/coding.h"
+#include "yb/gutil/hash/city.h"
 #include "yb/util/slice.h"
 #include "yb/util/math_util.h"
 
@@ -490,12 +495,165 @@ class FixedSizeFilterBitsReader : public FullFilterBitsReader {
       : FullFilterBitsReader(contents, logger) {}
 };
 
+// The fast local format of fixed size filters.
+//
+// Like the default format, all probes of a key are in one cache line, but:
+// - The line is picked by multiplying the upper half of a 64-bit hash of the key, and the probed
+//   bits of the line by multiplying its lower half, instead of by a division per probe.
+// - The probed bits are tested at once, by building the mask of the line and comparing it with the
+//   line, with AVX2 when available.
+//
+// The encoding is the same as the one of the default format, except that lines are always 64 bytes
+// and kFastLocalFormatFlag is set in the number of lines. So readers of the default format consider
+// these filters invalid and let all keys through, instead of filtering them incorrectly.
+constexpr uint32_t kFastLocalFormatFlag = 0x80000000;
+constexpr uint32_t kFastLocalLineSize = 64;
+constexpr uint32_t kFastLocalLineWords = kFastLocalLineSize / sizeof(uint64_t);
+
+inline uint64_t FastLocalHash(const Slice& key) {
+  return util_hash::CityHash64(key.cdata(), key.size());
+}
+
+inline uint32_t FastLocalLine(uint64_t hash, uint32_t num_lines) {
+  return static_cast<uint32_t>(((hash >> 32) * num_lines) >> 32);
+}
+
+// Fills 'mask' with the bits of the line probed for the given hash.
+inline void FastLocalMask(uint64_t hash, size_t num_probes, uint64_t* mask) {
+  memset(mask, 0, kFastLocalLineSize);
+  uint32_t h = static_cast<uint32_t>(hash);
+  for (size_t i = 0; i < num_probes; ++i) {
+    h *= 0x9e3779b9;
+    const uint32_t bitpos = h >> 23;  // The top 9 bits address the 512 bits of the line.
+    mask[bitpos / 64] |= 1ULL << (bitpos % 64);
+  }
+}
+
+inline bool FastLocalLineMatches(const char* line, const uint64_t* mask) {
+#ifdef __AVX2__
+  const __m256i* line_vec = reinterpret_cast<const __m256i*>(line);
+  const __m256i* mask_vec = reinterpret_cast<const __m256i*>(mask);
+  return _mm256_testc_si256(_mm256_loadu_si256(line_vec), _mm256_loadu_si256(mask_vec)) &&
+         _mm256_testc_si256(_mm256_loadu_si256(line_vec + 1), _mm256_loadu_si256(mask_vec + 1));
+#else
+  // Without branches, so that the compiler could vectorize it.
+  uint64_t missing = 0;
+  for (uint32_t i = 0; i < kFastLocalLineWords; ++i) {
+    uint64_t word;
+    memcpy(&word, line + i * sizeof(word), sizeof(word));
+    missing |= mask[i] & ~word;
+  }
+  return missing == 0;
+#endif
+}
+
+class FastLocalFilterBitsBuilder : public FilterBitsBuilder {
+ public:
+  FastLocalFilterBitsBuilder(const FastLocalFilterBitsBuilder&) = delete;
+  void operator=(const FastLocalFilterBitsBuilder&) = delete;
+
+  FastLocalFilterBitsBuilder(uint32_t total_bits, double error_rate) {
+    DCHECK_GT(error_rate, 0);
+    DCHECK_GT(total_bits, 0);
+    // Lines are picked without a division, so there is no need for an odd number of them.
+    num_lines_ = yb::ceil_div<uint32_t>(total_bits, kFastLocalLineSize * 8);
+    const uint32_t lines_bits = num_lines_ * kFastLocalLineSize * 8;
+
+    const double minus_log_error_rate = -log(error_rate);
+    DCHECK_GT(minus_log_error_rate, 0);
+    num_probes_ = static_cast<size_t>(minus_log_error_rate / LOG2);
+    num_probes_ = std::max<size_t>(num_probes_, 1);
+    num_probes_ = std::min<size_t>(num_probes_, 255);
+    max_keys_ = static_cast<size_t>(lines_bits * LOG2 * LOG2 / minus_log_error_rate);
+
+    data_.reset(new uint64_t[FilterWords()]);
+    memset(data_.get(), 0, FilterWords() * sizeof(uint64_t));
+  }
+
+  void AddKey(const Slice& key) override {
+    ++keys_added_;
+    const uint64_t hash = FastLocalHash(key);
+    uint64_t mask[kFastLocalLineWords];
+    FastLocalMask(hash, num_probes_, mask);
+    uint64_t* line = data_.get() + FastLocalLine(hash, num_lines_) * kFastLocalLineWords;
+    // Words are written in the native byte order, which is little endian on supported platforms.
+    for (uint32_t i = 0; i < kFastLocalLineWords; ++i) {
+      line[i] |= mask[i];
+    }
+  }
+
+  bool IsFull() const override { return keys_added_ >= max_keys_; }
+
+  Slice Finish(std::unique_ptr<const char[]>* buf) override {
+    const size_t lines_size = num_lines_ * kFastLocalLineSize;
+    const size_t filter_size = lines_size + kMetaDataSize;
+    std::unique_ptr<char[]> result(new char[filter_size]);
+    memcpy(result.get(), data_.get(), lines_size);
+    result[lines_size] = static_cast<char>(num_probes_);
+    EncodeFixed32(result.get() + lines_size + 1, num_lines_ | kFastLocalFormatFlag);
+    buf->reset(result.release());
+    return Slice(buf->get(), filter_size);
+  }
+
+  static constexpr size_t kMetaDataSize = FullFilterBitsBuilder::kMetaDataSize;
+
+ private:
+  size_t FilterWords() const { return num_lines_ * kFastLocalLineWords; }
+
+  std::unique_ptr<uint64_t[]> data_;
+  size_t max_keys_;
+  size_t keys_added_ = 0;
+  uint32_t num_lines_;
+  size_t num_probes_;
+};
+
+class FastLocalFilterBitsReader : public FilterBitsReader {
+ public:
+  FastLocalFilterBitsReader(const FastLocalFilterBitsReader&) = delete;
+  void operator=(const FastLocalFilterBitsReader&) = delete;
+
+  explicit FastLocalFilterBitsReader(const Slice& contents) : data_(contents.cdata()) {
+    const size_t len = contents.size();
+    num_probes_ = static_cast<uint8_t>(data_[len - kMetaDataSize]);
+    num_lines_ = DecodeFixed32(data_ + len - 4) & ~kFastLocalFormatFlag;
+    if (num_lines_ * kFastLocalLineSize + kMetaDataSize != len || num_probes_ == 0) {
+      // Corrupted filter, let all keys through.
+      num_lines_ = 0;
+    }
+  }
+
+  bool MayMatch(const Slice& entry) override {
+    if (num_lines_ == 0) {
+      return true;
+    }
+    const uint64_t hash = FastLocalHash(entry);
+    uint64_t mask[kFastLocalLineWords];
+    FastLocalMask(hash, num_probes_, mask);
+    return FastLocalLineMatches(data_ + FastLocalLine(hash, num_lines_) * kFastLocalLineSize, mask);
+  }
+
+  // Returns whether the filter is encoded in the fast local format.
+  static bool IsFastLocal(const Slice& contents) {
+    return contents.size() > kMetaDataSize &&
+           (DecodeFixed32(contents.cdata() + contents.size() - 4) & kFastLocalFormatFlag) != 0;
+  }
+
+ private:
+  static constexpr size_t kMetaDataSize = FullFilterBitsBuilder::kMetaDataSize;
+
+  const char* const data_;
+  size_t num_probes_;
+  uint32_t num_lines_;
+};
+
 class FixedSizeFilterPolicy : public FilterPolicy {
  public:
-  explicit FixedSizeFilterPolicy(uint32_t total_bits, double error_rate, Logger* logger)
+  FixedSizeFilterPolicy(
+      uint32_t total_bits, double error_rate, Logger* logger, FixedSizeFilterFormat format)
       : total_bits_(total_bits),
         error_rate_(error_rate),
-        logger_(logger) {
+        logger_(logger),
+        format_(format) {
     DCHECK_GT(error_rate, 0);
     // Make sure num_probes > 0.
     DCHECK_GT(static_cast<int64_t> (-log(error_rate) / LOG2), 0);
@@ -519,10 +677,18 @@ class FixedSizeFilterPolicy : public FilterPolicy {
   }
 
   virtual FilterBitsBuilder* GetFilterBitsBuilder() const override {
+    if (format_ == FixedSizeFilterFormat::kFastLocal) {
+      return new FastLocalFilterBitsBuilder(total_bits_, error_rate_);
+    }
     return new FixedSizeFilterBitsBuilder(total_bits_, error_rate_);
   }
 
+  // Filters of both formats could be read whatever the format of the policy is, so that the format
+  // of a table could be changed while its SST files written in the previous format are still used.
   virtual FilterBitsReader* GetFilterBitsReader(const Slice& contents) const override {
+    if (FastLocalFilterBitsReader::IsFastLocal(contents)) {
+      return new FastLocalFilterBitsReader(contents);
+    }
     return new FixedSizeFilterBitsReader(contents, logger_);
   }
 
@@ -532,6 +698,7 @@ class FixedSizeFilterPolicy : public FilterPolicy {
   uint32_t total_bits_;
   double error_rate_;
   Logger* logger_;
+  const FixedSizeFilterFormat format_;
 };
 
 }  // namespace
@@ -544,8 +711,9 @@ const FilterPolicy* NewBloomFilterPolicy(int bits_per_key,
 
 const FilterPolicy* NewFixedSizeFilterPolicy(uint32_t total_bits,
                                              double error_rate,
-                                             Logger* logger) {
-  return new FixedSizeFilterPolicy(total_bits, error_rate, logger);
+                                             Logger* logger,
+                                             FixedSizeFilterFormat format) {
+  return new FixedSizeFilterPolicy(total_bits, error_rate, logger, format);
 }
 
 }  // namespace rocksdb
@@ -217,6 +217,12 @@ class FullFilterBloomTestContext : public BloomTestContext {
 
 class FixedSizeFilterBloomTestContext : public BloomTestContext {
  public:
+  explicit FixedSizeFilterBloomTestContext(
+      FixedSizeFilterFormat format = FixedSizeFilterFormat::kDefault)
+      : filter_policy_(NewFixedSizeFilterPolicy(
+            FilterPolicy::kDefaultFixedSizeFilterBits,
+            FilterPolicy::kDefaultFixedSizeFilterErrorRate, nullptr, format)) {}
+
   const FilterPolicy& filter_policy() const override { return *filter_policy_.get(); }
 
   // For fixed-size filter we limit maximum number of keys depending on total bits in test itself
@@ -228,13 +234,11 @@ class FixedSizeFilterBloomTestContext : public BloomTestContext {
   }
 
  private:
-  std::unique_ptr<const FilterPolicy> filter_policy_{
-      NewFixedSizeFilterPolicy(
-          FilterPolicy::kDefaultFixedSizeFilterBits, FilterPolicy::kDefaultFixedSizeFilterErrorRate,
-          nullptr)};
+  std::unique_ptr<const FilterPolicy> filter_policy_;
 };
 
-YB_DEFINE_ENUM(BuilderReaderBloomTestType, (kFullFilter)(kFixedSizeFilter));
+YB_DEFINE_ENUM(BuilderReaderBloomTestType,
+               (kFullFilter)(kFixedSizeFilter)(kFastLocalFixedSizeFilter));
 
 namespace {
 
@@ -244,6 +248,8 @@ std::unique_ptr<const BloomTestContext> CreateContext(BuilderReaderBloomTestType
       return std::make_unique<FullFilterBloomTestContext>();
     case BuilderReaderBloomTestType::kFixedSizeFilter:
       return std::make_unique<FixedSizeFilterBloomTestContext>();
+    case BuilderReaderBloomTestType::kFastLocalFixedSizeFilter:
+      return std::make_unique<FixedSizeFilterBloomTestContext>(FixedSizeFilterFormat::kFastLocal);
   }
   FATAL_INVALID_ENUM_VALUE(BuilderReaderBloomTestType, type);
 }
@@ -372,7 +378,39 @@ TEST_P(BuilderReaderBloomTest, FullVaryingLengths) {
 
 INSTANTIATE_TEST_CASE_P(, BuilderReaderBloomTest, ::testing::Values(
     BuilderReaderBloomTestType::kFullFilter,
-    BuilderReaderBloomTestType::kFixedSizeFilter));
+    BuilderReaderBloomTestType::kFixedSizeFilter,
+    BuilderReaderBloomTestType::kFastLocalFixedSizeFilter));
+
+// Filters of both formats are read by fixed size filter policies of either format.
+TEST(FixedSizeFilterFormatTest, ReadBothFormats) {
+  std::unique_ptr<const FilterPolicy> policies[] = {
+      std::unique_ptr<const FilterPolicy>(NewFixedSizeFilterPolicy(
+          FilterPolicy::kDefaultFixedSizeFilterBits,
+          FilterPolicy::kDefaultFixedSizeFilterErrorRate, nullptr,
+          FixedSizeFilterFormat::kDefault)),
+      std::unique_ptr<const FilterPolicy>(NewFixedSizeFilterPolicy(
+          FilterPolicy::kDefaultFixedSizeFilterBits,
+          FilterPolicy::kDefaultFixedSizeFilterErrorRate, nullptr,
+          FixedSizeFilterFormat::kFastLocal))};
+  char buffer[sizeof(size_t)];
+  for (const auto& writer : policies) {
+    std::unique_ptr<FilterBitsBuilder> builder(writer->GetFilterBitsBuilder());
+    for (size_t i = 0; i != 1000; ++i) {
+      builder->AddKey(Key(i, buffer));
+    }
+    std::unique_ptr<const char[]> buf;
+    Slice filter = builder->Finish(&buf);
+    for (const auto& reader_policy : policies) {
+      std::unique_ptr<FilterBitsReader> reader(reader_policy->GetFilterBitsReader(filter));
+      size_t false_positives = 0;
+      for (size_t i = 0; i != 1000; ++i) {
+        ASSERT_TRUE(reader->MayMatch(Key(i, buffer))) << i;
+        false_positives += reader->MayMatch(Key(i + 1000000000, buffer));
+      }
+      ASSERT_LE(false_positives, 20);
+    }
+  }
+}
 
 }  // namespace rocksdb
 
@@ -24,6 +24,7 @@
 #include <assert.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <array>
 #include <gflags/gflags.h>
 
 #include "yb/util/metrics.h"
@@ -47,6 +48,9 @@ Cache::~Cache() {
 
 namespace {
 
+// Passed to LRUCache::EvictFromLRU to evict entries regardless of their priority class.
+constexpr CachePriorityClass kEvictAnyPriorityClass = kNumCachePriorityClasses;
+
 // LRU cache implementation
 
 // An entry is a variable length heap-allocated structure.
@@ -92,6 +96,7 @@ struct LRUHandle {
   bool in_cache;      // true, if this entry is referenced by the hash table
   uint32_t hash;      // Hash of key(); used for fast sharding and comparisons
   QueryId query_id;  // Query id that added the value to the cache.
+  CachePriorityClass priority_class;
   char key_data[1];   // Beginning of key
 
   Slice key() const {
@@ -114,6 +119,7 @@ struct LRUHandle {
         metrics->single_touch_cache_usage->DecrementBy(charge);
       }
       metrics->cache_usage->DecrementBy(charge);
+      metrics->priority_classes[priority_class].cache_usage->DecrementBy(charge);
     }
     delete[] reinterpret_cast<char*>(this);
   }
@@ -372,12 +378,15 @@ class LRUCache {
   // Set the flag to reject insertion if cache if full.
   void SetStrictCapacityLimit(bool strict_capacity_limit);
 
+  void SetPriorityClassReservedCapacity(CachePriorityClass priority_class, size_t capacity);
+
   // Like Cache methods, but with an extra "hash" parameter.
   Status Insert(const Slice& key, uint32_t hash, const QueryId query_id,
                 void* value, size_t charge, void (*deleter)(const Slice& key, void* value),
-                Cache::Handle** handle, Statistics* statistics);
+                Cache::Handle** handle, Statistics* statistics,
+                CachePriorityClass priority_class);
   Cache::Handle* Lookup(const Slice& key, uint32_t hash, const QueryId query_id,
-                        Statistics* statistics = nullptr);
+                        Statistics* statistics, CachePriorityClass priority_class);
   void Release(Cache::Handle* handle);
   void Erase(const Slice& key, uint32_t hash);
 
@@ -413,12 +422,26 @@ class LRUCache {
 
   // Free some space following strict LRU policy until enough space
   // to hold (usage_ + charge) is freed or the lru list is empty
+  // Entries that CanEvict() rejects for priority_class are skipped.
   // This function is not thread safe - it needs to be executed while
   // holding the mutex_
-  void EvictFromLRU(size_t charge, autovector<LRUHandle*>* deleted, SubCacheType subcache_type);
+  void EvictFromLRU(size_t charge, autovector<LRUHandle*>* deleted, SubCacheType subcache_type,
+                    CachePriorityClass priority_class);
+
+  // Whether e could be evicted to make room for an entry of priority_class. Entries of a class
+  // that does not use more than its reserved capacity are only evicted for entries of the same
+  // class. priority_class is kEvictAnyPriorityClass when shrinking the cache.
+  bool CanEvict(const LRUHandle* e, CachePriorityClass priority_class) const {
+    return priority_class == kEvictAnyPriorityClass || e->priority_class == priority_class ||
+           priority_class_usage_[e->priority_class] >
+               priority_class_reserved_capacity_[e->priority_class];
+  }
+
+  // Increments the usage of e on the appropriate subcache and priority class.
+  void IncrementUsage(LRUSubCache* sub_cache, const LRUHandle* e);
 
-  // Decrements the usage on the appropriate subcache.
-  void DecrementUsage(const SubCacheType subcache_type, const size_t charge);
+  // Decrements the usage of e on the appropriate subcache and priority class.
+  void DecrementUsage(const LRUHandle* e);
 
   // Whether to reject insertion if cache reaches its full capacity.
   bool strict_capacity_limit_;
@@ -430,6 +453,10 @@ class LRUCache {
 
   HandleTable table_;
 
+  // Memory size of the entries of each priority class, over both subcaches.
+  std::array<size_t, kNumCachePriorityClasses> priority_class_usage_ = {};
+  std::array<size_t, kNumCachePriorityClasses> priority_class_reserved_capacity_ = {};
+
   shared_ptr<yb::CacheMetrics> metrics_;
 };
 
@@ -453,8 +480,15 @@ LRUSubCache* LRUCache::GetSubCache(const SubCacheType subcache_type) {
                                                         &single_touch_sub_cache_;
 }
 
-void LRUCache::DecrementUsage(const SubCacheType subcache_type, const size_t charge) {
-  GetSubCache(subcache_type)->DecrementUsage(charge);
+void LRUCache::IncrementUsage(LRUSubCache* sub_cache, const LRUHandle* e) {
+  sub_cache->IncrementUsage(e->charge);
+  priority_class_usage_[e->priority_class] += e->charge;
+}
+
+void LRUCache::DecrementUsage(const LRUHandle* e) {
+  GetSubCache(e->GetSubCacheType())->DecrementUsage(e->charge);
+  assert(priority_class_usage_[e->priority_class] >= e->charge);
+  priority_class_usage_[e->priority_class] -= e->charge;
 }
 
 // Call deleter and free
@@ -483,18 +517,23 @@ void LRUCache::LRU_Append(LRUHandle* e) {
 
 
 void LRUCache::EvictFromLRU(size_t charge, autovector<LRUHandle*>* deleted,
-                            SubCacheType subcache_type) {
+                            SubCacheType subcache_type, CachePriorityClass priority_class) {
   LRUSubCache* sub_cache = GetSubCache(subcache_type);
-  while (sub_cache->Usage() + charge > sub_cache->Capacity() && !sub_cache->IsLRUEmpty()) {
-    LRUHandle* old = sub_cache->LRU_Head().next;
-    assert(old->in_cache);
-    assert(old->refs == 1);  // LRU list contains elements which may be evicted
-    sub_cache->LRU_Remove(old);
-    table_.Remove(old->key(), old->hash);
-    old->in_cache = false;
-    Unref(old);
-    sub_cache->DecrementUsage(old->charge);
-    deleted->push_back(old);
+  LRUHandle* const head = &sub_cache->LRU_Head();
+  LRUHandle* old = head->next;
+  while (sub_cache->Usage() + charge > sub_cache->Capacity() && old != head) {
+    LRUHandle* next = old->next;
+    if (CanEvict(old, priority_class)) {
+      assert(old->in_cache);
+      assert(old->refs == 1);  // LRU list contains elements which may be evicted
+      sub_cache->LRU_Remove(old);
+      table_.Remove(old->key(), old->hash);
+      old->in_cache = false;
+      Unref(old);
+      DecrementUsage(old);
+      deleted->push_back(old);
+    }
+    old = next;
   }
 }
 
@@ -505,8 +544,8 @@ void LRUCache::SetCapacity(size_t capacity) {
     single_touch_sub_cache_.SetCapacity(
       static_cast<size_t>(round(FLAGS_cache_single_touch_ratio * capacity)));
     multi_touch_sub_cache_.SetCapacity(capacity - single_touch_sub_cache_.Capacity());
-    EvictFromLRU(0, &last_reference_list, SINGLE_TOUCH);
-    EvictFromLRU(0, &last_reference_list, MULTI_TOUCH);
+    EvictFromLRU(0, &last_reference_list, SINGLE_TOUCH, kEvictAnyPriorityClass);
+    EvictFromLRU(0, &last_reference_list, MULTI_TOUCH, kEvictAnyPriorityClass);
   }
   // we free the entries here outside of mutex for
   // performance reasons
@@ -520,8 +559,14 @@ void LRUCache::SetStrictCapacityLimit(bool strict_capacity_limit) {
   strict_capacity_limit_ = strict_capacity_limit;
 }
 
+void LRUCache::SetPriorityClassReservedCapacity(CachePriorityClass priority_class,
+                                                size_t capacity) {
+  MutexLock l(&mutex_);
+  priority_class_reserved_capacity_[priority_class] = capacity;
+}
+
 Cache::Handle* LRUCache::Lookup(const Slice& key, uint32_t hash, const QueryId query_id,
-                                Statistics* statistics)  {
+                                Statistics* statistics, CachePriorityClass priority_class)  {
   MutexLock l(&mutex_);
   LRUHandle* e = table_.Lookup(key, hash);
   if (e != nullptr) {
@@ -537,7 +582,7 @@ Cache::Handle* LRUCache::Lookup(const Slice& key, uint32_t hash, const QueryId q
     if (FLAGS_cache_single_touch_ratio < 1 && e->GetSubCacheType() != MULTI_TOUCH &&
         e->query_id != query_id) {
       autovector<LRUHandle*> multi_touch_eviction_list;
-      EvictFromLRU(e->charge, &multi_touch_eviction_list, MULTI_TOUCH);
+      EvictFromLRU(e->charge, &multi_touch_eviction_list, MULTI_TOUCH, e->priority_class);
       for (auto entry : multi_touch_eviction_list) {
         entry->Free(metrics_.get());
       }
@@ -577,10 +622,13 @@ Cache::Handle* LRUCache::Lookup(const Slice& key, uint32_t hash, const QueryId q
   if (metrics_ != nullptr) {
     metrics_->lookups->Increment();
     bool was_hit = (e != nullptr);
+    auto& priority_class_metrics = metrics_->priority_classes[priority_class];
     if (was_hit) {
       metrics_->cache_hits->Increment();
+      priority_class_metrics.cache_hits->Increment();
     } else {
       metrics_->cache_misses->Increment();
+      priority_class_metrics.cache_misses->Increment();
     }
   }
   return reinterpret_cast<Cache::Handle*>(e);
@@ -597,7 +645,7 @@ void LRUCache::Release(Cache::Handle* handle) {
     LRUSubCache* sub_cache = GetSubCache(e->GetSubCacheType());
     last_reference = Unref(e);
     if (last_reference) {
-      sub_cache->DecrementUsage(e->charge);
+      DecrementUsage(e);
     }
     if (e->refs == 1 && e->in_cache) {
       // The item is still in cache, and nobody else holds a reference to it
@@ -608,7 +656,7 @@ void LRUCache::Release(Cache::Handle* handle) {
         table_.Remove(e->key(), e->hash);
         e->in_cache = false;
         Unref(e);
-        sub_cache->DecrementUsage(e->charge);
+        DecrementUsage(e);
         last_reference = true;
       } else {
         // put the item on the list to be potentially freed.
@@ -625,7 +673,8 @@ void LRUCache::Release(Cache::Handle* handle) {
 
 Status LRUCache::Insert(const Slice& key, uint32_t hash, const QueryId query_id,
                         void* value, size_t charge, void (*deleter)(const Slice& key, void* value),
-                        Cache::Handle** handle, Statistics* statistics) {
+                        Cache::Handle** handle, Statistics* statistics,
+                        CachePriorityClass priority_class) {
   // Don't use the cache if disabled by the caller using the special query id.
   if (query_id == kNoCacheQueryId) {
     return Status::OK();
@@ -650,6 +699,7 @@ Status LRUCache::Insert(const Slice& key, uint32_t hash, const QueryId query_id,
   e->in_cache = true;
   // Adding query id to the handle.
   e->query_id = query_id;
+  e->priority_class = priority_class;
   memcpy(e->key_data, key.data(), key.size());
 
   {
@@ -667,7 +717,7 @@ Status LRUCache::Insert(const Slice& key, uint32_t hash, const QueryId query_id,
     } else {
       subcache_type = table_.GetSubCacheTypeCandidate(e);
     }
-    EvictFromLRU(charge, &last_reference_list, subcache_type);
+    EvictFromLRU(charge, &last_reference_list, subcache_type, priority_class);
     LRUSubCache* sub_cache = GetSubCache(subcache_type);
     // If the cache no longer has any more space in the given pool.
     if (strict_capacity_limit_ &&
@@ -684,11 +734,11 @@ Status LRUCache::Insert(const Slice& key, uint32_t hash, const QueryId query_id,
       // note that the cache might get larger than its capacity if not enough
       // space was freed
       LRUHandle* old = table_.Insert(e);
-      sub_cache->IncrementUsage(e->charge);
+      IncrementUsage(sub_cache, e);
       if (old != nullptr) {
         old->in_cache = false;
         if (Unref(old)) {
-          DecrementUsage(old->GetSubCacheType(), old->charge);
+          DecrementUsage(old);
           // old is on LRU because it's in cache and its reference count
           // was just 1 (Unref returned 0)
           LRU_Remove(old);
@@ -725,6 +775,7 @@ Status LRUCache::Insert(const Slice& key, uint32_t hash, const QueryId query_id,
         metrics_->single_touch_cache_usage->IncrementBy(charge);
       }
       metrics_->cache_usage->IncrementBy(charge);
+      metrics_->priority_classes[priority_class].cache_usage->IncrementBy(charge);
     }
   }
 
@@ -747,7 +798,7 @@ void LRUCache::Erase(const Slice& key, uint32_t hash) {
     if (e != nullptr) {
       last_reference = Unref(e);
       if (last_reference) {
-        DecrementUsage(e->GetSubCacheType(), e->charge);
+        DecrementUsage(e);
       }
       if (last_reference && e->in_cache) {
         LRU_Remove(e);
@@ -826,26 +877,40 @@ class ShardedLRUCache : public Cache {
     }
     strict_capacity_limit_ = strict_capacity_limit;
   }
+
+  void SetPriorityClassReservedCapacity(CachePriorityClass priority_class,
+                                        size_t capacity) override {
+    DCHECK_LT(priority_class, kNumCachePriorityClasses);
+    int num_shards = 1 << num_shard_bits_;
+    const size_t per_shard = (capacity + (num_shards - 1)) / num_shards;
+    for (int s = 0; s < num_shards; s++) {
+      shards_[s].SetPriorityClassReservedCapacity(priority_class, per_shard);
+    }
+  }
   virtual Status Insert(const Slice& key, const QueryId query_id, void* value, size_t charge,
                         void (*deleter)(const Slice& key, void* value),
-                        Handle** handle, Statistics* statistics) override {
+                        Handle** handle, Statistics* statistics,
+                        CachePriorityClass priority_class) override {
     DCHECK(IsValidQueryId(query_id));
+    DCHECK_LT(priority_class, kNumCachePriorityClasses);
     // Queries with no cache query ids are not cached.
     if (query_id == kNoCacheQueryId) {
       return Status::OK();
     }
     const uint32_t hash = HashSlice(key);
     return shards_[Shard(hash)].Insert(key, hash, query_id, value, charge, deleter,
-                                       handle, statistics);
+                                       handle, statistics, priority_class);
   }
 
-  Handle* Lookup(const Slice& key, const QueryId query_id, Statistics* statistics) override {
+  Handle* Lookup(const Slice& key, const QueryId query_id, Statistics* statistics,
+                 CachePriorityClass priority_class) override {
     DCHECK(IsValidQueryId(query_id));
+    DCHECK_LT(priority_class, kNumCachePriorityClasses);
     if (query_id == kNoCacheQueryId) {
       return nullptr;
     }
     const uint32_t hash = HashSlice(key);
-    return shards_[Shard(hash)].Lookup(key, hash, query_id, statistics);
+    return shards_[Shard(hash)].Lookup(key, hash, query_id, statistics, priority_class);
   }
 
   void Release(Handle* handle) override {
@@ -923,8 +988,81 @@ class ShardedLRUCache : public Cache {
   }
 };
 
+class PriorityClassCache : public Cache {
+ public:
+  PriorityClassCache(shared_ptr<Cache> cache, CachePriorityClass priority_class)
+      : cache_(std::move(cache)), priority_class_(priority_class) {}
+
+  Status Insert(const Slice& key, const QueryId query_id, void* value, size_t charge,
+                void (*deleter)(const Slice& key, void* value),
+                Handle** handle, Statistics* statistics,
+                CachePriorityClass priority_class) override {
+    return cache_->Insert(key, query_id, value, charge, deleter, handle, statistics,
+                          priority_class_);
+  }
+
+  Handle* Lookup(const Slice& key, const QueryId query_id, Statistics* statistics,
+                 CachePriorityClass priority_class) override {
+    return cache_->Lookup(key, query_id, statistics, priority_class_);
+  }
+
+  void Release(Handle* handle) override { cache_->Release(handle); }
+
+  void* Value(Handle* handle) override { return cache_->Value(handle); }
+
+  void Erase(const Slice& key) override { cache_->Erase(key); }
+
+  uint64_t NewId() override { return cache_->NewId(); }
+
+  void SetCapacity(size_t capacity) override { cache_->SetCapacity(capacity); }
+
+  void SetStrictCapacityLimit(bool strict_capacity_limit) override {
+    cache_->SetStrictCapacityLimit(strict_capacity_limit);
+  }
+
+  bool HasStrictCapacityLimit() const override { return cache_->HasStrictCapacityLimit(); }
+
+  size_t GetCapacity() const override { return cache_->GetCapacity(); }
+
+  void SetPriorityClassReservedCapacity(CachePriorityClass priority_class,
+                                        size_t capacity) override {
+    cache_->SetPriorityClassReservedCapacity(priority_class, capacity);
+  }
+
+  size_t GetUsage() const override { return cache_->GetUsage(); }
+
+  size_t GetUsage(Handle* handle) const override { return cache_->GetUsage(handle); }
+
+  size_t GetPinnedUsage() const override { return cache_->GetPinnedUsage(); }
+
+  SubCacheType GetSubCacheType(Handle* e) const override { return cache_->GetSubCacheType(e); }
+
+  void DisownData() override { cache_->DisownData(); }
+
+  void ApplyToAllCacheEntries(void (*callback)(void*, size_t), bool thread_safe) override {
+    cache_->ApplyToAllCacheEntries(callback, thread_safe);
+  }
+
+  void SetMetrics(const scoped_refptr<yb::MetricEntity>& entity) override {
+    cache_->SetMetrics(entity);
+  }
+
+ private:
+  const shared_ptr<Cache> cache_;
+  const CachePriorityClass priority_class_;
+};
+
 }  // end anonymous namespace
 
+shared_ptr<Cache> NewPriorityClassCache(shared_ptr<Cache> cache,
+                                        CachePriorityClass priority_class) {
+  DCHECK_LT(priority_class, kNumCachePriorityClasses);
+  if (!cache || priority_class == kDefaultCachePriorityClass) {
+    return cache;
+  }
+  return std::make_shared<PriorityClassCache>(std::move(cache), priority_class);
+}
+
 shared_ptr<Cache> NewLRUCache(size_t capacity) {
   return NewLRUCache(capacity, kNumShardBits, false);
 }
@@ -23,12 +23,17 @@
 
 #include "yb/rocksdb/cache.h"
 
+#include <math.h>
+
+#include <atomic>
 #include <forward_list>
+#include <thread>
 #include <vector>
 #include <string>
 #include <iostream>
 #include <gflags/gflags.h>
 #include "yb/rocksdb/util/coding.h"
+#include "yb/rocksdb/util/random.h"
 #include "yb/util/string_util.h"
 #include "yb/rocksdb/util/testharness.h"
 
@@ -318,6 +323,48 @@ TEST_F(CacheTest, EvictionPolicy) {
   ASSERT_EQ(-1, Lookup(200));
 }
 
+TEST_F(CacheTest, PriorityClassReservedCapacity) {
+  constexpr int kCapacity = 100;
+  constexpr int kReserved = 10;
+  const size_t single_touch_capacity =
+      static_cast<size_t>(round(FLAGS_cache_single_touch_ratio * kCapacity));
+  shared_ptr<Cache> cache = NewLRUCache(kCapacity, 0);
+  cache->SetPriorityClassReservedCapacity(1, kReserved);
+  shared_ptr<Cache> reserved_cache = NewPriorityClassCache(cache, 1);
+  ASSERT_EQ(cache, NewPriorityClassCache(cache, kDefaultCachePriorityClass));
+
+  for (int i = 0; i < kReserved; i++) {
+    ASSERT_OK(Insert(reserved_cache, i, 100 + i));
+  }
+  // Entries of the default class only evict each other while the reserved class stays within its
+  // reservation.
+  for (int i = 0; i < kCacheSize; i++) {
+    ASSERT_OK(Insert(cache, 1000 + i, 2000 + i));
+  }
+  for (int i = 0; i < kReserved; i++) {
+    ASSERT_EQ(100 + i, Lookup(reserved_cache, i));
+  }
+  ASSERT_EQ(-1, Lookup(cache, 1000));
+  ASSERT_EQ(single_touch_capacity, cache->GetUsage());
+
+  // The reserved class could grow beyond its reservation by evicting entries of other classes.
+  ASSERT_OK(Insert(reserved_cache, kReserved, 100 + kReserved));
+  ASSERT_EQ(-1, Lookup(cache, 1000 + kCacheSize - kReserved));
+
+  // Entries above the reservation are evicted on behalf of other classes, least recently used
+  // first.
+  cache->SetPriorityClassReservedCapacity(1, kReserved / 2);
+  for (int i = 0; i < kCacheSize; i++) {
+    ASSERT_OK(Insert(cache, 3000 + i, 4000 + i));
+  }
+  for (int i = 0; i <= kReserved / 2; i++) {
+    ASSERT_EQ(-1, Lookup(reserved_cache, i));
+  }
+  for (int i = kReserved / 2 + 1; i <= kReserved; i++) {
+    ASSERT_EQ(100 + i, Lookup(reserved_cache, i));
+  }
+}
+
 TEST_F(CacheTest, EvictionPolicyRef) {
   Insert(100, 101);
   Insert(101, 102);
@@ -675,6 +722,141 @@ TEST_F(CacheTest, ApplyToAllCacheEntiresTest) {
   ASSERT_TRUE(inserted == callback_state);
 }
 
+TEST_F(CacheTest, ClockCacheHitAndMiss) {
+  auto cache = NewClockCache(kCacheSize, 0, false, 1);
+  ASSERT_EQ(-1, Lookup(cache, 100));
+
+  ASSERT_OK(Insert(cache, 100, 101));
+  ASSERT_OK(Insert(cache, 200, 201));
+  ASSERT_EQ(101, Lookup(cache, 100));
+  ASSERT_EQ(201, Lookup(cache, 200));
+  ASSERT_EQ(-1, Lookup(cache, 300));
+
+  // Replaced entry is kept until the last reference is released.
+  Cache::Handle* h1 = cache->Lookup(EncodeKey(100), kTestQueryId);
+  ASSERT_OK(Insert(cache, 100, 102));
+  ASSERT_EQ(102, Lookup(cache, 100));
+  ASSERT_EQ(101, DecodeValue(cache->Value(h1)));
+  ASSERT_EQ(0U, deleted_keys_.size());
+  ASSERT_EQ(1U, cache->GetPinnedUsage());
+  ASSERT_EQ(3U, cache->GetUsage());
+  cache->Release(h1);
+  ASSERT_EQ(1U, deleted_keys_.size());
+  ASSERT_EQ(100, deleted_keys_[0]);
+  ASSERT_EQ(101, deleted_values_[0]);
+  ASSERT_EQ(0U, cache->GetPinnedUsage());
+
+  Erase(cache, 200);
+  ASSERT_EQ(-1, Lookup(cache, 200));
+  ASSERT_EQ(2U, deleted_keys_.size());
+  ASSERT_EQ(200, deleted_keys_[1]);
+  ASSERT_EQ(1U, cache->GetUsage());
+}
+
+TEST_F(CacheTest, ClockCacheEvictionPolicy) {
+  auto cache = NewClockCache(kCacheSize, 0, false, 1);
+  const size_t single_touch_capacity = kCacheSize * FLAGS_cache_single_touch_ratio;
+
+  // Touched by two queries, so moved to the multi touch pool.
+  ASSERT_OK(Insert(cache, 100, 101));
+  ASSERT_TRUE(LookupAndCheckInMultiTouch(cache, 100, 101, kTestQueryId + 1));
+
+  // Single touch entries only push out each other.
+  for (int i = 0; i < kCacheSize; i++) {
+    ASSERT_OK(Insert(cache, 1000 + i, 2000 + i));
+    ASSERT_LE(cache->GetUsage(), single_touch_capacity + 1);
+  }
+  ASSERT_EQ(101, Lookup(cache, 100));
+  ASSERT_EQ(2000 + kCacheSize - 1, Lookup(cache, 1000 + kCacheSize - 1));
+  ASSERT_EQ(-1, Lookup(cache, 1000));
+
+  // Pinned entries are not evicted.
+  Cache::Handle* h = cache->Lookup(EncodeKey(1000 + kCacheSize - 1), kTestQueryId);
+  for (int i = 0; i < kCacheSize; i++) {
+    ASSERT_OK(Insert(cache, 5000 + i, 6000 + i));
+  }
+  ASSERT_EQ(2000 + kCacheSize - 1, DecodeValue(cache->Value(h)));
+  cache->Release(h);
+}
+
+TEST_F(CacheTest, ClockCacheStrictCapacityLimit) {
+  auto cache = NewClockCache(10, 0, true, 1);
+  std::vector<Cache::Handle*> handles;
+  Status s;
+  for (int i = 0; i < 10 && s.ok(); i++) {
+    Cache::Handle* handle = nullptr;
+    s = cache->Insert(EncodeKey(i), kInMultiTouchId, EncodeValue(i), 1, &CacheTest::Deleter,
+                      &handle);
+    if (s.ok()) {
+      handles.push_back(handle);
+    }
+  }
+  ASSERT_FALSE(handles.empty());
+  // Everything that fits is pinned now.
+  Cache::Handle* handle = nullptr;
+  s = cache->Insert(EncodeKey(100), kInMultiTouchId, EncodeValue(100), 10, &CacheTest::Deleter,
+                    &handle);
+  ASSERT_TRUE(s.IsIncomplete());
+  ASSERT_EQ(nullptr, handle);
+  for (auto h : handles) {
+    cache->Release(h);
+  }
+}
+
+namespace {
+
+std::atomic<int> concurrent_deleted{0};
+
+void CountingDeleter(const Slice& key, void* value) {
+  concurrent_deleted.fetch_add(1);
+}
+
+} // namespace
+
+TEST_F(CacheTest, ClockCacheConcurrentAccess) {
+  constexpr int kNumThreads = 8;
+  constexpr int kNumKeys = 200;
+  constexpr int kOpsPerThread = 20000;
+  concurrent_deleted = 0;
+  std::atomic<int> inserted{0};
+  {
+    auto cache = NewClockCache(kNumKeys / 2, 1, false, 1);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kNumThreads; t++) {
+      threads.emplace_back([&cache, &inserted, t] {
+        Random rnd(t + 1);
+        for (int i = 0; i < kOpsPerThread; i++) {
+          const int k = rnd.Uniform(kNumKeys);
+          const std::string key = EncodeKey(k);
+          switch (rnd.Uniform(4)) {
+            case 0:
+              if (cache->Insert(key, t, EncodeValue(k), 1, &CountingDeleter).ok()) {
+                inserted.fetch_add(1);
+              }
+              break;
+            case 1:
+              cache->Erase(key);
+              break;
+            default: {
+              Cache::Handle* handle = cache->Lookup(key, t);
+              if (handle != nullptr) {
+                ASSERT_EQ(k, DecodeValue(cache->Value(handle)));
+                cache->Release(handle);
+              }
+              break;
+            }
+          }
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    ASSERT_EQ(0U, cache->GetPinnedUsage());
+  }
+  ASSERT_EQ(inserted.load(), concurrent_deleted.load());
+}
+
 }  // namespace rocksdb
 
 int main(int argc, char** argv) {
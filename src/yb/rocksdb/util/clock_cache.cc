@@ -0,0 +1,772 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <math.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+#include <gflags/gflags.h>
+
+#include "yb/util/metrics.h"
+#include "yb/rocksdb/cache.h"
+#include "yb/rocksdb/statistics.h"
+#include "yb/rocksdb/port/port.h"
+#include "yb/rocksdb/util/hash.h"
+#include "yb/rocksdb/util/mutexlock.h"
+#include "yb/rocksdb/util/statistics.h"
+
+DECLARE_double(cache_single_touch_ratio);
+
+namespace rocksdb {
+
+namespace {
+
+// CLOCK cache implementation
+//
+// Each shard keeps its entries in a fixed size open addressing table with linear probing. Every
+// slot has a 64 bit meta word that holds the slot state, the CLOCK counter, the sub cache type and
+// the reference count, so Lookup and Release only perform atomic operations on the slot and never
+// take the shard mutex. Insert, Erase and eviction are serialized by the shard mutex.
+//
+// Slot states:
+// 1. Empty - the slot does not hold an entry.
+// 2. Construction - the slot is owned by a thread that inserts or frees the entry.
+// 3. Visible - the entry is in the cache and could be found by Lookup.
+// 4. Invisible - the entry was erased or replaced, but is still referenced externally. It is freed
+//    by whoever drops the last reference.
+//
+// Lookup optimistically increments the reference count of each probed slot and drops it if the
+// slot is not visible or holds another key. That's why all state transitions preserve reference
+// counts of such "stray" references, and a slot is only taken for construction or eviction when
+// its reference count is zero.
+//
+// The displacements counter of a slot is the number of entries whose probe sequence passes the
+// slot, so the probing stops at the first slot with no displacements.
+//
+// As in the LRU cache, the query id splits the cache into the single touch and the multi touch
+// pools. Entries are evicted from the pool that needs space for a new entry when the pool is over
+// capacity, and from any pool when the table is running out of free slots.
+
+constexpr int kStateShift = 62;
+constexpr uint64_t kStateEmpty = 0;
+constexpr uint64_t kStateConstruction = 1;
+constexpr uint64_t kStateVisible = 2;
+constexpr uint64_t kStateInvisible = 3;
+
+constexpr uint64_t kMultiTouchBit = 1ULL << 32;
+
+constexpr int kClockShift = 30;
+constexpr uint64_t kMaxClock = 3;
+constexpr uint64_t kOneClock = 1ULL << kClockShift;
+constexpr uint64_t kClockMask = kMaxClock << kClockShift;
+
+constexpr uint64_t kOneRef = 1;
+constexpr uint64_t kRefMask = kOneClock - 1;
+
+constexpr uint64_t kConstructionMeta = kStateConstruction << kStateShift;
+constexpr uint64_t kVisibleMeta = kStateVisible << kStateShift;
+constexpr uint64_t kInvisibleMeta = kStateInvisible << kStateShift;
+
+// Fraction of slots that could be occupied before entries are evicted to free slots.
+constexpr double kMaxLoadFactor = 0.7;
+
+constexpr size_t kMinSlotsPerShard = 16;
+
+inline uint64_t State(uint64_t meta) {
+  return meta >> kStateShift;
+}
+
+inline uint64_t Refs(uint64_t meta) {
+  return meta & kRefMask;
+}
+
+inline uint64_t Clock(uint64_t meta) {
+  return (meta & kClockMask) >> kClockShift;
+}
+
+inline SubCacheType SubCacheTypeOf(uint64_t meta) {
+  return (meta & kMultiTouchBit) ? MULTI_TOUCH : SINGLE_TOUCH;
+}
+
+struct ClockHandle {
+  std::atomic<uint64_t> meta{kStateEmpty};
+  std::atomic<uint32_t> displacements{0};
+
+  // The following fields are written while the slot is under construction, and could be read
+  // only when holding a reference to a visible or invisible entry.
+  uint32_t hash = 0;
+  void* value = nullptr;
+  void (*deleter)(const Slice&, void* value) = nullptr;
+  std::unique_ptr<char[]> key_data;
+  size_t key_length = 0;
+  // Entries that did not fit into the table are handed out to the caller without being cached.
+  bool detached = false;
+
+  // Query id that added the value to the cache.
+  std::atomic<QueryId> query_id{kDefaultQueryId};
+  // Atomic, so GetPinnedUsage could read it without holding a reference.
+  std::atomic<size_t> charge{0};
+
+  Slice key() const {
+    return Slice(key_data.get(), key_length);
+  }
+};
+
+// A single shard of sharded cache.
+class ClockCacheShard {
+ public:
+  ClockCacheShard() {}
+
+  ~ClockCacheShard();
+
+  // Separate from constructor so caller can easily make an array of ClockCacheShard.
+  void Init(size_t num_slots);
+
+  // If current usage is more than new capacity, the function will attempt to free the needed
+  // space.
+  void SetCapacity(size_t capacity);
+
+  void SetStrictCapacityLimit(bool strict_capacity_limit) {
+    MutexLock l(&mutex_);
+    strict_capacity_limit_ = strict_capacity_limit;
+  }
+
+  void SetMetrics(shared_ptr<yb::CacheMetrics> metrics) {
+    metrics_ = metrics;
+  }
+
+  // Like Cache methods, but with an extra "hash" parameter.
+  Status Insert(const Slice& key, uint32_t hash, const QueryId query_id,
+                void* value, size_t charge, void (*deleter)(const Slice& key, void* value),
+                Cache::Handle** handle, Statistics* statistics);
+  Cache::Handle* Lookup(const Slice& key, uint32_t hash, const QueryId query_id,
+                        Statistics* statistics);
+  void Release(Cache::Handle* handle);
+  void Erase(const Slice& key, uint32_t hash);
+
+  size_t GetUsage() const {
+    return Usage(SINGLE_TOUCH) + Usage(MULTI_TOUCH);
+  }
+
+  size_t GetPinnedUsage() const;
+
+  void ApplyToAllCacheEntries(void (*callback)(void*, size_t), bool thread_safe);
+
+ private:
+  size_t SubCacheIndex(SubCacheType subcache_type) const {
+    return subcache_type == MULTI_TOUCH ? 1 : 0;
+  }
+
+  size_t Usage(SubCacheType subcache_type) const {
+    return usage_[SubCacheIndex(subcache_type)].load(std::memory_order_relaxed);
+  }
+
+  size_t Capacity(SubCacheType subcache_type) const {
+    return capacity_[SubCacheIndex(subcache_type)].load(std::memory_order_relaxed);
+  }
+
+  // Returns the visible entry for key with a reference acquired, or nullptr.
+  ClockHandle* Find(const Slice& key, uint32_t hash);
+
+  // Acquires a reference to the slot if it holds a visible entry.
+  bool TryRef(ClockHandle* h);
+
+  // Drops a reference, freeing the entry if it was the last reference to an invisible entry.
+  void Unref(ClockHandle* h);
+
+  // Makes the referenced entry invisible to lookups and drops the reference.
+  void MakeInvisible(ClockHandle* h);
+
+  // Takes a slot for a new entry, returns nullptr if there are no empty slots.
+  ClockHandle* ClaimSlot(uint32_t hash);
+
+  // Calls the deleter of the entry in the slot owned by the current thread and makes the slot
+  // empty. meta is the value of the slot meta before it was taken for construction.
+  void Free(ClockHandle* h, uint64_t meta);
+
+  // Sweeps the clock until usage of the sub cache allows adding charge and, if need_slot is set,
+  // there are enough empty slots. Requires mutex_ to be held.
+  void EvictUnlocked(size_t charge, SubCacheType subcache_type, bool need_slot);
+
+  void UpdateUsage(SubCacheType subcache_type, size_t charge, bool increment);
+
+  std::unique_ptr<ClockHandle[]> slots_;
+  size_t mask_ = 0;
+  size_t max_occupancy_ = 0;
+  std::atomic<size_t> occupancy_{0};
+
+  // Indexed by SubCacheIndex.
+  std::atomic<size_t> usage_[2] = {{0}, {0}};
+  std::atomic<size_t> capacity_[2] = {{0}, {0}};
+
+  // mutex_ protects the following state and serializes changes of the table.
+  mutable port::Mutex mutex_;
+  size_t clock_pointer_ = 0;
+  bool strict_capacity_limit_ = false;
+
+  shared_ptr<yb::CacheMetrics> metrics_;
+};
+
+ClockCacheShard::~ClockCacheShard() {
+  if (!slots_) {
+    return;
+  }
+  for (size_t i = 0; i <= mask_; ++i) {
+    auto& slot = slots_[i];
+    const auto meta = slot.meta.load(std::memory_order_acquire);
+    if ((State(meta) == kStateVisible || State(meta) == kStateInvisible) && Refs(meta) == 0) {
+      (*slot.deleter)(slot.key(), slot.value);
+      UpdateUsage(SubCacheTypeOf(meta), slot.charge.load(std::memory_order_relaxed), false);
+    }
+  }
+}
+
+void ClockCacheShard::Init(size_t num_slots) {
+  slots_.reset(new ClockHandle[num_slots]);
+  mask_ = num_slots - 1;
+  max_occupancy_ = static_cast<size_t>(num_slots * kMaxLoadFactor);
+}
+
+void ClockCacheShard::SetCapacity(size_t capacity) {
+  MutexLock l(&mutex_);
+  const auto single_touch_capacity =
+      static_cast<size_t>(round(FLAGS_cache_single_touch_ratio * capacity));
+  capacity_[SubCacheIndex(SINGLE_TOUCH)].store(single_touch_capacity, std::memory_order_relaxed);
+  capacity_[SubCacheIndex(MULTI_TOUCH)].store(
+      capacity - single_touch_capacity, std::memory_order_relaxed);
+  EvictUnlocked(0, SINGLE_TOUCH, false);
+  EvictUnlocked(0, MULTI_TOUCH, false);
+}
+
+bool ClockCacheShard::TryRef(ClockHandle* h) {
+  const auto meta = h->meta.fetch_add(kOneRef, std::memory_order_acquire);
+  if (State(meta) == kStateVisible) {
+    return true;
+  }
+  Unref(h);
+  return false;
+}
+
+void ClockCacheShard::Unref(ClockHandle* h) {
+  auto meta = h->meta.fetch_sub(kOneRef, std::memory_order_acq_rel) - kOneRef;
+  // Only one of the threads racing on the last reference would take the slot.
+  while (State(meta) == kStateInvisible && Refs(meta) == 0) {
+    if (h->meta.compare_exchange_weak(meta, kConstructionMeta, std::memory_order_acq_rel)) {
+      Free(h, meta);
+      return;
+    }
+  }
+}
+
+void ClockCacheShard::MakeInvisible(ClockHandle* h) {
+  h->meta.fetch_or(kInvisibleMeta, std::memory_order_acq_rel);
+  Unref(h);
+}
+
+ClockHandle* ClockCacheShard::Find(const Slice& key, uint32_t hash) {
+  size_t index = hash & mask_;
+  for (size_t probe = 0; probe <= mask_; ++probe) {
+    ClockHandle* h = &slots_[index];
+    if (TryRef(h)) {
+      if (h->hash == hash && h->key() == key) {
+        return h;
+      }
+      Unref(h);
+    }
+    if (h->displacements.load(std::memory_order_acquire) == 0) {
+      break;
+    }
+    index = (index + 1) & mask_;
+  }
+  return nullptr;
+}
+
+ClockHandle* ClockCacheShard::ClaimSlot(uint32_t hash) {
+  if (occupancy_.load(std::memory_order_relaxed) > mask_) {
+    return nullptr;
+  }
+  const size_t home = hash & mask_;
+  size_t index = home;
+  for (size_t probe = 0; probe <= mask_; ++probe) {
+    ClockHandle* h = &slots_[index];
+    uint64_t expected = kStateEmpty;
+    if (h->meta.compare_exchange_strong(expected, kConstructionMeta, std::memory_order_acq_rel)) {
+      occupancy_.fetch_add(1, std::memory_order_relaxed);
+      return h;
+    }
+    h->displacements.fetch_add(1, std::memory_order_release);
+    index = (index + 1) & mask_;
+  }
+  // All slots are taken, undo displacements of the probe sequence.
+  for (size_t i = 0; i <= mask_; ++i) {
+    slots_[i].displacements.fetch_sub(1, std::memory_order_relaxed);
+  }
+  return nullptr;
+}
+
+void ClockCacheShard::Free(ClockHandle* h, uint64_t meta) {
+  const size_t charge = h->charge.load(std::memory_order_relaxed);
+  (*h->deleter)(h->key(), h->value);
+  UpdateUsage(SubCacheTypeOf(meta), charge, false);
+  if (h->detached) {
+    delete h;
+    return;
+  }
+  h->key_data.reset();
+  h->value = nullptr;
+  const size_t index = h - slots_.get();
+  for (size_t i = h->hash & mask_; i != index; i = (i + 1) & mask_) {
+    slots_[i].displacements.fetch_sub(1, std::memory_order_relaxed);
+  }
+  occupancy_.fetch_sub(1, std::memory_order_relaxed);
+  // Stray references of concurrent lookups are preserved.
+  h->meta.fetch_sub(kConstructionMeta, std::memory_order_release);
+}
+
+void ClockCacheShard::UpdateUsage(SubCacheType subcache_type, size_t charge, bool increment) {
+  auto& usage = usage_[SubCacheIndex(subcache_type)];
+  if (increment) {
+    usage.fetch_add(charge, std::memory_order_relaxed);
+  } else {
+    usage.fetch_sub(charge, std::memory_order_relaxed);
+  }
+  if (metrics_ == nullptr) {
+    return;
+  }
+  auto* gauge = subcache_type == MULTI_TOUCH ? metrics_->multi_touch_cache_usage.get()
+                                             : metrics_->single_touch_cache_usage.get();
+  if (increment) {
+    gauge->IncrementBy(charge);
+    metrics_->cache_usage->IncrementBy(charge);
+  } else {
+    gauge->DecrementBy(charge);
+    metrics_->cache_usage->DecrementBy(charge);
+  }
+}
+
+void ClockCacheShard::EvictUnlocked(size_t charge, SubCacheType subcache_type, bool need_slot) {
+  // Every visible entry that is not referenced gets evicted after kMaxClock + 1 passes.
+  const size_t max_steps = (kMaxClock + 1) * (mask_ + 1);
+  for (size_t step = 0; step != max_steps; ++step) {
+    const bool over_capacity = Usage(subcache_type) + charge > Capacity(subcache_type);
+    const bool over_occupancy =
+        need_slot && occupancy_.load(std::memory_order_relaxed) >= max_occupancy_;
+    if (!over_capacity && !over_occupancy) {
+      return;
+    }
+    ClockHandle* h = &slots_[clock_pointer_];
+    clock_pointer_ = (clock_pointer_ + 1) & mask_;
+    auto meta = h->meta.load(std::memory_order_acquire);
+    if (State(meta) != kStateVisible || Refs(meta) != 0 ||
+        (over_capacity && SubCacheTypeOf(meta) != subcache_type)) {
+      continue;
+    }
+    if (Clock(meta) > 0) {
+      h->meta.compare_exchange_strong(meta, meta - kOneClock, std::memory_order_relaxed);
+      continue;
+    }
+    if (h->meta.compare_exchange_strong(meta, kConstructionMeta, std::memory_order_acq_rel)) {
+      Free(h, meta);
+      if (metrics_ != nullptr) {
+        metrics_->evictions->Increment();
+      }
+    }
+  }
+}
+
+Cache::Handle* ClockCacheShard::Lookup(const Slice& key, uint32_t hash, const QueryId query_id,
+                                       Statistics* statistics) {
+  ClockHandle* h = Find(key, hash);
+  if (h != nullptr) {
+    auto meta = h->meta.load(std::memory_order_relaxed);
+    if (Clock(meta) != kMaxClock) {
+      h->meta.fetch_or(kClockMask, std::memory_order_relaxed);
+    }
+    // Now the handle will be moved to the multi touch pool. Unlike the LRU cache, the multi touch
+    // pool is not shrunk right away, the next insert evicts from it if needed.
+    if (FLAGS_cache_single_touch_ratio < 1 && SubCacheTypeOf(meta) != MULTI_TOUCH &&
+        h->query_id.load(std::memory_order_relaxed) != query_id) {
+      meta = h->meta.fetch_or(kMultiTouchBit, std::memory_order_relaxed);
+      if (SubCacheTypeOf(meta) != MULTI_TOUCH) {
+        h->query_id.store(kInMultiTouchId, std::memory_order_relaxed);
+        const size_t charge = h->charge.load(std::memory_order_relaxed);
+        UpdateUsage(SINGLE_TOUCH, charge, false);
+        UpdateUsage(MULTI_TOUCH, charge, true);
+      }
+    }
+    if (statistics != nullptr) {
+      const size_t charge = h->charge.load(std::memory_order_relaxed);
+      // overall cache hit
+      RecordTick(statistics, BLOCK_CACHE_HIT);
+      // total bytes read from cache
+      RecordTick(statistics, BLOCK_CACHE_BYTES_READ, charge);
+      if (SubCacheTypeOf(h->meta.load(std::memory_order_relaxed)) == SINGLE_TOUCH) {
+        RecordTick(statistics, BLOCK_CACHE_SINGLE_TOUCH_HIT);
+        RecordTick(statistics, BLOCK_CACHE_SINGLE_TOUCH_BYTES_READ, charge);
+      } else {
+        RecordTick(statistics, BLOCK_CACHE_MULTI_TOUCH_HIT);
+        RecordTick(statistics, BLOCK_CACHE_MULTI_TOUCH_BYTES_READ, charge);
+      }
+    }
+  } else if (statistics != nullptr) {
+    RecordTick(statistics, BLOCK_CACHE_MISS);
+  }
+
+  if (metrics_ != nullptr) {
+    metrics_->lookups->Increment();
+    if (h != nullptr) {
+      metrics_->cache_hits->Increment();
+    } else {
+      metrics_->cache_misses->Increment();
+    }
+  }
+  return reinterpret_cast<Cache::Handle*>(h);
+}
+
+void ClockCacheShard::Release(Cache::Handle* handle) {
+  if (handle == nullptr) {
+    return;
+  }
+  Unref(reinterpret_cast<ClockHandle*>(handle));
+}
+
+Status ClockCacheShard::Insert(const Slice& key, uint32_t hash, const QueryId query_id,
+                               void* value, size_t charge,
+                               void (*deleter)(const Slice& key, void* value),
+                               Cache::Handle** handle, Statistics* statistics) {
+  // Prepare the key outside of the mutex.
+  std::unique_ptr<char[]> key_data(new char[key.size()]);
+  memcpy(key_data.get(), key.data(), key.size());
+
+  Status s;
+  SubCacheType subcache_type = SINGLE_TOUCH;
+  {
+    MutexLock l(&mutex_);
+    // Check if there is a single touch cache.
+    if (FLAGS_cache_single_touch_ratio == 0) {
+      subcache_type = MULTI_TOUCH;
+    } else if (FLAGS_cache_single_touch_ratio == 1) {
+      // If there is no multi touch cache, default to single cache.
+      subcache_type = SINGLE_TOUCH;
+    } else if (query_id == kInMultiTouchId) {
+      subcache_type = MULTI_TOUCH;
+    }
+    ClockHandle* old = Find(key, hash);
+    if (old != nullptr && FLAGS_cache_single_touch_ratio != 1 &&
+        (SubCacheTypeOf(old->meta.load(std::memory_order_relaxed)) == MULTI_TOUCH ||
+         old->query_id.load(std::memory_order_relaxed) != query_id)) {
+      subcache_type = MULTI_TOUCH;
+    }
+
+    EvictUnlocked(charge, subcache_type, true);
+    ClockHandle* h = nullptr;
+    if (!strict_capacity_limit_ ||
+        Usage(subcache_type) + charge <= Capacity(subcache_type)) {
+      h = ClaimSlot(hash);
+      if (h == nullptr && !strict_capacity_limit_) {
+        if (handle == nullptr) {
+          // Every slot is referenced and nobody needs the entry, so it is evicted right away.
+          if (old != nullptr) {
+            MakeInvisible(old);
+          }
+          (*deleter)(key, value);
+          return Status::OK();
+        }
+        // Every slot is referenced, hand out an entry that is freed on release.
+        h = new ClockHandle();
+        h->detached = true;
+      }
+    }
+
+    if (h == nullptr) {
+      if (old != nullptr) {
+        Unref(old);
+      }
+      if (handle == nullptr) {
+        (*deleter)(key, value);
+      } else {
+        *handle = nullptr;
+      }
+      s = STATUS(Incomplete, "Insert failed due to CLOCK cache being full.");
+    } else {
+      if (old != nullptr) {
+        MakeInvisible(old);
+      }
+      h->hash = hash;
+      h->value = value;
+      h->deleter = deleter;
+      h->key_data = std::move(key_data);
+      h->key_length = key.size();
+      h->query_id.store(
+          subcache_type == MULTI_TOUCH ? kInMultiTouchId : query_id, std::memory_order_relaxed);
+      h->charge.store(charge, std::memory_order_relaxed);
+      UpdateUsage(subcache_type, charge, true);
+
+      uint64_t meta = (handle == nullptr ? 0 : kOneRef) + kOneClock;
+      if (subcache_type == MULTI_TOUCH) {
+        meta |= kMultiTouchBit;
+      }
+      if (h->detached) {
+        h->meta.store(meta | kInvisibleMeta, std::memory_order_release);
+      } else {
+        // Publish the entry, keeping stray references of concurrent lookups.
+        h->meta.fetch_add(meta + kVisibleMeta - kConstructionMeta, std::memory_order_release);
+      }
+      if (handle != nullptr) {
+        *handle = reinterpret_cast<Cache::Handle*>(h);
+      }
+    }
+  }
+
+  if (statistics != nullptr) {
+    if (s.ok()) {
+      RecordTick(statistics, BLOCK_CACHE_ADD);
+      RecordTick(statistics, BLOCK_CACHE_BYTES_WRITE, charge);
+      if (subcache_type == SubCacheType::SINGLE_TOUCH) {
+        RecordTick(statistics, BLOCK_CACHE_SINGLE_TOUCH_ADD);
+        RecordTick(statistics, BLOCK_CACHE_SINGLE_TOUCH_BYTES_WRITE, charge);
+      } else {
+        RecordTick(statistics, BLOCK_CACHE_MULTI_TOUCH_ADD);
+        RecordTick(statistics, BLOCK_CACHE_MULTI_TOUCH_BYTES_WRITE, charge);
+      }
+    } else {
+      RecordTick(statistics, BLOCK_CACHE_ADD_FAILURES);
+    }
+  }
+  if (metrics_ != nullptr && s.ok()) {
+    metrics_->inserts->Increment();
+  }
+  return s;
+}
+
+void ClockCacheShard::Erase(const Slice& key, uint32_t hash) {
+  MutexLock l(&mutex_);
+  ClockHandle* h = Find(key, hash);
+  if (h != nullptr) {
+    MakeInvisible(h);
+  }
+}
+
+size_t ClockCacheShard::GetPinnedUsage() const {
+  // Entries referenced by cache users are not tracked separately, so this is an estimate.
+  size_t usage = 0;
+  for (size_t i = 0; i <= mask_; ++i) {
+    const auto& slot = slots_[i];
+    const auto meta = slot.meta.load(std::memory_order_relaxed);
+    if ((State(meta) == kStateVisible || State(meta) == kStateInvisible) && Refs(meta) != 0) {
+      usage += slot.charge.load(std::memory_order_relaxed);
+    }
+  }
+  return usage;
+}
+
+void ClockCacheShard::ApplyToAllCacheEntries(void (*callback)(void*, size_t),
+                                             bool thread_safe) {
+  for (size_t i = 0; i <= mask_; ++i) {
+    ClockHandle* h = &slots_[i];
+    if (thread_safe) {
+      // Holding a reference keeps the entry from being freed while the callback runs.
+      if (TryRef(h)) {
+        callback(h->value, h->charge.load(std::memory_order_relaxed));
+        Unref(h);
+      }
+    } else if (State(h->meta.load(std::memory_order_relaxed)) == kStateVisible) {
+      callback(h->value, h->charge.load(std::memory_order_relaxed));
+    }
+  }
+}
+
+static int kNumShardBits = 4;          // default values, can be overridden
+
+class ShardedClockCache : public Cache {
+ private:
+  ClockCacheShard* shards_;
+  std::atomic<uint64_t> last_id_{0};
+  port::Mutex capacity_mutex_;
+  int num_shard_bits_;
+  size_t capacity_;
+  bool strict_capacity_limit_;
+  shared_ptr<yb::CacheMetrics> metrics_;
+
+  static inline uint32_t HashSlice(const Slice& s) {
+    return Hash(s.data(), s.size(), 0);
+  }
+
+  uint32_t Shard(uint32_t hash) {
+    // Note, hash >> 32 yields hash in gcc, not the zero we expect!
+    return (num_shard_bits_ > 0) ? (hash >> (32 - num_shard_bits_)) : 0;
+  }
+
+  bool IsValidQueryId(const QueryId query_id) {
+    return query_id >= 0 || query_id == kInMultiTouchId || query_id == kNoCacheQueryId;
+  }
+
+ public:
+  ShardedClockCache(size_t capacity, int num_shard_bits, bool strict_capacity_limit,
+                    size_t estimated_entry_charge)
+      : num_shard_bits_(num_shard_bits),
+        capacity_(capacity),
+        strict_capacity_limit_(strict_capacity_limit),
+        metrics_(nullptr) {
+    int num_shards = 1 << num_shard_bits_;
+    shards_ = new ClockCacheShard[num_shards];
+    const size_t per_shard = (capacity + (num_shards - 1)) / num_shards;
+    const size_t expected_entries = per_shard / std::max<size_t>(estimated_entry_charge, 1) + 1;
+    size_t num_slots = kMinSlotsPerShard;
+    while (num_slots * kMaxLoadFactor < expected_entries) {
+      num_slots *= 2;
+    }
+    for (int s = 0; s < num_shards; s++) {
+      shards_[s].Init(num_slots);
+      shards_[s].SetCapacity(per_shard);
+      shards_[s].SetStrictCapacityLimit(strict_capacity_limit);
+    }
+  }
+
+  virtual ~ShardedClockCache() {
+    delete[] shards_;
+  }
+
+  void SetCapacity(size_t capacity) override {
+    int num_shards = 1 << num_shard_bits_;
+    const size_t per_shard = (capacity + (num_shards - 1)) / num_shards;
+    MutexLock l(&capacity_mutex_);
+    for (int s = 0; s < num_shards; s++) {
+      shards_[s].SetCapacity(per_shard);
+    }
+    capacity_ = capacity;
+  }
+
+  void SetStrictCapacityLimit(bool strict_capacity_limit) override {
+    int num_shards = 1 << num_shard_bits_;
+    for (int s = 0; s < num_shards; s++) {
+      shards_[s].SetStrictCapacityLimit(strict_capacity_limit);
+    }
+    strict_capacity_limit_ = strict_capacity_limit;
+  }
+
+  virtual Status Insert(const Slice& key, const QueryId query_id, void* value, size_t charge,
+                        void (*deleter)(const Slice& key, void* value),
+                        Handle** handle, Statistics* statistics,
+                        CachePriorityClass priority_class) override {
+    // Priority classes are not supported, all entries compete for the whole capacity.
+    DCHECK(IsValidQueryId(query_id));
+    // Queries with no cache query ids are not cached.
+    if (query_id == kNoCacheQueryId) {
+      return Status::OK();
+    }
+    const uint32_t hash = HashSlice(key);
+    return shards_[Shard(hash)].Insert(key, hash, query_id, value, charge, deleter,
+                                       handle, statistics);
+  }
+
+  Handle* Lookup(const Slice& key, const QueryId query_id, Statistics* statistics,
+                 CachePriorityClass priority_class) override {
+    DCHECK(IsValidQueryId(query_id));
+    if (query_id == kNoCacheQueryId) {
+      return nullptr;
+    }
+    const uint32_t hash = HashSlice(key);
+    return shards_[Shard(hash)].Lookup(key, hash, query_id, statistics);
+  }
+
+  void Release(Handle* handle) override {
+    ClockHandle* h = reinterpret_cast<ClockHandle*>(handle);
+    shards_[Shard(h->hash)].Release(handle);
+  }
+
+  void Erase(const Slice& key) override {
+    const uint32_t hash = HashSlice(key);
+    shards_[Shard(hash)].Erase(key, hash);
+  }
+
+  void* Value(Handle* handle) override {
+    return reinterpret_cast<ClockHandle*>(handle)->value;
+  }
+
+  uint64_t NewId() override {
+    return last_id_.fetch_add(1, std::memory_order_relaxed) + 1;
+  }
+
+  size_t GetCapacity() const override { return capacity_; }
+
+  bool HasStrictCapacityLimit() const override {
+    return strict_capacity_limit_;
+  }
+
+  size_t GetUsage() const override {
+    int num_shards = 1 << num_shard_bits_;
+    size_t usage = 0;
+    for (int s = 0; s < num_shards; s++) {
+      usage += shards_[s].GetUsage();
+    }
+    return usage;
+  }
+
+  size_t GetUsage(Handle* handle) const override {
+    return reinterpret_cast<ClockHandle*>(handle)->charge.load(std::memory_order_relaxed);
+  }
+
+  size_t GetPinnedUsage() const override {
+    int num_shards = 1 << num_shard_bits_;
+    size_t usage = 0;
+    for (int s = 0; s < num_shards; s++) {
+      usage += shards_[s].GetPinnedUsage();
+    }
+    return usage;
+  }
+
+  SubCacheType GetSubCacheType(Handle* e) const override {
+    ClockHandle* h = reinterpret_cast<ClockHandle*>(e);
+    return SubCacheTypeOf(h->meta.load(std::memory_order_relaxed));
+  }
+
+  void DisownData() override {
+    shards_ = nullptr;
+  }
+
+  virtual void ApplyToAllCacheEntries(void (*callback)(void*, size_t),
+                                      bool thread_safe) override {
+    int num_shards = 1 << num_shard_bits_;
+    for (int s = 0; s < num_shards; s++) {
+      shards_[s].ApplyToAllCacheEntries(callback, thread_safe);
+    }
+  }
+
+  virtual void SetMetrics(const scoped_refptr<yb::MetricEntity>& entity) override {
+    int num_shards = 1 << num_shard_bits_;
+    metrics_ = std::make_shared<yb::CacheMetrics>(entity);
+    for (int s = 0; s < num_shards; s++) {
+      shards_[s].SetMetrics(metrics_);
+    }
+  }
+};
+
+}  // end anonymous namespace
+
+shared_ptr<Cache> NewClockCache(size_t capacity) {
+  return NewClockCache(capacity, kNumShardBits, false);
+}
+
+shared_ptr<Cache> NewClockCache(size_t capacity, int num_shard_bits,
+                                bool strict_capacity_limit, size_t estimated_entry_charge) {
+  if (num_shard_bits >= 20) {
+    return nullptr;  // the cache cannot be sharded into too many fine pieces
+  }
+  return std::make_shared<ShardedClockCache>(capacity, num_shard_bits, strict_capacity_limit,
+                                             estimated_entry_charge);
+}
+
+}  // namespace rocksdb
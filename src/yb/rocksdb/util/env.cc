@@ -84,6 +84,14 @@ SequentialFile::~SequentialFile() {
 RandomAccessFile::~RandomAccessFile() {
 }
 
+Status RandomAccessFile::MultiRead(ReadRequest* requests, size_t num_requests) const {
+  for (size_t i = 0; i != num_requests; ++i) {
+    auto& request = requests[i];
+    request.status = Read(request.offset, request.n, &request.result, request.scratch);
+  }
+  return Status::OK();
+}
+
 WritableFile::~WritableFile() {
 }
 
@@ -413,6 +421,20 @@ EnvOptions Env::OptimizeForManifestWrite(const EnvOptions& env_options) const {
   return env_options;
 }
 
+EnvOptions Env::OptimizeForCompactionTableWrite(const EnvOptions& env_options,
+                                                const DBOptions& db_options) const {
+  EnvOptions optimized_env_options(env_options);
+  optimized_env_options.use_direct_writes = db_options.use_direct_io_for_flush_and_compaction;
+  return optimized_env_options;
+}
+
+EnvOptions Env::OptimizeForCompactionTableRead(const EnvOptions& env_options,
+                                               const DBOptions& db_options) const {
+  EnvOptions optimized_env_options(env_options);
+  optimized_env_options.use_direct_reads = db_options.use_direct_io_for_flush_and_compaction;
+  return optimized_env_options;
+}
+
 EnvOptions::EnvOptions(const DBOptions& options) {
   AssignEnvOptions(this, options);
 }
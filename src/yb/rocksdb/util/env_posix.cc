@@ -128,6 +128,30 @@ static int LockOrUnlock(const std::string& fname, int fd, bool lock) {
   return value;
 }
 
+// Opens the file with O_DIRECT if try_direct is set and the file system supports it. Otherwise
+// opens it without O_DIRECT. *direct is set to true iff the returned descriptor uses O_DIRECT.
+static int OpenMaybeDirect(const std::string& fname, int flags, mode_t mode, bool try_direct,
+                           bool* direct) {
+  int fd = -1;
+  *direct = false;
+#ifdef O_DIRECT
+  if (try_direct) {
+    do {
+      fd = open(fname.c_str(), flags | O_DIRECT, mode);
+    } while (fd < 0 && errno == EINTR);
+    // EINVAL means that the file system does not support O_DIRECT, e.g. tmpfs.
+    if (fd >= 0 || errno != EINVAL) {
+      *direct = fd >= 0;
+      return fd;
+    }
+  }
+#endif
+  do {
+    fd = open(fname.c_str(), flags, mode);
+  } while (fd < 0 && errno == EINTR);
+  return fd;
+}
+
 class PosixFileLock : public FileLock {
  public:
   int fd_;
@@ -182,13 +206,24 @@ class PosixEnv : public Env {
     result->reset();
     Status s;
     int fd;
+    bool direct = false;
     {
       IOSTATS_TIMER_GUARD(open_nanos);
-      fd = open(fname.c_str(), O_RDONLY);
+      if (options.use_direct_reads) {
+        fd = OpenMaybeDirect(fname, O_RDONLY, 0, /* try_direct */ true, &direct);
+      } else {
+        fd = open(fname.c_str(), O_RDONLY);
+      }
     }
     SetFD_CLOEXEC(fd, &options);
     if (fd < 0) {
       s = STATUS_IO_ERROR(fname, errno);
+    } else if (options.use_direct_reads) {
+      // Without O_DIRECT support, fall back to dropping the pages that were read from the cache.
+      EnvOptions direct_options = options;
+      direct_options.use_direct_reads = direct;
+      direct_options.use_os_buffer = false;
+      result->reset(new PosixRandomAccessFile(fname, fd, direct_options));
     } else if (options.use_mmap_reads && sizeof(void*) >= 8) {
       // Use of mmap for random reads has been removed because it
       // kills performance when storage is fast.
@@ -217,12 +252,21 @@ class PosixEnv : public Env {
     result->reset();
     Status s;
     int fd = -1;
-    do {
+    bool direct = false;
+    const bool try_direct = options.use_direct_writes && !options.use_mmap_writes;
+    {
       IOSTATS_TIMER_GUARD(open_nanos);
-      fd = open(fname.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0644);
-    } while (fd < 0 && errno == EINTR);
+      fd = OpenMaybeDirect(fname, O_CREAT | O_RDWR | O_TRUNC, 0644, try_direct, &direct);
+    }
     if (fd < 0) {
       s = STATUS_IO_ERROR(fname, errno);
+    } else if (try_direct) {
+      SetFD_CLOEXEC(fd, &options);
+      // Without O_DIRECT support, fall back to dropping the written pages from the cache on sync.
+      EnvOptions direct_options = options;
+      direct_options.use_direct_writes = direct;
+      result->reset(new PosixWritableFile(fname, fd, direct_options,
+                                          /* drop_cache_on_sync */ !direct));
     } else {
       SetFD_CLOEXEC(fd, &options);
       if (options.use_mmap_writes) {
@@ -241,6 +285,7 @@ class PosixEnv : public Env {
         // disable mmap writes
         EnvOptions no_mmap_writes_options = options;
         no_mmap_writes_options.use_mmap_writes = false;
+        no_mmap_writes_options.use_direct_writes = false;
 
         result->reset(new PosixWritableFile(fname, fd, no_mmap_writes_options));
       }
@@ -285,6 +330,7 @@ class PosixEnv : public Env {
         // disable mmap writes
         EnvOptions no_mmap_writes_options = options;
         no_mmap_writes_options.use_mmap_writes = false;
+        no_mmap_writes_options.use_direct_writes = false;
 
         result->reset(new PosixWritableFile(fname, fd, no_mmap_writes_options));
       }
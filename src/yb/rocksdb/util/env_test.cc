@@ -30,6 +30,8 @@
 #include <unordered_set>
 #include <atomic>
 #include <list>
+#include <string>
+#include <vector>
 
 #ifdef OS_LINUX
 #include <fcntl.h>
@@ -46,8 +48,10 @@
 #include "yb/rocksdb/env.h"
 #include "yb/rocksdb/port/port.h"
 #include "yb/rocksdb/util/coding.h"
+#include "yb/rocksdb/util/file_reader_writer.h"
 #include "yb/rocksdb/util/log_buffer.h"
 #include "yb/rocksdb/util/mutexlock.h"
+#include "yb/rocksdb/util/random.h"
 #include "yb/util/string_util.h"
 #include "yb/rocksdb/util/testharness.h"
 #include "yb/rocksdb/util/testutil.h"
@@ -808,6 +812,89 @@ TEST_F(EnvPosixTest, InvalidateCache) {
   // Delete the file
   ASSERT_OK(env_->DeleteFile(fname));
 }
+
+TEST_F(EnvPosixTest, MultiRead) {
+  const EnvOptions soptions;
+  std::string fname = test::TmpDir() + "/" + "testfile";
+  Random rnd(301);
+  std::string data = RandomString(&rnd, 64 * 1024);
+
+  // Create file.
+  {
+    unique_ptr<WritableFile> wfile;
+    ASSERT_OK(env_->NewWritableFile(fname, &wfile, soptions));
+    ASSERT_OK(wfile->Append(data));
+    ASSERT_OK(wfile->Close());
+  }
+
+  unique_ptr<RandomAccessFile> file;
+  ASSERT_OK(env_->NewRandomAccessFile(fname, &file, soptions));
+  // More requests than fit into a single batch, some of them reading past the end of the file.
+  constexpr size_t kNumRequests = 100;
+  std::vector<ReadRequest> requests(kNumRequests);
+  std::vector<std::string> buffers(kNumRequests);
+  for (size_t i = 0; i != kNumRequests; ++i) {
+    auto& request = requests[i];
+    request.offset = rnd.Uniform(static_cast<int>(data.size()));
+    request.n = 1 + rnd.Uniform(8 * 1024);
+    buffers[i].resize(request.n);
+    request.scratch = &buffers[i][0];
+  }
+  ASSERT_OK(file->MultiRead(requests.data(), requests.size()));
+  for (const auto& request : requests) {
+    ASSERT_OK(request.status);
+    ASSERT_EQ(data.substr(request.offset, request.n), request.result.ToBuffer());
+  }
+
+  // Delete the file
+  ASSERT_OK(env_->DeleteFile(fname));
+}
+
+TEST_F(EnvPosixTest, DirectIO) {
+  EnvOptions soptions;
+  soptions.use_mmap_writes = false;
+  soptions.use_direct_writes = true;
+  soptions.use_direct_reads = true;
+  std::string fname = test::TmpDir() + "/" + "testfile";
+  Random rnd(301);
+  std::string data;
+
+  // Create file with unaligned appends, flushing in the middle of a page.
+  {
+    unique_ptr<WritableFile> wfile;
+    ASSERT_OK(env_->NewWritableFile(fname, &wfile, soptions));
+    WritableFileWriter writer(std::move(wfile), soptions);
+    for (int i = 0; i != 100; ++i) {
+      std::string chunk = RandomString(&rnd, 1 + rnd.Uniform(10000));
+      ASSERT_OK(writer.Append(chunk));
+      data += chunk;
+      if (i % 10 == 0) {
+        ASSERT_OK(writer.Flush());
+      }
+    }
+    ASSERT_OK(writer.Sync(false /* use_fsync */));
+    ASSERT_OK(writer.Close());
+  }
+
+  uint64_t file_size = 0;
+  ASSERT_OK(env_->GetFileSize(fname, &file_size));
+  ASSERT_EQ(data.size(), file_size);
+
+  unique_ptr<RandomAccessFile> file;
+  ASSERT_OK(env_->NewRandomAccessFile(fname, &file, soptions));
+  for (int i = 0; i != 100; ++i) {
+    // Unaligned reads, some of them past the end of the file.
+    const uint64_t offset = rnd.Uniform(static_cast<int>(data.size()));
+    const size_t n = 1 + rnd.Uniform(20000);
+    std::string scratch(n, 0);
+    Slice result;
+    ASSERT_OK(file->Read(offset, n, &result, &scratch[0]));
+    ASSERT_EQ(data.substr(offset, n), result.ToBuffer());
+  }
+
+  // Delete the file
+  ASSERT_OK(env_->DeleteFile(fname));
+}
 #endif  // not TRAVIS
 #endif  // OS_LINUX
 
@@ -33,11 +33,15 @@
 #include "yb/rocksdb/util/rate_limiter.h"
 #include "yb/rocksdb/util/sync_point.h"
 
+#include "yb/util/io_accounting.h"
+
 namespace rocksdb {
 
 Status SequentialFileReader::Read(size_t n, Slice* result, char* scratch) {
+  const auto io_start = yb::IOAccountingStart();
   Status s = file_->Read(n, result, scratch);
   IOSTATS_ADD(bytes_read, result->size());
+  yb::RecordIORead(io_start, result->size());
   return s;
 }
 
@@ -51,8 +55,32 @@ Status RandomAccessFileReader::Read(uint64_t offset, size_t n, Slice* result,
     StopWatch sw(env_, stats_, hist_type_,
                  (stats_ != nullptr) ? &elapsed : nullptr);
     IOSTATS_TIMER_GUARD(read_nanos);
+    const auto io_start = yb::IOAccountingStart();
     s = file_->Read(offset, n, result, scratch);
     IOSTATS_ADD_IF_POSITIVE(bytes_read, result->size());
+    yb::RecordIORead(io_start, result->size());
+  }
+  if (stats_ != nullptr && file_read_hist_ != nullptr) {
+    file_read_hist_->Add(elapsed);
+  }
+  return s;
+}
+
+Status RandomAccessFileReader::MultiRead(ReadRequest* requests, size_t num_requests) const {
+  Status s;
+  uint64_t elapsed = 0;
+  {
+    StopWatch sw(env_, stats_, hist_type_,
+                 (stats_ != nullptr) ? &elapsed : nullptr);
+    IOSTATS_TIMER_GUARD(read_nanos);
+    const auto io_start = yb::IOAccountingStart();
+    s = file_->MultiRead(requests, num_requests);
+    size_t total_bytes_read = 0;
+    for (size_t i = 0; i != num_requests; ++i) {
+      IOSTATS_ADD_IF_POSITIVE(bytes_read, requests[i].result.size());
+      total_bytes_read += requests[i].result.size();
+    }
+    yb::RecordIORead(io_start, total_bytes_read);
   }
   if (stats_ != nullptr && file_read_hist_ != nullptr) {
     file_read_hist_->Add(elapsed);
@@ -224,7 +252,8 @@ Status WritableFileWriter::Sync(bool use_fsync) {
     return s;
   }
   TEST_KILL_RANDOM("WritableFileWriter::Sync:0", rocksdb_kill_odds);
-  if (!direct_io_ && pending_sync_) {
+  // Direct I/O still needs a sync to persist the file metadata and the device write cache.
+  if (pending_sync_) {
     s = SyncInternal(use_fsync);
     if (!s.ok()) {
       return s;
@@ -254,11 +283,13 @@ Status WritableFileWriter::SyncInternal(bool use_fsync) {
   Status s;
   IOSTATS_TIMER_GUARD(fsync_nanos);
   TEST_SYNC_POINT("WritableFileWriter::SyncInternal:0");
+  const auto io_start = yb::IOAccountingStart();
   if (use_fsync) {
     s = writable_file_->Fsync();
   } else {
     s = writable_file_->Sync();
   }
+  yb::RecordIOSync(io_start);
   return s;
 }
 
@@ -301,10 +332,12 @@ Status WritableFileWriter::WriteBuffered(const char* data, size_t size) {
     {
       IOSTATS_TIMER_GUARD(write_nanos);
       TEST_SYNC_POINT("WritableFileWriter::Flush:BeforeAppend");
+      const auto io_start = yb::IOAccountingStart();
       s = writable_file_->Append(Slice(src, allowed));
       if (!s.ok()) {
         return s;
       }
+      yb::RecordIOWrite(io_start, allowed);
     }
 
     IOSTATS_ADD(bytes_written, allowed);
@@ -358,11 +391,13 @@ Status WritableFileWriter::WriteUnbuffered() {
       IOSTATS_TIMER_GUARD(write_nanos);
       TEST_SYNC_POINT("WritableFileWriter::Flush:BeforeAppend");
       // Unbuffered writes must be positional
+      const auto io_start = yb::IOAccountingStart();
       s = writable_file_->PositionedAppend(Slice(src, size), write_offset);
       if (!s.ok()) {
         buf_.Size(file_advance + leftover_tail);
         return s;
       }
+      yb::RecordIOWrite(io_start, size);
     }
 
     IOSTATS_ADD(bytes_written, size);
@@ -103,6 +103,12 @@ class RandomAccessFileReader {
 
   Status Read(uint64_t offset, size_t n, Slice* result, char* scratch) const;
 
+  // See RandomAccessFile::MultiRead.
+  Status MultiRead(ReadRequest* requests, size_t num_requests) const;
+
+  // See RandomAccessFile::Prefetch.
+  Status Prefetch(uint64_t offset, size_t n) const { return file_->Prefetch(offset, n); }
+
   RandomAccessFile* file() { return file_.get(); }
 };
 
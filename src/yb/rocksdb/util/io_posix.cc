@@ -39,15 +39,36 @@
 #ifdef OS_LINUX
 #include <sys/statfs.h>
 #include <sys/syscall.h>
+#include <sys/uio.h>
 #endif
+
+#if defined(OS_LINUX) && defined(__NR_io_uring_setup) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#define ROCKSDB_IO_URING_PRESENT
+#endif
+#endif
+
+#include <atomic>
+#include <limits>
+#include <vector>
+
+#include <gflags/gflags.h>
+
 #include "yb/rocksdb/port/port.h"
 #include "yb/util/slice.h"
+#include "yb/rocksdb/util/aligned_buffer.h"
 #include "yb/rocksdb/util/coding.h"
 #include "yb/rocksdb/util/iostats_context_imp.h"
 #include "yb/rocksdb/util/posix_logger.h"
 #include "yb/util/string_util.h"
+#include "yb/util/wait_state.h"
 #include "yb/rocksdb/util/sync_point.h"
 
+DEFINE_bool(rocksdb_use_io_uring, true,
+            "Submit batched reads of SST files through io_uring if the kernel supports it. "
+            "Otherwise the reads of a batch are performed one by one.");
+
 namespace rocksdb {
 
 // A wrapper for fadvise, if the platform doesn't support fadvise,
@@ -148,6 +169,161 @@ static size_t GetUniqueIdFromFile(int fd, char* id, size_t max_size) {
 } // namespace
 #endif
 
+#ifdef ROCKSDB_IO_URING_PRESENT
+namespace {
+
+// Minimal io_uring wrapper used to submit batches of reads with a single system call. The ring
+// is not thread safe, so every thread that performs batched reads gets its own ring.
+class IoUring {
+ public:
+  // Result of a request that was not submitted.
+  static constexpr int kNotSubmitted = std::numeric_limits<int>::min();
+
+  // Returns the ring of the current thread, or nullptr if io_uring is not available.
+  static IoUring* ForCurrentThread() {
+    static std::atomic<bool> unsupported{false};
+    static thread_local std::unique_ptr<IoUring> ring;
+    static thread_local bool initialized = false;
+    if (!initialized && !unsupported.load(std::memory_order_relaxed)) {
+      initialized = true;
+      std::unique_ptr<IoUring> new_ring(new IoUring());
+      if (new_ring->Init()) {
+        ring = std::move(new_ring);
+      } else if (errno == ENOSYS || errno == EPERM) {
+        unsupported.store(true, std::memory_order_relaxed);
+      }
+    }
+    return ring.get();
+  }
+
+  ~IoUring() {
+    if (sqes_ != MAP_FAILED) {
+      munmap(sqes_, sqes_size_);
+    }
+    if (cq_ptr_ != MAP_FAILED) {
+      munmap(cq_ptr_, cq_size_);
+    }
+    if (sq_ptr_ != MAP_FAILED) {
+      munmap(sq_ptr_, sq_size_);
+    }
+    if (ring_fd_ >= 0) {
+      close(ring_fd_);
+    }
+  }
+
+  // Reads the requests from fd, storing the result of the read system call for each request in
+  // results, negated errno on failure. Requests that could not be submitted keep kNotSubmitted.
+  void Read(int fd, ReadRequest* requests, size_t num_requests, std::vector<int>* results) {
+    std::vector<iovec> iovecs(num_requests);
+    size_t queued = 0;
+    size_t submitted = 0;
+    size_t completed = 0;
+    while (completed < num_requests) {
+      // Queue as many requests as could be in flight.
+      unsigned tail = *sq_tail_;
+      while (queued < num_requests && queued - completed < sq_entries_) {
+        const unsigned index = tail & *sq_mask_;
+        io_uring_sqe* sqe = &sqes_[index];
+        memset(sqe, 0, sizeof(*sqe));
+        iovecs[queued].iov_base = requests[queued].scratch;
+        iovecs[queued].iov_len = requests[queued].n;
+        sqe->opcode = IORING_OP_READV;
+        sqe->fd = fd;
+        sqe->off = requests[queued].offset;
+        sqe->addr = reinterpret_cast<uint64_t>(&iovecs[queued]);
+        sqe->len = 1;
+        sqe->user_data = queued;
+        sq_array_[index] = index;
+        ++tail;
+        ++queued;
+      }
+      __atomic_store_n(sq_tail_, tail, __ATOMIC_RELEASE);
+
+      const auto to_submit = static_cast<unsigned>(queued - submitted);
+      const auto ret = syscall(
+          __NR_io_uring_enter, ring_fd_, to_submit, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+      if (ret >= 0) {
+        submitted += ret;
+      } else if (errno != EINTR && errno != EAGAIN && errno != EBUSY && submitted == completed) {
+        // Nothing is in flight, so the rest of requests is left to the caller. Entries that were
+        // not submitted are taken back from the queue.
+        __atomic_store_n(sq_tail_, tail - to_submit, __ATOMIC_RELEASE);
+        return;
+      }
+
+      unsigned head = *cq_head_;
+      while (head != __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE)) {
+        const io_uring_cqe& cqe = cqes_[head & *cq_mask_];
+        (*results)[cqe.user_data] = cqe.res;
+        ++head;
+        ++completed;
+      }
+      __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+    }
+  }
+
+ private:
+  IoUring() {}
+
+  bool Init() {
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    ring_fd_ = static_cast<int>(syscall(__NR_io_uring_setup, kEntries, &params));
+    if (ring_fd_ < 0) {
+      return false;
+    }
+    sq_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+    sq_ptr_ = mmap(nullptr, sq_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                   ring_fd_, IORING_OFF_SQ_RING);
+    cq_ptr_ = mmap(nullptr, cq_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                   ring_fd_, IORING_OFF_CQ_RING);
+    sqes_ = static_cast<io_uring_sqe*>(mmap(
+        nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_,
+        IORING_OFF_SQES));
+    if (sq_ptr_ == MAP_FAILED || cq_ptr_ == MAP_FAILED || sqes_ == MAP_FAILED) {
+      return false;
+    }
+    auto* sq = static_cast<char*>(sq_ptr_);
+    sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    sq_mask_ = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    sq_entries_ = params.sq_entries;
+    auto* cq = static_cast<char*>(cq_ptr_);
+    cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    cq_mask_ = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+    return true;
+  }
+
+  static constexpr unsigned kEntries = 64;
+
+  int ring_fd_ = -1;
+  void* sq_ptr_ = MAP_FAILED;
+  void* cq_ptr_ = MAP_FAILED;
+  io_uring_sqe* sqes_ = static_cast<io_uring_sqe*>(MAP_FAILED);
+  size_t sq_size_ = 0;
+  size_t cq_size_ = 0;
+  size_t sqes_size_ = 0;
+
+  unsigned* sq_tail_ = nullptr;
+  unsigned* sq_mask_ = nullptr;
+  unsigned* sq_array_ = nullptr;
+  unsigned sq_entries_ = 0;
+  unsigned* cq_head_ = nullptr;
+  unsigned* cq_tail_ = nullptr;
+  unsigned* cq_mask_ = nullptr;
+  io_uring_cqe* cqes_ = nullptr;
+};
+
+constexpr int IoUring::kNotSubmitted;
+constexpr unsigned IoUring::kEntries;
+
+} // namespace
+#endif // ROCKSDB_IO_URING_PRESENT
+
 /*
  * PosixRandomAccessFile
  *
@@ -155,14 +331,19 @@ static size_t GetUniqueIdFromFile(int fd, char* id, size_t max_size) {
  */
 PosixRandomAccessFile::PosixRandomAccessFile(const std::string& fname, int fd,
                                              const EnvOptions& options)
-    : filename_(fname), fd_(fd), use_os_buffer_(options.use_os_buffer) {
-  assert(!options.use_mmap_reads || sizeof(void*) < 8);
+    : filename_(fname), fd_(fd), use_os_buffer_(options.use_os_buffer),
+      use_direct_io_(options.use_direct_reads) {
+  assert(!options.use_mmap_reads || sizeof(void*) < 8 || use_direct_io_);
 }
 
 PosixRandomAccessFile::~PosixRandomAccessFile() { close(fd_); }
 
 Status PosixRandomAccessFile::Read(uint64_t offset, size_t n, Slice* result,
                                    char* scratch) const {
+  if (use_direct_io_) {
+    return DirectRead(offset, n, result, scratch);
+  }
+  yb::ScopedWaitState wait_state(yb::WaitState::kIo);
   Status s;
   ssize_t r = -1;
   size_t left = n;
@@ -194,6 +375,106 @@ Status PosixRandomAccessFile::Read(uint64_t offset, size_t n, Slice* result,
   return s;
 }
 
+Status PosixRandomAccessFile::DirectRead(uint64_t offset, size_t n, Slice* result,
+                                         char* scratch) const {
+  const uint64_t aligned_offset = TruncateToPageBoundary(kDirectIOAlignment, offset);
+  const size_t offset_in_buffer = static_cast<size_t>(offset - aligned_offset);
+  const size_t aligned_size = Roundup(offset_in_buffer + n, kDirectIOAlignment);
+  AlignedBuffer buffer;
+  buffer.Alignment(kDirectIOAlignment);
+  buffer.AllocateNewBuffer(aligned_size);
+
+  ssize_t r = -1;
+  size_t left = aligned_size;
+  uint64_t read_offset = aligned_offset;
+  char* ptr = buffer.Destination();
+  while (left > 0) {
+    r = pread(fd_, ptr, left, static_cast<off_t>(read_offset));
+
+    if (r <= 0) {
+      if (r < 0 && errno == EINTR) {
+        continue;
+      }
+      break;
+    }
+    ptr += r;
+    read_offset += r;
+    left -= r;
+    if (r % kDirectIOAlignment != 0) {
+      // Only the last page of the file could be partial, so we reached the end of it.
+      break;
+    }
+  }
+
+  if (r < 0) {
+    *result = Slice(scratch, static_cast<size_t>(0));
+    return STATUS_IO_ERROR(filename_, errno);
+  }
+  const size_t bytes_read = aligned_size - left;
+  IOSTATS_ADD(direct_bytes_read, bytes_read);
+  const size_t available =
+      bytes_read > offset_in_buffer ? std::min(bytes_read - offset_in_buffer, n) : 0;
+  memcpy(scratch, buffer.BufferStart() + offset_in_buffer, available);
+  *result = Slice(scratch, available);
+  return Status::OK();
+}
+
+Status PosixRandomAccessFile::MultiRead(ReadRequest* requests, size_t num_requests) const {
+  if (use_direct_io_) {
+    // Batched reads go directly into scratch buffers of the requests, which are not aligned.
+    return RandomAccessFile::MultiRead(requests, num_requests);
+  }
+#ifdef ROCKSDB_IO_URING_PRESENT
+  IoUring* ring =
+      FLAGS_rocksdb_use_io_uring && num_requests > 1 ? IoUring::ForCurrentThread() : nullptr;
+  if (ring != nullptr) {
+    std::vector<int> results(num_requests, IoUring::kNotSubmitted);
+    ring->Read(fd_, requests, num_requests, &results);
+    for (size_t i = 0; i != num_requests; ++i) {
+      auto& request = requests[i];
+      const int res = results[i];
+      if (res == IoUring::kNotSubmitted || res == -EINTR || res == -EAGAIN) {
+        request.status = Read(request.offset, request.n, &request.result, request.scratch);
+        continue;
+      }
+      if (res < 0) {
+        request.result = Slice(request.scratch, static_cast<size_t>(0));
+        request.status = STATUS_IO_ERROR(filename_, -res);
+        continue;
+      }
+      request.result = Slice(request.scratch, res);
+      request.status = Status::OK();
+      if (res > 0 && static_cast<size_t>(res) < request.n) {
+        // Short read, the rest is read synchronously, stopping at the end of the file.
+        Slice rest;
+        request.status = Read(request.offset + res, request.n - res, &rest, request.scratch + res);
+        request.result = Slice(request.scratch, res + rest.size());
+      }
+    }
+    if (!use_os_buffer_) {
+      Fadvise(fd_, 0, 0, POSIX_FADV_DONTNEED);  // free OS pages
+    }
+    return Status::OK();
+  }
+#endif // ROCKSDB_IO_URING_PRESENT
+  return RandomAccessFile::MultiRead(requests, num_requests);
+}
+
+Status PosixRandomAccessFile::Prefetch(uint64_t offset, size_t n) const {
+  if (use_direct_io_) {
+    // Prefetching into the page cache is pointless when reads bypass it.
+    return RandomAccessFile::Prefetch(offset, n);
+  }
+#ifdef OS_LINUX
+  if (readahead(fd_, offset, n) != 0) {
+    return STATUS_IO_ERROR(filename_, errno);
+  }
+  return Status::OK();
+#else
+  return RandomAccessFile::Prefetch(offset, n);
+#endif
+}
+
 #ifdef OS_LINUX
 size_t PosixRandomAccessFile::GetUniqueId(char* id, size_t max_size) const {
   return GetUniqueIdFromFile(fd_, id, max_size);
@@ -516,8 +797,9 @@ Status PosixMmapFile::Allocate(uint64_t offset, uint64_t len) {
  * Use posix write to write data to a file.
  */
 PosixWritableFile::PosixWritableFile(const std::string& fname, int fd,
-                                     const EnvOptions& options)
-    : filename_(fname), fd_(fd), filesize_(0) {
+                                     const EnvOptions& options, bool drop_cache_on_sync)
+    : filename_(fname), fd_(fd), filesize_(0), use_direct_io_(options.use_direct_writes),
+      drop_cache_on_sync_(drop_cache_on_sync) {
 #ifdef ROCKSDB_FALLOCATE_PRESENT
   allow_fallocate_ = options.allow_fallocate;
   fallocate_with_keep_size_ = options.fallocate_with_keep_size;
@@ -549,6 +831,40 @@ Status PosixWritableFile::Append(const Slice& data) {
   return Status::OK();
 }
 
+Status PosixWritableFile::PositionedAppend(const Slice& data, uint64_t offset) {
+  assert(use_direct_io_);
+  assert(offset % kDirectIOAlignment == 0);
+  assert(data.size() % kDirectIOAlignment == 0);
+  const char* src = data.cdata();
+  size_t left = data.size();
+  while (left != 0) {
+    ssize_t done = pwrite(fd_, src, left, static_cast<off_t>(offset));
+    if (done < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return STATUS_IO_ERROR(filename_, errno);
+    }
+    left -= done;
+    src += done;
+    offset += done;
+  }
+  filesize_ = std::max(filesize_, offset);
+  IOSTATS_ADD(direct_bytes_written, data.size());
+  return Status::OK();
+}
+
+Status PosixWritableFile::Truncate(uint64_t size) {
+  if (!use_direct_io_) {
+    return Status::OK();
+  }
+  if (ftruncate(fd_, static_cast<off_t>(size)) != 0) {
+    return STATUS_IO_ERROR(filename_, errno);
+  }
+  filesize_ = size;
+  return Status::OK();
+}
+
 Status PosixWritableFile::Close() {
   Status s;
 
@@ -595,6 +911,9 @@ Status PosixWritableFile::Sync() {
   if (fdatasync(fd_) < 0) {
     return STATUS_IO_ERROR(filename_, errno);
   }
+  if (drop_cache_on_sync_) {
+    Fadvise(fd_, 0, 0, POSIX_FADV_DONTNEED);  // free OS pages
+  }
   return Status::OK();
 }
 
@@ -602,6 +921,9 @@ Status PosixWritableFile::Fsync() {
   if (fsync(fd_) < 0) {
     return STATUS_IO_ERROR(filename_, errno);
   }
+  if (drop_cache_on_sync_) {
+    Fadvise(fd_, 0, 0, POSIX_FADV_DONTNEED);  // free OS pages
+  }
   return Status::OK();
 }
 
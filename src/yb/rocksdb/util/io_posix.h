@@ -41,6 +41,9 @@ namespace rocksdb {
 
 #define STATUS_IO_ERROR(context, err_number) STATUS(IOError, (context), strerror(err_number))
 
+// Alignment of the file offsets, sizes and buffers of the reads and writes done through O_DIRECT.
+constexpr size_t kDirectIOAlignment = 4096;
+
 class PosixSequentialFile : public SequentialFile {
  private:
   std::string filename_;
@@ -63,6 +66,11 @@ class PosixRandomAccessFile : public RandomAccessFile {
   std::string filename_;
   int fd_;
   bool use_os_buffer_;
+  // True if fd_ was opened with O_DIRECT, so reads have to be aligned.
+  bool use_direct_io_;
+
+  // Reads through an aligned buffer the aligned range that covers [offset, offset + n).
+  Status DirectRead(uint64_t offset, size_t n, Slice* result, char* scratch) const;
 
  public:
   PosixRandomAccessFile(const std::string& fname, int fd,
@@ -71,6 +79,8 @@ class PosixRandomAccessFile : public RandomAccessFile {
 
   virtual Status Read(uint64_t offset, size_t n, Slice* result,
                       char* scratch) const override;
+  virtual Status MultiRead(ReadRequest* requests, size_t num_requests) const override;
+  virtual Status Prefetch(uint64_t offset, size_t n) const override;
 #ifdef OS_LINUX
   virtual size_t GetUniqueId(char* id, size_t max_size) const override;
 #endif
@@ -83,6 +93,11 @@ class PosixWritableFile : public WritableFile {
   const std::string filename_;
   int fd_;
   uint64_t filesize_;
+  // True if fd_ was opened with O_DIRECT, so writes have to be aligned and positional.
+  const bool use_direct_io_;
+  // True if written pages should be dropped from the OS page cache once they are synced. Used when
+  // direct I/O was requested but is not supported by the file system.
+  const bool drop_cache_on_sync_;
 #ifdef ROCKSDB_FALLOCATE_PRESENT
   bool allow_fallocate_;
   bool fallocate_with_keep_size_;
@@ -90,14 +105,19 @@ class PosixWritableFile : public WritableFile {
 
  public:
   PosixWritableFile(const std::string& fname, int fd,
-                    const EnvOptions& options);
+                    const EnvOptions& options, bool drop_cache_on_sync = false);
   ~PosixWritableFile();
 
-  // Means Close() will properly take care of truncate
-  // and it does not need any additional information
-  virtual Status Truncate(uint64_t size) override { return Status::OK(); }
+  virtual bool UseOSBuffer() const override { return !use_direct_io_; }
+  virtual bool UseDirectIO() const override { return use_direct_io_; }
+  virtual size_t GetRequiredBufferAlignment() const override { return kDirectIOAlignment; }
+
+  // With buffered I/O Close() will properly take care of truncate and it does not need any
+  // additional information. With direct I/O the padding of the last page has to be cut off.
+  virtual Status Truncate(uint64_t size) override;
   virtual Status Close() override;
   virtual Status Append(const Slice& data) override;
+  virtual Status PositionedAppend(const Slice& data, uint64_t offset) override;
   virtual Status Flush() override;
   virtual Status Sync() override;
   virtual Status Fsync() override;
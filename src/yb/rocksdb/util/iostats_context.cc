@@ -36,6 +36,8 @@ void IOStatsContext::Reset() {
   thread_pool_id = Env::Priority::TOTAL;
   bytes_read = 0;
   bytes_written = 0;
+  direct_bytes_read = 0;
+  direct_bytes_written = 0;
   open_nanos = 0;
   allocate_nanos = 0;
   write_nanos = 0;
@@ -56,6 +58,8 @@ std::string IOStatsContext::ToString(bool exclude_zero_counters) const {
   IOSTATS_CONTEXT_OUTPUT(thread_pool_id);
   IOSTATS_CONTEXT_OUTPUT(bytes_read);
   IOSTATS_CONTEXT_OUTPUT(bytes_written);
+  IOSTATS_CONTEXT_OUTPUT(direct_bytes_read);
+  IOSTATS_CONTEXT_OUTPUT(direct_bytes_written);
   IOSTATS_CONTEXT_OUTPUT(open_nanos);
   IOSTATS_CONTEXT_OUTPUT(allocate_nanos);
   IOSTATS_CONTEXT_OUTPUT(write_nanos);
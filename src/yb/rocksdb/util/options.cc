@@ -79,6 +79,8 @@ ImmutableCFOptions::ImmutableCFOptions(const Options& options)
       allow_mmap_reads(options.allow_mmap_reads),
       allow_mmap_writes(options.allow_mmap_writes),
       db_paths(options.db_paths),
+      compaction_output_path_selector(options.compaction_output_path_selector),
+      expired_files_selector(options.expired_files_selector),
       memtable_factory(options.memtable_factory.get()),
       table_factory(options.table_factory.get()),
       table_properties_collector_factories(
@@ -92,6 +94,9 @@ ImmutableCFOptions::ImmutableCFOptions(const Options& options)
       compression(options.compression),
       compression_per_level(options.compression_per_level),
       compression_opts(options.compression_opts),
+      large_compaction_threshold_bytes(options.large_compaction_threshold_bytes),
+      large_compaction_compression(options.large_compaction_compression),
+      large_compaction_compression_opts(options.large_compaction_compression_opts),
       level_compaction_dynamic_level_bytes(
           options.level_compaction_dynamic_level_bytes),
       access_hint_on_compaction_start(options.access_hint_on_compaction_start),
@@ -115,6 +120,8 @@ ColumnFamilyOptions::ColumnFamilyOptions()
       max_write_buffer_number_to_maintain(0),
       compression(Snappy_Supported() && FLAGS_enable_ondisk_compression ?
                   kSnappyCompression : kNoCompression),
+      large_compaction_threshold_bytes(0),
+      large_compaction_compression(kZlibCompression),
       prefix_extractor(nullptr),
       num_levels(7),
       level0_file_num_compaction_trigger(4),
@@ -174,6 +181,9 @@ ColumnFamilyOptions::ColumnFamilyOptions(const Options& options)
       compression(options.compression),
       compression_per_level(options.compression_per_level),
       compression_opts(options.compression_opts),
+      large_compaction_threshold_bytes(options.large_compaction_threshold_bytes),
+      large_compaction_compression(options.large_compaction_compression),
+      large_compaction_compression_opts(options.large_compaction_compression_opts),
       prefix_extractor(options.prefix_extractor),
       num_levels(options.num_levels),
       level0_file_num_compaction_trigger(
@@ -274,6 +284,7 @@ DBOptions::DBOptions()
       allow_os_buffer(true),
       allow_mmap_reads(false),
       allow_mmap_writes(false),
+      use_direct_io_for_flush_and_compaction(false),
       allow_fallocate(true),
       is_fd_close_on_exec(true),
       skip_log_error_on_recovery(false),
@@ -351,6 +362,8 @@ void DBOptions::Dump(Logger* log) const {
       max_background_compactions);
   RHEADER(log, "                     Options.max_subcompactions: %" PRIu32,
       max_subcompactions);
+  RHEADER(log, "                 Options.min_subcompaction_size: %" PRIu64,
+      min_subcompaction_size);
   RHEADER(log, "                 Options.max_background_flushes: %d",
       max_background_flushes);
   RHEADER(log, "                        Options.WAL_ttl_seconds: %" PRIu64,
@@ -366,6 +379,8 @@ void DBOptions::Dump(Logger* log) const {
       allow_mmap_reads);
   RHEADER(log, "                       Options.allow_mmap_writes: %d",
       allow_mmap_writes);
+  RHEADER(log, "  Options.use_direct_io_for_flush_and_compaction: %d",
+      use_direct_io_for_flush_and_compaction);
   RHEADER(log, "                     Options.is_fd_close_on_exec: %d",
       is_fd_close_on_exec);
   RHEADER(log, "                   Options.stats_dump_period_sec: %u",
@@ -466,6 +481,20 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
       compression_opts.level);
   RHEADER(log, "              Options.compression_opts.strategy: %d",
       compression_opts.strategy);
+  RHEADER(log, "        Options.compression_opts.max_dict_bytes: %" PRIu32,
+      compression_opts.max_dict_bytes);
+  RHEADER(log, "      Options.compression_opts.dict_train_bytes: %" PRIu32,
+      compression_opts.dict_train_bytes);
+  if (large_compaction_threshold_bytes > 0) {
+    RHEADER(log, "      Options.large_compaction_threshold_bytes: %" PRIu64,
+        large_compaction_threshold_bytes);
+    RHEADER(log, "          Options.large_compaction_compression: %s",
+        CompressionTypeToString(large_compaction_compression).c_str());
+    RHEADER(log, "  Options.large_compaction_compression_opts.level: %d",
+        large_compaction_compression_opts.level);
+    RHEADER(log, " Options.large_compaction_compression_opts.max_dict_bytes: %" PRIu32,
+        large_compaction_compression_opts.max_dict_bytes);
+  }
   RHEADER(log, "     Options.level0_file_num_compaction_trigger: %d",
       level0_file_num_compaction_trigger);
   RHEADER(log, "         Options.level0_slowdown_writes_trigger: %d",
@@ -529,6 +558,12 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
   RHEADER(log,
       "Options.compaction_options_universal.compression_size_percent: %d",
       compaction_options_universal.compression_size_percent);
+  RHEADER(log,
+      "Options.compaction_options_universal.read_amp_compaction_trigger: %u",
+      compaction_options_universal.read_amp_compaction_trigger);
+  RHEADER(log,
+      "Options.compaction_options_universal.read_amp_compaction_min_reads: %" PRIu64,
+      compaction_options_universal.read_amp_compaction_min_reads);
   RHEADER(log,
       "Options.compaction_options_fifo.max_table_files_size: %" PRIu64,
       compaction_options_fifo.max_table_files_size);
@@ -272,6 +272,33 @@ bool ParseVectorCompressionType(
   return true;
 }
 
+// Parses "window_bits:level:strategy[:max_dict_bytes[:dict_train_bytes]]".
+bool ParseCompressionOptions(const std::string& value, CompressionOptions* compression_opts) {
+  std::vector<std::string> fields;
+  size_t start = 0;
+  while (true) {
+    size_t end = value.find(':', start);
+    fields.push_back(value.substr(start, end == std::string::npos ? end : end - start));
+    if (end == std::string::npos) {
+      break;
+    }
+    start = end + 1;
+  }
+  if (fields.size() < 3 || fields.size() > 5 || fields.back().empty()) {
+    return false;
+  }
+  compression_opts->window_bits = ParseInt(fields[0]);
+  compression_opts->level = ParseInt(fields[1]);
+  compression_opts->strategy = ParseInt(fields[2]);
+  if (fields.size() > 3) {
+    compression_opts->max_dict_bytes = ParseUint32(fields[3]);
+  }
+  if (fields.size() > 4) {
+    compression_opts->dict_train_bytes = ParseUint32(fields[4]);
+  }
+  return true;
+}
+
 bool ParseSliceTransformHelper(
     const std::string& kFixedPrefixName, const std::string& kCappedPrefixName,
     const std::string& value,
@@ -803,29 +830,15 @@ Status ParseColumnFamilyOption(const std::string& name,
       }
       new_options->memtable_factory.reset(new_mem_factory.release());
     } else if (name == "compression_opts") {
-      size_t start = 0;
-      size_t end = value.find(':');
-      if (end == std::string::npos) {
-        return STATUS(InvalidArgument,
-            "unable to parse the specified CF option " + name);
-      }
-      new_options->compression_opts.window_bits =
-          ParseInt(value.substr(start, end - start));
-      start = end + 1;
-      end = value.find(':', start);
-      if (end == std::string::npos) {
+      if (!ParseCompressionOptions(value, &new_options->compression_opts)) {
         return STATUS(InvalidArgument,
             "unable to parse the specified CF option " + name);
       }
-      new_options->compression_opts.level =
-          ParseInt(value.substr(start, end - start));
-      start = end + 1;
-      if (start >= value.size()) {
+    } else if (name == "large_compaction_compression_opts") {
+      if (!ParseCompressionOptions(value, &new_options->large_compaction_compression_opts)) {
         return STATUS(InvalidArgument,
             "unable to parse the specified CF option " + name);
       }
-      new_options->compression_opts.strategy =
-          ParseInt(value.substr(start, value.size() - start));
     } else if (name == "compaction_options_fifo") {
       new_options->compaction_options_fifo.max_table_files_size =
           ParseUint64(value);
@@ -188,6 +188,9 @@ static std::unordered_map<std::string, OptionTypeInfo> db_options_type_info = {
     {"allow_os_buffer",
      {offsetof(struct DBOptions, allow_os_buffer), OptionType::kBoolean,
       OptionVerificationType::kNormal}},
+    {"use_direct_io_for_flush_and_compaction",
+     {offsetof(struct DBOptions, use_direct_io_for_flush_and_compaction),
+      OptionType::kBoolean, OptionVerificationType::kNormal}},
     {"create_if_missing",
      {offsetof(struct DBOptions, create_if_missing), OptionType::kBoolean,
       OptionVerificationType::kNormal}},
@@ -344,6 +347,9 @@ static std::unordered_map<std::string, OptionTypeInfo> db_options_type_info = {
     {"max_file_size_for_compaction",
      {offsetof(struct DBOptions, max_file_size_for_compaction),
       OptionType::kUInt64T, OptionVerificationType::kNormal}},
+    {"min_subcompaction_size",
+     {offsetof(struct DBOptions, min_subcompaction_size),
+      OptionType::kUInt64T, OptionVerificationType::kNormal}},
 };
 
 static std::unordered_map<std::string, OptionTypeInfo> cf_options_type_info = {
@@ -351,6 +357,7 @@ static std::unordered_map<std::string, OptionTypeInfo> cf_options_type_info = {
     CompactionOptionsFIFO compaction_options_fifo;
     CompactionOptionsUniversal compaction_options_universal;
     CompressionOptions compression_opts;
+    CompressionOptions large_compaction_compression_opts;
     TablePropertiesCollectorFactories table_properties_collector_factories;
     typedef std::vector<std::shared_ptr<TablePropertiesCollectorFactory>>
         TablePropertiesCollectorFactories;
@@ -485,6 +492,12 @@ static std::unordered_map<std::string, OptionTypeInfo> cf_options_type_info = {
     {"compression_per_level",
      {offsetof(struct ColumnFamilyOptions, compression_per_level),
       OptionType::kVectorCompressionType, OptionVerificationType::kNormal}},
+    {"large_compaction_threshold_bytes",
+     {offsetof(struct ColumnFamilyOptions, large_compaction_threshold_bytes),
+      OptionType::kUInt64T, OptionVerificationType::kNormal}},
+    {"large_compaction_compression",
+     {offsetof(struct ColumnFamilyOptions, large_compaction_compression),
+      OptionType::kCompressionType, OptionVerificationType::kNormal}},
     {"comparator",
      {offsetof(struct ColumnFamilyOptions, comparator), OptionType::kComparator,
       OptionVerificationType::kByName}},
@@ -522,6 +535,27 @@ static std::unordered_map<std::string,
     {"cache_index_and_filter_blocks",
      {offsetof(struct BlockBasedTableOptions, cache_index_and_filter_blocks),
       OptionType::kBoolean, OptionVerificationType::kNormal}},
+    {"pin_top_level_index",
+     {offsetof(struct BlockBasedTableOptions, pin_top_level_index),
+      OptionType::kBoolean, OptionVerificationType::kNormal}},
+    {"index_and_filter_blocks_in_multi_touch_cache",
+     {offsetof(struct BlockBasedTableOptions, index_and_filter_blocks_in_multi_touch_cache),
+      OptionType::kBoolean, OptionVerificationType::kNormal}},
+    {"scan_prefetch_data_blocks",
+     {offsetof(struct BlockBasedTableOptions, scan_prefetch_data_blocks),
+      OptionType::kSizeT, OptionVerificationType::kNormal}},
+    {"max_auto_readahead_size",
+     {offsetof(struct BlockBasedTableOptions, max_auto_readahead_size),
+      OptionType::kSizeT, OptionVerificationType::kNormal}},
+    {"num_sequential_reads_for_auto_readahead",
+     {offsetof(struct BlockBasedTableOptions, num_sequential_reads_for_auto_readahead),
+      OptionType::kSizeT, OptionVerificationType::kNormal}},
+    {"data_block_max_restart_interval",
+     {offsetof(struct BlockBasedTableOptions, data_block_max_restart_interval),
+      OptionType::kInt, OptionVerificationType::kNormal}},
+    {"data_block_hash_index",
+     {offsetof(struct BlockBasedTableOptions, data_block_hash_index),
+      OptionType::kBoolean, OptionVerificationType::kNormal}},
     {"index_type",
      {offsetof(struct BlockBasedTableOptions, index_type),
       OptionType::kBlockBasedTableIndexType, OptionVerificationType::kNormal}},
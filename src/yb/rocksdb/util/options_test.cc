@@ -128,6 +128,7 @@ TEST_F(OptionsTest, GetOptionsFromMapTest) {
        "kLZ4HCCompression:"
        "kZSTDNotFinalCompression"},
       {"compression_opts", "4:5:6"},
+      {"large_compaction_compression_opts", "4:5:6:16384:1048576"},
       {"num_levels", "7"},
       {"level0_file_num_compaction_trigger", "8"},
       {"level0_slowdown_writes_trigger", "9"},
@@ -190,6 +191,7 @@ TEST_F(OptionsTest, GetOptionsFromMapTest) {
       {"allow_os_buffer", "false"},
       {"allow_mmap_reads", "true"},
       {"allow_mmap_writes", "false"},
+      {"use_direct_io_for_flush_and_compaction", "true"},
       {"is_fd_close_on_exec", "true"},
       {"skip_log_error_on_recovery", "false"},
       {"stats_dump_period_sec", "46"},
@@ -223,6 +225,12 @@ TEST_F(OptionsTest, GetOptionsFromMapTest) {
   ASSERT_EQ(new_cf_opt.compression_opts.window_bits, 4);
   ASSERT_EQ(new_cf_opt.compression_opts.level, 5);
   ASSERT_EQ(new_cf_opt.compression_opts.strategy, 6);
+  ASSERT_EQ(new_cf_opt.compression_opts.max_dict_bytes, 0U);
+  ASSERT_EQ(new_cf_opt.large_compaction_compression_opts.window_bits, 4);
+  ASSERT_EQ(new_cf_opt.large_compaction_compression_opts.level, 5);
+  ASSERT_EQ(new_cf_opt.large_compaction_compression_opts.strategy, 6);
+  ASSERT_EQ(new_cf_opt.large_compaction_compression_opts.max_dict_bytes, 16384U);
+  ASSERT_EQ(new_cf_opt.large_compaction_compression_opts.dict_train_bytes, 1048576U);
   ASSERT_EQ(new_cf_opt.num_levels, 7);
   ASSERT_EQ(new_cf_opt.level0_file_num_compaction_trigger, 8);
   ASSERT_EQ(new_cf_opt.level0_slowdown_writes_trigger, 9);
@@ -302,6 +310,7 @@ TEST_F(OptionsTest, GetOptionsFromMapTest) {
   ASSERT_EQ(new_db_opt.allow_os_buffer, false);
   ASSERT_EQ(new_db_opt.allow_mmap_reads, true);
   ASSERT_EQ(new_db_opt.allow_mmap_writes, false);
+  ASSERT_EQ(new_db_opt.use_direct_io_for_flush_and_compaction, true);
   ASSERT_EQ(new_db_opt.is_fd_close_on_exec, true);
   ASSERT_EQ(new_db_opt.skip_log_error_on_recovery, false);
   ASSERT_EQ(new_db_opt.stats_dump_period_sec, 46U);
@@ -1624,7 +1633,10 @@ Status GetFromString(BlockBasedTableOptions* source, BlockBasedTableOptions* des
       "index_block_restart_interval=4;index_block_size=16384;min_keys_per_index_block=16;"
       "filter_policy=bloomfilter:4:true;whole_key_filtering=1;"
       "skip_table_builder_flush=1;format_version=1;"
-      "hash_index_allow_collision=false;";
+      "hash_index_allow_collision=false;pin_top_level_index=1;"
+      "index_and_filter_blocks_in_multi_touch_cache=1;scan_prefetch_data_blocks=8;"
+      "max_auto_readahead_size=262144;num_sequential_reads_for_auto_readahead=3;"
+      "data_block_max_restart_interval=32;data_block_hash_index=1;";
 
   RETURN_NOT_OK(GetBlockBasedTableOptionsFromString(*source, kOptionsString, destination));
 
@@ -1681,6 +1693,7 @@ Status GetFromString(DBOptions* source, DBOptions* destination) {
       "delayed_write_rate=4294976214;"
       "manifest_preallocation_size=1222;"
       "allow_mmap_writes=true;"
+      "use_direct_io_for_flush_and_compaction=false;"
       "stats_dump_period_sec=70127;"
       "allow_fallocate=true;"
       "allow_mmap_reads=true;"
@@ -1695,6 +1708,7 @@ Status GetFromString(DBOptions* source, DBOptions* destination) {
       "write_thread_max_yield_usec=1000;"
       "access_hint_on_compaction_start=NONE;"
       "max_file_size_for_compaction=123;"
+      "min_subcompaction_size=4321;"
       "initial_seqno=432;"
       "num_reserved_small_compaction_threads=-1;"
       "compaction_size_threshold_bytes=18446744073709551615;"
@@ -1719,6 +1733,8 @@ Status GetFromString(ColumnFamilyOptions* source, ColumnFamilyOptions* destinati
       "compression_per_level=kBZip2Compression:kBZip2Compression:"
       "kBZip2Compression:kNoCompression:kZlibCompression:kBZip2Compression:"
       "kSnappyCompression;"
+      "large_compaction_threshold_bytes=5184;"
+      "large_compaction_compression=kZlibCompression;"
       "max_bytes_for_level_base=986;"
       "bloom_locality=8016;"
       "target_file_size_base=4294976376;"
@@ -1769,6 +1785,7 @@ Status GetFromString(ColumnFamilyOptions* source, ColumnFamilyOptions* destinati
   destination->compaction_pri = CompactionPri::kOldestSmallestSeqFirst;
   destination->compaction_options_universal = CompactionOptionsUniversal();
   destination->compression_opts = CompressionOptions();
+  destination->large_compaction_compression_opts = CompressionOptions();
   destination->hard_rate_limit = 0;
   destination->soft_rate_limit = 0;
   destination->compaction_options_fifo = CompactionOptionsFIFO();
@@ -1889,6 +1906,7 @@ TEST_F(OptionsParserTest, BlockBasedTableOptionsAllFieldsSettable) {
       BLACKLIST_ENTRY(BlockBasedTableOptions, flush_block_policy_factory),
       BLACKLIST_ENTRY(BlockBasedTableOptions, block_cache),
       BLACKLIST_ENTRY(BlockBasedTableOptions, block_cache_compressed),
+      BLACKLIST_ENTRY(BlockBasedTableOptions, data_block_key_group_extractor),
       BLACKLIST_ENTRY(BlockBasedTableOptions, filter_policy),
   };
 
@@ -1923,6 +1941,7 @@ TEST_F(OptionsParserTest, DBOptionsAllFieldsSettable) {
       BLACKLIST_ENTRY(DBOptions, row_cache),
       BLACKLIST_ENTRY(DBOptions, wal_filter),
       BLACKLIST_ENTRY(DBOptions, boundary_extractor),
+      BLACKLIST_ENTRY(DBOptions, subcompaction_key_group_extractor),
       BLACKLIST_ENTRY(DBOptions, mem_table_flush_filter_factory),
       BLACKLIST_ENTRY(DBOptions, log_prefix),
       BLACKLIST_ENTRY(DBOptions, mem_tracker),
@@ -72,6 +72,9 @@ void PerfContext::Reset() {
   bloom_memtable_miss_count = 0;
   bloom_sst_hit_count = 0;
   bloom_sst_miss_count = 0;
+  iter_seek_count = 0;
+  iter_next_count = 0;
+  iter_prev_count = 0;
 #endif
 }
 
@@ -123,6 +126,9 @@ std::string PerfContext::ToString(bool exclude_zero_counters) const {
   PERF_CONTEXT_OUTPUT(bloom_memtable_miss_count);
   PERF_CONTEXT_OUTPUT(bloom_sst_hit_count);
   PERF_CONTEXT_OUTPUT(bloom_sst_miss_count);
+  PERF_CONTEXT_OUTPUT(iter_seek_count);
+  PERF_CONTEXT_OUTPUT(iter_next_count);
+  PERF_CONTEXT_OUTPUT(iter_prev_count);
   return ss.str();
 #endif
 }
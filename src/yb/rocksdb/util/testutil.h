@@ -28,6 +28,7 @@
 #include <algorithm>
 #include <deque>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "yb/rocksdb/compaction_filter.h"
@@ -274,15 +275,24 @@ class StringSource: public RandomAccessFile {
     return static_cast<size_t>(rid-id);
   }
 
+  virtual Status Prefetch(uint64_t offset, size_t n) const override {
+    prefetches_.emplace_back(offset, n);
+    return Status::OK();
+  }
+
   int total_reads() const { return total_reads_; }
 
   void set_total_reads(int tr) { total_reads_ = tr; }
 
+  // Offsets and sizes of the ranges passed to Prefetch.
+  const std::vector<std::pair<uint64_t, size_t>>& prefetches() const { return prefetches_; }
+
  private:
   std::string contents_;
   uint64_t uniq_id_;
   bool mmap_;
   mutable int total_reads_;
+  mutable std::vector<std::pair<uint64_t, size_t>> prefetches_;
 };
 
 class NullLogger : public Logger {
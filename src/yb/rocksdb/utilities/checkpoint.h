@@ -23,11 +23,13 @@
 #ifndef ROCKSDB_LITE
 
 #include <string>
+#include <vector>
 #include "yb/rocksdb/status.h"
 
 namespace rocksdb {
 
 class DB;
+class Env;
 
 namespace checkpoint {
 
@@ -40,6 +42,15 @@ namespace checkpoint {
   // The directory will be an absolute path
   CHECKED_STATUS CreateCheckpoint(DB* db, const std::string& checkpoint_dir);
 
+  // Lists the names of the files of checkpoint_dir that are not in base_checkpoint_dir, a
+  // checkpoint of the same DB created earlier, so that an incremental backup only has to upload
+  // those. Table files are immutable and their numbers are never reused, so a table file is only
+  // new when the base checkpoint does not have it. The other files are always listed.
+  // Subdirectories are skipped. An empty base_checkpoint_dir lists all the files.
+  CHECKED_STATUS ListNewFiles(
+      Env* env, const std::string& checkpoint_dir, const std::string& base_checkpoint_dir,
+      std::vector<std::string>* new_files);
+
 }  // namespace checkpoint
 }  // namespace rocksdb
 #endif  // !ROCKSDB_LITE
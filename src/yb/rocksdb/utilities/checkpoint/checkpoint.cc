@@ -43,6 +43,22 @@
 namespace rocksdb {
 namespace checkpoint {
 
+namespace {
+
+// Returns the directory of the DB path that contains the table file with the given name, which has
+// a leading "/".
+std::string TableFileDir(DB* db, const std::string& fname) {
+  const auto& db_paths = db->GetDBOptions().db_paths;
+  for (size_t i = 1; i < db_paths.size(); ++i) {
+    if (db->GetEnv()->FileExists(db_paths[i].path + fname).ok()) {
+      return db_paths[i].path;
+    }
+  }
+  return db->GetName();
+}
+
+} // namespace
+
 // Builds an openable snapshot of RocksDB on the same disk, which
 // accepts an output directory on the same disk, and under the directory
 // (1) hard-linked SST files pointing to existing live SST files
@@ -108,20 +124,26 @@ Status CreateCheckpoint(DB* db, const std::string& checkpoint_dir) {
     // * if it's kTableFile or kTableSBlockFile, then it's shared
     // * if it's kDescriptorFile, limit the size to manifest_file_size
     // * always copy if cross-device link
+    // Table files of all DB paths are put into the checkpoint directory. When the checkpoint is
+    // opened with the same DB paths, they are moved back to their paths.
     bool is_table_file = type == kTableFile || type == kTableSBlockFile;
-    if (is_table_file && same_fs) {
+    const std::string src_dir = is_table_file ? TableFileDir(db, src_fname) : db->GetName();
+    // Files of other DB paths are usually on other devices, so do not give up linking files of the
+    // first path when they could not be linked.
+    bool copy = !is_table_file || !same_fs;
+    if (!copy) {
       RLOG(db->GetOptions().info_log, "Hard Linking %s", src_fname.c_str());
-      s = db->GetEnv()->LinkFile(db->GetName() + src_fname,
-                                 full_private_path + src_fname);
+      s = db->GetEnv()->LinkFile(src_dir + src_fname, full_private_path + src_fname);
       if (s.IsNotSupported()) {
-        same_fs = false;
+        same_fs = same_fs && src_dir != db->GetName();
+        copy = true;
         s = Status::OK();
       }
     }
-    if (!is_table_file || !same_fs) {
+    if (copy) {
       RLOG(db->GetOptions().info_log, "Copying %s", src_fname.c_str());
       std::string dest_name = full_private_path + src_fname;
-      s = CopyFile(db->GetEnv(), db->GetName() + src_fname, dest_name,
+      s = CopyFile(db->GetEnv(), src_dir + src_fname, dest_name,
                    (type == kDescriptorFile) ? manifest_file_size : 0);
     }
   }
@@ -208,6 +230,39 @@ Status CreateCheckpoint(DB* db, const std::string& checkpoint_dir) {
   return s;
 }
 
+Status ListNewFiles(
+    Env* env, const std::string& checkpoint_dir, const std::string& base_checkpoint_dir,
+    std::vector<std::string>* new_files) {
+  std::vector<std::string> children;
+  RETURN_NOT_OK(env->GetChildren(checkpoint_dir, &children));
+  std::sort(children.begin(), children.end());
+  for (const auto& child : children) {
+    uint64_t number;
+    FileType type;
+    if (!ParseFileName(child, &number, &type)) {
+      continue;
+    }
+    if ((type == kTableFile || type == kTableSBlockFile) && !base_checkpoint_dir.empty()) {
+      const std::string base_fname = base_checkpoint_dir + "/" + child;
+      Status s = env->FileExists(base_fname);
+      if (s.ok()) {
+        // Guards against a base checkpoint that was only partially written.
+        uint64_t size = 0;
+        uint64_t base_size = 0;
+        RETURN_NOT_OK(env->GetFileSize(checkpoint_dir + "/" + child, &size));
+        RETURN_NOT_OK(env->GetFileSize(base_fname, &base_size));
+        if (size == base_size) {
+          continue;
+        }
+      } else if (!s.IsNotFound()) {
+        return s;
+      }
+    }
+    new_files->push_back(child);
+  }
+  return Status::OK();
+}
+
 }  // namespace checkpoint
 }  // namespace rocksdb
 
@@ -27,10 +27,12 @@
 #ifndef OS_WIN
 #include <unistd.h>
 #endif
+#include <algorithm>
 #include <iostream>
 #include <thread>
 #include <utility>
 #include "yb/rocksdb/db/db_impl.h"
+#include "yb/rocksdb/db/filename.h"
 #include "yb/rocksdb/port/stack_trace.h"
 #include "yb/rocksdb/db.h"
 #include "yb/rocksdb/env.h"
@@ -281,6 +283,54 @@ TEST_F(DBTest, GetSnapshotLink) {
     dbname_ = test::TmpDir(env_) + "/db_test";
 }
 
+TEST_F(DBTest, ListNewFiles) {
+  const std::string base_name = test::TmpDir(env_) + "/base_snapshot";
+  const std::string snapshot_name = test::TmpDir(env_) + "/snapshot";
+  Options options = CurrentOptions();
+  delete db_;
+  db_ = nullptr;
+  ASSERT_OK(DestroyDB(dbname_, options));
+  ASSERT_OK(DestroyDB(base_name, options));
+  ASSERT_OK(DestroyDB(snapshot_name, options));
+  options.create_if_missing = true;
+  ASSERT_OK(DB::Open(options, dbname_, &db_));
+
+  auto table_files = [](const std::vector<std::string>& files) {
+    std::vector<std::string> result;
+    for (const auto& file : files) {
+      uint64_t number;
+      FileType type;
+      if (ParseFileName(file, &number, &type) && type == kTableFile) {
+        result.push_back(file);
+      }
+    }
+    return result;
+  };
+
+  ASSERT_OK(Put("foo", "v1"));
+  ASSERT_OK(Flush());
+  ASSERT_OK(checkpoint::CreateCheckpoint(db_, base_name));
+  std::vector<std::string> base_files;
+  ASSERT_OK(checkpoint::ListNewFiles(env_, base_name, "", &base_files));
+  ASSERT_EQ(1, table_files(base_files).size());
+
+  ASSERT_OK(Put("bar", "v1"));
+  ASSERT_OK(Flush());
+  ASSERT_OK(checkpoint::CreateCheckpoint(db_, snapshot_name));
+  std::vector<std::string> new_files;
+  ASSERT_OK(checkpoint::ListNewFiles(env_, snapshot_name, base_name, &new_files));
+  // Only the table file of the second flush is new.
+  auto new_table_files = table_files(new_files);
+  ASSERT_EQ(1, new_table_files.size());
+  ASSERT_NE(table_files(base_files)[0], new_table_files[0]);
+  ASSERT_NE(new_files.end(), std::find(new_files.begin(), new_files.end(), "CURRENT"));
+
+  delete db_;
+  db_ = nullptr;
+  ASSERT_OK(DestroyDB(base_name, options));
+  ASSERT_OK(DestroyDB(snapshot_name, options));
+}
+
 TEST_F(DBTest, CheckpointCF) {
   Options options = CurrentOptions();
   CreateAndReopenWithCF({"one", "two", "three", "four", "five"}, options);
@@ -0,0 +1,175 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/rpc/compression.h"
+
+#include <lz4.h>
+
+#include <gflags/gflags.h>
+#include <google/protobuf/io/coded_stream.h>
+
+#include "yb/gutil/strings/substitute.h"
+
+#include "yb/rpc/rpc_metrics.h"
+#include "yb/rpc/serialization.h"
+
+#include "yb/util/flag_tags.h"
+#include "yb/util/monotime.h"
+#include "yb/util/net/sockaddr.h"
+#include "yb/util/ref_cnt_buffer.h"
+#include "yb/util/size_literals.h"
+
+using namespace yb::size_literals;
+
+DEFINE_string(rpc_compression_policy, "never",
+              "When to compress RPC messages to peers that accept it: never, always, or "
+              "other_subnets, to compress only messages to peers outside the subnet of the local "
+              "address, e.g. in other zones.");
+TAG_FLAG(rpc_compression_policy, advanced);
+
+DEFINE_int32(rpc_compression_min_bytes, 4_KB,
+             "RPC messages smaller than this are not compressed.");
+TAG_FLAG(rpc_compression_min_bytes, advanced);
+
+DEFINE_int32(rpc_compression_subnet_prefix_length, 24,
+             "Length of the IPv4 network prefix used by the other_subnets compression policy. "
+             "For IPv6 addresses the first 64 bits are compared.");
+TAG_FLAG(rpc_compression_subnet_prefix_length, advanced);
+
+namespace yb {
+namespace rpc {
+
+namespace {
+
+bool SameSubnet(const IpAddress& lhs, const IpAddress& rhs) {
+  if (lhs.is_v4() && rhs.is_v4()) {
+    const int bits = std::max(0, std::min(FLAGS_rpc_compression_subnet_prefix_length, 32));
+    const uint32_t mask = bits == 0 ? 0 : ~0U << (32 - bits);
+    return (lhs.to_v4().to_ulong() & mask) == (rhs.to_v4().to_ulong() & mask);
+  }
+  if (lhs.is_v6() && rhs.is_v6()) {
+    const auto lhs_bytes = lhs.to_v6().to_bytes();
+    const auto rhs_bytes = rhs.to_v6().to_bytes();
+    return std::equal(lhs_bytes.begin(), lhs_bytes.begin() + 8, rhs_bytes.begin());
+  }
+  return false;
+}
+
+void IncrementCounterBy(
+    RpcMetrics* metrics, scoped_refptr<Counter> RpcMetrics::*counter, int64_t amount) {
+  if (metrics && metrics->*counter) {
+    (metrics->*counter)->IncrementBy(amount);
+  }
+}
+
+} // namespace
+
+RpcCompressionPB AcceptedCompression() {
+  return FLAGS_rpc_compression_policy == "never" ? RPC_COMPRESSION_NONE : RPC_COMPRESSION_LZ4;
+}
+
+RpcCompressionPB CompressionForPeer(
+    RpcCompressionPB peer_accepted, const Endpoint& local, const Endpoint& remote) {
+  return CompressionForPeer(FLAGS_rpc_compression_policy, peer_accepted, local, remote);
+}
+
+RpcCompressionPB CompressionForPeer(
+    const std::string& policy, RpcCompressionPB peer_accepted, const Endpoint& local,
+    const Endpoint& remote) {
+  if (peer_accepted != RPC_COMPRESSION_LZ4) {
+    return RPC_COMPRESSION_NONE;
+  }
+  if (policy == "always") {
+    return RPC_COMPRESSION_LZ4;
+  }
+  if (policy == "other_subnets" && !SameSubnet(local.address(), remote.address())) {
+    return RPC_COMPRESSION_LZ4;
+  }
+  return RPC_COMPRESSION_NONE;
+}
+
+bool CompressPayload(RpcCompressionPB compression, const std::vector<Slice>& body,
+                     RpcMetrics* metrics, std::vector<char>* output) {
+  if (compression != RPC_COMPRESSION_LZ4) {
+    return false;
+  }
+  size_t size = 0;
+  for (const auto& slice : body) {
+    size += slice.size();
+  }
+  if (size < static_cast<size_t>(FLAGS_rpc_compression_min_bytes) || size > LZ4_MAX_INPUT_SIZE) {
+    return false;
+  }
+
+  auto start = MonoTime::Now();
+  // LZ4 block compression needs contiguous input, so sidecars are gathered first.
+  std::vector<char> gathered;
+  const char* input = body.front().cdata();
+  if (body.size() > 1) {
+    gathered.reserve(size);
+    for (const auto& slice : body) {
+      gathered.insert(gathered.end(), slice.cdata(), slice.cend());
+    }
+    input = gathered.data();
+  }
+  output->resize(LZ4_compressBound(size));
+  const int compressed_size = LZ4_compress_default(input, output->data(), size, output->size());
+  IncrementCounterBy(metrics, &RpcMetrics::compression_time_us,
+                     MonoTime::Now().GetDeltaSince(start).ToMicroseconds());
+  if (compressed_size <= 0 || static_cast<size_t>(compressed_size) >= size) {
+    return false;
+  }
+  output->resize(compressed_size);
+  IncrementCounterBy(metrics, &RpcMetrics::compression_bytes_saved, size - compressed_size);
+  return true;
+}
+
+Status DecompressPayload(RpcCompressionPB compression, const Slice& input,
+                         size_t uncompressed_size, RpcMetrics* metrics,
+                         std::vector<char>* output) {
+  if (compression != RPC_COMPRESSION_LZ4) {
+    return STATUS_FORMAT(NotSupported, "Unsupported RPC compression: $0", compression);
+  }
+  if (uncompressed_size > LZ4_MAX_INPUT_SIZE) {
+    return STATUS_FORMAT(Corruption, "Invalid uncompressed size of RPC message: $0",
+                         uncompressed_size);
+  }
+  auto start = MonoTime::Now();
+  output->resize(uncompressed_size);
+  const int size = LZ4_decompress_safe(
+      input.cdata(), output->data(), input.size(), uncompressed_size);
+  IncrementCounterBy(metrics, &RpcMetrics::decompression_time_us,
+                     MonoTime::Now().GetDeltaSince(start).ToMicroseconds());
+  if (size < 0 || static_cast<size_t>(size) != uncompressed_size) {
+    return STATUS_FORMAT(Corruption, "Failed to decompress RPC message of $0 bytes to $1 bytes",
+                         input.size(), uncompressed_size);
+  }
+  return Status::OK();
+}
+
+Status SerializeCompressedMessage(const google::protobuf::MessageLite& header,
+                                  const Slice& body, RefCntBuffer* output) {
+  using google::protobuf::io::CodedOutputStream;
+
+  const size_t message_size = CodedOutputStream::VarintSize32(body.size()) + body.size();
+  size_t header_size = 0;
+  RETURN_NOT_OK(serialization::SerializeHeader(
+      header, message_size, output, message_size, &header_size));
+  uint8_t* dst = output->udata() + header_size;
+  dst = CodedOutputStream::WriteVarint32ToArray(body.size(), dst);
+  memcpy(dst, body.data(), body.size());
+  return Status::OK();
+}
+
+} // namespace rpc
+} // namespace yb
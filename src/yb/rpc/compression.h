@@ -0,0 +1,75 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_RPC_COMPRESSION_H
+#define YB_RPC_COMPRESSION_H
+
+#include <string>
+#include <vector>
+
+#include "yb/rpc/rpc_header.pb.h"
+
+#include "yb/util/net/net_fwd.h"
+#include "yb/util/status.h"
+
+namespace yb {
+
+class RefCntBuffer;
+class Slice;
+
+namespace rpc {
+
+struct RpcMetrics;
+
+// Compression of the main message of YB RPC calls.
+//
+// Each side tells in its headers which compression it is able to decompress, and a side
+// compresses what it sends only after the peer told it accepts that. Whether a side compresses at
+// all is decided by --rpc_compression_policy, applied to the endpoints of the connection.
+
+// Compression that this process accepts from its peers, RPC_COMPRESSION_NONE if compression is
+// turned off.
+RpcCompressionPB AcceptedCompression();
+
+// Returns the compression to use for messages sent over the connection between 'local' and
+// 'remote', given the compression the peer accepts.
+RpcCompressionPB CompressionForPeer(
+    RpcCompressionPB peer_accepted, const Endpoint& local, const Endpoint& remote);
+
+// Same as above, with 'policy' taking the values of --rpc_compression_policy, for the users that
+// compress their own payloads under a policy of their own.
+RpcCompressionPB CompressionForPeer(
+    const std::string& policy, RpcCompressionPB peer_accepted, const Endpoint& local,
+    const Endpoint& remote);
+
+// Compresses the concatenation of 'body' into 'output'. Returns false, leaving 'output' in an
+// undefined state, when the body is smaller than --rpc_compression_min_bytes or does not get
+// smaller. 'metrics' could be null.
+bool CompressPayload(RpcCompressionPB compression, const std::vector<Slice>& body,
+                     RpcMetrics* metrics, std::vector<char>* output);
+
+// Decompresses 'input' into 'output', checking that it has 'uncompressed_size' bytes. 'metrics'
+// could be null.
+CHECKED_STATUS DecompressPayload(RpcCompressionPB compression, const Slice& input,
+                                 size_t uncompressed_size, RpcMetrics* metrics,
+                                 std::vector<char>* output);
+
+// Serializes a call with the given header whose main message, already compressed, is 'body'.
+// The header should have its compression fields set.
+CHECKED_STATUS SerializeCompressedMessage(const google::protobuf::MessageLite& header,
+                                          const Slice& body, RefCntBuffer* output);
+
+} // namespace rpc
+} // namespace yb
+
+#endif // YB_RPC_COMPRESSION_H
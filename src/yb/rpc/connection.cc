@@ -43,6 +43,7 @@
 #include "yb/util/enums.h"
 
 #include "yb/rpc/rpc_introspection.pb.h"
+#include "yb/rpc/compression.h"
 #include "yb/rpc/messenger.h"
 #include "yb/rpc/reactor.h"
 #include "yb/rpc/growable_buffer.h"
@@ -100,6 +101,11 @@ void UpdateIdleReason(const char* message, bool* result, std::string* reason) {
   }
 }
 
+void Connection::ReleaseIdleBuffers() {
+  DCHECK(reactor_->IsCurrentThread());
+  stream_->ReleaseIdleBuffers();
+}
+
 bool Connection::Idle(std::string* reason_not_idle) const {
   DCHECK(reactor_->IsCurrentThread());
 
@@ -214,6 +220,13 @@ void Connection::QueueOutboundCall(const OutboundCallPtr& call) {
   DCHECK(call);
   DCHECK_EQ(direction_, Direction::CLIENT);
 
+  if (peer_accepted_compression_ != RpcCompressionPB::RPC_COMPRESSION_NONE) {
+    auto compression = CompressionForPeer(peer_accepted_compression_, stream_->Local(), remote());
+    if (compression != RpcCompressionPB::RPC_COMPRESSION_NONE) {
+      call->CompressRequest(compression);
+    }
+  }
+
   DoQueueOutboundData(call, true);
 
   // Set up the timeout timer.
@@ -276,9 +289,10 @@ Result<size_t> Connection::ProcessReceived(const IoVecs& data, ReadBufferFull re
 Status Connection::HandleCallResponse(std::vector<char>* call_data) {
   DCHECK(reactor_->IsCurrentThread());
   CallResponse resp;
-  RETURN_NOT_OK(resp.ParseFrom(call_data));
+  RETURN_NOT_OK(resp.ParseFrom(call_data, rpc_metrics_));
 
   ++responded_call_count_;
+  peer_accepted_compression_ = resp.accepted_compression();
   auto awaiting = awaiting_response_.find(resp.call_id());
   if (awaiting == awaiting_response_.end()) {
     LOG_WITH_PREFIX(ERROR) << "Got a response for call id " << resp.call_id() << " which "
@@ -121,6 +121,9 @@ class Connection final : public StreamContext, public std::enable_shared_from_th
   // A human-readable reason why the connection is not idle. Empty string if connection is idle.
   std::string ReasonNotIdle() const;
 
+  // Returns the read buffer of an idle connection to its allocator.
+  void ReleaseIdleBuffers();
+
   // Fail any calls which are currently queued or awaiting response.
   // Prohibits any future calls (they will be failed immediately with this
   // same Status).
@@ -254,6 +257,10 @@ class Connection final : public StreamContext, public std::enable_shared_from_th
   // RPC related metrics.
   RpcMetrics* rpc_metrics_;
 
+  // Compression that the server accepts, as told in its latest response. Only used by client
+  // connections, and only from the reactor thread.
+  RpcCompressionPB peer_accepted_compression_ = RpcCompressionPB::RPC_COMPRESSION_NONE;
+
   // Connection is responsible for sending and receiving bytes.
   // Context is responsible for what to do with them.
   std::unique_ptr<ConnectionContext> context_;
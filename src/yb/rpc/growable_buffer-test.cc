@@ -108,5 +108,26 @@ TEST_F(GrowableBufferTest, TestConsume) {
   }
 }
 
+TEST_F(GrowableBufferTest, TestShrink) {
+  GrowableBuffer buffer(&allocator_, kSizeLimit);
+
+  ASSERT_OK(buffer.PrepareAppend());
+  buffer.DataAppended(10);
+  // Buffer with data keeps its memory.
+  buffer.Shrink();
+  ASSERT_EQ(buffer.capacity_left(), kBlockSize - 10);
+
+  buffer.Consume(10);
+  buffer.Shrink();
+  ASSERT_TRUE(buffer.valid());
+  ASSERT_EQ(buffer.capacity_left(), 0);
+
+  auto iov = ASSERT_RESULT(buffer.PrepareAppend());
+  ASSERT_EQ(iov.size(), 1);
+  ASSERT_EQ(iov[0].iov_len, kBlockSize);
+  buffer.DataAppended(kBlockSize / 2);
+  ASSERT_EQ(buffer.size(), kBlockSize / 2);
+}
+
 } // namespace rpc
 } // namespace yb
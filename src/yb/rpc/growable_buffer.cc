@@ -18,6 +18,8 @@
 #include <iostream>
 #include <unordered_set>
 
+#include <gflags/gflags.h>
+
 #include "yb/gutil/strings/substitute.h"
 
 #include "yb/util/mem_tracker.h"
@@ -25,6 +27,10 @@
 
 using namespace std::placeholders;
 
+DEFINE_int32(read_buffer_pool_max_blocks, 4096,
+             "Max number of free blocks that each read buffer allocator keeps for reuse. Blocks "
+             "freed beyond that are returned to malloc.");
+
 namespace yb {
 namespace rpc {
 
@@ -38,7 +44,7 @@ class GrowableBufferAllocator::Impl : public GarbageCollector,
             "Mandatory", mem_tracker, AddToParent::kFalse)),
         used_tracker_(MemTracker::FindOrCreateTracker("Used", mem_tracker)),
         allocated_tracker_(MemTracker::FindOrCreateTracker("Allocated", mem_tracker)),
-        pool_(0) {
+        pool_(FLAGS_read_buffer_pool_max_blocks) {
   }
 
   void CompleteInit() {
@@ -81,7 +87,7 @@ class GrowableBufferAllocator::Impl : public GarbageCollector,
     auto* tracker = was_forced ? mandatory_tracker_.get() : used_tracker_.get();
     tracker->Release(block_size_);
     if (allocated_tracker_->TryConsume(block_size_)) {
-      if (!pool_.push(buffer)) {
+      if (!pool_.bounded_push(buffer)) {
         allocated_tracker_->Release(block_size_);
         free(buffer);
       }
@@ -112,6 +118,8 @@ class GrowableBufferAllocator::Impl : public GarbageCollector,
   MemTrackerPtr used_tracker_;
   // Buffers that is contained in pool.
   MemTrackerPtr allocated_tracker_;
+  // Free blocks, its nodes are preallocated so that the pool is bounded and freeing a block never
+  // allocates.
   boost::lockfree::stack<uint8_t*> pool_;
 };
 
@@ -151,6 +159,13 @@ GrowableBuffer::GrowableBuffer(GrowableBufferAllocator* allocator, size_t limit)
       BufferPtr(allocator_.Allocate(true), GrowableBufferDeleter(&allocator_, true)));
 }
 
+void GrowableBuffer::Shrink() {
+  if (size_ == 0) {
+    pos_ = 0;
+    buffers_.clear();
+  }
+}
+
 void GrowableBuffer::DumpTo(std::ostream& out) const {
   out << "size: " << size_ << ", limit: " << limit_;
 }
@@ -213,6 +228,11 @@ IoVecs GrowableBuffer::AppendedVecs() {
 Result<IoVecs> GrowableBuffer::PrepareAppend() {
   DCHECK_LT(pos_, block_size_);
 
+  if (buffers_.empty()) {
+    buffers_.push_back(
+        BufferPtr(allocator_.Allocate(true), GrowableBufferDeleter(&allocator_, true)));
+  }
+
   // Check if we have too small capacity left.
   if (pos_ + size_ * 2 >= block_size_ && capacity_left() * 2 < block_size_) {
     if (buffers_.size() == buffers_.capacity()) {
@@ -252,7 +272,7 @@ void GrowableBuffer::Reset() {
 }
 
 bool GrowableBuffer::valid() const {
-  return !buffers_.empty();
+  return buffers_.capacity() != 0;
 }
 
 std::ostream& operator<<(std::ostream& out, const GrowableBuffer& receiver) {
@@ -113,6 +113,10 @@ class GrowableBuffer {
   // valid() will return false after call to Reset.
   void Reset();
 
+  // Returns the blocks of an empty buffer to the allocator, the buffer allocates a block again
+  // when data is appended. Does nothing if the buffer contains data.
+  void Shrink();
+
   bool valid() const;
 
  private:
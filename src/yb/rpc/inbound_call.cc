@@ -162,6 +162,9 @@ void InboundCall::RecordHandlingCompleted(scoped_refptr<Histogram> handler_run_t
   if (handler_run_time) {
     handler_run_time->Increment((timing_.time_completed - timing_.time_handled).ToMicroseconds());
   }
+  if (PREDICT_FALSE(trace_context_.sampled())) {
+    RecordSpan(trace_context_, method_name(), timing_.time_received);
+  }
 }
 
 bool InboundCall::ClientTimedOut() const {
@@ -51,6 +51,7 @@
 
 #include "yb/yql/cql/ql/ql_session.h"
 
+#include "yb/util/distributed_trace.h"
 #include "yb/util/faststring.h"
 #include "yb/util/monotime.h"
 #include "yb/util/ref_cnt_buffer.h"
@@ -103,6 +104,9 @@ class InboundCall : public RpcCall {
 
   Trace* trace();
 
+  // Context of the span of this call, if the request is traced.
+  const TraceContext& trace_context() const { return trace_context_; }
+
   // When this InboundCall was received (instantiated).
   // Should only be called once on a given instance.
   // Not thread-safe. Should only be called by the current "owner" thread.
@@ -134,10 +138,19 @@ class InboundCall : public RpcCall {
   // it gets handled.
   MonoDelta GetTimeInQueue() const;
 
+  // Priority class the client asked for.
+  virtual RpcPriorityPB priority() const { return RpcPriorityPB::RPC_PRIORITY_NORMAL; }
+
   virtual const std::string& method_name() const = 0;
   virtual const std::string& service_name() const = 0;
   virtual void RespondFailure(ErrorStatusPB::RpcErrorCodePB error_code, const Status& status) = 0;
 
+  // Responds with ERROR_SERVER_TOO_BUSY, asking the client to wait retry_after before retrying.
+  // Protocols that cannot carry the hint just respond busy.
+  virtual void RespondBusy(const Status& status, MonoDelta retry_after) {
+    RespondFailure(ErrorStatusPB::ERROR_SERVER_TOO_BUSY, status);
+  }
+
   std::string LogPrefix() const override;
 
   template <class T, class ...Args>
@@ -158,6 +171,8 @@ class InboundCall : public RpcCall {
 
   void QueueResponse(bool is_success);
 
+  RpcMetrics* rpc_metrics() const { return rpc_metrics_; }
+
   // The serialized bytes of the request param protobuf. Set by ParseFrom().
   // This references memory held by 'transfer_'.
   Slice serialized_request_;
@@ -168,6 +183,9 @@ class InboundCall : public RpcCall {
   // The trace buffer.
   scoped_refptr<Trace> trace_;
 
+  // Set by ParseFrom() for traced requests.
+  TraceContext trace_context_;
+
   // Timing information related to this RPC call.
   InboundCallTiming timing_;
 
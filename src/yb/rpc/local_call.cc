@@ -48,7 +48,12 @@ const std::shared_ptr<LocalYBInboundCall>& LocalOutboundCall::CreateLocalInbound
       timeout.Initialized() ? ToCoarse(start_) + timeout : CoarseTimePoint::max();
   auto outbound_call = std::static_pointer_cast<LocalOutboundCall>(shared_from(this));
   inbound_call_ = InboundCall::Create<LocalYBInboundCall>(
-      &rpc_metrics(), remote_method(), outbound_call, deadline);
+      &rpc_metrics(), remote_method(), outbound_call, deadline, controller()->priority());
+  // There is no connection in between, so the trace of the handler is recorded as part of the
+  // trace of the caller.
+  trace()->AddChildTrace(inbound_call_->trace());
+  inbound_call_->trace_context_ = trace_context().NewChild();
+  TRACE_TO(trace(), "Handing over to local service");
   return inbound_call_;
 }
 
@@ -66,9 +71,10 @@ LocalYBInboundCall::LocalYBInboundCall(
     RpcMetrics* rpc_metrics,
     const RemoteMethod& remote_method,
     std::weak_ptr<LocalOutboundCall> outbound_call,
-    CoarseTimePoint deadline)
+    CoarseTimePoint deadline,
+    RpcPriorityPB priority)
     : YBInboundCall(rpc_metrics, remote_method), outbound_call_(outbound_call),
-      deadline_(deadline) {
+      deadline_(deadline), priority_(priority) {
 }
 
 const Endpoint& LocalYBInboundCall::remote_address() const {
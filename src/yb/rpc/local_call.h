@@ -54,7 +54,7 @@ class LocalYBInboundCall : public YBInboundCall {
  public:
   LocalYBInboundCall(RpcMetrics* rpc_metrics, const RemoteMethod& remote_method,
                      std::weak_ptr<LocalOutboundCall> outbound_call,
-                     CoarseTimePoint deadline);
+                     CoarseTimePoint deadline, RpcPriorityPB priority);
 
   bool IsLocalCall() const override { return true; }
 
@@ -62,6 +62,8 @@ class LocalYBInboundCall : public YBInboundCall {
   const Endpoint& local_address() const override;
   CoarseTimePoint GetClientDeadline() const override { return deadline_; }
 
+  RpcPriorityPB priority() const override { return priority_; }
+
   CHECKED_STATUS ParseParam(google::protobuf::Message* message) override;
 
   const google::protobuf::Message* request() const { return outbound_call()->req_; }
@@ -81,6 +83,7 @@ class LocalYBInboundCall : public YBInboundCall {
   std::weak_ptr<LocalOutboundCall> outbound_call_;
 
   const CoarseTimePoint deadline_;
+  const RpcPriorityPB priority_;
 };
 
 } // namespace rpc
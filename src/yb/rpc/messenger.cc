@@ -84,6 +84,7 @@ using std::shared_ptr;
 using strings::Substitute;
 
 DECLARE_int32(num_connections_to_server);
+DECLARE_string(rpc_cpu_affinity);
 DEFINE_int32(rpc_default_keepalive_time_ms, 65000,
              "If an RPC connection from a client is idle for this amount of time, the server "
              "will disconnect the client. Setting flag to 0 disables this clean up.");
@@ -330,9 +331,9 @@ rpc::ThreadPool& Messenger::ThreadPool(ServicePriority priority) {
       if (high_priority_thread_pool) {
         return *high_priority_thread_pool;
       }
-      const ThreadPoolOptions& options = normal_thread_pool_->options();
-      high_priority_thread_pool_.reset(new rpc::ThreadPool(
-          name_ + "-high-pri", options.queue_limit, options.max_workers));
+      ThreadPoolOptions options = normal_thread_pool_->options();
+      options.name = name_ + "-high-pri";
+      high_priority_thread_pool_.reset(new rpc::ThreadPool(std::move(options)));
       return *high_priority_thread_pool_.get();
   }
   FATAL_INVALID_ENUM_VALUE(ServicePriority, priority);
@@ -471,8 +472,9 @@ Messenger::Messenger(const MessengerBuilder &bld)
       metric_entity_(bld.metric_entity_),
       retain_self_(this),
       io_thread_pool_(name_, FLAGS_io_thread_pool_size),
-      scheduler_(&io_thread_pool_.io_service()),
-      normal_thread_pool_(new rpc::ThreadPool(name_, bld.queue_limit_, bld.workers_limit_)),
+      scheduler_(&io_thread_pool_.io_service(), bld.metric_entity_),
+      normal_thread_pool_(new rpc::ThreadPool(
+          name_, bld.queue_limit_, bld.workers_limit_, !FLAGS_rpc_cpu_affinity.empty())),
       rpc_metrics_(new RpcMetrics(bld.metric_entity_)) {
 #ifndef NDEBUG
   creation_stack_trace_.Collect(/* skip_frames */ 1);
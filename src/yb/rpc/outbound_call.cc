@@ -42,6 +42,7 @@
 #include "yb/gutil/strings/substitute.h"
 #include "yb/gutil/walltime.h"
 
+#include "yb/rpc/compression.h"
 #include "yb/rpc/connection.h"
 #include "yb/rpc/constants.h"
 #include "yb/rpc/outbound_call.h"
@@ -265,6 +266,31 @@ Status OutboundCall::SetRequestParam(const Message& message) {
                           header_size);
 }
 
+void OutboundCall::CompressRequest(RpcCompressionPB compression) {
+  RequestHeader header;
+  Slice body;
+  auto status = serialization::ParseYBMessage(
+      Slice(buffer_.udata() + kMsgLengthPrefixLength, buffer_.size() - kMsgLengthPrefixLength),
+      &header, &body);
+  if (!status.ok()) {
+    LOG_WITH_PREFIX(DFATAL) << "Failed to parse serialized request: " << status;
+    return;
+  }
+  std::vector<char> compressed;
+  if (!CompressPayload(compression, {body}, rpc_metrics_, &compressed)) {
+    return;
+  }
+  header.set_compression(compression);
+  header.set_uncompressed_size(body.size());
+  RefCntBuffer buffer;
+  status = SerializeCompressedMessage(header, Slice(compressed.data(), compressed.size()), &buffer);
+  if (!status.ok()) {
+    LOG_WITH_PREFIX(DFATAL) << "Failed to serialize compressed request: " << status;
+    return;
+  }
+  buffer_ = std::move(buffer);
+}
+
 Status OutboundCall::status() const {
   std::lock_guard<simple_spinlock> l(lock_);
   return status_;
@@ -334,6 +360,10 @@ void OutboundCall::CallCallback() {
     return;
   }
 
+  if (PREDICT_FALSE(trace_context_.sampled())) {
+    RecordSpan(trace_context_, remote_method_->method_name() + " (outbound)", start_);
+  }
+
   int64_t start_cycles = CycleClock::Now();
   callback_();
   // Clear the callback, since it may be holding onto reference counts
@@ -502,7 +532,19 @@ void OutboundCall::InitHeader(RequestHeader* header) {
   if (timeout.Initialized()) {
     header->set_timeout_millis(timeout.ToMilliseconds());
   }
+  if (controller_->priority() != RpcPriorityPB::RPC_PRIORITY_NORMAL) {
+    header->set_priority(controller_->priority());
+  }
+  auto accepted_compression = AcceptedCompression();
+  if (accepted_compression != RpcCompressionPB::RPC_COMPRESSION_NONE) {
+    header->set_accepted_compression(accepted_compression);
+  }
   header->set_allocated_remote_method(remote_method_pool_->Take());
+  if (PREDICT_FALSE(trace_context_.sampled())) {
+    auto* trace_context = header->mutable_trace_context();
+    trace_context->set_trace_id(trace_context_.trace_id);
+    trace_context->set_parent_span_id(trace_context_.span_id);
+  }
 }
 
 ///
@@ -562,7 +604,7 @@ Status CallResponse::GetSidecar(int idx, Slice* sidecar) const {
   return Status::OK();
 }
 
-Status CallResponse::ParseFrom(std::vector<char>* call_data) {
+Status CallResponse::ParseFrom(std::vector<char>* call_data, RpcMetrics* rpc_metrics) {
   CHECK(!parsed_);
   Slice entire_message;
 
@@ -570,6 +612,15 @@ Status CallResponse::ParseFrom(std::vector<char>* call_data) {
   Slice source(response_data_.data(), response_data_.size());
   RETURN_NOT_OK(serialization::ParseYBMessage(source, &header_, &entire_message));
 
+  if (header_.compression() != RpcCompressionPB::RPC_COMPRESSION_NONE) {
+    std::vector<char> decompressed;
+    RETURN_NOT_OK(DecompressPayload(
+        header_.compression(), entire_message, header_.uncompressed_size(), rpc_metrics,
+        &decompressed));
+    response_data_.swap(decompressed);
+    entire_message = Slice(response_data_.data(), response_data_.size());
+  }
+
   // Use information from header to extract the payload slices.
   const size_t sidecars = header_.sidecar_offsets_size();
 
@@ -48,6 +48,7 @@
 #include "yb/rpc/rpc_header.pb.h"
 #include "yb/rpc/service_if.h"
 
+#include "yb/util/distributed_trace.h"
 #include "yb/util/locks.h"
 #include "yb/util/monotime.h"
 #include "yb/util/net/sockaddr.h"
@@ -139,8 +140,9 @@ class CallResponse {
   void operator=(CallResponse&& rhs);
 
   // Parse the response received from a call. This must be called before any
-  // other methods on this object. Takes ownership of data content.
-  CHECKED_STATUS ParseFrom(std::vector<char>* data);
+  // other methods on this object. Takes ownership of data content. A compressed response is
+  // decompressed, recording the time spent in 'rpc_metrics', which could be null.
+  CHECKED_STATUS ParseFrom(std::vector<char>* data, RpcMetrics* rpc_metrics = nullptr);
 
   // Return true if the call succeeded.
   bool is_success() const {
@@ -164,6 +166,12 @@ class CallResponse {
   // See RpcController::GetSidecar()
   CHECKED_STATUS GetSidecar(int idx, Slice* sidecar) const;
 
+  // Compression that the server accepts for requests.
+  RpcCompressionPB accepted_compression() const {
+    DCHECK(parsed_);
+    return header_.accepted_compression();
+  }
+
  private:
   // True once ParseFrom() is called.
   bool parsed_;
@@ -215,6 +223,11 @@ class OutboundCall : public RpcCall {
   // is called first. This is called from the Reactor thread.
   void Serialize(boost::container::small_vector_base<RefCntBuffer>* output) const override;
 
+  // Compresses the serialized request, if it is big enough and compression makes it smaller.
+  // Called from the Reactor thread, when the call is queued to a connection whose peer accepts
+  // 'compression'.
+  void CompressRequest(RpcCompressionPB compression);
+
   // Callback after the call has been put on the outbound connection queue.
   void SetQueued();
 
@@ -273,6 +286,10 @@ class OutboundCall : public RpcCall {
     return trace_.get();
   }
 
+  const TraceContext& trace_context() const {
+    return trace_context_;
+  }
+
   RpcMetrics& rpc_metrics() {
     return *rpc_metrics_;
   }
@@ -351,6 +368,9 @@ class OutboundCall : public RpcCall {
   // The trace buffer.
   scoped_refptr<Trace> trace_;
 
+  // Span of this call in the trace of the calling thread, if that thread works on a traced request.
+  const TraceContext trace_context_ = TraceContext::Current().NewChild();
+
   std::shared_ptr<OutboundCallMetrics> outbound_call_metrics_;
 
   RemoteMethodPool* remote_method_pool_;
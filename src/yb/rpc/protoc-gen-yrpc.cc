@@ -515,8 +515,7 @@ class CodeGenerator : public ::google::protobuf::compiler::CodeGenerator {
         "            metrics_[$metric_enum_key$]) :\n"
         "        ::yb::rpc::RpcContext(\n"
         "            yb_call, \n"
-        "            std::make_shared<$request$>(),\n"
-        "            std::make_shared<$response$>(),\n"
+        "            ::yb::rpc::MakeCallMessages<$request$, $response$>(),\n"
         "            metrics_[$metric_enum_key$]);\n"
         "    if (!rpc_context.responded()) {\n"
         "      const auto* req = static_cast<const $request$*>(rpc_context.request_pb());\n"
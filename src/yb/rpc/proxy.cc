@@ -56,6 +56,7 @@
 #include "yb/util/countdown_latch.h"
 #include "yb/util/status.h"
 #include "yb/util/user.h"
+#include "yb/util/wait_state.h"
 
 DEFINE_int32(num_connections_to_server, 8, "Number of underlying connections to each server");
 DEFINE_int32(proxy_resolve_cache_ms, 5000,
@@ -266,7 +267,10 @@ Status Proxy::SyncRequest(const RemoteMethod* method,
   CountDownLatch latch(1);
   AsyncRequest(method, req, DCHECK_NOTNULL(resp), controller, [&latch]() { latch.CountDown(); });
 
-  latch.Wait();
+  {
+    ScopedWaitState wait_state(WaitState::kRpc);
+    latch.Wait();
+  }
   return controller->status();
 }
 
@@ -68,12 +68,32 @@
 #include "yb/util/trace.h"
 #include "yb/util/status.h"
 #include "yb/util/net/socket.h"
+#include "yb/util/os-util.h"
 
 using namespace std::literals;
 
 DECLARE_string(local_ip_for_outbound_sockets);
 DECLARE_int32(num_connections_to_server);
 
+DEFINE_int64(rpc_release_idle_read_buffer_ms, 1000,
+             "Server connections that have been idle for longer than this return their read buffer "
+             "to the allocator, and allocate it again when data arrives. Negative to keep it.");
+TAG_FLAG(rpc_release_idle_read_buffer_ms, advanced);
+TAG_FLAG(rpc_release_idle_read_buffer_ms, runtime);
+
+DEFINE_int64(rpc_idle_client_connection_timeout_ms, 0,
+             "Connections to servers that have been idle for longer than this are closed, and "
+             "opened again on the next call. 0 keeps them open.");
+TAG_FLAG(rpc_idle_client_connection_timeout_ms, advanced);
+TAG_FLAG(rpc_idle_client_connection_timeout_ms, runtime);
+
+DEFINE_string(rpc_cpu_affinity, "",
+              "How to place reactor and RPC worker threads on CPUs. Empty - anywhere. "
+              "\"numa\" - reactors are spread over the NUMA nodes and run on the CPUs of their "
+              "node, and the RPC workers of each node run calls received by the reactors of that "
+              "node. \"core\" - like \"numa\", but each reactor runs on a single CPU.");
+TAG_FLAG(rpc_cpu_affinity, advanced);
+
 namespace yb {
 namespace rpc {
 
@@ -121,6 +141,7 @@ Reactor::Reactor(const std::shared_ptr<Messenger>& messenger,
                  const MessengerBuilder &bld)
     : messenger_(messenger),
       name_(StringPrintf("%s_R%03d", messenger->name().c_str(), index)),
+      index_(index),
       loop_(kDefaultLibEvFlags),
       cur_time_(CoarseMonoClock::Now()),
       last_unused_tcp_scan_(cur_time_),
@@ -417,12 +438,21 @@ void Reactor::TimerHandler(ev::timer &watcher, int revents) {
   cur_time_ = now;
 
   ScanIdleConnections();
+  ScanIdleClientConnections();
 }
 
 void Reactor::ScanIdleConnections() {
   DCHECK(IsCurrentThread());
+  const auto release_buffer_ms = FLAGS_rpc_release_idle_read_buffer_ms;
   if (connection_keepalive_time_ == CoarseMonoClock::Duration::zero()) {
     VLOG(3) << "Skipping Idle connections check since connection_keepalive_time_ = 0";
+    if (release_buffer_ms >= 0) {
+      for (const auto& conn : server_conns_) {
+        if (cur_time_ - conn->last_activity_time() > release_buffer_ms * 1ms && conn->Idle()) {
+          conn->ReleaseIdleBuffers();
+        }
+      }
+    }
     return;
   }
 
@@ -440,6 +470,10 @@ void Reactor::ScanIdleConnections() {
 
     auto last_activity_time = conn->last_activity_time();
     auto connection_delta = cur_time_ - last_activity_time;
+    if (release_buffer_ms >= 0 && connection_delta > release_buffer_ms * 1ms) {
+      // Most connections of a busy proxy are idle, they should not each hold a read buffer.
+      conn->ReleaseIdleBuffers();
+    }
     if (connection_delta > connection_keepalive_time_) {
       conn->Shutdown(STATUS_FORMAT(
           NetworkError, "Connection timed out after $0", ToSeconds(connection_delta)));
@@ -455,12 +489,33 @@ void Reactor::ScanIdleConnections() {
     }
   }
 
-  // TODO: above only times out on the server side.
-  // Clients may want to set their keepalive timeout as well.
+  // Client connections are timed out by ScanIdleClientConnections().
 
   VLOG_IF(1, timed_out > 0) << name() << ": timed out " << timed_out << " TCP connections.";
 }
 
+void Reactor::ScanIdleClientConnections() {
+  DCHECK(IsCurrentThread());
+  const auto timeout_ms = FLAGS_rpc_idle_client_connection_timeout_ms;
+  if (timeout_ms <= 0) {
+    return;
+  }
+
+  std::vector<ConnectionPtr> idle_conns;
+  for (const auto& entry : client_conns_) {
+    const ConnectionPtr& conn = entry.second;
+    if (cur_time_ - conn->last_activity_time() > timeout_ms * 1ms && conn->Idle()) {
+      idle_conns.push_back(conn);
+    }
+  }
+  for (const auto& conn : idle_conns) {
+    VLOG(1) << "Closing client connection " << conn->ToString() << " - it has been idle for "
+            << ToSeconds(cur_time_ - conn->last_activity_time()) << "s";
+    DestroyConnection(conn.get(), STATUS_FORMAT(
+        NetworkError, "Client connection idle for more than $0ms", timeout_ms));
+  }
+}
+
 bool Reactor::IsCurrentThread() const {
   return thread_.get() == yb::Thread::current_thread();
 }
@@ -470,9 +525,29 @@ bool Reactor::IsCurrentThreadOrStartedClosing() const {
          HasReactorStartedClosing(state_.load(std::memory_order_acquire));
 }
 
+void Reactor::SetCpuAffinity() {
+  const std::string& mode = FLAGS_rpc_cpu_affinity;
+  if (mode.empty()) {
+    return;
+  }
+  if (mode != "numa" && mode != "core") {
+    LOG(DFATAL) << "Unknown rpc_cpu_affinity: " << mode;
+    return;
+  }
+  // Consecutive reactors go to different nodes, so connections, that are assigned to reactors
+  // round robin, are spread over all nodes.
+  auto node_cpus = NumaNodeCpus();
+  auto& cpus = node_cpus[index_ % node_cpus.size()];
+  if (mode == "core") {
+    cpus = { cpus[(index_ / node_cpus.size()) % cpus.size()] };
+  }
+  WARN_NOT_OK(SetCurrentThreadCpuAffinity(cpus), "Failed to set reactor CPU affinity");
+}
+
 void Reactor::RunThread() {
   ThreadRestrictions::SetWaitAllowed(false);
   ThreadRestrictions::SetIOAllowed(false);
+  SetCpuAffinity();
   DVLOG(6) << "Calling Reactor::RunThread()...";
   loop_.run(/* flags */ 0);
   VLOG(1) << name() << " thread exiting.";
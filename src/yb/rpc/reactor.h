@@ -393,6 +393,13 @@ class Reactor {
   // connection_keepalive_time_
   void ScanIdleConnections();
 
+  // Close the client connections that have been idle longer than
+  // --rpc_idle_client_connection_timeout_ms.
+  void ScanIdleClientConnections();
+
+  // Pins the reactor thread according to rpc_cpu_affinity.
+  void SetCpuAffinity();
+
   // Assign a new outbound call to the appropriate connection object.
   // If this fails, the call is marked failed and completed.
   ConnectionPtr AssignOutboundCall(const OutboundCallPtr &call);
@@ -422,6 +429,9 @@ class Reactor {
 
   const std::string name_;
 
+  // Index of this reactor in its messenger.
+  const int index_;
+
   mutable simple_spinlock pending_tasks_mtx_;
 
   // Reactor status, mostly used when shutting down. Guarded by pending_tasks_mtx_, but also read
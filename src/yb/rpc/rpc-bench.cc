@@ -30,17 +30,34 @@
 // under the License.
 //
 
+#include <functional>
 #include <string>
 #include <thread>
+#include <vector>
 
+#include <gflags/gflags.h>
 #include <gtest/gtest.h>
 
 #include "yb/rpc/rpc-test-base.h"
 #include "yb/rpc/rtest.proxy.h"
-#include "yb/util/countdown_latch.h"
+#include "yb/util/hdr_histogram.h"
+#include "yb/util/size_literals.h"
 #include "yb/util/test_util.h"
+#include "yb/util/tsan_util.h"
 
 using namespace std::literals; // NOLINT
+using namespace yb::size_literals;
+
+DEFINE_int32(rpc_bench_duration_sec, 10, "How long each RPC benchmark runs.");
+DEFINE_int32(rpc_bench_client_threads, yb::NonTsanVsTsan(16, 4),
+             "Number of client threads, each with its own connection, used by the benchmarks.");
+DEFINE_int32(rpc_bench_fan_in_clients, yb::NonTsanVsTsan(256, 32),
+             "Number of clients, each with its own connection, used by BenchmarkFanIn.");
+DEFINE_int32(rpc_bench_large_payload_bytes, 1_MB,
+             "Size of the payload echoed by BenchmarkLargePayload.");
+DEFINE_int32(rpc_bench_sidecar_bytes, 64_KB,
+             "Size of each sidecar returned by BenchmarkSidecars.");
+DEFINE_int32(rpc_bench_sidecars, 4, "Number of sidecars returned by BenchmarkSidecars.");
 
 using std::string;
 using std::shared_ptr;
@@ -48,108 +65,261 @@ using std::shared_ptr;
 namespace yb {
 namespace rpc {
 
+namespace {
+
+// Latencies are recorded in microseconds.
+constexpr uint64_t kMaxLatencyUs = 60 * 1000 * 1000;
+constexpr int kLatencySignificantDigits = 3;
+
+RemoteMethod CalculatorMethod(const char* name) {
+  return RemoteMethod(rpc_test::CalculatorServiceIf::static_service_name(), name);
+}
+
+} // namespace
+
 class RpcBench : public RpcTestBase {
  public:
   RpcBench()
   {}
 
  protected:
-  friend class ClientThread;
+  // Makes a single call through 'proxy'. Returns the index of the latency group of the call,
+  // e.g. of its priority.
+  typedef std::function<size_t(Proxy* proxy, int64_t index)> MakeCall;
 
-  HostPort server_hostport_;
-  shared_ptr<Messenger> client_messenger_;
-  std::atomic<bool> should_run_{true};
-};
+  struct BenchmarkOptions {
+    std::string name;
+    int num_clients = FLAGS_rpc_bench_client_threads;
+    // Names of the latency groups, calls of each group are reported separately.
+    std::vector<std::string> groups = {"all"};
+    // When set all clients call through this messenger, otherwise each client has its own
+    // messenger, and so its own connection.
+    shared_ptr<Messenger> messenger;
+    // The default one means calls to the local service of 'messenger'.
+    HostPort remote;
+  };
 
-class ClientThread {
- public:
-  explicit ClientThread(RpcBench *bench)
-    : bench_(bench),
-      request_count_(0) {
-  }
+  // Runs 'make_call' in a loop from each of the clients for --rpc_bench_duration_sec, then logs
+  // throughput, latency percentiles of each group, and CPU time per call. Since the server runs in
+  // the same process, CPU time covers both sides of the call.
+  void RunBenchmark(const BenchmarkOptions& options, const MakeCall& make_call) {
+    std::vector<std::unique_ptr<HdrHistogram>> latencies;
+    for (size_t i = 0; i != options.groups.size(); ++i) {
+      latencies.push_back(std::make_unique<HdrHistogram>(
+          kMaxLatencyUs, kLatencySignificantDigits));
+    }
 
-  void Start() {
-    thread_.reset(new std::thread(&ClientThread::Run, this));
-  }
+    std::vector<shared_ptr<Messenger>> messengers;
+    std::vector<std::unique_ptr<Proxy>> proxies;
+    for (int i = 0; i != options.num_clients; ++i) {
+      auto messenger = options.messenger;
+      if (!messenger) {
+        messenger = CreateMessenger(Format("Client-$0", i));
+        messengers.push_back(messenger);
+      }
+      proxies.push_back(std::make_unique<Proxy>(messenger, options.remote));
+    }
 
-  void Join() {
-    thread_->join();
-  }
+    std::atomic<bool> should_run{true};
+    std::atomic<int64_t> total_calls{0};
+    std::vector<std::thread> threads;
 
-  void Run() {
-    shared_ptr<Messenger> client_messenger = bench_->CreateMessenger("Client");
-    ProxyCache proxy_cache(client_messenger);
+    Stopwatch sw(Stopwatch::ALL_THREADS);
+    sw.start();
+    for (auto& proxy : proxies) {
+      threads.emplace_back([&should_run, &total_calls, &latencies, &make_call,
+                            proxy = proxy.get()] {
+        int64_t calls = 0;
+        while (should_run.load(std::memory_order_acquire)) {
+          auto start = MonoTime::Now();
+          auto group = make_call(proxy, calls);
+          latencies[group]->Increment(MonoTime::Now().GetDeltaSince(start).ToMicroseconds());
+          ++calls;
+        }
+        total_calls += calls;
+      });
+    }
 
-    rpc_test::CalculatorServiceProxy p(&proxy_cache, HostPort(bench_->server_hostport_));
+    std::this_thread::sleep_for(FLAGS_rpc_bench_duration_sec * 1s);
+    should_run.store(false, std::memory_order_release);
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    sw.stop();
 
-    rpc_test::AddRequestPB req;
-    rpc_test::AddResponsePB resp;
-    while (bench_->should_run_.load(std::memory_order_acquire)) {
-      req.set_x(request_count_);
-      req.set_y(request_count_);
+    const double calls = std::max<int64_t>(total_calls.load(), 1);
+    LOG(INFO) << options.name << " clients: " << options.num_clients;
+    LOG(INFO) << options.name << " calls/sec: " << calls / sw.elapsed().wall_seconds();
+    LOG(INFO) << options.name << " user CPU per call: " << sw.elapsed().user / 1000.0 / calls
+              << "us";
+    LOG(INFO) << options.name << " sys CPU per call: " << sw.elapsed().system / 1000.0 / calls
+              << "us";
+    for (size_t i = 0; i != options.groups.size(); ++i) {
+      const auto& histogram = *latencies[i];
+      LOG(INFO) << options.name << " " << options.groups[i] << " latency us:"
+                << " calls: " << histogram.TotalCount()
+                << " p50: " << histogram.ValueAtPercentile(50)
+                << " p99: " << histogram.ValueAtPercentile(99)
+                << " p999: " << histogram.ValueAtPercentile(99.9)
+                << " max: " << histogram.MaxValue();
+    }
+
+    ASSERT_GT(total_calls.load(), 0);
+    proxies.clear();
+    for (const auto& messenger : messengers) {
+      messenger->Shutdown();
+    }
+  }
+
+  // Benchmarks calls of Add, the cheapest one to serve.
+  void BenchmarkAdd(const BenchmarkOptions& options) {
+    const auto method = CalculatorMethod("Add");
+    RunBenchmark(options, [&method](Proxy* proxy, int64_t index) {
+      rpc_test::AddRequestPB req;
+      req.set_x(index);
+      req.set_y(index);
+      rpc_test::AddResponsePB resp;
       RpcController controller;
-      controller.set_timeout(MonoDelta::FromSeconds(10));
-      CHECK_OK(p.Add(req, &resp, &controller));
+      controller.set_timeout(10s);
+      CHECK_OK(proxy->SyncRequest(&method, req, &resp, &controller));
       CHECK_EQ(req.x() + req.y(), resp.result());
-      request_count_++;
-    }
+      return 0;
+    });
   }
 
-  std::unique_ptr<std::thread> thread_;
-  RpcBench *bench_;
-  int request_count_;
+  HostPort server_hostport_;
 };
 
-
 // Test making successful RPC calls.
 TEST_F(RpcBench, BenchmarkCalls) {
-  TestServerOptions options;
-  options.n_worker_threads = 1;
+  StartTestServerWithGeneratedCode(&server_hostport_);
+
+  BenchmarkOptions options;
+  options.name = "Calls";
+  options.remote = server_hostport_;
+  BenchmarkAdd(options);
+}
 
-  // Set up server.
+// Many clients, each with its own connection, calling the same server.
+TEST_F(RpcBench, BenchmarkFanIn) {
   StartTestServerWithGeneratedCode(&server_hostport_);
 
-  // Set up client.
-  LOG(INFO) << "Connecting to " << server_hostport_;
-  MessengerOptions client_options = kDefaultClientMessengerOptions;
-  client_options.n_reactors = 2;
-  client_messenger_ = CreateMessenger("Client", client_options);
-
-  Stopwatch sw(Stopwatch::ALL_THREADS);
-  sw.start();
-
-  std::vector<std::unique_ptr<ClientThread>> threads;
-#if defined(THREAD_SANITIZER) || defined(ADDRESS_SANITIZER)
-  constexpr int kNumThreads = 4;
-#else
-  constexpr int kNumThreads = 16;
-#endif
-  for (int i = 0; i < kNumThreads; i++) {
-    auto thr = std::make_unique<ClientThread>(this);
-    thr->Start();
-    threads.push_back(std::move(thr));
-  }
+  BenchmarkOptions options;
+  options.name = "FanIn";
+  options.num_clients = FLAGS_rpc_bench_fan_in_clients;
+  options.remote = server_hostport_;
+  BenchmarkAdd(options);
+}
 
-  std::this_thread::sleep_for(10s);
-  should_run_.store(false, std::memory_order_release);
+// Calls to the service of the same messenger, that bypass serialization and the network.
+TEST_F(RpcBench, BenchmarkLocalCalls) {
+  TestServerOptions server_options;
+  server_options.messenger = CreateMessenger("TestServer", kDefaultServerMessengerOptions);
+  StartTestServerWithGeneratedCode(&server_hostport_, server_options);
 
-  int total_reqs = 0;
+  BenchmarkOptions options;
+  options.name = "LocalCalls";
+  options.messenger = server_options.messenger;
+  BenchmarkAdd(options);
+}
 
-  for (const auto& thr : threads) {
-    thr->Join();
-    total_reqs += thr->request_count_;
-  }
-  sw.stop();
+TEST_F(RpcBench, BenchmarkLargePayload) {
+  StartTestServerWithGeneratedCode(&server_hostport_);
+
+  BenchmarkOptions options;
+  options.name = "LargePayload";
+  options.remote = server_hostport_;
+  const string payload(FLAGS_rpc_bench_large_payload_bytes, 'x');
+  const auto method = CalculatorMethod("Echo");
+  RunBenchmark(options, [&method, &payload](Proxy* proxy, int64_t index) {
+    rpc_test::EchoRequestPB req;
+    req.set_data(payload);
+    rpc_test::EchoResponsePB resp;
+    RpcController controller;
+    controller.set_timeout(60s);
+    CHECK_OK(proxy->SyncRequest(&method, req, &resp, &controller));
+    CHECK_EQ(payload.size(), resp.data().size());
+    return 0;
+  });
+}
+
+// Responses that carry their data in sidecars, so it is not copied into the response protobuf.
+TEST_F(RpcBench, BenchmarkSidecars) {
+  StartTestServer(&server_hostport_);
 
-  float reqs_per_second = static_cast<float>(total_reqs / sw.elapsed().wall_seconds());
-  float user_cpu_micros_per_req = static_cast<float>(sw.elapsed().user / 1000.0 / total_reqs);
-  float sys_cpu_micros_per_req = static_cast<float>(sw.elapsed().system / 1000.0 / total_reqs);
+  BenchmarkOptions options;
+  options.name = "Sidecars";
+  options.remote = server_hostport_;
+  RunBenchmark(options, [](Proxy* proxy, int64_t index) {
+    rpc_test::SendStringsRequestPB req;
+    req.set_random_seed(index);
+    for (int i = 0; i != FLAGS_rpc_bench_sidecars; ++i) {
+      req.add_sizes(FLAGS_rpc_bench_sidecar_bytes);
+    }
+    rpc_test::SendStringsResponsePB resp;
+    RpcController controller;
+    controller.set_timeout(60s);
+    CHECK_OK(proxy->SyncRequest(
+        GenericCalculatorService::SendStringsMethod(), req, &resp, &controller));
+    CHECK_EQ(FLAGS_rpc_bench_sidecars, resp.sidecars_size());
+    return 0;
+  });
+}
+
+// Calls that time out while the server is still handling them, so the client gives up on them
+// and discards the responses that come later. Clients send calls faster than the server handles
+// them, so some calls are rejected by the full service queue, or expire in it.
+TEST_F(RpcBench, BenchmarkTimeouts) {
+  StartTestServerWithGeneratedCode(&server_hostport_);
+
+  BenchmarkOptions options;
+  options.name = "Timeouts";
+  options.remote = server_hostport_;
+  options.groups = {"timed_out", "succeeded", "rejected"};
+  const auto method = CalculatorMethod("Sleep");
+  RunBenchmark(options, [&method](Proxy* proxy, int64_t index) {
+    rpc_test::SleepRequestPB req;
+    req.set_sleep_micros(5000);
+    rpc_test::SleepResponsePB resp;
+    RpcController controller;
+    controller.set_timeout(1ms);
+    auto status = proxy->SyncRequest(&method, req, &resp, &controller);
+    if (status.ok()) {
+      return 1;
+    }
+    if (status.IsTimedOut()) {
+      return 0;
+    }
+    CHECK(status.IsServiceUnavailable()) << status;
+    return 2;
+  });
+}
+
+// A quarter of the calls are of high priority, and the server has a single worker, so calls are
+// queued there and the service pool picks high priority calls first.
+TEST_F(RpcBench, BenchmarkMixedPriorities) {
+  TestServerOptions server_options;
+  server_options.n_worker_threads = 1;
+  StartTestServerWithGeneratedCode(&server_hostport_, server_options);
 
-  LOG(INFO) << "Reqs/sec:         " << reqs_per_second;
-  LOG(INFO) << "User CPU per req: " << user_cpu_micros_per_req << "us";
-  LOG(INFO) << "Sys CPU per req:  " << sys_cpu_micros_per_req << "us";
+  BenchmarkOptions options;
+  options.name = "MixedPriorities";
+  options.remote = server_hostport_;
+  options.groups = {"normal", "high"};
+  const auto method = CalculatorMethod("Add");
+  RunBenchmark(options, [&method](Proxy* proxy, int64_t index) {
+    const bool high = index % 4 == 0;
+    rpc_test::AddRequestPB req;
+    req.set_x(index);
+    req.set_y(index);
+    rpc_test::AddResponsePB resp;
+    RpcController controller;
+    controller.set_timeout(10s);
+    controller.set_priority(high ? RPC_PRIORITY_HIGH : RPC_PRIORITY_NORMAL);
+    CHECK_OK(proxy->SyncRequest(&method, req, &resp, &controller));
+    return high ? 1 : 0;
+  });
 }
 
 } // namespace rpc
 } // namespace yb
-
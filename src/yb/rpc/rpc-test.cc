@@ -55,6 +55,8 @@ METRIC_DECLARE_histogram(rpc_incoming_queue_time);
 DEFINE_int32(rpc_test_connection_keepalive_num_iterations, 1,
   "Number of iterations in TestRpc.TestConnectionKeepalive");
 
+DECLARE_int64(rpc_idle_client_connection_timeout_ms);
+
 using namespace std::chrono_literals;
 using std::string;
 using std::shared_ptr;
@@ -286,6 +288,32 @@ TEST_F(TestRpc, TestConnectionKeepalive) {
   }
 }
 
+// Test that the client closes its idle connections, and opens them again for the next call.
+TEST_F(TestRpc, TestIdleClientConnectionTimeout) {
+  FLAGS_rpc_idle_client_connection_timeout_ms = 100;
+  MessengerOptions messenger_options = { 1, 1h };
+
+  HostPort server_addr;
+  StartTestServer(&server_addr);
+  shared_ptr<Messenger> client_messenger(CreateMessenger("Client", messenger_options));
+  Proxy p(client_messenger, server_addr);
+
+  ASSERT_OK(DoTestSyncCall(&p, GenericCalculatorService::AddMethod()));
+
+  ReactorMetrics metrics;
+  ASSERT_OK(client_messenger->reactors_[0]->GetMetrics(&metrics));
+  ASSERT_EQ(1, metrics.num_client_connections_) << "Client should have 1 client connection";
+
+  SleepFor(MonoDelta::FromMilliseconds(500));
+
+  ASSERT_OK(client_messenger->reactors_[0]->GetMetrics(&metrics));
+  ASSERT_EQ(0, metrics.num_client_connections_) << "Client should have 0 client connections";
+
+  ASSERT_OK(DoTestSyncCall(&p, GenericCalculatorService::AddMethod()));
+  ASSERT_OK(client_messenger->reactors_[0]->GetMetrics(&metrics));
+  ASSERT_EQ(1, metrics.num_client_connections_) << "Client should have 1 client connection";
+}
+
 // Test that a call which takes longer than the keepalive time
 // succeeds -- i.e that we don't consider a connection to be "idle" on the
 // server if there is a call outstanding on it.
@@ -89,7 +89,10 @@ bool RpcRetrier::HandleResponse(
     if (err &&
         err->has_code() &&
         err->code() == ErrorStatusPB::ERROR_SERVER_TOO_BUSY) {
-      auto status = DelayedRetry(rpc, controller_status, BackoffStrategy::kExponential);
+      // Honour the delay the server asked for, it knows how overloaded it is.
+      auto status = err->has_retry_after_ms()
+          ? DelayedRetry(rpc, controller_status, MonoDelta::FromMilliseconds(err->retry_after_ms()))
+          : DelayedRetry(rpc, controller_status, BackoffStrategy::kExponential);
       if (!status.ok()) {
         *out_status = status;
         return false;
@@ -104,9 +107,6 @@ bool RpcRetrier::HandleResponse(
 
 Status RpcRetrier::DelayedRetry(
     RpcCommand* rpc, const Status& why_status, BackoffStrategy strategy) {
-  if (!why_status.ok() && (last_error_.ok() || last_error_.IsTimedOut())) {
-    last_error_ = why_status;
-  }
   // Add some jitter to the retry delay.
   //
   // If the delay causes us to miss our deadline, RetryCb will fail the
@@ -118,6 +118,19 @@ Status RpcRetrier::DelayedRetry(
                  FLAGS_min_backoff_ms_exponent + attempt_num_, FLAGS_max_backoff_ms_exponent)
            : attempt_num_) +
       RandomUniformInt(0, 4);
+  return DoDelayedRetry(rpc, why_status, MonoDelta::FromMilliseconds(num_ms));
+}
+
+Status RpcRetrier::DelayedRetry(RpcCommand* rpc, const Status& why_status, MonoDelta delay) {
+  // Jitter keeps the clients that were told to wait the same time from retrying all at once.
+  auto jitter_ms = RandomUniformInt<int64_t>(0, delay.ToMilliseconds() / 10 + 4);
+  return DoDelayedRetry(rpc, why_status, delay + MonoDelta::FromMilliseconds(jitter_ms));
+}
+
+Status RpcRetrier::DoDelayedRetry(RpcCommand* rpc, const Status& why_status, MonoDelta delay) {
+  if (!why_status.ok() && (last_error_.ok() || last_error_.IsTimedOut())) {
+    last_error_ = why_status;
+  }
   attempt_num_++;
 
   RpcRetrierState expected_state = RpcRetrierState::kIdle;
@@ -136,7 +149,7 @@ Status RpcRetrier::DelayedRetry(
 
   auto retain_rpc = rpc->shared_from_this();
   task_id_ = messenger_->ScheduleOnReactor(
-      std::bind(&RpcRetrier::DoRetry, this, rpc, _1), MonoDelta::FromMilliseconds(num_ms),
+      std::bind(&RpcRetrier::DoRetry, this, rpc, _1), delay,
       SOURCE_LOCATION(), messenger_);
 
   // Scheduling state can be changed only in this method, so we expected both
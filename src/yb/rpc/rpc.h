@@ -121,6 +121,9 @@ class RpcRetrier {
       RpcCommand* rpc, const Status& why_status,
       BackoffStrategy strategy = BackoffStrategy::kLinear);
 
+  // Same as above, but retries after the provided delay, e.g. the one the server asked for.
+  CHECKED_STATUS DelayedRetry(RpcCommand* rpc, const Status& why_status, MonoDelta delay);
+
   RpcController* mutable_controller() { return &controller_; }
   const RpcController& controller() const { return controller_; }
 
@@ -152,6 +155,8 @@ class RpcRetrier {
   // Called when an RPC comes up for retrying. Actually sends the RPC.
   void DoRetry(RpcCommand* rpc, const Status& status);
 
+  CHECKED_STATUS DoDelayedRetry(RpcCommand* rpc, const Status& why_status, MonoDelta delay);
+
   // The next sent rpc will be the nth attempt (indexed from 1).
   int attempt_num_ = 1;
 
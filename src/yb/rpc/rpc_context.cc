@@ -157,6 +157,15 @@ void RpcContext::RespondRpcFailure(ErrorStatusPB_RpcErrorCodePB err, const Statu
   responded_ = true;
 }
 
+void RpcContext::RespondBusy(const Status& status, MonoDelta retry_after) {
+  call_->RecordHandlingCompleted(metrics_.handler_latency);
+  TRACE_EVENT_ASYNC_END2("rpc_call", "RPC", this,
+                         "status", status.ToString(),
+                         "trace", trace()->DumpToString(true));
+  call_->RespondBusy(status, retry_after);
+  responded_ = true;
+}
+
 void RpcContext::RespondApplicationError(int error_ext_id, const std::string& message,
                                          const Message& app_error_pb) {
   call_->RecordHandlingCompleted(metrics_.handler_latency);
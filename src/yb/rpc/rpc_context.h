@@ -33,6 +33,9 @@
 #define YB_RPC_RPC_CONTEXT_H
 
 #include <string>
+#include <type_traits>
+
+#include <google/protobuf/arena.h>
 
 #include "yb/gutil/gscoped_ptr.h"
 #include "yb/rpc/local_call.h"
@@ -61,6 +64,43 @@ namespace rpc {
 
 class YBInboundCall;
 
+// The request and the response of an inbound call.
+struct CallMessages {
+  std::shared_ptr<google::protobuf::Message> request;
+  std::shared_ptr<google::protobuf::Message> response;
+};
+
+namespace internal {
+
+template <class Message>
+Message* CreateOnArena(google::protobuf::Arena* arena, std::true_type) {
+  return google::protobuf::Arena::CreateMessage<Message>(arena);
+}
+
+// Messages of the files that do not enable arenas are only placed on the arena, and allocate their
+// fields on the heap.
+template <class Message>
+Message* CreateOnArena(google::protobuf::Arena* arena, std::false_type) {
+  return google::protobuf::Arena::Create<Message>(arena);
+}
+
+} // namespace internal
+
+// Allocates the request and the response of an inbound call on a protobuf arena that lives as long
+// as either of them, so that the nested messages of a large request or response are allocated in a
+// few blocks, instead of one by one.
+template <class Request, class Response>
+CallMessages MakeCallMessages() {
+  using google::protobuf::Arena;
+  auto arena = std::make_shared<Arena>();
+  auto* request = internal::CreateOnArena<Request>(
+      arena.get(), std::integral_constant<bool, Arena::is_arena_constructable<Request>::value>());
+  auto* response = internal::CreateOnArena<Response>(
+      arena.get(), std::integral_constant<bool, Arena::is_arena_constructable<Response>::value>());
+  return CallMessages{std::shared_ptr<google::protobuf::Message>(arena, request),
+                      std::shared_ptr<google::protobuf::Message>(arena, response)};
+}
+
 // The context provided to a generated ServiceIf. This provides
 // methods to respond to the RPC. In the future, this will also
 // include methods to access information about the caller: e.g
@@ -75,6 +115,11 @@ class RpcContext {
              std::shared_ptr<google::protobuf::Message> request_pb,
              std::shared_ptr<google::protobuf::Message> response_pb,
              RpcMethodMetrics metrics);
+  RpcContext(std::shared_ptr<YBInboundCall> call,
+             CallMessages messages,
+             RpcMethodMetrics metrics)
+      : RpcContext(std::move(call), std::move(messages.request), std::move(messages.response),
+                   std::move(metrics)) {}
   RpcContext(std::shared_ptr<LocalYBInboundCall> call,
              RpcMethodMetrics metrics);
 
@@ -127,6 +172,12 @@ class RpcContext {
   // and response protobufs are also destroyed.
   void RespondRpcFailure(ErrorStatusPB_RpcErrorCodePB err, const Status& status);
 
+  // Respond with ERROR_SERVER_TOO_BUSY, and ask the client to wait retry_after before it retries.
+  //
+  // After this method returns, this RpcContext object is destroyed. The request
+  // and response protobufs are also destroyed.
+  void RespondBusy(const Status& status, MonoDelta retry_after);
+
   // Respond with an application-level error. This causes the caller to get a
   // RemoteError status with the provided string message. Additionally, a
   // service-specific error extension is passed back to the client. The
@@ -38,6 +38,7 @@
 
 #include "yb/gutil/macros.h"
 #include "yb/rpc/rpc_fwd.h"
+#include "yb/rpc/rpc_header.pb.h"
 #include "yb/util/locks.h"
 #include "yb/util/monotime.h"
 #include "yb/util/status.h"
@@ -121,6 +122,11 @@ class RpcController {
   // Using an uninitialized deadline means the call won't time out.
   void set_deadline(const MonoTime& deadline);
 
+  // Priority class of the call, RPC_PRIORITY_NORMAL by default. Must be set prior to making the
+  // request.
+  void set_priority(RpcPriorityPB priority) { priority_ = priority; }
+  RpcPriorityPB priority() const { return priority_; }
+
   void set_allow_local_calls_in_curr_thread(bool al) { allow_local_calls_in_curr_thread_ = al; }
   bool allow_local_calls_in_curr_thread() const { return allow_local_calls_in_curr_thread_; }
 
@@ -147,6 +153,7 @@ class RpcController {
   // Once the call is sent, it is tracked here.
   OutboundCallPtr call_;
   bool allow_local_calls_in_curr_thread_ = false;
+  RpcPriorityPB priority_ = RpcPriorityPB::RPC_PRIORITY_NORMAL;
 
   DISALLOW_COPY_AND_ASSIGN(RpcController);
 };
@@ -43,6 +43,21 @@ METRIC_DEFINE_counter(server, rpc_outbound_calls_created,
                       yb::MetricUnit::kRequests,
                       "Number of created RPC outbound calls.");
 
+METRIC_DEFINE_counter(server, rpc_compression_bytes_saved,
+                      "Bytes saved by RPC compression.",
+                      yb::MetricUnit::kBytes,
+                      "Number of bytes by which compression reduced sent RPC messages.");
+
+METRIC_DEFINE_counter(server, rpc_compression_time_us,
+                      "Time spent compressing RPC messages.",
+                      yb::MetricUnit::kMicroseconds,
+                      "Time spent compressing RPC messages.");
+
+METRIC_DEFINE_counter(server, rpc_decompression_time_us,
+                      "Time spent decompressing RPC messages.",
+                      yb::MetricUnit::kMicroseconds,
+                      "Time spent decompressing RPC messages.");
+
 namespace yb {
 namespace rpc {
 
@@ -54,6 +69,9 @@ RpcMetrics::RpcMetrics(const scoped_refptr<MetricEntity>& metric_entity) {
     inbound_calls_created = METRIC_rpc_inbound_calls_created.Instantiate(metric_entity);
     outbound_calls_alive = METRIC_rpc_outbound_calls_alive.Instantiate(metric_entity, 0);
     outbound_calls_created = METRIC_rpc_outbound_calls_created.Instantiate(metric_entity);
+    compression_bytes_saved = METRIC_rpc_compression_bytes_saved.Instantiate(metric_entity);
+    compression_time_us = METRIC_rpc_compression_time_us.Instantiate(metric_entity);
+    decompression_time_us = METRIC_rpc_decompression_time_us.Instantiate(metric_entity);
   }
 }
 
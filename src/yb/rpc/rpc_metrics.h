@@ -28,6 +28,9 @@ struct RpcMetrics {
   scoped_refptr<Counter> inbound_calls_created;
   scoped_refptr<AtomicGauge<int64_t>> outbound_calls_alive;
   scoped_refptr<Counter> outbound_calls_created;
+  scoped_refptr<Counter> compression_bytes_saved;
+  scoped_refptr<Counter> compression_time_us;
+  scoped_refptr<Counter> decompression_time_us;
 };
 
 } // namespace rpc
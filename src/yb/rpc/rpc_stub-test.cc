@@ -39,6 +39,7 @@
 
 #include "yb/gutil/stl_util.h"
 #include "yb/rpc/rpc_introspection.pb.h"
+#include "yb/rpc/rpc_metrics.h"
 #include "yb/rpc/rtest.proxy.h"
 #include "yb/rpc/rtest.service.h"
 #include "yb/rpc/rpc-test-base.h"
@@ -56,6 +57,7 @@ DEFINE_bool(is_panic_test_child, false, "Used by TestRpcPanic");
 DECLARE_bool(socket_inject_short_recvs);
 DECLARE_int32(rpc_slow_query_threshold_ms);
 DECLARE_int32(TEST_delay_connect_ms);
+DECLARE_string(rpc_compression_policy);
 
 using namespace std::chrono_literals;
 
@@ -303,6 +305,42 @@ TEST_F(RpcStubTest, TestBigCallData) {
   }
 }
 
+// Test that requests and responses are compressed once the peers have told each other that they
+// accept compression, and only when the policy allows it.
+TEST_F(RpcStubTest, Compression) {
+  FLAGS_rpc_compression_policy = "always";
+  CalculatorServiceProxy p(proxy_cache_.get(), server_hostport_);
+
+  EchoRequestPB req;
+  req.set_data(std::string(64_KB, 'x'));
+
+  auto echo = [&p, &req] {
+    RpcController controller;
+    EchoResponsePB resp;
+    ASSERT_OK(p.Echo(req, &resp, &controller));
+    ASSERT_EQ(req.data(), resp.data());
+  };
+  auto& client_saved = *client_messenger_->rpc_metrics().compression_bytes_saved;
+  auto& server_saved = *server_messenger().rpc_metrics().compression_bytes_saved;
+
+  // The first request tells the server that the client accepts compression, so only the response
+  // is compressed.
+  ASSERT_NO_FATALS(echo());
+  ASSERT_EQ(0, client_saved.value());
+  ASSERT_GT(server_saved.value(), 0);
+
+  ASSERT_NO_FATALS(echo());
+  ASSERT_GT(client_saved.value(), 0);
+
+  // Both ends are on the loopback address, i.e. in the same subnet.
+  FLAGS_rpc_compression_policy = "other_subnets";
+  const auto client_saved_before = client_saved.value();
+  const auto server_saved_before = server_saved.value();
+  ASSERT_NO_FATALS(echo());
+  ASSERT_EQ(client_saved_before, client_saved.value());
+  ASSERT_EQ(server_saved_before, server_saved.value());
+}
+
 TEST_F(RpcStubTest, TestRespondDeferred) {
   CalculatorServiceProxy p(proxy_cache_.get(), server_hostport_);
 
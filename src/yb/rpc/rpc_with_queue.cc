@@ -66,15 +66,28 @@ void ConnectionContextWithQueue::Enqueue(std::shared_ptr<QueueableInboundCall> c
   if (size == replies_being_sent_ + 1) {
     first_without_reply_.store(call.get(), std::memory_order_release);
   }
-  if (size <= max_concurrent_calls_) {
+  StartCalls(reactor);
+}
+
+void ConnectionContextWithQueue::StartCalls(Reactor* reactor) {
+  while (started_calls_ < calls_queue_.size() && started_calls_ < max_concurrent_calls_) {
+    const auto& call = calls_queue_[started_calls_];
+    const bool exclusive = !call->CanRunConcurrently();
+    if (started_calls_ != 0 && (exclusive || started_exclusive_calls_ != 0)) {
+      break;
+    }
+    ++started_calls_;
+    if (exclusive) {
+      ++started_exclusive_calls_;
+    }
     reactor->messenger()->QueueInboundCall(call);
   }
 }
 
 void ConnectionContextWithQueue::Shutdown(const Status& status) {
   // Could erase calls, that we did not start to process yet.
-  if (calls_queue_.size() > max_concurrent_calls_) {
-    calls_queue_.erase(calls_queue_.begin() + max_concurrent_calls_, calls_queue_.end());
+  if (calls_queue_.size() > started_calls_) {
+    calls_queue_.erase(calls_queue_.begin() + started_calls_, calls_queue_.end());
   }
 
   for (auto& call : calls_queue_) {
@@ -95,12 +108,13 @@ void ConnectionContextWithQueue::CallProcessed(InboundCall* call) {
   auto call_weight_in_bytes = down_cast<QueueableInboundCall*>(call)->weight_in_bytes();
   queued_bytes_ -= call_weight_in_bytes;
 
+  if (!calls_queue_.front()->CanRunConcurrently()) {
+    --started_exclusive_calls_;
+  }
   calls_queue_.pop_front();
   --replies_being_sent_;
-  if (calls_queue_.size() >= max_concurrent_calls_) {
-    auto call_ptr = calls_queue_[max_concurrent_calls_ - 1];
-    reactor->messenger()->QueueInboundCall(call_ptr);
-  }
+  --started_calls_;
+  StartCalls(reactor);
   if (Idle() && idle_listener_) {
     idle_listener_();
   }
@@ -53,6 +53,11 @@ class QueueableInboundCall : public InboundCall {
   // `weight_in_bytes` function is used to determine how many bytes consumes this call.
   size_t weight_in_bytes() const { return weight_in_bytes_; }
 
+  // Whether this call could be processed while other calls of the same connection are being
+  // processed. A call that could not is started only after all calls before it are processed,
+  // and no call after it is started until it is processed.
+  virtual bool CanRunConcurrently() const { return true; }
+
  private:
   std::atomic<bool> has_reply_{false};
   std::atomic<bool> aborted_{false};
@@ -92,6 +97,7 @@ class ConnectionContextWithQueue : public ConnectionContextBase {
   void ListenIdle(IdleListener listener) override { idle_listener_ = std::move(listener); }
 
   void CallProcessed(InboundCall* call);
+  void StartCalls(Reactor* reactor);
   void FlushOutboundQueue(Connection* conn);
   void FlushOutboundQueueAborted(const Status& status);
 
@@ -99,12 +105,17 @@ class ConnectionContextWithQueue : public ConnectionContextBase {
   const size_t max_queued_bytes_;
   size_t replies_being_sent_ = 0;
   size_t queued_bytes_ = 0;
+  // Number of calls at the top of the queue whose processing was started.
+  size_t started_calls_ = 0;
+  // Number of started calls that could not run concurrently with other calls.
+  size_t started_exclusive_calls_ = 0;
 
   // Calls that are being processed by this connection/context.
   // At the top or queue there are replies_being_sent_ calls, for which we are sending reply.
   // After that there are calls that are being processed.
   // first_without_reply_ points to the first of them.
-  // There are not more than max_concurrent_calls_ entries in first two groups.
+  // There are not more than max_concurrent_calls_ entries in first two groups, i.e. started_calls_,
+  // and fewer when some of them could not run concurrently.
   // After end of queue there are calls that we received but processing did not start for them.
   std::deque<std::shared_ptr<QueueableInboundCall>> calls_queue_;
   std::shared_ptr<ReactorTask> flush_outbound_queue_task_;
@@ -18,27 +18,41 @@
 #include <boost/asio/steady_timer.hpp>
 #include <boost/asio/strand.hpp>
 
-#include <boost/multi_index_container.hpp>
-#include <boost/multi_index/hashed_index.hpp>
-#include <boost/multi_index/mem_fun.hpp>
-#include <boost/multi_index/ordered_index.hpp>
-
 #include <glog/logging.h>
 
+#include "yb/rpc/timer_wheel.h"
+
+#include "yb/util/metrics.h"
 #include "yb/util/status.h"
 
 using namespace std::placeholders;
-using boost::multi_index::const_mem_fun;
-using boost::multi_index::hashed_unique;
-using boost::multi_index::ordered_non_unique;
+using namespace std::literals;
+
+METRIC_DEFINE_histogram(server, rpc_scheduler_hold_time,
+                        "RPC Scheduler Hold Time",
+                        yb::MetricUnit::kMicroseconds,
+                        "Number of microseconds each operation of the RPC scheduler holds its "
+                        "strand, i.e. blocks other scheduling operations",
+                        60000000LU, 2);
 
 namespace yb {
 namespace rpc {
 
+namespace {
+
+// Granularity of the timer wheel. Tasks never run before their time, and usually run within one
+// tick after it.
+constexpr auto kTick = 1ms;
+
+} // namespace
+
 class Scheduler::Impl {
  public:
-  explicit Impl(IoService* io_service)
-      : io_service_(*io_service), strand_(*io_service), timer_(*io_service) {}
+  Impl(IoService* io_service, const scoped_refptr<MetricEntity>& metric_entity)
+      : io_service_(*io_service), strand_(*io_service), timer_(*io_service),
+        start_(std::chrono::steady_clock::now()),
+        hold_time_(metric_entity ? METRIC_rpc_scheduler_hold_time.Instantiate(metric_entity)
+                                 : scoped_refptr<Histogram>()) {}
 
   ~Impl() {
     Shutdown();
@@ -48,11 +62,10 @@ class Scheduler::Impl {
 
   void Abort(ScheduledTaskId task_id) {
     strand_.dispatch([this, task_id] {
-      auto& index = tasks_.get<IdTag>();
-      auto it = index.find(task_id);
-      if (it != index.end()) {
-        io_service_.post([task = *it] { task->Run(STATUS(Aborted, "Task aborted")); });
-        index.erase(it);
+      ScopedHold hold(this);
+      std::shared_ptr<ScheduledTaskBase> task;
+      if (tasks_.Erase(task_id, &task)) {
+        io_service_.post([task] { task->Run(STATUS(Aborted, "Task aborted")); });
       }
     });
   }
@@ -61,23 +74,27 @@ class Scheduler::Impl {
     bool old_value = false;
     if (closing_.compare_exchange_strong(old_value, true)) {
       strand_.dispatch([this] {
+        ScopedHold hold(this);
         boost::system::error_code ec;
         timer_.cancel(ec);
         LOG_IF(ERROR, ec) << "Failed to cancel timer: " << ec.message();
+        timer_tick_ = kTimerNotSet;
 
         auto status = STATUS(ServiceUnavailable, "Scheduler is shutting down", "", ESHUTDOWN);
         // Abort all scheduled tasks. It is ok to run task earlier than it was scheduled because
         // we pass error status to it.
-        for (auto task : tasks_) {
+        std::vector<std::shared_ptr<ScheduledTaskBase>> tasks;
+        tasks_.Clear(&tasks);
+        for (auto& task : tasks) {
           io_service_.post([task, status] { task->Run(status); });
         }
-        tasks_.clear();
       });
     }
   }
 
   void DoSchedule(std::shared_ptr<ScheduledTaskBase> task) {
     strand_.dispatch([this, task] {
+      ScopedHold hold(this);
       if (closing_.load(std::memory_order_acquire)) {
         io_service_.post([task] {
           task->Run(STATUS(Aborted, "Scheduler shutdown", "", ESHUTDOWN));
@@ -85,10 +102,14 @@ class Scheduler::Impl {
         return;
       }
 
-      auto pair = tasks_.insert(task);
-      CHECK(pair.second);
-      if (pair.first == tasks_.begin()) {
-        StartTimer();
+      Advance();
+      const int64_t tick = TickAfter(task->time());
+      if (!tasks_.Insert(task->id(), tick, task)) {
+        io_service_.post([task] { task->Run(Status::OK()); });
+        return;
+      }
+      if (timer_tick_ == kTimerNotSet || tick < timer_tick_) {
+        StartTimer(tick);
       }
     });
   }
@@ -98,21 +119,61 @@ class Scheduler::Impl {
   }
 
  private:
-  void StartTimer() {
+  static constexpr int64_t kTimerNotSet = -1;
+
+  // Records how long the enclosing strand handler runs.
+  class ScopedHold {
+   public:
+    explicit ScopedHold(Impl* impl)
+        : impl_(impl),
+          start_(impl->hold_time_ ? std::chrono::steady_clock::now() : SteadyTimePoint()) {}
+
+    ~ScopedHold() {
+      if (impl_->hold_time_) {
+        impl_->hold_time_->Increment(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start_).count());
+      }
+    }
+
+   private:
+    Impl* impl_;
+    SteadyTimePoint start_;
+  };
+
+  // Returns the first tick that is not before 'time'.
+  int64_t TickAfter(SteadyTimePoint time) const {
+    if (time <= start_) {
+      return 0;
+    }
+    return (time - start_ + kTick - std::chrono::steady_clock::duration(1)) / kTick;
+  }
+
+  // Moves the wheel to the current time and runs the tasks that are due.
+  void Advance() {
+    std::vector<std::shared_ptr<ScheduledTaskBase>> expired;
+    tasks_.Advance((std::chrono::steady_clock::now() - start_) / kTick, &expired);
+    for (auto& task : expired) {
+      io_service_.post([task] { task->Run(Status::OK()); });
+    }
+  }
+
+  void StartTimer(int64_t tick) {
     DCHECK(strand_.running_in_this_thread());
-    DCHECK(!tasks_.empty());
 
     boost::system::error_code ec;
-    timer_.expires_at((*tasks_.begin())->time(), ec);
+    timer_.expires_at(start_ + tick * kTick, ec);
     LOG_IF(ERROR, ec) << "Reschedule timer failed: " << ec.message();
+    timer_tick_ = tick;
     ++timer_counter_;
     timer_.async_wait(strand_.wrap(std::bind(&Impl::HandleTimer, this, _1)));
   }
 
   void HandleTimer(const boost::system::error_code& ec) {
     DCHECK(strand_.running_in_this_thread());
+    ScopedHold hold(this);
     --timer_counter_;
 
+    // The wait is aborted when the timer is started again, the new wait takes its place.
     if (ec) {
       LOG_IF(ERROR, ec != boost::asio::error::operation_aborted) << "Wait failed: " << ec.message();
       return;
@@ -121,43 +182,36 @@ class Scheduler::Impl {
       return;
     }
 
-    auto now = std::chrono::steady_clock::now();
-    while (!tasks_.empty() && (*tasks_.begin())->time() <= now) {
-      io_service_.post([task = *tasks_.begin()] { task->Run(Status::OK()); });
-      tasks_.erase(tasks_.begin());
-    }
+    timer_tick_ = kTimerNotSet;
+    Advance();
 
-    if (!tasks_.empty()) {
-      StartTimer();
+    int64_t next_tick;
+    if (tasks_.NextTick(&next_tick)) {
+      StartTimer(next_tick);
     }
   }
 
-  class IdTag;
-
-  typedef boost::multi_index_container<
-      std::shared_ptr<ScheduledTaskBase>,
-      boost::multi_index::indexed_by<
-          ordered_non_unique<
-              const_mem_fun<ScheduledTaskBase, SteadyTimePoint, &ScheduledTaskBase::time>
-          >,
-          hashed_unique<
-              boost::multi_index::tag<IdTag>,
-              const_mem_fun<ScheduledTaskBase, ScheduledTaskId, &ScheduledTaskBase::id>
-          >
-      >
-  > Tasks;
-
   IoService& io_service_;
   std::atomic<ScheduledTaskId> id_ = {0};
-  Tasks tasks_;
-  // Strand that protects tasks_ and timer_ fields.
+  // Scheduled tasks, by id and by the tick they should run at, in ticks of kTick since start_.
+  TimerWheel<ScheduledTaskId, std::shared_ptr<ScheduledTaskBase>> tasks_;
+  // Strand that protects tasks_, timer_ and timer_tick_ fields.
   boost::asio::io_service::strand strand_;
   boost::asio::steady_timer timer_;
+  // Tick the timer is set to, kTimerNotSet if it is not waiting.
+  int64_t timer_tick_ = kTimerNotSet;
   int timer_counter_ = 0;
   std::atomic<bool> closing_ = {false};
+  const SteadyTimePoint start_;
+  scoped_refptr<Histogram> hold_time_;
 };
 
-Scheduler::Scheduler(IoService* io_service) : impl_(new Impl(io_service)) {}
+constexpr int64_t Scheduler::Impl::kTimerNotSet;
+
+Scheduler::Scheduler(IoService* io_service) : impl_(new Impl(io_service, nullptr)) {}
+
+Scheduler::Scheduler(IoService* io_service, const scoped_refptr<MetricEntity>& metric_entity)
+    : impl_(new Impl(io_service, metric_entity)) {}
 Scheduler::~Scheduler() {}
 
 void Scheduler::Shutdown() {
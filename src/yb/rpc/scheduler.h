@@ -20,6 +20,7 @@
 
 namespace yb {
 
+class MetricEntity;
 class Status;
 
 namespace rpc {
@@ -59,6 +60,9 @@ class ScheduledTask : public ScheduledTaskBase {
 class Scheduler {
  public:
   explicit Scheduler(IoService* io_service);
+
+  // Also exports how long the operations of the scheduler hold its strand to 'metric_entity'.
+  Scheduler(IoService* io_service, const scoped_refptr<MetricEntity>& metric_entity);
   ~Scheduler();
 
   template<class F>
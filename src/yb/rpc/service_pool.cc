@@ -32,7 +32,10 @@
 
 #include "yb/rpc/service_pool.h"
 
+#include <array>
 #include <memory>
+#include <mutex>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -47,7 +50,9 @@
 #include "yb/rpc/tasks_pool.h"
 
 #include "yb/gutil/strings/substitute.h"
+#include "yb/util/distributed_trace.h"
 #include "yb/util/flag_tags.h"
+#include "yb/util/memory/request_arena.h"
 #include "yb/util/metrics.h"
 #include "yb/util/status.h"
 #include "yb/util/thread.h"
@@ -76,6 +81,27 @@ METRIC_DEFINE_histogram(server, rpc_incoming_queue_time,
                         "Number of microseconds incoming RPC requests spend in the worker queue",
                         60000000LU, 3);
 
+METRIC_DEFINE_histogram(server, rpc_incoming_queue_time_low_priority,
+                        "RPC Queue Time of Low Priority Calls",
+                        yb::MetricUnit::kMicroseconds,
+                        "Number of microseconds incoming low priority RPC requests spend in the "
+                        "worker queue",
+                        60000000LU, 3);
+
+METRIC_DEFINE_histogram(server, rpc_incoming_queue_time_normal_priority,
+                        "RPC Queue Time of Normal Priority Calls",
+                        yb::MetricUnit::kMicroseconds,
+                        "Number of microseconds incoming normal priority RPC requests spend in the "
+                        "worker queue",
+                        60000000LU, 3);
+
+METRIC_DEFINE_histogram(server, rpc_incoming_queue_time_high_priority,
+                        "RPC Queue Time of High Priority Calls",
+                        yb::MetricUnit::kMicroseconds,
+                        "Number of microseconds incoming high priority RPC requests spend in the "
+                        "worker queue",
+                        60000000LU, 3);
+
 METRIC_DEFINE_counter(server, rpcs_timed_out_in_queue,
                       "RPC Queue Timeouts",
                       yb::MetricUnit::kRequests,
@@ -96,10 +122,11 @@ namespace {
 static constexpr CoarseMonoClock::Duration kNone{
     CoarseTimePoint::min().time_since_epoch()};
 
+// Task does not carry a call, it handles the best queued one at the moment it runs.
+// There is exactly one task per queued call, so the queue cannot be empty when a task runs.
 class InboundCallTask final {
  public:
-  InboundCallTask(ServicePoolImpl* pool, InboundCallPtr call)
-      : pool_(pool), call_(std::move(call)) {
+  explicit InboundCallTask(ServicePoolImpl* pool) : pool_(pool) {
   }
 
   void Run();
@@ -107,7 +134,6 @@ class InboundCallTask final {
 
  private:
   ServicePoolImpl* pool_;
-  InboundCallPtr call_;
 };
 
 } // namespace
@@ -121,13 +147,21 @@ class ServicePoolImpl {
       : thread_pool_(thread_pool),
         service_(std::move(service)),
         incoming_queue_time_(METRIC_rpc_incoming_queue_time.Instantiate(entity)),
+        priority_queue_time_{{
+            METRIC_rpc_incoming_queue_time_low_priority.Instantiate(entity),
+            METRIC_rpc_incoming_queue_time_normal_priority.Instantiate(entity),
+            METRIC_rpc_incoming_queue_time_high_priority.Instantiate(entity)}},
         rpcs_timed_out_in_queue_(METRIC_rpcs_timed_out_in_queue.Instantiate(entity)),
         rpcs_queue_overflow_(METRIC_rpcs_queue_overflow.Instantiate(entity)),
-        tasks_pool_(max_tasks) {
+        max_queued_calls_(max_tasks),
+        // Besides the tasks of queued calls, each worker could hold the task it just ran.
+        tasks_pool_(max_tasks + thread_pool->options().max_workers) {
   }
 
   ~ServicePoolImpl() {
     Shutdown();
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    queue_.clear();
   }
 
   void Shutdown() {
@@ -140,9 +174,39 @@ class ServicePoolImpl {
   void Enqueue(InboundCallPtr call) {
     TRACE_TO(call->trace(), "Inserting onto call queue");
 
-    if (!tasks_pool_.Enqueue(thread_pool_, this, std::move(call))) {
-      Overflow(call, "service", tasks_pool_.size());
+    {
+      std::lock_guard<std::mutex> lock(queue_mutex_);
+      if (queue_.size() < max_queued_calls_) {
+        queue_.insert(QueuedCall{
+            call->priority(), call->GetClientDeadline(), next_serial_no_++, call});
+        call = nullptr;
+      }
     }
+    if (call) {
+      Overflow(call, "service", max_queued_calls_);
+      return;
+    }
+
+    if (!tasks_pool_.Enqueue(thread_pool_, this)) {
+      // Should not happen, since the pool has enough tasks for all queued calls. But if it does,
+      // keep one task per queued call by dropping the least urgent one.
+      auto worst = PopQueuedCall(false /* best */);
+      if (worst) {
+        Overflow(worst, "service", max_queued_calls_);
+      }
+    }
+  }
+
+  // Removes the most urgent queued call if 'best' is true, the least urgent one otherwise.
+  InboundCallPtr PopQueuedCall(bool best) {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    if (queue_.empty()) {
+      return nullptr;
+    }
+    auto it = best ? queue_.begin() : std::prev(queue_.end());
+    auto result = it->call;
+    queue_.erase(it);
+    return result;
   }
 
   const Counter* RpcsTimedOutInQueueMetricForTests() const {
@@ -191,7 +255,11 @@ class ServicePoolImpl {
 
   void Handle(InboundCallPtr incoming) {
     incoming->RecordHandlingStarted(incoming_queue_time_);
+    priority_queue_time_[incoming->priority()]->Increment(
+        incoming->GetTimeInQueue().ToMicroseconds());
     ADOPT_TRACE(incoming->trace());
+    // Work done for the call, like the RPCs that it makes, becomes part of its span.
+    ScopedTraceContext trace_context(incoming->trace_context());
 
     if (PREDICT_FALSE(incoming->ClientTimedOut() || ShouldDropRequestDuringHighLoad(incoming))) {
       const char* message =
@@ -211,10 +279,33 @@ class ServicePoolImpl {
 
     TRACE_TO(incoming->trace(), "Handling call");
 
+    // Temporary objects of the synchronous part of the handler come from a thread local arena.
+    ScopedRequestArena request_arena;
     service_->Handle(std::move(incoming));
   }
 
  private:
+  // Calls waiting for a worker. Raft traffic and other high priority calls go first, calls of the
+  // same priority are handled earliest deadline first, and in arrival order when deadlines match.
+  struct QueuedCall {
+    RpcPriorityPB priority;
+    CoarseTimePoint deadline;
+    uint64_t serial_no;
+    InboundCallPtr call;
+  };
+
+  struct QueuedCallComparator {
+    bool operator()(const QueuedCall& lhs, const QueuedCall& rhs) const {
+      if (lhs.priority != rhs.priority) {
+        return lhs.priority > rhs.priority;
+      }
+      if (lhs.deadline != rhs.deadline) {
+        return lhs.deadline < rhs.deadline;
+      }
+      return lhs.serial_no < rhs.serial_no;
+    }
+  };
+
   bool ShouldDropRequestDuringHighLoad(InboundCallPtr incoming) {
     auto last_backpressure_at = last_backpressure_at_.load(std::memory_order_acquire);
 
@@ -240,21 +331,38 @@ class ServicePoolImpl {
   ThreadPool* thread_pool_;
   ServiceIfPtr service_;
   scoped_refptr<Histogram> incoming_queue_time_;
+  std::array<scoped_refptr<Histogram>, RpcPriorityPB_ARRAYSIZE> priority_queue_time_;
   scoped_refptr<Counter> rpcs_timed_out_in_queue_;
   scoped_refptr<Counter> rpcs_queue_overflow_;
   std::atomic<CoarseMonoClock::Duration> last_backpressure_at_;
 
   std::atomic<bool> closing_ = {false};
+
+  const size_t max_queued_calls_;
+  std::mutex queue_mutex_;
+  std::set<QueuedCall, QueuedCallComparator> queue_;
+  uint64_t next_serial_no_ = 0;
+
   TasksPool<InboundCallTask> tasks_pool_;
 };
 
 void InboundCallTask::Run() {
-  pool_->Handle(call_);
+  auto call = pool_->PopQueuedCall(true /* best */);
+  if (call) {
+    pool_->Handle(std::move(call));
+  }
 }
 
 void InboundCallTask::Done(const Status& status) {
-  InboundCallPtr call = call_;
-  pool_->Processed(call, status);
+  if (status.ok()) {
+    return;
+  }
+  // The task did not run, so there is one queued call more than there are tasks. Drop the least
+  // urgent one.
+  auto call = pool_->PopQueuedCall(false /* best */);
+  if (call) {
+    pool_->Processed(call, status);
+  }
 }
 
 ServicePool::ServicePool(size_t max_tasks,
@@ -53,6 +53,8 @@ class Stream {
   virtual size_t GetPendingWriteBytes() = 0;
 
   virtual bool Idle(std::string* reason_not_idle) = 0;
+  // Releases the memory that an idle stream does not need.
+  virtual void ReleaseIdleBuffers() = 0;
   virtual bool IsConnected() = 0;
   virtual void DumpPB(const DumpRunningRpcsRequestPB& req, RpcConnectionPB* resp) = 0;
 
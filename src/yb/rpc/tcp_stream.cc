@@ -24,6 +24,11 @@ using namespace std::literals;
 DECLARE_uint64(rpc_connection_timeout_ms);
 DEFINE_test_flag(int32, TEST_delay_connect_ms, 0,
                  "Delay connect in tests for specified amount of milliseconds.");
+DEFINE_int64(rpc_zero_copy_send_threshold_bytes, 0,
+             "Sends of at least this many bytes are done with MSG_ZEROCOPY, so that the kernel "
+             "does not copy the data into socket buffers. Only worth it for large responses, "
+             "like remote bootstrap file pieces and big scan pages. 0 disables zero copy.");
+TAG_FLAG(rpc_zero_copy_send_threshold_bytes, advanced);
 
 namespace yb {
 namespace rpc {
@@ -58,6 +63,11 @@ Status TcpStream::Start(bool connect, ev::loop_ref* loop, StreamContext* context
   RETURN_NOT_OK(socket_.SetNoDelay(true));
   RETURN_NOT_OK(socket_.SetSendTimeout(FLAGS_rpc_connection_timeout_ms * 1ms));
   RETURN_NOT_OK(socket_.SetRecvTimeout(FLAGS_rpc_connection_timeout_ms * 1ms));
+  if (FLAGS_rpc_zero_copy_send_threshold_bytes > 0) {
+    auto status = socket_.SetZeroCopy(true);
+    zero_copy_enabled_ = status.ok();
+    YB_LOG_IF_EVERY_N(INFO, !status.ok(), 100) << "Zero copy send not available: " << status;
+  }
 
   if (connect && FLAGS_TEST_delay_connect_ms) {
     connect_delayer_.set(*loop);
@@ -86,6 +96,7 @@ Status TcpStream::DoStart(ev::loop_ref* loop, bool connect) {
   io_.set<TcpStream, &TcpStream::Handler>(this);
   int events = ev::READ | (!connected_ ? ev::WRITE : 0);
   io_.start(socket_.GetFd(), events);
+  events_ = events;
 
   DVLOG_WITH_PREFIX(4) << "Starting, listen events: " << events << ", fd: " << socket_.GetFd();
 
@@ -131,6 +142,7 @@ void TcpStream::Shutdown(const Status& status) {
   read_buffer_.Reset();
 
   WARN_NOT_OK(socket_.Close(), "Error closing socket");
+  zero_copy_pending_.clear();
 }
 
 Status TcpStream::TryWrite() {
@@ -141,7 +153,7 @@ Status TcpStream::TryWrite() {
   return result;
 }
 
-int TcpStream::FillIov(iovec* out) {
+int TcpStream::FillIov(iovec* out, size_t* total_size) {
   int index = 0;
   size_t offset = send_position_;
   for (auto& data : sending_) {
@@ -157,6 +169,7 @@ int TcpStream::FillIov(iovec* out) {
 
       out[index].iov_base = bytes.data() + offset;
       out[index].iov_len = bytes.size() - offset;
+      *total_size += out[index].iov_len;
       offset = 0;
       if (++index == kMaxIov) {
         return index;
@@ -175,12 +188,19 @@ Status TcpStream::DoWrite() {
   // If we weren't waiting write to be ready, we could try to write data to socket.
   while (!sending_.empty()) {
     iovec iov[kMaxIov];
-    int iov_len = FillIov(iov);
+    size_t iov_size = 0;
+    int iov_len = FillIov(iov, &iov_size);
 
     context_->UpdateLastActivity();
 
     int32_t written = 0;
-    auto status = iov_len != 0 ? socket_.Writev(iov, iov_len, &written) : Status::OK();
+    const bool zero_copy = zero_copy_enabled_ && iov_len != 0 &&
+        iov_size >= static_cast<size_t>(FLAGS_rpc_zero_copy_send_threshold_bytes);
+    Status status;
+    if (iov_len != 0) {
+      status = zero_copy ? socket_.WritevZeroCopy(iov, iov_len, &written)
+                         : socket_.Writev(iov, iov_len, &written);
+    }
     DVLOG_WITH_PREFIX(4) << "Queued writes " << queued_bytes_to_send_ << " bytes. written "
                          << written << " . Status " << status << " sending_ .size() "
                          << sending_.size();
@@ -194,6 +214,15 @@ Status TcpStream::DoWrite() {
       }
     }
 
+    if (zero_copy) {
+      // The kernel now references the buffers of everything we are sending, so they have to be
+      // kept until the completion of this send.
+      ++zero_copy_next_id_;
+      for (auto& data : sending_) {
+        data.zero_copy = true;
+      }
+    }
+
     send_position_ += written;
     while (!sending_.empty()) {
       auto& front = sending_.front();
@@ -209,6 +238,9 @@ Status TcpStream::DoWrite() {
       auto data = front.data;
       send_position_ -= full_size;
       queued_bytes_to_send_ -= full_size;
+      if (front.zero_copy) {
+        zero_copy_pending_.emplace_back(zero_copy_next_id_ - 1, std::move(front.bytes));
+      }
       sending_.pop_front();
       if (data) {
         context_->Transferred(data, Status::OK());
@@ -226,6 +258,12 @@ void TcpStream::Handler(ev::io& watcher, int revents) {  // NOLINT
     status = STATUS(NetworkError, ToString() + ": Handler encountered an error");
   }
 
+  // Completions are reported by the error queue of the socket, which wakes us up as readable or
+  // writable.
+  if (status.ok() && zero_copy_completed_ != zero_copy_next_id_) {
+    status = ProcessZeroCopyCompletions();
+  }
+
   if (status.ok() && (revents & ev::READ)) {
     status = ReadHandler();
   }
@@ -246,6 +284,40 @@ void TcpStream::Handler(ev::io& watcher, int revents) {  // NOLINT
   }
 }
 
+Status TcpStream::ProcessZeroCopyCompletions() {
+  for (;;) {
+    auto completion = VERIFY_RESULT(socket_.ReadZeroCopyCompletion());
+    if (!completion) {
+      break;
+    }
+    if (completion->copied && zero_copy_enabled_) {
+      // The kernel copies anyway, e.g. on loopback, so zero copy only adds overhead.
+      VLOG_WITH_PREFIX(1) << "Zero copy send fell back to copying, disabling it";
+      zero_copy_enabled_ = false;
+    }
+    // Sends complete in order in practice, so we keep track of completed ids as ranges, merging
+    // them as soon as they are contiguous.
+    uint32_t last = completion->last_id;
+    if (zero_copy_out_of_order_.empty() && completion->first_id == zero_copy_completed_) {
+      zero_copy_completed_ = last + 1;
+    } else {
+      zero_copy_out_of_order_.emplace(completion->first_id, last);
+    }
+    while (!zero_copy_out_of_order_.empty() &&
+           zero_copy_out_of_order_.begin()->first == zero_copy_completed_) {
+      zero_copy_completed_ = zero_copy_out_of_order_.begin()->second + 1;
+      zero_copy_out_of_order_.erase(zero_copy_out_of_order_.begin());
+    }
+  }
+
+  // Ids are compared with wraparound, since they are 32 bit counters.
+  while (!zero_copy_pending_.empty() &&
+         static_cast<int32_t>(zero_copy_pending_.front().first - zero_copy_completed_) < 0) {
+    zero_copy_pending_.pop_front();
+  }
+  return Status::OK();
+}
+
 void TcpStream::UpdateEvents() {
   int events = 0;
   if (!read_buffer_full_) {
@@ -255,8 +327,11 @@ void TcpStream::UpdateEvents() {
   if (waiting_write_ready_) {
     events |= ev::WRITE;
   }
-  if (events) {
+  // Setting the events makes libev modify the epoll registration of the socket on the next loop
+  // iteration, even when they did not change, so we only do it when they did.
+  if (events && events != events_) {
     io_.set(events);
+    events_ = events;
   }
 }
 
@@ -264,7 +339,8 @@ Status TcpStream::ReadHandler() {
   context_->UpdateLastActivity();
 
   for (;;) {
-    auto received = Receive();
+    bool drained = false;
+    auto received = Receive(&drained);
     if (PREDICT_FALSE(!received.ok())) {
       if (received.status().error_code() == ESHUTDOWN) {
         VLOG_WITH_PREFIX(1) << "Shut down by remote end.";
@@ -283,13 +359,15 @@ Status TcpStream::ReadHandler() {
     if (!continue_receiving.ok()) {
       return continue_receiving.status();
     }
-    if (!continue_receiving.get()) {
+    // The socket is level triggered, so after a short read we will be notified of new data anyway,
+    // and trying to receive again would most likely just fail with EAGAIN.
+    if (!continue_receiving.get() || drained) {
       return Status::OK();
     }
   }
 }
 
-Result<bool> TcpStream::Receive() {
+Result<bool> TcpStream::Receive(bool* drained) {
   auto iov = read_buffer_.valid() ? read_buffer_.PrepareAppend()
                                   : STATUS(IllegalState, "Read buffer was reset");
   if (!iov.ok()) {
@@ -309,6 +387,12 @@ Result<bool> TcpStream::Receive() {
     return nread.status();
   }
 
+  size_t capacity = 0;
+  for (const auto& vec : *iov) {
+    capacity += vec.iov_len;
+  }
+  *drained = static_cast<size_t>(*nread) < capacity;
+
   read_buffer_.DataAppended(*nread);
   return *nread != 0;
 }
@@ -359,6 +443,10 @@ const std::string& TcpStream::LogPrefix() const {
   return log_prefix_;
 }
 
+void TcpStream::ReleaseIdleBuffers() {
+  read_buffer_.Shrink();
+}
+
 bool TcpStream::Idle(std::string* reason_not_idle) {
   bool result = true;
   // Check if we're in the middle of receiving something.
@@ -377,6 +465,13 @@ bool TcpStream::Idle(std::string* reason_not_idle) {
     result = false;
   }
 
+  if (zero_copy_completed_ != zero_copy_next_id_) {
+    if (reason_not_idle) {
+      AppendWithSeparator("zero copy sends in flight", reason_not_idle);
+    }
+    result = false;
+  }
+
   return result;
 }
 
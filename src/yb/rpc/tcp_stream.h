@@ -14,6 +14,10 @@
 #ifndef YB_RPC_TCP_STREAM_H
 #define YB_RPC_TCP_STREAM_H
 
+#include <deque>
+#include <map>
+#include <utility>
+
 #include <ev++.h>
 
 #include "yb/rpc/growable_buffer.h"
@@ -49,6 +53,7 @@ class TcpStream : public Stream {
   CHECKED_STATUS TryWrite() override;
 
   bool Idle(std::string* reason_not_idle) override;
+  void ReleaseIdleBuffers() override;
   bool IsConnected() override { return connected_; }
   void DumpPB(const DumpRunningRpcsRequestPB& req, RpcConnectionPB* resp) override;
 
@@ -69,7 +74,8 @@ class TcpStream : public Stream {
   CHECKED_STATUS ReadHandler();
   CHECKED_STATUS WriteHandler(bool just_connected);
 
-  Result<bool> Receive();
+  // Receives into the read buffer. Sets *drained if the socket had less data than fits into it.
+  Result<bool> Receive(bool* drained);
   // Try to parse received data and process it.
   Result<bool> TryProcessReceived();
 
@@ -78,7 +84,11 @@ class TcpStream : public Stream {
 
   const std::string& LogPrefix() const;
 
-  int FillIov(iovec* out);
+  // Fills the io vectors to send and adds their total size to *total_size.
+  int FillIov(iovec* out, size_t* total_size);
+
+  // Releases the buffers of zero copy sends that the kernel reported as completed.
+  CHECKED_STATUS ProcessZeroCopyCompletions();
 
   void DelayConnectHandler(ev::timer& watcher, int revents); // NOLINT
 
@@ -99,6 +109,8 @@ class TcpStream : public Stream {
 
   // Notifies us when our socket is readable or writable.
   ev::io io_;
+  // Events that io_ is currently set to.
+  int events_ = 0;
 
   ev::timer connect_delayer_;
 
@@ -129,12 +141,23 @@ class TcpStream : public Stream {
     OutboundDataPtr data;
     SendingBytes bytes;
     bool skipped = false;
+    // Whether some of the bytes were sent with zero copy.
+    bool zero_copy = false;
   };
 
   std::deque<SendingData> sending_;
   size_t send_position_ = 0;
   size_t queued_bytes_to_send_ = 0;
   bool waiting_write_ready_ = false;
+
+  bool zero_copy_enabled_ = false;
+  // Id of the next zero copy send, and the first id whose completion was not reported yet.
+  uint32_t zero_copy_next_id_ = 0;
+  uint32_t zero_copy_completed_ = 0;
+  // Completed id ranges after zero_copy_completed_, by first id.
+  std::map<uint32_t, uint32_t> zero_copy_out_of_order_;
+  // Buffers of sent data, with the id of the last zero copy send that could still use them.
+  std::deque<std::pair<uint32_t, SendingBytes>> zero_copy_pending_;
 };
 
 } // namespace rpc
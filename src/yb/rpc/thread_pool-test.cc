@@ -24,6 +24,8 @@
 #include "yb/util/test_util.h"
 #include "yb/util/thread.h"
 
+DECLARE_bool(rpc_thread_pool_work_stealing);
+
 namespace yb {
 namespace rpc {
 
@@ -209,6 +211,54 @@ TEST_F(ThreadPoolTest, TestShutdown) {
   }
 }
 
+// Tasks that enqueue their second half from the worker that runs the first one, so that the
+// second halves go to the queues of the workers and are stolen by idle workers.
+TEST_F(ThreadPoolTest, TestWorkStealing) {
+  FLAGS_rpc_thread_pool_work_stealing = true;
+  constexpr size_t kTotalTasks = 10000;
+  constexpr size_t kTotalWorkers = 4;
+
+  class ForkingTask : public ThreadPoolTask {
+   public:
+    void Init(ThreadPool* thread_pool, CountDownLatch* latch, TestTask* second_half) {
+      thread_pool_ = thread_pool;
+      latch_ = latch;
+      second_half_ = second_half;
+    }
+
+    void Run() override {
+      second_half_->SetLatch(latch_);
+      ASSERT_TRUE(thread_pool_->Enqueue(second_half_));
+    }
+
+    void Done(const Status& status) override {
+      ASSERT_OK(status);
+      latch_->CountDown();
+    }
+
+    virtual ~ForkingTask() {}
+
+   private:
+    ThreadPool* thread_pool_ = nullptr;
+    CountDownLatch* latch_ = nullptr;
+    TestTask* second_half_ = nullptr;
+  };
+
+  ThreadPool pool("test", kTotalTasks, kTotalWorkers);
+  CountDownLatch latch(kTotalTasks * 2);
+  std::vector<ForkingTask> first_halves(kTotalTasks);
+  std::vector<TestTask> second_halves(kTotalTasks);
+  for (size_t i = 0; i != kTotalTasks; ++i) {
+    first_halves[i].Init(&pool, &latch, &second_halves[i]);
+    ASSERT_TRUE(pool.Enqueue(&first_halves[i]));
+  }
+  latch.Wait();
+  for (auto& task : second_halves) {
+    ASSERT_TRUE(task.IsCompleted());
+  }
+  pool.Shutdown();
+}
+
 TEST_F(ThreadPoolTest, TestOwns) {
   class TestTask : public ThreadPoolTask {
    public:
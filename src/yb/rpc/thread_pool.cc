@@ -18,12 +18,25 @@
 #include <condition_variable>
 #include <mutex>
 #include <thread>
+#include <vector>
 
-#include <boost/lockfree/queue.hpp>
 #include <boost/scope_exit.hpp>
 
+#include <gflags/gflags.h>
+
+#include "yb/util/format.h"
+#include "yb/util/lockfree.h"
+#include "yb/util/os-util.h"
 #include "yb/util/thread.h"
 
+DEFINE_bool(rpc_thread_pool_work_stealing, false,
+            "Give each worker of an RPC thread pool a queue of its own. Tasks enqueued by a worker "
+            "go to its own queue, and idle workers steal tasks from the queues of the others, so "
+            "that workers do not all contend on the shared queue.");
+DEFINE_int32(rpc_thread_pool_worker_queue_size, 256,
+             "Capacity of the queue of each worker when rpc_thread_pool_work_stealing is set. "
+             "Tasks that do not fit go to the shared queue.");
+
 namespace yb {
 namespace rpc {
 
@@ -31,18 +44,29 @@ namespace {
 
 class Worker;
 
-typedef boost::lockfree::queue<ThreadPoolTask*> TaskQueue;
-typedef boost::lockfree::queue<Worker*> WaitingWorkers;
+typedef MPMCQueue<ThreadPoolTask*> TaskQueue;
+typedef MPMCQueue<Worker*> WaitingWorkers;
 
 struct ThreadPoolShare {
   ThreadPoolOptions options;
+  // CPUs to run the workers on, any CPU when empty.
+  std::vector<int> cpus;
   TaskQueue task_queue;
   WaitingWorkers waiting_workers;
+  // Queues of the workers, indexed by worker, empty when work stealing is disabled.
+  std::vector<std::unique_ptr<TaskQueue>> worker_queues;
 
-  explicit ThreadPoolShare(ThreadPoolOptions o)
+  ThreadPoolShare(ThreadPoolOptions o, std::vector<int> c)
       : options(std::move(o)),
+        cpus(std::move(c)),
         task_queue(options.queue_limit),
         waiting_workers(options.max_workers) {
+    if (FLAGS_rpc_thread_pool_work_stealing) {
+      worker_queues.reserve(options.max_workers);
+      while (worker_queues.size() != options.max_workers) {
+        worker_queues.emplace_back(new TaskQueue(FLAGS_rpc_thread_pool_worker_queue_size));
+      }
+    }
   }
 };
 
@@ -50,12 +74,16 @@ namespace {
 
 const std::string kRpcThreadCategory = "rpc_thread_pool";
 
+// Pool and index of the worker running in the current thread, if any.
+thread_local ThreadPoolShare* current_share = nullptr;
+thread_local size_t current_worker_index = 0;
+
 } // namespace
 
 class Worker {
  public:
   explicit Worker(ThreadPoolShare* share, size_t index)
-      : share_(share) {
+      : share_(share), index_(index) {
     auto name = strings::Substitute("rpc_tp_$0_$1", share_->options.name, index);
     CHECK_OK(yb::Thread::Create(kRpcThreadCategory, name, &Worker::Execute, this, &thread_));
   }
@@ -95,6 +123,11 @@ class Worker {
   // does not have free hands (worker queue empty)
   void Execute() {
     Thread::current_thread()->SetUserData(share_);
+    current_share = share_;
+    current_worker_index = index_;
+    if (!share_->cpus.empty()) {
+      WARN_NOT_OK(SetCurrentThreadCpuAffinity(share_->cpus), "Failed to set worker CPU affinity");
+    }
     while (!stop_requested_) {
       ThreadPoolTask* task = nullptr;
       if (PopTask(&task)) {
@@ -107,7 +140,7 @@ class Worker {
   bool PopTask(ThreadPoolTask** task) {
     // First of all we try to get already queued task, w/o locking.
     // If there is no task, so we could go to waiting state.
-    if (share_->task_queue.pop(*task)) {
+    if (TryPopTask(task)) {
       return true;
     }
     std::unique_lock<std::mutex> lock(mutex_);
@@ -123,7 +156,7 @@ class Worker {
       // the worker queue. So worker queue could be empty in this case, and nobody was notified
       // about new task. So we check there for this case. This technique is similar to
       // double check.
-      if (share_->task_queue.pop(*task)) {
+      if (TryPopTask(task)) {
         return true;
       }
 
@@ -131,7 +164,25 @@ class Worker {
 
       // Sometimes another worker could steal task before we wake up. In this case we will
       // just enqueue ourselves back.
-      if (share_->task_queue.pop(*task)) {
+      if (TryPopTask(task)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Takes a task from our own queue, then from the shared one, and then steals one from the
+  // queues of other workers. So the invariant above holds for all queues together.
+  bool TryPopTask(ThreadPoolTask** task) {
+    auto& worker_queues = share_->worker_queues;
+    if (worker_queues.empty()) {
+      return share_->task_queue.Pop(task);
+    }
+    if (worker_queues[index_]->Pop(task) || share_->task_queue.Pop(task)) {
+      return true;
+    }
+    for (size_t i = 1; i < worker_queues.size(); ++i) {
+      if (worker_queues[(index_ + i) % worker_queues.size()]->Pop(task)) {
         return true;
       }
     }
@@ -140,13 +191,14 @@ class Worker {
 
   void AddToWaitingWorkers() {
     if (!added_to_waiting_workers_) {
-      auto pushed = share_->waiting_workers.bounded_push(this);
+      auto pushed = share_->waiting_workers.Push(this);
       CHECK(pushed);
       added_to_waiting_workers_ = true;
     }
   }
 
   ThreadPoolShare* share_;
+  const size_t index_;
   scoped_refptr<yb::Thread> thread_;
   std::mutex mutex_;
   std::condition_variable cond_;
@@ -155,12 +207,11 @@ class Worker {
   bool added_to_waiting_workers_ = false;
 };
 
-} // namespace
-
-class ThreadPool::Impl {
+// Workers that share one task queue.
+class WorkerGroup {
  public:
-  explicit Impl(ThreadPoolOptions options)
-      : share_(std::move(options)),
+  WorkerGroup(ThreadPoolOptions options, std::vector<int> cpus)
+      : share_(std::move(options), std::move(cpus)),
         queue_full_status_(STATUS_SUBSTITUTE(ServiceUnavailable,
                                              "Queue is full, max items: $0",
                                              share_.options.queue_limit)) {
@@ -181,14 +232,19 @@ class ThreadPool::Impl {
       task->Done(shutdown_status_);
       return false;
     }
-    bool added = share_.task_queue.bounded_push(task);
+    // A task enqueued by one of our workers goes to the queue of that worker, so it is likely run
+    // by the same worker, while its data is still in the cache.
+    bool added =
+        (current_share == &share_ && !share_.worker_queues.empty() &&
+         share_.worker_queues[current_worker_index]->Push(task)) ||
+        share_.task_queue.Push(task);
     --adding_;
     if (!added) {
       task->Done(queue_full_status_);
       return false;
     }
     Worker* worker = nullptr;
-    while (share_.waiting_workers.pop(worker)) {
+    while (share_.waiting_workers.Pop(&worker)) {
       if (worker->Notify()) {
         return true;
       }
@@ -215,7 +271,10 @@ class ThreadPool::Impl {
     {
       std::lock_guard<std::mutex> lock(mutex_);
       if (closing_) {
-        CHECK(share_.task_queue.empty());
+        CHECK(share_.task_queue.Empty());
+        for (auto& queue : share_.worker_queues) {
+          CHECK(queue->Empty());
+        }
         CHECK(workers_.empty());
         return;
       }
@@ -234,9 +293,14 @@ class ThreadPool::Impl {
       std::this_thread::sleep_for(std::chrono::milliseconds(10));
     }
     ThreadPoolTask* task = nullptr;
-    while (share_.task_queue.pop(task)) {
+    while (share_.task_queue.Pop(&task)) {
       task->Done(shutdown_status_);
     }
+    for (auto& queue : share_.worker_queues) {
+      while (queue->Pop(&task)) {
+        task->Done(shutdown_status_);
+      }
+    }
   }
 
   bool Owns(Thread* thread) {
@@ -254,6 +318,77 @@ class ThreadPool::Impl {
   const Status queue_full_status_;
 };
 
+} // namespace
+
+class ThreadPool::Impl {
+ public:
+  explicit Impl(ThreadPoolOptions options) : options_(std::move(options)) {
+    std::vector<std::vector<int>> node_cpus;
+    if (options_.numa_aware) {
+      node_cpus = NumaNodeCpus();
+    }
+    if (node_cpus.size() < 2) {
+      groups_.emplace_back(new WorkerGroup(options_, std::vector<int>()));
+      return;
+    }
+    const size_t num_groups = node_cpus.size();
+    for (size_t node = 0; node != num_groups; ++node) {
+      ThreadPoolOptions group_options = options_;
+      group_options.name = Format("$0_n$1", options_.name, node);
+      group_options.queue_limit = (options_.queue_limit + num_groups - 1) / num_groups;
+      group_options.max_workers = (options_.max_workers + num_groups - 1) / num_groups;
+      for (int cpu : node_cpus[node]) {
+        if (group_of_cpu_.size() <= static_cast<size_t>(cpu)) {
+          group_of_cpu_.resize(cpu + 1);
+        }
+        group_of_cpu_[cpu] = node;
+      }
+      groups_.emplace_back(new WorkerGroup(group_options, std::move(node_cpus[node])));
+    }
+  }
+
+  const ThreadPoolOptions& options() const {
+    return options_;
+  }
+
+  bool Enqueue(ThreadPoolTask* task) {
+    return CurrentGroup().Enqueue(task);
+  }
+
+  void Shutdown() {
+    for (auto& group : groups_) {
+      group->Shutdown();
+    }
+  }
+
+  bool Owns(Thread* thread) {
+    for (auto& group : groups_) {
+      if (group->Owns(thread)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+ private:
+  // Returns the group of the NUMA node that the calling thread runs on.
+  WorkerGroup& CurrentGroup() {
+    if (groups_.size() == 1) {
+      return *groups_.front();
+    }
+    const int cpu = CurrentCpu();
+    if (cpu >= 0 && static_cast<size_t>(cpu) < group_of_cpu_.size()) {
+      return *groups_[group_of_cpu_[cpu]];
+    }
+    return *groups_.front();
+  }
+
+  const ThreadPoolOptions options_;
+  std::vector<std::unique_ptr<WorkerGroup>> groups_;
+  // Index of the group of each CPU, when there is more than one group.
+  std::vector<size_t> group_of_cpu_;
+};
+
 ThreadPool::ThreadPool(ThreadPoolOptions options)
     : impl_(new Impl(std::move(options))) {
 }
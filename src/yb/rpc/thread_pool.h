@@ -43,6 +43,10 @@ struct ThreadPoolOptions {
   std::string name;
   size_t queue_limit;
   size_t max_workers;
+  // Split the workers into one group per NUMA node, each running on the CPUs of its node. A task
+  // is run by the group of the node it was enqueued from, so the task and whatever enqueued it,
+  // e.g. the reactor that received a call, use the memory of the same node.
+  bool numa_aware = false;
 };
 
 class ThreadPool {
@@ -0,0 +1,131 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <algorithm>
+#include <map>
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include "yb/rpc/timer_wheel.h"
+
+namespace yb {
+namespace rpc {
+
+typedef TimerWheel<int64_t, int64_t> TestTimerWheel;
+
+TEST(TimerWheelTest, Basic) {
+  TestTimerWheel wheel(10);
+  ASSERT_FALSE(wheel.Insert(1, 10, 1));
+  ASSERT_TRUE(wheel.Insert(2, 11, 2));
+  ASSERT_TRUE(wheel.Insert(3, 1000, 3));
+  ASSERT_TRUE(wheel.Insert(4, 20, 4));
+  ASSERT_EQ(3, wheel.size());
+
+  int64_t next = 0;
+  ASSERT_TRUE(wheel.NextTick(&next));
+  ASSERT_EQ(11, next);
+
+  int64_t value = 0;
+  ASSERT_TRUE(wheel.Erase(4, &value));
+  ASSERT_EQ(4, value);
+  ASSERT_FALSE(wheel.Erase(4, &value));
+
+  std::vector<int64_t> expired;
+  wheel.Advance(999, &expired);
+  ASSERT_EQ(std::vector<int64_t>{2}, expired);
+  expired.clear();
+  wheel.Advance(1000, &expired);
+  ASSERT_EQ(std::vector<int64_t>{3}, expired);
+  ASSERT_TRUE(wheel.empty());
+  ASSERT_FALSE(wheel.NextTick(&next));
+}
+
+// Checks the wheel against a map of ticks to timers, with timers far beyond the range of the top
+// level, and with the wheel advancing by random steps.
+TEST(TimerWheelTest, Random) {
+  std::mt19937_64 rng(42);
+  TestTimerWheel wheel;
+  std::multimap<int64_t, int64_t> expected;
+  std::map<int64_t, int64_t> ticks;
+  int64_t next_id = 0;
+  for (int i = 0; i != 100000; ++i) {
+    auto action = rng() % 10;
+    if (action < 5) {
+      int64_t delta;
+      switch (rng() % 4) {
+        case 0: delta = rng() % TestTimerWheel::kSlots + 1; break;
+        case 1: delta = rng() % 10000 + 1; break;
+        case 2: delta = rng() % TestTimerWheel::kMaxDelta + 1; break;
+        default: delta = rng() % (TestTimerWheel::kMaxDelta * 3) + 1; break;
+      }
+      auto id = ++next_id;
+      auto tick = wheel.now_tick() + delta;
+      ASSERT_TRUE(wheel.Insert(id, tick, id));
+      expected.emplace(tick, id);
+      ticks.emplace(id, tick);
+    } else if (action < 8) {
+      if (ticks.empty()) {
+        continue;
+      }
+      auto it = ticks.lower_bound(rng() % next_id + 1);
+      if (it == ticks.end()) {
+        continue;
+      }
+      int64_t value = 0;
+      ASSERT_TRUE(wheel.Erase(it->first, &value));
+      ASSERT_EQ(it->first, value);
+      auto range = expected.equal_range(it->second);
+      for (auto i = range.first; i != range.second; ++i) {
+        if (i->second == it->first) {
+          expected.erase(i);
+          break;
+        }
+      }
+      ticks.erase(it);
+    } else {
+      int64_t target;
+      if (rng() % 2 == 0 || expected.empty()) {
+        target = wheel.now_tick() + rng() % 100;
+      } else {
+        // Jump right to a random expiration, to exercise skipping of empty ticks.
+        auto it = expected.begin();
+        std::advance(it, rng() % expected.size());
+        target = it->first;
+      }
+      int64_t next = 0;
+      if (wheel.NextTick(&next)) {
+        ASSERT_LE(next, expected.begin()->first);
+      }
+      std::vector<int64_t> expired;
+      wheel.Advance(target, &expired);
+      std::sort(expired.begin(), expired.end());
+      std::vector<int64_t> expected_expired;
+      while (!expected.empty() && expected.begin()->first <= target) {
+        expected_expired.push_back(expected.begin()->second);
+        ticks.erase(expected.begin()->second);
+        expected.erase(expected.begin());
+      }
+      std::sort(expected_expired.begin(), expected_expired.end());
+      ASSERT_EQ(expected_expired, expired);
+      ASSERT_EQ(expected.size(), wheel.size());
+    }
+  }
+  std::vector<int64_t> values;
+  wheel.Clear(&values);
+  ASSERT_EQ(expected.size(), values.size());
+  ASSERT_TRUE(wheel.empty());
+}
+
+} // namespace rpc
+} // namespace yb
@@ -0,0 +1,206 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_RPC_TIMER_WHEEL_H
+#define YB_RPC_TIMER_WHEEL_H
+
+#include <array>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+#include <glog/logging.h>
+
+namespace yb {
+namespace rpc {
+
+// Hashed hierarchical timer wheel. Timers are kept in slots by the tick they expire at, so
+// inserting and erasing a timer take constant time, independent of the number of timers. That
+// suits timeouts, almost all of which are cancelled before they fire.
+//
+// Level 0 has one slot per tick for the next kSlots ticks, and each slot of level N covers kSlots
+// slots of level N - 1. When the wheel reaches the start of a slot of level N, its timers are
+// moved to the lower levels, so each timer is moved at most kLevels - 1 times. Timers beyond the
+// range of the top level wait in its last slot and are placed again when it is reached.
+//
+// Time is measured in ticks, the caller decides how long a tick is. Not thread safe.
+template <class Id, class Value>
+class TimerWheel {
+ public:
+  static constexpr size_t kLevelBits = 6;
+  static constexpr size_t kSlots = 1ULL << kLevelBits;
+  static constexpr size_t kLevels = 4;
+  static constexpr int64_t kMaxDelta = 1LL << (kLevelBits * kLevels);
+
+  explicit TimerWheel(int64_t now_tick = 0) : now_tick_(now_tick) {}
+
+  int64_t now_tick() const { return now_tick_; }
+  size_t size() const { return index_.size(); }
+  bool empty() const { return index_.empty(); }
+
+  // Adds a timer that expires at 'tick'. Returns false, without adding it, if it is already due.
+  bool Insert(const Id& id, int64_t tick, Value value) {
+    if (tick <= now_tick_) {
+      return false;
+    }
+    temp_.push_back(Entry{id, tick, std::move(value), kLevels, 0});
+    auto it = std::prev(temp_.end());
+    CHECK(index_.emplace(id, it).second) << "Duplicate timer";
+    Place(it);
+    return true;
+  }
+
+  // Removes the timer with the given id, storing its value in 'value'. Returns false if there is
+  // no such timer, e.g. because it has already expired.
+  bool Erase(const Id& id, Value* value) {
+    auto it = index_.find(id);
+    if (it == index_.end()) {
+      return false;
+    }
+    auto entry = it->second;
+    *value = std::move(entry->value);
+    --level_sizes_[entry->level];
+    slots_[entry->level][entry->slot].erase(entry);
+    index_.erase(it);
+    return true;
+  }
+
+  // Advances the wheel to 'tick', appending the values of the timers that expire by then to
+  // 'expired'. Ticks at which nothing can happen are skipped, so the cost does not depend on how
+  // far the wheel moves.
+  void Advance(int64_t tick, std::vector<Value>* expired) {
+    while (now_tick_ < tick) {
+      if (index_.empty()) {
+        now_tick_ = tick;
+        break;
+      }
+      // With the lowest levels empty, nothing happens before the next slot of the level above.
+      int64_t next = now_tick_ + 1;
+      for (size_t level = 0; level + 1 < kLevels && level_sizes_[level] == 0; ++level) {
+        const auto shift = kLevelBits * (level + 1);
+        next = ((now_tick_ >> shift) + 1) << shift;
+      }
+      now_tick_ = std::min(next, tick);
+      Tick(expired);
+    }
+  }
+
+  // Returns the earliest tick at which Advance could expire or move timers, or false if the wheel
+  // is empty.
+  bool NextTick(int64_t* result) const {
+    bool found = false;
+    for (size_t level = 0; level != kLevels; ++level) {
+      if (level_sizes_[level] == 0) {
+        continue;
+      }
+      const auto shift = kLevelBits * level;
+      for (size_t i = 1; i <= kSlots; ++i) {
+        const int64_t block = (now_tick_ >> shift) + i;
+        if (!slots_[level][block & kSlotMask].empty()) {
+          const int64_t tick = block << shift;
+          if (!found || tick < *result) {
+            *result = tick;
+            found = true;
+          }
+          break;
+        }
+      }
+    }
+    return found;
+  }
+
+  // Removes all timers, appending their values to 'values'.
+  void Clear(std::vector<Value>* values) {
+    for (auto& level : slots_) {
+      for (auto& slot : level) {
+        for (auto& entry : slot) {
+          values->push_back(std::move(entry.value));
+        }
+        slot.clear();
+      }
+    }
+    level_sizes_.fill(0);
+    index_.clear();
+  }
+
+ private:
+  static constexpr int64_t kSlotMask = kSlots - 1;
+
+  struct Entry {
+    Id id;
+    int64_t tick;
+    Value value;
+    size_t level;
+    size_t slot;
+  };
+
+  typedef std::list<Entry> Slot;
+  typedef typename Slot::iterator EntryIterator;
+
+  // Moves the entry from the list it is in, temp_ when its level is kLevels, to the slot it belongs
+  // to relative to the current tick. Iterators stay valid when moved between lists, so the index
+  // does not change.
+  void Place(EntryIterator entry) {
+    const int64_t delta = std::min(entry->tick - now_tick_, kMaxDelta - 1);
+    size_t level = 0;
+    while (level + 1 < kLevels && delta >= (1LL << (kLevelBits * (level + 1)))) {
+      ++level;
+    }
+    const int64_t tick = now_tick_ + delta;
+    const size_t slot = (tick >> (kLevelBits * level)) & kSlotMask;
+    auto& source = entry->level == kLevels ? temp_ : slots_[entry->level][entry->slot];
+    entry->level = level;
+    entry->slot = slot;
+    ++level_sizes_[level];
+    slots_[level][slot].splice(slots_[level][slot].end(), source, entry);
+  }
+
+  // Processes the current tick: moves the timers of the slots that start at it to lower levels,
+  // highest level first, then expires the timers of the current slot of level 0.
+  void Tick(std::vector<Value>* expired) {
+    size_t top = 0;
+    while (top + 1 < kLevels && (now_tick_ & ((1LL << (kLevelBits * (top + 1))) - 1)) == 0) {
+      ++top;
+    }
+    for (size_t level = top; level > 0; --level) {
+      auto& source = slots_[level][(now_tick_ >> (kLevelBits * level)) & kSlotMask];
+      level_sizes_[level] -= source.size();
+      temp_.splice(temp_.end(), source);
+      while (!temp_.empty()) {
+        auto entry = temp_.begin();
+        entry->level = kLevels;
+        Place(entry);
+      }
+    }
+    auto& current = slots_[0][now_tick_ & kSlotMask];
+    level_sizes_[0] -= current.size();
+    for (auto& entry : current) {
+      DCHECK_EQ(entry.tick, now_tick_);
+      expired->push_back(std::move(entry.value));
+      index_.erase(entry.id);
+    }
+    current.clear();
+  }
+
+  int64_t now_tick_;
+  std::array<std::array<Slot, kSlots>, kLevels> slots_;
+  std::array<size_t, kLevels> level_sizes_ = {};
+  // Entries that are not in any slot, while they are being placed.
+  Slot temp_;
+  std::unordered_map<Id, EntryIterator> index_;
+};
+
+} // namespace rpc
+} // namespace yb
+
+#endif // YB_RPC_TIMER_WHEEL_H
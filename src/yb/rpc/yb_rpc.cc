@@ -19,6 +19,7 @@
 
 #include "yb/gutil/endian.h"
 
+#include "yb/rpc/compression.h"
 #include "yb/rpc/connection.h"
 #include "yb/rpc/messenger.h"
 #include "yb/rpc/reactor.h"
@@ -167,6 +168,18 @@ Status YBInboundCall::ParseFrom(const MemTrackerPtr& mem_tracker, std::vector<ch
   Slice source(request_data_.data(), request_data_.size());
   RETURN_NOT_OK(serialization::ParseYBMessage(source, &header_, &serialized_request_));
 
+  if (header_.compression() != RpcCompressionPB::RPC_COMPRESSION_NONE) {
+    std::vector<char> decompressed;
+    RETURN_NOT_OK(DecompressPayload(
+        header_.compression(), serialized_request_, header_.uncompressed_size(), rpc_metrics(),
+        &decompressed));
+    if (consumption_) {
+      consumption_.Add(static_cast<int64_t>(decompressed.size()) - request_data_.size());
+    }
+    request_data_.swap(decompressed);
+    serialized_request_ = Slice(request_data_.data(), request_data_.size());
+  }
+
   // Adopt the service/method info from the header as soon as it's available.
   if (PREDICT_FALSE(!header_.has_remote_method())) {
     return STATUS(Corruption, "Non-connection context request header must specify remote_method");
@@ -177,6 +190,11 @@ Status YBInboundCall::ParseFrom(const MemTrackerPtr& mem_tracker, std::vector<ch
   }
   remote_method_.FromPB(header_.remote_method());
 
+  if (PREDICT_FALSE(header_.has_trace_context())) {
+    trace_context_ = TraceContext::ChildOfRemote(
+        header_.trace_context().trace_id(), header_.trace_context().parent_span_id());
+  }
+
   return Status::OK();
 }
 
@@ -209,6 +227,13 @@ Status YBInboundCall::SerializeResponseBuffer(const google::protobuf::MessageLit
   ResponseHeader resp_hdr;
   resp_hdr.set_call_id(header_.call_id());
   resp_hdr.set_is_error(!is_success);
+  // Tell about accepted compression only to clients that know about compression.
+  if (header_.accepted_compression() != RpcCompressionPB::RPC_COMPRESSION_NONE) {
+    auto accepted_compression = AcceptedCompression();
+    if (accepted_compression != RpcCompressionPB::RPC_COMPRESSION_NONE) {
+      resp_hdr.set_accepted_compression(accepted_compression);
+    }
+  }
   uint32_t absolute_sidecar_offset = protobuf_msg_size;
   for (auto& car : sidecars_) {
     resp_hdr.add_sidecar_offsets(absolute_sidecar_offset);
@@ -236,11 +261,39 @@ Status YBInboundCall::SerializeResponseBuffer(const google::protobuf::MessageLit
   if (!status.ok()) {
     return status;
   }
-  return SerializeMessage(response,
-                          &response_buf_,
-                          additional_size,
-                          /* use_cached_size */ true,
-                          header_size);
+  status = SerializeMessage(response,
+                            &response_buf_,
+                            additional_size,
+                            /* use_cached_size */ true,
+                            header_size);
+  if (!status.ok()) {
+    return status;
+  }
+
+  auto compression = CompressionForPeer(
+      header_.accepted_compression(), local_address(), remote_address());
+  if (compression == RpcCompressionPB::RPC_COMPRESSION_NONE) {
+    return Status::OK();
+  }
+  // The protobuf is at the end of the buffer, right after its size prefix.
+  std::vector<Slice> body;
+  body.reserve(sidecars_.size() + 1);
+  body.emplace_back(response_buf_.udata() + response_buf_.size() - protobuf_msg_size,
+                    protobuf_msg_size);
+  for (const auto& car : sidecars_) {
+    body.emplace_back(car.udata(), car.size());
+  }
+  std::vector<char> compressed;
+  if (!CompressPayload(compression, body, rpc_metrics(), &compressed)) {
+    return Status::OK();
+  }
+  resp_hdr.set_compression(compression);
+  resp_hdr.set_uncompressed_size(absolute_sidecar_offset);
+  RETURN_NOT_OK(SerializeCompressedMessage(
+      resp_hdr, Slice(compressed.data(), compressed.size()), &response_buf_));
+  // Sidecars are part of the compressed message now.
+  sidecars_.clear();
+  return Status::OK();
 }
 
 string YBInboundCall::ToString() const {
@@ -338,6 +391,16 @@ void YBInboundCall::RespondFailure(ErrorStatusPB::RpcErrorCodePB error_code,
   Respond(err, false);
 }
 
+void YBInboundCall::RespondBusy(const Status& status, MonoDelta retry_after) {
+  TRACE_EVENT0("rpc", "InboundCall::RespondBusy");
+  ErrorStatusPB err;
+  err.set_message(status.ToString());
+  err.set_code(ErrorStatusPB::ERROR_SERVER_TOO_BUSY);
+  err.set_retry_after_ms(std::max<int64_t>(retry_after.ToMilliseconds(), 0));
+
+  Respond(err, false);
+}
+
 void YBInboundCall::RespondApplicationError(int error_ext_id, const std::string& message,
                                             const MessageLite& app_error_pb) {
   ErrorStatusPB err;
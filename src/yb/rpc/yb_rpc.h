@@ -115,6 +115,8 @@ class YBInboundCall : public InboundCall {
   void RespondFailure(ErrorStatusPB::RpcErrorCodePB error_code,
                       const Status &status) override;
 
+  void RespondBusy(const Status& status, MonoDelta retry_after) override;
+
   void RespondApplicationError(int error_ext_id, const std::string& message,
                                const google::protobuf::MessageLite& app_error_pb);
 
@@ -134,6 +136,8 @@ class YBInboundCall : public InboundCall {
 
   CoarseTimePoint GetClientDeadline() const override;
 
+  RpcPriorityPB priority() const override { return header_.priority(); }
+
   const std::string& method_name() const override {
     return remote_method_.method_name();
   }
@@ -60,12 +60,15 @@
 
 #include "yb/gutil/map-util.h"
 #include "yb/gutil/strings/human_readable.h"
+#include "yb/gutil/strings/numbers.h"
 #include "yb/gutil/strings/split.h"
 #include "yb/gutil/strings/substitute.h"
 #include "yb/server/pprof-path-handlers.h"
 #include "yb/server/webserver.h"
+#include "yb/util/distributed_trace.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/histogram.pb.h"
+#include "yb/util/lock_contention.h"
 #include "yb/util/logging.h"
 #include "yb/util/mem_tracker.h"
 #include "yb/util/metrics.h"
@@ -154,6 +157,27 @@ static void StatusHandler(const Webserver::WebRequest& req, std::stringstream* o
   (*output) << "{}";
 }
 
+// Registered to handle "/trace-spans", and prints out the spans of sampled traces, one JSON object
+// per line. Only the spans recorded after the one with sequence number "since" are printed, and the
+// last line has the sequence number to pass as "since" to get the spans recorded next.
+static void TraceSpansHandler(const Webserver::WebRequest& req, std::stringstream* output) {
+  uint64_t since = 0;
+  const string* since_arg = FindOrNull(req.parsed_args, "since");
+  if (since_arg && !safe_strtou64(*since_arg, &since)) {
+    *output << "{\"error\":\"Invalid since: " << *since_arg << "\"}\n";
+    return;
+  }
+  const uint64_t last_seq_no = DumpSpans(since, output);
+  *output << "{\"last_seq_no\":" << last_seq_no << "}\n";
+}
+
+// Registered to handle "/lock-contention", and prints out the contention of each lock that is not a
+// spinlock, with the stacks sampled since the previous request. See
+// --lock_contention_profiling_sampling_interval.
+static void LockContentionHandler(const Webserver::WebRequest& req, std::stringstream* output) {
+  DumpLockContention(output);
+}
+
 // Registered to handle "/memz", and prints out memory allocation statistics.
 static void MemUsageHandler(const Webserver::WebRequest& req, std::stringstream* output) {
   bool as_text = (req.parsed_args.find("raw") != req.parsed_args.end());
@@ -269,9 +293,15 @@ static void WriteMetricsAsJson(const MetricRegistry* const metrics,
               "Couldn't write JSON metrics over HTTP");
 }
 
+// With only_changed=true, entries whose values did not change since the previous such request are
+// left out. Meant for collectors that keep the last value of each entry, Prometheus itself treats
+// missing entries as stale.
 static void WriteForPrometheus(const MetricRegistry* const metrics,
+                               const std::shared_ptr<PrometheusExportedValues>& exported_values,
                                const Webserver::WebRequest& req, std::stringstream* output) {
-  PrometheusWriter writer(output);
+  string arg = FindWithDefault(req.parsed_args, "only_changed", "false");
+  const bool only_changed = ParseLeadingBoolValue(arg.c_str(), false);
+  PrometheusWriter writer(output, only_changed ? exported_values.get() : nullptr);
   WARN_NOT_OK(metrics->WriteForPrometheus(&writer), "Couldn't write text metrics for Prometheus");
 }
 
@@ -284,6 +314,9 @@ void AddDefaultPathHandlers(Webserver* webserver) {
   webserver->RegisterPathHandler("/memz", "Memory (total)", MemUsageHandler, true, false);
   webserver->RegisterPathHandler("/mem-trackers", "Memory (detail)",
                                  MemTrackersHandler, true, false);
+  webserver->RegisterPathHandler("/trace-spans", "Trace spans", TraceSpansHandler, false, false);
+  webserver->RegisterPathHandler("/lock-contention", "Lock contention", LockContentionHandler,
+                                 false, false);
 
   AddPprofPathHandlers(webserver);
 }
@@ -291,7 +324,7 @@ void AddDefaultPathHandlers(Webserver* webserver) {
 void RegisterMetricsJsonHandler(Webserver* webserver, const MetricRegistry* const metrics) {
   Webserver::PathHandlerCallback callback = std::bind(WriteMetricsAsJson, metrics, _1, _2);
   Webserver::PathHandlerCallback prometheus_callback = std::bind(
-      WriteForPrometheus, metrics, _1, _2);
+      WriteForPrometheus, metrics, std::make_shared<PrometheusExportedValues>(), _1, _2);
   bool not_styled = false;
   bool not_on_nav_bar = false;
   webserver->RegisterPathHandler("/metrics", "Metrics", callback, not_styled, not_on_nav_bar);
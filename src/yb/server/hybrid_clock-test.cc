@@ -31,6 +31,8 @@
 //
 
 #include <algorithm>
+#include <thread>
+
 #include <glog/logging.h>
 #include <gtest/gtest.h>
 
@@ -171,6 +173,48 @@ void HybridClockTest::RunMultiThreadedTest(int num_reads_per_update) {
   }
 }
 
+// Measures the throughput of Now() and Update() with many threads sharing the clock.
+TEST_F(HybridClockTest, NowAndUpdatePerformance) {
+  constexpr int kNumThreads = 64;
+  const auto kTestDuration = MonoDelta::FromSeconds(2);
+
+  for (int reads_per_update : {0, 8}) {
+    std::atomic<bool> stop(false);
+    std::atomic<uint64_t> num_reads(0);
+    std::atomic<uint64_t> num_updates(0);
+    std::vector<std::thread> threads;
+    for (int i = 0; i != kNumThreads; ++i) {
+      threads.emplace_back([this, reads_per_update, &stop, &num_reads, &num_updates] {
+        uint64_t reads = 0;
+        uint64_t updates = 0;
+        HybridTime prev = HybridTime::kMin;
+        while (!stop.load(std::memory_order_acquire)) {
+          HybridTime now = clock_->Now();
+          EXPECT_GT(now, prev);
+          prev = now;
+          ++reads;
+          if (reads_per_update != 0 && reads % reads_per_update == 0) {
+            // Updates slightly in the future, like the ones coming from other servers.
+            clock_->Update(HybridClock::AddPhysicalTimeToHybridTime(
+                now, MonoDelta::FromMicroseconds(1)));
+            ++updates;
+          }
+        }
+        num_reads.fetch_add(reads, std::memory_order_acq_rel);
+        num_updates.fetch_add(updates, std::memory_order_acq_rel);
+      });
+    }
+    SleepFor(kTestDuration);
+    stop.store(true, std::memory_order_release);
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    LOG(INFO) << kNumThreads << " threads, " << reads_per_update << " reads per update: "
+              << num_reads.load() / kTestDuration.ToSeconds() << " reads/s, "
+              << num_updates.load() / kTestDuration.ToSeconds() << " updates/s";
+  }
+}
+
 TEST_F(HybridClockTest, CompareHybridClocksToDelta) {
   EXPECT_EQ(1, HybridClock::CompareHybridClocksToDelta(
       HybridClock::HybridTimeFromMicrosecondsAndLogicalValue(1000, 10),
@@ -108,34 +108,6 @@ class HybridClock : public Clock {
   const PhysicalClockPtr& TEST_clock() { return clock_; }
 
  private:
-  struct HybridClockComponents {
-    // The last clock read/update, in microseconds.
-    MicrosTime last_usec = 0;
-
-    // The next logical value to be assigned to a hybrid time.
-    LogicalTimeComponent logical = 0;
-
-    HybridClockComponents() noexcept {}
-
-    HybridClockComponents(MicrosTime last_usec_, LogicalTimeComponent logical_)
-        : last_usec(last_usec_),
-          logical(logical_) {
-    }
-
-    HybridClockComponents(HybridClockComponents&& other) = default;
-    HybridClockComponents(const HybridClockComponents& other) = default;
-
-    bool operator< (const HybridClockComponents& o) const {
-      return last_usec < o.last_usec || (last_usec == o.last_usec && logical < o.logical);
-    }
-
-    bool operator<= (const HybridClockComponents& o) const {
-      return last_usec < o.last_usec || (last_usec == o.last_usec && logical <= o.logical);
-    }
-
-    void HandleLogicalComponentOverflow();
-  };
-
   enum State {
     kNotInitialized,
     kInitialized
@@ -148,7 +120,12 @@ class HybridClock : public Clock {
   uint64_t ErrorForMetrics();
 
   PhysicalClockPtr clock_;
-  std::atomic<HybridClockComponents> components_{HybridClockComponents(0, 0)};
+
+  // The lowest hybrid time that could still be assigned, i.e. the last clock read or update with
+  // the next logical value. Physical and logical components are packed like in HybridTime, so a
+  // single 64-bit CAS or increment updates them, and an overflow of the logical component carries
+  // into the physical one.
+  std::atomic<uint64_t> next_hybrid_time_{0};
   State state_ = kNotInitialized;
 
   // Clock metrics are set to detach to their last value. This means
@@ -62,6 +62,7 @@
 #include "yb/gutil/strings/substitute.h"
 #include "yb/gutil/sysinfo.h"
 #include "yb/server/webserver.h"
+#include "yb/util/continuous_profiler.h"
 #include "yb/util/env.h"
 #include "yb/util/logging.h"
 #include "yb/util/monotime.h"
@@ -260,6 +261,23 @@ static void PprofSymbolHandler(const Webserver::WebRequest& req, stringstream* o
       pieces.size(), invalid_addrs, missing_symbols);
 }
 
+// Registered to handle "/pprof/continuous", and prints out the samples of the continuous profiler
+// between the unix times "start" and "end", in seconds. Without them, prints out the samples of the
+// last "seconds" seconds.
+static void PprofContinuousHandler(const Webserver::WebRequest& req, stringstream* output) {
+  const int64_t now_secs = GetCurrentTimeMicros() / MonoTime::kMicrosecondsPerSecond;
+  const int64_t seconds =
+      ParseLeadingInt64Value(FindWithDefault(req.parsed_args, "seconds", ""), 60);
+  const int64_t start_secs =
+      ParseLeadingInt64Value(FindWithDefault(req.parsed_args, "start", ""), now_secs - seconds);
+  const int64_t end_secs =
+      ParseLeadingInt64Value(FindWithDefault(req.parsed_args, "end", ""), now_secs);
+  *output << "--- continuous profile from " << start_secs << " to " << end_secs << endl;
+  ContinuousProfiler::GetInstance()->WriteProfile(
+      start_secs * MonoTime::kMicrosecondsPerSecond, end_secs * MonoTime::kMicrosecondsPerSecond,
+      output);
+}
+
 void AddPprofPathHandlers(Webserver* webserver) {
   // Path handlers for remote pprof profiling. For information see:
   // https://gperftools.googlecode.com/svn/trunk/doc/pprof_remote_servers.html
@@ -269,6 +287,7 @@ void AddPprofPathHandlers(Webserver* webserver) {
   webserver->RegisterPathHandler("/pprof/profile", "", PprofCpuProfileHandler, false, false);
   webserver->RegisterPathHandler("/pprof/symbol", "", PprofSymbolHandler, false, false);
   webserver->RegisterPathHandler("/pprof/contention", "", PprofContentionHandler, false, false);
+  webserver->RegisterPathHandler("/pprof/continuous", "", PprofContinuousHandler, false, false);
 }
 
 } // namespace yb
@@ -59,6 +59,7 @@
 #include "yb/server/tracing-path-handlers.h"
 #include "yb/server/webserver.h"
 #include "yb/util/atomic.h"
+#include "yb/util/continuous_profiler.h"
 #include "yb/util/env.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/jsonwriter.h"
@@ -70,6 +71,7 @@
 #include "yb/util/user.h"
 #include "yb/util/pb_util.h"
 #include "yb/util/rolling_log.h"
+#include "yb/util/lock_contention.h"
 #include "yb/util/spinlock_profiling.h"
 #include "yb/util/thread.h"
 #include "yb/util/version_info.h"
@@ -211,6 +213,7 @@ Status RpcServerBase::Init() {
   glog_metrics_.reset(new ScopedGLogMetrics(metric_entity_));
   tcmalloc::RegisterMetrics(metric_entity_);
   RegisterSpinLockContentionMetrics(metric_entity_);
+  RegisterLockContentionMetrics(metric_entity_);
 
   InitSpinLockContentionProfiling();
 
@@ -541,6 +544,7 @@ Status RpcAndWebServerBase::Start() {
                                    true, true, "fa fa-wrench");
   web_server_->set_footer_html(FooterHtml());
   RETURN_NOT_OK(web_server_->Start());
+  RETURN_NOT_OK(ContinuousProfiler::GetInstance()->Start());
 
   RETURN_NOT_OK(RpcServerBase::Start());
 
@@ -12,6 +12,7 @@
 //
 
 #include "yb/docdb/doc_operation.h"
+#include "yb/docdb/docdb_execution_stats.h"
 #include "yb/tablet/abstract_tablet.h"
 #include "yb/util/trace.h"
 #include "yb/yql/pggate/util/pg_doc_data.h"
@@ -43,9 +44,16 @@ Status AbstractTablet::HandleQLReadRequest(CoarseTimePoint deadline,
 
   const QLRSRowDesc rsrow_desc(ql_read_request.rsrow_desc());
   QLResultSet resultset(&rsrow_desc, &result->rows_data);
+  docdb::DocDBExecutionStats execution_stats;
   TRACE("Start Execute");
-  const Status s = doc_op.Execute(
-      QLStorage(), deadline, read_time, schema, projection, &resultset, &result->restart_read_ht);
+  Status s;
+  {
+    docdb::ScopedDocDBExecutionStats execution_stats_scope(
+        ql_read_request.return_execution_stats() ? &execution_stats : nullptr);
+    s = doc_op.Execute(
+        QLStorage(), deadline, read_time, schema, projection, &resultset,
+        &result->restart_read_ht);
+  }
   TRACE("Done Execute");
   if (!s.ok()) {
     if (s.IsQLError()) {
@@ -61,6 +69,11 @@ Status AbstractTablet::HandleQLReadRequest(CoarseTimePoint deadline,
   RETURN_NOT_OK(CreatePagingStateForRead(
       ql_read_request, resultset.rsrow_count(), &result->response));
 
+  if (ql_read_request.return_execution_stats()) {
+    execution_stats.rows_returned = resultset.rsrow_count();
+    execution_stats.ToPB(result->response.mutable_execution_stats());
+  }
+
   result->response.set_status(QLResponsePB::YQL_STATUS_OK);
   return Status::OK();
 }
@@ -80,9 +93,15 @@ Status AbstractTablet::HandlePgsqlReadRequest(CoarseTimePoint deadline,
                                : nullptr;
 
   PgsqlResultSet resultset;
+  docdb::DocDBExecutionStats execution_stats;
   TRACE("Start Execute");
-  const Status s = doc_op.Execute(QLStorage(), deadline, read_time, schema, index_schema,
-                                  &resultset, &result->restart_read_ht);
+  Status s;
+  {
+    docdb::ScopedDocDBExecutionStats execution_stats_scope(
+        pgsql_read_request.return_execution_stats() ? &execution_stats : nullptr);
+    s = doc_op.Execute(QLStorage(), deadline, read_time, schema, index_schema,
+                       &resultset, &result->restart_read_ht);
+  }
   TRACE("Done Execute");
   if (!s.ok()) {
     result->response.set_status(PgsqlResponsePB::PGSQL_STATUS_RUNTIME_ERROR);
@@ -94,6 +113,11 @@ Status AbstractTablet::HandlePgsqlReadRequest(CoarseTimePoint deadline,
   RETURN_NOT_OK(CreatePagingStateForRead(
       pgsql_read_request, resultset.rsrow_count(), &result->response));
 
+  if (pgsql_read_request.return_execution_stats()) {
+    execution_stats.rows_returned = resultset.rsrow_count();
+    execution_stats.ToPB(result->response.mutable_execution_stats());
+  }
+
   // TODO(neil) The clients' request should indicate what encoding method should be used. When
   // multi-shard is used to process more complicated queries, proxy-server might prefer a different
   // encoding. For now, we'll call PgsqlSerialize() without checking encoding method.
@@ -102,7 +126,25 @@ Status AbstractTablet::HandlePgsqlReadRequest(CoarseTimePoint deadline,
   // Serializing data for PgGate API.
   CHECK(!pgsql_read_request.has_rsrow_desc()) << "Row description is not needed";
   TRACE("Start Serialize");
-  RETURN_NOT_OK(pggate::PgDocData::WriteTuples(resultset, &result->rows_data));
+  if (pgsql_read_request.has_sample_size()) {
+    // The rows of a sampling scan are serialized one by one, so that the client could keep only
+    // some of them when it merges the samples of the tablets.
+    PgsqlSampleResultPB* sample_result = result->response.mutable_sample_result();
+    faststring row_data;
+    for (const PgsqlRSRow& rsrow : resultset.rsrows()) {
+      PgsqlResultSet row_resultset;
+      PgsqlRSRow* row = row_resultset.AllocateRSRow(rsrow.rscol_count());
+      for (size_t i = 0; i != rsrow.rscol_count(); ++i) {
+        *row->rscol(i) = rsrow.rscol_value(i);
+      }
+      row_data.clear();
+      RETURN_NOT_OK(pggate::PgDocData::WriteTuples(row_resultset, &row_data));
+      sample_result->add_rows(row_data.data(), row_data.size());
+    }
+    RETURN_NOT_OK(pggate::PgDocData::WriteTuples(PgsqlResultSet(), &result->rows_data));
+  } else {
+    RETURN_NOT_OK(pggate::PgDocData::WriteTuples(resultset, &result->rows_data));
+  }
   TRACE("Done Serialize");
 
   return Status::OK();
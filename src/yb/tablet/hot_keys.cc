@@ -0,0 +1,110 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/tablet/hot_keys.h"
+
+#include <algorithm>
+#include <limits>
+
+#include <gflags/gflags.h>
+
+#include "yb/util/flag_tags.h"
+#include "yb/util/metrics.h"
+
+DEFINE_int32(tablet_hot_keys_sampling_interval, 100,
+             "One in this many reads and writes of each thread is sampled to find the hottest keys "
+             "of tablets. 0 turns hot key tracking off.");
+TAG_FLAG(tablet_hot_keys_sampling_interval, advanced);
+TAG_FLAG(tablet_hot_keys_sampling_interval, runtime);
+
+DEFINE_int32(tablet_hot_keys_window_sec, 60,
+             "Length of the windows over which the rates of the hottest keys of tablets are "
+             "computed.");
+TAG_FLAG(tablet_hot_keys_window_sec, advanced);
+TAG_FLAG(tablet_hot_keys_window_sec, runtime);
+
+DEFINE_int32(tablet_hot_keys_capacity, 64,
+             "Number of keys whose counts are kept by the hot key tracker of each tablet. A key "
+             "sampled more than 1 / capacity of the time is guaranteed to be found.");
+TAG_FLAG(tablet_hot_keys_capacity, advanced);
+
+namespace yb {
+namespace tablet {
+
+HotKeys::HotKeys(const scoped_refptr<AtomicGauge<uint64_t>>& hottest_key_ops_per_sec)
+    : hottest_key_ops_per_sec_(hottest_key_ops_per_sec),
+      window_start_(CoarseMonoClock::now()),
+      current_(FLAGS_tablet_hot_keys_capacity) {
+}
+
+HotKeys::~HotKeys() {
+}
+
+bool HotKeys::Sample() {
+  const int interval = FLAGS_tablet_hot_keys_sampling_interval;
+  if (interval <= 0) {
+    return false;
+  }
+  // Counting per thread keeps sampling off the cache lines shared by the threads of a tablet.
+  static thread_local uint64_t operations = 0;
+  return ++operations % interval == 0;
+}
+
+void HotKeys::Add(const std::string& key) {
+  const int interval = std::max(FLAGS_tablet_hot_keys_sampling_interval, 1);
+  const auto now = CoarseMonoClock::now();
+  std::lock_guard<std::mutex> lock(mutex_);
+  CheckWindow(now);
+  // Each sample stands for the operations that were not sampled.
+  current_.Add(key, interval);
+}
+
+std::vector<HotKeys::Entry> HotKeys::Top(size_t limit) {
+  const auto now = CoarseMonoClock::now();
+  std::lock_guard<std::mutex> lock(mutex_);
+  CheckWindow(now);
+  if (!has_last_window_) {
+    return CurrentTop(now, limit);
+  }
+  return std::vector<Entry>(
+      last_window_.begin(), last_window_.begin() + std::min(limit, last_window_.size()));
+}
+
+void HotKeys::CheckWindow(CoarseTimePoint now) {
+  if (now - window_start_ < std::chrono::seconds(FLAGS_tablet_hot_keys_window_sec)) {
+    return;
+  }
+  last_window_ = CurrentTop(now, std::numeric_limits<size_t>::max());
+  has_last_window_ = true;
+  current_.Clear();
+  window_start_ = now;
+  if (hottest_key_ops_per_sec_) {
+    hottest_key_ops_per_sec_->set_value(last_window_.empty() ? 0 : last_window_[0].ops_per_sec);
+  }
+}
+
+std::vector<HotKeys::Entry> HotKeys::CurrentTop(CoarseTimePoint now, size_t limit) {
+  // Rates over less than a second would be mostly noise.
+  const double seconds = std::max(ToSeconds(now - window_start_), 1.0);
+  std::vector<Entry> result;
+  for (auto& counter : current_.Top(limit)) {
+    result.push_back(Entry{
+        std::move(counter.item),
+        static_cast<uint64_t>(counter.count / seconds),
+        static_cast<uint64_t>(counter.error / seconds)});
+  }
+  return result;
+}
+
+} // namespace tablet
+} // namespace yb
@@ -0,0 +1,85 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_TABLET_HOT_KEYS_H
+#define YB_TABLET_HOT_KEYS_H
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "yb/gutil/ref_counted.h"
+
+#include "yb/util/monotime.h"
+#include "yb/util/space_saving.h"
+
+namespace yb {
+
+template <class T>
+class AtomicGauge;
+
+namespace tablet {
+
+// Tracks the most frequently read and written keys of a tablet, to find keys that get much more
+// load than their tablet could spread.
+//
+// One in every tablet_hot_keys_sampling_interval operations of a thread is sampled, and the keys
+// of sampled operations are counted by a Space-Saving sketch over windows of
+// tablet_hot_keys_window_sec. Rates are reported for the last complete window, or for the current
+// one until the first window completes.
+//
+// This class is thread-safe.
+class HotKeys {
+ public:
+  struct Entry {
+    std::string key;
+    // Estimated number of operations per second on the key.
+    uint64_t ops_per_sec;
+    // Maximal overestimation of ops_per_sec.
+    uint64_t error_ops_per_sec;
+  };
+
+  // 'hottest_key_ops_per_sec' could be null, otherwise it is set to the rate of the hottest key
+  // whenever a window completes.
+  explicit HotKeys(const scoped_refptr<AtomicGauge<uint64_t>>& hottest_key_ops_per_sec);
+
+  ~HotKeys();
+
+  // Returns whether the current operation should be recorded with Add. Cheap, so it is meant to be
+  // called before building the key.
+  static bool Sample();
+
+  void Add(const std::string& key);
+
+  // Returns up to 'limit' hottest keys, hottest first.
+  std::vector<Entry> Top(size_t limit);
+
+ private:
+  // Completes the current window if it is over.
+  void CheckWindow(CoarseTimePoint now);
+
+  std::vector<Entry> CurrentTop(CoarseTimePoint now, size_t limit);
+
+  scoped_refptr<AtomicGauge<uint64_t>> hottest_key_ops_per_sec_;
+
+  std::mutex mutex_;
+  CoarseTimePoint window_start_;
+  SpaceSaving<std::string> current_;
+  bool has_last_window_ = false;
+  std::vector<Entry> last_window_;
+};
+
+} // namespace tablet
+} // namespace yb
+
+#endif // YB_TABLET_HOT_KEYS_H
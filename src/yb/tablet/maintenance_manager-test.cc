@@ -50,6 +50,8 @@ using std::shared_ptr;
 using std::vector;
 using strings::Substitute;
 
+DECLARE_int64(maintenance_manager_data_dir_io_budget_bytes_per_sec);
+
 METRIC_DEFINE_entity(test);
 METRIC_DEFINE_gauge_uint32(test, maintenance_ops_running,
                            "Number of Maintenance Operations Running",
@@ -140,6 +142,10 @@ class TestMaintenanceOp : public MaintenanceOp {
     stats->set_ram_anchored(consumption_.consumption());
     stats->set_logs_retained_bytes(logs_retained_bytes_);
     stats->set_perf_improvement(perf_improvement_);
+    if (!data_dir_.empty()) {
+      stats->set_data_dir(data_dir_);
+      stats->set_estimated_io_bytes(estimated_io_bytes_);
+    }
   }
 
   void Enable() {
@@ -187,6 +193,12 @@ class TestMaintenanceOp : public MaintenanceOp {
     perf_improvement_ = perf_improvement;
   }
 
+  void set_data_dir_io(const std::string& data_dir, uint64_t estimated_io_bytes) {
+    std::lock_guard<Mutex> guard(lock_);
+    data_dir_ = data_dir;
+    estimated_io_bytes_ = estimated_io_bytes;
+  }
+
   scoped_refptr<Histogram> DurationHistogram() const override {
     return maintenance_op_duration_;
   }
@@ -202,6 +214,8 @@ class TestMaintenanceOp : public MaintenanceOp {
   ScopedTrackedConsumption consumption_;
   uint64_t logs_retained_bytes_;
   uint64_t perf_improvement_;
+  std::string data_dir_;
+  uint64_t estimated_io_bytes_ = 0;
   MetricRegistry metric_registry_;
   scoped_refptr<MetricEntity> metric_entity_;
   scoped_refptr<Histogram> maintenance_op_duration_;
@@ -279,6 +293,44 @@ TEST_F(MaintenanceManagerTest, TestLogRetentionPrioritization) {
   manager_->UnregisterOp(&op2);
 }
 
+// Test that ops are spread over data directories and that a directory over its I/O budget does
+// not get more high IO ops.
+TEST_F(MaintenanceManagerTest, TestDataDirIOBudget) {
+  manager_->Shutdown();
+
+  TestMaintenanceOp op1("op1", MaintenanceOp::HIGH_IO_USAGE, OP_RUNNABLE, test_tracker_);
+  op1.set_ram_anchored(0);
+  op1.set_perf_improvement(10);
+  op1.set_data_dir_io("/disk1", 1000);
+
+  TestMaintenanceOp op2("op2", MaintenanceOp::HIGH_IO_USAGE, OP_RUNNABLE, test_tracker_);
+  op2.set_ram_anchored(0);
+  op2.set_perf_improvement(6);
+  op2.set_data_dir_io("/disk2", 1000);
+
+  manager_->RegisterOp(&op1);
+  manager_->RegisterOp(&op2);
+
+  // Without a budget, an op already running on the directory of op1 makes op2 the better choice.
+  ASSERT_EQ(&op1, manager_->FindBestOp());
+  auto io = manager_->ChargeDataDir(manager_->ops_[&op1]);
+  ASSERT_EQ(&op2, manager_->FindBestOp());
+  manager_->SettleDataDir(io, 0);
+  ASSERT_EQ(&op1, manager_->FindBestOp());
+
+  // With a budget, the charged estimate keeps op1 from running until the budget pays it back, or
+  // the op turns out to have done less I/O than estimated.
+  FLAGS_maintenance_manager_data_dir_io_budget_bytes_per_sec = 100;
+  io = manager_->ChargeDataDir(manager_->ops_[&op1]);
+  manager_->SettleDataDir(manager_->ChargeDataDir(manager_->ops_[&op2]), 0);
+  ASSERT_EQ(nullptr, manager_->FindBestOp());
+  manager_->SettleDataDir(io, 50);
+  ASSERT_EQ(&op1, manager_->FindBestOp());
+
+  manager_->UnregisterOp(&op1);
+  manager_->UnregisterOp(&op2);
+}
+
 // Test adding operations and make sure that the history of recently completed operations
 // is correct in that it wraps around and doesn't grow.
 TEST_F(MaintenanceManagerTest, TestCompletedOpsHistory) {
@@ -34,6 +34,7 @@
 
 #include <stdint.h>
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <utility>
@@ -73,6 +74,12 @@ DEFINE_bool(enable_maintenance_manager, true,
        "Enable the maintenance manager, runs compaction and tablet cleaning tasks.");
 TAG_FLAG(enable_maintenance_manager, unsafe);
 
+DEFINE_int64(maintenance_manager_data_dir_io_budget_bytes_per_sec, 0,
+       "I/O budget of the maintenance ops on one data directory, in bytes per second. High IO "
+       "ops on a directory that has used up more than one second of its budget are not started, "
+       "so that ops on other directories run instead. 0 means no budget.");
+TAG_FLAG(maintenance_manager_data_dir_io_budget_bytes_per_sec, advanced);
+
 namespace yb {
 
 using yb::tablet::MaintenanceManagerStatusPB;
@@ -89,6 +96,8 @@ void MaintenanceOpStats::Clear() {
   ram_anchored_ = 0;
   logs_retained_bytes_ = 0;
   perf_improvement_ = 0;
+  data_dir_.clear();
+  estimated_io_bytes_ = 0;
 }
 
 MaintenanceOp::MaintenanceOp(std::string name, IOUsage io_usage)
@@ -222,6 +231,9 @@ void MaintenanceManager::RunSchedulerThread() {
     // Prepare the maintenance operation.
     op->running_++;
     running_ops_++;
+    // Copy the stats, they are cleared by the next FindBestOp, which could run while we wait for
+    // Prepare.
+    const MaintenanceOpStats stats = ops_[op];
     guard.unlock();
     bool ready = op->Prepare();
     guard.lock();
@@ -234,7 +246,9 @@ void MaintenanceManager::RunSchedulerThread() {
     }
 
     // Run the maintenance operation.
-    Status s = thread_pool_->SubmitFunc(std::bind(&MaintenanceManager::LaunchOp, this, op));
+    LaunchedOpIO io = ChargeDataDir(stats);
+    Status s = thread_pool_->SubmitFunc(
+        std::bind(&MaintenanceManager::LaunchOp, this, op, std::move(io)));
     CHECK(s.ok());
   }
 }
@@ -246,7 +260,10 @@ void MaintenanceManager::RunSchedulerThread() {
 // - If there are Ops that retain logs, we run the one that has the highest retention (and if many
 //   qualify, then we run the one that also frees up the most RAM).
 // - Finally, if there's nothing else that we really need to do, we run the Op that will improve
-//   performance the most.
+//   performance the most, preferring Ops on data directories that are not busy with other Ops.
+//
+// High IO Ops on a data directory that used up its I/O budget are only considered for freeing
+// memory, so that the threads go to Ops on other directories instead.
 //
 // The reason it's done this way is that we want to prioritize limiting the amount of resources we
 // hold on to. Low IO Ops go first since we can quickly run them, then we can look at memory usage.
@@ -282,6 +299,7 @@ MaintenanceOp* MaintenanceManager::FindBestOp() {
 
   double best_perf_improvement = 0;
   MaintenanceOp* best_perf_improvement_op = nullptr;
+  UpdateDataDirBudgets();
   for (OpMapTy::value_type &val : ops_) {
     MaintenanceOp* op(val.first);
     MaintenanceOpStats& stats(val.second);
@@ -301,6 +319,11 @@ MaintenanceOp* MaintenanceManager::FindBestOp() {
       most_mem_anchored_op = op;
       most_mem_anchored = stats.ram_anchored();
     }
+    if (OverDataDirBudget(op, stats)) {
+      VLOG_AND_TRACE("maintenance", 2) << "Skipping " << op->name() << ", data directory "
+                                       << stats.data_dir() << " is over its I/O budget";
+      continue;
+    }
     // We prioritize ops that can free more logs, but when it's the same we pick the one that
     // also frees up the most memory.
     if (stats.logs_retained_bytes() > 0 &&
@@ -311,10 +334,13 @@ MaintenanceOp* MaintenanceManager::FindBestOp() {
       most_logs_retained_bytes = stats.logs_retained_bytes();
       most_logs_retained_bytes_ram_anchored = stats.ram_anchored();
     }
+    // Spread the threads over the data directories: the more ops already run on the directory,
+    // the less attractive it is to start another one there.
+    const double perf_improvement = stats.perf_improvement() / (1 + RunningOpsOnDataDir(stats));
     if ((!best_perf_improvement_op) ||
-        (stats.perf_improvement() > best_perf_improvement)) {
+        (perf_improvement > best_perf_improvement)) {
       best_perf_improvement_op = op;
-      best_perf_improvement = stats.perf_improvement();
+      best_perf_improvement = perf_improvement;
     }
   }
 
@@ -366,7 +392,80 @@ MaintenanceOp* MaintenanceManager::FindBestOp() {
   return nullptr;
 }
 
-void MaintenanceManager::LaunchOp(MaintenanceOp* op) {
+void MaintenanceManager::UpdateDataDirBudgets() {
+  const auto budget = FLAGS_maintenance_manager_data_dir_io_budget_bytes_per_sec;
+  const MonoTime now = MonoTime::Now();
+  for (auto& entry : data_dirs_) {
+    DataDirIOState& state = entry.second;
+    if (budget <= 0) {
+      state.debt_bytes = 0;
+    } else if (state.last_update.Initialized()) {
+      const double paid = budget * now.GetDeltaSince(state.last_update).ToSeconds();
+      state.debt_bytes = std::max(0.0, state.debt_bytes - paid);
+    }
+    state.last_update = now;
+  }
+}
+
+bool MaintenanceManager::OverDataDirBudget(
+    MaintenanceOp* op, const MaintenanceOpStats& stats) const {
+  const auto budget = FLAGS_maintenance_manager_data_dir_io_budget_bytes_per_sec;
+  if (budget <= 0 || op->io_usage() != MaintenanceOp::HIGH_IO_USAGE || stats.data_dir().empty()) {
+    return false;
+  }
+  auto it = data_dirs_.find(stats.data_dir());
+  return it != data_dirs_.end() && it->second.debt_bytes > budget;
+}
+
+uint32_t MaintenanceManager::RunningOpsOnDataDir(const MaintenanceOpStats& stats) const {
+  if (stats.data_dir().empty()) {
+    return 0;
+  }
+  auto it = data_dirs_.find(stats.data_dir());
+  return it != data_dirs_.end() ? it->second.running_ops : 0;
+}
+
+MaintenanceManager::LaunchedOpIO MaintenanceManager::ChargeDataDir(
+    const MaintenanceOpStats& stats) {
+  LaunchedOpIO result;
+  if (!stats.valid() || stats.data_dir().empty()) {
+    return result;
+  }
+  DataDirIOState& state = data_dirs_[stats.data_dir()];
+  if (!state.last_update.Initialized()) {
+    state.last_update = MonoTime::Now();
+  }
+  result.data_dir = stats.data_dir();
+  result.estimated_bytes = stats.estimated_io_bytes();
+  result.charged_bytes = result.estimated_bytes * state.estimate_ratio;
+  state.debt_bytes += result.charged_bytes;
+  ++state.running_ops;
+  return result;
+}
+
+void MaintenanceManager::SettleDataDir(const LaunchedOpIO& io, uint64_t performed_bytes) {
+  if (io.data_dir.empty()) {
+    return;
+  }
+  DataDirIOState& state = data_dirs_[io.data_dir];
+  DCHECK_GT(state.running_ops, 0);
+  --state.running_ops;
+  // Ops that do not report their I/O keep their estimate.
+  if (performed_bytes == 0) {
+    return;
+  }
+  state.debt_bytes = std::max(0.0, state.debt_bytes + performed_bytes - io.charged_bytes);
+  if (io.estimated_bytes > 0) {
+    constexpr double kNewSampleWeight = 0.2;
+    constexpr double kMinRatio = 0.1;
+    constexpr double kMaxRatio = 10;
+    const double ratio = static_cast<double>(performed_bytes) / io.estimated_bytes;
+    state.estimate_ratio = std::min(kMaxRatio, std::max(kMinRatio,
+        (1 - kNewSampleWeight) * state.estimate_ratio + kNewSampleWeight * ratio));
+  }
+}
+
+void MaintenanceManager::LaunchOp(MaintenanceOp* op, const LaunchedOpIO& io) {
   MonoTime start_time(MonoTime::Now());
   op->RunningGauge()->Increment();
   LOG_TIMING(INFO, Substitute("running $0", op->name())) {
@@ -386,6 +485,7 @@ void MaintenanceManager::LaunchOp(MaintenanceOp* op) {
   completed_ops_count_++;
 
   op->DurationHistogram()->Increment(delta.ToMilliseconds());
+  SettleDataDir(io, op->performed_io_bytes_.exchange(0, std::memory_order_acq_rel));
 
   running_ops_--;
   op->running_--;
@@ -407,6 +507,10 @@ void MaintenanceManager::GetMaintenanceManagerStatusDump(MaintenanceManagerStatu
       op_pb->set_ram_anchored_bytes(stat.ram_anchored());
       op_pb->set_logs_retained_bytes(stat.logs_retained_bytes());
       op_pb->set_perf_improvement(stat.perf_improvement());
+      if (!stat.data_dir().empty()) {
+        op_pb->set_data_dir(stat.data_dir());
+        op_pb->set_estimated_io_bytes(stat.estimated_io_bytes());
+      }
     } else {
       op_pb->set_runnable(false);
       op_pb->set_ram_anchored_bytes(0);
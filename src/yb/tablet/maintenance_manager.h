@@ -34,10 +34,13 @@
 
 #include <stdint.h>
 
+#include <atomic>
 #include <map>
 #include <memory>
 #include <set>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "yb/gutil/macros.h"
@@ -104,6 +107,27 @@ class MaintenanceOpStats {
     perf_improvement_ = perf_improvement;
   }
 
+  // The data directory that this op reads and writes, or empty if unknown.
+  const std::string& data_dir() const {
+    DCHECK(valid_);
+    return data_dir_;
+  }
+
+  void set_data_dir(std::string data_dir) {
+    UpdateLastModified();
+    data_dir_ = std::move(data_dir);
+  }
+
+  uint64_t estimated_io_bytes() const {
+    DCHECK(valid_);
+    return estimated_io_bytes_;
+  }
+
+  void set_estimated_io_bytes(uint64_t estimated_io_bytes) {
+    UpdateLastModified();
+    estimated_io_bytes_ = estimated_io_bytes;
+  }
+
   const MonoTime& last_modified() const {
     DCHECK(valid_);
     return last_modified_;
@@ -138,6 +162,12 @@ class MaintenanceOpStats {
   // absolute scale (yet TBD).
   double perf_improvement_;
 
+  std::string data_dir_;
+
+  // The approximate number of bytes this op reads and writes when performed. Used to keep the
+  // ops on one data directory within its I/O budget. May be 0.
+  uint64_t estimated_io_bytes_;
+
   // The last time that the stats were modified.
   MonoTime last_modified_;
 };
@@ -192,6 +222,12 @@ class MaintenanceOp {
 
   IOUsage io_usage() const { return io_usage_; }
 
+  // Reports the number of bytes actually read and written by Perform. Should be called from
+  // Perform; the manager uses it to correct the I/O estimates of the data directory of the op.
+  void RecordPerformedIO(uint64_t bytes) {
+    performed_io_bytes_.fetch_add(bytes, std::memory_order_acq_rel);
+  }
+
  private:
   // The name of the operation.  Op names must be unique.
   const std::string name_;
@@ -211,6 +247,9 @@ class MaintenanceOp {
 
   IOUsage io_usage_;
 
+  // I/O reported by RecordPerformedIO and not yet accounted by the manager.
+  std::atomic<uint64_t> performed_io_bytes_{0};
+
   DISALLOW_COPY_AND_ASSIGN(MaintenanceOp);
 };
 
@@ -261,15 +300,49 @@ class MaintenanceManager : public std::enable_shared_from_this<MaintenanceManage
 
  private:
   FRIEND_TEST(MaintenanceManagerTest, TestLogRetentionPrioritization);
+  FRIEND_TEST(MaintenanceManagerTest, TestDataDirIOBudget);
   typedef std::map<MaintenanceOp*, MaintenanceOpStats,
           MaintenanceOpComparator> OpMapTy;
 
+  // I/O accounting of the ops on one data directory.
+  struct DataDirIOState {
+    // Bytes of I/O charged to the directory that its budget has not paid back yet.
+    double debt_bytes = 0;
+    MonoTime last_update;
+    // Number of ops that are currently running on the directory.
+    uint32_t running_ops = 0;
+    // Ratio of the actual I/O of completed ops to their estimates, used to correct estimates.
+    double estimate_ratio = 1.0;
+  };
+
+  // What was charged to a data directory when an op was launched.
+  struct LaunchedOpIO {
+    std::string data_dir;
+    uint64_t estimated_bytes = 0;
+    double charged_bytes = 0;
+  };
+
   void RunSchedulerThread();
 
   // find the best op, or null if there is nothing we want to run
   MaintenanceOp* FindBestOp();
 
-  void LaunchOp(MaintenanceOp* op);
+  void LaunchOp(MaintenanceOp* op, const LaunchedOpIO& io);
+
+  // Pays back the debts of the data directories for the time passed since their last update.
+  void UpdateDataDirBudgets();
+
+  // Returns true if the op is high I/O and its data directory has used up its I/O budget.
+  bool OverDataDirBudget(MaintenanceOp* op, const MaintenanceOpStats& stats) const;
+
+  // Returns the number of ops running on the data directory of the op.
+  uint32_t RunningOpsOnDataDir(const MaintenanceOpStats& stats) const;
+
+  // Charges the estimated I/O of an op that is about to run to its data directory.
+  LaunchedOpIO ChargeDataDir(const MaintenanceOpStats& stats);
+
+  // Replaces the charged estimate by the actual I/O of a completed op.
+  void SettleDataDir(const LaunchedOpIO& io, uint64_t performed_bytes);
 
   const int32_t num_threads_;
   OpMapTy ops_; // registered operations
@@ -285,6 +358,7 @@ class MaintenanceManager : public std::enable_shared_from_this<MaintenanceManage
   std::vector<CompletedOp> completed_ops_;
   int64_t completed_ops_count_;
   std::shared_ptr<MemTracker> parent_mem_tracker_;
+  std::unordered_map<std::string, DataDirIOState> data_dirs_;
 
   DISALLOW_COPY_AND_ASSIGN(MaintenanceManager);
 };
@@ -111,6 +111,36 @@ TEST_F(MvccTest, SafeHybridTimeToReadAt) {
   ASSERT_EQ(now, manager_.SafeTime(now));
 }
 
+TEST_F(MvccTest, SafeTimeWithLease) {
+  constexpr uint64_t kLease = 1000;
+  auto ht_lease = AddLogical(clock_->Now(), kLease);
+
+  auto now = clock_->Now();
+  auto safe_time = manager_.SafeTime(ht_lease);
+  ASSERT_GT(safe_time, now);
+  ASSERT_LE(safe_time, ht_lease);
+
+  HybridTime ht1;
+  manager_.AddPending(&ht1);
+  ASSERT_EQ(ht1.Decremented(), manager_.SafeTime(ht_lease));
+
+  HybridTime ht2;
+  manager_.AddPending(&ht2);
+  ASSERT_EQ(ht1.Decremented(), manager_.SafeTime(ht_lease));
+
+  manager_.Replicated(ht1);
+  ASSERT_EQ(ht2.Decremented(), manager_.SafeTime(ht_lease));
+
+  manager_.Replicated(ht2);
+  safe_time = manager_.SafeTime(ht_lease);
+  ASSERT_GT(safe_time, ht2);
+  ASSERT_LE(safe_time, ht_lease);
+
+  // Once the clock passes the lease, safe time stays at the lease.
+  clock_->Update(AddLogical(ht_lease, kLease));
+  ASSERT_EQ(ht_lease, manager_.SafeTime(ht_lease));
+}
+
 TEST_F(MvccTest, Abort) {
   constexpr size_t kTotalEntries = 10;
   vector<HybridTime> hts(kTotalEntries);
@@ -34,7 +34,9 @@
 
 #include <sstream>
 
+#include "yb/util/lock_contention.h"
 #include "yb/util/logging.h"
+#include "yb/util/metrics.h"
 
 namespace yb {
 namespace tablet {
@@ -59,11 +61,12 @@ void MvccManager::Replicated(HybridTime ht) {
   VLOG_WITH_PREFIX(1) << __func__ << "(" << ht << ")";
 
   {
-    std::lock_guard<std::mutex> lock(mutex_);
+    auto lock = LockMutex();
     CHECK(!queue_.empty()) << LogPrefix();
     CHECK_EQ(queue_.front(), ht) << LogPrefix();
     PopFront(&lock);
     last_replicated_ = ht;
+    published_last_replicated_.store(ht.ToUint64(), std::memory_order_release);
   }
   cond_.notify_all();
 }
@@ -72,7 +75,7 @@ void MvccManager::Aborted(HybridTime ht) {
   VLOG_WITH_PREFIX(1) << __func__ << "(" << ht << ")";
 
   {
-    std::lock_guard<std::mutex> lock(mutex_);
+    auto lock = LockMutex();
     CHECK(!queue_.empty()) << LogPrefix();
     if (queue_.front() == ht) {
       PopFront(&lock);
@@ -84,7 +87,13 @@ void MvccManager::Aborted(HybridTime ht) {
   cond_.notify_all();
 }
 
-void MvccManager::PopFront(std::lock_guard<std::mutex>* lock) {
+std::unique_lock<std::mutex> MvccManager::LockMutex() const {
+  std::unique_lock<std::mutex> lock(mutex_, std::defer_lock);
+  LockProfilingContention(LockContentionSite::kMvccManager, &lock);
+  return lock;
+}
+
+void MvccManager::PopFront(std::unique_lock<std::mutex>* lock) {
   queue_.pop_front();
   CHECK_GE(queue_.size(), aborted_.size()) << LogPrefix();
   while (!aborted_.empty()) {
@@ -95,11 +104,22 @@ void MvccManager::PopFront(std::lock_guard<std::mutex>* lock) {
     queue_.pop_front();
     aborted_.pop();
   }
+  PublishQueueFront();
+}
+
+void MvccManager::PublishQueueFront() {
+  queue_front_.store(queue_.empty() ? HybridTime::kInvalid.ToUint64() : queue_.front().ToUint64(),
+                     std::memory_order_release);
+}
+
+void MvccManager::SetSafeTimeWaitsCounter(scoped_refptr<Counter> safe_time_waits) {
+  safe_time_waits_ = std::move(safe_time_waits);
 }
 
 void MvccManager::AddPending(HybridTime* ht) {
   const bool is_follower_side = ht->is_valid();
-  std::lock_guard<std::mutex> lock(mutex_);
+  auto lock = LockMutex();
+  ++add_pending_sequence_;
   if (is_follower_side) {
     // This must be a follower-side transaction with already known hybrid time.
     VLOG_WITH_PREFIX(1) << "AddPending(" << *ht << ")";
@@ -127,6 +147,7 @@ void MvccManager::AddPending(HybridTime* ht) {
       iter++;
     }
     queue_.erase(start_iter, iter);
+    PublishQueueFront();
   }
   HybridTime last_ht_in_queue = queue_.empty() ? HybridTime::kMin : queue_.back();
 
@@ -135,6 +156,7 @@ void MvccManager::AddPending(HybridTime* ht) {
           max_safe_time_returned_with_lease_.safe_time,
           max_safe_time_returned_without_lease_.safe_time,
           max_safe_time_returned_for_follower_.safe_time,
+          HybridTime(max_safe_time_returned_without_lock_.load(std::memory_order_acquire)),
           last_replicated_,
           last_ht_in_queue});
 
@@ -191,14 +213,17 @@ void MvccManager::AddPending(HybridTime* ht) {
     }
   }
   queue_.push_back(*ht);
+  PublishQueueFront();
+  ++add_pending_sequence_;
 }
 
 void MvccManager::SetLastReplicated(HybridTime ht) {
   VLOG_WITH_PREFIX(1) << __func__ << "(" << ht << ")";
 
   {
-    std::lock_guard<std::mutex> lock(mutex_);
+    auto lock = LockMutex();
     last_replicated_ = ht;
+    published_last_replicated_.store(ht.ToUint64(), std::memory_order_release);
   }
   cond_.notify_all();
 }
@@ -207,7 +232,7 @@ void MvccManager::SetPropagatedSafeTimeOnFollower(HybridTime ht) {
   VLOG_WITH_PREFIX(1) << __func__ << "(" << ht << ")";
 
   {
-    std::lock_guard<std::mutex> lock(mutex_);
+    auto lock = LockMutex();
     if (ht >= propagated_safe_time_) {
       propagated_safe_time_ = ht;
     } else {
@@ -223,7 +248,7 @@ void MvccManager::UpdatePropagatedSafeTimeOnLeader(HybridTime ht_lease) {
   VLOG_WITH_PREFIX(1) << __func__ << "(" << ht_lease << ")";
 
   {
-    std::unique_lock<std::mutex> lock(mutex_);
+    auto lock = LockMutex();
     auto ht = DoGetSafeTime(HybridTime::kMin,       // min_allowed
                             CoarseTimePoint::max(), // deadline
                             ht_lease,
@@ -249,7 +274,7 @@ void MvccManager::UpdatePropagatedSafeTimeOnLeader(HybridTime ht_lease) {
 
 HybridTime MvccManager::SafeTimeForFollower(
     HybridTime min_allowed, CoarseTimePoint deadline) const {
-  std::unique_lock<std::mutex> lock(mutex_);
+  auto lock = LockMutex();
   SafeTimeWithSource result;
   auto predicate = [this, &result, min_allowed] {
     // last_replicated_ is updated earlier than propagated_safe_time_, so because of concurrency it
@@ -281,10 +306,60 @@ HybridTime MvccManager::SafeTimeForFollower(
 HybridTime MvccManager::SafeTime(HybridTime min_allowed,
                                  CoarseTimePoint deadline,
                                  HybridTime ht_lease) const {
-  std::unique_lock<std::mutex> lock(mutex_);
+  auto result = SafeTimeWithoutLock(min_allowed, ht_lease);
+  if (result) {
+    return result;
+  }
+  auto lock = LockMutex();
   return DoGetSafeTime(min_allowed, deadline, ht_lease, &lock);
 }
 
+HybridTime MvccManager::SafeTimeWithoutLock(HybridTime min_allowed, HybridTime ht_lease) const {
+  // Without a lease the result is not bounded, and the mutex is needed to keep it consistent with
+  // the results returned before.
+  if (!ht_lease.is_valid() || ht_lease.GetPhysicalValueMicros() >= kMaxHybridTimePhysicalMicros ||
+      min_allowed > ht_lease) {
+    return HybridTime::kInvalid;
+  }
+
+  // All accesses to add_pending_sequence_ are sequentially consistent, so if the second load
+  // returns the same value, any operation that picks its hybrid time after it reads the clock
+  // after us.
+  const auto sequence = add_pending_sequence_.load();
+  if (sequence & 1) {
+    return HybridTime::kInvalid;
+  }
+  const HybridTime queue_front(queue_front_.load(std::memory_order_acquire));
+  HybridTime result = queue_front.is_valid() ? queue_front.Decremented() : clock_->Now();
+  if (add_pending_sequence_.load() != sequence) {
+    return HybridTime::kInvalid;
+  }
+
+  UpdateMaxHtLeaseSeen(ht_lease);
+  result = std::min(result, max_ht_lease_seen());
+  result = std::max(
+      result, HybridTime(published_last_replicated_.load(std::memory_order_acquire)));
+  if (result < min_allowed) {
+    return HybridTime::kInvalid;
+  }
+
+  auto max_returned = max_safe_time_returned_without_lock_.load(std::memory_order_acquire);
+  while (result.ToUint64() > max_returned &&
+         !max_safe_time_returned_without_lock_.compare_exchange_weak(max_returned,
+                                                                     result.ToUint64())) {
+  }
+  VLOG_WITH_PREFIX(2) << "SafeTimeWithoutLock(" << min_allowed << ", " << ht_lease
+                      << "), result = " << result;
+  return result;
+}
+
+void MvccManager::UpdateMaxHtLeaseSeen(HybridTime ht_lease) const {
+  auto max_seen = max_ht_lease_seen_.load(std::memory_order_acquire);
+  while (ht_lease.ToUint64() > max_seen &&
+         !max_ht_lease_seen_.compare_exchange_weak(max_seen, ht_lease.ToUint64())) {
+  }
+}
+
 HybridTime MvccManager::DoGetSafeTime(const HybridTime min_allowed,
                                       const CoarseTimePoint deadline,
                                       const HybridTime ht_lease,
@@ -295,7 +370,7 @@ HybridTime MvccManager::DoGetSafeTime(const HybridTime min_allowed,
 
   const bool has_lease = ht_lease.GetPhysicalValueMicros() < kMaxHybridTimePhysicalMicros;
   if (has_lease) {
-    max_ht_lease_seen_ = std::max(ht_lease, max_ht_lease_seen_);
+    UpdateMaxHtLeaseSeen(ht_lease);
   }
 
   HybridTime result;
@@ -312,8 +387,8 @@ HybridTime MvccManager::DoGetSafeTime(const HybridTime min_allowed,
       VLOG_WITH_PREFIX(2) << "DoGetSafeTime, Queue front (decremented): " << result;
     }
 
-    if (has_lease && result > max_ht_lease_seen_) {
-      result = max_ht_lease_seen_;
+    if (has_lease && result > max_ht_lease_seen()) {
+      result = max_ht_lease_seen();
       source = SafeTimeSource::kHybridTimeLease;
     }
 
@@ -326,10 +401,15 @@ HybridTime MvccManager::DoGetSafeTime(const HybridTime min_allowed,
 
   // In the case of an empty queue, the safe hybrid time to read at is only limited by hybrid time
   // ht_lease, which is by definition higher than min_allowed, so we would not get blocked.
-  if (deadline == CoarseTimePoint::max()) {
-    cond_.wait(*lock, predicate);
-  } else if (!cond_.wait_until(*lock, deadline, predicate)) {
-    return HybridTime::kInvalid;
+  if (!predicate()) {
+    if (safe_time_waits_) {
+      safe_time_waits_->Increment();
+    }
+    if (deadline == CoarseTimePoint::max()) {
+      cond_.wait(*lock, predicate);
+    } else if (!cond_.wait_until(*lock, deadline, predicate)) {
+      return HybridTime::kInvalid;
+    }
   }
   VLOG_WITH_PREFIX(1) << "DoGetSafeTime(" << min_allowed << ", "
                       << ht_lease << "), result = " << result;
@@ -340,7 +420,7 @@ HybridTime MvccManager::DoGetSafeTime(const HybridTime min_allowed,
       << ": " << EXPR_VALUE_FOR_LOG(has_lease)
       << ", " << EXPR_VALUE_FOR_LOG(enforced_min_time.ToUint64() - result.ToUint64())
       << ", " << EXPR_VALUE_FOR_LOG(ht_lease)
-      << ", " << EXPR_VALUE_FOR_LOG(max_ht_lease_seen_)
+      << ", " << EXPR_VALUE_FOR_LOG(max_ht_lease_seen())
       << ", " << EXPR_VALUE_FOR_LOG(last_replicated_)
       << ", " << EXPR_VALUE_FOR_LOG(clock_->Now())
       << ", " << EXPR_VALUE_FOR_LOG(ToString(deadline))
@@ -356,7 +436,7 @@ HybridTime MvccManager::DoGetSafeTime(const HybridTime min_allowed,
 }
 
 HybridTime MvccManager::LastReplicatedHybridTime() const {
-  std::lock_guard<std::mutex> lock(mutex_);
+  auto lock = LockMutex();
   VLOG_WITH_PREFIX(1) << __func__ << "(), result = " << last_replicated_;
   return last_replicated_;
 }
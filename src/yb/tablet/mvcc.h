@@ -32,18 +32,23 @@
 #ifndef YB_TABLET_MVCC_H_
 #define YB_TABLET_MVCC_H_
 
+#include <atomic>
 #include <condition_variable>
 #include <mutex>
 #include <deque>
 #include <queue>
 #include <vector>
 
+#include "yb/gutil/ref_counted.h"
 #include "yb/server/clock.h"
 #include "yb/util/debug-util.h"
 #include "yb/util/opid.h"
 #include "yb/util/enums.h"
 
 namespace yb {
+
+class Counter;
+
 namespace tablet {
 
 // Allows us to keep track of how a particular value of safe time was obtained, for sanity
@@ -72,6 +77,10 @@ class MvccManager {
   // Sets time of last replicated operation, used after bootstrap.
   void SetLastReplicated(HybridTime ht);
 
+  // Sets the counter incremented for every SafeTime call that has to wait for pending operations
+  // to be replicated. Should be called before the manager is used.
+  void SetSafeTimeWaitsCounter(scoped_refptr<Counter> safe_time_waits);
+
   // Sets safe time that was sent to us by the leader. Should be called on followers.
   void SetPropagatedSafeTimeOnFollower(HybridTime ht);
 
@@ -113,6 +122,9 @@ class MvccManager {
   //
   // Returns invalid hybrid time in case it cannot satisfy provided requirements, for instance
   // because of timeout.
+  //
+  // With a leader lease, most calls are answered without taking the mutex, from the published
+  // front of the queue, see SafeTimeWithoutLock.
   HybridTime SafeTime(
       HybridTime min_allowed, CoarseTimePoint deadline, HybridTime ht_lease) const;
 
@@ -132,8 +144,26 @@ class MvccManager {
                            HybridTime ht_lease,
                            std::unique_lock<std::mutex>* lock) const;
 
+  // Computes the safe time the same way as DoGetSafeTime, without taking the mutex. Returns an
+  // invalid hybrid time if an operation was being added concurrently, or if the result would be
+  // less than min_allowed, in which case the caller should fall back to DoGetSafeTime.
+  HybridTime SafeTimeWithoutLock(HybridTime min_allowed, HybridTime ht_lease) const;
+
+  // Publishes the front of queue_ for SafeTimeWithoutLock. Should be called with mutex_ held
+  // after every change of queue_.
+  void PublishQueueFront();
+
+  void UpdateMaxHtLeaseSeen(HybridTime ht_lease) const;
+
+  HybridTime max_ht_lease_seen() const {
+    return HybridTime(max_ht_lease_seen_.load(std::memory_order_acquire));
+  }
+
   const std::string& LogPrefix() const { return prefix_; }
-  void PopFront(std::lock_guard<std::mutex>* lock);
+  void PopFront(std::unique_lock<std::mutex>* lock);
+
+  // Locks mutex_, recording the contention when it is profiled.
+  std::unique_lock<std::mutex> LockMutex() const;
 
   std::string prefix_;
   server::ClockPtr clock_;
@@ -157,7 +187,27 @@ class MvccManager {
   // Because different calls that have current hybrid time leader lease as an argument can come to
   // us out of order, we might see an older value of hybrid time leader lease expiration after a
   // newer value. We mitigate this by always using the highest value we've seen.
-  mutable HybridTime max_ht_lease_seen_ = HybridTime::kMin;
+  // Atomic, because SafeTimeWithoutLock also updates it.
+  mutable std::atomic<uint64_t> max_ht_lease_seen_{HybridTime::kMin.ToUint64()};
+
+  // State published for SafeTimeWithoutLock, which reads it without holding mutex_.
+  //
+  // Incremented by AddPending before it picks the hybrid time of a new operation and again after
+  // the operation is in queue_, so it is odd while an operation is being added. A reader that sees
+  // the same even value before and after reading the clock knows that every operation that picks
+  // its hybrid time later gets a higher one, since the clock is monotonic.
+  std::atomic<uint64_t> add_pending_sequence_{0};
+
+  // Front of queue_, or HybridTime::kInvalid if queue_ is empty.
+  std::atomic<uint64_t> queue_front_{HybridTime::kInvalid.ToUint64()};
+
+  // Same as last_replicated_.
+  std::atomic<uint64_t> published_last_replicated_{HybridTime::kMin.ToUint64()};
+
+  // Highest safe time returned by SafeTimeWithoutLock, for the sanity check in AddPending.
+  mutable std::atomic<uint64_t> max_safe_time_returned_without_lock_{HybridTime::kMin.ToUint64()};
+
+  scoped_refptr<Counter> safe_time_waits_;
 
   mutable SafeTimeWithSource max_safe_time_returned_with_lease_;
   mutable SafeTimeWithSource max_safe_time_returned_without_lease_;
@@ -0,0 +1,83 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+
+#include "yb/tablet/operations/ingest_external_files_operation.h"
+
+#include <glog/logging.h>
+
+#include "yb/common/wire_protocol.h"
+#include "yb/consensus/consensus.h"
+#include "yb/server/hybrid_clock.h"
+#include "yb/tablet/tablet.h"
+#include "yb/tserver/tserver.pb.h"
+#include "yb/util/trace.h"
+
+namespace yb {
+namespace tablet {
+
+using consensus::ReplicateMsg;
+using consensus::INGEST_EXTERNAL_FILES_OP;
+using strings::Substitute;
+
+void IngestExternalFilesOperationState::UpdateRequestFromConsensusRound() {
+  request_ = consensus_round()->replicate_msg()->mutable_ingest_external_files_request();
+}
+
+string IngestExternalFilesOperationState::ToString() const {
+  return Format("IngestExternalFilesOperationState [hybrid_time=$0, source_dir=$1]",
+                hybrid_time_even_if_unset(), request_ ? request_->source_dir() : "<NULL>");
+}
+
+IngestExternalFilesOperation::IngestExternalFilesOperation(
+    std::unique_ptr<IngestExternalFilesOperationState> state)
+    : Operation(std::move(state), OperationType::kIngestExternalFiles) {
+}
+
+consensus::ReplicateMsgPtr IngestExternalFilesOperation::NewReplicateMsg() {
+  auto result = std::make_shared<ReplicateMsg>();
+  result->set_op_type(INGEST_EXTERNAL_FILES_OP);
+  result->mutable_ingest_external_files_request()->CopyFrom(*state()->request());
+  return result;
+}
+
+void IngestExternalFilesOperation::DoStart() {
+  state()->TrySetHybridTimeFromClock();
+
+  TRACE("START INGEST EXTERNAL FILES: hybrid time: $0",
+        server::HybridClock::GetPhysicalValueMicros(state()->hybrid_time()));
+}
+
+Status IngestExternalFilesOperation::Apply(int64_t leader_term) {
+  TRACE("APPLY INGEST EXTERNAL FILES: started");
+
+  auto status = state()->tablet()->IngestExternalFiles(state());
+  if (!status.ok()) {
+    LOG_WITH_PREFIX(WARNING) << "Failed to ingest external files: " << status;
+    auto* response = state()->response();
+    if (response) {
+      StatusToPB(status, response->mutable_error()->mutable_status());
+      response->mutable_error()->set_code(tserver::TabletServerErrorPB::UNKNOWN_ERROR);
+    }
+  }
+
+  TRACE("APPLY INGEST EXTERNAL FILES: finished");
+  return Status::OK();
+}
+
+string IngestExternalFilesOperation::ToString() const {
+  return Substitute("IngestExternalFilesOperation [state=$0]", state()->ToString());
+}
+
+}  // namespace tablet
+}  // namespace yb
@@ -0,0 +1,90 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+
+#ifndef YB_TABLET_OPERATIONS_INGEST_EXTERNAL_FILES_OPERATION_H
+#define YB_TABLET_OPERATIONS_INGEST_EXTERNAL_FILES_OPERATION_H
+
+#include <string>
+
+#include "yb/gutil/macros.h"
+#include "yb/tablet/operations/operation.h"
+
+namespace yb {
+namespace tablet {
+
+// Operation Context for the IngestExternalFiles operation.
+// Keeps track of the Operation states (request, result, ...)
+class IngestExternalFilesOperationState : public OperationState {
+ public:
+  explicit IngestExternalFilesOperationState(
+      Tablet* tablet, const tserver::IngestExternalFilesRequestPB* request = nullptr,
+      tserver::IngestExternalFilesResponsePB* response = nullptr)
+      : OperationState(tablet), request_(request), response_(response) {}
+  ~IngestExternalFilesOperationState() {}
+
+  const tserver::IngestExternalFilesRequestPB* request() const override { return request_; }
+
+  // The response is only available on the leader replica that received the request.
+  tserver::IngestExternalFilesResponsePB* response() const { return response_; }
+
+  void UpdateRequestFromConsensusRound() override;
+
+  virtual std::string ToString() const override;
+
+ private:
+  // The original RPC request and response.
+  const tserver::IngestExternalFilesRequestPB *request_;
+  tserver::IngestExternalFilesResponsePB *response_;
+
+  DISALLOW_COPY_AND_ASSIGN(IngestExternalFilesOperationState);
+};
+
+// Ingests SST files built outside of the tablet. Only the request is replicated, each replica
+// hard links the files into its own RocksDB, so bulk loaded data does not go through the write
+// path.
+class IngestExternalFilesOperation : public Operation {
+ public:
+  explicit IngestExternalFilesOperation(
+      std::unique_ptr<IngestExternalFilesOperationState> operation_state);
+
+  IngestExternalFilesOperationState* state() override {
+    return down_cast<IngestExternalFilesOperationState*>(Operation::state());
+  }
+
+  const IngestExternalFilesOperationState* state() const override {
+    return down_cast<const IngestExternalFilesOperationState*>(Operation::state());
+  }
+
+  consensus::ReplicateMsgPtr NewReplicateMsg() override;
+
+  CHECKED_STATUS Prepare() override { return Status::OK(); }
+
+  // Executes an Apply for the ingest external files operation. A failed import leaves the tablet
+  // unchanged and is reported in the response instead of failing the apply, since it fails the
+  // same way on every replica that has the same files.
+  CHECKED_STATUS Apply(int64_t leader_term) override;
+
+  std::string ToString() const override;
+
+ private:
+  // Starts the IngestExternalFilesOperation by assigning it a timestamp.
+  void DoStart() override;
+
+  DISALLOW_COPY_AND_ASSIGN(IngestExternalFilesOperation);
+};
+
+}  // namespace tablet
+}  // namespace yb
+
+#endif  // YB_TABLET_OPERATIONS_INGEST_EXTERNAL_FILES_OPERATION_H
@@ -108,6 +108,11 @@ Status OperationDriver::Init(std::unique_ptr<Operation>* operation, int64_t term
     if (consensus_) {  // sometimes NULL in tests
       // Unretained is required to avoid a refcount cycle.
       consensus::ReplicateMsgPtr replicate_msg = operation_->NewReplicateMsg();
+      if (PREDICT_FALSE(trace_context_.sampled())) {
+        auto* trace_context = replicate_msg->mutable_trace_context();
+        trace_context->set_trace_id(trace_context_.trace_id);
+        trace_context->set_parent_span_id(trace_context_.span_id);
+      }
       mutable_state()->set_consensus_round(
         consensus_->NewRound(std::move(replicate_msg),
                              std::bind(&OperationDriver::ReplicationFinished, this, _1, _2)));
@@ -373,6 +378,10 @@ void OperationDriver::ReplicationFinished(const Status& status, int64_t leader_t
     prepare_state_copy = prepare_state_;
   }
 
+  if (PREDICT_FALSE(trace_context_.sampled())) {
+    RecordSpan(trace_context_, "Replicate", start_time_);
+  }
+
   // If we have prepared and replicated, we're ready to move ahead and apply this operation.
   // Note that if we set the state to REPLICATION_FAILED above, ApplyOperation() will actually abort
   // the operation, i.e. ApplyTask() will never be called and the operation will never be applied to
@@ -39,6 +39,7 @@
 #include "yb/gutil/ref_counted.h"
 #include "yb/gutil/walltime.h"
 #include "yb/tablet/operations/operation.h"
+#include "yb/util/distributed_trace.h"
 #include "yb/util/lockfree.h"
 #include "yb/util/status.h"
 #include "yb/util/trace.h"
@@ -285,6 +286,9 @@ class OperationDriver : public RefCountedThreadSafe<OperationDriver>,
 
   const MonoTime start_time_;
 
+  // Span of the replication of the operation, if it is part of a traced request.
+  const TraceContext trace_context_ = TraceContext::Current().NewChild();
+
   ReplicationState replication_state_;
   PrepareState prepare_state_;
 
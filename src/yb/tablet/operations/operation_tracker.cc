@@ -80,6 +80,10 @@ METRIC_DEFINE_gauge_uint64(tablet, truncate_operations_inflight,
                            "Truncate Operations In Flight",
                            yb::MetricUnit::kOperations,
                            "Number of truncate operations currently in-flight");
+METRIC_DEFINE_gauge_uint64(tablet, ingest_external_files_operations_inflight,
+                           "Ingest External Files Operations In Flight",
+                           yb::MetricUnit::kOperations,
+                           "Number of ingest external files operations currently in-flight");
 METRIC_DEFINE_gauge_uint64(tablet, empty_operations_inflight,
                            "Empty Operations In Flight",
                            yb::MetricUnit::kOperations,
@@ -112,8 +116,9 @@ OperationTracker::Metrics::Metrics(const scoped_refptr<MetricEntity>& entity)
   INSTANTIATE(UpdateTransaction, update_transaction);
   INSTANTIATE(Snapshot, snapshot);
   INSTANTIATE(Truncate, truncate);
+  INSTANTIATE(IngestExternalFiles, ingest_external_files);
   INSTANTIATE(Empty, empty);
-  static_assert(6 == kElementsInOperationType, "Init metrics for all operation types");
+  static_assert(7 == kElementsInOperationType, "Init metrics for all operation types");
 }
 #undef INSTANTIATE
 #undef GINIT
@@ -58,6 +58,11 @@ DEFINE_test_flag(int32, tablet_inject_latency_on_apply_write_txn_ms, 0,
                  "How much latency to inject when a write operation is applied.");
 DEFINE_test_flag(bool, tablet_pause_apply_write_ops, false,
                  "Pause applying of write operations.");
+
+DEFINE_int32(tablet_slow_write_threshold_ms, 0,
+             "Writes that take longer than this on the leader have their latency breakdown by "
+             "phase logged and added to their trace. 0 disables it.");
+TAG_FLAG(tablet_slow_write_threshold_ms, runtime);
 TAG_FLAG(tablet_inject_latency_on_apply_write_txn_ms, runtime);
 TAG_FLAG(tablet_pause_apply_write_ops, runtime);
 
@@ -79,7 +84,8 @@ WriteOperation::WriteOperation(
     std::unique_ptr<WriteOperationState> state, int64_t term, CoarseTimePoint deadline,
     WriteOperationContext* context)
     : Operation(std::move(state), OperationType::kWrite),
-      context_(*context), term_(term), deadline_(deadline), start_time_(MonoTime::Now()) {
+      context_(*context), term_(term), deadline_(deadline), start_time_(MonoTime::Now()),
+      phase_start_(start_time_) {
 }
 
 consensus::ReplicateMsgPtr WriteOperation::NewReplicateMsg() {
@@ -96,6 +102,7 @@ Status WriteOperation::Prepare() {
 
 void WriteOperation::DoStart() {
   TRACE("Start()");
+  PhaseDone(WritePhase::kPrepare);
   state()->tablet()->StartOperation(state());
 }
 
@@ -116,7 +123,9 @@ Status WriteOperation::Apply(int64_t leader_term) {
 
   Tablet* tablet = state()->tablet();
 
+  PhaseDone(WritePhase::kReplication);
   tablet->ApplyRowOperations(state());
+  PhaseDone(WritePhase::kApply);
 
   return Status::OK();
 }
@@ -137,9 +146,42 @@ void WriteOperation::Finish(OperationResult result) {
 
   TabletMetrics* metrics = tablet()->metrics();
   if (metrics && state()->has_completion_callback()) {
-    auto op_duration_usec = MonoTime::Now().GetDeltaSince(start_time_).ToMicroseconds();
-    metrics->write_op_duration_client_propagated_consistency->Increment(op_duration_usec);
+    auto op_duration = MonoTime::Now().GetDeltaSince(start_time_);
+    metrics->write_op_duration_client_propagated_consistency->Increment(
+        op_duration.ToMicroseconds());
+    RecordPhases(metrics, op_duration);
+  }
+}
+
+void WriteOperation::PhaseDone(WritePhase phase) {
+  const auto now = MonoTime::Now();
+  phase_durations_[to_underlying(phase)] = now.GetDeltaSince(phase_start_);
+  phase_start_ = now;
+}
+
+void WriteOperation::RecordPhases(TabletMetrics* metrics, MonoDelta op_duration) {
+  for (auto phase : kWritePhaseList) {
+    const auto& duration = phase_durations_[to_underlying(phase)];
+    // Lock latency is recorded by docdb, and phases that the write skipped are not recorded.
+    if (phase != WritePhase::kLock && duration.Initialized()) {
+      metrics->write_phase_latency[to_underlying(phase)]->Increment(duration.ToMicroseconds());
+    }
+  }
+
+  const auto threshold_ms = FLAGS_tablet_slow_write_threshold_ms;
+  if (threshold_ms <= 0 || op_duration.ToMilliseconds() < threshold_ms) {
+    return;
+  }
+  std::string breakdown;
+  for (auto phase : kWritePhaseList) {
+    const auto& duration = phase_durations_[to_underlying(phase)];
+    if (duration.Initialized()) {
+      breakdown += Substitute(" $0: $1us", ToCString(phase), duration.ToMicroseconds());
+    }
   }
+  TRACE("Slow write, phases:$0", breakdown);
+  LOG(WARNING) << "Slow write to " << tablet()->tablet_id() << " took "
+               << op_duration.ToMicroseconds() << "us, phases:" << breakdown;
 }
 
 string WriteOperation::ToString() const {
@@ -51,6 +51,7 @@
 
 #include "yb/tablet/lock_manager.h"
 #include "yb/tablet/tablet.pb.h"
+#include "yb/tablet/tablet_metrics.h"
 #include "yb/tablet/operations/operation.h"
 
 #include "yb/util/locks.h"
@@ -279,7 +280,13 @@ class WriteOperation : public Operation {
     operation.release()->DoStartSynchronization(status);
   }
 
+  // Records the end of the phase, which started where the previous recorded phase ended.
+  void PhaseDone(WritePhase phase);
+
  private:
+  // Updates the phase latency histograms, and logs the breakdown if the write was slow.
+  void RecordPhases(TabletMetrics* metrics, MonoDelta op_duration);
+
   // Actually starts the Mvcc transaction and assigns a hybrid_time to this transaction.
   void DoStart() override;
   void DoStartSynchronization(const Status& status);
@@ -291,6 +298,9 @@ class WriteOperation : public Operation {
   // this transaction's start time
   MonoTime start_time_;
 
+  MonoTime phase_start_;
+  std::array<MonoDelta, kWritePhaseMapSize> phase_durations_;
+
   HybridTime restart_read_ht_;
 
   docdb::DocOperations doc_ops_;
@@ -11,6 +11,7 @@
 // under the License.
 //
 
+#include <algorithm>
 #include <atomic>
 #include <condition_variable>
 #include <memory>
@@ -24,11 +25,44 @@
 #include "yb/tablet/preparer.h"
 #include "yb/tablet/operations/operation_driver.h"
 #include "yb/util/logging.h"
+#include "yb/util/metrics.h"
 #include "yb/util/threadpool.h"
 #include "yb/util/lockfree.h"
+#include "yb/util/size_literals.h"
+
+using namespace yb::size_literals;
 
 DEFINE_int32(max_group_replicate_batch_size, 16,
-             "Maximum number of operations to submit to consensus for replication in a batch.");
+             "Maximum number of operations to submit to consensus for replication in a batch. "
+             "With adaptive_group_replicate_batch_size it is the initial limit.");
+DEFINE_bool(adaptive_group_replicate_batch_size, true,
+            "Whether to raise the limit on operations in a replication batch up to "
+            "max_adaptive_group_replicate_batch_size while operations arrive faster than they "
+            "are submitted to consensus, and lower it back once the prepare queue drains.");
+DEFINE_int32(max_adaptive_group_replicate_batch_size, 256,
+             "Upper bound of the adaptive limit on operations in a replication batch.");
+DEFINE_uint64(max_group_replicate_batch_bytes, 4_MB,
+              "Maximum total size of the replicate messages submitted to consensus in a batch.");
+
+METRIC_DEFINE_histogram(tablet, op_prepare_batch_size, "Operation Prepare Batch Size",
+                        yb::MetricUnit::kOperations,
+                        "Number of leader side operations submitted to consensus in one batch.",
+                        10000, 2);
+
+METRIC_DEFINE_histogram(tablet, op_prepare_batch_bytes, "Operation Prepare Batch Bytes",
+                        yb::MetricUnit::kBytes,
+                        "Total size of the replicate messages submitted to consensus in one batch.",
+                        1024 * 1024 * 1024, 2);
+
+METRIC_DEFINE_counter(tablet, op_prepare_batches_at_limit, "Operation Batches At Limit",
+                      yb::MetricUnit::kUnits,
+                      "Number of replication batches that were submitted because they reached "
+                      "the operation count or size limit, while more operations were waiting.");
+
+METRIC_DEFINE_counter(tablet, op_prepare_batches_on_drain, "Operation Batches On Drain",
+                      yb::MetricUnit::kUnits,
+                      "Number of replication batches that were submitted because the prepare "
+                      "queue became empty.");
 
 using std::vector;
 
@@ -38,12 +72,16 @@ class ThreadPoolToken;
 
 namespace tablet {
 
+METRIC_DECLARE_histogram(op_prepare_queue_length);
+METRIC_DECLARE_histogram(op_prepare_queue_time);
+
 // ------------------------------------------------------------------------------------------------
 // PreparerImpl
 
 class PreparerImpl {
  public:
-  explicit PreparerImpl(consensus::Consensus* consensus, ThreadPool* tablet_prepare_pool);
+  PreparerImpl(consensus::Consensus* consensus, ThreadPool* tablet_prepare_pool,
+               const scoped_refptr<MetricEntity>& metric_entity);
   ~PreparerImpl();
   CHECKED_STATUS Start();
   void Stop();
@@ -88,6 +126,19 @@ class PreparerImpl {
 
   OperationDrivers leader_side_batch_;
 
+  // Total size of the replicate messages in leader_side_batch_.
+  size_t leader_side_batch_bytes_ = 0;
+
+  // Current limit on the number of operations in leader_side_batch_.
+  size_t batch_size_limit_;
+
+  scoped_refptr<Histogram> queue_length_;
+  scoped_refptr<Histogram> queue_time_;
+  scoped_refptr<Histogram> batch_size_;
+  scoped_refptr<Histogram> batch_bytes_;
+  scoped_refptr<Counter> batches_at_limit_;
+  scoped_refptr<Counter> batches_on_drain_;
+
   std::unique_ptr<ThreadPoolToken> tablet_prepare_pool_token_;
 
   // A temporary buffer of rounds to replicate, used to reduce reallocation.
@@ -106,10 +157,20 @@ class PreparerImpl {
 };
 
 PreparerImpl::PreparerImpl(consensus::Consensus* consensus,
-                                     ThreadPool* tablet_prepare_pool)
+                           ThreadPool* tablet_prepare_pool,
+                           const scoped_refptr<MetricEntity>& metric_entity)
     : consensus_(consensus),
+      batch_size_limit_(FLAGS_max_group_replicate_batch_size),
       tablet_prepare_pool_token_(tablet_prepare_pool
                                      ->NewToken(ThreadPool::ExecutionMode::SERIAL)) {
+  if (metric_entity) {
+    queue_length_ = METRIC_op_prepare_queue_length.Instantiate(metric_entity);
+    queue_time_ = METRIC_op_prepare_queue_time.Instantiate(metric_entity);
+    batch_size_ = METRIC_op_prepare_batch_size.Instantiate(metric_entity);
+    batch_bytes_ = METRIC_op_prepare_batch_bytes.Instantiate(metric_entity);
+    batches_at_limit_ = METRIC_op_prepare_batches_at_limit.Instantiate(metric_entity);
+    batches_on_drain_ = METRIC_op_prepare_batches_on_drain.Instantiate(metric_entity);
+  }
 }
 
 PreparerImpl::~PreparerImpl() {
@@ -158,9 +219,24 @@ void PreparerImpl::Run() {
   VLOG(2) << "Starting prepare task:" << this;
   for (;;) {
     while (OperationDriver *item = queue_.Pop()) {
-      active_tasks_.fetch_sub(1, std::memory_order_release);
+      auto queue_length = active_tasks_.fetch_sub(1, std::memory_order_acq_rel);
+      if (queue_length_) {
+        queue_length_->Increment(queue_length);
+        queue_time_->Increment((MonoTime::Now() - item->start_time()).ToMicroseconds());
+      }
       ProcessItem(item);
     }
+    // There is nothing else to add, so send what we have instead of letting consensus idle.
+    // The backlog is gone, so smaller batches are enough again.
+    if (!leader_side_batch_.empty()) {
+      if (batches_on_drain_) {
+        batches_on_drain_->Increment();
+      }
+      if (FLAGS_adaptive_group_replicate_batch_size) {
+        batch_size_limit_ = std::max<size_t>(
+            batch_size_limit_ / 2, FLAGS_max_group_replicate_batch_size);
+      }
+    }
     ProcessAndClearLeaderSideBatch();
     std::unique_lock<std::mutex> stop_lock(stop_mtx_);
     running_.store(false, std::memory_order_release);
@@ -195,16 +271,33 @@ void PreparerImpl::ProcessItem(OperationDriver* item) {
     const bool apply_separately = operation_type == OperationType::kChangeMetadata ||
                                   operation_type == OperationType::kEmpty;
     const int64_t bound_term = apply_separately ? -1 : item->consensus_round()->bound_term();
-
-    // Don't add more than the max number of operations to a batch, and also don't add
-    // operations bound to different terms, so as not to fail unrelated operations
+    const size_t item_bytes = item->consensus_round()->replicate_msg()->ByteSizeLong();
+
+    // Don't add more than the max number of operations or bytes to a batch. We get here with a
+    // full batch only while operations are waiting in the queue, i.e. they arrive faster than
+    // we submit them, so let the following batches be larger.
+    if (!leader_side_batch_.empty() &&
+        (leader_side_batch_.size() >= batch_size_limit_ ||
+         leader_side_batch_bytes_ + item_bytes > FLAGS_max_group_replicate_batch_bytes)) {
+      if (batches_at_limit_) {
+        batches_at_limit_->Increment();
+      }
+      if (FLAGS_adaptive_group_replicate_batch_size) {
+        batch_size_limit_ = std::min<size_t>(
+            batch_size_limit_ * 2,
+            std::max(FLAGS_max_adaptive_group_replicate_batch_size,
+                     FLAGS_max_group_replicate_batch_size));
+      }
+      ProcessAndClearLeaderSideBatch();
+    }
+    // Also don't add operations bound to different terms, so as not to fail unrelated operations
     // unnecessarily in case of a bound term mismatch.
-    if (leader_side_batch_.size() >= FLAGS_max_group_replicate_batch_size ||
-        (!leader_side_batch_.empty() &&
-            bound_term != leader_side_batch_.back()->consensus_round()->bound_term())) {
+    if (!leader_side_batch_.empty() &&
+        bound_term != leader_side_batch_.back()->consensus_round()->bound_term()) {
       ProcessAndClearLeaderSideBatch();
     }
     leader_side_batch_.push_back(item);
+    leader_side_batch_bytes_ += item_bytes;
     if (apply_separately) {
       ProcessAndClearLeaderSideBatch();
     }
@@ -223,6 +316,11 @@ void PreparerImpl::ProcessAndClearLeaderSideBatch() {
 
   VLOG(2) << "Preparing a batch of " << leader_side_batch_.size() << " leader-side operations";
 
+  if (batch_size_) {
+    batch_size_->Increment(leader_side_batch_.size());
+    batch_bytes_->Increment(leader_side_batch_bytes_);
+  }
+
   auto iter = leader_side_batch_.begin();
   auto replication_subbatch_begin = iter;
   auto replication_subbatch_end = iter;
@@ -253,6 +351,7 @@ void PreparerImpl::ProcessAndClearLeaderSideBatch() {
   ReplicateSubBatch(replication_subbatch_begin, replication_subbatch_end);
 
   leader_side_batch_.clear();
+  leader_side_batch_bytes_ = 0;
 }
 
 void PreparerImpl::ReplicateSubBatch(
@@ -295,8 +394,9 @@ void PreparerImpl::ReplicateSubBatch(
 // ------------------------------------------------------------------------------------------------
 // Preparer
 
-Preparer::Preparer(consensus::Consensus* consensus, ThreadPool* tablet_prepare_thread)
-    : impl_(std::make_unique<PreparerImpl>(consensus, tablet_prepare_thread)) {
+Preparer::Preparer(consensus::Consensus* consensus, ThreadPool* tablet_prepare_thread,
+                   const scoped_refptr<MetricEntity>& metric_entity)
+    : impl_(std::make_unique<PreparerImpl>(consensus, tablet_prepare_thread, metric_entity)) {
 }
 
 Preparer::~Preparer() = default;
@@ -16,6 +16,8 @@
 
 #include <gflags/gflags.h>
 
+#include "yb/gutil/ref_counted.h"
+
 #include "yb/util/status.h"
 #include "yb/util/threadpool.h"
 
@@ -23,6 +25,7 @@ DECLARE_int32(max_group_replicate_batch_size);
 DECLARE_int32(prepare_queue_max_size);
 
 namespace yb {
+class MetricEntity;
 class ThreadPool;
 
 namespace consensus {
@@ -38,10 +41,15 @@ class PreparerImpl;
 // This is a thread that invokes the "prepare" step on single-shard transactions and, for
 // leader-side transactions, submits them for replication to the consensus in batches. This is
 // useful because we have a "fat lock" in the consensus.
+// A batch is submitted as soon as the queue is empty, so consensus never waits for a batch to fill
+// up. While operations keep arriving faster than batches are submitted, the limit on operations
+// per batch is raised, so consensus and the WAL get fewer and larger batches.
 // Preparer does not manage a thread but only submits to a token in a thread pool.
 class Preparer {
  public:
-  explicit Preparer(consensus::Consensus* consensus, ThreadPool* tablet_prepare_pool);
+  // metric_entity could be null, in which case no metrics are collected.
+  Preparer(consensus::Consensus* consensus, ThreadPool* tablet_prepare_pool,
+           const scoped_refptr<MetricEntity>& metric_entity);
   ~Preparer();
 
   CHECKED_STATUS Start();
@@ -30,6 +30,8 @@
 // under the License.
 //
 
+#include <thread>
+
 #include <glog/logging.h>
 
 #include "yb/common/schema.h"
@@ -108,6 +110,38 @@ TEST_F(TestTabletMetadata, TestLoadFromSuperBlock) {
             << superblock_pb_1.DebugString();
 }
 
+// Test that concurrent flushes share superblock writes, and that the last written superblock
+// reflects the latest state.
+TEST_F(TestTabletMetadata, TestConcurrentFlush) {
+  TabletMetadata* meta = harness_->tablet()->metadata();
+  const auto writes_before = meta->superblock_writes();
+
+  constexpr int kNumThreads = 8;
+  constexpr int kFlushesPerThread = 50;
+  std::vector<std::thread> threads;
+  for (int i = 0; i != kNumThreads; ++i) {
+    threads.emplace_back([meta] {
+      for (int j = 0; j != kFlushesPerThread; ++j) {
+        ASSERT_OK(meta->Flush());
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  const auto writes = meta->superblock_writes() - writes_before;
+  LOG(INFO) << "Superblock writes: " << writes;
+  ASSERT_GT(writes, 0);
+  ASSERT_LE(writes, kNumThreads * kFlushesPerThread);
+
+  TabletSuperBlockPB in_memory;
+  meta->ToSuperBlock(&in_memory);
+  TabletSuperBlockPB on_disk;
+  ASSERT_OK(meta->ReadSuperBlockFromDisk(&on_disk));
+  ASSERT_EQ(in_memory.SerializeAsString(), on_disk.SerializeAsString());
+}
+
 
 } // namespace tablet
 } // namespace yb
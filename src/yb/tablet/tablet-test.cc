@@ -212,5 +212,27 @@ TYPED_TEST(TestTablet, TestFlushedOpId) {
   ASSERT_EQ(id.index, start_index + 2*kCount);
 }
 
+TYPED_TEST(TestTablet, TestHibernateIdleTablet) {
+  auto tablet = this->tablet().get();
+  const int64_t kCount = 100;
+  this->InsertTestRows(0, kCount, 555);
+
+  // Recently written tablet is not idle.
+  ASSERT_FALSE(ASSERT_RESULT(tablet->HibernateIfIdle(std::chrono::hours(1))));
+  ASSERT_FALSE(tablet->hibernating());
+
+  ASSERT_TRUE(ASSERT_RESULT(tablet->HibernateIfIdle(CoarseDuration::zero())));
+  ASSERT_TRUE(tablet->hibernating());
+  ASSERT_EQ(1, tablet->metrics()->hibernations->value());
+  // Hibernating tablet is not hibernated again.
+  ASSERT_FALSE(ASSERT_RESULT(tablet->HibernateIfIdle(CoarseDuration::zero())));
+
+  // Writing wakes the tablet up, and the rows flushed before the hibernation are still there.
+  this->InsertTestRows(kCount, 1, 555);
+  ASSERT_FALSE(tablet->hibernating());
+  ASSERT_FALSE(tablet->MarkAccessed());
+  this->VerifyTestRows(0, kCount + 1);
+}
+
 } // namespace tablet
 } // namespace yb
@@ -38,6 +38,7 @@
 #include <memory>
 #include <mutex>
 #include <ostream>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -67,13 +68,16 @@
 #include "yb/consensus/log_anchor_registry.h"
 #include "yb/consensus/opid_util.h"
 
+#include "yb/docdb/adaptive_seek_tuner.h"
 #include "yb/docdb/conflict_resolution.h"
 #include "yb/docdb/consensus_frontier.h"
+#include "yb/docdb/doc_row_cache.h"
 #include "yb/docdb/doc_rowwise_iterator.h"
 #include "yb/docdb/docdb.h"
 #include "yb/docdb/docdb.pb.h"
 #include "yb/docdb/docdb_compaction_filter.h"
 #include "yb/docdb/docdb_compaction_filter_intents.h"
+#include "yb/docdb/docdb_execution_stats.h"
 #include "yb/docdb/docdb_rocksdb_util.h"
 #include "yb/docdb/intent.h"
 #include "yb/docdb/primitive_value.h"
@@ -88,12 +92,14 @@
 #include "yb/rocksutil/yb_rocksdb_logger.h"
 #include "yb/server/hybrid_clock.h"
 
+#include "yb/tablet/hot_keys.h"
 #include "yb/tablet/maintenance_manager.h"
 #include "yb/tablet/tablet_metrics.h"
 #include "yb/tablet/tablet_retention_policy.h"
 #include "yb/tablet/transaction_coordinator.h"
 #include "yb/tablet/transaction_participant.h"
 #include "yb/tablet/operations/change_metadata_operation.h"
+#include "yb/tablet/operations/ingest_external_files_operation.h"
 #include "yb/tablet/operations/truncate_operation.h"
 #include "yb/tablet/operations/write_operation.h"
 #include "yb/tablet/tablet_options.h"
@@ -119,6 +125,16 @@ TAG_FLAG(tablet_do_dup_key_checks, unsafe);
 DEFINE_bool(tablet_do_compaction_cleanup_for_intents, true,
             "Whether to clean up intents for aborted transactions in compaction.");
 
+DEFINE_int64(tablet_row_cache_size_bytes, 0,
+             "Capacity of the per-tablet cache of decoded rows used by point reads of "
+             "non-transactional tables. 0 disables the row cache.");
+TAG_FLAG(tablet_row_cache_size_bytes, advanced);
+
+DEFINE_bool(tablet_adaptive_nexts_to_avoid_seek, true,
+            "Whether to learn, per tablet and per RocksDB instance, how many nexts to try before "
+            "doing a RocksDB seek, instead of always using max_nexts_to_avoid_seek.");
+TAG_FLAG(tablet_adaptive_nexts_to_avoid_seek, advanced);
+
 DEFINE_int32(tablet_bloom_block_size, 4096,
              "Block size of the bloom filters used for tablet keys.");
 TAG_FLAG(tablet_bloom_block_size, advanced);
@@ -143,6 +159,17 @@ DEFINE_int32(intents_flush_max_delay_ms, 2000,
              "Max time to wait for regular db to flush during flush of intents. "
              "After this time flush of regular db will be forced.");
 
+DEFINE_bool(wait_for_conflicting_transactions, false,
+            "When a transactional write conflicts with a transaction of higher priority, wait for "
+            "that transaction to finish instead of failing.");
+TAG_FLAG(wait_for_conflicting_transactions, advanced);
+TAG_FLAG(wait_for_conflicting_transactions, runtime);
+
+DEFINE_int32(conflicting_transactions_recheck_interval_ms, 100,
+             "Max time a write waiting for conflicting transactions sleeps before resolving its "
+             "conflicts again. Transactions aborted by another tablet are noticed only then.");
+TAG_FLAG(conflicting_transactions_recheck_interval_ms, advanced);
+
 DEFINE_test_flag(
     bool, tablet_verify_flushed_frontier_after_modifying, false,
     "After modifying the flushed frontier in RocksDB, verify that the restored value of it "
@@ -289,6 +316,30 @@ CHECKED_STATUS EmitRocksDbMetricsAsPrometheus(
   return Status::OK();
 }
 
+// Marks the tablet as accessed by a read or write, and if that woke the tablet up from
+// hibernation, records how long the access took.
+class ScopedTabletAccess {
+ public:
+  explicit ScopedTabletAccess(Tablet* tablet)
+      : tablet_(tablet), woke_up_(tablet->MarkAccessed()),
+        start_(woke_up_ ? CoarseMonoClock::Now() : CoarseTimePoint()) {
+  }
+
+  ~ScopedTabletAccess() {
+    if (woke_up_ && tablet_->metrics()) {
+      tablet_->metrics()->wake_up_latency->Increment(
+          ToMicroseconds(CoarseMonoClock::Now() - start_));
+    }
+  }
+
+ private:
+  Tablet* const tablet_;
+  const bool woke_up_;
+  const CoarseTimePoint start_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScopedTabletAccess);
+};
+
 } // namespace
 
 string DocDbOpIds::ToString() const {
@@ -347,10 +398,15 @@ Tablet::Tablet(
     });
 
     metrics_.reset(new TabletMetrics(metric_entity_));
+    shared_lock_manager_.SetLockWaitsCounter(metrics_->write_lock_waits);
+    mvcc_.SetSafeTimeWaitsCounter(metrics_->safe_time_waits);
 
     mem_tracker_->SetMetricEntity(metric_entity_);
   }
 
+  hot_keys_ = std::make_unique<HotKeys>(
+      metrics_ ? metrics_->hottest_key_ops_per_sec : scoped_refptr<AtomicGauge<uint64_t>>());
+
   if (transaction_participant_context && metadata->schema().table_properties().is_transactional()) {
     transaction_participant_ = std::make_unique<TransactionParticipant>(
         transaction_participant_context, this);
@@ -475,6 +531,10 @@ Result<bool> Tablet::IntentsDbFlushFilter(const rocksdb::MemTable& memtable) {
   return false;
 }
 
+const IOMetrics* Tablet::io_metrics(IOClass io_class) const {
+  return metrics_ ? metrics_->io_metrics[to_underlying(io_class)].get() : nullptr;
+}
+
 std::string Tablet::LogPrefix() const {
   return Format("T $0$1: ", tablet_id(), log_prefix_suffix_);
 }
@@ -486,8 +546,14 @@ Status Tablet::OpenKeyValueTablet() {
 
   // Install the history cleanup handler. Note that TabletRetentionPolicy is going to hold a raw ptr
   // to this tablet. So, we ensure that rocksdb_ is reset before this tablet gets destroyed.
+  auto retention_policy = make_shared<TabletRetentionPolicy>(this);
   rocksdb_options.compaction_filter_factory = make_shared<DocDBCompactionFilterFactory>(
-      make_shared<TabletRetentionPolicy>(this));
+      retention_policy);
+  // Files of tables with a default TTL whose values all expired are deleted without being read.
+  rocksdb_options.expired_files_selector = docdb::CreateTtlExpiredFilesSelector(retention_policy);
+  // Files with many versions that are no longer visible are marked for compaction.
+  rocksdb_options.table_properties_collector_factories.push_back(
+      docdb::CreateObsoleteVersionsCollectorFactory(retention_policy));
 
   rocksdb_options.mem_table_flush_filter_factory = MakeMemTableFlushFilterFactory([this] {
     if (mem_table_flush_filter_factory_) {
@@ -498,9 +564,51 @@ Status Tablet::OpenKeyValueTablet() {
 
   rocksdb_options.disable_auto_compactions = true;
 
+  // The I/O of the flushes and compactions of both DBs is accounted to the tablet.
+  if (metrics_) {
+    rocksdb_options.flush_io_metrics = metrics_->io_metrics[to_underlying(IOClass::kFlush)];
+    rocksdb_options.compaction_io_metrics =
+        metrics_->io_metrics[to_underlying(IOClass::kCompaction)];
+  }
+
+  // Range-partitioned tables could opt into also filtering by leading range key columns, so that
+  // scans by a prefix of the primary key could skip SST files. Tables could also opt into the fast
+  // local format of filter blocks, which is cheaper to probe but not readable by older versions.
+  const Schema& schema = metadata_->schema();
+  const size_t num_range_components_in_bloom_filter = std::min(
+      schema.table_properties().num_range_components_in_bloom_filter(),
+      schema.num_range_key_columns());
+  const auto bloom_filter_format = schema.table_properties().fast_local_bloom_filter()
+      ? rocksdb::FixedSizeFilterFormat::kFastLocal : rocksdb::FixedSizeFilterFormat::kDefault;
+  if (num_range_components_in_bloom_filter != 0 ||
+      bloom_filter_format != rocksdb::FixedSizeFilterFormat::kDefault) {
+    docdb::SetBloomFilterOptions(
+        &rocksdb_options, num_range_components_in_bloom_filter, bloom_filter_format);
+  }
+  // Tables could be given a priority class of the shared block cache, so that their blocks are
+  // protected from evictions caused by other tables. The intents DB inherits it.
+  if (schema.table_properties().block_cache_priority_class() != 0) {
+    docdb::SetBlockCachePriorityClass(
+        &rocksdb_options, schema.table_properties().block_cache_priority_class());
+  }
+  // Memtables of hash partitioned tables could be split into buckets by the hash of the keys. The
+  // keys of intents are prefixed by the same DocKeys, so the intents DB inherits it.
+  if (schema.table_properties().hash_prefix_memtable() && schema.num_hash_key_columns() > 0) {
+    docdb::SetHashPrefixMemTableOptions(&rocksdb_options);
+  }
+
   const string db_dir = metadata()->rocksdb_dir();
   RETURN_NOT_OK(CreateTabletDirectories(db_dir, metadata()->fs_manager()));
 
+  // Compactions of old data could write their output to a secondary device.
+  docdb::SetColdDataPath(db_dir, [this] { return clock_->Now(); }, &rocksdb_options);
+  for (size_t i = 1; i < rocksdb_options.db_paths.size(); ++i) {
+    const string table_dir = DirName(rocksdb_options.db_paths[i].path);
+    RETURN_NOT_OK_PREPEND(metadata()->fs_manager()->CreateDirIfMissingAndSync(table_dir),
+                          Format("Failed to create RocksDB cold data table directory $0",
+                                 table_dir));
+  }
+
   LOG(INFO) << "Opening RocksDB at: " << db_dir;
   rocksdb::DB* db = nullptr;
   rocksdb::Status rocksdb_open_status = rocksdb::DB::Open(rocksdb_options, db_dir, &db);
@@ -526,13 +634,50 @@ Status Tablet::OpenKeyValueTablet() {
         std::make_shared<docdb::DocDBIntentsCompactionFilterFactory>(this) : nullptr;
 
     rocksdb_options.mem_tracker = MemTracker::FindOrCreateTracker("IntentsDB", mem_tracker_);
+    // Intents are short lived, so they always stay on the primary device.
+    rocksdb_options.db_paths.clear();
+    rocksdb_options.compaction_output_path_selector = nullptr;
+    rocksdb_options.expired_files_selector = nullptr;
+    rocksdb_options.table_properties_collector_factories.clear();
+    if (num_range_components_in_bloom_filter != 0) {
+      // Intents are looked up by full and partial doc keys alike, so keep filtering them by the
+      // hashed components only.
+      docdb::SetBloomFilterOptions(&rocksdb_options, 0, bloom_filter_format);
+    }
 
     rocksdb::DB* intents_db = nullptr;
     RETURN_NOT_OK(rocksdb::DB::Open(rocksdb_options, db_dir + kIntentsDBSuffix, &intents_db));
     intents_db_.reset(intents_db);
   }
 
-  ql_storage_.reset(new docdb::QLRocksDBStorage({regular_db_.get(), intents_db_.get()}));
+  if (row_cache_) {
+    row_cache_->Clear();
+  } else if (FLAGS_tablet_row_cache_size_bytes > 0 && !transaction_participant_) {
+    // Rows of transactional tables also change when intents get applied, so they are not cached.
+    row_cache_ = std::make_unique<docdb::DocRowCache>(
+        FLAGS_tablet_row_cache_size_bytes, MemTracker::FindOrCreateTracker("RowCache", mem_tracker_),
+        metrics_ ? metrics_->row_cache_hits : scoped_refptr<Counter>(),
+        metrics_ ? metrics_->row_cache_misses : scoped_refptr<Counter>());
+  }
+
+  if (FLAGS_tablet_adaptive_nexts_to_avoid_seek && !regular_seek_tuner_) {
+    docdb::AdaptiveSeekTuner::Metrics regular_metrics;
+    docdb::AdaptiveSeekTuner::Metrics intents_metrics;
+    if (metrics_) {
+      regular_metrics.nexts_instead_of_seek = metrics_->regulardb_nexts_instead_of_seek;
+      regular_metrics.seeks_after_nexts = metrics_->regulardb_seeks_after_nexts;
+      regular_metrics.max_nexts_to_avoid_seek = metrics_->regulardb_max_nexts_to_avoid_seek;
+      intents_metrics.nexts_instead_of_seek = metrics_->intentsdb_nexts_instead_of_seek;
+      intents_metrics.seeks_after_nexts = metrics_->intentsdb_seeks_after_nexts;
+      intents_metrics.max_nexts_to_avoid_seek = metrics_->intentsdb_max_nexts_to_avoid_seek;
+    }
+    regular_seek_tuner_ = std::make_unique<docdb::AdaptiveSeekTuner>(regular_metrics);
+    intents_seek_tuner_ = std::make_unique<docdb::AdaptiveSeekTuner>(intents_metrics);
+  }
+
+  auto ql_doc_db = doc_db();
+  ql_doc_db.row_cache = row_cache_.get();
+  ql_storage_.reset(new docdb::QLRocksDBStorage(ql_doc_db));
   if (transaction_participant_) {
     transaction_participant_->SetDB(intents_db_.get());
   }
@@ -615,7 +760,7 @@ void Tablet::Shutdown() {
 
 Result<std::unique_ptr<common::YQLRowwiseIteratorIf>> Tablet::NewRowIterator(
     const Schema &projection, const boost::optional<TransactionId>& transaction_id,
-    const TableId& table_id) const {
+    const TableId& table_id, const ReadHybridTime& read_time, CoarseTimePoint deadline) const {
   if (state_ != kOpen) {
     return STATUS_FORMAT(IllegalState, "Tablet in wrong state: $0", state_);
   }
@@ -635,11 +780,18 @@ Result<std::unique_ptr<common::YQLRowwiseIteratorIf>> Tablet::NewRowIterator(
   RETURN_NOT_OK(schema.GetMappedReadProjection(projection, mapped_projection.get()));
 
   auto txn_op_ctx = CreateTransactionOperationContext(transaction_id);
-  auto read_time = ReadHybridTime::SingleTime(SafeTime(RequireLease::kFalse));
+  ReadHybridTime iterator_read_time = read_time;
+  if (iterator_read_time) {
+    if (!SafeTime(RequireLease::kFalse, iterator_read_time.read, deadline).is_valid()) {
+      return STATUS_FORMAT(TimedOut, "Safe time did not reach $0", iterator_read_time.read);
+    }
+  } else {
+    iterator_read_time = ReadHybridTime::SingleTime(SafeTime(RequireLease::kFalse));
+  }
   auto result = std::make_unique<DocRowwiseIterator>(
       std::move(mapped_projection), schema, txn_op_ctx,
-      docdb::DocDB{regular_db_.get(), intents_db_.get()},
-      CoarseTimePoint::max() /* deadline */, read_time, &pending_op_counter_);
+      doc_db(),
+      deadline, iterator_read_time, &pending_op_counter_);
   RETURN_NOT_OK(result->Init());
   return std::move(result);
 }
@@ -718,6 +870,28 @@ Status Tablet::CreateCheckpoint(const std::string& dir) {
   return Status::OK();
 }
 
+Status Tablet::CreateCheckpoint(
+    const std::string& dir, const std::string& base_dir, std::vector<std::string>* new_files) {
+  RETURN_NOT_OK(CreateCheckpoint(dir));
+
+  auto* env = regular_db_->GetEnv();
+  RETURN_NOT_OK(rocksdb::checkpoint::ListNewFiles(env, dir, base_dir, new_files));
+  if (intents_db_) {
+    std::vector<std::string> new_intents_files;
+    RETURN_NOT_OK(rocksdb::checkpoint::ListNewFiles(
+        env, JoinPathSegments(dir, kIntentsSubdir),
+        base_dir.empty() ? base_dir : JoinPathSegments(base_dir, kIntentsSubdir),
+        &new_intents_files));
+    for (const auto& file : new_intents_files) {
+      new_files->push_back(JoinPathSegments(kIntentsSubdir, file));
+    }
+  }
+  VLOG_WITH_PREFIX(1) << "Checkpoint in " << dir << " has " << new_files->size()
+                      << " files not in " << base_dir;
+
+  return Status::OK();
+}
+
 void Tablet::PrepareTransactionWriteBatch(
     const KeyValueWriteBatchPB& put_batch,
     HybridTime hybrid_time,
@@ -752,6 +926,7 @@ void Tablet::ApplyKeyValueRowOperations(const KeyValueWriteBatchPB& put_batch,
     return;
   }
 
+  ScopedTabletAccess tablet_access(this);
   rocksdb::WriteBatch write_batch;
   if (put_batch.has_transaction()) {
     RequestScope request_scope(transaction_participant_.get());
@@ -760,6 +935,36 @@ void Tablet::ApplyKeyValueRowOperations(const KeyValueWriteBatchPB& put_batch,
   } else {
     PrepareNonTransactionWriteBatch(put_batch, hybrid_time, &write_batch);
     WriteBatch(frontiers, hybrid_time, &write_batch, regular_db_.get());
+    if (row_cache_) {
+      InvalidateRowCache(put_batch, hybrid_time);
+    }
+  }
+}
+
+docdb::DocDB Tablet::doc_db() const {
+  docdb::DocDB result = {regular_db_.get(), intents_db_.get()};
+  result.regular_seek_tuner = regular_seek_tuner_.get();
+  result.intents_seek_tuner = intents_seek_tuner_.get();
+  return result;
+}
+
+void Tablet::InvalidateRowCache(const KeyValueWriteBatchPB& put_batch, HybridTime hybrid_time) {
+  // Rows are invalidated only after the write is visible in RocksDB, so a read that races with
+  // this write either sees the new row or fails to populate the cache.
+  Slice prev_doc_key;
+  for (const auto& kv_pair : put_batch.write_pairs()) {
+    Slice key(kv_pair.key());
+    auto doc_key_size = docdb::DocKey::EncodedSize(key, docdb::DocKeyPart::WHOLE_DOC_KEY);
+    if (!doc_key_size.ok()) {
+      // Not a row key, i.e. a key written by Redis. Such keys are never cached.
+      continue;
+    }
+    Slice doc_key(key.data(), *doc_key_size);
+    if (doc_key == prev_doc_key) {
+      continue;
+    }
+    row_cache_->Invalidate(doc_key, hybrid_time);
+    prev_doc_key = doc_key;
   }
 }
 
@@ -811,6 +1016,20 @@ void SetupKeyValueBatch(WriteRequestPB* write_request, WriteRequestPB* batch_req
   }
 }
 
+// Returns the key that hot key tracking counts QL operations on one hash key under, built from the
+// values of their hash columns.
+std::string QLHotKey(
+    const google::protobuf::RepeatedPtrField<QLExpressionPB>& hashed_column_values) {
+  std::string result;
+  for (const auto& column_value : hashed_column_values) {
+    if (!result.empty()) {
+      result += ", ";
+    }
+    result += column_value.value().ShortDebugString();
+  }
+  return result;
+}
+
 } // namespace
 
 //--------------------------------------------------------------------------------------------------
@@ -826,6 +1045,9 @@ Status Tablet::KeyValueBatchFromRedisWriteBatch(WriteOperation* operation) {
 
   doc_ops.reserve(redis_write_batch->size());
   for (size_t i = 0; i < redis_write_batch->size(); i++) {
+    if (HotKeys::Sample()) {
+      hot_keys_->Add(redis_write_batch->Get(i).key_value().key());
+    }
     doc_ops.emplace_back(new RedisWriteOperation(redis_write_batch->Mutable(i)));
   }
   RETURN_NOT_OK(StartDocWriteOperation(operation));
@@ -850,9 +1072,15 @@ Status Tablet::HandleRedisReadRequest(CoarseTimePoint deadline,
   RETURN_NOT_OK(scoped_read_operation);
 
   ScopedTabletMetricsTracker metrics_tracker(metrics_->redis_read_latency);
+  ScopedTabletAccess tablet_access(this);
+  ScopedIOAccounting io_accounting(io_metrics(IOClass::kForegroundRead));
+
+  if (HotKeys::Sample()) {
+    hot_keys_->Add(redis_read_request.key_value().key());
+  }
 
   docdb::RedisReadOperation doc_op(
-      redis_read_request, {regular_db_.get(), intents_db_.get()}, deadline, read_time);
+      redis_read_request, doc_db(), deadline, read_time);
   RETURN_NOT_OK(doc_op.Execute());
   *response = std::move(doc_op.response());
   return Status::OK();
@@ -869,12 +1097,19 @@ Status Tablet::HandleQLReadRequest(
   ScopedPendingOperation scoped_read_operation(&pending_op_counter_);
   RETURN_NOT_OK(scoped_read_operation);
   ScopedTabletMetricsTracker metrics_tracker(metrics_->ql_read_latency);
+  ScopedTabletAccess tablet_access(this);
+  ScopedIOAccounting io_accounting(io_metrics(IOClass::kForegroundRead));
 
   if (metadata()->schema_version() != ql_read_request.schema_version()) {
     result->response.set_status(QLResponsePB::YQL_STATUS_SCHEMA_VERSION_MISMATCH);
     return Status::OK();
   }
 
+  // Scans are not counted, they are not limited to one key.
+  if (!ql_read_request.hashed_column_values().empty() && HotKeys::Sample()) {
+    hot_keys_->Add(QLHotKey(ql_read_request.hashed_column_values()));
+  }
+
   Result<TransactionOperationContextOpt> txn_op_ctx =
       CreateTransactionOperationContext(transaction_metadata);
   RETURN_NOT_OK(txn_op_ctx);
@@ -948,6 +1183,9 @@ void Tablet::KeyValueBatchFromQLWriteBatch(std::unique_ptr<WriteOperation> opera
   for (size_t i = 0; i < ql_write_batch->size(); i++) {
     QLWriteRequestPB* req = ql_write_batch->Mutable(i);
     QLResponsePB* resp = operation->response()->add_ql_response_batch();
+    if (!req->hashed_column_values().empty() && HotKeys::Sample()) {
+      hot_keys_->Add(QLHotKey(req->hashed_column_values()));
+    }
     if (metadata_->schema_version() != req->schema_version()) {
       resp->set_status(QLResponsePB::YQL_STATUS_SCHEMA_VERSION_MISMATCH);
     } else {
@@ -1014,6 +1252,9 @@ void Tablet::UpdateQLIndexes(std::unique_ptr<WriteOperation> operation) {
   client::YBSessionPtr session;
   client::YBTransactionPtr txn;
   std::vector<std::pair<std::shared_ptr<client::YBqlWriteOp>, QLWriteOperation*>> index_ops;
+  // Index tables already looked up for this batch. The writes of a batch usually update the same
+  // few indexes, so each of them is looked up in the metadata cache once per batch.
+  std::unordered_map<TableId, client::YBTablePtr> index_tables;
   const ChildTransactionDataPB* child_transaction_data = nullptr;
   for (auto& doc_op : operation->doc_ops()) {
     auto* write_op = static_cast<QLWriteOperation*>(doc_op.get());
@@ -1052,25 +1293,27 @@ void Tablet::UpdateQLIndexes(std::unique_ptr<WriteOperation> operation) {
 
     // Apply the write ops to update the index
     for (auto& pair : *write_op->index_requests()) {
-      client::YBTablePtr index_table;
-      bool cache_used_ignored = false;
-      if (!metadata_cache_) {
-        auto status = STATUS(Corruption, "Table metadata cache is not present for index update");
-        operation->state()->CompleteWithStatus(status);
-        return;
-      }
-      // TODO create async version of GetTable.
-      // It is ok to have sync call here, because we use cache and it should not take too long.
-      auto status = metadata_cache_->GetTable(pair.first->table_id(), &index_table,
-                                              &cache_used_ignored);
-      if (!status.ok()) {
-        operation->state()->CompleteWithStatus(status);
-        return;
+      client::YBTablePtr& index_table = index_tables[pair.first->table_id()];
+      if (!index_table) {
+        bool cache_used_ignored = false;
+        if (!metadata_cache_) {
+          auto status = STATUS(Corruption, "Table metadata cache is not present for index update");
+          operation->state()->CompleteWithStatus(status);
+          return;
+        }
+        // TODO create async version of GetTable.
+        // It is ok to have sync call here, because we use cache and it should not take too long.
+        auto status = metadata_cache_->GetTable(pair.first->table_id(), &index_table,
+                                                &cache_used_ignored);
+        if (!status.ok()) {
+          operation->state()->CompleteWithStatus(status);
+          return;
+        }
       }
       shared_ptr<client::YBqlWriteOp> index_op(index_table->NewQLWrite());
       index_op->mutable_request()->Swap(&pair.second);
       index_op->mutable_request()->MergeFrom(pair.second);
-      status = session->Apply(index_op);
+      auto status = session->Apply(index_op);
       if (!status.ok()) {
         operation->state()->CompleteWithStatus(status);
         return;
@@ -1145,6 +1388,8 @@ Status Tablet::HandlePgsqlReadRequest(
   RETURN_NOT_OK(scoped_read_operation);
   // TODO(neil) Work on metrics for PGSQL.
   // ScopedTabletMetricsTracker metrics_tracker(metrics_->pgsql_read_latency);
+  ScopedTabletAccess tablet_access(this);
+  ScopedIOAccounting io_accounting(io_metrics(IOClass::kForegroundRead));
 
   const tablet::TableInfo* table_info =
       VERIFY_RESULT(metadata_->GetTableInfo(pgsql_read_request.table_id()));
@@ -1324,7 +1569,11 @@ Status Tablet::WaitForFlush() {
 
 Status Tablet::ImportData(const std::string& source_dir) {
   // We import only regular records, so don't have to deal with intents here.
-  return regular_db_->Import(source_dir);
+  RETURN_NOT_OK(regular_db_->Import(source_dir));
+  if (row_cache_) {
+    row_cache_->Clear();
+  }
+  return Status::OK();
 }
 
 // We apply intents using by iterating over whole transaction reverse index.
@@ -1333,6 +1582,7 @@ Status Tablet::ImportData(const std::string& source_dir) {
 // TODO(dtxn) use separate thread for applying intents.
 // TODO(dtxn) use multiple batches when applying really big transaction.
 Status Tablet::ApplyIntents(const TransactionApplyData& data) {
+  ScopedTabletAccess tablet_access(this);
   rocksdb::WriteBatch regular_write_batch;
   rocksdb::WriteBatch intents_write_batch;
   RETURN_NOT_OK(docdb::PrepareApplyIntentsBatch(
@@ -1456,6 +1706,11 @@ Status Tablet::AlterSchema(ChangeMetadataOperationState *operation_state) {
   // Clear old index table metadata cache.
   metadata_cache_ = boost::none;
 
+  // Cached rows were read with the projections and the default TTL of the old schema.
+  if (row_cache_) {
+    row_cache_->Clear();
+  }
+
   // Create transaction manager and index table metadata cache for secondary index update.
   if (!metadata_->index_map().empty()) {
     if (metadata_->schema().table_properties().is_transactional() && !transaction_manager_) {
@@ -1560,6 +1815,7 @@ Status Tablet::Truncate(TruncateOperationState *state) {
     intents_status = rocksdb::DestroyDB(intents_dir, rocksdb_options);
   }
   regular_db_.reset();
+  docdb::SetColdDataPath(db_dir, nullptr /* now */, &rocksdb_options);
   auto s = rocksdb::DestroyDB(db_dir, rocksdb_options);
   if (s.ok() && !intents_status.ok()) {
     s = intents_status;
@@ -1591,6 +1847,39 @@ Status Tablet::Truncate(TruncateOperationState *state) {
   return Status::OK();
 }
 
+Status Tablet::IngestExternalFiles(IngestExternalFilesOperationState* state) {
+  if (metadata_->table_type() == TableType::TRANSACTION_STATUS_TABLE_TYPE) {
+    return STATUS(NotSupported, "Cannot ingest files into transaction status table");
+  }
+
+  // Quiesce writes, so all entries preceding this operation are in the memtable that Import
+  // flushes before the imported files and the new flushed frontier are added.
+  auto op_pause = PauseReadWriteOperations();
+  RETURN_NOT_OK(op_pause);
+
+  if (IsShutdownRequested()) {
+    return STATUS(IllegalState, "Tablet was shut down");
+  }
+
+  docdb::ConsensusFrontier frontier;
+  frontier.set_op_id({state->op_id().term(), state->op_id().index()});
+  frontier.set_hybrid_time(state->hybrid_time());
+
+  // The files are added together with the flushed frontier, so after a restart the operation is
+  // either replayed from the log or fully present in the regular RocksDB. Only regular records are
+  // imported, so the intents DB is left as is.
+  const auto& source_dir = state->request()->source_dir();
+  RETURN_NOT_OK_PREPEND(regular_db_->Import(source_dir, frontier.Clone()),
+                        Format("Failed to ingest $0", source_dir));
+  if (row_cache_) {
+    row_cache_->Clear();
+  }
+
+  LOG_WITH_PREFIX(INFO) << "Ingested " << source_dir << ", flushed frontier: "
+                        << frontier.ToString();
+  return Status::OK();
+}
+
 void Tablet::UpdateMonotonicCounter(int64_t value) {
   int64_t counter = monotonic_counter_;
   while (true) {
@@ -1701,6 +1990,15 @@ Result<IsolationLevel> GetIsolationLevel(const KeyValueWriteBatchPB& write_batch
   return stored_metadata->isolation;
 }
 
+// Returns the QL write of 'doc_op', if it asks for the execution statistics of its write batch.
+QLWriteOperation* QLWriteReturningExecutionStats(docdb::DocOperation* doc_op) {
+  if (doc_op->OpType() != docdb::DocOperationType::QL_WRITE_OPERATION) {
+    return nullptr;
+  }
+  auto* ql_write_op = down_cast<QLWriteOperation*>(doc_op);
+  return ql_write_op->request().return_execution_stats() ? ql_write_op : nullptr;
+}
+
 } // namespace
 
 Status Tablet::TEST_SwitchMemtable() {
@@ -1711,6 +2009,44 @@ Status Tablet::TEST_SwitchMemtable() {
   return Status::OK();
 }
 
+Status Tablet::ResolveTransactionConflictsWaiting(
+    WriteOperation* operation, IsolationLevel isolation_level, bool transactional_table,
+    docdb::PrepareDocWriteOperationResult* prepare_result) {
+  auto* write_batch = operation->request()->mutable_write_batch();
+  const bool wait = FLAGS_wait_for_conflicting_transactions;
+  std::vector<TransactionId> blockers;
+  for (;;) {
+    RETURN_NOT_OK(docdb::ResolveTransactionConflicts(
+        operation->doc_ops(), *write_batch, clock_->Now(),
+        doc_db(), transaction_participant_.get(),
+        metrics_->transaction_conflicts.get(), wait ? &blockers : nullptr));
+    if (blockers.empty()) {
+      return Status::OK();
+    }
+
+    // The locks are released while waiting, otherwise the transactions we wait for could not
+    // lock the keys to apply their intents.
+    prepare_result->lock_batch.Reset();
+    const auto now = CoarseMonoClock::Now();
+    if (now >= operation->deadline()) {
+      return STATUS_FORMAT(TimedOut, "Timed out waiting for conflicting transactions: $0",
+                           blockers);
+    }
+    VLOG_WITH_PREFIX(2) << "Waiting for conflicting transactions: " << yb::ToString(blockers);
+    const auto recheck_interval =
+        std::chrono::milliseconds(FLAGS_conflicting_transactions_recheck_interval_ms);
+    transaction_participant_->WaitUntilFinished(
+        blockers, std::min(operation->deadline(), now + recheck_interval));
+    blockers.clear();
+
+    auto relock_result = VERIFY_RESULT(docdb::PrepareDocWriteOperation(
+        operation->doc_ops(), write_batch->read_pairs(), metrics_->write_lock_latency,
+        isolation_level, operation->state()->kind(), transactional_table, operation->deadline(),
+        &shared_lock_manager_));
+    prepare_result->lock_batch = std::move(relock_result.lock_batch);
+  }
+}
+
 Status Tablet::StartDocWriteOperation(WriteOperation* operation) {
   auto write_batch = operation->request()->mutable_write_batch();
   auto isolation_level = VERIFY_RESULT(GetIsolationLevel(
@@ -1721,6 +2057,18 @@ Status Tablet::StartDocWriteOperation(WriteOperation* operation) {
       operation->doc_ops(), write_batch->read_pairs(), metrics_->write_lock_latency,
       isolation_level, operation->state()->kind(), transactional_table, operation->deadline(),
       &shared_lock_manager_));
+  operation->PhaseDone(WritePhase::kLock);
+
+  // The statistics are gathered for the whole write batch, when one of its writes asks for them.
+  docdb::DocDBExecutionStats execution_stats;
+  boost::optional<docdb::ScopedDocDBExecutionStats> execution_stats_scope;
+  for (const auto& doc_op : operation->doc_ops()) {
+    if (QLWriteReturningExecutionStats(doc_op.get())) {
+      execution_stats_scope.emplace(&execution_stats);
+      break;
+    }
+  }
+  const auto conflict_resolution_start = MonoTime::Now();
 
   RequestScope request_scope;
   if (transaction_participant_) {
@@ -1733,11 +2081,13 @@ Status Tablet::StartDocWriteOperation(WriteOperation* operation) {
     if (isolation_level == IsolationLevel::NON_TRANSACTIONAL) {
       auto now = clock_->Now();
       auto result = VERIFY_RESULT(docdb::ResolveOperationConflicts(
-          operation->doc_ops(), now, { regular_db_.get(), intents_db_.get() },
+          operation->doc_ops(), now, doc_db(),
           transaction_participant_.get()));
       if (now != result) {
         clock_->Update(result);
       }
+      operation->PhaseDone(WritePhase::kConflictResolution);
+      execution_stats.conflict_resolution_time = MonoTime::Now() - conflict_resolution_start;
     } else {
       if (isolation_level == IsolationLevel::SERIALIZABLE_ISOLATION &&
           prepare_result.need_read_snapshot) {
@@ -1758,10 +2108,10 @@ Status Tablet::StartDocWriteOperation(WriteOperation* operation) {
         }
       }
 
-      RETURN_NOT_OK(docdb::ResolveTransactionConflicts(
-          operation->doc_ops(), *write_batch, clock_->Now(),
-          { regular_db_.get(), intents_db_.get() }, transaction_participant_.get(),
-          metrics_->transaction_conflicts.get()));
+      RETURN_NOT_OK(ResolveTransactionConflictsWaiting(
+          operation, isolation_level, transactional_table, &prepare_result));
+      operation->PhaseDone(WritePhase::kConflictResolution);
+      execution_stats.conflict_resolution_time = MonoTime::Now() - conflict_resolution_start;
 
       if (!read_time) {
         DSCHECK_EQ(isolation_level, IsolationLevel::SERIALIZABLE_ISOLATION, InvalidArgument,
@@ -1786,16 +2136,22 @@ Status Tablet::StartDocWriteOperation(WriteOperation* operation) {
   // Once read_txn goes out of scope, the read point is deregistered.
   HybridTime restart_read_ht;
   bool local_limit_updated = false;
+  int num_rocksdb_seeks = 0;
 
   for (;;) {
     RETURN_NOT_OK(docdb::ExecuteDocWriteOperation(
         operation->doc_ops(), operation->deadline(), real_read_time,
-        { regular_db_.get(), intents_db_.get() }, write_batch,
+        doc_db(), write_batch,
         table_type_ == TableType::REDIS_TABLE_TYPE
             ? InitMarkerBehavior::kRequired
             : InitMarkerBehavior::kOptional,
         &monotonic_counter_,
-        &restart_read_ht));
+        &restart_read_ht,
+        &num_rocksdb_seeks));
+
+    if (metrics_) {
+      metrics_->docdb_write_rocksdb_seeks->IncrementBy(num_rocksdb_seeks);
+    }
 
     // For serializable isolation we don't fix read time, so could do read restart locally,
     // instead of failing whole transaction.
@@ -1819,8 +2175,21 @@ Status Tablet::StartDocWriteOperation(WriteOperation* operation) {
     }
   }
 
+  operation->PhaseDone(WritePhase::kExecute);
   operation->SetRestartReadHt(restart_read_ht);
 
+  if (execution_stats_scope) {
+    execution_stats_scope.reset();
+    // Returned once, so that the statistics of the writes of a batch can be added up.
+    for (const auto& doc_op : operation->doc_ops()) {
+      auto* ql_write_op = QLWriteReturningExecutionStats(doc_op.get());
+      if (ql_write_op) {
+        execution_stats.ToPB(ql_write_op->response()->mutable_execution_stats());
+        break;
+      }
+    }
+  }
+
   if (operation->restart_read_ht().is_valid()) {
     return Status::OK();
   }
@@ -1932,7 +2301,7 @@ std::string Tablet::TEST_DocDBDumpStr(IncludeIntents include_intents) {
     return docdb::DocDBDebugDumpToStr(regular_db_.get());
   }
 
-  return docdb::DocDBDebugDumpToStr(docdb::DocDB{regular_db_.get(), intents_db_.get()});
+  return docdb::DocDBDebugDumpToStr(doc_db());
 }
 
 size_t Tablet::TEST_CountRocksDBRecords() {
@@ -1972,6 +2341,112 @@ uint64_t Tablet::GetUncompressedSSTFileSizes() const {
   return regular_db_->GetUncompressedSSTFileSize();
 }
 
+uint64_t Tablet::GetMemTablesSize() const {
+  ScopedPendingOperation scoped_operation(&pending_op_counter_);
+  std::lock_guard<rw_spinlock> lock(component_lock_);
+  if (!pending_op_counter_.IsReady()) {
+    return 0;
+  }
+  uint64_t result = 0;
+  for (auto* db : {regular_db_.get(), intents_db_.get()}) {
+    uint64_t size = 0;
+    if (db && db->GetIntProperty(rocksdb::DB::Properties::kCurSizeAllMemTables, &size)) {
+      result += size;
+    }
+  }
+  return result;
+}
+
+namespace {
+
+void AddDbCompactionRateSignals(rocksdb::DB* db, docdb::CompactionRateTuner::Signals* signals) {
+  uint64_t pending_compaction_bytes = 0;
+  if (db->GetIntProperty(rocksdb::DB::Properties::kEstimatePendingCompactionBytes,
+                         &pending_compaction_bytes)) {
+    signals->pending_compaction_bytes += pending_compaction_bytes;
+  }
+  const int slowdown_trigger = db->GetOptions().level0_slowdown_writes_trigger;
+  std::string num_l0_files_str;
+  uint64 num_l0_files = 0;
+  if (slowdown_trigger > 0 &&
+      db->GetProperty(rocksdb::DB::Properties::kNumFilesAtLevelPrefix + "0", &num_l0_files_str) &&
+      safe_strtou64(num_l0_files_str, &num_l0_files)) {
+    signals->max_l0_slowdown_ratio = std::max(
+        signals->max_l0_slowdown_ratio, static_cast<double>(num_l0_files) / slowdown_trigger);
+  }
+}
+
+void AddReadLatency(const scoped_refptr<Histogram>& latency,
+                    docdb::CompactionRateTuner::Signals* signals) {
+  if (latency) {
+    signals->num_reads += latency->TotalCount();
+    signals->total_read_latency_us += latency->TotalSum();
+  }
+}
+
+} // namespace
+
+bool Tablet::MarkAccessed() {
+  const auto now = CoarseMonoClock::Now();
+  // Concurrent reads and writes only update the time once in a while, so they do not keep
+  // writing to the same cache line.
+  if (now - last_access_time_.load(std::memory_order_relaxed) > 1s) {
+    last_access_time_.store(now, std::memory_order_relaxed);
+  }
+  if (PREDICT_TRUE(!hibernating())) {
+    return false;
+  }
+  return hibernating_.exchange(false, std::memory_order_acq_rel);
+}
+
+Result<bool> Tablet::HibernateIfIdle(CoarseDuration idle_time) {
+  if (hibernating() ||
+      CoarseMonoClock::Now() - last_access_time_.load(std::memory_order_relaxed) < idle_time) {
+    return false;
+  }
+
+  ScopedPendingOperation scoped_operation(&pending_op_counter_);
+  if (!scoped_operation.ok() || !regular_db_) {
+    return false;
+  }
+
+  // RocksDB does not have a WAL of its own, so the memtables are flushed instead of dropped. The
+  // memtables that replace them are empty and only take memory when written to.
+  RETURN_NOT_OK(Flush(FlushMode::kSync));
+  if (row_cache_) {
+    row_cache_->Clear();
+  }
+  for (auto* db : {regular_db_.get(), intents_db_.get()}) {
+    if (db) {
+      db->ReleaseTableReaders();
+    }
+  }
+  hibernating_.store(true, std::memory_order_release);
+  metrics_->hibernations->Increment();
+  VLOG_WITH_PREFIX(1) << "Hibernated after being idle for at least "
+                      << MonoDelta(idle_time).ToString();
+  return true;
+}
+
+void Tablet::AddCompactionRateSignals(docdb::CompactionRateTuner::Signals* signals) const {
+  if (metrics_) {
+    AddReadLatency(metrics_->ql_read_latency, signals);
+    AddReadLatency(metrics_->redis_read_latency, signals);
+  }
+
+  ScopedPendingOperation scoped_operation(&pending_op_counter_);
+  std::lock_guard<rw_spinlock> lock(component_lock_);
+  if (!pending_op_counter_.IsReady()) {
+    return;
+  }
+  if (regular_db_) {
+    AddDbCompactionRateSignals(regular_db_.get(), signals);
+  }
+  if (intents_db_) {
+    AddDbCompactionRateSignals(intents_db_.get(), signals);
+  }
+}
+
 // ------------------------------------------------------------------------------------------------
 
 Result<TransactionOperationContextOpt> Tablet::CreateTransactionOperationContext(
@@ -51,6 +51,7 @@
 #include "yb/common/transaction.h"
 #include "yb/common/ql_storage_interface.h"
 
+#include "yb/docdb/compaction_rate_tuner.h"
 #include "yb/docdb/docdb.pb.h"
 #include "yb/docdb/docdb_compaction_filter.h"
 #include "yb/docdb/doc_operation.h"
@@ -78,6 +79,7 @@
 #include "yb/util/status.h"
 #include "yb/util/countdown_latch.h"
 #include "yb/util/enums.h"
+#include "yb/util/io_accounting.h"
 
 #include "yb/gutil/thread_annotations.h"
 
@@ -92,7 +94,10 @@ class MetricEntity;
 class RowChangeList;
 
 namespace docdb {
+class AdaptiveSeekTuner;
 class ConsensusFrontier;
+class DocRowCache;
+struct PrepareDocWriteOperationResult;
 }
 
 namespace log {
@@ -110,6 +115,8 @@ class MaintenanceOpStats;
 namespace tablet {
 
 class ChangeMetadataOperationState;
+class HotKeys;
+class IngestExternalFilesOperationState;
 class ScopedReadOperation;
 struct TabletMetrics;
 struct TransactionApplyData;
@@ -293,6 +300,13 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
                   rocksdb::WriteBatch* write_batch,
                   rocksdb::DB* dest_db);
 
+  // Drops the rows written by put_batch from the row cache.
+  void InvalidateRowCache(const docdb::KeyValueWriteBatchPB& put_batch, HybridTime hybrid_time);
+
+  // Returns the DBs of this tablet along with their seek tuners, but without the row cache, which
+  // is only used by QL reads.
+  docdb::DocDB doc_db() const;
+
   //------------------------------------------------------------------------------------------------
   // Redis Request Processing.
   // Takes a Redis WriteRequestPB as input with its redis_write_batch.
@@ -347,12 +361,20 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   // YQL_TABLE_TYPE.
   CHECKED_STATUS CreateCheckpoint(const std::string& dir);
 
+  // Same as above, but also fills new_files with the paths, relative to dir, of the files that are
+  // not in base_dir, an earlier checkpoint of this tablet. Table files are hard-linked, so only the
+  // files listed have to be uploaded by an incremental backup.
+  CHECKED_STATUS CreateCheckpoint(
+      const std::string& dir, const std::string& base_dir, std::vector<std::string>* new_files);
+
   // Create a new row iterator which yields the rows as of the current MVCC
-  // state of this tablet.
+  // state of this tablet, or as of read_time when it is set. In the latter case, the iterator is
+  // created once the safe time of the tablet reaches read_time, or fails at deadline.
   // The returned iterator is not initialized.
   Result<std::unique_ptr<common::YQLRowwiseIteratorIf>> NewRowIterator(
       const Schema &projection, const boost::optional<TransactionId>& transaction_id,
-      const TableId& table_id = "") const;
+      const TableId& table_id = "", const ReadHybridTime& read_time = ReadHybridTime(),
+      CoarseTimePoint deadline = CoarseTimePoint::max()) const;
   Result<std::unique_ptr<common::YQLRowwiseIteratorIf>> NewRowIterator(
       const TableId& table_id) const;
 
@@ -382,6 +404,10 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   // Truncate this tablet by resetting the content of RocksDB.
   CHECKED_STATUS Truncate(TruncateOperationState* state);
 
+  // Apply replicated ingest external files operation. Imports the RocksDB directory specified in
+  // the request into the regular RocksDB and moves the flushed frontier to the operation.
+  CHECKED_STATUS IngestExternalFiles(IngestExternalFilesOperationState* state);
+
   // Verbosely dump this entire tablet to the logs. This is only
   // really useful when debugging unit tests failures where the tablet
   // has a very small number of rows.
@@ -414,6 +440,12 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   // May be NULL in unit tests, etc.
   TabletMetrics* metrics() { return metrics_.get(); }
 
+  // Returns the metrics that the file I/O of 'io_class' done for this tablet is accounted to, or
+  // null when the tablet has no metrics.
+  const IOMetrics* io_metrics(IOClass io_class) const;
+
+  HotKeys& hot_keys() { return *hot_keys_; }
+
   // Return handle to the metric entity of this tablet.
   const scoped_refptr<MetricEntity>& GetMetricEntity() const { return metric_entity_; }
 
@@ -498,6 +530,30 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   uint64_t GetTotalSSTFileSizes() const;
   uint64_t GetUncompressedSSTFileSizes() const;
 
+  // Returns the total size of the memtables of the RocksDB instances of this tablet.
+  uint64_t GetMemTablesSize() const;
+
+  // Adds the compaction backlog of the RocksDB instances of this tablet and the totals of its
+  // foreground read latency histograms to *signals.
+  void AddCompactionRateSignals(docdb::CompactionRateTuner::Signals* signals) const;
+
+  // Marks the tablet as read or written now. Returns true if the tablet was hibernating, in which
+  // case it is woken up.
+  bool MarkAccessed();
+
+  // Puts the tablet in hibernation if it was not read or written for at least idle_time: flushes
+  // the memtables, clears the row cache and releases the readers of the SST files, which the first
+  // access after that reopens. Returns true if the tablet was put in hibernation.
+  Result<bool> HibernateIfIdle(CoarseDuration idle_time);
+
+  bool hibernating() const {
+    return hibernating_.load(std::memory_order_acquire);
+  }
+
+  CoarseTimePoint last_access_time() const {
+    return last_access_time_.load(std::memory_order_relaxed);
+  }
+
   void SetHybridTimeLeaseProvider(HybridTimeLeaseProvider provider) {
     ht_lease_provider_ = std::move(provider);
   }
@@ -534,6 +590,13 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
 
   CHECKED_STATUS StartDocWriteOperation(WriteOperation* operation);
 
+  // Resolves the conflicts of a transactional write. With --wait_for_conflicting_transactions,
+  // waits for the conflicting transactions of higher priority to finish, relocking the keys of
+  // prepare_result after each wait.
+  CHECKED_STATUS ResolveTransactionConflictsWaiting(
+      WriteOperation* operation, IsolationLevel isolation_level, bool transactional_table,
+      docdb::PrepareDocWriteOperationResult* prepare_result);
+
   CHECKED_STATUS OpenKeyValueTablet();
   virtual CHECKED_STATUS CreateTabletDirectories(const string& db_dir, FsManager* fs);
 
@@ -643,6 +706,22 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
 
   std::unique_ptr<common::YQLStorageIf> ql_storage_;
 
+  // Cache of decoded rows for point reads, if enabled by tablet_row_cache_size_bytes.
+  std::unique_ptr<docdb::DocRowCache> row_cache_;
+
+  // Tuners of the number of nexts to try before seeking, if enabled by
+  // tablet_adaptive_nexts_to_avoid_seek. They outlive the DBs, so that what they learned is kept
+  // when the DBs get reopened.
+  std::unique_ptr<docdb::AdaptiveSeekTuner> regular_seek_tuner_;
+  std::unique_ptr<docdb::AdaptiveSeekTuner> intents_seek_tuner_;
+
+  // Most frequently read and written keys, see HotKeys.
+  std::unique_ptr<HotKeys> hot_keys_;
+
+  // Time of the last read or write, updated once in a while by MarkAccessed.
+  std::atomic<CoarseTimePoint> last_access_time_{CoarseMonoClock::Now()};
+  std::atomic<bool> hibernating_{false};
+
   // This is for docdb fine-grained locking.
   docdb::SharedLockManager shared_lock_manager_;
 
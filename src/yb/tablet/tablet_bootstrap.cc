@@ -31,6 +31,8 @@
 //
 #include "yb/tablet/tablet_bootstrap.h"
 
+#include <future>
+
 #include "yb/consensus/consensus.h"
 #include "yb/consensus/log_anchor_registry.h"
 #include "yb/consensus/log_reader.h"
@@ -40,6 +42,7 @@
 #include "yb/tablet/tablet.h"
 #include "yb/tablet/tablet_peer.h"
 #include "yb/tablet/operations/change_metadata_operation.h"
+#include "yb/tablet/operations/ingest_external_files_operation.h"
 #include "yb/tablet/operations/truncate_operation.h"
 #include "yb/tablet/operations/update_txn_operation.h"
 #include "yb/tablet/operations/write_operation.h"
@@ -67,6 +70,11 @@ DEFINE_bool(force_recover_flushed_frontier, false,
 TAG_FLAG(force_recover_flushed_frontier, hidden);
 TAG_FLAG(force_recover_flushed_frontier, advanced);
 
+DEFINE_bool(tablet_bootstrap_read_ahead, true,
+            "Whether tablet bootstrap reads and decodes the next WAL segment on another thread "
+            "while it replays the current one.");
+TAG_FLAG(tablet_bootstrap_read_ahead, advanced);
+
 namespace yb {
 namespace tablet {
 
@@ -91,6 +99,7 @@ using consensus::ReplicateMsg;
 using strings::Substitute;
 using tserver::ChangeMetadataRequestPB;
 using tserver::TruncateRequestPB;
+using tserver::IngestExternalFilesRequestPB;
 using tserver::WriteRequestPB;
 
 static string DebugInfo(const string& tablet_id,
@@ -292,7 +301,8 @@ TabletBootstrap::TabletBootstrap(const BootstrapTabletData& data)
       listener_(data.listener),
       log_anchor_registry_(data.log_anchor_registry),
       tablet_options_(data.tablet_options),
-      append_pool_(data.append_pool) {
+      append_pool_(data.append_pool),
+      allocation_pool_(data.allocation_pool) {
 }
 
 TabletBootstrap::~TabletBootstrap() {}
@@ -397,9 +407,15 @@ Result<bool> TabletBootstrap::OpenTablet() {
       tablet_options_, data_.log_prefix_suffix, data_.transaction_participant_context,
       data_.local_tablet_filter, data_.transaction_coordinator_context);
   // Doing nothing for now except opening a tablet locally.
+  const auto open_start = MonoTime::Now();
   LOG_TIMING_PREFIX(INFO, LogPrefix(), "opening tablet") {
+    ScopedIOAccounting io_accounting(tablet->io_metrics(IOClass::kBootstrap));
     RETURN_NOT_OK(tablet->Open());
   }
+  if (tablet->metrics()) {
+    tablet->metrics()->bootstrap_open_tablet_duration->set_value(
+        (MonoTime::Now() - open_start).ToMicroseconds());
+  }
   Result<bool> has_ss_tables = tablet->HasSSTables();
 
   // In theory, an error can happen in case of tablet Shutdown or in RocksDB object replacement
@@ -534,6 +550,7 @@ Status TabletBootstrap::OpenNewLog() {
                           tablet_->metadata()->schema_version(),
                           tablet_->GetMetricEntity(),
                           append_pool_,
+                          allocation_pool_,
                           &log_));
   // Disable sync temporarily in order to speed up appends during the bootstrap process.
   log_->DisableSync();
@@ -664,6 +681,9 @@ Status TabletBootstrap::HandleOperation(consensus::OperationType op_type,
     case consensus::TRUNCATE_OP:
       return PlayTruncateRequest(replicate);
 
+    case consensus::INGEST_EXTERNAL_FILES_OP:
+      return PlayIngestExternalFilesRequest(replicate);
+
     case consensus::NO_OP:
       return PlayNoOpRequest(replicate);
 
@@ -749,6 +769,7 @@ void TabletBootstrap::DumpReplayStateToLog(const ReplayState& state) {
 }
 
 Status TabletBootstrap::PlaySegments(ConsensusBootstrapInfo* consensus_info) {
+  ScopedIOAccounting io_accounting(tablet_->io_metrics(IOClass::kBootstrap));
   auto flushed_op_id = VERIFY_RESULT(tablet_->MaxPersistentOpId());
   if (FLAGS_force_recover_flushed_frontier) {
     LOG_WITH_PREFIX(WARNING)
@@ -787,8 +808,24 @@ Status TabletBootstrap::PlaySegments(ConsensusBootstrapInfo* consensus_info) {
   int segment_count = 0;
   yb::OpId last_committed_op_id;
   RestartSafeCoarseTimePoint last_entry_time;
-  for (const scoped_refptr<ReadableLogSegment>& segment : segments) {
-    auto read_result = segment->ReadEntries();
+  MonoDelta read_log_time = MonoDelta::kZero;
+  MonoDelta replay_log_time = MonoDelta::kZero;
+  // Reading a segment checks and decodes all of its entries, so it is done for the next segment
+  // while the current one is replayed. If we return early, the destructor of the future waits for
+  // the read to finish.
+  std::future<log::ReadEntriesResult> next_read_result;
+  for (size_t segment_idx = 0; segment_idx != segments.size(); ++segment_idx) {
+    const scoped_refptr<ReadableLogSegment>& segment = segments[segment_idx];
+    auto read_start = MonoTime::Now();
+    auto read_result = next_read_result.valid() ? next_read_result.get() : segment->ReadEntries();
+    if (FLAGS_tablet_bootstrap_read_ahead && segment_idx + 1 != segments.size()) {
+      scoped_refptr<ReadableLogSegment> next_segment = segments[segment_idx + 1];
+      next_read_result = std::async(std::launch::async, [next_segment] {
+        return next_segment->ReadEntries();
+      });
+    }
+    auto replay_start = MonoTime::Now();
+    read_log_time += replay_start - read_start;
     last_committed_op_id = std::max(last_committed_op_id, read_result.committed_op_id);
     for (int entry_idx = 0; entry_idx < read_result.entries.size(); ++entry_idx) {
       Status s = HandleEntry(
@@ -802,6 +839,7 @@ Status TabletBootstrap::PlaySegments(ConsensusBootstrapInfo* consensus_info) {
                                            *read_result.entries[entry_idx]));
       }
     }
+    replay_log_time += MonoTime::Now() - replay_start;
     if (!read_result.entry_times.empty()) {
       last_entry_time = read_result.entry_times.back();
     }
@@ -857,6 +895,14 @@ Status TabletBootstrap::PlaySegments(ConsensusBootstrapInfo* consensus_info) {
     }
   }
 
+  LOG_WITH_PREFIX(INFO) << "Read log segments in " << read_log_time << ", replayed them in "
+                        << replay_log_time;
+  if (tablet_->metrics()) {
+    tablet_->metrics()->bootstrap_read_log_duration->set_value(read_log_time.ToMicroseconds());
+    tablet_->metrics()->bootstrap_replay_log_duration->set_value(
+        replay_log_time.ToMicroseconds());
+  }
+
   LOG_WITH_PREFIX(INFO) << "Dumping replay state to log at the end of " << __FUNCTION__;
   DumpReplayStateToLog(state);
 
@@ -931,6 +977,13 @@ Status TabletBootstrap::PlayChangeMetadataRequest(ReplicateMsg* replicate_msg) {
     log_->SetSchemaForNextLogSegment(schema, operation_state.schema_version());
   }
 
+  // The table added to the tablet, e.g. a table of a colocated namespace, is already in the
+  // metadata if the metadata was flushed after the operation was applied.
+  if (request->has_add_table() &&
+      !tablet_->metadata()->GetTableInfo(request->add_table().table_id()).ok()) {
+    RETURN_NOT_OK_PREPEND(tablet_->AddTable(request->add_table()), "Failed to AddTable:");
+  }
+
   return Status::OK();
 }
 
@@ -976,6 +1029,22 @@ Status TabletBootstrap::PlayTruncateRequest(ReplicateMsg* replicate_msg) {
   return Status::OK();
 }
 
+Status TabletBootstrap::PlayIngestExternalFilesRequest(ReplicateMsg* replicate_msg) {
+  IngestExternalFilesRequestPB* req = replicate_msg->mutable_ingest_external_files_request();
+
+  IngestExternalFilesOperationState operation_state(nullptr, req);
+  operation_state.mutable_op_id()->CopyFrom(replicate_msg->id());
+  operation_state.set_hybrid_time(HybridTime(replicate_msg->hybrid_time()));
+
+  // Same as during apply, a failed import leaves the tablet unchanged and is not fatal.
+  Status s = tablet_->IngestExternalFiles(&operation_state);
+  if (!s.ok()) {
+    LOG_WITH_PREFIX(WARNING) << "Failed to ingest external files: " << s;
+  }
+
+  return Status::OK();
+}
+
 Status TabletBootstrap::PlayUpdateTransactionRequest(
     ReplicateMsg* replicate_msg, AlreadyApplied already_applied) {
   DCHECK(replicate_msg->has_hybrid_time());
@@ -124,6 +124,8 @@ class TabletBootstrap {
 
   CHECKED_STATUS PlayTruncateRequest(consensus::ReplicateMsg* replicate_msg);
 
+  CHECKED_STATUS PlayIngestExternalFilesRequest(consensus::ReplicateMsg* replicate_msg);
+
   void DumpReplayStateToLog(const ReplayState& state);
 
   // Handlers for each type of message seen in the log during replay.
@@ -164,6 +166,9 @@ class TabletBootstrap {
   // Thread pool for append task for bootstrap.
   ThreadPool* append_pool_;
 
+  // Thread pool for allocating the segments of the new log.
+  ThreadPool* allocation_pool_;
+
   // Statistics on the replay of entries in the log.
   struct Stats {
     Stats()
@@ -126,6 +126,8 @@ struct BootstrapTabletData {
   TransactionCoordinatorContext* transaction_coordinator_context;
   ThreadPool* append_pool;
   consensus::RetryableRequests* retryable_requests;
+  // Shared by the logs for allocating their segments. If null, each log uses its own pool.
+  ThreadPool* allocation_pool = nullptr;
 };
 
 // Bootstraps a tablet, initializing it with the provided metadata. If the tablet
@@ -82,6 +82,7 @@ namespace tablet {
 const int64 kNoDurableMemStore = -1;
 const std::string kIntentsSubdir = "intents";
 const std::string kIntentsDBSuffix = ".intents";
+const std::string kRemoteBootstrapResumeDirSuffix = ".rb_resume";
 
 // ============================================================================
 //  Tablet Metadata
@@ -366,9 +367,11 @@ Status TabletMetadata::DeleteTabletData(TabletDataState delete_type,
   TabletOptions tablet_options;
   docdb::InitRocksDBOptions(
       &rocksdb_options, tablet_id_, nullptr /* statistics */, tablet_options);
+  docdb::SetColdDataPath(rocksdb_dir_, nullptr /* now */, &rocksdb_options);
 
   LOG(INFO) << "Destroying regular db at: " << rocksdb_dir_;
   rocksdb::Status status = rocksdb::DestroyDB(rocksdb_dir_, rocksdb_options);
+  rocksdb_options.db_paths.clear();
 
   if (!status.ok()) {
     LOG(ERROR) << "Failed to destroy regular DB at: " << rocksdb_dir_ << ": " << status;
@@ -388,6 +391,14 @@ Status TabletMetadata::DeleteTabletData(TabletDataState delete_type,
     }
   }
 
+  // Files kept by a failed remote bootstrap survive tombstoning, so that the next remote bootstrap
+  // of the tablet could reuse them, but not the deletion of the tablet.
+  auto resume_dir = rocksdb_dir_ + kRemoteBootstrapResumeDirSuffix;
+  if (delete_type == TABLET_DATA_DELETED && fs_manager_->env()->FileExists(resume_dir)) {
+    LOG(INFO) << "Deleting remote bootstrap resume directory: " << resume_dir;
+    RETURN_NOT_OK(fs_manager_->env()->DeleteRecursively(resume_dir));
+  }
+
   // Flushing will sync the new tablet_data_state_ to disk and will now also
   // delete all the data.
   RETURN_NOT_OK(Flush());
@@ -533,13 +544,26 @@ Status TabletMetadata::Flush() {
   TRACE_EVENT1("tablet", "TabletMetadata::Flush",
                "tablet_id", tablet_id_);
 
+  // Changes made before this call are visible to any superblock that is built after a request
+  // with a number not less than ours is taken.
+  const auto request = flush_requests_.fetch_add(1, std::memory_order_acq_rel) + 1;
+
   MutexLock l_flush(flush_lock_);
+  if (covered_flush_requests_ >= request) {
+    TRACE("Metadata flushed by another caller");
+    return last_flush_status_;
+  }
+  // All the requests taken so far are covered by the superblock built below.
+  const auto covered = flush_requests_.load(std::memory_order_acquire);
   TabletSuperBlockPB pb;
   {
     std::lock_guard<LockType> l(data_lock_);
     ToSuperBlockUnlocked(&pb);
   }
-  RETURN_NOT_OK(ReplaceSuperBlockUnlocked(pb));
+  last_flush_status_ = ReplaceSuperBlockUnlocked(pb);
+  covered_flush_requests_ = covered;
+  superblock_writes_.fetch_add(1, std::memory_order_acq_rel);
+  RETURN_NOT_OK(last_flush_status_);
   TRACE("Metadata flushed");
 
   return Status::OK();
@@ -32,6 +32,7 @@
 #ifndef YB_TABLET_TABLET_METADATA_H
 #define YB_TABLET_TABLET_METADATA_H
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <unordered_set>
@@ -289,8 +290,16 @@ class TabletMetadata : public RefCountedThreadSafe<TabletMetadata> {
   void set_tablet_data_state(TabletDataState state);
   TabletDataState tablet_data_state() const;
 
+  // Writes the superblock to disk and syncs it. Concurrent calls are coalesced: a call that arrives
+  // while a write is in progress waits for it, and then returns without writing again if another
+  // caller already wrote a superblock that includes its changes.
   CHECKED_STATUS Flush();
 
+  // Number of times the superblock was written by Flush().
+  uint64_t superblock_writes() const {
+    return superblock_writes_.load(std::memory_order_acquire);
+  }
+
   // Mark the superblock to be in state 'delete_type', sync it to disk, and
   // then delete all of the rowsets in this tablet.
   // The metadata (superblock) is not deleted. For that, call DeleteSuperBlock().
@@ -402,6 +411,13 @@ class TabletMetadata : public RefCountedThreadSafe<TabletMetadata> {
   // If taken together with 'data_lock_', must be acquired first.
   mutable Mutex flush_lock_;
 
+  // Number of calls to Flush(), and the number of them that are covered by written superblocks,
+  // which is protected by 'flush_lock_', together with the status of the last write.
+  std::atomic<uint64_t> flush_requests_{0};
+  uint64_t covered_flush_requests_ = 0;
+  Status last_flush_status_;
+  std::atomic<uint64_t> superblock_writes_{0};
+
   // The tablet id and partition.
   const std::string tablet_id_;
   Partition partition_;
@@ -443,6 +459,7 @@ class TabletMetadata : public RefCountedThreadSafe<TabletMetadata> {
 
 extern const std::string kIntentsSubdir;
 extern const std::string kIntentsDBSuffix;
+extern const std::string kRemoteBootstrapResumeDirSuffix;
 
 } // namespace tablet
 } // namespace yb
@@ -70,10 +70,109 @@ METRIC_DEFINE_histogram(
     tablet, ql_read_latency, "HandleQLReadRequest latency", yb::MetricUnit::kMicroseconds,
     "Time taken to handle a QLReadRequest", 60000000LU, 2);
 
+METRIC_DEFINE_histogram(
+    tablet, wake_up_latency, "Tablet wake up latency", yb::MetricUnit::kMicroseconds,
+    "Time taken by the first read or write of a tablet that woke up from hibernation, which "
+    "includes reopening the SST files it reads.", 60000000LU, 2);
+
 METRIC_DEFINE_histogram(
     tablet, write_lock_latency, "Write lock latency", yb::MetricUnit::kMicroseconds,
     "Time taken to acquire key locks for a write operation", 60000000LU, 2);
 
+METRIC_DEFINE_histogram(
+    tablet, write_conflict_resolution_latency, "Write conflict resolution latency",
+    yb::MetricUnit::kMicroseconds,
+    "Time taken to resolve conflicts with other transactions for a write operation",
+    60000000LU, 2);
+
+METRIC_DEFINE_histogram(
+    tablet, write_execute_latency, "Write execute latency", yb::MetricUnit::kMicroseconds,
+    "Time taken to read the current values and build the write batch of a write operation",
+    60000000LU, 2);
+
+METRIC_DEFINE_histogram(
+    tablet, write_prepare_latency, "Write prepare latency", yb::MetricUnit::kMicroseconds,
+    "Time a write operation waited for the preparer to start it", 60000000LU, 2);
+
+METRIC_DEFINE_histogram(
+    tablet, write_replication_latency, "Write replication latency",
+    yb::MetricUnit::kMicroseconds,
+    "Time from the start of a write operation until it is applied, including the WAL append, "
+    "Raft replication and the wait for the apply pool", 60000000LU, 2);
+
+METRIC_DEFINE_histogram(
+    tablet, write_apply_latency, "Write apply latency", yb::MetricUnit::kMicroseconds,
+    "Time taken to apply a write operation to RocksDB", 60000000LU, 2);
+
+METRIC_DEFINE_counter(tablet, write_lock_waits,
+  "Write Lock Waits",
+  yb::MetricUnit::kOperations,
+  "Number of key locks that had to wait for a conflicting lock to be released.");
+
+METRIC_DEFINE_counter(tablet, safe_time_waits,
+  "Safe Time Waits",
+  yb::MetricUnit::kRequests,
+  "Number of reads that had to wait for pending operations to be replicated before they could "
+  "read at the requested hybrid time.");
+
+METRIC_DEFINE_counter(tablet, row_cache_hits,
+  "Row Cache Hits",
+  yb::MetricUnit::kRequests,
+  "Number of point reads served from the tablet row cache.");
+
+METRIC_DEFINE_counter(tablet, row_cache_misses,
+  "Row Cache Misses",
+  yb::MetricUnit::kRequests,
+  "Number of point reads that looked up the tablet row cache and had to read RocksDB.");
+
+METRIC_DEFINE_counter(tablet, docdb_write_rocksdb_seeks,
+  "DocDB Write RocksDB Seeks",
+  yb::MetricUnit::kOperations,
+  "Number of RocksDB seeks performed by write operations to read the existing state of the "
+  "documents they modify.");
+
+METRIC_DEFINE_counter(tablet, regulardb_nexts_instead_of_seek,
+  "Regular DB Nexts Instead Of Seek",
+  yb::MetricUnit::kOperations,
+  "Number of forward seeks in the regular DB that reached the target key with "
+  "Next() calls only.");
+
+METRIC_DEFINE_counter(tablet, regulardb_seeks_after_nexts,
+  "Regular DB Seeks After Nexts",
+  yb::MetricUnit::kOperations,
+  "Number of forward seeks in the regular DB that had to call Seek() after "
+  "trying Next() calls.");
+
+METRIC_DEFINE_gauge_uint32(tablet, regulardb_max_nexts_to_avoid_seek,
+  "Regular DB Max Nexts To Avoid Seek",
+  yb::MetricUnit::kOperations,
+  "Number of Next() calls currently tried before a Seek() in the regular DB, "
+  "as chosen by the adaptive seek tuner.");
+
+METRIC_DEFINE_counter(tablet, intentsdb_nexts_instead_of_seek,
+  "Intents DB Nexts Instead Of Seek",
+  yb::MetricUnit::kOperations,
+  "Number of forward seeks in the intents DB that reached the target key with "
+  "Next() calls only.");
+
+METRIC_DEFINE_counter(tablet, intentsdb_seeks_after_nexts,
+  "Intents DB Seeks After Nexts",
+  yb::MetricUnit::kOperations,
+  "Number of forward seeks in the intents DB that had to call Seek() after "
+  "trying Next() calls.");
+
+METRIC_DEFINE_gauge_uint32(tablet, intentsdb_max_nexts_to_avoid_seek,
+  "Intents DB Max Nexts To Avoid Seek",
+  yb::MetricUnit::kOperations,
+  "Number of Next() calls currently tried before a Seek() in the intents DB, "
+  "as chosen by the adaptive seek tuner.");
+
+METRIC_DEFINE_gauge_uint64(tablet, hottest_key_ops_per_sec,
+  "Hottest Key Operations Per Second",
+  yb::MetricUnit::kOperations,
+  "Estimated rate of reads and writes of the most frequently accessed key of the tablet, "
+  "over the last window of tablet_hot_keys_window_sec. Zero when hot key sampling is off.");
+
 METRIC_DEFINE_gauge_uint32(tablet, compact_rs_running,
   "RowSet Compactions Running",
   yb::MetricUnit::kMaintenanceOperations,
@@ -129,24 +228,125 @@ METRIC_DEFINE_counter(tablet, restart_read_requests,
   yb::MetricUnit::kRequests,
   "Number of read requests that require restart.");
 
+METRIC_DEFINE_counter(tablet, hibernations,
+  "Tablet Hibernations",
+  yb::MetricUnit::kOperations,
+  "Number of times the tablet released its memtables and SST file readers because it was idle.");
+
+METRIC_DEFINE_gauge_uint64(tablet, bootstrap_open_tablet_duration,
+  "Bootstrap Open Tablet Duration",
+  yb::MetricUnit::kMicroseconds,
+  "Time the last bootstrap of this tablet spent opening its RocksDB instances.");
+
+METRIC_DEFINE_gauge_uint64(tablet, bootstrap_read_log_duration,
+  "Bootstrap Read Log Duration",
+  yb::MetricUnit::kMicroseconds,
+  "Time the last bootstrap of this tablet spent waiting for WAL segments to be read and "
+  "decoded.");
+
+METRIC_DEFINE_gauge_uint64(tablet, bootstrap_replay_log_duration,
+  "Bootstrap Replay Log Duration",
+  yb::MetricUnit::kMicroseconds,
+  "Time the last bootstrap of this tablet spent replaying WAL entries.");
+
+// The file I/O metrics of an I/O class.
+#define YB_DEFINE_IO_METRICS(io_class, label, description) \
+  METRIC_DEFINE_counter(tablet, io_class##_io_bytes_read, label " I/O Bytes Read", \
+      yb::MetricUnit::kBytes, "Number of bytes read from files by " description "."); \
+  METRIC_DEFINE_counter(tablet, io_class##_io_bytes_written, \
+      label " I/O Bytes Written", yb::MetricUnit::kBytes, \
+      "Number of bytes written to files by " description "."); \
+  METRIC_DEFINE_counter(tablet, io_class##_io_read_ops, label " I/O Reads", \
+      yb::MetricUnit::kOperations, "Number of file reads done by " description "."); \
+  METRIC_DEFINE_counter(tablet, io_class##_io_write_ops, label " I/O Writes", \
+      yb::MetricUnit::kOperations, "Number of file writes done by " description "."); \
+  METRIC_DEFINE_counter(tablet, io_class##_io_time, label " I/O Time", \
+      yb::MetricUnit::kNanoseconds, \
+      "Time spent in file reads, writes and syncs done by " description ".")
+
+YB_DEFINE_IO_METRICS(foreground_read, "Foreground Read", "reads of this tablet");
+YB_DEFINE_IO_METRICS(flush, "Flush", "flushes of this tablet");
+YB_DEFINE_IO_METRICS(compaction, "Compaction", "compactions of this tablet");
+YB_DEFINE_IO_METRICS(bootstrap, "Bootstrap", "bootstraps of this tablet");
+
+#undef YB_DEFINE_IO_METRICS
+
 using strings::Substitute;
 
 namespace yb {
 namespace tablet {
 
+namespace {
+
+std::shared_ptr<IOMetrics> InstantiateIOMetrics(
+    const scoped_refptr<MetricEntity>& entity, CounterPrototype* bytes_read,
+    CounterPrototype* bytes_written, CounterPrototype* read_ops,
+    CounterPrototype* write_ops, CounterPrototype* io_time) {
+  auto result = std::make_shared<IOMetrics>();
+  result->bytes_read = bytes_read->Instantiate(entity);
+  result->bytes_written = bytes_written->Instantiate(entity);
+  result->read_ops = read_ops->Instantiate(entity);
+  result->write_ops = write_ops->Instantiate(entity);
+  result->io_time = io_time->Instantiate(entity);
+  return result;
+}
+
+} // namespace
+
+#define INSTANTIATE_IO_METRICS(io_class) \
+  InstantiateIOMetrics( \
+      entity, &METRIC_##io_class##_io_bytes_read, &METRIC_##io_class##_io_bytes_written, \
+      &METRIC_##io_class##_io_read_ops, &METRIC_##io_class##_io_write_ops, \
+      &METRIC_##io_class##_io_time)
+
 #define MINIT(x) x(METRIC_##x.Instantiate(entity))
+#define GINIT(x) x(METRIC_##x.Instantiate(entity, 0))
 TabletMetrics::TabletMetrics(const scoped_refptr<MetricEntity>& entity)
   : MINIT(snapshot_read_inflight_wait_duration),
     MINIT(redis_read_latency),
     MINIT(ql_read_latency),
+    MINIT(wake_up_latency),
     MINIT(write_lock_latency),
+    MINIT(write_lock_waits),
+    MINIT(safe_time_waits),
+    MINIT(row_cache_hits),
+    MINIT(row_cache_misses),
+    MINIT(docdb_write_rocksdb_seeks),
+    MINIT(regulardb_nexts_instead_of_seek),
+    MINIT(regulardb_seeks_after_nexts),
+    MINIT(intentsdb_nexts_instead_of_seek),
+    MINIT(intentsdb_seeks_after_nexts),
     MINIT(write_op_duration_client_propagated_consistency),
     MINIT(not_leader_rejections),
     MINIT(leader_memory_pressure_rejections),
     MINIT(transaction_conflicts),
     MINIT(expired_transactions),
-    MINIT(restart_read_requests) {
+    MINIT(restart_read_requests),
+    MINIT(hibernations),
+    GINIT(regulardb_max_nexts_to_avoid_seek),
+    GINIT(intentsdb_max_nexts_to_avoid_seek),
+    GINIT(hottest_key_ops_per_sec),
+    GINIT(bootstrap_open_tablet_duration),
+    GINIT(bootstrap_read_log_duration),
+    GINIT(bootstrap_replay_log_duration) {
+  write_phase_latency[to_underlying(WritePhase::kLock)] = write_lock_latency;
+  write_phase_latency[to_underlying(WritePhase::kConflictResolution)] =
+      METRIC_write_conflict_resolution_latency.Instantiate(entity);
+  write_phase_latency[to_underlying(WritePhase::kExecute)] =
+      METRIC_write_execute_latency.Instantiate(entity);
+  write_phase_latency[to_underlying(WritePhase::kPrepare)] =
+      METRIC_write_prepare_latency.Instantiate(entity);
+  write_phase_latency[to_underlying(WritePhase::kReplication)] =
+      METRIC_write_replication_latency.Instantiate(entity);
+  write_phase_latency[to_underlying(WritePhase::kApply)] =
+      METRIC_write_apply_latency.Instantiate(entity);
+  io_metrics[to_underlying(IOClass::kForegroundRead)] = INSTANTIATE_IO_METRICS(foreground_read);
+  io_metrics[to_underlying(IOClass::kFlush)] = INSTANTIATE_IO_METRICS(flush);
+  io_metrics[to_underlying(IOClass::kCompaction)] = INSTANTIATE_IO_METRICS(compaction);
+  io_metrics[to_underlying(IOClass::kBootstrap)] = INSTANTIATE_IO_METRICS(bootstrap);
 }
+#undef INSTANTIATE_IO_METRICS
+#undef GINIT
 #undef MINIT
 
 ScopedTabletMetricsTracker::ScopedTabletMetricsTracker(scoped_refptr<Histogram> latency)
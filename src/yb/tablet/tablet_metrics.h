@@ -32,9 +32,14 @@
 #ifndef YB_TABLET_TABLET_METRICS_H
 #define YB_TABLET_TABLET_METRICS_H
 
+#include <array>
+#include <memory>
+
 #include "yb/gutil/macros.h"
 #include "yb/gutil/ref_counted.h"
 
+#include "yb/util/enums.h"
+#include "yb/util/io_accounting.h"
 #include "yb/util/monotime.h"
 
 namespace yb {
@@ -47,6 +52,15 @@ class MetricEntity;
 
 namespace tablet {
 
+// Phases of a write on the leader. Each one starts where the previous one ended.
+YB_DEFINE_ENUM(WritePhase,
+    (kLock)               // From the creation of the operation until its key locks are acquired.
+    (kConflictResolution) // Resolving conflicts with other transactions.
+    (kExecute)            // Reading the current values and building the write batch.
+    (kPrepare)            // Waiting for the preparer to start the operation.
+    (kReplication)        // Appending to the WAL, replicating and waiting for the apply pool.
+    (kApply));            // Applying the write batch to RocksDB.
+
 // Container for all metrics specific to a single tablet.
 struct TabletMetrics {
   explicit TabletMetrics(const scoped_refptr<MetricEntity>& metric_entity);
@@ -56,15 +70,41 @@ struct TabletMetrics {
   scoped_refptr<Histogram> snapshot_read_inflight_wait_duration;
   scoped_refptr<Histogram> redis_read_latency;
   scoped_refptr<Histogram> ql_read_latency;
+  // Duration of the first read or write after the tablet woke up from hibernation.
+  scoped_refptr<Histogram> wake_up_latency;
   scoped_refptr<Histogram> write_lock_latency;
   scoped_refptr<Histogram> write_op_duration_client_propagated_consistency;
   scoped_refptr<Histogram> write_op_duration_commit_wait_consistency;
+  // Latency of each write phase, the lock phase uses write_lock_latency.
+  std::array<scoped_refptr<Histogram>, kWritePhaseMapSize> write_phase_latency;
 
+  scoped_refptr<Counter> write_lock_waits;
+  scoped_refptr<Counter> safe_time_waits;
+  scoped_refptr<Counter> row_cache_hits;
+  scoped_refptr<Counter> row_cache_misses;
+  scoped_refptr<Counter> docdb_write_rocksdb_seeks;
+  scoped_refptr<Counter> regulardb_nexts_instead_of_seek;
+  scoped_refptr<Counter> regulardb_seeks_after_nexts;
+  scoped_refptr<Counter> intentsdb_nexts_instead_of_seek;
+  scoped_refptr<Counter> intentsdb_seeks_after_nexts;
   scoped_refptr<Counter> not_leader_rejections;
   scoped_refptr<Counter> leader_memory_pressure_rejections;
   scoped_refptr<Counter> transaction_conflicts;
   scoped_refptr<Counter> expired_transactions;
   scoped_refptr<Counter> restart_read_requests;
+  scoped_refptr<Counter> hibernations;
+
+  scoped_refptr<AtomicGauge<uint32_t>> regulardb_max_nexts_to_avoid_seek;
+  scoped_refptr<AtomicGauge<uint32_t>> intentsdb_max_nexts_to_avoid_seek;
+  scoped_refptr<AtomicGauge<uint64_t>> hottest_key_ops_per_sec;
+
+  // Time spent in each phase of the last bootstrap of this tablet.
+  scoped_refptr<AtomicGauge<uint64_t>> bootstrap_open_tablet_duration;
+  scoped_refptr<AtomicGauge<uint64_t>> bootstrap_read_log_duration;
+  scoped_refptr<AtomicGauge<uint64_t>> bootstrap_replay_log_duration;
+
+  // File I/O done for this tablet, by class.
+  std::array<std::shared_ptr<IOMetrics>, kIOClassMapSize> io_metrics;
 };
 
 class ScopedTabletMetricsTracker {
@@ -17,6 +17,7 @@ namespace rocksdb {
 class Cache;
 class EventListener;
 class MemoryMonitor;
+class RateLimiter;
 }
 
 namespace yb {
@@ -25,6 +26,9 @@ namespace tablet {
 struct TabletOptions {
   std::shared_ptr<rocksdb::Cache> block_cache;
   std::shared_ptr<rocksdb::MemoryMonitor> memory_monitor;
+  // Compaction and flush rate limiter shared by all tablets. When not set, every RocksDB instance
+  // gets a rate limiter of its own.
+  std::shared_ptr<rocksdb::RateLimiter> rate_limiter;
   std::vector<std::shared_ptr<rocksdb::EventListener>> listeners;
 };
 
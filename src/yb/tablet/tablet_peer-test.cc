@@ -160,7 +160,7 @@ class TabletPeerTest : public YBTabletTest,
     ASSERT_OK(Log::Open(LogOptions(), fs_manager(), tablet()->tablet_id(),
                         tablet()->metadata()->wal_dir(), *tablet()->schema(),
                         tablet()->metadata()->schema_version(), metric_entity_.get(),
-                        append_pool_.get(), &log));
+                        append_pool_.get(), nullptr /* allocation_thread_pool */, &log));
 
     ASSERT_OK(tablet_peer_->SetBootstrapping());
     ASSERT_OK(tablet_peer_->InitTabletPeer(tablet(),
@@ -172,7 +172,8 @@ class TabletPeerTest : public YBTabletTest,
                                            metric_entity_,
                                            raft_pool_.get(),
                                            tablet_prepare_pool_.get(),
-                                           nullptr /* retryable_requests */));
+                                           nullptr /* retryable_requests */,
+                                           nullptr /* multi_raft_manager */));
   }
 
   Status StartPeer(const ConsensusBootstrapInfo& info) {
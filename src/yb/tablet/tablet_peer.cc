@@ -72,6 +72,7 @@
 
 #include "yb/tablet/operations/change_metadata_operation.h"
 #include "yb/tablet/operations/operation_driver.h"
+#include "yb/tablet/operations/ingest_external_files_operation.h"
 #include "yb/tablet/operations/truncate_operation.h"
 #include "yb/tablet/operations/write_operation.h"
 #include "yb/tablet/operations/update_txn_operation.h"
@@ -163,7 +164,8 @@ Status TabletPeer::InitTabletPeer(const shared_ptr<TabletClass> &tablet,
                                   const scoped_refptr<MetricEntity> &metric_entity,
                                   ThreadPool* raft_pool,
                                   ThreadPool* tablet_prepare_pool,
-                                  consensus::RetryableRequests* retryable_requests) {
+                                  consensus::RetryableRequests* retryable_requests,
+                                  consensus::MultiRaftManager* multi_raft_manager) {
 
   DCHECK(tablet) << "A TabletPeer must be provided with a Tablet";
   DCHECK(log) << "A TabletPeer must be provided with a Log";
@@ -221,6 +223,7 @@ Status TabletPeer::InitTabletPeer(const shared_ptr<TabletClass> &tablet,
 
     if (retryable_requests) {
       retryable_requests->SetMetricEntity(tablet->GetMetricEntity());
+      retryable_requests->SetMemTracker(tablet->mem_tracker());
     }
 
     consensus_ = RaftConsensus::Create(
@@ -237,7 +240,8 @@ Status TabletPeer::InitTabletPeer(const shared_ptr<TabletClass> &tablet,
         mark_dirty_clbk_,
         tablet_->table_type(),
         raft_pool,
-        retryable_requests);
+        retryable_requests,
+        multi_raft_manager);
     has_consensus_.store(true, std::memory_order_release);
     auto ht_lease_provider = [this](MicrosTime min_allowed, CoarseTimePoint deadline) {
       MicrosTime lease_micros {
@@ -263,7 +267,8 @@ Status TabletPeer::InitTabletPeer(const shared_ptr<TabletClass> &tablet,
       return mvcc_manager->SafeTime(ht_lease);
     });
 
-    prepare_thread_ = std::make_unique<Preparer>(consensus_.get(), tablet_prepare_pool);
+    prepare_thread_ = std::make_unique<Preparer>(
+        consensus_.get(), tablet_prepare_pool, tablet_->GetMetricEntity());
 
     consensus_->SetMajorityReplicatedListener([mvcc_manager, ht_lease_provider] {
       auto ht_lease = ht_lease_provider(/* min_allowed */ 0, /* deadline */ CoarseTimePoint::max());
@@ -573,6 +578,9 @@ consensus::OperationType MapOperationTypeToPB(OperationType operation_type) {
     case OperationType::kTruncate:
       return consensus::TRUNCATE_OP;
 
+    case OperationType::kIngestExternalFiles:
+      return consensus::INGEST_EXTERNAL_FILES_OP;
+
     case OperationType::kEmpty:
       LOG(FATAL) << "OperationType::kEmpty cannot be converted to consensus::OperationType";
   }
@@ -736,6 +744,12 @@ std::unique_ptr<Operation> TabletPeer::CreateOperation(consensus::ReplicateMsg*
       return std::make_unique<TruncateOperation>(
           std::make_unique<TruncateOperationState>(tablet()));
 
+    case consensus::INGEST_EXTERNAL_FILES_OP:
+      DCHECK(replicate_msg->has_ingest_external_files_request()) << "INGEST_EXTERNAL_FILES_OP "
+          "replica operation must receive an IngestExternalFilesRequestPB";
+      return std::make_unique<IngestExternalFilesOperation>(
+          std::make_unique<IngestExternalFilesOperationState>(tablet()));
+
     case consensus::SNAPSHOT_OP: FALLTHROUGH_INTENDED;
     case consensus::UNKNOWN_OP: FALLTHROUGH_INTENDED;
     case consensus::NO_OP: FALLTHROUGH_INTENDED;
@@ -27,9 +27,17 @@ namespace tablet {
 using docdb::TableTTL;
 using docdb::HistoryRetentionDirective;
 
-TabletRetentionPolicy::TabletRetentionPolicy(Tablet* tablet)
-    : tablet_(tablet),
-      retention_delta_(MonoDelta::FromSeconds(-FLAGS_timestamp_history_retention_interval_sec)) {
+TabletRetentionPolicy::TabletRetentionPolicy(Tablet* tablet) : tablet_(tablet) {
+}
+
+MonoDelta TabletRetentionPolicy::RetentionDelta() const {
+  // Frequently updated tables could retain less history than the others, so that reads skip fewer
+  // overwritten versions. The table property is read each time, so that it can be altered.
+  const auto& table_properties = tablet_->metadata()->schema().table_properties();
+  if (table_properties.HasHistoryRetentionInterval()) {
+    return MonoDelta::FromSeconds(-table_properties.history_retention_interval_sec());
+  }
+  return MonoDelta::FromSeconds(-FLAGS_timestamp_history_retention_interval_sec);
 }
 
 HistoryRetentionDirective TabletRetentionPolicy::GetRetentionDirective() {
@@ -37,7 +45,7 @@ HistoryRetentionDirective TabletRetentionPolicy::GetRetentionDirective() {
   // interval, but we might not be able to do so if there are still read operations reading at an
   // older snapshot.
   const HybridTime proposed_cutoff =
-      server::HybridClock::AddPhysicalTimeToHybridTime(tablet_->clock()->Now(), retention_delta_);
+      server::HybridClock::AddPhysicalTimeToHybridTime(tablet_->clock()->Now(), RetentionDelta());
   const HybridTime history_cutoff = tablet_->UpdateHistoryCutoff(proposed_cutoff);
 
   std::shared_ptr<ColumnIds> deleted_before_history_cutoff = std::make_shared<ColumnIds>();
@@ -22,8 +22,8 @@
 namespace yb {
 namespace tablet {
 
-// History retention policy used by a tablet. It is based on pending reads and a fixed retention
-// interval configured by the user.
+// History retention policy used by a tablet. It is based on pending reads and a retention interval
+// configured by the user, per table or server-wide.
 class TabletRetentionPolicy : public docdb::HistoryRetentionPolicy {
  public:
   explicit TabletRetentionPolicy(Tablet* tablet);
@@ -31,11 +31,11 @@ class TabletRetentionPolicy : public docdb::HistoryRetentionPolicy {
   docdb::HistoryRetentionDirective GetRetentionDirective() override;
 
  private:
-  Tablet* tablet_;
-
   // The delta to be added to the current time to get the history cutoff timestamp. This is always
   // a negative amount.
-  MonoDelta retention_delta_;
+  MonoDelta RetentionDelta() const;
+
+  Tablet* tablet_;
 };
 
 }  // namespace tablet
@@ -647,12 +647,31 @@ class TransactionCoordinator::Impl : public TransactionStateContext {
     }
 
     std::lock_guard<std::mutex> lock(managed_mutex_);
-    auto it = managed_transactions_.find(*id);
-    if (it == managed_transactions_.end()) {
-      response->set_status(TransactionStatus::ABORTED);
-      return Status::OK();
+    return GetStatusUnlocked(*id, response);
+  }
+
+  CHECKED_STATUS GetStatus(const tserver::GetTransactionStatusRequestPB& request,
+                           tserver::GetTransactionStatusResponsePB* response) {
+    std::vector<TransactionId> ids;
+    ids.reserve(request.batched_transaction_id_size() + 1);
+    ids.push_back(VERIFY_RESULT(FullyDecodeTransactionId(request.transaction_id())));
+    for (const auto& transaction_id : request.batched_transaction_id()) {
+      ids.push_back(VERIFY_RESULT(FullyDecodeTransactionId(transaction_id)));
     }
-    return it->GetStatus(response);
+
+    std::lock_guard<std::mutex> lock(managed_mutex_);
+    RETURN_NOT_OK(GetStatusUnlocked(ids.front(), response));
+    tserver::GetTransactionStatusResponsePB transaction_response;
+    for (auto it = ids.begin() + 1; it != ids.end(); ++it) {
+      transaction_response.Clear();
+      RETURN_NOT_OK(GetStatusUnlocked(*it, &transaction_response));
+      auto* batched_status = response->add_batched_statuses();
+      batched_status->set_status(transaction_response.status());
+      if (transaction_response.has_status_hybrid_time()) {
+        batched_status->set_status_hybrid_time(transaction_response.status_hybrid_time());
+      }
+    }
+    return Status::OK();
   }
 
   void Abort(const std::string& transaction_id, int64_t term, TransactionAbortCallback callback) {
@@ -803,6 +822,16 @@ class TransactionCoordinator::Impl : public TransactionStateContext {
   class LastTouchTag;
   class FirstEntryIndexTag;
 
+  CHECKED_STATUS GetStatusUnlocked(const TransactionId& id,
+                                   tserver::GetTransactionStatusResponsePB* response) {
+    auto it = managed_transactions_.find(id);
+    if (it == managed_transactions_.end()) {
+      response->set_status(TransactionStatus::ABORTED);
+      return Status::OK();
+    }
+    return it->GetStatus(response);
+  }
+
   typedef boost::multi_index_container<TransactionState,
       boost::multi_index::indexed_by <
           boost::multi_index::hashed_unique <
@@ -1042,6 +1071,11 @@ void TransactionCoordinator::Shutdown() {
   impl_->Shutdown();
 }
 
+Status TransactionCoordinator::GetStatus(const tserver::GetTransactionStatusRequestPB& request,
+                                         tserver::GetTransactionStatusResponsePB* response) {
+  return impl_->GetStatus(request, response);
+}
+
 Status TransactionCoordinator::GetStatus(const std::string& transaction_id,
                                          tserver::GetTransactionStatusResponsePB* response) {
   return impl_->GetStatus(transaction_id, response);
@@ -47,6 +47,7 @@ class Clock;
 namespace tserver {
 
 class AbortTransactionResponsePB;
+class GetTransactionStatusRequestPB;
 class GetTransactionStatusResponsePB;
 class TransactionStatePB;
 
@@ -133,6 +134,11 @@ class TransactionCoordinator {
   CHECKED_STATUS GetStatus(const std::string& transaction_id,
                            tserver::GetTransactionStatusResponsePB* response);
 
+  // Fills the statuses of the transaction_id of the request, and of all its
+  // batched_transaction_id, looking all of them up at once.
+  CHECKED_STATUS GetStatus(const tserver::GetTransactionStatusRequestPB& request,
+                           tserver::GetTransactionStatusResponsePB* response);
+
   void Abort(const std::string& transaction_id, int64_t term, TransactionAbortCallback callback);
 
   // Returns count of managed transactions. Used in tests.
@@ -15,8 +15,11 @@
 
 #include "yb/tablet/transaction_participant.h"
 
+#include <atomic>
+#include <condition_variable>
 #include <mutex>
 #include <queue>
+#include <unordered_map>
 
 #include <boost/multi_index_container.hpp>
 #include <boost/multi_index/hashed_index.hpp>
@@ -53,6 +56,9 @@ using namespace std::placeholders;
 
 DEFINE_uint64(transaction_delay_status_reply_usec_in_tests, 0,
               "For tests only. Delay handling status reply by specified amount of usec.");
+DEFINE_bool(transaction_status_batching, true,
+            "Fetch statuses of transactions that have the same status tablet with a single RPC, "
+            "when statuses of several transactions are requested at once.");
 DEFINE_double(transaction_ignore_applying_probability_in_tests, 0,
               "Probability to ignore APPLYING update in tests.");
 
@@ -130,11 +136,101 @@ class RunningTransaction;
 
 typedef std::shared_ptr<RunningTransaction> RunningTransactionPtr;
 
+// Status request of running transaction, that was not sent yet.
+struct PendingStatusRequest {
+  RunningTransactionPtr transaction;
+  int64_t serial_no;
+};
+
+// Pending status requests grouped by status tablet.
+typedef std::unordered_map<TabletId, std::vector<PendingStatusRequest>> StatusRequestBatch;
+
+// Removes the intents of aborted transactions in the background. Transactions queued while a
+// removal is in progress are removed together by the next one, with a single write batch, so with
+// many small transactions aborted at once the intents DB does not get a write per transaction.
+class RemoveIntentsTask : public rpc::ThreadPoolTask {
+ public:
+  RemoveIntentsTask(TransactionIntentApplier* applier, TransactionParticipantContext* context)
+      : applier_(*applier), context_(*context) {}
+
+  ~RemoveIntentsTask() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    stopping_ = true;
+    queue_.clear();
+    cond_.wait(lock, [this] { return !running_; });
+  }
+
+  void Add(const TransactionId& id) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (stopping_) {
+        return;
+      }
+      queue_.insert(id);
+      if (running_) {
+        return;
+      }
+      running_ = true;
+    }
+    context_.Enqueue(this);
+  }
+
+  void Run() override {
+    TransactionIdSet batch;
+    for (;;) {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (queue_.empty()) {
+          return;
+        }
+        batch.swap(queue_);
+      }
+      auto status = applier_.RemoveIntents(batch);
+      LOG_IF(WARNING, !status.ok()) << "Failed to remove intents of " << batch.size()
+                                    << " aborted transactions: " << status;
+      VLOG(2) << "Removed intents of " << batch.size() << " aborted transactions";
+      batch.clear();
+    }
+  }
+
+  void Done(const Status& status) override {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!status.ok()) {
+        // Intents left behind are removed later, by the cleanup of aborted transactions found
+        // during compactions.
+        LOG(WARNING) << "Failed to remove intents of " << queue_.size()
+                     << " aborted transactions: " << status;
+        queue_.clear();
+      }
+      if (queue_.empty()) {
+        running_ = false;
+        cond_.notify_all();
+        return;
+      }
+    }
+    // Transactions were added after Run found the queue empty.
+    context_.Enqueue(this);
+  }
+
+ private:
+  TransactionIntentApplier& applier_;
+  TransactionParticipantContext& context_;
+
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  TransactionIdSet queue_;
+  // Whether the task is enqueued or running, so it will process transactions added to queue_.
+  bool running_ = false;
+  bool stopping_ = false;
+};
+
 class RunningTransactionContext {
  public:
   RunningTransactionContext(TransactionParticipantContext* participant_context,
                             TransactionIntentApplier* applier)
-      : participant_context_(*participant_context), applier_(*applier) {
+      : participant_context_(*participant_context), applier_(*applier),
+        remove_intents_task_(applier, participant_context) {
   }
 
   virtual ~RunningTransactionContext() {}
@@ -153,48 +249,11 @@ class RunningTransactionContext {
   rpc::Rpcs rpcs_;
   TransactionParticipantContext& participant_context_;
   TransactionIntentApplier& applier_;
+  RemoveIntentsTask remove_intents_task_;
   int64_t request_serial_ = 0;
   std::mutex mutex_;
 };
 
-class RemoveIntentsTask : public rpc::ThreadPoolTask {
- public:
-  RemoveIntentsTask(TransactionIntentApplier* applier, TransactionParticipantContext* context,
-                    const TransactionId& id)
-      : applier_(*applier), context_(*context), id_(id) {}
-
-  bool Prepare(RunningTransactionPtr transaction) {
-    bool expected = false;
-    if (!used_.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
-      return false;
-    }
-
-    transaction_ = std::move(transaction);
-    return true;
-  }
-
-  void Run() override {
-    if (context_.IsLeader()) {
-      auto status = applier_.RemoveIntents(id_);
-      LOG_IF(WARNING, !status.ok()) << "Failed to remove intents of aborted transaction " << id_
-                                    << ": " << status;
-    }
-  }
-
-  void Done(const Status& status) override {
-    transaction_.reset();
-  }
-
-  virtual ~RemoveIntentsTask() {}
-
- private:
-  TransactionIntentApplier& applier_;
-  TransactionParticipantContext& context_;
-  TransactionId id_;
-  std::atomic<bool> used_{false};
-  RunningTransactionPtr transaction_;
-};
-
 class CleanupAbortsTask : public rpc::ThreadPoolTask {
  public:
   CleanupAbortsTask(TransactionIntentApplier* applier,
@@ -334,8 +393,6 @@ class RunningTransaction : public std::enable_shared_from_this<RunningTransactio
       : metadata_(std::move(metadata)),
         last_write_id_(last_write_id),
         context_(*context),
-        remove_intents_task_(&context->applier_, &context->participant_context_,
-                             metadata_.transaction_id),
         get_status_handle_(context->rpcs_.InvalidHandle()),
         abort_handle_(context->rpcs_.InvalidHandle()) {
   }
@@ -368,9 +425,12 @@ class RunningTransaction : public std::enable_shared_from_this<RunningTransactio
     local_commit_time_ = time;
   }
 
+  // When batch is specified, status RPC is not sent. Instead the request is added to batch, so it
+  // could be sent along with requests of other transactions.
   void RequestStatusAt(client::YBClient* client,
                        const StatusRequest& request,
-                       std::unique_lock<std::mutex>* lock) {
+                       std::unique_lock<std::mutex>* lock,
+                       StatusRequestBatch* batch = nullptr) {
     DCHECK_LT(request.global_limit_ht, HybridTime::kMax);
     DCHECK_LE(request.read_ht, request.global_limit_ht);
 
@@ -394,6 +454,10 @@ class RunningTransaction : public std::enable_shared_from_this<RunningTransactio
     auto request_id = context_.NextRequestIdUnlocked();
     auto shared_self = shared_from_this();
     lock->unlock();
+    if (batch) {
+      (*batch)[metadata_.status_tablet].push_back({std::move(shared_self), request_id});
+      return;
+    }
     SendStatusRequest(client, request_id, shared_self);
   }
 
@@ -424,28 +488,6 @@ class RunningTransaction : public std::enable_shared_from_this<RunningTransactio
     return metadata_.ToString();
   }
 
- private:
-  static boost::optional<TransactionStatus> GetStatusAt(
-      HybridTime time,
-      HybridTime last_known_status_hybrid_time,
-      TransactionStatus last_known_status) {
-    switch (last_known_status) {
-      case TransactionStatus::ABORTED:
-        return TransactionStatus::ABORTED;
-      case TransactionStatus::COMMITTED:
-        return last_known_status_hybrid_time > time
-            ? TransactionStatus::PENDING
-            : TransactionStatus::COMMITTED;
-      case TransactionStatus::PENDING:
-        if (last_known_status_hybrid_time >= time) {
-          return TransactionStatus::PENDING;
-        }
-        return boost::none;
-      default:
-        FATAL_INVALID_ENUM_VALUE(TransactionStatus, last_known_status);
-    }
-  }
-
   void SendStatusRequest(
       client::YBClient* client, int64_t serial_no, const RunningTransactionPtr& shared_self) {
     tserver::GetTransactionStatusRequestPB req;
@@ -479,6 +521,28 @@ class RunningTransaction : public std::enable_shared_from_this<RunningTransactio
     }
   }
 
+ private:
+  static boost::optional<TransactionStatus> GetStatusAt(
+      HybridTime time,
+      HybridTime last_known_status_hybrid_time,
+      TransactionStatus last_known_status) {
+    switch (last_known_status) {
+      case TransactionStatus::ABORTED:
+        return TransactionStatus::ABORTED;
+      case TransactionStatus::COMMITTED:
+        return last_known_status_hybrid_time > time
+            ? TransactionStatus::PENDING
+            : TransactionStatus::COMMITTED;
+      case TransactionStatus::PENDING:
+        if (last_known_status_hybrid_time >= time) {
+          return TransactionStatus::PENDING;
+        }
+        return boost::none;
+      default:
+        FATAL_INVALID_ENUM_VALUE(TransactionStatus, last_known_status);
+    }
+  }
+
   void DoStatusReceived(client::YBClient* client,
                         const Status& status,
                         const tserver::GetTransactionStatusResponsePB& response,
@@ -514,8 +578,8 @@ class RunningTransaction : public std::enable_shared_from_this<RunningTransactio
         last_known_status_hybrid_time_ = time_of_status;
         last_known_status_ = response.status();
         if (response.status() == TransactionStatus::ABORTED) {
-          if (!local_commit_time_ && remove_intents_task_.Prepare(shared_self)) {
-            context_.participant_context_.Enqueue(&remove_intents_task_);
+          if (!local_commit_time_ && context_.participant_context_.IsLeader()) {
+            context_.remove_intents_task_.Add(id());
             VLOG_WITH_PREFIX(1) << "Transaction should be aborted: " << id();
           }
           context_.RemoveUnlocked(id());
@@ -629,7 +693,6 @@ class RunningTransaction : public std::enable_shared_from_this<RunningTransactio
   TransactionMetadata metadata_;
   IntraTxnWriteId last_write_id_ = 0;
   RunningTransactionContext& context_;
-  RemoveIntentsTask remove_intents_task_;
   HybridTime local_commit_time_ = HybridTime::kInvalid;
 
   TransactionStatus last_known_status_;
@@ -763,6 +826,30 @@ class TransactionParticipant::Impl : public RunningTransactionContext {
     lock_and_iterator.transaction().RequestStatusAt(client(), request, &lock_and_iterator.lock);
   }
 
+  void RequestStatusesAt(const std::vector<StatusRequest>& requests) {
+    if (!FLAGS_transaction_status_batching || requests.size() < 2) {
+      for (const auto& request : requests) {
+        RequestStatusAt(request);
+      }
+      return;
+    }
+
+    StatusRequestBatch batch;
+    for (const auto& request : requests) {
+      auto lock_and_iterator = LockAndFindOrLoad(*request.id, *request.reason, request.must_exist);
+      if (!lock_and_iterator.found()) {
+        request.callback(
+            STATUS_FORMAT(NotFound, "Request status of unknown transaction: $0", *request.id));
+        continue;
+      }
+      lock_and_iterator.transaction().RequestStatusAt(
+          client(), request, &lock_and_iterator.lock, &batch);
+    }
+    for (auto& tablet_and_requests : batch) {
+      SendBatchedStatusRequest(tablet_and_requests.first, std::move(tablet_and_requests.second));
+    }
+  }
+
   // Registers request, giving him newly allocated id and returning this id.
   int64_t RegisterRequest() {
     std::lock_guard<std::mutex> lock(mutex_);
@@ -798,9 +885,22 @@ class TransactionParticipant::Impl : public RunningTransactionContext {
       transactions_.erase(id);
       VLOG_WITH_PREFIX(2) << "Cleaned from queue: " << id;
       cleanup_queue_.pop_front();
+      removed_cond_.notify_all();
     }
   }
 
+  void WaitUntilFinished(const std::vector<TransactionId>& ids, CoarseTimePoint deadline) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    removed_cond_.wait_until(lock, deadline, [this, &ids] {
+      for (const auto& id : ids) {
+        if (transactions_.find(id) != transactions_.end()) {
+          return false;
+        }
+      }
+      return true;
+    });
+  }
+
   void Abort(const TransactionId& id, TransactionStatusCallback callback) {
     auto lock_and_iterator = LockAndFindOrLoad(id, "abort"s);
     if (!lock_and_iterator.found()) {
@@ -952,6 +1052,13 @@ class TransactionParticipant::Impl : public RunningTransactionContext {
       }
     }
 
+    if (!force_remove) {
+      // Cleanup of an aborted transaction requested by its coordinator. Batch it with the cleanups
+      // of other aborted transactions.
+      remove_intents_task_.Add(data.transaction_id);
+      return Status::OK();
+    }
+
     auto status = applier_.RemoveIntents(data.transaction_id);
     LOG_IF_WITH_PREFIX(DFATAL, !status.ok()) << "Failed to remove intents for "
                                              << data.transaction_id << ": " << status;
@@ -961,6 +1068,26 @@ class TransactionParticipant::Impl : public RunningTransactionContext {
 
   void SetDB(rocksdb::DB* db) {
     db_ = db;
+
+    // Transactions stored in the intents DB are loaded lazily, so until one of them is loaded
+    // transactions_ does not reflect them. Check whether there is any stored transaction at all.
+    docdb::KeyBytes key;
+    key.AppendValueType(docdb::ValueType::kTransactionId);
+    auto iter = docdb::CreateRocksDBIterator(db_,
+                                             docdb::BloomFilterMode::DONT_USE_BLOOM_FILTER,
+                                             boost::none,
+                                             rocksdb::kDefaultQueryId);
+    iter->Seek(key.AsSlice());
+    has_stored_transactions_ = iter->Valid() && iter->key().starts_with(key.AsSlice());
+    LOG_IF_WITH_PREFIX(INFO, has_stored_transactions_) << "Intents DB has stored transactions";
+  }
+
+  bool MayHaveLiveIntents() {
+    if (has_stored_transactions_) {
+      return true;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    return !transactions_.empty();
   }
 
   TransactionParticipantContext* participant_context() const {
@@ -1000,6 +1127,7 @@ class TransactionParticipant::Impl : public RunningTransactionContext {
       transactions_.erase(it);
       VLOG_WITH_PREFIX(2) << "Cleaned transaction: " << txn_id
                           << ", left: " << transactions_.size();
+      removed_cond_.notify_all();
       return true;
     }
 
@@ -1119,9 +1247,85 @@ class TransactionParticipant::Impl : public RunningTransactionContext {
     TransactionId transaction_id;
   };
 
+  struct BatchedStatusRequest {
+    rpc::Rpcs::Handle handle;
+    std::vector<PendingStatusRequest> requests;
+  };
+
+  void SendBatchedStatusRequest(
+      const TabletId& status_tablet, std::vector<PendingStatusRequest> requests) {
+    auto* client = this->client();
+    if (requests.size() == 1) {
+      const auto& request = requests.front();
+      request.transaction->SendStatusRequest(client, request.serial_no, request.transaction);
+      return;
+    }
+
+    tserver::GetTransactionStatusRequestPB req;
+    req.set_tablet_id(status_tablet);
+    const auto& first_id = requests.front().transaction->id();
+    req.set_transaction_id(first_id.begin(), first_id.size());
+    for (auto it = requests.begin() + 1; it != requests.end(); ++it) {
+      const auto& id = it->transaction->id();
+      req.add_batched_transaction_id(id.begin(), id.size());
+    }
+    req.set_propagated_hybrid_time(participant_context_.Now().ToUint64());
+
+    auto batch = std::make_shared<BatchedStatusRequest>();
+    batch->handle = rpcs_.InvalidHandle();
+    batch->requests = std::move(requests);
+    rpcs_.RegisterAndStart(
+        client::GetTransactionStatus(
+            TransactionRpcDeadline(),
+            nullptr /* tablet */,
+            client,
+            &req,
+            std::bind(&Impl::BatchedStatusReceived, this, client, _1, _2, batch)),
+        &batch->handle);
+  }
+
+  // Splits response to batched status request into responses of individual transactions.
+  void BatchedStatusReceived(client::YBClient* client,
+                             const Status& status,
+                             const tserver::GetTransactionStatusResponsePB& response,
+                             const std::shared_ptr<BatchedStatusRequest>& batch) {
+    rpcs_.Unregister(&batch->handle);
+    const size_t num_batched_statuses = response.batched_statuses_size();
+    for (size_t i = 0; i != batch->requests.size(); ++i) {
+      const auto& request = batch->requests[i];
+      tserver::GetTransactionStatusResponsePB transaction_response;
+      if (status.ok()) {
+        if (response.has_propagated_hybrid_time()) {
+          transaction_response.set_propagated_hybrid_time(response.propagated_hybrid_time());
+        }
+        if (i == 0) {
+          transaction_response.set_status(response.status());
+          if (response.has_status_hybrid_time()) {
+            transaction_response.set_status_hybrid_time(response.status_hybrid_time());
+          }
+        } else if (i <= num_batched_statuses) {
+          const auto& batched_status = response.batched_statuses(i - 1);
+          transaction_response.set_status(batched_status.status());
+          if (batched_status.has_status_hybrid_time()) {
+            transaction_response.set_status_hybrid_time(batched_status.status_hybrid_time());
+          }
+        } else {
+          // Status tablet does not support batched requests, fetch this status separately.
+          request.transaction->SendStatusRequest(client, request.serial_no, request.transaction);
+          continue;
+        }
+      }
+      request.transaction->StatusReceived(
+          client, status, transaction_response, request.serial_no, request.transaction);
+    }
+  }
+
   std::string log_prefix_;
 
   rocksdb::DB* db_ = nullptr;
+  // Whether the intents DB had stored transactions when it was opened. Such transactions could
+  // have live intents without being loaded into transactions_.
+  std::atomic<bool> has_stored_transactions_{true};
   Transactions transactions_;
   // Ids of running requests, stored in increasing order.
   std::deque<int64_t> running_requests_;
@@ -1132,6 +1336,8 @@ class TransactionParticipant::Impl : public RunningTransactionContext {
   // Queue of transaction ids that should be cleaned, paired with request that should be completed
   // in order to be able to do clean.
   std::deque<CleanupQueueEntry> cleanup_queue_;
+  // Notified when transactions are removed, for the writes waiting for them to finish.
+  std::condition_variable removed_cond_;
 };
 
 TransactionParticipant::TransactionParticipant(
@@ -1173,6 +1379,10 @@ void TransactionParticipant::RequestStatusAt(const StatusRequest& request) {
   return impl_->RequestStatusAt(request);
 }
 
+void TransactionParticipant::RequestStatusesAt(const std::vector<StatusRequest>& requests) {
+  return impl_->RequestStatusesAt(requests);
+}
+
 int64_t TransactionParticipant::RegisterRequest() {
   return impl_->RegisterRequest();
 }
@@ -1195,6 +1405,15 @@ void TransactionParticipant::Cleanup(TransactionIdSet&& set) {
   return impl_->Cleanup(std::move(set), this);
 }
 
+void TransactionParticipant::WaitUntilFinished(
+    const std::vector<TransactionId>& ids, CoarseTimePoint deadline) {
+  impl_->WaitUntilFinished(ids, deadline);
+}
+
+bool TransactionParticipant::MayHaveLiveIntents() {
+  return impl_->MayHaveLiveIntents();
+}
+
 CHECKED_STATUS TransactionParticipant::ProcessApply(const TransactionApplyData& data) {
   return impl_->ProcessApply(data);
 }
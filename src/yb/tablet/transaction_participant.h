@@ -122,12 +122,20 @@ class TransactionParticipant : public TransactionStatusManager {
 
   void RequestStatusAt(const StatusRequest& request) override;
 
+  void RequestStatusesAt(const std::vector<StatusRequest>& requests) override;
+
   void Abort(const TransactionId& id, TransactionStatusCallback callback) override;
 
   void Handle(std::unique_ptr<tablet::UpdateTxnOperationState> request, int64_t term);
 
   void Cleanup(TransactionIdSet&& set) override;
 
+  // Waits until none of the specified transactions is running in this tablet anymore, i.e. their
+  // intents were applied or removed, or until the deadline.
+  void WaitUntilFinished(const std::vector<TransactionId>& ids, CoarseTimePoint deadline);
+
+  bool MayHaveLiveIntents() override;
+
   CHECKED_STATUS ProcessApply(const TransactionApplyData& data);
 
   // Used to pass arguments to ProcessReplicated.
@@ -82,6 +82,11 @@ DEFINE_int32(bulk_load_max_background_flushes, 2, "Number of flushes to perform
 DEFINE_uint64(bulk_load_num_files_per_tablet, 5,
               "Determines how to compact the data of a tablet to ensure we have only a certain "
               "number of sst files per tablet");
+DEFINE_bool(bulk_load_replicated_ingest, false,
+            "Ingest the exported files with a single request to the tablet leader, which is "
+            "replicated through Raft, instead of importing them on every replica separately. "
+            "Requires the helper script to place the files at the same path on all replicas. The "
+            "files are not cleaned up in this mode, since followers could still be applying it.");
 
 namespace yb {
 namespace tools {
@@ -129,6 +134,10 @@ class BulkLoad {
                                         vector<pair<TabletId, string>> rows);
   CHECKED_STATUS RetryableSubmit(vector<pair<TabletId, string>> rows);
   CHECKED_STATUS CompactFiles();
+  CHECKED_STATUS IngestReplicated(const TabletId &tablet_id,
+                                  const vector<string> &helper_output_lines,
+                                  const HostPort &leader,
+                                  rpc::ProxyCache *proxy_cache);
 
   shared_ptr<YBClient> client_;
   shared_ptr<YBTable> table_;
@@ -388,6 +397,7 @@ Status BulkLoad::FinishTabletProcessing(const TabletId &tablet_id,
   RETURN_NOT_OK(client_->GetTabletLocation(tablet_id, &tablet_locations));
   string csv_replicas;
   std::map<string, int32_t> host_to_rpcport;
+  string leader_host;
   for (const master::TabletLocationsPB_ReplicaPB &replica : tablet_locations.replicas()) {
     if (!csv_replicas.empty()) {
       csv_replicas += ",";
@@ -395,6 +405,9 @@ Status BulkLoad::FinishTabletProcessing(const TabletId &tablet_id,
     const string &host = replica.ts_info().private_rpc_addresses(0).host();
     csv_replicas += host;
     host_to_rpcport[host] = replica.ts_info().private_rpc_addresses(0).port();
+    if (replica.role() == consensus::RaftPeerPB::LEADER) {
+      leader_host = host;
+    }
   }
 
   // Invoke the bulk_load_helper script.
@@ -413,6 +426,11 @@ Status BulkLoad::FinishTabletProcessing(const TabletId &tablet_id,
   rpc::ProxyCache proxy_cache(client_messenger);
   vector<string> lines;
   boost::split(lines, bulk_load_helper_stdout, boost::is_any_of("\n"));
+  if (FLAGS_bulk_load_replicated_ingest) {
+    RETURN_NOT_OK(IngestReplicated(
+        tablet_id, lines, HostPort(leader_host, host_to_rpcport[leader_host]), &proxy_cache));
+    return yb::Env::Default()->DeleteRecursively(db_fixture_->rocksdb_dir());
+  }
   for (const string &line : lines) {
     vector<string> tokens;
     boost::split(tokens, line, boost::is_any_of(","));
@@ -447,6 +465,47 @@ Status BulkLoad::FinishTabletProcessing(const TabletId &tablet_id,
   return yb::Env::Default()->DeleteRecursively(db_fixture_->rocksdb_dir());
 }
 
+Status BulkLoad::IngestReplicated(const TabletId &tablet_id,
+                                  const vector<string> &helper_output_lines,
+                                  const HostPort &leader,
+                                  rpc::ProxyCache *proxy_cache) {
+  if (leader.host().empty()) {
+    return STATUS_SUBSTITUTE(IllegalState, "No leader found for tablet $0", tablet_id);
+  }
+
+  // Only the request is replicated, so every replica has to find the files at the same path.
+  string directory;
+  for (const string &line : helper_output_lines) {
+    vector<string> tokens;
+    boost::split(tokens, line, boost::is_any_of(","));
+    if (tokens.size() != 2) {
+      return STATUS_SUBSTITUTE(InvalidArgument, "Invalid line $0", line);
+    }
+    if (directory.empty()) {
+      directory = tokens[1];
+    } else if (directory != tokens[1]) {
+      return STATUS_SUBSTITUTE(InvalidArgument,
+                               "Replicated ingest requires the same directory on all replicas, "
+                               "found $0 and $1", directory, tokens[1]);
+    }
+  }
+
+  tserver::TabletServerServiceProxy proxy(proxy_cache, leader);
+  tserver::IngestExternalFilesRequestPB req;
+  req.set_tablet_id(tablet_id);
+  req.set_source_dir(directory);
+
+  tserver::IngestExternalFilesResponsePB resp;
+  rpc::RpcController controller;
+  LOG(INFO) << "Ingesting " << directory << " through leader " << leader.ToString()
+            << " for tablet_id: " << tablet_id;
+  RETURN_NOT_OK(proxy.IngestExternalFiles(req, &resp, &controller));
+  if (resp.has_error()) {
+    return StatusFromPB(resp.error().status());
+  }
+  return Status::OK();
+}
+
 
 CHECKED_STATUS BulkLoad::InitDBUtil(const TabletId &tablet_id) {
   db_fixture_.reset(new BulkLoadDocDBUtil(tablet_id, FLAGS_base_dir,
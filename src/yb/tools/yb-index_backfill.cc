@@ -0,0 +1,211 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+//
+// Exports the rows of a secondary index of an existing table, read from the indexed table at a
+// single hybrid time, so that the index could be backfilled with bulk built SSTs instead of
+// through the write path. The output has the format of yb-generate_partitions, i.e. each line is
+// the index tablet id and the CSV index row, so that a backfill is:
+//
+//   yb-index_backfill ... | sort | yb-bulk_load --table_name=<index> \
+//       --bulk_load_replicated_ingest ...
+//
+// The bulk loaded entries are older than any write through the write path, so the writes to the
+// indexed table after the read time, which update the index themselves, take precedence over them.
+
+#include <iostream>
+
+#include <boost/algorithm/string.hpp>
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include "yb/client/client.h"
+#include "yb/client/table_handle.h"
+#include "yb/common/hybrid_time.h"
+#include "yb/common/index.h"
+#include "yb/common/read_hybrid_time.h"
+#include "yb/common/schema.h"
+#include "yb/gutil/stringprintf.h"
+#include "yb/gutil/walltime.h"
+#include "yb/tools/bulk_load_utils.h"
+#include "yb/tools/yb-generate_partitions.h"
+#include "yb/util/flags.h"
+#include "yb/util/logging.h"
+#include "yb/util/result.h"
+
+DEFINE_string(master_addresses, "", "Comma-separated list of YB Master server addresses");
+DEFINE_string(namespace_name, "", "Namespace of the indexed table and of the index");
+DEFINE_string(table_name, "", "Name of the indexed table");
+DEFINE_string(index_name, "", "Name of the index to export the rows of");
+DEFINE_uint64(read_time_micros, 0,
+              "Physical time, in microseconds since the epoch, to read the indexed table at. 0 "
+              "uses the current time. It must be later than the time the index was created at, "
+              "so that the writes after it are indexed through the write path.");
+DEFINE_string(tablet_id, "",
+              "Only export the rows of this tablet of the indexed table, to split the export "
+              "between several processes. They should all use the same --read_time_micros.");
+
+using std::string;
+using std::vector;
+
+namespace yb {
+namespace tools {
+
+namespace {
+
+// Quotes the value, escaping the characters with a special meaning for Tokenize().
+string CsvQuote(const string& value) {
+  string result = "\"";
+  for (char c : value) {
+    switch (c) {
+      case '\\': result += "\\\\"; break;
+      case '"': result += "\\\""; break;
+      case '\n': result += "\\n"; break;
+      default: result += c; break;
+    }
+  }
+  result += '"';
+  return result;
+}
+
+// Returns the CSV field of the value, in the format that yb-bulk_load parses.
+Result<string> CsvField(const QLValue& value, DataType data_type) {
+  if (value.IsNull()) {
+    // Tokenize() unescapes it to kNullStringEscaped.
+    return string("\\\\n");
+  }
+  switch (data_type) {
+    case DataType::INT8: return std::to_string(value.int8_value());
+    case DataType::INT16: return std::to_string(value.int16_value());
+    case DataType::INT32: return std::to_string(value.int32_value());
+    case DataType::INT64: return std::to_string(value.int64_value());
+    case DataType::FLOAT: return StringPrintf("%.9g", value.float_value());
+    case DataType::DOUBLE: return StringPrintf("%.17g", value.double_value());
+    case DataType::STRING: return CsvQuote(value.string_value());
+    case DataType::BINARY: return CsvQuote(value.binary_value());
+    case DataType::TIMESTAMP:
+      // Integer timestamps are parsed as milliseconds, the precision of CQL timestamps.
+      return std::to_string(value.timestamp_value().ToInt64() / 1000);
+    default:
+      break;
+  }
+  return STATUS_FORMAT(NotSupported, "Bulk load does not support $0 columns", data_type);
+}
+
+Status ExportIndexRows() {
+  client::YBClientBuilder builder;
+  builder.add_master_server_addr(FLAGS_master_addresses);
+  std::shared_ptr<client::YBClient> client;
+  RETURN_NOT_OK(builder.Build(&client));
+
+  // Convert table names to lowercase since we store table names in lowercase.
+  client::TableHandle table;
+  RETURN_NOT_OK(table.Open(
+      client::YBTableName(FLAGS_namespace_name, boost::to_lower_copy(FLAGS_table_name)),
+      client.get()));
+  client::YBTableName index_name(FLAGS_namespace_name, boost::to_lower_copy(FLAGS_index_name));
+  std::shared_ptr<client::YBTable> index;
+  RETURN_NOT_OK(client->OpenTable(index_name, &index));
+  if (!index->IsIndex() || index->index_info().indexed_table_id() != table->id()) {
+    return STATUS_FORMAT(InvalidArgument, "$0 is not an index of $1", index_name, table.name());
+  }
+  const IndexInfo& index_info = index->index_info();
+
+  // The indexed table column, and the type, of each column of the index, in the index order.
+  struct IndexField {
+    size_t row_index;
+    DataType data_type;
+  };
+  vector<IndexField> fields;
+  vector<string> columns;
+  const Schema& index_schema = index->InternalSchema();
+  const Schema& table_schema = table->InternalSchema();
+  for (size_t i = 0; i != index_schema.num_columns(); ++i) {
+    const auto column_id = index_schema.column_id(i);
+    auto it = std::find_if(
+        index_info.columns().begin(), index_info.columns().end(),
+        [column_id](const IndexInfo::IndexColumn& column) {
+          return column.column_id == column_id;
+        });
+    if (it == index_info.columns().end()) {
+      return STATUS_FORMAT(IllegalState, "Index column $0 is not in the index info",
+                           index_schema.column(i).name());
+    }
+    if (it->is_json_path()) {
+      return STATUS_FORMAT(NotSupported, "Cannot export JSON path index column $0",
+                           index_schema.column(i).name());
+    }
+    const auto& table_column = VERIFY_RESULT(table_schema.column_by_id(it->indexed_column_id));
+    fields.push_back({columns.size(), index_schema.column(i).type_info()->type()});
+    columns.push_back(table_column.name());
+  }
+
+  YBPartitionGenerator partition_generator(index_name, {FLAGS_master_addresses});
+  RETURN_NOT_OK(partition_generator.Init());
+
+  const auto read_time = HybridTime::FromMicros(
+      FLAGS_read_time_micros != 0 ? FLAGS_read_time_micros : GetCurrentTimeMicros());
+  LOG(INFO) << "Exporting rows of " << index_name.ToString() << " as of " << read_time;
+
+  client::TableIteratorOptions options;
+  options.columns = columns;
+  options.read_time = ReadHybridTime::SingleTime(read_time);
+  options.tablet = FLAGS_tablet_id;
+  Status scan_status;
+  options.error_handler = [&scan_status](const Status& status) {
+    scan_status = status;
+  };
+
+  size_t num_rows = 0;
+  for (const auto& row : client::TableRange(table, options)) {
+    string line;
+    for (const auto& field : fields) {
+      if (!line.empty()) {
+        line += ',';
+      }
+      line += VERIFY_RESULT(CsvField(row.column(field.row_index), field.data_type));
+    }
+    string tablet_id;
+    string partition_key;
+    RETURN_NOT_OK(partition_generator.LookupTabletId(line, &tablet_id, &partition_key));
+    std::cout << tablet_id << "\t" << line << "\n";
+    ++num_rows;
+  }
+  RETURN_NOT_OK(scan_status);
+  std::cout.flush();
+
+  LOG(INFO) << "Exported " << num_rows << " rows of " << index_name.ToString() << " as of "
+            << read_time;
+  return Status::OK();
+}
+
+} // namespace
+
+} // namespace tools
+} // namespace yb
+
+int main(int argc, char** argv) {
+  yb::ParseCommandLineFlags(&argc, &argv, true);
+  yb::InitGoogleLoggingSafe(argv[0]);
+  if (FLAGS_master_addresses.empty() || FLAGS_namespace_name.empty() ||
+      FLAGS_table_name.empty() || FLAGS_index_name.empty()) {
+    LOG(FATAL) << "Need to specify --master_addresses, --namespace_name, --table_name, "
+        "--index_name";
+  }
+
+  yb::Status s = yb::tools::ExportIndexRows();
+  if (!s.ok()) {
+    LOG(FATAL) << "Error exporting index rows: " << s.ToString();
+  }
+  return 0;
+}
@@ -37,10 +37,12 @@
 #include <unordered_set>
 #include <glog/logging.h>
 
+#include "yb/common/hybrid_time.h"
 #include "yb/gutil/map-util.h"
 #include "yb/gutil/ref_counted.h"
 #include "yb/gutil/strings/join.h"
 #include "yb/gutil/strings/substitute.h"
+#include "yb/gutil/walltime.h"
 #include "yb/util/blocking_queue.h"
 #include "yb/util/locks.h"
 #include "yb/util/monotime.h"
@@ -59,14 +61,26 @@ DEFINE_int32(checksum_timeout_sec, 120,
              "before timing out.");
 DEFINE_int32(checksum_scan_concurrency, 4,
              "Number of concurrent checksum scans to execute per tablet server.");
+DEFINE_bool(checksum_snapshot, true,
+            "Whether all the replicas are checksummed as of the same hybrid time.");
+DEFINE_uint64(checksum_snapshot_hybrid_time, 0,
+              "Hybrid time to checksum the replicas as of, when --checksum_snapshot is set. "
+              "0 uses the current time.");
+
+const uint64_t ChecksumOptions::kCurrentHybridTime = 0;
 
 ChecksumOptions::ChecksumOptions()
     : timeout(MonoDelta::FromSeconds(FLAGS_checksum_timeout_sec)),
-      scan_concurrency(FLAGS_checksum_scan_concurrency) {}
+      scan_concurrency(FLAGS_checksum_scan_concurrency),
+      use_snapshot(FLAGS_checksum_snapshot),
+      snapshot_hybrid_time(FLAGS_checksum_snapshot_hybrid_time) {}
 
-ChecksumOptions::ChecksumOptions(MonoDelta timeout, int scan_concurrency)
+ChecksumOptions::ChecksumOptions(MonoDelta timeout, int scan_concurrency, bool use_snapshot,
+                                 uint64_t snapshot_hybrid_time)
     : timeout(std::move(timeout)),
-      scan_concurrency(scan_concurrency) {}
+      scan_concurrency(scan_concurrency),
+      use_snapshot(use_snapshot),
+      snapshot_hybrid_time(snapshot_hybrid_time) {}
 
 YsckCluster::~YsckCluster() {
 }
@@ -273,6 +287,12 @@ Status Ysck::ChecksumData(const vector<string>& tables,
 
   // Copy options so that local modifications can be made and passed on.
   ChecksumOptions options = opts;
+  if (options.use_snapshot && options.snapshot_hybrid_time == ChecksumOptions::kCurrentHybridTime) {
+    // The replicas wait for their safe time to reach the snapshot, so a clock ahead of those of the
+    // servers only delays the scans.
+    options.snapshot_hybrid_time = HybridTime::FromMicros(GetCurrentTimeMicros()).ToUint64();
+    LOG(INFO) << "Using snapshot hybrid time " << HybridTime(options.snapshot_hybrid_time);
+  }
 
   typedef unordered_map<shared_ptr<YsckTablet>, std::vector<shared_ptr<YsckTable>>> TabletTableMap;
   TabletTableMap tablet_table_map;
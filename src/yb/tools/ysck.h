@@ -56,13 +56,23 @@ struct ChecksumOptions {
 
   ChecksumOptions();
 
-  ChecksumOptions(MonoDelta timeout, int scan_concurrency);
+  ChecksumOptions(MonoDelta timeout, int scan_concurrency, bool use_snapshot = true,
+                  uint64_t snapshot_hybrid_time = kCurrentHybridTime);
 
   // The maximum total time to wait for results to come back from all replicas.
   MonoDelta timeout;
 
   // The maximum number of concurrent checksum scans to run per tablet server.
   int scan_concurrency;
+
+  // Whether all the replicas are checksummed as of the same hybrid time, so that the writes made
+  // while the replicas are scanned do not show up as mismatches.
+  bool use_snapshot;
+
+  // The hybrid time of the snapshot, or kCurrentHybridTime for the time the checksum starts at.
+  uint64_t snapshot_hybrid_time;
+
+  static const uint64_t kCurrentHybridTime;
 };
 
 // Representation of a tablet replica on a tablet server.
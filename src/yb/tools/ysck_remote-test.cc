@@ -254,35 +254,19 @@ TEST_F(RemoteYsckTest, TestChecksumSnapshot) {
   CHECK(started_writing.WaitFor(MonoDelta::FromSeconds(30)));
 
   uint64_t ts = client_->GetLatestObservedHybridTime();
-  MonoTime start(MonoTime::Now());
-  MonoTime deadline = start;
-  deadline.AddDelta(MonoDelta::FromSeconds(30));
-  Status s;
-  // TODO: We need to loop here because safe time is not yet implemented.
-  // Remove this loop when that is done. See KUDU-1056.
-  while (true) {
-    ASSERT_OK(ysck_->FetchTableAndTabletInfo());
-    Status s = ysck_->ChecksumData(vector<string>(), vector<string>(),
-                                   ChecksumOptions(MonoDelta::FromSeconds(10), 16));
-    if (s.ok()) break;
-    if (deadline.ComesBefore(MonoTime::Now())) break;
-    SleepFor(MonoDelta::FromMilliseconds(10));
-  }
-  if (!s.ok()) {
-    LOG(WARNING) << Substitute("Timed out after $0 waiting for ysck to become consistent on TS $1. "
-                               "Status: $2",
-                               MonoTime::Now().GetDeltaSince(start).ToString(),
-                               ts, s.ToString());
-    EXPECT_OK(s); // To avoid ASAN complaints due to thread reading the CountDownLatch.
-  }
+  ASSERT_OK(ysck_->FetchTableAndTabletInfo());
+  Status s = ysck_->ChecksumData(vector<string>(), vector<string>(),
+                                 ChecksumOptions(MonoDelta::FromSeconds(10), 16, true, ts));
+  // To avoid ASAN complaints due to thread reading the CountDownLatch.
+  EXPECT_OK(s);
   continue_writing.Store(false);
   ASSERT_OK(promise.Get());
   writer_thread->Join();
 }
 
 // Test that followers & leader wait until safe time to respond to a snapshot
-// scan at current hybrid_time. TODO: Safe time not yet implemented. See KUDU-1056.
-TEST_F(RemoteYsckTest, DISABLED_TestChecksumSnapshotCurrentHybridTime) {
+// scan at current hybrid_time.
+TEST_F(RemoteYsckTest, TestChecksumSnapshotCurrentHybridTime) {
   CountDownLatch started_writing(1);
   AtomicBool continue_writing(true);
   Promise<Status> promise;
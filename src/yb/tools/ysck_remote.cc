@@ -32,6 +32,7 @@
 
 #include "yb/tools/ysck_remote.h"
 
+#include "yb/common/read_hybrid_time.h"
 #include "yb/common/schema.h"
 #include "yb/common/wire_protocol.h"
 #include "yb/gutil/map-util.h"
@@ -146,7 +147,12 @@ class ChecksumStepper {
   void SendRequest() {
     req_.set_tablet_id(tablet_id_);
     req_.set_consistency_level(YBConsistencyLevel::CONSISTENT_PREFIX);
-    rpc_.set_timeout(GetDefaultTimeout());
+    if (options_.use_snapshot) {
+      ReadHybridTime::FromUint64(options_.snapshot_hybrid_time).AddToPB(&req_);
+    }
+    // The replica reads the whole tablet before it responds, which could take a lot longer than
+    // the other requests.
+    rpc_.set_timeout(std::max(GetDefaultTimeout(), options_.timeout));
     auto handler = std::make_unique<ChecksumCallbackHandler>(this);
     rpc::ResponseCallback cb = std::bind(&ChecksumCallbackHandler::Run, handler.get());
     proxy_->ChecksumAsync(req_, &resp_, &rpc_, cb);
@@ -35,6 +35,7 @@
 #include <memory>
 #include <vector>
 #include <mutex>
+#include <unordered_map>
 
 #include <gflags/gflags.h>
 #include <glog/logging.h>
@@ -48,6 +49,7 @@
 #include "yb/server/server_base.proxy.h"
 #include "yb/server/webserver.h"
 #include "yb/tablet/tablet.h"
+#include "yb/tablet/tablet_metrics.h"
 #include "yb/tserver/tablet_server.h"
 #include "yb/tserver/tablet_server_options.h"
 #include "yb/tserver/ts_tablet_manager.h"
@@ -125,6 +127,10 @@ class Heartbeater::Thread {
   void SetupCommonField(master::TSToMasterCommonPB* common);
   bool IsCurrentThread() const;
   uint64_t CalculateUptime();
+  void AddTabletLeaderMetrics(tablet::Tablet* tablet,
+                              const MonoDelta& interval,
+                              std::unordered_map<TabletId, uint64_t>* tablet_writes,
+                              master::TSHeartbeatRequestPB* req);
 
   const std::string& LogPrefix() const {
     return log_prefix_;
@@ -190,6 +196,9 @@ class Heartbeater::Thread {
   uint64_t prev_reads_ = 0;
   uint64_t prev_writes_ = 0;
 
+  // Stores the writes of each tablet led by this ts, for computing its write ops.
+  std::unordered_map<TabletId, uint64_t> prev_tablet_writes_;
+
   MonoTime start_time_;
 
   rpc::Rpcs rpcs_;
@@ -351,6 +360,28 @@ uint64_t Heartbeater::Thread::CalculateUptime() {
   return uptime_seconds;
 }
 
+// Reports size and write ops of a tablet led by this ts, so master could find tablets to split.
+void Heartbeater::Thread::AddTabletLeaderMetrics(
+    tablet::Tablet* tablet,
+    const MonoDelta& interval,
+    std::unordered_map<TabletId, uint64_t>* tablet_writes,
+    master::TSHeartbeatRequestPB* req) {
+  auto* metrics = tablet->metrics();
+  uint64_t num_writes = metrics->write_op_duration_client_propagated_consistency->TotalCount() +
+                        metrics->write_op_duration_commit_wait_consistency->TotalCount();
+  const TabletId& tablet_id = tablet->tablet_id();
+  (*tablet_writes)[tablet_id] = num_writes;
+
+  auto* tablet_metrics = req->mutable_metrics()->add_tablet_leader_metrics();
+  tablet_metrics->set_tablet_id(tablet_id);
+  tablet_metrics->set_sst_file_size(tablet->GetTotalSSTFileSizes());
+  // Rate is only known for tablets that we already led during the previous interval.
+  auto it = prev_tablet_writes_.find(tablet_id);
+  if (it != prev_tablet_writes_.end() && interval.ToSeconds() > 0 && num_writes >= it->second) {
+    tablet_metrics->set_write_ops_per_sec((num_writes - it->second) / interval.ToSeconds());
+  }
+}
+
 Status Heartbeater::Thread::TryHeartbeat() {
   master::TSHeartbeatRequestPB req;
 
@@ -391,6 +422,8 @@ Status Heartbeater::Thread::TryHeartbeat() {
     std::vector<shared_ptr<yb::tablet::TabletPeer> > tablet_peers;
     uint64_t total_file_sizes = 0;
     uint64_t uncompressed_file_sizes = 0;
+    MonoDelta metrics_interval = MonoTime::Now() - prev_tserver_metrics_submission_;
+    std::unordered_map<TabletId, uint64_t> tablet_writes;
     server_->tablet_manager()->GetTabletPeers(&tablet_peers);
     for (auto it = tablet_peers.begin(); it != tablet_peers.end(); it++) {
       shared_ptr<yb::tablet::TabletPeer> tablet_peer = *it;
@@ -398,8 +431,12 @@ Status Heartbeater::Thread::TryHeartbeat() {
         shared_ptr<yb::tablet::TabletClass> tablet_class = tablet_peer->shared_tablet();
         total_file_sizes += (tablet_class) ? tablet_class->GetTotalSSTFileSizes() : 0;
         uncompressed_file_sizes += (tablet_class) ? tablet_class->GetUncompressedSSTFileSizes() : 0;
+        if (tablet_class && tablet_peer->LeaderStatus() != consensus::LeaderStatus::NOT_LEADER) {
+          AddTabletLeaderMetrics(tablet_class.get(), metrics_interval, &tablet_writes, &req);
+        }
       }
     }
+    prev_tablet_writes_.swap(tablet_writes);
     req.mutable_metrics()->set_total_sst_file_size(total_file_sizes);
     req.mutable_metrics()->set_uncompressed_sst_file_size(uncompressed_file_sizes);
 
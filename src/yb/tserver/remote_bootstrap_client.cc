@@ -32,6 +32,8 @@
 
 #include "yb/tserver/remote_bootstrap_client.h"
 
+#include <unordered_set>
+
 #include <gflags/gflags.h>
 #include <glog/logging.h>
 
@@ -43,6 +45,7 @@
 #include "yb/gutil/strings/substitute.h"
 #include "yb/gutil/strings/util.h"
 #include "yb/gutil/walltime.h"
+#include "yb/rpc/compression.h"
 #include "yb/rpc/messenger.h"
 #include "yb/rpc/rpc_controller.h"
 #include "yb/tablet/tablet.pb.h"
@@ -61,7 +64,9 @@
 #include "yb/util/flag_tags.h"
 #include "yb/util/net/net_util.h"
 #include "yb/util/net/rate_limiter.h"
+#include "yb/util/pb_util.h"
 #include "yb/util/size_literals.h"
+#include "yb/util/threadpool.h"
 
 using namespace yb::size_literals;
 
@@ -109,10 +114,22 @@ DEFINE_int64(remote_boostrap_rate_limit_bytes_per_sec, 100_MB,
              "the total limit will be 2 * remote_boostrap_rate_limit_bytes_per_sec because a "
              "tserver or master can act both as a sender and receiver at the same time.");
 
+DEFINE_int32(remote_bootstrap_max_concurrent_file_downloads, 4,
+             "Maximum number of RocksDB files that a remote bootstrap session downloads "
+             "concurrently. The rate limit is shared by all downloads in flight, so this helps "
+             "when a single stream is bounded by the round trip of each chunk.");
+TAG_FLAG(remote_bootstrap_max_concurrent_file_downloads, advanced);
+
 DEFINE_int32(bytes_remote_bootstrap_durable_write_mb, 8,
              "Explicitly call fsync after downloading the specified amount of data in MB "
              "during a remote bootstrap session. If 0 fsync() is not called.");
 
+DEFINE_bool(remote_bootstrap_resume, true,
+            "Whether the RocksDB files downloaded by a remote bootstrap session that fails are "
+            "kept, so that the next session from the same peer does not download them again.");
+TAG_FLAG(remote_bootstrap_resume, advanced);
+TAG_FLAG(remote_bootstrap_resume, runtime);
+
 // RETURN_NOT_OK_PREPEND() with a remote-error unwinding step.
 #define RETURN_NOT_OK_UNWIND_PREPEND(status, controller, msg) \
   RETURN_NOT_OK_PREPEND(UnwindRemoteError(status, controller), msg)
@@ -137,8 +154,51 @@ using tablet::TabletMetadata;
 using tablet::TabletStatusListener;
 using tablet::TabletSuperBlockPB;
 
+namespace {
+
+const char* const kResumeManifestFileName = "RESUME-MANIFEST";
+
+Result<uint32_t> ComputeFileCrc32(Env* env, const std::string& path) {
+  gscoped_ptr<SequentialFile> file;
+  RETURN_NOT_OK(env->NewSequentialFile(path, &file));
+  std::vector<uint8_t> scratch(1_MB);
+  uint32_t crc32 = 0;
+  for (;;) {
+    Slice slice;
+    RETURN_NOT_OK(file->Read(scratch.size(), &slice, scratch.data()));
+    if (slice.empty()) {
+      break;
+    }
+    crc32 = crc::Crc32cExtend(crc32, slice.data(), slice.size());
+  }
+  return crc32;
+}
+
+} // namespace
+
 constexpr int kBytesReservedForMessageHeaders = 16384;
 std::atomic<int32_t> RemoteBootstrapClient::n_started_(0);
+std::atomic<int32_t> RemoteBootstrapClient::n_downloads_(0);
+
+namespace {
+
+class ScopedDownloadCounter {
+ public:
+  explicit ScopedDownloadCounter(std::atomic<int32_t>* counter) : counter_(counter) {
+    counter_->fetch_add(1, std::memory_order_acq_rel);
+  }
+
+  ~ScopedDownloadCounter() {
+    counter_->fetch_sub(1, std::memory_order_acq_rel);
+  }
+
+ private:
+  std::atomic<int32_t>* const counter_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScopedDownloadCounter);
+};
+
+} // namespace
 
 RemoteBootstrapClient::RemoteBootstrapClient(std::string tablet_id,
                                              FsManager* fs_manager,
@@ -216,6 +276,7 @@ Status RemoteBootstrapClient::Start(const string& bootstrap_peer_uuid,
                                     TSTabletManager* ts_manager) {
   CHECK(!started_);
   start_time_micros_ = GetCurrentTimeMicros();
+  bootstrap_peer_uuid_ = bootstrap_peer_uuid;
 
   LOG_WITH_PREFIX(INFO) << "Beginning remote bootstrap session"
                         << " from remote peer at address " << bootstrap_peer_addr.ToString();
@@ -226,6 +287,7 @@ Status RemoteBootstrapClient::Start(const string& bootstrap_peer_uuid,
   BeginRemoteBootstrapSessionRequestPB req;
   req.set_requestor_uuid(permanent_uuid_);
   req.set_tablet_id(tablet_id_);
+  req.set_accepted_compression(rpc::RPC_COMPRESSION_LZ4);
 
   rpc::RpcController controller;
   controller.set_timeout(MonoDelta::FromMilliseconds(
@@ -430,6 +492,13 @@ Status RemoteBootstrapClient::Finish() {
 
   succeeded_ = true;
 
+  // The tablet is now ready, so there is nothing left to resume.
+  const auto resume_dir = ResumeDir();
+  if (fs_manager_->env()->FileExists(resume_dir)) {
+    WARN_NOT_OK(fs_manager_->env()->DeleteRecursively(resume_dir),
+                "Unable to delete remote bootstrap resume directory " + resume_dir);
+  }
+
   MAYBE_FAULT(FLAGS_fault_crash_bootstrap_client_before_changing_role);
 
   RETURN_NOT_OK_PREPEND(EndRemoteSession(), "Error closing remote bootstrap session " +
@@ -589,32 +658,48 @@ Status RemoteBootstrapClient::DownloadFile(
   RETURN_NOT_OK(fs_manager_->env()->CreateDirs(DirName(file_path)));
 
   if (file_pb.inode() != 0) {
-    auto it = inode2file_.find(file_pb.inode());
-    if (it != inode2file_.end()) {
+    std::string linked_file;
+    {
+      std::lock_guard<std::mutex> lock(inode2file_mutex_);
+      auto it = inode2file_.find(file_pb.inode());
+      if (it != inode2file_.end()) {
+        linked_file = it->second;
+      }
+    }
+    if (!linked_file.empty()) {
       VLOG_WITH_PREFIX(2) << "File with the same inode already found: " << file_path
-                          << " => " << it->second;
-      auto link_status = fs_manager_->env()->LinkFile(it->second, file_path);
+                          << " => " << linked_file;
+      auto link_status = fs_manager_->env()->LinkFile(linked_file, file_path);
       if (link_status.ok()) {
         return Status::OK();
       }
       // TODO fallback to copy.
-      LOG_WITH_PREFIX(ERROR) << "Failed to link file: " << file_path << " => " << it->second
+      LOG_WITH_PREFIX(ERROR) << "Failed to link file: " << file_path << " => " << linked_file
                              << ": " << link_status;
     }
   }
 
-  WritableFileOptions opts;
-  opts.sync_on_close = true;
-  gscoped_ptr<WritableFile> file;
-  RETURN_NOT_OK(fs_manager_->env()->NewWritableFile(opts, file_path, &file));
-
-  data_id->set_file_name(file_pb.name());
-  RETURN_NOT_OK_PREPEND(DownloadFile(*data_id, file.get()),
-                        Format("Unable to download $0 file $1",
-                               DataIdPB::IdType_Name(data_id->type()), file_path));
-  VLOG_WITH_PREFIX(2) << "Downloaded file " << file_path;
+  if (VERIFY_RESULT(ResumeFile(file_pb, file_path))) {
+    VLOG_WITH_PREFIX(2) << "Resumed file " << file_path;
+  } else {
+    WritableFileOptions opts;
+    opts.sync_on_close = true;
+    gscoped_ptr<WritableFile> file;
+    RETURN_NOT_OK(fs_manager_->env()->NewWritableFile(opts, file_path, &file));
+
+    data_id->set_file_name(file_pb.name());
+    uint64_t crc32 = 0;
+    RETURN_NOT_OK_PREPEND(DownloadFile(*data_id, file.get(), &crc32),
+                          Format("Unable to download $0 file $1",
+                                 DataIdPB::IdType_Name(data_id->type()), file_path));
+    // The file has to be durable before it is recorded as downloaded.
+    RETURN_NOT_OK(file->Close());
+    VLOG_WITH_PREFIX(2) << "Downloaded file " << file_path;
+    AddToResumeManifest(file_pb, file_path, static_cast<uint32_t>(crc32));
+  }
 
   if (file_pb.inode() != 0) {
+    std::lock_guard<std::mutex> lock(inode2file_mutex_);
     inode2file_.emplace(file_pb.inode(), file_path);
   }
 
@@ -641,15 +726,22 @@ Status RemoteBootstrapClient::DownloadRocksDBFiles() {
   new_sb->set_rocksdb_dir(rocksdb_dir);
 
   RETURN_NOT_OK(CreateTabletDirectories(rocksdb_dir, meta_->fs_manager()));
+  RETURN_NOT_OK(LoadResumeManifest());
 
-  DataIdPB data_id;
-  data_id.set_type(DataIdPB::ROCKSDB_FILE);
+  // Files that share an inode with an earlier file are linked to it after it is downloaded.
+  std::vector<const tablet::FilePB*> files;
+  std::vector<const tablet::FilePB*> linked_files;
+  std::unordered_set<uint64_t> inodes;
   for (auto const& file_pb : new_sb->rocksdb_files()) {
-    auto start = MonoTime::Now();
-    RETURN_NOT_OK(DownloadFile(file_pb, rocksdb_dir, &data_id));
-    auto elapsed = MonoTime::Now().GetDeltaSince(start);
-    LOG(INFO) << "Downloaded file " << file_pb.name() << " of size " << file_pb.size_bytes()
-              << " in " << elapsed.ToSeconds() << " seconds";
+    if (file_pb.inode() != 0 && !inodes.insert(file_pb.inode()).second) {
+      linked_files.push_back(&file_pb);
+    } else {
+      files.push_back(&file_pb);
+    }
+  }
+  RETURN_NOT_OK(DownloadRocksDBFilesConcurrently(files, rocksdb_dir));
+  for (const auto* file_pb : linked_files) {
+    RETURN_NOT_OK(DownloadRocksDBFile(*file_pb, rocksdb_dir));
   }
 
   // To avoid adding new file type to remote bootstrap we move intents as subdir of regular DB.
@@ -668,6 +760,176 @@ Status RemoteBootstrapClient::DownloadRocksDBFiles() {
   return Status::OK();
 }
 
+std::string RemoteBootstrapClient::ResumeDir() const {
+  return meta_->rocksdb_dir() + tablet::kRemoteBootstrapResumeDirSuffix;
+}
+
+std::string RemoteBootstrapClient::ResumeManifestPath() const {
+  return JoinPathSegments(ResumeDir(), kResumeManifestFileName);
+}
+
+Status RemoteBootstrapClient::LoadResumeManifest() {
+  auto* env = fs_manager_->env();
+  const auto resume_dir = ResumeDir();
+  resumable_files_.clear();
+  {
+    std::lock_guard<std::mutex> lock(resume_manifest_mutex_);
+    resume_manifest_.Clear();
+    resume_manifest_.set_source_uuid(bootstrap_peer_uuid_);
+  }
+
+  RemoteBootstrapResumeManifestPB old_manifest;
+  auto status = FLAGS_remote_bootstrap_resume
+      ? pb_util::ReadPBContainerFromPath(env, ResumeManifestPath(), &old_manifest)
+      : STATUS(NotFound, "Remote bootstrap resumption is disabled");
+  if (!status.ok() && !status.IsNotFound()) {
+    LOG_WITH_PREFIX(WARNING) << "Unable to read remote bootstrap resume manifest: " << status;
+  }
+  if (status.ok() && old_manifest.source_uuid() == bootstrap_peer_uuid_) {
+    std::unordered_map<std::string, const tablet::FilePB*> files;
+    for (const auto& file_pb : superblock_->rocksdb_files()) {
+      files.emplace(file_pb.name(), &file_pb);
+    }
+    for (const auto& entry : old_manifest.files()) {
+      auto it = files.find(entry.file().name());
+      if (it != files.end() && it->second->size_bytes() == entry.file().size_bytes() &&
+          it->second->inode() == entry.file().inode()) {
+        resumable_files_.emplace(entry.file().name(), entry);
+      } else {
+        const auto path = JoinPathSegments(resume_dir, entry.file().name());
+        WARN_NOT_OK(env->DeleteFile(path), "Unable to delete stale resumable file " + path);
+      }
+    }
+  }
+
+  if (resumable_files_.empty()) {
+    if (env->FileExists(resume_dir)) {
+      RETURN_NOT_OK_PREPEND(env->DeleteRecursively(resume_dir),
+                            "Unable to delete remote bootstrap resume directory " + resume_dir);
+    }
+    return Status::OK();
+  }
+
+  LOG_WITH_PREFIX(INFO) << "Resuming " << resumable_files_.size() << " of "
+                        << superblock_->rocksdb_files_size()
+                        << " RocksDB files downloaded by an earlier session";
+  std::lock_guard<std::mutex> lock(resume_manifest_mutex_);
+  for (const auto& entry : resumable_files_) {
+    *resume_manifest_.add_files() = entry.second;
+  }
+  return pb_util::WritePBContainerToPath(
+      env, ResumeManifestPath(), resume_manifest_, pb_util::OVERWRITE, pb_util::SYNC);
+}
+
+Result<bool> RemoteBootstrapClient::ResumeFile(
+    const tablet::FilePB& file_pb, const std::string& file_path) {
+  auto it = resumable_files_.find(file_pb.name());
+  if (it == resumable_files_.end()) {
+    return false;
+  }
+  auto* env = fs_manager_->env();
+  const auto resume_path = JoinPathSegments(ResumeDir(), file_pb.name());
+  auto size = env->GetFileSize(resume_path);
+  auto crc32 = size.ok() ? ComputeFileCrc32(env, resume_path) : Result<uint32_t>(size.status());
+  if (!crc32.ok() || *size != file_pb.size_bytes() || *crc32 != it->second.crc32()) {
+    LOG_WITH_PREFIX(WARNING) << "Downloading again file " << file_pb.name()
+                             << " of an earlier session, which does not match its manifest: "
+                             << (crc32.ok() ? "size or checksum differs"
+                                            : crc32.status().ToString());
+    return false;
+  }
+  if (env->FileExists(file_path)) {
+    RETURN_NOT_OK(env->DeleteFile(file_path));
+  }
+  RETURN_NOT_OK(env->LinkFile(resume_path, file_path));
+  return true;
+}
+
+void RemoteBootstrapClient::AddToResumeManifest(
+    const tablet::FilePB& file_pb, const std::string& file_path, uint32_t crc32) {
+  if (!FLAGS_remote_bootstrap_resume) {
+    return;
+  }
+  auto* env = fs_manager_->env();
+  const auto resume_path = JoinPathSegments(ResumeDir(), file_pb.name());
+  auto status = env->CreateDirs(DirName(resume_path));
+  if (status.ok() && env->FileExists(resume_path)) {
+    status = env->DeleteFile(resume_path);
+  }
+  if (status.ok()) {
+    status = env->LinkFile(file_path, resume_path);
+  }
+  if (status.ok()) {
+    std::lock_guard<std::mutex> lock(resume_manifest_mutex_);
+    auto* entry = resume_manifest_.add_files();
+    *entry->mutable_file() = file_pb;
+    entry->set_crc32(crc32);
+    status = pb_util::WritePBContainerToPath(
+        env, ResumeManifestPath(), resume_manifest_, pb_util::OVERWRITE, pb_util::SYNC);
+  }
+  if (!status.ok()) {
+    LOG_WITH_PREFIX(WARNING) << "Unable to keep " << file_path << " for a later session: "
+                             << status;
+  }
+}
+
+Status RemoteBootstrapClient::DownloadRocksDBFilesConcurrently(
+    const std::vector<const tablet::FilePB*>& files, const std::string& rocksdb_dir) {
+  const auto max_threads = std::min<size_t>(
+      std::max(FLAGS_remote_bootstrap_max_concurrent_file_downloads, 1), files.size());
+  if (max_threads <= 1) {
+    for (const auto* file_pb : files) {
+      RETURN_NOT_OK(DownloadRocksDBFile(*file_pb, rocksdb_dir));
+    }
+    return Status::OK();
+  }
+
+  std::unique_ptr<ThreadPool> pool;
+  RETURN_NOT_OK(ThreadPoolBuilder("rb-download").set_max_threads(max_threads).Build(&pool));
+
+  std::mutex mutex;
+  Status result;
+  std::atomic<bool> failed(false);
+  Status submit_status;
+  for (const auto* file_pb : files) {
+    submit_status = pool->SubmitFunc([this, file_pb, &rocksdb_dir, &mutex, &result, &failed]() {
+      if (failed.load(std::memory_order_acquire)) {
+        return;
+      }
+      auto status = DownloadRocksDBFile(*file_pb, rocksdb_dir);
+      if (!status.ok()) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (result.ok()) {
+          result = status;
+        }
+        failed.store(true, std::memory_order_release);
+      }
+    });
+    if (!submit_status.ok()) {
+      failed.store(true, std::memory_order_release);
+      break;
+    }
+  }
+  // The tasks refer to the locals of this function, so they have to complete before returning.
+  pool->Wait();
+  pool->Shutdown();
+
+  RETURN_NOT_OK(submit_status);
+  return result;
+}
+
+Status RemoteBootstrapClient::DownloadRocksDBFile(
+    const tablet::FilePB& file_pb, const std::string& rocksdb_dir) {
+  DataIdPB data_id;
+  data_id.set_type(DataIdPB::ROCKSDB_FILE);
+  auto start = MonoTime::Now();
+  RETURN_NOT_OK(DownloadFile(file_pb, rocksdb_dir, &data_id));
+  auto elapsed = MonoTime::Now().GetDeltaSince(start);
+  LOG(INFO) << "Downloaded file " << file_pb.name() << " of size " << file_pb.size_bytes()
+            << " in " << elapsed.ToSeconds() << " seconds";
+  return Status::OK();
+}
+
 Status RemoteBootstrapClient::DownloadWAL(uint64_t wal_segment_seqno) {
   VLOG_WITH_PREFIX(1) << "Downloading WAL segment with seqno " << wal_segment_seqno;
   DataIdPB data_id;
@@ -720,7 +982,8 @@ Status RemoteBootstrapClient::WriteConsensusMetadata() {
 
 template<class Appendable>
 Status RemoteBootstrapClient::DownloadFile(const DataIdPB& data_id,
-                                           Appendable* appendable) {
+                                           Appendable* appendable,
+                                           uint64_t* crc32) {
   // For periodic sync, indicates number of bytes which need to be sync'ed.
   size_t periodic_sync_unsynced_bytes = 0;
   uint64_t offset = 0;
@@ -728,14 +991,17 @@ Status RemoteBootstrapClient::DownloadFile(const DataIdPB& data_id,
                                 FLAGS_rpc_max_message_size - kBytesReservedForMessageHeaders);
 
   std::unique_ptr<RateLimiter> rate_limiter;
+  ScopedDownloadCounter download_counter(&n_downloads_);
 
   if (FLAGS_remote_boostrap_rate_limit_bytes_per_sec > 0) {
     static auto rate_updater = []() {
-      if (n_started_.load(std::memory_order_acquire) < 1) {
-        YB_LOG_EVERY_N(ERROR, 100) << "Invalid number of remote bootstrap sessions: " << n_started_;
+      auto n_downloads = n_downloads_.load(std::memory_order_acquire);
+      if (n_downloads < 1) {
+        YB_LOG_EVERY_N(ERROR, 100) << "Invalid number of remote bootstrap downloads: "
+                                   << n_downloads;
         return static_cast<uint64_t>(FLAGS_remote_boostrap_rate_limit_bytes_per_sec);
       }
-      return static_cast<uint64_t>(FLAGS_remote_boostrap_rate_limit_bytes_per_sec / n_started_);
+      return static_cast<uint64_t>(FLAGS_remote_boostrap_rate_limit_bytes_per_sec / n_downloads);
     };
 
     rate_limiter = std::make_unique<RateLimiter>(rate_updater);
@@ -747,6 +1013,7 @@ Status RemoteBootstrapClient::DownloadFile(const DataIdPB& data_id,
   rpc::RpcController controller;
   controller.set_timeout(MonoDelta::FromMilliseconds(session_idle_timeout_millis_));
   FetchDataRequestPB req;
+  std::vector<char> decompressed;
 
   bool done = false;
   while (!done) {
@@ -774,17 +1041,30 @@ Status RemoteBootstrapClient::DownloadFile(const DataIdPB& data_id,
     RETURN_NOT_OK_PREPEND(VerifyData(offset, resp.chunk()),
                           Substitute("Error validating data item $0", data_id.ShortDebugString()));
 
+    Slice data(resp.chunk().data());
+    if (resp.chunk().compression() != rpc::RPC_COMPRESSION_NONE) {
+      RETURN_NOT_OK_PREPEND(
+          rpc::DecompressPayload(resp.chunk().compression(), data,
+                                 resp.chunk().uncompressed_length(), nullptr, &decompressed),
+          Substitute("Error decompressing data item $0", data_id.ShortDebugString()));
+      data = Slice(decompressed.data(), decompressed.size());
+    }
+
     // Write the data.
-    RETURN_NOT_OK(appendable->Append(resp.chunk().data()));
+    RETURN_NOT_OK(appendable->Append(data));
+    if (crc32) {
+      *crc32 = crc::Crc32cExtend(static_cast<uint32_t>(*crc32), data.data(), data.size());
+    }
     VLOG(3) << "resp size: " << resp.ByteSize()
-            << ", chunk size: " << resp.chunk().data().size();
+            << ", chunk size: " << resp.chunk().data().size()
+            << ", uncompressed chunk size: " << data.size();
 
-    if (offset + resp.chunk().data().size() == resp.chunk().total_data_length()) {
+    if (offset + data.size() == resp.chunk().total_data_length()) {
       done = true;
     }
-    offset += resp.chunk().data().size();
+    offset += data.size();
     if (FLAGS_bytes_remote_bootstrap_durable_write_mb != 0) {
-      periodic_sync_unsynced_bytes += resp.chunk().data().size();
+      periodic_sync_unsynced_bytes += data.size();
       if (periodic_sync_unsynced_bytes > FLAGS_bytes_remote_bootstrap_durable_write_mb * 1_MB) {
         RETURN_NOT_OK(appendable->Sync());
         periodic_sync_unsynced_bytes = 0;
@@ -35,6 +35,7 @@
 #include <atomic>
 #include <string>
 #include <memory>
+#include <mutex>
 #include <vector>
 #include <unordered_map>
 
@@ -46,6 +47,7 @@
 #include "yb/gutil/ref_counted.h"
 #include "yb/rpc/rpc_fwd.h"
 #include "yb/tserver/remote_bootstrap.pb.h"
+#include "yb/util/result.h"
 #include "yb/util/status.h"
 
 namespace yb {
@@ -134,6 +136,7 @@ class RemoteBootstrapClient {
  protected:
   FRIEND_TEST(RemoteBootstrapRocksDBClientTest, TestBeginEndSession);
   FRIEND_TEST(RemoteBootstrapRocksDBClientTest, TestDownloadRocksDBFiles);
+  FRIEND_TEST(RemoteBootstrapRocksDBClientTest, TestResumeRocksDBFiles);
 
   // Extract the embedded Status message from the given ErrorStatusPB.
   // The given ErrorStatusPB must extend RemoteBootstrapErrorPB.
@@ -169,17 +172,44 @@ class RemoteBootstrapClient {
   // Only used in one compilation unit, otherwise the implementation would
   // need to be in the header.
   template<class Appendable>
-  CHECKED_STATUS DownloadFile(const DataIdPB& data_id, Appendable* appendable);
+  CHECKED_STATUS DownloadFile(const DataIdPB& data_id, Appendable* appendable,
+                              uint64_t* crc32 = nullptr);
 
   virtual CHECKED_STATUS CreateTabletDirectories(const string& db_dir, FsManager* fs);
 
   CHECKED_STATUS DownloadRocksDBFiles();
 
+  // Downloads 'files' using up to remote_bootstrap_max_concurrent_file_downloads threads.
+  CHECKED_STATUS DownloadRocksDBFilesConcurrently(
+      const std::vector<const tablet::FilePB*>& files, const std::string& rocksdb_dir);
+
+  CHECKED_STATUS DownloadRocksDBFile(const tablet::FilePB& file_pb, const std::string& rocksdb_dir);
+
   CHECKED_STATUS VerifyData(uint64_t offset, const DataChunkPB& resp);
 
   CHECKED_STATUS DownloadFile(
       const tablet::FilePB& file_pb, const std::string& dir, DataIdPB* data_id);
 
+  // Directory where the downloaded RocksDB files are linked until the remote bootstrap completes,
+  // so that they survive the tombstoning of the tablet if it fails.
+  std::string ResumeDir() const;
+
+  std::string ResumeManifestPath() const;
+
+  // Loads the manifest of the resume directory, keeping the files that are part of the checkpoint
+  // of the current session.
+  CHECKED_STATUS LoadResumeManifest();
+
+  // Links the file described by 'file_pb' from the resume directory to 'file_path', if it was
+  // downloaded by an earlier session and its size and checksum still match. Returns whether it
+  // did.
+  Result<bool> ResumeFile(const tablet::FilePB& file_pb, const std::string& file_path);
+
+  // Keeps the file downloaded to 'file_path' in the resume directory. Errors are only logged,
+  // since they just make a later session download the file again.
+  void AddToResumeManifest(
+      const tablet::FilePB& file_pb, const std::string& file_path, uint32_t crc32);
+
   // Return standard log prefix.
   std::string LogPrefix();
 
@@ -190,9 +220,11 @@ class RemoteBootstrapClient {
 
   // State flags that enforce the progress of remote bootstrap.
   bool started_;            // Session started.
-  // Total number of remote bootstrap sessions. Used to calculate the transmission rate across all
-  // the sessions.
+  // Total number of remote bootstrap sessions.
   static std::atomic<int32_t> n_started_;
+  // Number of file downloads in flight across all the sessions. The transmission rate is split
+  // evenly between them.
+  static std::atomic<int32_t> n_downloads_;
   bool downloaded_wal_;     // WAL segments downloaded.
   bool downloaded_blocks_;  // Data blocks downloaded.
   bool downloaded_rocksdb_files_;
@@ -222,9 +254,19 @@ class RemoteBootstrapClient {
   // EndRemoteBootstrapSessionRequestPB request.
   bool succeeded_;
 
+  std::string bootstrap_peer_uuid_;
+
  private:
+  std::mutex inode2file_mutex_;
   std::unordered_map<uint64_t, std::string> inode2file_;
 
+  // Files of the resume directory that match the checkpoint of the session, by name. Only
+  // modified by LoadResumeManifest(), before the downloads start.
+  std::unordered_map<std::string, RemoteBootstrapResumeFilePB> resumable_files_;
+
+  std::mutex resume_manifest_mutex_;
+  RemoteBootstrapResumeManifestPB resume_manifest_;  // Protected by resume_manifest_mutex_.
+
   DISALLOW_COPY_AND_ASSIGN(RemoteBootstrapClient);
 };
 
@@ -15,6 +15,8 @@
 
 #include "yb/tserver/remote_bootstrap_client-test.h"
 
+#include "yb/util/pb_util.h"
+
 
 using std::shared_ptr;
 
@@ -78,5 +80,53 @@ TEST_F(RemoteBootstrapRocksDBClientTest, TestDownloadRocksDBFiles) {
   }
 }
 
+// Test that the next session links the RocksDB files downloaded by a session that failed.
+TEST_F(RemoteBootstrapRocksDBClientTest, TestResumeRocksDBFiles) {
+  ASSERT_OK(client_->DownloadRocksDBFiles());
+  const auto resume_dir = client_->ResumeDir();
+  RemoteBootstrapResumeManifestPB manifest;
+  ASSERT_OK(pb_util::ReadPBContainerFromPath(
+      fs_manager_->env(), client_->ResumeManifestPath(), &manifest));
+  ASSERT_EQ(leader_.permanent_uuid(), manifest.source_uuid());
+  ASSERT_EQ(client_->superblock_->rocksdb_files_size(), manifest.files_size());
+  std::unordered_map<std::string, uint64_t> downloaded_inodes;
+  for (const auto& entry : manifest.files()) {
+    downloaded_inodes.emplace(
+        entry.file().name(),
+        ASSERT_RESULT(fs_manager_->env()->GetFileINode(
+            JoinPathSegments(resume_dir, entry.file().name()))));
+  }
+
+  // Tombstoning the tablet deletes its RocksDB files, but keeps the ones of the resume directory.
+  ASSERT_OK(meta_->DeleteTabletData(tablet::TABLET_DATA_TOMBSTONED, yb::OpId()));
+  ASSERT_TRUE(fs_manager_->env()->FileExists(client_->ResumeManifestPath()));
+
+  client_.reset(new YB_EDITION_NS_PREFIX RemoteBootstrapClient(
+      GetTabletId(), fs_manager_.get(), fs_manager_->uuid()));
+  ASSERT_OK(client_->SetTabletToReplace(meta_, 0));
+  HostPort host_port = HostPortFromPB(leader_.last_known_private_addr()[0]);
+  ASSERT_OK(client_->Start(leader_.permanent_uuid(), proxy_cache_.get(), host_port, &meta_));
+  TabletStatusListener listener(meta_);
+  ASSERT_OK(client_->FetchAll(&listener));
+
+  // The SST files did not change between the checkpoints of the sessions, so they are linked.
+  int resumed = 0;
+  for (const auto& file_pb : client_->superblock_->rocksdb_files()) {
+    auto it = downloaded_inodes.find(file_pb.name());
+    // Files of the intents DB are moved out of the RocksDB directory after the download.
+    if (it == downloaded_inodes.end() || file_pb.name().find('/') != std::string::npos) {
+      continue;
+    }
+    const auto path = JoinPathSegments(meta_->rocksdb_dir(), file_pb.name());
+    if (ASSERT_RESULT(fs_manager_->env()->GetFileINode(path)) == it->second) {
+      ++resumed;
+    }
+  }
+  ASSERT_GT(resumed, 0);
+
+  ASSERT_OK(client_->Finish());
+  ASSERT_FALSE(fs_manager_->env()->FileExists(resume_dir));
+}
+
 } // namespace tserver
 } // namespace yb
@@ -41,6 +41,7 @@
 #include "yb/consensus/log_util.h"
 #include "yb/consensus/metadata.pb.h"
 #include "yb/consensus/opid_util.h"
+#include "yb/rpc/compression.h"
 #include "yb/rpc/rpc_header.pb.h"
 #include "yb/tserver/mini_tablet_server.h"
 #include "yb/tserver/remote_bootstrap.pb.h"
@@ -58,6 +59,8 @@
 
 DECLARE_uint64(remote_bootstrap_idle_timeout_ms);
 DECLARE_uint64(remote_bootstrap_timeout_poll_period_ms);
+DECLARE_string(remote_bootstrap_compression_policy);
+DECLARE_int32(rpc_compression_min_bytes);
 
 namespace yb {
 namespace tserver {
@@ -88,11 +91,14 @@ class RemoteBootstrapServiceTest : public RemoteBootstrapTest {
   Status DoBeginRemoteBootstrapSession(const string& tablet_id,
                                        const string& requestor_uuid,
                                        BeginRemoteBootstrapSessionResponsePB* resp,
-                                       RpcController* controller) {
+                                       RpcController* controller,
+                                       rpc::RpcCompressionPB accepted_compression =
+                                           rpc::RPC_COMPRESSION_NONE) {
     controller->set_timeout(MonoDelta::FromSeconds(1.0));
     BeginRemoteBootstrapSessionRequestPB req;
     req.set_tablet_id(tablet_id);
     req.set_requestor_uuid(requestor_uuid);
+    req.set_accepted_compression(accepted_compression);
     return UnwindRemoteError(
         remote_bootstrap_proxy_->BeginRemoteBootstrapSession(req, resp, controller), controller);
   }
@@ -372,6 +378,44 @@ TEST_F(RemoteBootstrapServiceTest, TestFetchLog) {
   AssertDataEqual(slice.data(), slice.size(), resp.chunk());
 }
 
+// Test that the chunks of a session are compressed when the requester accepts it.
+TEST_F(RemoteBootstrapServiceTest, TestFetchCompressedLog) {
+  FLAGS_remote_bootstrap_compression_policy = "always";
+  FLAGS_rpc_compression_min_bytes = 0;
+
+  BeginRemoteBootstrapSessionResponsePB begin_resp;
+  RpcController controller;
+  ASSERT_OK(DoBeginRemoteBootstrapSession(
+      GetTabletId(), GetLocalUUID(), &begin_resp, &controller, rpc::RPC_COMPRESSION_LZ4));
+  ASSERT_GT(begin_resp.wal_segment_seqnos_size(), 0);
+
+  FetchDataResponsePB resp;
+  controller.Reset();
+  DataIdPB data_id;
+  data_id.set_type(DataIdPB::LOG_SEGMENT);
+  data_id.set_wal_segment_seqno(begin_resp.wal_segment_seqnos(0));
+  ASSERT_OK(DoFetchData(begin_resp.session_id(), data_id, nullptr, nullptr, &resp, &controller));
+
+  const DataChunkPB& chunk = resp.chunk();
+  ASSERT_EQ(rpc::RPC_COMPRESSION_LZ4, chunk.compression());
+  ASSERT_LT(chunk.data().size(), chunk.uncompressed_length());
+  ASSERT_EQ(crc::Crc32c(chunk.data().data(), chunk.data().size()), chunk.crc32());
+
+  std::vector<char> decompressed;
+  ASSERT_OK(rpc::DecompressPayload(
+      chunk.compression(), chunk.data(), chunk.uncompressed_length(), nullptr, &decompressed));
+
+  log::SegmentSequence local_segments;
+  ASSERT_OK(tablet_peer_->log()->GetLogReader()->GetSegmentsSnapshot(&local_segments));
+  const scoped_refptr<ReadableLogSegment>& segment = local_segments[0];
+  faststring scratch;
+  int64_t size = segment->file_size();
+  scratch.resize(size);
+  Slice slice;
+  ASSERT_OK(ReadFully(segment->readable_file().get(), 0, size, &slice, scratch.data()));
+  ASSERT_EQ(slice, Slice(decompressed.data(), decompressed.size()));
+}
+
 // Test that the remote bootstrap session timeout works properly.
 TEST_F(RemoteBootstrapServiceTest, TestSessionTimeout) {
   // This flag should be seen by the service due to TSO.
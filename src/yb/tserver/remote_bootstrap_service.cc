@@ -45,6 +45,7 @@
 #include "yb/fs/fs_manager.h"
 #include "yb/gutil/strings/substitute.h"
 #include "yb/gutil/map-util.h"
+#include "yb/rpc/compression.h"
 #include "yb/rpc/rpc_context.h"
 #include "yb/tserver/tablet_peer_lookup.h"
 #include "yb/tablet/tablet_peer.h"
@@ -77,6 +78,14 @@ DEFINE_uint64(remote_bootstrap_timeout_poll_period_ms, 10000,
               "remote bootstrap sessions, in millis");
 TAG_FLAG(remote_bootstrap_timeout_poll_period_ms, hidden);
 
+DEFINE_string(remote_bootstrap_compression_policy, "other_subnets",
+              "When to compress the data chunks of remote bootstrap sessions for requesters that "
+              "accept it: never, always, or other_subnets, with the same meaning as for "
+              "--rpc_compression_policy. Chunks of files that do not shrink, like compressed SST "
+              "files, are sent as is.");
+TAG_FLAG(remote_bootstrap_compression_policy, advanced);
+TAG_FLAG(remote_bootstrap_compression_policy, runtime);
+
 DEFINE_test_flag(double, fault_crash_on_handle_rb_fetch_data, 0.0,
                  "Fraction of the time when the tablet will crash while "
                  "servicing a RemoteBootstrapService FetchData() RPC call.");
@@ -184,6 +193,9 @@ void RemoteBootstrapServiceImpl::BeginRemoteBootstrapSession(
     }
     ResetSessionExpirationUnlocked(session_id);
   }
+  session->set_compression(rpc::CompressionForPeer(
+      FLAGS_remote_bootstrap_compression_policy, req->accepted_compression(),
+      context.local_address(), context.remote_address()));
 
   resp->set_session_id(session_id);
   resp->set_session_idle_timeout_millis(FLAGS_remote_bootstrap_idle_timeout_ms);
@@ -283,8 +295,8 @@ void RemoteBootstrapServiceImpl::FetchData(const FetchDataRequestPB* req,
   MAYBE_FAULT(FLAGS_fault_crash_on_handle_rb_fetch_data);
 
   uint64_t offset = req->offset();
-  VLOG(3) << " rate limiter max len: "  << session->rate_limiter().GetMaxSizeForNextTransmission();
-  auto rate_limit = session->rate_limiter().GetMaxSizeForNextTransmission();
+  auto rate_limit = session->GetMaxSizeForNextTransmission();
+  VLOG(3) << " rate limiter max len: "  << rate_limit;
   int64_t client_maxlen = rate_limit == 0
       ? req->max_length() : std::min(static_cast<uint64_t>(req->max_length()), rate_limit);
   const DataIdPB& data_id = req->data_id();
@@ -300,8 +312,9 @@ void RemoteBootstrapServiceImpl::FetchData(const FetchDataRequestPB* req,
                     error_code, "Unable to get piece of data file");
 
   data_chunk->set_total_data_length(total_data_length);
-  session->rate_limiter().UpdateDataSizeAndMaybeSleep(data->size());
   data_chunk->set_offset(offset);
+  session->MaybeCompressChunk(data_id, data_chunk);
+  session->UpdateDataSizeAndMaybeSleep(data->size());
 
   // Calculate checksum.
   uint32_t crc32 = Crc32c(data->data(), data->length());
@@ -119,6 +119,7 @@ class RemoteBootstrapTest : public YBTabletTest {
                        0,  // schema_version
                        nullptr, // metric_entity
                        append_pool_.get(),
+                       nullptr /* allocation_thread_pool */,
                        &log));
 
     scoped_refptr<MetricEntity> metric_entity =
@@ -164,7 +165,8 @@ class RemoteBootstrapTest : public YBTabletTest {
                                           metric_entity,
                                           raft_pool_.get(),
                                           tablet_prepare_pool_.get(),
-                                          nullptr /* retryable_requests */));
+                                          nullptr /* retryable_requests */,
+                                          nullptr /* multi_raft_manager */));
     consensus::ConsensusBootstrapInfo boot_info;
     ASSERT_OK(tablet_peer_->Start(boot_info));
 
@@ -40,6 +40,7 @@
 #include "yb/gutil/map-util.h"
 #include "yb/gutil/strings/substitute.h"
 #include "yb/gutil/type_traits.h"
+#include "yb/rpc/compression.h"
 #include "yb/server/metadata.h"
 #include "yb/tablet/tablet.h"
 #include "yb/tablet/tablet_peer.h"
@@ -513,11 +514,52 @@ bool RemoteBootstrapSession::Succeeded() {
 }
 
 void RemoteBootstrapSession::EnsureRateLimiterIsInitialized() {
+  std::lock_guard<std::mutex> lock(rate_limiter_mutex_);
   if (!rate_limiter_.IsInitialized()) {
     InitRateLimiter();
   }
 }
 
+uint64_t RemoteBootstrapSession::GetMaxSizeForNextTransmission() {
+  std::lock_guard<std::mutex> lock(rate_limiter_mutex_);
+  return rate_limiter_.GetMaxSizeForNextTransmission();
+}
+
+void RemoteBootstrapSession::UpdateDataSizeAndMaybeSleep(uint64_t data_size) {
+  // Sleeping under the lock also holds back the other fetches of the session, which keeps the
+  // whole session within its rate.
+  std::lock_guard<std::mutex> lock(rate_limiter_mutex_);
+  rate_limiter_.UpdateDataSizeAndMaybeSleep(data_size);
+}
+
+void RemoteBootstrapSession::MaybeCompressChunk(const DataIdPB& data_id, DataChunkPB* chunk) {
+  const auto compression = this->compression();
+  if (compression == rpc::RPC_COMPRESSION_NONE) {
+    return;
+  }
+  const string file = data_id.type() == DataIdPB::LOG_SEGMENT
+      ? Substitute("log segment $0", data_id.wal_segment_seqno()) : data_id.file_name();
+  {
+    std::lock_guard<std::mutex> lock(incompressible_files_mutex_);
+    if (incompressible_files_.count(file)) {
+      return;
+    }
+  }
+
+  std::vector<char> compressed;
+  if (!rpc::CompressPayload(compression, {Slice(chunk->data())}, nullptr, &compressed)) {
+    // Data that is already compressed, like the data blocks of compressed SST files or WAL
+    // segments written with --log_compression_codec, does not get smaller, so the rest of the
+    // file is sent as is instead of spending CPU on it.
+    std::lock_guard<std::mutex> lock(incompressible_files_mutex_);
+    incompressible_files_.insert(file);
+    return;
+  }
+  chunk->set_uncompressed_length(chunk->data().size());
+  chunk->set_compression(compression);
+  chunk->mutable_data()->assign(compressed.data(), compressed.size());
+}
+
 
 void RemoteBootstrapSession::InitRateLimiter() {
   if (FLAGS_remote_boostrap_rate_limit_bytes_per_sec > 0 && nsessions_) {
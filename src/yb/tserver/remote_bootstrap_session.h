@@ -32,9 +32,12 @@
 #ifndef YB_TSERVER_REMOTE_BOOTSTRAP_SESSION_H_
 #define YB_TSERVER_REMOTE_BOOTSTRAP_SESSION_H_
 
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "yb/consensus/log_anchor_registry.h"
@@ -44,6 +47,7 @@
 #include "yb/gutil/macros.h"
 #include "yb/gutil/ref_counted.h"
 #include "yb/gutil/stl_util.h"
+#include "yb/rpc/rpc_header.pb.h"
 #include "yb/tserver/remote_bootstrap.pb.h"
 #include "yb/util/env_util.h"
 #include "yb/util/net/rate_limiter.h"
@@ -144,9 +148,26 @@ class RemoteBootstrapSession : public RefCountedThreadSafe<RemoteBootstrapSessio
 
   void InitRateLimiter();
 
+  // The rate limiter methods are safe to call concurrently, since a client could fetch several
+  // files of the same session in parallel.
   void EnsureRateLimiterIsInitialized();
 
-  RateLimiter& rate_limiter() { return rate_limiter_; }
+  uint64_t GetMaxSizeForNextTransmission();
+
+  void UpdateDataSizeAndMaybeSleep(uint64_t data_size);
+
+  // Compression of the data chunks sent by this session, set when the session begins.
+  void set_compression(rpc::RpcCompressionPB compression) {
+    compression_.store(compression, std::memory_order_release);
+  }
+
+  rpc::RpcCompressionPB compression() const {
+    return compression_.load(std::memory_order_acquire);
+  }
+
+  // Compresses 'chunk' in place with the compression of the session, unless the file it belongs
+  // to, e.g. an SST file written with RocksDB compression, was found not to shrink.
+  void MaybeCompressChunk(const DataIdPB& data_id, DataChunkPB* chunk);
 
  protected:
   friend class RefCountedThreadSafe<RemoteBootstrapSession>;
@@ -203,12 +224,19 @@ class RemoteBootstrapSession : public RefCountedThreadSafe<RemoteBootstrapSessio
   MonoTime start_time_;
 
   // Used to limit the transmission rate.
-  RateLimiter rate_limiter_;
+  std::mutex rate_limiter_mutex_;
+  RateLimiter rate_limiter_;  // Protected by rate_limiter_mutex_.
 
   // Pointer to the counter for of the number of sessions in RemoteBootstrapService. Used to
   // calculate the rate for the rate limiter.
   const std::atomic<int>* nsessions_;
 
+  std::atomic<rpc::RpcCompressionPB> compression_{rpc::RPC_COMPRESSION_NONE};
+
+  // Files whose chunks are sent uncompressed, since one of their chunks did not shrink.
+  std::mutex incompressible_files_mutex_;
+  std::unordered_set<std::string> incompressible_files_;  // Protected by the mutex above.
+
  private:
   DISALLOW_COPY_AND_ASSIGN(RemoteBootstrapSession);
 };
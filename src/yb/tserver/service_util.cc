@@ -21,6 +21,11 @@
 namespace yb {
 namespace tserver {
 
+void SetupError(TabletServerErrorPB* error, const Status& s, TabletServerErrorPB::Code code) {
+  StatusToPB(s, error->mutable_status());
+  error->set_code(code);
+}
+
 void SetupErrorAndRespond(TabletServerErrorPB* error,
                           const Status& s,
                           TabletServerErrorPB::Code code,
@@ -31,8 +36,7 @@ void SetupErrorAndRespond(TabletServerErrorPB* error,
     return;
   }
 
-  StatusToPB(s, error->mutable_status());
-  error->set_code(code);
+  SetupError(error, s, code);
   // TODO: rename RespondSuccess() to just "Respond" or
   // "SendResponse" since we use it for application-level error
   // responses, and this just looks confusing!
@@ -79,6 +83,14 @@ bool LeaderTabletPeer::FillTerm(TabletServerErrorPB* error, rpc::RpcContext* con
   auto leader_term = LeaderTerm(*peer);
   if (!leader_term.ok()) {
     peer->tablet()->metrics()->not_leader_rejections->Increment();
+    auto code = static_cast<TabletServerErrorPB::Code>(leader_term.status().error_code());
+    if (code == TabletServerErrorPB::NOT_THE_LEADER) {
+      auto leader_uuid = peer->shared_consensus()->ConsensusState(
+          consensus::CONSENSUS_CONFIG_ACTIVE).leader_uuid();
+      if (!leader_uuid.empty() && leader_uuid != peer->permanent_uuid()) {
+        error->set_leader_uuid(std::move(leader_uuid));
+      }
+    }
     SetupErrorAndRespond(error, leader_term.status(), context);
     return false;
   }
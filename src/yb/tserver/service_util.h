@@ -28,6 +28,9 @@ namespace tserver {
 
 // Non-template helpers.
 
+// Fills 'error' without responding, for errors of a single entry of a batched request.
+void SetupError(TabletServerErrorPB* error, const Status& s, TabletServerErrorPB::Code code);
+
 void SetupErrorAndRespond(TabletServerErrorPB* error,
                           const Status& s,
                           TabletServerErrorPB::Code code,
@@ -563,6 +563,36 @@ TEST_F(TabletServerTest, TestCreateTablet_TabletExists) {
   }
 }
 
+// Tablets of a CreateTablets request should fail or succeed independently.
+TEST_F(TabletServerTest, TestCreateTablets) {
+  CreateTabletsRequestPB req;
+  CreateTabletsResponsePB resp;
+  RpcController rpc;
+
+  req.set_dest_uuid(mini_server_->server()->fs_manager()->uuid());
+  Schema schema = SchemaBuilder(schema_).Build();
+  for (const auto& tablet_id : {kTabletId, "new-tablet"}) {
+    auto* tablet_req = req.add_tablets();
+    tablet_req->set_table_id("testtb");
+    tablet_req->set_tablet_id(tablet_id);
+    tablet_req->set_table_name("testtb");
+    tablet_req->mutable_config()->CopyFrom(mini_server_->CreateLocalConfig());
+    SchemaToPB(schema, tablet_req->mutable_schema());
+  }
+
+  SCOPED_TRACE(req.DebugString());
+  ASSERT_OK(admin_proxy_->CreateTablets(req, &resp, &rpc));
+  SCOPED_TRACE(resp.DebugString());
+  ASSERT_FALSE(resp.has_error());
+  ASSERT_EQ(2, resp.tablets_size());
+  ASSERT_TRUE(resp.tablets(0).has_error());
+  ASSERT_EQ(TabletServerErrorPB::TABLET_ALREADY_EXISTS, resp.tablets(0).error().code());
+  ASSERT_FALSE(resp.tablets(1).has_error());
+
+  std::shared_ptr<TabletPeer> tablet;
+  ASSERT_TRUE(mini_server_->server()->tablet_manager()->LookupTablet("new-tablet", &tablet));
+}
+
 TEST_F(TabletServerTest, TestDeleteTablet) {
   std::shared_ptr<TabletPeer> tablet;
 
@@ -633,6 +663,34 @@ TEST_F(TabletServerTest, TestDeleteTablet_TabletNotCreated) {
   }
 }
 
+TEST_F(TabletServerTest, TestMultiUpdateConsensusErrors) {
+  consensus::MultiConsensusRequestPB req;
+  consensus::MultiConsensusResponsePB resp;
+  RpcController rpc;
+
+  auto add_request = [&req](const string& dest_uuid, const string& tablet_id) {
+    auto* request = req.add_requests();
+    request->set_dest_uuid(dest_uuid);
+    request->set_tablet_id(tablet_id);
+    request->set_caller_uuid("CallerUuid");
+    request->set_caller_term(1);
+    request->mutable_committed_index()->set_term(0);
+    request->mutable_committed_index()->set_index(0);
+  };
+  add_request("WrongUuid", kTabletId);
+  add_request(mini_server_->server()->fs_manager()->uuid(), "NotPresentTabletId");
+
+  // Errors are reported per request, the RPC itself succeeds.
+  SCOPED_TRACE(req.DebugString());
+  ASSERT_OK(consensus_proxy_->MultiUpdateConsensus(req, &resp, &rpc));
+  SCOPED_TRACE(resp.DebugString());
+  ASSERT_EQ(2, resp.responses_size());
+  ASSERT_TRUE(resp.responses(0).has_error());
+  ASSERT_EQ(TabletServerErrorPB::WRONG_SERVER_UUID, resp.responses(0).error().code());
+  ASSERT_TRUE(resp.responses(1).has_error());
+  ASSERT_EQ(TabletServerErrorPB::TABLET_NOT_FOUND, resp.responses(1).error().code());
+}
+
 // Test that with concurrent requests to delete the same tablet, one wins and
 // the other fails, with no assertion failures. Regression test for KUDU-345.
 TEST_F(TabletServerTest, TestConcurrentDeleteTablet) {
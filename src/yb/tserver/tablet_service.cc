@@ -62,6 +62,7 @@
 #include "yb/tablet/tablet_metrics.h"
 
 #include "yb/tablet/operations/change_metadata_operation.h"
+#include "yb/tablet/operations/ingest_external_files_operation.h"
 #include "yb/tablet/operations/truncate_operation.h"
 #include "yb/tablet/operations/update_txn_operation.h"
 #include "yb/tablet/operations/write_operation.h"
@@ -75,6 +76,7 @@
 #include "yb/util/flag_tags.h"
 #include "yb/util/mem_tracker.h"
 #include "yb/util/monotime.h"
+#include "yb/util/net/rate_limiter.h"
 #include "yb/util/random_util.h"
 #include "yb/util/size_literals.h"
 #include "yb/util/status.h"
@@ -86,6 +88,7 @@
 #include "yb/yql/pggate/util/pg_doc_data.h"
 
 using namespace std::literals;  // NOLINT
+using namespace yb::size_literals;
 
 DEFINE_int32(scanner_default_batch_size_bytes, 64 * 1024,
              "The default size for batches of scan results");
@@ -114,8 +117,17 @@ DEFINE_test_flag(int32, scanner_inject_latency_on_each_batch_ms, 0,
                  "If set, the scanner will pause the specified number of milliesconds "
                  "before reading each batch of data on the tablet server.");
 
+DECLARE_int32(memory_limit_soft_percentage);
 DECLARE_int32(memory_limit_warn_threshold_percentage);
 
+DEFINE_int32(memory_pressure_max_retry_after_ms, 1000,
+             "How long the clients of writes rejected because of the soft memory limit are asked "
+             "to wait before retrying, when the memory usage is at the hard limit. Between the "
+             "soft and the hard limit the delay grows in proportion to the usage. 0 leaves the "
+             "delay to the client backoff.");
+TAG_FLAG(memory_pressure_max_retry_after_ms, advanced);
+TAG_FLAG(memory_pressure_max_retry_after_ms, runtime);
+
 DEFINE_int32(max_wait_for_safe_time_ms, 5000,
              "Maximum time in milliseconds to wait for the safe time to advance when trying to "
              "scan at the given hybrid_time.");
@@ -145,6 +157,12 @@ DEFINE_test_flag(bool, simulate_time_out_failures, false, "If true, we will rand
 DEFINE_test_flag(double, respond_write_failed_probability, 0.0,
                  "Probability to respond that write request is failed");
 
+DEFINE_int64(checksum_scan_max_bytes_per_sec, 0,
+             "Maximum rate at which a checksum scan of a tablet, such as those of ysck, reads "
+             "the data of the tablet. 0 does not limit the rate.");
+TAG_FLAG(checksum_scan_max_bytes_per_sec, advanced);
+TAG_FLAG(checksum_scan_max_bytes_per_sec, runtime);
+
 DECLARE_uint64(max_clock_skew_usec);
 
 namespace yb {
@@ -216,6 +234,16 @@ Status GetTabletRef(const TabletPeerPtr& tablet_peer,
   return Status::OK();
 }
 
+// Only reads could be served by followers with a bounded staleness.
+template <class Req>
+uint64_t MaxStalenessMs(const Req& req) {
+  return 0;
+}
+
+uint64_t MaxStalenessMs(const ReadRequestPB& req) {
+  return req.max_staleness_ms();
+}
+
 } // namespace
 
 template<class Resp>
@@ -234,9 +262,21 @@ bool TabletServiceImpl::CheckMemoryPressure(
     } else {
       YB_LOG_EVERY_N_SECS(INFO, 1) << "Rejecting Write request: " << msg << THROTTLE_MSG;
     }
-    SetupErrorAndRespond(resp->mutable_error(), STATUS(ServiceUnavailable, msg),
-                         TabletServerErrorPB::UNKNOWN_ERROR,
-                         context);
+    auto status = STATUS(ServiceUnavailable, msg);
+    if (FLAGS_memory_pressure_max_retry_after_ms > 0) {
+      // The further past the soft limit, the longer the clients back off, so that the write
+      // throughput degrades gradually while flushes free memory.
+      const double soft_pct = FLAGS_memory_limit_soft_percentage;
+      const double overshoot = soft_pct < 100
+          ? std::min(std::max((capacity_pct - soft_pct) / (100 - soft_pct), 0.0), 1.0) : 1.0;
+      context->RespondBusy(
+          status,
+          MonoDelta::FromMilliseconds(
+              static_cast<int64_t>(FLAGS_memory_pressure_max_retry_after_ms * overshoot)));
+    } else {
+      SetupErrorAndRespond(resp->mutable_error(), status, TabletServerErrorPB::UNKNOWN_ERROR,
+                           context);
+    }
     return false;
   }
 
@@ -320,7 +360,8 @@ class ScanResultChecksummer {
  public:
   ScanResultChecksummer() {}
 
-  void HandleRow(const Schema& schema, const QLTableRow& row) {
+  // Returns the size of the serialized row.
+  size_t HandleRow(const Schema& schema, const QLTableRow& row) {
     QLValue value;
     buffer_.clear();
     for (uint32_t col_index = 0; col_index != schema.num_columns(); ++col_index) {
@@ -339,14 +380,15 @@ class ScanResultChecksummer {
         value.value().AppendToString(&buffer_);
       }
     }
-    crc_->Compute(buffer_.c_str(), buffer_.size(), &agg_checksum_, nullptr);
+    agg_checksum_ = crc::Crc32cExtend(
+        static_cast<uint32_t>(agg_checksum_), buffer_.c_str(), buffer_.size());
+    return buffer_.size();
   }
 
   // Accessors for initializing / setting the checksum.
   uint64_t agg_checksum() const { return agg_checksum_; }
 
  private:
-  crc::Crc* const crc_ = crc::GetCrc32cInstance();
   uint64_t agg_checksum_ = 0;
   std::string buffer_;
 };
@@ -361,6 +403,27 @@ TabletServiceAdminImpl::TabletServiceAdminImpl(TabletServer* server)
       server_(server) {
 }
 
+namespace {
+
+// Submits the change metadata operation of 'req' to the leader of its tablet. The RPC is responded
+// to asynchronously.
+void SubmitChangeMetadata(const ChangeMetadataRequestPB* req,
+                          ChangeMetadataResponsePB* resp,
+                          rpc::RpcContext context,
+                          const LeaderTabletPeer& tablet,
+                          server::Clock* clock) {
+  auto operation_state = std::make_unique<ChangeMetadataOperationState>(
+      tablet.peer->tablet(), tablet.peer->log(), req);
+
+  operation_state->set_completion_callback(
+      MakeRpcOperationCompletionCallback(std::move(context), resp, clock));
+
+  tablet.peer->Submit(std::make_unique<tablet::ChangeMetadataOperation>(
+      std::move(operation_state)), tablet.leader_term);
+}
+
+} // namespace
+
 void TabletServiceAdminImpl::AlterSchema(const ChangeMetadataRequestPB* req,
                                          ChangeMetadataResponsePB* resp,
                                          rpc::RpcContext context) {
@@ -377,6 +440,16 @@ void TabletServiceAdminImpl::AlterSchema(const ChangeMetadataRequestPB* req,
     return;
   }
 
+  if (req->has_add_table()) {
+    // The table may have been added by a previous attempt of the same request.
+    if (tablet.peer->tablet_metadata()->GetTableInfo(req->add_table().table_id()).ok()) {
+      context.RespondSuccess();
+      return;
+    }
+    SubmitChangeMetadata(req, resp, std::move(context), tablet, server_->Clock());
+    return;
+  }
+
   uint32_t schema_version = tablet.peer->tablet_metadata()->schema_version();
 
   // If the schema was already applied, respond as succeeded
@@ -419,16 +492,58 @@ void TabletServiceAdminImpl::AlterSchema(const ChangeMetadataRequestPB* req,
     return;
   }
 
-  auto operation_state = std::make_unique<ChangeMetadataOperationState>(
-      tablet.peer->tablet(), tablet.peer->log(), req);
+  SubmitChangeMetadata(req, resp, std::move(context), tablet, server_->Clock());
+}
 
-  operation_state->set_completion_callback(
-      MakeRpcOperationCompletionCallback(std::move(context), resp, server_->Clock()));
+namespace {
 
-  // Submit the alter schema op. The RPC will be responded to asynchronously.
-  tablet.peer->Submit(std::make_unique<tablet::ChangeMetadataOperation>(
-      std::move(operation_state)), tablet.leader_term);
-}
+// Responds to UpdateTransaction with batched heartbeats once all of them are completed.
+class BatchedHeartbeats {
+ public:
+  BatchedHeartbeats(rpc::RpcContext context,
+                    UpdateTransactionResponsePB* resp,
+                    server::ClockPtr clock,
+                    int size)
+      : context_(std::move(context)), resp_(resp), clock_(std::move(clock)), pending_(size) {
+    for (int i = 0; i != size; ++i) {
+      resp_->add_batched_results();
+    }
+  }
+
+  void Completed(int index, const Status& status, TabletServerErrorPB::Code code) {
+    if (!status.ok()) {
+      auto* error = resp_->mutable_batched_results(index)->mutable_error();
+      error->set_code(code);
+      StatusToPB(status, error->mutable_status());
+    }
+    if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      resp_->set_propagated_hybrid_time(clock_->Now().ToUint64());
+      context_.RespondSuccess();
+    }
+  }
+
+ private:
+  rpc::RpcContext context_;
+  UpdateTransactionResponsePB* const resp_;
+  server::ClockPtr clock_;
+  std::atomic<int> pending_;
+};
+
+class BatchedHeartbeatCompletionCallback : public tablet::OperationCompletionCallback {
+ public:
+  BatchedHeartbeatCompletionCallback(std::shared_ptr<BatchedHeartbeats> heartbeats, int index)
+      : heartbeats_(std::move(heartbeats)), index_(index) {}
+
+  void OperationCompleted() override {
+    heartbeats_->Completed(index_, status_, code_);
+  }
+
+ private:
+  std::shared_ptr<BatchedHeartbeats> heartbeats_;
+  const int index_;
+};
+
+} // namespace
 
 #define VERIFY_RESULT_OR_RETURN(expr) \
   __extension__ ({ \
@@ -459,6 +574,26 @@ void TabletServiceImpl::UpdateTransaction(const UpdateTransactionRequestPB* req,
     return;
   }
 
+  if (!req->has_state() && req->batched_heartbeats_size() != 0) {
+    auto heartbeats = std::make_shared<BatchedHeartbeats>(
+        std::move(context), resp, server_->Clock(), req->batched_heartbeats_size());
+    for (int i = 0; i != req->batched_heartbeats_size(); ++i) {
+      const auto& heartbeat = req->batched_heartbeats(i);
+      auto state = std::make_unique<tablet::UpdateTxnOperationState>(
+          tablet.peer->tablet(), &heartbeat);
+      state->set_completion_callback(
+          std::make_unique<BatchedHeartbeatCompletionCallback>(heartbeats, i));
+      if (heartbeat.status() != TransactionStatus::PENDING) {
+        state->CompleteWithStatus(STATUS_FORMAT(
+            InvalidArgument, "Only heartbeats could be batched: $0", heartbeat.ShortDebugString()));
+        continue;
+      }
+      tablet.peer->tablet()->transaction_coordinator()->Handle(
+          std::move(state), tablet.leader_term);
+    }
+    return;
+  }
+
   auto state = std::make_unique<tablet::UpdateTxnOperationState>(tablet.peer->tablet(),
                                                                  &req->state());
   state->set_completion_callback(MakeRpcOperationCompletionCallback(
@@ -488,8 +623,7 @@ void TabletServiceImpl::GetTransactionStatus(const GetTransactionStatusRequestPB
     return;
   }
 
-  status = tablet_peer->tablet()->transaction_coordinator()->GetStatus(
-      req->transaction_id(), resp);
+  status = tablet_peer->tablet()->transaction_coordinator()->GetStatus(*req, resp);
   resp->set_propagated_hybrid_time(server_->Clock()->Now().ToUint64());
   if (status.ok()) {
     context.RespondSuccess();
@@ -557,58 +691,106 @@ void TabletServiceImpl::Truncate(const TruncateRequestPB* req,
       std::make_unique<tablet::TruncateOperation>(std::move(tx_state)), tablet.leader_term);
 }
 
+void TabletServiceImpl::IngestExternalFiles(const IngestExternalFilesRequestPB* req,
+                                            IngestExternalFilesResponsePB* resp,
+                                            rpc::RpcContext context) {
+  TRACE("IngestExternalFiles");
+
+  UpdateClock(*req, server_->Clock());
+
+  auto tablet = LookupLeaderTabletOrRespond(
+      server_->tablet_peer_lookup(), req->tablet_id(), resp, &context);
+  if (!tablet) {
+    return;
+  }
+
+  auto tx_state = std::make_unique<tablet::IngestExternalFilesOperationState>(
+      tablet.peer->tablet(), req, resp);
+
+  tx_state->set_completion_callback(
+      MakeRpcOperationCompletionCallback(std::move(context), resp, server_->Clock()));
+
+  // Submit the ingest op. The RPC will be responded to asynchronously.
+  tablet.peer->Submit(
+      std::make_unique<tablet::IngestExternalFilesOperation>(std::move(tx_state)),
+      tablet.leader_term);
+}
+
 void TabletServiceAdminImpl::CreateTablet(const CreateTabletRequestPB* req,
                                           CreateTabletResponsePB* resp,
                                           rpc::RpcContext context) {
   if (!CheckUuidMatchOrRespond(server_->tablet_manager(), "CreateTablet", req, resp, &context)) {
     return;
   }
+  TabletServerErrorPB::Code code;
+  Status s = DoCreateTablet(*req, &code);
+  if (PREDICT_FALSE(!s.ok())) {
+    SetupErrorAndRespond(resp->mutable_error(), s, code, &context);
+    return;
+  }
+  context.RespondSuccess();
+}
+
+void TabletServiceAdminImpl::CreateTablets(const CreateTabletsRequestPB* req,
+                                           CreateTabletsResponsePB* resp,
+                                           rpc::RpcContext context) {
+  if (!CheckUuidMatchOrRespond(server_->tablet_manager(), "CreateTablets", req, resp, &context)) {
+    return;
+  }
+  TRACE_EVENT1("tserver", "CreateTablets", "num_tablets", req->tablets_size());
+
+  for (const auto& tablet_req : req->tablets()) {
+    auto* tablet_resp = resp->add_tablets();
+    TabletServerErrorPB::Code code;
+    Status s = DoCreateTablet(tablet_req, &code);
+    if (PREDICT_FALSE(!s.ok())) {
+      SetupError(tablet_resp->mutable_error(), s, code);
+    }
+  }
+  context.RespondSuccess();
+}
+
+Status TabletServiceAdminImpl::DoCreateTablet(const CreateTabletRequestPB& req,
+                                              TabletServerErrorPB::Code* code) {
   TRACE_EVENT1("tserver", "CreateTablet",
-               "tablet_id", req->tablet_id());
+               "tablet_id", req.tablet_id());
 
   Schema schema;
-  Status s = SchemaFromPB(req->schema(), &schema);
+  Status s = SchemaFromPB(req.schema(), &schema);
   DCHECK(schema.has_column_ids());
   if (!s.ok()) {
-    SetupErrorAndRespond(resp->mutable_error(),
-                         STATUS(InvalidArgument, "Invalid Schema."),
-                         TabletServerErrorPB::INVALID_SCHEMA, &context);
-    return;
+    *code = TabletServerErrorPB::INVALID_SCHEMA;
+    return STATUS(InvalidArgument, "Invalid Schema.");
   }
 
   PartitionSchema partition_schema;
-  s = PartitionSchema::FromPB(req->partition_schema(), schema, &partition_schema);
+  s = PartitionSchema::FromPB(req.partition_schema(), schema, &partition_schema);
   if (!s.ok()) {
-    SetupErrorAndRespond(resp->mutable_error(),
-                         STATUS(InvalidArgument, "Invalid PartitionSchema."),
-                         TabletServerErrorPB::INVALID_SCHEMA, &context);
-    return;
+    *code = TabletServerErrorPB::INVALID_SCHEMA;
+    return STATUS(InvalidArgument, "Invalid PartitionSchema.");
   }
 
   Partition partition;
-  Partition::FromPB(req->partition(), &partition);
+  Partition::FromPB(req.partition(), &partition);
 
-  LOG(INFO) << "Processing CreateTablet for tablet " << req->tablet_id()
-            << " (table=" << req->table_name()
-            << " [id=" << req->table_id() << "]), partition="
+  LOG(INFO) << "Processing CreateTablet for tablet " << req.tablet_id()
+            << " (table=" << req.table_name()
+            << " [id=" << req.table_id() << "]), partition="
             << partition_schema.PartitionDebugString(partition, schema);
-  VLOG(1) << "Full request: " << req->DebugString();
+  VLOG(1) << "Full request: " << req.DebugString();
 
-  s = server_->tablet_manager()->CreateNewTablet(req->table_id(), req->tablet_id(), partition,
-      req->table_name(), req->table_type(), schema, partition_schema,
-      req->has_index_info() ? boost::optional<IndexInfo>(req->index_info()) : boost::none,
-      req->config(), /* tablet_peer */ nullptr);
+  s = server_->tablet_manager()->CreateNewTablet(req.table_id(), req.tablet_id(), partition,
+      req.table_name(), req.table_type(), schema, partition_schema,
+      req.has_index_info() ? boost::optional<IndexInfo>(req.index_info()) : boost::none,
+      req.config(), /* tablet_peer */ nullptr);
   if (PREDICT_FALSE(!s.ok())) {
-    TabletServerErrorPB::Code code;
     if (s.IsAlreadyPresent()) {
-      code = TabletServerErrorPB::TABLET_ALREADY_EXISTS;
+      *code = TabletServerErrorPB::TABLET_ALREADY_EXISTS;
     } else {
-      code = TabletServerErrorPB::UNKNOWN_ERROR;
+      *code = TabletServerErrorPB::UNKNOWN_ERROR;
     }
-    SetupErrorAndRespond(resp->mutable_error(), s, code, &context);
-    return;
   }
-  context.RespondSuccess();
+  return s;
 }
 
 void TabletServiceAdminImpl::DeleteTablet(const DeleteTabletRequestPB* req,
@@ -871,6 +1053,24 @@ bool TabletServiceImpl::DoGetTabletOrRespond(const Req* req, Resp* resp, rpc::Rp
           return false;
         }
       }
+
+      // The follower serves the read at its safe time, so check that it is recent enough.
+      const auto max_staleness_ms = MaxStalenessMs(*req);
+      if (max_staleness_ms > 0) {
+        auto tablet = tablet_peer->shared_tablet();
+        const auto safe_time = tablet ? tablet->SafeTime(tablet::RequireLease::kFalse)
+                                      : HybridTime::kInvalid;
+        const auto now = server_->Clock()->Now();
+        if (!safe_time.is_valid() ||
+            now.PhysicalDiff(safe_time) > static_cast<int64_t>(max_staleness_ms * 1000)) {
+          SetupErrorAndRespond(
+              resp->mutable_error(),
+              STATUS_FORMAT(IllegalState, "Safe time $0 is more than $1 ms behind $2",
+                            safe_time, max_staleness_ms, now),
+              TabletServerErrorPB::STALE_FOLLOWER, context);
+          return false;
+        }
+      }
     } else {
       // We are here because we are the leader.
       if (PREDICT_FALSE(FLAGS_assert_reads_from_follower_rejected_because_of_staleness)) {
@@ -1030,6 +1230,7 @@ void TabletServiceImpl::Read(const ReadRequestPB* req,
       req->consistency_level() == YBConsistencyLevel::STRONG);
   // TODO: should check all the tables referenced by the requests to decide if it is transactional.
   const bool transactional = read_context.tablet->SchemaRef().table_properties().is_transactional();
+  const auto safe_time_wait_start = MonoTime::Now();
   if (!read_time) {
     read_context.safe_ht_to_read = read_context.tablet->SafeTime(read_context.require_lease);
     // If the read time is not specified, then it is non transactional read.
@@ -1054,6 +1255,13 @@ void TabletServiceImpl::Read(const ReadRequestPB* req,
       return;
     }
   }
+  // Reads are broken down into the wait for the safe time, recorded here, and the execution,
+  // recorded by the tablet in ql_read_latency and redis_read_latency.
+  auto* metrics = down_cast<Tablet*>(read_context.tablet.get())->metrics();
+  if (metrics) {
+    metrics->snapshot_read_inflight_wait_duration->Increment(
+        MonoTime::Now().GetDeltaSince(safe_time_wait_start).ToMicroseconds());
+  }
 
   RequestScope request_scope;
   if (transactional) {
@@ -1218,12 +1426,13 @@ Result<ReadHybridTime> TabletServiceImpl::DoRead(ReadContext* read_context) {
     DCHECK_EQ(read_context->tablet->table_type(), TableType::YQL_TABLE_TYPE);
     ReadRequestPB* mutable_req = const_cast<ReadRequestPB*>(read_context->req);
     for (QLReadRequestPB& ql_read_req : *mutable_req->mutable_ql_batch()) {
-      // Update the remote endpoint.
-      ql_read_req.set_allocated_remote_endpoint(read_context->host_port_pb);
-      ql_read_req.set_allocated_proxy_uuid(mutable_req->mutable_proxy_uuid());
+      // Update the remote endpoint. The request could be on the arena of the call, which would take
+      // ownership of an endpoint set with set_allocated_remote_endpoint().
+      ql_read_req.unsafe_arena_set_allocated_remote_endpoint(read_context->host_port_pb);
+      ql_read_req.set_proxy_uuid(mutable_req->proxy_uuid());
       BOOST_SCOPE_EXIT(&ql_read_req) {
-        ql_read_req.release_remote_endpoint();
-        ql_read_req.release_proxy_uuid();
+        ql_read_req.unsafe_arena_release_remote_endpoint();
+        ql_read_req.clear_proxy_uuid();
       } BOOST_SCOPE_EXIT_END;
 
       tablet::QLReadRequestResult result;
@@ -1321,6 +1530,57 @@ void ConsensusServiceImpl::UpdateConsensus(const ConsensusRequestPB* req,
   context.RespondSuccess();
 }
 
+void ConsensusServiceImpl::MultiUpdateConsensus(const consensus::MultiConsensusRequestPB* req,
+                                                consensus::MultiConsensusResponsePB* resp,
+                                                rpc::RpcContext context) {
+  DVLOG(3) << "Received Multi Consensus Update RPC with " << req->requests_size() << " requests";
+  const string& local_uuid = tablet_manager_->NodeInstance().permanent_uuid();
+  auto* requests = const_cast<consensus::MultiConsensusRequestPB*>(req)->mutable_requests();
+  resp->mutable_responses()->Reserve(requests->size());
+  for (auto& request : *requests) {
+    auto* response = resp->add_responses();
+    auto code = TabletServerErrorPB::UNKNOWN_ERROR;
+    auto status = UpdateConsensusInBatch(local_uuid, &request, response, &code);
+    if (PREDICT_FALSE(!status.ok())) {
+      response->Clear();
+      SetupError(response->mutable_error(), status, code);
+    }
+  }
+  context.RespondSuccess();
+}
+
+Status ConsensusServiceImpl::UpdateConsensusInBatch(const string& local_uuid,
+                                                    consensus::ConsensusRequestPB* req,
+                                                    consensus::ConsensusResponsePB* resp,
+                                                    TabletServerErrorPB::Code* error_code) {
+  if (PREDICT_FALSE(req->dest_uuid() != local_uuid)) {
+    *error_code = TabletServerErrorPB::WRONG_SERVER_UUID;
+    return STATUS_FORMAT(InvalidArgument,
+                         "MultiUpdateConsensus: Wrong destination UUID requested. "
+                         "Local UUID: $0. Requested UUID: $1", local_uuid, req->dest_uuid());
+  }
+
+  shared_ptr<TabletPeer> tablet_peer;
+  Status s = tablet_manager_->GetTabletPeer(req->tablet_id(), &tablet_peer);
+  if (PREDICT_FALSE(!s.ok())) {
+    *error_code = s.IsServiceUnavailable() ? TabletServerErrorPB::UNKNOWN_ERROR
+                                           : TabletServerErrorPB::TABLET_NOT_FOUND;
+    return s;
+  }
+  auto state = tablet_peer->state();
+  if (PREDICT_FALSE(state != tablet::RUNNING)) {
+    *error_code = TabletServerErrorPB::TABLET_NOT_RUNNING;
+    return STATUS(IllegalState, "Tablet not RUNNING", tablet::TabletStatePB_Name(state));
+  }
+  auto consensus = tablet_peer->shared_consensus();
+  if (!consensus) {
+    *error_code = TabletServerErrorPB::TABLET_NOT_RUNNING;
+    return STATUS(ServiceUnavailable, "Consensus unavailable. Tablet not running");
+  }
+
+  return consensus->Update(req, resp);
+}
+
 void ConsensusServiceImpl::RequestConsensusVote(const VoteRequestPB* req,
                                                 VoteResponsePB* resp,
                                                 rpc::RpcContext context) {
@@ -1444,6 +1704,13 @@ void ConsensusServiceImpl::RunLeaderElection(const RunLeaderElectionRequestPB* r
   if (!scope) {
     return;
   }
+  if (req->has_lease_transfer()) {
+    Status s = scope->AcceptLeaseTransfer(req->lease_transfer());
+    if (!s.ok()) {
+      scope.CheckStatus(s, resp);
+      return;
+    }
+  }
   Status s = scope->StartElection(
       consensus::Consensus::ELECT_EVEN_IF_LEADER_IS_ALIVE,
       req->has_committed_index(),
@@ -1565,6 +1832,10 @@ void TabletServiceImpl::Publish(
     const PublishRequestPB* req, PublishResponsePB* resp, rpc::RpcContext context) {
   rpc::Publisher* publisher = server_->GetPublisher();
   resp->set_num_clients_forwarded_to(publisher ? (*publisher)(req->channel(), req->message()) : 0);
+  for (const auto& batched : req->batched_messages()) {
+    resp->add_batched_num_clients_forwarded_to(
+        publisher ? (*publisher)(batched.channel(), batched.message()) : 0);
+  }
   context.RespondSuccess();
 }
 
@@ -1623,18 +1894,37 @@ void TabletServiceImpl::ListTabletsForTabletServer(const ListTabletsForTabletSer
 
 namespace {
 
-Result<uint64_t> CalcChecksum(tablet::Tablet* tablet) {
+// The rate of a throttled scan is checked after this many bytes are read.
+constexpr size_t kChecksumRateCheckBytes = 1_MB;
+
+// Replicas checksummed at the same read time have the same checksum when they are consistent.
+Result<uint64_t> CalcChecksum(
+    tablet::Tablet* tablet, const ReadHybridTime& read_time, CoarseTimePoint deadline) {
   const Schema& schema = tablet->metadata()->schema();
   auto client_schema = schema.CopyWithoutColumnIds();
-  auto iter = tablet->NewRowIterator(client_schema, boost::none);
+  auto iter = tablet->NewRowIterator(client_schema, boost::none, "" /* table_id */, read_time,
+                                     deadline);
   RETURN_NOT_OK(iter);
 
+  std::unique_ptr<RateLimiter> rate_limiter;
+  if (FLAGS_checksum_scan_max_bytes_per_sec > 0) {
+    rate_limiter = std::make_unique<RateLimiter>([] {
+      return static_cast<uint64_t>(std::max<int64_t>(FLAGS_checksum_scan_max_bytes_per_sec, 1));
+    });
+    rate_limiter->Init();
+  }
+
   QLTableRow value_map;
   ScanResultChecksummer collector;
+  size_t unthrottled_bytes = 0;
 
   while ((**iter).HasNext()) {
     RETURN_NOT_OK((**iter).NextRow(&value_map));
-    collector.HandleRow(schema, value_map);
+    unthrottled_bytes += collector.HandleRow(schema, value_map);
+    if (rate_limiter && unthrottled_bytes >= kChecksumRateCheckBytes) {
+      rate_limiter->UpdateDataSizeAndMaybeSleep(unthrottled_bytes);
+      unthrottled_bytes = 0;
+    }
   }
 
   return collector.agg_checksum();
@@ -1651,7 +1941,8 @@ void TabletServiceImpl::Checksum(const ChecksumRequestPB* req,
   if (!DoGetTabletOrRespond(req, resp, &context, &abstract_tablet)) {
     return;
   }
-  auto checksum = CalcChecksum(down_cast<tablet::Tablet*>(abstract_tablet.get()));
+  auto checksum = CalcChecksum(down_cast<tablet::Tablet*>(abstract_tablet.get()),
+                               ReadHybridTime::FromReadTimePB(*req), context.GetClientDeadline());
   if (!checksum.ok()) {
     SetupErrorAndRespond(resp->mutable_error(), checksum.status(),
                          TabletServerErrorPB::UNKNOWN_ERROR, &context);
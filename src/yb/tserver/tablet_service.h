@@ -116,6 +116,10 @@ class TabletServiceImpl : public TabletServerServiceIf {
                 TruncateResponsePB* resp,
                 rpc::RpcContext context) override;
 
+  void IngestExternalFiles(const IngestExternalFilesRequestPB* req,
+                           IngestExternalFilesResponsePB* resp,
+                           rpc::RpcContext context) override;
+
   void GetTabletStatus(const GetTabletStatusRequestPB* req,
                        GetTabletStatusResponsePB* resp,
                        rpc::RpcContext context) override;
@@ -165,6 +169,10 @@ class TabletServiceAdminImpl : public TabletServerAdminServiceIf {
                     CreateTabletResponsePB* resp,
                     rpc::RpcContext context) override;
 
+  void CreateTablets(const CreateTabletsRequestPB* req,
+                     CreateTabletsResponsePB* resp,
+                     rpc::RpcContext context) override;
+
   void DeleteTablet(const DeleteTabletRequestPB* req,
                     DeleteTabletResponsePB* resp,
                     rpc::RpcContext context) override;
@@ -182,6 +190,9 @@ class TabletServiceAdminImpl : public TabletServerAdminServiceIf {
                     rpc::RpcContext context) override;
 
  private:
+  // Creates the tablet of 'req', setting 'code' on failure.
+  CHECKED_STATUS DoCreateTablet(const CreateTabletRequestPB& req, TabletServerErrorPB::Code* code);
+
   TabletServer* server_;
 };
 
@@ -196,6 +207,10 @@ class ConsensusServiceImpl : public consensus::ConsensusServiceIf {
                                consensus::ConsensusResponsePB *resp,
                                rpc::RpcContext context) override;
 
+  virtual void MultiUpdateConsensus(const consensus::MultiConsensusRequestPB* req,
+                                    consensus::MultiConsensusResponsePB* resp,
+                                    rpc::RpcContext context) override;
+
   virtual void RequestConsensusVote(const consensus::VoteRequestPB* req,
                                     consensus::VoteResponsePB* resp,
                                     rpc::RpcContext context) override;
@@ -233,6 +248,13 @@ class ConsensusServiceImpl : public consensus::ConsensusServiceIf {
                                     rpc::RpcContext context) override;
 
  private:
+  // Handles a single request of MultiUpdateConsensus, returning the error that UpdateConsensus
+  // would have responded with.
+  CHECKED_STATUS UpdateConsensusInBatch(const std::string& local_uuid,
+                                        consensus::ConsensusRequestPB* req,
+                                        consensus::ConsensusResponsePB* resp,
+                                        TabletServerErrorPB::Code* error_code);
+
   TabletPeerLookupIf* tablet_manager_;
 };
 
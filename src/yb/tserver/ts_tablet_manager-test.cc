@@ -48,8 +48,10 @@
 #include "yb/tablet/tablet-test-util.h"
 #include "yb/tserver/mini_tablet_server.h"
 #include "yb/tserver/tablet_server.h"
+#include "yb/util/pb_util.h"
 #include "yb/util/test_util.h"
 #include "yb/util/format.h"
+#include "yb/util/size_literals.h"
 
 #define ASSERT_REPORT_HAS_UPDATED_TABLET(report, tablet_id) \
   ASSERT_NO_FATALS(AssertReportHasUpdatedTablet(report, tablet_id))
@@ -58,6 +60,7 @@
   ASSERT_NO_FATALS(AssertMonotonicReportSeqno(report_seqno, tablet_report))
 
 DECLARE_bool(pretend_memory_exceeded_enforce_flush);
+DECLARE_int32(memstore_flush_age_boost_sec);
 
 namespace yb {
 namespace tserver {
@@ -72,6 +75,8 @@ using master::TabletReportPB;
 using tablet::TabletPeer;
 using gflags::FlagSaver;
 
+using namespace yb::size_literals;
+
 static const char* const kTabletId = "my-tablet-id";
 
 class TsTabletManagerTest : public YBTest {
@@ -201,6 +206,50 @@ TEST_F(TsTabletManagerTest, TestProperBackgroundFlushOnStartup) {
   }
 }
 
+TEST_F(TsTabletManagerTest, TestTabletOpenHints) {
+  std::vector<scoped_refptr<tablet::TabletMetadata>> metas;
+  for (int i = 0; i < 3; ++i) {
+    std::shared_ptr<TabletPeer> peer;
+    ASSERT_OK(CreateNewTablet(Format("tablet-$0", i + 1), schema_, &peer));
+    metas.push_back(peer->tablet_metadata());
+  }
+
+  // All the tablets are led by this server, so all of them are opened before unknown tablets.
+  ASSERT_OK(tablet_manager_->PersistTabletOpenHints());
+  TabletOpenHintsPB hints;
+  ASSERT_OK(pb_util::ReadPBContainerFromPath(
+      fs_manager_->env(), fs_manager_->GetTabletOpenHintsPath(), &hints));
+  ASSERT_EQ(3, hints.tablets_size());
+  for (const auto& hint : hints.tablets()) {
+    ASSERT_TRUE(hint.was_leader()) << hint.ShortDebugString();
+  }
+
+  // Former leaders go first, then the other known tablets in order, then the unknown ones.
+  hints.Clear();
+  auto* hint = hints.add_tablets();
+  hint->set_tablet_id("tablet-3");
+  hint->set_was_leader(false);
+  hint = hints.add_tablets();
+  hint->set_tablet_id("tablet-2");
+  hint->set_was_leader(true);
+  TSTabletManager::OrderTabletsToOpen(hints, &metas);
+  std::vector<std::string> order;
+  for (const auto& meta : metas) {
+    order.push_back(meta->tablet_id());
+  }
+  ASSERT_EQ((std::vector<std::string>{"tablet-2", "tablet-3", "tablet-1"}), order);
+
+  // The hints are persisted on shutdown, and a restart opens all the tablets.
+  mini_server_->Shutdown();
+  CreateMiniTabletServer();
+  ASSERT_OK(mini_server_->Start());
+  ASSERT_OK(mini_server_->WaitStarted());
+  for (const auto& tablet_id : order) {
+    std::shared_ptr<TabletPeer> peer;
+    ASSERT_TRUE(mini_server_->server()->tablet_manager()->LookupTablet(tablet_id, &peer));
+  }
+}
+
 static void AssertMonotonicReportSeqno(int64_t* report_seqno,
                                        const TabletReportPB &report) {
   ASSERT_LT(*report_seqno, report.sequence_number());
@@ -233,6 +282,29 @@ static void AssertReportHasUpdatedTablet(const TabletReportPB& report,
   ASSERT_TRUE(found_tablet);
 }
 
+TEST(MemstoreFlushScoreTest, Order) {
+  MemstoreFlushCandidate small;
+  small.memstore_bytes = 64_KB;
+  small.memstore_age = MonoDelta::FromSeconds(1);
+
+  MemstoreFlushCandidate large = small;
+  large.memstore_bytes = 64_MB;
+  ASSERT_GT(MemstoreFlushScore(large), MemstoreFlushScore(small));
+
+  // Retained WAL makes a flush more worthwhile.
+  MemstoreFlushCandidate large_with_wal = large;
+  large_with_wal.retained_wal_bytes = 1_GB;
+  ASSERT_GT(MemstoreFlushScore(large_with_wal), MemstoreFlushScore(large));
+
+  // An old memstore overtakes a slightly larger young one.
+  MemstoreFlushCandidate old = large;
+  old.memstore_bytes = 32_MB;
+  old.memstore_age = MonoDelta::FromSeconds(FLAGS_memstore_flush_age_boost_sec * 2);
+  ASSERT_GT(MemstoreFlushScore(old), MemstoreFlushScore(large));
+
+  ASSERT_EQ(0, MemstoreFlushScore(MemstoreFlushCandidate()));
+}
+
 TEST_F(TsTabletManagerTest, TestTabletReports) {
   TabletReportPB report;
   int64_t seqno = -1;
@@ -50,12 +50,18 @@
 #include "yb/consensus/log.h"
 #include "yb/consensus/log_anchor_registry.h"
 #include "yb/consensus/metadata.pb.h"
+#include "yb/consensus/multi_raft_batcher.h"
 #include "yb/consensus/opid_util.h"
 #include "yb/consensus/quorum_util.h"
 #include "yb/consensus/retryable_requests.h"
 
+#include "yb/docdb/compaction_rate_tuner.h"
+#include "yb/docdb/docdb_rocksdb_util.h"
+
 #include "yb/fs/fs_manager.h"
 
+#include "yb/gutil/strings/numbers.h"
+#include "yb/gutil/strings/split.h"
 #include "yb/gutil/strings/substitute.h"
 #include "yb/gutil/strings/util.h"
 
@@ -87,6 +93,7 @@
 #include "yb/util/mem_tracker.h"
 #include "yb/util/metrics.h"
 #include "yb/util/pb_util.h"
+#include "yb/util/size_literals.h"
 #include "yb/util/stopwatch.h"
 #include "yb/util/trace.h"
 #include "yb/util/tsan_util.h"
@@ -94,6 +101,10 @@
 
 using namespace std::literals;
 using namespace std::placeholders;
+using namespace yb::size_literals;
+
+DECLARE_int64(rocksdb_compact_flush_rate_limit_bytes_per_sec);
+DECLARE_bool(rocksdb_compaction_rate_auto_tune);
 
 DEFINE_int32(num_tablets_to_open_simultaneously, 0,
              "Number of threads available to open tablets during startup. If this "
@@ -112,6 +123,18 @@ DEFINE_int32(db_block_cache_num_shard_bits, 4,
              "Number of bits to use for sharding the block cache (defaults to 4 bits)");
 TAG_FLAG(db_block_cache_num_shard_bits, advanced);
 
+DEFINE_string(db_block_cache_type, "lru",
+              "Replacement policy of the block cache: lru, or clock for a cache that does not take "
+              "a mutex on lookups.");
+TAG_FLAG(db_block_cache_type, advanced);
+
+DEFINE_string(db_block_cache_priority_class_reserved_percentages, "",
+              "Comma separated percentages of the block cache reserved for each priority class, "
+              "starting with class 0. Blocks of a class are not evicted on behalf of other "
+              "classes while the class uses no more than its reservation. Tables pick their class "
+              "with the block_cache_priority_class table property. Ignored by the clock cache.");
+TAG_FLAG(db_block_cache_priority_class_reserved_percentages, advanced);
+
 DEFINE_test_flag(double, fault_crash_after_blocks_deleted, 0.0,
                  "Fraction of the time when the tablet will crash immediately "
                  "after deleting the data blocks during tablet deletion.");
@@ -153,6 +176,22 @@ DEFINE_int64(global_memstore_size_mb_max, 2048,
              "memory. However, this flag limits it in absolute size. Value of 0 "
              "means no limit on the value obtained by the percentage. Default is 2048.");
 
+DEFINE_double(memstore_flush_wal_bytes_weight, 0.5,
+              "When memory is exceeded, the tablet to flush is chosen by the memory and WAL space "
+              "the flush frees. This is the weight of a byte of retained WAL relative to a byte of "
+              "memstore.");
+TAG_FLAG(memstore_flush_wal_bytes_weight, advanced);
+
+DEFINE_uint64(memstore_flush_fixed_cost_bytes, 1_MB,
+              "Fixed overhead of a memstore flush, expressed in bytes of memstore. Makes flushing "
+              "many small memstores less attractive than flushing one large memstore.");
+TAG_FLAG(memstore_flush_fixed_cost_bytes, advanced);
+
+DEFINE_int32(memstore_flush_age_boost_sec, 600,
+             "Age of the oldest write in a memstore that doubles its priority for flushing when "
+             "memory is exceeded. Value of 0 means that age is not taken into account.");
+TAG_FLAG(memstore_flush_age_boost_sec, advanced);
+
 DEFINE_int64(db_block_cache_size_bytes, kDbCacheSizeUsePercentage,
              "Size of cross-tablet shared RocksDB block cache (in bytes). "
              "This defaults to -1 for system auto-generated default, which would use "
@@ -163,6 +202,38 @@ DEFINE_int32(db_block_cache_size_percentage, 50,
              "Default percentage of total available memory to use as block cache size, if not "
              "asking for a raw number, through FLAGS_db_block_cache_size_bytes.");
 
+DEFINE_int32(rocksdb_compaction_rate_tune_interval_ms, 5000,
+             "How often the compaction and flush rate limit shared by all tablets is adjusted, "
+             "when rocksdb_compaction_rate_auto_tune is set.");
+TAG_FLAG(rocksdb_compaction_rate_tune_interval_ms, advanced);
+
+DEFINE_int32(tablet_hibernation_idle_secs, 0,
+             "Tablets that were not read or written for this many seconds are put in hibernation: "
+             "their memtables are flushed, their row caches cleared and their SST file readers "
+             "released, until the next read or write. 0 disables hibernation.");
+TAG_FLAG(tablet_hibernation_idle_secs, advanced);
+TAG_FLAG(tablet_hibernation_idle_secs, runtime);
+
+DEFINE_int32(tablet_hibernation_check_interval_ms, 60000,
+             "How often tablets are checked for hibernation, see tablet_hibernation_idle_secs.");
+TAG_FLAG(tablet_hibernation_check_interval_ms, advanced);
+
+DEFINE_bool(prioritize_tablet_open, true,
+            "Open the tablets on startup in the order of the hints persisted before the tablet "
+            "server stopped: the tablets it was the leader of first, then the most recently "
+            "accessed ones, so that they become available first.");
+TAG_FLAG(prioritize_tablet_open, advanced);
+
+DEFINE_int32(tablet_open_hints_persist_interval_ms, 300000,
+             "How often the hints used by prioritize_tablet_open are persisted, in addition to "
+             "persisting them on shutdown. 0 only persists them on shutdown.");
+TAG_FLAG(tablet_open_hints_persist_interval_ms, advanced);
+
+DEFINE_int32(log_allocation_pool_max_threads, 8,
+             "Maximum number of threads shared by the logs of all tablets for pre-allocating "
+             "their segments.");
+TAG_FLAG(log_allocation_pool_max_threads, advanced);
+
 DEFINE_int32(read_pool_max_threads, 128,
              "The maximum number of threads allowed for read_pool_. This pool is used "
              "to run multiple read operations, that are part of the same tablet rpc, "
@@ -181,6 +252,8 @@ DEFINE_int32(tserver_yb_client_default_timeout_ms, kTServerYbClientDefaultTimeou
              "Default timeout for the YBClient embedded into the tablet server that is used "
              "for distributed transactions.");
 
+DECLARE_int64(db_block_size_bytes);
+
 namespace yb {
 namespace tserver {
 
@@ -205,6 +278,29 @@ METRIC_DEFINE_histogram(server, op_apply_run_time, "Operation Apply Run Time",
                         "that operations consist of very large batches.",
                         10000000, 2);
 
+METRIC_DEFINE_counter(server, memstore_flushes_scheduled, "Memstore Flushes Scheduled",
+                      MetricUnit::kOperations,
+                      "Number of memstore flushes scheduled because the global memstore limit "
+                      "was exceeded.");
+
+METRIC_DEFINE_histogram(server, memstore_flush_bytes, "Memstore Flush Bytes",
+                        MetricUnit::kBytes,
+                        "Size of the memstores chosen for flushing because the global memstore "
+                        "limit was exceeded.",
+                        1024 * 1024 * 1024, 2);
+
+METRIC_DEFINE_histogram(server, memstore_flush_retained_wal_bytes,
+                        "Memstore Flush Retained WAL Bytes",
+                        MetricUnit::kBytes,
+                        "Size of the WAL retained by the memstores chosen for flushing because the "
+                        "global memstore limit was exceeded.",
+                        16LL * 1024 * 1024 * 1024, 2);
+
+METRIC_DEFINE_gauge_uint64(server, hibernating_tablets, "Hibernating Tablets",
+                           MetricUnit::kUnits,
+                           "Number of tablets that were put in hibernation because they were idle "
+                           "and were not accessed since then.");
+
 METRIC_DEFINE_histogram(server, op_read_queue_length, "Operation Read op Queue Length",
                         MetricUnit::kTasks,
                         "Number of operations waiting to be applied to the tablet. "
@@ -254,36 +350,164 @@ using tablet::TabletStatusListener;
 using tablet::TabletStatusPB;
 
 // Only called from the background task to ensure it's synchronized
+double MemstoreFlushScore(const MemstoreFlushCandidate& candidate) {
+  const double memstore_bytes = candidate.memstore_bytes;
+  const double freed_bytes =
+      memstore_bytes + FLAGS_memstore_flush_wal_bytes_weight * candidate.retained_wal_bytes;
+  // Fraction of the flush work that actually goes into writing the memstore.
+  const double efficiency =
+      memstore_bytes / (memstore_bytes + FLAGS_memstore_flush_fixed_cost_bytes + 1);
+  double age_factor = 1.0;
+  if (FLAGS_memstore_flush_age_boost_sec > 0 && candidate.memstore_age.Initialized()) {
+    age_factor += candidate.memstore_age.ToSeconds() / FLAGS_memstore_flush_age_boost_sec;
+  }
+  return freed_bytes * efficiency * age_factor;
+}
+
 void TSTabletManager::MaybeFlushTablet() {
   int iteration = 0;
   while (memory_monitor()->Exceeded() ||
          (iteration++ == 0 && FLAGS_pretend_memory_exceeded_enforce_flush)) {
-    TabletPeerPtr tablet_to_flush = TabletToFlush();
+    MemstoreFlushCandidate candidate;
+    TabletPeerPtr tablet_to_flush = TabletToFlush(&candidate);
     // TODO(bojanserafimov): If tablet_to_flush flushes now because of other reasons,
     // we will schedule a second flush, which will unnecessarily stall writes for a short time. This
     // will not happen often, but should be fixed.
-    if (tablet_to_flush) {
-      WARN_NOT_OK(tablet_to_flush->tablet()->Flush(tablet::FlushMode::kAsync),
-          Substitute("Flush failed on $0", tablet_to_flush->tablet_id()));
+    if (!tablet_to_flush) {
+      break;
     }
+    VLOG(1) << "Flushing " << tablet_to_flush->tablet_id() << ": memstore "
+            << candidate.memstore_bytes << " bytes, retained WAL " << candidate.retained_wal_bytes
+            << " bytes, age " << candidate.memstore_age;
+    memstore_flushes_scheduled_->Increment();
+    memstore_flush_bytes_->Increment(candidate.memstore_bytes);
+    memstore_flush_retained_wal_bytes_->Increment(candidate.retained_wal_bytes);
+    WARN_NOT_OK(tablet_to_flush->tablet()->Flush(tablet::FlushMode::kAsync),
+        Substitute("Flush failed on $0", tablet_to_flush->tablet_id()));
   }
 }
 
-// Return the tablet with the oldest write in memstore, or nullptr if all
-// tablet memstores are empty or about to flush.
-TabletPeerPtr TSTabletManager::TabletToFlush() {
+// Only called from the compaction rate tuner background task.
+void TSTabletManager::TuneCompactionRateLimiter() {
+  docdb::CompactionRateTuner::Signals signals;
+  for (const TabletPeerPtr& peer : GetTabletPeers()) {
+    const auto tablet = peer->shared_tablet();
+    if (tablet) {
+      tablet->AddCompactionRateSignals(&signals);
+    }
+  }
+  compaction_rate_tuner_->Update(signals);
+}
+
+// Only called from the hibernation background task.
+void TSTabletManager::HibernateIdleTablets() {
+  const int32_t idle_secs = FLAGS_tablet_hibernation_idle_secs;
+  uint64_t hibernating_tablets = 0;
+  for (const TabletPeerPtr& peer : GetTabletPeers()) {
+    const auto tablet = peer->shared_tablet();
+    if (!tablet || peer->state() != tablet::RUNNING) {
+      continue;
+    }
+    if (idle_secs > 0) {
+      auto hibernated = tablet->HibernateIfIdle(std::chrono::seconds(idle_secs));
+      if (!hibernated.ok()) {
+        LOG(WARNING) << "Failed to hibernate tablet " << peer->tablet_id() << ": "
+                     << hibernated.status();
+      } else if (*hibernated) {
+        VLOG(1) << "Hibernated tablet " << peer->tablet_id();
+      }
+    }
+    if (tablet->hibernating()) {
+      ++hibernating_tablets;
+    }
+  }
+  hibernating_tablets_->set_value(hibernating_tablets);
+}
+
+Status TSTabletManager::PersistTabletOpenHints() {
+  struct TabletHint {
+    std::string tablet_id;
+    bool was_leader;
+    CoarseTimePoint last_access_time;
+  };
+  std::vector<TabletHint> tablets;
+  for (const TabletPeerPtr& peer : GetTabletPeers()) {
+    const auto tablet = peer->shared_tablet();
+    // Tablets that are still being opened go last, since nothing accessed them yet.
+    tablets.push_back(TabletHint{
+        peer->tablet_id(),
+        tablet && peer->LeaderStatus() != consensus::LeaderStatus::NOT_LEADER,
+        tablet ? tablet->last_access_time() : CoarseTimePoint::min()});
+  }
+  std::stable_sort(tablets.begin(), tablets.end(),
+                   [](const TabletHint& lhs, const TabletHint& rhs) {
+    return lhs.last_access_time > rhs.last_access_time;
+  });
+
+  TabletOpenHintsPB hints;
+  for (const auto& tablet : tablets) {
+    auto* hint = hints.add_tablets();
+    hint->set_tablet_id(tablet.tablet_id);
+    hint->set_was_leader(tablet.was_leader);
+  }
+  // Losing the hints only makes the next start open the tablets in a worse order.
+  return pb_util::WritePBContainerToPath(
+      fs_manager_->env(), fs_manager_->GetTabletOpenHintsPath(), hints, pb_util::OVERWRITE,
+      pb_util::NO_SYNC);
+}
+
+void TSTabletManager::OrderTabletsToOpen(
+    const TabletOpenHintsPB& hints, std::vector<scoped_refptr<TabletMetadata>>* metas) {
+  // Former leaders get the ranks before all the other tablets, and the tablets missing from hints
+  // the ranks after them.
+  const size_t num_hints = hints.tablets_size();
+  std::unordered_map<std::string, size_t> ranks;
+  for (size_t i = 0; i != num_hints; ++i) {
+    const auto& hint = hints.tablets(i);
+    ranks.emplace(hint.tablet_id(), hint.was_leader() ? i : num_hints + i);
+  }
+  const size_t missing_rank = 2 * num_hints;
+  auto rank = [&ranks, missing_rank](const scoped_refptr<TabletMetadata>& meta) {
+    auto it = ranks.find(meta->tablet_id());
+    return it != ranks.end() ? it->second : missing_rank;
+  };
+  std::stable_sort(metas->begin(), metas->end(),
+                   [&rank](const scoped_refptr<TabletMetadata>& lhs,
+                           const scoped_refptr<TabletMetadata>& rhs) {
+    return rank(lhs) < rank(rhs);
+  });
+}
+
+TabletPeerPtr TSTabletManager::TabletToFlush(MemstoreFlushCandidate* candidate) {
   boost::shared_lock<RWMutex> lock(lock_); // For using the tablet map
-  HybridTime oldest_write_in_memstores = HybridTime::kMax;
+  double best_score = -1;
   TabletPeerPtr tablet_to_flush;
   for (const TabletMap::value_type& entry : tablet_map_) {
     const auto tablet = entry.second->shared_tablet();
-    if (tablet) {
-      const HybridTime oldest_write_in_memstore = tablet->flush_stats()->oldest_write_in_memstore();
-      if (oldest_write_in_memstore < oldest_write_in_memstores) {
-        oldest_write_in_memstores = oldest_write_in_memstore;
-        tablet_to_flush = entry.second;
+    if (!tablet) {
+      continue;
+    }
+    const HybridTime oldest_write_in_memstore = tablet->flush_stats()->oldest_write_in_memstore();
+    // kMax means that the memstore is empty or that a flush is already scheduled.
+    if (oldest_write_in_memstore == HybridTime::kMax) {
+      continue;
+    }
+    MemstoreFlushCandidate current;
+    current.memstore_bytes = tablet->GetMemTablesSize();
+    tablet::TabletPeer::MaxIdxToSegmentSizeMap idx_size_map;
+    if (entry.second->GetMaxIndexesToSegmentSizeMap(&idx_size_map).ok()) {
+      for (const auto& idx_and_size : idx_size_map) {
+        current.retained_wal_bytes += idx_and_size.second;
       }
     }
+    const int64_t age_us = tablet->clock()->Now().PhysicalDiff(oldest_write_in_memstore);
+    current.memstore_age = MonoDelta::FromMicroseconds(std::max<int64_t>(age_us, 0));
+    const double score = MemstoreFlushScore(current);
+    if (score > best_score) {
+      best_score = score;
+      *candidate = current;
+      tablet_to_flush = entry.second;
+    }
   }
   return tablet_to_flush;
 }
@@ -302,6 +526,13 @@ TSTabletManager::TSTabletManager(FsManager* fs_manager,
       METRIC_op_apply_queue_time.Instantiate(server_->metric_entity()),
       METRIC_op_apply_run_time.Instantiate(server_->metric_entity())
   };
+  memstore_flushes_scheduled_ =
+      METRIC_memstore_flushes_scheduled.Instantiate(server_->metric_entity());
+  memstore_flush_bytes_ = METRIC_memstore_flush_bytes.Instantiate(server_->metric_entity());
+  memstore_flush_retained_wal_bytes_ =
+      METRIC_memstore_flush_retained_wal_bytes.Instantiate(server_->metric_entity());
+  hibernating_tablets_ = METRIC_hibernating_tablets.Instantiate(server_->metric_entity(), 0);
+
   CHECK_OK(ThreadPoolBuilder("apply")
                .set_metrics(std::move(metrics))
                .Build(&apply_pool_));
@@ -323,6 +554,10 @@ TSTabletManager::TSTabletManager(FsManager* fs_manager,
                .unlimited_threads()
                .set_idle_timeout(MonoDelta::FromMilliseconds(10000))
                .Build(&append_pool_));
+  // Each log allocates its segments through its own serial token, so the logs take turns.
+  CHECK_OK(ThreadPoolBuilder("log-alloc")
+               .set_max_threads(FLAGS_log_allocation_pool_max_threads)
+               .Build(&log_allocation_pool_));
   ThreadPoolMetrics read_metrics = {
       METRIC_op_read_queue_length.Instantiate(server_->metric_entity()),
       METRIC_op_read_queue_time.Instantiate(server_->metric_entity()),
@@ -348,9 +583,35 @@ TSTabletManager::TSTabletManager(FsManager* fs_manager,
     block_cache_size_bytes = total_ram_avail * FLAGS_db_block_cache_size_percentage / 100;
   }
   if (FLAGS_db_block_cache_size_bytes != kDbCacheSizeCacheDisabled) {
-    tablet_options_.block_cache = rocksdb::NewLRUCache(block_cache_size_bytes,
-                                                       FLAGS_db_block_cache_num_shard_bits);
+    if (FLAGS_db_block_cache_type == "clock") {
+      tablet_options_.block_cache = rocksdb::NewClockCache(
+          block_cache_size_bytes, FLAGS_db_block_cache_num_shard_bits,
+          /* strict_capacity_limit */ false, FLAGS_db_block_size_bytes);
+    } else {
+      LOG_IF(DFATAL, FLAGS_db_block_cache_type != "lru")
+          << "Unknown block cache type: " << FLAGS_db_block_cache_type;
+      tablet_options_.block_cache = rocksdb::NewLRUCache(block_cache_size_bytes,
+                                                         FLAGS_db_block_cache_num_shard_bits);
+    }
     tablet_options_.block_cache->SetMetrics(server_->metric_entity());
+
+    const vector<string> reserved_percentages = strings::Split(
+        FLAGS_db_block_cache_priority_class_reserved_percentages, ",", strings::SkipEmpty());
+    CHECK_LE(reserved_percentages.size(), rocksdb::kNumCachePriorityClasses)
+        << "Too many block cache priority classes: "
+        << FLAGS_db_block_cache_priority_class_reserved_percentages;
+    int32_t total_reserved_percentage = 0;
+    for (size_t i = 0; i != reserved_percentages.size(); ++i) {
+      int32_t percentage = 0;
+      CHECK(safe_strto32(reserved_percentages[i], &percentage) && percentage >= 0)
+          << "Invalid block cache priority class reservation: " << reserved_percentages[i];
+      total_reserved_percentage += percentage;
+      tablet_options_.block_cache->SetPriorityClassReservedCapacity(
+          i, block_cache_size_bytes * percentage / 100);
+    }
+    CHECK_LE(total_reserved_percentage, 100)
+        << "Block cache priority class reservations exceed the capacity: "
+        << FLAGS_db_block_cache_priority_class_reserved_percentages;
   }
 
   // Calculate memstore_size_bytes
@@ -379,6 +640,33 @@ TSTabletManager::TSTabletManager(FsManager* fs_manager,
         std::function<void()>([this](){
                                 YB_WARN_NOT_OK(background_task_->Wake(), "Wakeup error"); }));
   }
+
+  tablet_options_.rate_limiter = docdb::CreateCompactionRateLimiter();
+  if (tablet_options_.rate_limiter && FLAGS_rocksdb_compaction_rate_auto_tune) {
+    compaction_rate_tuner_.reset(new docdb::CompactionRateTuner(
+        tablet_options_.rate_limiter, FLAGS_rocksdb_compact_flush_rate_limit_bytes_per_sec));
+    compaction_rate_task_.reset(new BackgroundTask(
+      std::function<void()>([this](){ TuneCompactionRateLimiter(); }),
+      "tablet manager",
+      "compaction rate tuner bgtask",
+      std::chrono::milliseconds(FLAGS_rocksdb_compaction_rate_tune_interval_ms)));
+  }
+
+  hibernation_task_.reset(new BackgroundTask(
+    std::function<void()>([this](){ HibernateIdleTablets(); }),
+    "tablet manager",
+    "tablet hibernation bgtask",
+    std::chrono::milliseconds(FLAGS_tablet_hibernation_check_interval_ms)));
+
+  if (FLAGS_prioritize_tablet_open && FLAGS_tablet_open_hints_persist_interval_ms > 0) {
+    tablet_open_hints_task_.reset(new BackgroundTask(
+      std::function<void()>([this](){
+        YB_WARN_NOT_OK(PersistTabletOpenHints(), "Failed to persist tablet open hints");
+      }),
+      "tablet manager",
+      "tablet open hints bgtask",
+      std::chrono::milliseconds(FLAGS_tablet_open_hints_persist_interval_ms)));
+  }
 }
 
 TSTabletManager::~TSTabletManager() {
@@ -393,6 +681,9 @@ Status TSTabletManager::Init() {
       &server_->options(), server_->metric_entity(), server_->mem_tracker(),
       server_->messenger());
 
+  multi_raft_manager_ = std::make_unique<consensus::MultiRaftManager>(
+      server_->messenger(), &server_->proxy_cache());
+
   // Start the threadpool we'll use to open tablets.
   // This has to be done in Init() instead of the constructor, since the
   // FsManager isn't initialized until this point.
@@ -440,7 +731,19 @@ Status TSTabletManager::Init() {
     metas.push_back(meta);
   }
 
-  // Now submit the "Open" task for each.
+  if (FLAGS_prioritize_tablet_open) {
+    TabletOpenHintsPB hints;
+    Status s = pb_util::ReadPBContainerFromPath(
+        fs_manager_->env(), fs_manager_->GetTabletOpenHintsPath(), &hints);
+    if (s.ok()) {
+      OrderTabletsToOpen(hints, &metas);
+    } else if (!s.IsNotFound()) {
+      LOG(WARNING) << "Failed to read tablet open hints, opening tablets in any order: " << s;
+    }
+  }
+
+  // Now submit the "Open" task for each. The bootstrap pool runs them in the order they were
+  // submitted.
   for (const scoped_refptr<TabletMetadata>& meta : metas) {
     scoped_refptr<TransitionInProgressDeleter> deleter;
     {
@@ -462,6 +765,16 @@ Status TSTabletManager::Init() {
     RETURN_NOT_OK(background_task_->Init());
   }
 
+  if (compaction_rate_task_) {
+    RETURN_NOT_OK(compaction_rate_task_->Init());
+  }
+
+  RETURN_NOT_OK(hibernation_task_->Init());
+
+  if (tablet_open_hints_task_) {
+    RETURN_NOT_OK(tablet_open_hints_task_->Init());
+  }
+
   return Status::OK();
 }
 
@@ -958,7 +1271,8 @@ void TSTabletManager::OpenTablet(const scoped_refptr<TabletMetadata>& meta,
         std::bind(&TSTabletManager::PreserveLocalLeadersOnly, this, _1),
         tablet_peer.get(),
         append_pool(),
-        &retryable_requests};
+        &retryable_requests,
+        log_allocation_pool_.get()};
     s = BootstrapTablet(data, &tablet, &log, &bootstrap_info);
     if (!s.ok()) {
       LOG(ERROR) << kLogPrefix << "Tablet failed to bootstrap: "
@@ -980,7 +1294,8 @@ void TSTabletManager::OpenTablet(const scoped_refptr<TabletMetadata>& meta,
                                     tablet->GetMetricEntity(),
                                     raft_pool(),
                                     tablet_prepare_pool(),
-                                    &retryable_requests);
+                                    &retryable_requests,
+                                    multi_raft_manager_.get());
 
     if (!s.ok()) {
       LOG(ERROR) << kLogPrefix << "Tablet failed to init: "
@@ -1018,6 +1333,20 @@ void TSTabletManager::StartShutdown() {
     background_task_->Shutdown();
   }
 
+  if (compaction_rate_task_) {
+    compaction_rate_task_->Shutdown();
+  }
+
+  hibernation_task_->Shutdown();
+
+  if (tablet_open_hints_task_) {
+    tablet_open_hints_task_->Shutdown();
+  }
+  // Persisted before the tablets are shut down, while they still know whether they are leaders.
+  if (FLAGS_prioritize_tablet_open && state() == MANAGER_RUNNING) {
+    YB_WARN_NOT_OK(PersistTabletOpenHints(), "Failed to persist tablet open hints");
+  }
+
   {
     std::lock_guard<RWMutex> lock(lock_);
     switch (state_) {
@@ -1068,6 +1397,9 @@ void TSTabletManager::CompleteShutdown() {
   if (tablet_prepare_pool_) {
     tablet_prepare_pool_->Shutdown();
   }
+  if (log_allocation_pool_) {
+    log_allocation_pool_->Shutdown();
+  }
   if (append_pool_) {
     append_pool_->Shutdown();
   }
@@ -58,6 +58,7 @@
 #include "yb/tserver/tserver_admin.pb.h"
 #include "yb/util/locks.h"
 #include "yb/util/metrics.h"
+#include "yb/util/monotime.h"
 #include "yb/util/rw_mutex.h"
 #include "yb/util/status.h"
 #include "yb/util/threadpool.h"
@@ -76,6 +77,10 @@ namespace consensus {
 class RaftConfigPB;
 } // namespace consensus
 
+namespace docdb {
+class CompactionRateTuner;
+} // namespace docdb
+
 namespace master {
 class ReportedTabletPB;
 class TabletReportPB;
@@ -121,6 +126,20 @@ class TransitionInProgressDeleter;
 // TODO: will also be responsible for keeping the local metadata about
 // which tablets are hosted on this server persistent on disk, as well
 // as re-opening all the tablets at startup, etc.
+// What the flush scheduler knows about the memstore of a tablet when memory is exceeded.
+struct MemstoreFlushCandidate {
+  uint64_t memstore_bytes = 0;
+  // Size of the WAL segments that could be GCed once the memstore is flushed.
+  uint64_t retained_wal_bytes = 0;
+  // Time since the oldest write that is still in the memstore.
+  MonoDelta memstore_age;
+};
+
+// Returns how worthwhile it is to flush the candidate: the memory and WAL space freed by the
+// flush, scaled down for small memstores whose flush cost is mostly fixed overhead, and scaled up
+// with the memstore age so that cold tablets are flushed eventually.
+double MemstoreFlushScore(const MemstoreFlushCandidate& candidate);
+
 class TSTabletManager : public tserver::TabletPeerLookupIf {
  public:
   typedef std::vector<std::shared_ptr<tablet::TabletPeer>> TabletPeers;
@@ -291,6 +310,22 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
   // Flush some tablet if the memstore memory limit is exceeded
   void MaybeFlushTablet();
 
+  // Adjust the compaction and flush rate limit shared by all tablets.
+  void TuneCompactionRateLimiter();
+
+  // Put the tablets that were idle for tablet_hibernation_idle_secs in hibernation.
+  void HibernateIdleTablets();
+
+  // Write the tablets hosted by this server to the tablet open hints file, from the most recently
+  // accessed one, so that the next start opens them in that order.
+  CHECKED_STATUS PersistTabletOpenHints();
+
+  // Reorder metas in the order the tablets should be opened according to hints: the tablets this
+  // server was the leader of first, then the other ones from the most recently accessed, then the
+  // tablets that hints do not know about.
+  static void OrderTabletsToOpen(const TabletOpenHintsPB& hints,
+                                 std::vector<scoped_refptr<tablet::TabletMetadata>>* metas);
+
  private:
   FRIEND_TEST(TsTabletManagerTest, TestPersistBlocks);
 
@@ -380,8 +415,9 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
   // TABLET_DATA_READY state. Generally, we tombstone the replica.
   CHECKED_STATUS HandleNonReadyTabletOnStartup(const scoped_refptr<tablet::TabletMetadata>& meta);
 
-  // Return the tablet with oldest write still in its memstore
-  std::shared_ptr<tablet::TabletPeer> TabletToFlush();
+  // Return the tablet with the highest MemstoreFlushScore, or nullptr if all tablet memstores are
+  // empty or about to flush.
+  std::shared_ptr<tablet::TabletPeer> TabletToFlush(MemstoreFlushCandidate* candidate);
 
   TSTabletManagerStatePB state() const {
     boost::shared_lock<RWMutex> lock(lock_);
@@ -454,15 +490,37 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
   // Thread pool for appender threads, shared between all tablets.
   std::unique_ptr<ThreadPool> append_pool_;
 
+  // Thread pool for pre-allocating log segments, shared between all tablets.
+  std::unique_ptr<ThreadPool> log_allocation_pool_;
+
   // Thread pool for read ops, that are run in parallel, shared between all tablets.
   std::unique_ptr<ThreadPool> read_pool_;
 
+  // Batches Raft heartbeats of all tablets going to the same tablet server.
+  std::unique_ptr<consensus::MultiRaftManager> multi_raft_manager_;
+
   // Used for scheduling flushes
   std::unique_ptr<BackgroundTask> background_task_;
 
-  // For block cache and memory monitor shared across tablets
+  // Flushes scheduled because memory was exceeded, and what they were expected to free.
+  scoped_refptr<Counter> memstore_flushes_scheduled_;
+  scoped_refptr<Histogram> memstore_flush_bytes_;
+  scoped_refptr<Histogram> memstore_flush_retained_wal_bytes_;
+
+  // For block cache, memory monitor and rate limiter shared across tablets
   tablet::TabletOptions tablet_options_;
 
+  // Used for auto tuning the shared compaction and flush rate limiter.
+  std::unique_ptr<docdb::CompactionRateTuner> compaction_rate_tuner_;
+  std::unique_ptr<BackgroundTask> compaction_rate_task_;
+
+  // Used for putting idle tablets in hibernation.
+  std::unique_ptr<BackgroundTask> hibernation_task_;
+  scoped_refptr<AtomicGauge<uint64_t>> hibernating_tablets_;
+
+  // Used for persisting the tablet open hints from time to time.
+  std::unique_ptr<BackgroundTask> tablet_open_hints_task_;
+
   boost::optional<yb::client::AsyncClientInitialiser> async_client_init_;
 
   TabletPeers shutting_down_peers_;
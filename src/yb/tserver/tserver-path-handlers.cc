@@ -43,19 +43,23 @@
 #include "yb/consensus/log_anchor_registry.h"
 #include "yb/consensus/quorum_util.h"
 #include "yb/gutil/map-util.h"
+#include "yb/gutil/strings/escaping.h"
 #include "yb/gutil/strings/human_readable.h"
 #include "yb/gutil/strings/join.h"
 #include "yb/gutil/strings/numbers.h"
 #include "yb/gutil/strings/substitute.h"
 #include "yb/server/webui_util.h"
+#include "yb/tablet/hot_keys.h"
 #include "yb/tablet/maintenance_manager.h"
 #include "yb/tablet/tablet.h"
 #include "yb/tablet/tablet.pb.h"
 #include "yb/tablet/tablet_bootstrap_if.h"
 #include "yb/tablet/tablet_metadata.h"
+#include "yb/tablet/tablet_metrics.h"
 #include "yb/tablet/tablet_peer.h"
 #include "yb/tserver/tablet_server.h"
 #include "yb/tserver/ts_tablet_manager.h"
+#include "yb/util/metrics.h"
 #include "yb/util/url-coding.h"
 
 namespace yb {
@@ -109,6 +113,12 @@ Status TabletServerPathHandlers::Register(Webserver* server) {
       "/", "Dashboards",
       std::bind(&TabletServerPathHandlers::HandleDashboardsPage, this, _1, _2), true /* styled */,
       true /* is_on_nav_bar */, "fa fa-dashboard");
+  server->RegisterPathHandler(
+      "/hot-keys", "", std::bind(&TabletServerPathHandlers::HandleHotKeysPage, this, _1, _2),
+      true /* styled */, false /* is_on_nav_bar */);
+  server->RegisterPathHandler(
+      "/tablet-io", "", std::bind(&TabletServerPathHandlers::HandleTabletIOPage, this, _1, _2),
+      true /* styled */, false /* is_on_nav_bar */);
   server->RegisterPathHandler(
       "/maintenance-manager", "",
       std::bind(&TabletServerPathHandlers::HandleMaintenanceManagerPage, this, _1, _2),
@@ -407,6 +417,11 @@ void TabletServerPathHandlers::HandleDashboardsPage(const Webserver::WebRequest&
   *output << GetDashboardLine("maintenance-manager", "Maintenance Manager",
                               "List of operations that are currently running and those "
                               "that are registered.");
+  *output << GetDashboardLine("hot-keys", "Hot Keys", "Most frequently read and written keys of "
+                                                      "each tablet.");
+  *output << GetDashboardLine("tablet-io", "Tablet I/O", "File I/O done for each tablet by "
+                                                         "reads, flushes, compactions and "
+                                                         "bootstraps.");
 }
 
 string TabletServerPathHandlers::GetDashboardLine(const std::string& link,
@@ -418,6 +433,109 @@ string TabletServerPathHandlers::GetDashboardLine(const std::string& link,
                     EscapeForHtmlToString(desc));
 }
 
+void TabletServerPathHandlers::HandleHotKeysPage(const Webserver::WebRequest& req,
+                                                 std::stringstream* output) {
+  const size_t limit = std::max(
+      ParseLeadingInt32Value(FindWithDefault(req.parsed_args, "limit", "").c_str(), 10), 1);
+
+  vector<std::shared_ptr<TabletPeer>> peers;
+  tserver_->tablet_manager()->GetTabletPeers(&peers);
+
+  struct TabletHotKeys {
+    std::shared_ptr<TabletPeer> peer;
+    vector<tablet::HotKeys::Entry> keys;
+  };
+  vector<TabletHotKeys> tablets;
+  for (auto& peer : peers) {
+    auto tablet = peer->shared_tablet();
+    if (!tablet) {
+      continue;
+    }
+    auto keys = tablet->hot_keys().Top(limit);
+    if (!keys.empty()) {
+      tablets.push_back(TabletHotKeys{std::move(peer), std::move(keys)});
+    }
+  }
+  // Tablets with the hottest keys go first.
+  std::sort(tablets.begin(), tablets.end(), [](const TabletHotKeys& lhs, const TabletHotKeys& rhs) {
+    return lhs.keys[0].ops_per_sec > rhs.keys[0].ops_per_sec;
+  });
+
+  *output << "<h1>Hot Keys</h1>\n";
+  *output << "<table class='table table-striped'>\n";
+  *output << "  <tr><th>Table name</th><th>Tablet ID</th><th>Key</th>"
+          << "<th>Operations per second</th><th>Error</th></tr>\n";
+  for (const auto& tablet : tablets) {
+    for (const auto& entry : tablet.keys) {
+      *output << Substitute(
+          "<tr><td>$0</td><td>$1</td><td>$2</td><td>$3</td><td>$4</td></tr>\n",
+          EscapeForHtmlToString(tablet.peer->tablet_metadata()->table_name()),
+          TabletLink(tablet.peer->tablet_id()),
+          EscapeForHtmlToString(strings::CHexEscape(entry.key)),
+          entry.ops_per_sec,
+          entry.error_ops_per_sec);
+    }
+  }
+  *output << "</table>\n";
+}
+
+void TabletServerPathHandlers::HandleTabletIOPage(const Webserver::WebRequest& req,
+                                                  std::stringstream* output) {
+  vector<std::shared_ptr<TabletPeer>> peers;
+  tserver_->tablet_manager()->GetTabletPeers(&peers);
+
+  struct TabletIO {
+    std::shared_ptr<TabletPeer> peer;
+    std::shared_ptr<Tablet> tablet;
+    int64_t total_bytes;
+  };
+  vector<TabletIO> tablets;
+  for (auto& peer : peers) {
+    auto tablet = peer->shared_tablet();
+    if (!tablet || !tablet->metrics()) {
+      continue;
+    }
+    int64_t total_bytes = 0;
+    for (const auto& io_metrics : tablet->metrics()->io_metrics) {
+      total_bytes += io_metrics->bytes_read->value() + io_metrics->bytes_written->value();
+    }
+    tablets.push_back(TabletIO{std::move(peer), std::move(tablet), total_bytes});
+  }
+  // Tablets that did the most I/O go first.
+  std::sort(tablets.begin(), tablets.end(), [](const TabletIO& lhs, const TabletIO& rhs) {
+    return lhs.total_bytes > rhs.total_bytes;
+  });
+
+  *output << "<h1>Tablet I/O</h1>\n";
+  *output << "<table class='table table-striped'>\n";
+  *output << "  <tr><th>Table name</th><th>Tablet ID</th><th>Class</th>"
+          << "<th>Read</th><th>Reads</th><th>Written</th><th>Writes</th>"
+          << "<th>I/O time</th><th>Mean I/O time</th></tr>\n";
+  for (const auto& tablet : tablets) {
+    for (auto io_class : kIOClassList) {
+      const auto& io_metrics = *tablet.tablet->metrics()->io_metrics[to_underlying(io_class)];
+      const int64_t ops = io_metrics.read_ops->value() + io_metrics.write_ops->value();
+      if (ops == 0) {
+        continue;
+      }
+      const auto io_time = MonoDelta::FromNanoseconds(io_metrics.io_time->value());
+      *output << Substitute(
+          "<tr><td>$0</td><td>$1</td><td>$2</td><td>$3</td><td>$4</td><td>$5</td><td>$6</td>"
+          "<td>$7</td><td>$8</td></tr>\n",
+          EscapeForHtmlToString(tablet.peer->tablet_metadata()->table_name()),
+          TabletLink(tablet.peer->tablet_id()),
+          ToString(io_class).substr(1),
+          HumanReadableNumBytes::ToString(io_metrics.bytes_read->value()),
+          io_metrics.read_ops->value(),
+          HumanReadableNumBytes::ToString(io_metrics.bytes_written->value()),
+          io_metrics.write_ops->value(),
+          io_time.ToString(),
+          MonoDelta::FromNanoseconds(io_time.ToNanoseconds() / ops).ToString());
+    }
+  }
+  *output << "</table>\n";
+}
+
 void TabletServerPathHandlers::HandleMaintenanceManagerPage(const Webserver::WebRequest& req,
                                                             std::stringstream* output) {
   MaintenanceManager* manager = tserver_->maintenance_manager();
@@ -76,6 +76,10 @@ class TabletServerPathHandlers {
                                  std::stringstream* output);
   void HandleDashboardsPage(const Webserver::WebRequest& req,
                             std::stringstream* output);
+  void HandleHotKeysPage(const Webserver::WebRequest& req,
+                         std::stringstream* output);
+  void HandleTabletIOPage(const Webserver::WebRequest& req,
+                          std::stringstream* output);
   void HandleMaintenanceManagerPage(const Webserver::WebRequest& req,
                                     std::stringstream* output);
   std::string ConsensusStatePBToHtml(const consensus::ConsensusStatePB& cstate) const;
@@ -83,7 +83,10 @@ class BackgroundTask {
 
       // Wait
       if (interval_ != std::chrono::milliseconds::zero()) {
-        cond_.wait_for(lock, interval_);
+        if (cond_.wait_for(lock, interval_) == std::cv_status::timeout) {
+          // Run the task every interval, even if nobody woke us up.
+          have_job_ = true;
+        }
       } else {
         cond_.wait(lock);
       }
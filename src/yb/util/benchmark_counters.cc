@@ -0,0 +1,122 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+
+#include "yb/util/benchmark_counters.h"
+
+#include <string.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#endif
+
+#include <atomic>
+
+#if defined(TCMALLOC_ENABLED)
+#include <gperftools/malloc_hook.h>
+#endif
+
+#include <glog/logging.h>
+
+#include "yb/util/errno.h"
+
+namespace yb {
+
+namespace {
+
+// Allocations of all threads since the hook was added.
+std::atomic<int64_t> num_allocations{0};
+
+#if defined(TCMALLOC_ENABLED)
+void CountAllocation(const void* ptr, size_t size) {
+  num_allocations.fetch_add(1, std::memory_order_relaxed);
+}
+#endif
+
+bool CountingAllocations() {
+#if defined(TCMALLOC_ENABLED)
+  static const bool added = MallocHook::AddNewHook(&CountAllocation);
+  return added;
+#else
+  return false;
+#endif
+}
+
+MonoDelta ToMonoDelta(const timeval& tv) {
+  return MonoDelta::FromMicroseconds(tv.tv_sec * 1000000LL + tv.tv_usec);
+}
+
+} // namespace
+
+BenchmarkCounters::BenchmarkCounters() {
+  CountingAllocations();
+#if defined(__linux__)
+  perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+  attr.inherit = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  instructions_fd_ = syscall(
+      __NR_perf_event_open, &attr, 0 /* pid */, -1 /* cpu */, -1 /* group_fd */,
+      PERF_FLAG_FD_CLOEXEC);
+  if (instructions_fd_ < 0) {
+    LOG(WARNING) << "Instructions are not counted: " << ErrnoToString(errno);
+  }
+#endif
+}
+
+BenchmarkCounters::~BenchmarkCounters() {
+  if (instructions_fd_ >= 0) {
+    close(instructions_fd_);
+  }
+}
+
+BenchmarkCounters::Values BenchmarkCounters::Read() const {
+  Values result;
+  if (instructions_fd_ >= 0) {
+    // Includes the counts of the threads that inherited the counter.
+    uint64_t instructions = 0;
+    if (read(instructions_fd_, &instructions, sizeof(instructions)) == sizeof(instructions)) {
+      result.instructions = instructions;
+    }
+  }
+  if (CountingAllocations()) {
+    result.allocations = num_allocations.load(std::memory_order_relaxed);
+  }
+  rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0) {
+    result.cpu_time = ToMonoDelta(usage.ru_utime) + ToMonoDelta(usage.ru_stime);
+  }
+  return result;
+}
+
+BenchmarkCounters::Values operator-(const BenchmarkCounters::Values& after,
+                                    const BenchmarkCounters::Values& before) {
+  BenchmarkCounters::Values result;
+  if (after.instructions >= 0 && before.instructions >= 0) {
+    result.instructions = after.instructions - before.instructions;
+  }
+  if (after.allocations >= 0 && before.allocations >= 0) {
+    result.allocations = after.allocations - before.allocations;
+  }
+  result.cpu_time = after.cpu_time - before.cpu_time;
+  return result;
+}
+
+} // namespace yb
@@ -0,0 +1,59 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+
+#ifndef YB_UTIL_BENCHMARK_COUNTERS_H
+#define YB_UTIL_BENCHMARK_COUNTERS_H
+
+#include <stdint.h>
+
+#include "yb/gutil/macros.h"
+#include "yb/util/monotime.h"
+
+namespace yb {
+
+// Counts the cost of the code run by a benchmark in the whole process: the CPU instructions
+// retired in user space, the CPU time and the memory allocations.
+//
+// Instructions are counted with a hardware performance counter, which is inherited by the threads
+// started after the counter was created, but not by the existing ones. So it should be created
+// before the servers of the benchmark are started. It may also be unavailable, e.g. when perf
+// events are not allowed. Allocations are only counted when tcmalloc is used.
+class BenchmarkCounters {
+ public:
+  struct Values {
+    // -1 when not counted.
+    int64_t instructions = -1;
+    int64_t allocations = -1;
+    MonoDelta cpu_time;
+  };
+
+  BenchmarkCounters();
+  ~BenchmarkCounters();
+
+  // Returns the totals counted since the counters were created.
+  Values Read() const;
+
+ private:
+  int instructions_fd_ = -1;
+
+  DISALLOW_COPY_AND_ASSIGN(BenchmarkCounters);
+};
+
+// Returns the counts between 'before' and 'after' taken by Read().
+BenchmarkCounters::Values operator-(const BenchmarkCounters::Values& after,
+                                    const BenchmarkCounters::Values& before);
+
+} // namespace yb
+
+#endif // YB_UTIL_BENCHMARK_COUNTERS_H
@@ -71,6 +71,28 @@ METRIC_DEFINE_gauge_uint64(server, block_cache_multi_touch_usage,
                            "Multi Cache Block Cache Memory Usage",
                            yb::MetricUnit::kBytes,
                            "Memory consumed by the multi cache block cache");
+
+#define DEFINE_PRIORITY_CLASS_METRICS(n) \
+    METRIC_DEFINE_counter(server, block_cache_priority_class_##n##_hits, \
+                          "Block Cache Priority Class " #n " Hits", yb::MetricUnit::kBlocks, \
+                          "Number of lookups of tables in block cache priority class " #n \
+                          " that found a block"); \
+    METRIC_DEFINE_counter(server, block_cache_priority_class_##n##_misses, \
+                          "Block Cache Priority Class " #n " Misses", yb::MetricUnit::kBlocks, \
+                          "Number of lookups of tables in block cache priority class " #n \
+                          " that didn't yield a block"); \
+    METRIC_DEFINE_gauge_uint64(server, block_cache_priority_class_##n##_usage, \
+                               "Block Cache Priority Class " #n " Memory Usage", \
+                               yb::MetricUnit::kBytes, \
+                               "Memory consumed by the blocks of block cache priority class " #n)
+
+DEFINE_PRIORITY_CLASS_METRICS(0);
+DEFINE_PRIORITY_CLASS_METRICS(1);
+DEFINE_PRIORITY_CLASS_METRICS(2);
+DEFINE_PRIORITY_CLASS_METRICS(3);
+
+#undef DEFINE_PRIORITY_CLASS_METRICS
+
 namespace yb {
 
 #define MINIT(member, x) member(METRIC_##x.Instantiate(entity))
@@ -86,6 +108,19 @@ CacheMetrics::CacheMetrics(const scoped_refptr<MetricEntity>& entity)
     GINIT(cache_usage, block_cache_usage),
     GINIT(single_touch_cache_usage, block_cache_single_touch_usage),
     GINIT(multi_touch_cache_usage, block_cache_multi_touch_usage) {
+#define INIT_PRIORITY_CLASS_METRICS(n) \
+    priority_classes[n].cache_hits = METRIC_block_cache_priority_class_##n##_hits.Instantiate( \
+        entity); \
+    priority_classes[n].cache_misses = METRIC_block_cache_priority_class_##n##_misses.Instantiate( \
+        entity); \
+    priority_classes[n].cache_usage = METRIC_block_cache_priority_class_##n##_usage.Instantiate( \
+        entity, 0)
+  INIT_PRIORITY_CLASS_METRICS(0);
+  INIT_PRIORITY_CLASS_METRICS(1);
+  INIT_PRIORITY_CLASS_METRICS(2);
+  INIT_PRIORITY_CLASS_METRICS(3);
+#undef INIT_PRIORITY_CLASS_METRICS
+  static_assert(kNumCachePriorityClasses == 4, "Update the priority class metrics");
 }
 #undef MINIT
 #undef GINIT
@@ -34,6 +34,8 @@
 
 #include <stdint.h>
 
+#include <array>
+
 #include "yb/gutil/macros.h"
 #include "yb/gutil/ref_counted.h"
 
@@ -44,6 +46,15 @@ class AtomicGauge;
 class Counter;
 class MetricEntity;
 
+// Number of priority classes a block cache is partitioned into.
+constexpr size_t kNumCachePriorityClasses = 4;
+
+struct CachePriorityClassMetrics {
+  scoped_refptr<Counter> cache_hits;
+  scoped_refptr<Counter> cache_misses;
+  scoped_refptr<AtomicGauge<uint64_t> > cache_usage;
+};
+
 struct CacheMetrics {
   explicit CacheMetrics(const scoped_refptr<MetricEntity>& metric_entity);
 
@@ -58,6 +69,8 @@ struct CacheMetrics {
   scoped_refptr<AtomicGauge<uint64_t> > cache_usage;
   scoped_refptr<AtomicGauge<uint64_t> > single_touch_cache_usage;
   scoped_refptr<AtomicGauge<uint64_t> > multi_touch_cache_usage;
+
+  std::array<CachePriorityClassMetrics, kNumCachePriorityClasses> priority_classes;
 };
 
 } // namespace yb
@@ -0,0 +1,74 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "yb/util/chainable_future.h"
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+namespace yb {
+
+class ChainableFutureTest : public YBTest {
+};
+
+TEST_F(ChainableFutureTest, Then) {
+  ChainablePromise<int> promise;
+  auto future = promise.GetFuture()
+      .Then([](int value) { return value * 2; })
+      .Then([](int value) { return std::to_string(value); });
+  ASSERT_FALSE(future.ready());
+  promise.Set(21);
+  ASSERT_TRUE(future.ready());
+  ASSERT_EQ("42", future.Get());
+
+  // Continuation of a ready future runs inline.
+  int seen = 0;
+  promise.GetFuture().Then([&seen](int value) { seen = value; });
+  ASSERT_EQ(21, seen);
+}
+
+TEST_F(ChainableFutureTest, ThenFuture) {
+  ChainablePromise<int> first;
+  ChainablePromise<Status> second;
+  auto future = first.GetFuture().Then([second](int) { return second.GetFuture(); });
+  first.Set(1);
+  ASSERT_FALSE(future.ready());
+  second.Set(STATUS(TimedOut, "Timed out"));
+  ASSERT_TRUE(future.Get().IsTimedOut());
+}
+
+TEST_F(ChainableFutureTest, WhenAllOk) {
+  ASSERT_OK(WhenAllOk({}).Get());
+
+  constexpr int kNumPromises = 1000;
+  std::vector<ChainablePromise<Status>> promises(kNumPromises);
+  std::vector<ChainableFuture<Status>> futures;
+  for (const auto& promise : promises) {
+    futures.push_back(promise.GetFuture());
+  }
+  auto all = WhenAllOk(futures);
+
+  std::thread thread([&promises] {
+    for (int i = 0; i != kNumPromises; ++i) {
+      promises[i].Set(i == kNumPromises / 2 ? STATUS(IllegalState, "Failed") : Status::OK());
+    }
+  });
+  // Blocks until the other thread sets all the values.
+  ASSERT_TRUE(all.Get().IsIllegalState());
+  thread.join();
+}
+
+} // namespace yb
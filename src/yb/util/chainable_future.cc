@@ -0,0 +1,63 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/util/chainable_future.h"
+
+#include <atomic>
+
+namespace yb {
+
+namespace {
+
+struct WhenAllOkContext {
+  explicit WhenAllOkContext(size_t count) : remaining(count) {}
+
+  std::atomic<size_t> remaining;
+  std::mutex mutex;
+  Status status;
+  ChainablePromise<Status> promise;
+};
+
+} // namespace
+
+ChainableFuture<Status> WhenAllOk(const std::vector<ChainableFuture<Status>>& futures) {
+  if (futures.empty()) {
+    ChainablePromise<Status> promise;
+    promise.Set(Status::OK());
+    return promise.GetFuture();
+  }
+
+  auto context = std::make_shared<WhenAllOkContext>(futures.size());
+  auto result = context->promise.GetFuture();
+  for (const auto& future : futures) {
+    future.Then([context](const Status& status) {
+      if (!status.ok()) {
+        std::lock_guard<std::mutex> lock(context->mutex);
+        if (context->status.ok()) {
+          context->status = status;
+        }
+      }
+      if (--context->remaining == 0) {
+        Status final_status;
+        {
+          std::lock_guard<std::mutex> lock(context->mutex);
+          final_status = context->status;
+        }
+        context->promise.Set(std::move(final_status));
+      }
+    });
+  }
+  return result;
+}
+
+} // namespace yb
@@ -0,0 +1,219 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_UTIL_CHAINABLE_FUTURE_H
+#define YB_UTIL_CHAINABLE_FUTURE_H
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+#include <boost/optional.hpp>
+
+#include <glog/logging.h>
+
+#include "yb/util/status.h"
+
+namespace yb {
+
+template <class T>
+class ChainableFuture;
+
+namespace internal {
+
+// State shared by a ChainablePromise and its futures: a single heap allocation per operation.
+template <class T>
+class ChainableState {
+ public:
+  typedef std::function<void(const T&)> Continuation;
+
+  void Set(T value) {
+    Continuation continuation;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      DCHECK(!value_) << "Value already set";
+      value_ = std::move(value);
+      continuation.swap(continuation_);
+      if (waiters_) {
+        cond_.notify_all();
+      }
+    }
+    // The value is never changed once set, so it can be read without the lock.
+    if (continuation) {
+      continuation(*value_);
+    }
+  }
+
+  void SetContinuation(Continuation continuation) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      DCHECK(!continuation_) << "Continuation already set";
+      if (!value_) {
+        continuation_ = std::move(continuation);
+        return;
+      }
+    }
+    continuation(*value_);
+  }
+
+  bool ready() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return value_.is_initialized();
+  }
+
+  const T& Wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    ++waiters_;
+    cond_.wait(lock, [this] { return value_.is_initialized(); });
+    --waiters_;
+    return *value_;
+  }
+
+ private:
+  mutable std::mutex mutex_;
+  std::condition_variable cond_;
+  int waiters_ = 0;
+  boost::optional<T> value_;
+  Continuation continuation_;
+};
+
+template <class T, class F, class R = typename std::result_of<F(const T&)>::type>
+struct ChainableThen;
+
+} // namespace internal
+
+// Producer side of a ChainableFuture.
+template <class T>
+class ChainablePromise {
+ public:
+  ChainablePromise() : state_(std::make_shared<internal::ChainableState<T>>()) {}
+
+  ChainableFuture<T> GetFuture() const {
+    return ChainableFuture<T>(state_);
+  }
+
+  // May be called at most once. Runs the continuation of the future, if any, in this thread.
+  void Set(T value) const {
+    state_->Set(std::move(value));
+  }
+
+ private:
+  std::shared_ptr<internal::ChainableState<T>> state_;
+};
+
+// Future that can be continued without blocking a thread, unlike std::future. Then() registers
+// the code to run once the value is set, and returns a future for the result of that code, so
+// dependent async operations are composed without callback nesting.
+//
+// As with the callbacks of the async client calls, a continuation runs in the thread that sets
+// the value, usually a reactor thread, or inline in Then() if the value is already set. So it
+// should not block; heavy work should be passed to a thread pool.
+//
+// A future has at most one continuation, as std::future has at most one consumer.
+template <class T>
+class ChainableFuture {
+ public:
+  ChainableFuture() = default;
+
+  bool valid() const {
+    return state_ != nullptr;
+  }
+
+  bool ready() const {
+    return state_->ready();
+  }
+
+  // Blocks until the value is set. Meant for tests and for the edges of synchronous code.
+  const T& Get() const {
+    return state_->Wait();
+  }
+
+  // Runs f(value) once the value is set. If f returns void, nothing is returned. If it returns a
+  // ChainableFuture<U>, the result is a ChainableFuture<U> that is set once the returned one is.
+  // Otherwise the result is a ChainableFuture of the return type of f.
+  template <class F>
+  typename internal::ChainableThen<T, F>::Result Then(F f) const {
+    return internal::ChainableThen<T, F>::Apply(state_.get(), std::move(f));
+  }
+
+ private:
+  friend class ChainablePromise<T>;
+
+  explicit ChainableFuture(std::shared_ptr<internal::ChainableState<T>> state)
+      : state_(std::move(state)) {}
+
+  std::shared_ptr<internal::ChainableState<T>> state_;
+};
+
+namespace internal {
+
+template <class T, class F, class R>
+struct ChainableThen {
+  typedef ChainableFuture<R> Result;
+
+  static Result Apply(ChainableState<T>* state, F f) {
+    ChainablePromise<R> promise;
+    state->SetContinuation([promise, f](const T& value) mutable {
+      promise.Set(f(value));
+    });
+    return promise.GetFuture();
+  }
+};
+
+template <class T, class F>
+struct ChainableThen<T, F, void> {
+  typedef void Result;
+
+  static Result Apply(ChainableState<T>* state, F f) {
+    state->SetContinuation(std::move(f));
+  }
+};
+
+template <class T, class F, class U>
+struct ChainableThen<T, F, ChainableFuture<U>> {
+  typedef ChainableFuture<U> Result;
+
+  static Result Apply(ChainableState<T>* state, F f) {
+    ChainablePromise<U> promise;
+    state->SetContinuation([promise, f](const T& value) mutable {
+      f(value).Then([promise](const U& inner) {
+        promise.Set(inner);
+      });
+    });
+    return promise.GetFuture();
+  }
+};
+
+} // namespace internal
+
+// Same as MakeFuture from async_util.h, but for a ChainableFuture.
+// Functor is any functor that accepts callback as only argument.
+template <class Result, class Functor>
+ChainableFuture<Result> MakeChainableFuture(const Functor& functor) {
+  ChainablePromise<Result> promise;
+  functor([promise](Result result) {
+    promise.Set(std::move(result));
+  });
+  return promise.GetFuture();
+}
+
+// Returns a future that is set once all of 'futures' are set, to the first of their non-OK
+// statuses or to OK.
+ChainableFuture<Status> WhenAllOk(const std::vector<ChainableFuture<Status>>& futures);
+
+} // namespace yb
+
+#endif // YB_UTIL_CHAINABLE_FUTURE_H
@@ -0,0 +1,92 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <atomic>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "yb/gutil/walltime.h"
+#include "yb/util/continuous_profiler.h"
+#include "yb/util/countdown_latch.h"
+#include "yb/util/test_util.h"
+#include "yb/util/wait_state.h"
+
+namespace yb {
+
+class ContinuousProfilerTest : public YBTest {
+};
+
+void __attribute__((noinline)) WaitInRpc(CountDownLatch* started, CountDownLatch* finish) {
+  ScopedWaitState wait_state(WaitState::kRpc);
+  started->CountDown();
+  finish->Wait();
+}
+
+TEST_F(ContinuousProfilerTest, WaitStates) {
+  CountDownLatch started(1);
+  CountDownLatch finish(1);
+  std::thread waiter(&WaitInRpc, &started, &finish);
+  started.Wait();
+
+  bool found = false;
+  ForEachThreadWaitState([&found](pid_t, WaitState state) {
+    found = found || state == WaitState::kRpc;
+  });
+  ASSERT_TRUE(found);
+
+  const MicrosecondsInt64 start_us = GetCurrentTimeMicros();
+  auto* profiler = ContinuousProfiler::GetInstance();
+  for (int i = 0; i != 5; ++i) {
+    profiler->SampleNow();
+  }
+  finish.CountDown();
+  waiter.join();
+
+  std::stringstream out;
+  profiler->WriteProfile(start_us, GetCurrentTimeMicros(), &out);
+  const std::string profile = out.str();
+  LOG(INFO) << "Profile:\n" << profile;
+  ASSERT_NE(std::string::npos, profile.find("5 samples")) << profile;
+  ASSERT_NE(std::string::npos, profile.find("in kRpc")) << profile;
+  ASSERT_NE(std::string::npos, profile.find("WaitInRpc")) << profile;
+
+  // Nothing was sampled in this range.
+  std::stringstream old_out;
+  profiler->WriteProfile(0, ContinuousProfiler::kBucketSeconds, &old_out);
+  ASSERT_EQ(std::string::npos, old_out.str().find("samples (")) << old_out.str();
+}
+
+TEST_F(ContinuousProfilerTest, OnCpu) {
+  std::atomic<bool> stop{false};
+  std::thread spinner([&stop] {
+    while (!stop.load(std::memory_order_relaxed)) {
+    }
+  });
+
+  const MicrosecondsInt64 start_us = GetCurrentTimeMicros();
+  auto* profiler = ContinuousProfiler::GetInstance();
+  for (int i = 0; i != 5; ++i) {
+    profiler->SampleNow();
+  }
+  stop = true;
+  spinner.join();
+
+  std::stringstream out;
+  profiler->WriteProfile(start_us, GetCurrentTimeMicros(), &out);
+  ASSERT_NE(std::string::npos, out.str().find("in kOnCpu")) << out.str();
+}
+
+} // namespace yb
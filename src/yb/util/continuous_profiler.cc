@@ -0,0 +1,212 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/util/continuous_profiler.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <ostream>
+#include <vector>
+
+#include <gflags/gflags.h>
+
+#include "yb/gutil/strings/substitute.h"
+#include "yb/util/flag_tags.h"
+#include "yb/util/thread.h"
+
+DEFINE_int32(continuous_profiler_interval_ms, 200,
+             "Interval between the samples of the threads taken by the continuous profiler. "
+             "0 stops sampling.");
+TAG_FLAG(continuous_profiler_interval_ms, advanced);
+TAG_FLAG(continuous_profiler_interval_ms, runtime);
+
+DEFINE_int32(continuous_profiler_window_secs, 1800,
+             "How far back the samples of the continuous profiler are kept.");
+TAG_FLAG(continuous_profiler_window_secs, advanced);
+TAG_FLAG(continuous_profiler_window_secs, runtime);
+
+namespace yb {
+
+namespace {
+
+// How long the sampling thread sleeps between checks of --continuous_profiler_interval_ms while
+// sampling is off.
+const MonoDelta kDisabledRecheckInterval = MonoDelta::FromSeconds(1);
+
+// Returns the state letter of /proc/<pid>/task/<tid>/stat, like 'R' for running or 'S' for
+// sleeping, or 0 if it could not be read, e.g. because the thread exited.
+char ThreadRunState(pid_t tid) {
+  char path[64];
+  snprintf(path, sizeof(path), "/proc/self/task/%d/stat", tid);
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    return 0;
+  }
+  char buf[256];
+  ssize_t size = read(fd, buf, sizeof(buf) - 1);
+  close(fd);
+  if (size <= 0) {
+    return 0;
+  }
+  buf[size] = 0;
+  // The format is "<tid> (<name>) <state> ...", and the name may contain spaces and parentheses.
+  const char* name_end = strrchr(buf, ')');
+  if (name_end == nullptr || name_end + 2 >= buf + size) {
+    return 0;
+  }
+  return name_end[2];
+}
+
+uint64_t SampleKey(WaitState state, const StackTrace& stack) {
+  return stack.HashCode() * 31 + to_underlying(state);
+}
+
+const char* StateName(WaitState state) {
+  return state == WaitState::kNone ? "kOnCpu" : ToCString(state);
+}
+
+} // namespace
+
+ContinuousProfiler::ContinuousProfiler() {
+}
+
+Status ContinuousProfiler::Start() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (thread_) {
+    return Status::OK();
+  }
+  return Thread::Create("continuous-profiler", "sampler",
+                        std::bind(&ContinuousProfiler::RunThread, this), &thread_);
+}
+
+void ContinuousProfiler::RunThread() {
+  for (;;) {
+    const int interval_ms = FLAGS_continuous_profiler_interval_ms;
+    if (interval_ms <= 0) {
+      SleepFor(kDisabledRecheckInterval);
+      continue;
+    }
+    SleepFor(MonoDelta::FromMilliseconds(interval_ms));
+    SampleNow();
+  }
+}
+
+void ContinuousProfiler::SampleNow() {
+  std::vector<pid_t> tids;
+  WARN_NOT_OK(ListThreads(&tids), "Failed to list threads");
+  std::unordered_map<pid_t, WaitState> wait_states;
+  ForEachThreadWaitState([&wait_states](pid_t tid, WaitState state) {
+    if (state != WaitState::kNone) {
+      wait_states.emplace(tid, state);
+    }
+  });
+
+  const pid_t self_tid = Thread::CurrentThreadId();
+  std::vector<Sample> samples;
+  for (pid_t tid : tids) {
+    if (tid == self_tid) {
+      continue;
+    }
+    Sample sample;
+    auto it = wait_states.find(tid);
+    if (it != wait_states.end()) {
+      sample.state = it->second;
+    } else if (ThreadRunState(tid) == 'R') {
+      sample.state = WaitState::kNone;
+    } else {
+      // Idle.
+      continue;
+    }
+    // Threads that exited since they were listed, or that block signals, are not sampled.
+    if (!GetThreadStack(tid, &sample.stack).ok()) {
+      continue;
+    }
+    sample.count = 1;
+    samples.push_back(sample);
+  }
+
+  const MicrosecondsInt64 now_us = GetCurrentTimeMicros();
+  const MicrosecondsInt64 bucket_us = kBucketSeconds * MonoTime::kMicrosecondsPerSecond;
+  const MicrosecondsInt64 bucket_start_us = now_us - now_us % bucket_us;
+  const MicrosecondsInt64 window_start_us =
+      now_us - FLAGS_continuous_profiler_window_secs * MonoTime::kMicrosecondsPerSecond;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  while (!buckets_.empty() && buckets_.front().start_us + bucket_us <= window_start_us) {
+    buckets_.pop_front();
+  }
+  if (buckets_.empty() || buckets_.back().start_us != bucket_start_us) {
+    buckets_.emplace_back();
+    buckets_.back().start_us = bucket_start_us;
+  }
+  auto& bucket = buckets_.back();
+  for (const auto& sample : samples) {
+    ++bucket.num_samples;
+    const uint64_t key = SampleKey(sample.state, sample.stack);
+    auto it = bucket.samples.find(key);
+    if (it != bucket.samples.end()) {
+      ++it->second.count;
+    } else if (bucket.samples.size() < kMaxStacksPerBucket) {
+      bucket.samples.emplace(key, sample);
+    } else {
+      ++bucket.num_dropped;
+    }
+  }
+}
+
+void ContinuousProfiler::WriteProfile(
+    MicrosecondsInt64 start_us, MicrosecondsInt64 end_us, std::ostream* out) {
+  const MicrosecondsInt64 bucket_us = kBucketSeconds * MonoTime::kMicrosecondsPerSecond;
+  std::unordered_map<uint64_t, Sample> merged;
+  uint64_t num_samples = 0;
+  uint64_t num_dropped = 0;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& bucket : buckets_) {
+      if (bucket.start_us + bucket_us <= start_us || bucket.start_us > end_us) {
+        continue;
+      }
+      num_samples += bucket.num_samples;
+      num_dropped += bucket.num_dropped;
+      for (const auto& entry : bucket.samples) {
+        auto it = merged.emplace(entry.first, entry.second);
+        if (!it.second) {
+          it.first->second.count += entry.second.count;
+        }
+      }
+    }
+  }
+
+  std::vector<const Sample*> sorted;
+  sorted.reserve(merged.size());
+  for (const auto& entry : merged) {
+    sorted.push_back(&entry.second);
+  }
+  std::sort(sorted.begin(), sorted.end(), [](const Sample* lhs, const Sample* rhs) {
+    return lhs->count > rhs->count;
+  });
+
+  *out << strings::Substitute(
+      "Samples: $0, of stacks not kept: $1, sampling interval: $2ms, bucket: $3s\n\n",
+      num_samples, num_dropped, FLAGS_continuous_profiler_interval_ms, kBucketSeconds);
+  for (const Sample* sample : sorted) {
+    *out << strings::Substitute("$0 samples ($1%) in $2\n", sample->count,
+                                sample->count * 100 / std::max<uint64_t>(num_samples, 1),
+                                StateName(sample->state))
+         << sample->stack.Symbolize() << "\n";
+  }
+}
+
+} // namespace yb
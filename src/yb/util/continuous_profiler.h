@@ -0,0 +1,93 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_UTIL_CONTINUOUS_PROFILER_H
+#define YB_UTIL_CONTINUOUS_PROFILER_H
+
+#include <deque>
+#include <iosfwd>
+#include <mutex>
+#include <unordered_map>
+
+#include "yb/gutil/macros.h"
+#include "yb/gutil/ref_counted.h"
+#include "yb/gutil/singleton.h"
+#include "yb/gutil/walltime.h"
+#include "yb/util/debug-util.h"
+#include "yb/util/wait_state.h"
+
+namespace yb {
+
+class Thread;
+
+// Always-on, low frequency sampler of the threads of the process.
+//
+// Each --continuous_profiler_interval_ms, the stacks of the threads that are running on a CPU or
+// are tagged with a wait state (see ScopedWaitState) are collected. Threads that sleep without a
+// wait state, like idle pool threads, are not sampled. The samples are aggregated by stack and wait
+// state into buckets of kBucketSeconds, and the buckets of the last
+// --continuous_profiler_window_secs are kept, so the profile of a past incident can be read after
+// the fact.
+class ContinuousProfiler {
+ public:
+  static constexpr int64_t kBucketSeconds = 10;
+  // Each bucket keeps at most this many distinct stacks. Samples of other stacks are only counted.
+  static constexpr size_t kMaxStacksPerBucket = 256;
+
+  static ContinuousProfiler* GetInstance() {
+    return Singleton<ContinuousProfiler>::get();
+  }
+
+  // Starts the sampling thread. Does nothing if it is already running.
+  Status Start();
+
+  // Samples the threads of the process once. Called by the sampling thread.
+  void SampleNow();
+
+  // Writes the aggregated samples of the buckets overlapping [start_us, end_us] of the wall clock,
+  // most frequent stacks first.
+  void WriteProfile(MicrosecondsInt64 start_us, MicrosecondsInt64 end_us, std::ostream* out);
+
+ private:
+  friend class Singleton<ContinuousProfiler>;
+
+  struct Sample {
+    WaitState state;
+    StackTrace stack;
+    uint64_t count = 0;
+  };
+
+  struct Bucket {
+    MicrosecondsInt64 start_us;
+    uint64_t num_samples = 0;
+    // Samples not kept because the bucket had kMaxStacksPerBucket stacks already.
+    uint64_t num_dropped = 0;
+    std::unordered_map<uint64_t, Sample> samples;
+  };
+
+  ContinuousProfiler();
+
+  void RunThread();
+
+  std::mutex mutex_;
+  // Runs for the lifetime of the process.
+  scoped_refptr<Thread> thread_;
+  // Oldest bucket first.
+  std::deque<Bucket> buckets_;
+
+  DISALLOW_COPY_AND_ASSIGN(ContinuousProfiler);
+};
+
+} // namespace yb
+
+#endif // YB_UTIL_CONTINUOUS_PROFILER_H
@@ -30,9 +30,13 @@
 // under the License.
 //
 
+#include <random>
+#include <vector>
+
 #include "yb/gutil/gscoped_ptr.h"
 #include "yb/gutil/strings/substitute.h"
 #include "yb/util/crc.h"
+#include "yb/util/random_util.h"
 #include "yb/util/stopwatch.h"
 #include "yb/util/test_util.h"
 
@@ -73,6 +77,34 @@ TEST_F(CrcTest, TestCRC32C) {
   ASSERT_EQ(0xa9421b7, data_crc); // Known value from crcutil usage test program.
 }
 
+TEST_F(CrcTest, TestCrc32cExtend) {
+  ASSERT_EQ(0, Crc32c(nullptr, 0));
+  ASSERT_EQ(0xe3069283, Crc32c("123456789", 9));
+  ASSERT_EQ(0xa9421b7, Crc32c("abcdefgh", 8));
+  LOG(INFO) << "Hardware accelerated: " << Crc32cHardwareAccelerated();
+
+  // Covers unaligned starts, and the sizes handled by each of the stripe sizes and the tail loops.
+  constexpr size_t kMaxLength = 64 * 1024;
+  std::vector<uint8_t> data(kMaxLength + 8);
+  std::mt19937_64 rng(GetRandomSeed32());
+  for (auto& byte : data) {
+    byte = rng();
+  }
+  Crc* crc32c = GetCrc32cInstance();
+  for (int i = 0; i != 2000; ++i) {
+    const size_t offset = rng() % 8;
+    const size_t length = rng() % (i % 2 ? 64 : kMaxLength);
+    const uint8_t* begin = data.data() + offset;
+    uint64_t expected = 0;
+    crc32c->Compute(begin, length, &expected);
+    ASSERT_EQ(expected, Crc32c(begin, length)) << "offset: " << offset << ", length: " << length;
+
+    const size_t split = length ? rng() % length : 0;
+    ASSERT_EQ(expected, Crc32cExtend(Crc32c(begin, split), begin + split, length - split))
+        << "offset: " << offset << ", length: " << length << ", split: " << split;
+  }
+}
+
 // Simple benchmark of CRC32C throughput.
 // We should expect about 8 bytes per cycle in throughput on a single core.
 TEST_F(CrcTest, BenchmarkCRC32C) {
@@ -102,5 +134,27 @@ TEST_F(CrcTest, BenchmarkCRC32C) {
                           (kNumBytes / elapsed.wall));
 }
 
+TEST_F(CrcTest, BenchmarkCrc32cExtend) {
+  gscoped_ptr<const uint8_t[]> data;
+  const uint8_t* buf;
+  size_t buflen;
+  GenerateBenchmarkData(&buf, &buflen);
+  data.reset(buf);
+  const uint64_t kTotalBytes = AllowSlowTests() ? 40000ULL * buflen : 1000ULL * buflen;
+  // Sizes of RPC payloads and WAL entries, SST blocks and whole buffers.
+  for (size_t chunk : {256UL, 4096UL, 32768UL, buflen}) {
+    uint32_t checksum = 0;
+    Stopwatch sw;
+    sw.start();
+    for (uint64_t bytes = 0; bytes < kTotalBytes; bytes += chunk) {
+      checksum = Crc32cExtend(checksum, buf, chunk);
+    }
+    sw.stop();
+    LOG(INFO) << Substitute("Crc32cExtend on $0 byte chunks: $1 bytes per nanosecond ($2)",
+                            chunk, static_cast<double>(kTotalBytes) / sw.elapsed().wall,
+                            checksum);
+  }
+}
+
 } // namespace crc
 } // namespace yb
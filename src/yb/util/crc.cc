@@ -31,8 +31,20 @@
 //
 #include "yb/util/crc.h"
 
+#include <string.h>
+
 #include <crcutil/interface.h>
 
+#if defined(__x86_64__)
+#include <nmmintrin.h>
+#include <wmmintrin.h>
+#elif defined(__aarch64__) && defined(__linux__)
+#include <arm_acle.h>
+#include <arm_neon.h>
+#include <asm/hwcap.h>
+#include <sys/auxv.h>
+#endif
+
 #include "yb/gutil/once.h"
 #include "yb/util/debug/leakcheck_disabler.h"
 
@@ -55,10 +67,270 @@ Crc* GetCrc32cInstance() {
   return crc32c_instance;
 }
 
-uint32_t Crc32c(const void* data, size_t length) {
-  uint64_t crc32 = 0;
-  GetCrc32cInstance()->Compute(data, length, &crc32);
-  return static_cast<uint32_t>(crc32); // Only uses lower 32 bits.
+namespace {
+
+// The CRC32C polynomial, bit reflected as in the CRC registers, where bit 31 is the coefficient of
+// x^0 and bit 0 the coefficient of x^31.
+constexpr uint32_t kCrc32cPolynomial = 0x82f63b78;
+
+// Returns a * b modulo the CRC32C polynomial, in the bit reflected representation.
+constexpr uint32_t MultiplyModP(uint32_t a, uint32_t b) {
+  uint32_t result = 0;
+  for (uint32_t mask = 1U << 31; mask != 0; mask >>= 1) {
+    if (a & mask) {
+      result ^= b;
+    }
+    b = (b & 1) ? (b >> 1) ^ kCrc32cPolynomial : b >> 1;
+  }
+  return result;
+}
+
+// Returns x^n modulo the CRC32C polynomial, in the bit reflected representation.
+constexpr uint32_t XPowModP(uint64_t n) {
+  uint32_t result = 1U << 31;
+  uint32_t power = 1U << 30;
+  for (; n != 0; n >>= 1) {
+    if (n & 1) {
+      result = MultiplyModP(result, power);
+    }
+    power = MultiplyModP(power, power);
+  }
+  return result;
+}
+
+// Large buffers are split into three stripes of the same size, whose CRC registers are computed
+// in parallel, because the CRC32 instruction has a latency of several cycles but could start
+// every cycle. The registers of the second and the third stripe start from zero, and the registers
+// of the earlier stripes are combined with them by shifting them over the bytes that follow, that
+// is multiplying them by x^(8 * bytes). The carry-less multiplication of two reflected values and
+// the CRC32 instruction that reduces its result together multiply by another x^33, so the
+// constants are divided by it.
+constexpr uint32_t ShiftConstant(size_t bytes) {
+  return XPowModP(8 * bytes - 33);
+}
+
+constexpr size_t kLargeStripe = 4096;
+constexpr size_t kSmallStripe = 256;
+
+constexpr uint32_t kShiftLargeStripe = ShiftConstant(kLargeStripe);
+constexpr uint32_t kShiftTwoLargeStripes = ShiftConstant(2 * kLargeStripe);
+constexpr uint32_t kShiftSmallStripe = ShiftConstant(kSmallStripe);
+constexpr uint32_t kShiftTwoSmallStripes = ShiftConstant(2 * kSmallStripe);
+
+uint64_t Load64(const uint8_t* p) {
+  uint64_t result;
+  memcpy(&result, p, sizeof(result));
+  return result;
+}
+
+uint32_t Load32(const uint8_t* p) {
+  uint32_t result;
+  memcpy(&result, p, sizeof(result));
+  return result;
+}
+
+#if __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "CRC32C implementation assumes a little endian CPU"
+#endif
+
+// Tables for processing 4 bytes at a time without CPU support.
+class Crc32cTables {
+ public:
+  Crc32cTables() {
+    for (uint32_t i = 0; i != 256; ++i) {
+      uint32_t crc = i;
+      for (int bit = 0; bit != 8; ++bit) {
+        crc = (crc & 1) ? (crc >> 1) ^ kCrc32cPolynomial : crc >> 1;
+      }
+      tables_[0][i] = crc;
+    }
+    for (uint32_t i = 0; i != 256; ++i) {
+      for (int t = 1; t != 4; ++t) {
+        tables_[t][i] = (tables_[t - 1][i] >> 8) ^ tables_[0][tables_[t - 1][i] & 0xff];
+      }
+    }
+  }
+
+  uint32_t Extend(uint32_t crc, const uint8_t* p, size_t length) const {
+    uint32_t l = ~crc;
+    const uint8_t* end = p + length;
+    for (; end - p >= 4; p += 4) {
+      l ^= Load32(p);
+      l = tables_[3][l & 0xff] ^ tables_[2][(l >> 8) & 0xff] ^ tables_[1][(l >> 16) & 0xff] ^
+          tables_[0][l >> 24];
+    }
+    for (; p != end; ++p) {
+      l = tables_[0][(l ^ *p) & 0xff] ^ (l >> 8);
+    }
+    return ~l;
+  }
+
+ private:
+  uint32_t tables_[4][256];
+};
+
+uint32_t Crc32cSoftware(uint32_t crc, const uint8_t* p, size_t length) {
+  static const Crc32cTables tables;
+  return tables.Extend(crc, p, length);
+}
+
+#if defined(__x86_64__)
+
+#define CRC32C_TARGET __attribute__((target("sse4.2")))
+#define CRC32C_PCLMUL_TARGET __attribute__((target("sse4.2,pclmul")))
+
+CRC32C_TARGET uint32_t Crc32cSse42(uint32_t crc, const uint8_t* p, size_t length) {
+  uint64_t l = ~crc;
+  for (; length != 0 && (reinterpret_cast<uintptr_t>(p) & 7); ++p, --length) {
+    l = _mm_crc32_u8(l, *p);
+  }
+  for (; length >= 8; p += 8, length -= 8) {
+    l = _mm_crc32_u64(l, Load64(p));
+  }
+  for (; length != 0; ++p, --length) {
+    l = _mm_crc32_u8(l, *p);
+  }
+  return ~static_cast<uint32_t>(l);
+}
+
+CRC32C_PCLMUL_TARGET inline uint64_t Shift(uint64_t crc, uint32_t shift_constant) {
+  const __m128i product = _mm_clmulepi64_si128(
+      _mm_cvtsi64_si128(crc), _mm_cvtsi32_si128(shift_constant), 0);
+  return _mm_crc32_u64(0, _mm_cvtsi128_si64(product));
+}
+
+// Processes the stripes of 'stripe' bytes while there are three of them.
+CRC32C_PCLMUL_TARGET inline uint64_t ThreeWay(
+    uint64_t l, size_t stripe, uint32_t shift_one, uint32_t shift_two,
+    const uint8_t** p, size_t* length) {
+  for (; *length >= 3 * stripe; *p += 3 * stripe, *length -= 3 * stripe) {
+    const uint8_t* p0 = *p;
+    const uint8_t* p1 = p0 + stripe;
+    const uint8_t* p2 = p1 + stripe;
+    uint64_t l1 = 0;
+    uint64_t l2 = 0;
+    for (size_t i = 0; i != stripe; i += 8) {
+      l = _mm_crc32_u64(l, Load64(p0 + i));
+      l1 = _mm_crc32_u64(l1, Load64(p1 + i));
+      l2 = _mm_crc32_u64(l2, Load64(p2 + i));
+    }
+    l = Shift(l, shift_two) ^ Shift(l1, shift_one) ^ l2;
+  }
+  return l;
+}
+
+CRC32C_PCLMUL_TARGET uint32_t Crc32cSse42Pclmul(uint32_t crc, const uint8_t* p, size_t length) {
+  uint64_t l = ~crc;
+  for (; length != 0 && (reinterpret_cast<uintptr_t>(p) & 7); ++p, --length) {
+    l = _mm_crc32_u8(l, *p);
+  }
+  l = ThreeWay(l, kLargeStripe, kShiftLargeStripe, kShiftTwoLargeStripes, &p, &length);
+  l = ThreeWay(l, kSmallStripe, kShiftSmallStripe, kShiftTwoSmallStripes, &p, &length);
+  for (; length >= 8; p += 8, length -= 8) {
+    l = _mm_crc32_u64(l, Load64(p));
+  }
+  for (; length != 0; ++p, --length) {
+    l = _mm_crc32_u8(l, *p);
+  }
+  return ~static_cast<uint32_t>(l);
+}
+
+#elif defined(__aarch64__) && defined(__linux__)
+
+#define CRC32C_TARGET __attribute__((target("+crc")))
+#define CRC32C_PCLMUL_TARGET __attribute__((target("+crc+crypto")))
+
+CRC32C_TARGET uint32_t Crc32cArm(uint32_t crc, const uint8_t* p, size_t length) {
+  uint32_t l = ~crc;
+  for (; length != 0 && (reinterpret_cast<uintptr_t>(p) & 7); ++p, --length) {
+    l = __crc32cb(l, *p);
+  }
+  for (; length >= 8; p += 8, length -= 8) {
+    l = __crc32cd(l, Load64(p));
+  }
+  for (; length != 0; ++p, --length) {
+    l = __crc32cb(l, *p);
+  }
+  return ~l;
+}
+
+CRC32C_PCLMUL_TARGET inline uint32_t Shift(uint32_t crc, uint32_t shift_constant) {
+  const poly128_t product = vmull_p64(crc, shift_constant);
+  return __crc32cd(0, vgetq_lane_u64(vreinterpretq_u64_p128(product), 0));
+}
+
+// Processes the stripes of 'stripe' bytes while there are three of them.
+CRC32C_PCLMUL_TARGET inline uint32_t ThreeWay(
+    uint32_t l, size_t stripe, uint32_t shift_one, uint32_t shift_two,
+    const uint8_t** p, size_t* length) {
+  for (; *length >= 3 * stripe; *p += 3 * stripe, *length -= 3 * stripe) {
+    const uint8_t* p0 = *p;
+    const uint8_t* p1 = p0 + stripe;
+    const uint8_t* p2 = p1 + stripe;
+    uint32_t l1 = 0;
+    uint32_t l2 = 0;
+    for (size_t i = 0; i != stripe; i += 8) {
+      l = __crc32cd(l, Load64(p0 + i));
+      l1 = __crc32cd(l1, Load64(p1 + i));
+      l2 = __crc32cd(l2, Load64(p2 + i));
+    }
+    l = Shift(l, shift_two) ^ Shift(l1, shift_one) ^ l2;
+  }
+  return l;
+}
+
+CRC32C_PCLMUL_TARGET uint32_t Crc32cArmPmull(uint32_t crc, const uint8_t* p, size_t length) {
+  uint32_t l = ~crc;
+  for (; length != 0 && (reinterpret_cast<uintptr_t>(p) & 7); ++p, --length) {
+    l = __crc32cb(l, *p);
+  }
+  l = ThreeWay(l, kLargeStripe, kShiftLargeStripe, kShiftTwoLargeStripes, &p, &length);
+  l = ThreeWay(l, kSmallStripe, kShiftSmallStripe, kShiftTwoSmallStripes, &p, &length);
+  for (; length >= 8; p += 8, length -= 8) {
+    l = __crc32cd(l, Load64(p));
+  }
+  for (; length != 0; ++p, --length) {
+    l = __crc32cb(l, *p);
+  }
+  return ~l;
+}
+
+#endif
+
+#undef CRC32C_TARGET
+#undef CRC32C_PCLMUL_TARGET
+
+typedef uint32_t (*Crc32cFunction)(uint32_t crc, const uint8_t* p, size_t length);
+
+Crc32cFunction ChooseCrc32cFunction() {
+#if defined(__x86_64__)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("sse4.2")) {
+    return __builtin_cpu_supports("pclmul") ? &Crc32cSse42Pclmul : &Crc32cSse42;
+  }
+#elif defined(__aarch64__) && defined(__linux__)
+  const auto hwcap = getauxval(AT_HWCAP);
+  if (hwcap & HWCAP_CRC32) {
+    return (hwcap & HWCAP_PMULL) ? &Crc32cArmPmull : &Crc32cArm;
+  }
+#endif
+  return &Crc32cSoftware;
+}
+
+Crc32cFunction GetCrc32cFunction() {
+  // Chosen on first use, so it works for checksums computed during static initialization.
+  static const Crc32cFunction function = ChooseCrc32cFunction();
+  return function;
+}
+
+} // namespace
+
+uint32_t Crc32cExtend(uint32_t crc, const void* data, size_t length) {
+  return GetCrc32cFunction()(crc, static_cast<const uint8_t*>(data), length);
+}
+
+bool Crc32cHardwareAccelerated() {
+  return GetCrc32cFunction() != &Crc32cSoftware;
 }
 
 } // namespace crc
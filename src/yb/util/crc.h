@@ -45,8 +45,22 @@ typedef crcutil_interface::CRC Crc;
 // Returns pointer to singleton instance of CRC32C implementation.
 Crc* GetCrc32cInstance();
 
+// Returns the CRC32C of concat(A, data), where 'crc' is the CRC32C of A, so a checksum could be
+// computed over a stream of data. The CRC32C of empty data is 0.
+//
+// Uses the CRC32C instructions of the CPU when it has them, as detected at runtime: SSE4.2 on
+// x86-64, computing three interleaved streams of large buffers and combining them with PCLMUL,
+// and the CRC32 extension on ARMv8, combining with PMULL. Otherwise falls back to tables.
+// Results are the same on all paths, and the same as of rocksdb::crc32c::Extend().
+uint32_t Crc32cExtend(uint32_t crc, const void* data, size_t length);
+
+// Returns true if Crc32cExtend() uses CPU instructions rather than tables.
+bool Crc32cHardwareAccelerated();
+
 // Helper function to simply calculate a CRC32C of the given data.
-uint32_t Crc32c(const void* data, size_t length);
+inline uint32_t Crc32c(const void* data, size_t length) {
+  return Crc32cExtend(0, data, length);
+}
 
 } // namespace crc
 } // namespace yb
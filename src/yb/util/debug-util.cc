@@ -440,13 +440,22 @@ Status SetStackTraceSignal(int signum) {
 }
 
 std::string DumpThreadStack(int64_t tid) {
+  StackTrace stack;
+  Status status = GetThreadStack(tid, &stack);
+  if (!status.ok()) {
+    return "(" + status.message().ToString() + ")";
+  }
+  return stack.Symbolize();
+}
+
+Status GetThreadStack(int64_t tid, StackTrace* stack) {
 #if defined(__linux__)
   base::SpinLockHolder h(&g_dumper_thread_lock);
 
   // Ensure that our signal handler is installed. We don't need any fancy GoogleOnce here
   // because of the mutex above.
   if (!InitSignalHandlerUnlocked(g_stack_trace_signum)) {
-    return "<unable to take thread stack: signal handler unavailable>";
+    return STATUS(IllegalState, "unable to take thread stack: signal handler unavailable");
   }
 
   // Set the target TID in our communication structure, so if we end up with any
@@ -465,38 +474,44 @@ std::string DumpThreadStack(int64_t tid) {
       SignalCommunication::Lock l;
       g_comm.target_tid = 0;
     }
-    return "(unable to deliver signal: process may have exited)";
+    return STATUS(NotFound, "unable to deliver signal: process may have exited");
   }
 
   // We give the thread ~1s to respond. In testing, threads typically respond within
-  // a few iterations of the loop, so this timeout is very conservative.
+  // a few iterations of the loop, so this timeout is very conservative. The first iterations
+  // only yield, so that sampling the stacks of many threads, as the continuous profiler does,
+  // does not wait for a sleep per thread.
   //
   // The main reason that a thread would not respond is that it has blocked signals. For
   // example, glibc's timer_thread doesn't respond to our signal, so we always time out
   // on that one.
-  string buf;
   int i = 0;
   while (!base::subtle::Acquire_Load(&g_comm.result_ready) &&
-         i++ < 100) {
-    SleepFor(MonoDelta::FromMilliseconds(10));
+         i++ < 200) {
+    if (i <= 100) {
+      sched_yield();
+    } else {
+      SleepFor(MonoDelta::FromMilliseconds(10));
+    }
   }
 
+  Status status;
   {
     SignalCommunication::Lock l;
     CHECK_EQ(tid, g_comm.target_tid);
 
     if (!g_comm.result_ready) {
-      buf = "(thread did not respond: maybe it is blocking signals)";
+      status = STATUS(TimedOut, "thread did not respond: maybe it is blocking signals");
     } else {
-      buf = g_comm.stack.Symbolize();
+      stack->CopyFrom(g_comm.stack);
     }
 
     g_comm.target_tid = 0;
     g_comm.result_ready = 0;
   }
-  return buf;
+  return status;
 #else // defined(__linux__)
-  return "(unsupported platform)";
+  return STATUS(NotSupported, "unsupported platform");
 #endif
 }
 
@@ -71,6 +71,12 @@ Status SetStackTraceSignal(int signum);
 // may be active at a time.
 std::string DumpThreadStack(int64_t tid);
 
+class StackTrace;
+
+// Collects the stack trace of the given thread into 'stack', without symbolizing it. Has the same
+// requirements and synchronization as DumpThreadStack().
+Status GetThreadStack(int64_t tid, StackTrace* stack);
+
 // Return the current stack trace, stringified.
 std::string GetStackTrace(
     StackTraceLineFormat source_file_path_format = StackTraceLineFormat::DEFAULT,
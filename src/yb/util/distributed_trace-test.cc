@@ -0,0 +1,91 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "yb/util/distributed_trace.h"
+#include "yb/util/test_util.h"
+
+DECLARE_int32(trace_sampling_interval);
+
+namespace yb {
+
+class DistributedTraceTest : public YBTest {
+};
+
+TEST_F(DistributedTraceTest, Sampling) {
+  FLAGS_trace_sampling_interval = 0;
+  for (int i = 0; i != 100; ++i) {
+    ASSERT_FALSE(TraceContext::SampleNew().sampled());
+  }
+
+  FLAGS_trace_sampling_interval = 10;
+  int sampled = 0;
+  for (int i = 0; i != 100; ++i) {
+    if (TraceContext::SampleNew().sampled()) {
+      ++sampled;
+    }
+  }
+  ASSERT_EQ(10, sampled);
+
+  // Children of a context that is not sampled are not sampled either.
+  ASSERT_FALSE(TraceContext().NewChild().sampled());
+}
+
+TEST_F(DistributedTraceTest, Spans) {
+  FLAGS_trace_sampling_interval = 1;
+  std::stringstream earlier_spans;
+  const uint64_t since = DumpSpans(0, &earlier_spans);
+
+  const auto root = TraceContext::SampleNew();
+  ASSERT_TRUE(root.sampled());
+  TraceContext child;
+  {
+    ScopedTraceContext scoped_context(root);
+    ASSERT_EQ(root.span_id, TraceContext::Current().span_id);
+    ScopedSpan span(root, "root");
+    child = TraceContext::Current().NewChild();
+    // A span that continues the trace on another server, recorded by another thread.
+    std::thread([&child] {
+      const auto remote = TraceContext::ChildOfRemote(child.trace_id, child.span_id);
+      ScopedSpan remote_span(remote, "remote");
+    }).join();
+    RecordSpan(child, "child", MonoTime::Now());
+  }
+  ASSERT_FALSE(TraceContext::Current().sampled());
+  ASSERT_EQ(root.trace_id, child.trace_id);
+  ASSERT_EQ(root.span_id, child.parent_span_id);
+
+  std::stringstream out;
+  const uint64_t last = DumpSpans(since, &out);
+  const std::string dump = out.str();
+  ASSERT_EQ(since + 3, last) << dump;
+  const auto remote_pos = dump.find("\"name\":\"remote\"");
+  const auto child_pos = dump.find("\"name\":\"child\"");
+  const auto root_pos = dump.find("\"name\":\"root\"");
+  ASSERT_NE(std::string::npos, remote_pos) << dump;
+  ASSERT_LT(remote_pos, child_pos) << dump;
+  ASSERT_LT(child_pos, root_pos) << dump;
+  ASSERT_NE(std::string::npos, dump.find(Format("\"parent_span_id\":$0", child.span_id))) << dump;
+
+  // Spans are dumped only once.
+  std::stringstream next_out;
+  ASSERT_EQ(last, DumpSpans(last, &next_out));
+  ASSERT_EQ("", next_out.str());
+}
+
+} // namespace yb
@@ -0,0 +1,251 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/util/distributed_trace.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <vector>
+
+#include <gflags/gflags.h>
+
+#include "yb/gutil/strings/substitute.h"
+#include "yb/gutil/walltime.h"
+#include "yb/util/flag_tags.h"
+#include "yb/util/jsonwriter.h"
+#include "yb/util/locks.h"
+#include "yb/util/random_util.h"
+
+DEFINE_int32(trace_sampling_interval, 0,
+             "One in this many requests started by each thread is traced across servers, and its "
+             "spans are recorded. 0 turns tracing off.");
+TAG_FLAG(trace_sampling_interval, advanced);
+TAG_FLAG(trace_sampling_interval, runtime);
+
+namespace yb {
+
+namespace {
+
+// Number of spans kept by each thread that records spans.
+constexpr size_t kSpanBufferCapacity = 256;
+constexpr size_t kMaxSpanNameLength = 47;
+
+struct SpanRecord {
+  uint64_t seq_no;
+  TraceContext context;
+  MicrosecondsInt64 start_us;
+  int64_t duration_us;
+  char name[kMaxSpanNameLength + 1];
+};
+
+class SpanBuffer {
+ public:
+  void Add(const SpanRecord& record) {
+    std::lock_guard<simple_spinlock> lock(lock_);
+    spans_[num_added_ % spans_.size()] = record;
+    ++num_added_;
+  }
+
+  void Collect(uint64_t since, std::vector<SpanRecord>* out) const {
+    std::lock_guard<simple_spinlock> lock(lock_);
+    const size_t begin = num_added_ > spans_.size() ? num_added_ - spans_.size() : 0;
+    for (size_t i = begin; i != num_added_; ++i) {
+      const auto& record = spans_[i % spans_.size()];
+      if (record.seq_no > since) {
+        out->push_back(record);
+      }
+    }
+  }
+
+ private:
+  // Only taken by the owning thread and the occasional DumpSpans(), so it is almost never
+  // contended.
+  mutable simple_spinlock lock_;
+  std::array<SpanRecord, kSpanBufferCapacity> spans_;
+  size_t num_added_ = 0;
+};
+
+class SpanBuffers {
+ public:
+  SpanBuffer* ThreadBuffer() {
+    static thread_local std::shared_ptr<SpanBuffer> buffer;
+    if (PREDICT_FALSE(!buffer)) {
+      buffer = std::make_shared<SpanBuffer>();
+      std::lock_guard<std::mutex> lock(mutex_);
+      buffers_.push_back(buffer);
+    }
+    return buffer.get();
+  }
+
+  uint64_t NextSeqNo() {
+    return next_seq_no_.fetch_add(1, std::memory_order_relaxed) + 1;
+  }
+
+  uint64_t LastSeqNo() const {
+    return next_seq_no_.load(std::memory_order_relaxed);
+  }
+
+  std::vector<SpanRecord> Collect(uint64_t since) {
+    std::vector<SpanRecord> result;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = buffers_.begin(); it != buffers_.end();) {
+      (**it).Collect(since, &result);
+      // The buffers of threads that exited are dropped once their spans were dumped.
+      if (it->use_count() == 1) {
+        it = buffers_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    return result;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::vector<std::shared_ptr<SpanBuffer>> buffers_;
+  std::atomic<uint64_t> next_seq_no_{0};
+};
+
+SpanBuffers& GetSpanBuffers() {
+  // Never destroyed, so threads may record spans during shutdown.
+  static SpanBuffers* buffers = new SpanBuffers;
+  return *buffers;
+}
+
+uint64_t NewId() {
+  uint64_t result;
+  do {
+    result = ThreadLocalRandom()();
+  } while (result == 0);
+  return result;
+}
+
+thread_local TraceContext current_trace_context;
+
+} // namespace
+
+TraceContext TraceContext::NewChild() const {
+  TraceContext result;
+  if (sampled()) {
+    result.trace_id = trace_id;
+    result.span_id = NewId();
+    result.parent_span_id = span_id;
+  }
+  return result;
+}
+
+TraceContext TraceContext::SampleNew() {
+  const int interval = FLAGS_trace_sampling_interval;
+  TraceContext result;
+  if (interval <= 0) {
+    return result;
+  }
+  // Counting per thread keeps sampling off the cache lines shared by the threads.
+  static thread_local uint64_t requests = 0;
+  if (++requests % interval == 0) {
+    result.trace_id = NewId();
+    result.span_id = NewId();
+  }
+  return result;
+}
+
+TraceContext TraceContext::ChildOfRemote(uint64_t trace_id, uint64_t parent_span_id) {
+  TraceContext parent;
+  parent.trace_id = trace_id;
+  parent.span_id = parent_span_id;
+  return parent.NewChild();
+}
+
+const TraceContext& TraceContext::Current() {
+  return current_trace_context;
+}
+
+std::string TraceContext::ToString() const {
+  return strings::Substitute("{ trace_id: $0 span_id: $1 parent_span_id: $2 }",
+                             trace_id, span_id, parent_span_id);
+}
+
+ScopedTraceContext::ScopedTraceContext(const TraceContext& context)
+    : old_context_(current_trace_context) {
+  current_trace_context = context;
+}
+
+ScopedTraceContext::~ScopedTraceContext() {
+  current_trace_context = old_context_;
+}
+
+void RecordSpan(const TraceContext& context, const std::string& name, MonoTime start) {
+  if (!context.sampled()) {
+    return;
+  }
+  auto& buffers = GetSpanBuffers();
+  SpanRecord record;
+  record.seq_no = buffers.NextSeqNo();
+  record.context = context;
+  record.duration_us = MonoTime::Now().GetDeltaSince(start).ToMicroseconds();
+  // Spans of different servers are put together, so they need the wall clock.
+  record.start_us = GetCurrentTimeMicros() - record.duration_us;
+  const size_t length = std::min(name.size(), kMaxSpanNameLength);
+  memcpy(record.name, name.data(), length);
+  record.name[length] = 0;
+  buffers.ThreadBuffer()->Add(record);
+}
+
+ScopedSpan::ScopedSpan(const TraceContext& context, const char* name)
+    : context_(context), name_(name), start_(context.sampled() ? MonoTime::Now() : MonoTime()) {
+}
+
+ScopedSpan::~ScopedSpan() {
+  if (context_.sampled()) {
+    RecordSpan(context_, name_, start_);
+  }
+}
+
+uint64_t DumpSpans(uint64_t since, std::ostream* out) {
+  auto& buffers = GetSpanBuffers();
+  const uint64_t last_seq_no = buffers.LastSeqNo();
+  auto spans = buffers.Collect(since);
+  std::sort(spans.begin(), spans.end(), [](const SpanRecord& lhs, const SpanRecord& rhs) {
+    return lhs.seq_no < rhs.seq_no;
+  });
+  for (const auto& span : spans) {
+    std::stringstream line;
+    JsonWriter writer(&line, JsonWriter::COMPACT);
+    writer.StartObject();
+    writer.String("seq_no");
+    writer.Uint64(span.seq_no);
+    writer.String("trace_id");
+    writer.Uint64(span.context.trace_id);
+    writer.String("span_id");
+    writer.Uint64(span.context.span_id);
+    writer.String("parent_span_id");
+    writer.Uint64(span.context.parent_span_id);
+    writer.String("name");
+    writer.String(span.name);
+    writer.String("start_us");
+    writer.Int64(span.start_us);
+    writer.String("duration_us");
+    writer.Int64(span.duration_us);
+    writer.EndObject();
+    *out << line.str() << '\n';
+  }
+  return last_seq_no;
+}
+
+} // namespace yb
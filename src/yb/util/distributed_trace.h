@@ -0,0 +1,100 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_UTIL_DISTRIBUTED_TRACE_H
+#define YB_UTIL_DISTRIBUTED_TRACE_H
+
+#include <stdint.h>
+
+#include <iosfwd>
+#include <string>
+
+#include "yb/gutil/macros.h"
+#include "yb/util/monotime.h"
+
+namespace yb {
+
+// Tracing of sampled requests across servers.
+//
+// A sampled request gets a trace id, and each step of its handling, like an RPC handled by a
+// server or the Raft replication of a write, is a span within the trace. The context of the span
+// that the current thread works for is propagated in RPC headers and Raft messages, so the spans
+// recorded by different servers for the same request can be put together.
+//
+// Spans are recorded into per thread ring buffers and read with DumpSpans(). Requests that are
+// not sampled only pay for checking that the current trace context is empty.
+struct TraceContext {
+  // 0 for work that is not traced.
+  uint64_t trace_id = 0;
+  uint64_t span_id = 0;
+  uint64_t parent_span_id = 0;
+
+  bool sampled() const { return trace_id != 0; }
+
+  // Returns the context of a new span that is a child of this one, or an empty context if this
+  // one is not sampled.
+  TraceContext NewChild() const;
+
+  // Returns the context of the root span of a new trace if the request should be sampled
+  // according to --trace_sampling_interval, otherwise an empty context.
+  static TraceContext SampleNew();
+
+  // Returns the context of a new span whose parent is the span 'parent_span_id' of the trace
+  // 'trace_id', started by another server.
+  static TraceContext ChildOfRemote(uint64_t trace_id, uint64_t parent_span_id);
+
+  // Returns the context adopted by the current thread.
+  static const TraceContext& Current();
+
+  std::string ToString() const;
+};
+
+// Adopts a trace context on the current thread for the duration of the current scope.
+class ScopedTraceContext {
+ public:
+  explicit ScopedTraceContext(const TraceContext& context);
+  ~ScopedTraceContext();
+
+ private:
+  TraceContext old_context_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScopedTraceContext);
+};
+
+// Records the span of 'context' that started at 'start' and ends now. Does nothing if 'context'
+// is not sampled. 'name' is copied, so it does not have to outlive the call.
+void RecordSpan(const TraceContext& context, const std::string& name, MonoTime start);
+
+// Records the span of 'context' from its construction to its destruction.
+class ScopedSpan {
+ public:
+  ScopedSpan(const TraceContext& context, const char* name);
+  ~ScopedSpan();
+
+ private:
+  const TraceContext context_;
+  const char* const name_;
+  const MonoTime start_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScopedSpan);
+};
+
+// Writes the spans recorded after the one with sequence number 'since' that are still in the ring
+// buffers, one JSON object per line. Returns the sequence number of the last span recorded so far,
+// for use as 'since' of the next call. Spans recorded concurrently may be written again by the next
+// call.
+uint64_t DumpSpans(uint64_t since, std::ostream* out);
+
+} // namespace yb
+
+#endif // YB_UTIL_DISTRIBUTED_TRACE_H
@@ -49,6 +49,7 @@
 #include "yb/util/env.h"
 #include "yb/util/errno.h"
 #include "yb/util/flag_tags.h"
+#include "yb/util/io_accounting.h"
 #include "yb/util/locks.h"
 #include "yb/util/logging.h"
 #include "yb/util/malloc.h"
@@ -57,6 +58,7 @@
 #include "yb/util/slice.h"
 #include "yb/util/stopwatch.h"
 #include "yb/util/thread_restrictions.h"
+#include "yb/util/wait_state.h"
 
 #if defined(__APPLE__)
 #include <mach-o/dyld.h>
@@ -209,6 +211,7 @@ static Status IOError(const std::string& context, int err_number, const char* fi
 static Status DoSync(int fd, const string& filename) {
   ThreadRestrictions::AssertIOAllowed();
   if (FLAGS_never_fsync) return Status::OK();
+  ScopedWaitState wait_state(WaitState::kIo);
   if (FLAGS_writable_file_use_fsync) {
     if (fsync(fd) < 0) {
       return STATUS_IO_ERROR(filename, errno);
@@ -258,7 +261,9 @@ class PosixSequentialFile: public SequentialFile {
   Status Read(size_t n, Slice* result, uint8_t* scratch) override {
     ThreadRestrictions::AssertIOAllowed();
     Status s;
+    const auto io_start = IOAccountingStart();
     size_t r = fread_unlocked(scratch, 1, n, file_);
+    RecordIORead(io_start, r);
     *result = Slice(scratch, r);
     if (r < n) {
       if (feof(file_)) {
@@ -297,9 +302,12 @@ class PosixRandomAccessFile: public RandomAccessFile {
   virtual Status Read(uint64_t offset, size_t n, Slice* result,
                       uint8_t *scratch) const override {
     ThreadRestrictions::AssertIOAllowed();
+    ScopedWaitState wait_state(WaitState::kIo);
     Status s;
+    const auto io_start = IOAccountingStart();
     ssize_t r = pread(fd_, scratch, n, static_cast<off_t>(offset));
     *result = Slice(scratch, (r < 0) ? 0 : r);
+    RecordIORead(io_start, result->size());
     if (r < 0) {
       // An error: return a non-ok status.
       s = STATUS_IO_ERROR(filename_, errno);
@@ -491,12 +499,14 @@ class PosixWritableFile : public WritableFile {
       ++j;
     }
 
+    const auto io_start = IOAccountingStart();
     ssize_t written = pwritev(fd_, iov, n, filesize_);
 
     if (PREDICT_FALSE(written == -1)) {
       int err = errno;
       return STATUS_IO_ERROR(filename_, err);
     }
+    RecordIOWrite(io_start, written);
 
     filesize_ += written;
 
@@ -781,6 +791,7 @@ class PosixRWFile final : public RWFile {
   virtual Status Read(uint64_t offset, size_t length,
                       Slice* result, uint8_t* scratch) const override {
     ThreadRestrictions::AssertIOAllowed();
+    ScopedWaitState wait_state(WaitState::kIo);
     int rem = length;
     uint8_t* dst = scratch;
     while (rem > 0) {
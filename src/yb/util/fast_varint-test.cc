@@ -385,6 +385,25 @@ TEST(FastVarIntTest, Unsigned) {
   }
 }
 
+// Varints inside of keys are followed by other bytes, so they are decoded with a single load.
+TEST(FastVarIntTest, UnsignedFollowedByOtherBytes) {
+  std::mt19937_64 rng(654321);
+  for (int i = 0; i != 100000; ++i) {
+    uint64_t len = std::uniform_int_distribution<uint64_t>(1, 10)(rng);
+    uint64_t max_value = len == 10 ? std::numeric_limits<uint64_t>::max() : (1ULL << (7 * len)) - 1;
+    uint64_t value = std::uniform_int_distribution<uint64_t>(0, max_value)(rng);
+    uint8_t buf[kMaxVarIntBufferSize + 8];
+    memset(buf, i % 2 ? 0xff : 0, sizeof(buf));
+    size_t size = 0;
+    FastEncodeUnsignedVarInt(value, buf, &size);
+    uint64_t decoded_value;
+    size_t decoded_size = 0;
+    ASSERT_OK(FastDecodeUnsignedVarInt(buf, sizeof(buf), &decoded_value, &decoded_size));
+    ASSERT_EQ(value, decoded_value);
+    ASSERT_EQ(size, decoded_size) << "Value is: " << value;
+  }
+}
+
 TEST(FastVarIntTest, DecodeUnsignedIncorrect) {
   const auto& incorrect_values = IncorrectValues();
   for (const auto& value : incorrect_values) {
@@ -13,6 +13,8 @@
 
 #include "yb/util/fast_varint.h"
 
+#include <string.h>
+
 #include "yb/util/bytes_formatter.h"
 #include "yb/util/debug/leakcheck_disabler.h"
 #include "yb/util/cast.h"
@@ -314,6 +316,16 @@ CHECKED_STATUS FastDecodeUnsignedVarInt(
     return Status::OK();
   }
 
+  if (n_bytes <= 8 && src_size >= 8) {
+    // Read the varint with a single load instead of byte by byte. The varint occupies the first
+    // n_bytes of the big endian word, and its header the highest n_bytes bits of the varint.
+    uint64_t word;
+    memcpy(&word, src, sizeof(word));
+    *v = (__builtin_bswap64(word) >> (64 - 8 * n_bytes)) & ((1ULL << (7 * n_bytes)) - 1);
+    *decoded_size = n_bytes;
+    return Status::OK();
+  }
+
   uint64_t result = 0;
   int i = 0;
   if (n_bytes == 9) {
@@ -125,4 +125,20 @@ TEST_F(HdrHistogramTest, PercentileAndCopyTest) {
   ASSERT_EQ(hist.TotalSum(), copy.TotalSum());
 }
 
+TEST_F(HdrHistogramTest, ResetTest) {
+  HdrHistogram hist(10000, kSigDigits);
+  hist.Increment(7);
+  hist.Increment(5000);
+  hist.Reset();
+  ASSERT_EQ(0, hist.TotalCount());
+  ASSERT_EQ(0, hist.TotalSum());
+  ASSERT_EQ(0, hist.CountInBucketForValue(7));
+  ASSERT_EQ(0, hist.MaxValue());
+
+  hist.Increment(20);
+  ASSERT_EQ(1, hist.TotalCount());
+  ASSERT_EQ(20, hist.MinValue());
+  ASSERT_EQ(20, hist.MaxValue());
+}
+
 } // namespace yb
@@ -159,6 +159,10 @@ void HdrHistogram::Increment(int64_t value) {
 }
 
 void HdrHistogram::IncrementBy(int64_t value, int64_t count) {
+  IncrementByDetectingContention(value, count);
+}
+
+bool HdrHistogram::IncrementByDetectingContention(int64_t value, int64_t count) {
   DCHECK_GE(value, 0);
   DCHECK_GE(count, 0);
 
@@ -168,16 +172,27 @@ void HdrHistogram::IncrementBy(int64_t value, int64_t count) {
   int sub_bucket_index = SubBucketIndex(value, bucket_index);
   int counts_index = CountsArrayIndex(bucket_index, sub_bucket_index);
 
-  // Increment bucket, total, and sum.
+  // Increment bucket, total, and sum. A CAS on the total costs about the same as an increment
+  // when there is no contention, and fails when another thread updated the histogram meanwhile.
   NoBarrier_AtomicIncrement(&counts_[counts_index], count);
-  NoBarrier_AtomicIncrement(&total_count_, count);
+  Atomic64 old_total_count = NoBarrier_Load(&total_count_);
+  bool contended = NoBarrier_CompareAndSwap(
+      &total_count_, old_total_count, old_total_count + count) != old_total_count;
+  if (PREDICT_FALSE(contended)) {
+    NoBarrier_AtomicIncrement(&total_count_, count);
+  }
   NoBarrier_AtomicIncrement(&total_sum_, value * count);
 
+  UpdateMinAndMax(value, value);
+  return contended;
+}
+
+void HdrHistogram::UpdateMinAndMax(int64_t min, int64_t max) {
   // Update min, if needed.
   {
     Atomic64 min_val;
-    while (PREDICT_FALSE(value < (min_val = MinValue()))) {
-      Atomic64 old_val = NoBarrier_CompareAndSwap(&min_value_, min_val, value);
+    while (PREDICT_FALSE(min < (min_val = MinValue()))) {
+      Atomic64 old_val = NoBarrier_CompareAndSwap(&min_value_, min_val, min);
       if (PREDICT_TRUE(old_val == min_val)) break; // CAS success.
     }
   }
@@ -185,13 +200,37 @@ void HdrHistogram::IncrementBy(int64_t value, int64_t count) {
   // Update max, if needed.
   {
     Atomic64 max_val;
-    while (PREDICT_FALSE(value > (max_val = MaxValue()))) {
-      Atomic64 old_val = NoBarrier_CompareAndSwap(&max_value_, max_val, value);
+    while (PREDICT_FALSE(max > (max_val = MaxValue()))) {
+      Atomic64 old_val = NoBarrier_CompareAndSwap(&max_value_, max_val, max);
       if (PREDICT_TRUE(old_val == max_val)) break; // CAS success.
     }
   }
 }
 
+void HdrHistogram::MergeFrom(const HdrHistogram& other) {
+  DCHECK_EQ(highest_trackable_value_, other.highest_trackable_value_);
+  DCHECK_EQ(num_significant_digits_, other.num_significant_digits_);
+
+  // Same order as in the copy constructor: sum and min, counts, then max.
+  NoBarrier_AtomicIncrement(&total_sum_, NoBarrier_Load(&other.total_sum_));
+  const Atomic64 other_min = NoBarrier_Load(&other.min_value_);
+
+  uint64_t total_copied_count = 0;
+  for (int i = 0; i < counts_array_length_; i++) {
+    uint64_t count = NoBarrier_Load(&other.counts_[i]);
+    if (count != 0) {
+      NoBarrier_AtomicIncrement(&counts_[i], count);
+      total_copied_count += count;
+    }
+  }
+  if (total_copied_count == 0) {
+    return;
+  }
+  // The total has to be updated before min and max, which are ignored while it is 0.
+  NoBarrier_AtomicIncrement(&total_count_, total_copied_count);
+  UpdateMinAndMax(other_min, NoBarrier_Load(&other.max_value_));
+}
+
 void HdrHistogram::IncrementWithExpectedInterval(int64_t value,
                                                  int64_t expected_interval_between_samples) {
   Increment(value);
@@ -205,6 +244,18 @@ void HdrHistogram::IncrementWithExpectedInterval(int64_t value,
   }
 }
 
+void HdrHistogram::Reset() {
+  // Reverse order of the copy constructor: the total goes first, so a concurrent reader sees an
+  // empty histogram rather than counts that no longer add up.
+  NoBarrier_Store(&total_count_, 0);
+  NoBarrier_Store(&max_value_, 0);
+  for (int i = 0; i < counts_array_length_; i++) {
+    NoBarrier_Store(&counts_[i], 0);
+  }
+  NoBarrier_Store(&min_value_, std::numeric_limits<Atomic64>::max());
+  NoBarrier_Store(&total_sum_, 0);
+}
+
 ////////////////////////////////////
 
 int HdrHistogram::BucketIndex(uint64_t value) const {
@@ -97,6 +97,15 @@ class HdrHistogram {
   void Increment(int64_t value);
   void IncrementBy(int64_t value, int64_t count);
 
+  // Same as IncrementBy(), returns true when a concurrent update of the histogram was seen, so
+  // that callers could move hot histograms off the shared counters.
+  bool IncrementByDetectingContention(int64_t value, int64_t count);
+
+  // Adds the values recorded by 'other', which should have the same highest trackable value and
+  // number of significant digits. Like the copy constructor, this is not a consistent snapshot of
+  // 'other' while it is being updated.
+  void MergeFrom(const HdrHistogram& other);
+
   // Record new data, correcting for "coordinated omission".
   //
   // See https://groups.google.com/d/msg/mechanical-sympathy/icNZJejUHfE/BfDekfBEs_sJ
@@ -104,6 +113,10 @@ class HdrHistogram {
   void IncrementWithExpectedInterval(int64_t value,
                                      int64_t expected_interval_between_samples);
 
+  // Drops all recorded values. Values recorded concurrently may be partially lost, so callers that
+  // need exact intervals should keep the writers out while resetting.
+  void Reset();
+
   // Fetch configuration params.
   uint64_t highest_trackable_value() const { return highest_trackable_value_; }
   int num_significant_digits() const { return num_significant_digits_; }
@@ -185,6 +198,7 @@ class HdrHistogram {
 
   void Init();
   int CountsArrayIndex(int bucket_index, int sub_bucket_index) const;
+  void UpdateMinAndMax(int64_t min, int64_t max);
 
   uint64_t highest_trackable_value_;
   int num_significant_digits_;
@@ -0,0 +1,56 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "yb/util/hyperloglog.h"
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+namespace yb {
+
+class HyperLogLogTest : public YBTest {
+};
+
+TEST_F(HyperLogLogTest, Estimate) {
+  HyperLogLog sketch;
+  ASSERT_EQ(0, sketch.Estimate());
+  for (int num_distinct : {10, 1000, 100000}) {
+    HyperLogLog sketch;
+    // Every value is added several times.
+    for (int repeat = 0; repeat != 3; ++repeat) {
+      for (int i = 0; i != num_distinct; ++i) {
+        sketch.Add(std::to_string(i));
+      }
+    }
+    ASSERT_NEAR(num_distinct, sketch.Estimate(), num_distinct * 0.05) << num_distinct;
+  }
+}
+
+TEST_F(HyperLogLogTest, Merge) {
+  HyperLogLog lhs, rhs;
+  for (int i = 0; i != 20000; ++i) {
+    // Half of the values are in both sketches.
+    (i % 2 == 0 ? lhs : rhs).Add(std::to_string(i % 15000));
+  }
+  auto restored = ASSERT_RESULT(HyperLogLog::FromRegisters(rhs.registers()));
+  ASSERT_OK(lhs.Merge(restored));
+  ASSERT_NEAR(15000, lhs.Estimate(), 15000 * 0.05);
+
+  ASSERT_NOK(lhs.Merge(HyperLogLog(HyperLogLog::kDefaultPrecision + 1)));
+  ASSERT_NOK(HyperLogLog::FromRegisters("abc"));
+}
+
+} // namespace yb
@@ -0,0 +1,99 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/util/hyperloglog.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <glog/logging.h>
+
+#include "yb/gutil/bits.h"
+#include "yb/util/hash_util.h"
+
+namespace yb {
+
+namespace {
+
+constexpr int kMinPrecision = 4;
+constexpr int kMaxPrecision = 16;
+constexpr uint64_t kHashSeed = 0x9e3779b97f4a7c15ULL;
+
+} // namespace
+
+HyperLogLog::HyperLogLog(int precision)
+    : precision_(precision), registers_(size_t(1) << precision, '\0') {
+  CHECK_GE(precision, kMinPrecision);
+  CHECK_LE(precision, kMaxPrecision);
+}
+
+void HyperLogLog::AddHash(uint64_t hash) {
+  // The first bits of the hash pick the register, which keeps the highest rank of the rest: the
+  // position of their first set bit.
+  const size_t index = hash >> (64 - precision_);
+  const uint64_t rest = (hash << precision_) | (uint64_t(1) << (precision_ - 1));
+  const uint8_t rank = 64 - Bits::Log2FloorNonZero64(rest);
+  auto& reg = registers_[index];
+  if (static_cast<uint8_t>(reg) < rank) {
+    reg = static_cast<char>(rank);
+  }
+}
+
+void HyperLogLog::Add(const Slice& value) {
+  AddHash(HashUtil::MurmurHash2_64(value.data(), value.size(), kHashSeed));
+}
+
+Status HyperLogLog::Merge(const HyperLogLog& other) {
+  if (other.precision_ != precision_) {
+    return STATUS_FORMAT(InvalidArgument, "Cannot merge a sketch of $0 registers into one of $1",
+                         other.registers_.size(), registers_.size());
+  }
+  for (size_t i = 0; i != registers_.size(); ++i) {
+    registers_[i] = std::max<uint8_t>(registers_[i], other.registers_[i]);
+  }
+  return Status::OK();
+}
+
+double HyperLogLog::Estimate() const {
+  const double m = registers_.size();
+  double sum = 0;
+  size_t num_zeros = 0;
+  for (const char reg : registers_) {
+    const uint8_t rank = reg;
+    sum += std::ldexp(1.0, -rank);
+    if (rank == 0) {
+      ++num_zeros;
+    }
+  }
+  const double alpha = 0.7213 / (1 + 1.079 / m);
+  const double estimate = alpha * m * m / sum;
+  // Linear counting is more accurate while many registers are still empty.
+  if (estimate <= 2.5 * m && num_zeros != 0) {
+    return m * std::log(m / num_zeros);
+  }
+  return estimate;
+}
+
+Result<HyperLogLog> HyperLogLog::FromRegisters(const Slice& registers) {
+  for (int precision = kMinPrecision; precision <= kMaxPrecision; ++precision) {
+    if (registers.size() == (size_t(1) << precision)) {
+      HyperLogLog result(precision);
+      result.registers_.assign(registers.cdata(), registers.size());
+      return result;
+    }
+  }
+  return STATUS_FORMAT(Corruption, "Invalid number of HyperLogLog registers: $0",
+                       registers.size());
+}
+
+} // namespace yb
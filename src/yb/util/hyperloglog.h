@@ -0,0 +1,61 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_UTIL_HYPERLOGLOG_H
+#define YB_UTIL_HYPERLOGLOG_H
+
+#include <stdint.h>
+
+#include <string>
+
+#include "yb/util/slice.h"
+#include "yb/util/result.h"
+
+namespace yb {
+
+// HyperLogLog sketch that estimates the number of distinct values added to it, within about 2% with
+// the default 2^12 registers, using one byte per register whatever the number of values.
+//
+// Sketches with the same number of registers are merged by Merge(), so the values could be added to
+// different sketches, e.g. by different tablets, and counted together.
+class HyperLogLog {
+ public:
+  static constexpr int kDefaultPrecision = 12;
+
+  // Uses 2^precision registers, precision being within [4, 16].
+  explicit HyperLogLog(int precision = kDefaultPrecision);
+
+  // Adds a value, given by a well mixed 64-bit hash of it.
+  void AddHash(uint64_t hash);
+
+  // Adds a value given by its bytes.
+  void Add(const Slice& value);
+
+  // Adds the values added to 'other', which should have the same number of registers.
+  CHECKED_STATUS Merge(const HyperLogLog& other);
+
+  // Returns the estimated number of distinct values added.
+  double Estimate() const;
+
+  // The registers, for sending the sketch to another server, and restoring it from them.
+  const std::string& registers() const { return registers_; }
+  static Result<HyperLogLog> FromRegisters(const Slice& registers);
+
+ private:
+  int precision_;
+  std::string registers_;
+};
+
+} // namespace yb
+
+#endif // YB_UTIL_HYPERLOGLOG_H
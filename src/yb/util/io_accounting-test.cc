@@ -0,0 +1,84 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "yb/util/env.h"
+#include "yb/util/faststring.h"
+#include "yb/util/io_accounting.h"
+#include "yb/util/metrics.h"
+#include "yb/util/test_util.h"
+
+METRIC_DEFINE_entity(io_accounting_test_entity);
+METRIC_DEFINE_counter(io_accounting_test_entity, test_io_bytes_read, "Bytes Read",
+                      yb::MetricUnit::kBytes, "Bytes read");
+METRIC_DEFINE_counter(io_accounting_test_entity, test_io_bytes_written, "Bytes Written",
+                      yb::MetricUnit::kBytes, "Bytes written");
+METRIC_DEFINE_counter(io_accounting_test_entity, test_io_read_ops, "Read Operations",
+                      yb::MetricUnit::kOperations, "Read operations");
+METRIC_DEFINE_counter(io_accounting_test_entity, test_io_write_ops, "Write Operations",
+                      yb::MetricUnit::kOperations, "Write operations");
+METRIC_DEFINE_counter(io_accounting_test_entity, test_io_time, "I/O Time",
+                      yb::MetricUnit::kNanoseconds, "Time spent in I/O");
+
+namespace yb {
+
+class IOAccountingTest : public YBTest {
+ protected:
+  void SetUp() override {
+    YBTest::SetUp();
+    entity_ = METRIC_ENTITY_io_accounting_test_entity.Instantiate(&registry_, "test");
+    metrics_.bytes_read = METRIC_test_io_bytes_read.Instantiate(entity_);
+    metrics_.bytes_written = METRIC_test_io_bytes_written.Instantiate(entity_);
+    metrics_.read_ops = METRIC_test_io_read_ops.Instantiate(entity_);
+    metrics_.write_ops = METRIC_test_io_write_ops.Instantiate(entity_);
+    metrics_.io_time = METRIC_test_io_time.Instantiate(entity_);
+  }
+
+  MetricRegistry registry_;
+  scoped_refptr<MetricEntity> entity_;
+  IOMetrics metrics_;
+};
+
+TEST_F(IOAccountingTest, FileIO) {
+  const std::string data(4096, 'x');
+  const std::string path = GetTestPath("file");
+  faststring read_data;
+
+  // I/O outside of the scope is not accounted.
+  ASSERT_OK(WriteStringToFile(env_.get(), data, path));
+  ASSERT_EQ(0, metrics_.bytes_written->value());
+
+  {
+    ScopedIOAccounting io_accounting(&metrics_);
+    ASSERT_OK(WriteStringToFile(env_.get(), data, path));
+    ASSERT_OK(ReadFileToString(env_.get(), path, &read_data));
+    {
+      // Nested scope that does not account its I/O.
+      ScopedIOAccounting no_accounting(nullptr);
+      ASSERT_OK(ReadFileToString(env_.get(), path, &read_data));
+    }
+  }
+  ASSERT_OK(ReadFileToString(env_.get(), path, &read_data));
+
+  ASSERT_EQ(static_cast<int64_t>(data.size()), metrics_.bytes_written->value());
+  ASSERT_EQ(static_cast<int64_t>(data.size()), metrics_.bytes_read->value());
+  ASSERT_GE(metrics_.write_ops->value(), 1);
+  ASSERT_GE(metrics_.read_ops->value(), 1);
+  ASSERT_GT(metrics_.io_time->value(), 0);
+}
+
+} // namespace yb
@@ -0,0 +1,71 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+
+#include "yb/util/io_accounting.h"
+
+#include "yb/gutil/port.h"
+#include "yb/util/metrics.h"
+
+namespace yb {
+
+namespace {
+
+thread_local const IOMetrics* current_io_metrics = nullptr;
+
+void RecordIO(MonoTime start, const scoped_refptr<Counter> IOMetrics::*bytes_counter,
+              const scoped_refptr<Counter> IOMetrics::*ops_counter, size_t bytes) {
+  if (PREDICT_TRUE(!start.Initialized())) {
+    return;
+  }
+  const auto* metrics = current_io_metrics;
+  if (!metrics) {
+    return;
+  }
+  metrics->io_time->IncrementBy((MonoTime::Now() - start).ToNanoseconds());
+  if (ops_counter) {
+    (metrics->*ops_counter)->Increment();
+    (metrics->*bytes_counter)->IncrementBy(bytes);
+  }
+}
+
+} // namespace
+
+IOMetrics::~IOMetrics() = default;
+
+ScopedIOAccounting::ScopedIOAccounting(const IOMetrics* metrics)
+    : old_metrics_(current_io_metrics) {
+  current_io_metrics = metrics;
+}
+
+ScopedIOAccounting::~ScopedIOAccounting() {
+  current_io_metrics = old_metrics_;
+}
+
+MonoTime IOAccountingStart() {
+  return current_io_metrics ? MonoTime::Now() : MonoTime();
+}
+
+void RecordIORead(MonoTime start, size_t bytes) {
+  RecordIO(start, &IOMetrics::bytes_read, &IOMetrics::read_ops, bytes);
+}
+
+void RecordIOWrite(MonoTime start, size_t bytes) {
+  RecordIO(start, &IOMetrics::bytes_written, &IOMetrics::write_ops, bytes);
+}
+
+void RecordIOSync(MonoTime start) {
+  RecordIO(start, nullptr, nullptr, 0);
+}
+
+} // namespace yb
@@ -0,0 +1,75 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+
+#ifndef YB_UTIL_IO_ACCOUNTING_H
+#define YB_UTIL_IO_ACCOUNTING_H
+
+#include <stddef.h>
+
+#include "yb/gutil/macros.h"
+#include "yb/gutil/ref_counted.h"
+#include "yb/util/enums.h"
+#include "yb/util/monotime.h"
+
+namespace yb {
+
+class Counter;
+
+// Classes of the file I/O done for a tablet.
+YB_DEFINE_ENUM(IOClass, (kForegroundRead)(kFlush)(kCompaction)(kBootstrap));
+
+// Metrics that the file I/O of one class is accounted to.
+struct IOMetrics {
+  scoped_refptr<Counter> bytes_read;
+  scoped_refptr<Counter> bytes_written;
+  scoped_refptr<Counter> read_ops;
+  scoped_refptr<Counter> write_ops;
+  // Nanoseconds spent in reads, writes and syncs.
+  scoped_refptr<Counter> io_time;
+
+  ~IOMetrics();
+};
+
+// Accounts the file I/O done by the current thread to 'metrics' for the duration of the scope.
+// 'metrics' may be null, then the I/O of the scope is not accounted. 'metrics' should outlive the
+// scope.
+//
+// The I/O accounted is the one of yb::Env files and of the RocksDB file readers and writers.
+class ScopedIOAccounting {
+ public:
+  explicit ScopedIOAccounting(const IOMetrics* metrics);
+  ~ScopedIOAccounting();
+
+ private:
+  const IOMetrics* old_metrics_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScopedIOAccounting);
+};
+
+// Returns the start of a file I/O operation, to be passed to RecordIORead(), RecordIOWrite() or
+// RecordIOSync() when it completes, or an uninitialized time when the I/O of the current thread is
+// not accounted.
+MonoTime IOAccountingStart();
+
+// Records a read or a write of 'bytes' started at 'start', which was returned by
+// IOAccountingStart(). Does nothing when 'start' is not initialized.
+void RecordIORead(MonoTime start, size_t bytes);
+void RecordIOWrite(MonoTime start, size_t bytes);
+
+// Records the time of a sync started at 'start'.
+void RecordIOSync(MonoTime start);
+
+} // namespace yb
+
+#endif // YB_UTIL_IO_ACCOUNTING_H
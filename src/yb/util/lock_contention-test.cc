@@ -0,0 +1,110 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "yb/util/lock_contention.h"
+#include "yb/util/mutex.h"
+#include "yb/util/rw_semaphore.h"
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+DECLARE_int32(lock_contention_profiling_sampling_interval);
+
+namespace yb {
+
+class LockContentionTest : public YBTest {
+};
+
+namespace {
+
+// Holds 'lockable' while another thread takes it, so that the other thread is contended.
+template <class Lockable, class Lock>
+void Contend(Lockable* lockable, const Lock& lock) {
+  std::unique_lock<Lockable> holder(*lockable);
+  std::thread thread([&lock] {
+    lock();
+  });
+  SleepFor(MonoDelta::FromMilliseconds(50));
+  holder.unlock();
+  thread.join();
+}
+
+} // namespace
+
+TEST_F(LockContentionTest, Mutex) {
+  FLAGS_lock_contention_profiling_sampling_interval = 1;
+  const auto before = GetLockContentionStats(LockContentionSite::kMutex);
+
+  Mutex mutex;
+  Contend(&mutex, [&mutex] {
+    MutexLock lock(mutex);
+  });
+
+  const auto after = GetLockContentionStats(LockContentionSite::kMutex);
+  ASSERT_GE(after.contentions, before.contentions + 1);
+  ASSERT_GE(after.wait_micros, before.wait_micros + 10000);
+  ASSERT_GE(after.max_wait_micros, 10000);
+
+  std::stringstream out;
+  DumpLockContention(&out);
+  const auto dump = out.str();
+  LOG(INFO) << "Lock contention: " << dump;
+  ASSERT_STR_CONTAINS(dump, "Mutex\t");
+  ASSERT_STR_CONTAINS(dump, " @ ");
+}
+
+TEST_F(LockContentionTest, RwSemaphore) {
+  FLAGS_lock_contention_profiling_sampling_interval = 1;
+  const auto before = GetLockContentionStats(LockContentionSite::kRwSemaphore);
+
+  rw_semaphore semaphore;
+  Contend(&semaphore, [&semaphore] {
+    semaphore.lock_shared();
+    semaphore.unlock_shared();
+  });
+  Contend(&semaphore, [&semaphore] {
+    std::lock_guard<rw_semaphore> lock(semaphore);
+  });
+
+  const auto after = GetLockContentionStats(LockContentionSite::kRwSemaphore);
+  ASSERT_GE(after.contentions, before.contentions + 2);
+}
+
+TEST_F(LockContentionTest, StdMutex) {
+  const auto before = GetLockContentionStats(LockContentionSite::kMvccManager);
+  std::mutex mutex;
+  auto lock = [&mutex] {
+    LockProfilingContention(LockContentionSite::kMvccManager, &mutex);
+    mutex.unlock();
+  };
+
+  // Nothing is recorded while the profiling is off.
+  FLAGS_lock_contention_profiling_sampling_interval = 0;
+  Contend(&mutex, lock);
+  ASSERT_EQ(before.contentions,
+            GetLockContentionStats(LockContentionSite::kMvccManager).contentions);
+
+  FLAGS_lock_contention_profiling_sampling_interval = 1;
+  Contend(&mutex, lock);
+  ASSERT_EQ(before.contentions + 1,
+            GetLockContentionStats(LockContentionSite::kMvccManager).contentions);
+}
+
+} // namespace yb
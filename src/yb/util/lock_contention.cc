@@ -0,0 +1,231 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+
+#include "yb/util/lock_contention.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+#include <gflags/gflags.h>
+
+#include "yb/gutil/bind.h"
+#include "yb/gutil/sysinfo.h"
+#include "yb/gutil/walltime.h"
+#include "yb/util/debug-util.h"
+#include "yb/util/flag_tags.h"
+#include "yb/util/metrics.h"
+
+DEFINE_int32(lock_contention_profiling_sampling_interval, 0,
+             "When positive, the contended waits for yb::Mutex, rw_semaphore, RWCLock, the "
+             "MvccManager mutex and the SharedLockManager locks are profiled: the wait time of "
+             "each is added to the aggregate of its lock, and the stack of one in this many is "
+             "recorded. 0 turns the profiling off.");
+TAG_FLAG(lock_contention_profiling_sampling_interval, advanced);
+TAG_FLAG(lock_contention_profiling_sampling_interval, runtime);
+
+#define YB_LOCK_CONTENTION_METRIC(name, label) \
+  METRIC_DEFINE_gauge_uint64(server, BOOST_PP_CAT(name, _contention_time), \
+      label " Contention Time", yb::MetricUnit::kMicroseconds, \
+      "Amount of time spent waiting for contended " label " locks since the server started. " \
+      "Only counted while --lock_contention_profiling_sampling_interval is positive.", \
+      yb::EXPOSE_AS_COUNTER)
+
+YB_LOCK_CONTENTION_METRIC(mutex, "Mutex");
+YB_LOCK_CONTENTION_METRIC(rw_semaphore, "rw_semaphore");
+YB_LOCK_CONTENTION_METRIC(rwc_lock, "RWCLock");
+YB_LOCK_CONTENTION_METRIC(mvcc_manager, "MvccManager");
+YB_LOCK_CONTENTION_METRIC(shared_lock_manager, "SharedLockManager");
+
+namespace yb {
+
+namespace {
+
+// Number of distinct stacks kept for each lock between dumps.
+constexpr size_t kMaxStacksPerSite = 256;
+
+struct SampledStack {
+  uint64_t hash;
+  StackTrace trace;
+  int64_t count = 0;
+  int64_t cycles = 0;
+};
+
+class SiteContention {
+ public:
+  // Returns true when the stack of this wait should be sampled.
+  bool Add(int64_t cycles, int sampling_interval) {
+    const auto contentions = contentions_.fetch_add(1, std::memory_order_relaxed) + 1;
+    cycles_.fetch_add(cycles, std::memory_order_relaxed);
+    auto max_cycles = max_cycles_.load(std::memory_order_relaxed);
+    while (cycles > max_cycles &&
+           !max_cycles_.compare_exchange_weak(max_cycles, cycles, std::memory_order_relaxed)) {
+    }
+    return contentions % sampling_interval == 0;
+  }
+
+  void AddStack(const StackTrace& trace, int64_t cycles) {
+    const auto hash = trace.HashCode();
+    std::lock_guard<std::mutex> lock(stacks_mutex_);
+    for (auto& stack : stacks_) {
+      if (stack.hash == hash && stack.trace.Equals(trace)) {
+        ++stack.count;
+        stack.cycles += cycles;
+        return;
+      }
+    }
+    if (stacks_.size() == kMaxStacksPerSite) {
+      ++dropped_stacks_;
+      return;
+    }
+    stacks_.emplace_back();
+    auto& stack = stacks_.back();
+    stack.hash = hash;
+    stack.trace.CopyFrom(trace);
+    stack.count = 1;
+    stack.cycles = cycles;
+  }
+
+  int64_t contentions() const {
+    return contentions_.load(std::memory_order_relaxed);
+  }
+
+  int64_t cycles() const {
+    return cycles_.load(std::memory_order_relaxed);
+  }
+
+  int64_t max_cycles() const {
+    return max_cycles_.load(std::memory_order_relaxed);
+  }
+
+  // Moves the sampled stacks to 'out' and returns the number of dropped ones.
+  int64_t TakeStacks(std::vector<SampledStack>* out) {
+    std::lock_guard<std::mutex> lock(stacks_mutex_);
+    out->swap(stacks_);
+    stacks_.clear();
+    return std::exchange(dropped_stacks_, 0);
+  }
+
+ private:
+  std::atomic<int64_t> contentions_{0};
+  std::atomic<int64_t> cycles_{0};
+  std::atomic<int64_t> max_cycles_{0};
+
+  // Only taken for the sampled waits. It is a std::mutex, so taking it is not profiled.
+  std::mutex stacks_mutex_;
+  std::vector<SampledStack> stacks_;
+  int64_t dropped_stacks_ = 0;
+};
+
+std::array<SiteContention, kElementsInLockContentionSite>& Sites() {
+  // Never destroyed, so that locks may be used during shutdown.
+  static auto* sites = new std::array<SiteContention, kElementsInLockContentionSite>;
+  return *sites;
+}
+
+uint64_t CyclesToMicros(int64_t cycles) {
+  return static_cast<uint64_t>(cycles * 1000000.0 / base::CyclesPerSecond());
+}
+
+uint64_t GetLockContentionMicros(LockContentionSite site) {
+  return CyclesToMicros(Sites()[to_underlying(site)].cycles());
+}
+
+} // namespace
+
+int64_t LockContentionStart() {
+  if (PREDICT_TRUE(FLAGS_lock_contention_profiling_sampling_interval <= 0)) {
+    return 0;
+  }
+  return CycleClock::Now();
+}
+
+void RecordLockContention(LockContentionSite site, int64_t start) {
+  if (PREDICT_TRUE(start == 0)) {
+    return;
+  }
+  const int64_t cycles = CycleClock::Now() - start;
+  const int sampling_interval = std::max(FLAGS_lock_contention_profiling_sampling_interval, 1);
+  auto& site_contention = Sites()[to_underlying(site)];
+  if (!site_contention.Add(cycles, sampling_interval)) {
+    return;
+  }
+
+  // Collecting the stack could wait for a lock that is profiled.
+  static thread_local bool collecting_stack = false;
+  if (collecting_stack) {
+    return;
+  }
+  collecting_stack = true;
+  StackTrace stack;
+  stack.Collect();
+  site_contention.AddStack(stack, cycles);
+  collecting_stack = false;
+}
+
+LockContentionStats GetLockContentionStats(LockContentionSite site) {
+  const auto& site_contention = Sites()[to_underlying(site)];
+  LockContentionStats result;
+  result.contentions = site_contention.contentions();
+  result.wait_micros = CyclesToMicros(site_contention.cycles());
+  result.max_wait_micros = CyclesToMicros(site_contention.max_cycles());
+  return result;
+}
+
+void DumpLockContention(std::ostream* out) {
+  *out << "Format: Lock\tContentions\tWait Micros\tMax Wait Micros" << std::endl;
+  for (auto site : kLockContentionSiteList) {
+    const auto stats = GetLockContentionStats(site);
+    *out << ToString(site).substr(1) << "\t" << stats.contentions << "\t" << stats.wait_micros
+         << "\t" << stats.max_wait_micros << std::endl;
+  }
+  *out << std::endl << "Format: Lock\tWait Micros\tCount @ Call Stack" << std::endl;
+  int64_t dropped = 0;
+  std::vector<SampledStack> stacks;
+  for (auto site : kLockContentionSiteList) {
+    dropped += Sites()[to_underlying(site)].TakeStacks(&stacks);
+    std::sort(stacks.begin(), stacks.end(), [](const SampledStack& lhs, const SampledStack& rhs) {
+      return lhs.cycles > rhs.cycles;
+    });
+    for (const auto& stack : stacks) {
+      *out << ToString(site).substr(1) << "\t" << CyclesToMicros(stack.cycles) << "\t"
+           << stack.count << " @ " << stack.trace.ToHexString(StackTrace::NO_FIX_CALLER_ADDRESSES)
+           << "\n" << stack.trace.Symbolize()
+           << "\n-----------" << std::endl;
+    }
+  }
+  *out << "Dropped stacks: " << dropped << std::endl;
+}
+
+void RegisterLockContentionMetrics(const scoped_refptr<MetricEntity>& entity) {
+  const GaugePrototype<uint64_t>* prototypes[] = {
+    &METRIC_mutex_contention_time,
+    &METRIC_rw_semaphore_contention_time,
+    &METRIC_rwc_lock_contention_time,
+    &METRIC_mvcc_manager_contention_time,
+    &METRIC_shared_lock_manager_contention_time,
+  };
+  static_assert(arraysize(prototypes) == kElementsInLockContentionSite,
+                "A metric is needed for each lock contention site");
+  for (auto site : kLockContentionSiteList) {
+    entity->NeverRetire(prototypes[to_underlying(site)]->InstantiateFunctionGauge(
+        entity, Bind(&GetLockContentionMicros, site)));
+  }
+}
+
+} // namespace yb
@@ -0,0 +1,82 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+
+#ifndef YB_UTIL_LOCK_CONTENTION_H
+#define YB_UTIL_LOCK_CONTENTION_H
+
+#include <stdint.h>
+
+#include <iosfwd>
+
+#include "yb/gutil/port.h"
+#include "yb/gutil/ref_counted.h"
+#include "yb/util/enums.h"
+
+namespace yb {
+
+class MetricEntity;
+
+// Contention profiling of the locks that are not gutil spinlocks, which are covered by
+// spinlock_profiling.h.
+//
+// It is turned on by --lock_contention_profiling_sampling_interval. Then the wait time of each
+// contended acquisition is added to the aggregate of its lock, and the stacks of a sample of them
+// are recorded. Acquisitions that are not contended pay nothing, the others pay for reading the
+// flag when profiling is off.
+YB_DEFINE_ENUM(LockContentionSite,
+               (kMutex)(kRwSemaphore)(kRWCLock)(kMvccManager)(kSharedLockManager));
+
+// Returns the start of a contended wait, to be passed to RecordLockContention() when it ends, or 0
+// when contention is not profiled.
+int64_t LockContentionStart();
+
+// Records the contended wait for a lock of 'site' started at 'start', which was returned by
+// LockContentionStart(). Does nothing when 'start' is 0.
+void RecordLockContention(LockContentionSite site, int64_t start);
+
+// Locks 'lockable', recording the wait for a lock of 'site' when it is contended.
+template <class Lockable>
+void LockProfilingContention(LockContentionSite site, Lockable* lockable) {
+  if (PREDICT_TRUE(lockable->try_lock())) {
+    return;
+  }
+  const auto start = LockContentionStart();
+  lockable->lock();
+  RecordLockContention(site, start);
+}
+
+struct LockContentionStats {
+  uint64_t contentions = 0;
+  uint64_t wait_micros = 0;
+  uint64_t max_wait_micros = 0;
+};
+
+// Returns the aggregate of the contended waits for the locks of 'site' since the process started.
+LockContentionStats GetLockContentionStats(LockContentionSite site);
+
+// Writes the aggregate of each lock, followed by the stacks sampled since the previous call, in the
+// following format:
+//   <lock>\t<contentions>\t<wait micros>\t<max wait micros>
+//   ...
+//   <lock>\t<wait micros>\t<count> @ <hex stack trace>
+//   <symbolized stack trace>
+// Stacks that did not fit the buffer of their lock are counted as dropped at the end.
+void DumpLockContention(std::ostream* out);
+
+// Registers metrics in the given server entity with the contention time of each lock.
+void RegisterLockContentionMetrics(const scoped_refptr<MetricEntity>& entity);
+
+} // namespace yb
+
+#endif // YB_UTIL_LOCK_CONTENTION_H
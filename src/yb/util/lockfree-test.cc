@@ -15,11 +15,15 @@
 
 #include <thread>
 
+#include <boost/lockfree/queue.hpp>
+
 #include "yb/gutil/strings/substitute.h"
 
 #include "yb/util/test_util.h"
 #include "yb/util/lockfree.h"
 
+using namespace std::chrono_literals;
+
 namespace yb {
 
 struct TestEntry : public MPSCQueueEntry<TestEntry> {
@@ -122,4 +126,184 @@ TEST(LockfreeTest, MPSCQueueConcurrent) {
   }
 }
 
+TEST(LockfreeTest, MPMCQueueSimple) {
+  MPMCQueue<int> queue(3);
+  int value = 0;
+  ASSERT_TRUE(queue.Empty());
+  ASSERT_FALSE(queue.Pop(&value));
+
+  for (int lap = 0; lap != 5; ++lap) {
+    ASSERT_TRUE(queue.Push(1));
+    ASSERT_TRUE(queue.Push(2));
+    ASSERT_TRUE(queue.Push(3));
+    ASSERT_FALSE(queue.Push(4));
+    ASSERT_FALSE(queue.Empty());
+    ASSERT_TRUE(queue.Pop(&value));
+    ASSERT_EQ(1, value);
+    ASSERT_TRUE(queue.Push(5));
+    for (int expected : {2, 3, 5}) {
+      ASSERT_TRUE(queue.Pop(&value));
+      ASSERT_EQ(expected, value);
+    }
+    ASSERT_FALSE(queue.Pop(&value));
+    ASSERT_TRUE(queue.Empty());
+  }
+}
+
+namespace {
+
+// Runs the same number of producers and consumers, that pass 'kEntriesPerThread' values each
+// through the queue, and returns the time it took. Checks that each value is received once and
+// in the order it was sent by its producer.
+template <class Push, class Pop>
+MonoDelta RunProducersAndConsumers(size_t num_threads, Push push, Pop pop) {
+  constexpr size_t kEntriesPerThread = 100000;
+  const size_t num_producers = num_threads / 2;
+
+  std::vector<std::vector<size_t>> received(num_threads - num_producers);
+  std::atomic<size_t> entries_left{num_producers * kEntriesPerThread};
+  std::vector<std::thread> threads;
+  auto start_time = MonoTime::Now();
+  for (size_t i = 0; i != num_producers; ++i) {
+    threads.emplace_back([i, &push] {
+      for (size_t index = 0; index != kEntriesPerThread; ++index) {
+        while (!push(i * kEntriesPerThread + index)) {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+  for (auto& values : received) {
+    threads.emplace_back([&values, &entries_left, &pop] {
+      size_t value;
+      while (entries_left.load(std::memory_order_acquire) != 0) {
+        if (pop(&value)) {
+          values.push_back(value);
+          entries_left.fetch_sub(1, std::memory_order_acq_rel);
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  auto passed = MonoTime::Now() - start_time;
+
+  std::vector<size_t> next_index(num_producers);
+  for (const auto& values : received) {
+    std::vector<size_t> last_index(num_producers);
+    for (auto value : values) {
+      auto producer = value / kEntriesPerThread;
+      auto index = value % kEntriesPerThread + 1;
+      EXPECT_LT(last_index[producer], index);
+      last_index[producer] = index;
+      ++next_index[producer];
+    }
+  }
+  for (auto count : next_index) {
+    EXPECT_EQ(kEntriesPerThread, count);
+  }
+  return passed;
+}
+
+} // namespace
+
+TEST(LockfreeTest, MPMCQueueConcurrent) {
+  constexpr size_t kQueueSize = 1024;
+  for (size_t num_threads : {2, 8, 64}) {
+    MPMCQueue<size_t> queue(kQueueSize);
+    auto passed = RunProducersAndConsumers(
+        num_threads,
+        [&queue](size_t value) { return queue.Push(value); },
+        [&queue](size_t* value) { return queue.Pop(value); });
+    ASSERT_TRUE(queue.Empty());
+
+    boost::lockfree::queue<size_t> boost_queue(kQueueSize);
+    auto boost_passed = RunProducersAndConsumers(
+        num_threads,
+        [&boost_queue](size_t value) { return boost_queue.bounded_push(value); },
+        [&boost_queue](size_t* value) { return boost_queue.pop(*value); });
+
+    LOG(INFO) << num_threads << " threads, MPMCQueue: " << passed
+              << ", boost::lockfree::queue: " << boost_passed;
+  }
+}
+
+TEST(LockfreeTest, EventCount) {
+  constexpr size_t kConsumers = 32;
+  constexpr size_t kProducers = 32;
+  constexpr size_t kEntriesPerProducer = 10000;
+
+  MPMCQueue<size_t> queue(64);
+  EventCount not_empty;
+  EventCount not_full;
+  std::atomic<size_t> entries_left{kProducers * kEntriesPerProducer};
+  std::atomic<size_t> sum{0};
+
+  // Blocks on 'event_count' until 'action' succeeds or all entries were received.
+  auto wait_for = [&entries_left](EventCount* event_count, const auto& action) {
+    for (;;) {
+      if (action() || entries_left.load(std::memory_order_acquire) == 0) {
+        return;
+      }
+      auto key = event_count->PrepareWait();
+      if (action() || entries_left.load(std::memory_order_acquire) == 0) {
+        event_count->CancelWait();
+        return;
+      }
+      event_count->Wait(key);
+    }
+  };
+
+  auto start_time = MonoTime::Now();
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i != kProducers; ++i) {
+    threads.emplace_back([&] {
+      for (size_t value = 1; value <= kEntriesPerProducer; ++value) {
+        wait_for(&not_full, [&queue, value] { return queue.Push(value); });
+        not_empty.Notify();
+      }
+    });
+  }
+  for (size_t i = 0; i != kConsumers; ++i) {
+    threads.emplace_back([&] {
+      while (entries_left.load(std::memory_order_acquire) != 0) {
+        size_t value = 0;
+        wait_for(&not_empty, [&queue, &value] { return queue.Pop(&value); });
+        if (value == 0) {
+          continue;
+        }
+        not_full.Notify();
+        sum.fetch_add(value, std::memory_order_acq_rel);
+        if (entries_left.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+          // Wake up the consumers that wait for entries that will never come.
+          not_empty.Notify();
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  LOG(INFO) << "Passed: " << MonoTime::Now() - start_time;
+
+  ASSERT_EQ(kProducers * kEntriesPerProducer * (kEntriesPerProducer + 1) / 2, sum.load());
+}
+
+TEST(LockfreeTest, EventCountTimeout) {
+  EventCount event_count;
+  auto key = event_count.PrepareWait();
+  ASSERT_FALSE(event_count.WaitUntil(key, std::chrono::steady_clock::now() + 10ms));
+
+  // A notification between PrepareWait() and Wait() is not missed.
+  key = event_count.PrepareWait();
+  event_count.Notify();
+  ASSERT_TRUE(event_count.WaitUntil(key, std::chrono::steady_clock::now() + 1h));
+
+  // Nobody waits, so there is nothing to notify.
+  event_count.Notify();
+  key = event_count.PrepareWait();
+  ASSERT_FALSE(event_count.WaitUntil(key, std::chrono::steady_clock::now() + 10ms));
+}
+
 } // namespace yb
@@ -14,7 +14,16 @@
 #ifndef YB_UTIL_LOCKFREE_H
 #define YB_UTIL_LOCKFREE_H
 
+#include <stdint.h>
+
+#include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
+#include "yb/gutil/port.h"
 
 namespace yb {
 
@@ -91,6 +100,182 @@ T* GetNext(const MPSCQueueEntry<T>* entry) {
   return entry->GetNext();
 }
 
+// Bounded multi producer - multi consumer queue, for values that are cheap to copy, like pointers.
+//
+// It is the ring buffer by Dmitry Vyukov. Each cell has a sequence number that tells whether
+// the cell is ready to be filled or to be read during the current lap of the ring, so producers
+// and consumers only contend on their own position counter and on the cell they work with.
+// The whole ring is allocated by the constructor.
+template <class T>
+class MPMCQueue {
+ public:
+  // The queue holds up to 'capacity' values. The algorithm needs at least 2 cells.
+  explicit MPMCQueue(size_t capacity)
+      : capacity_(std::max<size_t>(capacity, 2)), cells_(new Cell[capacity_]) {
+    for (size_t i = 0; i != capacity_; ++i) {
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  MPMCQueue(const MPMCQueue&) = delete;
+  void operator=(const MPMCQueue&) = delete;
+
+  // Returns false if the queue is full.
+  bool Push(const T& value) {
+    auto pos = push_pos_.load(std::memory_order_relaxed);
+    for (;;) {
+      auto& cell = cells_[pos % capacity_];
+      auto diff = static_cast<intptr_t>(cell.sequence.load(std::memory_order_acquire)) -
+                  static_cast<intptr_t>(pos);
+      if (diff == 0) {
+        if (push_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          cell.value = value;
+          cell.sequence.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        // The cell still holds the value pushed during the previous lap.
+        return false;
+      } else {
+        pos = push_pos_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // Returns false if the queue is empty.
+  bool Pop(T* value) {
+    auto pos = pop_pos_.load(std::memory_order_relaxed);
+    for (;;) {
+      auto& cell = cells_[pos % capacity_];
+      auto diff = static_cast<intptr_t>(cell.sequence.load(std::memory_order_acquire)) -
+                  static_cast<intptr_t>(pos + 1);
+      if (diff == 0) {
+        if (pop_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          *value = std::move(cell.value);
+          cell.sequence.store(pos + capacity_, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        // The cell was not filled yet during this lap.
+        return false;
+      } else {
+        pos = pop_pos_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // The result could be stale when the queue is modified concurrently.
+  bool Empty() const {
+    return pop_pos_.load(std::memory_order_acquire) >= push_pos_.load(std::memory_order_acquire);
+  }
+
+  size_t capacity() const {
+    return capacity_;
+  }
+
+ private:
+  struct Cell {
+    std::atomic<size_t> sequence;
+    T value;
+  };
+
+  const size_t capacity_;
+  std::unique_ptr<Cell[]> cells_;
+  // Producers and consumers should not invalidate the cache lines of each other.
+  CACHELINE_ALIGNED std::atomic<size_t> push_pos_{0};
+  CACHELINE_ALIGNED std::atomic<size_t> pop_pos_{0};
+};
+
+// Lets threads block until a condition, checked without locks, becomes true. For instance,
+// consumers of a lock-free queue could wait for it to become non empty:
+//
+//   for (;;) {
+//     if (queue.Pop(&value)) break;
+//     auto key = event_count.PrepareWait();
+//     if (queue.Pop(&value)) {
+//       event_count.CancelWait();
+//       break;
+//     }
+//     event_count.Wait(key);
+//   }
+//
+// While a producer calls event_count.Notify() after each push.
+//
+// Notify() only costs a fence and a load when nobody waits, so producers do not pay for the mutex
+// unless there is a consumer to wake up. A waiter rechecks the condition after PrepareWait(), so
+// it does not miss a notification that came between the first check and Wait().
+class EventCount {
+ public:
+  typedef uint32_t Key;
+
+  EventCount() = default;
+  EventCount(const EventCount&) = delete;
+  void operator=(const EventCount&) = delete;
+
+  // Registers the current thread as a waiter. Should be followed by Wait(), WaitUntil() or
+  // CancelWait().
+  Key PrepareWait() {
+    return static_cast<Key>(state_.fetch_add(1, std::memory_order_seq_cst) >> kEpochShift);
+  }
+
+  void CancelWait() {
+    state_.fetch_sub(1, std::memory_order_seq_cst);
+  }
+
+  // Waits until Notify() is invoked after PrepareWait() returned 'key'.
+  void Wait(Key key) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cond_.wait(lock, [this, key] { return Epoch() != key; });
+    }
+    CancelWait();
+  }
+
+  // Same as Wait(), but gives up at 'deadline'. Returns false if it has given up.
+  template <class Clock, class Duration>
+  bool WaitUntil(Key key, const std::chrono::time_point<Clock, Duration>& deadline) {
+    bool result;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      result = cond_.wait_until(lock, deadline, [this, key] { return Epoch() != key; });
+    }
+    CancelWait();
+    return result;
+  }
+
+  // Wakes up all threads that are waiting with keys obtained before this call.
+  void Notify() {
+    // Orders the changes that the waiters are waiting for before the load of the waiter count,
+    // pairs with the read-modify-write in PrepareWait().
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if ((state_.load(std::memory_order_relaxed) & kWaitersMask) == 0) {
+      return;
+    }
+    state_.fetch_add(kEpochIncrement, std::memory_order_seq_cst);
+    {
+      // A waiter that has checked the old epoch could not have started waiting yet, unless it
+      // has released the mutex inside the wait.
+      std::lock_guard<std::mutex> lock(mutex_);
+    }
+    cond_.notify_all();
+  }
+
+ private:
+  static constexpr int kEpochShift = 32;
+  static constexpr uint64_t kWaitersMask = (1ULL << kEpochShift) - 1;
+  static constexpr uint64_t kEpochIncrement = 1ULL << kEpochShift;
+
+  Key Epoch() const {
+    return static_cast<Key>(state_.load(std::memory_order_seq_cst) >> kEpochShift);
+  }
+
+  // The number of waiters in the lower half, and the number of notifications that found waiters
+  // in the upper half.
+  std::atomic<uint64_t> state_{0};
+  std::mutex mutex_;
+  std::condition_variable cond_;
+};
+
 } // namespace yb
 
 #endif // YB_UTIL_LOCKFREE_H
@@ -46,6 +46,7 @@
 
 DECLARE_int32(memory_limit_soft_percentage);
 DECLARE_int64(mem_tracker_update_consumption_interval_us);
+DECLARE_int64(mem_tracker_ancestors_batch_bytes);
 
 namespace yb {
 
@@ -129,6 +130,41 @@ TEST(MemTrackerTest, TrackerHierarchy) {
   c2->Release(60);
 }
 
+TEST(MemTrackerTest, BatchedAncestorUpdates) {
+  constexpr int64_t kBatchBytes = 1024;
+  google::FlagSaver flag_saver;
+  FLAGS_mem_tracker_ancestors_batch_bytes = kBatchBytes;
+  shared_ptr<MemTracker> p = MemTracker::CreateTracker(10 * kBatchBytes, "p");
+  shared_ptr<MemTracker> c = MemTracker::CreateTracker("c", p);
+
+  // Changes below the batch size reach the parent only once they add up to it.
+  c->Consume(kBatchBytes - 1);
+  EXPECT_EQ(c->consumption(), kBatchBytes - 1);
+  EXPECT_EQ(p->consumption(), 0);
+  c->Consume(1);
+  EXPECT_EQ(p->consumption(), kBatchBytes);
+
+  c->Release(kBatchBytes * 3 / 4);
+  EXPECT_EQ(c->consumption(), kBatchBytes / 4);
+  EXPECT_EQ(p->consumption(), kBatchBytes);
+
+  // The pending release of the child is collected before the parent reports its limit exceeded.
+  p->Consume(9 * kBatchBytes + kBatchBytes / 2);
+  EXPECT_EQ(p->consumption(), 10 * kBatchBytes + kBatchBytes / 2);
+  EXPECT_FALSE(p->LimitExceeded());
+  EXPECT_EQ(p->consumption(), 9 * kBatchBytes + kBatchBytes * 3 / 4);
+
+  // Close to the soft limit of the parent, changes reach it right away.
+  c->Consume(1);
+  EXPECT_EQ(p->consumption(), 9 * kBatchBytes + kBatchBytes * 3 / 4 + 1);
+
+  p->Release(9 * kBatchBytes + kBatchBytes / 2);
+  c->Release(kBatchBytes / 4 + 1);
+  EXPECT_EQ(c->consumption(), 0);
+  c.reset();
+  EXPECT_EQ(p->consumption(), 0);
+}
+
 namespace {
 
 class GcTest : public GarbageCollector {
@@ -33,6 +33,7 @@
 #include "yb/util/mem_tracker.h"
 
 #include <algorithm>
+#include <cstdlib>
 #include <deque>
 #include <limits>
 #include <list>
@@ -102,6 +103,12 @@ DEFINE_int64(mem_tracker_update_consumption_interval_us, 2000000,
              "Interval that is used to update memory consumption from external source. "
              "For instance from tcmalloc statistics.");
 
+DEFINE_int64(mem_tracker_ancestors_batch_bytes, 64 * 1024,
+             "Consumption changes of a memory tracker are applied to its ancestors once they add "
+             "up to this many bytes, unless an ancestor is close to its soft limit. 0 applies "
+             "every change right away.");
+TAG_FLAG(mem_tracker_ancestors_batch_bytes, advanced);
+
 namespace yb {
 
 // NOTE: this class has been adapted from Impala, so the code style varies
@@ -319,6 +326,7 @@ MemTracker::MemTracker(int64_t byte_limit, const string& id, shared_ptr<MemTrack
 
 MemTracker::~MemTracker() {
   VLOG(1) << "Destroying tracker " << ToString();
+  FlushPendingDelta();
   if (parent_) {
     DCHECK_EQ(consumption(), 0) << "Memory tracker " << ToString();
     if (add_to_parent_) {
@@ -455,12 +463,73 @@ void MemTracker::Consume(int64_t bytes) {
   if (PREDICT_FALSE(enable_logging_)) {
     LogUpdate(true, bytes);
   }
-  for (auto& tracker : all_trackers_) {
+  UpdateConsumptionBy(bytes);
+}
+
+void MemTracker::UpdateConsumptionBy(int64_t delta) {
+  IncrementBy(delta, &consumption_, metrics_);
+  // If a UDF calls FunctionContext::TrackAllocation() but allocates less than the
+  // reported amount, the subsequent call to FunctionContext::Free() may cause the
+  // process mem tracker to go negative until it is synced back to the tcmalloc
+  // metric. Don't blow up in this case. (Note that this doesn't affect non-process
+  // trackers since we can enforce that the reported memory usage is internally
+  // consistent.)
+  DCHECK_GE(consumption_.current_value(), 0) << "Tracker: " << ToString();
+
+  if (all_trackers_.size() == 1) {
+    return;
+  }
+  const int64_t batch_bytes = FLAGS_mem_tracker_ancestors_batch_bytes;
+  if (batch_bytes > 0 && !AncestorLimitClose(batch_bytes)) {
+    int64_t pending = pending_ancestors_delta_.fetch_add(delta, std::memory_order_relaxed) + delta;
+    if (std::abs(pending) < batch_bytes) {
+      return;
+    }
+    delta = pending_ancestors_delta_.exchange(0, std::memory_order_relaxed);
+  } else if (pending_ancestors_delta_.load(std::memory_order_relaxed) != 0) {
+    delta += pending_ancestors_delta_.exchange(0, std::memory_order_relaxed);
+  }
+  UpdateAncestorsBy(delta);
+}
+
+void MemTracker::UpdateAncestorsBy(int64_t delta) {
+  if (delta == 0) {
+    return;
+  }
+  for (auto it = all_trackers_.begin() + 1; it != all_trackers_.end(); ++it) {
+    MemTracker* tracker = *it;
     if (!tracker->UpdateConsumption()) {
-      IncrementBy(bytes, &tracker->consumption_, tracker->metrics_);
-      DCHECK_GE(tracker->consumption_.current_value(), 0);
+      IncrementBy(delta, &tracker->consumption_, tracker->metrics_);
+      DCHECK_GE(tracker->consumption_.current_value(), 0) << "Tracker: " << tracker->ToString();
+    }
+  }
+}
+
+bool MemTracker::AncestorLimitClose(int64_t bytes) const {
+  for (const auto& tracker : limit_trackers_) {
+    if (tracker != this && tracker->consumption() + bytes > tracker->soft_limit_) {
+      return true;
     }
   }
+  return false;
+}
+
+void MemTracker::FlushPendingDelta() {
+  if (pending_ancestors_delta_.load(std::memory_order_relaxed) != 0) {
+    UpdateAncestorsBy(pending_ancestors_delta_.exchange(0, std::memory_order_relaxed));
+  }
+}
+
+void MemTracker::ReconcileDescendants() {
+  if (UpdateConsumption()) {
+    // Consumption comes from an external source, so pending changes do not affect it.
+    return;
+  }
+  std::vector<MemTrackerPtr> descendants;
+  ListDescendantTrackers(&descendants);
+  for (const auto& descendant : descendants) {
+    descendant->FlushPendingDelta();
+  }
 }
 
 bool MemTracker::TryConsume(int64_t bytes) {
@@ -536,18 +605,7 @@ void MemTracker::Release(int64_t bytes) {
     LogUpdate(false, bytes);
   }
 
-  for (auto& tracker : all_trackers_) {
-    if (!tracker->UpdateConsumption()) {
-      IncrementBy(-bytes, &tracker->consumption_, tracker->metrics_);
-      // If a UDF calls FunctionContext::TrackAllocation() but allocates less than the
-      // reported amount, the subsequent call to FunctionContext::Free() may cause the
-      // process mem tracker to go negative until it is synced back to the tcmalloc
-      // metric. Don't blow up in this case. (Note that this doesn't affect non-process
-      // trackers since we can enforce that the reported memory usage is internally
-      // consistent.)
-      DCHECK_GE(tracker->consumption_.current_value(), 0) << "Tracker: " << tracker->ToString();
-    }
-  }
+  UpdateConsumptionBy(-bytes);
 }
 
 bool MemTracker::AnyLimitExceeded() {
@@ -561,7 +619,9 @@ bool MemTracker::AnyLimitExceeded() {
 
 bool MemTracker::LimitExceeded() {
   if (PREDICT_FALSE(CheckLimitExceeded())) {
-    return GcMemory(limit_);
+    // Pending releases of the descendants could be all that keeps the limit exceeded.
+    ReconcileDescendants();
+    return CheckLimitExceeded() && GcMemory(limit_);
   }
   return false;
 }
@@ -589,6 +649,7 @@ bool MemTracker::SoftLimitExceeded(double* current_capacity_pct) {
 
   // We're over the threshold; were we randomly chosen to be over the soft limit?
   if (usage + rand_.Uniform64(limit_ - soft_limit_) > limit_) {
+    ReconcileDescendants();
     bool exceeded = GcMemory(soft_limit_);
     if (exceeded && current_capacity_pct) {
       *current_capacity_pct =
@@ -34,6 +34,7 @@
 
 #include <stdint.h>
 
+#include <atomic>
 #include <functional>
 #include <memory>
 #include <string>
@@ -101,6 +102,12 @@ YB_STRONGLY_TYPED_BOOL(OnlyChildren);
 // memory consumption, since the process memory usage may be higher than the computed
 // total memory (tcmalloc does not release deallocated memory immediately).
 //
+// To keep frequent small Consume()/Release() calls off the counters of the ancestors, which are
+// shared by all the trackers below them, a tracker accumulates its changes and passes them on to
+// its ancestors once they add up to --mem_tracker_ancestors_batch_bytes. Changes are passed on
+// immediately while an ancestor with a limit is close to its soft limit, and the pending changes
+// of all descendants are collected before a tracker acts on an exceeded limit.
+//
 // GcFunctions can be attached to a MemTracker in order to free up memory if the limit is
 // reached. If LimitExceeded() is called and the limit is exceeded, it will first call the
 // GcFunctions to try to free memory and recheck the limit. For example, the process
@@ -357,6 +364,22 @@ class MemTracker : public std::enable_shared_from_this<MemTracker> {
   // Logs the stack of the current consume/release. Used for debugging only.
   void LogUpdate(bool is_consume, int64_t bytes) const;
 
+  // Applies 'delta' to this tracker, and to its ancestors either right away or once the pending
+  // changes of this tracker reach the batch size.
+  void UpdateConsumptionBy(int64_t delta);
+
+  // Applies 'delta' to the ancestors of this tracker.
+  void UpdateAncestorsBy(int64_t delta);
+
+  // Returns true if consuming 'bytes' could take an ancestor with a limit over its soft limit.
+  bool AncestorLimitClose(int64_t bytes) const;
+
+  // Applies the pending changes of this tracker to its ancestors.
+  void FlushPendingDelta();
+
+  // Applies the pending changes of all descendants of this tracker, so its consumption is exact.
+  void ReconcileDescendants();
+
   // Variant of CreateTracker() that:
   // 1. Must be called with a non-NULL parent, and
   // 2. Must be called with parent->child_trackers_lock_ held.
@@ -394,6 +417,9 @@ class MemTracker : public std::enable_shared_from_this<MemTracker> {
 
   HighWaterMark consumption_{0};
 
+  // Changes of consumption_ that were not applied to the ancestors yet.
+  std::atomic<int64_t> pending_ancestors_delta_{0};
+
   // this tracker plus all of its ancestors
   std::vector<MemTracker*> all_trackers_;
   // all_trackers_ with valid limits
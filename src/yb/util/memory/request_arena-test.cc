@@ -0,0 +1,93 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "yb/util/memory/arena.h"
+#include "yb/util/memory/request_arena.h"
+#include "yb/util/test_util.h"
+
+DECLARE_int64(request_arena_max_retained_bytes);
+
+namespace yb {
+
+class RequestArenaTest : public YBTest {
+};
+
+TEST_F(RequestArenaTest, Nesting) {
+  ASSERT_EQ(nullptr, CurrentRequestArena());
+  Arena* outer_arena;
+  {
+    ScopedRequestArena outer;
+    outer_arena = &outer.arena();
+    ASSERT_EQ(outer_arena, CurrentRequestArena());
+    auto* outer_value = outer_arena->NewObject<int>(1);
+    {
+      ScopedRequestArena inner;
+      ASSERT_NE(outer_arena, &inner.arena());
+      ASSERT_EQ(&inner.arena(), CurrentRequestArena());
+      for (int i = 0; i != 1000; ++i) {
+        inner.arena().NewObject<int>(i);
+      }
+    }
+    ASSERT_EQ(outer_arena, CurrentRequestArena());
+    // The inner scope did not reset the objects of the outer one.
+    ASSERT_EQ(1, *outer_value);
+  }
+  ASSERT_EQ(nullptr, CurrentRequestArena());
+
+  // The arena is reused by the next scope of the same thread.
+  {
+    ScopedRequestArena next;
+    ASSERT_EQ(outer_arena, &next.arena());
+  }
+
+  // But not by other threads.
+  std::thread([outer_arena] {
+    ASSERT_EQ(nullptr, CurrentRequestArena());
+    ScopedRequestArena other;
+    ASSERT_NE(outer_arena, &other.arena());
+  }).join();
+}
+
+TEST_F(RequestArenaTest, Containers) {
+  ScopedRequestArena scope;
+  ArenaAllocator<int> allocator(CurrentRequestArena());
+  std::vector<int, ArenaAllocator<int>> values(allocator);
+  for (int i = 0; i != 10000; ++i) {
+    values.push_back(i);
+  }
+  ASSERT_GE(scope.arena().memory_footprint(), values.size() * sizeof(int));
+  for (int i = 0; i != 10000; ++i) {
+    ASSERT_EQ(i, values[i]);
+  }
+}
+
+TEST_F(RequestArenaTest, LargeArenaIsNotRetained) {
+  FLAGS_request_arena_max_retained_bytes = 64 * 1024;
+  size_t footprint;
+  {
+    ScopedRequestArena scope;
+    scope.arena().AllocateBytes(1024 * 1024);
+    footprint = scope.arena().memory_footprint();
+  }
+  ASSERT_GE(footprint, 1024 * 1024);
+  ScopedRequestArena scope;
+  ASSERT_LE(scope.arena().memory_footprint(), FLAGS_request_arena_max_retained_bytes);
+}
+
+} // namespace yb
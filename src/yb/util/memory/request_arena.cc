@@ -0,0 +1,83 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+
+#include "yb/util/memory/request_arena.h"
+
+#include <memory>
+#include <vector>
+
+#include <gflags/gflags.h>
+
+#include "yb/util/flag_tags.h"
+#include "yb/util/memory/arena.h"
+
+DEFINE_int64(request_arena_max_retained_bytes, 1024 * 1024,
+             "An arena used by a request is kept by its thread for the following requests only "
+             "if its memory footprint after the reset does not exceed this many bytes.");
+TAG_FLAG(request_arena_max_retained_bytes, advanced);
+TAG_FLAG(request_arena_max_retained_bytes, runtime);
+
+namespace yb {
+
+namespace {
+
+class RequestArenaStack {
+ public:
+  Arena* Push() {
+    if (depth_ == arenas_.size()) {
+      arenas_.emplace_back(new Arena());
+    }
+    auto* result = arenas_[depth_].get();
+    ++depth_;
+    return result;
+  }
+
+  void Pop(Arena* arena) {
+    DCHECK_GT(depth_, 0);
+    --depth_;
+    auto& entry = arenas_[depth_];
+    DCHECK_EQ(entry.get(), arena);
+    entry->Reset();
+    // Reset keeps the last buffer, that could be large if the request allocated a large object.
+    if (entry->memory_footprint() > FLAGS_request_arena_max_retained_bytes) {
+      entry.reset(new Arena());
+    }
+  }
+
+  Arena* Current() const {
+    return depth_ != 0 ? arenas_[depth_ - 1].get() : nullptr;
+  }
+
+ private:
+  // Arenas of the open scopes come first, then the ones kept for reuse.
+  std::vector<std::unique_ptr<Arena>> arenas_;
+  size_t depth_ = 0;
+};
+
+thread_local RequestArenaStack request_arena_stack;
+
+} // namespace
+
+ScopedRequestArena::ScopedRequestArena() : arena_(request_arena_stack.Push()) {
+}
+
+ScopedRequestArena::~ScopedRequestArena() {
+  request_arena_stack.Pop(arena_);
+}
+
+Arena* CurrentRequestArena() {
+  return request_arena_stack.Current();
+}
+
+} // namespace yb
@@ -0,0 +1,53 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+
+#ifndef YB_UTIL_MEMORY_REQUEST_ARENA_H
+#define YB_UTIL_MEMORY_REQUEST_ARENA_H
+
+#include "yb/gutil/macros.h"
+#include "yb/util/memory/arena_fwd.h"
+
+namespace yb {
+
+// Request scoped arenas for short lived objects.
+//
+// A ScopedRequestArena pushes an arena to the stack of request arenas of the current thread, and
+// resets it when it goes out of scope. Code that runs within the scope allocates its temporary
+// objects from CurrentRequestArena(), for instance with ArenaAllocator based containers, instead
+// of the global allocator. The arenas are reused by the following scopes of the same thread, so
+// in the steady state a request does not allocate from the global allocator for such objects.
+//
+// Scopes could be nested, each one gets an arena of its own, so an inner scope does not reset
+// the objects of an outer scope. Objects allocated from a request arena must not outlive the
+// scope, so they should not be handed to other threads or kept by asynchronous callbacks.
+class ScopedRequestArena {
+ public:
+  ScopedRequestArena();
+  ~ScopedRequestArena();
+
+  Arena& arena() { return *arena_; }
+
+ private:
+  Arena* const arena_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScopedRequestArena);
+};
+
+// Returns the arena of the innermost ScopedRequestArena of the current thread, or nullptr if the
+// thread is not within such a scope.
+Arena* CurrentRequestArena();
+
+} // namespace yb
+
+#endif // YB_UTIL_MEMORY_REQUEST_ARENA_H
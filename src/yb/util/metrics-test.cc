@@ -34,6 +34,7 @@
 #include <gtest/gtest.h>
 #include <rapidjson/document.h>
 #include <string>
+#include <thread>
 #include <unordered_set>
 #include <vector>
 
@@ -181,6 +182,37 @@ TEST_F(MetricsTest, SimpleHistogramTest) {
   // TODO: Test coverage needs to be improved a lot.
 }
 
+TEST_F(MetricsTest, ShardedHistogramTest) {
+  constexpr int kNumThreads = 16;
+  constexpr int kValuesPerThread = 1000;
+
+  scoped_refptr<Histogram> hist = METRIC_test_hist.Instantiate(entity_);
+  hist->Increment(1);
+  // Contention is what switches a histogram to shards, so force the switch to keep the test
+  // deterministic.
+  hist->sharded_ = true;
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i != kNumThreads; ++i) {
+    threads.emplace_back([hist]() {
+      for (int value = 1; value <= kValuesPerThread; ++value) {
+        hist->Increment(value);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  ASSERT_EQ(1 + kNumThreads * kValuesPerThread, hist->TotalCount());
+  ASSERT_EQ(1 + kNumThreads * kValuesPerThread * (kValuesPerThread + 1) / 2, hist->TotalSum());
+  ASSERT_EQ(1, hist->MinValueForTests());
+  ASSERT_EQ(kValuesPerThread, hist->MaxValueForTests());
+  ASSERT_EQ(kNumThreads + 1, hist->CountInBucketForValueForTests(1));
+  // Everything recorded after the switch went to the shards.
+  ASSERT_EQ(1, hist->histogram_->TotalCount());
+}
+
 TEST_F(MetricsTest, JsonPrintTest) {
   scoped_refptr<Counter> bytes_seen = METRIC_reqs_pending.Instantiate(entity_);
   bytes_seen->Increment();
@@ -322,4 +354,36 @@ TEST_F(MetricsTest, TestDumpJsonPrototypes) {
   ASSERT_TRUE(ContainsKey(seen_metrics, "test_hist"));
 }
 
+TEST_F(MetricsTest, PrometheusWriter) {
+  const MetricEntity::AttributeMap tablet_attr = {{"table_id", "t1"}, {"table_name", "table1"}};
+  const MetricEntity::AttributeMap server_attr = {{"metric_type", "server"}};
+  PrometheusExportedValues exported_values;
+
+  auto write = [&](int64_t tablet1_value, int64_t tablet2_value, int64_t server_value) {
+    std::stringstream output;
+    PrometheusWriter writer(&output, &exported_values);
+    EXPECT_OK(writer.WriteSingleEntry(tablet_attr, "reads", tablet1_value));
+    EXPECT_OK(writer.WriteSingleEntry(tablet_attr, "reads", tablet2_value));
+    EXPECT_OK(writer.WriteSingleEntry(server_attr, "calls", server_value));
+    EXPECT_OK(writer.FlushAggregatedValues());
+    return output.str();
+  };
+
+  // The values of the tablets of a table are summed up.
+  auto output = write(1, 2, 10);
+  ASSERT_NE(output.find("reads{table_id=\"t1\",table_name=\"table1\"} 3 "), string::npos)
+      << output;
+  ASSERT_NE(output.find("calls{metric_type=\"server\"} 10 "), string::npos) << output;
+
+  // Only the entries that changed since the previous export are written.
+  output = write(2, 1, 11);
+  ASSERT_EQ(output.find("reads"), string::npos) << output;
+  ASSERT_NE(output.find("calls{metric_type=\"server\"} 11 "), string::npos) << output;
+
+  output = write(2, 2, 11);
+  ASSERT_NE(output.find("reads{table_id=\"t1\",table_name=\"table1\"} 4 "), string::npos)
+      << output;
+  ASSERT_EQ(output.find("calls"), string::npos) << output;
+}
+
 } // namespace yb
@@ -31,6 +31,7 @@
 //
 #include "yb/util/metrics.h"
 
+#include <cmath>
 #include <iostream>
 #include <map>
 #include <regex>
@@ -43,6 +44,7 @@
 #include "yb/gutil/map-util.h"
 #include "yb/gutil/singleton.h"
 #include "yb/gutil/stl_util.h"
+#include "yb/gutil/strings/numbers.h"
 #include "yb/gutil/strings/substitute.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/hdr_histogram.h"
@@ -285,46 +287,45 @@ Status MetricEntity::WriteAsJson(JsonWriter* writer,
 }
 
 CHECKED_STATUS MetricEntity::WriteForPrometheus(PrometheusWriter* writer) const {
-  // We want the keys to be in alphabetical order when printing, so we use an ordered map here.
-  typedef std::map<const char*, scoped_refptr<Metric> > OrderedMetricMap;
-  OrderedMetricMap metrics;
-  AttributeMap attrs;
+  const bool is_tablet = strcmp(prototype_->name(), "tablet") == 0;
+  if (!is_tablet && strcmp(prototype_->name(), "server") != 0 &&
+      strcmp(prototype_->name(), "cluster") != 0) {
+    return Status::OK();
+  }
+
+  // Prometheus does not need the entries in any particular order, so the metrics are not sorted.
+  std::vector<scoped_refptr<Metric>> metrics;
+  AttributeMap prometheus_attr;
   std::vector<ExternalPrometheusMetricsCb> external_metrics_cbs;
   {
     // Snapshot the metrics, attributes & external metrics callbacks in this metrics entity. (Note:
     // this is not guaranteed to be a consistent snapshot).
     std::lock_guard<simple_spinlock> l(lock_);
-    attrs = attributes_;
+    // Per tablet metrics come with tablet_id, as well as table_id and table_name attributes.
+    // We ignore the tablet part to squash at the table level.
+    if (is_tablet) {
+      prometheus_attr["table_id"] = FindWithDefault(attributes_, "table_id", "");
+      prometheus_attr["table_name"] = FindWithDefault(attributes_, "table_name", "");
+    } else {
+      prometheus_attr = attributes_;
+      // This is tablet_id in the case of tablet, but otherwise names the server type, eg:
+      // yb.master
+      prometheus_attr["metric_id"] = id_;
+    }
     external_metrics_cbs = external_prometheus_metrics_cbs_;
+    metrics.reserve(metric_map_.size());
     for (const MetricMap::value_type& val : metric_map_) {
-      const MetricPrototype* prototype = val.first;
-      const scoped_refptr<Metric>& metric = val.second;
-
-      InsertOrDie(&metrics, prototype->name(), metric);
+      metrics.push_back(val.second);
     }
   }
-  AttributeMap prometheus_attr;
-  // Per tablet metrics come with tablet_id, as well as table_id and table_name attributes.
-  // We ignore the tablet part to squash at the table level.
-  if (strcmp(prototype_->name(), "tablet") == 0)  {
-    prometheus_attr["table_id"] = attrs["table_id"];
-    prometheus_attr["table_name"] = attrs["table_name"];
-  } else if (strcmp(prototype_->name(), "server") == 0 ||
-      strcmp(prototype_->name(), "cluster") == 0) {
-    prometheus_attr = attrs;
-    // This is tablet_id in the case of tablet, but otherwise names the server type, eg: yb.master
-    prometheus_attr["metric_id"] = id_;
-  } else {
-    return Status::OK();
-  }
   // This is currently tablet / server / cluster.
   prometheus_attr["metric_type"] = prototype_->name();
   prometheus_attr["exported_instance"] = FLAGS_metric_node_name;
 
-  for (OrderedMetricMap::value_type& val : metrics) {
-    WARN_NOT_OK(val.second->WriteForPrometheus(writer, prometheus_attr),
-                strings::Substitute("Failed to write $0 as Prometheus", val.first));
-
+  for (const auto& metric : metrics) {
+    WARN_NOT_OK(metric->WriteForPrometheus(writer, prometheus_attr),
+                strings::Substitute("Failed to write $0 as Prometheus",
+                                    metric->prototype()->name()));
   }
   // Run the external metrics collection callback if there is one set.
   for (const ExternalPrometheusMetricsCb& cb : external_metrics_cbs) {
@@ -400,6 +401,108 @@ void MetricEntity::SetAttribute(const string& key, const string& val) {
   attributes_[key] = val;
 }
 
+//
+// PrometheusWriter
+//
+
+PrometheusWriter::PrometheusWriter(std::ostream* output,
+                                   PrometheusExportedValues* exported_values)
+    : output_(output),
+      timestamp_(std::chrono::duration_cast<std::chrono::milliseconds>(
+          std::chrono::system_clock::now().time_since_epoch()).count()),
+      exported_values_(exported_values) {
+  if (exported_values_) {
+    exported_values_lock_ = std::unique_lock<std::mutex>(exported_values_->mutex_);
+    export_id_ = ++exported_values_->last_export_id_;
+  }
+}
+
+PrometheusWriter::~PrometheusWriter() {
+  if (!exported_values_) {
+    return;
+  }
+  auto& entries = exported_values_->entries_;
+  for (auto it = entries.begin(); it != entries.end();) {
+    if (it->second.export_id != export_id_) {
+      it = entries.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+Status PrometheusWriter::FlushAggregatedValues() {
+  for (const auto& table : per_table_values_) {
+    const std::string labels = FormatLabels(table.second.attributes);
+    for (const auto& metric_entry : table.second.values) {
+      RETURN_NOT_OK(FlushSingleEntry(labels, metric_entry.first, metric_entry.second));
+    }
+  }
+  per_table_values_.clear();
+  return Status::OK();
+}
+
+std::string PrometheusWriter::FormatLabels(const MetricEntity::AttributeMap& attr) {
+  if (attr.empty()) {
+    return std::string();
+  }
+  std::vector<const MetricEntity::AttributeMap::value_type*> entries;
+  entries.reserve(attr.size());
+  for (const auto& entry : attr) {
+    entries.push_back(&entry);
+  }
+  std::sort(entries.begin(), entries.end(), [](const auto* lhs, const auto* rhs) {
+    return lhs->first < rhs->first;
+  });
+  std::string result = "{";
+  for (const auto* entry : entries) {
+    if (result.size() > 1) {
+      result += ',';
+    }
+    result += entry->first;
+    result += "=\"";
+    result += entry->second;
+    result += '"';
+  }
+  result += '}';
+  return result;
+}
+
+Status PrometheusWriter::FlushSingleEntry(
+    const std::string& labels, const std::string& name, double value) {
+  entry_key_.clear();
+  entry_key_ += name;
+  entry_key_ += labels;
+  if (exported_values_ && !UpdateExportedValue(entry_key_, value)) {
+    return Status::OK();
+  }
+  *output_ << entry_key_ << ' ';
+  // Counters and most gauges are integers, which would lose digits in the default formatting of
+  // doubles.
+  if (value == std::trunc(value) && std::abs(value) < 1e18) {
+    *output_ << static_cast<int64_t>(value);
+  } else {
+    *output_ << SimpleDtoa(value);
+  }
+  *output_ << ' ' << timestamp_ << '\n';
+  return Status::OK();
+}
+
+bool PrometheusWriter::UpdateExportedValue(const std::string& key, double value) {
+  auto insert_result = exported_values_->entries_.emplace(
+      key, PrometheusExportedValues::Entry{value, export_id_});
+  if (insert_result.second) {
+    return true;
+  }
+  auto& entry = insert_result.first->second;
+  entry.export_id = export_id_;
+  if (entry.value == value) {
+    return false;
+  }
+  entry.value = value;
+  return true;
+}
+
 //
 // MetricRegistry
 //
@@ -726,14 +829,58 @@ scoped_refptr<Histogram> HistogramPrototype::Instantiate(
 Histogram::Histogram(const HistogramPrototype* proto)
   : Metric(proto),
     histogram_(new HdrHistogram(proto->max_trackable_value(), proto->num_sig_digits())) {
+  for (auto& shard : shards_) {
+    shard.store(nullptr, std::memory_order_relaxed);
+  }
+}
+
+Histogram::~Histogram() {
+  for (auto& shard : shards_) {
+    delete shard.load(std::memory_order_acquire);
+  }
 }
 
 void Histogram::Increment(int64_t value) {
-  histogram_->Increment(value);
+  IncrementBy(value, 1);
 }
 
 void Histogram::IncrementBy(int64_t value, int64_t amount) {
-  histogram_->IncrementBy(value, amount);
+  if (PREDICT_TRUE(!sharded_.load(std::memory_order_relaxed))) {
+    if (PREDICT_FALSE(histogram_->IncrementByDetectingContention(value, amount))) {
+      sharded_.store(true, std::memory_order_relaxed);
+    }
+    return;
+  }
+  ThreadShard()->IncrementBy(value, amount);
+}
+
+HdrHistogram* Histogram::ThreadShard() {
+  // Threads are spread over the shards round robin, so the threads of a pool get different ones.
+  static std::atomic<size_t> next_thread_shard{0};
+  static thread_local size_t thread_shard =
+      next_thread_shard.fetch_add(1, std::memory_order_relaxed) % kNumShards;
+
+  auto& shard = shards_[thread_shard];
+  HdrHistogram* result = shard.load(std::memory_order_acquire);
+  if (PREDICT_FALSE(result == nullptr)) {
+    std::unique_ptr<HdrHistogram> new_shard(new HdrHistogram(
+        histogram_->highest_trackable_value(), histogram_->num_significant_digits()));
+    if (shard.compare_exchange_strong(result, new_shard.get(), std::memory_order_acq_rel)) {
+      result = new_shard.release();
+    }
+  }
+  return result;
+}
+
+std::unique_ptr<HdrHistogram> Histogram::Snapshot() const {
+  std::unique_ptr<HdrHistogram> result(new HdrHistogram(*histogram_));
+  for (const auto& shard : shards_) {
+    const HdrHistogram* histogram = shard.load(std::memory_order_acquire);
+    if (histogram) {
+      result->MergeFrom(*histogram);
+    }
+  }
+  return result;
 }
 
 Status Histogram::WriteAsJson(JsonWriter* writer,
@@ -747,15 +894,11 @@ Status Histogram::WriteAsJson(JsonWriter* writer,
 
 CHECKED_STATUS Histogram::WriteForPrometheus(
     PrometheusWriter* writer, const MetricEntity::AttributeMap& attr) const {
-  HdrHistogram snapshot(*histogram_);
-
-  // Representing the sum and count require suffixed names.
+  // Representing the sum and count require suffixed names. Neither needs a snapshot of the
+  // histogram.
   std::string hist_name = prototype_->name();
-  auto copy_of_attr = attr;
-  RETURN_NOT_OK(writer->WriteSingleEntry(
-        copy_of_attr, hist_name + "_sum", snapshot.TotalSum()));
-  RETURN_NOT_OK(writer->WriteSingleEntry(
-        copy_of_attr, hist_name + "_count", snapshot.TotalCount()));
+  RETURN_NOT_OK(writer->WriteSingleEntry(attr, hist_name + "_sum", TotalSum()));
+  RETURN_NOT_OK(writer->WriteSingleEntry(attr, hist_name + "_count", TotalCount()));
   /*
   // Copy the label map to add the quatiles.
   copy_of_attr["quantile"] = "0.75";
@@ -780,7 +923,8 @@ CHECKED_STATUS Histogram::WriteForPrometheus(
 
 Status Histogram::GetHistogramSnapshotPB(HistogramSnapshotPB* snapshot_pb,
                                          const MetricJsonOptions& opts) const {
-  HdrHistogram snapshot(*histogram_);
+  const auto snapshot_holder = Snapshot();
+  const HdrHistogram& snapshot = *snapshot_holder;
   snapshot_pb->set_name(prototype_->name());
   if (opts.include_schema_info) {
     snapshot_pb->set_type(MetricType::Name(prototype_->type()));
@@ -814,22 +958,40 @@ Status Histogram::GetHistogramSnapshotPB(HistogramSnapshotPB* snapshot_pb,
 }
 
 uint64_t Histogram::CountInBucketForValueForTests(uint64_t value) const {
-  return histogram_->CountInBucketForValue(value);
+  return Snapshot()->CountInBucketForValue(value);
 }
 
 uint64_t Histogram::TotalCount() const {
-  return histogram_->TotalCount();
+  uint64_t result = histogram_->TotalCount();
+  for (const auto& shard : shards_) {
+    const HdrHistogram* histogram = shard.load(std::memory_order_acquire);
+    if (histogram) {
+      result += histogram->TotalCount();
+    }
+  }
+  return result;
+}
+
+uint64_t Histogram::TotalSum() const {
+  uint64_t result = histogram_->TotalSum();
+  for (const auto& shard : shards_) {
+    const HdrHistogram* histogram = shard.load(std::memory_order_acquire);
+    if (histogram) {
+      result += histogram->TotalSum();
+    }
+  }
+  return result;
 }
 
 uint64_t Histogram::MinValueForTests() const {
-  return histogram_->MinValue();
+  return Snapshot()->MinValue();
 }
 
 uint64_t Histogram::MaxValueForTests() const {
-  return histogram_->MaxValue();
+  return Snapshot()->MaxValue();
 }
 double Histogram::MeanValueForTests() const {
-  return histogram_->MeanValue();
+  return Snapshot()->MeanValue();
 }
 
 ScopedLatencyMetric::ScopedLatencyMetric(
@@ -239,6 +239,9 @@
 /////////////////////////////////////////////////////
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <sstream>
@@ -581,12 +584,37 @@ class MetricEntity : public RefCountedThreadSafe<MetricEntity> {
 
 typedef scoped_refptr<MetricEntity> MetricEntityPtr;
 
+// Values of the entries written by previous Prometheus exports. Lets an export skip the entries
+// whose values did not change since the previous export that used the same object.
+class PrometheusExportedValues {
+ public:
+  PrometheusExportedValues() {}
+
+ private:
+  friend class PrometheusWriter;
+
+  struct Entry {
+    double value;
+    // Exports that do not write an entry any more drop it.
+    uint64_t export_id;
+  };
+
+  std::mutex mutex_;
+  uint64_t last_export_id_ = 0;
+  // Map from the name and labels of an entry to its value.
+  std::unordered_map<std::string, Entry> entries_;
+
+  DISALLOW_COPY_AND_ASSIGN(PrometheusExportedValues);
+};
+
 class PrometheusWriter {
  public:
-  explicit PrometheusWriter(std::stringstream* output)
-    : output_(output),
-      timestamp_(std::chrono::duration_cast<std::chrono::milliseconds>(
-          std::chrono::system_clock::now().time_since_epoch()).count()) {}
+  // If 'exported_values' is not null, only the entries whose values changed since the previous
+  // export with the same 'exported_values' are written. Such exports are serialized.
+  explicit PrometheusWriter(std::ostream* output,
+                            PrometheusExportedValues* exported_values = nullptr);
+
+  ~PrometheusWriter();
 
   template<typename T>
   CHECKED_STATUS WriteSingleEntry(
@@ -594,63 +622,50 @@ class PrometheusWriter {
     auto it = attr.find("table_id");
     if (it != attr.end()) {
       // For tablet level metrics, we roll up on the table level.
-      if (per_table_attributes_.find(it->second) == per_table_attributes_.end()) {
-        // If it's the first time we see this table, create the aggregate structures.
-        per_table_attributes_[it->second] = attr;
-        per_table_values_[it->second];
-      } else {
-        per_table_values_[it->second][name] += value;
+      auto& table = per_table_values_[it->second];
+      if (table.attributes.empty()) {
+        // If it's the first time we see this table, remember its attributes.
+        table.attributes = attr;
       }
+      table.values[name] += value;
     } else {
       // For non-tablet level metrics, export them directly.
-      RETURN_NOT_OK(FlushSingleEntry(attr, name, value));
+      RETURN_NOT_OK(FlushSingleEntry(FormatLabels(attr), name, value));
     }
     return Status::OK();
   }
 
-  CHECKED_STATUS FlushAggregatedValues() {
-    for (const auto& entry : per_table_values_) {
-      const auto& attrs = per_table_attributes_[entry.first];
-      for (const auto& metric_entry : entry.second) {
-        RETURN_NOT_OK(FlushSingleEntry(attrs, metric_entry.first, metric_entry.second));
-      }
-    }
-    return Status::OK();
-  }
+  CHECKED_STATUS FlushAggregatedValues();
 
  private:
-  template<typename T>
+  struct TableValues {
+    MetricEntity::AttributeMap attributes;
+    // Map from metric name to the sum of its values over the tablets of the table.
+    std::unordered_map<std::string, double> values;
+  };
+
+  // Returns the labels for 'attr', ordered by name so they are the same for every export.
+  static std::string FormatLabels(const MetricEntity::AttributeMap& attr);
+
   CHECKED_STATUS FlushSingleEntry(
-      const MetricEntity::AttributeMap& attr, const std::string& name, const T& value) {
-    *output_ << name;
-    size_t total_elements = attr.size();
-    if (total_elements > 0) {
-      *output_ << "{";
-      for (const auto& entry : attr) {
-        *output_ << entry.first << "=\"" << entry.second << "\"";
-        if (--total_elements > 0) {
-          *output_ << ",";
-        }
-      }
-      *output_ << "}";
-    }
-    *output_ << " " << value;
-    *output_ << " " << timestamp_;
-    *output_ << std::endl;
-    return Status::OK();
-  }
+      const std::string& labels, const std::string& name, double value);
+
+  // Returns true if 'key' was not exported with 'value' by the previous export.
+  bool UpdateExportedValue(const std::string& key, double value);
 
-  // Map from table_id to attributes
-  std::map<std::string, MetricEntity::AttributeMap> per_table_attributes_;
-  // Map from table_id to map of metric_name to value
-  std::map<std::string, std::map<std::string, double>> per_table_values_;
+  // Map from table_id to the attributes and aggregated values of the table.
+  std::unordered_map<std::string, TableValues> per_table_values_;
   // Output stream
-  std::stringstream* output_;
+  std::ostream* output_;
   // Timestamp for all metrics belonging to this writer instance.
   int64_t timestamp_;
-};
-
 
+  PrometheusExportedValues* exported_values_;
+  std::unique_lock<std::mutex> exported_values_lock_;
+  uint64_t export_id_ = 0;
+  // Buffer reused for the name and labels of entries.
+  std::string entry_key_;
+};
 
 // Base class to allow for putting all metrics into a single container.
 // See documentation at the top of this file for information on metrics ownership.
@@ -1165,6 +1180,9 @@ class Histogram : public Metric {
   // or IncrementBy()).
   uint64_t TotalCount() const;
 
+  // Return the sum of all values added to the histogram.
+  uint64_t TotalSum() const;
+
   virtual CHECKED_STATUS WriteAsJson(JsonWriter* w,
                              const MetricJsonOptions& opts) const override;
 
@@ -1182,10 +1200,26 @@ class Histogram : public Metric {
 
  private:
   FRIEND_TEST(MetricsTest, SimpleHistogramTest);
+  FRIEND_TEST(MetricsTest, ShardedHistogramTest);
   friend class MetricEntity;
   explicit Histogram(const HistogramPrototype* proto);
+  ~Histogram();
+
+  // Returns the shard that the calling thread records into, creating it if needed.
+  HdrHistogram* ThreadShard();
+
+  // Returns the values recorded in the histogram, merged from its shards.
+  std::unique_ptr<HdrHistogram> Snapshot() const;
+
+  // Values are recorded into histogram_ until two threads are seen updating it at the same time.
+  // From then on each thread records into one of the shards, which are merged by the readers, so
+  // that hot histograms do not make all the threads contend on the same counters, while the
+  // others do not pay for the memory of the shards.
+  static constexpr size_t kNumShards = 8;
 
   const gscoped_ptr<HdrHistogram> histogram_;
+  std::atomic<bool> sharded_{false};
+  std::array<std::atomic<HdrHistogram*>, kNumShards> shards_;
   DISALLOW_COPY_AND_ASSIGN(Histogram);
 };
 
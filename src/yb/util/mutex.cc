@@ -37,6 +37,8 @@
 
 #include "yb/util/debug-util.h"
 #include "yb/util/env.h"
+#include "yb/util/lock_contention.h"
+#include "yb/util/wait_state.h"
 
 namespace yb {
 
@@ -82,7 +84,13 @@ bool Mutex::TryAcquire() {
 }
 
 void Mutex::Acquire() {
-  int rv = pthread_mutex_lock(&native_handle_);
+  int rv = pthread_mutex_trylock(&native_handle_);
+  if (rv != 0) {
+    ScopedWaitState wait_state(WaitState::kLock);
+    const auto contention_start = LockContentionStart();
+    rv = pthread_mutex_lock(&native_handle_);
+    RecordLockContention(LockContentionSite::kMutex, contention_start);
+  }
 #ifndef NDEBUG
   DCHECK_EQ(0, rv) << ". " << strerror(rv)
       << ". Owner tid: " << owning_tid_ << "; Self tid: " << Env::Default()->gettid()
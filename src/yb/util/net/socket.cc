@@ -40,6 +40,10 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#if defined(__linux__)
+#include <linux/errqueue.h>
+#endif
+
 #include <limits>
 #include <numeric>
 #include <string>
@@ -71,6 +75,22 @@ DEFINE_bool(socket_inject_short_recvs, false,
 TAG_FLAG(socket_inject_short_recvs, hidden);
 TAG_FLAG(socket_inject_short_recvs, unsafe);
 
+#if defined(__linux__)
+// Older kernel and libc headers do not define these.
+#ifndef SO_ZEROCOPY
+#define SO_ZEROCOPY 60
+#endif
+#ifndef MSG_ZEROCOPY
+#define MSG_ZEROCOPY 0x4000000
+#endif
+#ifndef SO_EE_ORIGIN_ZEROCOPY
+#define SO_EE_ORIGIN_ZEROCOPY 5
+#endif
+#ifndef SO_EE_CODE_ZEROCOPY_COPIED
+#define SO_EE_CODE_ZEROCOPY_COPIED 1
+#endif
+#endif
+
 namespace yb {
 
 size_t IoVecsFullSize(const IoVecs& io_vecs) {
@@ -218,6 +238,20 @@ Status Socket::SetNoDelay(bool enabled) {
   return Status::OK();
 }
 
+Status Socket::SetZeroCopy(bool enabled) {
+#if defined(__linux__)
+  int flag = enabled ? 1 : 0;
+  if (setsockopt(fd_, SOL_SOCKET, SO_ZEROCOPY, &flag, sizeof(flag)) == -1) {
+    int err = errno;
+    return STATUS(NetworkError, std::string("failed to set SO_ZEROCOPY: ") +
+                                ErrnoToString(err), Slice(), err);
+  }
+  return Status::OK();
+#else
+  return STATUS(NotSupported, "Zero copy send is not supported on this platform");
+#endif
+}
+
 Status Socket::SetNonBlocking(bool enabled) {
   int curflags = ::fcntl(fd_, F_GETFL, 0);
   if (curflags == -1) {
@@ -482,6 +516,71 @@ Status Socket::Writev(const struct ::iovec *iov, int iov_len,
   return Status::OK();
 }
 
+Status Socket::WritevZeroCopy(const struct ::iovec *iov, int iov_len, int32_t *nwritten) {
+#if defined(__linux__)
+  if (PREDICT_FALSE(iov_len <= 0)) {
+    return STATUS(NetworkError,
+                StringPrintf("writev: invalid io vector length of %d",
+                             iov_len),
+                Slice(), EINVAL);
+  }
+  DCHECK_GE(fd_, 0);
+
+  struct msghdr msg;
+  memset(&msg, 0, sizeof(struct msghdr));
+  msg.msg_iov = const_cast<iovec *>(iov);
+  msg.msg_iovlen = iov_len;
+  int res = ::sendmsg(fd_, &msg, MSG_NOSIGNAL | MSG_ZEROCOPY);
+  if (PREDICT_FALSE(res < 0)) {
+    int err = errno;
+    return STATUS(NetworkError, std::string("sendmsg error: ") +
+                                ErrnoToString(err), Slice(), err);
+  }
+
+  *nwritten = res;
+  return Status::OK();
+#else
+  return STATUS(NotSupported, "Zero copy send is not supported on this platform");
+#endif
+}
+
+Result<boost::optional<Socket::ZeroCopyCompletion>> Socket::ReadZeroCopyCompletion() {
+#if defined(__linux__)
+  char control[CMSG_SPACE(sizeof(sock_extended_err))];
+  struct msghdr msg;
+  memset(&msg, 0, sizeof(struct msghdr));
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+  for (;;) {
+    if (::recvmsg(fd_, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) == -1) {
+      int err = errno;
+      if (err == EAGAIN || err == EWOULDBLOCK) {
+        return boost::none;
+      }
+      return STATUS(NetworkError, std::string("recvmsg error queue error: ") +
+                                  ErrnoToString(err), Slice(), err);
+    }
+    for (cmsghdr* cm = CMSG_FIRSTHDR(&msg); cm; cm = CMSG_NXTHDR(&msg, cm)) {
+      if ((cm->cmsg_level != SOL_IP || cm->cmsg_type != IP_RECVERR) &&
+          (cm->cmsg_level != SOL_IPV6 || cm->cmsg_type != IPV6_RECVERR)) {
+        continue;
+      }
+      auto* serr = reinterpret_cast<sock_extended_err*>(CMSG_DATA(cm));
+      if (serr->ee_errno != 0 || serr->ee_origin != SO_EE_ORIGIN_ZEROCOPY) {
+        continue;
+      }
+      return ZeroCopyCompletion {
+        serr->ee_info, serr->ee_data, (serr->ee_code & SO_EE_CODE_ZEROCOPY_COPIED) != 0
+      };
+    }
+    // Not a zero copy notification, try the next one.
+    msg.msg_controllen = sizeof(control);
+  }
+#else
+  return boost::none;
+#endif
+}
+
 // Mostly follows writen() from Stevens (2004) or Kerrisk (2010).
 Status Socket::BlockingWrite(const uint8_t *buf, size_t buflen, size_t *nwritten,
     const MonoTime& deadline) {
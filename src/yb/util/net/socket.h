@@ -36,6 +36,7 @@
 #include <string>
 
 #include <boost/container/small_vector.hpp>
+#include <boost/optional/optional.hpp>
 
 #include "yb/gutil/macros.h"
 #include "yb/util/status.h"
@@ -96,6 +97,10 @@ class Socket {
   // Set or clear TCP_NODELAY
   CHECKED_STATUS SetNoDelay(bool enabled);
 
+  // Set SO_ZEROCOPY, which allows sending with WritevZeroCopy. Returns NotSupported on platforms
+  // without MSG_ZEROCOPY.
+  CHECKED_STATUS SetZeroCopy(bool enabled);
+
   // Set or clear O_NONBLOCK
   CHECKED_STATUS SetNonBlocking(bool enabled);
   CHECKED_STATUS IsNonBlocking(bool* is_nonblock) const;
@@ -144,6 +149,22 @@ class Socket {
 
   CHECKED_STATUS Writev(const struct ::iovec *iov, int iov_len, int32_t *nwritten);
 
+  // Same as Writev, but the kernel sends directly from the buffers instead of copying them. The
+  // buffers must stay unchanged until the completion of the send is reported by
+  // ReadZeroCopyCompletion. Each successful call gets the next send id, starting from 0.
+  CHECKED_STATUS WritevZeroCopy(const struct ::iovec *iov, int iov_len, int32_t *nwritten);
+
+  // Completion of the zero copy sends with ids in [first_id, last_id].
+  struct ZeroCopyCompletion {
+    uint32_t first_id;
+    uint32_t last_id;
+    // The kernel copied the data anyway, e.g. for loopback connections.
+    bool copied;
+  };
+
+  // Reads the next zero copy completion notification, or returns boost::none if none is pending.
+  Result<boost::optional<ZeroCopyCompletion>> ReadZeroCopyCompletion();
+
   // Blocking Write call, returns IOError unless full buffer is sent.
   // Underlying Socket expected to be in blocking mode. Fails if any Write() sends 0 bytes.
   // Returns OK if buflen bytes were sent, otherwise IOError.
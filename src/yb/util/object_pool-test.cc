@@ -30,7 +30,13 @@
 // under the License.
 //
 
+#include <atomic>
+#include <thread>
+#include <vector>
+
 #include <gtest/gtest.h>
+
+#include "yb/util/monotime.h"
 #include "yb/util/object_pool.h"
 
 namespace yb {
@@ -96,4 +102,35 @@ TEST(TestObjectPool, TestScopedPtr) {
   ASSERT_EQ(0, MyClass::instance_count());
 }
 
+TEST(TestObjectPool, ThreadSafePoolConcurrent) {
+  constexpr size_t kThreads = 64;
+  constexpr size_t kIterations = 100000;
+  std::atomic<size_t> created{0};
+  {
+    ThreadSafeObjectPool<int> pool([&created] {
+      created.fetch_add(1, std::memory_order_relaxed);
+      return new int(0);
+    });
+
+    auto start_time = MonoTime::Now();
+    std::vector<std::thread> threads;
+    while (threads.size() != kThreads) {
+      threads.emplace_back([&pool] {
+        for (size_t i = 0; i != kIterations; ++i) {
+          auto* value = pool.Take();
+          ++*value;
+          pool.Release(value);
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    LOG(INFO) << kThreads << " threads, passed: " << MonoTime::Now() - start_time
+              << ", created: " << created.load();
+  }
+  // The pool keeps objects at hand, so most takes do not create a new object.
+  ASSERT_LT(created.load(), kThreads * kIterations / 10);
+}
+
 } // namespace yb
@@ -59,6 +59,17 @@ void RunTest(const string& name, int user_ticks, int kernel_ticks, int io_wait)
   ASSERT_EQ(io_wait * (1e9 / sysconf(_SC_CLK_TCK)), stats.iowait_ns);
 }
 
+TEST(OsUtilTest, TestParseCpuList) {
+  std::vector<int> cpus;
+  ASSERT_OK(ParseCpuList("0-3,8,10-11", &cpus));
+  ASSERT_EQ(std::vector<int>({0, 1, 2, 3, 8, 10, 11}), cpus);
+  ASSERT_OK(ParseCpuList("", &cpus));
+  ASSERT_TRUE(cpus.empty());
+  ASSERT_NOK(ParseCpuList("3-1", &cpus));
+  ASSERT_NOK(ParseCpuList("1-2-3", &cpus));
+  ASSERT_NOK(ParseCpuList("a", &cpus));
+}
+
 TEST(OsUtilTest, TestSelf) {
   RunTest("test", 111, 222, 333);
 }
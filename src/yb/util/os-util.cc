@@ -42,6 +42,7 @@
 #include <sstream>
 #include <string>
 #include <vector>
+#include <sched.h>
 #include <unistd.h>
 
 #include "yb/gutil/strings/numbers.h"
@@ -159,4 +160,80 @@ bool RunShellProcess(const string& cmd, string* msg) {
   return false;
 }
 
+Status ParseCpuList(const string& list, std::vector<int>* cpus) {
+  cpus->clear();
+  std::vector<string> ranges = Split(list, ",", strings::SkipWhitespace());
+  for (const string& range : ranges) {
+    std::vector<string> bounds = Split(range, "-");
+    int first = 0;
+    int last = 0;
+    if (bounds.size() > 2 || !safe_strto32(bounds[0], &first) ||
+        !safe_strto32(bounds.back(), &last) || first < 0 || last < first) {
+      return STATUS_SUBSTITUTE(InvalidArgument, "Bad CPU list: $0", list);
+    }
+    for (int cpu = first; cpu <= last; ++cpu) {
+      cpus->push_back(cpu);
+    }
+  }
+  return Status::OK();
+}
+
+namespace {
+
+bool ReadCpuList(const string& path, std::vector<int>* cpus) {
+  ifstream in(path);
+  string list;
+  return std::getline(in, list) && ParseCpuList(list, cpus).ok() && !cpus->empty();
+}
+
+} // namespace
+
+std::vector<std::vector<int>> NumaNodeCpus() {
+  std::vector<std::vector<int>> result;
+  std::vector<int> nodes;
+  if (ReadCpuList("/sys/devices/system/node/online", &nodes)) {
+    for (int node : nodes) {
+      std::vector<int> cpus;
+      if (ReadCpuList(Substitute("/sys/devices/system/node/node$0/cpulist", node), &cpus)) {
+        result.push_back(std::move(cpus));
+      }
+    }
+  }
+  if (!result.empty()) {
+    return result;
+  }
+  std::vector<int> cpus;
+  if (!ReadCpuList("/sys/devices/system/cpu/online", &cpus)) {
+    for (int cpu = 0; cpu < sysconf(_SC_NPROCESSORS_ONLN); ++cpu) {
+      cpus.push_back(cpu);
+    }
+  }
+  result.push_back(std::move(cpus));
+  return result;
+}
+
+Status SetCurrentThreadCpuAffinity(const std::vector<int>& cpus) {
+#if defined(__linux__)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (int cpu : cpus) {
+    CPU_SET(cpu, &set);
+  }
+  if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+    return STATUS(IOError, "sched_setaffinity failed", ErrnoToString(errno), errno);
+  }
+  return Status::OK();
+#else
+  return STATUS(NotSupported, "Thread CPU affinity is not supported on this platform");
+#endif
+}
+
+int CurrentCpu() {
+#if defined(__linux__)
+  return sched_getcpu();
+#else
+  return -1;
+#endif
+}
+
 } // namespace yb
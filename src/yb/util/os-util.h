@@ -38,6 +38,7 @@
 #define YB_UTIL_OS_UTIL_H
 
 #include <string>
+#include <vector>
 
 #include "yb/util/status.h"
 
@@ -74,6 +75,19 @@ Status GetThreadStats(int64_t tid, ThreadStats* stats);
 // first 1k of output otherwise.
 bool RunShellProcess(const std::string& cmd, std::string* msg);
 
+// Parses a CPU list in the format of the kernel, e.g. "0-3,8,10-11".
+Status ParseCpuList(const std::string& list, std::vector<int>* cpus);
+
+// Returns the CPUs of each NUMA node. When the topology is not available, returns a single node
+// with all online CPUs.
+std::vector<std::vector<int>> NumaNodeCpus();
+
+// Restricts the calling thread to run on the given CPUs.
+Status SetCurrentThreadCpuAffinity(const std::vector<int>& cpus);
+
+// Returns the CPU the calling thread is running on, or -1 if it is not known.
+int CurrentCpu();
+
 } // namespace yb
 
 #endif /* YB_UTIL_OS_UTIL_H */
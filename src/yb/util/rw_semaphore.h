@@ -39,6 +39,7 @@
 #include "yb/gutil/macros.h"
 #include "yb/gutil/port.h"
 #include "yb/util/debug-util.h"
+#include "yb/util/lock_contention.h"
 
 #include "yb/util/thread.h"
 
@@ -72,6 +73,7 @@ class rw_semaphore {
 
   void lock_shared() {
     int loop_count = 0;
+    int64_t contention_start = 0;
     Atomic32 cur_state = base::subtle::NoBarrier_Load(&state_);
     while (true) {
       Atomic32 expected = cur_state & kNumReadersMask;   // I expect no write lock
@@ -80,8 +82,10 @@ class rw_semaphore {
       if (cur_state == expected)
         break;
       // Either was already locked by someone else, or CAS failed.
+      StartContention(loop_count, &contention_start);
       boost::detail::yield(loop_count++);
     }
+    RecordLockContention(LockContentionSite::kRwSemaphore, contention_start);
   }
 
   void unlock_shared() {
@@ -126,6 +130,7 @@ class rw_semaphore {
 
   void lock() {
     int loop_count = 0;
+    int64_t contention_start = 0;
     Atomic32 cur_state = base::subtle::NoBarrier_Load(&state_);
     while (true) {
       Atomic32 expected = cur_state & kNumReadersMask;   // I expect some 0+ readers
@@ -136,10 +141,12 @@ class rw_semaphore {
       if (cur_state == expected)
         break;
       // Either was already locked by someone else, or CAS failed.
+      StartContention(loop_count, &contention_start);
       boost::detail::yield(loop_count++);
     }
 
-    WaitPendingReaders();
+    WaitPendingReaders(&contention_start);
+    RecordLockContention(LockContentionSite::kRwSemaphore, contention_start);
 
 #ifndef NDEBUG
     writer_tid_ = Thread::CurrentThreadId();
@@ -192,13 +199,25 @@ class rw_semaphore {
   }
 #endif
 
-  void WaitPendingReaders() {
+  // Waits for the readers to release the lock. 'contention_start' is set to the start of the wait
+  // if the lock was not already contended.
+  void WaitPendingReaders(int64_t* contention_start = nullptr) {
     int loop_count = 0;
     while ((base::subtle::Acquire_Load(&state_) & kNumReadersMask) > 0) {
+      if (contention_start && *contention_start == 0) {
+        StartContention(loop_count, contention_start);
+      }
       boost::detail::yield(loop_count++);
     }
   }
 
+  // Starts profiling the contention when the first attempt to take the lock fails.
+  static void StartContention(int loop_count, int64_t* contention_start) {
+    if (loop_count == 0) {
+      *contention_start = LockContentionStart();
+    }
+  }
+
  private:
   volatile Atomic32 state_;
 #ifndef NDEBUG
@@ -34,6 +34,8 @@
 
 #include <glog/logging.h>
 
+#include "yb/util/lock_contention.h"
+
 #ifndef NDEBUG
 #include "yb/gutil/walltime.h"
 #include "yb/util/debug-util.h"
@@ -92,8 +94,12 @@ bool RWCLock::HasWriteLock() const {
 void RWCLock::WriteLock() {
   MutexLock l(lock_);
   // Wait for any other mutations to finish.
-  while (write_locked_) {
-    no_mutators_.Wait();
+  if (write_locked_) {
+    const auto contention_start = LockContentionStart();
+    do {
+      no_mutators_.Wait();
+    } while (write_locked_);
+    RecordLockContention(LockContentionSite::kRWCLock, contention_start);
   }
 #ifndef NDEBUG
   last_writelock_acquire_time_ = GetCurrentTimeMicros();
@@ -116,8 +122,12 @@ void RWCLock::WriteUnlock() {
 void RWCLock::UpgradeToCommitLock() {
   lock_.lock();
   DCHECK(write_locked_);
-  while (reader_count_ > 0) {
-    no_readers_.Wait();
+  if (reader_count_ > 0) {
+    const auto contention_start = LockContentionStart();
+    do {
+      no_readers_.Wait();
+    } while (reader_count_ > 0);
+    RecordLockContention(LockContentionSite::kRWCLock, contention_start);
   }
   DCHECK(write_locked_);
 
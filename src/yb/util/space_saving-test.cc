@@ -0,0 +1,76 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/util/space_saving.h"
+
+#include <map>
+#include <random>
+#include <string>
+
+#include "yb/util/test_util.h"
+
+namespace yb {
+
+class SpaceSavingTest : public YBTest {
+};
+
+TEST_F(SpaceSavingTest, Exact) {
+  SpaceSaving<std::string> sketch(4);
+  for (int i = 0; i != 3; ++i) {
+    sketch.Add("a");
+  }
+  sketch.Add("b", 5);
+  sketch.Add("c");
+
+  auto top = sketch.Top(2);
+  ASSERT_EQ(2, top.size());
+  ASSERT_EQ("b", top[0].item);
+  ASSERT_EQ(5, top[0].count);
+  ASSERT_EQ("a", top[1].item);
+  ASSERT_EQ(3, top[1].count);
+  ASSERT_EQ(0, top[1].error);
+  ASSERT_EQ(9, sketch.total());
+
+  sketch.Clear();
+  ASSERT_TRUE(sketch.empty());
+  ASSERT_EQ(0, sketch.total());
+}
+
+// Hot items hidden in a stream of many distinct ones should be found, with counts within their
+// errors.
+TEST_F(SpaceSavingTest, HeavyHitters) {
+  constexpr size_t kCapacity = 32;
+  constexpr int kHotItems = 4;
+  constexpr int kOps = 100000;
+
+  std::mt19937_64 rng(42);
+  SpaceSaving<int> sketch(kCapacity);
+  std::map<int, size_t> counts;
+  for (int i = 0; i != kOps; ++i) {
+    // Every hot item occurs in 5% of operations, the rest is spread over many cold items.
+    int item = rng() % 20 < kHotItems ? rng() % kHotItems : kHotItems + rng() % 100000;
+    sketch.Add(item);
+    ++counts[item];
+  }
+
+  auto top = sketch.Top(kHotItems);
+  ASSERT_EQ(kHotItems, top.size());
+  for (const auto& counter : top) {
+    ASSERT_LT(counter.item, kHotItems);
+    ASSERT_GE(counter.count, counts[counter.item]);
+    ASSERT_LE(counter.count - counter.error, counts[counter.item]);
+    ASSERT_LE(counter.error, kOps / kCapacity);
+  }
+}
+
+} // namespace yb
@@ -0,0 +1,98 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_UTIL_SPACE_SAVING_H
+#define YB_UTIL_SPACE_SAVING_H
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+namespace yb {
+
+// Space-Saving sketch of the most frequent items of a stream, using a fixed number of counters.
+//
+// An item that has a counter gets it incremented. Otherwise the counter with the smallest count is
+// taken over by the item, which inherits that count as its error. Every item that occurs more than
+// total / capacity times is guaranteed to have a counter, and its count overestimates the number of
+// its occurrences by at most its error.
+//
+// Finding the smallest counter is linear in the capacity, which is meant to be small. Not thread
+// safe.
+template <class Item, class Hash = std::hash<Item>>
+class SpaceSaving {
+ public:
+  struct Counter {
+    Item item;
+    size_t count;
+    size_t error;
+  };
+
+  explicit SpaceSaving(size_t capacity) : capacity_(std::max<size_t>(capacity, 1)) {
+    counters_.reserve(capacity_);
+  }
+
+  void Add(const Item& item, size_t count = 1) {
+    total_ += count;
+    auto it = index_.find(item);
+    if (it != index_.end()) {
+      counters_[it->second].count += count;
+      return;
+    }
+    if (counters_.size() < capacity_) {
+      index_.emplace(item, counters_.size());
+      counters_.push_back(Counter{item, count, 0});
+      return;
+    }
+    auto min = std::min_element(
+        counters_.begin(), counters_.end(),
+        [](const Counter& lhs, const Counter& rhs) { return lhs.count < rhs.count; });
+    index_.erase(min->item);
+    index_.emplace(item, min - counters_.begin());
+    min->item = item;
+    min->error = min->count;
+    min->count += count;
+  }
+
+  // Returns up to 'limit' counters with the largest counts, largest first.
+  std::vector<Counter> Top(size_t limit) const {
+    std::vector<Counter> result(counters_);
+    auto end = result.begin() + std::min(limit, result.size());
+    std::partial_sort(
+        result.begin(), end, result.end(),
+        [](const Counter& lhs, const Counter& rhs) { return lhs.count > rhs.count; });
+    result.erase(end, result.end());
+    return result;
+  }
+
+  // Sum of counts of all added items.
+  size_t total() const { return total_; }
+
+  bool empty() const { return counters_.empty(); }
+
+  void Clear() {
+    counters_.clear();
+    index_.clear();
+    total_ = 0;
+  }
+
+ private:
+  const size_t capacity_;
+  std::vector<Counter> counters_;
+  std::unordered_map<Item, size_t, Hash> index_;
+  size_t total_ = 0;
+};
+
+} // namespace yb
+
+#endif // YB_UTIL_SPACE_SAVING_H
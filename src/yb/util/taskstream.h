@@ -24,8 +24,9 @@
 
 #include <gflags/gflags.h>
 
-#include "yb/util/blocking_queue.h"
+#include "yb/util/lockfree.h"
 #include "yb/util/logging.h"
+#include "yb/util/object_pool.h"
 #include "yb/util/status.h"
 #include "yb/util/taskstream.h"
 #include "yb/util/threadpool.h"
@@ -33,8 +34,7 @@
 using namespace std::chrono_literals;
 
 // We have to make the queue length really long.
-// Note that the lock-free queue seems to be preallocating memory proportional to the queue size
-// (about 64 bytes per entry for 8-byte pointer keys)
+// The queue does not preallocate memory for its entries, so the limit does not cost memory.
 DEFINE_int32(taskstream_queue_max_size, 100000,
              "Maximum number of operations waiting in the taskstream queue.");
 
@@ -105,8 +105,38 @@ class TaskStreamImpl {
   // This is set to true immediately before the thread exits.
   std::atomic<bool> stopped_{false};
 
+  struct Node : public MPSCQueueEntry<Node> {
+    T* item = nullptr;
+  };
+
+  // Nodes are shared by all task streams of the same type, so a stream that is idle does not keep
+  // any.
+  static ThreadSafeObjectPool<Node>& NodePool() {
+    static ThreadSafeObjectPool<Node>* pool = new ThreadSafeObjectPool<Node>([] {
+      return new Node;
+    });
+    return *pool;
+  }
+
+  // Pops all queued items in 'group', or waits for items to be queued until 'deadline'.
+  template <class Deadline>
+  void DrainTo(std::vector<T*>* group, const Deadline& deadline);
+
+  // Moves all queued items to 'group'. Could only be invoked by the Run task.
+  void PopAll(std::vector<T*>* group);
+
   // The objects in the queue are owned by the queue and ownership gets tranferred to ProcessItem.
-  BlockingQueue<T*> queue_;
+  // Submitters push to the queue without locks, and the only consumer is the Run task.
+  MPSCQueue<Node> queue_;
+
+  // Number of items that were submitted but not popped from queue_ yet.
+  std::atomic<int64_t> queue_size_{0};
+
+  // Notified when items are pushed to the queue, or when stop is requested.
+  EventCount items_available_;
+
+  // Notified when the queue stops being full, or when stop is requested.
+  EventCount space_available_;
 
   // This mutex/condition combination is used in Stop() in case multiple threads are calling that
   // function concurrently. One of them will ask the taskstream thread to stop and wait for it, and
@@ -123,8 +153,7 @@ class TaskStreamImpl {
 
 template <typename T>
 TaskStreamImpl<T>::TaskStreamImpl(std::function<void(T*)> process_item, ThreadPool* thread_pool)
-    : queue_(FLAGS_taskstream_queue_max_size),
-      taskstream_pool_token_(thread_pool->NewToken(ThreadPool::ExecutionMode::SERIAL)),
+    : taskstream_pool_token_(thread_pool->NewToken(ThreadPool::ExecutionMode::SERIAL)),
       process_item_(process_item) {
 }
 
@@ -139,15 +168,17 @@ template <typename T> Status TaskStreamImpl<T>::Start() {
 
 template <typename T>
 void TaskStreamImpl<T>::Stop() {
-  queue_.Shutdown();
   if (stopped_.load(std::memory_order_acquire)) {
     return;
   }
   stop_requested_ = true;
+  items_available_.Notify();
+  space_available_.Notify();
   {
     std::unique_lock<std::mutex> stop_lock(stop_mtx_);
     stop_cond_.wait(stop_lock, [this] {
-      return (!running_.load(std::memory_order_acquire) && queue_.empty());
+      return (!running_.load(std::memory_order_acquire) &&
+              queue_size_.load(std::memory_order_acquire) == 0);
     });
   }
   stopped_.store(true, std::memory_order_release);
@@ -157,11 +188,32 @@ template <typename T> Status TaskStreamImpl<T>::Submit(T *task) {
   if (stop_requested_.load(std::memory_order_acquire)) {
     return STATUS(IllegalState, "Tablet is shutting down");
   }
-  if (!queue_.BlockingPut(task)) {
-    return STATUS_FORMAT(ServiceUnavailable,
-                         "TaskStream queue is full (max capacity $0)",
-                         FLAGS_taskstream_queue_max_size);
+  // Reserve a place in the queue, waiting while it is full.
+  for (;;) {
+    auto size = queue_size_.load(std::memory_order_acquire);
+    if (size < FLAGS_taskstream_queue_max_size) {
+      if (queue_size_.compare_exchange_weak(size, size + 1, std::memory_order_acq_rel)) {
+        break;
+      }
+      continue;
+    }
+    auto key = space_available_.PrepareWait();
+    if (stop_requested_.load(std::memory_order_acquire)) {
+      space_available_.CancelWait();
+      return STATUS_FORMAT(ServiceUnavailable,
+                           "TaskStream queue is full (max capacity $0)",
+                           FLAGS_taskstream_queue_max_size);
+    }
+    if (queue_size_.load(std::memory_order_acquire) < FLAGS_taskstream_queue_max_size) {
+      space_available_.CancelWait();
+      continue;
+    }
+    space_available_.Wait(key);
   }
+  auto* node = NodePool().Take();
+  node->item = task;
+  queue_.Push(node);
+  items_available_.Notify();
 
   int expected = 0;
   if (!running_.compare_exchange_strong(expected, 1, std::memory_order_acq_rel)) {
@@ -179,13 +231,47 @@ Status TaskStreamImpl<T>::TEST_SubmitFunc(const std::function<void()>& func) {
   return taskstream_pool_token_->SubmitFunc(func);
 }
 
+template <typename T>
+void TaskStreamImpl<T>::PopAll(std::vector<T*>* group) {
+  const auto old_size = group->size();
+  while (auto* node = queue_.Pop()) {
+    group->push_back(node->item);
+    NodePool().Release(node);
+  }
+  const auto popped = group->size() - old_size;
+  if (popped != 0) {
+    queue_size_.fetch_sub(popped, std::memory_order_acq_rel);
+    space_available_.Notify();
+  }
+}
+
+template <typename T>
+template <class Deadline>
+void TaskStreamImpl<T>::DrainTo(std::vector<T*>* group, const Deadline& deadline) {
+  for (;;) {
+    PopAll(group);
+    if (!group->empty() || stop_requested_.load(std::memory_order_acquire)) {
+      return;
+    }
+    auto key = items_available_.PrepareWait();
+    PopAll(group);
+    if (!group->empty() || stop_requested_.load(std::memory_order_acquire)) {
+      items_available_.CancelWait();
+      return;
+    }
+    if (!items_available_.WaitUntil(key, deadline)) {
+      return;
+    }
+  }
+}
+
 template <typename T> void TaskStreamImpl<T>::Run() {
   VLOG(1) << "Starting taskstream task:" << this;
   for (;;) {
-    MonoTime wait_timeout_deadline = MonoTime::Now() + MonoDelta::FromMilliseconds(
-        FLAGS_taskstream_queue_max_wait_ms);
+    auto wait_timeout_deadline = std::chrono::steady_clock::now() +
+                                 FLAGS_taskstream_queue_max_wait_ms * 1ms;
     std::vector<T *> group;
-    queue_.BlockingDrainTo(&group, wait_timeout_deadline);
+    DrainTo(&group, wait_timeout_deadline);
     if (!group.empty()) {
       for (T* item : group) {
         ProcessItem(item);
@@ -197,7 +283,7 @@ template <typename T> void TaskStreamImpl<T>::Run() {
     // Not processing and queue empty, return from task.
     std::unique_lock<std::mutex> stop_lock(stop_mtx_);
     running_--;
-    if (!queue_.empty()) {
+    if (queue_size_.load(std::memory_order_acquire) != 0) {
       // Got more operations, stay in the loop.
       running_++;
       continue;
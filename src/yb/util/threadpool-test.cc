@@ -30,6 +30,7 @@
 // under the License.
 //
 
+#include <algorithm>
 #include <atomic>
 #include <functional>
 #include <limits>
@@ -301,6 +302,26 @@ TEST_F(TestThreadPool, TestVariableSizeThreadPool) {
   ASSERT_EQ(0, thread_pool->num_threads_);
 }
 
+TEST_F(TestThreadPool, TestQueueLatencyTarget) {
+  gscoped_ptr<ThreadPool> thread_pool;
+  ASSERT_OK(ThreadPoolBuilder("test")
+      .set_min_threads(1).set_max_threads(4)
+      .set_queue_latency_target(MonoDelta::FromMilliseconds(50)).Build(&thread_pool));
+  ASSERT_EQ(1, thread_pool->num_threads_);
+  CountDownLatch latch(1);
+  // The queued tasks have not waited long enough for the pool to grow.
+  ASSERT_OK(thread_pool->Submit(SlowTask::NewSlowTask(&latch)));
+  ASSERT_OK(thread_pool->Submit(SlowTask::NewSlowTask(&latch)));
+  ASSERT_EQ(1, thread_pool->num_threads_);
+  // Now the second task has waited past the target behind the first one.
+  SleepFor(MonoDelta::FromMilliseconds(200));
+  ASSERT_OK(thread_pool->Submit(SlowTask::NewSlowTask(&latch)));
+  ASSERT_EQ(2, thread_pool->num_threads_);
+  latch.CountDown();
+  thread_pool->Wait();
+  thread_pool->Shutdown();
+}
+
 TEST_F(TestThreadPool, TestMaxQueueSize) {
   gscoped_ptr<ThreadPool> thread_pool;
   ASSERT_OK(ThreadPoolBuilder("test")
@@ -466,6 +487,38 @@ TEST_F(TestThreadPool, TestTokenSubmitsProcessedSerially) {
   ASSERT_EQ("abcde", result);
 }
 
+// Tokens of a higher weight get a proportionally larger share of a busy pool, without starving
+// the tokens of a lower weight.
+TEST_F(TestThreadPool, TestTokenWeights) {
+  gscoped_ptr<ThreadPool> thread_pool;
+  ASSERT_OK(ThreadPoolBuilder("test").set_max_threads(1).Build(&thread_pool));
+  auto low = thread_pool->NewToken(ThreadPool::ExecutionMode::CONCURRENT);
+  auto high = thread_pool->NewToken(ThreadPool::ExecutionMode::CONCURRENT, 4);
+
+  // Keep the only worker busy until all the tasks are queued.
+  CountDownLatch started(1);
+  CountDownLatch latch(1);
+  ASSERT_OK(thread_pool->SubmitFunc([&started, &latch]() {
+    started.CountDown();
+    latch.Wait();
+  }));
+  started.Wait();
+
+  const size_t kTasksPerToken = 50;
+  string result;
+  for (size_t i = 0; i != kTasksPerToken; ++i) {
+    ASSERT_OK(low->SubmitFunc([&result]() { result += 'l'; }));
+    ASSERT_OK(high->SubmitFunc([&result]() { result += 'h'; }));
+  }
+  latch.CountDown();
+  thread_pool->Wait();
+
+  ASSERT_EQ(2 * kTasksPerToken, result.size());
+  // Out of every 5 tasks, 4 come from the high weight token while both have tasks queued.
+  const string first = result.substr(0, 25);
+  ASSERT_EQ(20, std::count(first.begin(), first.end(), 'h')) << result;
+}
+
 TEST_P(TestThreadPoolTokenTypes, TestTokenSubmitsProcessedConcurrently) {
   const int kNumTokens = 5;
   gscoped_ptr<ThreadPool> thread_pool;
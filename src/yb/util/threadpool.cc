@@ -100,6 +100,12 @@ ThreadPoolBuilder& ThreadPoolBuilder::set_idle_timeout(const MonoDelta& idle_tim
   return *this;
 }
 
+ThreadPoolBuilder& ThreadPoolBuilder::set_queue_latency_target(
+    const MonoDelta& queue_latency_target) {
+  queue_latency_target_ = queue_latency_target;
+  return *this;
+}
+
 Status ThreadPoolBuilder::Build(gscoped_ptr<ThreadPool>* pool) const {
   pool->reset(new ThreadPool(*this));
   RETURN_NOT_OK((*pool)->Init());
@@ -118,8 +124,10 @@ Status ThreadPoolBuilder::Build(unique_ptr<ThreadPool>* pool) const {
 
 ThreadPoolToken::ThreadPoolToken(ThreadPool* pool,
                                  ThreadPool::ExecutionMode mode,
-                                 ThreadPoolMetrics metrics)
+                                 ThreadPoolMetrics metrics,
+                                 int weight)
     : mode_(mode),
+      weight_(weight),
       pool_(pool),
       metrics_(std::move(metrics)),
       state_(ThreadPoolTokenState::kIdle),
@@ -170,13 +178,7 @@ void ThreadPoolToken::Shutdown() {
       // Plus doing it this way (rather than switching to kQuiescing and waiting
       // for a worker thread to process the queue entry) helps retain state
       // transition symmetry with ThreadPool::Shutdown.
-      for (auto it = pool_->queue_.begin(); it != pool_->queue_.end();) {
-        if (*it == this) {
-          it = pool_->queue_.erase(it);
-        } else {
-          it++;
-        }
-      }
+      pool_->queue_.Remove(this);
 
       if (active_threads_ == 0) {
         Transition(ThreadPoolTokenState::kQuiesced);
@@ -286,6 +288,73 @@ const char* ThreadPoolToken::StateToString(ThreadPoolTokenState s) {
   return "<cannot reach here>";
 }
 
+////////////////////////////////////////////////////////
+// ThreadPool::TokenQueue
+////////////////////////////////////////////////////////
+
+void ThreadPool::TokenQueue::Push(ThreadPoolToken* token) {
+  auto& queue = queues_[token->weight()];
+  if (queue.tokens.empty()) {
+    queue.pass = std::max(queue.pass, pass_);
+  }
+  queue.tokens.push_back(token);
+  ++size_;
+}
+
+ThreadPoolToken* ThreadPool::TokenQueue::Pop() {
+  DCHECK(!empty());
+  auto best = queues_.end();
+  for (auto it = queues_.begin(); it != queues_.end(); ++it) {
+    if (it->second.tokens.empty()) {
+      continue;
+    }
+    if (best == queues_.end() || it->second.pass < best->second.pass) {
+      best = it;
+    }
+  }
+  auto& queue = best->second;
+  ThreadPoolToken* token = queue.tokens.front();
+  queue.tokens.pop_front();
+  pass_ = queue.pass;
+  queue.pass += kStride / std::max(best->first, 1);
+  --size_;
+  return token;
+}
+
+void ThreadPool::TokenQueue::Remove(ThreadPoolToken* token) {
+  auto it = queues_.find(token->weight());
+  if (it == queues_.end()) {
+    return;
+  }
+  auto& tokens = it->second.tokens;
+  auto new_end = std::remove(tokens.begin(), tokens.end(), token);
+  size_ -= tokens.end() - new_end;
+  tokens.erase(new_end, tokens.end());
+}
+
+void ThreadPool::TokenQueue::Clear() {
+  for (auto& weight_and_queue : queues_) {
+    weight_and_queue.second.tokens.clear();
+  }
+  size_ = 0;
+}
+
+MonoTime ThreadPool::TokenQueue::OldestSubmitTime() const {
+  MonoTime result;
+  for (const auto& weight_and_queue : queues_) {
+    const auto& tokens = weight_and_queue.second.tokens;
+    if (tokens.empty()) {
+      continue;
+    }
+    DCHECK(!tokens.front()->entries_.empty());
+    const MonoTime& submit_time = tokens.front()->entries_.front().submit_time;
+    if (!result.Initialized() || submit_time < result) {
+      result = submit_time;
+    }
+  }
+  return result;
+}
+
 ////////////////////////////////////////////////////////
 // ThreadPool
 ////////////////////////////////////////////////////////
@@ -296,6 +365,7 @@ ThreadPool::ThreadPool(const ThreadPoolBuilder& builder)
     max_threads_(builder.max_threads_),
     max_queue_size_(builder.max_queue_size_),
     idle_timeout_(builder.idle_timeout_),
+    queue_latency_target_(builder.queue_latency_target_),
     pool_status_(STATUS(Uninitialized, "The pool was not initialized.")),
     idle_cond_(&lock_),
     no_threads_cond_(&lock_),
@@ -345,7 +415,7 @@ void ThreadPool::Shutdown() {
   // of the tasks outside the lock, in case there are concurrent threads
   // wanting to access the ThreadPool. The task's destructors may acquire
   // locks, etc, so this also prevents lock inversions.
-  queue_.clear();
+  queue_.Clear();
   deque<deque<Task>> to_release;
   for (auto* t : tokens_) {
     if (!t->entries_.empty()) {
@@ -396,14 +466,15 @@ void ThreadPool::Shutdown() {
   }
 }
 
-unique_ptr<ThreadPoolToken> ThreadPool::NewToken(ExecutionMode mode) {
-  return NewTokenWithMetrics(mode, {});
+unique_ptr<ThreadPoolToken> ThreadPool::NewToken(ExecutionMode mode, int weight) {
+  return NewTokenWithMetrics(mode, {}, weight);
 }
 
 unique_ptr<ThreadPoolToken> ThreadPool::NewTokenWithMetrics(
-    ExecutionMode mode, ThreadPoolMetrics metrics) {
+    ExecutionMode mode, ThreadPoolMetrics metrics, int weight) {
+  CHECK_GT(weight, 0);
   MutexLock guard(lock_);
-  unique_ptr<ThreadPoolToken> t(new ThreadPoolToken(this, mode, std::move(metrics)));
+  unique_ptr<ThreadPoolToken> t(new ThreadPoolToken(this, mode, std::move(metrics), weight));
   InsertOrDie(&tokens_, t.get());
   return t;
 }
@@ -470,7 +541,8 @@ Status ThreadPool::DoSubmit(const std::shared_ptr<Runnable> task, ThreadPoolToke
       token->IsActive() && token->mode() == ExecutionMode::SERIAL ? 0 : 1;
   int inactive_threads = num_threads_ - active_threads_;
   int additional_threads = (queue_.size() + threads_from_this_submit) - inactive_threads;
-  if (additional_threads > 0 && num_threads_ < max_threads_) {
+  if (additional_threads > 0 && num_threads_ < max_threads_ &&
+      ShouldAddThreadUnlocked(submit_time)) {
     Status status = CreateThreadUnlocked();
     if (!status.ok()) {
       if (num_threads_ == 0) {
@@ -501,7 +573,7 @@ Status ThreadPool::DoSubmit(const std::shared_ptr<Runnable> task, ThreadPoolToke
   token->entries_.emplace_back(std::move(e));
   if (state == ThreadPoolTokenState::kIdle ||
       token->mode() == ExecutionMode::CONCURRENT) {
-    queue_.emplace_back(token);
+    queue_.Push(token);
     if (state == ThreadPoolTokenState::kIdle) {
       token->Transition(ThreadPoolTokenState::kRunning);
     }
@@ -528,6 +600,13 @@ void ThreadPool::Wait() {
   }
 }
 
+bool ThreadPool::ShouldAddThreadUnlocked(const MonoTime& now) const {
+  if (!queue_latency_target_.Initialized() || num_threads_ == 0) {
+    return true;
+  }
+  return !queue_.empty() && now - queue_.OldestSubmitTime() > queue_latency_target_;
+}
+
 bool ThreadPool::WaitUntil(const MonoTime& until) {
   MonoDelta relative = until.GetDeltaSince(MonoTime::Now());
   return WaitFor(relative);
@@ -574,8 +653,7 @@ void ThreadPool::DispatchThread(bool permanent) {
     }
 
     // Get the next token and task to execute.
-    ThreadPoolToken* token = queue_.front();
-    queue_.pop_front();
+    ThreadPoolToken* token = queue_.Pop();
     DCHECK_EQ(ThreadPoolTokenState::kRunning, token->state());
     DCHECK(!token->entries_.empty());
     Task task = std::move(token->entries_.front());
@@ -584,6 +662,17 @@ void ThreadPool::DispatchThread(bool permanent) {
     --total_queued_tasks_;
     ++active_threads_;
 
+    // When growing by queue latency, the tasks left in the queue could be delayed past the target
+    // with no new submission to notice it, so the workers check it too.
+    if (queue_latency_target_.Initialized() && !queue_.empty() &&
+        num_threads_ == active_threads_ && num_threads_ < max_threads_ &&
+        ShouldAddThreadUnlocked(MonoTime::Now())) {
+      Status status = CreateThreadUnlocked();
+      if (!status.ok()) {
+        LOG(WARNING) << "Thread pool failed to create thread: " << status.ToString();
+      }
+    }
+
     unique_lock.Unlock();
 
     // Release the reference which was held by the queued item.
@@ -638,7 +727,7 @@ void ThreadPool::DispatchThread(bool permanent) {
       } else if (token->entries_.empty()) {
         token->Transition(ThreadPoolTokenState::kIdle);
       } else if (token->mode() == ExecutionMode::SERIAL) {
-        queue_.emplace_back(token);
+        queue_.Push(token);
       }
     }
     if (--active_threads_ == 0) {
@@ -34,6 +34,7 @@
 
 #include <deque>
 #include <functional>
+#include <map>
 #include <memory>
 #include <string>
 #include <unordered_set>
@@ -117,6 +118,13 @@ struct ThreadPoolMetrics {
 // metrics: Histograms, counters, etc. to update on various threadpool events.
 //    Default: not set.
 //
+// queue_latency_target: If set, threads beyond the first one are added only once the oldest
+//    queued task has waited longer than this, instead of as soon as the queue is longer than the
+//    number of idle threads. This is checked when a task is submitted or dequeued. So the pool
+//    grows when its tasks are delayed rather than whenever a burst is queued, and shrinks back
+//    through idle_timeout.
+//    Default: not set.
+//
 class ThreadPoolBuilder {
  public:
   explicit ThreadPoolBuilder(std::string name);
@@ -129,12 +137,14 @@ class ThreadPoolBuilder {
   ThreadPoolBuilder& set_max_queue_size(int max_queue_size);
   ThreadPoolBuilder& set_idle_timeout(const MonoDelta& idle_timeout);
   ThreadPoolBuilder& set_metrics(ThreadPoolMetrics metrics);
+  ThreadPoolBuilder& set_queue_latency_target(const MonoDelta& queue_latency_target);
 
   const std::string& name() const { return name_; }
   int min_threads() const { return min_threads_; }
   int max_threads() const { return max_threads_; }
   int max_queue_size() const { return max_queue_size_; }
   const MonoDelta& idle_timeout() const { return idle_timeout_; }
+  const MonoDelta& queue_latency_target() const { return queue_latency_target_; }
 
   // Instantiate a new ThreadPool with the existing builder arguments.
   CHECKED_STATUS Build(gscoped_ptr<ThreadPool>* pool) const;
@@ -147,6 +157,7 @@ class ThreadPoolBuilder {
   int max_threads_;
   int max_queue_size_;
   MonoDelta idle_timeout_;
+  MonoDelta queue_latency_target_;
   ThreadPoolMetrics metrics_;
 
   DISALLOW_COPY_AND_ASSIGN(ThreadPoolBuilder);
@@ -172,7 +183,13 @@ class ThreadPoolBuilder {
 // processed in FIFO order. On the other hand, ExecutionMode::SERIAL tokens are
 // processed in a round-robin fashion, one task at a time. This prevents them
 // from starving one another. However, tokenless (and CONCURRENT token-based)
-// tasks can starve SERIAL token-based tasks.
+// tasks can starve SERIAL token-based tasks of the same weight.
+//
+// Each token has a weight, kDefaultTokenWeight unless given to NewToken(). The
+// tokens of one weight are queued as described above, and the different weights
+// share the workers in proportion to their weights. So latency critical work
+// could be given a token with a higher weight than the background work that
+// shares its pool, without starving the background work.
 //
 // Usage Example:
 //    static void Func(int n) { ... }
@@ -253,13 +270,19 @@ class ThreadPool {
     // Tasks submitted via this token may be executed concurrently.
     CONCURRENT,
   };
-  std::unique_ptr<ThreadPoolToken> NewToken(ExecutionMode mode);
+  //
+  // 'weight' is the token's share of the workers relative to the tokens of
+  // other weights, see the class comment.
+  static constexpr int kDefaultTokenWeight = 1;
+  std::unique_ptr<ThreadPoolToken> NewToken(ExecutionMode mode, int weight = kDefaultTokenWeight);
 
   // Like NewToken(), but lets the caller provide metrics for the token. These
   // metrics are incremented/decremented in addition to the configured
-  // pool-wide metrics (if any).
+  // pool-wide metrics (if any), so they break the queue and run times of the
+  // pool down by token.
   std::unique_ptr<ThreadPoolToken> NewTokenWithMetrics(ExecutionMode mode,
-                                                       ThreadPoolMetrics metrics);
+                                                       ThreadPoolMetrics metrics,
+                                                       int weight = kDefaultTokenWeight);
 
  private:
   friend class ThreadPoolBuilder;
@@ -282,6 +305,7 @@ class ThreadPool {
   FRIEND_TEST(TestThreadPool, TestThreadPoolWithNoMinimum);
   FRIEND_TEST(TestThreadPool, TestThreadPoolWithNoMaxThreads);
   FRIEND_TEST(TestThreadPool, TestVariableSizeThreadPool);
+  FRIEND_TEST(TestThreadPool, TestQueueLatencyTarget);
   // Aborts if the current thread is a member of this thread pool.
   void CheckNotPoolThreadUnlocked();
 
@@ -298,11 +322,49 @@ class ThreadPool {
   // Releases token 't' and invalidates it.
   void ReleaseToken(ThreadPoolToken* t);
 
+  // Whether a thread should be added for the queued tasks, given that there are already some
+  // threads but not enough idle ones. Required that lock_ is held.
+  bool ShouldAddThreadUnlocked(const MonoTime& now) const;
+
+  // Queue of the tokens from which tasks should be executed, with one FIFO per token weight.
+  // The FIFOs are served by stride scheduling: each FIFO advances its pass by kStride / weight
+  // for every task taken from it, and the FIFO with the lowest pass goes next. A FIFO that was
+  // empty restarts from the current pass, so it cannot save up turns while idle.
+  class TokenQueue {
+   public:
+    void Push(ThreadPoolToken* token);
+    ThreadPoolToken* Pop();
+
+    // Removes all the entries of 'token'.
+    void Remove(ThreadPoolToken* token);
+    void Clear();
+
+    // Submit time of the oldest task at the front of the FIFOs. Requires a non-empty queue.
+    MonoTime OldestSubmitTime() const;
+
+    bool empty() const { return size_ == 0; }
+    size_t size() const { return size_; }
+
+   private:
+    static constexpr uint64_t kStride = 1 << 20;
+
+    struct WeightQueue {
+      std::deque<ThreadPoolToken*> tokens;
+      uint64_t pass = 0;
+    };
+
+    // Keyed by token weight.
+    std::map<int, WeightQueue> queues_;
+    uint64_t pass_ = 0;
+    size_t size_ = 0;
+  };
+
   const std::string name_;
   const int min_threads_;
   const int max_threads_;
   const int max_queue_size_;
   const MonoDelta idle_timeout_;
+  const MonoDelta queue_latency_target_;
 
   Status pool_status_;
   Mutex lock_;
@@ -323,11 +385,11 @@ class ThreadPool {
   // Protected by lock_.
   std::unordered_set<ThreadPoolToken*> tokens_;
 
-  // FIFO of tokens from which tasks should be executed. Does not own the
-  // tokens; they are owned by clients and are removed from the FIFO on shutdown.
+  // Tokens from which tasks should be executed. Does not own the tokens; they
+  // are owned by clients and are removed from the queue on shutdown.
   //
   // Protected by lock_.
-  std::deque<ThreadPoolToken*> queue_;
+  TokenQueue queue_;
 
   // Pointers to all running threads. Raw pointers are safe because a Thread
   // may only go out of scope after being removed from threads_.
@@ -420,7 +482,8 @@ class ThreadPoolToken {
   // Constructs a new token.
   //
   // The token may not outlive its thread pool ('pool').
-  ThreadPoolToken(ThreadPool* pool, ThreadPool::ExecutionMode mode, ThreadPoolMetrics metrics);
+  ThreadPoolToken(ThreadPool* pool, ThreadPool::ExecutionMode mode, ThreadPoolMetrics metrics,
+                  int weight);
 
   // Changes this token's state to 'new_state' taking actions as needed.
   void Transition(ThreadPoolTokenState new_state);
@@ -440,10 +503,14 @@ class ThreadPoolToken {
 
   ThreadPoolTokenState state() const { return state_; }
   ThreadPool::ExecutionMode mode() const { return mode_; }
+  int weight() const { return weight_; }
 
   // Token's configured execution mode.
   const ThreadPool::ExecutionMode mode_;
 
+  // Token's share of the pool relative to the tokens of other weights.
+  const int weight_;
+
   // Pointer to the token's thread pool.
   ThreadPool* pool_;
 
@@ -0,0 +1,59 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <gtest/gtest.h>
+
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+#include "yb/util/token_bucket.h"
+
+namespace yb {
+
+class TokenBucketTest : public YBTest {
+};
+
+TEST_F(TokenBucketTest, Refill) {
+  auto now = CoarseMonoClock::Now();
+  TokenBucket bucket(10, now);
+  // Starts with one second worth of tokens.
+  for (int i = 0; i != 10; ++i) {
+    ASSERT_TRUE(bucket.TryAcquire(1, now));
+  }
+  ASSERT_FALSE(bucket.TryAcquire(1, now));
+
+  now += std::chrono::milliseconds(300);
+  for (int i = 0; i != 3; ++i) {
+    ASSERT_TRUE(bucket.TryAcquire(1, now));
+  }
+  ASSERT_FALSE(bucket.TryAcquire(1, now));
+
+  // Does not accumulate more than one second worth of tokens.
+  now += std::chrono::seconds(10);
+  for (int i = 0; i != 10; ++i) {
+    ASSERT_TRUE(bucket.TryAcquire(1, now));
+  }
+  ASSERT_FALSE(bucket.TryAcquire(1, now));
+}
+
+TEST_F(TokenBucketTest, Debt) {
+  auto now = CoarseMonoClock::Now();
+  TokenBucket bucket(100, now);
+  // A request larger than the burst is let through, the following ones pay for it.
+  ASSERT_TRUE(bucket.TryAcquire(250, now));
+  now += std::chrono::seconds(1);
+  ASSERT_FALSE(bucket.TryAcquire(1, now));
+  now += std::chrono::milliseconds(600);
+  ASSERT_TRUE(bucket.TryAcquire(1, now));
+}
+
+} // namespace yb
@@ -0,0 +1,38 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/util/token_bucket.h"
+
+#include <algorithm>
+
+namespace yb {
+
+TokenBucket::TokenBucket(double tokens_per_sec, CoarseTimePoint now)
+    : tokens_per_sec_(tokens_per_sec), tokens_(tokens_per_sec), last_refill_(now) {
+}
+
+bool TokenBucket::TryAcquire(double tokens, CoarseTimePoint now) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (now > last_refill_) {
+    tokens_ = std::min(
+        tokens_ + MonoDelta(now - last_refill_).ToSeconds() * tokens_per_sec_, tokens_per_sec_);
+    last_refill_ = now;
+  }
+  if (tokens_ <= 0) {
+    return false;
+  }
+  tokens_ -= tokens;
+  return true;
+}
+
+} // namespace yb
@@ -0,0 +1,48 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_UTIL_TOKEN_BUCKET_H
+#define YB_UTIL_TOKEN_BUCKET_H
+
+#include <mutex>
+
+#include "yb/util/monotime.h"
+
+namespace yb {
+
+// Token bucket that is refilled at a fixed rate, up to one second worth of tokens. Unlike
+// RateLimiter it never sleeps: the callers that find it empty are expected to reject their
+// request, so that an over-quota client is pushed back instead of queueing on the server.
+//
+// A request takes its tokens as long as the bucket is not empty, so the bucket could go into debt
+// for a request larger than the burst, which then delays the following requests.
+class TokenBucket {
+ public:
+  explicit TokenBucket(double tokens_per_sec, CoarseTimePoint now = CoarseMonoClock::Now());
+
+  // Takes tokens from the bucket. Returns false, and takes nothing, if the bucket is empty.
+  bool TryAcquire(double tokens, CoarseTimePoint now = CoarseMonoClock::Now());
+
+  double tokens_per_sec() const { return tokens_per_sec_; }
+
+ private:
+  const double tokens_per_sec_;
+
+  std::mutex mutex_;
+  double tokens_;
+  CoarseTimePoint last_refill_;
+};
+
+} // namespace yb
+
+#endif // YB_UTIL_TOKEN_BUCKET_H
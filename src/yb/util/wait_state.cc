@@ -0,0 +1,102 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/util/wait_state.h"
+
+#include <mutex>
+#include <unordered_map>
+
+#include "yb/gutil/port.h"
+#include "yb/util/thread.h"
+
+namespace yb {
+
+namespace {
+
+// Uses std::mutex instead of yb::Mutex, because contended yb::Mutex tags the thread itself.
+class WaitStateRegistry {
+ public:
+  void Register(pid_t tid, std::atomic<WaitState>* slot) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    slots_[tid] = slot;
+  }
+
+  void Unregister(pid_t tid) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    slots_.erase(tid);
+  }
+
+  void ForEach(const std::function<void(pid_t tid, WaitState state)>& callback) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& entry : slots_) {
+      callback(entry.first, entry.second->load(std::memory_order_relaxed));
+    }
+  }
+
+ private:
+  std::mutex mutex_;
+  std::unordered_map<pid_t, std::atomic<WaitState>*> slots_;
+};
+
+WaitStateRegistry& GetRegistry() {
+  // Never destroyed, so threads exiting during shutdown may still unregister.
+  static WaitStateRegistry* registry = new WaitStateRegistry;
+  return *registry;
+}
+
+// Used by the threads whose ThreadWaitState was destroyed, since the destructors of other thread
+// locals may still take locks.
+std::atomic<WaitState> exited_thread_slot{WaitState::kNone};
+
+thread_local std::atomic<WaitState>* thread_slot = nullptr;
+
+class ThreadWaitState {
+ public:
+  ThreadWaitState() : tid_(Thread::CurrentThreadId()) {
+    GetRegistry().Register(tid_, &state_);
+    thread_slot = &state_;
+  }
+
+  ~ThreadWaitState() {
+    thread_slot = &exited_thread_slot;
+    GetRegistry().Unregister(tid_);
+  }
+
+ private:
+  const pid_t tid_;
+  std::atomic<WaitState> state_{WaitState::kNone};
+};
+
+std::atomic<WaitState>* ThreadSlot() {
+  if (PREDICT_FALSE(!thread_slot)) {
+    static thread_local ThreadWaitState thread_wait_state;
+  }
+  return thread_slot;
+}
+
+} // namespace
+
+ScopedWaitState::ScopedWaitState(WaitState state)
+    : slot_(ThreadSlot()), old_state_(slot_->load(std::memory_order_relaxed)) {
+  slot_->store(state, std::memory_order_relaxed);
+}
+
+ScopedWaitState::~ScopedWaitState() {
+  slot_->store(old_state_, std::memory_order_relaxed);
+}
+
+void ForEachThreadWaitState(const std::function<void(pid_t tid, WaitState state)>& callback) {
+  GetRegistry().ForEach(callback);
+}
+
+} // namespace yb
@@ -0,0 +1,51 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_UTIL_WAIT_STATE_H
+#define YB_UTIL_WAIT_STATE_H
+
+#include <sys/types.h>
+
+#include <atomic>
+#include <functional>
+
+#include "yb/gutil/macros.h"
+#include "yb/util/enums.h"
+
+namespace yb {
+
+// What a thread is blocked on, as seen by the continuous profiler.
+YB_DEFINE_ENUM(WaitState, (kNone)(kLock)(kIo)(kRpc)(kRaft));
+
+// Tags the current thread with 'state' for the duration of the current scope. Only stores to a
+// thread local, so it is cheap enough for each contended lock and each I/O.
+class ScopedWaitState {
+ public:
+  explicit ScopedWaitState(WaitState state);
+  ~ScopedWaitState();
+
+ private:
+  std::atomic<WaitState>* const slot_;
+  const WaitState old_state_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScopedWaitState);
+};
+
+// Calls 'callback' with the thread id and the current wait state of each running thread that was
+// ever tagged with a wait state. Threads are registered on their first tag, so the threads not
+// listed are in kNone.
+void ForEachThreadWaitState(const std::function<void(pid_t tid, WaitState state)>& callback);
+
+} // namespace yb
+
+#endif // YB_UTIL_WAIT_STATE_H
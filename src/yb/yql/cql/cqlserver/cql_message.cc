@@ -914,9 +914,11 @@ void CQLResponse::Serialize(const CompressionScheme compression_scheme, faststri
   const size_t start_pos = mesg->size(); // save the start position
   const bool compress = (compression_scheme != CQLMessage::CompressionScheme::NONE);
   SerializeHeader(compress, mesg);
+  const Slice tail = BodyTail();
   if (compress) {
     faststring body;
     SerializeBody(&body);
+    body.append(tail.data(), tail.size());
     switch (compression_scheme) {
       case CQLMessage::CompressionScheme::LZ4: {
         SerializeInt(static_cast<int32_t>(body.size()), mesg);
@@ -947,11 +949,28 @@ void CQLResponse::Serialize(const CompressionScheme compression_scheme, faststri
     }
   } else {
     SerializeBody(mesg);
+    mesg->append(tail.data(), tail.size());
   }
   SERIALIZE_INT(
       mesg->data(), start_pos + kHeaderPosLength, mesg->size() - start_pos - kMessageHeaderLength);
 }
 
+void CQLResponse::Serialize(const CompressionScheme compression_scheme,
+                            boost::container::small_vector_base<RefCntBuffer>* output) const {
+  const Slice tail = BodyTail();
+  faststring mesg;
+  if (compression_scheme != CQLMessage::CompressionScheme::NONE || tail.empty()) {
+    Serialize(compression_scheme, &mesg);
+    output->push_back(RefCntBuffer(mesg));
+    return;
+  }
+  SerializeHeader(false /* compress */, &mesg);
+  SerializeBody(&mesg);
+  SERIALIZE_INT(mesg.data(), kHeaderPosLength, mesg.size() + tail.size() - kMessageHeaderLength);
+  output->push_back(RefCntBuffer(mesg));
+  output->push_back(RefCntBuffer(tail.data(), tail.size()));
+}
+
 void CQLResponse::SerializeHeader(const bool compress, faststring* mesg) const {
   uint8_t buffer[kMessageHeaderLength];
   SERIALIZE_BYTE(buffer, kHeaderPosVersion, version());
@@ -1487,9 +1506,11 @@ RowsResultResponse::RowsResultResponse(
 }
 
 RowsResultResponse::RowsResultResponse(
-    const ExecuteRequest& request, const ql::RowsResult::SharedPtr& result)
+    const ExecuteRequest& request, const ql::RowsResult::SharedPtr& result,
+    RowsMetadataCache* metadata_cache)
     : ResultResponse(request, Kind::ROWS), result_(result),
-      skip_metadata_(request.params().flags & CQLMessage::QueryParameters::kSkipMetadataFlag) {
+      skip_metadata_(request.params().flags & CQLMessage::QueryParameters::kSkipMetadataFlag),
+      metadata_cache_(metadata_cache) {
 }
 
 RowsResultResponse::RowsResultResponse(
@@ -1502,10 +1523,49 @@ RowsResultResponse::~RowsResultResponse() {
 }
 
 void RowsResultResponse::SerializeResultBody(faststring* mesg) const {
-  SerializeRowsMetadata(
-      RowsMetadata(result_->table_name(), result_->column_schemas(),
-                   result_->paging_state(), skip_metadata_), mesg);
-  mesg->append(result_->rows_data());
+  if (skip_metadata_ || metadata_cache_ == nullptr) {
+    SerializeRowsMetadata(
+        RowsMetadata(result_->table_name(), result_->column_schemas(),
+                     result_->paging_state(), skip_metadata_), mesg);
+    return;
+  }
+
+  // Only the flags and the paging state differ between the executions of a prepared statement.
+  const auto col_specs = metadata_cache_->Get(*result_, [this](faststring* out) {
+    const RowsMetadata metadata(result_->table_name(), result_->column_schemas(),
+                                "" /* paging_state */, false /* no_metadata */);
+    SerializeColSpecs(true /* has_global_table_spec */, metadata.global_table_spec,
+                      metadata.col_specs, out);
+  });
+  const string& paging_state = result_->paging_state();
+  SerializeInt(RowsMetadata::kHasGlobalTableSpec |
+               (!paging_state.empty() ? RowsMetadata::kHasMorePages : 0), mesg);
+  SerializeInt(result_->column_schemas().size(), mesg);
+  if (!paging_state.empty()) {
+    SerializeBytes(paging_state, mesg);
+  }
+  mesg->append(col_specs->data(), col_specs->size());
+}
+
+std::shared_ptr<const std::string> RowsMetadataCache::Get(
+    const ql::RowsResult& result, const std::function<void(faststring*)>& serialize) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (column_schemas_ == result.column_schemas_ptr()) {
+      return col_specs_;
+    }
+  }
+  faststring col_specs;
+  serialize(&col_specs);
+  auto serialized = std::make_shared<const std::string>(col_specs.ToString());
+  std::lock_guard<std::mutex> lock(mutex_);
+  column_schemas_ = result.column_schemas_ptr();
+  col_specs_ = serialized;
+  return serialized;
+}
+
+Slice RowsResultResponse::BodyTail() const {
+  return Slice(result_->rows_data());
 }
 
 //----------------------------------------------------------------------------------------
@@ -21,14 +21,19 @@
 #define YB_YQL_CQL_CQLSERVER_CQL_MESSAGE_H_
 
 #include <stdint.h>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <unordered_map>
 
+#include <boost/container/small_vector.hpp>
+
 #include "yb/common/wire_protocol.h"
 #include "yb/rpc/server_event.h"
 #include "yb/yql/cql/ql/util/statement_params.h"
 #include "yb/yql/cql/ql/util/statement_result.h"
+#include "yb/util/ref_cnt_buffer.h"
 #include "yb/util/slice.h"
 #include "yb/util/status.h"
 #include "yb/util/net/sockaddr.h"
@@ -235,6 +240,10 @@ class CQLRequest : public CQLMessage {
     return static_cast<StreamId>(NetworkByteOrder::Load16(mesg.data() + kHeaderPosStreamId));
   }
 
+  static Opcode ParseOpcode(const Slice& mesg) {
+    return static_cast<Opcode>(mesg.data()[kHeaderPosOpcode]);
+  }
+
   virtual ~CQLRequest();
 
  protected:
@@ -465,6 +474,12 @@ class CQLResponse : public CQLMessage {
   virtual ~CQLResponse();
   virtual void Serialize(CompressionScheme compression_scheme, faststring* mesg) const;
 
+  // Serializes the response into buffers to be sent one after another. Unless the response is
+  // compressed, the body tail, e.g. the rows of a ROWS result, gets a buffer of its own so that it
+  // is copied only once instead of being appended to the rest of the message first.
+  void Serialize(CompressionScheme compression_scheme,
+                 boost::container::small_vector_base<RefCntBuffer>* output) const;
+
  protected:
   CQLResponse(const CQLRequest& request, Opcode opcode);
   CQLResponse(StreamId stream_id, Opcode opcode);
@@ -472,6 +487,9 @@ class CQLResponse : public CQLMessage {
 
   // Function to serialize a response body that all CQLResponse subclasses need to implement
   virtual void SerializeBody(faststring* mesg) const = 0;
+
+  // Data that ends the body and is not serialized by SerializeBody().
+  virtual Slice BodyTail() const { return Slice(); }
 };
 
 // ------------------------------ Individual CQL responses -----------------------------------
@@ -720,11 +738,29 @@ class VoidResultResponse : public ResultResponse {
   virtual void SerializeResultBody(faststring* mesg) const override;
 };
 
+//------------------------------------------------------------
+// The column specs of the rows returned by a prepared statement, serialized once and copied into
+// the ROWS responses of its executions. They are serialized again when the statement returns other
+// columns, e.g. after it was reparsed.
+class RowsMetadataCache {
+ public:
+  // Returns the serialized column specs of 'result', calling 'serialize' to produce them unless
+  // they were serialized for the same columns before.
+  std::shared_ptr<const std::string> Get(
+      const ql::RowsResult& result, const std::function<void(faststring*)>& serialize);
+
+ private:
+  std::mutex mutex_;
+  std::shared_ptr<std::vector<ColumnSchema>> column_schemas_;
+  std::shared_ptr<const std::string> col_specs_;
+};
+
 //------------------------------------------------------------
 class RowsResultResponse : public ResultResponse {
  public:
   RowsResultResponse(const QueryRequest& request, const ql::RowsResult::SharedPtr& result);
-  RowsResultResponse(const ExecuteRequest& request, const ql::RowsResult::SharedPtr& result);
+  RowsResultResponse(const ExecuteRequest& request, const ql::RowsResult::SharedPtr& result,
+                     RowsMetadataCache* metadata_cache = nullptr);
   RowsResultResponse(const BatchRequest& request, const ql::RowsResult::SharedPtr& result);
 
   virtual ~RowsResultResponse() override;
@@ -732,9 +768,13 @@ class RowsResultResponse : public ResultResponse {
  protected:
   virtual void SerializeResultBody(faststring* mesg) const override;
 
+  // The rows data, already in the CQL wire format.
+  virtual Slice BodyTail() const override;
+
  private:
   const ql::RowsResult::SharedPtr result_;
   const bool skip_metadata_;
+  RowsMetadataCache* const metadata_cache_ = nullptr;
 };
 
 //------------------------------------------------------------
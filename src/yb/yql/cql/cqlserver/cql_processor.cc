@@ -15,6 +15,8 @@
 
 #include "yb/yql/cql/cqlserver/cql_processor.h"
 
+#include <gflags/gflags.h>
+
 #include "yb/gutil/strings/escaping.h"
 
 #include "yb/rpc/connection.h"
@@ -22,6 +24,7 @@
 #include "yb/rpc/rpc_context.h"
 
 #include "yb/util/crypt.h"
+#include "yb/util/flag_tags.h"
 
 #include "yb/yql/cql/cqlserver/cql_service.h"
 
@@ -51,6 +54,10 @@ METRIC_DEFINE_histogram(
 METRIC_DEFINE_counter(
     server, yb_cqlserver_CQLServerService_ParsingErrors, "Errors encountered when parsing ",
     yb::MetricUnit::kRequests, "Errors encountered when parsing ");
+METRIC_DEFINE_counter(
+    server, yb_cqlserver_CQLServerService_KeyspaceQuotaRejections,
+    "Requests rejected because their keyspace was over its quota", yb::MetricUnit::kRequests,
+    "Requests rejected because their keyspace was over its quota");
 METRIC_DEFINE_histogram(
     server, handler_latency_yb_cqlserver_CQLServerService_Any,
     "yb.cqlserver.CQLServerService.AnyMethod RPC Time", yb::MetricUnit::kMicroseconds,
@@ -71,6 +78,19 @@ METRIC_DEFINE_counter(server, cql_processors_created,
 
 DECLARE_bool(use_cassandra_authentication);
 
+DEFINE_bool(cql_cache_unprepared_statements, false,
+            "Cache the analyzed parse trees of unprepared DML statements along with the prepared "
+            "statements, keyed by keyspace and query text, so that a query text executed again is "
+            "not parsed and analyzed again.");
+TAG_FLAG(cql_cache_unprepared_statements, advanced);
+
+DEFINE_bool(cql_execute_on_reactor, false,
+            "Run EXECUTE requests of prepared statements on the reactor thread that read them, "
+            "and continue CQL calls on the thread that completes their reads and writes, instead "
+            "of handing them over to the CQL service thread pool each time. Requests that could "
+            "block, like the parsing and analysis of a statement, still go to the thread pool.");
+TAG_FLAG(cql_execute_on_reactor, experimental);
+
 namespace yb {
 namespace cqlserver {
 
@@ -98,6 +118,8 @@ using ql::SetKeyspaceResult;
 using ql::SchemaChangeResult;
 using ql::QLProcessor;
 using ql::ParseTree;
+using ql::TreeNode;
+using ql::TreeNodeOpcode;
 using ql::Statement;
 using ql::StatementBatch;
 using ql::StatementExecutedCallback;
@@ -125,6 +147,8 @@ CQLMetrics::CQLMetrics(const scoped_refptr<yb::MetricEntity>& metric_entity)
       METRIC_handler_latency_yb_cqlserver_CQLServerService_Any.Instantiate(metric_entity);
   num_errors_parsing_cql_ =
       METRIC_yb_cqlserver_CQLServerService_ParsingErrors.Instantiate(metric_entity);
+  num_keyspace_quota_rejections_ =
+      METRIC_yb_cqlserver_CQLServerService_KeyspaceQuotaRejections.Instantiate(metric_entity);
   cql_processors_alive_ = METRIC_cql_processors_alive.Instantiate(metric_entity, 0);
   cql_processors_created_ = METRIC_cql_processors_created.Instantiate(metric_entity);
 }
@@ -182,11 +206,7 @@ void CQLProcessor::SendResponse(const CQLResponse& response) {
   // Serialize the response to return to the CQL client. In case of error, an error response
   // should still be present.
   MonoTime response_begin = MonoTime::Now();
-  const auto& context = static_cast<const CQLConnectionContext&>(call_->connection()->context());
-  const auto compression_scheme = context.compression_scheme();
-  faststring msg;
-  response.Serialize(compression_scheme, &msg);
-  call_->RespondSuccess(RefCntBuffer(msg), cql_metrics_->rpc_method_metrics_);
+  call_->RespondSuccess(response, cql_metrics_->rpc_method_metrics_);
 
   MonoTime response_done = MonoTime::Now();
   cql_metrics_->time_to_process_request_->Increment(
@@ -202,6 +222,8 @@ void CQLProcessor::SendResponse(const CQLResponse& response) {
   call_ = nullptr;
   request_ = nullptr;
   stmts_.clear();
+  executed_stmt_ = nullptr;
+  cached_query_stmts_.clear();
   parse_trees_.clear();
   SetCurrentSession(nullptr);
   service_impl_->ReturnProcessor(pos_);
@@ -304,45 +326,128 @@ CQLResponse* CQLProcessor::ProcessRequest(const ExecuteRequest& req) {
   if (stmt == nullptr) {
     return ProcessError(ErrorStatus(ErrorCode::UNPREPARED_STATEMENT), req.query_id());
   }
+  CQLResponse* overloaded = CheckKeyspaceQuota(req, stmt->keyspace());
+  if (overloaded != nullptr) {
+    return overloaded;
+  }
+  executed_stmt_ = stmt;
   const Status s = stmt->ExecuteAsync(this, req.params(), statement_executed_cb_);
   return s.ok() ? nullptr : ProcessError(s, stmt->query_id());
 }
 
 CQLResponse* CQLProcessor::ProcessRequest(const QueryRequest& req) {
   VLOG(1) << "QUERY " << req.query();
+  CQLResponse* overloaded = CheckKeyspaceQuota(req, ql_env_.CurrentKeyspace());
+  if (overloaded != nullptr) {
+    return overloaded;
+  }
+  if (FLAGS_cql_cache_unprepared_statements) {
+    return ProcessCachedQuery(req);
+  }
   RunAsync(req.query(), req.params(), statement_executed_cb_);
   return nullptr;
 }
 
+namespace {
+
+// Only DML statements are kept in the statement cache. Other statements, e.g. USE or DDL, are rare
+// and change the state that the analysis of later statements depends on.
+bool IsCacheableQuery(const ParseTree& parse_tree) {
+  const TreeNode* root = parse_tree.root().get();
+  if (root == nullptr) {
+    return false;
+  }
+  switch (root->opcode()) {
+    case TreeNodeOpcode::kPTSelectStmt: FALLTHROUGH_INTENDED;
+    case TreeNodeOpcode::kPTInsertStmt: FALLTHROUGH_INTENDED;
+    case TreeNodeOpcode::kPTUpdateStmt: FALLTHROUGH_INTENDED;
+    case TreeNodeOpcode::kPTDeleteStmt:
+      return true;
+    default:
+      return false;
+  }
+}
+
+} // namespace
+
+CQLResponse* CQLProcessor::ProcessCachedQuery(const QueryRequest& req) {
+  // Look up the query text as if it was prepared in the current keyspace, and prepare it if it is
+  // not cached yet. The statement is not added to stmts_ because the client did not prepare it and
+  // should not be asked to. If it turns out to be stale, the lookup in the retry deletes it.
+  const CQLMessage::QueryId query_id =
+      CQLStatement::GetQueryId(ql_env_.CurrentKeyspace(), req.query());
+  shared_ptr<const CQLStatement> stmt = service_impl_->GetPreparedStatement(query_id);
+  if (stmt == nullptr) {
+    shared_ptr<CQLStatement> new_stmt = service_impl_->AllocatePreparedStatement(
+        query_id, ql_env_.CurrentKeyspace(), req.query());
+    const Status s = new_stmt->Prepare(this, service_impl_->prepared_stmts_mem_tracker());
+    if (!s.ok()) {
+      service_impl_->DeletePreparedStatement(new_stmt);
+      return ProcessError(s);
+    }
+    stmt = std::move(new_stmt);
+  }
+  stmt->clear_reparsed();
+
+  const Result<const ParseTree&> parse_tree = stmt->GetParseTree();
+  if (!parse_tree) {
+    return ProcessError(parse_tree.status());
+  }
+  if (!IsCacheableQuery(*parse_tree)) {
+    service_impl_->DeletePreparedStatement(stmt);
+  }
+  cached_query_stmts_.insert(stmt);
+  ExecuteAsync(*parse_tree, req.params(), statement_executed_cb_);
+  return nullptr;
+}
+
 CQLResponse* CQLProcessor::ProcessRequest(const BatchRequest& req) {
   VLOG(1) << "BATCH " << req.queries().size();
+  CQLResponse* overloaded = CheckKeyspaceQuota(req, ql_env_.CurrentKeyspace());
+  if (overloaded != nullptr) {
+    return overloaded;
+  }
 
   StatementBatch batch;
   batch.reserve(req.queries().size());
 
+  // Parse trees of the prepared statements and of the queries seen so far in this batch. A batch
+  // usually repeats a few statements with different parameters, so each distinct statement is
+  // looked up or prepared only once.
+  std::unordered_map<std::string, const ParseTree*> prepared_parse_trees;
+  std::unordered_map<std::string, const ParseTree*> query_parse_trees;
+
   // For each query in the batch, look up the query id if it is a prepared statement, or prepare the
   // query if it is not prepared. Then execute the parse trees with the parameters.
   for (const BatchRequest::Query& query : req.queries()) {
     if (query.is_prepared) {
       VLOG(1) << "BATCH EXECUTE " << b2a_hex(query.query_id);
-      const shared_ptr<const CQLStatement> stmt = GetPreparedStatement(query.query_id);
-      if (stmt == nullptr) {
-        return ProcessError(ErrorStatus(ErrorCode::UNPREPARED_STATEMENT), query.query_id);
-      }
-      const Result<const ParseTree&> parse_tree = stmt->GetParseTree();
-      if (!parse_tree) {
-        return ProcessError(parse_tree.status(), query.query_id);
+      auto it = prepared_parse_trees.find(query.query_id);
+      if (it == prepared_parse_trees.end()) {
+        const shared_ptr<const CQLStatement> stmt = GetPreparedStatement(query.query_id);
+        if (stmt == nullptr) {
+          return ProcessError(ErrorStatus(ErrorCode::UNPREPARED_STATEMENT), query.query_id);
+        }
+        const Result<const ParseTree&> parse_tree = stmt->GetParseTree();
+        if (!parse_tree) {
+          return ProcessError(parse_tree.status(), query.query_id);
+        }
+        it = prepared_parse_trees.emplace(query.query_id, &*parse_tree).first;
       }
-      batch.emplace_back(*parse_tree, query.params);
+      batch.emplace_back(*it->second, query.params);
     } else {
       VLOG(1) << "BATCH QUERY " << query.query;
-      ParseTree::UniPtr parse_tree;
-      const Status s = Prepare(query.query, &parse_tree);
-      if (PREDICT_FALSE(!s.ok())) {
-        return ProcessError(s);
+      auto it = query_parse_trees.find(query.query);
+      if (it == query_parse_trees.end()) {
+        ParseTree::UniPtr parse_tree;
+        const Status s = Prepare(query.query, &parse_tree);
+        if (PREDICT_FALSE(!s.ok())) {
+          return ProcessError(s);
+        }
+        it = query_parse_trees.emplace(query.query, parse_tree.get()).first;
+        parse_trees_.insert(std::move(parse_tree));
       }
-      batch.emplace_back(*parse_tree, query.params);
-      parse_trees_.insert(std::move(parse_tree));
+      batch.emplace_back(*it->second, query.params);
     }
   }
 
@@ -388,6 +493,15 @@ void CQLProcessor::StatementExecuted(const Status& s, const ExecutedResult::Shar
   }
 }
 
+CQLResponse* CQLProcessor::CheckKeyspaceQuota(const CQLRequest& req, const std::string& keyspace) {
+  if (service_impl_->ChargeKeyspaceQuota(keyspace, call_->serialized_request().size())) {
+    return nullptr;
+  }
+  cql_metrics_->num_keyspace_quota_rejections_->Increment();
+  return new ErrorResponse(req, ErrorResponse::Code::OVERLOADED,
+                           Substitute("Keyspace $0 is over its quota", keyspace));
+}
+
 CQLResponse* CQLProcessor::ProcessError(const Status& s,
                                         boost::optional<CQLMessage::QueryId> query_id) {
   if (s.IsQLError()) {
@@ -414,6 +528,7 @@ CQLResponse* CQLProcessor::ProcessError(const Status& s,
       // thread. Also, rescheduling gives other calls a chance to execute first before we do.
       if (++retry_count_ == 1) {
         stmts_.clear();
+        cached_query_stmts_.clear();
         parse_trees_.clear();
         Reschedule(&process_request_task_.Bind(this));
         return nullptr;
@@ -460,7 +575,9 @@ CQLResponse* CQLProcessor::ProcessResult(const ExecutedResult::SharedPtr& result
       }
       switch (request_->opcode()) {
         case CQLMessage::Opcode::EXECUTE:
-          return new RowsResultResponse(down_cast<const ExecuteRequest&>(*request_), rows_result);
+          return new RowsResultResponse(
+              down_cast<const ExecuteRequest&>(*request_), rows_result,
+              executed_stmt_ ? executed_stmt_->rows_metadata_cache() : nullptr);
         case CQLMessage::Opcode::QUERY:
           return new RowsResultResponse(down_cast<const QueryRequest&>(*request_), rows_result);
         case CQLMessage::Opcode::BATCH:
@@ -525,6 +642,11 @@ CQLResponse* CQLProcessor::ProcessResult(const ExecutedResult::SharedPtr& result
 }
 
 bool CQLProcessor::NeedReschedule() {
+  // The continuation of an executed statement does not block, so it could just as well stay on
+  // the reactor thread that delivered the response.
+  if (FLAGS_cql_execute_on_reactor) {
+    return false;
+  }
   auto messenger = service_impl_->messenger().lock();
   if (!messenger) {
     return false;
@@ -45,6 +45,7 @@ class CQLMetrics : public ql::QLMetrics {
 
   scoped_refptr<yb::Histogram> time_to_queue_cql_response_;
   scoped_refptr<yb::Counter> num_errors_parsing_cql_;
+  scoped_refptr<yb::Counter> num_keyspace_quota_rejections_;
   // Rpc level metrics
   yb::rpc::RpcMethodMetrics rpc_method_metrics_;
 
@@ -85,12 +86,20 @@ class CQLProcessor : public ql::QLProcessor {
   CQLResponse* ProcessRequest(const AuthResponseRequest& req);
   CQLResponse* ProcessRequest(const RegisterRequest& req);
 
+  // Execute an unprepared query using the statement cache, with
+  // --cql_cache_unprepared_statements.
+  CQLResponse* ProcessCachedQuery(const QueryRequest& req);
+
   // Get a prepared statement and adds it to the set of statements currently being executed.
   std::shared_ptr<const CQLStatement> GetPreparedStatement(const CQLMessage::QueryId& id);
 
   // Statement executed callback.
   void StatementExecuted(const Status& s, const ql::ExecutedResult::SharedPtr& result = nullptr);
 
+  // Charge the request to the quota of the keyspace. Returns an OVERLOADED error response if the
+  // keyspace is over its quota, nullptr otherwise.
+  CQLResponse* CheckKeyspaceQuota(const CQLRequest& req, const std::string& keyspace);
+
   // Process statement execution result and error.
   CQLResponse* ProcessResult(const ql::ExecutedResult::SharedPtr& result);
   CQLResponse* ProcessError(const Status& s,
@@ -110,10 +119,14 @@ class CQLProcessor : public ql::QLProcessor {
 
   //----------------------------- StatementExecuted callback and state ---------------------------
 
-  // Current call, request, prepared statements and parse trees being processed.
+  // Current call, request, prepared statements, cached statements of unprepared queries and parse
+  // trees being processed.
   CQLInboundCallPtr call_;
   std::shared_ptr<const CQLRequest> request_;
   std::unordered_set<std::shared_ptr<const CQLStatement>> stmts_;
+  // The prepared statement being executed by an EXECUTE request.
+  std::shared_ptr<const CQLStatement> executed_stmt_;
+  std::unordered_set<std::shared_ptr<const CQLStatement>> cached_query_stmts_;
   std::unordered_set<ql::ParseTree::UniPtr> parse_trees_;
 
   // Current retry count.
@@ -40,6 +40,7 @@ DEFINE_int32(rpcz_max_cql_batch_dump_count, 4_KB,
              "The maximum number of CQL batch elements in the RPCZ dump.");
 
 DECLARE_int32(rpc_max_message_size);
+DECLARE_bool(cql_execute_on_reactor);
 
 // Max msg length for CQL.
 // Since yb_rpc limit is 255MB, we limit consensensus size to 254MB,
@@ -92,7 +93,14 @@ Status CQLConnectionContext::HandleCall(
     return s;
   }
 
-  reactor->messenger()->QueueInboundCall(call);
+  // A prepared statement is executed without parsing or analysis, so it does not block and can run
+  // on this reactor thread instead of waiting for a service thread.
+  if (FLAGS_cql_execute_on_reactor &&
+      CQLRequest::ParseOpcode(call->serialized_request()) == CQLMessage::Opcode::EXECUTE) {
+    reactor->messenger()->Handle(call);
+  } else {
+    reactor->messenger()->QueueInboundCall(call);
+  }
 
   return Status::OK();
 }
@@ -131,6 +139,9 @@ Status CQLInboundCall::ParseFrom(const MemTrackerPtr& call_tracker, std::vector<
   // tracing only. Inside CQLServiceImpl::Handle, we rely on the opcode to dispatch the execution.
   stream_id_ = cqlserver::CQLRequest::ParseStreamId(serialized_request_);
 
+  // CQL requests are where traces start.
+  trace_context_ = TraceContext::SampleNew();
+
   return Status::OK();
 }
 
@@ -146,9 +157,9 @@ const std::string& CQLInboundCall::method_name() const {
 
 void CQLInboundCall::Serialize(boost::container::small_vector_base<RefCntBuffer>* output) const {
   TRACE_EVENT0("rpc", "CQLInboundCall::Serialize");
-  CHECK_GT(response_msg_buf_.size(), 0);
+  CHECK(!response_msg_bufs_.empty());
 
-  output->push_back(response_msg_buf_);
+  output->insert(output->end(), response_msg_bufs_.begin(), response_msg_bufs_.end());
 }
 
 void CQLInboundCall::RespondFailure(rpc::ErrorStatusPB::RpcErrorCodePB error_code,
@@ -179,15 +190,17 @@ void CQLInboundCall::RespondFailure(rpc::ErrorStatusPB::RpcErrorCodePB error_cod
       break;
     }
   }
-  response_msg_buf_ = RefCntBuffer(msg);
+  response_msg_bufs_.assign(1, RefCntBuffer(msg));
 
   QueueResponse(/* is_success */ false);
 }
 
-void CQLInboundCall::RespondSuccess(const RefCntBuffer& buffer,
+void CQLInboundCall::RespondSuccess(const CQLResponse& response,
                                     const yb::rpc::RpcMethodMetrics& metrics) {
+  const auto& context = static_cast<const CQLConnectionContext&>(connection()->context());
+  response_msg_bufs_.clear();
+  response.Serialize(context.compression_scheme(), &response_msg_bufs_);
   RecordHandlingCompleted(metrics.handler_latency);
-  response_msg_buf_ = buffer;
 
   QueueResponse(/* is_success */ true);
 }
@@ -97,11 +97,6 @@ class CQLInboundCall : public rpc::InboundCall {
 
   CoarseTimePoint GetClientDeadline() const override;
 
-  // Return the response message buffer.
-  RefCntBuffer& response_msg_buf() {
-    return response_msg_buf_;
-  }
-
   // Return the SQL session of this CQL call.
   const ql::QLSession::SharedPtr& ql_session() const {
     return ql_session_;
@@ -112,7 +107,7 @@ class CQLInboundCall : public rpc::InboundCall {
   const std::string& service_name() const override;
   const std::string& method_name() const override;
   void RespondFailure(rpc::ErrorStatusPB::RpcErrorCodePB error_code, const Status& status) override;
-  void RespondSuccess(const RefCntBuffer& buffer, const yb::rpc::RpcMethodMetrics& metrics);
+  void RespondSuccess(const CQLResponse& response, const yb::rpc::RpcMethodMetrics& metrics);
   void GetCallDetails(rpc::RpcCallInProgressPB *call_in_progress_pb) const;
   void SetRequest(std::shared_ptr<const CQLRequest> request, CQLServiceImpl* service_impl) {
     service_impl_ = service_impl;
@@ -124,7 +119,7 @@ class CQLInboundCall : public rpc::InboundCall {
   }
 
  private:
-  RefCntBuffer response_msg_buf_;
+  boost::container::small_vector<RefCntBuffer, 2> response_msg_bufs_;
   const ql::QLSession::SharedPtr ql_session_;
   uint16_t stream_id_;
   std::shared_ptr<const CQLRequest> request_;
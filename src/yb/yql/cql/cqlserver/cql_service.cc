@@ -16,7 +16,11 @@
 #include <mutex>
 #include <thread>
 
+#include <boost/thread/shared_mutex.hpp>
+
 #include "yb/gutil/strings/join.h"
+#include "yb/gutil/strings/numbers.h"
+#include "yb/gutil/strings/split.h"
 
 #include "yb/yql/cql/cqlserver/cql_processor.h"
 #include "yb/yql/cql/cqlserver/cql_rpc.h"
@@ -27,6 +31,7 @@
 #include "yb/tserver/tablet_server.h"
 
 #include "yb/util/bytes_formatter.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/mem_tracker.h"
 
 using namespace std::placeholders;
@@ -39,6 +44,12 @@ DEFINE_int64(cql_service_max_prepared_statement_size_bytes, 0,
 DEFINE_int32(cql_ybclient_reactor_threads, 24,
              "The number of reactor threads to be used for processing ybclient "
              "requests originating in the cql layer");
+DEFINE_string(cql_keyspace_quotas, "",
+              "Comma-separated throughput quotas of keyspaces, each as "
+              "<keyspace>:<ops per sec>[:<bytes per sec>], with 0 for no limit. Requests of a "
+              "keyspace over its quota are rejected as overloaded, so that the clients retry "
+              "later. Quotas apply to each CQL proxy separately.");
+TAG_FLAG(cql_keyspace_quotas, advanced);
 
 namespace yb {
 namespace cqlserver {
@@ -78,6 +89,25 @@ CQLServiceImpl::CQLServiceImpl(CQLServer* server, const CQLServerOptions& opts,
       FLAGS_cql_service_max_prepared_statement_size_bytes : -1,
       "CQL prepared statements", server->mem_tracker());
 
+  for (const auto& entry : strings::Split(FLAGS_cql_keyspace_quotas, ",", strings::SkipEmpty())) {
+    const vector<string> fields = strings::Split(entry, ":");
+    double ops_per_sec = 0;
+    double bytes_per_sec = 0;
+    CHECK((fields.size() == 2 || fields.size() == 3) && !fields[0].empty() &&
+          safe_strtod(fields[1], &ops_per_sec) && ops_per_sec >= 0 &&
+          (fields.size() == 2 || (safe_strtod(fields[2], &bytes_per_sec) && bytes_per_sec >= 0)))
+        << "Invalid keyspace quota: " << entry;
+    auto& quota = keyspace_quotas_[fields[0]];
+    if (ops_per_sec > 0) {
+      quota.ops = std::make_unique<TokenBucket>(ops_per_sec);
+    }
+    if (bytes_per_sec > 0) {
+      quota.bytes = std::make_unique<TokenBucket>(bytes_per_sec);
+    }
+    LOG(INFO) << "Keyspace " << fields[0] << " quota: " << ops_per_sec << " ops/sec, "
+              << bytes_per_sec << " bytes/sec";
+  }
+
   auth_prepared_stmt_ = std::make_shared<ql::Statement>(
       "",
       Substitute("SELECT $0, $1 FROM system_auth.roles WHERE role = ?",
@@ -104,6 +134,19 @@ const std::shared_ptr<client::YBClient>& CQLServiceImpl::client() const {
   return client;
 }
 
+bool CQLServiceImpl::ChargeKeyspaceQuota(const std::string& keyspace, size_t request_size) {
+  if (keyspace_quotas_.empty()) {
+    return true;
+  }
+  auto it = keyspace_quotas_.find(keyspace);
+  if (it == keyspace_quotas_.end()) {
+    return true;
+  }
+  // The bytes are only charged for the requests within the ops quota.
+  return (!it->second.ops || it->second.ops->TryAcquire(1)) &&
+         (!it->second.bytes || it->second.bytes->TryAcquire(request_size));
+}
+
 const std::shared_ptr<client::YBMetaDataCache>& CQLServiceImpl::metadata_cache() const {
   // Call client to wait for client and initialize metadata_cache if not already done.
   (void)client();
@@ -160,7 +203,7 @@ void CQLServiceImpl::ReturnProcessor(const CQLProcessorListPos& pos) {
 shared_ptr<CQLStatement> CQLServiceImpl::AllocatePreparedStatement(
     const CQLMessage::QueryId& query_id, const string& keyspace, const string& query) {
   // Get exclusive lock before allocating a prepared statement and updating the LRU list.
-  std::lock_guard<std::mutex> guard(prepared_stmts_mutex_);
+  std::lock_guard<rw_spinlock> guard(prepared_stmts_mutex_);
 
   shared_ptr<CQLStatement> stmt;
   const auto itr = prepared_stmts_map_.find(query_id);
@@ -175,7 +218,7 @@ shared_ptr<CQLStatement> CQLServiceImpl::AllocatePreparedStatement(
   } else {
     // Return existing statement if found.
     stmt = itr->second;
-    MoveLruPreparedStatementUnlocked(stmt);
+    stmt->mark_used();
   }
 
   VLOG(1) << "InsertPreparedStatement: CQL prepared statement cache count = "
@@ -187,33 +230,35 @@ shared_ptr<CQLStatement> CQLServiceImpl::AllocatePreparedStatement(
 
 shared_ptr<const CQLStatement> CQLServiceImpl::GetPreparedStatement(
     const CQLMessage::QueryId& query_id) {
-  // Get exclusive lock before looking up a prepared statement and updating the LRU list.
-  std::lock_guard<std::mutex> guard(prepared_stmts_mutex_);
+  shared_ptr<CQLStatement> stmt;
+  {
+    // A lookup only marks the statement as used, so a shared lock is enough.
+    boost::shared_lock<rw_spinlock> guard(prepared_stmts_mutex_);
 
-  const auto itr = prepared_stmts_map_.find(query_id);
-  if (itr == prepared_stmts_map_.end()) {
-    return nullptr;
+    const auto itr = prepared_stmts_map_.find(query_id);
+    if (itr == prepared_stmts_map_.end()) {
+      return nullptr;
+    }
+    stmt = itr->second;
   }
 
-  shared_ptr<CQLStatement> stmt = itr->second;
-
   // If the statement has not finished preparing, do not return it.
   if (stmt->unprepared()) {
     return nullptr;
   }
   // If the statement is stale, delete it.
   if (stmt->stale()) {
-    DeletePreparedStatementUnlocked(stmt);
+    DeletePreparedStatement(stmt);
     return nullptr;
   }
 
-  MoveLruPreparedStatementUnlocked(stmt);
+  stmt->mark_used();
   return stmt;
 }
 
 void CQLServiceImpl::DeletePreparedStatement(const shared_ptr<const CQLStatement>& stmt) {
   // Get exclusive lock before deleting the prepared statement.
-  std::lock_guard<std::mutex> guard(prepared_stmts_mutex_);
+  std::lock_guard<rw_spinlock> guard(prepared_stmts_mutex_);
 
   DeletePreparedStatementUnlocked(stmt);
 
@@ -252,8 +297,15 @@ void CQLServiceImpl::DeletePreparedStatementUnlocked(
 void CQLServiceImpl::CollectGarbage(size_t required) {
   // Get exclusive lock before deleting the least recently used statement at the end of the LRU
   // list from the cache.
-  std::lock_guard<std::mutex> guard(prepared_stmts_mutex_);
-
+  std::lock_guard<rw_spinlock> guard(prepared_stmts_mutex_);
+
+  // Statements used since they were last moved get another round at the front of the list, so
+  // the one deleted is the first at the end that was not used. Each statement is moved at most
+  // once, which bounds the loop by the size of the list.
+  for (size_t i = prepared_stmts_list_.size(); i > 1 && prepared_stmts_list_.back()->clear_used();
+       --i) {
+    MoveLruPreparedStatementUnlocked(prepared_stmts_list_.back());
+  }
   if (!prepared_stmts_list_.empty()) {
     DeletePreparedStatementUnlocked(prepared_stmts_list_.back());
   }
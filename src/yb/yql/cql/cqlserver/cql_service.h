@@ -17,6 +17,7 @@
 #ifndef YB_YQL_CQL_CQLSERVER_CQL_SERVICE_H_
 #define YB_YQL_CQL_CQLSERVER_CQL_SERVICE_H_
 
+#include <unordered_map>
 #include <vector>
 
 #include "yb/yql/cql/cqlserver/cql_message.h"
@@ -26,7 +27,9 @@
 #include "yb/yql/cql/cqlserver/cql_server_options.h"
 #include "yb/yql/cql/ql/statement.h"
 
+#include "yb/util/locks.h"
 #include "yb/util/string_case.h"
+#include "yb/util/token_bucket.h"
 
 #include "yb/client/async_initializer.h"
 
@@ -77,6 +80,10 @@ class CQLServiceImpl : public CQLServerServiceIf,
   // Delete the prepared statement from the cache.
   void DeletePreparedStatement(const std::shared_ptr<const CQLStatement>& stmt);
 
+  // Charge a request of request_size bytes to the quota of the keyspace. Returns false if the
+  // keyspace is over its quota, in which case the request should be rejected as overloaded.
+  bool ChargeKeyspaceQuota(const std::string& keyspace, size_t request_size);
+
   // Return the memory tracker for prepared statements.
   const MemTrackerPtr& prepared_stmts_mem_tracker() const {
     return prepared_stmts_mem_tracker_;
@@ -109,7 +116,7 @@ class CQLServiceImpl : public CQLServerServiceIf,
   void InsertLruPreparedStatementUnlocked(const std::shared_ptr<CQLStatement>& stmt);
 
   // Move a prepared statement to the front of the LRU list. "prepared_stmts_mutex_" needs to be
-  // locked before this call.
+  // locked exclusively before this call.
   void MoveLruPreparedStatementUnlocked(const std::shared_ptr<CQLStatement>& stmt);
 
   // Delete a prepared statement from the cache and the LRU list. "prepared_stmts_mutex_" needs to
@@ -119,6 +126,12 @@ class CQLServiceImpl : public CQLServerServiceIf,
   // Delete the least recently used prepared statement from the cache to free up memory.
   void CollectGarbage(size_t required) override;
 
+  // Throughput quota of a keyspace. A null bucket means no limit.
+  struct KeyspaceQuota {
+    std::unique_ptr<TokenBucket> ops;
+    std::unique_ptr<TokenBucket> bytes;
+  };
+
   // CQLServer of this service.
   CQLServer* const server_;
 
@@ -146,11 +159,15 @@ class CQLServiceImpl : public CQLServerServiceIf,
   // Prepared statements LRU list (least recently used one at the end).
   CQLStatementList prepared_stmts_list_;
 
-  // Mutex that protects the prepared statements and the LRU list.
-  std::mutex prepared_stmts_mutex_;
+  // Lock that protects the prepared statements and the LRU list. Executing a prepared statement
+  // only looks it up, under a shared lock.
+  rw_spinlock prepared_stmts_mutex_;
 
   std::shared_ptr<ql::Statement> auth_prepared_stmt_;
 
+  // Quotas of the keyspaces in --cql_keyspace_quotas. Not modified after construction.
+  std::unordered_map<std::string, KeyspaceQuota> keyspace_quotas_;
+
   // Tracker to measure and limit memory usage of prepared statements.
   MemTrackerPtr prepared_stmts_mem_tracker_;
 
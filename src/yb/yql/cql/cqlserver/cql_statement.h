@@ -19,6 +19,7 @@
 #ifndef YB_YQL_CQL_CQLSERVER_CQL_STATEMENT_H_
 #define YB_YQL_CQL_CQLSERVER_CQL_STATEMENT_H_
 
+#include <atomic>
 #include <list>
 
 #include "yb/yql/cql/cqlserver/cql_message.h"
@@ -51,12 +52,26 @@ class CQLStatement : public ql::Statement {
   CQLStatementListPos pos() const { return pos_; }
   void set_pos(CQLStatementListPos pos) const { pos_ = pos; }
 
+  // Mark the statement as used since it was last moved in the LRU. Lookups only set this flag, so
+  // they do not need exclusive access to the LRU list. The statement is moved to the front when
+  // it reaches the end of the list with the flag set.
+  void mark_used() const { used_.store(true, std::memory_order_relaxed); }
+  bool clear_used() const { return used_.exchange(false, std::memory_order_relaxed); }
+
   // Return the query id of a statement.
   static CQLMessage::QueryId GetQueryId(const std::string& keyspace, const std::string& query);
 
+  // The serialized metadata of the rows the statement returns.
+  RowsMetadataCache* rows_metadata_cache() const { return &rows_metadata_cache_; }
+
  private:
   // Position of the statement in the LRU.
   mutable CQLStatementListPos pos_;
+
+  // Whether the statement was used since it was last moved in the LRU.
+  mutable std::atomic<bool> used_{false};
+
+  mutable RowsMetadataCache rows_metadata_cache_;
 };
 
 }  // namespace cqlserver
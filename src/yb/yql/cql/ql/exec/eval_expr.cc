@@ -118,6 +118,10 @@ CHECKED_STATUS Executor::PTExprToPB(const PTSubscriptedColumn *ref_pt, QLExpress
 CHECKED_STATUS Executor::PTExprToPB(const PTJsonColumnWithOperators *ref_pt,
                                     QLExpressionPB *expr_pb) {
   const ColumnDesc *col_desc = ref_pt->desc();
+  if (ref_pt->is_index_column()) {
+    expr_pb->set_column_id(col_desc->id());
+    return Status::OK();
+  }
   auto col_pb = expr_pb->mutable_json_column();
   col_pb->set_column_id(col_desc->id());
   for (auto& arg : ref_pt->operators()->node_list()) {
@@ -75,8 +75,14 @@ CHECKED_STATUS Executor::ColumnOpsToSchema(const PTColumnDefinition *col,
       break;
 
       case InternalType::kVarintValue: {
+        // Encoded like the array indexes of json operators in requests, so the path can be applied
+        // when maintaining an index on it.
         const PTConstVarInt* const num = dynamic_cast<const PTConstVarInt*>(arg.get());
-        col_spec->JsonOp(json_op_pb, num->value()->c_str());
+        util::VarInt varint;
+        RETURN_NOT_OK(varint.FromString(num->value()->c_str()));
+        QLValuePB operand;
+        operand.set_varint_value(varint.EncodeToComparable());
+        col_spec->JsonOp(json_op_pb, operand);
       }
       break;
 
@@ -16,6 +16,8 @@
 #include "yb/yql/cql/ql/exec/exec_context.h"
 #include "yb/yql/cql/ql/ptree/pt_select.h"
 #include "yb/client/callbacks.h"
+#include "yb/client/client.h"
+#include "yb/client/transaction.h"
 #include "yb/client/yb_op.h"
 #include "yb/util/trace.h"
 
@@ -82,6 +84,28 @@ Status ExecContext::ApplyChildTransactionResult(const ChildTransactionResultPB&
   return DCHECK_NOTNULL(transaction_.get())->ApplyChildResult(result);
 }
 
+void ExecContext::PrepareTransactionalFlush() {
+  DCHECK(transaction_);
+  for (const auto& tnode_context : tnode_contexts_) {
+    const TreeNode* tnode = tnode_context.tnode();
+    switch (tnode->opcode()) {
+      case TreeNodeOpcode::kPTStartTransaction: FALLTHROUGH_INTENDED;
+      case TreeNodeOpcode::kPTCommit:
+        break;
+      case TreeNodeOpcode::kPTInsertStmt: FALLTHROUGH_INTENDED;
+      case TreeNodeOpcode::kPTUpdateStmt: FALLTHROUGH_INTENDED;
+      case TreeNodeOpcode::kPTDeleteStmt:
+        if (!static_cast<const PTDmlStmt*>(tnode)->table()->index_map().empty()) {
+          return;
+        }
+        break;
+      default:
+        return;
+    }
+  }
+  transaction_->ExpectSingleFlush();
+}
+
 void ExecContext::CommitTransaction(CommitCallback callback) {
   if (!transaction_) {
     LOG(DFATAL) << "No transaction to commit";
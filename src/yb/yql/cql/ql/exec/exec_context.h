@@ -20,6 +20,8 @@
 #ifndef YB_YQL_CQL_QL_EXEC_EXEC_CONTEXT_H_
 #define YB_YQL_CQL_QL_EXEC_EXEC_CONTEXT_H_
 
+#include <deque>
+
 #include "yb/yql/cql/ql/ptree/process_context.h"
 #include "yb/yql/cql/ql/util/ql_env.h"
 #include "yb/yql/cql/ql/util/statement_params.h"
@@ -66,6 +68,11 @@ class TnodeContext {
     ops_.push_back(op);
   }
 
+  // Reads of the next tablets of a table scan, issued ahead of the read of the current tablet.
+  std::deque<client::YBqlReadOpPtr>& scan_ahead_ops() {
+    return scan_ahead_ops_;
+  }
+
   // Does this statement have pending operations?
   bool HasPendingOperations() const;
 
@@ -150,6 +157,10 @@ class TnodeContext {
   // Read/write operations to execute.
   std::vector<client::YBqlOpPtr> ops_;
 
+  // Reads of the next tablets of a table scan, in tablet order. They are sent in the same flush as
+  // the read of the current tablet and are used only if the scan reaches their tablets.
+  std::deque<client::YBqlReadOpPtr> scan_ahead_ops_;
+
   // Accumulated number of rows fetched by the statement.
   size_t row_count_ = 0;
 
@@ -242,6 +253,11 @@ class ExecContext : public ProcessContextBase {
   // Apply the result of a child distributed transaction.
   CHECKED_STATUS ApplyChildTransactionResult(const ChildTransactionResultPB& result);
 
+  // Called before the transactional session is flushed. If all statements are writes to tables
+  // without secondary indexes, this flush has all operations of the transaction, so the
+  // transaction is told that it could be applied as a single shard write.
+  void PrepareTransactionalFlush();
+
   // Commit the current distributed transaction.
   void CommitTransaction(client::CommitCallback callback);
 
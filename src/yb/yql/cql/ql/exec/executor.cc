@@ -15,6 +15,9 @@
 
 #include <yb/yql/cql/ql/util/errcodes.h>
 #include "yb/yql/cql/ql/exec/executor.h"
+
+#include <gflags/gflags.h>
+
 #include "yb/yql/cql/ql/ql_processor.h"
 #include "yb/client/client.h"
 #include "yb/client/callbacks.h"
@@ -24,10 +27,25 @@
 #include "yb/common/wire_protocol.h"
 #include "yb/rpc/thread_pool.h"
 #include "yb/util/decimal.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
 #include "yb/util/thread_restrictions.h"
 #include "yb/util/trace.h"
 
+DEFINE_int32(cql_scan_ahead_tablets, 0,
+             "Number of tablets that a table scan without a hash key condition reads ahead, in "
+             "parallel with the tablet it is reading, so that it does not wait for one tablet "
+             "after another when a page spans several tablets. 0 disables reading ahead.");
+TAG_FLAG(cql_scan_ahead_tablets, advanced);
+
+DEFINE_int32(cql_slow_query_log_threshold_ms, 0,
+             "CQL statements that take longer than this many milliseconds are logged, with the "
+             "DocDB execution statistics of their reads and writes: RocksDB seeks and nexts, "
+             "blocks read, intents encountered, rows scanned and returned, and time in conflict "
+             "resolution. 0 disables the log, and the statistics are not gathered.");
+TAG_FLAG(cql_slow_query_log_threshold_ms, advanced);
+TAG_FLAG(cql_slow_query_log_threshold_ms, runtime);
+
 namespace yb {
 namespace ql {
 
@@ -76,6 +94,7 @@ void Executor::ExecuteAsync(const ParseTree& parse_tree, const StatementParamete
                             StatementExecutedCallback cb) {
   DCHECK(cb_.is_null()) << "Another execution is in progress.";
   cb_ = std::move(cb);
+  start_time_ = MonoTime::Now();
   session_->SetForceConsistentRead(false);
   session_->SetReadPoint(client::Restart::kFalse);
   RETURN_STMT_NOT_OK(Execute(parse_tree, params));
@@ -85,6 +104,7 @@ void Executor::ExecuteAsync(const ParseTree& parse_tree, const StatementParamete
 void Executor::ExecuteAsync(const StatementBatch& batch, StatementExecutedCallback cb) {
   DCHECK(cb_.is_null()) << "Another execution is in progress.";
   cb_ = std::move(cb);
+  start_time_ = MonoTime::Now();
   session_->SetForceConsistentRead(false);
   session_->SetReadPoint(client::Restart::kFalse);
 
@@ -472,8 +492,9 @@ Status Executor::ExecPTNode(const PTAlterTable *tnode) {
             ->RenameTo(mod_column->new_name()->c_str());
         break;
       case ALTER_TYPE:
-        // Not yet supported by AlterTableRequestPB.
-        return exec_context_->Error(tnode, ErrorCode::FEATURE_NOT_YET_IMPLEMENTED);
+        table_alterer->AlterColumn(mod_column->old_name()->last_name().data())
+            ->Type(mod_column->ql_type());
+        break;
     }
   }
 
@@ -755,6 +776,16 @@ Status Executor::ExecPTNode(const PTSelectStmt *tnode, TnodeContext* tnode_conte
       req->set_limit(limit);
       req->set_return_paging_state(false);
     }
+
+    // For a top-N read, each tablet returns its own first "limit" rows regardless of the page
+    // size, and the paging state is only used to move on to the next tablet.
+    if (tnode->is_top_n()) {
+      req->set_limit(limit);
+      req->set_return_paging_state(true);
+      QLOrderByPB* order_by = req->mutable_order_by();
+      order_by->set_rscol_index(tnode->top_n_rscol_index());
+      order_by->set_is_descending(tnode->is_top_n_descending());
+    }
   }
 
   if (tnode->offset()) {
@@ -820,7 +851,8 @@ Status Executor::ExecPTNode(const PTSelectStmt *tnode, TnodeContext* tnode_conte
   }
 
   // Add the operation.
-  return AddOperation(select_op, tnode_context);
+  RETURN_NOT_OK(AddOperation(select_op, tnode_context));
+  return ScanAhead(tnode, select_op, tnode_context);
 }
 
 Result<bool> Executor::FetchMoreRows(const PTSelectStmt* tnode,
@@ -844,6 +876,11 @@ Result<bool> Executor::FetchMoreRows(const PTSelectStmt* tnode,
   const size_t total_rows_skipped = exec_context->params().total_rows_skipped() +
                                     current_params.total_rows_skipped();
 
+  // A top-N read goes through all the tablets, whatever the number of rows read so far.
+  if (op->request().has_order_by()) {
+    return FetchMoreTopNRows(op, current_params, tnode_context);
+  }
+
   // The limit for this select: min of page size and result limit (if set).
   uint64_t fetch_limit = exec_context->params().page_size(); // default;
   if (tnode->limit()) {
@@ -938,10 +975,134 @@ Result<bool> Executor::FetchMoreRows(const PTSelectStmt* tnode,
 }
 
 
+Result<bool> Executor::FetchMoreTopNRows(const YBqlReadOpPtr& op,
+                                         const StatementParameters& current_params,
+                                         TnodeContext* tnode_context) {
+  RowsResult::SharedPtr current_result = tnode_context->rows_result();
+  const bool finished_current_read_partition = current_result->paging_state().empty() ||
+                                               (current_params.next_partition_key().empty() &&
+                                                current_params.next_row_key().empty());
+  if (finished_current_read_partition) {
+    if (tnode_context->UnreadPartitionsRemaining() <= 1) {
+      current_result->ClearPagingState();
+      return false;
+    }
+    tnode_context->AdvanceToNextPartition(op->mutable_request());
+  }
+
+  QLPagingStatePB *paging_state = op->mutable_request()->mutable_paging_state();
+  paging_state->set_next_partition_key(current_params.next_partition_key());
+  paging_state->set_next_row_key(current_params.next_row_key());
+  return true;
+}
+
+Status Executor::MergeTopNResultSets(const PTSelectStmt* pt_select,
+                                     TnodeContext* tnode_context) {
+  if (!pt_select->is_top_n() || !tnode_context->rows_result()) {
+    return Status::OK();
+  }
+
+  QLExpressionPB limit_pb;
+  RETURN_NOT_OK(PTExprToPB(pt_select->limit(), &limit_pb));
+  const size_t limit = std::max(limit_pb.value().int32_value(), 0);
+
+  shared_ptr<RowsResult> rows_result = tnode_context->rows_result();
+  shared_ptr<QLRowBlock> row_block = rows_result->GetRowBlock();
+  std::vector<QLRow>& rows = row_block->rows();
+  const size_t rscol_index = pt_select->top_n_rscol_index();
+  const bool is_descending = pt_select->is_top_n_descending();
+  std::stable_sort(rows.begin(), rows.end(),
+                   [rscol_index, is_descending](const QLRow& lhs, const QLRow& rhs) {
+    const int result = CompareForOrderBy(lhs.column(rscol_index), rhs.column(rscol_index));
+    return is_descending ? result > 0 : result < 0;
+  });
+  if (rows.size() > limit) {
+    rows.erase(rows.begin() + limit, rows.end());
+  }
+
+  faststring buffer;
+  row_block->Serialize(rows_result->client(), &buffer);
+  rows_result->set_rows_data(buffer.c_str(), buffer.size());
+  rows_result->ClearPagingState();
+  return Status::OK();
+}
+
+Status Executor::ScanAhead(const PTSelectStmt* tnode,
+                           const YBqlReadOpPtr& op,
+                           TnodeContext* tnode_context) {
+  // Only a forward scan of the whole table, or a token range of it, reads one tablet after another.
+  // With an offset, the rows to skip in a tablet depend on the rows read from the previous ones.
+  const QLReadRequestPB& req = op->request();
+  if (FLAGS_cql_scan_ahead_tablets <= 0 || !req.hashed_column_values().empty() ||
+      !req.is_forward_scan() || req.has_offset() || req.is_aggregate() || req.has_order_by()) {
+    return Status::OK();
+  }
+
+  // Find the tablet that the op reads from, the first one of the scan unless it is a continuation.
+  string partition_key;
+  if (!req.paging_state().next_partition_key().empty()) {
+    partition_key = req.paging_state().next_partition_key();
+  } else if (req.has_hash_code()) {
+    partition_key = PartitionSchema::EncodeMultiColumnHashValue(req.hash_code());
+  }
+  const std::vector<string>& partitions = tnode->table()->GetPartitions();
+  auto it = std::upper_bound(partitions.begin(), partitions.end(), partition_key);
+
+  auto& scan_ahead_ops = tnode_context->scan_ahead_ops();
+  DCHECK(scan_ahead_ops.empty());
+  const size_t max_scan_ahead_ops = FLAGS_cql_scan_ahead_tablets;
+  for (; it != partitions.end() && scan_ahead_ops.size() < max_scan_ahead_ops; ++it) {
+    if (req.has_max_hash_code() &&
+        PartitionSchema::DecodeMultiColumnHashValue(*it) > req.max_hash_code()) {
+      break;
+    }
+    YBqlReadOpPtr scan_ahead_op(tnode->table()->NewQLSelect());
+    QLReadRequestPB* scan_ahead_req = scan_ahead_op->mutable_request();
+    scan_ahead_req->CopyFrom(req);
+    QLPagingStatePB* paging_state = scan_ahead_req->mutable_paging_state();
+    paging_state->set_next_partition_key(*it);
+    paging_state->clear_next_row_key();
+    scan_ahead_op->set_yb_consistency_level(op->yb_consistency_level());
+    TRACE("Apply");
+    RETURN_NOT_OK(session_->Apply(scan_ahead_op));
+    scan_ahead_ops.push_back(std::move(scan_ahead_op));
+  }
+  return Status::OK();
+}
+
+Result<YBqlReadOpPtr> Executor::TakeScanAheadOp(const YBqlReadOp& op,
+                                                TnodeContext* tnode_context) {
+  auto& scan_ahead_ops = tnode_context->scan_ahead_ops();
+  if (scan_ahead_ops.empty()) {
+    return YBqlReadOpPtr();
+  }
+  YBqlReadOpPtr next_op = std::move(scan_ahead_ops.front());
+  scan_ahead_ops.pop_front();
+
+  // The read ahead is used only if the scan continues from the start of its tablet. It was sent
+  // with the limit of an earlier read, so it may have read more rows than the scan still needs, in
+  // which case its tablet is read again with the current limit.
+  const QLPagingStatePB& paging_state = op.request().paging_state();
+  const QLResponsePB& response = next_op->response();
+  if (paging_state.next_row_key().empty() &&
+      paging_state.next_partition_key() ==
+          next_op->request().paging_state().next_partition_key() &&
+      response.has_status() && response.status() == QLResponsePB::YQL_STATUS_OK &&
+      VERIFY_RESULT(QLRowBlock::GetRowCount(YQL_CLIENT_CQL, next_op->rows_data())) <=
+          op.request().limit()) {
+    return next_op;
+  }
+  scan_ahead_ops.clear();
+  return YBqlReadOpPtr();
+}
+
 Result<bool> Executor::FetchRowsByKeys(const PTSelectStmt* tnode,
                                        const YBqlReadOpPtr& select_op,
                                        const QLRowBlock& keys,
                                        TnodeContext* tnode_context) {
+  // The reads for all keys of the index page are applied to the session together and flushed in
+  // one wave with the read of the next index page, if one is needed. The session groups them into
+  // one RPC per tablet of the table and sends those in parallel.
   const Schema& schema = tnode->table()->InternalSchema();
   for (const QLRow& key : keys.rows()) {
     YBqlReadOpPtr op(tnode->table()->NewQLSelect());
@@ -1064,6 +1225,44 @@ Status Executor::ExecPTNode(const PTDeleteStmt *tnode, TnodeContext* tnode_conte
 
 //--------------------------------------------------------------------------------------------------
 
+namespace {
+
+// Check if a DML may set a column to null, which deletes the row when no other column remains.
+// Values that are not known yet, collection operations and empty collections count as nulls.
+bool MaySetNull(const QLWriteRequestPB& req) {
+  for (const QLColumnValuePB& column_value : req.column_values()) {
+    if (column_value.subscript_args_size() > 0 || column_value.json_args_size() > 0 ||
+        !column_value.expr().has_value()) {
+      return true;
+    }
+    const QLValuePB& value = column_value.expr().value();
+    switch (value.value_case()) {
+      case QLValuePB::VALUE_NOT_SET:
+        return true;
+      case QLValuePB::kMapValue:
+        if (value.map_value().keys_size() == 0) {
+          return true;
+        }
+        break;
+      case QLValuePB::kSetValue:
+        if (value.set_value().elems_size() == 0) {
+          return true;
+        }
+        break;
+      case QLValuePB::kListValue:
+        if (value.list_value().elems_size() == 0) {
+          return true;
+        }
+        break;
+      default:
+        break;
+    }
+  }
+  return false;
+}
+
+} // namespace
+
 Status Executor::ExecPTNode(const PTUpdateStmt *tnode, TnodeContext* tnode_context) {
   // Create write request.
   const shared_ptr<client::YBTable>& table = tnode->table();
@@ -1096,6 +1295,13 @@ Status Executor::ExecPTNode(const PTUpdateStmt *tnode, TnodeContext* tnode_conte
     return exec_context_->Error(tnode, s, ErrorCode::INVALID_ARGUMENTS);
   }
 
+  // An UPDATE of an existing row that keeps the index entries is a single-row conditional write
+  // that needs no transaction. If it may set a null, it may delete the row and its index entries,
+  // so they are updated in a transaction as usual.
+  if (tnode->KeepsIndexesIfNotNull() && tnode->IndexesRequireTransaction() && MaySetNull(*req)) {
+    RETURN_NOT_OK(exec_context_->StartTransaction(SNAPSHOT_ISOLATION, ql_env_));
+  }
+
   // Setup the column values that need to be read.
   s = ColumnRefsToPB(tnode, req->mutable_column_refs());
   if (PREDICT_FALSE(!s.ok())) {
@@ -1249,6 +1455,7 @@ void Executor::FlushAsync() {
   for (ExecContext& exec_context : exec_contexts_) {
     if (exec_context.HasTransaction()) {
       if (exec_context.transactional_session()->CountBufferedOperations() > 0) {
+        exec_context.PrepareTransactionalFlush();
         flush_sessions.push_back({exec_context.transactional_session(), &exec_context});
       } else if (!exec_context.HasPendingOperations()) {
         commit_contexts.push_back(&exec_context);
@@ -1439,6 +1646,8 @@ void Executor::ProcessAsyncResults(const bool rescheduled) {
       if (tnode->opcode() == TreeNodeOpcode::kPTSelectStmt) {
         RETURN_STMT_NOT_OK(AggregateResultSets(static_cast<const PTSelectStmt *>(tnode),
                                                &tnode_context));
+        RETURN_STMT_NOT_OK(MergeTopNResultSets(static_cast<const PTSelectStmt *>(tnode),
+                                               &tnode_context));
       }
 
       // Update the metrics for SELECT/INSERT/UPDATE/DELETE here after the ops have been completed
@@ -1523,6 +1732,11 @@ Result<bool> Executor::ProcessTnodeResults(TnodeContext* tnode_context) {
       continue;
     }
 
+    if (op->response().has_execution_stats()) {
+      AddExecutionStats(op->response().execution_stats(), &execution_stats_);
+      op->mutable_response()->clear_execution_stats();
+    }
+
     // If the statement is in a transaction, check the status of the current operation. If it
     // failed to apply (either because of an execution error or unsatisfied IF condition), quit the
     // execution and abort the transaction. Also, if this is a batch returning status, mark all
@@ -1586,13 +1800,22 @@ Result<bool> Executor::ProcessTnodeResults(TnodeContext* tnode_context) {
         DCHECK_EQ(op->type(), YBOperation::Type::QL_READ);
         const auto& read_op = std::static_pointer_cast<YBqlReadOp>(op);
         if (VERIFY_RESULT(FetchMoreRows(select_stmt, read_op, tnode_context, exec_context_))) {
+          // If the next tablet of a table scan has been read ahead, continue with its result.
+          YBqlReadOpPtr next_op = VERIFY_RESULT(TakeScanAheadOp(*read_op, tnode_context));
+          if (next_op) {
+            *op_itr = std::move(next_op);
+            continue;
+          }
           op->mutable_response()->Clear();
           TRACE("Apply");
           RETURN_NOT_OK(session_->Apply(op));
+          RETURN_NOT_OK(ScanAhead(select_stmt, read_op, tnode_context));
           has_buffered_ops = true;
           op_itr++;
           continue;
         }
+        // The scan is done, or stops at the end of this page, so the reads ahead are not needed.
+        tnode_context->scan_ahead_ops().clear();
       }
     }
 
@@ -1707,6 +1930,12 @@ Status Executor::UpdateIndexes(const PTDmlStmt *tnode,
     return exec_context_->Error(tnode, ErrorCode::FEATURE_NOT_SUPPORTED);
   }
 
+  // The index entries stay as they are. When the DML may set nulls, a transaction was started in
+  // ExecPTNode() and the indexes are updated as usual.
+  if (tnode->KeepsIndexesIfNotNull() && !MaySetNull(*req)) {
+    return Status::OK();
+  }
+
   // If updates of pk-only indexes can be issued from CQL proxy directly, do it. Otherwise, add
   // them to the list of indexes to be updated from tserver.
   if (!tnode->pk_only_indexes().empty()) {
@@ -1755,7 +1984,7 @@ Status Executor::UpdateIndexes(const PTDmlStmt *tnode,
     }
   }
 
-  if (!req->update_index_ids().empty() && tnode->RequiresTransaction()) {
+  if (!req->update_index_ids().empty() && tnode->IndexesRequireTransaction()) {
     RETURN_NOT_OK(exec_context_->PrepareChildTransaction(req->mutable_child_transaction_data()));
   }
   return Status::OK();
@@ -1841,6 +2070,9 @@ bool Executor::WriteBatch::Empty() const {
 Status Executor::AddOperation(const YBqlReadOpPtr& op, TnodeContext *tnode_context) {
   DCHECK(write_batch_.Empty()) << "Concurrent read and write operations not supported yet";
   tnode_context->AddOperation(op);
+  if (FLAGS_cql_slow_query_log_threshold_ms > 0) {
+    op->mutable_request()->set_return_execution_stats(true);
+  }
 
   // We need consistent read point if statement is executed in multiple RPC commands.
   if (tnode_context->UnreadPartitionsRemaining() > 0 ||
@@ -1854,6 +2086,9 @@ Status Executor::AddOperation(const YBqlReadOpPtr& op, TnodeContext *tnode_conte
 
 Status Executor::AddOperation(const YBqlWriteOpPtr& op, TnodeContext *tnode_context) {
   tnode_context->AddOperation(op);
+  if (FLAGS_cql_slow_query_log_threshold_ms > 0) {
+    op->mutable_request()->set_return_execution_stats(true);
+  }
 
   // Check for inter-dependency in the current write batch before applying the write operation.
   // Apply it in the transactional session in exec_context for the current statement if there is
@@ -2023,6 +2258,10 @@ void Executor::StatementExecuted(const Status& s) {
     ql_metrics_->num_flushes_to_execute_ql_->Increment(num_flushes_);
   }
 
+  if (s.ok()) {
+    LogIfSlowQuery();
+  }
+
   // Clean up and invoke statement-executed callback.
   ExecutedResult::SharedPtr result = s.ok() ? std::move(result_) : nullptr;
   StatementExecutedCallback cb = std::move(cb_);
@@ -2030,6 +2269,33 @@ void Executor::StatementExecuted(const Status& s) {
   cb.Run(s, result);
 }
 
+void Executor::LogIfSlowQuery() {
+  const int32_t threshold_ms = FLAGS_cql_slow_query_log_threshold_ms;
+  if (threshold_ms <= 0 || exec_contexts_.empty()) {
+    return;
+  }
+  const auto elapsed_ms = (MonoTime::Now() - start_time_).ToMilliseconds();
+  if (elapsed_ms < threshold_ms) {
+    return;
+  }
+  // Only the start of long statements and batches is logged.
+  constexpr size_t kMaxLoggedStatementsLength = 1024;
+  string statements;
+  for (const auto& exec_context : exec_contexts_) {
+    if (!statements.empty()) {
+      statements += "; ";
+    }
+    statements += exec_context.stmt();
+    if (statements.size() > kMaxLoggedStatementsLength) {
+      statements.resize(kMaxLoggedStatementsLength);
+      statements += "...";
+      break;
+    }
+  }
+  LOG(WARNING) << "Slow CQL query took " << elapsed_ms << "ms, DocDB stats: { "
+               << execution_stats_.ShortDebugString() << " }: " << statements;
+}
+
 void Executor::Reset() {
   exec_context_ = nullptr;
   exec_contexts_.clear();
@@ -2039,6 +2305,7 @@ void Executor::Reset() {
   result_ = nullptr;
   cb_.Reset();
   returns_status_batch_opt_ = boost::none;
+  execution_stats_.Clear();
 }
 
 }  // namespace ql
@@ -22,6 +22,7 @@
 #include "yb/common/ql_expr.h"
 #include "yb/common/ql_rowblock.h"
 #include "yb/common/common.pb.h"
+#include "yb/common/ql_protocol.pb.h"
 #include "yb/yql/cql/ql/exec/exec_context.h"
 #include "yb/yql/cql/ql/ptree/pt_create_keyspace.h"
 #include "yb/yql/cql/ql/ptree/pt_use_keyspace.h"
@@ -195,6 +196,23 @@ class Executor : public QLExprExecutor {
                              TnodeContext* tnode_context,
                              ExecContext* exec_context);
 
+  // Continue a top-N select with the next tablet, which returns its own first rows in order.
+  Result<bool> FetchMoreTopNRows(const client::YBqlReadOpPtr& op,
+                                 const StatementParameters& current_params,
+                                 TnodeContext* tnode_context);
+
+  // Read the tablets that follow the one 'op' reads from in a table scan ahead of time, in parallel
+  // with 'op', up to --cql_scan_ahead_tablets tablets.
+  CHECKED_STATUS ScanAhead(const PTSelectStmt* tnode,
+                           const client::YBqlReadOpPtr& op,
+                           TnodeContext* tnode_context);
+
+  // Return the read of the next tablet issued by ScanAhead() if the table scan continues from the
+  // start of that tablet with 'op' and the rows read fit in its limit. Otherwise, drop the reads
+  // issued ahead and return null.
+  Result<client::YBqlReadOpPtr> TakeScanAheadOp(const client::YBqlReadOp& op,
+                                                TnodeContext* tnode_context);
+
   // Fetch rows for a select statement using primary keys selected from an uncovered index.
   Result<bool> FetchRowsByKeys(const PTSelectStmt* tnode,
                                const client::YBqlReadOpPtr& select_op,
@@ -203,6 +221,9 @@ class Executor : public QLExprExecutor {
 
   // Aggregate all result sets from all tablet servers to form the requested resultset.
   CHECKED_STATUS AggregateResultSets(const PTSelectStmt* pt_select, TnodeContext* tnode_context);
+
+  // Merge the first rows returned by each tablet for a top-N select into the first rows overall.
+  CHECKED_STATUS MergeTopNResultSets(const PTSelectStmt* pt_select, TnodeContext* tnode_context);
   CHECKED_STATUS EvalCount(const std::shared_ptr<QLRowBlock>& row_block,
                            int column_index,
                            QLValue *ql_value);
@@ -224,6 +245,10 @@ class Executor : public QLExprExecutor {
   // Invoke statement executed callback.
   void StatementExecuted(const Status& s);
 
+  // Logs the statements executed with their DocDB execution statistics, if they took longer than
+  // --cql_slow_query_log_threshold_ms.
+  void LogIfSlowQuery();
+
   // Reset execution state.
   void Reset();
 
@@ -417,6 +442,10 @@ class Executor : public QLExprExecutor {
   // Whether this is a batch with statements that returns status.
   boost::optional<bool> returns_status_batch_opt_;
 
+  // When the execution started, and the DocDB execution statistics returned for its operations.
+  MonoTime start_time_;
+  DocDBExecutionStatsPB execution_stats_;
+
   class ProcessAsyncResultsTask : public rpc::ThreadPoolTask {
    public:
     ProcessAsyncResultsTask& Bind(Executor* executor) {
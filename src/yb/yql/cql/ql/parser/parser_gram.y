@@ -1967,7 +1967,7 @@ alterColumnTypeList:
 
 alterColumnType:
   qualified_name TYPE_P Typename {
-    PARSER_UNSUPPORTED(@3);
+    $$ = MAKE_NODE(@1, PTAlterColumnDefinition, $1, nullptr, $3, ALTER_TYPE);
   }
 ;
 
@@ -85,6 +85,21 @@ CHECKED_STATUS PTAlterTable::AppendModColumn(SemContext *sem_context,
     if (desc->is_hash() && column->mod_type() != ALTER_RENAME) {
       return sem_context->Error(this, "Can't alter key column", ErrorCode::ALTER_KEY_COLUMN);
     }
+
+    // Only type changes that existing data can be read back as are allowed, so that the alter
+    // is a schema-only change on the tablets.
+    if (column->mod_type() == ALTER_TYPE) {
+      if (desc->is_primary()) {
+        return sem_context->Error(this, "Can't alter type of primary key column",
+                                  ErrorCode::ALTER_KEY_COLUMN);
+      }
+      const auto& new_type = column->ql_type();
+      if (!desc->ql_type()->IsElementary() || !new_type->IsElementary() ||
+          !QLType::IsStorageWidening(desc->ql_type()->main(), new_type->main())) {
+        return sem_context->Error(this, "Can't alter column to an incompatible type",
+                                  ErrorCode::DATATYPE_MISMATCH);
+      }
+    }
   }
 
   // Make sure column already doesn't exist with the same name.
@@ -357,10 +357,37 @@ Status PTDmlStmt::AnalyzeIndexesForWrites(SemContext *sem_context) {
 }
 
 bool PTDmlStmt::RequiresTransaction() const {
+  return IndexesRequireTransaction() && !keeps_indexes_if_not_null_;
+}
+
+bool PTDmlStmt::IndexesRequireTransaction() const {
   return IsWriteOp() && !DCHECK_NOTNULL(table_.get())->index_map().empty() &&
       table_->InternalSchema().table_properties().is_transactional();
 }
 
+bool PTDmlStmt::SetsIndexedColumns() const {
+  std::set<int32> set_columns;
+  for (const auto& arg : *column_args_) {
+    if (arg.IsInitialized()) {
+      set_columns.insert(arg.desc()->id());
+    }
+  }
+  for (const auto& arg : *subscripted_col_args_) {
+    set_columns.insert(arg.desc()->id());
+  }
+  for (const auto& arg : *json_col_args_) {
+    set_columns.insert(arg.desc()->id());
+  }
+  for (const auto& itr : table_->index_map()) {
+    for (const IndexInfo::IndexColumn& column : itr.second.columns()) {
+      if (set_columns.count(column.indexed_column_id) != 0) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 Status PTDmlStmt::AnalyzeHashColumnBindVars(SemContext *sem_context) {
   // If not all hash columns are bound, clear hash_col_bindvars_ because the client driver will not
   // be able to compute the full hash key unless it parses the SQL statement and extracts the
@@ -374,8 +374,21 @@ class PTDmlStmt : public PTCollection {
            opcode() == TreeNodeOpcode::kPTDeleteStmt;
   }
 
+  // Does this DML need a distributed transaction to update the indexes of the table along with
+  // the table?
   bool RequiresTransaction() const;
 
+  // Would the indexes of the table need updates in a distributed transaction if this DML was not
+  // known to keep them unchanged?
+  bool IndexesRequireTransaction() const;
+
+  // Does this UPDATE leave the entries of all indexes unchanged as long as it sets no column to
+  // null? That is the case when it applies to an existing row only (IF EXISTS) and sets columns no
+  // index refers to. Otherwise, it could create or, by setting nulls, delete the row.
+  bool KeepsIndexesIfNotNull() const {
+    return keeps_indexes_if_not_null_;
+  }
+
   const MCUnorderedSet<std::shared_ptr<client::YBTable>>& pk_only_indexes() const {
     return pk_only_indexes_;
   }
@@ -433,6 +446,9 @@ class PTDmlStmt : public PTCollection {
   // Does column_args_ contain static columns only (i.e. writing static column only)?
   bool StaticColumnArgsOnly() const;
 
+  // Does any index refer to a column set by this DML?
+  bool SetsIndexedColumns() const;
+
   // --- The parser will decorate this node with the following information --
 
   const PTExpr::SharedPtr where_clause_;
@@ -491,6 +507,7 @@ class PTDmlStmt : public PTCollection {
   // indexes that do not.
   MCUnorderedSet<client::YBTablePtr> pk_only_indexes_;
   MCUnorderedSet<TableId> non_pk_only_indexes_;
+  bool keeps_indexes_if_not_null_ = false;
 
   // For inter-dependency analysis of DMLs in a batch/transaction
   bool modifies_primary_row_ = false;
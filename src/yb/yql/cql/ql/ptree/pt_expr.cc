@@ -16,7 +16,10 @@
 //--------------------------------------------------------------------------------------------------
 
 #include "yb/yql/cql/ql/ptree/pt_expr.h"
+#include "yb/client/client.h"
+#include "yb/common/index.h"
 #include "yb/yql/cql/ql/ptree/pt_bcall.h"
+#include "yb/yql/cql/ql/ptree/pt_dml.h"
 #include "yb/yql/cql/ql/ptree/sem_context.h"
 #include "yb/util/decimal.h"
 #include "yb/util/net/inetaddress.h"
@@ -642,7 +645,9 @@ CHECKED_STATUS PTRelationExpr::AnalyzeOperator(SemContext *sem_context,
       const PTJsonColumnWithOperators *ref =
           static_cast<const PTJsonColumnWithOperators*>(op1.get());
 
-      return where_state->AnalyzeColumnOp(sem_context, this, ref->desc(), op2, ref->operators());
+      // A reference to the index column of the path is a plain column operator.
+      return where_state->AnalyzeColumnOp(sem_context, this, ref->desc(), op2,
+                                          ref->is_index_column() ? nullptr : ref->operators());
     } else if (op1->expr_op() == ExprOperator::kBcall) {
       const PTBcall *bcall = static_cast<const PTBcall *>(op1.get());
       if (strcmp(bcall->name()->c_str(), "token") == 0 ||
@@ -860,7 +865,16 @@ CHECKED_STATUS PTJsonColumnWithOperators::AnalyzeOperator(SemContext *sem_contex
 
   SemState sem_state(sem_context);
 
+  is_index_column_ = false;
   if (!desc_->ql_type()->IsJson()) {
+    // When selecting from an index on this path, the expression is a reference to the index column.
+    RETURN_NOT_OK(operators_->Analyze(sem_context));
+    if (IsIndexedPath(sem_context)) {
+      is_index_column_ = true;
+      ql_type_ = desc_->ql_type();
+      internal_type_ = desc_->internal_type();
+      return Status::OK();
+    }
     return sem_context->Error(this, "Column provided is not json data type",
                               ErrorCode::CQL_STATEMENT_INVALID);
   }
@@ -895,6 +909,61 @@ CHECKED_STATUS PTJsonColumnWithOperators::CheckLhsExpr(SemContext *sem_context)
   return Status::OK();
 }
 
+bool PTJsonColumnWithOperators::MatchesIndexedPath(const PTExprListNode& operators,
+                                                   const QLJsonColumnOperationsPB& json_ops) {
+  const int num_ops = json_ops.json_operations_size();
+  if (num_ops == 0 || operators.size() != num_ops ||
+      json_ops.json_operations(num_ops - 1).json_operator() != JsonOperatorPB::JSON_TEXT) {
+    return false;
+  }
+  auto indexed_op = json_ops.json_operations().begin();
+  for (const auto& node : operators.node_list()) {
+    const auto* const json_op = static_cast<const PTJsonOperator*>(node.get());
+    const JsonOperatorPB op = json_op->json_operator() == JsonOperator::JSON_TEXT
+        ? JsonOperatorPB::JSON_TEXT : JsonOperatorPB::JSON_OBJECT;
+    const QLValuePB& indexed_arg = indexed_op->operand().value();
+    if (op != indexed_op->json_operator()) {
+      return false;
+    }
+    const PTExpr* const arg = json_op->arg().get();
+    switch (arg->internal_type()) {
+      case InternalType::kStringValue:
+        if (!indexed_arg.has_string_value() ||
+            static_cast<const PTConstText*>(arg)->QLName() != indexed_arg.string_value()) {
+          return false;
+        }
+        break;
+      case InternalType::kVarintValue: {
+        util::VarInt varint;
+        if (!indexed_arg.has_varint_value() ||
+            !varint.FromString(static_cast<const PTConstVarInt*>(arg)->value()->c_str()).ok() ||
+            varint.EncodeToComparable() != indexed_arg.varint_value()) {
+          return false;
+        }
+        break;
+      }
+      default:
+        // Bind variables and other expressions are not known until execution.
+        return false;
+    }
+    ++indexed_op;
+  }
+  return true;
+}
+
+bool PTJsonColumnWithOperators::IsIndexedPath(SemContext *sem_context) const {
+  const PTDmlStmt* const stmt = sem_context->current_dml_stmt();
+  if (stmt == nullptr || stmt->table() == nullptr || !stmt->table()->IsIndex()) {
+    return false;
+  }
+  for (const IndexInfo::IndexColumn& column : stmt->table()->index_info().columns()) {
+    if (column.column_id.rep() == desc_->id()) {
+      return column.is_json_path() && MatchesIndexedPath(*operators_, column.json_ops);
+    }
+  }
+  return false;
+}
+
 CHECKED_STATUS PTJsonColumnWithOperators::SetupPrimaryKey(SemContext *sem_context) const {
   PTColumnDefinition* column = sem_context->GetColumnDefinition(name_->first_name());
   if (column == nullptr) {
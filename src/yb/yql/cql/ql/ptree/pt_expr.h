@@ -1035,11 +1035,22 @@ class PTJsonColumnWithOperators : public PTOperator0 {
     return desc_;
   }
 
+  // Whether the expression refers to the column of an index on the same jsonb path, when
+  // selecting from that index.
+  bool is_index_column() const {
+    return is_index_column_;
+  }
+
   // Node type.
   virtual TreeNodeOpcode opcode() const override {
     return TreeNodeOpcode::kPTJsonOp;
   }
 
+  // Returns whether the analyzed json operators are the indexed jsonb path 'json_ops'. Only paths
+  // that end with '->>' match, since index columns hold text.
+  static bool MatchesIndexedPath(const PTExprListNode& operators,
+                                 const QLJsonColumnOperationsPB& json_ops);
+
   // Analyze LHS expression.
   virtual CHECKED_STATUS CheckLhsExpr(SemContext *sem_context) override;
 
@@ -1048,11 +1059,15 @@ class PTJsonColumnWithOperators : public PTOperator0 {
   CHECKED_STATUS SetupCoveringIndexColumn(SemContext *sem_context) const;
 
  private:
+  // Whether the current statement selects from an index on this jsonb path.
+  bool IsIndexedPath(SemContext *sem_context) const;
+
   PTQualifiedName::SharedPtr name_;
   PTExprListNode::SharedPtr operators_;
 
   // Fields that should be resolved by semantic analysis.
   const ColumnDesc *desc_ = nullptr;
+  bool is_index_column_ = false;
 };
 
 // SubColumn Reference. The datatype of this expression would need to be resolved by the analyzer.
@@ -75,6 +75,18 @@ bool CoversFully(const IndexInfo& index_info, const MCSet<int32>& column_refs) {
   return true;
 }
 
+// Returns the position of the index key column that indexes the jsonb path of 'col_op', or -1.
+int FindJsonPathKeyColumn(const IndexInfo& index_info, const JsonColumnOp& col_op) {
+  for (size_t i = 0; i < index_info.key_column_count(); i++) {
+    const IndexInfo::IndexColumn& column = index_info.column(i);
+    if (column.is_json_path() && column.indexed_column_id.rep() == col_op.desc()->id() &&
+        PTJsonColumnWithOperators::MatchesIndexedPath(*col_op.args(), column.json_ops)) {
+      return i;
+    }
+  }
+  return -1;
+}
+
 // Class to compare selectivity of an index for a SELECT statement.
 class Selectivity {
  public:
@@ -87,7 +99,8 @@ class Selectivity {
     for (size_t i = 0; i < schema.num_key_columns(); i++) {
       id_to_idx.emplace(schema.ColumnId(i), i);
     }
-    Analyze(memctx, stmt, id_to_idx, schema.num_key_columns(), schema.num_hash_key_columns());
+    Analyze(memctx, stmt, id_to_idx, nullptr /* index_info */, schema.num_key_columns(),
+            schema.num_hash_key_columns());
   }
 
   // Selectivity of an index.
@@ -97,9 +110,13 @@ class Selectivity {
         covers_fully_(CoversFully(index_info, stmt.column_refs())) {
     MCIdToIndexMap id_to_idx(memctx);
     for (size_t i = 0; i < index_info.key_column_count(); i++) {
-      id_to_idx.emplace(index_info.column(i).indexed_column_id, i);
+      // Columns on jsonb paths are matched by FindJsonPathKeyColumn().
+      if (!index_info.column(i).is_json_path()) {
+        id_to_idx.emplace(index_info.column(i).indexed_column_id, i);
+      }
     }
-    Analyze(memctx, stmt, id_to_idx, index_info.key_column_count(), index_info.hash_column_count());
+    Analyze(memctx, stmt, id_to_idx, &index_info, index_info.key_column_count(),
+            index_info.hash_column_count());
   }
 
   bool covers_fully() const { return covers_fully_; }
@@ -168,10 +185,11 @@ class Selectivity {
   void Analyze(MemoryContext *memctx,
                const PTSelectStmt& stmt,
                const MCIdToIndexMap& id_to_idx,
+               const IndexInfo* index_info,
                const size_t num_key_columns,
                const size_t num_hash_key_columns) {
     // The operator on each column, in the order of the columns in the table or index we analyze.
-    MCVector<OpSelectivity> ops(id_to_idx.size(), OpSelectivity::kNone, memctx);
+    MCVector<OpSelectivity> ops(num_key_columns, OpSelectivity::kNone, memctx);
     for (const ColumnOp& col_op : stmt.key_where_ops()) {
       const auto iter = id_to_idx.find(col_op.desc()->id());
       if (iter != id_to_idx.end()) {
@@ -188,6 +206,14 @@ class Selectivity {
         num_non_key_ops_++;
       }
     }
+    for (const JsonColumnOp& col_op : stmt.json_col_where_ops()) {
+      const int idx = index_info != nullptr ? FindJsonPathKeyColumn(*index_info, col_op) : -1;
+      if (idx >= 0) {
+        ops[idx] = GetOperatorSelectivity(col_op.yb_op());
+      } else {
+        num_non_key_ops_++;
+      }
+    }
 
     // Find the length of fully specified prefix in index or indexed table.
     while (prefix_length_ < ops.size() && ops[prefix_length_] == OpSelectivity::kEqual) {
@@ -368,7 +394,8 @@ CHECKED_STATUS PTSelectStmt::Analyze(SemContext *sem_context) {
 
   // Check if there is an index to use. If there is and it covers the query fully, we will query
   // just the index and that is it.
-  if (index_id_.empty()) {
+  // A top-N read has to see all the rows of the table, so it does not use an index.
+  if (index_id_.empty() && !is_top_n()) {
     RETURN_NOT_OK(AnalyzeIndexes(sem_context));
     if (child_select_ && child_select_->covers_fully_) {
       return Status::OK();
@@ -528,18 +555,27 @@ PTOrderBy::Direction directionFromSortingType(ColumnSchema::SortingType sorting_
 
 CHECKED_STATUS PTSelectStmt::AnalyzeOrderByClause(SemContext *sem_context) {
   if (order_by_clause_ != nullptr) {
+    unordered_map<string, PTOrderBy::Direction> order_by_map;
+    for (auto& order_by : order_by_clause_->node_list()) {
+      RETURN_NOT_OK(order_by->Analyze(sem_context));
+      order_by_map[order_by->name()->QLName()] = order_by->direction();
+    }
+
+    // Ordering by a column that is not a clustering column is done as a top-N read.
+    if (order_by_clause_->size() == 1) {
+      const PTOrderBy& order_by = *order_by_clause_->element(0);
+      const ColumnDesc* col_desc = static_cast<const PTRef*>(order_by.name().get())->desc();
+      if (col_desc != nullptr && !col_desc->is_primary()) {
+        return AnalyzeTopNOrderBy(sem_context, order_by, *col_desc);
+      }
+    }
+
     if (key_where_ops_.empty()) {
       return sem_context->Error(
           order_by_clause_,
           "All hash columns must be set if order by clause is present.",
           ErrorCode::INVALID_ARGUMENTS);
     }
-
-    unordered_map<string, PTOrderBy::Direction> order_by_map;
-    for (auto& order_by : order_by_clause_->node_list()) {
-      RETURN_NOT_OK(order_by->Analyze(sem_context));
-      order_by_map[order_by->name()->QLName()] = order_by->direction();
-    }
     const auto& schema = table_->schema();
     vector<bool> is_column_forward;
     is_column_forward.reserve(schema.num_range_key_columns());
@@ -579,6 +615,55 @@ CHECKED_STATUS PTSelectStmt::AnalyzeOrderByClause(SemContext *sem_context) {
   return Status::OK();
 }
 
+CHECKED_STATUS PTSelectStmt::AnalyzeTopNOrderBy(SemContext *sem_context,
+                                                const PTOrderBy& order_by,
+                                                const ColumnDesc& col_desc) {
+  // Without a LIMIT, every row would be sent to the proxy to be sorted.
+  if (limit_clause_ == nullptr) {
+    return sem_context->Error(
+        order_by_clause_, "Order by a non-clustering column requires a LIMIT clause",
+        ErrorCode::INVALID_ARGUMENTS);
+  }
+  if (offset_clause_ != nullptr || distinct_ || is_aggregate_) {
+    return sem_context->Error(
+        order_by_clause_,
+        "Order by a non-clustering column is not supported with OFFSET, DISTINCT or aggregates",
+        ErrorCode::INVALID_ARGUMENTS);
+  }
+  if (col_desc.is_static() || col_desc.ql_type()->IsParametric() ||
+      col_desc.ql_type()->IsJson()) {
+    return sem_context->Error(
+        order_by_clause_, "Order by a static, collection or json column is not supported",
+        ErrorCode::INVALID_ARGUMENTS);
+  }
+
+  // The proxy merges the rows of the tablets by the ordering column, so it has to be selected.
+  int rscol_index = 0;
+  for (const auto& expr : selected_exprs()) {
+    if (expr->opcode() == TreeNodeOpcode::kPTAllColumns) {
+      for (const auto& desc : static_cast<const PTAllColumns*>(expr.get())->columns()) {
+        if (desc.id() == col_desc.id()) {
+          top_n_rscol_index_ = rscol_index;
+        }
+        rscol_index++;
+      }
+    } else {
+      if (expr->opcode() == TreeNodeOpcode::kPTRef &&
+          static_cast<const PTRef*>(expr.get())->desc()->id() == col_desc.id()) {
+        top_n_rscol_index_ = rscol_index;
+      }
+      rscol_index++;
+    }
+  }
+  if (top_n_rscol_index_ < 0) {
+    return sem_context->Error(
+        order_by_clause_, "Order by a non-clustering column requires the column to be selected",
+        ErrorCode::INVALID_ARGUMENTS);
+  }
+  is_top_n_descending_ = order_by.direction() == PTOrderBy::Direction::kDESC;
+  return Status::OK();
+}
+
 //--------------------------------------------------------------------------------------------------
 
 CHECKED_STATUS PTSelectStmt::AnalyzeLimitClause(SemContext *sem_context) {
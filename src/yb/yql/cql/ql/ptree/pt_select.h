@@ -262,6 +262,21 @@ class PTSelectStmt : public PTDmlStmt {
     return is_aggregate_;
   }
 
+  // Whether this is "ORDER BY <column> LIMIT <n>" on a column that is not a clustering column,
+  // where each tablet returns its own first n rows and the proxy merges them. The column is the
+  // top_n_rscol_index()-th of the selected row.
+  bool is_top_n() const {
+    return top_n_rscol_index_ >= 0;
+  }
+
+  int top_n_rscol_index() const {
+    return top_n_rscol_index_;
+  }
+
+  bool is_top_n_descending() const {
+    return is_top_n_descending_;
+  }
+
   const PTSelectStmt::SharedPtr& child_select() const {
     return child_select_;
   }
@@ -303,6 +318,8 @@ class PTSelectStmt : public PTDmlStmt {
   CHECKED_STATUS AnalyzeIndexes(SemContext *sem_context);
   CHECKED_STATUS AnalyzeDistinctClause(SemContext *sem_context);
   CHECKED_STATUS AnalyzeOrderByClause(SemContext *sem_context);
+  CHECKED_STATUS AnalyzeTopNOrderBy(SemContext *sem_context, const PTOrderBy& order_by,
+                                    const ColumnDesc& col_desc);
   CHECKED_STATUS AnalyzeLimitClause(SemContext *sem_context);
   CHECKED_STATUS AnalyzeOffsetClause(SemContext *sem_context);
   CHECKED_STATUS ConstructSelectedSchema();
@@ -332,6 +349,8 @@ class PTSelectStmt : public PTDmlStmt {
 
   bool is_forward_scan_ = true;
   bool is_aggregate_ = false;
+  int top_n_rscol_index_ = -1;
+  bool is_top_n_descending_ = false;
 
   // Child select statement. Currently only a select statement using an index (covered or uncovered)
   // has a child select statement to query an index.
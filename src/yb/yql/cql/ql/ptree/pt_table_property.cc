@@ -11,10 +11,12 @@
 // under the License.
 //
 
+#include <limits>
 #include <set>
 #include "yb/client/schema.h"
 #include "yb/yql/cql/ql/ptree/pt_table_property.h"
 #include "yb/yql/cql/ql/ptree/sem_context.h"
+#include "yb/util/cache_metrics.h"
 #include "yb/util/stol_utils.h"
 #include "yb/util/string_case.h"
 #include "yb/util/string_util.h"
@@ -25,11 +27,26 @@ namespace ql {
 using strings::Substitute;
 using client::YBColumnSchema;
 
+namespace {
+
+// Values of the bloom_filter_format table property.
+const char* const kBloomFilterFormatDefault = "default";
+const char* const kBloomFilterFormatFastLocal = "fast_local";
+
+// Values of the memtable_format table property.
+const char* const kMemtableFormatDefault = "default";
+const char* const kMemtableFormatHashPrefix = "hash_prefix";
+
+} // namespace
+
 // These property names need to be lowercase, since identifiers are converted to lowercase by the
 // scanner phase and as a result if we're doing string matching everything should be lowercase.
 const std::map<std::string, PTTableProperty::KVProperty> PTTableProperty::kPropertyDataTypes
     = {
+    {"bloom_filter_format", KVProperty::kBloomFilterFormat},
     {"bloom_filter_fp_chance", KVProperty::kBloomFilterFpChance},
+    {"bloom_filter_range_components", KVProperty::kBloomFilterRangeComponents},
+    {"block_cache_priority_class", KVProperty::kBlockCachePriorityClass},
     {"caching", KVProperty::kCaching},
     {"comment", KVProperty::kComment},
     {"compaction", KVProperty::kCompaction},
@@ -38,8 +55,10 @@ const std::map<std::string, PTTableProperty::KVProperty> PTTableProperty::kPrope
     {"dclocal_read_repair_chance", KVProperty::kDclocalReadRepairChance},
     {"default_time_to_live", KVProperty::kDefaultTimeToLive},
     {"gc_grace_seconds", KVProperty::kGcGraceSeconds},
+    {"history_retention_seconds", KVProperty::kHistoryRetentionSeconds},
     {"index_interval", KVProperty::kIndexInterval},
     {"memtable_flush_period_in_ms", KVProperty::kMemtableFlushPeriodInMs},
+    {"memtable_format", KVProperty::kMemtableFormat},
     {"min_index_interval", KVProperty::kMinIndexInterval},
     {"max_index_interval", KVProperty::kMaxIndexInterval},
     {"read_repair_chance", KVProperty::kReadRepairChance},
@@ -160,6 +179,23 @@ CHECKED_STATUS PTTableProperty::Analyze(SemContext *sem_context) {
   string str_val;
 
   switch (iterator->second) {
+    case KVProperty::kBloomFilterFormat:
+      // Tablets pick the format of the bloom filters that they build when they are opened.
+      if (sem_context->current_alter_table() != nullptr) {
+        return sem_context->Error(this,
+                                  Substitute("$0 could not be altered", table_property_name).c_str(),
+                                  ErrorCode::FEATURE_NOT_SUPPORTED);
+      }
+      RETURN_SEM_CONTEXT_ERROR_NOT_OK(GetStringValueFromExpr(rhs_, true, table_property_name,
+                                                             &str_val));
+      if (str_val != kBloomFilterFormatDefault && str_val != kBloomFilterFormatFastLocal) {
+        return sem_context->Error(this,
+                                  Substitute("$0 must be '$1' or '$2' (got '$3')",
+                                             table_property_name, kBloomFilterFormatDefault,
+                                             kBloomFilterFormatFastLocal, str_val).c_str(),
+                                  ErrorCode::INVALID_ARGUMENTS);
+      }
+      break;
     case KVProperty::kBloomFilterFpChance:
       RETURN_SEM_CONTEXT_ERROR_NOT_OK(GetDoubleValueFromExpr(rhs_, table_property_name,
                                                              &double_val));
@@ -170,6 +206,37 @@ CHECKED_STATUS PTTableProperty::Analyze(SemContext *sem_context) {
             ErrorCode::INVALID_ARGUMENTS);
       }
       break;
+    case KVProperty::kBloomFilterRangeComponents:
+      // The bloom filters of existing SST files could not be changed.
+      if (sem_context->current_alter_table() != nullptr) {
+        return sem_context->Error(this,
+                                  Substitute("$0 could not be altered", table_property_name).c_str(),
+                                  ErrorCode::FEATURE_NOT_SUPPORTED);
+      }
+      RETURN_SEM_CONTEXT_ERROR_NOT_OK(GetIntValueFromExpr(rhs_, table_property_name, &int_val));
+      if (int_val < 0) {
+        return sem_context->Error(this,
+                                  Substitute("$0 must be greater than or equal to 0 (got $1)",
+                                             table_property_name, std::to_string(int_val)).c_str(),
+                                  ErrorCode::INVALID_ARGUMENTS);
+      }
+      break;
+    case KVProperty::kBlockCachePriorityClass:
+      // Tablets pick the priority class of their blocks when they are opened.
+      if (sem_context->current_alter_table() != nullptr) {
+        return sem_context->Error(this,
+                                  Substitute("$0 could not be altered", table_property_name).c_str(),
+                                  ErrorCode::FEATURE_NOT_SUPPORTED);
+      }
+      RETURN_SEM_CONTEXT_ERROR_NOT_OK(GetIntValueFromExpr(rhs_, table_property_name, &int_val));
+      if (int_val < 0 || int_val >= static_cast<int64_t>(kNumCachePriorityClasses)) {
+        return sem_context->Error(this,
+                                  Substitute("$0 must be between 0 and $1 (got $2)",
+                                             table_property_name, kNumCachePriorityClasses - 1,
+                                             std::to_string(int_val)).c_str(),
+                                  ErrorCode::INVALID_ARGUMENTS);
+      }
+      break;
     case KVProperty::kCrcCheckChance: FALLTHROUGH_INTENDED;
     case KVProperty::kDclocalReadRepairChance: FALLTHROUGH_INTENDED;
     case KVProperty::kReadRepairChance:
@@ -194,6 +261,7 @@ CHECKED_STATUS PTTableProperty::Analyze(SemContext *sem_context) {
       }
       break;
     case KVProperty::kGcGraceSeconds: FALLTHROUGH_INTENDED;
+    case KVProperty::kHistoryRetentionSeconds: FALLTHROUGH_INTENDED;
     case KVProperty::kMemtableFlushPeriodInMs:
       RETURN_SEM_CONTEXT_ERROR_NOT_OK(GetIntValueFromExpr(rhs_, table_property_name, &int_val));
       if (int_val < 0) {
@@ -203,6 +271,23 @@ CHECKED_STATUS PTTableProperty::Analyze(SemContext *sem_context) {
                                   ErrorCode::INVALID_ARGUMENTS);
       }
       break;
+    case KVProperty::kMemtableFormat:
+      // Tablets pick the representation of their memtables when they are opened.
+      if (sem_context->current_alter_table() != nullptr) {
+        return sem_context->Error(this,
+                                  Substitute("$0 could not be altered", table_property_name).c_str(),
+                                  ErrorCode::FEATURE_NOT_SUPPORTED);
+      }
+      RETURN_SEM_CONTEXT_ERROR_NOT_OK(GetStringValueFromExpr(rhs_, true, table_property_name,
+                                                             &str_val));
+      if (str_val != kMemtableFormatDefault && str_val != kMemtableFormatHashPrefix) {
+        return sem_context->Error(this,
+                                  Substitute("$0 must be '$1' or '$2' (got '$3')",
+                                             table_property_name, kMemtableFormatDefault,
+                                             kMemtableFormatHashPrefix, str_val).c_str(),
+                                  ErrorCode::INVALID_ARGUMENTS);
+      }
+      break;
     case KVProperty::kIndexInterval: FALLTHROUGH_INTENDED;
     case KVProperty::kMinIndexInterval: FALLTHROUGH_INTENDED;
     case KVProperty::kMaxIndexInterval:
@@ -371,6 +456,51 @@ Status PTTableProperty::SetTableProperty(yb::TableProperties *table_property) co
       table_property->SetDefaultTimeToLive(val * MonoTime::kMillisecondsPerSecond);
       break;
     }
+    case KVProperty::kBloomFilterRangeComponents: {
+      int64_t val;
+      if (!GetIntValueFromExpr(rhs_, table_property_name, &val).ok() || val < 0) {
+        return STATUS(InvalidArgument,
+                      Substitute("Invalid value for bloom_filter_range_components"));
+      }
+      table_property->SetNumRangeComponentsInBloomFilter(val);
+      break;
+    }
+    case KVProperty::kBloomFilterFormat: {
+      string val;
+      if (!GetStringValueFromExpr(rhs_, true, table_property_name, &val).ok() ||
+          (val != kBloomFilterFormatDefault && val != kBloomFilterFormatFastLocal)) {
+        return STATUS(InvalidArgument, Substitute("Invalid value for bloom_filter_format"));
+      }
+      table_property->SetFastLocalBloomFilter(val == kBloomFilterFormatFastLocal);
+      break;
+    }
+    case KVProperty::kBlockCachePriorityClass: {
+      int64_t val;
+      if (!GetIntValueFromExpr(rhs_, table_property_name, &val).ok() || val < 0 ||
+          val >= static_cast<int64_t>(kNumCachePriorityClasses)) {
+        return STATUS(InvalidArgument, Substitute("Invalid value for block_cache_priority_class"));
+      }
+      table_property->SetBlockCachePriorityClass(val);
+      break;
+    }
+    case KVProperty::kHistoryRetentionSeconds: {
+      int64_t val;
+      if (!GetIntValueFromExpr(rhs_, table_property_name, &val).ok() || val < 0 ||
+          val > std::numeric_limits<int32_t>::max()) {
+        return STATUS(InvalidArgument, Substitute("Invalid value for history_retention_seconds"));
+      }
+      table_property->SetHistoryRetentionInterval(static_cast<int32_t>(val));
+      break;
+    }
+    case KVProperty::kMemtableFormat: {
+      string val;
+      if (!GetStringValueFromExpr(rhs_, true, table_property_name, &val).ok() ||
+          (val != kMemtableFormatDefault && val != kMemtableFormatHashPrefix)) {
+        return STATUS(InvalidArgument, Substitute("Invalid value for memtable_format"));
+      }
+      table_property->SetHashPrefixMemTable(val == kMemtableFormatHashPrefix);
+      break;
+    }
     case KVProperty::kBloomFilterFpChance: FALLTHROUGH_INTENDED;
     case KVProperty::kComment: FALLTHROUGH_INTENDED;
     case KVProperty::kCrcCheckChance: FALLTHROUGH_INTENDED;
@@ -38,7 +38,10 @@ enum class PropertyType : int {
 class PTTableProperty : public PTProperty {
  public:
   enum class KVProperty : int {
+    kBloomFilterFormat,
     kBloomFilterFpChance,
+    kBloomFilterRangeComponents,
+    kBlockCachePriorityClass,
     kCaching,
     kComment,
     kCompaction,
@@ -47,8 +50,10 @@ class PTTableProperty : public PTProperty {
     kDclocalReadRepairChance,
     kDefaultTimeToLive,
     kGcGraceSeconds,
+    kHistoryRetentionSeconds,
     kIndexInterval,
     kMemtableFlushPeriodInMs,
+    kMemtableFormat,
     kMinIndexInterval,
     kMaxIndexInterval,
     kReadRepairChance,
@@ -107,6 +107,26 @@ void PTAssign::PrintSemanticAnalysisResult(SemContext *sem_context) {
 
 //--------------------------------------------------------------------------------------------------
 
+namespace {
+
+// Can the IF condition be true only when the row exists?
+bool RequiresExistingRow(const PTExpr* condition) {
+  if (condition == nullptr) {
+    return false;
+  }
+  switch (condition->ql_op()) {
+    case QL_OP_EXISTS:
+      return true;
+    case QL_OP_AND:
+      return RequiresExistingRow(condition->op1().get()) ||
+             RequiresExistingRow(condition->op2().get());
+    default:
+      return false;
+  }
+}
+
+} // anonymous namespace
+
 PTUpdateStmt::PTUpdateStmt(MemoryContext *memctx,
                            YBLocation::SharedPtr loc,
                            PTTableRef::SharedPtr relation,
@@ -169,6 +189,8 @@ CHECKED_STATUS PTUpdateStmt::Analyze(SemContext *sem_context) {
 
   // Analyze indexes for write operations.
   RETURN_NOT_OK(AnalyzeIndexesForWrites(sem_context));
+  keeps_indexes_if_not_null_ = !table_->index_map().empty() &&
+                               RequiresExistingRow(if_clause_.get()) && !SetsIndexedColumns();
 
   // If returning a status we always return back the whole row.
   if (returns_status_) {
@@ -24,6 +24,8 @@
 #include "yb/util/crypt.h"
 #include "yb/yql/cql/ql/test/ql-test-base.h"
 
+DECLARE_int32(cql_scan_ahead_tablets);
+
 using std::string;
 using std::unique_ptr;
 using std::shared_ptr;
@@ -840,6 +842,103 @@ TEST_F(TestQLQuery, TestPagingState) {
   }
 }
 
+// Verifies that a table scan that reads tablets ahead returns the same pages as one that reads
+// one tablet after another.
+TEST_F(TestQLQuery, TestScanAheadPaging) {
+  // Init the simulated cluster.
+  ASSERT_NO_FATALS(CreateSimulatedCluster());
+
+  // Get a processor.
+  TestQLProcessor *processor = GetQLProcessor();
+
+  CHECK_VALID_STMT("CREATE TABLE t (h int, r int, v int, primary key((h), r));");
+  static constexpr int kNumRows = 100;
+  for (int i = 1; i <= kNumRows; i++) {
+    CHECK_VALID_STMT(Substitute("INSERT INTO t (h, r, v) VALUES ($0, $1, $2);", i, i % 3, i));
+  }
+
+  // Returns the pages of the select statement, each as the string of its row block.
+  auto read_pages = [processor](const string& select_stmt, int page_size) {
+    std::vector<string> pages;
+    StatementParameters params;
+    params.set_page_size(page_size);
+    do {
+      CHECK_OK(processor->Run(select_stmt, params));
+      pages.push_back(processor->row_block()->ToString());
+      if (processor->rows_result()->paging_state().empty()) {
+        break;
+      }
+      CHECK_OK(params.set_paging_state(processor->rows_result()->paging_state()));
+    } while (true);
+    return pages;
+  };
+
+  for (const string& select_stmt : {"SELECT h, r, v FROM t;",
+                                    "SELECT h, r, v FROM t WHERE v > 10 LIMIT 53;",
+                                    "SELECT h, r, v FROM t WHERE token(h) > 0;"}) {
+    for (int page_size : {1, 7, 1000}) {
+      FLAGS_cql_scan_ahead_tablets = 0;
+      const auto expected = read_pages(select_stmt, page_size);
+      FLAGS_cql_scan_ahead_tablets = 3;
+      ASSERT_EQ(expected, read_pages(select_stmt, page_size)) << select_stmt << " " << page_size;
+    }
+  }
+}
+
+TEST_F(TestQLQuery, TestTopNOrderBy) {
+  // Init the simulated cluster.
+  ASSERT_NO_FATALS(CreateSimulatedCluster());
+
+  // Get a processor.
+  TestQLProcessor *processor = GetQLProcessor();
+
+  CHECK_VALID_STMT("CREATE TABLE t (h int, r int, v int, primary key((h), r));");
+  static constexpr int kNumRows = 100;
+  std::vector<int> values;
+  for (int i = 1; i <= kNumRows; i++) {
+    // Spreads the values over the tablets in no particular order.
+    const int v = (i * 37) % 101;
+    values.push_back(v);
+    CHECK_VALID_STMT(Substitute("INSERT INTO t (h, r, v) VALUES ($0, $1, $2);", i, i % 3, v));
+  }
+  CHECK_VALID_STMT("INSERT INTO t (h, r) VALUES (1000, 0);");
+  std::sort(values.begin(), values.end());
+
+  // The rows come in a single page whatever the page size.
+  StatementParameters params;
+  params.set_page_size(3);
+  CHECK_OK(processor->Run("SELECT h, v FROM t WHERE r < 2 ORDER BY v LIMIT 10;", params));
+  ASSERT_TRUE(processor->rows_result()->paging_state().empty());
+  std::shared_ptr<QLRowBlock> row_block = processor->row_block();
+  ASSERT_EQ(10, row_block->row_count());
+  int last = -1;
+  for (const auto& row : row_block->rows()) {
+    ASSERT_NE(2, row.column(0).int32_value() % 3);
+    ASSERT_LT(last, row.column(1).int32_value());
+    last = row.column(1).int32_value();
+  }
+
+  CHECK_VALID_STMT("SELECT * FROM t ORDER BY v LIMIT 5;");
+  row_block = processor->row_block();
+  ASSERT_EQ(5, row_block->row_count());
+  for (int i = 0; i != 5; i++) {
+    ASSERT_EQ(values[i], row_block->row(i).column(2).int32_value());
+  }
+
+  // The null value comes first in descending order.
+  CHECK_VALID_STMT("SELECT v, h FROM t ORDER BY v DESC LIMIT 4;");
+  row_block = processor->row_block();
+  ASSERT_EQ(4, row_block->row_count());
+  ASSERT_TRUE(row_block->row(0).column(0).IsNull());
+  for (int i = 1; i != 4; i++) {
+    ASSERT_EQ(values[kNumRows - i], row_block->row(i).column(0).int32_value());
+  }
+
+  CHECK_INVALID_STMT("SELECT h, v FROM t ORDER BY v;");
+  CHECK_INVALID_STMT("SELECT h FROM t ORDER BY v LIMIT 10;");
+  CHECK_INVALID_STMT("SELECT h, v FROM t ORDER BY v LIMIT 10 OFFSET 2;");
+}
+
 #define RUN_PAGINATION_WITH_DESC_TEST(processor, type, values, rows)                               \
 do {                                                                                               \
   /* Creating the table. */                                                                        \
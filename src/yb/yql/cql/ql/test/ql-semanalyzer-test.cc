@@ -381,6 +381,59 @@ TEST_F(QLTestAnalyzer, TestCreateLocalIndex) {
 }
 
 
+TEST_F(QLTestAnalyzer, TestJsonIndexSelection) {
+  CreateSimulatedCluster();
+  TestQLProcessor *processor = GetQLProcessor();
+  EXPECT_OK(processor->Run("CREATE TABLE t (k int PRIMARY KEY, j jsonb) "
+                           "with transactions = {'enabled':true};"));
+  EXPECT_OK(processor->Run("CREATE INDEX i ON t (j->'a'->>'b');"));
+
+  client::YBTableName table_name(kDefaultKeyspaceName, "t");
+  processor->RemoveCachedTableDesc(table_name);
+
+  // The index holds the element at the path rather than the document, so it does not cover the
+  // jsonb column.
+  TestIndexSelection("SELECT k FROM t WHERE j->'a'->>'b' = 'x'", true, false);
+  TestIndexSelection("SELECT * FROM t WHERE j->'a'->>'b' = 'x'", true, false);
+
+  // Other paths are not indexed.
+  TestIndexSelection("SELECT * FROM t WHERE j->'a'->>'c' = 'x'", false, false);
+  TestIndexSelection("SELECT * FROM t WHERE j->>'a' = 'x'", false, false);
+  TestIndexSelection("SELECT * FROM t WHERE j->'b'->>'b' = 'x'", false, false);
+}
+
+TEST_F(QLTestAnalyzer, TestConditionalUpdateKeepsIndexes) {
+  CreateSimulatedCluster();
+  TestQLProcessor *processor = GetQLProcessor();
+  EXPECT_OK(processor->Run("CREATE TABLE t (k int PRIMARY KEY, v1 int, v2 int, v3 int) "
+                           "with transactions = {'enabled':true};"));
+  EXPECT_OK(processor->Run("CREATE INDEX i ON t (v1) INCLUDE (v2);"));
+
+  client::YBTableName table_name(kDefaultKeyspaceName, "t");
+  processor->RemoveCachedTableDesc(table_name);
+
+  auto keeps_indexes = [this](const string& update_stmt) {
+    ParseTree::UniPtr parse_tree;
+    EXPECT_OK(TestAnalyzer(update_stmt, &parse_tree));
+    auto pt_update_stmt = std::dynamic_pointer_cast<PTUpdateStmt>(parse_tree->root());
+    CHECK_NOTNULL(pt_update_stmt.get());
+    EXPECT_EQ(pt_update_stmt->KeepsIndexesIfNotNull(), !pt_update_stmt->RequiresTransaction())
+        << update_stmt;
+    return pt_update_stmt->KeepsIndexesIfNotNull();
+  };
+
+  EXPECT_TRUE(keeps_indexes("UPDATE t SET v3 = 1 WHERE k = 1 IF EXISTS;"));
+  EXPECT_TRUE(keeps_indexes("UPDATE t SET v3 = 1 WHERE k = 1 IF EXISTS AND v3 = 0;"));
+  EXPECT_TRUE(keeps_indexes("UPDATE t SET v3 = 1 WHERE k = 1 IF v1 = 0 AND EXISTS;"));
+
+  // The row may be created.
+  EXPECT_FALSE(keeps_indexes("UPDATE t SET v3 = 1 WHERE k = 1;"));
+  EXPECT_FALSE(keeps_indexes("UPDATE t SET v3 = 1 WHERE k = 1 IF v3 = 0;"));
+  // Indexed and covering columns change the index entries.
+  EXPECT_FALSE(keeps_indexes("UPDATE t SET v1 = 1 WHERE k = 1 IF EXISTS;"));
+  EXPECT_FALSE(keeps_indexes("UPDATE t SET v2 = 1 WHERE k = 1 IF EXISTS;"));
+}
+
 TEST_F(QLTestAnalyzer, TestIndexSelection) {
   CreateSimulatedCluster();
   TestQLProcessor *processor = GetQLProcessor();
@@ -134,6 +134,9 @@ class RowsResult : public ExecutedResult {
   // Accessor functions.
   const client::YBTableName& table_name() const { return table_name_; }
   const std::vector<ColumnSchema>& column_schemas() const { return *column_schemas_; }
+  const std::shared_ptr<std::vector<ColumnSchema>>& column_schemas_ptr() const {
+    return column_schemas_;
+  }
   void set_column_schema(int col_index, const std::shared_ptr<QLType>& type) {
     (*column_schemas_)[col_index].set_type(type);
   }
@@ -279,13 +279,32 @@ PgCreateIndex::PgCreateIndex(PgSession::ScopedRefPtr pg_session,
 PgCreateIndex::~PgCreateIndex() {
 }
 
-Status PgCreateIndex::Exec() {
+Status PgCreateIndex::AddColumn(const char *attr_name, int attr_num, int attr_ybtype,
+                                bool is_hash, bool is_range) {
+  // The columns of a table are ordered as hash, range and then regular columns, so ybbasectid is
+  // added before the first INCLUDE column.
+  if (!is_hash && !is_range) {
+    RETURN_NOT_OK(AddYBbasectidColumn());
+  }
+  return PgCreateTable::AddColumn(attr_name, attr_num, attr_ybtype, is_hash, is_range);
+}
+
+Status PgCreateIndex::AddYBbasectidColumn() {
+  if (ybbasectid_added_) {
+    return Status::OK();
+  }
   // Add ybbasectid column to store the ybctid of the rows in the indexed table.
-  RETURN_NOT_OK(AddColumn("ybbasectid",
-                          static_cast<int32_t>(PgSystemAttrNum::kYBBaseTupleId),
-                          YB_YQL_DATA_TYPE_BINARY,
-                          false /* is_hash */,
-                          !is_unique_index_  /* is_range */));
+  RETURN_NOT_OK(PgCreateTable::AddColumn("ybbasectid",
+                                         static_cast<int32_t>(PgSystemAttrNum::kYBBaseTupleId),
+                                         YB_YQL_DATA_TYPE_BINARY,
+                                         false /* is_hash */,
+                                         !is_unique_index_  /* is_range */));
+  ybbasectid_added_ = true;
+  return Status::OK();
+}
+
+Status PgCreateIndex::Exec() {
+  RETURN_NOT_OK(AddYBbasectidColumn());
   return PgCreateTable::Exec();
 }
 
@@ -177,8 +177,8 @@ class PgCreateTable : public PgDdl {
   virtual boost::optional<const PgObjectId&> indexed_table_id() const { return boost::none; }
   virtual bool is_unique_index() const { return false; }
 
-  CHECKED_STATUS AddColumn(const char *attr_name, int attr_num, int attr_ybtype,
-                           bool is_hash, bool is_range);
+  virtual CHECKED_STATUS AddColumn(const char *attr_name, int attr_num, int attr_ybtype,
+                                   bool is_hash, bool is_range);
   CHECKED_STATUS AddColumn(const char *attr_name, int attr_num, const YBCPgTypeEntity *attr_type,
                            bool is_hash, bool is_range) {
     return AddColumn(attr_name, attr_num, attr_type->yb_type, is_hash, is_range);
@@ -276,12 +276,21 @@ class PgCreateIndex : public PgCreateTable {
     return is_unique_index_;
   }
 
+  // Columns that are neither hash nor range columns are the INCLUDE columns of a covering index.
+  using PgCreateTable::AddColumn;
+  virtual CHECKED_STATUS AddColumn(const char *attr_name, int attr_num, int attr_ybtype,
+                                   bool is_hash, bool is_range) override;
+
   // Execute.
   virtual CHECKED_STATUS Exec() override;
 
  private:
+  // Add the ybbasectid column, which is a range column of a non-unique index.
+  CHECKED_STATUS AddYBbasectidColumn();
+
   const PgObjectId base_table_id_;
   bool is_unique_index_;
+  bool ybbasectid_added_ = false;
 };
 
 }  // namespace pggate
@@ -270,6 +270,29 @@ Status PgDml::Fetch(int32_t natts,
   return Status::OK();
 }
 
+Status PgDml::FetchBatch(int32_t natts,
+                         int32_t max_rows,
+                         uint64_t *values,
+                         bool *isnulls,
+                         PgSysColumns *syscols,
+                         int32_t *nrows) {
+  *nrows = 0;
+  while (*nrows < max_rows && (*nrows == 0 || !cursor_.empty())) {
+    const int32_t offset = *nrows * natts;
+    bool has_data = false;
+    RETURN_NOT_OK(Fetch(natts,
+                        values ? values + offset : nullptr,
+                        isnulls ? isnulls + offset : nullptr,
+                        syscols ? syscols + *nrows : nullptr,
+                        &has_data));
+    if (!has_data) {
+      break;
+    }
+    ++*nrows;
+  }
+  return Status::OK();
+}
+
 Status PgDml::WritePgTuple(PgTuple *pg_tuple) {
   for (const PgExpr *target : targets_) {
     if (target->opcode() != PgColumnRef::Opcode::PG_EXPR_COLREF) {
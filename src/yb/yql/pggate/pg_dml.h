@@ -58,6 +58,16 @@ class PgDml : public PgStatement {
                        bool *isnulls,
                        PgSysColumns *syscols,
                        bool *has_data);
+
+  // Fetch up to max_rows rows, stored one after the other in the layout of Fetch(). Only the first
+  // row might wait for DocDB, the others are those already received, so nrows is 0 only at the end
+  // of the result.
+  CHECKED_STATUS FetchBatch(int32_t natts,
+                            int32_t max_rows,
+                            uint64_t *values,
+                            bool *isnulls,
+                            PgSysColumns *syscols,
+                            int32_t *nrows);
   CHECKED_STATUS WritePgTuple(PgTuple *pg_tuple);
 
  protected:
@@ -14,6 +14,48 @@
 
 #include "yb/yql/pggate/pg_doc_op.h"
 
+#include <algorithm>
+
+#include <gflags/gflags.h>
+
+#include "yb/common/partition.h"
+#include "yb/common/ql_protocol_util.h"
+
+#include "yb/util/flag_tags.h"
+#include "yb/util/random_util.h"
+#include "yb/util/size_literals.h"
+
+using namespace yb::size_literals;
+
+DEFINE_int32(pggate_prefetch_pages, 2,
+             "Maximum number of result pages of a scan that pggate requests ahead of the rows "
+             "consumed by PostgreSQL. 0 requests a page only when the previous one is consumed.");
+TAG_FLAG(pggate_prefetch_pages, advanced);
+
+DEFINE_int64(pggate_prefetch_max_bytes, 16_MB,
+             "Pages of a scan are not prefetched while the pages received and not yet consumed by "
+             "PostgreSQL take at least this many bytes.");
+TAG_FLAG(pggate_prefetch_max_bytes, advanced);
+
+DEFINE_int32(pggate_scan_parallelism, 4,
+             "Maximum number of tablets that a full scan of a hash partitioned table reads in "
+             "parallel. 1 reads the tablets one after another.");
+TAG_FLAG(pggate_scan_parallelism, advanced);
+
+DEFINE_bool(pggate_parallel_scan_preserve_order, true,
+            "Whether a scan that reads tablets in parallel returns the rows in partition order, "
+            "as a scan reading the tablets one after another does. Otherwise the pages of the "
+            "tablets are returned in the order they are received.");
+TAG_FLAG(pggate_parallel_scan_preserve_order, advanced);
+
+DEFINE_int32(pggate_slow_scan_log_threshold_ms, 0,
+             "Scans whose responses take longer than this many milliseconds to come are logged, "
+             "with the DocDB execution statistics of the requests: RocksDB seeks and nexts, "
+             "blocks read, intents encountered, and rows scanned and returned. 0 disables the "
+             "log, and the statistics are not gathered.");
+TAG_FLAG(pggate_slow_scan_log_threshold_ms, advanced);
+TAG_FLAG(pggate_slow_scan_log_threshold_ms, runtime);
+
 using std::shared_ptr;
 
 namespace yb {
@@ -118,6 +160,13 @@ void PgDocOp::ReadFromCacheUnlocked(string *result) {
   }
 }
 
+Status PgDocOp::FailedOperationStatus(const client::YBPgsqlOp& op) {
+  if (op.response().status() == PgsqlResponsePB::PGSQL_STATUS_SCHEMA_VERSION_MISMATCH) {
+    pg_session_->InvalidateTableCache(op.table()->id());
+  }
+  return STATUS(QLError, op.response().error_message());
+}
+
 Status PgDocOp::SendRequestIfNeededUnlocked() {
   // Request more data if more execution is needed and cache is empty.
   if (!has_cached_data_ && !end_of_data_ && !waiting_for_response_) {
@@ -134,18 +183,56 @@ PgDocReadOp::PgDocReadOp(
 }
 
 PgDocReadOp::~PgDocReadOp() {
+  std::lock_guard<std::mutex> lock(mtx_);
+  LogIfSlowScanUnlocked();
 }
 
 void PgDocReadOp::InitUnlocked(std::unique_lock<std::mutex>* lock) {
   PgDocOp::InitUnlocked(lock);
+  LogIfSlowScanUnlocked();
 
   PgsqlReadRequestPB *req = read_op_->mutable_request();
   req->set_limit(kPrefetchLimit);
   req->set_return_paging_state(true);
+  req->set_return_execution_stats(FLAGS_pggate_slow_scan_log_threshold_ms > 0);
+  start_time_ = MonoTime::Now();
+  last_response_time_ = MonoTime();
+  execution_stats_.Clear();
+  prefetch_session_.reset();
+  sample_rows_.clear();
+  sample_num_rows_ = 0;
+  sample_null_counts_.clear();
+  sample_sketches_.clear();
+  for (const auto& op : in_value_ops_) {
+    PgsqlReadRequestPB *op_req = op->mutable_request();
+    op_req->set_limit(kPrefetchLimit);
+    op_req->set_return_paging_state(true);
+    op_req->set_return_execution_stats(req->return_execution_stats());
+    op_req->clear_paging_state();
+  }
+  in_value_ops_to_send_ = in_value_ops_;
+  if (in_value_ops_.empty()) {
+    PrepareTabletScansUnlocked();
+  }
+}
+
+void PgDocReadOp::SetInValueOps(std::vector<std::shared_ptr<client::YBPgsqlReadOp>> ops) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  in_value_ops_ = std::move(ops);
 }
 
 Status PgDocReadOp::SendRequestUnlocked() {
+  if (!in_value_ops_.empty()) {
+    return SendInValueOpsUnlocked();
+  }
+  if (!tablet_scans_.empty()) {
+    return SendTabletScansUnlocked();
+  }
+
   RETURN_NOT_OK(pg_session_->PgApplyAsync(read_op_, read_time_));
+  if (FLAGS_pggate_prefetch_pages > 0 && !prefetch_session_) {
+    prefetch_session_ = VERIFY_RESULT(pg_session_->GetSessionForOp(read_op_))->shared_from_this();
+  }
   waiting_for_response_ = true;
   RETURN_NOT_OK(
       pg_session_->PgFlushAsync([this](const Status& s) { PgDocReadOp::ReceiveResponse(s); }));
@@ -158,28 +245,382 @@ void PgDocReadOp::ReceiveResponse(Status exec_status) {
   cv_.notify_all();
   waiting_for_response_ = false;
   exec_status_ = exec_status;
+  if (exec_status_.ok() && !read_op_->succeeded()) {
+    exec_status_ = FailedOperationStatus(*read_op_);
+  }
 
-  if (!exec_status.ok()) {
+  if (!exec_status_.ok()) {
     end_of_data_ = true;
     return;
   }
 
   if (!is_canceled_) {
+    AddExecutionStatsUnlocked(read_op_->response());
+
     // Save it to cache.
     WriteToCacheUnlocked(read_op_);
+    exec_status_ = MergeSampleUnlocked(read_op_->response());
 
     // Setup request for the next batch of data.
     const PgsqlResponsePB& res = read_op_->response();
-     if (res.has_paging_state()) {
+    if (!exec_status_.ok()) {
+      end_of_data_ = true;
+    } else if (res.has_paging_state()) {
       PgsqlReadRequestPB *req = read_op_->mutable_request();
       // Set up paging state for next request.
       *req->mutable_paging_state() = res.paging_state();
     } else {
       end_of_data_ = true;
+      FinishSampleUnlocked();
     }
   } else {
     end_of_data_ = true;
   }
+
+  if (ShouldPrefetchUnlocked()) {
+    // The rows are copied to the cache, so the operation could be sent again right away. The
+    // lock is released first, because a failed flush could call back on this thread.
+    waiting_for_response_ = true;
+    lock.unlock();
+    VLOG(2) << __PRETTY_FUNCTION__ << ": Prefetching next page for " << this;
+    Status s = prefetch_session_->ApplyAndFlushIsolatedAsync(
+        read_op_, [this](const Status& s) { PgDocReadOp::ReceiveResponse(s); });
+    if (!s.ok()) {
+      PgDocReadOp::ReceiveResponse(s);
+    }
+  }
+}
+
+Status PgDocReadOp::SendInValueOpsUnlocked() {
+  // The session groups the operations by tablet, so the values that are in the same tablet are
+  // read with one request.
+  for (const auto& op : in_value_ops_to_send_) {
+    RETURN_NOT_OK(pg_session_->PgApplyAsync(op, read_time_));
+  }
+  waiting_for_response_ = true;
+  Status s = pg_session_->PgFlushAsync(
+      [this](const Status& s) { PgDocReadOp::ReceiveInValueOpsResponse(s); });
+  if (!s.ok()) {
+    waiting_for_response_ = false;
+  }
+  return s;
+}
+
+void PgDocReadOp::ReceiveInValueOpsResponse(Status exec_status) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  CHECK(waiting_for_response_);
+  cv_.notify_all();
+  waiting_for_response_ = false;
+  exec_status_ = exec_status;
+  for (const auto& op : in_value_ops_to_send_) {
+    if (exec_status_.ok() && !op->succeeded()) {
+      exec_status_ = FailedOperationStatus(*op);
+    }
+  }
+  if (!exec_status_.ok() || is_canceled_) {
+    end_of_data_ = true;
+    return;
+  }
+
+  std::vector<std::shared_ptr<client::YBPgsqlReadOp>> ops_to_send;
+  for (const auto& op : in_value_ops_to_send_) {
+    AddExecutionStatsUnlocked(op->response());
+    WriteToCacheUnlocked(op);
+    if (op->response().has_paging_state()) {
+      *op->mutable_request()->mutable_paging_state() = op->response().paging_state();
+      ops_to_send.push_back(op);
+    }
+  }
+  in_value_ops_to_send_ = std::move(ops_to_send);
+  end_of_data_ = in_value_ops_to_send_.empty();
+}
+
+bool PgDocReadOp::ShouldPrefetchUnlocked() const {
+  if (end_of_data_ || is_canceled_ || !prefetch_session_ || FLAGS_pggate_prefetch_pages <= 0 ||
+      result_cache_.size() >= static_cast<size_t>(FLAGS_pggate_prefetch_pages)) {
+    return false;
+  }
+  int64_t cached_bytes = 0;
+  for (const auto& page : result_cache_) {
+    cached_bytes += page.size();
+  }
+  return cached_bytes < FLAGS_pggate_prefetch_max_bytes;
+}
+
+void PgDocReadOp::PrepareTabletScansUnlocked() {
+  tablet_scans_.clear();
+  tablet_scans_in_flight_ = 0;
+  first_unfinished_scan_ = 0;
+  preserve_order_ = FLAGS_pggate_parallel_scan_preserve_order;
+
+  // Only full forward scans are split. The other scans read a single tablet, or should see the
+  // tablets in key order.
+  const PgsqlReadRequestPB& req = read_op_->request();
+  const client::YBTable* table = read_op_->table();
+  if (FLAGS_pggate_scan_parallelism <= 1 ||
+      !req.partition_column_values().empty() ||
+      !req.ybctid_column_value().value().binary_value().empty() ||
+      req.has_hash_code() || req.has_max_hash_code() || req.has_index_request() ||
+      !req.is_forward_scan() || !table->partition_schema().IsHashPartitioning()) {
+    return;
+  }
+  const auto& partitions = table->GetPartitions();
+  if (partitions.size() <= 1) {
+    return;
+  }
+
+  tablet_scans_.resize(partitions.size());
+  for (size_t i = 0; i != partitions.size(); ++i) {
+    auto& scan = tablet_scans_[i];
+    scan.op = read_op_->DeepCopy();
+    PgsqlReadRequestPB* scan_req = scan.op->mutable_request();
+    scan_req->clear_paging_state();
+    if (!partitions[i].empty()) {
+      scan_req->set_hash_code(PartitionSchema::DecodeMultiColumnHashValue(partitions[i]));
+    }
+    if (i + 1 != partitions.size()) {
+      scan.partition_key_end = partitions[i + 1];
+    }
+  }
+  VLOG(1) << __PRETTY_FUNCTION__ << ": Scanning " << tablet_scans_.size()
+          << " tablets in parallel for " << this;
+}
+
+Status PgDocReadOp::SendTabletScansUnlocked() {
+  if (!prefetch_session_) {
+    prefetch_session_ = VERIFY_RESULT(pg_session_->PrepareIsolatedRead(read_op_, read_time_));
+  }
+  for (auto index : PickTabletScansUnlocked()) {
+    Status s = SendTabletScan(index);
+    if (!s.ok()) {
+      tablet_scans_[index].in_flight = false;
+      --tablet_scans_in_flight_;
+      waiting_for_response_ = tablet_scans_in_flight_ != 0;
+      exec_status_ = s;
+      end_of_data_ = true;
+      return s;
+    }
+  }
+  return Status::OK();
+}
+
+std::vector<size_t> PgDocReadOp::PickTabletScansUnlocked() {
+  std::vector<size_t> result;
+  if (end_of_data_ || is_canceled_) {
+    return result;
+  }
+  int64_t buffered_bytes = 0;
+  for (const auto& page : result_cache_) {
+    buffered_bytes += page.size();
+  }
+  for (const auto& scan : tablet_scans_) {
+    for (const auto& page : scan.pages) {
+      buffered_bytes += page.size();
+    }
+  }
+  const size_t parallelism = std::max(FLAGS_pggate_scan_parallelism, 1);
+  for (size_t i = first_unfinished_scan_;
+       i != tablet_scans_.size() && tablet_scans_in_flight_ < parallelism; ++i) {
+    auto& scan = tablet_scans_[i];
+    if (scan.in_flight || scan.done) {
+      continue;
+    }
+    // The scan whose pages are returned next is requested regardless of the buffered pages,
+    // otherwise the pages buffered for the later scans could stall the whole scan.
+    const bool next_in_order = preserve_order_ && i == first_unfinished_scan_;
+    if (buffered_bytes >= FLAGS_pggate_prefetch_max_bytes && !next_in_order) {
+      break;
+    }
+    scan.in_flight = true;
+    ++tablet_scans_in_flight_;
+    result.push_back(i);
+  }
+  waiting_for_response_ = tablet_scans_in_flight_ != 0;
+  return result;
+}
+
+Status PgDocReadOp::SendTabletScan(size_t index) {
+  return prefetch_session_->ApplyAndFlushIsolatedAsync(
+      tablet_scans_[index].op,
+      [this, index](const Status& s) { PgDocReadOp::ReceiveTabletResponse(index, s); });
+}
+
+void PgDocReadOp::ReceiveTabletResponse(size_t index, Status exec_status) {
+  std::unique_lock<std::mutex> lock(mtx_);
+  auto& scan = tablet_scans_[index];
+  CHECK(scan.in_flight);
+  scan.in_flight = false;
+  --tablet_scans_in_flight_;
+  waiting_for_response_ = tablet_scans_in_flight_ != 0;
+  cv_.notify_all();
+
+  if (exec_status.ok() && !scan.op->succeeded()) {
+    exec_status = FailedOperationStatus(*scan.op);
+  }
+  if (!exec_status.ok()) {
+    exec_status_ = exec_status;
+    end_of_data_ = true;
+    return;
+  }
+  if (is_canceled_ || end_of_data_) {
+    end_of_data_ = true;
+    return;
+  }
+  AddExecutionStatsUnlocked(scan.op->response());
+  exec_status_ = MergeSampleUnlocked(scan.op->response());
+  if (!exec_status_.ok()) {
+    end_of_data_ = true;
+    return;
+  }
+
+  const string& rows_data = scan.op->rows_data();
+  if (!rows_data.empty()) {
+    if (preserve_order_ && index != first_unfinished_scan_) {
+      scan.pages.push_back(rows_data);
+    } else {
+      result_cache_.push_back(rows_data);
+    }
+  }
+
+  // The tablet returns the start key of the next tablet when it is done, which is read by
+  // another scan.
+  const PgsqlResponsePB& res = scan.op->response();
+  if (res.has_paging_state() &&
+      (scan.partition_key_end.empty() ||
+       res.paging_state().next_partition_key() < scan.partition_key_end)) {
+    *scan.op->mutable_request()->mutable_paging_state() = res.paging_state();
+  } else {
+    scan.done = true;
+  }
+  AdvanceTabletScansUnlocked();
+
+  auto indexes = PickTabletScansUnlocked();
+  if (indexes.empty()) {
+    return;
+  }
+  // A failed send calls back on this thread, so the lock is released first.
+  lock.unlock();
+  for (auto i : indexes) {
+    Status s = SendTabletScan(i);
+    if (!s.ok()) {
+      PgDocReadOp::ReceiveTabletResponse(i, s);
+    }
+  }
+}
+
+void PgDocReadOp::AdvanceTabletScansUnlocked() {
+  while (first_unfinished_scan_ != tablet_scans_.size()) {
+    auto& scan = tablet_scans_[first_unfinished_scan_];
+    result_cache_.splice(result_cache_.end(), scan.pages);
+    if (!scan.done) {
+      break;
+    }
+    ++first_unfinished_scan_;
+  }
+  has_cached_data_ = !result_cache_.empty();
+  if (first_unfinished_scan_ == tablet_scans_.size()) {
+    end_of_data_ = true;
+    FinishSampleUnlocked();
+  }
+}
+
+Status PgDocReadOp::MergeSampleUnlocked(const PgsqlResponsePB& response) {
+  if (!response.has_sample_result()) {
+    return Status::OK();
+  }
+  const PgsqlSampleResultPB& sample = response.sample_result();
+  const uint64_t old_rows = sample_num_rows_;
+  const uint64_t new_rows = sample.num_rows();
+  const uint64_t merged_size =
+      std::min<uint64_t>(read_op_->request().sample_size(), old_rows + new_rows);
+
+  // A uniform sample of all the rows draws the rows one by one without replacement, so each draw
+  // is from the rows of the tablet with the probability of the share of its rows not drawn yet.
+  // Both samples are uniform, so the rows drawn from each side could be taken from its sample.
+  uint64_t num_new = 0;
+  for (uint64_t i = 0; i != merged_size; ++i) {
+    if (RandomUniformInt<uint64_t>(0, old_rows + new_rows - i - 1) < new_rows - num_new) {
+      ++num_new;
+    }
+  }
+  SCHECK_LE(num_new, static_cast<uint64_t>(sample.rows_size()), IllegalState,
+            "Sample of a tablet is too small");
+  SCHECK_LE(merged_size - num_new, sample_rows_.size(), IllegalState,
+            "Sample of the tablets read is too small");
+  std::shuffle(sample_rows_.begin(), sample_rows_.end(), ThreadLocalRandom());
+  sample_rows_.resize(merged_size - num_new);
+  // The tablet returns its sample in a random order, so any of its prefixes is a uniform sample.
+  for (uint64_t i = 0; i != num_new; ++i) {
+    sample_rows_.push_back(sample.rows(i));
+  }
+  sample_num_rows_ += new_rows;
+
+  // A tablet without rows does not return the statistics of the targets.
+  if (sample.column_stats_size() == 0) {
+    return Status::OK();
+  }
+  if (sample_sketches_.empty()) {
+    sample_null_counts_.resize(sample.column_stats_size());
+    sample_sketches_.resize(sample.column_stats_size());
+  }
+  SCHECK_EQ(static_cast<size_t>(sample.column_stats_size()), sample_sketches_.size(),
+            IllegalState, "Different number of targets in the samples of the tablets");
+  for (size_t i = 0; i != sample_sketches_.size(); ++i) {
+    const PgsqlColumnStatsPB& column_stats = sample.column_stats(i);
+    sample_null_counts_[i] += column_stats.null_count();
+    RETURN_NOT_OK(sample_sketches_[i].Merge(
+        VERIFY_RESULT(HyperLogLog::FromRegisters(column_stats.distinct_sketch()))));
+  }
+  return Status::OK();
+}
+
+void PgDocReadOp::FinishSampleUnlocked() {
+  if (!read_op_->request().has_sample_size()) {
+    return;
+  }
+  // The order of the rows drawn from each tablet is not random after a merge.
+  std::shuffle(sample_rows_.begin(), sample_rows_.end(), ThreadLocalRandom());
+  result_cache_.insert(result_cache_.end(), sample_rows_.begin(), sample_rows_.end());
+  sample_rows_.clear();
+  has_cached_data_ = !result_cache_.empty();
+}
+
+Result<PgDocReadOp::SampleStats> PgDocReadOp::GetSampleStats() const {
+  std::lock_guard<std::mutex> lock(mtx_);
+  RETURN_NOT_OK(exec_status_);
+  if (!end_of_data_) {
+    return STATUS(IllegalState, "Sampling scan is not done");
+  }
+  SampleStats stats;
+  stats.num_rows = sample_num_rows_;
+  stats.null_counts = sample_null_counts_;
+  stats.distinct_counts.reserve(sample_sketches_.size());
+  for (const auto& sketch : sample_sketches_) {
+    stats.distinct_counts.push_back(sketch.Estimate());
+  }
+  return stats;
+}
+
+void PgDocReadOp::AddExecutionStatsUnlocked(const PgsqlResponsePB& response) {
+  last_response_time_ = MonoTime::Now();
+  if (response.has_execution_stats()) {
+    AddExecutionStats(response.execution_stats(), &execution_stats_);
+  }
+}
+
+void PgDocReadOp::LogIfSlowScanUnlocked() {
+  const int32_t threshold_ms = FLAGS_pggate_slow_scan_log_threshold_ms;
+  if (threshold_ms <= 0 || !last_response_time_.Initialized()) {
+    return;
+  }
+  const auto elapsed_ms = (last_response_time_ - start_time_).ToMilliseconds();
+  if (elapsed_ms >= threshold_ms) {
+    LOG(WARNING) << "Slow scan of " << read_op_->table()->name().ToString() << " took "
+                 << elapsed_ms << "ms, DocDB stats: { " << execution_stats_.ShortDebugString()
+                 << " }";
+  }
+  // Logged once per execution.
+  last_response_time_ = MonoTime();
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -194,6 +635,13 @@ PgDocWriteOp::~PgDocWriteOp() {
 Status PgDocWriteOp::SendRequestUnlocked() {
   CHECK(!waiting_for_response_);
 
+  if (VERIFY_RESULT(pg_session_->BufferWriteOperation(write_op_))) {
+    // A buffered write returns no rows, its errors are reported when it is sent.
+    end_of_data_ = true;
+    VLOG(1) << __PRETTY_FUNCTION__ << ": Buffered request for " << this;
+    return Status::OK();
+  }
+
   RETURN_NOT_OK(pg_session_->PgApplyAsync(write_op_, read_time_));
   waiting_for_response_ = true;
   Status s = pg_session_->PgFlushAsync([this](const Status& s) {
@@ -214,7 +662,7 @@ void PgDocWriteOp::ReceiveResponse(Status exec_status) {
   cv_.notify_all();
 
   if (exec_status.ok() && !write_op_->succeeded()) {
-    exec_status_ = STATUS(QLError, write_op_->response().error_message());
+    exec_status_ = FailedOperationStatus(*write_op_);
   } else {
     exec_status_ = exec_status;
   }
@@ -18,6 +18,7 @@
 #include <mutex>
 #include <condition_variable>
 
+#include "yb/util/hyperloglog.h"
 #include "yb/util/locks.h"
 #include "yb/client/yb_op.h"
 #include "yb/yql/pggate/pg_session.h"
@@ -63,6 +64,10 @@ class PgDocOp {
   void WriteToCacheUnlocked(std::shared_ptr<client::YBPgsqlOp> yb_op);
   void ReadFromCacheUnlocked(string* result);
 
+  // Returns the error of an operation that DocDB did not run. When the request had an old schema
+  // version, the table is also evicted from the table cache, so the next statement reloads it.
+  Status FailedOperationStatus(const client::YBPgsqlOp& op);
+
   // Send another request if no request is pending and we've already consumed
   // all data in the cache.
   CHECKED_STATUS SendRequestIfNeededUnlocked();
@@ -118,14 +123,119 @@ class PgDocReadOp : public PgDocOp {
     return read_op_;
   }
 
+  // Sets the operations that are sent in place of read_op_ by the next execution, one for each
+  // value of a key column bound to a list of values.
+  void SetInValueOps(std::vector<std::shared_ptr<client::YBPgsqlReadOp>> ops);
+
+  // Statistics of a sampling scan over all the rows read: the number of rows, and for each target
+  // the number of rows where it is null and the estimated number of its distinct non-null values.
+  struct SampleStats {
+    uint64_t num_rows = 0;
+    std::vector<uint64_t> null_counts;
+    std::vector<double> distinct_counts;
+  };
+
+  // Returns the statistics of a sampling scan, once it has returned all its rows.
+  Result<SampleStats> GetSampleStats() const;
+
  private:
   // Process response from DocDB.
   void InitUnlocked(std::unique_lock<std::mutex>* lock) override;
   CHECKED_STATUS SendRequestUnlocked() override;
   virtual void ReceiveResponse(Status exec_status);
 
+  // Whether the next page should be requested as soon as the previous one is received, before
+  // the cached pages are consumed.
+  bool ShouldPrefetchUnlocked() const;
+
+  // A full scan of a hash partitioned table is split into one scan per tablet, so that several
+  // tablets could be read in parallel.
+  struct TabletScan {
+    std::shared_ptr<client::YBPgsqlReadOp> op;
+    // The exclusive end partition key of the tablet, empty for the last tablet.
+    std::string partition_key_end;
+    bool in_flight = false;
+    bool done = false;
+    // Pages received ahead of the pages of the previous tablets, when the order is preserved.
+    std::list<string> pages;
+  };
+
+  // Sends the operations of the values that are not done yet, in one flush.
+  CHECKED_STATUS SendInValueOpsUnlocked();
+
+  // Process the response of the operations of the values.
+  void ReceiveInValueOpsResponse(Status exec_status);
+
+  // Splits the scan into tablet scans if it could be read in parallel.
+  void PrepareTabletScansUnlocked();
+
+  // Sends the requests of the tablet scans that should be in flight now.
+  CHECKED_STATUS SendTabletScansUnlocked();
+
+  // Marks the tablet scans that should be requested now as in flight and returns their indexes.
+  // The scans are limited by --pggate_scan_parallelism and by the bytes of the pages buffered.
+  std::vector<size_t> PickTabletScansUnlocked();
+
+  // Sends the request of the tablet scan with the given index.
+  CHECKED_STATUS SendTabletScan(size_t index);
+
+  // Process the response of the tablet scan with the given index.
+  void ReceiveTabletResponse(size_t index, Status exec_status);
+
+  // Moves the pages that are next in order to the cache, and skips the tablet scans that are done.
+  void AdvanceTabletScansUnlocked();
+
+  // Merges the sample of a tablet of a sampling scan into the sample of the tablets read before.
+  CHECKED_STATUS MergeSampleUnlocked(const PgsqlResponsePB& response);
+
+  // Moves the sample of a sampling scan to the cache, once all the tablets are read.
+  void FinishSampleUnlocked();
+
+  // Adds the execution statistics of a response to those of the scan.
+  void AddExecutionStatsUnlocked(const PgsqlResponsePB& response);
+
+  // Logs the last execution of the scan with its DocDB execution statistics, if the responses
+  // took longer than --pggate_slow_scan_log_threshold_ms to come.
+  void LogIfSlowScanUnlocked();
+
   // Operator.
   std::shared_ptr<client::YBPgsqlReadOp> read_op_;
+
+  // Session that the next pages are prefetched with. The pages are requested from the thread
+  // that receives the previous page, so they are sent with YBSession::ApplyAndFlushIsolatedAsync,
+  // which does not touch the operations that the PgSession buffers. The tablet scans are sent
+  // with it as well.
+  client::YBSessionPtr prefetch_session_;
+
+  // Operations of the values of a key column bound to a list of values, in the order of the
+  // values, and those of them that have more rows to read.
+  std::vector<std::shared_ptr<client::YBPgsqlReadOp>> in_value_ops_;
+  std::vector<std::shared_ptr<client::YBPgsqlReadOp>> in_value_ops_to_send_;
+
+  // Tablet scans in partition order, empty when the scan pages through the tablets one by one.
+  std::vector<TabletScan> tablet_scans_;
+  size_t tablet_scans_in_flight_ = 0;
+
+  // The first tablet scan that is not done. When the order is preserved, only its pages are moved
+  // to the cache.
+  size_t first_unfinished_scan_ = 0;
+
+  // Whether the rows are returned in partition order, as when paging through the tablets.
+  bool preserve_order_ = true;
+
+  // The sample of a sampling scan: the sampled rows of the tablets read so far, each serialized as
+  // a page of one row, the number of rows that they are drawn from, and the statistics of the
+  // targets over these rows.
+  std::vector<string> sample_rows_;
+  uint64_t sample_num_rows_ = 0;
+  std::vector<uint64_t> sample_null_counts_;
+  std::vector<HyperLogLog> sample_sketches_;
+
+  // When the last execution started and got its last response, and the DocDB execution
+  // statistics of its responses.
+  MonoTime start_time_;
+  MonoTime last_response_time_;
+  DocDBExecutionStatsPB execution_stats_;
 };
 
 class PgDocWriteOp : public PgDocOp {
@@ -42,6 +42,11 @@ const std::unordered_map<string, PgExpr::Opcode> kOperatorNames = {
   { ">=", PgExpr::Opcode::PG_EXPR_GE },
   { "<", PgExpr::Opcode::PG_EXPR_LT },
   { "<=", PgExpr::Opcode::PG_EXPR_LE },
+  { "and", PgExpr::Opcode::PG_EXPR_AND },
+  { "or", PgExpr::Opcode::PG_EXPR_OR },
+  { "in", PgExpr::Opcode::PG_EXPR_IN },
+  { "is_null", PgExpr::Opcode::PG_EXPR_IS_NULL },
+  { "is_not_null", PgExpr::Opcode::PG_EXPR_IS_NOT_NULL },
 
   { "avg", PgExpr::Opcode::PG_EXPR_AVG },
   { "sum", PgExpr::Opcode::PG_EXPR_SUM },
@@ -581,6 +586,51 @@ void PgOperator::AppendArg(PgExpr *arg) {
   args_.push_back(arg);
 }
 
+namespace {
+
+Result<QLOperator> OpcodeToQLOperator(PgExpr::Opcode opcode) {
+  switch (opcode) {
+    case PgExpr::Opcode::PG_EXPR_NOT: return QL_OP_NOT;
+    case PgExpr::Opcode::PG_EXPR_EQ: return QL_OP_EQUAL;
+    case PgExpr::Opcode::PG_EXPR_NE: return QL_OP_NOT_EQUAL;
+    case PgExpr::Opcode::PG_EXPR_GE: return QL_OP_GREATER_THAN_EQUAL;
+    case PgExpr::Opcode::PG_EXPR_GT: return QL_OP_GREATER_THAN;
+    case PgExpr::Opcode::PG_EXPR_LE: return QL_OP_LESS_THAN_EQUAL;
+    case PgExpr::Opcode::PG_EXPR_LT: return QL_OP_LESS_THAN;
+    case PgExpr::Opcode::PG_EXPR_AND: return QL_OP_AND;
+    case PgExpr::Opcode::PG_EXPR_OR: return QL_OP_OR;
+    case PgExpr::Opcode::PG_EXPR_IN: return QL_OP_IN;
+    case PgExpr::Opcode::PG_EXPR_IS_NULL: return QL_OP_IS_NULL;
+    case PgExpr::Opcode::PG_EXPR_IS_NOT_NULL: return QL_OP_IS_NOT_NULL;
+    default:
+      break;
+  }
+  return STATUS_FORMAT(NotSupported, "Operator $0 could not be evaluated by DocDB",
+                       static_cast<int>(opcode));
+}
+
+} // namespace
+
+Status PgOperator::PrepareForRead(PgDml *pg_stmt, PgsqlExpressionPB *expr_pb) {
+  PgsqlBCallPB *bocall = expr_pb->mutable_bocall();
+  bocall->set_opcode(VERIFY_RESULT(OpcodeToQLOperator(opcode_)));
+  bocall->clear_operands();
+  for (PgExpr *arg : args_) {
+    RETURN_NOT_OK(arg->PrepareForRead(pg_stmt, bocall->add_operands()));
+  }
+  return Status::OK();
+}
+
+Status PgOperator::Eval(PgDml *pg_stmt, PgsqlExpressionPB *expr_pb) {
+  PgsqlBCallPB *bocall = expr_pb->mutable_bocall();
+  SCHECK_EQ(static_cast<size_t>(bocall->operands_size()), args_.size(), IllegalState,
+            "Operator arguments changed after it was prepared");
+  for (size_t i = 0; i != args_.size(); ++i) {
+    RETURN_NOT_OK(args_[i]->Eval(pg_stmt, bocall->mutable_operands(i)));
+  }
+  return Status::OK();
+}
+
 //--------------------------------------------------------------------------------------------------
 namespace {
 #define POSTGRESQL_BYTEAOID 17
@@ -38,6 +38,11 @@ class PgExpr {
     PG_EXPR_GT,
     PG_EXPR_LE,
     PG_EXPR_LT,
+    PG_EXPR_AND,
+    PG_EXPR_OR,
+    PG_EXPR_IN,
+    PG_EXPR_IS_NULL,
+    PG_EXPR_IS_NOT_NULL,
 
     // Aggregate functions.
     PG_EXPR_AVG,
@@ -267,6 +272,13 @@ class PgOperator : public PgExpr {
   // Append arguments.
   void AppendArg(PgExpr *arg);
 
+  // Setup the operator call, with its arguments, as a builtin operator call evaluated by DocDB.
+  // Only the logical and comparison operators could be evaluated by DocDB.
+  virtual CHECKED_STATUS PrepareForRead(PgDml *pg_stmt, PgsqlExpressionPB *expr_pb) override;
+
+  // Update the values of the arguments.
+  virtual CHECKED_STATUS Eval(PgDml *pg_stmt, PgsqlExpressionPB *expr_pb) override;
+
  private:
   const string opname_;
   std::vector<PgExpr*> args_;
@@ -16,6 +16,18 @@
 #include "yb/yql/pggate/pg_insert.h"
 #include "yb/client/yb_op.h"
 
+#include <algorithm>
+
+#include <gflags/gflags.h>
+
+#include "yb/util/async_util.h"
+#include "yb/util/flag_tags.h"
+
+DEFINE_int32(pggate_bulk_insert_batch_rows, 1024,
+             "Number of rows of a bulk insert, as done by COPY FROM, that are sent to DocDB "
+             "together.");
+TAG_FLAG(pggate_bulk_insert_batch_rows, advanced);
+
 namespace yb {
 namespace pggate {
 
@@ -68,5 +80,126 @@ void PgInsert::AllocWriteRequest() {
   doc_op_ = doc_op;
 }
 
+//--------------------------------------------------------------------------------------------------
+// PgBulkInsert
+//--------------------------------------------------------------------------------------------------
+
+PgBulkInsert::PgBulkInsert(PgSession::ScopedRefPtr pg_session, const PgObjectId& table_id)
+    : PgStatement(std::move(pg_session)), table_id_(table_id) {
+}
+
+PgBulkInsert::~PgBulkInsert() {
+}
+
+Status PgBulkInsert::Prepare() {
+  table_desc_ = VERIFY_RESULT(pg_session_->LoadTable(table_id_));
+  return Status::OK();
+}
+
+Status PgBulkInsert::AddColumn(int attr_num, const YBCPgTypeEntity *type_entity) {
+  SCHECK(slots_.empty(), IllegalState, "Columns cannot be added once rows are appended");
+  PgColumn *col = VERIFY_RESULT(table_desc_->FindColumn(attr_num));
+
+  // Same check as PgDml::BindColumn().
+  if (col->internal_type() != InternalType::kBinaryValue) {
+    PgConstant value(type_entity, 0, true /* is_null */);
+    SCHECK_EQ(col->internal_type(), value.internal_type(), Corruption,
+              "Attribute value type does not match column type");
+  }
+  columns_.push_back(col);
+  types_.push_back(type_entity);
+  return Status::OK();
+}
+
+Status PgBulkInsert::PrepareSlots() {
+  const int rowid_attr_num = static_cast<int>(PgSystemAttrNum::kYBRowId);
+  for (PgColumn &col : table_desc_->columns()) {
+    auto it = std::find(columns_.begin(), columns_.end(), &col);
+    int index = it == columns_.end() ? -1 : static_cast<int>(it - columns_.begin());
+    if (index < 0 && col.attr_num() != rowid_attr_num) {
+      if (col.desc()->is_partition() || col.desc()->is_primary()) {
+        return STATUS(InvalidArgument, "Primary key must be fully specified for modifying table");
+      }
+      continue;
+    }
+    slots_.push_back(ColumnSlot{&col, index});
+  }
+  return Status::OK();
+}
+
+Status PgBulkInsert::AppendRows(int nrows, const uint64_t *values, const bool *isnulls) {
+  if (slots_.empty()) {
+    RETURN_NOT_OK(PrepareSlots());
+  }
+  const size_t natts = types_.size();
+  for (int i = 0; i < nrows; i++) {
+    RETURN_NOT_OK(AppendRow(values + i * natts, isnulls + i * natts));
+    if (pending_ops_.size() >= static_cast<size_t>(FLAGS_pggate_bulk_insert_batch_rows)) {
+      RETURN_NOT_OK(Flush());
+    }
+  }
+  return Status::OK();
+}
+
+Status PgBulkInsert::AppendRow(const uint64_t *values, const bool *isnulls) {
+  std::shared_ptr<YBPgsqlWriteOp> op(table_desc_->NewPgsqlInsert());
+  PgsqlWriteRequestPB *write_req = op->mutable_request();
+
+  // Key columns come first in the table, in the order the request needs them.
+  for (const ColumnSlot& slot : slots_) {
+    const ColumnDesc *desc = slot.col->desc();
+    PgsqlExpressionPB *expr_pb;
+    if (desc->is_partition()) {
+      expr_pb = write_req->add_partition_column_values();
+    } else if (desc->is_primary()) {
+      expr_pb = write_req->add_range_column_values();
+    } else {
+      PgsqlColumnValuePB *col_pb = write_req->add_column_values();
+      col_pb->set_column_id(slot.col->id());
+      expr_pb = col_pb->mutable_expr();
+    }
+
+    if (slot.index < 0) {
+      expr_pb->mutable_value()->set_binary_value(pg_session_->GenerateNewRowid());
+      continue;
+    }
+    if (isnulls[slot.index] && (desc->is_partition() || desc->is_primary())) {
+      return STATUS(InvalidArgument, "Primary key column cannot be null");
+    }
+    PgConstant value(types_[slot.index], values[slot.index], isnulls[slot.index]);
+    RETURN_NOT_OK(value.Eval(nullptr /* pg_stmt */, expr_pb));
+  }
+
+  RETURN_NOT_OK(pg_session_->PgApplyAsync(op, nullptr /* read_time */));
+  pending_ops_.push_back(std::move(op));
+  return Status::OK();
+}
+
+Status PgBulkInsert::Flush() {
+  if (pending_ops_.empty()) {
+    return Status::OK();
+  }
+  Synchronizer s;
+  RETURN_NOT_OK(pg_session_->PgFlushAsync(s.AsStatusFunctor()));
+  RETURN_NOT_OK(s.Wait());
+
+  // As in PgDocWriteOp::ReceiveResponse(), e.g. for duplicate keys.
+  for (const auto& op : pending_ops_) {
+    if (!op->succeeded()) {
+      if (op->response().status() == PgsqlResponsePB::PGSQL_STATUS_SCHEMA_VERSION_MISMATCH) {
+        pg_session_->InvalidateTableCache(table_desc_->table()->id());
+      }
+      pending_ops_.clear();
+      return STATUS(QLError, op->response().error_message());
+    }
+  }
+  pending_ops_.clear();
+  return Status::OK();
+}
+
+Status PgBulkInsert::ClearBinds() {
+  return STATUS(NotSupported, "Bulk insert has no binds");
+}
+
 }  // namespace pggate
 }  // namespace yb
@@ -48,6 +48,65 @@ class PgInsert : public PgDmlWrite {
   std::unique_ptr<PgGenerateRowId> generate_rowid_;
 };
 
+//--------------------------------------------------------------------------------------------------
+// Bulk INSERT, as used by COPY FROM
+//--------------------------------------------------------------------------------------------------
+
+// Inserts many rows given in one buffer, without the per-statement work of PgInsert. The write
+// operations of the rows are applied to the session and flushed once for every
+// --pggate_bulk_insert_batch_rows rows, so the batcher sends each tablet one large write.
+class PgBulkInsert : public PgStatement {
+ public:
+  // Public types.
+  typedef scoped_refptr<PgBulkInsert> ScopedRefPtr;
+
+  // Constructors.
+  PgBulkInsert(PgSession::ScopedRefPtr pg_session, const PgObjectId& table_id);
+  virtual ~PgBulkInsert();
+
+  virtual StmtOp stmt_op() const override { return StmtOp::STMT_BULK_INSERT; }
+
+  // Load the table.
+  CHECKED_STATUS Prepare();
+
+  // Add the column stored at the next position of each row given to AppendRows().
+  CHECKED_STATUS AddColumn(int attr_num, const YBCPgTypeEntity *type_entity);
+
+  // Insert 'nrows' rows, whose values are stored row by row in the same layout as the values of
+  // PgDml::Fetch(), one for each added column.
+  CHECKED_STATUS AppendRows(int nrows, const uint64_t *values, const bool *isnulls);
+
+  // Send the rows that have not been sent yet and wait for the result.
+  CHECKED_STATUS Flush();
+
+  virtual CHECKED_STATUS ClearBinds() override;
+
+ private:
+  // A column of the table and the position of its value in each row, -1 if it has none.
+  struct ColumnSlot {
+    PgColumn *col;
+    int index;
+  };
+
+  // Find where the value of each column of the table is, once all columns are added.
+  CHECKED_STATUS PrepareSlots();
+
+  CHECKED_STATUS AppendRow(const uint64_t *values, const bool *isnulls);
+
+  const PgObjectId table_id_;
+  PgTableDesc::ScopedRefPtr table_desc_;
+
+  // Column and type of the value at each position of a row.
+  std::vector<PgColumn *> columns_;
+  std::vector<const YBCPgTypeEntity *> types_;
+
+  // Columns of the table with values, in the order the write request needs.
+  std::vector<ColumnSlot> slots_;
+
+  // Operations applied to the session since the last flush.
+  std::vector<std::shared_ptr<client::YBPgsqlWriteOp>> pending_ops_;
+};
+
 }  // namespace pggate
 }  // namespace yb
 
@@ -17,6 +17,23 @@
 #include "yb/yql/pggate/util/pg_doc_data.h"
 #include "yb/client/yb_op.h"
 
+#include "yb/gutil/casts.h"
+
+#include <gflags/gflags.h>
+
+#include "yb/util/flag_tags.h"
+
+DEFINE_bool(pggate_pushdown_filters, true,
+            "Whether the filters that PostgreSQL gives to a SELECT are evaluated by DocDB, so that "
+            "rows that do not match are not sent to PostgreSQL. PostgreSQL checks the rows it "
+            "receives against the filters either way.");
+TAG_FLAG(pggate_pushdown_filters, advanced);
+
+DEFINE_bool(pggate_index_only_scan, true,
+            "Whether a SELECT through an index reads only the index when the index has all the "
+            "selected columns, instead of reading the row of the base table for each index entry.");
+TAG_FLAG(pggate_index_only_scan, advanced);
+
 namespace yb {
 namespace pggate {
 
@@ -49,6 +66,7 @@ Status PgSelect::Prepare(uint64_t* read_time) {
   }
 
   // Allocate READ/SELECT operation.
+  read_time_ = read_time;
   auto doc_op = make_shared<PgDocReadOp>(pg_session_, read_time, table_desc_->NewPgsqlSelect());
   read_req_ = doc_op->read_op()->mutable_request();
   if (index_id_.IsValid()) {
@@ -111,6 +129,47 @@ PgsqlExpressionPB *PgSelect::AllocIndexTargetPB() {
   return index_req_->add_targets();
 }
 
+Status PgSelect::AppendFilter(PgExpr *filter) {
+  if (!FLAGS_pggate_pushdown_filters) {
+    return Status::OK();
+  }
+
+  // The filters are the operands of a conjunction, so they could be appended one by one.
+  PgsqlBCallPB *conjunction = read_req_->mutable_where_expr()->mutable_bocall();
+  conjunction->set_opcode(QL_OP_AND);
+  PgsqlExpressionPB *filter_pb = conjunction->add_operands();
+  Status s = filter->PrepareForRead(this, filter_pb);
+  if (!s.ok()) {
+    conjunction->mutable_operands()->RemoveLast();
+    if (conjunction->operands_size() == 0) {
+      read_req_->clear_where_expr();
+    }
+    return s;
+  }
+
+  // Constants in the filter are written to the protobuf when the statement is executed.
+  expr_binds_[filter_pb] = filter;
+  return Status::OK();
+}
+
+Status PgSelect::SetSampleSize(int sample_size) {
+  if (sample_size <= 0) {
+    return STATUS_SUBSTITUTE(InvalidArgument, "Invalid sample size $0", sample_size);
+  }
+  if (index_id_.IsValid() || in_bind_pb_ != nullptr) {
+    return STATUS(NotSupported, "Sampling is only supported for scans of a table");
+  }
+  read_req_->set_sample_size(sample_size);
+  return Status::OK();
+}
+
+Result<PgDocReadOp::SampleStats> PgSelect::GetSampleStats() const {
+  if (!read_req_->has_sample_size()) {
+    return STATUS(IllegalState, "Not a sampling scan");
+  }
+  return down_cast<PgDocReadOp*>(doc_op_.get())->GetSampleStats();
+}
+
 //--------------------------------------------------------------------------------------------------
 // RESULT SET SUPPORT.
 // For now, selected expressions are just a list of column names (ref).
@@ -136,8 +195,8 @@ Status PgSelect::DeleteEmptyPrimaryBinds() {
 
     if (miss_partition_columns) {
       VLOG(1) << "Full scan is needed";
-      DCHECK(table_desc.get() != index_desc_.get())
-          << "Full scan should be applied to base table only";
+      DCHECK(index_only_ || table_desc.get() != index_desc_.get())
+          << "Full scan should be applied to base table or index only";
       read_req->clear_partition_column_values();
       read_req->clear_range_column_values();
     }
@@ -220,7 +279,152 @@ Status PgSelect::BindIndexColumn(int attr_num, PgExpr *attr_value) {
   return Status::OK();
 }
 
+Status PgSelect::BindColumnIn(int attr_num, const std::vector<PgExpr*>& attr_values) {
+  if (attr_values.empty()) {
+    return STATUS(InvalidArgument, "No values to bind");
+  }
+  if (index_id_.IsValid()) {
+    return STATUS(NotSupported, "Binding a list of values is not supported for index scans");
+  }
+  if (in_bind_pb_ != nullptr) {
+    return STATUS(InvalidArgument, "Only one column could be bound to a list of values");
+  }
+  if (read_req_->has_sample_size()) {
+    return STATUS(NotSupported, "Binding a list of values is not supported for sampling scans");
+  }
+  PgColumn *col = nullptr;
+  RETURN_NOT_OK(FindColumn(attr_num, &col));
+  const size_t col_index = col - table_desc_->columns().data();
+  if (col_index >= table_desc_->num_key_columns()) {
+    return STATUS_SUBSTITUTE(InvalidArgument, "Column $0 is not a key column", attr_num);
+  }
+  for (PgExpr *attr_value : attr_values) {
+    if (col->internal_type() != InternalType::kBinaryValue) {
+      SCHECK_EQ(col->internal_type(), attr_value->internal_type(), Corruption,
+                "Attribute value type does not match column type");
+    }
+  }
+
+  // The column is bound to the first value as usual, so that the key is set up as for a single
+  // value. The other values are written to copies of the request when executing.
+  RETURN_NOT_OK(BindColumn(attr_num, attr_values.front()));
+  in_bind_pb_ = col->bind_pb();
+  in_values_ = attr_values;
+  return Status::OK();
+}
+
+Status PgSelect::PrepareInValueOps() {
+  int partition_index = -1;
+  int range_index = -1;
+  for (int i = 0; i != read_req_->partition_column_values_size(); ++i) {
+    if (read_req_->mutable_partition_column_values(i) == in_bind_pb_) {
+      partition_index = i;
+    }
+  }
+  for (int i = 0; i != read_req_->range_column_values_size(); ++i) {
+    if (read_req_->mutable_range_column_values(i) == in_bind_pb_) {
+      range_index = i;
+    }
+  }
+  if (partition_index < 0 && range_index < 0) {
+    return STATUS(InvalidArgument, "The column bound to a list of values is not part of the key");
+  }
+
+  auto* doc_op = down_cast<PgDocReadOp*>(doc_op_.get());
+  std::vector<std::shared_ptr<client::YBPgsqlReadOp>> ops;
+  ops.reserve(in_values_.size());
+  for (PgExpr *value : in_values_) {
+    std::shared_ptr<client::YBPgsqlReadOp> op = doc_op->read_op()->DeepCopy();
+    PgsqlReadRequestPB *req = op->mutable_request();
+    // The hash code is computed from the partition column values when the operation is sent.
+    if (req->partition_column_values_size() > 0) {
+      req->clear_hash_code();
+      req->clear_max_hash_code();
+    }
+    RETURN_NOT_OK(value->Eval(this, partition_index >= 0
+        ? req->mutable_partition_column_values(partition_index)
+        : req->mutable_range_column_values(range_index)));
+    ops.push_back(std::move(op));
+  }
+  doc_op->SetInValueOps(std::move(ops));
+  return Status::OK();
+}
+
+PgColumn *PgSelect::FindCoveringIndexColumn(int attr_num) {
+  // The ybctid of a base table row is the ybbasectid of its index entries.
+  if (attr_num == static_cast<int>(PgSystemAttrNum::kYBTupleId)) {
+    auto index_col = index_desc_->FindColumn(static_cast<int>(PgSystemAttrNum::kYBBaseTupleId));
+    return index_col.ok() ? *index_col : nullptr;
+  }
+
+  // The columns of an index are named after the columns of the base table that they hold.
+  auto base_col = table_desc_->FindColumn(attr_num);
+  if (!base_col.ok()) {
+    return nullptr;
+  }
+  for (PgColumn &index_col : index_desc_->columns()) {
+    if (!index_col.is_virtual_column() &&
+        index_col.attr_name() == (*base_col)->attr_name() &&
+        index_col.internal_type() == (*base_col)->internal_type()) {
+      return &index_col;
+    }
+  }
+  return nullptr;
+}
+
+Status PgSelect::UseIndexOnly() {
+  // Only the targets are read from the base table, so the index should hold all of them, and there
+  // should be no condition on the base table.
+  if (!ybctid_bind_.empty() || read_req_->partition_column_values_size() > 0 ||
+      read_req_->range_column_values_size() > 0 || read_req_->has_where_expr()) {
+    return Status::OK();
+  }
+  std::vector<PgColumn*> index_cols;
+  for (PgExpr *target : targets_) {
+    if (target->opcode() != PgExpr::Opcode::PG_EXPR_COLREF) {
+      return Status::OK();
+    }
+    PgColumn *index_col = FindCoveringIndexColumn(down_cast<PgColumnRef*>(target)->attr_num());
+    if (index_col == nullptr) {
+      return Status::OK();
+    }
+    index_cols.push_back(index_col);
+  }
+  VLOG(1) << "Reading index " << index_id_.GetYBTableId() << " only";
+
+  // Read the index directly, with the binds already set up in the nested index request. Swapping
+  // the repeated fields keeps the addresses of their elements, which the index columns and
+  // expr_binds_ refer to.
+  auto doc_op = make_shared<PgDocReadOp>(pg_session_, read_time_, index_desc_->NewPgsqlSelect());
+  PgsqlReadRequestPB *req = doc_op->read_op()->mutable_request();
+  req->mutable_partition_column_values()->Swap(index_req_->mutable_partition_column_values());
+  req->mutable_range_column_values()->Swap(index_req_->mutable_range_column_values());
+  req->set_is_forward_scan(read_req_->is_forward_scan());
+  if (read_req_->has_limit()) {
+    req->set_limit(read_req_->limit());
+  }
+
+  // Select the index columns in place of the base table columns, in the same order.
+  for (int i = 0; i < read_req_->targets_size(); i++) {
+    expr_binds_.erase(read_req_->mutable_targets(i));
+  }
+  for (PgColumn *index_col : index_cols) {
+    req->add_targets()->set_column_id(index_col->id());
+    index_col->set_read_requested(true);
+  }
+
+  read_req_ = req;
+  index_req_ = req;
+  doc_op_ = doc_op;
+  index_only_ = true;
+  return Status::OK();
+}
+
 Status PgSelect::Exec() {
+  if (index_id_.IsValid() && !index_only_ && FLAGS_pggate_index_only_scan) {
+    RETURN_NOT_OK(UseIndexOnly());
+  }
+
   // Delete key columns that are not bound to any values.
   RETURN_NOT_OK(DeleteEmptyPrimaryBinds());
 
@@ -228,9 +432,17 @@ Status PgSelect::Exec() {
   RETURN_NOT_OK(UpdateBindPBs());
 
   // Set column references in protobuf.
-  SetColumnRefIds(table_desc_, read_req_->mutable_column_refs());
-  if (index_id_.IsValid()) {
-    SetColumnRefIds(index_desc_, index_req_->mutable_column_refs());
+  if (index_only_) {
+    SetColumnRefIds(index_desc_, read_req_->mutable_column_refs());
+  } else {
+    SetColumnRefIds(table_desc_, read_req_->mutable_column_refs());
+    if (index_id_.IsValid()) {
+      SetColumnRefIds(index_desc_, index_req_->mutable_column_refs());
+    }
+  }
+
+  if (in_bind_pb_ != nullptr) {
+    RETURN_NOT_OK(PrepareInValueOps());
   }
 
   // Execute select statement asynchronously.
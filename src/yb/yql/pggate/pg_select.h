@@ -55,6 +55,23 @@ class PgSelect : public PgDml {
   // Bind an index column with an expression.
   CHECKED_STATUS BindIndexColumn(int attnum, PgExpr *attr_value);
 
+  // Bind a key column of the base table with a list of values, as in "WHERE key IN (...)". The
+  // other key columns are bound with BindColumn() as usual. Each value is read with its own
+  // operation, and the operations are sent together, so there is one request per tablet. The rows
+  // of each value are returned together, in the order of the values.
+  CHECKED_STATUS BindColumnIn(int attnum, const std::vector<PgExpr*>& attr_values);
+
+  // Append a boolean expression that the selected rows should match, to be evaluated by DocDB.
+  // The appended filters are combined with AND.
+  CHECKED_STATUS AppendFilter(PgExpr *filter);
+
+  // Make the SELECT a sampling scan: all the rows of the table are read, and a uniform random
+  // sample of up to sample_size of them is returned in place of the rows.
+  CHECKED_STATUS SetSampleSize(int sample_size);
+
+  // Statistics of a sampling scan, once all its rows are fetched.
+  Result<PgDocReadOp::SampleStats> GetSampleStats() const;
+
   // Execute.
   CHECKED_STATUS Exec();
 
@@ -76,9 +93,30 @@ class PgSelect : public PgDml {
   // Load index.
   CHECKED_STATUS LoadIndex();
 
+  // Find the index column that holds the values of the base table column "attr_num", or null if
+  // the index does not have this column.
+  PgColumn *FindCoveringIndexColumn(int attr_num);
+
+  // When the index has all the targets, read only the index instead of reading the base table
+  // row of each index entry.
+  CHECKED_STATUS UseIndexOnly();
+
+  // Creates the operations that read the values of the column bound by BindColumnIn().
+  CHECKED_STATUS PrepareInValueOps();
+
   PgObjectId index_id_;
   PgTableDesc::ScopedRefPtr index_desc_;
 
+  // Whether the index is read in place of the base table.
+  bool index_only_ = false;
+
+  // The bind of the column bound by BindColumnIn() and its values.
+  PgsqlExpressionPB *in_bind_pb_ = nullptr;
+  std::vector<PgExpr*> in_values_;
+
+  // Where the read time of the statement is stored.
+  uint64_t* read_time_ = nullptr;
+
   // Protobuf instruction.
   std::shared_ptr<client::YBPgsqlReadOp> read_op_;
   PgsqlReadRequestPB *read_req_ = nullptr;
@@ -16,12 +16,32 @@
 #include "yb/yql/pggate/pg_session.h"
 #include "yb/yql/pggate/pggate_if_cxx_decl.h"
 
+#include <gflags/gflags.h>
+
 #include "yb/client/yb_op.h"
 #include "yb/client/transaction.h"
 #include "yb/client/batcher.h"
 
+#include "yb/util/flag_tags.h"
 #include "yb/util/string_util.h"
 
+DEFINE_int32(pggate_max_buffered_write_operations, 0,
+             "Maximum number of writes of a transaction that pggate buffers to send together. "
+             "Errors of buffered writes are reported by a later statement or by the commit. "
+             "0 disables buffering, so each write is sent by its own statement.");
+TAG_FLAG(pggate_max_buffered_write_operations, advanced);
+
+DEFINE_bool(ysql_colocate_database_tables, false,
+            "Whether the tables of new databases share one tablet instead of getting tablets of "
+            "their own. Saves the Raft groups and RocksDB instances of many small tables.");
+TAG_FLAG(ysql_colocate_database_tables, advanced);
+
+DEFINE_bool(pggate_prefetch_oids, true,
+            "Whether the next range of object identifiers of a database is reserved in the "
+            "background once a range is handed out, so that allocating it does not wait for the "
+            "master.");
+TAG_FLAG(pggate_prefetch_oids, advanced);
+
 namespace yb {
 namespace pggate {
 
@@ -50,11 +70,13 @@ PgSession::PgSession(
     std::shared_ptr<client::YBClient> client,
     const string& database_name,
     scoped_refptr<PgTxnManager> pg_txn_manager,
-    scoped_refptr<server::HybridClock> clock)
+    scoped_refptr<server::HybridClock> clock,
+    PgTableCache::ScopedRefPtr table_cache)
     : client_(client),
       session_(client_->NewSession()),
       pg_txn_manager_(std::move(pg_txn_manager)),
-      clock_(std::move(clock)) {
+      clock_(std::move(clock)),
+      table_cache_(std::move(table_cache)) {
   session_->SetTimeout(kSessionTimeout);
   session_->SetForceConsistentRead(true);
 }
@@ -91,7 +113,8 @@ Status PgSession::CreateDatabase(const string& database_name,
                                   GetPgsqlNamespaceId(database_oid),
                                   source_database_oid != kPgInvalidOid
                                   ? GetPgsqlNamespaceId(source_database_oid) : "",
-                                  next_oid);
+                                  next_oid,
+                                  FLAGS_ysql_colocate_database_tables);
 }
 
 Status PgSession::DropDatabase(const string& database_name, bool if_exist) {
@@ -103,8 +126,34 @@ Status PgSession::ReserveOids(const PgOid database_oid,
                               const uint32_t count,
                               PgOid *begin_oid,
                               PgOid *end_oid) {
-  return client_->ReservePgsqlOids(GetPgsqlNamespaceId(database_oid), next_oid, count,
-                                   begin_oid, end_oid);
+  if (prefetched_oids_.valid()) {
+    const Status s = prefetched_oids_.get();
+    // Another backend of this node may have moved past the prefetched range since it was
+    // reserved, in which case it is dropped.
+    if (s.ok() && prefetched_oids_database_ == database_oid &&
+        prefetched_begin_oid_ >= next_oid && prefetched_end_oid_ > prefetched_begin_oid_) {
+      *begin_oid = prefetched_begin_oid_;
+      *end_oid = prefetched_end_oid_;
+      PrefetchOids(database_oid, *end_oid, count);
+      return Status::OK();
+    }
+  }
+  RETURN_NOT_OK(client_->ReservePgsqlOids(GetPgsqlNamespaceId(database_oid), next_oid, count,
+                                          begin_oid, end_oid));
+  PrefetchOids(database_oid, *end_oid, count);
+  return Status::OK();
+}
+
+void PgSession::PrefetchOids(const PgOid database_oid, const PgOid next_oid,
+                             const uint32_t count) {
+  if (!FLAGS_pggate_prefetch_oids || next_oid == std::numeric_limits<PgOid>::max()) {
+    return;
+  }
+  prefetched_oids_database_ = database_oid;
+  prefetched_oids_ = std::async(std::launch::async, [this, database_oid, next_oid, count] {
+    return client_->ReservePgsqlOids(GetPgsqlNamespaceId(database_oid), next_oid, count,
+                                     &prefetched_begin_oid_, &prefetched_end_oid_);
+  });
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -114,6 +163,7 @@ client::YBTableCreator *PgSession::NewTableCreator() {
 }
 
 Status PgSession::DropTable(const PgObjectId& table_id) {
+  InvalidateTableCache(table_id.GetYBTableId());
   return client_->DeleteTable(table_id.GetYBTableId());
 }
 
@@ -126,10 +176,9 @@ Status PgSession::TruncateTable(const PgObjectId& table_id) {
 Result<PgTableDesc::ScopedRefPtr> PgSession::LoadTable(const PgObjectId& table_id) {
   VLOG(3) << "Loading table descriptor for " << table_id;
   const TableId yb_table_id = table_id.GetYBTableId();
-  shared_ptr<YBTable> table;
+  shared_ptr<YBTable> table = table_cache_->Get(yb_table_id);
 
-  auto cached_yb_table = table_cache_.find(yb_table_id);
-  if (cached_yb_table == table_cache_.end()) {
+  if (!table) {
     Status s = client_->OpenTable(yb_table_id, &table);
     if (!s.ok()) {
       VLOG(3) << "LoadTable: Server returns an error: " << s;
@@ -137,9 +186,7 @@ Result<PgTableDesc::ScopedRefPtr> PgSession::LoadTable(const PgObjectId& table_i
       return STATUS_FORMAT(
           NotFound, "Error loading table with id $0: $1", yb_table_id, s.ToString());
     }
-    table_cache_[yb_table_id] = table;
-  } else {
-    table = cached_yb_table->second;
+    table_cache_->Put(table);
   }
 
   DCHECK_EQ(table->table_type(), YBTableType::PGSQL_TABLE_TYPE);
@@ -147,7 +194,13 @@ Result<PgTableDesc::ScopedRefPtr> PgSession::LoadTable(const PgObjectId& table_i
   return make_scoped_refptr<PgTableDesc>(table);
 }
 
+void PgSession::InvalidateTableCache(const TableId& table_id) {
+  table_cache_->Invalidate(table_id);
+}
+
 Status PgSession::PgApplyAsync(const std::shared_ptr<client::YBPgsqlOp>& op, uint64_t* read_time) {
+  // Reads should see the buffered writes, and other writes should be applied after them.
+  RETURN_NOT_OK(FlushBufferedWriteOperations());
   if (op->IsTransactional()) {
     has_txn_ops_ = true;
   } else {
@@ -163,6 +216,19 @@ Status PgSession::PgApplyAsync(const std::shared_ptr<client::YBPgsqlOp>& op, uin
   return session->Apply(op);
 }
 
+Result<client::YBSessionPtr> PgSession::PrepareIsolatedRead(
+    const std::shared_ptr<client::YBPgsqlReadOp>& op, uint64_t* read_time) {
+  RETURN_NOT_OK(FlushBufferedWriteOperations());
+  auto session = VERIFY_RESULT(GetSessionForOp(op));
+  if (read_time && op->IsTransactional()) {
+    if (!*read_time) {
+      *read_time = clock_->Now().ToUint64();
+    }
+    session->SetInTxnLimit(HybridTime(*read_time));
+  }
+  return session->shared_from_this();
+}
+
 Status PgSession::PgFlushAsync(StatusFunctor callback) {
   VLOG(2) << __PRETTY_FUNCTION__ << " called";
   if (has_txn_ops_ && has_non_txn_ops_) {
@@ -183,6 +249,33 @@ Status PgSession::PgFlushAsync(StatusFunctor callback) {
   return Status::OK();
 }
 
+Result<bool> PgSession::BufferWriteOperation(const std::shared_ptr<client::YBPgsqlWriteOp>& op) {
+  if (FLAGS_pggate_max_buffered_write_operations <= 0 || !op->IsTransactional() ||
+      op->request().targets_size() != 0 || !pg_txn_manager_->txn_in_progress() ||
+      has_non_txn_ops_) {
+    return false;
+  }
+  auto session = VERIFY_RESULT(GetSessionForOp(op));
+  RETURN_NOT_OK(session->Apply(op));
+  has_buffered_write_ops_ = true;
+  if (session->CountBufferedOperations() >= FLAGS_pggate_max_buffered_write_operations) {
+    RETURN_NOT_OK(FlushBufferedWriteOperations());
+  }
+  return true;
+}
+
+Status PgSession::FlushBufferedWriteOperations() {
+  if (!has_buffered_write_ops_) {
+    return Status::OK();
+  }
+  has_buffered_write_ops_ = false;
+  auto session = VERIFY_RESULT(GetSession(/* transactional */ true, /* read_only_op */ true));
+  VLOG(2) << __PRETTY_FUNCTION__ << ": flushing " << session->CountBufferedOperations()
+          << " buffered writes";
+  Status status = session->Flush();
+  return CombineErrorsToStatus(session->GetPendingErrors(), status);
+}
+
 Result<client::YBSession*> PgSession::GetSessionForOp(
     const std::shared_ptr<client::YBPgsqlOp>& op) {
   return GetSession(op->IsTransactional(), op->read_only());
@@ -14,6 +14,8 @@
 #ifndef YB_YQL_PGGATE_PG_SESSION_H_
 #define YB_YQL_PGGATE_PG_SESSION_H_
 
+#include <future>
+
 #include "yb/client/client.h"
 #include "yb/client/callbacks.h"
 #include "yb/client/schema.h"
@@ -46,7 +48,8 @@ class PgSession : public RefCountedThreadSafe<PgSession> {
   PgSession(std::shared_ptr<client::YBClient> client,
             const string& database_name,
             scoped_refptr<PgTxnManager> pg_txn_manager,
-            scoped_refptr<server::HybridClock> clock);
+            scoped_refptr<server::HybridClock> clock,
+            PgTableCache::ScopedRefPtr table_cache);
   virtual ~PgSession();
 
   //------------------------------------------------------------------------------------------------
@@ -68,6 +71,9 @@ class PgSession : public RefCountedThreadSafe<PgSession> {
                                 PgOid nexte_oid);
   CHECKED_STATUS DropDatabase(const std::string& database_name, bool if_exist);
 
+  // Reserves 'count' object identifiers of the database, starting at 'nexte_oid' or later. The
+  // range that follows is reserved in the background, so that the next call usually does not
+  // wait for the master.
   CHECKED_STATUS ReserveOids(PgOid database_oid,
                              PgOid nexte_oid,
                              uint32_t count,
@@ -85,10 +91,37 @@ class PgSession : public RefCountedThreadSafe<PgSession> {
   CHECKED_STATUS TruncateTable(const PgObjectId& table_id);
   Result<PgTableDesc::ScopedRefPtr> LoadTable(const PgObjectId& table_id);
 
+  // Makes the next LoadTable() of the table fetch it from the master again.
+  void InvalidateTableCache(const TableId& table_id);
+
   // Apply the given operation to read and write database content.
   CHECKED_STATUS PgApplyAsync(const std::shared_ptr<client::YBPgsqlOp>& op, uint64_t* read_time);
   CHECKED_STATUS PgFlushAsync(StatusFunctor callback);
 
+  // Buffers a write of the current transaction that returns no rows, so it is sent together with
+  // the writes that follow it, grouped by tablet. Returns false if the write cannot be buffered
+  // and should be sent right away. Buffered writes are sent before any other operation, when
+  // --pggate_max_buffered_write_operations is reached, and when the transaction commits. Their
+  // errors are reported at that point.
+  Result<bool> BufferWriteOperation(const std::shared_ptr<client::YBPgsqlWriteOp>& op);
+
+  // Sends the buffered writes and waits for them to complete.
+  CHECKED_STATUS FlushBufferedWriteOperations();
+
+  // Get the appropriate YBSession to apply the given operation to, based on whether or not this
+  // is an operation on a transactional table, as well as read-only vs. non-read-only operation.
+  Result<client::YBSession*> GetSessionForOp(const std::shared_ptr<client::YBPgsqlOp>& op);
+
+  // Prepares the session for a read that is sent with YBSession::ApplyAndFlushIsolatedAsync
+  // rather than with PgApplyAsync and PgFlushAsync, in the same way as PgApplyAsync, and returns
+  // that session.
+  Result<client::YBSessionPtr> PrepareIsolatedRead(
+      const std::shared_ptr<client::YBPgsqlReadOp>& op, uint64_t* read_time);
+
+  // Given a set of errors from operations, this function attempts to combine them into one status
+  // that is later passed to PostgreSQL and further converted into a more specific error code.
+  static Status CombineErrorsToStatus(client::CollectedErrors errors, Status status);
+
   // Return the number of errors which are pending.
   int CountPendingErrors() const;
 
@@ -136,13 +169,8 @@ class PgSession : public RefCountedThreadSafe<PgSession> {
   // PgTxnManager or by this object.
   Result<client::YBSession*> GetSession(bool transactional, bool read_only_op);
 
-  // Get the appropriate YBSession to apply the given operation to, based on whether or not this
-  // is an operation on a transactional table, as well as read-only vs. non-read-only operation.
-  Result<client::YBSession*> GetSessionForOp(const std::shared_ptr<client::YBPgsqlOp>& op);
-
-  // Given a set of errors from operations, this function attempts to combine them into one status
-  // that is later passed to PostgreSQL and further converted into a more specific error code.
-  Status CombineErrorsToStatus(client::CollectedErrors errors, Status status);
+  // Starts reserving the range of object identifiers that follows 'next_oid' in the background.
+  void PrefetchOids(PgOid database_oid, PgOid next_oid, uint32_t count);
 
   // YBClient, an API that SQL engine uses to communicate with all servers.
   std::shared_ptr<client::YBClient> client_;
@@ -165,10 +193,21 @@ class PgSession : public RefCountedThreadSafe<PgSession> {
   // Rowid generator.
   ObjectIdGenerator rowid_generator_;
 
-  std::unordered_map<TableId, std::shared_ptr<client::YBTable>> table_cache_;
+  // Tables opened by the sessions of this process.
+  const PgTableCache::ScopedRefPtr table_cache_;
 
   bool has_txn_ops_ = false;
   bool has_non_txn_ops_ = false;
+
+  // Whether writes were buffered in the transactional session since it was last flushed.
+  bool has_buffered_write_ops_ = false;
+
+  // The range of object identifiers that is reserved in the background. Declared last, so that
+  // the reservation is waited for before the fields that it sets are destroyed.
+  PgOid prefetched_oids_database_ = kPgInvalidOid;
+  PgOid prefetched_begin_oid_ = kPgInvalidOid;
+  PgOid prefetched_end_oid_ = kPgInvalidOid;
+  std::future<Status> prefetched_oids_;
 };
 
 }  // namespace pggate
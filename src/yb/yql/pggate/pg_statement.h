@@ -45,6 +45,7 @@ enum class StmtOp {
   STMT_UPDATE,
   STMT_DELETE,
   STMT_SELECT,
+  STMT_BULK_INSERT,
 };
 
 class PgStatement : public RefCountedThreadSafe<PgStatement> {
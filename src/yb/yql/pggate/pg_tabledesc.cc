@@ -75,5 +75,26 @@ bool PgTableDesc::IsTransactional() const {
   return table_->schema().table_properties().is_transactional();
 }
 
+//--------------------------------------------------------------------------------------------------
+
+std::shared_ptr<client::YBTable> PgTableCache::Get(const TableId& table_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = tables_.find(table_id);
+  return it == tables_.end() ? nullptr : it->second;
+}
+
+void PgTableCache::Put(const std::shared_ptr<client::YBTable>& table) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& cached = tables_[table->id()];
+  if (!cached || cached->schema().version() < table->schema().version()) {
+    cached = table;
+  }
+}
+
+void PgTableCache::Invalidate(const TableId& table_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  tables_.erase(table_id);
+}
+
 }  // namespace pggate
 }  // namespace yb
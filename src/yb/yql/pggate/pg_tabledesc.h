@@ -18,6 +18,9 @@
 #ifndef YB_YQL_PGGATE_PG_TABLEDESC_H_
 #define YB_YQL_PGGATE_PG_TABLEDESC_H_
 
+#include <mutex>
+#include <unordered_map>
+
 #include "yb/client/client.h"
 #include "yb/yql/pggate/pg_column.h"
 
@@ -95,6 +98,30 @@ class PgTableDesc : public RefCountedThreadSafe<PgTableDesc> {
   PgColumn column_ybctid_;
 };
 
+//--------------------------------------------------------------------------------------------------
+
+// Tables opened by the sessions of a process, so that a table is fetched from the master once
+// rather than once per session. Only the YBTable is shared: PgTableDesc keeps the state of the
+// statement using it, so each statement still builds its own. An entry is replaced only by a newer
+// schema version of the table, and is removed when the table is dropped or DocDB rejects a request
+// for having an old schema version.
+class PgTableCache : public RefCountedThreadSafe<PgTableCache> {
+ public:
+  typedef scoped_refptr<PgTableCache> ScopedRefPtr;
+
+  // Returns the cached table, or nullptr if it is not cached.
+  std::shared_ptr<client::YBTable> Get(const TableId& table_id);
+
+  // Caches the table, unless a newer schema version of it is cached already.
+  void Put(const std::shared_ptr<client::YBTable>& table);
+
+  void Invalidate(const TableId& table_id);
+
+ private:
+  std::mutex mutex_;
+  std::unordered_map<TableId, std::shared_ptr<client::YBTable>> tables_;
+};
+
 }  // namespace pggate
 }  // namespace yb
 
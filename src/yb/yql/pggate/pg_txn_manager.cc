@@ -100,6 +100,16 @@ Status PgTxnManager::CommitTransaction() {
     ResetTxnAndSession();
     return Status::OK();
   }
+  // Writes buffered by PgSession are sent before the transaction commits.
+  if (session_->CountBufferedOperations() != 0) {
+    Status status = session_->Flush();
+    status = PgSession::CombineErrorsToStatus(session_->GetPendingErrors(), status);
+    if (!status.ok()) {
+      txn_->Abort();
+      ResetTxnAndSession();
+      return status;
+    }
+  }
   Status status = txn_->CommitFuture().get();
   ResetTxnAndSession();
   return status;
@@ -147,6 +157,10 @@ Result<client::YBSession*> PgTxnManager::GetTransactionalSession() {
 }
 
 void PgTxnManager::ResetTxnAndSession() {
+  // Discard writes that were buffered but not sent.
+  if (session_) {
+    session_->Abort();
+  }
   txn_in_progress_ = false;
   session_ = nullptr;
   txn_ = nullptr;
@@ -49,6 +49,8 @@ YBC_STATUS_METHOD(SetIsolationLevel, ((int, isolation)));
 
   Status BeginWriteTransactionIfNecessary(bool read_only_op);
 
+  bool txn_in_progress() const { return txn_in_progress_; }
+
  private:
 
   client::TransactionManager* GetOrCreateTransactionManager();
@@ -42,6 +42,22 @@ DEFINE_string(pggate_proxy_bind_address, "",
 DEFINE_string(pggate_master_addresses, "",
               "Addresses of the master servers to which the PostgreSQL proxy server connects.");
 
+// Every PostgreSQL backend has its own client, so these are multiplied by the number of
+// connections to PostgreSQL on the node.
+DEFINE_int32(pggate_num_connections_to_server, 1,
+             "Number of connections that a PostgreSQL backend opens to each server. A backend "
+             "runs one statement at a time, so it seldom uses more than one.");
+TAG_FLAG(pggate_num_connections_to_server, advanced);
+
+DEFINE_int64(pggate_idle_connection_timeout_ms, 60000,
+             "A PostgreSQL backend closes its connections to servers that have been idle for "
+             "longer than this, so idle backends do not hold sockets to every server. "
+             "0 keeps them open.");
+TAG_FLAG(pggate_idle_connection_timeout_ms, advanced);
+
+DECLARE_int32(num_connections_to_server);
+DECLARE_int64(rpc_idle_client_connection_timeout_ms);
+
 namespace yb {
 namespace pggate {
 
@@ -60,6 +76,11 @@ PggateOptions::PggateOptions() {
                                                           PggateOptions::kDefaultPort);
   }
   rpc_opts.rpc_bind_addresses = FLAGS_pggate_proxy_bind_address;
+
+  // The client of the backend is created after the options, so it opens the connections with
+  // these.
+  FLAGS_num_connections_to_server = FLAGS_pggate_num_connections_to_server;
+  FLAGS_rpc_idle_client_connection_timeout_ms = FLAGS_pggate_idle_connection_timeout_ms;
   master_addresses_flag = FLAGS_pggate_master_addresses;
 
   server::MasterAddresses master_addresses;
@@ -86,7 +107,8 @@ PgApiImpl::PgApiImpl(const YBCPgTypeEntity *YBCDataTypeArray, int count)
                          metric_entity_,
                          mem_tracker_),
       clock_(new server::HybridClock()),
-      pg_txn_manager_(new PgTxnManager(&async_client_init_, clock_)) {
+      pg_txn_manager_(new PgTxnManager(&async_client_init_, clock_)),
+      table_cache_(new PgTableCache()) {
   CHECK_OK(clock_->Init());
 
   // Setup type mapping.
@@ -125,7 +147,8 @@ Status PgApiImpl::DestroyEnv(PgEnv *pg_env) {
 Status PgApiImpl::CreateSession(const PgEnv *pg_env,
                                 const string& database_name,
                                 PgSession **pg_session) {
-  auto session = make_scoped_refptr<PgSession>(client(), database_name, pg_txn_manager_, clock_);
+  auto session = make_scoped_refptr<PgSession>(
+      client(), database_name, pg_txn_manager_, clock_, table_cache_);
   if (!database_name.empty()) {
     RETURN_NOT_OK(session->ConnectDatabase(database_name));
   }
@@ -400,6 +423,14 @@ Status PgApiImpl::DmlBindColumn(PgStatement *handle, int attr_num, PgExpr *attr_
   return down_cast<PgDml*>(handle)->BindColumn(attr_num, attr_value);
 }
 
+Status PgApiImpl::DmlAppendFilter(PgStatement *handle, PgExpr *filter) {
+  if (!PgStatement::IsValidStmt(handle, StmtOp::STMT_SELECT)) {
+    // Invalid handle.
+    return STATUS(InvalidArgument, "Invalid statement handle");
+  }
+  return down_cast<PgSelect*>(handle)->AppendFilter(filter);
+}
+
 Status PgApiImpl::DmlBindIndexColumn(PgStatement *handle, int attr_num, PgExpr *attr_value) {
   if (!PgStatement::IsValidStmt(handle, StmtOp::STMT_SELECT)) {
     // Invalid handle.
@@ -408,6 +439,15 @@ Status PgApiImpl::DmlBindIndexColumn(PgStatement *handle, int attr_num, PgExpr *
   return down_cast<PgSelect*>(handle)->BindIndexColumn(attr_num, attr_value);
 }
 
+Status PgApiImpl::DmlBindColumnIn(PgStatement *handle, int attr_num,
+                                  const std::vector<PgExpr*>& attr_values) {
+  if (!PgStatement::IsValidStmt(handle, StmtOp::STMT_SELECT)) {
+    // Invalid handle.
+    return STATUS(InvalidArgument, "Invalid statement handle");
+  }
+  return down_cast<PgSelect*>(handle)->BindColumnIn(attr_num, attr_values);
+}
+
 CHECKED_STATUS PgApiImpl::DmlAssignColumn(PgStatement *handle, int attr_num, PgExpr *attr_value) {
   return down_cast<PgDml*>(handle)->AssignColumn(attr_num, attr_value);
 }
@@ -417,6 +457,12 @@ Status PgApiImpl::DmlFetch(PgStatement *handle, int32_t natts, uint64_t *values,
   return down_cast<PgDml*>(handle)->Fetch(natts, values, isnulls, syscols, has_data);
 }
 
+Status PgApiImpl::DmlFetchBatch(PgStatement *handle, int32_t natts, int32_t max_rows,
+                                uint64_t *values, bool *isnulls, PgSysColumns *syscols,
+                                int32_t *nrows) {
+  return down_cast<PgDml*>(handle)->FetchBatch(natts, max_rows, values, isnulls, syscols, nrows);
+}
+
 // Insert ------------------------------------------------------------------------------------------
 
 Status PgApiImpl::NewInsert(PgSession *pg_session,
@@ -438,6 +484,45 @@ Status PgApiImpl::ExecInsert(PgStatement *handle) {
   return down_cast<PgInsert*>(handle)->Exec();
 }
 
+// Bulk insert -------------------------------------------------------------------------------------
+
+Status PgApiImpl::NewBulkInsert(PgSession *pg_session,
+                                const PgObjectId& table_id,
+                                PgStatement **handle) {
+  DCHECK(pg_session) << "Invalid session handle";
+  *handle = nullptr;
+  auto stmt = make_scoped_refptr<PgBulkInsert>(pg_session, table_id);
+  RETURN_NOT_OK(stmt->Prepare());
+  *handle = stmt.detach();
+  return Status::OK();
+}
+
+Status PgApiImpl::BulkInsertAddColumn(PgStatement *handle, int attr_num,
+                                      const YBCPgTypeEntity *type_entity) {
+  if (!PgStatement::IsValidStmt(handle, StmtOp::STMT_BULK_INSERT)) {
+    // Invalid handle.
+    return STATUS(InvalidArgument, "Invalid statement handle");
+  }
+  return down_cast<PgBulkInsert*>(handle)->AddColumn(attr_num, type_entity);
+}
+
+Status PgApiImpl::BulkInsertAppendRows(PgStatement *handle, int nrows, const uint64_t *values,
+                                       const bool *isnulls) {
+  if (!PgStatement::IsValidStmt(handle, StmtOp::STMT_BULK_INSERT)) {
+    // Invalid handle.
+    return STATUS(InvalidArgument, "Invalid statement handle");
+  }
+  return down_cast<PgBulkInsert*>(handle)->AppendRows(nrows, values, isnulls);
+}
+
+Status PgApiImpl::BulkInsertFlush(PgStatement *handle) {
+  if (!PgStatement::IsValidStmt(handle, StmtOp::STMT_BULK_INSERT)) {
+    // Invalid handle.
+    return STATUS(InvalidArgument, "Invalid statement handle");
+  }
+  return down_cast<PgBulkInsert*>(handle)->Flush();
+}
+
 // Update ------------------------------------------------------------------------------------------
 
 Status PgApiImpl::NewUpdate(PgSession *pg_session,
@@ -506,6 +591,36 @@ Status PgApiImpl::ExecSelect(PgStatement *handle) {
   return down_cast<PgSelect*>(handle)->Exec();
 }
 
+Status PgApiImpl::SelectSetSampleSize(PgStatement *handle, int sample_size) {
+  if (!PgStatement::IsValidStmt(handle, StmtOp::STMT_SELECT)) {
+    // Invalid handle.
+    return STATUS(InvalidArgument, "Invalid statement handle");
+  }
+  return down_cast<PgSelect*>(handle)->SetSampleSize(sample_size);
+}
+
+Status PgApiImpl::SelectGetSampleStats(PgStatement *handle, int natts, double *num_rows,
+                                       double *null_fracs, double *n_distincts) {
+  if (!PgStatement::IsValidStmt(handle, StmtOp::STMT_SELECT)) {
+    // Invalid handle.
+    return STATUS(InvalidArgument, "Invalid statement handle");
+  }
+  const auto stats = VERIFY_RESULT(down_cast<PgSelect*>(handle)->GetSampleStats());
+  *num_rows = stats.num_rows;
+  // The targets have no statistics when the table has no rows.
+  for (int i = 0; i != natts; ++i) {
+    const size_t index = i;
+    if (index < stats.null_counts.size()) {
+      null_fracs[i] = stats.num_rows == 0 ? 0 : 1.0 * stats.null_counts[index] / stats.num_rows;
+      n_distincts[i] = stats.distinct_counts[index];
+    } else {
+      null_fracs[i] = 0;
+      n_distincts[i] = 0;
+    }
+  }
+  return Status::OK();
+}
+
 //--------------------------------------------------------------------------------------------------
 // Expressions.
 //--------------------------------------------------------------------------------------------------
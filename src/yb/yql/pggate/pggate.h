@@ -224,21 +224,33 @@ class PgApiImpl {
   CHECKED_STATUS DmlBindColumn(YBCPgStatement handle, int attr_num, YBCPgExpr attr_value);
   CHECKED_STATUS DmlBindIndexColumn(YBCPgStatement handle, int attr_num, YBCPgExpr attr_value);
 
+  // Bind a primary-key column of a SELECT with a list of values, as in "WHERE key IN (...)".
+  CHECKED_STATUS DmlBindColumnIn(YBCPgStatement handle, int attr_num,
+                                 const std::vector<PgExpr*>& attr_values);
+
   // API for SET clause.
   CHECKED_STATUS DmlAssignColumn(YBCPgStatement handle, int attr_num, YBCPgExpr attr_value);
 
+  // Append a filter, evaluated by DocDB, that the rows selected by a SELECT should match.
+  CHECKED_STATUS DmlAppendFilter(PgStatement *handle, PgExpr *filter);
+
   // This function is to fetch the targets in YBCPgDmlAppendTarget() from the rows that were defined
   // by YBCPgDmlBindColumn().
   CHECKED_STATUS DmlFetch(PgStatement *handle, int32_t natts, uint64_t *values, bool *isnulls,
                           PgSysColumns *syscols, bool *has_data);
 
+  // Fetch a batch of rows, see PgDml::FetchBatch().
+  CHECKED_STATUS DmlFetchBatch(PgStatement *handle, int32_t natts, int32_t max_rows,
+                               uint64_t *values, bool *isnulls, PgSysColumns *syscols,
+                               int32_t *nrows);
+
   // DB Operations: SET, WHERE, ORDER_BY, GROUP_BY, etc.
   // + The following operations are run by DocDB.
   //   - API for "set_clause" (not yet implemented).
+  //   - API for "where_expr", DmlAppendFilter(). Postgres still checks the rows it receives.
   //
   // + The following operations are run by Postgres layer. An API might be added to move these
   //   operations to DocDB.
-  //   - API for "where_expr"
   //   - API for "order_by_expr"
   //   - API for "group_by_expr"
 
@@ -248,6 +260,19 @@ class PgApiImpl {
 
   CHECKED_STATUS ExecInsert(PgStatement *handle);
 
+  //------------------------------------------------------------------------------------------------
+  // Bulk insert.
+  CHECKED_STATUS NewBulkInsert(PgSession *pg_session, const PgObjectId& table_id,
+                               PgStatement **handle);
+
+  CHECKED_STATUS BulkInsertAddColumn(PgStatement *handle, int attr_num,
+                                     const YBCPgTypeEntity *type_entity);
+
+  CHECKED_STATUS BulkInsertAppendRows(PgStatement *handle, int nrows, const uint64_t *values,
+                                      const bool *isnulls);
+
+  CHECKED_STATUS BulkInsertFlush(PgStatement *handle);
+
   //------------------------------------------------------------------------------------------------
   // Update.
   CHECKED_STATUS NewUpdate(PgSession *pg_session, const PgObjectId& table_id, PgStatement **handle);
@@ -267,6 +292,11 @@ class PgApiImpl {
 
   CHECKED_STATUS ExecSelect(PgStatement *handle);
 
+  CHECKED_STATUS SelectSetSampleSize(PgStatement *handle, int sample_size);
+
+  CHECKED_STATUS SelectGetSampleStats(PgStatement *handle, int natts, double *num_rows,
+                                      double *null_fracs, double *n_distincts);
+
   //------------------------------------------------------------------------------------------------
   // Transaction control.
   PgTxnManager* GetPgTxnManager() { return pg_txn_manager_.get(); }
@@ -323,6 +353,9 @@ class PgApiImpl {
   scoped_refptr<server::HybridClock> clock_;
   scoped_refptr<PgTxnManager> pg_txn_manager_;
 
+  // Tables opened by the sessions, shared so that each table is fetched once per process.
+  PgTableCache::ScopedRefPtr table_cache_;
+
   // Mapping table of YugaByte and PostgreSQL datatypes.
   std::unordered_map<int, const YBCPgTypeEntity *>type_map_;
 };
@@ -18,6 +18,8 @@
 
 #include <dirent.h>
 
+#include <vector>
+
 #include "yb/client/client.h"
 #include "yb/integration-tests/external_mini_cluster.h"
 #include "yb/master/mini_master.h"
@@ -117,6 +119,10 @@ YBCStatus YBCTestNewConstantFloat8(YBCPgStatement stmt, double value, bool is_nu
 YBCStatus YBCTestNewConstantText(YBCPgStatement stmt, const char *value, bool is_null,
                                  YBCPgExpr *expr_handle);
 
+// Boolean operator expression with the given arguments.
+YBCStatus YBCTestNewOperator(YBCPgStatement stmt, const char *opname,
+                             const std::vector<YBCPgExpr>& args, YBCPgExpr *expr_handle);
+
 }  // namespace pggate
 }  // namespace yb
 
@@ -0,0 +1,145 @@
+//--------------------------------------------------------------------------------------------------
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+//--------------------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <memory>
+
+#include <gflags/gflags.h>
+
+#include "yb/yql/pggate/test/pggate_test.h"
+#include "yb/util/ybc-internal.h"
+
+DECLARE_int32(pggate_bulk_insert_batch_rows);
+
+namespace yb {
+namespace pggate {
+
+class PggateTestBulkInsert : public PggateTest {
+};
+
+TEST_F(PggateTestBulkInsert, TestBulkInsert) {
+  CHECK_OK(Init("TestBulkInsert"));
+
+  // Send the rows in several batches.
+  FLAGS_pggate_bulk_insert_batch_rows = 10;
+
+  const char *tabname = "basic_table";
+  const YBCPgOid tab_oid = 3;
+  YBCPgStatement pg_stmt;
+
+  // Create table in the connected database.
+  int col_count = 0;
+  CHECK_YBC_STATUS(YBCPgNewCreateTable(pg_session_, kDefaultDatabase, kDefaultSchema, tabname,
+                                       kDefaultDatabaseOid, tab_oid,
+                                       false /* is_shared_table */, true /* if_not_exist */,
+                                       false /* add_primary_key */, &pg_stmt));
+  CHECK_YBC_STATUS(YBCTestCreateTableAddColumn(pg_stmt, "hash_key", ++col_count,
+                                             DataType::INT64, true, true));
+  CHECK_YBC_STATUS(YBCTestCreateTableAddColumn(pg_stmt, "id", ++col_count,
+                                             DataType::INT32, false, true));
+  CHECK_YBC_STATUS(YBCTestCreateTableAddColumn(pg_stmt, "project_count", ++col_count,
+                                             DataType::INT32, false, false));
+  CHECK_YBC_STATUS(YBCPgExecCreateTable(pg_stmt));
+  CHECK_YBC_STATUS(YBCPgDeleteStatement(pg_stmt));
+  pg_stmt = nullptr;
+
+  // BULK INSERT -----------------------------------------------------------------------------------
+  const YBCPgTypeEntity *int8_type = YBCPgFindTypeEntity(INT8OID);
+  const YBCPgTypeEntity *int4_type = YBCPgFindTypeEntity(INT4OID);
+  CHECK_YBC_STATUS(YBCPgNewBulkInsert(pg_session_, kDefaultDatabaseOid, tab_oid, &pg_stmt));
+  CHECK_YBC_STATUS(YBCPgBulkInsertAddColumn(pg_stmt, 1, int8_type));
+  CHECK_YBC_STATUS(YBCPgBulkInsertAddColumn(pg_stmt, 2, int4_type));
+  CHECK_YBC_STATUS(YBCPgBulkInsertAddColumn(pg_stmt, 3, int4_type));
+
+  // Rows seed = 1..25, the last one without project_count.
+  const int insert_row_count = 25;
+  std::vector<uint64_t> values;
+  std::vector<bool> isnulls;
+  for (int seed = 1; seed <= insert_row_count; seed++) {
+    int64_t hash = seed;
+    int32_t id = seed;
+    int32_t project_count = 100 + seed;
+    values.push_back(int8_type->yb_to_datum(&hash, 0, nullptr));
+    values.push_back(int4_type->yb_to_datum(&id, 0, nullptr));
+    values.push_back(int4_type->yb_to_datum(&project_count, 0, nullptr));
+    isnulls.push_back(false);
+    isnulls.push_back(false);
+    isnulls.push_back(seed == insert_row_count);
+  }
+  std::unique_ptr<bool[]> isnull_array(new bool[isnulls.size()]);
+  std::copy(isnulls.begin(), isnulls.end(), isnull_array.get());
+
+  // Append the rows in two calls, which do not line up with the batches.
+  const int first_rows = 13;
+  CHECK_YBC_STATUS(YBCPgBulkInsertAppendRows(pg_stmt, first_rows, values.data(),
+                                             isnull_array.get()));
+  CHECK_YBC_STATUS(YBCPgBulkInsertAppendRows(pg_stmt, insert_row_count - first_rows,
+                                             values.data() + first_rows * col_count,
+                                             isnull_array.get() + first_rows * col_count));
+  CHECK_YBC_STATUS(YBCPgBulkInsertFlush(pg_stmt));
+  CHECK_YBC_STATUS(YBCPgDeleteStatement(pg_stmt));
+  pg_stmt = nullptr;
+  CommitTransaction();
+
+  // A key column must have a value.
+  CHECK_YBC_STATUS(YBCPgNewBulkInsert(pg_session_, kDefaultDatabaseOid, tab_oid, &pg_stmt));
+  CHECK_YBC_STATUS(YBCPgBulkInsertAddColumn(pg_stmt, 1, int8_type));
+  CHECK(!YBCStatusIsOK(YBCPgBulkInsertAppendRows(pg_stmt, 1, values.data(),
+                                                 isnull_array.get())));
+  CHECK_YBC_STATUS(YBCPgDeleteStatement(pg_stmt));
+  pg_stmt = nullptr;
+
+  // SELECT ----------------------------------------------------------------------------------------
+  LOG(INFO) << "Test SELECTing the bulk inserted rows";
+  CHECK_YBC_STATUS(YBCPgNewSelect(pg_session_, kDefaultDatabaseOid, tab_oid, kInvalidOid, &pg_stmt,
+                                  nullptr /* read_time */));
+
+  YBCPgExpr colref;
+  YBCTestNewColumnRef(pg_stmt, 1, DataType::INT64, &colref);
+  CHECK_YBC_STATUS(YBCPgDmlAppendTarget(pg_stmt, colref));
+  YBCTestNewColumnRef(pg_stmt, 2, DataType::INT32, &colref);
+  CHECK_YBC_STATUS(YBCPgDmlAppendTarget(pg_stmt, colref));
+  YBCTestNewColumnRef(pg_stmt, 3, DataType::INT32, &colref);
+  CHECK_YBC_STATUS(YBCPgDmlAppendTarget(pg_stmt, colref));
+  CHECK_YBC_STATUS(YBCPgExecSelect(pg_stmt));
+
+  uint64_t *row = static_cast<uint64_t*>(YBCPAlloc(col_count * sizeof(uint64_t)));
+  bool *row_isnulls = static_cast<bool*>(YBCPAlloc(col_count * sizeof(bool)));
+  int select_row_count = 0;
+  while (true) {
+    bool has_data = false;
+    CHECK_YBC_STATUS(YBCPgDmlFetch(pg_stmt, col_count, row, row_isnulls, nullptr, &has_data));
+    if (!has_data) {
+      break;
+    }
+    select_row_count++;
+
+    int32_t id = row[0];
+    CHECK_EQ(row[1], id);
+    if (id == insert_row_count) {
+      CHECK(row_isnulls[2]) << "Unexpected value for project_count";
+    } else {
+      CHECK(!row_isnulls[2]);
+      CHECK_EQ(row[2], 100 + id);
+    }
+  }
+  CHECK_EQ(select_row_count, insert_row_count) << "Unexpected row count";
+
+  CHECK_YBC_STATUS(YBCPgDeleteStatement(pg_stmt));
+  pg_stmt = nullptr;
+}
+
+} // namespace pggate
+} // namespace yb
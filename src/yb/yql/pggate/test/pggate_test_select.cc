@@ -13,6 +13,8 @@
 //
 //--------------------------------------------------------------------------------------------------
 
+#include <algorithm>
+
 #include "yb/yql/pggate/test/pggate_test.h"
 #include "yb/util/ybc-internal.h"
 
@@ -259,6 +261,63 @@ TEST_F(PggateTestSelect, TestSelectOneTablet) {
 
   CHECK_YBC_STATUS(YBCPgDeleteStatement(pg_stmt));
   pg_stmt = nullptr;
+
+  // SELECT ----------------------------------------------------------------------------------------
+  LOG(INFO) << "Test SELECTing with filters evaluated by DocDB";
+  CHECK_YBC_STATUS(YBCPgNewSelect(pg_session_, kDefaultDatabaseOid, tab_oid, kInvalidOid, &pg_stmt,
+                                  nullptr /* read_time */));
+
+  YBCTestNewColumnRef(pg_stmt, 2, DataType::INT32, &colref);
+  CHECK_YBC_STATUS(YBCPgDmlAppendTarget(pg_stmt, colref));
+
+  CHECK_YBC_STATUS(YBCTestNewConstantInt8(pg_stmt, 0, false, &expr_hash));
+  CHECK_YBC_STATUS(YBCPgDmlBindColumn(pg_stmt, 1, expr_hash));
+
+  // WHERE project_count >= 104 AND (dependent_count <> 6 OR job IS NULL)
+  //   AND id IN (1, 4, 6, 7).
+  YBCPgExpr projcnt_ref, depcnt_ref, job_ref, id_ref;
+  YBCTestNewColumnRef(pg_stmt, 4, DataType::INT32, &projcnt_ref);
+  YBCTestNewColumnRef(pg_stmt, 3, DataType::INT16, &depcnt_ref);
+  YBCTestNewColumnRef(pg_stmt, 6, DataType::STRING, &job_ref);
+  YBCTestNewColumnRef(pg_stmt, 2, DataType::INT32, &id_ref);
+  YBCPgExpr expr_min_projcnt;
+  CHECK_YBC_STATUS(YBCTestNewConstantInt4(pg_stmt, 104, false, &expr_min_projcnt));
+  CHECK_YBC_STATUS(YBCTestNewConstantInt2(pg_stmt, 6, false, &expr_depcnt));
+  std::vector<YBCPgExpr> in_args = { id_ref };
+  for (int32_t id : { 1, 4, 6, 7 }) {
+    CHECK_YBC_STATUS(YBCTestNewConstantInt4(pg_stmt, id, false, &expr_id));
+    in_args.push_back(expr_id);
+  }
+
+  YBCPgExpr filter_projcnt, filter_depcnt, filter_job, filter_or, filter_in;
+  CHECK_YBC_STATUS(YBCTestNewOperator(pg_stmt, ">=", { projcnt_ref, expr_min_projcnt },
+                                      &filter_projcnt));
+  CHECK_YBC_STATUS(YBCTestNewOperator(pg_stmt, "<>", { depcnt_ref, expr_depcnt }, &filter_depcnt));
+  CHECK_YBC_STATUS(YBCTestNewOperator(pg_stmt, "is_null", { job_ref }, &filter_job));
+  CHECK_YBC_STATUS(YBCTestNewOperator(pg_stmt, "or", { filter_depcnt, filter_job }, &filter_or));
+  CHECK_YBC_STATUS(YBCTestNewOperator(pg_stmt, "in", in_args, &filter_in));
+  CHECK_YBC_STATUS(YBCPgDmlAppendFilter(pg_stmt, filter_projcnt));
+  CHECK_YBC_STATUS(YBCPgDmlAppendFilter(pg_stmt, filter_or));
+  CHECK_YBC_STATUS(YBCPgDmlAppendFilter(pg_stmt, filter_in));
+
+  // Execute select statement.
+  CHECK_YBC_STATUS(YBCPgExecSelect(pg_stmt));
+
+  // Only the rows with ids 4 and 7 match.
+  std::vector<int32_t> selected_ids;
+  for (;;) {
+    bool has_data = false;
+    CHECK_YBC_STATUS(YBCPgDmlFetch(pg_stmt, col_count, values, isnulls, &syscols, &has_data));
+    if (!has_data) {
+      break;
+    }
+    selected_ids.push_back(static_cast<int32_t>(values[1]));
+  }
+  std::sort(selected_ids.begin(), selected_ids.end());
+  CHECK(selected_ids == std::vector<int32_t>({ 4, 7 })) << "Unexpected rows selected";
+
+  CHECK_YBC_STATUS(YBCPgDeleteStatement(pg_stmt));
+  pg_stmt = nullptr;
 }
 
 } // namespace pggate
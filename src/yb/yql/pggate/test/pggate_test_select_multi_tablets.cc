@@ -13,6 +13,8 @@
 //
 //--------------------------------------------------------------------------------------------------
 
+#include <set>
+
 #include "yb/yql/pggate/test/pggate_test.h"
 #include "yb/util/ybc-internal.h"
 
@@ -269,6 +271,84 @@ TEST_F(PggateTestSelectMultiTablets, TestSelectMultiTablets) {
 
   CHECK_YBC_STATUS(YBCPgDeleteStatement(pg_stmt));
   pg_stmt = nullptr;
+
+  // SELECT ----------------------------------------------------------------------------------------
+  LOG(INFO) << "Test SELECTing from partitioned table WITH a list of HASH column values";
+  CHECK_YBC_STATUS(YBCPgNewSelect(pg_session_, kDefaultDatabaseOid, tab_oid, kInvalidOid, &pg_stmt,
+                                  nullptr /* read_time */));
+
+  YBCTestNewColumnRef(pg_stmt, 1, DataType::INT64, &colref);
+  CHECK_YBC_STATUS(YBCPgDmlAppendTarget(pg_stmt, colref));
+  YBCTestNewColumnRef(pg_stmt, 2, DataType::INT32, &colref);
+  CHECK_YBC_STATUS(YBCPgDmlAppendTarget(pg_stmt, colref));
+
+  // SELECT ... WHERE hash IN (2, 4, 6, 9). There is no row for 9.
+  const std::vector<int> in_values = { 2, 4, 6, 9 };
+  std::vector<YBCPgExpr> in_exprs;
+  for (int value : in_values) {
+    CHECK_YBC_STATUS(YBCTestNewConstantInt8(pg_stmt, value, false, &expr_hash));
+    in_exprs.push_back(expr_hash);
+  }
+  CHECK_YBC_STATUS(YBCPgDmlBindColumnIn(pg_stmt, 1, in_exprs.size(), in_exprs.data()));
+
+  YBCPgExecSelect(pg_stmt);
+
+  // The rows are returned in the order of the values.
+  for (int i = 0; i < 3; i++) {
+    bool has_data = false;
+    YBCPgDmlFetch(pg_stmt, 2, values, isnulls, nullptr, &has_data);
+    CHECK(has_data) << "Not all selected rows are fetched";
+    CHECK_EQ(values[0], in_values[i]);
+    CHECK_EQ(values[1], in_values[i]);
+  }
+  has_data = false;
+  YBCPgDmlFetch(pg_stmt, 2, values, isnulls, nullptr, &has_data);
+  CHECK(!has_data) << "Unexpected row";
+
+  CHECK_YBC_STATUS(YBCPgDeleteStatement(pg_stmt));
+  pg_stmt = nullptr;
+
+  // SELECT ----------------------------------------------------------------------------------------
+  LOG(INFO) << "Test sampling a partitioned table";
+  CHECK_YBC_STATUS(YBCPgNewSelect(pg_session_, kDefaultDatabaseOid, tab_oid, kInvalidOid, &pg_stmt,
+                                  nullptr /* read_time */));
+
+  YBCTestNewColumnRef(pg_stmt, 1, DataType::INT64, &colref);
+  CHECK_YBC_STATUS(YBCPgDmlAppendTarget(pg_stmt, colref));
+  YBCTestNewColumnRef(pg_stmt, 2, DataType::INT32, &colref);
+  CHECK_YBC_STATUS(YBCPgDmlAppendTarget(pg_stmt, colref));
+
+  const int sample_size = 3;
+  CHECK_YBC_STATUS(YBCPgSelectSetSampleSize(pg_stmt, sample_size));
+  YBCPgExecSelect(pg_stmt);
+
+  // The sample has distinct rows of the table.
+  std::set<int64_t> sampled_keys;
+  has_data = false;
+  YBCPgDmlFetch(pg_stmt, 2, values, isnulls, nullptr, &has_data);
+  while (has_data) {
+    CHECK_GE(values[0], 1);
+    CHECK_LE(values[0], insert_row_count);
+    CHECK_EQ(values[1], values[0]);
+    CHECK(sampled_keys.insert(values[0]).second) << "Row sampled twice: " << values[0];
+    YBCPgDmlFetch(pg_stmt, 2, values, isnulls, nullptr, &has_data);
+  }
+  CHECK_EQ(sampled_keys.size(), static_cast<size_t>(sample_size));
+
+  // The statistics are over all the rows of the table.
+  double num_rows = 0;
+  double null_fracs[2];
+  double n_distincts[2];
+  CHECK_YBC_STATUS(YBCPgSelectGetSampleStats(pg_stmt, 2, &num_rows, null_fracs, n_distincts));
+  CHECK_EQ(num_rows, insert_row_count);
+  for (int i = 0; i < 2; i++) {
+    CHECK_EQ(null_fracs[i], 0);
+    CHECK_GE(n_distincts[i], insert_row_count - 0.5);
+    CHECK_LE(n_distincts[i], insert_row_count + 0.5);
+  }
+
+  CHECK_YBC_STATUS(YBCPgDeleteStatement(pg_stmt));
+  pg_stmt = nullptr;
 }
 
 } // namespace pggate
@@ -94,6 +94,15 @@ YBCStatus YBCTestNewColumnRef(YBCPgStatement stmt, int attr_num, DataType yb_typ
 
 //--------------------------------------------------------------------------------------------------
 
+YBCStatus YBCTestNewOperator(YBCPgStatement stmt, const char *opname,
+                             const std::vector<YBCPgExpr>& args, YBCPgExpr *expr_handle) {
+  YBCStatus status = YBCPgNewOperator(stmt, opname, YBCPgFindTypeEntity(BOOLOID), expr_handle);
+  for (auto it = args.begin(); YBCStatusIsOK(status) && it != args.end(); ++it) {
+    status = YBCPgOperatorAppendArg(*expr_handle, *it);
+  }
+  return status;
+}
+
 YBCStatus YBCTestNewConstantBool(YBCPgStatement stmt, bool value, bool is_null,
                                  YBCPgExpr *expr_handle) {
   const YBCPgTypeEntity *type_entity = YBCPgFindTypeEntity(BOOLOID);
@@ -309,6 +309,12 @@ YBCStatus YBCPgDmlBindIndexColumn(YBCPgStatement handle, int attr_num, YBCPgExpr
   return ToYBCStatus(pgapi->DmlBindIndexColumn(handle, attr_num, attr_value));
 }
 
+YBCStatus YBCPgDmlBindColumnIn(YBCPgStatement handle, int attr_num, int n_attr_values,
+                               YBCPgExpr *attr_values) {
+  return ToYBCStatus(pgapi->DmlBindColumnIn(
+      handle, attr_num, std::vector<PgExpr*>(attr_values, attr_values + n_attr_values)));
+}
+
 YBCStatus YBCPgDmlAssignColumn(YBCPgStatement handle,
                                int attr_num,
                                YBCPgExpr attr_value) {
@@ -320,6 +326,17 @@ YBCStatus YBCPgDmlFetch(YBCPgStatement handle, int32_t natts, uint64_t *values,
   return ToYBCStatus(pgapi->DmlFetch(handle, natts, values, isnulls, syscols, has_data));
 }
 
+YBCStatus YBCPgDmlFetchBatch(YBCPgStatement handle, int32_t natts, int32_t max_rows,
+                             uint64_t *values, bool *isnulls, YBCPgSysColumns *syscols,
+                             int32_t *nrows) {
+  return ToYBCStatus(pgapi->DmlFetchBatch(handle, natts, max_rows, values, isnulls, syscols,
+                                          nrows));
+}
+
+YBCStatus YBCPgDmlAppendFilter(YBCPgStatement handle, YBCPgExpr filter) {
+  return ToYBCStatus(pgapi->DmlAppendFilter(handle, filter));
+}
+
 // INSERT Operations -------------------------------------------------------------------------------
 YBCStatus YBCPgNewInsert(YBCPgSession pg_session,
                          const YBCPgOid database_oid,
@@ -333,6 +350,30 @@ YBCStatus YBCPgExecInsert(YBCPgStatement handle) {
   return ToYBCStatus(pgapi->ExecInsert(handle));
 }
 
+// BULK INSERT Operations --------------------------------------------------------------------------
+YBCStatus YBCPgNewBulkInsert(YBCPgSession pg_session,
+                             const YBCPgOid database_oid,
+                             const YBCPgOid table_oid,
+                             YBCPgStatement *handle) {
+  const PgObjectId table_id(database_oid, table_oid);
+  return ToYBCStatus(pgapi->NewBulkInsert(pg_session, table_id, handle));
+}
+
+YBCStatus YBCPgBulkInsertAddColumn(YBCPgStatement handle,
+                                   int attr_num,
+                                   const YBCPgTypeEntity *type_entity) {
+  return ToYBCStatus(pgapi->BulkInsertAddColumn(handle, attr_num, type_entity));
+}
+
+YBCStatus YBCPgBulkInsertAppendRows(YBCPgStatement handle, int nrows, const uint64_t *values,
+                                    const bool *isnulls) {
+  return ToYBCStatus(pgapi->BulkInsertAppendRows(handle, nrows, values, isnulls));
+}
+
+YBCStatus YBCPgBulkInsertFlush(YBCPgStatement handle) {
+  return ToYBCStatus(pgapi->BulkInsertFlush(handle));
+}
+
 // UPDATE Operations -------------------------------------------------------------------------------
 YBCStatus YBCPgNewUpdate(YBCPgSession pg_session,
                          const YBCPgOid database_oid,
@@ -375,6 +416,16 @@ YBCStatus YBCPgExecSelect(YBCPgStatement handle) {
   return ToYBCStatus(pgapi->ExecSelect(handle));
 }
 
+YBCStatus YBCPgSelectSetSampleSize(YBCPgStatement handle, int sample_size) {
+  return ToYBCStatus(pgapi->SelectSetSampleSize(handle, sample_size));
+}
+
+YBCStatus YBCPgSelectGetSampleStats(YBCPgStatement handle, int natts, double *num_rows,
+                                    double *null_fracs, double *n_distincts) {
+  return ToYBCStatus(pgapi->SelectGetSampleStats(handle, natts, num_rows, null_fracs,
+                                                 n_distincts));
+}
+
 //--------------------------------------------------------------------------------------------------
 // Expression Operations
 //--------------------------------------------------------------------------------------------------
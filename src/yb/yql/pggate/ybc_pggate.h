@@ -162,6 +162,8 @@ YBCStatus YBCPgNewCreateIndex(YBCPgSession pg_session,
                               bool if_not_exist,
                               YBCPgStatement *handle);
 
+// The key columns of the index are added first, then its INCLUDE columns, which are neither hash
+// nor range columns.
 YBCStatus YBCPgCreateIndexAddColumn(YBCPgStatement handle, const char *attr_name, int attr_num,
                                     const YBCPgTypeEntity *attr_type, bool is_hash, bool is_range);
 
@@ -196,6 +198,12 @@ YBCStatus YBCPgDmlAppendTarget(YBCPgStatement handle, YBCPgExpr target);
 YBCStatus YBCPgDmlBindColumn(YBCPgStatement handle, int attr_num, YBCPgExpr attr_value);
 YBCStatus YBCPgDmlBindIndexColumn(YBCPgStatement handle, int attr_num, YBCPgExpr attr_value);
 
+// Binds a primary-key column of a SELECT to a list of values, as in "WHERE key IN (...)", such as
+// the outer rows of a batched nested loop join. The rows of all values are read with one request
+// per tablet, and are returned value after value, in the order of attr_values.
+YBCStatus YBCPgDmlBindColumnIn(YBCPgStatement handle, int attr_num, int n_attr_values,
+                               YBCPgExpr *attr_values);
+
 // API for SET clause.
 YBCStatus YBCPgDmlAssignColumn(YBCPgStatement handle,
                                int attr_num,
@@ -206,13 +214,25 @@ YBCStatus YBCPgDmlAssignColumn(YBCPgStatement handle,
 YBCStatus YBCPgDmlFetch(YBCPgStatement handle, int32_t natts, uint64_t *values, bool *isnulls,
                         YBCPgSysColumns *syscols, bool *has_data);
 
+// Same as YBCPgDmlFetch(), for up to max_rows rows at once: values and isnulls have natts entries
+// per row, row after row, and syscols one entry per row. Only the first row might wait for DocDB,
+// the others are the rows already received. nrows is set to the number of rows fetched, 0 when
+// there are no more rows.
+YBCStatus YBCPgDmlFetchBatch(YBCPgStatement handle, int32_t natts, int32_t max_rows,
+                             uint64_t *values, bool *isnulls, YBCPgSysColumns *syscols,
+                             int32_t *nrows);
+
+// Append a boolean expression, built of column references, constants and operators, that the rows
+// selected by a SELECT should match. The filters are combined with AND and evaluated by DocDB, so
+// that rows that do not match are not sent back. Rows for which a filter is null do not match.
+YBCStatus YBCPgDmlAppendFilter(YBCPgStatement handle, YBCPgExpr filter);
+
 // DB Operations: WHERE, ORDER_BY, GROUP_BY, etc.
 // + The following operations are run by DocDB.
-//   - Not yet
+//   - API for "where_expr", YBCPgDmlAppendFilter().
 //
 // + The following operations are run by Postgres layer. An API might be added to move these
 //   operations to DocDB.
-//   - API for "where_expr"
 //   - API for "order_by_expr"
 //   - API for "group_by_expr"
 
@@ -224,6 +244,26 @@ YBCStatus YBCPgNewInsert(YBCPgSession pg_session,
 
 YBCStatus YBCPgExecInsert(YBCPgStatement handle);
 
+// BULK INSERT -------------------------------------------------------------------------------------
+// Inserts the rows of COPY FROM in batches. The columns are added once, in the order of the values
+// of each row, then the rows are appended in the layout of YBCPgDmlFetch(): natts values and null
+// flags per row, row after row. Rows are sent in the background as batches fill up, and the errors
+// of a batch might only be returned by a later call. YBCPgBulkInsertFlush() sends the rest and
+// waits for them. Delete the statement with YBCPgDeleteStatement().
+YBCStatus YBCPgNewBulkInsert(YBCPgSession pg_session,
+                             YBCPgOid database_oid,
+                             YBCPgOid table_oid,
+                             YBCPgStatement *handle);
+
+YBCStatus YBCPgBulkInsertAddColumn(YBCPgStatement handle,
+                                   int attr_num,
+                                   const YBCPgTypeEntity *type_entity);
+
+YBCStatus YBCPgBulkInsertAppendRows(YBCPgStatement handle, int nrows, const uint64_t *values,
+                                    const bool *isnulls);
+
+YBCStatus YBCPgBulkInsertFlush(YBCPgStatement handle);
+
 // UPDATE ------------------------------------------------------------------------------------------
 YBCStatus YBCPgNewUpdate(YBCPgSession pg_session,
                          YBCPgOid database_oid,
@@ -252,6 +292,17 @@ YBCStatus YBCPgNewSelect(YBCPgSession pg_session,
 
 YBCStatus YBCPgExecSelect(YBCPgStatement handle);
 
+// Makes a SELECT on a table a sampling scan, such as the scan that ANALYZE gathers the statistics
+// of a table with: DocDB reads all the rows, and the SELECT returns a uniform random sample of up
+// to sample_size of them in place of the rows. Call before YBCPgExecSelect().
+YBCStatus YBCPgSelectSetSampleSize(YBCPgStatement handle, int sample_size);
+
+// Once all the rows of a sampling scan are fetched, returns the number of rows of the table, and
+// for each of the first natts targets, in the order they are appended, the fraction of the rows
+// where it is null and the estimated number of its distinct non-null values.
+YBCStatus YBCPgSelectGetSampleStats(YBCPgStatement handle, int natts, double *num_rows,
+                                    double *null_fracs, double *n_distincts);
+
 // Transaction control -----------------------------------------------------------------------------
 YBCPgTxnManager YBCGetPgTxnManager();
 
@@ -13,7 +13,11 @@
 
 #include "yb/yql/redis/redisserver/redis_commands.h"
 
+#include <mutex>
+#include <unordered_set>
+
 #include <boost/algorithm/string.hpp>
+#include <boost/preprocessor/cat.hpp>
 #include <boost/preprocessor/seq/for_each.hpp>
 #include <boost/preprocessor/stringize.hpp>
 
@@ -63,12 +67,14 @@ DEFINE_int32(redis_keys_threshold, 10000,
 __attribute__((unused))
 DEFINE_validator(redis_passwords_separator, &ValidateRedisPasswordSeparator);
 
+DECLARE_bool(redis_enable_client_tracking);
+
 namespace yb {
 namespace redisserver {
 
 #define REDIS_COMMANDS \
     ((get, Get, 2, READ)) \
-    ((mget, MGet, -2, READ)) \
+    ((mget, MGet, -2, MULTI_READ)) \
     ((hget, HGet, 3, READ)) \
     ((tsget, TsGet, 3, READ)) \
     ((hmget, HMGet, -3, READ)) \
@@ -87,7 +93,7 @@ namespace redisserver {
     ((zcard, ZCard, 2, READ)) \
     ((rename, Rename, 3, LOCAL)) \
     ((set, Set, -3, WRITE)) \
-    ((mset, MSet, -3, WRITE)) \
+    ((mset, MSet, -3, MULTI_WRITE)) \
     ((hset, HSet, 4, WRITE)) \
     ((hmset, HMSet, -4, WRITE)) \
     ((hincrby, HIncrBy, 4, WRITE)) \
@@ -95,7 +101,7 @@ namespace redisserver {
     ((sadd, SAdd, -3, WRITE)) \
     ((srem, SRem, -3, WRITE)) \
     ((tsadd, TsAdd, -4, WRITE)) \
-    ((tsrangebytime, TsRangeByTime, 4, READ)) \
+    ((tsrangebytime, TsRangeByTime, -4, READ)) \
     ((tsrevrangebytime, TsRevRangeByTime, -4, READ)) \
     ((tslastn, TsLastN, 3, READ)) \
     ((tscard, TsCard, 2, READ)) \
@@ -108,7 +114,7 @@ namespace redisserver {
     ((zadd, ZAdd, -4, WRITE)) \
     ((getset, GetSet, 3, WRITE)) \
     ((append, Append, 3, WRITE)) \
-    ((del, Del, 2, WRITE)) \
+    ((del, Del, -2, MULTI_WRITE)) \
     ((setrange, SetRange, 4, WRITE)) \
     ((incr, Incr, 2, WRITE)) \
     ((incrby, IncrBy, 3, WRITE)) \
@@ -124,6 +130,7 @@ namespace redisserver {
     ((ping, Ping, -1, LOCAL)) \
     ((command, Command, -1, LOCAL)) \
     ((monitor, Monitor, 1, LOCAL)) \
+    ((client, Client, -2, LOCAL)) \
     ((pubsub, PubSub, -2, LOCAL)) \
     ((publish, Publish, 3, LOCAL)) \
     ((subscribe, Subscribe, -2, LOCAL)) \
@@ -160,6 +167,8 @@ BOOST_PP_SEQ_FOR_EACH(DEFINE_HISTOGRAM, ~, REDIS_COMMANDS)
 
 #define READ_OP yb::client::YBRedisReadOp
 #define WRITE_OP yb::client::YBRedisWriteOp
+#define MULTI_READ_OP READ_OP
+#define MULTI_WRITE_OP WRITE_OP
 #define LOCAL_OP RedisResponsePB
 #define CLUSTER_OP RedisResponsePB
 
@@ -208,10 +217,168 @@ void Command(
   context->Apply(idx, std::move(op), info.metrics);
 }
 
+// Collects responses to the single-key operations that a multi-key command is split into, and
+// responds to the command when all of them are done.
+class MultiKeyResponse {
+ public:
+  typedef std::vector<std::shared_ptr<client::YBRedisOp>> Ops;
+  typedef std::function<void(const Ops&, RedisResponsePB*)> Merger;
+
+  MultiKeyResponse(const RedisCommandInfo& info, size_t idx, BatchContext* context, Merger merger)
+      : call_(context->call()), idx_(idx), metrics_(info.metrics), merger_(std::move(merger)) {}
+
+  Ops& ops() {
+    return ops_;
+  }
+
+  void Start() {
+    left_.store(ops_.size(), std::memory_order_release);
+  }
+
+  void Done(const Status& status) {
+    if (!status.ok()) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (status_.ok()) {
+        status_ = status;
+      }
+    }
+    if (left_.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+      return;
+    }
+    if (!status_.ok()) {
+      call_->RespondFailure(idx_, status_);
+      return;
+    }
+    RedisResponsePB response;
+    merger_(ops_, &response);
+    call_->RespondSuccess(idx_, metrics_, &response);
+  }
+
+ private:
+  std::shared_ptr<RedisInboundCall> call_;
+  const size_t idx_;
+  rpc::RpcMethodMetrics metrics_;
+  Merger merger_;
+  Ops ops_;
+  std::atomic<size_t> left_{0};
+  std::mutex mutex_;
+  Status status_;
+};
+
+// Splits the command into single-key operations of 'args_per_key' arguments each, parsed by
+// 'parser'. They are applied to the batch as usual, so operations for the same tablet are sent
+// in one RPC and different tablets are processed in parallel. 'merger' builds the response from
+// the responses to the operations, in the order of keys.
+template<class Op>
+void MultiKeyCommand(
+    const RedisCommandInfo& info,
+    size_t idx,
+    size_t args_per_key,
+    Parser<Op> parser,
+    MultiKeyResponse::Merger merger,
+    BatchContext* context) {
+  VLOG(1) << "Processing " << info.name << ".";
+
+  auto table = context->table();
+  if (!table) {
+    RespondWithFailure(context->call(), idx, "Could not open YBTable");
+    return;
+  }
+
+  const auto& command = context->command(idx);
+  if ((command.size() - 1) % args_per_key != 0) {
+    RespondWithFailure(context->call(), idx, "Wrong number of arguments.");
+    return;
+  }
+  auto response = std::make_shared<MultiKeyResponse>(info, idx, context, std::move(merger));
+  std::vector<std::shared_ptr<Op>> ops;
+  RedisClientCommand key_command;
+  for (size_t i = 1; i < command.size(); i += args_per_key) {
+    key_command.assign(1, command[0]);
+    key_command.insert(key_command.end(), command.begin() + i, command.begin() + i + args_per_key);
+    auto op = std::make_shared<Op>(table);
+    Status s = parser(op.get(), key_command);
+    if (!s.ok()) {
+      RespondWithFailure(context->call(), idx, s.message().ToBuffer());
+      return;
+    }
+    response->ops().push_back(op);
+    ops.push_back(std::move(op));
+  }
+  response->Start();
+  for (auto& op : ops) {
+    context->Apply(idx, std::move(op), info.metrics,
+                   std::bind(&MultiKeyResponse::Done, response, _1));
+  }
+}
+
+// Copies the first response that is not OK, returns false if there is one.
+bool AllResponsesOk(const MultiKeyResponse::Ops& ops, RedisResponsePB* response) {
+  for (const auto& op : ops) {
+    if (op->response().code() != RedisResponsePB::OK) {
+      *response = op->response();
+      return false;
+    }
+  }
+  return true;
+}
+
+void HandleMGet(const RedisCommandInfo& info, size_t idx, BatchContext* context) {
+  // As in Redis, keys without a string value are returned as nil.
+  auto merger = [](const MultiKeyResponse::Ops& ops, RedisResponsePB* response) {
+    response->set_code(RedisResponsePB::OK);
+    auto* array_response = response->mutable_array_response();
+    for (const auto& op : ops) {
+      const auto& op_response = op->response();
+      if (op_response.code() == RedisResponsePB::OK && op_response.has_string_response()) {
+        array_response->add_elements(EncodeAsBulkString(op_response.string_response()).ToBuffer());
+      } else {
+        array_response->add_elements(kNilResponse);
+      }
+    }
+    array_response->set_encoded(true);
+  };
+  MultiKeyCommand<client::YBRedisReadOp>(info, idx, 1, &ParseGet, merger, context);
+}
+
+// Keys are set independently, so unlike in Redis a concurrent MGET could see some of them set.
+void HandleMSet(const RedisCommandInfo& info, size_t idx, BatchContext* context) {
+  auto merger = [](const MultiKeyResponse::Ops& ops, RedisResponsePB* response) {
+    if (AllResponsesOk(ops, response)) {
+      response->set_code(RedisResponsePB::OK);
+    }
+  };
+  MultiKeyCommand<client::YBRedisWriteOp>(info, idx, 2, &ParseSet, merger, context);
+}
+
+void HandleDel(const RedisCommandInfo& info, size_t idx, BatchContext* context) {
+  auto merger = [](const MultiKeyResponse::Ops& ops, RedisResponsePB* response) {
+    if (!AllResponsesOk(ops, response)) {
+      return;
+    }
+    // The number of deleted keys is reported only when Redis responses are emulated.
+    bool has_count = false;
+    int64_t deleted = 0;
+    for (const auto& op : ops) {
+      if (op->response().has_int_response()) {
+        has_count = true;
+        deleted += op->response().int_response();
+      }
+    }
+    response->set_code(RedisResponsePB::OK);
+    if (has_count) {
+      response->set_int_response(deleted);
+    }
+  };
+  MultiKeyCommand<client::YBRedisWriteOp>(info, idx, 1, &ParseDel, merger, context);
+}
+
 #define READ_COMMAND(cname) \
     Command<yb::client::YBRedisReadOp>(info, idx, &BOOST_PP_CAT(Parse, cname), context)
 #define WRITE_COMMAND(cname) \
     Command<yb::client::YBRedisWriteOp>(info, idx, &BOOST_PP_CAT(Parse, cname), context)
+#define MULTI_READ_COMMAND(cname) BOOST_PP_CAT(Handle, cname)(info, idx, context)
+#define MULTI_WRITE_COMMAND(cname) BOOST_PP_CAT(Handle, cname)(info, idx, context)
 #define LOCAL_COMMAND(cname) \
     BOOST_PP_CAT(Handle, cname)({info, idx, context});
 #define CLUSTER_COMMAND(cname) ClusterCommand(info, idx, context)
@@ -399,6 +566,28 @@ void HandleMonitor(LocalCommandData data) {
   data.context()->service_data()->AppendToMonitors(conn);
 }
 
+// Only CLIENT TRACKING ON|OFF is supported. Invalidations of the keys read by a tracking
+// connection are published to kTrackingInvalidationChannel, which clients subscribe to with
+// another connection, as with the REDIRECT option of Redis.
+void HandleClient(LocalCommandData data) {
+  RedisResponsePB response;
+  if (data.arg_size() != 3 || !boost::iequals(data.arg(1).ToBuffer(), "TRACKING")) {
+    response.set_code(RedisResponsePB_RedisStatusCode_SERVER_ERROR);
+    response.set_error_message("ERR: Only CLIENT TRACKING ON|OFF is supported.");
+  } else if (boost::iequals(data.arg(2).ToBuffer(), "OFF")) {
+    data.call()->connection_context().set_tracking(false);
+  } else if (!boost::iequals(data.arg(2).ToBuffer(), "ON")) {
+    response.set_code(RedisResponsePB_RedisStatusCode_SERVER_ERROR);
+    response.set_error_message("ERR: Syntax error.");
+  } else if (!FLAGS_redis_enable_client_tracking) {
+    response.set_code(RedisResponsePB_RedisStatusCode_SERVER_ERROR);
+    response.set_error_message("ERR: Client tracking is disabled.");
+  } else {
+    data.call()->connection_context().set_tracking(true);
+  }
+  data.Respond(&response);
+}
+
 void HandlePubSub(LocalCommandData data) {
   RedisResponsePB response;
   if (boost::iequals(data.arg(1).ToBuffer(), "CHANNELS") && data.arg_size() <= 3) {
@@ -676,6 +865,9 @@ class RenameData : public std::enable_shared_from_this<RenameData> {
   }
 
   void Respond(RedisResponsePB* response) {
+    auto* service_data = data_.context()->service_data();
+    service_data->InvalidateTrackedKey(data_.arg(1).ToBuffer());
+    service_data->InvalidateTrackedKey(data_.arg(2).ToBuffer());
     data_.Respond(response);
     if (src_functor_) {
       src_functor_(Status::OK());
@@ -1289,6 +1481,22 @@ void RespondWithFailure(
   call->RespondFailure(idx, STATUS_FORMAT(InvalidCommand, "$0 $1: $2", redis_code, cmd, error));
 }
 
+#define READ_COMMAND_NAME_READ(name) BOOST_PP_STRINGIZE(name),
+#define READ_COMMAND_NAME_WRITE(name)
+#define READ_COMMAND_NAME_MULTI_READ(name) BOOST_PP_STRINGIZE(name),
+#define READ_COMMAND_NAME_MULTI_WRITE(name)
+#define READ_COMMAND_NAME_LOCAL(name)
+#define READ_COMMAND_NAME_CLUSTER(name)
+#define DO_READ_COMMAND_NAME(name, cname, arity, type) BOOST_PP_CAT(READ_COMMAND_NAME_, type)(name)
+#define READ_COMMAND_NAME(r, data, elem) DO_READ_COMMAND_NAME elem
+
+bool IsReadCommand(const Slice& name) {
+  static const std::unordered_set<std::string> kReadCommands = {
+    BOOST_PP_SEQ_FOR_EACH(READ_COMMAND_NAME, ~, REDIS_COMMANDS)
+  };
+  return kReadCommands.count(boost::to_lower_copy(name.ToBuffer())) != 0;
+}
+
 void FillRedisCommands(const scoped_refptr<MetricEntity>& metric_entity,
                        const std::function<void(const RedisCommandInfo& info)>& setup_method) {
   BOOST_PP_SEQ_FOR_EACH(POPULATE_HANDLER, ~, REDIS_COMMANDS);
@@ -63,6 +63,9 @@ class RedisServiceData {
   virtual void ForwardToInterestedProxies(
       const std::string& channel, const std::string& message, const IntFunctor& f) = 0;
 
+  // Used for client tracking.
+  virtual void InvalidateTrackedKey(const std::string& key) = 0;
+
   // Used for Auth.
   virtual CHECKED_STATUS GetRedisPasswords(std::vector<std::string>* passwords) = 0;
 
@@ -98,6 +101,20 @@ class BatchContext : public RefCountedThreadSafe<BatchContext> {
       std::shared_ptr<client::YBRedisWriteOp> operation,
       const rpc::RpcMethodMetrics& metrics) = 0;
 
+  // Applies one of the operations that the multi-key command at 'index' is split into. Instead of
+  // responding to the command, 'callback' is invoked when the operation is done.
+  virtual void Apply(
+      size_t index,
+      std::shared_ptr<client::YBRedisReadOp> operation,
+      const rpc::RpcMethodMetrics& metrics,
+      StatusFunctor callback) = 0;
+
+  virtual void Apply(
+      size_t index,
+      std::shared_ptr<client::YBRedisWriteOp> operation,
+      const rpc::RpcMethodMetrics& metrics,
+      StatusFunctor callback) = 0;
+
   virtual void Apply(
       size_t index,
       std::function<bool(client::YBSession*, const StatusFunctor&)> functor,
@@ -134,6 +151,9 @@ void RespondWithFailure(
     const std::string& error,
     const char* error_code = "ERR");
 
+// Whether the command with the given name, in any case, only reads from the database.
+bool IsReadCommand(const Slice& name);
+
 void FillRedisCommands(const scoped_refptr<MetricEntity>& metric_entity,
                        const std::function<void(const RedisCommandInfo& info)>& setup_method);
 
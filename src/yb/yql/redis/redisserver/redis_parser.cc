@@ -145,15 +145,6 @@ CHECKED_STATUS ParseSet(YBRedisWriteOp *op, const RedisClientCommand& args) {
   return Status::OK();
 }
 
-// TODO: support MSET
-CHECKED_STATUS ParseMSet(YBRedisWriteOp *op, const RedisClientCommand& args) {
-  if (args.size() < 3 || args.size() % 2 == 0) {
-    return STATUS_SUBSTITUTE(InvalidCommand,
-        "An MSET request must have at least 3, odd number of arguments, found $0", args.size());
-  }
-  return STATUS(InvalidCommand, "MSET command not yet supported");
-}
-
 CHECKED_STATUS ParseHSet(YBRedisWriteOp *op, const RedisClientCommand& args) {
   const auto& key = args[1];
   const auto& subkey = args[2];
@@ -444,7 +435,7 @@ CHECKED_STATUS ParseAppend(YBRedisWriteOp* op, const RedisClientCommand& args) {
   return Status::OK();
 }
 
-// Note: deleting only one key is supported using one command as of now.
+// Parses deletion of the key args[1], DEL with several keys is split into such commands.
 CHECKED_STATUS ParseDel(YBRedisWriteOp* op, const RedisClientCommand& args) {
   const auto& key = args[1];
   op->mutable_request()->set_allocated_del_request(new RedisDelRequestPB());
@@ -518,11 +509,6 @@ CHECKED_STATUS ParseHGetLikeCommands(YBRedisReadOp* op, const RedisClientCommand
   return ParseCollection(op, args, boost::none, add_string_subkey, remove_duplicates);
 }
 
-// TODO: Support MGET
-CHECKED_STATUS ParseMGet(YBRedisReadOp* op, const RedisClientCommand& args) {
-  return STATUS(InvalidCommand, "MGET command not yet supported");
-}
-
 CHECKED_STATUS ParseHGet(YBRedisReadOp* op, const RedisClientCommand& args) {
   return ParseHGetLikeCommands(op, args, RedisGetRequestPB_GetRequestType_HGET);
 }
@@ -639,6 +625,45 @@ CHECKED_STATUS ParseTsRangeByTime(YBRedisReadOp* op, const RedisClientCommand& a
       RedisCollectionGetRangeRequestPB_GetRangeRequestType_TSRANGEBYTIME));
 
   op->mutable_request()->mutable_key_value()->set_key(key.ToBuffer());
+
+  if (args.size() > 4) {
+    if (args.size() != 7) {
+      return STATUS_SUBSTITUTE(InvalidCommand,
+                               "Invalid number of arguments. Command should have 4 or 7 arguments");
+    }
+    string upper_arg;
+    ToUpperCase(args[4].ToBuffer(), &upper_arg);
+    if (upper_arg != "AGGREGATION") {
+      return STATUS_SUBSTITUTE(InvalidArgument,
+                               "Invalid argument $0. Expecting $1", args[4].ToBuffer(),
+                               "aggregation");
+    }
+    ToUpperCase(args[5].ToBuffer(), &upper_arg);
+    RedisCollectionGetRangeRequestPB::TsAggregation aggregation;
+    if (upper_arg == "AVG") {
+      aggregation = RedisCollectionGetRangeRequestPB::TS_AVG;
+    } else if (upper_arg == "MIN") {
+      aggregation = RedisCollectionGetRangeRequestPB::TS_MIN;
+    } else if (upper_arg == "MAX") {
+      aggregation = RedisCollectionGetRangeRequestPB::TS_MAX;
+    } else if (upper_arg == "COUNT") {
+      aggregation = RedisCollectionGetRangeRequestPB::TS_COUNT;
+    } else {
+      return STATUS_SUBSTITUTE(InvalidArgument,
+                               "Invalid aggregation $0. Expecting avg, min, max or count",
+                               args[5].ToBuffer());
+    }
+    auto step = ParseInt64(args[6], "step");
+    RETURN_NOT_OK(step);
+    if (*step <= 0) {
+      return STATUS_SUBSTITUTE(InvalidArgument,
+                               "$0 field $1 is not within valid bounds", "step",
+                               args[6].ToDebugString());
+    }
+    auto* range_request = op->mutable_request()->mutable_get_collection_range_request();
+    range_request->set_ts_aggregation(aggregation);
+    range_request->set_ts_aggregation_step(*step);
+  }
   return Status::OK();
 }
 
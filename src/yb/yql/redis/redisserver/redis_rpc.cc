@@ -19,6 +19,7 @@
 
 #include "yb/common/redis_protocol.pb.h"
 
+#include "yb/yql/redis/redisserver/redis_commands.h"
 #include "yb/yql/redis/redisserver/redis_encoding.h"
 #include "yb/yql/redis/redisserver/redis_parser.h"
 
@@ -40,9 +41,10 @@ using namespace yb::size_literals;
 
 DECLARE_bool(rpc_dump_all_traces);
 DECLARE_int32(rpc_slow_query_threshold_ms);
-DEFINE_uint64(redis_max_concurrent_commands, 1,
+DEFINE_uint64(redis_max_concurrent_commands, 10,
               "Max number of redis commands received from single connection, "
-              "that could be processed concurrently");
+              "that could be processed concurrently. Only batches of reads are processed "
+              "concurrently, a batch with other commands waits for all batches before it.");
 DEFINE_uint64(redis_max_batch, 500, "Max number of redis commands that forms batch");
 DEFINE_int32(rpcz_max_redis_query_dump_size, 4_KB,
              "The maximum size of the Redis query string in the RPCZ dump.");
@@ -226,6 +228,7 @@ Status RedisInboundCall::ParseFrom(
   }
   RedisParser parser(IoVecs(1, iovec{request_data_.data(), request_data_.size()}));
   size_t end_of_command = 0;
+  bool read_only = true;
   for (size_t i = 0; i != commands; ++i) {
     parser.SetArgs(&client_batch_[i]);
     end_of_command = VERIFY_RESULT(parser.NextCommand());
@@ -233,6 +236,7 @@ Status RedisInboundCall::ParseFrom(
     if (client_batch_[i].empty()) { // Should not be there.
       return STATUS(Corruption, "Empty command");
     }
+    read_only = read_only && IsReadCommand(client_batch_[i][0]);
     if (!end_of_command) {
       break;
     }
@@ -242,6 +246,7 @@ Status RedisInboundCall::ParseFrom(
                          "Parsed size $0 does not match source size $1",
                          end_of_command, request_data_.size());
   }
+  read_only_ = read_only;
 
   parsed_.store(true, std::memory_order_release);
   return Status::OK();
@@ -310,11 +315,13 @@ Out DoSerializeResponses(const Collection& responses, Out out) {
   // TODO(Amit): As and when we implement get/set and its h* equivalents, we would have to
   // handle arrays, hashes etc. For now, we only support the string response.
 
+  static const std::string kUnknownError = "Unknown error";
+
+  // Responses are written straight from the response protobufs, which are serialized twice: once
+  // to compute the size of the reply, and once to fill it. So nothing should be copied here.
   for (const auto& redis_response : responses) {
-    string error_message = redis_response.error_message();
-    if (error_message == "") {
-      error_message = "Unknown error";
-    }
+    const std::string& error_message = redis_response.error_message().empty()
+        ? kUnknownError : redis_response.error_message();
     // Several types of error cases:
     //    1) Parsing error: The command is malformed (eg. too few arguments "SET a")
     //    2) Server error: Request to server failed due to reasons not related to the command
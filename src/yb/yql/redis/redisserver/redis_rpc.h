@@ -63,6 +63,14 @@ class RedisConnectionContext : public rpc::ConnectionContextWithQueue {
 
   void SetCleanupHook(std::function<void()> hook) { cleanup_hook_ = std::move(hook); }
 
+  bool tracking() const {
+    return tracking_.load(std::memory_order_acquire);
+  }
+
+  void set_tracking(bool flag) {
+    tracking_.store(flag, std::memory_order_release);
+  }
+
   // Shutdown this context. Clean up the subscriptions if any.
   void Shutdown(const Status& status) override;
 
@@ -89,6 +97,8 @@ class RedisConnectionContext : public rpc::ConnectionContextWithQueue {
   size_t commands_in_batch_ = 0;
   size_t end_of_batch_ = 0;
   std::atomic<bool> authenticated_{false};
+  // Whether the keys read by this connection are tracked, see CLIENT TRACKING.
+  std::atomic<bool> tracking_{false};
   std::string redis_db_name_ = "0";
   std::atomic<RedisClientMode> mode_{RedisClientMode::kNormal};
   CoarseTimePoint soft_limit_exceeded_since_{CoarseTimePoint::max()};
@@ -120,6 +130,9 @@ class RedisInboundCall : public rpc::QueueableInboundCall {
   CoarseTimePoint GetClientDeadline() const override;
 
   RedisClientBatch& client_batch() { return client_batch_; }
+
+  // Calls that only read, so they do not affect each other, could be processed concurrently.
+  bool CanRunConcurrently() const override { return read_only_; }
   RedisConnectionContext& connection_context() const;
 
   const std::string& service_name() const override;
@@ -148,6 +161,9 @@ class RedisInboundCall : public rpc::QueueableInboundCall {
   // Atomic bool to indicate if the command batch has been parsed.
   std::atomic<bool> parsed_ = {false};
 
+  // Whether all commands of the batch are reads.
+  bool read_only_ = false;
+
   // Atomic bool to indicate if the quit command is present
   std::atomic<bool> quit_ = {false};
 
@@ -13,6 +13,7 @@
 
 #include "yb/yql/redis/redisserver/redis_service.h"
 
+#include <deque>
 #include <iostream>
 #include <thread>
 
@@ -51,6 +52,7 @@
 #include "yb/tserver/tserver_service.proxy.h"
 
 #include "yb/util/bytes_formatter.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/locks.h"
 #include "yb/util/logging.h"
 #include "yb/util/memory/mc_types.h"
@@ -116,6 +118,20 @@ DEFINE_int32(redis_password_caching_duration_ms, 5000,
              "The duration for which we will cache the redis passwords. 0 to disable.");
 
 DEFINE_bool(redis_safe_batch, true, "Use safe batching with Redis service");
+
+DEFINE_int32(redis_max_publishes_per_rpc, 100,
+             "Maximum number of messages that are published to a tablet server with one RPC. "
+             "Messages published while an RPC to the same server is in flight are batched.");
+TAG_FLAG(redis_max_publishes_per_rpc, advanced);
+TAG_FLAG(redis_max_publishes_per_rpc, runtime);
+
+DEFINE_bool(redis_enable_client_tracking, false,
+            "Allow clients to track the keys they read with CLIENT TRACKING ON. Every write then "
+            "publishes an invalidation of its key to all tablet servers.");
+DEFINE_int32(redis_tracking_table_max_keys, 1000000,
+             "Maximum number of keys read by tracking clients that a server remembers. When the "
+             "table is full, an invalidation is sent for a key that is dropped from it.");
+TAG_FLAG(redis_tracking_table_max_keys, advanced);
 DEFINE_bool(enable_redis_auth, true, "Enable AUTH for the Redis service");
 
 DECLARE_string(placement_cloud);
@@ -142,6 +158,8 @@ namespace redisserver {
 
 typedef boost::container::small_vector_base<Slice> RedisKeyList;
 
+class PublishDestination;
+
 namespace {
 
 YB_DEFINE_ENUM(OperationType, (kNone)(kRead)(kWrite)(kLocal));
@@ -166,13 +184,15 @@ class Operation {
   Operation(const std::shared_ptr<RedisInboundCall>& call,
             size_t index,
             std::shared_ptr<Op> operation,
-            const rpc::RpcMethodMetrics& metrics)
+            const rpc::RpcMethodMetrics& metrics,
+            StatusFunctor callback = StatusFunctor())
     : type_(std::is_same<Op, YBRedisReadOp>::value ? OperationType::kRead : OperationType::kWrite),
       call_(call),
       index_(index),
       operation_(std::move(operation)),
       metrics_(metrics),
-      manual_response_(ManualResponse::kFalse) {
+      manual_response_(ManualResponse::kFalse),
+      callback_(std::move(callback)) {
     auto status = operation_->GetPartitionKey(&partition_key_);
     if (!status.ok()) {
       Respond(status);
@@ -206,6 +226,11 @@ class Operation {
     return type_;
   }
 
+  // The key of the operation will be invalidated for tracking clients when it succeeds.
+  void InvalidateOnSuccess(RedisServiceData* service_data) {
+    invalidate_on_success_ = service_data;
+  }
+
   const YBRedisOp& operation() const {
     return *operation_;
   }
@@ -294,10 +319,19 @@ class Operation {
 
   void Respond(const Status& status) {
     responded_.store(true, std::memory_order_release);
+    if (invalidate_on_success_ && status.ok()) {
+      invalidate_on_success_->InvalidateTrackedKey(operation_->GetKey());
+    }
     if (manual_response_) {
       return;
     }
 
+    // Part of a multi-key command, that responds when all its parts are done.
+    if (callback_) {
+      callback_(status);
+      return;
+    }
+
     if (status.ok()) {
       if (operation_) {
         call_->RespondSuccess(index_, metrics_, &response());
@@ -326,6 +360,8 @@ class Operation {
   std::string partition_key_;
   rpc::RpcMethodMetrics metrics_;
   ManualResponse manual_response_;
+  StatusFunctor callback_;
+  RedisServiceData* invalidate_on_success_ = nullptr;
   client::internal::RemoteTabletPtr tablet_;
   std::atomic<bool> responded_{false};
 };
@@ -765,10 +801,13 @@ struct RedisServiceImplData : public RedisServiceData {
   std::unordered_set<std::string> GetSubscriptions(AsPattern type, rpc::Connection* conn) override;
   std::unordered_set<std::string> GetAllSubscriptions(AsPattern type) override;
   int Publish(const string& channel, const string& message);
+  void TrackKey(const string& key);
+  void InvalidateTrackedKey(const string& key) override;
   void ForwardToInterestedProxies(
       const string& channel, const string& message, const IntFunctor& f) override;
   int PublishToLocalClients(IsMonitorMessage mode, const string& channel, const string& message);
   Result<vector<HostPortPB>> GetServerAddrsForChannel(const string& channel);
+  std::shared_ptr<PublishDestination> GetPublishDestination(const HostPort& host_port);
   int NumSubscriptionsUnlocked(Connection* conn);
 
   CHECKED_STATUS GetRedisPasswords(vector<string>* passwords) override;
@@ -802,6 +841,14 @@ struct RedisServiceImplData : public RedisServiceData {
   std::unordered_set<Connection*> monitoring_clients_;
   scoped_refptr<AtomicGauge<uint64_t>> num_clients_monitoring_;
 
+  // Servers that messages were published to, keyed by their address.
+  std::mutex publish_mutex_;
+  std::unordered_map<std::string, std::shared_ptr<PublishDestination>> publish_destinations_;
+
+  // Keys read by tracking clients of this server, that were not invalidated since.
+  std::mutex tracking_mutex_;
+  std::unordered_set<std::string> tracked_keys_;
+
   std::mutex redis_password_mutex_;
   MonoTime redis_cached_password_validity_expiry_;
   vector<string> redis_cached_passwords_;
@@ -899,6 +946,22 @@ class BatchContextImpl : public BatchContext {
     DoApply(index, std::move(operation), metrics);
   }
 
+  void Apply(
+      size_t index,
+      std::shared_ptr<client::YBRedisReadOp> operation,
+      const rpc::RpcMethodMetrics& metrics,
+      StatusFunctor callback) override {
+    DoApply(index, std::move(operation), metrics, std::move(callback));
+  }
+
+  void Apply(
+      size_t index,
+      std::shared_ptr<client::YBRedisWriteOp> operation,
+      const rpc::RpcMethodMetrics& metrics,
+      StatusFunctor callback) override {
+    DoApply(index, std::move(operation), metrics, std::move(callback));
+  }
+
   void Apply(
       size_t index,
       std::function<bool(client::YBSession*, const StatusFunctor&)> functor,
@@ -920,6 +983,21 @@ class BatchContextImpl : public BatchContext {
       operations_.pop_back();
     } else {
       consumption_.Add(operations_.back().space_used_by_request());
+      if (PREDICT_FALSE(FLAGS_redis_enable_client_tracking)) {
+        SetupTracking(&operations_.back());
+      }
+    }
+  }
+
+  void SetupTracking(Operation* operation) {
+    if (!operation->has_operation()) {
+      return;
+    }
+    if (operation->type() == OperationType::kWrite) {
+      operation->InvalidateOnSuccess(impl_data_);
+    } else if (call_->connection_context().tracking()) {
+      // Tracked before the read is done, so that a concurrent write invalidates the value read.
+      impl_data_->TrackKey(operation->operation().GetKey());
     }
   }
 
@@ -1174,15 +1252,54 @@ void RedisServiceImplData::LogToMonitors(
 
 int RedisServiceImplData::Publish(const string& channel, const string& message) {
   VLOG(3) << "Forwarding to clients on channel " << channel;
+  if (channel == kTrackingInvalidationChannel) {
+    // Every write publishes an invalidation, but only the keys that were read by tracking clients
+    // of this server since their last invalidation are announced.
+    std::lock_guard<std::mutex> lock(tracking_mutex_);
+    if (tracked_keys_.erase(message) == 0) {
+      return 0;
+    }
+  }
   return PublishToLocalClients(IsMonitorMessage::kFalse, channel, message);
 }
 
+void RedisServiceImplData::TrackKey(const string& key) {
+  string evicted_key;
+  {
+    std::lock_guard<std::mutex> lock(tracking_mutex_);
+    if (tracked_keys_.count(key)) {
+      return;
+    }
+    if (tracked_keys_.size() >= std::max(FLAGS_redis_tracking_table_max_keys, 1)) {
+      auto it = tracked_keys_.begin();
+      evicted_key = std::move(*it);
+      tracked_keys_.erase(it);
+    }
+    tracked_keys_.insert(key);
+  }
+  if (!evicted_key.empty()) {
+    // Clients could not be told about writes of a key that is not tracked anymore, so they have
+    // to drop it from their caches now.
+    PublishToLocalClients(IsMonitorMessage::kFalse, kTrackingInvalidationChannel, evicted_key);
+  }
+}
+
+void RedisServiceImplData::InvalidateTrackedKey(const string& key) {
+  if (!FLAGS_redis_enable_client_tracking) {
+    return;
+  }
+  // Tracking clients of other servers could have read the key, so the invalidation goes to all of
+  // them.
+  ForwardToInterestedProxies(kTrackingInvalidationChannel, key, [](int) {});
+}
+
 Result<vector<HostPortPB>> RedisServiceImplData::GetServerAddrsForChannel(
     const string& channel_unused) {
   // TODO(Amit): Instead of forwarding  blindly to all servers, figure out the
   // ones that have a subscription and send it to them only.
   std::vector<master::TSInformationPB> live_tservers;
-  Status s = CHECK_NOTNULL(server_->tserver())->GetLiveTServers(&live_tservers);
+  const auto* tserver = CHECK_NOTNULL(server_->tserver());
+  Status s = tserver->GetLiveTServers(&live_tservers);
   if (!s.ok()) {
     LOG(WARNING) << s;
     return s;
@@ -1190,8 +1307,12 @@ Result<vector<HostPortPB>> RedisServiceImplData::GetServerAddrsForChannel(
 
   vector<HostPortPB> servers;
   const auto cloud_info_pb = server_->MakeCloudInfoPB();
-  // Queue NEW_NODE event for all the live tservers.
+  // Queue NEW_NODE event for all the live tservers, except this one, whose clients get the
+  // messages without an RPC.
   for (const master::TSInformationPB& ts_info : live_tservers) {
+    if (ts_info.tserver_instance().permanent_uuid() == tserver->permanent_uuid()) {
+      continue;
+    }
     const auto& hostport_pb = DesiredHostPort(ts_info.registration().common(), cloud_info_pb);
     if (hostport_pb.host().empty()) {
       LOG(WARNING) << "Skipping TS since it doesn't have any rpc address: "
@@ -1208,8 +1329,8 @@ class PublishResponseHandler {
   PublishResponseHandler(int32_t n, IntFunctor f)
       : num_replies_pending(n), done_functor(std::move(f)) {}
 
-  void HandleResponse(const tserver::PublishResponsePB* resp) {
-    num_clients_forwarded_to.IncrementBy(resp->num_clients_forwarded_to());
+  void HandleResponse(int32_t num_clients) {
+    num_clients_forwarded_to.IncrementBy(num_clients);
 
     if (0 == num_replies_pending.IncrementBy(-1)) {
       done_functor(num_clients_forwarded_to.Load());
@@ -1222,39 +1343,124 @@ class PublishResponseHandler {
   IntFunctor done_functor;
 };
 
+// Sends the messages published to one tablet server. While an RPC to the server is in flight,
+// further messages are queued and then sent together with the next RPC, so that a burst of
+// publishes does not turn into a burst of RPCs.
+class PublishDestination : public std::enable_shared_from_this<PublishDestination> {
+ public:
+  explicit PublishDestination(std::shared_ptr<tserver::TabletServerServiceProxy> proxy)
+      : proxy_(std::move(proxy)) {}
+
+  void Publish(
+      const string& channel, const string& message,
+      const std::shared_ptr<PublishResponseHandler>& handler) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      pending_.push_back(PendingMessage{channel, message, handler});
+      if (rpc_in_flight_) {
+        return;
+      }
+      rpc_in_flight_ = true;
+    }
+    SendPending();
+  }
+
+ private:
+  struct PendingMessage {
+    string channel;
+    string message;
+    std::shared_ptr<PublishResponseHandler> handler;
+  };
+
+  void SendPending() {
+    auto batch = std::make_shared<std::vector<PendingMessage>>();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (pending_.empty()) {
+        rpc_in_flight_ = false;
+        return;
+      }
+      const size_t max_batch_size =
+          supports_batching_ ? std::max(FLAGS_redis_max_publishes_per_rpc, 1) : 1;
+      while (!pending_.empty() && batch->size() < max_batch_size) {
+        batch->push_back(std::move(pending_.front()));
+        pending_.pop_front();
+      }
+    }
+
+    tserver::PublishRequestPB request;
+    request.set_channel(batch->front().channel);
+    request.set_message(batch->front().message);
+    for (auto it = batch->begin() + 1; it != batch->end(); ++it) {
+      auto* batched = request.add_batched_messages();
+      batched->set_channel(it->channel);
+      batched->set_message(it->message);
+    }
+    auto response = std::make_shared<tserver::PublishResponsePB>();
+    auto controller = std::make_shared<rpc::RpcController>();
+    auto self = shared_from_this();
+    proxy_->PublishAsync(
+        request, response.get(), controller.get(), [self, batch, response, controller] {
+          self->Done(*controller, *response, batch.get());
+        });
+  }
+
+  void Done(
+      const rpc::RpcController& controller, const tserver::PublishResponsePB& response,
+      std::vector<PendingMessage>* batch) {
+    const size_t num_batched = batch->size() - 1;
+    batch->front().handler->HandleResponse(response.num_clients_forwarded_to());
+    if (!controller.status().ok() ||
+        response.batched_num_clients_forwarded_to_size() == num_batched) {
+      for (size_t i = 0; i != num_batched; ++i) {
+        (*batch)[i + 1].handler->HandleResponse(
+            controller.status().ok() ? response.batched_num_clients_forwarded_to(i) : 0);
+      }
+    } else {
+      // The server does not know about batched messages and only published the first one, so
+      // the rest is sent again, one message per RPC.
+      std::lock_guard<std::mutex> lock(mutex_);
+      supports_batching_ = false;
+      for (auto it = batch->rbegin(); it + 1 != batch->rend(); ++it) {
+        pending_.push_front(std::move(*it));
+      }
+    }
+    SendPending();
+  }
+
+  const std::shared_ptr<tserver::TabletServerServiceProxy> proxy_;
+
+  std::mutex mutex_;
+  bool rpc_in_flight_ = false;
+  bool supports_batching_ = true;
+  std::deque<PendingMessage> pending_;
+};
+
+std::shared_ptr<PublishDestination> RedisServiceImplData::GetPublishDestination(
+    const HostPort& host_port) {
+  std::lock_guard<std::mutex> lock(publish_mutex_);
+  auto& result = publish_destinations_[host_port.ToString()];
+  if (!result) {
+    result = std::make_shared<PublishDestination>(
+        std::make_shared<tserver::TabletServerServiceProxy>(&client_->proxy_cache(), host_port));
+  }
+  return result;
+}
+
 void RedisServiceImplData::ForwardToInterestedProxies(
     const string& channel, const string& message, const IntFunctor& f) {
+  const int num_local_clients = Publish(channel, message);
   auto interested_servers = GetServerAddrsForChannel(channel);
   if (!interested_servers.ok()) {
     LOG(ERROR) << "Could not get servers to forward to " << interested_servers.status();
+    f(num_local_clients);
     return;
   }
-  std::shared_ptr<PublishResponseHandler> resp_handler =
-      std::make_shared<PublishResponseHandler>(interested_servers->size(), f);
-  for (auto& hostport_pb : *interested_servers) {
-    tserver::PublishRequestPB requestPB;
-    requestPB.set_channel(channel);
-    requestPB.set_message(message);
-    std::shared_ptr<tserver::TabletServerServiceProxy> proxy =
-        std::make_shared<tserver::TabletServerServiceProxy>(
-            &client_->proxy_cache(), HostPortFromPB(hostport_pb));
-    std::shared_ptr<tserver::PublishResponsePB> responsePB =
-        std::make_shared<tserver::PublishResponsePB>();
-    std::shared_ptr<yb::rpc::RpcController> rpcController = std::make_shared<rpc::RpcController>();
-    // Hold a copy of the shared ptr in the callback to ensure that the proxy, responsePB and
-    // rpcController are valid.
-    // these self-destruct on the latter of the two events
-    //  (i)  exit this loop, and
-    //  (ii) done with the callback.
-    proxy->PublishAsync(
-        requestPB, responsePB.get(), rpcController.get(),
-        [resp_handler, responsePB, rpcController, proxy]() mutable {
-          resp_handler->HandleResponse(responsePB.get());
-          responsePB.reset();
-          rpcController.reset();
-          proxy.reset();
-          resp_handler.reset();
-        });
+  auto resp_handler =
+      std::make_shared<PublishResponseHandler>(interested_servers->size() + 1, f);
+  resp_handler->HandleResponse(num_local_clients);
+  for (const auto& hostport_pb : *interested_servers) {
+    GetPublishDestination(HostPortFromPB(hostport_pb))->Publish(channel, message, resp_handler);
   }
 }
 
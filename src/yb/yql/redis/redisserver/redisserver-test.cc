@@ -1196,6 +1196,29 @@ TEST_F_EX(TestRedisService, PipelinePartial, TestRedisServicePipelined) {
       true /* partial */);
 }
 
+class TestRedisServiceConcurrentCalls : public TestRedisService {
+ public:
+  void SetUp() override {
+    FLAGS_redis_max_concurrent_commands = FLAGS_test_redis_max_concurrent_commands;
+    FLAGS_redis_max_batch = 1;
+    TestRedisService::SetUp();
+  }
+};
+
+// Each command is a call of its own, so reads run concurrently, while writes wait for the reads
+// before them and the reads after them wait for the writes.
+TEST_F_EX(TestRedisService, ConcurrentCallsOrder, TestRedisServiceConcurrentCalls) {
+  std::string command;
+  std::string response;
+  for (int i = 0; i != 100; ++i) {
+    const auto value = std::to_string(i);
+    command += yb::Format("set foo $0\r\nget foo\r\nget foo\r\nget bar\r\n", value);
+    response += yb::Format("+OK\r\n$$$0\r\n$1\r\n$$$0\r\n$1\r\n$$-1\r\n",
+                           value.length(), value);
+  }
+  SendCommandAndExpectResponse(__LINE__, command, response);
+}
+
 namespace {
 
 class BatchGenerator {
@@ -2779,6 +2802,76 @@ TEST_F(TestRedisServiceExternal, SubscribedClientMode) {
   SyncClient();
 }
 
+class TestRedisServiceClientTracking : public TestRedisServiceExternal {
+ protected:
+  void CustomizeExternalMiniCluster(ExternalMiniClusterOptions* opts) override {
+    TestRedisServiceExternal::CustomizeExternalMiniCluster(opts);
+    opts->extra_tserver_flags.push_back("--redis_enable_client_tracking=true");
+  }
+};
+
+TEST_F(TestRedisServiceClientTracking, InvalidateAfterWrite) {
+  expected_no_sessions_ = true;
+  auto ts0 = external_mini_cluster()->tablet_server(0);
+  auto ts1 = external_mini_cluster()->tablet_server(1);
+  auto tracking_client = std::make_shared<RedisClient>(ts0->bind_host(), ts0->redis_rpc_port());
+  auto invalidation_client =
+      std::make_shared<RedisClient>(ts0->bind_host(), ts0->redis_rpc_port());
+  auto writing_client = std::make_shared<RedisClient>(ts1->bind_host(), ts1->redis_rpc_port());
+  const string channel = kTrackingInvalidationChannel;
+
+  UseClient(invalidation_client);
+  DoRedisTestResultsArray(
+      __LINE__, {"SUBSCRIBE", channel},
+      {RedisReply(RedisReplyType::kString, "subscribe"),
+       RedisReply(RedisReplyType::kString, channel), RedisReply(1)});
+  SyncClient();
+
+  UseClient(tracking_client);
+  DoRedisTestOk(__LINE__, {"CLIENT", "TRACKING", "ON"});
+  DoRedisTestNull(__LINE__, {"GET", "key"});
+  SyncClient();
+
+  // A write through another server invalidates the key read by the tracking client.
+  UseClient(writing_client);
+  DoRedisTestOk(__LINE__, {"SET", "key", "value1"});
+  DoRedisTestOk(__LINE__, {"SET", "other_key", "value1"});
+  SyncClient();
+
+  UseClient(invalidation_client);
+  DoRedisTestArray(__LINE__, {}, {"message", channel, "key"});
+  SyncClient();
+
+  // The key is not tracked anymore until it is read again.
+  UseClient(writing_client);
+  DoRedisTestOk(__LINE__, {"SET", "key", "value2"});
+  SyncClient();
+
+  UseClient(tracking_client);
+  DoRedisTestBulkString(__LINE__, {"GET", "key"}, "value2");
+  DoRedisTestOk(__LINE__, {"CLIENT", "TRACKING", "OFF"});
+  DoRedisTestBulkString(__LINE__, {"GET", "other_key"}, "value1");
+  SyncClient();
+
+  UseClient(writing_client);
+  DoRedisTestOk(__LINE__, {"SET", "key", "value3"});
+  DoRedisTestOk(__LINE__, {"SET", "other_key", "value3"});
+  SyncClient();
+
+  UseClient(invalidation_client);
+  DoRedisTestArray(__LINE__, {}, {"message", channel, "key"});
+  DoRedisTestOk(__LINE__, {"QUIT"});
+  SyncClient();
+
+  UseClient(tracking_client);
+  DoRedisTestOk(__LINE__, {"QUIT"});
+  SyncClient();
+
+  UseClient(writing_client);
+  DoRedisTestOk(__LINE__, {"QUIT"});
+  SyncClient();
+}
+
 TEST_F(TestRedisService, TestAuth) {
   FLAGS_redis_password_caching_duration_ms = 0;
   const char* kRedisAuthPassword = "redis-password";
@@ -3959,6 +4052,48 @@ TEST_F(TestRedisService, TestTsRangeByTime) {
   VerifyCallbacks();
 }
 
+TEST_F(TestRedisService, TestTsRangeByTimeAggregation) {
+  DoRedisTestOk(__LINE__, {"TSADD", "ts_key",
+      "-25", "4",
+      "-15", "1",
+      "-5", "8",
+      "0", "2",
+      "5", "3.5",
+      "10", "7",
+      "25", "6",
+  });
+  SyncClient();
+
+  // Intervals start at multiples of the step, also for negative timestamps.
+  DoRedisTestArray(__LINE__, {"TSRANGEBYTIME", "ts_key", "-inf", "+inf", "AGGREGATION", "count",
+      "20"}, {"-40", "1", "-20", "2", "0", "3", "20", "1"});
+  DoRedisTestArray(__LINE__, {"TSRANGEBYTIME", "ts_key", "-20", "20", "aggregation", "MIN", "20"},
+      {"-20", "1", "0", "2"});
+  DoRedisTestArray(__LINE__, {"TSRANGEBYTIME", "ts_key", "-20", "20", "AGGREGATION", "max", "20"},
+      {"-20", "8", "0", "7"});
+  DoRedisTestArray(__LINE__, {"TSRANGEBYTIME", "ts_key", "0", "+inf", "AGGREGATION", "avg", "10"},
+      {"0", "2.750000", "10", "7.000000", "20", "6.000000"});
+  DoRedisTestArray(__LINE__, {"TSRANGEBYTIME", "ts_key", "30", "40", "AGGREGATION", "avg", "10"},
+      {});
+
+  DoRedisTestExpectError(__LINE__, {"TSRANGEBYTIME", "ts_key", "0", "10", "AGGREGATION", "avg"});
+  DoRedisTestExpectError(__LINE__, {"TSRANGEBYTIME", "ts_key", "0", "10", "AGGREGATION", "sum",
+      "10"});
+  DoRedisTestExpectError(__LINE__, {"TSRANGEBYTIME", "ts_key", "0", "10", "AGGREGATION", "avg",
+      "0"});
+  DoRedisTestExpectError(__LINE__, {"TSRANGEBYTIME", "ts_key", "0", "10", "GROUP", "avg", "10"});
+
+  DoRedisTestOk(__LINE__, {"TSADD", "ts_text", "10", "v1"});
+  SyncClient();
+  DoRedisTestArray(__LINE__, {"TSRANGEBYTIME", "ts_text", "0", "20", "AGGREGATION", "count",
+      "10"}, {"10", "1"});
+  DoRedisTestExpectError(__LINE__, {"TSRANGEBYTIME", "ts_text", "0", "20", "AGGREGATION", "avg",
+      "10"});
+
+  SyncClient();
+  VerifyCallbacks();
+}
+
 TEST_F(TestRedisService, TestTsRevRangeByTime) {
   DoRedisTestOk(__LINE__, {"TSADD", "ts_key",
       "-50", "v1",
@@ -4496,6 +4631,42 @@ TEST_F(TestRedisService, TestDel) {
   VerifyCallbacks();
 }
 
+TEST_F(TestRedisService, TestMultiKeyCommands) {
+  FLAGS_emulate_redis_responses = true;
+
+  std::vector<std::string> mset = {"MSET"};
+  std::vector<std::string> mget = {"MGET"};
+  std::vector<std::string> del = {"DEL"};
+  std::vector<std::string> values;
+  for (int i = 0; i != 100; ++i) {
+    const auto key = yb::Format("key$0", i);
+    mget.push_back(key);
+    del.push_back(key);
+    if (i % 3 == 0) {
+      values.push_back("");
+      continue;
+    }
+    mset.push_back(key);
+    mset.push_back(yb::Format("value$0", i));
+    values.push_back(mset.back());
+  }
+  mget.push_back("hash_key");
+  values.push_back("");
+
+  DoRedisTestInt(__LINE__, {"HSET", "hash_key", "subkey", "value"}, 1);
+  DoRedisTestOk(__LINE__, mset);
+  SyncClient();
+  // Keys without a string value, including the hash, are returned as nil, in the order of keys.
+  DoRedisTestArray(__LINE__, mget, values);
+  SyncClient();
+  DoRedisTestInt(__LINE__, del, 66);
+  DoRedisTestExpectError(__LINE__, {"MSET", "key1", "value1", "key2"});
+  SyncClient();
+  DoRedisTestArray(__LINE__, {"MGET", "key1", "key2"}, {"", ""});
+  SyncClient();
+  VerifyCallbacks();
+}
+
 TEST_F(TestRedisService, TestHDel) {
   // The default value is true, but we explicitly set this here for clarity.
   FLAGS_emulate_redis_responses = true;